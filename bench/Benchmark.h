@@ -79,6 +79,10 @@ public:
 
     virtual void getGpuStats(SkCanvas*, SkTArray<SkString>* keys, SkTArray<double>* values) {}
 
+    // Results other than timing (e.g. cache hit rates) to log with the timing. Called once the
+    // samples have been taken, before perCanvasPostDraw().
+    virtual void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) {}
+
 protected:
     virtual void setupPaint(SkPaint* paint);
 
@@ -18,6 +18,7 @@
 #define REAL    0.5f
 #define BIG     SkIntToScalar(10)
 #define REALBIG 100.5f
+#define GIANT   230.0f
 // The value that produces a sigma of just over 2.
 #define CUTOVER 2.6f
 
@@ -95,6 +96,9 @@ DEF_BENCH(return new BlurBench(REALBIG, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REALBIG, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REALBIG, kInner_SkBlurStyle);)
 
+DEF_BENCH(return new BlurBench(GIANT, kNormal_SkBlurStyle);)
+DEF_BENCH(return new BlurBench(GIANT, kOuter_SkBlurStyle);)
+
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
@@ -72,9 +72,26 @@ private:
     typedef BlurRectsBench INHERITED;
 };
 
+// Masks this big blur in bands of rows spread across the default executor's threads.
+class BlurRectsLargeSigmaBench: public BlurRectsBench {
+public:
+    BlurRectsLargeSigmaBench(SkRect outer, SkRect inner, SkScalar radius)
+        : INHERITED(outer, inner, radius) {
+        this->setName(SkStringPrintf("blurrects_large_sigma_%g", radius));
+    }
+private:
+    typedef BlurRectsBench INHERITED;
+};
+
 DEF_BENCH(return new BlurRectsNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                              SkRect::MakeXYWH(20, 20, 60, 60),
                                              2.3f);)
 DEF_BENCH(return new BlurRectsNonNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                                 SkRect::MakeXYWH(50, 50, 10, 10),
                                                 4.3f);)
+DEF_BENCH(return new BlurRectsLargeSigmaBench(SkRect::MakeXYWH(10, 10, 1000, 1000),
+                                              SkRect::MakeXYWH(400, 400, 200, 200),
+                                              40);)
+DEF_BENCH(return new BlurRectsLargeSigmaBench(SkRect::MakeXYWH(10, 10, 1000, 1000),
+                                              SkRect::MakeXYWH(400, 400, 200, 200),
+                                              120);)
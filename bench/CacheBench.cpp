@@ -0,0 +1,665 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkDescriptor.h"
+#include "SkImageFilterCache.h"
+#include "SkOffsetImageFilter.h"
+#include "SkRandom.h"
+#include "SkResourceCache.h"
+#include "SkScalerContext.h"
+#include "SkSpecialImage.h"
+#include "SkStrikeCache.h"
+#include "SkTypeface.h"
+#include "sk_tool_utils.h"
+
+#if SK_SUPPORT_GPU
+#include "GrClip.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "GrGpuResource.h"
+#include "GrGpuResourcePriv.h"
+#include "GrRenderTargetContext.h"
+#include "GrResourceCache.h"
+#include "GrShape.h"
+#include "SkTextBlob.h"
+#include "ccpr/GrCCPathCache.h"
+#include "glsl/GrGLSLFragmentProcessor.h"
+#include "glsl/GrGLSLFragmentShaderBuilder.h"
+#include "text/GrTextBlobCache.h"
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+/**
+ * These benchmarks drive each of Skia's caches through a working set of keys that is some fraction
+ * or multiple of the cache's budget, looked up in one of three orders:
+ *
+ *   uniform: every key is equally likely,
+ *   zipf:    key k is looked up in proportion to 1/(k+1), so a few keys are very hot,
+ *   scan:    keys in order, over and over, which defeats LRU once the set is over budget.
+ *
+ * A lookup that misses adds its key, so once the working set is over budget every miss evicts.
+ * The time is per loop of lookups. hit_rate and evictions_per_lookup are logged along with it.
+ * Comparing the time of the 50% (nothing evicted) and 200% benches of a cache gives the cost of
+ * its misses and evictions. The benches are named cache_<cache>_<order>_<working set % of budget>.
+ */
+
+namespace {
+
+enum class Order { kUniform, kZipf, kScan };
+
+static const char* order_name(Order order) {
+    switch (order) {
+        case Order::kUniform: return "uniform";
+        case Order::kZipf:    return "zipf";
+        case Order::kScan:    return "scan";
+    }
+    SkASSERT(false);
+    return "";
+}
+
+// The keys to look up, in order. Looping over it is far cheaper than drawing random numbers in
+// the timed loop, and it's long enough that the loops don't keep repeating a few keys.
+static std::vector<int> make_sequence(Order order, int keyCount) {
+    const int passes = SkTMax(8, ((1 << 16) + keyCount - 1) / keyCount);
+    std::vector<int> sequence(keyCount * passes);
+    SkRandom random;
+    switch (order) {
+        case Order::kUniform:
+            for (int& key : sequence) {
+                key = random.nextULessThan(keyCount);
+            }
+            break;
+        case Order::kZipf: {
+            std::vector<double> cdf(keyCount);
+            double sum = 0;
+            for (int k = 0; k < keyCount; ++k) {
+                sum += 1.0 / (k + 1);
+                cdf[k] = sum;
+            }
+            for (int& key : sequence) {
+                double x = random.nextF() * sum;
+                key = std::lower_bound(cdf.begin(), cdf.end(), x) - cdf.begin();
+                key = SkTMin(key, keyCount - 1);
+            }
+            break;
+        }
+        case Order::kScan:
+            for (size_t i = 0; i < sequence.size(); ++i) {
+                sequence[i] = i % keyCount;
+            }
+            break;
+    }
+    return sequence;
+}
+
+// Adapts one cache to CacheBench.
+class CacheDriver {
+public:
+    virtual ~CacheDriver() {}
+
+    virtual const char* name() const = 0;
+
+    // The number of entries the cache holds before it starts to evict.
+    virtual int budget() const = 0;
+
+    // Creates the cache and whatever the first keyCount keys need. Not timed.
+    virtual bool setup(int keyCount) = 0;
+
+    // Looks up key, adding it if it is missing. Returns true if it was found.
+    virtual bool lookup(int key) = 0;
+
+    // The number of entries in the cache now.
+    virtual int count() const = 0;
+};
+
+class CacheBench : public Benchmark {
+public:
+    CacheBench(CacheDriver* driver, Order order, int workingSetPercent)
+            : fDriver(driver)
+            , fOrder(order)
+            , fWorkingSetPercent(workingSetPercent) {
+        fName.printf("cache_%s_%s_%d", driver->name(), order_name(order), workingSetPercent);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        if (0 == fLookups) {
+            return;
+        }
+        // Every miss adds an entry, so any the cache didn't grow by were evicted.
+        const int64_t evictions = (fLookups - fHits) - (fDriver->count() - fStartCount);
+        keys->push_back(SkString("hit_rate"));
+        values->push_back((double)fHits / fLookups);
+        keys->push_back(SkString("evictions_per_lookup"));
+        values->push_back((double)evictions / fLookups);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        const int keyCount = SkTMax(1, fDriver->budget() * fWorkingSetPercent / 100);
+        if (!fDriver->setup(keyCount)) {
+            return;
+        }
+        fSequence = make_sequence(fOrder, keyCount);
+
+        // Start the timing from a warm cache.
+        const size_t warmup = SkTMin(fSequence.size(), (size_t)keyCount * 2);
+        for (size_t i = 0; i < warmup; ++i) {
+            fDriver->lookup(fSequence[i]);
+        }
+        fNext = warmup % fSequence.size();
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fLookups = fHits = 0;
+        fStartCount = fSequence.empty() ? 0 : fDriver->count();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (fSequence.empty()) {
+            return;
+        }
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < kLookupsPerLoop; ++j) {
+                fHits += fDriver->lookup(fSequence[fNext]);
+                if (++fNext == fSequence.size()) {
+                    fNext = 0;
+                }
+            }
+        }
+        fLookups += (int64_t)loops * kLookupsPerLoop;
+    }
+
+private:
+    static constexpr int kLookupsPerLoop = 1024;
+
+    std::unique_ptr<CacheDriver> fDriver;
+    const Order                  fOrder;
+    const int                    fWorkingSetPercent;
+    SkString                     fName;
+    std::vector<int>             fSequence;
+    size_t                       fNext = 0;
+    int64_t                      fLookups = 0;
+    int64_t                      fHits = 0;
+    int                          fStartCount = 0;
+
+    typedef Benchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void* gResourceCacheNamespace;
+
+class ResourceCacheDriver : public CacheDriver {
+public:
+    const char* name() const override { return "resource"; }
+    int budget() const override { return kBudget; }
+
+    bool setup(int) override {
+        fCache.reset(new SkResourceCache(kBudget * kRecBytes));
+        return true;
+    }
+
+    bool lookup(int key) override {
+        RecKey k(key);
+        if (fCache->find(k, [](const SkResourceCache::Rec&, void*) { return true; }, nullptr)) {
+            return true;
+        }
+        fCache->add(new Rec(k));
+        return false;
+    }
+
+    int count() const override { return SkToInt(fCache->getTotalBytesUsed() / kRecBytes); }
+
+private:
+    static constexpr int    kBudget = 1024;
+    static constexpr size_t kRecBytes = 1024;
+
+    // Not called Key, which would be hidden by SkResourceCache::Rec::Key inside Rec.
+    struct RecKey : public SkResourceCache::Key {
+        explicit RecKey(int value) : fValue(value) {
+            this->init(&gResourceCacheNamespace, 0, sizeof(fValue));
+        }
+        int fValue;
+    };
+
+    struct Rec : public SkResourceCache::Rec {
+        explicit Rec(const RecKey& key) : fKey(key) {}
+
+        const Key& getKey() const override { return fKey; }
+        size_t bytesUsed() const override { return kRecBytes; }
+        const char* getCategory() const override { return "cachebench"; }
+        SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+        RecKey fKey;
+    };
+
+    std::unique_ptr<SkResourceCache> fCache;
+};
+
+// Each key is the same typeface at its own text size.
+class StrikeCacheDriver : public CacheDriver {
+public:
+    const char* name() const override { return "strike"; }
+    int budget() const override { return kBudget; }
+
+    bool setup(int keyCount) override {
+        fCache.setCacheCountLimit(kBudget);
+        fCache.setCacheSizeLimit(1 << 30);
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setTypeface(sk_tool_utils::create_portable_typeface("serif", SkFontStyle()));
+        fTypeface = paint.refTypeface();
+        for (int k = 0; k < keyCount; ++k) {
+            paint.setTextSize(8 + k * 0.125f);
+            SkAutoDescriptor ad;
+            auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                    paint, nullptr, SkScalerContextFlags::kNone, nullptr, &ad, &fEffects);
+            fDescriptors.push_back(desc->copy());
+        }
+        return true;
+    }
+
+    bool lookup(int key) override {
+        const SkDescriptor& desc = *fDescriptors[key];
+        if (fCache.findStrikeExclusive(desc)) {
+            return true;
+        }
+        fCache.createStrikeExclusive(
+                desc, SkStrikeCache::CreateScalerContext(desc, fEffects, *fTypeface));
+        return false;
+    }
+
+    int count() const override { return fCache.getCacheCountUsed(); }
+
+private:
+    static constexpr int kBudget = 256;
+
+    SkStrikeCache                              fCache;
+    sk_sp<SkTypeface>                          fTypeface;
+    SkScalerContextEffects                     fEffects;
+    std::vector<std::unique_ptr<SkDescriptor>> fDescriptors;
+};
+
+// Each key is a srcGenID, with the keys spread over a few filters as they would be in practice.
+class ImageFilterCacheDriver : public CacheDriver {
+public:
+    const char* name() const override { return "imagefilter"; }
+    int budget() const override { return kBudget; }
+
+    bool setup(int) override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kImageSize, kImageSize);
+        bitmap.eraseColor(SK_ColorBLUE);
+        fImage = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kImageSize, kImageSize), bitmap);
+        fImageBytes = fImage->getSize();
+        fCache.reset(SkImageFilterCache::Create(kBudget * fImageBytes));
+        for (auto& filter : fFilters) {
+            filter = SkOffsetImageFilter::Make(0, 0, nullptr);
+        }
+        return true;
+    }
+
+    bool lookup(int key) override {
+        const int filter = key % kFilterCount;
+        const SkIRect bounds = SkIRect::MakeWH(kImageSize, kImageSize);
+        SkImageFilterCacheKey k(filter, SkMatrix::I(), bounds, key, bounds);
+        SkIPoint offset;
+        if (fCache->get(k, &offset)) {
+            return true;
+        }
+        fCache->set(k, fImage.get(), SkIPoint::Make(0, 0), fFilters[filter].get());
+        return false;
+    }
+
+    int count() const override { return SkToInt(fCache->bytesUsed() / fImageBytes); }
+
+private:
+    static constexpr int kBudget = 1024;
+    static constexpr int kImageSize = 16;
+    static constexpr int kFilterCount = 16;
+
+    sk_sp<SkImageFilterCache> fCache;
+    sk_sp<SkSpecialImage>     fImage;
+    size_t                    fImageBytes = 0;
+    sk_sp<SkImageFilter>      fFilters[kFilterCount];
+};
+
+#if SK_SUPPORT_GPU
+
+class GpuResourceCacheDriver : public CacheDriver {
+public:
+    const char* name() const override { return "gpuresource"; }
+    int budget() const override { return kBudget; }
+
+    bool setup(int keyCount) override {
+        fContext = GrContext::MakeMock(nullptr);
+        if (!fContext) {
+            return false;
+        }
+        fContext->setResourceCacheLimits(kBudget, 1 << 30);
+        fCache = fContext->contextPriv().getResourceCache();
+        fCache->purgeAllUnlocked();
+
+        static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+        fKeys.resize(keyCount);
+        for (int k = 0; k < keyCount; ++k) {
+            GrUniqueKey::Builder builder(&fKeys[k], kDomain, 1);
+            builder[0] = k;
+        }
+        return true;
+    }
+
+    bool lookup(int key) override {
+        sk_sp<GrGpuResource> resource(fCache->findAndRefUniqueResource(fKeys[key]));
+        if (resource) {
+            return true;
+        }
+        resource.reset(new Resource(fContext->contextPriv().getGpu()));
+        resource->resourcePriv().setUniqueKey(fKeys[key]);
+        return false;
+    }
+
+    int count() const override { return fCache->getResourceCount(); }
+
+private:
+    static constexpr int kBudget = 1024;
+
+    class Resource : public GrGpuResource {
+    public:
+        explicit Resource(GrGpu* gpu) : INHERITED(gpu) {
+            this->registerWithCache(SkBudgeted::kYes);
+        }
+
+    private:
+        size_t onGpuMemorySize() const override { return 100; }
+        const char* getResourceType() const override { return "cachebench"; }
+
+        typedef GrGpuResource INHERITED;
+    };
+
+    sk_sp<GrContext>         fContext;
+    GrResourceCache*         fCache = nullptr;
+    std::vector<GrUniqueKey> fKeys;
+};
+
+// Each key is a blob ID. The cache's own ID is SK_InvalidUniqueID, so the SkTextBlob that stands in
+// for every key never posts purge messages to it.
+class TextBlobCacheDriver : public CacheDriver {
+public:
+    const char* name() const override { return "textblob"; }
+    int budget() const override { return kBudget; }
+
+    bool setup(int) override {
+        SkPaint paint;
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+        SkTextBlobBuilder builder;
+        const auto& run = builder.allocRun(paint, kGlyphCount, 0, 0);
+        for (int i = 0; i < kGlyphCount; ++i) {
+            run.glyphs[i] = i;
+        }
+        fBlob = builder.make();
+
+        fCache.reset(new GrTextBlobCache([](void*) {}, this, SK_InvalidUniqueID));
+        fBlobBytes = fCache->makeBlob(fBlob.get())->size();
+        fCache->setBudget(kBudget * fBlobBytes);
+        fBlurRec.fSigma = 0;
+        fBlurRec.fStyle = kNormal_SkBlurStyle;
+        return true;
+    }
+
+    bool lookup(int key) override {
+        GrTextBlob::Key k;
+        k.fUniqueID = key + 1;
+        if (sk_sp<GrTextBlob> blob = fCache->find(k)) {
+            fCache->makeMRU(blob.get());
+            return true;
+        }
+        fCache->makeCachedBlob(fBlob.get(), k, fBlurRec, fPaint);
+        return false;
+    }
+
+    int count() const override { return SkToInt(fCache->usedBytes() / fBlobBytes); }
+
+private:
+    static constexpr int kBudget = 1024;
+    static constexpr int kGlyphCount = 16;
+
+    std::unique_ptr<GrTextBlobCache> fCache;
+    sk_sp<SkTextBlob>                fBlob;
+    size_t                           fBlobBytes = 0;
+    SkMaskFilterBase::BlurRec        fBlurRec;
+    SkPaint                          fPaint;
+};
+
+// Each key is a path. An entry that gets evicted stays alive until its path changes or goes away,
+// as a listener on the path, so memory grows a little with each miss until the bench is deleted.
+class CCPRPathCacheDriver : public CacheDriver {
+public:
+    const char* name() const override { return "ccprpath"; }
+    int budget() const override { return GrCCPathCache::kMaxCacheCount; }
+
+    bool setup(int keyCount) override {
+        fShapes.reserve(keyCount);
+        for (int k = 0; k < keyCount; ++k) {
+            // Distinct points, in case small paths get keyed by their data.
+            SkPath path;
+            path.moveTo(0, 0);
+            path.lineTo(k + 1, 0);
+            path.lineTo(0, 10);
+            path.close();
+            fShapes.emplace_back(path);
+        }
+        return true;
+    }
+
+    bool lookup(int key) override {
+        auto entry = fCache.find(fShapes[key], fMaskTransform, GrCCPathCache::CreateIfAbsent::kYes);
+        return entry->hitCount() > 1;
+    }
+
+    int count() const override { return fCache.count(); }
+
+private:
+    static GrCCPathCache::MaskTransform IdentityTransform() {
+        SkIVector shift;
+        return GrCCPathCache::MaskTransform(SkMatrix::I(), &shift);
+    }
+
+    std::vector<GrShape>               fShapes;
+    GrCCPathCache                      fCache;
+    const GrCCPathCache::MaskTransform fMaskTransform = IdentityTransform();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Does next to nothing, but each variant is its own program.
+class VariantFP : public GrFragmentProcessor {
+public:
+    static std::unique_ptr<GrFragmentProcessor> Make(int variant) {
+        return std::unique_ptr<GrFragmentProcessor>(new VariantFP(variant));
+    }
+
+    const char* name() const override { return "CacheBenchVariant"; }
+
+    std::unique_ptr<GrFragmentProcessor> clone() const override { return Make(fVariant); }
+
+private:
+    explicit VariantFP(int variant)
+            : INHERITED(kCacheBenchFP_ClassID, kNone_OptimizationFlags), fVariant(variant) {}
+
+    GrGLSLFragmentProcessor* onCreateGLSLInstance() const override {
+        class GLSLVariantFP : public GrGLSLFragmentProcessor {
+        public:
+            void emitCode(EmitArgs& args) override {
+                const int variant = args.fFp.cast<VariantFP>().fVariant;
+                args.fFragBuilder->codeAppendf("%s = %s * half(%d) / half(%d);",
+                                               args.fOutputColor, args.fInputColor,
+                                               variant + 1, variant + 2);
+            }
+        };
+        return new GLSLVariantFP;
+    }
+
+    void onGetGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
+        b->add32(fVariant);
+    }
+
+    bool onIsEqual(const GrFragmentProcessor& that) const override {
+        return fVariant == that.cast<VariantFP>().fVariant;
+    }
+
+    const int fVariant;
+
+    typedef GrFragmentProcessor INHERITED;
+};
+
+/**
+ * Drives the backend's program (or pipeline state) cache by drawing with a working set of distinct
+ * programs. The GL and Vulkan caches both hold 128. Only builds with GR_GPU_STATS log hit_rate.
+ */
+class ProgramCacheBench : public Benchmark {
+public:
+    ProgramCacheBench(Order order, int workingSetPercent)
+            : fOrder(order)
+            , fKeyCount(SkTMax(1, kBudget * workingSetPercent / 100)) {
+        fName.printf("cache_program_%s_%d", order_name(order), workingSetPercent);
+    }
+
+    bool isSuitableFor(Backend backend) override { return kGPU_Backend == backend; }
+
+    void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+#if GR_GPU_STATS
+        if (!fGpu) {
+            return;
+        }
+        const int hits = fGpu->stats()->programCacheHits() - fStartHits;
+        const int misses = fGpu->stats()->programCacheMisses() - fStartMisses;
+        if (hits + misses > 0) {
+            keys->push_back(SkString("hit_rate"));
+            values->push_back((double)hits / (hits + misses));
+        }
+#endif
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override { fSequence = make_sequence(fOrder, fKeyCount); }
+
+    void onPerCanvasPreDraw(SkCanvas* canvas) override {
+        GrContext* context = canvas->getGrContext();
+        GrRenderTargetContext* rtc = canvas->internal_private_accessTopLayerRenderTargetContext();
+        if (!context || !rtc) {
+            return;
+        }
+        fGpu = context->contextPriv().getGpu();
+
+        // Start the timing from a warm cache.
+        const size_t warmup = SkTMin(fSequence.size(), (size_t)fKeyCount * 2);
+        for (size_t i = 0; i < warmup; ++i) {
+            this->draw(rtc, fSequence[i]);
+        }
+        context->flush();
+        fNext = warmup % fSequence.size();
+#if GR_GPU_STATS
+        fStartHits = fGpu->stats()->programCacheHits();
+        fStartMisses = fGpu->stats()->programCacheMisses();
+#endif
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        GrContext* context = canvas->getGrContext();
+        GrRenderTargetContext* rtc = canvas->internal_private_accessTopLayerRenderTargetContext();
+        if (!context || !rtc) {
+            return;
+        }
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < kDrawsPerLoop; ++j) {
+                this->draw(rtc, fSequence[fNext]);
+                if (++fNext == fSequence.size()) {
+                    fNext = 0;
+                }
+            }
+            context->flush();
+        }
+    }
+
+private:
+    // Misses compile a program, so keep the loops short.
+    static constexpr int kDrawsPerLoop = 32;
+    static constexpr int kBudget = 128;
+
+    void draw(GrRenderTargetContext* rtc, int variant) {
+        GrPaint paint;
+        paint.addColorFragmentProcessor(VariantFP::Make(variant));
+        paint.setPorterDuffXPFactory(SkBlendMode::kSrcOver);
+        rtc->drawRect(GrNoClip(), std::move(paint), GrAA::kNo, SkMatrix::I(),
+                      SkRect::MakeWH(4, 4));
+    }
+
+    const Order      fOrder;
+    const int        fKeyCount;
+    SkString         fName;
+    std::vector<int> fSequence;
+    size_t           fNext = 0;
+    GrGpu*           fGpu = nullptr;
+    int              fStartHits = 0;
+    int              fStartMisses = 0;
+
+    typedef Benchmark INHERITED;
+};
+
+#endif
+
+}  // namespace
+
+#define DEF_CACHE_BENCH(Driver, order, percent) \
+    DEF_BENCH(return new CacheBench(new Driver, Order::order, percent);)
+
+#define DEF_CACHE_BENCHES(Driver)              \
+    DEF_CACHE_BENCH(Driver, kUniform,  50)     \
+    DEF_CACHE_BENCH(Driver, kUniform, 100)     \
+    DEF_CACHE_BENCH(Driver, kUniform, 200)     \
+    DEF_CACHE_BENCH(Driver, kZipf,     50)     \
+    DEF_CACHE_BENCH(Driver, kZipf,    100)     \
+    DEF_CACHE_BENCH(Driver, kZipf,    200)     \
+    DEF_CACHE_BENCH(Driver, kScan,     50)     \
+    DEF_CACHE_BENCH(Driver, kScan,    100)     \
+    DEF_CACHE_BENCH(Driver, kScan,    200)
+
+DEF_CACHE_BENCHES(ResourceCacheDriver)
+DEF_CACHE_BENCHES(StrikeCacheDriver)
+DEF_CACHE_BENCHES(ImageFilterCacheDriver)
+
+#if SK_SUPPORT_GPU
+DEF_CACHE_BENCHES(GpuResourceCacheDriver)
+DEF_CACHE_BENCHES(TextBlobCacheDriver)
+DEF_CACHE_BENCHES(CCPRPathCacheDriver)
+
+DEF_BENCH(return new ProgramCacheBench(Order::kUniform,  50);)
+DEF_BENCH(return new ProgramCacheBench(Order::kUniform, 100);)
+DEF_BENCH(return new ProgramCacheBench(Order::kUniform, 200);)
+DEF_BENCH(return new ProgramCacheBench(Order::kZipf,     50);)
+DEF_BENCH(return new ProgramCacheBench(Order::kZipf,    100);)
+DEF_BENCH(return new ProgramCacheBench(Order::kZipf,    200);)
+DEF_BENCH(return new ProgramCacheBench(Order::kScan,     50);)
+DEF_BENCH(return new ProgramCacheBench(Order::kScan,    100);)
+DEF_BENCH(return new ProgramCacheBench(Order::kScan,    200);)
+#endif
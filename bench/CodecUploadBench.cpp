@@ -0,0 +1,189 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if SK_SUPPORT_GPU
+
+#include "SkCanvas.h"
+#include "SkCodec.h"
+#include "SkColorSpace.h"
+#include "SkData.h"
+#include "SkGradientShader.h"
+#include "SkImage.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkTime.h"
+
+/**
+ * Takes an encoded image all the way to the screen, the way a client does: MakeFromEncoded, a
+ * texture for the canvas' color space (decode, color conversion, upload and mip building all
+ * happen in there, and JPEGs may take the YUV path), then drawImageRect and wait for the GPU.
+ * CodecBench and ImageBench time these pieces alone; this one catches regressions in how they
+ * interact.
+ *
+ * The time is for the whole pipeline. Each phase's share is reported as a metric, along with the
+ * time a plain CPU decode takes, so that texture_ms can be split into decoding and uploading.
+ */
+class CodecUploadBench : public Benchmark {
+public:
+    CodecUploadBench(SkEncodedImageFormat format, int size, bool p3, bool mips)
+            : fFormat(format)
+            , fSize(size)
+            , fP3(p3)
+            , fMips(mips) {
+        const char* formatName = SkEncodedImageFormat::kPNG == format  ? "png"
+                               : SkEncodedImageFormat::kJPEG == format ? "jpeg"
+                                                                       : "webp";
+        fName.printf("codec_upload_draw_%s_%d_%s%s", formatName, size, p3 ? "p3" : "srgb",
+                     mips ? "_mips" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override { return kGPU_Backend == backend; }
+
+    void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        if (0 == fLoops) {
+            return;
+        }
+        keys->push_back(SkString("parse_ms"));
+        values->push_back(fParseMs / fLoops);
+        keys->push_back(SkString("texture_ms"));
+        values->push_back(fTextureMs / fLoops);
+        keys->push_back(SkString("draw_ms"));
+        values->push_back(fDrawMs / fLoops);
+
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fEncoded);
+        if (!codec) {
+            return;
+        }
+        SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+        if (fDstColorSpace) {
+            info = info.makeColorSpace(fDstColorSpace);
+        }
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        double best = 0;
+        for (int i = 0; i < 3; ++i) {
+            double start = SkTime::GetMSecs();
+            codec->getPixels(bitmap.pixmap());
+            double ms = SkTime::GetMSecs() - start;
+            best = i ? SkTMin(best, ms) : ms;
+        }
+        keys->push_back(SkString("decode_ms"));
+        values->push_back(best);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkColorSpace> colorSpace =
+                fP3 ? SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                                            SkColorSpace::kDCIP3_D65_Gamut)
+                    : SkColorSpace::MakeSRGB();
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeN32(fSize, fSize, kOpaque_SkAlphaType, colorSpace));
+
+        // A gradient with shapes and a little noise, so that no format gets away with nothing.
+        SkCanvas canvas(bitmap);
+        const SkPoint pts[] = {{0, 0}, {SkIntToScalar(fSize), SkIntToScalar(fSize)}};
+        const SkColor colors[] = {SK_ColorBLUE, SK_ColorYELLOW, SK_ColorRED};
+        SkPaint paint;
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                     SkShader::kClamp_TileMode));
+        canvas.drawPaint(paint);
+        paint.setShader(nullptr);
+        paint.setAntiAlias(true);
+        SkRandom random;
+        for (int i = 0; i < 50; ++i) {
+            paint.setColor(random.nextU() | 0xFF000000);
+            canvas.drawCircle(random.nextRangeScalar(0, fSize), random.nextRangeScalar(0, fSize),
+                              random.nextRangeScalar(fSize / 64.f, fSize / 8.f), paint);
+        }
+        for (int y = 0; y < fSize; ++y) {
+            uint32_t* row = bitmap.getAddr32(0, y);
+            for (int x = 0; x < fSize; ++x) {
+                row[x] ^= random.nextU() & 0x00070707;
+            }
+        }
+
+        // Not every build has every encoder; onDraw() does nothing without data.
+        fEncoded = SkEncodeBitmap(bitmap, fFormat, 90);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        GrContext* context = canvas->getGrContext();
+        if (!fEncoded || !context) {
+            return;
+        }
+        fDstColorSpace = canvas->imageInfo().refColorSpace();
+
+        SkPaint paint;
+        paint.setFilterQuality(fMips ? kMedium_SkFilterQuality : kLow_SkFilterQuality);
+        const SkRect dst = SkRect::MakeIWH(canvas->imageInfo().width(),
+                                           canvas->imageInfo().height());
+        const GrMipMapped mipMapped = fMips ? GrMipMapped::kYes : GrMipMapped::kNo;
+        for (int i = 0; i < loops; i++) {
+            double start = SkTime::GetMSecs();
+            sk_sp<SkImage> image = SkImage::MakeFromEncoded(fEncoded);
+            double parsed = SkTime::GetMSecs();
+            sk_sp<SkImage> texture = image->makeTextureImage(context, fDstColorSpace.get(),
+                                                             mipMapped);
+            finish(canvas);
+            double uploaded = SkTime::GetMSecs();
+            canvas->drawImageRect(texture, dst, &paint);
+            finish(canvas);
+            double drawn = SkTime::GetMSecs();
+
+            fParseMs   += parsed - start;
+            fTextureMs += uploaded - parsed;
+            fDrawMs    += drawn - uploaded;
+        }
+        fLoops += loops;
+    }
+
+private:
+    // Reading back a pixel waits for the GPU to get through everything before it.
+    static void finish(SkCanvas* canvas) {
+        uint32_t pixel;
+        canvas->flush();
+        canvas->readPixels(SkImageInfo::MakeN32Premul(1, 1), &pixel, sizeof(pixel), 0, 0);
+    }
+
+    const SkEncodedImageFormat fFormat;
+    const int                  fSize;
+    const bool                 fP3;
+    const bool                 fMips;
+    SkString                   fName;
+    sk_sp<SkData>              fEncoded;
+    sk_sp<SkColorSpace>        fDstColorSpace;
+
+    int64_t fLoops     = 0;
+    double  fParseMs   = 0;
+    double  fTextureMs = 0;
+    double  fDrawMs    = 0;
+
+    typedef Benchmark INHERITED;
+};
+
+#define DEF_CODEC_UPLOAD_BENCH(format, size, p3, mips) \
+    DEF_BENCH(return new CodecUploadBench(SkEncodedImageFormat::format, size, p3, mips);)
+
+#define DEF_CODEC_UPLOAD_BENCHES(format, size)             \
+    DEF_CODEC_UPLOAD_BENCH(format, size, false, false)     \
+    DEF_CODEC_UPLOAD_BENCH(format, size, false, true)      \
+    DEF_CODEC_UPLOAD_BENCH(format, size, true,  false)     \
+    DEF_CODEC_UPLOAD_BENCH(format, size, true,  true)
+
+DEF_CODEC_UPLOAD_BENCHES(kPNG, 512)
+DEF_CODEC_UPLOAD_BENCHES(kPNG, 2048)
+DEF_CODEC_UPLOAD_BENCHES(kJPEG, 512)
+DEF_CODEC_UPLOAD_BENCHES(kJPEG, 2048)
+DEF_CODEC_UPLOAD_BENCHES(kWEBP, 512)
+DEF_CODEC_UPLOAD_BENCHES(kWEBP, 2048)
+
+#endif
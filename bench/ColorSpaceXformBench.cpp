@@ -10,12 +10,13 @@
 #include "SkColor.h"
 #include "SkColorSpaceXformer.h"
 #include "SkColorSpaceXformSteps.h"
+#include "SkImage.h"
 #include "SkMakeUnique.h"
 #include "SkPM4f.h"
 #include "SkRandom.h"
 #include "SkRasterPipeline.h"
 
-enum class Mode { steps, pipeA, pipeB, xformer };
+enum class Mode { steps, pipeA, pipeB, xformer, image };
 
 struct ColorSpaceXformBench : public Benchmark {
     ColorSpaceXformBench(Mode mode) : fMode(mode) {}
@@ -30,6 +31,7 @@ struct ColorSpaceXformBench : public Benchmark {
     SkSTArenaAlloc<1024> fAlloc;
 
     std::unique_ptr<SkColorSpaceXformer> fXformer;
+    sk_sp<SkImage>                       fImage;
 
     const char* onGetName() override {
         switch (fMode) {
@@ -37,6 +39,7 @@ struct ColorSpaceXformBench : public Benchmark {
             case Mode::pipeA  : return "ColorSpaceXformBench_pipeA";
             case Mode::pipeB  : return "ColorSpaceXformBench_pipeB";
             case Mode::xformer: return "ColorSpaceXformBench_xformer";
+            case Mode::image  : return "ColorSpaceXformBench_image";
         }
         return "";
     }
@@ -59,6 +62,12 @@ struct ColorSpaceXformBench : public Benchmark {
         fPipeA = p.compile();
 
         fXformer = SkColorSpaceXformer::Make(dst);  // src is implicitly sRGB, what we want anyway
+
+        // An image drawn over and over through SkColorSpaceXformCanvas.
+        SkBitmap bm;
+        bm.allocN32Pixels(256, 256);
+        bm.eraseColor(0xFF4080C0);
+        fImage = SkImage::MakeFromBitmap(bm);
     }
 
     void onDraw(int n, SkCanvas* canvas) override {
@@ -95,6 +104,10 @@ struct ColorSpaceXformBench : public Benchmark {
                 case Mode::xformer: {
                     dst = fXformer->apply(src);
                 } break;
+
+                case Mode::image: {
+                    dst = fXformer->apply(fImage.get())->uniqueID();
+                } break;
             }
 
             if (false && i == 0) {
@@ -110,3 +123,4 @@ DEF_BENCH(return new ColorSpaceXformBench{Mode::steps  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::pipeA  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::pipeB  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::xformer};)
+DEF_BENCH(return new ColorSpaceXformBench{Mode::image  };)
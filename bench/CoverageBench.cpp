@@ -11,6 +11,7 @@
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkDraw.h"
+#include "SkGradientShader.h"
 #include "SkMatrix.h"
 #include "SkPath.h"
 #include "SkRasterClip.h"
@@ -69,7 +70,60 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// A spiky star filled with a gradient: nearly every scanline is a few short antialiased runs
+// along the edges, which the raster pipeline blitter shades a span at a time.
+class DrawShadedPathBench : public Benchmark {
+    SkPaint     fPaint;
+    SkPath      fPath;
+    SkRasterClip fRC;
+    SkAutoPixmapStorage fPixmap;
+    SkMatrix    fIdentity;
+    SkDraw      fDraw;
+public:
+    DrawShadedPathBench() {
+        fPaint.setAntiAlias(true);
+        SkPoint pts[] = {{0, 0}, {500, 500}};
+        SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        fPaint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                      SkShader::kClamp_TileMode));
+
+        const int kPoints = 97;
+        for (int i = 0; i < kPoints; ++i) {
+            SkScalar angle  = i * 44 * SK_ScalarPI * 2 / kPoints,
+                     radius = (i & 1) ? 120 : 245;
+            SkPoint p = {250 + radius * SkScalarCos(angle), 250 + radius * SkScalarSin(angle)};
+            i == 0 ? fPath.moveTo(p) : fPath.lineTo(p);
+        }
+        fPath.close();
+
+        fPixmap.alloc(SkImageInfo::MakeN32Premul(500, 500));
+        fPixmap.erase(SK_ColorWHITE);
+
+        fIdentity.setIdentity();
+        fRC.setRect(fPixmap.bounds());
+
+        fDraw.fDst      = fPixmap;
+        fDraw.fMatrix   = &fIdentity;
+        fDraw.fRC       = &fRC;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "draw_coverage_shaded";
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            fDraw.drawPath(fPath, fPaint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new DrawPathBench(false) )
 DEF_BENCH( return new DrawPathBench(true) )
+DEF_BENCH( return new DrawShadedPathBench() )
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkRSXform.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+
+// Many small sprites from one atlas in a single drawAtlas() call, like a game or a particle
+// system would draw them.
+class DrawAtlasBench : public Benchmark {
+    enum {
+        W = 640,
+        H = 480,
+        CELL = 16,
+        CELLS = 4,
+        N = 2000,
+    };
+
+    SkString       fName;
+    bool           fRotate;
+    bool           fColors;
+    sk_sp<SkImage> fAtlas;
+    SkRSXform      fXforms[N];
+    SkRect         fTex[N];
+    SkColor        fColorArray[N];
+
+public:
+    DrawAtlasBench(bool rotate, bool colors) : fRotate(rotate), fColors(colors) {
+        fName.printf("draw_atlas%s%s", rotate ? "_rotate" : "", colors ? "_colors" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        auto surface = SkSurface::MakeRasterN32Premul(CELL * CELLS, CELL * CELLS);
+        SkRandom rand;
+        for (int y = 0; y < CELLS; ++y) {
+            for (int x = 0; x < CELLS; ++x) {
+                SkPaint paint;
+                paint.setColor(rand.nextU() | 0xFF000000);
+                paint.setAntiAlias(true);
+                surface->getCanvas()->drawCircle((x + 0.5f) * CELL, (y + 0.5f) * CELL,
+                                                 CELL * 0.5f, paint);
+            }
+        }
+        fAtlas = surface->makeImageSnapshot();
+
+        for (int i = 0; i < N; ++i) {
+            int cell = rand.nextULessThan(CELLS * CELLS);
+            fTex[i] = SkRect::MakeXYWH((cell % CELLS) * CELL, (cell / CELLS) * CELL, CELL, CELL);
+            SkScalar radians = fRotate ? rand.nextRangeScalar(0, 2 * SK_ScalarPI) : 0;
+            fXforms[i] = SkRSXform::MakeFromRadians(1, radians,
+                                                    rand.nextRangeScalar(0, W - CELL),
+                                                    rand.nextRangeScalar(0, H - CELL),
+                                                    CELL * 0.5f, CELL * 0.5f);
+            fColorArray[i] = rand.nextU() | 0xFF000000;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setFilterQuality(kLow_SkFilterQuality);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawAtlas(fAtlas, fXforms, fTex, fColors ? fColorArray : nullptr, N,
+                              SkBlendMode::kModulate, nullptr, &paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new DrawAtlasBench(false, false);)
+DEF_BENCH(return new DrawAtlasBench(false, true);)
+DEF_BENCH(return new DrawAtlasBench(true, false);)
+DEF_BENCH(return new DrawAtlasBench(true, true);)
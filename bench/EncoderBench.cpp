@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "Resources.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "SkJpegEncoder.h"
 #include "SkPngEncoder.h"
 #include "SkWebpEncoder.h"
@@ -52,6 +53,19 @@ static bool encode_jpeg(SkWStream* dst, const SkPixmap& src) {
     return SkJpegEncoder::Encode(dst, src, opts);
 }
 
+static SkExecutor* encoder_thread_pool() {
+    static SkExecutor* gThreadPool = SkExecutor::MakeFIFOThreadPool(4).release();
+    return gThreadPool;
+}
+
+// Compresses strips of rows on four threads.
+static bool encode_jpeg_parallel(SkWStream* dst, const SkPixmap& src) {
+    SkJpegEncoder::Options opts;
+    opts.fQuality = 90;
+    opts.fExecutor = encoder_thread_pool();
+    return SkJpegEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_webp_lossy(SkWStream* dst, const SkPixmap& src) {
     SkWebpEncoder::Options opts;
     opts.fCompression = SkWebpEncoder::Compression::kLossy;
@@ -59,6 +73,14 @@ static bool encode_webp_lossy(SkWStream* dst, const SkPixmap& src) {
     return SkWebpEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_webp_lossy_multithreaded(SkWStream* dst, const SkPixmap& src) {
+    SkWebpEncoder::Options opts;
+    opts.fCompression = SkWebpEncoder::Compression::kLossy;
+    opts.fQuality = 90;
+    opts.fMultithreaded = true;
+    return SkWebpEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_webp_lossless(SkWStream* dst, const SkPixmap& src) {
     SkWebpEncoder::Options opts;
     opts.fCompression = SkWebpEncoder::Compression::kLossless;
@@ -79,15 +101,34 @@ static bool encode_png(SkWStream* dst,
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
            return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
 
+// Filters and deflates segments of rows on four threads.
+static bool encode_png_parallel(SkWStream* dst,
+                                const SkPixmap& src,
+                                SkPngEncoder::FilterFlag filters,
+                                int zlibLevel) {
+    SkPngEncoder::Options opts;
+    opts.fFilterFlags = filters;
+    opts.fZLibLevel = zlibLevel;
+    opts.fExecutor = encoder_thread_pool();
+    return SkPngEncoder::Encode(dst, src, opts);
+}
+
+#define PNG_PARALLEL(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
+           return encode_png_parallel(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
+
 static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg"};
 
 // The Android Photos app uses a quality of 90 on JPEG encodes
 DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg, "JPEG"));
 DEF_BENCH(return new EncodeBench(srcs[1], &encode_jpeg, "JPEG"));
+DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg_parallel, "JPEG_par"));
+DEF_BENCH(return new EncodeBench(srcs[1], &encode_jpeg_parallel, "JPEG_par"));
 
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossy, "WEBP"));
 DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossy, "WEBP"));
+DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossy_multithreaded, "WEBP_mt"));
+DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossy_multithreaded, "WEBP_mt"));
 
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossless, "WEBP_LL"));
 DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossless, "WEBP_LL"));
@@ -116,4 +157,10 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_PARALLEL(kAll, 6), "PNG_par"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_PARALLEL(kAll, 3), "PNG_par_3"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_PARALLEL(kAll, 1), "PNG_par_1"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_PARALLEL(kSub, 6), "PNG_par_6s"));
+
+#undef PNG_PARALLEL
 #undef PNG
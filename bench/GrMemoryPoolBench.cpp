@@ -9,10 +9,17 @@
 
 #include "Benchmark.h"
 #include "GrMemoryPool.h"
+#include "SkExecutor.h"
 #include "SkRandom.h"
+#include "SkString.h"
 #include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
+#if SK_SUPPORT_GPU
+#include "GrProcessor.h"
+#endif
+
 #include <new>
 
 // change this to 0 to compare GrMemoryPool to default new / delete
@@ -170,8 +177,75 @@ private:
     typedef Benchmark INHERITED;
 };
 
+#if SK_SUPPORT_GPU
+
+class BenchProcessor : public GrProcessor {
+public:
+    BenchProcessor() : INHERITED(kTestFP_ClassID) {}
+    const char* name() const override { return "BenchProcessor"; }
+
+private:
+    typedef GrProcessor INHERITED;
+};
+
+/**
+ * This benchmark creates and deletes processors in stack order on several threads at once, as
+ * DDL recorders do. Every thread does the same work, so with no contention the time per loop
+ * stays flat as threads are added.
+ */
+class GrMemoryPoolBenchThreaded : public Benchmark {
+public:
+    explicit GrMemoryPoolBenchThreaded(int threads) : fThreads(threads) {
+        fName.printf("grmemorypool_processor_threaded_%d", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fPool = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        enum {
+            kObjects = 1 << 10,
+        };
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup(*fPool).batch(fThreads, [](int) {
+                BenchProcessor* objects[kObjects];
+                for (int j = 0; j < kObjects; ++j) {
+                    objects[j] = new BenchProcessor;
+                }
+                for (int j = kObjects - 1; j >= 0; --j) {
+                    delete objects[j];
+                }
+            });
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fPool;
+
+    typedef Benchmark INHERITED;
+};
+
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new GrMemoryPoolBenchStack(); )
 DEF_BENCH( return new GrMemoryPoolBenchRandom(); )
 DEF_BENCH( return new GrMemoryPoolBenchQueue(); )
+#if SK_SUPPORT_GPU
+DEF_BENCH( return new GrMemoryPoolBenchThreaded(1); )
+DEF_BENCH( return new GrMemoryPoolBenchThreaded(4); )
+DEF_BENCH( return new GrMemoryPoolBenchThreaded(8); )
+#endif
@@ -36,6 +36,12 @@ static const SkColor gColors[] = {
 static const SkColor gShallowColors[] = { 0xFF555555, 0xFF444444 };
 static const SkScalar gPos[] = {0.25f, 0.75f};
 
+// Unevenly spaced, like the stops of a data visualization color scale.
+static const SkScalar gPos20[] = {
+    0.00f, 0.06f, 0.10f, 0.16f, 0.21f, 0.27f, 0.31f, 0.37f, 0.42f, 0.48f,
+    0.52f, 0.58f, 0.63f, 0.69f, 0.73f, 0.79f, 0.84f, 0.90f, 0.94f, 1.00f,
+};
+
 // We have several special-cases depending on the number (and spacing) of colors, so
 // try to exercise those here.
 static const GradData gGradData[] = {
@@ -44,6 +50,7 @@ static const GradData gGradData[] = {
     { 3, gColors, nullptr, "_3color" },
     { 2, gShallowColors, nullptr, "_shallow" },
     { 2, gColors, gPos, "_pos" },
+    { 20, gColors, gPos20, "_20pos" }, // many stops that have to be searched for, or resampled
 };
 
 /// Ignores scale
@@ -282,6 +289,7 @@ DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[2], SkShader::kM
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0]); )
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[2]); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[5]); )
 // Draw a radial gradient of radius 1/2 on a rectangle; half the lines should
 // be completely pinned, the other half should pe partially pinned
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0], SkShader::kClamp_TileMode, kRect_GeomType, 0.5f); )
@@ -295,6 +303,7 @@ DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0], SkShader::kR
 DEF_BENCH( return new GradientBench(kSweep_GradType); )
 DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[2]); )
+DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[5]); )
 DEF_BENCH( return new GradientBench(kConical_GradType); )
 DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[2]); )
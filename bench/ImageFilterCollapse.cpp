@@ -13,6 +13,7 @@
 #include "SkGradientShader.h"
 #include "SkImageFilter.h"
 #include "SkTableColorFilter.h"
+#include "SkXfermodeImageFilter.h"
 
 // Chains several matrix color filters image filter or several
 // table filter image filters and draws a bitmap.
@@ -34,6 +35,11 @@ protected:
         }
     }
 
+    void setImageFilter(sk_sp<SkImageFilter> imageFilter) {
+        SkASSERT(!fImageFilter);
+        fImageFilter = std::move(imageFilter);
+    }
+
     void onDraw(int loops, SkCanvas* canvas) override {
         makeBitmap();
 
@@ -133,5 +139,33 @@ protected:
     }
 };
 
+// Blends two color filtered copies of the bitmap. The blend applies both color filters as it
+// draws its inputs, unless the color filters are cropped, which makes each one a pass of its own.
+class BlendFuseBench: public BaseImageFilterCollapseBench {
+public:
+    BlendFuseBench(bool fused) : fFused(fused) {}
+
+protected:
+    const char* onGetName() override {
+        return fFused ? "image_filter_fuse_blend" : "image_filter_fuse_blend_unfused";
+    }
+
+    void onDelayedSetup() override {
+        const SkImageFilter::CropRect everything(SkRect::MakeLTRB(-1000, -1000, 1000, 1000));
+        const SkImageFilter::CropRect* crop = fFused ? nullptr : &everything;
+        sk_sp<SkColorFilter> tint = SkColorMatrixFilter::MakeLightingFilter(0xFFC0A080, 0);
+        this->setImageFilter(SkXfermodeImageFilter::Make(
+                SkBlendMode::kMultiply,
+                SkColorFilterImageFilter::Make(make_grayscale(), nullptr, crop),
+                SkColorFilterImageFilter::Make(std::move(tint), nullptr, crop),
+                nullptr));
+    }
+
+private:
+    const bool fFused;
+};
+
 DEF_BENCH(return new TableCollapseBench;)
 DEF_BENCH(return new MatrixCollapseBench;)
+DEF_BENCH(return new BlendFuseBench(true);)
+DEF_BENCH(return new BlendFuseBench(false);)
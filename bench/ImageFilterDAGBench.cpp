@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "Resources.h"
+#include "SkBitmapDevice.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
 #include "SkDisplacementMapEffect.h"
@@ -87,6 +88,54 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// The same kind of DAG over a clip big enough for raster devices to filter it in tiles. The
+// untiled variant filters it in one piece, with full size intermediates for every node. Both
+// draw into a device of their own, so that the tile size can be set on it.
+class ImageFilterLargeDAGBench : public Benchmark {
+public:
+    ImageFilterLargeDAGBench(bool tiled) : fTiled(tiled) {}
+
+    bool isSuitableFor(Backend backend) override { return kRaster_Backend == backend; }
+
+protected:
+    const char* onGetName() override {
+        return fTiled ? "image_filter_dag_2048" : "image_filter_dag_2048_untiled";
+    }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(kSize, kSize); }
+
+    void onDelayedSetup() override {
+        fDevice.reset(SkBitmapDevice::Create(SkImageInfo::MakeN32Premul(kSize, kSize)));
+        if (!fTiled) {
+            fDevice->setImageFilterTileSize(0);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas canvas(fDevice);
+        const SkRect rect = SkRect::MakeLTRB(64, 64, kSize - 64, kSize - 64);
+
+        for (int j = 0; j < loops; j++) {
+            sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(20.0f, 20.0f, nullptr));
+            sk_sp<SkImageFilter> inputs[kNumInputs];
+            for (int i = 0; i < kNumInputs; ++i) {
+                inputs[i] = SkOffsetImageFilter::Make(i * 10.0f, i * 10.0f, blur);
+            }
+            SkPaint paint;
+            paint.setImageFilter(SkMergeImageFilter::Make(inputs, kNumInputs));
+            canvas.drawRect(rect, paint);
+        }
+    }
+
+private:
+    static const int kNumInputs = 5;
+    static const int kSize = 2048;
+    const bool fTiled;
+    sk_sp<SkBitmapDevice> fDevice;
+
+    typedef Benchmark INHERITED;
+};
+
 // Exercise a blur filter connected to both inputs of an SkDisplacementMapEffect.
 
 class ImageFilterDisplacedBlur : public Benchmark {
@@ -145,6 +194,8 @@ private:
 };
 
 DEF_BENCH(return new ImageFilterDAGBench;)
+DEF_BENCH(return new ImageFilterLargeDAGBench(true);)
+DEF_BENCH(return new ImageFilterLargeDAGBench(false);)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
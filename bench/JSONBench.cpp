@@ -55,6 +55,55 @@ private:
 
 DEF_BENCH( return new JsonBench; )
 
+// Synthetic input dominated by long strings, like Lottie files with embedded (base64) images.
+class JsonLongStringsBench : public Benchmark {
+public:
+
+protected:
+    const char* onGetName() override { return "json_skjson_longstrings"; }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        static constexpr int kAssetCount  = 32,
+                             kAssetLength = 64 * 1024;
+        static constexpr char kBase64[] =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        SkDynamicMemoryWStream stream;
+        stream.writeText("{ \"assets\": [");
+        for (int i = 0; i < kAssetCount; ++i) {
+            stream.writeText(i ? ", " : "");
+            stream.writeText("{ \"id\": \"image_");
+            stream.writeDecAsText(i);
+            stream.writeText("\", \"p\": \"data:image/png;base64,");
+            for (int j = 0; j < kAssetLength; ++j) {
+                stream.write8(kBase64[(i + j * 7) % (SK_ARRAY_COUNT(kBase64) - 1)]);
+            }
+            stream.writeText("\" }");
+        }
+        stream.writeText("] }");
+        fData = stream.detachAsData();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            skjson::DOM dom(static_cast<const char*>(fData->data()), fData->size());
+            if (dom.root().is<skjson::NullValue>()) {
+                SkDebugf("!! Parsing failed.\n");
+                return;
+            }
+        }
+    }
+
+private:
+    sk_sp<SkData> fData;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new JsonLongStringsBench; )
+
 #if (0)
 
 #include "rapidjson/document.h"
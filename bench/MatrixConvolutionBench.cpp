@@ -10,6 +10,7 @@
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 static const char* name(SkMatrixConvolutionImageFilter::TileMode mode) {
     switch (mode) {
@@ -22,19 +23,24 @@ static const char* name(SkMatrixConvolutionImageFilter::TileMode mode) {
 
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(SkMatrixConvolutionImageFilter::TileMode tileMode, bool convolveAlpha)
+    MatrixConvolutionBench(SkMatrixConvolutionImageFilter::TileMode tileMode, bool convolveAlpha,
+                           int kernelWidth = 3)
         : fName(SkStringPrintf("matrixconvolution_%s%s",
                                name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        SkISize kernelSize = SkISize::Make(3, 3);
-        SkScalar kernel[9] = {
-            SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-            SkIntToScalar( 1), SkIntToScalar(-7), SkIntToScalar( 1),
-            SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-        };
+        if (kernelWidth != 3) {
+            fName.appendf("_%dx%d", kernelWidth, kernelWidth);
+        }
+        // A box with a negative center; the wider kernels exercise the vectorized inner loop.
+        SkISize kernelSize = SkISize::Make(kernelWidth, kernelWidth);
+        SkAutoTArray<SkScalar> kernel(kernelWidth * kernelWidth);
+        for (int i = 0; i < kernelWidth * kernelWidth; ++i) {
+            kernel[i] = SK_Scalar1;
+        }
+        kernel[kernelWidth * kernelWidth / 2] = SkIntToScalar(2 - kernelWidth * kernelWidth);
         SkScalar gain = 0.3f, bias = SkIntToScalar(100);
-        SkIPoint kernelOffset = SkIPoint::Make(1, 1);
-        fFilter = SkMatrixConvolutionImageFilter::Make(kernelSize, kernel, gain, bias,
+        SkIPoint kernelOffset = SkIPoint::Make(kernelWidth / 2, kernelWidth / 2);
+        fFilter = SkMatrixConvolutionImageFilter::Make(kernelSize, kernel.get(), gain, bias,
                                                        kernelOffset, tileMode, convolveAlpha,
                                                        nullptr);
     }
@@ -68,3 +74,5 @@ DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kCl
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kRepeat_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, false); )
+DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClamp_TileMode, true, 5); )
+DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kRepeat_TileMode, true, 7); )
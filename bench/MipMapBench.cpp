@@ -13,15 +13,17 @@ class MipMapBench: public Benchmark {
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
-    bool fHalfFoat;
+    const SkColorType fColorType;
 
 public:
-    MipMapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipMapBench(int w, int h, SkColorType ct = kN32_SkColorType)
+        : fW(w), fH(h), fColorType(ct)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
-        if (halfFloat) {
+        if (kRGBA_F16_SkColorType == ct) {
             fName.append("_f16");
+        } else if (kAlpha_8_SkColorType == ct) {
+            fName.append("_a8");
         }
     }
 
@@ -33,8 +35,7 @@ protected:
     const char* onGetName() override { return fName.c_str(); }
 
     void onDelayedSetup() override {
-        SkColorType ct = fHalfFoat ? kRGBA_F16_SkColorType : kN32_SkColorType;
-        SkImageInfo info = SkImageInfo::Make(fW, fH, ct, kPremul_SkAlphaType,
+        SkImageInfo info = SkImageInfo::Make(fW, fH, fColorType, kPremul_SkAlphaType,
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
@@ -58,10 +59,53 @@ DEF_BENCH( return new MipMapBench(512, 511); )
 DEF_BENCH( return new MipMapBench(511, 512); )
 DEF_BENCH( return new MipMapBench(512, 512); )
 
-DEF_BENCH( return new MipMapBench(512, 512, true); )
-DEF_BENCH( return new MipMapBench(511, 511, true); )
+DEF_BENCH( return new MipMapBench(512, 512, kRGBA_F16_SkColorType); )
+DEF_BENCH( return new MipMapBench(511, 511, kRGBA_F16_SkColorType); )
+
+DEF_BENCH( return new MipMapBench(512, 512, kAlpha_8_SkColorType); )
+DEF_BENCH( return new MipMapBench(511, 511, kAlpha_8_SkColorType); )
 
 DEF_BENCH( return new MipMapBench(2048, 2048); )
 DEF_BENCH( return new MipMapBench(2047, 2047); )
 DEF_BENCH( return new MipMapBench(2048, 2047); )
 DEF_BENCH( return new MipMapBench(2047, 2048); )
+
+// Refreshes the mipmap after a small part of the base image changes, compared with the full
+// rebuild done by mipmap_build_2048x2048.
+class MipMapRefreshBench: public Benchmark {
+    SkBitmap fBitmap;
+    sk_sp<SkMipMap> fMipMap;
+    SkString fName;
+    const int fDirtySize;
+
+public:
+    MipMapRefreshBench(int dirtySize) : fDirtySize(dirtySize) {
+        fName.printf("mipmap_refresh_2048x2048_dirty%d", dirtySize);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(2048, 2048);
+        fBitmap.eraseColor(SK_ColorWHITE);
+        fMipMap.reset(SkMipMap::Build(fBitmap, nullptr));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect dirty = SkIRect::MakeXYWH(1000, 600, fDirtySize, fDirtySize);
+        for (int i = 0; i < loops * 4; i++) {
+            fMipMap->refresh(fBitmap.pixmap(), dirty);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new MipMapRefreshBench(64); )
+DEF_BENCH( return new MipMapRefreshBench(512); )
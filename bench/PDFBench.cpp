@@ -73,6 +73,7 @@ DEF_BENCH(return new PDFScalarBench("PDFScalar_random", next_any);)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "SkDeflate.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFDocumentPriv.h"
 #include "SkPDFShader.h"
@@ -199,6 +200,39 @@ private:
     std::unique_ptr<SkStreamAsset> fAsset;
 };
 
+/** Test SkDeflateWStream at one compression level on the same command stream,
+    to compare each level's throughput. */
+class PDFDeflateLevelBench : public Benchmark {
+public:
+    explicit PDFDeflateLevelBench(int level) : fLevel(level) {
+        fName.printf("PDFDeflate_level_%d", level);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        fData = GetResourceAsData("pdf_command_stream.txt");
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkASSERT(fData);
+        if (!fData) { return; }
+        while (loops-- > 0) {
+            SkNullWStream out;
+            SkDeflateWStream deflateWStream(&out, fLevel);
+            deflateWStream.write(fData->data(), fData->size());
+            deflateWStream.finalize();
+        }
+    }
+
+private:
+    int fLevel;
+    SkString fName;
+    sk_sp<SkData> fData;
+};
+
 struct PDFColorComponentBench : public Benchmark {
     bool isSuitableFor(Backend b) override {
         return b == kNonRendering_Backend;
@@ -262,6 +296,9 @@ struct WritePDFTextBenchmark : public Benchmark {
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
 DEF_BENCH(return new PDFCompressionBench;)
+DEF_BENCH(return new PDFDeflateLevelBench(1);)
+DEF_BENCH(return new PDFDeflateLevelBench(6);)
+DEF_BENCH(return new PDFDeflateLevelBench(9);)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
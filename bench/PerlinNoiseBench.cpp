@@ -10,20 +10,35 @@
 #include "SkShader.h"
 
 class PerlinNoiseBench : public Benchmark {
-    SkISize fSize;
+    SkISize  fSize;
+    bool     fTurbulence;
+    bool     fStitchTiles;
+    SkString fName;
 
 public:
-    PerlinNoiseBench()  {
-        fSize = SkISize::Make(80, 80);
+    PerlinNoiseBench(int size = 80, bool turbulence = false, bool stitchTiles = false)
+        : fSize(SkISize::Make(size, size))
+        , fTurbulence(turbulence)
+        , fStitchTiles(stitchTiles) {
+        fName.set("perlinnoise");
+        if (turbulence) {
+            fName.append("_turbulence");
+        }
+        if (stitchTiles) {
+            fName.append("_stitched");
+        }
+        if (size != 80) {
+            fName.appendf("_%d", size);
+        }
     }
 
 protected:
     const char* onGetName() override {
-        return "perlinnoise";
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
-        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, 3, 0, false);
+        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, 3, 0, fStitchTiles);
     }
 
 private:
@@ -42,9 +57,12 @@ private:
               float baseFrequencyX, float baseFrequencyY, int numOctaves, float seed,
               bool stitchTiles) {
         SkPaint paint;
-        paint.setShader(SkPerlinNoiseShader::MakeFractalNoise(baseFrequencyX, baseFrequencyY,
-                                                              numOctaves, seed,
-                                                              stitchTiles ? &fSize : nullptr));
+        const SkISize* tileSize = stitchTiles ? &fSize : nullptr;
+        paint.setShader(fTurbulence
+                ? SkPerlinNoiseShader::MakeTurbulence(baseFrequencyX, baseFrequencyY,
+                                                      numOctaves, seed, tileSize)
+                : SkPerlinNoiseShader::MakeFractalNoise(baseFrequencyX, baseFrequencyY,
+                                                        numOctaves, seed, tileSize));
         for (int i = 0; i < loops; i++) {
             this->drawClippedRect(canvas, x, y, paint);
         }
@@ -56,3 +74,7 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new PerlinNoiseBench(); )
+DEF_BENCH( return new PerlinNoiseBench(80, true); )
+DEF_BENCH( return new PerlinNoiseBench(80, false, true); )
+DEF_BENCH( return new PerlinNoiseBench(512); )
+DEF_BENCH( return new PerlinNoiseBench(512, true, true); )
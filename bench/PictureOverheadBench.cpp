@@ -6,7 +6,8 @@
  */
 
 // A benchmark designed to isolate the constant overheads of picture recording.
-// We record an empty picture and a picture with one draw op to force memory allocation.
+// We record an empty picture, and pictures with a few draw ops (which SkMiniRecorder can hold
+// inline) or too many (which force memory allocation).
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
@@ -56,10 +57,12 @@ struct PictureOverheadBench : public Benchmark {
 DEF_BENCH(return (new PictureOverheadBench<0, false>);)
 DEF_BENCH(return (new PictureOverheadBench<1, false>);)
 DEF_BENCH(return (new PictureOverheadBench<2, false>);)
+DEF_BENCH(return (new PictureOverheadBench<6, false>);)
 DEF_BENCH(return (new PictureOverheadBench<10,false>);)
 DEF_BENCH(return (new PictureOverheadBench<0,  true>);)
 DEF_BENCH(return (new PictureOverheadBench<1,  true>);)
 DEF_BENCH(return (new PictureOverheadBench<2,  true>);)
+DEF_BENCH(return (new PictureOverheadBench<6,  true>);)
 DEF_BENCH(return (new PictureOverheadBench<10, true>);)
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
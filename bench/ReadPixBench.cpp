@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkColorSpace.h"
 
 
 /**
@@ -64,6 +65,53 @@ private:
 };
 DEF_BENCH( return new ReadPixBench(); )
 
+// Reads back a whole large image while converting it, which SkConvertPixels splits into bands
+// of rows across the default SkExecutor's threads.
+class LargeReadPixBench : public Benchmark {
+public:
+    LargeReadPixBench(SkColorType dstCT, sk_sp<SkColorSpace> dstCS, const char* label)
+        : fDstInfo(SkImageInfo::Make(kSize, kSize, dstCT, kPremul_SkAlphaType, std::move(dstCS)))
+        , fName(SkStringPrintf("readpix_large_%s", label)) {}
+
+protected:
+    void onDelayedSetup() override {
+        fSrc.allocPixels(SkImageInfo::MakeS32(kSize, kSize, kPremul_SkAlphaType));
+        fSrc.eraseColor(0x88336699);
+        fDst.allocPixels(fDstInfo);
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            fSrc.readPixels(fDst.pixmap());
+        }
+    }
+
+private:
+    static const int kSize = 4096;
+
+    SkImageInfo fDstInfo;
+    SkString    fName;
+    SkBitmap    fSrc, fDst;
+
+    typedef Benchmark INHERITED;
+};
+DEF_BENCH( return new LargeReadPixBench(kBGRA_8888_SkColorType, SkColorSpace::MakeSRGB(),
+                                        "bgra"); )
+DEF_BENCH( return new LargeReadPixBench(kRGBA_F16_SkColorType, SkColorSpace::MakeSRGBLinear(),
+                                        "f16_linear"); )
+DEF_BENCH( return new LargeReadPixBench(kRGBA_8888_SkColorType,
+                                        SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                                                              SkColorSpace::kDCIP3_D65_Gamut),
+                                        "p3"); )
+
 ////////////////////////////////////////////////////////////////////////////////
 #include "SkBitmap.h"
 #include "SkPixmapPriv.h"
@@ -154,6 +154,18 @@ protected:
     const char* onGetName() override { return computeName("rrects"); }
 };
 
+// Small rounded rects with a fixed corner radius, like the buttons of a UI.
+class ButtonRRectBench : public RectBench {
+public:
+    ButtonRRectBench() : RectBench(3) {}
+protected:
+    void drawThisRect(SkCanvas* c, const SkRect& r, const SkPaint& p) override {
+        SkRect button = SkRect::MakeXYWH(r.fLeft, r.fTop, 96, 28);
+        c->drawRoundRect(button, 6, 6, p);
+    }
+    const char* onGetName() override { return "rrects_buttons"; }
+};
+
 class PointsBench : public RectBench {
 public:
     SkCanvas::PointMode fMode;
@@ -285,6 +297,7 @@ DEF_BENCH(return new RRectBench(1);)
 DEF_BENCH(return new RRectBench(1, 4);)
 DEF_BENCH(return new RRectBench(3);)
 DEF_BENCH(return new RRectBench(3, 4);)
+DEF_BENCH(return new ButtonRRectBench();)
 DEF_BENCH(return new PointsBench(SkCanvas::kPoints_PointMode, "points");)
 DEF_BENCH(return new PointsBench(SkCanvas::kLines_PointMode, "lines");)
 DEF_BENCH(return new PointsBench(SkCanvas::kPolygon_PointMode, "polygon");)
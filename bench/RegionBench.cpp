@@ -8,6 +8,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -129,3 +130,41 @@ DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+
+// Unions many small rects at once, like accumulating damage for a frame.
+class RegionSetRectsBench : public Benchmark {
+public:
+    RegionSetRectsBench(int count) {
+        fName.printf("region_setrects_%d", count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            *fRects.append() = SkIRect::MakeXYWH(rand.nextULessThan(1024), rand.nextULessThan(768),
+                                                 4 + rand.nextULessThan(60),
+                                                 4 + rand.nextULessThan(40));
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            rgn.setRects(fRects.begin(), fRects.count());
+        }
+    }
+
+private:
+    SkTDArray<SkIRect> fRects;
+    SkString           fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new RegionSetRectsBench(SMALL);)
+DEF_BENCH(return new RegionSetRectsBench(1000);)
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkGradientShader.h"
+
+// Makes a thumbnail of a large image.  kMedium_SkFilterQuality builds mipmaps and samples them;
+// kHigh_SkFilterQuality filters the whole image with SkBitmapScaler.
+class ScalePixelsBench : public Benchmark {
+public:
+    ScalePixelsBench(int reduction, SkFilterQuality quality, const char* label)
+        : fReduction(reduction)
+        , fQuality(quality)
+        , fName(SkStringPrintf("scalepixels_%dx_%s", reduction, label)) {}
+
+protected:
+    void onDelayedSetup() override {
+        fSrc.allocN32Pixels(kSize, kSize);
+        SkCanvas canvas(fSrc);
+        SkPaint paint;
+        SkPoint pts[] = {{0, 0}, {kSize, kSize}};
+        SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                    SkShader::kMirror_TileMode));
+        canvas.drawPaint(paint);
+
+        fDst.allocN32Pixels(kSize / fReduction, kSize / fReduction);
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            fSrc.pixmap().scalePixels(fDst.pixmap(), fQuality);
+        }
+    }
+
+private:
+    static const int kSize = 4096;
+
+    int             fReduction;
+    SkFilterQuality fQuality;
+    SkString        fName;
+    SkBitmap        fSrc, fDst;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ScalePixelsBench(10, kMedium_SkFilterQuality, "medium"); )
+DEF_BENCH( return new ScalePixelsBench(10, kHigh_SkFilterQuality,   "high"); )
+DEF_BENCH( return new ScalePixelsBench(40, kMedium_SkFilterQuality, "medium"); )
+DEF_BENCH( return new ScalePixelsBench(40, kHigh_SkFilterQuality,   "high"); )
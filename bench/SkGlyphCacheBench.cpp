@@ -10,12 +10,18 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkStrikeCache.h"
 #include "SkGraphics.h"
+#include "SkRandom.h"
+#include "SkTFlatHash.h"
+#include "SkTHash.h"
 #include "SkTaskGroup.h"
 #include "SkTypeface.h"
 #include "sk_tool_utils.h"
 
+#include <vector>
+
 
 static void do_font_stuff(SkPaint* paint) {
     for (SkScalar i = 8; i < 64; i++) {
@@ -109,7 +115,159 @@ private:
     SkString fName;
 };
 
+// Every thread does the same work, so with no contention the time per loop stays flat as
+// threads are added.
+class SkGlyphCacheThreaded : public Benchmark {
+public:
+    explicit SkGlyphCacheThreaded(int threads) : fThreads(threads) {
+        fName.printf("SkGlyphCacheThreaded%d", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fPool = SkExecutor::MakeFIFOThreadPool(fThreads);
+        fTypefaces[0] = sk_tool_utils::create_portable_typeface("serif", SkFontStyle::Italic());
+        fTypefaces[1] = sk_tool_utils::create_portable_typeface("sans-serif", SkFontStyle());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int work = 0; work < loops; work++) {
+            SkTaskGroup(*fPool).batch(fThreads, [&](int threadIndex) {
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                paint.setSubpixelText(true);
+                paint.setTypeface(fTypefaces[threadIndex % 2]);
+                do_font_stuff(&paint);
+            });
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const int                   fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fPool;
+    sk_sp<SkTypeface>           fTypefaces[2];
+};
+
+// Rasterizes a fresh strike's worth of glyphs each loop, one at a time or all together with
+// prepareImages(), which splits them among tasks on the default executor.
+class SkGlyphCacheColdImages : public Benchmark {
+public:
+    explicit SkGlyphCacheColdImages(bool batched) : fBatched(batched) {
+        fName.printf("SkGlyphCacheColdImages_%s", batched ? "batched" : "serial");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fPaint.setAntiAlias(true);
+        fPaint.setTypeface(sk_tool_utils::create_portable_typeface("serif", SkFontStyle()));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int work = 0; work < loops; work++) {
+            SkGraphics::PurgeFontCache();
+            fPaint.setTextSize(24 + (work % 32));
+            auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
+                    fPaint, nullptr, SkScalerContextFlags::kNone, nullptr);
+            uint16_t glyphIDs['z' - ' '];
+            for (int c = ' '; c < 'z'; c++) {
+                glyphIDs[c - ' '] = cache->unicharToGlyph(c);
+                cache->getGlyphIDMetrics(glyphIDs[c - ' ']);
+            }
+            const SkGlyph* glyphs['z' - ' '];
+            for (int i = 0; i < 'z' - ' '; i++) {
+                glyphs[i] = &cache->getGlyphIDMetrics(glyphIDs[i]);
+                if (!fBatched) {
+                    cache->findImage(*glyphs[i]);
+                }
+            }
+            if (fBatched) {
+                cache->prepareImages(glyphs);
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const bool fBatched;
+    SkString   fName;
+    SkPaint    fPaint;
+};
+
+// Looks up glyphs, at a mix of subpixel positions, in SkGlyphCache's glyph map; run on both
+// SkTHashTable and the SkTFlatHashTable it now uses.
+template <typename Map>
+class GlyphMapLookupBench : public Benchmark {
+public:
+    GlyphMapLookupBench(const char* name, int glyphs) : fGlyphs(glyphs) {
+        fName.printf("glyph_map_lookup_%s_%d", name, glyphs);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < fGlyphs; i++) {
+            SkGlyph glyph;
+            glyph.initWithGlyphID(SkPackedGlyphID(rand.nextULessThan(3000),
+                                                  (rand.nextU() & 3) << 14,
+                                                  (rand.nextU() & 3) << 14));
+            fMap.set(glyph);
+            fIDs.push_back(glyph.getPackedID());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        int found = 0;
+        for (int i = 0; i < loops; i++) {
+            for (SkPackedGlyphID id : fIDs) {
+                found += fMap.find(id) != nullptr;
+            }
+        }
+        sk_ignore_unused_variable(found);
+    }
+
+private:
+    const int                    fGlyphs;
+    SkString                     fName;
+    Map                          fMap;
+    std::vector<SkPackedGlyphID> fIDs;
+
+    typedef Benchmark INHERITED;
+};
+
+using THashGlyphMap = SkTHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits>;
+using FlatGlyphMap  = SkTFlatHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits>;
+
+DEF_BENCH( return new GlyphMapLookupBench<THashGlyphMap>("thash", 1000); )
+DEF_BENCH( return new GlyphMapLookupBench<FlatGlyphMap>("flat", 1000); )
+DEF_BENCH( return new GlyphMapLookupBench<THashGlyphMap>("thash", 10000); )
+DEF_BENCH( return new GlyphMapLookupBench<FlatGlyphMap>("flat", 10000); )
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheThreaded(1); )
+DEF_BENCH( return new SkGlyphCacheThreaded(4); )
+DEF_BENCH( return new SkGlyphCacheThreaded(16); )
+DEF_BENCH( return new SkGlyphCacheThreaded(32); )
+DEF_BENCH( return new SkGlyphCacheColdImages(false); )
+DEF_BENCH( return new SkGlyphCacheColdImages(true); )
@@ -6,8 +6,11 @@
  */
 
 #include "Benchmark.h"
+#include "SkExecutor.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
 #include "../src/jumper/SkJumper.h"
 
 static const int N = 15;
@@ -67,6 +70,49 @@ public:
 DEF_BENCH( return (new SkRasterPipelineBench< true>); )
 DEF_BENCH( return (new SkRasterPipelineBench<false>); )
 
+// The same kind of pipeline without any sRGB conversion, which lets 8888 run in lowp. F16 always
+// runs in highp.
+class SkRasterPipelineBlendBench : public Benchmark {
+public:
+    SkRasterPipelineBlendBench(bool f16, SkRasterPipeline::StockStage blend, const char* blendName)
+        : fF16(f16)
+        , fBlend(blend)
+        , fName(SkStringPrintf("SkRasterPipeline_%s_%s", f16 ? "f16" : "8888", blendName)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkJumper_MemoryCtx mask_ctx = {mask, 0},
+                            src_ctx = {src,  0},
+                            dst_ctx = {dst,  0};
+
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::load_8888, &src_ctx);
+        p.append(SkRasterPipeline::scale_u8, &mask_ctx);
+        p.append(fF16 ? SkRasterPipeline::load_f16_dst : SkRasterPipeline::load_8888_dst,
+                 &dst_ctx);
+        p.append(fBlend);
+        p.append(fF16 ? SkRasterPipeline::store_f16 : SkRasterPipeline::store_8888, &dst_ctx);
+
+        while (loops --> 0) {
+            p.run(0,0,N,1);
+        }
+    }
+private:
+    bool                          fF16;
+    SkRasterPipeline::StockStage  fBlend;
+    SkString                      fName;
+};
+DEF_BENCH( return new SkRasterPipelineBlendBench(true,  SkRasterPipeline::srcover,  "srcover" ); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(false, SkRasterPipeline::srcover,  "srcover" ); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(true,  SkRasterPipeline::modulate, "modulate"); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(false, SkRasterPipeline::modulate, "modulate"); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(true,  SkRasterPipeline::multiply, "multiply"); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(false, SkRasterPipeline::multiply, "multiply"); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(true,  SkRasterPipeline::screen,   "screen"  ); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(false, SkRasterPipeline::screen,   "screen"  ); )
+
 class SkRasterPipelineCompileVsRunBench : public Benchmark {
 public:
     explicit SkRasterPipelineCompileVsRunBench(bool compile) : fCompile(compile) {}
@@ -104,6 +150,54 @@ private:
 DEF_BENCH( return (new SkRasterPipelineCompileVsRunBench(true )); )
 DEF_BENCH( return (new SkRasterPipelineCompileVsRunBench(false)); )
 
+// Every run() looks its program up in the shared program cache. This runs short pipelines on
+// several threads at once, each with its own blend mode, so that time per loop only grows with
+// threads when the lookups contend.
+class SkRasterPipelineProgramCacheBench : public Benchmark {
+public:
+    explicit SkRasterPipelineProgramCacheBench(int threads)
+        : fThreads(threads)
+        , fName(SkStringPrintf("SkRasterPipeline_program_cache_%d", threads)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fPool = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static const SkRasterPipeline::StockStage kBlends[] = {
+            SkRasterPipeline::srcover, SkRasterPipeline::modulate,
+            SkRasterPipeline::multiply, SkRasterPipeline::screen,
+        };
+        while (loops --> 0) {
+            SkTaskGroup(*fPool).batch(fThreads, [](int thread) {
+                uint32_t pixels[N];
+                SkJumper_MemoryCtx src_ctx = {src,    0},
+                                   dst_ctx = {pixels, 0};
+
+                SkRasterPipeline_<256> p;
+                p.append(SkRasterPipeline::load_8888, &dst_ctx);
+                p.append(SkRasterPipeline::move_src_dst);
+                p.append(SkRasterPipeline::load_8888, &src_ctx);
+                p.append(kBlends[thread % SK_ARRAY_COUNT(kBlends)]);
+                p.append(SkRasterPipeline::store_8888, &dst_ctx);
+                for (int i = 0; i < 256; i++) {
+                    p.run(0,0,N,1);
+                }
+            });
+        }
+    }
+private:
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fPool;
+};
+DEF_BENCH( return new SkRasterPipelineProgramCacheBench(1); )
+DEF_BENCH( return new SkRasterPipelineProgramCacheBench(4); )
+DEF_BENCH( return new SkRasterPipelineProgramCacheBench(8); )
+
 static SkColorSpaceTransferFn gamma(float g) {
     SkColorSpaceTransferFn fn = {0,0,0,0,0,0,0};
     fn.fG = g;
@@ -164,3 +258,54 @@ public:
     }
 };
 DEF_BENCH( return (new SkRasterPipelineToSRGB); )
+
+// Compares pipelines whose stages append() fuses against the same stages run unfused.
+class SkRasterPipelineFusionBench : public Benchmark {
+public:
+    enum Pipeline { kSeedMatrixGather, kLoadSwapStore };
+
+    SkRasterPipelineFusionBench(Pipeline pipeline, bool fuse)
+        : fPipeline(pipeline)
+        , fFuse(fuse) {
+        fName.printf("SkRasterPipeline_%s_%s",
+                     pipeline == kSeedMatrixGather ? "seed_matrix_gather" : "load_swap_store",
+                     fuse ? "fused" : "unfused");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkJumper_MemoryCtx src_ctx = {src, 0},
+                           dst_ctx = {dst, 0};
+        SkJumper_GatherCtx gather  = {src, N, (float)N, 1.0f};
+        const float matrix[] = { 0.5f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f };  // column-major 2x3
+
+        SkRasterPipeline_<256> p;
+        p.setFuseStages(fFuse);
+        if (fPipeline == kSeedMatrixGather) {
+            p.append(SkRasterPipeline::seed_shader);
+            p.append(SkRasterPipeline::matrix_2x3, matrix);
+            p.append(SkRasterPipeline::gather_8888, &gather);
+            p.append(SkRasterPipeline::srcover_rgba_8888, &dst_ctx);
+        } else {
+            p.append(SkRasterPipeline::load_8888, &src_ctx);
+            p.append(SkRasterPipeline::swap_rb);
+            p.append(SkRasterPipeline::store_8888, &dst_ctx);
+        }
+
+        while (loops --> 0) {
+            p.run(0,0,N,1);
+        }
+    }
+
+private:
+    SkString fName;
+    Pipeline fPipeline;
+    bool     fFuse;
+};
+using FusionBench = SkRasterPipelineFusionBench;
+DEF_BENCH( return new FusionBench(FusionBench::kSeedMatrixGather, true ); )
+DEF_BENCH( return new FusionBench(FusionBench::kSeedMatrixGather, false); )
+DEF_BENCH( return new FusionBench(FusionBench::kLoadSwapStore,    true ); )
+DEF_BENCH( return new FusionBench(FusionBench::kLoadSwapStore,    false); )
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkExecutor.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
+
+// Nested batches of small tasks, as made by parallel codecs/PDF/tiling running inside parallel
+// callers: this mostly measures contention on the executor's work lists.
+class NestedBatchBench : public Benchmark {
+public:
+    enum class Pool { kFIFO, kLIFO, kWorkStealing };
+
+    explicit NestedBatchBench(Pool pool) : fPoolType(pool) {
+        static const char* kNames[] = { "fifo", "lifo", "workstealing" };
+        fName.printf("taskgroup_nested_batch_%s", kNames[static_cast<int>(pool)]);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        switch (fPoolType) {
+            case Pool::kFIFO:         fPool = SkExecutor::MakeFIFOThreadPool(4);         break;
+            case Pool::kLIFO:         fPool = SkExecutor::MakeLIFOThreadPool(4);         break;
+            case Pool::kWorkStealing: fPool = SkExecutor::MakeWorkStealingThreadPool(4); break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::atomic<int> sum{0};
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup(*fPool).batch(16, [&](int j) {
+                SkTaskGroup(*fPool).batch(64, [&](int k) {
+                    sum.fetch_add(j ^ k, std::memory_order_relaxed);
+                });
+            });
+        }
+    }
+
+private:
+    Pool                        fPoolType;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fPool;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new NestedBatchBench(NestedBatchBench::Pool::kFIFO); )
+DEF_BENCH( return new NestedBatchBench(NestedBatchBench::Pool::kLIFO); )
+DEF_BENCH( return new NestedBatchBench(NestedBatchBench::Pool::kWorkStealing); )
@@ -94,6 +94,19 @@ static SkPath cubic_path_maker() {
     return path;
 }
 
+// A long, wandering polyline, like a plotted series or a recorded pen stroke.
+static SkPath polyline_path_maker() {
+    SkPath path;
+    SkRandom rand;
+    SkPoint pt = rand_pt(rand);
+    path.moveTo(pt);
+    for (int i = 0; i < 100 * N; ++i) {
+        pt += SkVector::Make(rand.nextSScalar1(), rand.nextSScalar1());
+        path.lineTo(pt);
+    }
+    return path;
+}
+
 static SkPaint paint_maker() {
     SkPaint paint;
     paint.setStyle(SkPaint::kStroke_Style);
@@ -117,3 +130,18 @@ DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_.25", .
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_.25", .25f);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_.25", .25f);)
 DEF_BENCH(return new StrokeBench(cubic_path_maker(), paint_maker(), "cubic_.25", .25f);)
+
+static SkPaint polyline_paint_maker(SkPaint::Join join) {
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2);
+    paint.setStrokeJoin(join);
+    return paint;
+}
+
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), polyline_paint_maker(SkPaint::kMiter_Join),
+                                 "polyline", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), polyline_paint_maker(SkPaint::kRound_Join),
+                                 "polyline", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), polyline_paint_maker(SkPaint::kBevel_Join),
+                                 "polyline", 1);)
@@ -6,6 +6,7 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
@@ -14,8 +15,8 @@
 #include "SkVertices.h"
 
 enum VertFlags {
-    kColors_VertFlag,
-    kTexture_VertFlag,
+    kColors_VertFlag  = 1 << 0,
+    kTexture_VertFlag = 1 << 1,
 };
 
 class VertBench : public Benchmark {
@@ -27,11 +28,15 @@ class VertBench : public Benchmark {
         COL = 20,
         PTS = (ROW + 1) * (COL + 1),
         IDX = ROW * COL * 6,
+        TEX = 64,
     };
 
     SkPoint fPts[PTS];
+    SkPoint fTexs[PTS];
     SkColor fColors[PTS];
     uint16_t fIdx[IDX];
+    uint32_t fFlags;
+    sk_sp<SkShader> fShader;
 
     static void load_2_tris(uint16_t idx[], int x, int y, int rb) {
         int n = y * rb + x;
@@ -40,7 +45,7 @@ class VertBench : public Benchmark {
     }
 
 public:
-    VertBench() {
+    VertBench(uint32_t flags = kColors_VertFlag) : fFlags(flags) {
         const SkScalar dx = SkIntToScalar(W) / COL;
         const SkScalar dy = SkIntToScalar(H) / COL;
 
@@ -71,9 +76,23 @@ public:
         SkRandom rand;
         for (int i = 0; i < PTS; ++i) {
             fColors[i] = rand.nextU() | (0xFF << 24);
+            // Map the mesh onto a quarter of the texture, so that it's magnified and filtered.
+            fTexs[i].set(fPts[i].fX * 0.5f * TEX / W, fPts[i].fY * 0.5f * TEX / H);
         }
 
         fName.set("verts");
+        if (fFlags & kTexture_VertFlag) {
+            SkBitmap bm;
+            bm.allocN32Pixels(TEX, TEX);
+            for (int y = 0; y < TEX; ++y) {
+                for (int x = 0; x < TEX; ++x) {
+                    *bm.getAddr32(x, y) = ((x ^ y) & 8) ? 0xFFFFFFFF : 0xFF808080;
+                }
+            }
+            fShader = SkShader::MakeBitmapShader(bm, SkShader::kClamp_TileMode,
+                                                 SkShader::kClamp_TileMode);
+            fName.append(fFlags & kColors_VertFlag ? "_texture_colors" : "_texture");
+        }
     }
 
 protected:
@@ -81,9 +100,13 @@ protected:
     void onDraw(int loops, SkCanvas* canvas) override {
         SkPaint paint;
         this->setupPaint(&paint);
+        paint.setShader(fShader);
+        paint.setFilterQuality(kLow_SkFilterQuality);
 
-        auto verts = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, PTS,
-                                          fPts, nullptr, fColors, IDX, fIdx);
+        auto verts = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, PTS, fPts,
+                                          fShader ? fTexs : nullptr,
+                                          fFlags & kColors_VertFlag ? fColors : nullptr,
+                                          IDX, fIdx);
         for (int i = 0; i < loops; i++) {
             canvas->drawVertices(verts, SkBlendMode::kModulate, paint);
         }
@@ -95,3 +118,5 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new VertBench();)
+DEF_BENCH(return new VertBench(kTexture_VertFlag);)
+DEF_BENCH(return new VertBench(kTexture_VertFlag | kColors_VertFlag);)
@@ -16,12 +16,14 @@
 #include "CodecBenchPriv.h"
 #include "CrashHandler.h"
 #include "GMBench.h"
+#include "PerfCounters.h"
 #include "ProcStats.h"
 #include "RecordingBench.h"
 #include "ResultsWriter.h"
 #include "SKPAnimationBench.h"
 #include "SKPBench.h"
 #include "SkAndroidCodec.h"
+#include "SkArenaBlockPool.h"
 #include "SkAutoMalloc.h"
 #include "SkBBoxHierarchy.h"
 #include "SkBitmapRegionDecoder.h"
@@ -33,9 +35,11 @@
 #include "SkCommonFlagsGpu.h"
 #include "SkData.h"
 #include "SkDebugfTracer.h"
+#include "SkDrawScratch.h"
 #include "SkEventTracingPriv.h"
 #include "SkGraphics.h"
 #include "SkLeanWindows.h"
+#include "SkMemoryAccounting.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPictureRecorder.h"
@@ -51,8 +55,10 @@
 #include "SkSVGDOM.h"
 #endif  // SK_XML
 
+#include <atomic>
 #include <stdlib.h>
 #include <thread>
+#include <vector>
 
 extern bool gSkForceRasterPipelineBlitter;
 
@@ -137,6 +143,15 @@ DEFINE_string(benchType,  "",
         "Apply usual --match rules to bench type: micro, recording, piping, playback, skcodec, etc.");
 
 DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
+DEFINE_int32(benchThreads, 1, "If >1, also time each CPU micro bench running on this many threads "
+                              "at once, each with its own bench and canvas. Results are logged "
+                              "under the config name with a _threadsN suffix.");
+DEFINE_bool(perfCounters, false, "Count CPU cycles, instructions, cache misses and branch misses "
+                                 "on the timing thread while sampling (Linux only), and log them "
+                                 "per loop.");
+DEFINE_bool(countAllocs, false, "Count sk_malloc/sk_realloc calls (and operator new, if built with "
+                                "skia_count_new_allocations) and the bytes they ask for while "
+                                "sampling, and log them per loop. Counting slows timing a little.");
 
 static double now_ms() { return SkTime::GetNSecs() * 1e-6; }
 
@@ -239,19 +254,26 @@ struct GPUTarget : public Target {
     }
 };
 
-static double time(int loops, Benchmark* bench, Target* target) {
+static double time(int loops, Benchmark* bench, Target* target,
+                   sk_tools::PerfCounters* counters = nullptr) {
     SkCanvas* canvas = target->getCanvas();
     if (canvas) {
         canvas->clear(SK_ColorWHITE);
     }
     bench->preDraw(canvas);
     double start = now_ms();
+    if (counters) {
+        counters->start();
+    }
     canvas = target->beginTiming(canvas);
     bench->draw(loops, canvas);
     if (canvas) {
         canvas->flush();
     }
     target->endTiming();
+    if (counters) {
+        counters->stop();
+    }
     double elapsed = now_ms() - start;
     bench->postDraw(canvas);
     return elapsed;
@@ -553,6 +575,58 @@ static Target* is_enabled(Benchmark* bench, const Config& config) {
 #pragma warning ( pop )
 #endif
 
+typedef Benchmark* (*BenchFactory)(void*);
+
+// Times copies of a bench running concurrently, one per thread, each drawing into its own target.
+// Fills samples with every thread's ms per loop and wallMs with the time until the last thread
+// finished. Returns false if a copy can't run on config.
+static bool time_concurrently(BenchFactory factory, const Config& config, int loops,
+                              int threads, SkTArray<double>* samples, double* wallMs) {
+    std::vector<std::unique_ptr<Benchmark>> benches;
+    std::vector<std::unique_ptr<Target>> targets;
+    for (int t = 0; t < threads; t++) {
+        benches.emplace_back(factory(nullptr));
+        benches.back()->delayedSetup();
+        targets.emplace_back(is_enabled(benches.back().get(), config));
+        if (!targets.back()) {
+            return false;
+        }
+        targets.back()->setup();
+        benches.back()->perCanvasPreDraw(targets.back()->getCanvas());
+    }
+
+    std::vector<SkTArray<double>> threadSamples(threads);
+    std::atomic<int> waiting{threads};
+    auto run = [&](int t) {
+        // Start drawing together, so that the threads overlap as much as possible.
+        waiting--;
+        while (waiting.load() > 0) {}
+
+        auto stop = now_ms() + FLAGS_ms;
+        for (int s = 0; FLAGS_ms ? now_ms() < stop : s < FLAGS_samples; s++) {
+            threadSamples[t].push_back(time(loops, benches[t].get(), targets[t].get()) / loops);
+        }
+    };
+
+    double start = now_ms();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.emplace_back(run, t);
+    }
+    run(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    *wallMs = now_ms() - start;
+
+    samples->reset();
+    for (int t = 0; t < threads; t++) {
+        benches[t]->perCanvasPostDraw(targets[t]->getCanvas());
+        samples->push_back_n(threadSamples[t].count(), threadSamples[t].begin());
+    }
+    return true;
+}
+
 static bool valid_brd_bench(sk_sp<SkData> encoded, SkColorType colorType, uint32_t sampleSize,
         uint32_t minOutputSize, int* width, int* height) {
     std::unique_ptr<SkBitmapRegionDecoder> brd(
@@ -710,9 +784,15 @@ public:
         return bench.release();
     }
 
+    // The factory that made the last bench, if it came from BenchRegistry, so more copies of it
+    // can be made. Null for everything else.
+    BenchFactory benchFactory() const { return fBenchFactory; }
+
     Benchmark* rawNext() {
+        fBenchFactory = nullptr;
         if (fBenches) {
-            Benchmark* bench = fBenches->get()(nullptr);
+            fBenchFactory = fBenches->get();
+            Benchmark* bench = fBenchFactory(nullptr);
             fBenches = fBenches->next();
             fSourceType = "bench";
             fBenchType  = "micro";
@@ -1054,6 +1134,7 @@ private:
 
     const BenchRegistry* fBenches;
     const skiagm::GMRegistry* fGMs;
+    BenchFactory fBenchFactory = nullptr;
     SkIRect            fClip;
     SkTArray<SkScalar> fScales;
     SkTArray<SkString> fSKPs;
@@ -1195,6 +1276,18 @@ int main(int argc, char** argv) {
         gSkForceRasterPipelineBlitter = true;
     }
 
+    std::unique_ptr<sk_tools::PerfCounters> perfCounters;
+    if (FLAGS_perfCounters) {
+        perfCounters = sk_tools::PerfCounters::Make();
+        if (!perfCounters) {
+            SkDebugf("Hardware performance counters are not available; not counting.\n");
+        }
+    }
+
+    if (FLAGS_countAllocs) {
+        SkMemoryAccounting::SetCountAllocations(true);
+    }
+
     int runs = 0;
     BenchmarkStream benchStream;
     while (Benchmark* b = benchStream.next()) {
@@ -1233,7 +1326,8 @@ int main(int argc, char** argv) {
             bench->perCanvasPreDraw(canvas);
 
             int maxFrameLag;
-            int loops = target->needsFrameTiming(&maxFrameLag)
+            const bool frameTiming = target->needsFrameTiming(&maxFrameLag);
+            int loops = frameTiming
                 ? setup_gpu_bench(target, bench.get(), maxFrameLag)
                 : setup_cpu_bench(overhead, target, bench.get());
 
@@ -1252,19 +1346,33 @@ int main(int argc, char** argv) {
                 } while (now_ms() < stop);
             }
 
+            // Count how many raster draws had to go to the heap for their temporaries.
+            const SkDrawScratch::Stats scratchBefore = SkDrawScratch::GetStats();
+            // ... and how often arenas found a recycled block.
+            const SkArenaBlockPool::Stats blocksBefore = SkArenaBlockPool::GetStats();
+            const SkMemoryAccounting::AllocationStats allocsBefore =
+                    SkMemoryAccounting::GetAllocationStats();
+            if (perfCounters) {
+                perfCounters->reset();
+            }
             if (FLAGS_ms) {
                 samples.reset();
                 auto stop = now_ms() + FLAGS_ms;
                 do {
-                    samples.push_back(time(loops, bench.get(), target) / loops);
+                    samples.push_back(time(loops, bench.get(), target, perfCounters.get()) / loops);
                 } while (now_ms() < stop);
             } else {
                 samples.reset(FLAGS_samples);
                 for (int s = 0; s < FLAGS_samples; s++) {
-                    samples[s] = time(loops, bench.get(), target) / loops;
+                    samples[s] = time(loops, bench.get(), target, perfCounters.get()) / loops;
                 }
             }
 
+            const SkDrawScratch::Stats scratchAfter = SkDrawScratch::GetStats();
+            const SkArenaBlockPool::Stats blocksAfter = SkArenaBlockPool::GetStats();
+            const SkMemoryAccounting::AllocationStats allocsAfter =
+                    SkMemoryAccounting::GetAllocationStats();
+
             SkTArray<SkString> keys;
             SkTArray<double> values;
             bool gpuStatsDump = FLAGS_gpuStatsDump && Benchmark::kGPU_Backend == configs[i].backend;
@@ -1272,6 +1380,38 @@ int main(int argc, char** argv) {
                 // TODO cache stats
                 bench->getGpuStats(canvas, &keys, &values);
             }
+            SkTArray<SkString> metricKeys;
+            SkTArray<double> metricValues;
+            bench->getMetrics(&metricKeys, &metricValues);
+            if (perfCounters) {
+                // Per loop, like the times.
+                const double totalLoops = (double)loops * samples.count();
+                double counts[sk_tools::PerfCounters::kCounterCount];
+                bool have[sk_tools::PerfCounters::kCounterCount];
+                for (int c = 0; c < sk_tools::PerfCounters::kCounterCount; c++) {
+                    auto counter = (sk_tools::PerfCounters::Counter)c;
+                    have[c] = perfCounters->read(counter, &counts[c]);
+                    if (have[c]) {
+                        metricKeys.push_back(SkString(sk_tools::PerfCounters::Name(counter)));
+                        metricValues.push_back(counts[c] / totalLoops);
+                    }
+                }
+                if (have[sk_tools::PerfCounters::kCycles] &&
+                    have[sk_tools::PerfCounters::kInstructions] &&
+                    counts[sk_tools::PerfCounters::kCycles] > 0) {
+                    metricKeys.push_back(SkString("ipc"));
+                    metricValues.push_back(counts[sk_tools::PerfCounters::kInstructions] /
+                                           counts[sk_tools::PerfCounters::kCycles]);
+                }
+            }
+            if (FLAGS_countAllocs) {
+                const double totalLoops = (double)loops * samples.count();
+                metricKeys.push_back(SkString("allocs"));
+                metricValues.push_back((allocsAfter.fCount - allocsBefore.fCount) / totalLoops);
+                metricKeys.push_back(SkString("alloc_bytes"));
+                metricValues.push_back((allocsAfter.fBytes - allocsBefore.fBytes) / totalLoops);
+            }
+            SkASSERT(metricKeys.count() == metricValues.count());
 
             bench->perCanvasPostDraw(canvas);
 
@@ -1294,6 +1434,10 @@ int main(int argc, char** argv) {
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
             log->metrics("samples",    samples);
+            log->metric("scratch_draws",      scratchAfter.fDraws     - scratchBefore.fDraws);
+            log->metric("scratch_heap_draws", scratchAfter.fHeapDraws - scratchBefore.fHeapDraws);
+            log->metric("arena_blocks",        blocksAfter.fAllocs - blocksBefore.fAllocs);
+            log->metric("arena_blocks_reused", blocksAfter.fReuses - blocksBefore.fReuses);
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
                 SkASSERT(keys.count() == values.count());
@@ -1301,6 +1445,9 @@ int main(int argc, char** argv) {
                     log->metric(keys[i].c_str(), values[i]);
                 }
             }
+            for (int i = 0; i < metricKeys.count(); i++) {
+                log->metric(metricKeys[i].c_str(), metricValues[i]);
+            }
 
             if (runs++ % FLAGS_flushEvery == 0) {
                 log->flush();
@@ -1362,6 +1509,46 @@ int main(int argc, char** argv) {
                     SkDebugf("%s  ", HUMANIZE(samples[i]));
                 }
                 SkDebugf("%s\n", bench->getUniqueName());
+                for (int i = 0; i < metricKeys.count(); i++) {
+                    SkDebugf("%s: %g\n", metricKeys[i].c_str(), metricValues[i]);
+                }
+            }
+
+            // Now run the bench on FLAGS_benchThreads threads at once. Logged as its own config,
+            // it regresses (and is caught) like any other, but only through contention.
+            double wallMs;
+            if (FLAGS_benchThreads > 1 && !frameTiming && benchStream.benchFactory() &&
+                time_concurrently(benchStream.benchFactory(), target->config, loops,
+                                  FLAGS_benchThreads, &samples, &wallMs)) {
+                Stats threadStats(samples, false);
+                // Loops completed per ms by all threads, relative to one thread on its own.
+                const double throughput = samples.count() * loops / wallMs * stats.mean;
+                const double scaling = throughput / FLAGS_benchThreads;
+
+                SkString threadsConfig = SkStringPrintf("%s_threads%d", target->config.name.c_str(),
+                                                        FLAGS_benchThreads);
+                log->config(threadsConfig.c_str());
+                log->configOption("name", bench->getName());
+                benchStream.fillCurrentOptions(log.get());
+                target->fillOptions(log.get());
+                log->metric("min_ms", threadStats.min);
+                log->metrics("samples", samples);
+                log->metric("throughput", throughput);
+                log->metric("scaling", scaling);
+
+                if (kAutoTuneLoops == FLAGS_loops && !FLAGS_quiet && !FLAGS_csv) {
+                    SkDebugf("\t\t%d\t%s\t%s\t%s\t%s\t%.2fx throughput, %.0f%% scaling\t%s\t%s\n"
+                             , loops
+                             , HUMANIZE(threadStats.min)
+                             , HUMANIZE(threadStats.median)
+                             , HUMANIZE(threadStats.mean)
+                             , HUMANIZE(threadStats.max)
+                             , throughput
+                             , 100 * scaling
+                             , threadsConfig.c_str()
+                             , bench->getUniqueName()
+                             );
+                }
             }
             cleanup_run(target);
         }
@@ -353,7 +353,9 @@ EMSCRIPTEN_BINDINGS(Skia) {
         }))
         .function("size", &skottie::Animation::size)
         .function("duration", &skottie::Animation::duration)
-        .function("seek", &skottie::Animation::seek)
+        .function("seek", optional_override([](skottie::Animation& self, SkScalar t)->void {
+            self.seek(t);
+        }))
         .function("render", optional_override([](skottie::Animation& self, SkCanvas* canvas)->void {
             self.render(canvas, nullptr);
         }), allow_raw_pointers())
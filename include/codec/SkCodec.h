@@ -26,6 +26,7 @@
 
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkPngChunkReader;
 class SkSampler;
@@ -257,6 +258,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -300,6 +302,17 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into parts that run in
+         *  parallel on this executor, and returns once they are all done.
+         *
+         *  Currently only used for JPEGs whose restart markers fall at the start
+         *  of MCU rows, decoded at full size from a stream with a memory base,
+         *  and for non-interlaced PNGs, whose rows are swizzled and color
+         *  transformed on the executor while libpng inflates the rows after them.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -435,6 +448,22 @@ public:
         return this->onIncrementalDecode(rowsDecoded);
     }
 
+    /**
+     *  Returns the part of the destination that the last call to incrementalDecode() wrote to,
+     *  e.g. so that only that part needs to be uploaded again. Empty if it wrote nothing.
+     *
+     *  Most codecs write each row once, top to bottom. A progressive JPEG is written once per
+     *  scan instead: a call writes the whole image, at the quality of the last scan that has all
+     *  of its data, if that scan is newer than the one the last call wrote. Codecs that don't
+     *  keep track return all of dstInfo.
+     */
+    SkIRect getIncrementalUpdatedBounds() const {
+        if (!fStartedIncrementalDecode) {
+            return SkIRect::MakeEmpty();
+        }
+        return this->onGetIncrementalUpdatedBounds();
+    }
+
     /**
      * The remaining functions revolve around decoding scanlines.
      */
@@ -868,6 +897,10 @@ private:
         return kUnimplemented;
     }
 
+    virtual SkIRect onGetIncrementalUpdatedBounds() const {
+        return SkIRect::MakeWH(fDstInfo.width(), fDstInfo.height());
+    }
+
 
     virtual bool onSkipScanlines(int /*countLines*/) { return false; }
 
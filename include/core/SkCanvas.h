@@ -2617,6 +2617,7 @@ private:
 
     void doSave();
     void checkForDeferredSave();
+    void checkForDeferredDeviceSave();
     void internalSetMatrix(const SkMatrix&);
 
     friend class SkAndroidFrameworkUtils;
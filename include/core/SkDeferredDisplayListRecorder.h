@@ -20,7 +20,9 @@ class GrBackendTexture;
 class GrContext;
 
 class SkCanvas;
+class SkExecutor;
 class SkImage;
+class SkPicture;
 class SkSurface;
 struct SkYUVAIndex;
 
@@ -149,6 +151,38 @@ public:
                                           PromiseDoneProc promiseDoneProc,
                                           TextureContext textureContexts[]);
 
+    /** Progress metrics reported by RecordTiles(). */
+    struct TileStats {
+        int    fTileCount  = 0;
+        int    fTilesDrawn = 0;   //!< tiles whose DDL was drawn into the destination
+        double fRecordMs   = 0;   //!< wall time spent recording all the tiles
+        double fSlowestMs  = 0;   //!< time spent recording the slowest tile
+        double fDrawMs     = 0;   //!< wall time spent drawing the DDLs into the destination
+    };
+
+    /**
+        Records picture into one SkDeferredDisplayList per tile, splitting the surface described
+        by characterization into xDivisions by yDivisions tiles.  The tiles are recorded in
+        parallel on executor, or on the calling thread if executor is nullptr.  Each DDL targets
+        the whole surface and is clipped to its tile, so they are all drawn straight into dst.
+        Images in the picture are shared by all the tiles.
+
+        This does not flush dst.
+
+        @param picture           content to draw at the surface's origin
+        @param characterization  describes dst; must be valid
+        @param xDivisions        number of tile columns; at least 1
+        @param yDivisions        number of tile rows; at least 1
+        @param executor          runs the recording tasks; may be nullptr
+        @param dst               surface compatible with characterization
+        @param stats             if not nullptr, filled in with progress metrics
+        @return                  true if every tile was recorded and drawn into dst
+     */
+    static bool RecordTiles(const SkPicture* picture,
+                            const SkSurfaceCharacterization& characterization,
+                            int xDivisions, int yDivisions, SkExecutor* executor,
+                            SkSurface* dst, TileStats* stats = nullptr);
+
 private:
     bool init();
 
@@ -11,9 +11,13 @@
 #include "SkRefCnt.h"
 #include "SkScalar.h"
 
+#include <functional>
+
 class SkCanvas;
+class SkExecutor;
 class SkWStream;
 struct SkRect;
+struct SkSize;
 
 /** SK_ScalarDefaultDPI is 72 dots per inch. */
 static constexpr SkScalar SK_ScalarDefaultRasterDPI = 72.0f;
@@ -45,6 +49,19 @@ public:
      */
     void endPage();
 
+    /**
+     *  Adds 'count' pages, the i-th 'sizes[i]' big, drawn by drawPage(i, canvas).
+     *
+     *  Without an executor this is the same as calling beginPage(), drawPage() and endPage() for
+     *  each page. With one, the pages are first recorded in parallel on 'executor', each by its
+     *  own SkPictureRecorder, so drawPage() must be safe to call on several threads at once.
+     *  The recorded pages are then added to the document in order, sharing its typefaces and
+     *  images as pages drawn directly would.
+     */
+    void drawPages(int count, const SkSize sizes[],
+                   const std::function<void(int, SkCanvas*)>& drawPage,
+                   SkExecutor* executor = nullptr);
+
     /**
      *  Call close() when all pages have been drawn. This will close the file
      *  or stream holding the document's contents. After close() the document
@@ -87,6 +87,17 @@ public:
                                           const char* bcp47[], int bcp47Count,
                                           SkUnichar character) const;
 
+    /**
+     *  Like matchFamilyStyleCharacter, for many characters at once. Sets typefaces[i] to a
+     *  typeface with characters[i], or to nullptr if none was found. A typeface found for one
+     *  character is also used for every later character it has, so the system fallback is
+     *  queried about once per typeface needed rather than once per character.
+     */
+    void matchFamilyStyleCharacters(const char familyName[], const SkFontStyle&,
+                                    const char* bcp47[], int bcp47Count,
+                                    const SkUnichar characters[], int count,
+                                    sk_sp<SkTypeface> typefaces[]) const;
+
     SkTypeface* matchFaceStyle(const SkTypeface*, const SkFontStyle&) const;
 
     /**
@@ -103,6 +103,38 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  Storage for the font cache that outlives the process, e.g. files on disk. Strikes store
+     *  their glyphs' metrics, images and paths here when purged from the font cache or on
+     *  StoreFontCache(), and the same strike in a later run loads them back instead of
+     *  rasterizing them again. Keys identify fonts by their contents, so they're stable across
+     *  runs, but only for fonts that have a 'head' table.
+     */
+    class PersistentFontCache {
+    public:
+        virtual ~PersistentFontCache() {}
+
+        /**
+         *  Returns the data for the key if it exists in the cache, otherwise returns null. The
+         *  data is only read while the strike is created, so it may be memory mapped.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
+    /**
+     *  Sets the persistent store for the font cache, or stops using one if null. The store is
+     *  not owned, must be thread safe, and must outlive its use. Not thread safe.
+     */
+    static void SetPersistentFontCache(PersistentFontCache*);
+
+    /**
+     *  Stores every strike in the font cache that has new glyphs since it was loaded or last
+     *  stored, e.g. before the process exits. Strikes in use by other threads are skipped.
+     */
+    static void StoreFontCache();
+
     /**
      *  Scaling bitmaps with the kHigh_SkFilterQuality setting is
      *  expensive, so the result is saved in the global Scaled Image
@@ -138,8 +170,24 @@ public:
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
     /**
-     *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
-     *  for usage of this method.
+     *  The raster backend caches the pipeline programs it builds, keyed by their sequence of
+     *  stages, so repeated draws with the same kind of paint skip rebuilding them. These return
+     *  how many programs were found in (hits) or had to be added to (misses) that cache since
+     *  startup or the last purge.
+     */
+    static int64_t GetRasterPipelineCacheHits();
+    static int64_t GetRasterPipelineCacheMisses();
+
+    /**
+     *  For debugging purposes, this will purge the raster pipeline program cache and reset its
+     *  hit and miss counts.
+     */
+    static void PurgeRasterPipelineCache();
+
+    /**
+     *  Dumps memory usage of caches, and of the other heap memory Skia tracks by subsystem (see
+     *  SkMemoryAccounting.h), using the SkTraceMemoryDump interface. See SkTraceMemoryDump for
+     *  usage of this method.
      */
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
@@ -151,6 +199,24 @@ public:
      */
     static void PurgeAllCaches();
 
+    enum class MemoryPressure {
+        kModerate,  // Free part of what each cache holds, least recently used first.
+        kCritical,  // Free everything that can be freed.
+    };
+
+    /**
+     *  Frees cached memory across Skia in proportion to the pressure level. At kModerate each cache
+     *  gives up a share of its least recently used entries, smaller for caches whose entries cost
+     *  more to remake; at kCritical they give up all they can, as in PurgeAllCaches().
+     *
+     *  Returns the number of bytes freed. If dump is not null, each cache also reports what it
+     *  freed to it, as a "freed_size" value under "skia/memory_pressure/<cache>".
+     *
+     *  A GrContext can only be used on its own thread, so each context frees its caches (see
+     *  GrContext::onMemoryPressure) when it next flushes; those aren't counted here.
+     */
+    static size_t OnMemoryPressure(MemoryPressure level, SkTraceMemoryDump* dump = nullptr);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
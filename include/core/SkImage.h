@@ -461,6 +461,30 @@ public:
             const GrBackendTexture& backendTexture,
             sk_sp<SkColorSpace> imageColorSpace = nullptr);
 
+    /** Block compressed formats that MakeFromCompressed() accepts.
+    */
+    enum class CompressionType {
+        kETC1,            //!< opaque RGB in 4x4 blocks of 8 bytes; decoded by ETC2 hardware too
+        kLast = kETC1,
+    };
+
+    /** Creates GPU-backed SkImage from data that is already block compressed, so it is uploaded
+        without being decoded and stays compressed in GPU memory. data must hold exactly the
+        blocks covering width by height, with no padding between rows of blocks.
+
+        SkImage is returned if context supports textures of type. SkImage is opaque, and
+        its pixels can be drawn but not read back.
+
+        @param context  GPU context
+        @param data     compressed blocks, top row of blocks first
+        @param width    width of full SkImage
+        @param height   height of full SkImage
+        @param type     compression of data
+        @return         created SkImage, or nullptr
+    */
+    static sk_sp<SkImage> MakeFromCompressed(GrContext* context, sk_sp<SkData> data,
+                                             int width, int height, CompressionType type);
+
     enum class BitDepth {
         kU8,  //!< uses 8-bit unsigned int per color component
         kF16, //!< uses 16-bit float per color component
@@ -772,6 +796,8 @@ public:
         bilerp filter. kMedium_SkFilterQuality is typically implemented with
         bilerp filter, and Filter_Quality_MipMap when size is reduced.
         kHigh_SkFilterQuality is slowest, typically implemented with Filter_Quality_BiCubic.
+        When reducing size of 8888 pixels, kHigh_SkFilterQuality instead applies a separable
+        Mitchell filter that weighs every source pixel under each destination pixel.
 
         If cachingHint is kAllow_CachingHint, pixels may be retained locally.
         If cachingHint is kDisallow_CachingHint, pixels are not added to the local cache.
@@ -232,6 +232,13 @@ public:
     // Can this filter DAG compute the resulting bounds of an object-space rectangle?
     bool canComputeFastBounds() const;
 
+    /**
+     *  Returns true if filtering a region one piece at a time, with each piece as the clip
+     *  bounds, gives the same pixels as filtering the whole region at once. Raster devices use
+     *  this to filter large regions in tiles.
+     */
+    bool canFilterInTiles() const;
+
     /**
      *  If this filter can be represented by another filter + a localMatrix, return that filter,
      *  else return null.
@@ -380,6 +387,17 @@ protected:
                                       const Context&,
                                       SkIPoint* offset) const;
 
+    // Like filterInput(), but if the input is a color filter node that leaves transparent black
+    // alone, that node's own pass is skipped: this returns the node's input, and puts its color
+    // filter in "colorFilter" for the caller to apply as it draws the result. Otherwise
+    // "colorFilter" is set to null. This lets per-pixel filters fuse a color filter into their
+    // own pass instead of paying for an intermediate image.
+    sk_sp<SkSpecialImage> filterInputDeferringColorFilter(int index,
+                                                          SkSpecialImage* src,
+                                                          const Context&,
+                                                          SkIPoint* offset,
+                                                          sk_sp<SkColorFilter>* colorFilter) const;
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
@@ -394,6 +412,13 @@ protected:
      */
     virtual bool onCanHandleComplexCTM() const { return false; }
 
+    /**
+     *  Override this to return false if your subclass' output depends on where the clip bounds
+     *  fall, and not only on the input pixels that onFilterNodeBounds() asks for. The caller
+     *  takes care of the inputs.
+     */
+    virtual bool onCanFilterInTiles() const { return true; }
+
     /** Given a "srcBounds" rect, computes destination bounds for this filter.
      *  "dstBounds" are computed by transforming the crop rect by the context's
      *  CTM, applying it to the initial bounds, and intersecting the result with
@@ -431,6 +456,15 @@ protected:
      *  texture samples to guarantee that any color space conversion has happened before running.
      */
     static sk_sp<SkSpecialImage> ImageToColorSpace(SkSpecialImage* src, const OutputProperties&);
+
+    /**
+     *  Returns "fp" followed by the color filter, for applying a color filter returned by
+     *  filterInputDeferringColorFilter(). Returns "fp" itself if "colorFilter" is null, and null
+     *  if the color filter isn't implemented for the GPU backend.
+     */
+    static std::unique_ptr<GrFragmentProcessor> MakeColorFilteredFP(
+            GrContext*, std::unique_ptr<GrFragmentProcessor> fp, SkColorFilter* colorFilter,
+            const OutputProperties&);
 #endif
 
     /**
@@ -12,8 +12,13 @@
 #include "SkColor.h"
 #include "SkImage.h"
 #include "SkImageInfo.h"
+#include "SkYUVAIndex.h"
 #include "SkYUVSizeInfo.h"
 
+#if SK_SUPPORT_GPU
+#include "GrBackendSurface.h"
+#endif
+
 class GrContext;
 class GrContextThreadSafeProxy;
 class GrTextureProxy;
@@ -135,6 +140,34 @@ public:
     sk_sp<GrTextureProxy> generateTexture(GrContext*, const SkImageInfo& info,
                                           const SkIPoint& origin,
                                           bool willNeedMipMaps);
+
+    /**
+     *  The Y, U, V and optional A planes of the generator's pixels, in textures on the GPU.
+     *  fTextures and fIndices are interpreted as in SkImage::MakeFromYUVATexturesCopy().
+     *
+     *  If fReleaseProc is not null, it is called with fReleaseContexts[i] once Skia is done with
+     *  fTextures[i], for each texture that fIndices refers to. Until then the textures must stay
+     *  valid and unchanged.
+     */
+    struct YUVATextures {
+        SkYUVColorSpace             fYUVColorSpace = kJPEG_SkYUVColorSpace;
+        GrBackendTexture            fTextures[4];
+        SkYUVAIndex                 fIndices[4];
+        GrSurfaceOrigin             fOrigin = kTopLeft_GrSurfaceOrigin;
+        SkImage::TextureReleaseProc fReleaseProc = nullptr;
+        SkImage::ReleaseContext     fReleaseContexts[4] = { nullptr, nullptr, nullptr, nullptr };
+    };
+
+    /**
+     *  If the generator can decode straight into textures for the GrContext, e.g. with a hardware
+     *  decoder, this returns true and fills out the YUVA planes of all of its pixels. Images made
+     *  from the generator then convert the planes to RGBA on the GPU, so the pixels never pass
+     *  through CPU memory. This is only asked for if generateTexture() fails.
+     *
+     *  Decoders are plugged in with SkGraphics::SetImageGeneratorFromEncodedDataFactory(), whose
+     *  factory can return a generator that implements this for the encoded formats it handles.
+     */
+    bool getYUVATextures(GrContext*, YUVATextures*);
 #endif
 
     /**
@@ -176,6 +209,7 @@ protected:
     virtual TexGenType onCanGenerateTexture() const { return TexGenType::kNone; }
     virtual sk_sp<GrTextureProxy> onGenerateTexture(GrContext*, const SkImageInfo&, const SkIPoint&,
                                                     bool willNeedMipMaps);  // returns nullptr
+    virtual bool onGetYUVATextures(GrContext*, YUVATextures*) { return false; }
 #endif
 
 private:
@@ -10,6 +10,7 @@
 
 #include "../private/SkTDArray.h"
 #include "SkMatrix.h"
+#include "SkRect.h"
 
 class SkCanvas;
 class SkPaint;
@@ -43,12 +44,33 @@ public:
              const SkMatrix* matrix = nullptr,
              const SkPaint* paint = nullptr);
 
+    /**
+     *  How long one piece of a raster draw took. Large pictures drawn without a paint into
+     *  raster canvases are split into bands of rows, replayed concurrently; other raster draws
+     *  are reported as a single piece covering their clip.
+     */
+    struct TileTiming {
+        int     fDrawIndex; // which add() call, counting from 0 since the last reset
+        SkIRect fBounds;    // device pixels this piece was clipped to
+        double  fMs;        // wall time spent replaying into fBounds
+    };
+
     /**
      *  Perform all the previously added draws. This will reset the state
      *  of this object. If flush is true, all canvases are flushed after
      *  draw.
+     *
+     *  Splitting a picture into bands gives the same pixels as drawing it serially. Pictures
+     *  that use layers or image filters are always drawn whole, since layers are sized to the
+     *  clip and would move with each band.
+     */
+    void draw(bool flush = false) { this->draw(flush, nullptr); }
+
+    /**
+     *  As above, and if timings is not null, replaces its contents with the time taken by
+     *  each raster band or draw, in no particular order. GPU draws are not timed.
      */
-    void draw(bool flush = false);
+    void draw(bool flush, SkTDArray<TileTiming>* timings);
 
     /**
      *  Abandon all buffered draws and reset to the initial state.
@@ -61,8 +83,9 @@ private:
         const SkPicture* fPicture; // reffed
         SkMatrix         fMatrix;
         SkPaint*         fPaint;   // owned
+        int              fIndex;   // order of the add() call
 
-        void init(SkCanvas*, const SkPicture*, const SkMatrix*, const SkPaint*);
+        void init(SkCanvas*, const SkPicture*, const SkMatrix*, const SkPaint*, int index);
         void draw();
 
         static void Reset(SkTDArray<DrawData>&);
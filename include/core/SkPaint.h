@@ -677,7 +677,7 @@ public:
 
         @return  SkShader if previously set, nullptr otherwise
     */
-    SkShader* getShader() const { return fShader.get(); }
+    SkShader* getShader() const { return fEffects ? fEffects->fShader.get() : nullptr; }
 
     /** Returns optional colors used when filling a path, such as a gradient.
 
@@ -701,7 +701,9 @@ public:
 
         @return  SkColorFilter if previously set, nullptr otherwise
     */
-    SkColorFilter* getColorFilter() const { return fColorFilter.get(); }
+    SkColorFilter* getColorFilter() const {
+        return fEffects ? fEffects->fColorFilter.get() : nullptr;
+    }
 
     /** Returns SkColorFilter if set, or nullptr.
         Increases SkColorFilter SkRefCnt by one.
@@ -744,7 +746,7 @@ public:
 
         @return  SkPathEffect if previously set, nullptr otherwise
     */
-    SkPathEffect* getPathEffect() const { return fPathEffect.get(); }
+    SkPathEffect* getPathEffect() const { return fEffects ? fEffects->fPathEffect.get() : nullptr; }
 
     /** Returns SkPathEffect if set, or nullptr.
         Increases SkPathEffect SkRefCnt by one.
@@ -767,7 +769,7 @@ public:
 
         @return  SkMaskFilter if previously set, nullptr otherwise
     */
-    SkMaskFilter* getMaskFilter() const { return fMaskFilter.get(); }
+    SkMaskFilter* getMaskFilter() const { return fEffects ? fEffects->fMaskFilter.get() : nullptr; }
 
     /** Returns SkMaskFilter if set, or nullptr.
 
@@ -813,7 +815,9 @@ public:
 
         @return  SkImageFilter if previously set, nullptr otherwise
     */
-    SkImageFilter* getImageFilter() const { return fImageFilter.get(); }
+    SkImageFilter* getImageFilter() const {
+        return fEffects ? fEffects->fImageFilter.get() : nullptr;
+    }
 
     /** Returns SkImageFilter if set, or nullptr.
         Increases SkImageFilter SkRefCnt by one.
@@ -837,7 +841,7 @@ public:
 
         @return  SkDrawLooper if previously set, nullptr otherwise
     */
-    SkDrawLooper* getDrawLooper() const { return fDrawLooper.get(); }
+    SkDrawLooper* getDrawLooper() const { return fEffects ? fEffects->fDrawLooper.get() : nullptr; }
 
     /** Returns SkDrawLooper if set, or nullptr.
         Increases SkDrawLooper SkRefCnt by one.
@@ -849,7 +853,7 @@ public:
     /** Deprecated.
         (see skbug.com/6259)
     */
-    SkDrawLooper* getLooper() const { return fDrawLooper.get(); }
+    SkDrawLooper* getLooper() const { return this->getDrawLooper(); }
 
     /** Sets SkDrawLooper to drawLooper, decreasing SkRefCnt of the previous
         drawLooper.  Pass nullptr to clear SkDrawLooper and leave SkDrawLooper effect on
@@ -1483,13 +1487,26 @@ private:
     SkPaint(const SkPaint&, const SkRunFont&);
     typedef const SkGlyph& (*GlyphCacheProc)(SkGlyphCache*, const char**, const char*);
 
+    // The effects are kept together in an immutable bundle that copies of the paint share, so a
+    // copy takes one ref instead of six. Setters copy the bundle first if it is shared.
+    struct Effects : public SkNVRefCnt<Effects> {
+        Effects();
+        Effects(const Effects&);
+        ~Effects();
+
+        sk_sp<SkPathEffect>   fPathEffect;
+        sk_sp<SkShader>       fShader;
+        sk_sp<SkMaskFilter>   fMaskFilter;
+        sk_sp<SkColorFilter>  fColorFilter;
+        sk_sp<SkDrawLooper>   fDrawLooper;
+        sk_sp<SkImageFilter>  fImageFilter;
+    };
+
+    // Returns an unshared bundle that may be modified.
+    Effects* writableEffects();
+
     sk_sp<SkTypeface>     fTypeface;
-    sk_sp<SkPathEffect>   fPathEffect;
-    sk_sp<SkShader>       fShader;
-    sk_sp<SkMaskFilter>   fMaskFilter;
-    sk_sp<SkColorFilter>  fColorFilter;
-    sk_sp<SkDrawLooper>   fDrawLooper;
-    sk_sp<SkImageFilter>  fImageFilter;
+    sk_sp<const Effects>  fEffects;  // null means no effects
 
     SkScalar        fTextSize;
     SkScalar        fTextScaleX;
@@ -1685,6 +1685,7 @@ private:
     uint8_t                                              fFillType    : 2;
     uint8_t                                              fIsVolatile  : 1;
     uint8_t                                              fIsBadForDAA : 1;
+    uint8_t                                              fIsStrokeOutline : 1;
 
     /** Resets all fields other than fPathRef to their initial 'empty' values.
      *  Assumes the caller has already emptied fPathRef.
@@ -1761,6 +1762,7 @@ private:
     friend class SkAutoDisableDirectionCheck;
     friend class SkPathWriter;
     friend class SkOpBuilder;
+    friend class SkPathArena;
     friend class SkBench_AddPathTest; // perf test reversePathTo
     friend class PathTest_Private; // unit test reversePathTo
     friend class ForceIsRRect_Private; // unit test isRRect
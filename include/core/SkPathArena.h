@@ -0,0 +1,49 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathArena_DEFINED
+#define SkPathArena_DEFINED
+
+#include "SkData.h"
+#include "SkPath.h"
+
+/**
+ *  Packs paths that won't change into large shared blocks of memory, for callers that keep many
+ *  small paths around, e.g. the features of a map tile. A frozen path's conic weights, points and
+ *  verbs sit side by side in a block, with no room to grow, rather than in allocations of its own,
+ *  and its bounds and convexity are computed once when it is frozen.
+ *
+ *  Frozen paths are ordinary SkPaths. Copies share the packed data; editing one moves it to
+ *  memory of its own first. Each block stays alive as long as any path in it does, so frozen
+ *  paths may outlive the arena. The arena itself is not thread safe.
+ */
+class SK_API SkPathArena : SkNoncopyable {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit SkPathArena(size_t blockSize = kDefaultBlockSize);
+
+    /**
+     *  Returns a copy of path packed into the arena. Paths larger than a quarter of a block get
+     *  a block of their own.
+     */
+    SkPath freeze(const SkPath& path);
+
+    /** The bytes of all the blocks the arena has made. */
+    size_t bytesAllocated() const { return fBytesAllocated; }
+
+private:
+    char* allocate(size_t bytes, sk_sp<SkData>* block);
+
+    const size_t  fBlockSize;
+    sk_sp<SkData> fBlock;
+    char*         fCursor = nullptr;
+    char*         fEnd = nullptr;
+    size_t        fBytesAllocated = 0;
+};
+
+#endif
@@ -105,6 +105,11 @@ private:
     SkTDArray<Segment>  fSegments;
     SkTDArray<SkPoint>  fPts; // Points used to define the segments
 
+    // Every contour of a path, measured once and shared through SkResourceCache.
+    struct Table;
+    sk_sp<Table>    fTable;         // if set, contours come from here rather than fIter
+    int             fContourIndex;  // the contour in fTable to measure next
+
     static const Segment* NextSegment(const Segment*);
 
     void     buildSegments();
@@ -120,6 +125,8 @@ private:
     bool conic_too_curvy(const SkPoint& firstPt, const SkPoint& midTPt,const SkPoint& lastPt);
     bool cheap_dist_exceeds_limit(const SkPoint& pt, SkScalar x, SkScalar y);
     bool cubic_too_curvy(const SkPoint pts[4]);
+
+    friend class SkPathMeasurePriv;
 };
 
 #endif
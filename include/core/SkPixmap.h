@@ -657,6 +657,8 @@ public:
         bilerp filter. kMedium_SkFilterQuality is typically implemented with
         bilerp filter, and Filter_Quality_MipMap when size is reduced.
         kHigh_SkFilterQuality is slowest, typically implemented with Filter_Quality_BiCubic.
+        When reducing size of 8888 pixels, kHigh_SkFilterQuality instead applies a separable
+        Mitchell filter that weighs every source pixel under each destination pixel.
 
         @param dst            SkImageInfo and pixel address to write to
         @param filterQuality  one of: kNone_SkFilterQuality, kLow_SkFilterQuality,
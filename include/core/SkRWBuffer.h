@@ -12,8 +12,10 @@
 
 struct SkBufferBlock;
 struct SkBufferHead;
+struct SkBufferStreamState;
 class SkRWBuffer;
 class SkStreamAsset;
+class SkStreamSeekable;
 
 /**
  *  Contains a read-only, thread-sharable block of memory. To access the memory, the caller must
@@ -96,6 +98,23 @@ public:
 
     std::unique_ptr<SkStreamAsset> makeStreamSnapshot() const;
 
+    /**
+     *  Return a stream that sees everything appended to this buffer, including bytes appended
+     *  after it is made. When a read catches up with the writer, it waits for more bytes to be
+     *  appended or for finish() to be called, rather than returning early. This lets a decoder
+     *  on another thread consume the data as it arrives, without copying it or polling for it.
+     *
+     *  Like the snapshots, this must be called on the writer's thread, but the stream may then
+     *  be passed to another thread. It has no length, since more bytes may still be appended.
+     */
+    std::unique_ptr<SkStreamSeekable> makeStreamingReader();
+
+    /**
+     *  Mark the end of the data. Streaming readers report the end instead of waiting for more.
+     *  Nothing may be appended afterwards. The destructor calls this if it has not been called.
+     */
+    void finish();
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -106,6 +125,9 @@ private:
     SkBufferHead*   fHead;
     SkBufferBlock*  fTail;
     size_t          fTotalUsed;
+
+    // Created by the first makeStreamingReader(), and shared with the streams it returns.
+    sk_sp<SkBufferStreamState> fStreamState;
 };
 
 #endif
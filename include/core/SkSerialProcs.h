@@ -12,6 +12,8 @@
 #include "SkPicture.h"
 #include "SkTypeface.h"
 
+class SkExecutor;
+
 /**
  *  A serial-proc is asked to serialize the specified object (e.g. picture or image).
  *  If a data object is returned, it will be used (even if it is zero-length).
@@ -67,6 +69,12 @@ struct SK_API SkDeserialProcs {
 
     SkDeserialTypefaceProc  fTypefaceProc = nullptr;
     void*                   fTypefaceCtx = nullptr;
+
+    /**
+     *  If set, independent parts of a picture, such as its images, may be decoded concurrently
+     *  on this executor.  The procs above must then be safe to call from any thread.
+     */
+    SkExecutor*             fExecutor = nullptr;
 };
 
 #endif
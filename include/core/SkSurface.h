@@ -605,6 +605,57 @@ public:
     */
     bool readPixels(const SkBitmap& dst, int srcX, int srcY);
 
+    /** Client-provided context passed to the async read callbacks. */
+    typedef void* ReadPixelsContext;
+
+    /** Receives the pixels of asyncReadPixels(). pixels is nullptr if the read failed; otherwise
+        it is only valid for the duration of the call.
+    */
+    typedef void (*ReadPixelsCallback)(ReadPixelsContext context, const void* pixels,
+                                       size_t rowBytes);
+
+    /** Receives the Y, U, and V planes of asyncReadPixelsYUV420(). Each plane is nullptr if the
+        read failed; otherwise the planes are only valid for the duration of the call.
+    */
+    typedef void (*ReadPixelsYUV420Callback)(ReadPixelsContext context, const void* planes[3],
+                                             const size_t rowBytes[3]);
+
+    /** Like readPixels(), but does not wait for a GPU surface's pending drawing to finish.
+
+        Source SkRect corners are (srcX, srcY) and (srcX + dstInfo.width(),
+        srcY + dstInfo.height()), and must lie within SkSurface. The pixels are copied on the GPU
+        into a transfer buffer that is submitted before this returns, and callback is called from
+        GrContext::checkAsyncWorkCompletion() once the GPU has finished with it. If the context
+        is abandoned or destroyed first, callback is called with nullptr.
+
+        If the pixels must be converted on the CPU, or the backend can't read them
+        asynchronously, they are read synchronously instead, and callback is called before this
+        returns. That is always the case for a raster SkSurface.
+
+        @param dstInfo   width, height, SkColorType, SkAlphaType, and SkColorSpace of the pixels
+        @param srcX      offset into readable pixels on x-axis
+        @param srcY      offset into readable pixels on y-axis
+        @param callback  receives the pixels
+        @param context   passed to callback
+    */
+    void asyncReadPixels(const SkImageInfo& dstInfo, int srcX, int srcY,
+                         ReadPixelsCallback callback, ReadPixelsContext context);
+
+    /** Like asyncReadPixels(), but converts srcRect to 8-bit Y, U, and V planes with yuvColorSpace
+        before reading it. U and V are subsampled by two in each direction, so the planes hold
+        half as many bytes as 8-bit RGB would. On a GPU surface the conversion is done on the GPU.
+
+        The Y plane is srcRect.width() by srcRect.height(), and the U and V planes are
+        (srcRect.width() + 1) / 2 by (srcRect.height() + 1) / 2. Pixels are assumed to be opaque.
+
+        @param yuvColorSpace  conversion from RGB to YUV
+        @param srcRect        pixels to read; must lie within SkSurface
+        @param callback       receives the planes
+        @param context        passed to callback
+    */
+    void asyncReadPixelsYUV420(SkYUVColorSpace yuvColorSpace, const SkIRect& srcRect,
+                               ReadPixelsYUV420Callback callback, ReadPixelsContext context);
+
     /** Copies SkRect of pixels from the src SkPixmap to the SkSurface.
 
         Source SkRect corners are (0, 0) and (src.width(), src.height()).
@@ -52,6 +52,12 @@ class SK_API SkSurfaceProps {
 public:
     enum Flags {
         kUseDeviceIndependentFonts_Flag = 1 << 0,
+        /** Raster surfaces only: defer draws and replay them in parallel tiles on
+            SkExecutor::GetDefault(). Pending draws are flushed before the pixels are read. */
+        kThreadedRaster_Flag            = 1 << 1,
+        /** Raster surfaces only: scan convert and blit consecutive, non-overlapping path fills
+            that share a paint together. Pending fills are flushed before the pixels are read. */
+        kBatchRasterPathFills_Flag      = 1 << 2,
     };
     /** Deprecated alias used by Chromium. Will be removed. */
     static const Flags kUseDistanceFieldFonts_Flag = kUseDeviceIndependentFonts_Flag;
@@ -72,6 +78,14 @@ public:
         return SkToBool(fFlags & kUseDeviceIndependentFonts_Flag);
     }
 
+    bool isThreadedRaster() const {
+        return SkToBool(fFlags & kThreadedRaster_Flag);
+    }
+
+    bool isBatchRasterPathFills() const {
+        return SkToBool(fFlags & kBatchRasterPathFills_Flag);
+    }
+
     bool operator==(const SkSurfaceProps& that) const {
         return fFlags == that.fFlags && fPixelGeometry == that.fPixelGeometry;
     }
@@ -9,6 +9,8 @@
 #include "SkString.h"
 #include "SkTime.h"
 
+class SkExecutor;
+
 namespace SkPDF {
 
 /** Table 333 in PDF 32000-1:2008
@@ -131,7 +133,9 @@ struct Metadata {
     /** Encoding quality controls the trade-off between size and quality. By
         default this is set to 101 percent, which corresponds to lossless
         encoding. If this value is set to a value <= 100, and the image is
-        opaque, it will be encoded (using JPEG) with that quality setting.
+        opaque and looks photographic, it will be encoded (using JPEG) with
+        that quality setting. Images that are already JPEGs are embedded as
+        is, whatever this is set to.
     */
     int fEncodingQuality = 101;
 
@@ -141,6 +145,44 @@ struct Metadata {
      *  should retain ownership.
      */
     const StructureElementNode* fStructureElementTreeRoot = nullptr;
+
+    /** Executor to handle threaded work within PDF Backend. If this is nullptr,
+        then all work will be done serially on the main thread. To have worker
+        threads assist with various tasks, set this to a valid SkExecutor
+        instance. Currently used for image encoding, compression of page
+        contents and font subsetting. The document's bytes are the same either
+        way. The caller retains ownership, and the executor must outlive the
+        document.
+    */
+    SkExecutor* fExecutor = nullptr;
+
+    /** If true, each page's resources (images, layers, shaders and graphic
+        states) are written out when the page ends, rather than kept until the
+        document closes, so that memory use stays bounded for long documents.
+        Fonts are still written when the document closes, once the glyphs
+        every page uses are known. Objects are numbered differently than
+        without it.
+    */
+    bool fStreaming = false;
+
+    /** If true, images are also matched by a digest of their contents, so
+        that identical pixels drawn from different images (e.g. the same logo
+        decoded for every page) are embedded once. Computing the digest reads
+        the pixels of each image, unless it is a jpeg that is embedded as is.
+    */
+    bool fDeduplicateImages = false;
+
+    /** Trades off the speed of compressing page contents, layers and images
+        against the size of the document. kNone writes them uncompressed.
+    */
+    enum class CompressionLevel : int {
+        kDefault = -1,
+        kNone = 0,
+        kLowButFast = 1,
+        kAverage = 6,
+        kHighButSlow = 9,
+    };
+    CompressionLevel fCompressionLevel = CompressionLevel::kDefault;
 };
 
 /** Associate a node ID with subsequent drawing commands in an
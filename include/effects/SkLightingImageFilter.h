@@ -51,6 +51,8 @@ protected:
     inline sk_sp<const SkImageFilterLight> refLight() const;
     SkScalar surfaceScale() const { return fSurfaceScale; }
     bool affectsTransparentBlack() const override { return true; }
+    // The edges of the input are lit as the surface's edges, so tiling would light the seams.
+    bool onCanFilterInTiles() const override { return false; }
 
 private:
     sk_sp<SkImageFilterLight> fLight;
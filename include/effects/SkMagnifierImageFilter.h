@@ -30,6 +30,8 @@ protected:
     sk_sp<SkSpecialImage> onFilterImage(SkSpecialImage* source, const Context&,
                                         SkIPoint* offset) const override;
     sk_sp<SkImageFilter> onMakeColorSpace(SkColorSpaceXformer*) const override;
+    // The zoom is relative to the filtered bounds, which a tile would shrink.
+    bool onCanFilterInTiles() const override { return false; }
 
 private:
     static sk_sp<SkFlattenable> CreateProc(SkReadBuffer&);
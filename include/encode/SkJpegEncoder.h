@@ -10,6 +10,7 @@
 
 #include "SkEncoder.h"
 
+class SkExecutor;
 class SkJpegEncoderMgr;
 class SkWStream;
 
@@ -61,6 +62,17 @@ public:
          *  In the second case, the encoder supports linear or legacy blending.
          */
         AlphaOption fAlphaOption = AlphaOption::kIgnore;
+
+        /**
+         *  If not NULL, an encode of the whole image in one call is split into strips of rows
+         *  that are compressed in parallel on this executor.  The strips are joined into a
+         *  single baseline jpeg, separated by restart markers.
+         *
+         *  All strips have to share their Huffman tables, so this uses the standard tables
+         *  rather than computing optimal ones for the image.  The output is a few percent
+         *  larger than a serial encode, but decodes to the same pixels.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -11,6 +11,7 @@
 #include "SkEncoder.h"
 #include "SkDataTable.h"
 
+class SkExecutor;
 class SkPngEncoderMgr;
 class SkWStream;
 
@@ -59,6 +60,17 @@ public:
          *  and the (2i + 1)-th entry is the text for the i-th comment.
          */
         sk_sp<SkDataTable> fComments;
+
+        /**
+         *  If not NULL, an encode of the whole image in one call is split into segments of rows
+         *  that are filtered and deflated in parallel on this executor.  Each segment's deflate
+         *  is primed with the end of the segment before it, so the output stays close in size
+         *  to a serial encode.
+         *
+         *  When multiple filters are chosen, this tries at most two of them on each row (Paeth
+         *  and Sub, if they are chosen), rather than libpng's heuristic over all of them.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -34,6 +34,12 @@ namespace SkWebpEncoder {
          */
         Compression fCompression = Compression::kLossy;
         float fQuality = 100.0f;
+
+        /**
+         *  If true, libwebp may use a second thread for parts of the encode.  This speeds up
+         *  lossy encodes without changing their output.
+         */
+        bool fMultithreaded = false;
     };
 
     /**
@@ -8,6 +8,7 @@
 #ifndef GrContext_DEFINED
 #define GrContext_DEFINED
 
+#include "SkGraphics.h"
 #include "SkMatrix.h"
 #include "SkPathEffect.h"
 #include "SkTypes.h"
@@ -39,6 +40,7 @@ class GrRenderTargetContext;
 class GrResourceCache;
 class GrResourceProvider;
 class GrSamplerState;
+class GrShaderCapture;
 class GrSurfaceProxy;
 class GrSwizzle;
 class GrTextBlobCache;
@@ -206,6 +208,18 @@ public:
      */
     void purgeUnlockedResources(bool scratchResourcesOnly);
 
+    /**
+     * Frees GPU memory in proportion to the pressure level, as SkGraphics::OnMemoryPressure()
+     * does for Skia's CPU caches. At kModerate this purges part of the unlocked resources (scratch
+     * ones first) and cached text blobs, least recently used first; at kCritical it purges all of
+     * them, and the compiled programs too.
+     *
+     * SkGraphics::OnMemoryPressure() has every context do this when it next flushes. Call this
+     * to do it right away. Returns the bytes freed, and reports what each cache freed to dump
+     * if it isn't null, under "skia/memory_pressure/gr_context_<uniqueID>/<cache>".
+     */
+    size_t onMemoryPressure(SkGraphics::MemoryPressure, SkTraceMemoryDump* dump = nullptr);
+
     /**
      * Gets the maximum supported texture size.
      */
@@ -240,10 +254,33 @@ public:
     // Misc.
 
     /**
-     * Call to ensure all drawing to the context has been issued to the underlying 3D API.
+     * Call to ensure all drawing to the context has been issued to the underlying 3D API. The
+     * exception is kBackground work once the flush time budget is spent; see setFlushTimeBudget().
      */
     void flush();
 
+    enum class WorkPriority {
+        kCritical,    //<! Work the next flush must issue. The default.
+        kBackground,  //<! Work that can wait, such as warming up content for a later frame.
+    };
+
+    /**
+     * Sets the priority of the drawing recorded from now on. A flush issues background work after
+     * all the critical work that doesn't rely on it, so the critical work reaches the GPU first.
+     */
+    void setWorkPriority(WorkPriority);
+    WorkPriority workPriority() const;
+
+    /**
+     * Limits how long flush() spends issuing background work, in microseconds of wall-clock time
+     * counted from the start of the flush; 0, the default, is no limit. Critical work is always
+     * issued. Background work left over when the budget runs out is never dropped: it goes to the
+     * front of the next flush. Only flush() defers work. Flushes made to read or export a surface, and
+     * flushAndSignalSemaphores(), issue everything. When the context explicitly allocates GPU
+     * resources, background work is reordered but never deferred.
+     */
+    void setFlushTimeBudget(uint64_t microseconds);
+
     /**
      * Call to ensure all drawing to the context has been issued to the underlying 3D API. After
      * issuing all commands, numSemaphore semaphores will be signaled by the gpu. The client passes
@@ -268,6 +305,65 @@ public:
     GrSemaphoresSubmitted flushAndSignalSemaphores(int numSemaphores,
                                                    GrBackendSemaphore signalSemaphores[]);
 
+    /**
+     * Calls back the asynchronous reads, such as SkSurface::asyncReadPixels(), and the GPU timings
+     * (see setGpuTiming()) that the GPU has finished. Work that isn't finished is left pending;
+     * this never waits on the GPU.
+     */
+    void checkAsyncWorkCompletion();
+
+    enum class GpuTimingLevel {
+        kNone,      //<! No timing.
+        kOpLists,   //<! Each opList executed by a flush is timed.
+        kOps,       //<! Each op is timed as well as the opList it is part of.
+    };
+
+    /**
+     * Receives the GPU time spent on an opList or op. 'name' is the op's name, as reported by
+     * GrAuditTrail, or "RenderTargetOpList" or "TextureOpList" for a whole opList; it is a string
+     * literal. Ops report the ID of the opList that executed them.
+     */
+    typedef void (*GpuTimingCallback)(void* context, const char* name, uint32_t opListID,
+                                      uint64_t nanoseconds);
+
+    /**
+     * While the level isn't kNone, every opList a flush executes, and with kOps every op, is
+     * bracketed by GPU timestamps. Once the GPU has written both of a bracket's timestamps its
+     * duration is handed to the callback, in execution order, from a later flush or
+     * checkAsyncWorkCompletion(). Changing the level reports the brackets that are already
+     * finished and drops the rest. Returns false, and leaves timing off, if the backend can't
+     * time GPU work; currently that takes OpenGL 3.3 or GL_ARB_timer_query.
+     */
+    bool setGpuTiming(GpuTimingLevel, GpuTimingCallback, void* callbackContext);
+
+    /**
+     * On Vulkan, stores the contents of the context's VkPipelineCache in the PersistentCache it was
+     * created with, so later contexts can create their pipelines from it. This also happens when
+     * the context is destroyed; calling it once startup rendering is done saves the data sooner.
+     * Does nothing on other backends or without a PersistentCache.
+     */
+    void storeVkPipelineCacheData();
+
+    /**
+     * Given a key and data that this context's backend stored in the PersistentCache on a previous
+     * run, starts creating the program ahead of its first use, so drawing with it later doesn't
+     * stall on the driver. Clients can call this for each entry of their cache during startup.
+     * Currently only GL programs cached as program binaries can be precompiled; with
+     * GL_KHR_parallel_shader_compile they link on driver threads in the meantime. Returns false
+     * if the entry can't be precompiled, which is harmless.
+     */
+    bool precompileShader(const SkData& key, const SkData& data);
+
+    /**
+     * Given shaders recorded by the skpshaders tool on an earlier run, generates the backend's
+     * shader code for all of them ahead of their first use, on the threads of the context's
+     * fExecutor when it has one (otherwise before returning). Drawing with one of these programs
+     * later then skips SkSL compilation. Programs that have an entry in the PersistentCache are
+     * left to precompileShader(). Returns the number of programs started, or -1 if the data isn't
+     * a shader capture. Currently only GL generates shaders this way; other backends return 0.
+     */
+    int precompileShaders(const SkData& capturedShaders);
+
     /**
      * An ID associated with this context, guaranteed to be unique.
      */
@@ -310,6 +406,7 @@ private:
 
     bool                                    fDisableGpuYUVConversion;
     bool                                    fSharpenMipmappedTextures;
+    bool                                    fReduceProgramVariants;
     bool                                    fDidTestPMConversions;
     // true if the PM/UPM conversion succeeded; false otherwise
     bool                                    fPMUPMConversionsRoundTrip;
@@ -329,6 +426,8 @@ private:
 
     GrContextOptions::PersistentCache*      fPersistentCache;
 
+    GrShaderCapture*                        fShaderCapture;
+
     // TODO: have the GrClipStackClip use renderTargetContexts and rm this friending
     friend class GrContextPriv;
 
@@ -401,6 +500,18 @@ public:
                                   const SkSurfaceProps& surfaceProps,
                                   bool isMipMapped, bool willUseGLFBO0 = false);
 
+    /**
+     *  Makes a texture-backed copy of a raster or lazily generated image for the GrContext that
+     *  created this proxy. Unlike SkImage::makeTextureImage() this can be called on any thread.
+     *  The image is decoded, and if mipMapped is kYes its mip levels are built, on the calling
+     *  thread. The texture is created and uploaded when the GrContext first flushes a draw of the
+     *  returned image, through a transfer buffer when the backend supports them, so the
+     *  GrContext's thread neither decodes nor waits on the upload.
+     *
+     *  Returns nullptr if the image is already texture-backed or can't be decoded.
+     */
+    sk_sp<SkImage> makeTextureImage(sk_sp<SkImage> image, GrMipMapped mipMapped = GrMipMapped::kNo);
+
     bool operator==(const GrContextThreadSafeProxy& that) const {
         // Each GrContext should only ever have a single thread-safe proxy.
         SkASSERT((this == &that) == (fContextUniqueID == that.fContextUniqueID));
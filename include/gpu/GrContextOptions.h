@@ -34,7 +34,8 @@ struct GrContextOptions {
     /**
      * Abstract class which stores Skia data in a cache that persists between sessions. Currently,
      * Skia stores compiled shader binaries (only when glProgramBinary / glGetProgramBinary are
-     * supported) when provided a persistent cache, but this may extend to other data in the future.
+     * supported) on GL, and SPIR-V shaders and the VkPipelineCache's data on Vulkan, when provided
+     * a persistent cache, but this may extend to other data in the future.
      */
     class PersistentCache {
     public:
@@ -96,6 +97,14 @@ struct GrContextOptions {
      */
     bool fAllowPathMaskCaching = true;
 
+    /**
+     * If true, and path mask caching is allowed, the coverage counting path renderer compacts its
+     * cached path mask atlases instead of dropping them once they become fragmented: the masks that
+     * are still in use get copied into fresh atlases on the GPU as they are drawn. This helps long
+     * running apps that keep redrawing a changing set of paths.
+     */
+    bool fCompactPathMaskAtlases = false;
+
     /**
      * If true, the GPU will not be used to perform YUV -> RGB conversion when generating
      * textures from codec-backed images.
@@ -126,6 +135,13 @@ struct GrContextOptions {
      */
     Enable fAllowMultipleGlyphCacheTextures = Enable::kDefault;
 
+    /**
+     * If the glyph atlas can use multiple textures, this bounds how many each mask format may
+     * grow to before glyphs are evicted. Values larger than the maximum the text shaders support
+     * (currently 4) are clamped to it. A non-positive value means use that maximum.
+     */
+    int fGlyphCacheTextureMaximumPages = -1;
+
     /**
      * Bugs on certain drivers cause stencil buffers to leak. This flag causes Skia to avoid
      * allocating stencil buffers and use alternate rasterization paths, avoiding the leak.
@@ -152,6 +168,13 @@ struct GrContextOptions {
      */
     bool fSharpenMipmappedTextures = false;
 
+    /**
+     * If true, gradients pick the most general form of their fragment processors rather than the
+     * one that generates the least shader code for them, so that far fewer distinct programs are
+     * needed to draw them. This trades some per-pixel work for fewer shader compiles.
+     */
+    bool fReduceProgramVariants = false;
+
     /**
      * Enables driver workaround to use draws instead of glClear. This only applies to
      * GrBackendApi::kOpenGL.
@@ -178,6 +201,22 @@ struct GrContextOptions {
      */
     Enable fReduceOpListSplitting = Enable::kDefault;
 
+    /**
+     * Allow an op to combine with a compatible op recorded anywhere earlier in its opList, rather
+     * than only among the last few, as long as nothing recorded in between overlaps it. This helps
+     * content with many interleaved draws of different kinds. For now it is only turned on when
+     * explicitly enabled.
+     */
+    Enable fSpatialOpCombining = Enable::kDefault;
+
+    /**
+     * Upload raster images to textures through a ring of transfer buffers, so the backend can copy
+     * them into the textures asynchronously rather than on the flushing thread. Uploads fall back
+     * to writing the pixels directly whenever no transfer buffer is free. Only used when the
+     * backend supports transfer buffers and fences, and for now only when explicitly enabled.
+     */
+    Enable fStagedTextureUploads = Enable::kDefault;
+
     /**
      * Some ES3 contexts report the ES2 external image extension, but not the ES3 version.
      * If support for external images is critical, enabling this option will cause Ganesh to limit
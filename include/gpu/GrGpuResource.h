@@ -336,6 +336,9 @@ private:
     // by the cache.
     uint32_t fTimestamp;
     GrStdSteadyClock::time_point fTimeWhenBecamePurgeable;
+    // The budget partition the cache is accounting this resource against. This is maintained by
+    // the cache.
+    int fCachePartition;
 
     static const size_t kInvalidGpuMemorySize = ~static_cast<size_t>(0);
     GrScratchKey fScratchKey;
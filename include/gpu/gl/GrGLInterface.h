@@ -188,6 +188,7 @@ public:
         GrGLFunction<GrGLMapBufferRangeFn> fMapBufferRange;
         GrGLFunction<GrGLMapBufferSubDataFn> fMapBufferSubData;
         GrGLFunction<GrGLMapTexSubImage2DFn> fMapTexSubImage2D;
+        GrGLFunction<GrGLMaxShaderCompilerThreadsFn> fMaxShaderCompilerThreads;
         GrGLFunction<GrGLMultiDrawArraysIndirectFn> fMultiDrawArraysIndirect;
         GrGLFunction<GrGLMultiDrawElementsIndirectFn> fMultiDrawElementsIndirect;
         GrGLFunction<GrGLPixelStoreiFn> fPixelStorei;
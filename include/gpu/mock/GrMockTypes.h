@@ -55,6 +55,8 @@ struct GrMockOptions {
     // GrCaps options.
     bool fInstanceAttribSupport = false;
     uint32_t fMapBufferFlags = 0;
+    bool fFenceSyncSupport = false;
+    bool fTransferBufferSupport = false;
     int fMaxTextureSize = 2048;
     int fMaxRenderTargetSize = 2048;
     int fMaxVertexAttributes = 16;
@@ -10,7 +10,9 @@
 #include "../private/SkTArray.h"
 #include "../private/SkTDArray.h"
 #include "SkPreConfig.h"
+#include "SkScalar.h"
 
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -81,6 +83,32 @@ bool SK_API TightBounds(const SkPath& path, SkRect* result);
   */
 bool SK_API AsWinding(const SkPath& path, SkPath* result);
 
+/** Set this path to the result of applying the Op to this path and the specified path,
+    like Op(), but with curves replaced by lines that stray from them by at most tolerance.
+    The result has only lines, and fill type even odd or inverse even odd; it is meant for
+    drawing, where differences smaller than a fraction of a pixel don't show. This is much faster
+    than Op(), as it never needs to find where curves meet exactly.
+
+    @param one The first operand (for difference, the minuend)
+    @param two The second operand (for difference, the subtrahend)
+    @param op The operator to apply.
+    @param tolerance How far the result may stray from the exact result; must be greater than zero.
+    @param result The product of the operands. The result may be one of the inputs.
+    @return True if the operation succeeded.
+  */
+bool SK_API ApproximateOp(const SkPath& one, const SkPath& two, SkPathOp op, SkScalar tolerance,
+                          SkPath* result);
+
+/** Set this path to a set of non-overlapping contours that describe the same area as the
+    original path, like Simplify(), with curves replaced by lines as ApproximateOp() does.
+
+    @param path The path to simplify.
+    @param tolerance How far the result may stray from the exact result; must be greater than zero.
+    @param result The simplified path. The result may be the input.
+    @return True if simplification succeeded.
+  */
+bool SK_API ApproximateSimplify(const SkPath& path, SkScalar tolerance, SkPath* result);
+
 /** Perform a series of path operations, optimized for unioning many paths together.
   */
 class SK_API SkOpBuilder {
@@ -96,10 +124,15 @@ public:
     /** Computes the sum of all paths and operands, and resets the builder to its
         initial state.
 
+        When every operand is a union, paths whose bounds overlap are grouped
+        into clusters that are unioned independently; with an executor, the
+        clusters are unioned in parallel on it.
+
         @param result The product of the operands.
+        @param executor Optional executor for unioning clusters in parallel.
         @return True if the operation succeeded.
       */
-    bool resolve(SkPath* result);
+    bool resolve(SkPath* result, SkExecutor* executor = nullptr);
 
 private:
     SkTArray<SkPath> fPathRefs;
@@ -107,6 +140,7 @@ private:
 
     static bool FixWinding(SkPath* path);
     static void ReversePath(SkPath* path);
+    bool resolveUnionClusters(SkPath* result, SkExecutor* executor);
     void reset();
 };
 
@@ -18,4 +18,11 @@ class SkFontMgr;
  */
 SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir);
 
+/** Like the above, but keeps an index of the scanned fonts in the file at indexPath. Font files
+ *  whose size and modification time match the index are not opened at startup, and the index's
+ *  character coverage lets matchFamilyStyleCharacter() answer without opening font files.
+ *  The index is rewritten when fonts are added, changed, or removed.
+ */
+SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir, const char* indexPath);
+
 #endif // SkFontMgr_directory_DEFINED
@@ -16,7 +16,10 @@
 #include "SkTArray.h"
 #include "SkTHash.h"
 
+class GrMesh;
 class GrOp;
+class GrPipeline;
+class GrPrimitiveProcessor;
 
 /*
  * GrAuditTrail collects a list of draw ops, detailed information about those ops, and can dump them
@@ -26,6 +29,11 @@ class GrOp;
  * to enable auditing only when required and disable it promptly. The AutoEnable class helps to
  * ensure that the audit trail is disabled in a timely fashion. Once the information has been dealt
  * with, be sure to call reset(), or the log will simply keep growing.
+ *
+ * It can also estimate what each op costs when it executes (pixels touched, fragment processors,
+ * texture samples and color bandwidth) and accumulate the per-pixel fragment cost of every render
+ * target into a coarse heatmap. Ops usually execute in a later flush than the one that recorded
+ * them, so cost collection is switched on with setCollectCosts() rather than by enabling.
  */
 class GrAuditTrail {
 public:
@@ -101,6 +109,43 @@ public:
 
     void setClientID(int clientID) { fClientID = clientID; }
 
+    void setCollectCosts(bool collect) { fCollectCosts = collect; }
+    bool isCollectingCosts() const { return fCollectCosts; }
+
+    // Called around each op's execution; the draws in between are charged to it.
+    void opExecuting(const GrOp*);
+    void opExecuted() { fExecutingOpListID = kGrAuditTrailInvalidID; }
+
+    void drawExecuted(const GrPrimitiveProcessor&, const GrPipeline&, int meshCount,
+                      const SkRect& bounds);
+
+    /**
+     * The estimated cost of everything an op drew. These are bounds based, so an op that draws a
+     * thin diagonal line is charged for its whole bounding box.
+     */
+    struct OpCost {
+        int    fDraws = 0;
+        int    fFragmentProcessors = 0;  // Summed over the draws, as are the texture samples.
+        int    fTextureSamples = 0;
+        bool   fReadsDst = false;
+        double fPixels = 0;
+        double fBytes = 0;  // Color reads and writes plus 4 bytes per texture sample per pixel.
+    };
+
+    /**
+     * The fragment cost accumulated over one render target, in cells of kHeatmapCellSize pixels.
+     * The cost of a pixel is one for the draw itself plus one per fragment processor, texture
+     * sample and dst read; each cell holds the average over its pixels, summed over every draw.
+     */
+    struct Heatmap {
+        int             fWidth = 0;
+        int             fHeight = 0;
+        SkTArray<float> fCells;
+    };
+    static constexpr int kHeatmapCellSize = 8;
+
+    bool getHeatmap(GrSurfaceProxy::UniqueID, Heatmap*) const;
+
     // We could just return our internal bookkeeping struct if copying the data out becomes
     // a performance issue, but until then its nice to decouple
     struct OpInfo {
@@ -112,6 +157,7 @@ public:
         SkRect                   fBounds;
         GrSurfaceProxy::UniqueID fProxyUniqueID;
         SkTArray<Op>             fOps;
+        OpCost                   fCost;
     };
 
     void getBoundsByClientID(SkTArray<OpInfo>* outInfo, int clientID);
@@ -143,6 +189,7 @@ private:
         SkRect                         fBounds;
         Ops                            fChildren;
         const GrSurfaceProxy::UniqueID fProxyUniqueID;
+        OpCost                         fCost;
     };
     typedef SkTArray<std::unique_ptr<OpNode>, true> OpList;
 
@@ -157,10 +204,13 @@ private:
     SkTHashMap<int, Ops*> fClientIDLookup;
     OpList fOpList;
     SkTArray<SkString> fCurrentStackTrace;
+    SkTHashMap<uint32_t, Heatmap> fHeatmaps;
 
     // The client can pass in an optional client ID which we will use to mark the ops
     int fClientID;
     bool fEnabled;
+    bool fCollectCosts = false;
+    int fExecutingOpListID = kGrAuditTrailInvalidID;
 };
 
 #define GR_AUDIT_TRAIL_INVOKE_GUARD(audit_trail, invoke, ...) \
@@ -182,4 +232,18 @@ private:
 
 #define GR_AUDIT_TRAIL_OP_RESULT_NEW(audit_trail, op) // Doesn't do anything now, one day...
 
+#define GR_AUDIT_TRAIL_COST_GUARD(audit_trail, invoke, ...) \
+    if (audit_trail->isCollectingCosts()) {                  \
+        audit_trail->invoke(__VA_ARGS__);                    \
+    }
+
+#define GR_AUDIT_TRAIL_OP_EXECUTING(audit_trail, op) \
+    GR_AUDIT_TRAIL_COST_GUARD(audit_trail, opExecuting, op);
+
+#define GR_AUDIT_TRAIL_OP_EXECUTED(audit_trail) \
+    GR_AUDIT_TRAIL_COST_GUARD(audit_trail, opExecuted);
+
+#define GR_AUDIT_TRAIL_DRAW_EXECUTED(audit_trail, prim_proc, pipeline, mesh_count, bounds) \
+    GR_AUDIT_TRAIL_COST_GUARD(audit_trail, drawExecuted, prim_proc, pipeline, mesh_count, bounds);
+
 #endif
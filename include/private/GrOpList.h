@@ -14,6 +14,8 @@
 #include "SkRefCnt.h"
 #include "SkTDArray.h"
 
+#include <functional>
+
 class GrAuditTrail;
 class GrCaps;
 class GrOpFlushState;
@@ -114,7 +116,8 @@ protected:
     SkTArray<GrTextureProxy*, true> fDeferredProxies;
 
 private:
-    friend class GrDrawingManager; // for resetFlag, TopoSortTraits & gatherProxyIntervals
+    // for resetFlag, TopoSortTraits, gatherProxyIntervals & the background flag
+    friend class GrDrawingManager;
 
     void addDependency(GrOpList* dependedOn);
     void addDependent(GrOpList* dependent);
@@ -128,13 +131,20 @@ private:
     // Feed proxy usage intervals to the GrResourceAllocator class
     virtual void gatherProxyIntervals(GrResourceAllocator*) const = 0;
 
+    // Calls 'func' on every proxy this opList's ops read or write, besides its target
+    virtual void visitOpProxies(const std::function<void(GrSurfaceProxy*)>& func) const = 0;
+
+    // Was this opList recorded while the GrContext's work priority was kBackground?
+    bool isBackground() const { return this->isSetFlag(kBackground_Flag); }
+
     static uint32_t CreateUniqueID();
 
     enum Flags {
-        kClosed_Flag    = 0x01,   //!< This GrOpList can't accept any more ops
+        kClosed_Flag     = 0x01,   //!< This GrOpList can't accept any more ops
 
-        kWasOutput_Flag = 0x02,   //!< Flag for topological sorting
-        kTempMark_Flag  = 0x04,   //!< Flag for topological sorting
+        kWasOutput_Flag  = 0x02,   //!< Flag for topological sorting
+        kTempMark_Flag   = 0x04,   //!< Flag for topological sorting
+        kBackground_Flag = 0x08,   //!< Background work, which a flush may defer
     };
 
     void setFlag(uint32_t flag) {
@@ -183,6 +183,12 @@ protected:
         return SkToBool(fPendingWrites);
     }
 
+    // True if the only ref and pending IO on the proxy itself are one ref and one pending write,
+    // i.e. those of a single GrProxyRef for writing such as an opList's target.
+    bool internalIsOnlyReferencedByWriter() const {
+        return 1 == fRefCnt && 0 == fPendingReads && 1 == fPendingWrites;
+    }
+
     // For deferred proxies this will be null. For wrapped proxies it will point to the
     // wrapped resource.
     GrSurface* fTarget;
@@ -447,7 +453,13 @@ protected:
         return this->internalHasPendingWrite();
     }
 
+    bool isOnlyReferencedByWriter() const {
+        return this->internalIsOnlyReferencedByWriter();
+    }
+
     void computeScratchKey(GrScratchKey*) const;
+    // The key of a surface like the proxy's but of the given dimensions.
+    void computeScratchKey(int width, int height, GrScratchKey*) const;
 
     virtual sk_sp<GrSurface> createSurface(GrResourceProvider*) const = 0;
     void assign(sk_sp<GrSurface> surface);
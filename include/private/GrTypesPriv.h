@@ -50,6 +50,7 @@ enum GrPixelConfig {
     kRG_float_GrPixelConfig,
     kAlpha_half_GrPixelConfig,
     kRGBA_half_GrPixelConfig,
+    kRGB_ETC1_GrPixelConfig,
 
     /** For internal usage. */
     kPrivateConfig1_GrPixelConfig,
@@ -883,6 +884,11 @@ T* const* unique_ptr_address_as_pointer_address(std::unique_ptr<T> const* up) {
  */
 typedef uint64_t GrFence;
 
+/*
+ * A GPU timestamp query, or 0 for none
+ */
+typedef uint64_t GrTimestampQuery;
+
 /**
  * Used to include or exclude specific GPU path renderers for testing purposes.
  */
@@ -964,6 +970,7 @@ static inline GrSRGBEncoded GrPixelConfigIsSRGBEncoded(GrPixelConfig config) {
         case kAlpha_half_GrPixelConfig:
         case kAlpha_half_as_Red_GrPixelConfig:
         case kRGBA_half_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:
             return GrSRGBEncoded::kNo;
     }
     SK_ABORT("Invalid pixel config");
@@ -1002,12 +1009,26 @@ static inline size_t GrBytesPerPixel(GrPixelConfig config) {
         case kRG_float_GrPixelConfig:
             return 8;
         case kUnknown_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:  // Use GrCompressedFormatDataSize() for these.
             return 0;
     }
     SK_ABORT("Invalid pixel config");
     return 0;
 }
 
+// Returns whether the config's texels are stored in compressed blocks rather than one by one.
+static inline bool GrPixelConfigIsCompressed(GrPixelConfig config) {
+    return kRGB_ETC1_GrPixelConfig == config;
+}
+
+// Returns the number of bytes needed for one level of a compressed texture of the given size.
+static inline size_t GrCompressedFormatDataSize(GrPixelConfig config, int width, int height) {
+    SkASSERT(GrPixelConfigIsCompressed(config));
+    // ETC1 stores each 4x4 block of texels (padded at the right and bottom edges) in 8 bytes.
+    SkASSERT(kRGB_ETC1_GrPixelConfig == config);
+    return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
 static inline bool GrPixelConfigIsOpaque(GrPixelConfig config) {
     switch (config) {
         case kRGB_565_GrPixelConfig:
@@ -1016,6 +1037,7 @@ static inline bool GrPixelConfigIsOpaque(GrPixelConfig config) {
         case kGray_8_as_Lum_GrPixelConfig:
         case kGray_8_as_Red_GrPixelConfig:
         case kRG_float_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:
             return true;
         case kAlpha_8_GrPixelConfig:
         case kAlpha_8_as_Alpha_GrPixelConfig:
@@ -1060,6 +1082,7 @@ static inline bool GrPixelConfigIsAlphaOnly(GrPixelConfig config) {
         case kRGBA_float_GrPixelConfig:
         case kRG_float_GrPixelConfig:
         case kRGBA_half_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:
             return false;
     }
     SK_ABORT("Invalid pixel config.");
@@ -1085,6 +1108,7 @@ static inline GrSLPrecision GrSLSamplerPrecision(GrPixelConfig config) {
         case kBGRA_8888_GrPixelConfig:
         case kSRGBA_8888_GrPixelConfig:
         case kSBGRA_8888_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:
             return kLow_GrSLPrecision;
         case kRGBA_float_GrPixelConfig:
         case kRG_float_GrPixelConfig:
@@ -1216,6 +1240,10 @@ static inline GrColorType GrPixelConfigToColorTypeAndEncoding(GrPixelConfig conf
     switch (config) {
         case kUnknown_GrPixelConfig:
             return GrColorType::kUnknown;
+        case kRGB_ETC1_GrPixelConfig:
+            // Compressed texels have no CPU-side layout, so they can't be read or written as such.
+            *srgbEncoded = GrSRGBEncoded::kNo;
+            return GrColorType::kUnknown;
         case kAlpha_8_GrPixelConfig:
             *srgbEncoded = GrSRGBEncoded::kNo;
             return GrColorType::kAlpha_8;
@@ -136,6 +136,9 @@ public:
     // Destroy all allocated objects, free any heap allocations.
     void reset();
 
+    // Bytes allocated from the heap since construction or the last reset().
+    size_t heapBytes() const { return fHeapBytes; }
+
 private:
     static void AssertRelease(bool cond) { if (!cond) { ::abort(); } }
     static uint32_t ToU32(size_t v) {
@@ -221,6 +224,7 @@ private:
     // allocated is fFib0 * fFirstHeapAllocationSize. Using 2 ^ n * fFirstHeapAllocationSize
     // had too much slop for Android.
     uint32_t       fFib0 {1}, fFib1 {1};
+    size_t         fHeapBytes {0};
 };
 
 // Helper for defining allocators with inline/reserved storage.
@@ -23,6 +23,11 @@ class SkSurface;
  * This class contains pre-processed gpu operations that can be replayed into
  * an SkSurface via draw(SkDeferredDisplayList*).
  *
+ * A DDL can only be replayed once: its ops write their vertex and uniform data into the
+ * replaying context's flush state when they are prepared, and are deleted when that flush ends.
+ * Replaying one frame's structure with only its matrices or colors patched would need ops that
+ * can be prepared more than once against a parameter block, which they can't yet.
+ *
  * TODO: we probably need to expose this class so users can query it for memory usage.
  */
 class SK_API SkDeferredDisplayList {
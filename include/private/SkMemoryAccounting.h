@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMemoryAccounting_DEFINED
+#define SkMemoryAccounting_DEFINED
+
+#include "SkTemplates.h"
+#include "SkTypes.h"
+
+#include <atomic>
+
+class SkTraceMemoryDump;
+
+/**
+ *  The subsystems whose heap memory SkMemoryAccounting tracks. The caches (SkResourceCache,
+ *  SkStrikeCache, GrResourceCache) report their own memory, so they are not here.
+ */
+enum class SkMemoryTag {
+    kArenaBlocks,       // blocks held by SkArenaAlloc and GrMemoryPool
+    kArenaBlockPool,    // freed blocks kept by SkArenaBlockPool for reuse
+    kRecord,            // SkRecord's command arrays (its commands live in kArenaBlocks)
+    kPathRef,           // SkPathRef point and verb storage
+    kPictureData,       // op data, paints and paths of deserialized (or serializing) pictures
+    kCodec,             // SkCodec row and scratch buffers
+
+    kLast = kCodec
+};
+
+/**
+ *  Always-on counts of the bytes each SkMemoryTag holds. Owners call Add() and Remove() with the
+ *  sizes they already know when they allocate and free. A count is one relaxed atomic add, and
+ *  each tag's counter sits on its own cache line. SkGraphics::DumpMemoryStatistics() reports
+ *  every tag.
+ */
+class SK_API SkMemoryAccounting {
+public:
+    static constexpr int kTagCount = (int)SkMemoryTag::kLast + 1;
+
+    static void Add(SkMemoryTag tag, size_t bytes) {
+        gCounters[(int)tag].fBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    static void Remove(SkMemoryTag tag, size_t bytes) {
+        gCounters[(int)tag].fBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    static size_t Bytes(SkMemoryTag tag) {
+        return gCounters[(int)tag].fBytes.load(std::memory_order_relaxed);
+    }
+
+    static const char* Name(SkMemoryTag);
+
+    /** Dumps each tag as "skia/sk_memory/<name>". */
+    static void DumpMemoryStatistics(SkTraceMemoryDump*);
+
+    /**
+     *  Benchmarks can count every sk_malloc()/sk_realloc() (and operator new, in tools that link
+     *  in tools/AllocationCountingNew.cpp) on every thread, along with the bytes asked for.
+     *  Counting is off by default, when it costs each allocation one relaxed load.
+     */
+    struct AllocationStats {
+        uint64_t fCount;
+        uint64_t fBytes;
+    };
+    static void SetCountAllocations(bool enabled) {
+        gCountAllocations.store(enabled, std::memory_order_relaxed);
+    }
+    static void CountAllocation(size_t bytes) {
+        if (gCountAllocations.load(std::memory_order_relaxed)) {
+            gAllocations.fCount.fetch_add(1, std::memory_order_relaxed);
+            gAllocations.fBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+    static AllocationStats GetAllocationStats() {
+        return { gAllocations.fCount.load(std::memory_order_relaxed),
+                 gAllocations.fBytes.load(std::memory_order_relaxed) };
+    }
+
+private:
+    struct alignas(64) Counter {
+        std::atomic<size_t> fBytes;
+    };
+    static Counter gCounters[kTagCount];
+
+    struct alignas(64) AllocationCounter {
+        std::atomic<uint64_t> fCount;
+        std::atomic<uint64_t> fBytes;
+    };
+    static std::atomic<bool>  gCountAllocations;
+    static AllocationCounter  gAllocations;
+};
+
+/**
+ *  An SkAutoTMalloc whose storage is counted against kTag.
+ */
+template <typename T, SkMemoryTag kTag>
+class SkTaggedAutoTMalloc {
+public:
+    SkTaggedAutoTMalloc() {}
+    ~SkTaggedAutoTMalloc() { SkMemoryAccounting::Remove(kTag, fCount * sizeof(T)); }
+
+    T* reset(size_t count = 0) {
+        SkMemoryAccounting::Remove(kTag, fCount * sizeof(T));
+        fStorage.reset(count);
+        fCount = count;
+        SkMemoryAccounting::Add(kTag, fCount * sizeof(T));
+        return this->get();
+    }
+
+    T* get() const { return fStorage.get(); }
+
+    operator T*() { return fStorage.get(); }
+    operator const T*() const { return fStorage.get(); }
+
+private:
+    SkAutoTMalloc<T> fStorage;
+    size_t           fCount = 0;
+
+    SkTaggedAutoTMalloc(const SkTaggedAutoTMalloc&) = delete;
+    SkTaggedAutoTMalloc& operator=(const SkTaggedAutoTMalloc&) = delete;
+};
+
+#endif
@@ -9,7 +9,9 @@
 #define SkPathRef_DEFINED
 
 #include "SkAtomics.h"
+#include "SkData.h"
 #include "SkMatrix.h"
+#include "SkMemoryAccounting.h"
 #include "SkMutex.h"
 #include "SkPoint.h"
 #include "SkRRect.h"
@@ -37,6 +39,10 @@ class SkWBuffer;
  * and verbs both grow into the middle of the allocation until the meet. To access verb i in the
  * verb array use ref.verbs()[~i] (because verbs() returns a pointer just beyond the first
  * logical verb or the last verb in memory).
+ *
+ * A path ref made by SkPathArena instead keeps its conic weights, points and verbs, in that order,
+ * in a block of memory it shares with other path refs. It is never edited in place; editors copy
+ * it to an allocation of its own first.
  */
 
 class SK_API SkPathRef final : public SkNVRefCnt<SkPathRef> {
@@ -251,7 +257,9 @@ public:
     ~SkPathRef();
     int countPoints() const { return fPointCnt; }
     int countVerbs() const { return fVerbCnt; }
-    int countWeights() const { return fConicWeights.count(); }
+    int countWeights() const {
+        return fSharedStorage ? fSharedWeightCnt : fConicWeights.count();
+    }
 
     /**
      * Returns a pointer one beyond the first logical verb (last verb in memory order).
@@ -273,8 +281,10 @@ public:
      */
     const SkPoint* pointsEnd() const { return this->points() + this->countPoints(); }
 
-    const SkScalar* conicWeights() const { return fConicWeights.begin(); }
-    const SkScalar* conicWeightsEnd() const { return fConicWeights.end(); }
+    const SkScalar* conicWeights() const {
+        return fSharedStorage ? fSharedWeights : fConicWeights.begin();
+    }
+    const SkScalar* conicWeightsEnd() const { return this->conicWeights() + this->countWeights(); }
 
     /**
      * Convenience methods for getting to a verb or point by index.
@@ -336,6 +346,8 @@ private:
         fVerbs = nullptr;
         fPoints = nullptr;
         fFreeSpace = 0;
+        fSharedWeights = nullptr;
+        fSharedWeightCnt = 0;
         fGenerationID = kEmptyGenID;
         fSegmentMask = 0;
         fIsOval = false;
@@ -349,6 +361,9 @@ private:
 
     void copy(const SkPathRef& ref, int additionalReserveVerbs, int additionalReservePoints);
 
+    // True if nothing else refers to this path ref, and its storage is its own to change.
+    bool isEditable() const { return this->unique() && !fSharedStorage; }
+
     // Doesn't read fSegmentMask, but (re)computes it from the verbs array
     unsigned computeSegmentMask() const;
 
@@ -402,6 +417,7 @@ private:
         ptrdiff_t sizeDelta = this->currSize() - minSize;
 
         if (sizeDelta < 0 || static_cast<size_t>(sizeDelta) >= 3 * minSize) {
+            SkMemoryAccounting::Remove(SkMemoryTag::kPathRef, this->currSize());
             sk_free(fPoints);
             fPoints = nullptr;
             fVerbs = nullptr;
@@ -470,6 +486,7 @@ private:
         // Note that realloc could memcpy more than we need. It seems to be a win anyway. TODO:
         // encapsulate this.
         fPoints = reinterpret_cast<SkPoint*>(sk_realloc_throw(fPoints, newSize));
+        SkMemoryAccounting::Add(SkMemoryTag::kPathRef, growSize);
         size_t oldVerbSize = fVerbCnt * sizeof(uint8_t);
         void* newVerbsDst = SkTAddOffset<void>(fPoints, newSize - oldVerbSize);
         void* oldVerbsSrc = SkTAddOffset<void>(fPoints, oldSize - oldVerbSize);
@@ -538,6 +555,11 @@ private:
     int                 fPointCnt;
     size_t              fFreeSpace; // redundant but saves computation
     SkTDArray<SkScalar> fConicWeights;
+    // Set if SkPathArena made this path ref. The conic weights, points and verbs are in it, and
+    // fConicWeights is empty.
+    sk_sp<SkData>       fSharedStorage;
+    const SkScalar*     fSharedWeights;
+    int                 fSharedWeightCnt;
 
     enum {
         kEmptyGenID = 1, // GenID reserved for path ref with zero points and zero verbs.
@@ -562,6 +584,7 @@ private:
     friend class PathRefTest_Private;
     friend class ForceIsRRect_Private; // unit test isRRect
     friend class SkPath;
+    friend class SkPathArena;
 };
 
 #endif
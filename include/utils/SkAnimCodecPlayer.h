@@ -9,12 +9,42 @@
 #define SkAnimCodecPlayer_DEFINED
 
 #include "SkCodec.h"
+#include "SkMutex.h"
+#include "SkSemaphore.h"
 
+class SkData;
+class SkExecutor;
 class SkImage;
+class SkTaskGroup;
 
 class SkAnimCodecPlayer {
 public:
+    struct Options {
+        /**
+         *  If set, frames are decoded on this executor ahead of playback: whenever getFrame() is
+         *  called, the next fDecodeAhead frames that aren't decoded yet start decoding. Each run
+         *  of frames starting at a frame that needs no prior frame is independent of the others,
+         *  so runs decode in parallel. Each run decodes with its own codec, made from the
+         *  encoded data.
+         */
+        SkExecutor* fExecutor = nullptr;
+        int         fDecodeAhead = 0;
+
+        /**
+         *  The most decoded frames to keep, or 0 to keep all of them. When there are too many,
+         *  the frames that won't be played for the longest are dropped; they are decoded again
+         *  when they are needed. This is raised to at least fDecodeAhead + 1.
+         */
+        int         fMaxCachedFrames = 0;
+    };
+
     SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+
+    /**
+     *  Plays the image encoded in data. Returns a player with no frames if it can't be decoded.
+     */
+    SkAnimCodecPlayer(sk_sp<SkData> data, const Options&);
+
     ~SkAnimCodecPlayer();
 
     /**
@@ -46,12 +76,43 @@ public:
 
 
 private:
+    enum class FrameState {
+        kNotDecoded,
+        kDecoding,  // on the executor
+        kDecoded,
+    };
+
+    void init();
+    void decodeAhead();
+    void decodeRun(int first, int count);
+    // Decodes a frame. If prior is the frame at priorIndex, and that is the frame's required frame,
+    // it starts from that; otherwise it starts from the required frame if it's cached.
+    sk_sp<SkImage> decodeFrame(SkCodec*, int index, int priorIndex, const sk_sp<SkImage>& prior);
+    void didDecode(int index, sk_sp<SkImage>);
+    void dropFramesIfNeeded();
+    std::unique_ptr<SkCodec> takeCodec();
+    void returnCodec(std::unique_ptr<SkCodec>);
+
     std::unique_ptr<SkCodec>        fCodec;
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
     int                             fCurrIndex = 0;
-    uint32_t                        fTotalDuration;
+    uint32_t                        fTotalDuration = 0;
+
+    sk_sp<SkData>                   fData;
+    Options                         fOptions;
+
+    // fImages, fStates, fCachedFrames and fSpareCodecs are shared with decodes on fExecutor.
+    SkMutex                                fMutex;
+    std::vector<sk_sp<SkImage> >           fImages;
+    std::vector<FrameState>                fStates;
+    int                                    fCachedFrames = 0;
+    std::vector<std::unique_ptr<SkCodec> > fSpareCodecs;
+    // Signaled whenever a decode on fExecutor finishes.
+    SkSemaphore                            fDecoded;
+
+    // Last, so that it waits for decodes that use the rest.
+    std::unique_ptr<SkTaskGroup>           fTaskGroup;
 
     sk_sp<SkImage> getFrameAt(int index);
 };
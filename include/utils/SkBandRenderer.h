@@ -0,0 +1,49 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBandRenderer_DEFINED
+#define SkBandRenderer_DEFINED
+
+#include "SkImageInfo.h"
+#include "SkTypes.h"
+
+#include <functional>
+
+class SkPicture;
+class SkPixmap;
+class SkSurfaceProps;
+
+/**
+ * Renders an SkPicture into a raster image too large to allocate at once, a band of scanlines
+ * at a time. Only one band of pixels is alive at any moment, so peak memory is proportional to
+ * width * bandHeight rather than width * height. Each finished band is handed to a sink, in
+ * order from the top of the image, which can write it to a file or an encoder row by row.
+ */
+class SK_API SkBandRenderer {
+public:
+    /**
+     * Receives each band. The pixmap holds the band's rows, which are rows
+     * [top, top + band.height()) of the whole image, and is only valid during the call.
+     * Returning false stops rendering.
+     */
+    typedef std::function<bool(const SkPixmap& band, int top)> BandSink;
+
+    /**
+     * Renders picture into an image described by info, bandHeight rows at a time, starting
+     * from transparent. The picture is played back once per band, clipped to it, and only the
+     * ops whose bounds touch the band are drawn. A picture recorded without an SkBBHFactory is
+     * re-recorded into an SkRTree first. Anti-aliased edges cut by a band boundary may round
+     * slightly differently than when rendering the whole image at once.
+     *
+     * Returns false, having called the sink for none or only some of the bands, if info cannot
+     * be rendered to, bandHeight is not positive, or the sink returns false.
+     */
+    static bool RenderPicture(const SkPicture* picture, const SkImageInfo& info, int bandHeight,
+                              const BandSink& sink, const SkSurfaceProps* props = nullptr);
+};
+
+#endif
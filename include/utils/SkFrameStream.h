@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFrameStream_DEFINED
+#define SkFrameStream_DEFINED
+
+#include "SkRefCnt.h"
+
+#include <memory>
+
+class SkData;
+class SkPicture;
+
+/**
+ * Serializes a sequence of pictures, one per frame, for a reader that sees every frame in
+ * order, e.g. at the other end of a pipe. Paints, paths, text blobs, images, typefaces and
+ * flattenable factories are sent once, the first frame they're used in, and then referred to
+ * by ID in that frame and every later one. Frames that mostly repeat the last one's content
+ * only send their ops.
+ *
+ * Both ends remember everything sent until they're reset. If a frame is lost or rejected,
+ * reset() the writer; its next frame is self-contained and resets the reader too.
+ */
+class SK_API SkFrameStreamWriter {
+public:
+    struct Stats {
+        int fDefinitions = 0;   // objects sent in full
+        int fReferences  = 0;   // objects sent as the ID of an earlier definition
+        int fFallbackOps = 0;   // ops sent as a small serialized SkPicture
+    };
+
+    SkFrameStreamWriter();
+    ~SkFrameStreamWriter();
+
+    /** Returns the next frame's bytes, and if stats isn't null, what went into them. */
+    sk_sp<SkData> writeFrame(const SkPicture*, Stats* stats = nullptr);
+
+    /** Forgets everything sent so far; the next frame will tell the reader to do the same. */
+    void reset();
+
+    struct State;
+
+private:
+    std::unique_ptr<State> fState;
+};
+
+class SK_API SkFrameStreamReader {
+public:
+    SkFrameStreamReader();
+    ~SkFrameStreamReader();
+
+    /**
+     * Reads the next frame, returning nullptr if the bytes are malformed or out of sequence.
+     * After a failure, frames are rejected until the writer is reset.
+     */
+    sk_sp<SkPicture> readFrame(const void* data, size_t length);
+
+    struct State;
+
+private:
+    std::unique_ptr<State> fState;
+};
+
+#endif
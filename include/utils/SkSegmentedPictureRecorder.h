@@ -0,0 +1,80 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSegmentedPictureRecorder_DEFINED
+#define SkSegmentedPictureRecorder_DEFINED
+
+#include "../private/SkTArray.h"
+#include "SkBBHFactory.h"
+#include "SkPictureRecorder.h"
+#include "SkRect.h"
+
+class SkCanvas;
+class SkPicture;
+
+/**
+ * Records a picture as a sequence of segments, each its own SkPicture, so that changing one
+ * part of a scene only re-records (and re-optimizes) that part. Segments are identified by
+ * caller-chosen ids and drawn in the order they were first recorded. Each segment keeps the
+ * tight bounds of what it draws and a hash of its content; re-recording a segment with the
+ * same content keeps its previous picture, so caches keyed on that picture's uniqueID, such
+ * as the GPU backend's, stay valid.
+ */
+class SK_API SkSegmentedPictureRecorder {
+public:
+    struct Segment {
+        uint32_t         fID;
+        sk_sp<SkPicture> fPicture;
+        SkRect           fBounds;       // bounds of what the segment draws
+        uint32_t         fContentHash;  // of the ops; images and typefaces by uniqueID
+    };
+
+    SkSegmentedPictureRecorder();
+    ~SkSegmentedPictureRecorder();
+
+    /**
+     * Starts recording segment id, culled to bounds, and returns the canvas to record into,
+     * valid until endSegment(). A new id is appended after the existing segments; an existing
+     * one keeps its place and has its content replaced. Only one segment may be recorded at a
+     * time.
+     */
+    SkCanvas* beginSegment(uint32_t id, const SkRect& bounds);
+
+    /**
+     * Finishes the segment begun by beginSegment(). Returns true if its content changed, or
+     * false if it was the same as before, in which case the old picture is kept.
+     */
+    bool endSegment();
+
+    /** Removes segment id, returning false if there was none. */
+    bool removeSegment(uint32_t id);
+
+    int segmentCount() const { return fSegments.count(); }
+
+    /** Returns the segment at index, in drawing order. */
+    const Segment& segment(int index) const { return fSegments[index]; }
+
+    /** Returns segment id, or nullptr if there is none. */
+    const Segment* findSegment(uint32_t id) const;
+
+    /**
+     * Returns a picture that draws every segment in order. It holds one op per segment, and
+     * only its bounds hierarchy is rebuilt, so this stays cheap however large the segments are.
+     */
+    sk_sp<SkPicture> makePicture() const;
+
+private:
+    int indexOf(uint32_t id) const;
+
+    SkRTreeFactory    fFactory;
+    SkPictureRecorder fRecorder;
+    SkTArray<Segment> fSegments;
+    uint32_t          fRecordingID = 0;
+    bool              fRecording = false;
+};
+
+#endif
@@ -37,6 +37,10 @@ if [[ $@ == *help* ]]; then
   echo "  test = Make a build suitable for running tests or profiling"
   echo "  debug = Make a build suitable for debugging (defines SK_DEBUG)"
   echo "  asm.js = Build for asm.js instead of WASM (very experimental)"
+  echo "  simd = Use WebAssembly SIMD128 (SkNx_wasm.h). Needs an emsdk and a"
+  echo "         browser with wasm SIMD support."
+  echo "  threads = Build with pthreads, which Emscripten runs on web workers."
+  echo "            Needs SharedArrayBuffer in the browser."
   echo "  serve = starts a webserver allowing a user to navigate to"
   echo "          localhost:8000/pathkit.html to view the demo page."
   exit 0
@@ -68,6 +72,23 @@ if [[ $@ == *asm.js* ]]; then
   WASM_CONF="-s WASM=0 -s ALLOW_MEMORY_GROWTH=1"
 fi
 
+# Both of these must be passed to the libpathkit.a compile and to the final link, or the
+# objects won't agree on the vector types and atomics they were built for.
+SIMD_CFLAGS=""
+if [[ $@ == *simd* ]]; then
+  echo "Building with WebAssembly SIMD"
+  SIMD_CFLAGS="\"-msimd128\","
+  WASM_CONF="$WASM_CONF -msimd128"
+fi
+
+THREAD_CFLAGS=""
+if [[ $@ == *threads* ]]; then
+  echo "Building with pthreads"
+  THREAD_CFLAGS="\"-pthread\","
+  # Start the workers up front; spawning one later needs the main thread to yield.
+  WASM_CONF="$WASM_CONF -pthread -s USE_PTHREADS=1 -s PTHREAD_POOL_SIZE=4"
+fi
+
 OUTPUT="-o $BUILD_DIR/pathkit.js"
 
 source $EMSDK/emsdk_env.sh
@@ -92,6 +113,7 @@ echo "Compiling bitcode"
   --args="cc=\"${EMCC}\" \
   cxx=\"${EMCXX}\" \
   extra_cflags=[\"-DSK_DISABLE_READBUFFER=1\",\"-s\", \"WARN_UNALIGNED=1\",
+    ${SIMD_CFLAGS} ${THREAD_CFLAGS}
     ${EXTRA_CFLAGS}
   ] \
   is_debug=false \
@@ -80,6 +80,25 @@ module.exports = function(config) {
     cfg.proxies = {
       '/pathkit/': '/base/npm-asmjs/bin/'
     };
+  } else if (process.env.PATHKIT_VARIANT) {
+    // One of the builds from make npm-bench-variants, i.e. simd or simd-threads.
+    const variant = process.env.PATHKIT_VARIANT;
+    console.log(`wasm (${variant}) is under test`);
+    cfg.files = [
+      { pattern: `npm-wasm/bin/${variant}/pathkit.wasm`, included:false, served:true},
+      // Only the threaded build has a worker script.
+      { pattern: `npm-wasm/bin/${variant}/pathkit.worker.js`, included:false, served:true},
+      'perf/perfReporter.js',
+      `npm-wasm/bin/${variant}/pathkit.js`,
+      'perf/*.bench.js'
+    ];
+
+    cfg.proxies = {
+      '/pathkit/': `/base/npm-wasm/bin/${variant}/`
+    };
+    cfg.client = {
+      variant: variant,
+    };
   } else {
     console.log('wasm is under test');
   }
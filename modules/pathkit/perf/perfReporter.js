@@ -48,6 +48,11 @@ function benchmarkAndReport(benchName, setupFn, testFn, teardownFn) {
 
 
 function _report(microseconds, benchName) {
+    // Results from the SIMD or threaded builds are reported next to the default build's.
+    const variant = window.__karma__ && window.__karma__.config.variant;
+    if (variant) {
+        benchName = `${benchName}_${variant}`;
+    }
     return fetch(REPORT_URL, {
         method: 'POST',
         mode: 'no-cors',
@@ -18,13 +18,19 @@
 
 class SkCanvas;
 class SkData;
+class SkExecutor;
 class SkImage;
 struct SkRect;
 class SkStream;
 
 namespace skjson { class ObjectValue; }
 
-namespace sksg { class Scene;  }
+namespace sksg {
+
+class InvalidationController;
+class Scene;
+
+} // namespace sksg
 
 namespace skottie {
 
@@ -176,6 +182,14 @@ public:
          */
         Builder& setAnnotationObserver(sk_sp<AnnotationObserver>);
 
+        /**
+         * Specify an executor for seek(): the animation's top-level layers are then animated
+         * concurrently, each on a task of its own.  The executor must outlive the animation.
+         *
+         * Note: an animated ImageAsset can then see concurrent getFrame() calls (one per layer).
+         */
+        Builder& setExecutor(SkExecutor*);
+
         /**
          * Animation factories.
          */
@@ -189,6 +203,7 @@ public:
         sk_sp<PropertyObserver>   fPropertyObserver;
         sk_sp<Logger>             fLogger;
         sk_sp<AnnotationObserver> fAnnotationObserver;
+        SkExecutor*               fExecutor = nullptr;
         Stats                     fStats;
     };
 
@@ -215,9 +230,13 @@ public:
      * Updates the animation state for |t|.
      *
      * @param t   normalized [0..1] frame selector (0 -> first frame, 1 -> final frame)
+     * @param ic  optional invalidation controller, receiving the areas (in animation
+     *            coordinates, see size()) which changed since the previous seek with a
+     *            controller.  Clients retaining the previous frame can then clip to (and erase)
+     *            the damage before calling render(): content outside the clip is skipped.
      *
      */
-    void seek(SkScalar t);
+    void seek(SkScalar t, sksg::InvalidationController* ic = nullptr);
 
     /**
      * Returns the animation duration in seconds.
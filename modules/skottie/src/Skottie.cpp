@@ -302,6 +302,11 @@ Animation::Builder& Animation::Builder::setAnnotationObserver(sk_sp<AnnotationOb
     return *this;
 }
 
+Animation::Builder& Animation::Builder::setExecutor(SkExecutor* executor) {
+    fExecutor = executor;
+    return *this;
+}
+
 sk_sp<Animation> Animation::Builder::make(SkStream* stream) {
     if (!stream->hasLength()) {
         // TODO: handle explicit buffering?
@@ -384,6 +389,10 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
         fLogger->log(Logger::Level::kError, "Could not parse animation.\n");
     }
 
+    if (scene) {
+        scene->setExecutor(fExecutor);
+    }
+
     return sk_sp<Animation>(
         new Animation(std::move(scene), std::move(version), size, inPoint, outPoint, duration));
 }
@@ -477,11 +486,15 @@ void Animation::render(SkCanvas* canvas, const SkRect* dstR) const {
     fScene->render(canvas);
 }
 
-void Animation::seek(SkScalar t) {
+void Animation::seek(SkScalar t, sksg::InvalidationController* ic) {
     if (!fScene)
         return;
 
     fScene->animate(fInPoint + SkTPin(t, 0.0f, 1.0f) * (fOutPoint - fInPoint));
+
+    if (ic) {
+        fScene->revalidate(ic);
+    }
 }
 
 sk_sp<Animation> Animation::Make(const char* data, size_t length) {
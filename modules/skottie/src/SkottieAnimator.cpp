@@ -12,7 +12,9 @@
 #include "SkSGScene.h"
 #include "SkString.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace skottie {
@@ -43,7 +45,10 @@ protected:
 
     const KeyframeRec& frame(float t) {
         if (!fCachedRec || !fCachedRec->contains(t)) {
-            fCachedRec = findFrame(t);
+            fCachedRec = this->findAdjacentFrame(t);
+            if (!fCachedRec) {
+                fCachedRec = this->findFrame(t);
+            }
         }
         return *fCachedRec;
     }
@@ -63,6 +68,9 @@ protected:
     virtual int parseValue(const skjson::Value&, const AnimationBuilder* abuilder) = 0;
 
     void parseKeyFrames(const skjson::ArrayValue& jframes, const AnimationBuilder* abuilder) {
+        // Control points for fCubicMaps.
+        std::vector<std::pair<SkPoint, SkPoint>> cubic_pts;
+
         for (const skjson::ObjectValue* jframe : jframes) {
             if (!jframe) continue;
 
@@ -103,11 +111,16 @@ protected:
 
             int cm_idx = -1;
             if (c0 != kDefaultC0 || c1 != kDefaultC1) {
-                // TODO: is it worth de-duping these?
-                cm_idx = SkToInt(fCubicMaps.size());
-                fCubicMaps.emplace_back();
-                // TODO: why do we have to plug these inverted?
-                fCubicMaps.back().setPts(c1, c0);
+                // Keyframes tend to share their easing curves: dedupe the cubic maps.
+                const auto it = std::find(cubic_pts.begin(), cubic_pts.end(),
+                                          std::make_pair(c0, c1));
+                cm_idx = SkToInt(it - cubic_pts.begin());
+                if (it == cubic_pts.end()) {
+                    cubic_pts.emplace_back(c0, c1);
+                    fCubicMaps.emplace_back();
+                    // TODO: why do we have to plug these inverted?
+                    fCubicMaps.back().setPts(c1, c0);
+                }
             }
 
             fRecs.push_back({t0, t0, v0_idx, v1_idx, cm_idx });
@@ -130,6 +143,24 @@ protected:
     }
 
 private:
+    // Playback is mostly monotonic, so when the cached frame no longer contains t, one of its
+    // neighbors usually does.
+    const KeyframeRec* findAdjacentFrame(float t) const {
+        if (!fCachedRec) {
+            return nullptr;
+        }
+
+        if (fCachedRec != &fRecs.back() && fCachedRec[1].contains(t)) {
+            return fCachedRec + 1;
+        }
+
+        if (fCachedRec != &fRecs.front() && fCachedRec[-1].contains(t)) {
+            return fCachedRec - 1;
+        }
+
+        return nullptr;
+    }
+
     const KeyframeRec* findFrame(float t) const {
         SkASSERT(!fRecs.empty());
 
@@ -15,6 +15,7 @@
 #include "SkottieJson.h"
 #include "SkottieValue.h"
 #include "SkParse.h"
+#include "SkSGCacheEffect.h"
 #include "SkSGClipEffect.h"
 #include "SkSGColor.h"
 #include "SkSGDraw.h"
@@ -168,9 +169,21 @@ sk_sp<sksg::RenderNode> AttachMask(const skjson::ArrayValue* jmask,
         maskNode = sksg::Group::Make(std::move(masks));
     }
 
-    return sksg::MaskEffect::Make(std::move(childNode), std::move(maskNode));
+    return sksg::CacheEffect::Make(
+            sksg::MaskEffect::Make(std::move(childNode), std::move(maskNode)));
 }
 
+// Ticks animators which drive a shared adapter as a single top-level animator, since
+// sksg::Scene may tick its top-level animators concurrently.
+class AdapterAnimator final : public sksg::GroupAnimator {
+public:
+    explicit AdapterAnimator(sksg::AnimatorList&& animators)
+        : INHERITED(std::move(animators)) {}
+
+private:
+    using INHERITED = sksg::GroupAnimator;
+};
+
 } // namespace
 
 sk_sp<sksg::RenderNode> AnimationBuilder::attachNestedAnimation(const char* name,
@@ -448,10 +461,15 @@ private:
         auto parent_matrix = this->AttachParentLayerMatrix(jlayer, abuilder, layer_index);
 
         if (const skjson::ObjectValue* jtransform = jlayer["ks"]) {
-            return *fLayerMatrixMap.set(layer_index,
-                                        abuilder->attachMatrix(*jtransform, fScope,
-                                                               std::move(parent_matrix)));
+            AnimatorScope matrix_animators;
+            auto matrix = abuilder->attachMatrix(*jtransform, &matrix_animators,
+                                                 std::move(parent_matrix));
+            if (!matrix_animators.empty()) {
+                fScope->push_back(
+                    skstd::make_unique<AdapterAnimator>(std::move(matrix_animators)));
+            }
 
+            return *fLayerMatrixMap.set(layer_index, std::move(matrix));
         }
         return nullptr;
     }
@@ -575,9 +593,10 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachLayer(const skjson::ObjectValue*
         const auto matteType = ParseDefault<size_t>((*jlayer)["tt"], 1) - 1;
 
         if (matteType < SK_ARRAY_COUNT(gMaskModes)) {
-            return sksg::MaskEffect::Make(std::move(controller_node),
-                                          std::move(layerCtx->fCurrentMatte),
-                                          gMaskModes[matteType]);
+            return sksg::CacheEffect::Make(
+                    sksg::MaskEffect::Make(std::move(controller_node),
+                                           std::move(layerCtx->fCurrentMatte),
+                                           gMaskModes[matteType]));
         }
         layerCtx->fCurrentMatte.reset();
     }
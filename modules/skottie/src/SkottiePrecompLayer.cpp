@@ -11,6 +11,7 @@
 #include "SkottieJson.h"
 #include "SkottieValue.h"
 #include "SkMakeUnique.h"
+#include "SkSGCacheEffect.h"
 #include "SkSGRenderNode.h"
 #include "SkSGScene.h"
 #include "SkTLazy.h"
@@ -30,12 +31,14 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachPrecompLayer(const skjson::Objec
                                        time_remap;
 
     AnimatorScope local_animators;
+    const auto animator_count = ascope->size();
     auto precomp_layer = this->attachAssetRef(jlayer,
                                               requires_time_mapping ? &local_animators : ascope,
                                               [this] (const skjson::ObjectValue& jcomp,
                                                       AnimatorScope* ascope) {
                                                   return this->attachComposition(jcomp, ascope);
                                               });
+    const auto is_static = local_animators.empty() && ascope->size() == animator_count;
 
     // Applies a bias/scale/remap t-adjustment to child animators.
     class CompTimeMapper final : public sksg::GroupAnimator {
@@ -83,6 +86,12 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachPrecompLayer(const skjson::Objec
         ascope->push_back(std::move(time_mapper));
     }
 
+    // Static precomps (no animators of their own) render the same content on every frame, so
+    // the cache gets to replace their re-rendering with a single image draw.
+    if (is_static) {
+        return sksg::CacheEffect::Make(std::move(precomp_layer));
+    }
+
     return precomp_layer;
 }
 
@@ -5,10 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkMatrix.h"
+#include "SkSGInvalidationController.h"
 #include "Skottie.h"
 #include "SkottieProperty.h"
 #include "SkStream.h"
+#include "SkSurface.h"
 
 #include "Test.h"
 
@@ -196,3 +201,180 @@ DEF_TEST(Skottie_Annotations, reporter) {
     REPORTER_ASSERT(reporter, std::get<0>(observer->fAnnotations[2]) == "key3");
     REPORTER_ASSERT(reporter, std::get<1>(observer->fAnnotations[2]) == "baz");
 }
+
+DEF_TEST(Skottie_ConcurrentSeek, reporter) {
+    // Two animated layers, the second parented to the first.
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 100,
+                                     "h": 100,
+                                     "fr": 1,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "layers": [
+                                       {
+                                         "ty": 1,
+                                         "ind": 0,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "o": { "a": 1, "k": [
+                                             { "t": 0, "s": [ 20 ], "e": [ 100 ],
+                                               "i": { "x": [ 1 ], "y": [ 1 ] },
+                                               "o": { "x": [ 0 ], "y": [ 0 ] } },
+                                             { "t": 10 }
+                                           ]},
+                                           "p": { "a": 1, "k": [
+                                             { "t": 0, "s": [ 0, 0 ], "e": [ 40, 20 ],
+                                               "i": { "x": [ 1 ], "y": [ 1 ] },
+                                               "o": { "x": [ 0 ], "y": [ 0 ] } },
+                                             { "t": 10 }
+                                           ]}
+                                         },
+                                         "sw": 50,
+                                         "sh": 50,
+                                         "sc": "#ff0000"
+                                       },
+                                       {
+                                         "ty": 1,
+                                         "ind": 1,
+                                         "parent": 0,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "r": { "a": 1, "k": [
+                                             { "t": 0, "s": [ 0 ], "e": [ 90 ],
+                                               "i": { "x": [ 1 ], "y": [ 1 ] },
+                                               "o": { "x": [ 0 ], "y": [ 0 ] } },
+                                             { "t": 10 }
+                                           ]}
+                                         },
+                                         "sw": 30,
+                                         "sh": 30,
+                                         "sc": "#0000ff"
+                                       }
+                                     ]
+                                   })";
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    auto serial     = Animation::Builder().make(json, strlen(json)),
+         concurrent = Animation::Builder().setExecutor(executor.get()).make(json, strlen(json));
+    REPORTER_ASSERT(reporter, serial && concurrent);
+    if (!serial || !concurrent) {
+        return;
+    }
+
+    const auto info = SkImageInfo::MakeN32Premul(100, 100);
+    auto expected = SkSurface::MakeRaster(info),
+         actual   = SkSurface::MakeRaster(info);
+    SkBitmap expectedBitmap, actualBitmap;
+    expectedBitmap.allocPixels(info);
+    actualBitmap.allocPixels(info);
+
+    for (float t : { 0.0f, 0.3f, 0.75f, 1.0f }) {
+        serial->seek(t);
+        concurrent->seek(t);
+
+        expected->getCanvas()->clear(SK_ColorWHITE);
+        actual->getCanvas()->clear(SK_ColorWHITE);
+        serial->render(expected->getCanvas());
+        concurrent->render(actual->getCanvas());
+
+        expected->readPixels(expectedBitmap, 0, 0);
+        actual->readPixels(actualBitmap, 0, 0);
+        REPORTER_ASSERT(reporter, !memcmp(expectedBitmap.getPixels(), actualBitmap.getPixels(),
+                                          expectedBitmap.computeByteSize()));
+    }
+}
+
+DEF_TEST(Skottie_IncrementalRender, reporter) {
+    // A static layer, and a layer moving across it.
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 100,
+                                     "h": 100,
+                                     "fr": 1,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "layers": [
+                                       {
+                                         "ty": 1,
+                                         "ind": 0,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "p": { "a": 1, "k": [
+                                             { "t": 0, "s": [ 10, 10 ], "e": [ 70, 35 ],
+                                               "i": { "x": [ 1 ], "y": [ 1 ] },
+                                               "o": { "x": [ 0 ], "y": [ 0 ] } },
+                                             { "t": 10 }
+                                           ]}
+                                         },
+                                         "sw": 20,
+                                         "sh": 20,
+                                         "sc": "#0000ff"
+                                       },
+                                       {
+                                         "ty": 1,
+                                         "ind": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "o": { "a": 0, "k": 50 }
+                                         },
+                                         "sw": 100,
+                                         "sh": 50,
+                                         "sc": "#ff0000"
+                                       }
+                                     ]
+                                   })";
+
+    auto full        = Animation::Make(json, strlen(json)),
+         incremental = Animation::Make(json, strlen(json));
+    REPORTER_ASSERT(reporter, full && incremental);
+    if (!full || !incremental) {
+        return;
+    }
+
+    const auto info = SkImageInfo::MakeN32Premul(100, 100);
+    auto expected = SkSurface::MakeRaster(info),
+         actual   = SkSurface::MakeRaster(info);
+    SkBitmap expectedBitmap, actualBitmap;
+    expectedBitmap.allocPixels(info);
+    actualBitmap.allocPixels(info);
+
+    static constexpr float kTimes[] = { 0, 0, 0.25f, 0.5f, 1 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kTimes); ++i) {
+        const auto t = kTimes[i];
+        sksg::InvalidationController ic;
+        incremental->seek(t, &ic);
+
+        const auto damage = SkRect::Make(ic.bounds().roundOut());
+        if (i == 0) {
+            // The first seek damages all of the content.
+            REPORTER_ASSERT(reporter, damage.contains(SkRect::MakeWH(100, 50)));
+        } else if (i == 1) {
+            // Nothing changed since then.
+            REPORTER_ASSERT(reporter, damage.isEmpty());
+        } else {
+            // Only the area covered by the moving layer changes.
+            REPORTER_ASSERT(reporter, !damage.isEmpty() && damage.height() <= 65);
+        }
+
+        auto* canvas = actual->getCanvas();
+        canvas->save();
+        canvas->clipRect(damage);
+        canvas->clear(SK_ColorWHITE);
+        incremental->render(canvas);
+        canvas->restore();
+
+        full->seek(t);
+        expected->getCanvas()->clear(SK_ColorWHITE);
+        full->render(expected->getCanvas());
+
+        expected->readPixels(expectedBitmap, 0, 0);
+        actual->readPixels(actualBitmap, 0, 0);
+        REPORTER_ASSERT(reporter, !memcmp(expectedBitmap.getPixels(), actualBitmap.getPixels(),
+                                          expectedBitmap.computeByteSize()));
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "SkCanvas.h"
 #include "SkCommandLineFlags.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkMakeUnique.h"
 #include "SkOSFile.h"
@@ -29,6 +30,8 @@ DEFINE_double(fps, 30, "Decode frames per second.");
 DEFINE_int32(width , 800, "Render width.");
 DEFINE_int32(height, 600, "Render height.");
 
+DEFINE_int32(threads, 0, "Number of worker threads used to animate layers (0 = animate serially).");
+
 namespace {
 
 class Sink {
@@ -185,8 +188,14 @@ int main(int argc, char** argv) {
 
     auto logger = sk_make_sp<Logger>();
 
+    std::unique_ptr<SkExecutor> executor;
+    if (FLAGS_threads > 0) {
+        executor = SkExecutor::MakeFIFOThreadPool(FLAGS_threads);
+    }
+
     auto anim = skottie::Animation::Builder()
             .setLogger(logger)
+            .setExecutor(executor.get())
             .makeFromFile(FLAGS_input[0]);
     if (!anim) {
         SkDebugf("Could not load animation: '%s'.\n", FLAGS_input[0]);
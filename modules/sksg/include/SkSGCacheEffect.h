@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSGCacheEffect_DEFINED
+#define SkSGCacheEffect_DEFINED
+
+#include "SkSGEffectNode.h"
+
+#include "SkImage.h"
+#include "SkMatrix.h"
+#include "SkPoint.h"
+
+namespace sksg {
+
+/**
+ * Concrete Effect node, caching the rendered content of its descendants.
+ *
+ * Once the sub-DAG has rendered unchanged (no invalidation, same total matrix) for a couple of
+ * frames, it is rasterized into a device-space image which subsequent renders draw instead.
+ * Meant for expensive content (masks, mattes) which tends to stay static. Content covering more
+ * than a megapixel on the device is not cached.
+ *
+ * Content rendered under an ancestor's opacity or color filter is not cached, as those apply to
+ * each descendant draw individually.
+ */
+class CacheEffect final : public EffectNode {
+public:
+    static sk_sp<CacheEffect> Make(sk_sp<RenderNode> child) {
+        return child ? sk_sp<CacheEffect>(new CacheEffect(std::move(child))) : nullptr;
+    }
+
+protected:
+    explicit CacheEffect(sk_sp<RenderNode>);
+
+    void onRender(SkCanvas*, const RenderContext*) const override;
+
+    SkRect onRevalidate(InvalidationController*, const SkMatrix&) override;
+
+private:
+    sk_sp<SkImage> rasterize(SkCanvas*, const SkMatrix& ctm, SkIPoint* origin) const;
+
+    // Render state (the total matrix is only known at render time).
+    mutable sk_sp<SkImage> fImage;
+    mutable SkIPoint       fImageOrigin;
+    mutable SkMatrix       fLastCTM;
+    mutable int            fStableRenders = 0;
+    mutable bool           fImageValid    = false;
+
+    typedef EffectNode INHERITED;
+};
+
+} // namespace sksg
+
+#endif // SkSGCacheEffect_DEFINED
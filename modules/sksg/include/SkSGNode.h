@@ -73,8 +73,21 @@ private:
     template <typename Func>
     void forEachInvalObserver(Func&&) const;
 
+    void invalidateImpl(bool damage);
+
     class ScopedFlag;
 
+    // While one of these is alive, invalidation is serialized across threads. Scene uses it to
+    // tick animators concurrently: they write disjoint nodes, but the invalidations bubble up to
+    // shared ancestors.
+    class ConcurrentInvalidationScope {
+    public:
+        ConcurrentInvalidationScope();
+        ~ConcurrentInvalidationScope();
+    };
+
+    friend class Scene;
+
     union {
         Node*               fInvalObserver;
         std::vector<Node*>* fInvalObserverArray;
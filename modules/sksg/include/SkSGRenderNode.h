@@ -25,7 +25,8 @@ protected:
     struct RenderContext;
 
 public:
-    // Render the node and its descendants to the canvas.
+    // Render the node and its descendants to the canvas.  Nodes whose bounds fall outside the
+    // canvas clip are skipped.
     void render(SkCanvas*, const RenderContext* = nullptr) const;
 
 protected:
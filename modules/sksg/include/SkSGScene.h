@@ -15,9 +15,11 @@
 #include <vector>
 
 class SkCanvas;
+class SkExecutor;
 
 namespace sksg {
 
+class InvalidationController;
 class RenderNode;
 
 /**
@@ -68,15 +70,35 @@ public:
     void render(SkCanvas*) const;
     void animate(float t);
 
+    /**
+     * Revalidates the scene, accumulating the areas which changed since the previous
+     * revalidation in |ic| (in scene coordinates).  The first call damages the whole scene.
+     *
+     * Clients can then re-render only the damaged areas: clip to them (and erase them), then
+     * call render().  Sub-DAGs outside the clip are skipped.
+     */
+    void revalidate(InvalidationController* ic);
+
     void setShowInval(bool show) { fShowInval = show; }
 
+    /**
+     * When set, animate() ticks the top-level animators concurrently on |executor|, and returns
+     * once they have all completed.  Scene owners are responsible for only grouping animators
+     * which drive disjoint sets of nodes at the top level (e.g. one animator per layer).
+     *
+     * The executor must outlive the scene, or be reset to nullptr.
+     */
+    void setExecutor(SkExecutor* executor) { fExecutor = executor; }
+
 private:
     Scene(sk_sp<RenderNode> root, AnimatorList&& animators);
 
     const sk_sp<RenderNode> fRoot;
     const AnimatorList      fAnimators;
 
-    bool                    fShowInval = false;
+    SkExecutor*             fExecutor    = nullptr;
+    bool                    fShowInval   = false;
+    bool                    fRevalidated = false;
 };
 
 } // namespace sksg
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSGCacheEffect.h"
+
+#include "SkCanvas.h"
+#include "SkSurface.h"
+
+namespace sksg {
+
+// Content is cached after rendering unchanged this many times in a row, so that animated
+// sub-DAGs don't pay for an offscreen pass on every frame.
+static constexpr int kMinStableRenders = 2;
+
+// Content larger than this (in device pixels) is not cached, to bound the memory kept alive.
+static constexpr int64_t kMaxCachedPixels = 1024 * 1024;
+
+CacheEffect::CacheEffect(sk_sp<RenderNode> child)
+    : INHERITED(std::move(child)) {}
+
+void CacheEffect::onRender(SkCanvas* canvas, const RenderContext* ctx) const {
+    const auto& ctm = canvas->getTotalMatrix();
+    if (ctm != fLastCTM) {
+        fLastCTM       = ctm;
+        fStableRenders = 0;
+        fImageValid    = false;
+        fImage.reset();
+    }
+
+    fStableRenders = SkTMin(fStableRenders + 1, kMinStableRenders);
+
+    // Inherited opacity and color filters apply to each descendant draw on its own, which a
+    // single flattened image can't reproduce where the content overlaps itself.
+    const bool modulated = ctx && (ctx->fColorFilter || ctx->fOpacity < 1);
+
+    if (fStableRenders < kMinStableRenders || modulated || ctm.hasPerspective()) {
+        this->INHERITED::onRender(canvas, ctx);
+        return;
+    }
+
+    if (!fImageValid) {
+        // A failed attempt (e.g. the canvas can't make surfaces) is not retried until the
+        // content or the matrix changes.
+        fImage      = this->rasterize(canvas, ctm, &fImageOrigin);
+        fImageValid = true;
+    }
+
+    if (!fImage) {
+        this->INHERITED::onRender(canvas, ctx);
+        return;
+    }
+
+    SkAutoCanvasRestore acr(canvas, true);
+    canvas->resetMatrix();
+    canvas->drawImage(fImage, fImageOrigin.x(), fImageOrigin.y());
+}
+
+sk_sp<SkImage> CacheEffect::rasterize(SkCanvas* canvas, const SkMatrix& ctm,
+                                      SkIPoint* origin) const {
+    // The whole visible content is cached, regardless of the current clip.
+    auto device_bounds = ctm.mapRect(this->bounds()).roundOut();
+    if (!device_bounds.intersect(SkIRect::MakeSize(canvas->getBaseLayerSize()))) {
+        return nullptr;
+    }
+    if (sk_64_mul(device_bounds.width(), device_bounds.height()) > kMaxCachedPixels) {
+        return nullptr;
+    }
+
+    auto surface = canvas->makeSurface(
+            canvas->imageInfo().makeWH(device_bounds.width(), device_bounds.height()));
+    if (!surface) {
+        return nullptr;
+    }
+
+    auto* cache_canvas = surface->getCanvas();
+    cache_canvas->clear(SK_ColorTRANSPARENT);
+    cache_canvas->translate(-device_bounds.x(), -device_bounds.y());
+    cache_canvas->concat(ctm);
+    this->INHERITED::onRender(cache_canvas, nullptr);
+
+    *origin = SkIPoint::Make(device_bounds.x(), device_bounds.y());
+    return surface->makeImageSnapshot();
+}
+
+SkRect CacheEffect::onRevalidate(InvalidationController* ic, const SkMatrix& ctm) {
+    SkASSERT(this->hasInval());
+
+    fStableRenders = 0;
+    fImageValid    = false;
+    fImage.reset();
+
+    return this->INHERITED::onRevalidate(ic, ctm);
+}
+
+} // namespace sksg
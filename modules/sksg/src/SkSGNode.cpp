@@ -5,11 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkMutex.h"
 #include "SkRectPriv.h"
 #include "SkSGNode.h"
 #include "SkSGInvalidationController.h"
 
 #include <algorithm>
+#include <atomic>
 
 namespace sksg {
 
@@ -107,7 +109,30 @@ void Node::forEachInvalObserver(Func&& func) const {
     }
 }
 
+SK_DECLARE_STATIC_MUTEX(gInvalidationMutex);
+static std::atomic<int> gConcurrentInvalidationScopes{0};
+
+Node::ConcurrentInvalidationScope::ConcurrentInvalidationScope() {
+    gConcurrentInvalidationScopes.fetch_add(1, std::memory_order_relaxed);
+}
+
+Node::ConcurrentInvalidationScope::~ConcurrentInvalidationScope() {
+    gConcurrentInvalidationScopes.fetch_sub(1, std::memory_order_relaxed);
+}
+
 void Node::invalidate(bool damageBubbling) {
+    // The scope is entered before any concurrent work is dispatched, and left after it all
+    // completes, so a relaxed load is enough to observe it.
+    if (gConcurrentInvalidationScopes.load(std::memory_order_relaxed) > 0) {
+        SkAutoMutexAcquire lock(gInvalidationMutex);
+        this->invalidateImpl(damageBubbling);
+        return;
+    }
+
+    this->invalidateImpl(damageBubbling);
+}
+
+void Node::invalidateImpl(bool damageBubbling) {
     TRAVERSAL_GUARD;
 
     if (this->hasInval() && (!damageBubbling || (fFlags & kDamage_Flag))) {
@@ -124,7 +149,7 @@ void Node::invalidate(bool damageBubbling) {
     fFlags |= kInvalidated_Flag;
 
     forEachInvalObserver([&](Node* observer) {
-        observer->invalidate(damageBubbling);
+        observer->invalidateImpl(damageBubbling);
     });
 }
 
@@ -16,6 +16,12 @@ RenderNode::RenderNode() : INHERITED(0) {}
 
 void RenderNode::render(SkCanvas* canvas, const RenderContext* ctx) const {
     SkASSERT(!this->hasInval());
+
+    // Skip sub-DAGs outside the clip (e.g. when only re-rendering damaged areas).
+    if (canvas->quickReject(this->bounds())) {
+        return;
+    }
+
     this->onRender(canvas, ctx);
 }
 
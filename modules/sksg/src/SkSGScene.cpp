@@ -12,6 +12,7 @@
 #include "SkPaint.h"
 #include "SkSGInvalidationController.h"
 #include "SkSGRenderNode.h"
+#include "SkTaskGroup.h"
 
 namespace sksg {
 
@@ -61,10 +62,31 @@ void Scene::render(SkCanvas* canvas) const {
     }
 }
 
+void Scene::revalidate(InvalidationController* ic) {
+    SkASSERT(ic);
+
+    const auto& bounds = fRoot->revalidate(ic, SkMatrix::I());
+
+    if (!fRevalidated) {
+        // The client has no previous frame to update.
+        ic->inval(bounds);
+        fRevalidated = true;
+    }
+}
+
 void Scene::animate(float t) {
-    for (const auto& anim : fAnimators) {
-        anim->tick(t);
+    if (!fExecutor || fAnimators.size() < 2) {
+        for (const auto& anim : fAnimators) {
+            anim->tick(t);
+        }
+        return;
     }
+
+    // Animators only invalidate during the tick; revalidation happens later, in render().
+    Node::ConcurrentInvalidationScope inval_scope;
+    SkTaskGroup tasks(*fExecutor);
+    tasks.batch(SkToInt(fAnimators.size()), [this, t](int i) { fAnimators[i]->tick(t); });
+    tasks.wait();
 }
 
 } // namespace sksg
@@ -36,6 +36,22 @@ public:
                    SkPoint point,
                    SkScalar width) const;
 
+    /**
+     * Keeps the shaping of up to maxEntries recently shaped strings, so that shaping one of them
+     * again, at any size, width or position, skips itemization and HarfBuzz. Shaping a string
+     * which shares a prefix with the previously shaped one reuses the runs of that prefix.
+     * The cache is off (maxEntries == 0) by default.
+     */
+    void setCacheLimit(int maxEntries);
+
+    struct CacheStats {
+        int fHits = 0;          // shape() calls which found their string in the cache.
+        int fMisses = 0;        // shape() calls which had to shape their string.
+        int fRunsReused = 0;    // Runs of missed strings reused from the previous string.
+        int fRunsShaped = 0;    // Runs of missed strings shaped with HarfBuzz.
+    };
+    CacheStats cacheStats() const;
+
 private:
     SkShaper(const SkShaper&) = delete;
     SkShaper& operator=(const SkShaper&) = delete;
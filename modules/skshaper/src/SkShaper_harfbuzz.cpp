@@ -7,9 +7,11 @@
 
 #include "SkFontArguments.h"
 #include "SkFontMgr.h"
+#include "SkLRUCache.h"
 #include "SkLoadICU.h"
 #include "SkMalloc.h"
 #include "SkOnce.h"
+#include "SkOpts.h"
 #include "SkPaint.h"
 #include "SkPoint.h"
 #include "SkRefCnt.h"
@@ -260,50 +262,70 @@ public:
     }
     FontRunIterator(const char* utf8, size_t utf8Bytes, sk_sp<SkTypeface> typeface,
                     hb_font_t* hbFace, sk_sp<SkFontMgr> fallbackMgr)
-        : fCurrent(utf8), fEnd(fCurrent + utf8Bytes)
-        , fFallbackMgr(std::move(fallbackMgr))
+        : fCurrent(utf8), fEnd(fCurrent + utf8Bytes), fIndex(0)
         , fHBFont(hbFace), fTypeface(std::move(typeface))
-        , fFallbackHBFont(nullptr), fFallbackTypeface(nullptr)
         , fCurrentHBFont(fHBFont), fCurrentTypeface(fTypeface.get())
-    {}
+    {
+        // Pick a font for every character up front, with one cmap lookup in the starting
+        // typeface and one batched fallback query for everything it lacks.
+        SkTDArray<SkUnichar> unichars;
+        for (const char* current = fCurrent; current < fEnd;) {
+            unichars.push_back(utf8_next(&current, fEnd));
+        }
+        int count = unichars.count();
+        SkAutoTMalloc<SkGlyphID> glyphs(count);
+        fTypeface->charsToGlyphs(unichars.begin(), SkTypeface::kUTF32_Encoding,
+                                 glyphs.get(), count);
+
+        fFontIndex.setCount(count);
+        SkTDArray<SkUnichar> missing;
+        SkTDArray<int> missingIndex;
+        for (int i = 0; i < count; ++i) {
+            fFontIndex[i] = 0;
+            if (glyphs[i] == 0) {
+                missing.push_back(unichars[i]);
+                missingIndex.push_back(i);
+            }
+        }
+        if (missing.isEmpty()) {
+            return;
+        }
+
+        SkAutoTArray<sk_sp<SkTypeface>> found(missing.count());
+        fallbackMgr->matchFamilyStyleCharacters(nullptr, fTypeface->fontStyle(), nullptr, 0,
+                                                missing.begin(), missing.count(), found.get());
+        for (int i = 0; i < missing.count(); ++i) {
+            // With no fallback, stay with the starting typeface.
+            if (!found[i]) {
+                continue;
+            }
+            int fallback = 0;
+            while (fallback < fFallbacks.count() &&
+                   fFallbacks[fallback].fTypeface != found[i]) {
+                ++fallback;
+            }
+            if (fallback == fFallbacks.count()) {
+                Fallback& added = fFallbacks.push_back();
+                added.fTypeface = found[i];
+                added.fHBFont = create_hb_font(found[i].get());
+            }
+            fFontIndex[missingIndex[i]] = fallback + 1;
+        }
+    }
     void consume() override {
         SkASSERT(fCurrent < fEnd);
-        SkUnichar u = utf8_next(&fCurrent, fEnd);
-        // If the starting typeface can handle this character, use it.
-        if (fTypeface->charsToGlyphs(&u, SkTypeface::kUTF32_Encoding, nullptr, 1)) {
+        int font = fFontIndex[fIndex];
+        do {
+            utf8_next(&fCurrent, fEnd);
+            ++fIndex;
+        } while (fCurrent < fEnd && fFontIndex[fIndex] == font);
+
+        if (font == 0) {
             fCurrentTypeface = fTypeface.get();
             fCurrentHBFont = fHBFont;
-        // If the current fallback can handle this character, use it.
-        } else if (fFallbackTypeface &&
-                   fFallbackTypeface->charsToGlyphs(&u, SkTypeface::kUTF32_Encoding, nullptr, 1))
-        {
-            fCurrentTypeface = fFallbackTypeface.get();
-            fCurrentHBFont = fFallbackHBFont.get();
-        // If not, try to find a fallback typeface
         } else {
-            fFallbackTypeface.reset(fFallbackMgr->matchFamilyStyleCharacter(
-                nullptr, fTypeface->fontStyle(), nullptr, 0, u));
-            fFallbackHBFont = create_hb_font(fFallbackTypeface.get());
-            fCurrentTypeface = fFallbackTypeface.get();
-            fCurrentHBFont = fFallbackHBFont.get();
-        }
-
-        while (fCurrent < fEnd) {
-            const char* prev = fCurrent;
-            u = utf8_next(&fCurrent, fEnd);
-
-            // If not using initial typeface and initial typeface has this character, stop fallback.
-            if (fCurrentTypeface != fTypeface.get() &&
-                fTypeface->charsToGlyphs(&u, SkTypeface::kUTF32_Encoding, nullptr, 1))
-            {
-                fCurrent = prev;
-                return;
-            }
-            // If the current typeface cannot handle this character, stop using it.
-            if (!fCurrentTypeface->charsToGlyphs(&u, SkTypeface::kUTF32_Encoding, nullptr, 1)) {
-                fCurrent = prev;
-                return;
-            }
+            fCurrentTypeface = fFallbacks[font - 1].fTypeface.get();
+            fCurrentHBFont = fFallbacks[font - 1].fHBFont.get();
         }
     }
     const char* endOfCurrentRun() const override {
@@ -320,13 +342,19 @@ public:
         return fCurrentHBFont;
     }
 private:
+    struct Fallback {
+        sk_sp<SkTypeface> fTypeface;
+        HBFont fHBFont;
+    };
+
     const char* fCurrent;
     const char* fEnd;
-    sk_sp<SkFontMgr> fFallbackMgr;
+    int fIndex;  // Of the character at fCurrent.
     hb_font_t* fHBFont;
     sk_sp<SkTypeface> fTypeface;
-    HBFont fFallbackHBFont;
-    sk_sp<SkTypeface> fFallbackTypeface;
+    // For each character, 0 for the starting typeface or 1 + its index in fFallbacks.
+    SkTDArray<int> fFontIndex;
+    SkTArray<Fallback> fFallbacks;
     hb_font_t* fCurrentHBFont;
     SkTypeface* fCurrentTypeface;
 };
@@ -376,6 +404,55 @@ private:
     SkTDPQueue<RunIterator*, CompareRunIterator> fRunIterators;
 };
 
+// A glyph as HarfBuzz positioned it, in font units.
+struct UnscaledGlyph {
+    SkGlyphID fID;
+    uint32_t fCluster;
+    hb_position_t fXOffset;
+    hb_position_t fYOffset;
+    hb_position_t fXAdvance;
+    hb_position_t fYAdvance;
+    bool fMayLineBreakBefore;
+};
+
+// A run as HarfBuzz shaped it. It doesn't depend on the paint, so it can be laid out at any size.
+struct UnscaledRun {
+    size_t fUtf8Start;
+    size_t fUtf8End;
+    UBiDiLevel fLevel;
+    hb_script_t fScript;
+    sk_sp<SkTypeface> fTypeface;
+    int fScaleX;
+    int fScaleY;
+    SkTArray<UnscaledGlyph, true> fGlyphs;
+};
+
+// The runs of a paragraph in logical order, before line breaking, and the text they index.
+struct ShapedParagraph : public SkNVRefCnt<ShapedParagraph> {
+    SkString fText;
+    bool fLeftToRight;
+    SkTArray<UnscaledRun> fRuns;
+};
+
+struct ShapeCacheKey {
+    SkString fText;
+    bool fLeftToRight;
+
+    bool operator==(const ShapeCacheKey& that) const {
+        return fLeftToRight == that.fLeftToRight && fText == that.fText;
+    }
+};
+
+struct ShapeCacheKeyHash {
+    uint32_t operator()(const ShapeCacheKey& key) const {
+        return SkOpts::hash(key.fText.c_str(), key.fText.size(), key.fLeftToRight);
+    }
+};
+
+// HarfBuzz looks at up to this many characters of context on either side of a run
+// (HB_BUFFER_MAX_CONTEXT_LENGTH), so a run this close to an edit may shape differently.
+static constexpr size_t kMaxContextBytes = 5 * 4;
+
 struct ShapedGlyph {
     SkGlyphID fID;
     uint32_t fCluster;
@@ -476,6 +553,15 @@ struct SkShaper::Impl {
     HBBuffer fBuffer;
     sk_sp<SkTypeface> fTypeface;
     std::unique_ptr<icu::BreakIterator> fBreakIterator;
+
+    std::unique_ptr<SkLRUCache<ShapeCacheKey, sk_sp<ShapedParagraph>, ShapeCacheKeyHash>> fCache;
+    // The most recently shaped paragraph, which the next one may share a prefix with.
+    sk_sp<ShapedParagraph> fPrevious;
+    CacheStats fCacheStats;
+
+    sk_sp<ShapedParagraph> findOrShape(const char* utf8, size_t utf8Bytes, bool leftToRight);
+    sk_sp<ShapedParagraph> shapeParagraph(const char* utf8, size_t utf8Bytes, bool leftToRight,
+                                          const ShapedParagraph* previous);
 };
 
 SkShaper::SkShaper(sk_sp<SkTypeface> tf) : fImpl(new Impl) {
@@ -506,48 +592,102 @@ bool SkShaper::good() const {
            fImpl->fBreakIterator;
 }
 
-SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
-                        const SkPaint& srcPaint,
-                        const char* utf8,
-                        size_t utf8Bytes,
-                        bool leftToRight,
-                        SkPoint point,
-                        SkScalar width) const {
+void SkShaper::setCacheLimit(int maxEntries) {
+    fImpl->fPrevious.reset();
+    if (maxEntries > 0) {
+        fImpl->fCache.reset(
+                new SkLRUCache<ShapeCacheKey, sk_sp<ShapedParagraph>, ShapeCacheKeyHash>(
+                        maxEntries));
+    } else {
+        fImpl->fCache.reset();
+    }
+}
+
+SkShaper::CacheStats SkShaper::cacheStats() const {
+    return fImpl->fCacheStats;
+}
+
+sk_sp<ShapedParagraph> SkShaper::Impl::findOrShape(const char* utf8, size_t utf8Bytes,
+                                                   bool leftToRight) {
+    if (!fCache) {
+        return this->shapeParagraph(utf8, utf8Bytes, leftToRight, nullptr);
+    }
+
+    ShapeCacheKey key{SkString(utf8, utf8Bytes), leftToRight};
+    if (sk_sp<ShapedParagraph>* paragraph = fCache->find(key)) {
+        fCacheStats.fHits++;
+        fPrevious = *paragraph;
+        return *paragraph;
+    }
+
+    fCacheStats.fMisses++;
+    sk_sp<ShapedParagraph> paragraph =
+            this->shapeParagraph(utf8, utf8Bytes, leftToRight, fPrevious.get());
+    if (paragraph) {
+        fCache->insert(key, paragraph);
+        fPrevious = paragraph;
+    }
+    return paragraph;
+}
+
+sk_sp<ShapedParagraph> SkShaper::Impl::shapeParagraph(const char* utf8, size_t utf8Bytes,
+                                                      bool leftToRight,
+                                                      const ShapedParagraph* previous) {
     sk_sp<SkFontMgr> fontMgr = SkFontMgr::RefDefault();
-    SkASSERT(builder);
     UBiDiLevel defaultLevel = leftToRight ? UBIDI_DEFAULT_LTR : UBIDI_DEFAULT_RTL;
     //hb_script_t script = ...
 
-    SkTArray<ShapedRun> runs;
-{
+    sk_sp<ShapedParagraph> paragraph(new ShapedParagraph);
+    paragraph->fText.set(utf8, utf8Bytes);
+    paragraph->fLeftToRight = leftToRight;
+    SkTArray<UnscaledRun>& runs = paragraph->fRuns;
+
+    // Runs of the previous paragraph which end far enough before the first difference from this
+    // one can be reused as they are, if this paragraph is itemized the same way up to them.
+    size_t reusableBytes = 0;
+    if (previous && previous->fLeftToRight == leftToRight) {
+        size_t commonBytes = 0;
+        size_t maxCommonBytes = SkTMin(previous->fText.size(), utf8Bytes);
+        while (commonBytes < maxCommonBytes &&
+               previous->fText[commonBytes] == utf8[commonBytes]) {
+            ++commonBytes;
+        }
+        if (commonBytes == utf8Bytes && commonBytes == previous->fText.size()) {
+            reusableBytes = commonBytes;
+        } else if (commonBytes > kMaxContextBytes) {
+            reusableBytes = commonBytes - kMaxContextBytes;
+        }
+    }
+    int previousRunIndex = 0;
+
     RunIteratorQueue runSegmenter;
 
     SkTLazy<BiDiRunIterator> maybeBidi(BiDiRunIterator::Make(utf8, utf8Bytes, defaultLevel));
     BiDiRunIterator* bidi = maybeBidi.getMaybeNull();
     if (!bidi) {
-        return point;
+        return nullptr;
     }
     runSegmenter.insert(bidi);
 
-    hb_unicode_funcs_t* hbUnicode = hb_buffer_get_unicode_funcs(fImpl->fBuffer.get());
+    hb_unicode_funcs_t* hbUnicode = hb_buffer_get_unicode_funcs(fBuffer.get());
     SkTLazy<ScriptRunIterator> maybeScript(ScriptRunIterator::Make(utf8, utf8Bytes, hbUnicode));
     ScriptRunIterator* script = maybeScript.getMaybeNull();
     if (!script) {
-        return point;
+        return nullptr;
     }
     runSegmenter.insert(script);
 
     SkTLazy<FontRunIterator> maybeFont(FontRunIterator::Make(utf8, utf8Bytes,
-                                                             fImpl->fTypeface,
-                                                             fImpl->fHarfBuzzFont.get(),
+                                                             fTypeface,
+                                                             fHarfBuzzFont.get(),
                                                              std::move(fontMgr)));
     FontRunIterator* font = maybeFont.getMaybeNull();
     if (!font) {
-        return point;
+        return nullptr;
     }
     runSegmenter.insert(font);
 
-    icu::BreakIterator& breakIterator = *fImpl->fBreakIterator;
+    icu::BreakIterator& breakIterator = *fBreakIterator;
     {
         UErrorCode status = U_ZERO_ERROR;
         UText utf8UText = UTEXT_INITIALIZER;
@@ -555,13 +695,13 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
         std::unique_ptr<UText, SkFunctionWrapper<UText*, UText, utext_close>> autoClose(&utf8UText);
         if (U_FAILURE(status)) {
             SkDebugf("Could not create utf8UText: %s", u_errorName(status));
-            return point;
+            return nullptr;
         }
         breakIterator.setText(&utf8UText, status);
         //utext_close(&utf8UText);
         if (U_FAILURE(status)) {
             SkDebugf("Could not setText on break iterator: %s", u_errorName(status));
-            return point;
+            return nullptr;
         }
     }
 
@@ -571,81 +711,106 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
         utf8Start = utf8End;
         utf8End = runSegmenter.endOfCurrentRun();
 
-        hb_buffer_t* buffer = fImpl->fBuffer.get();
-        SkAutoTCallVProc<hb_buffer_t, hb_buffer_clear_contents> autoClearBuffer(buffer);
-        hb_buffer_set_content_type(buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
-        hb_buffer_set_cluster_level(buffer, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
-
-        // Add precontext.
-        hb_buffer_add_utf8(buffer, utf8, utf8Start - utf8, utf8Start - utf8, 0);
-
-        // Populate the hb_buffer directly with utf8 cluster indexes.
-        const char* utf8Current = utf8Start;
-        while (utf8Current < utf8End) {
-            unsigned int cluster = utf8Current - utf8Start;
-            hb_codepoint_t u = utf8_next(&utf8Current, utf8End);
-            hb_buffer_add(buffer, u, cluster);
-        }
-
-        // Add postcontext.
-        hb_buffer_add_utf8(buffer, utf8Current, utf8 + utf8Bytes - utf8Current, 0, 0);
-
         size_t utf8runLength = utf8End - utf8Start;
         if (!SkTFitsIn<int>(utf8runLength)) {
             SkDebugf("Shaping error: utf8 too long");
-            return point;
-        }
-        hb_buffer_set_script(buffer, script->currentScript());
-        hb_direction_t direction = is_LTR(bidi->currentLevel()) ? HB_DIRECTION_LTR:HB_DIRECTION_RTL;
-        hb_buffer_set_direction(buffer, direction);
-        // TODO: language
-        hb_buffer_guess_segment_properties(buffer);
-        // TODO: features
-        hb_shape(font->currentHBFont(), buffer, nullptr, 0);
-        unsigned len = hb_buffer_get_length(buffer);
-        if (len == 0) {
-            continue;
+            return nullptr;
         }
 
-        if (direction == HB_DIRECTION_RTL) {
-            // Put the clusters back in logical order.
-            // Note that the advances remain ltr.
-            hb_buffer_reverse(buffer);
+        size_t runStart = utf8Start - utf8;
+        size_t runEnd = utf8End - utf8;
+        const UnscaledRun* reusable = nullptr;
+        if (previous && runEnd <= reusableBytes) {
+            while (previousRunIndex < previous->fRuns.count() &&
+                   previous->fRuns[previousRunIndex].fUtf8Start < runStart) {
+                ++previousRunIndex;
+            }
+            if (previousRunIndex < previous->fRuns.count()) {
+                const UnscaledRun& candidate = previous->fRuns[previousRunIndex];
+                if (candidate.fUtf8Start == runStart && candidate.fUtf8End == runEnd &&
+                    candidate.fLevel == bidi->currentLevel() &&
+                    candidate.fScript == script->currentScript() &&
+                    candidate.fTypeface->uniqueID() == font->currentTypeface()->uniqueID()) {
+                    reusable = &candidate;
+                }
+            }
         }
-        hb_glyph_info_t* info = hb_buffer_get_glyph_infos(buffer, nullptr);
-        hb_glyph_position_t* pos = hb_buffer_get_glyph_positions(buffer, nullptr);
 
-        if (!SkTFitsIn<int>(len)) {
-            SkDebugf("Shaping error: too many glyphs");
-            return point;
-        }
+        UnscaledRun* run;
+        if (reusable) {
+            run = &runs.push_back(*reusable);
+            fCacheStats.fRunsReused++;
+        } else {
+            hb_buffer_t* buffer = fBuffer.get();
+            SkAutoTCallVProc<hb_buffer_t, hb_buffer_clear_contents> autoClearBuffer(buffer);
+            hb_buffer_set_content_type(buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
+            hb_buffer_set_cluster_level(buffer, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
+
+            // Add precontext.
+            hb_buffer_add_utf8(buffer, utf8, utf8Start - utf8, utf8Start - utf8, 0);
+
+            // Populate the hb_buffer directly with utf8 cluster indexes.
+            const char* utf8Current = utf8Start;
+            while (utf8Current < utf8End) {
+                unsigned int cluster = utf8Current - utf8Start;
+                hb_codepoint_t u = utf8_next(&utf8Current, utf8End);
+                hb_buffer_add(buffer, u, cluster);
+            }
 
-        SkPaint paint(srcPaint);
-        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
-        paint.setTypeface(sk_ref_sp(font->currentTypeface()));
-        ShapedRun& run = runs.emplace_back(utf8Start, utf8End, len, paint, bidi->currentLevel(),
-                                           std::unique_ptr<ShapedGlyph[]>(new ShapedGlyph[len]));
-        int scaleX, scaleY;
-        hb_font_get_scale(font->currentHBFont(), &scaleX, &scaleY);
-        double textSizeY = run.fPaint.getTextSize() / scaleY;
-        double textSizeX = run.fPaint.getTextSize() / scaleX * run.fPaint.getTextScaleX();
-        for (unsigned i = 0; i < len; i++) {
-            ShapedGlyph& glyph = run.fGlyphs[i];
-            glyph.fID = info[i].codepoint;
-            glyph.fCluster = info[i].cluster;
-            glyph.fOffset.fX = pos[i].x_offset * textSizeX;
-            glyph.fOffset.fY = pos[i].y_offset * textSizeY;
-            glyph.fAdvance.fX = pos[i].x_advance * textSizeX;
-            glyph.fAdvance.fY = pos[i].y_advance * textSizeY;
-            glyph.fHasVisual = true; //!font->currentTypeface()->glyphBoundsAreZero(glyph.fID);
-            //info->mask safe_to_break;
-            glyph.fMustLineBreakBefore = false;
+            // Add postcontext.
+            hb_buffer_add_utf8(buffer, utf8Current, utf8 + utf8Bytes - utf8Current, 0, 0);
+
+            hb_buffer_set_script(buffer, script->currentScript());
+            hb_direction_t direction = is_LTR(bidi->currentLevel()) ? HB_DIRECTION_LTR
+                                                                    : HB_DIRECTION_RTL;
+            hb_buffer_set_direction(buffer, direction);
+            // TODO: language
+            hb_buffer_guess_segment_properties(buffer);
+            // TODO: features
+            hb_shape(font->currentHBFont(), buffer, nullptr, 0);
+            fCacheStats.fRunsShaped++;
+            unsigned len = hb_buffer_get_length(buffer);
+            if (len == 0) {
+                continue;
+            }
+
+            if (direction == HB_DIRECTION_RTL) {
+                // Put the clusters back in logical order.
+                // Note that the advances remain ltr.
+                hb_buffer_reverse(buffer);
+            }
+            hb_glyph_info_t* info = hb_buffer_get_glyph_infos(buffer, nullptr);
+            hb_glyph_position_t* pos = hb_buffer_get_glyph_positions(buffer, nullptr);
+
+            if (!SkTFitsIn<int>(len)) {
+                SkDebugf("Shaping error: too many glyphs");
+                return nullptr;
+            }
+
+            run = &runs.push_back();
+            run->fUtf8Start = runStart;
+            run->fUtf8End = runEnd;
+            run->fLevel = bidi->currentLevel();
+            run->fScript = script->currentScript();
+            run->fTypeface = sk_ref_sp(font->currentTypeface());
+            hb_font_get_scale(font->currentHBFont(), &run->fScaleX, &run->fScaleY);
+            run->fGlyphs.reset(len);
+            for (unsigned i = 0; i < len; i++) {
+                UnscaledGlyph& glyph = run->fGlyphs[i];
+                glyph.fID = info[i].codepoint;
+                glyph.fCluster = info[i].cluster;
+                glyph.fXOffset = pos[i].x_offset;
+                glyph.fYOffset = pos[i].y_offset;
+                glyph.fXAdvance = pos[i].x_advance;
+                glyph.fYAdvance = pos[i].y_advance;
+            }
         }
 
+        // Line break opportunities depend on the whole paragraph, so even reused runs need them
+        // found again.
         int32_t clusterOffset = utf8Start - utf8;
         uint32_t previousCluster = 0xFFFFFFFF;
-        for (unsigned i = 0; i < len; ++i) {
-            ShapedGlyph& glyph = run.fGlyphs[i];
+        for (UnscaledGlyph& glyph : run->fGlyphs) {
             int32_t glyphCluster = glyph.fCluster + clusterOffset;
             int32_t breakIteratorCurrent = breakIterator.current();
             while (breakIteratorCurrent != icu::BreakIterator::DONE &&
@@ -658,8 +823,53 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
             previousCluster = glyph.fCluster;
         }
     }
+    return paragraph;
 }
 
+SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
+                        const SkPaint& srcPaint,
+                        const char* utf8,
+                        size_t utf8Bytes,
+                        bool leftToRight,
+                        SkPoint point,
+                        SkScalar width) const {
+    SkASSERT(builder);
+    sk_sp<ShapedParagraph> paragraph = fImpl->findOrShape(utf8, utf8Bytes, leftToRight);
+    if (!paragraph) {
+        return point;
+    }
+
+    // Lay the paragraph's runs out at the paint's size. The glyphs index the paragraph's copy of
+    // the text, which is identical to utf8.
+    SkTArray<ShapedRun> runs(paragraph->fRuns.count());
+    for (const UnscaledRun& unscaled : paragraph->fRuns) {
+        int len = unscaled.fGlyphs.count();
+        SkPaint paint(srcPaint);
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+        paint.setTypeface(unscaled.fTypeface);
+        const char* text = paragraph->fText.c_str();
+        ShapedRun& run = runs.emplace_back(text + unscaled.fUtf8Start, text + unscaled.fUtf8End,
+                                           len, paint, unscaled.fLevel,
+                                           std::unique_ptr<ShapedGlyph[]>(new ShapedGlyph[len]));
+        double textSizeY = run.fPaint.getTextSize() / unscaled.fScaleY;
+        double textSizeX = run.fPaint.getTextSize() / unscaled.fScaleX *
+                           run.fPaint.getTextScaleX();
+        for (int i = 0; i < len; i++) {
+            const UnscaledGlyph& src = unscaled.fGlyphs[i];
+            ShapedGlyph& glyph = run.fGlyphs[i];
+            glyph.fID = src.fID;
+            glyph.fCluster = src.fCluster;
+            glyph.fOffset.fX = src.fXOffset * textSizeX;
+            glyph.fOffset.fY = src.fYOffset * textSizeY;
+            glyph.fAdvance.fX = src.fXAdvance * textSizeX;
+            glyph.fAdvance.fY = src.fYAdvance * textSizeY;
+            glyph.fHasVisual = true; //!font->currentTypeface()->glyphBoundsAreZero(glyph.fID);
+            //info->mask safe_to_break;
+            glyph.fMayLineBreakBefore = src.fMayLineBreakBefore;
+            glyph.fMustLineBreakBefore = false;
+        }
+    }
+
 // Iterate over the glyphs in logical order to mark line endings.
 {
     SkScalar widthSoFar = 0;
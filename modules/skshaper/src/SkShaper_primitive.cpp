@@ -24,6 +24,11 @@ SkShaper::~SkShaper() {}
 
 bool SkShaper::good() const { return true; }
 
+// Shaping is cheap enough here that there is nothing to cache.
+void SkShaper::setCacheLimit(int) {}
+
+SkShaper::CacheStats SkShaper::cacheStats() const { return CacheStats(); }
+
 // This example only uses public API, so we don't use SkUTF8_NextUnichar.
 unsigned utf8_lead_byte_to_count(const char* ptr) {
     uint8_t c = *(const uint8_t*)ptr;
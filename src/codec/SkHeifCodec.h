@@ -11,6 +11,7 @@
 #include "SkCodec.h"
 #include "SkEncodedOrigin.h"
 #include "SkImageInfo.h"
+#include "SkMemoryAccounting.h"
 #include "SkSwizzler.h"
 #include "SkStream.h"
 
@@ -66,7 +67,7 @@ private:
 
     std::unique_ptr<HeifDecoder>       fHeifDecoder;
     HeifFrameInfo                      fFrameInfo;
-    SkAutoTMalloc<uint8_t>             fStorage;
+    SkTaggedAutoTMalloc<uint8_t, SkMemoryTag::kCodec> fStorage;
     uint8_t*                           fSwizzleSrcRow;
     uint32_t*                          fColorXformSrcRow;
 
@@ -13,10 +13,13 @@
 #include "SkJpegDecoderMgr.h"
 #include "SkJpegInfo.h"
 #include "SkStream.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkTypes.h"
 
+#include <atomic>
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "SkJpegUtility.h"
@@ -36,14 +39,6 @@ bool SkJpegCodec::IsJpeg(const void* buffer, size_t bytesRead) {
     return bytesRead >= 3 && !memcmp(buffer, jpegSig, sizeof(jpegSig));
 }
 
-static uint32_t get_endian_int(const uint8_t* data, bool littleEndian) {
-    if (littleEndian) {
-        return (data[3] << 24) | (data[2] << 16) | (data[1] << 8) | (data[0]);
-    }
-
-    return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | (data[3]);
-}
-
 const uint32_t kExifHeaderSize = 14;
 const uint32_t kExifMarker = JPEG_APP0 + 1;
 
@@ -63,49 +58,6 @@ static bool is_orientation_marker(jpeg_marker_struct* marker, SkEncodedOrigin* o
             orientation);
 }
 
-bool is_orientation_marker(const uint8_t* data, size_t data_length, SkEncodedOrigin* orientation) {
-    bool littleEndian;
-    // We need eight bytes to read the endian marker and the offset, below.
-    if (data_length < 8 || !is_valid_endian_marker(data, &littleEndian)) {
-        return false;
-    }
-
-    // Get the offset from the start of the marker.
-    // Though this only reads four bytes, use a larger int in case it overflows.
-    uint64_t offset = get_endian_int(data + 4, littleEndian);
-
-    // Require that the marker is at least large enough to contain the number of entries.
-    if (data_length < offset + 2) {
-        return false;
-    }
-    uint32_t numEntries = get_endian_short(data + offset, littleEndian);
-
-    // Tag (2 bytes), Datatype (2 bytes), Number of elements (4 bytes), Data (4 bytes)
-    const uint32_t kEntrySize = 12;
-    const auto max = SkTo<uint32_t>((data_length - offset - 2) / kEntrySize);
-    numEntries = SkTMin(numEntries, max);
-
-    // Advance the data to the start of the entries.
-    data += offset + 2;
-
-    const uint16_t kOriginTag = 0x112;
-    const uint16_t kOriginType = 3;
-    for (uint32_t i = 0; i < numEntries; i++, data += kEntrySize) {
-        uint16_t tag = get_endian_short(data, littleEndian);
-        uint16_t type = get_endian_short(data + 2, littleEndian);
-        uint32_t count = get_endian_int(data + 4, littleEndian);
-        if (kOriginTag == tag && kOriginType == type && 1 == count) {
-            uint16_t val = get_endian_short(data + 8, littleEndian);
-            if (0 < val && val <= kLast_SkEncodedOrigin) {
-                *orientation = (SkEncodedOrigin) val;
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
 static SkEncodedOrigin get_exif_orientation(jpeg_decompress_struct* dinfo) {
     SkEncodedOrigin orientation;
     for (jpeg_marker_struct* marker = dinfo->marker_list; marker; marker = marker->next) {
@@ -306,8 +258,17 @@ SkJpegCodec::SkJpegCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
     , fSwizzleSrcRow(nullptr)
     , fColorXformSrcRow(nullptr)
     , fSwizzlerSubset(SkIRect::MakeEmpty())
+    , fRestartLayoutParsed(false)
+    , fIncrementalDst(nullptr)
+    , fIncrementalRowBytes(0)
+    , fIncrementalSkip(0)
+    , fIncrementalUpdated(SkIRect::MakeEmpty())
+    , fIncrementalScans(false)
+    , fIncrementalScan(0)
 {}
 
+SkJpegCodec::~SkJpegCodec() {}
+
 /*
  * Return the row bytes of a particular image type and width
  */
@@ -376,6 +337,8 @@ bool SkJpegCodec::onRewind() {
     }
     SkASSERT(nullptr != decoderMgr);
     fDecoderMgr.reset(decoderMgr);
+    fBandStream.reset();
+    fSuspendingSource.reset();
 
     fSwizzler.reset(nullptr);
     fSwizzleSrcRow = nullptr;
@@ -569,6 +532,336 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+/*
+ * The parts of a sequential, single scan jpeg that let us decode the rows between its restart
+ * markers as jpegs of their own. Only restart markers that fall at the start of an MCU row are
+ * of use; the rows between two of those are a "group".
+ */
+struct SkJpegRestartLayout {
+    // Every segment from SOI through SOS that decoding needs, and no others.
+    SkTDArray<uint8_t> fHeader;
+    // Where the frame height is within fHeader.
+    int                fHeightOffset = -1;
+    // The entropy coded data of the scan.
+    const uint8_t*     fScan = nullptr;
+    size_t             fScanLength = 0;
+    // The offset of each RSTn marker within fScan.
+    SkTDArray<size_t>  fRestarts;
+
+    int                fHeight = 0;
+    int                fMCUHeight = 0;
+    int                fMCUsPerRow = 0;
+    int                fInterval = 0;
+    // The first MCU row of each group, followed by the number of MCU rows.
+    SkTDArray<int>     fGroupRows;
+
+    int numGroups() const { return fGroupRows.count() - 1; }
+    // The first pixel row of group 'group', at full size.
+    int groupTop(int group) const { return SkTMin(fGroupRows[group] * fMCUHeight, fHeight); }
+};
+
+static int div_round_up(int x, int y) {
+    return (x + y - 1) / y;
+}
+
+static bool parse_restart_layout(const uint8_t* data, size_t length, SkJpegRestartLayout* layout) {
+    if (length < 4 || 0xFF != data[0] || 0xD8 != data[1]) {
+        return false;
+    }
+    layout->fHeader.append(2, data);
+
+    size_t pos = 2;
+    while (true) {
+        // Skip any fill bytes before the marker.
+        while (pos + 1 < length && 0xFF == data[pos] && 0xFF == data[pos + 1]) {
+            pos++;
+        }
+        if (pos + 4 > length || 0xFF != data[pos]) {
+            return false;
+        }
+        const uint8_t marker = data[pos + 1];
+        const size_t end = pos + 2 + ((data[pos + 2] << 8) | data[pos + 3]);
+        if (end > length || end < pos + 4) {
+            return false;
+        }
+
+        if (0xC0 == marker || 0xC1 == marker) {
+            // Baseline or extended sequential, Huffman coded.
+            layout->fHeightOffset = layout->fHeader.count() + 5;
+        } else if ((marker >= 0xC2 && marker <= 0xCF && 0xC4 /* DHT */ != marker) ||
+                   0xDC == marker /* DNL */ || (marker >= 0xD0 && marker <= 0xD9)) {
+            // Progressive or arithmetic coded frames, heights defined after the scan, and markers
+            // that don't belong here.
+            return false;
+        } else if ((marker >= JPEG_APP0 + 1 && marker <= JPEG_APP0 + 15 &&
+                    JPEG_APP0 + 14 != marker) || JPEG_COM == marker) {
+            // Only the JFIF and Adobe markers affect decoding.
+            pos = end;
+            continue;
+        }
+
+        layout->fHeader.append(end - pos, data + pos);
+        pos = end;
+        if (0xDA == marker /* SOS */) {
+            break;
+        }
+    }
+    if (layout->fHeightOffset < 0 || layout->fHeightOffset + 2 > layout->fHeader.count()) {
+        return false;
+    }
+
+    // Find the restart markers, and make sure the scan is the last thing in the image.
+    const uint8_t* scan = data + pos;
+    const size_t scanLength = length - pos;
+    size_t i = 0;
+    while (true) {
+        const void* ff = memchr(scan + i, 0xFF, scanLength - i);
+        if (!ff) {
+            return false;
+        }
+        i = static_cast<const uint8_t*>(ff) - scan;
+        if (i + 1 >= scanLength) {
+            return false;
+        }
+        const uint8_t next = scan[i + 1];
+        if (0x00 == next) {
+            // A stuffed 0xFF data byte.
+            i += 2;
+        } else if (0xFF == next) {
+            // A fill byte.
+            i += 1;
+        } else if (next >= 0xD0 && next <= 0xD7) {
+            layout->fRestarts.push_back(i);
+            i += 2;
+        } else if (0xD9 == next) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    layout->fScan = scan;
+    layout->fScanLength = i;
+    return true;
+}
+
+// Returns a jpeg of the groups from 'first' up to 'last'.
+static sk_sp<SkData> make_band_jpeg(const SkJpegRestartLayout& layout, int first, int last) {
+    const int firstInterval = layout.fGroupRows[first] * layout.fMCUsPerRow / layout.fInterval;
+    const int lastInterval = div_round_up(layout.fGroupRows[last] * layout.fMCUsPerRow,
+                                          layout.fInterval);
+    const int height = layout.groupTop(last) - layout.groupTop(first);
+
+    const int numIntervals = layout.fRestarts.count() + 1;
+    const size_t start = firstInterval ? layout.fRestarts[firstInterval - 1] + 2 : 0;
+    const size_t stop = lastInterval < numIntervals ? layout.fRestarts[lastInterval - 1]
+                                                    : layout.fScanLength;
+    const size_t headerLength = layout.fHeader.count();
+
+    sk_sp<SkData> band = SkData::MakeUninitialized(headerLength + stop - start + 2);
+    uint8_t* bytes = static_cast<uint8_t*>(band->writable_data());
+    memcpy(bytes, layout.fHeader.begin(), headerLength);
+    bytes[layout.fHeightOffset] = height >> 8;
+    bytes[layout.fHeightOffset + 1] = height & 0xFF;
+
+    uint8_t* scan = bytes + headerLength;
+    memcpy(scan, layout.fScan + start, stop - start);
+    // The restart markers of each band must count up from RST0.
+    for (int i = firstInterval; i < lastInterval - 1; ++i) {
+        scan[layout.fRestarts[i] - start + 1] = 0xD0 + ((i - firstInterval) & 7);
+    }
+    scan[stop - start] = 0xFF;
+    scan[stop - start + 1] = 0xD9;
+    return band;
+}
+
+/*
+ * Restart markers reset the entropy decoder, so when they fall at the start of MCU rows, the rows
+ * between them can be decoded without decoding the rows before. Returns the layout of the image's
+ * restart markers if there are at least two groups, or nullptr. The layout is found once, on the
+ * first call.
+ */
+const SkJpegRestartLayout* SkJpegCodec::restartLayout() {
+    if (fRestartLayoutParsed) {
+        return fRestartLayout.get();
+    }
+    fRestartLayoutParsed = true;
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    SkStream* stream = this->stream();
+    if (!dinfo->restart_interval || dinfo->progressive_mode || dinfo->arith_code ||
+        dinfo->comps_in_scan != dinfo->num_components || !stream->getMemoryBase() ||
+        !stream->hasLength()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegRestartLayout> layout(new SkJpegRestartLayout);
+    // A scan of one component has MCUs of a single block.
+    const int width = this->dimensions().width();
+    layout->fHeight = this->dimensions().height();
+    layout->fMCUHeight = DCTSIZE * (1 == dinfo->comps_in_scan ? 1 : dinfo->max_v_samp_factor);
+    layout->fMCUsPerRow = div_round_up(width, DCTSIZE * (1 == dinfo->comps_in_scan
+                                                             ? 1 : dinfo->max_h_samp_factor));
+    layout->fInterval = dinfo->restart_interval;
+
+    const int mcuRows = div_round_up(layout->fHeight, layout->fMCUHeight);
+    for (int row = 0; row < mcuRows; ++row) {
+        if (0 == (row * layout->fMCUsPerRow) % layout->fInterval) {
+            layout->fGroupRows.push_back(row);
+        }
+    }
+    layout->fGroupRows.push_back(mcuRows);
+    if (layout->numGroups() < 2 ||
+        !parse_restart_layout(static_cast<const uint8_t*>(stream->getMemoryBase()),
+                              stream->getLength(), layout.get()) ||
+        layout->fRestarts.count() + 1 != div_round_up(layout->fMCUsPerRow * mcuRows,
+                                                      layout->fInterval)) {
+        return nullptr;
+    }
+
+    fRestartLayout = std::move(layout);
+    return fRestartLayout.get();
+}
+
+/*
+ * Splits the image into bands at its restart markers, and decodes each on the executor, as a jpeg
+ * of its own. Returns false, having left the image to the serial decode, if the image can't be
+ * split or any band fails.
+ */
+bool SkJpegCodec::decodeInBands(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                                SkExecutor* executor) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (dstInfo.dimensions() != this->dimensions() ||
+        needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        return false;
+    }
+    const SkJpegRestartLayout* layout = this->restartLayout();
+    if (!layout) {
+        return false;
+    }
+
+    const int numGroups = layout->numGroups();
+    constexpr int kMaxBands = 16;
+    const int numBands = SkTMin(kMaxBands, numGroups / 4);
+    if (numBands < 2) {
+        return false;
+    }
+
+    // Vertically upsampled chroma reads the rows on either side of each row, so then every band
+    // also decodes one group of rows beyond its own at each end.
+    const int overlap = dinfo->max_v_samp_factor > 1 ? 1 : 0;
+    const int width = this->dimensions().width();
+    const J_COLOR_SPACE outColorSpace = dinfo->out_color_space;
+    const J_DITHER_MODE ditherMode = dinfo->dither_mode;
+    const bool needsXformRow = this->colorXform() && sizeof(uint32_t) != dstInfo.bytesPerPixel();
+
+    std::atomic<bool> failed(false);
+    SkTaskGroup(*executor).batch(numBands, [&](int band) {
+        const int firstGroup = band * numGroups / numBands;
+        const int lastGroup = (band + 1) * numGroups / numBands;
+        const int decodeFirst = SkTMax(firstGroup - overlap, 0);
+        const int decodeLast = SkTMin(lastGroup + overlap, numGroups);
+        const int top = layout->groupTop(firstGroup);
+        const int bottom = layout->groupTop(lastGroup);
+        const int skip = top - layout->groupTop(decodeFirst);
+
+        SkMemoryStream bandStream(make_band_jpeg(*layout, decodeFirst, decodeLast));
+        JpegDecoderMgr decoderMgr(&bandStream);
+        SkAutoTMalloc<uint32_t> xformRow(needsXformRow ? width : 0);
+
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+        if (setjmp(jmp)) {
+            failed = true;
+            return;
+        }
+        decoderMgr.init();
+        jpeg_decompress_struct* bandInfo = decoderMgr.dinfo();
+        if (JPEG_HEADER_OK != jpeg_read_header(bandInfo, true)) {
+            failed = true;
+            return;
+        }
+        bandInfo->out_color_space = outColorSpace;
+        bandInfo->dither_mode = ditherMode;
+        if (!jpeg_start_decompress(bandInfo) || bandInfo->output_width != (unsigned) width ||
+            (unsigned) skip != jpeg_skip_scanlines(bandInfo, skip)) {
+            failed = true;
+            return;
+        }
+
+        for (int y = top; y < bottom; ++y) {
+            void* dstRow = SkTAddOffset<void>(dst, y * dstRowBytes);
+            JSAMPLE* decodeDst = needsXformRow ? (JSAMPLE*) xformRow.get() : (JSAMPLE*) dstRow;
+            if (1 != jpeg_read_scanlines(bandInfo, &decodeDst, 1)) {
+                failed = true;
+                return;
+            }
+            if (this->colorXform()) {
+                this->applyColorXform(dstRow, decodeDst, width);
+            }
+        }
+        // The rows below are only decoded for their chroma.
+        jpeg_abort_decompress(bandInfo);
+    });
+
+    return !failed;
+}
+
+/*
+ * Swaps in a decoder that starts at the last restart marker far enough above the row 'skip' rows
+ * down, and reduces 'skip' to match. Leaves the decoder alone if the image has no restart markers
+ * that help.
+ */
+void SkJpegCodec::startAtRestartBefore(int* skip) {
+    const SkJpegRestartLayout* layout = this->restartLayout();
+    if (!layout || !*skip) {
+        return;
+    }
+
+    // The MCU rows start at multiples of eight rows, and libjpeg-turbo scales each block of eight
+    // rows to exactly scale_num rows.
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    SkASSERT(DCTSIZE == dinfo->scale_denom || dinfo->scale_num == dinfo->scale_denom);
+    const int scaleNum = dinfo->scale_num;
+    const int scaleDenom = dinfo->scale_denom;
+    int group = 0;
+    while (group + 1 < layout->numGroups() &&
+           layout->groupTop(group + 1) * scaleNum / scaleDenom <= *skip) {
+        group++;
+    }
+    // Vertically upsampled chroma needs the rows above the first one we keep.
+    if (dinfo->max_v_samp_factor > 1) {
+        group = SkTMax(group - 1, 0);
+    }
+    const int top = layout->groupTop(group);
+    if (!group || (top * scaleNum) % scaleDenom) {
+        return;
+    }
+
+    std::unique_ptr<SkStream> bandStream(
+            new SkMemoryStream(make_band_jpeg(*layout, group, layout->numGroups())));
+    std::unique_ptr<JpegDecoderMgr> decoderMgr(new JpegDecoderMgr(bandStream.get()));
+    {
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr->errorMgr());
+        if (setjmp(jmp)) {
+            return;
+        }
+        decoderMgr->init();
+        jpeg_decompress_struct* bandInfo = decoderMgr->dinfo();
+        if (JPEG_HEADER_OK != jpeg_read_header(bandInfo, true)) {
+            return;
+        }
+        bandInfo->out_color_space = dinfo->out_color_space;
+        bandInfo->dither_mode = dinfo->dither_mode;
+        bandInfo->scale_num = scaleNum;
+        bandInfo->scale_denom = scaleDenom;
+    }
+
+    // The next rewind goes back to decoding the whole image.
+    fDecoderMgr = std::move(decoderMgr);
+    fBandStream = std::move(bandStream);
+    *skip -= top * scaleNum / scaleDenom;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -581,6 +874,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (options.fExecutor && this->decodeInBands(dstInfo, dst, dstRowBytes, options.fExecutor)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -749,6 +1046,162 @@ SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+/*
+ * Incremental decoding is used for subsets, which it decodes in one call: libjpeg-turbo crops
+ * the columns, the rows above are skipped, from the last useful restart marker if there is one,
+ * and decoding stops after the subset's last row.
+ *
+ * It is also used for whole progressive images, which libjpeg-turbo's buffered image mode shows
+ * a scan at a time, as their data arrives.
+ */
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    fIncrementalUpdated.setEmpty();
+    fIncrementalScans = !options.fSubset;
+    if (fIncrementalScans) {
+        if (!fDecoderMgr->dinfo()->progressive_mode) {
+            // Other whole images are decoded by getPixels() or the scanline decoder.
+            return kUnimplemented;
+        }
+        // libjpeg-turbo will suspend when it runs out of data. A stream in memory has all of it,
+        // but others need a source that can back up after more arrives.
+        SkStream* stream = this->stream();
+        if (!stream->hasLength() || !stream->getMemoryBase()) {
+            fSuspendingSource.reset(new skjpeg_suspending_source_mgr(stream,
+                                                                     *fDecoderMgr->dinfo()->src));
+            fDecoderMgr->dinfo()->src = fSuspendingSource.get();
+        }
+        fDecoderMgr->dinfo()->buffered_image = TRUE;
+        Result result = this->onStartScanlineDecode(dstInfo, options);
+        if (kSuccess != result) {
+            return result;
+        }
+        fIncrementalScan = 0;
+        fIncrementalDst = dst;
+        fIncrementalRowBytes = rowBytes;
+        fIncrementalSkippedRow.reset(rowBytes);
+        return kSuccess;
+    }
+
+    fIncrementalSkip = options.fSubset->top();
+    this->startAtRestartBefore(&fIncrementalSkip);
+
+    Result result = this->onStartScanlineDecode(dstInfo, options);
+    if (kSuccess != result) {
+        return result;
+    }
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    if (fIncrementalScans) {
+        return this->incrementalDecodeScans(rowsDecoded);
+    }
+
+    // SkSampledCodec may have asked the sampler to take every sampleY'th row of the subset.
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int dstHeight = get_scaled_dimension(this->options().fSubset->height(), sampleY);
+
+    int rows = 0;
+    if (this->onSkipScanlines(fIncrementalSkip + get_start_coord(sampleY))) {
+        for (; rows < dstHeight; ++rows) {
+            void* dst = SkTAddOffset<void>(fIncrementalDst, rows * fIncrementalRowBytes);
+            if (1 != this->readRows(this->dstInfo(), dst, fIncrementalRowBytes, 1,
+                                    this->options())) {
+                break;
+            }
+            if (sampleY > 1 && rows < dstHeight - 1 && !this->onSkipScanlines(sampleY - 1)) {
+                rows++;
+                break;
+            }
+        }
+    }
+    fIncrementalSkip = 0;
+    fIncrementalUpdated.setLTRB(0, 0, this->options().fSubset->width(), rows);
+
+    if (rowsDecoded) {
+        *rowsDecoded = rows;
+    }
+    if (rows < dstHeight) {
+        // This allows us to skip calling jpeg_finish_decompress().
+        fDecoderMgr->dinfo()->output_scanline = fDecoderMgr->dinfo()->output_height;
+        return fDecoderMgr->returnFailure("Incomplete image data", kIncompleteInput);
+    }
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::incrementalDecodeScans(int* rowsDecoded) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("incrementalDecodeScans", kErrorInInput);
+    }
+
+    // Take in all of the data there is so far.
+    if (fSuspendingSource) {
+        fSuspendingSource->addAvailableData();
+    }
+    int status;
+    do {
+        // Like jpeg_start_decompress(), give the progress monitor a chance to stop images with
+        // too many scans.
+        if (dinfo->progress) {
+            dinfo->progress->progress_monitor((j_common_ptr) dinfo);
+        }
+        status = jpeg_consume_input(dinfo);
+    } while (JPEG_SUSPENDED != status && JPEG_REACHED_EOI != status);
+
+    // Show the last scan that has all of its data, unless it has been shown already.
+    const bool complete = jpeg_input_complete(dinfo);
+    const int scan = complete ? dinfo->input_scan_number : dinfo->input_scan_number - 1;
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int dstHeight = get_scaled_dimension(this->dstInfo().height(), sampleY);
+    fIncrementalUpdated.setEmpty();
+    if (scan > fIncrementalScan) {
+        // The scan has all of its data, so none of this waits for more.
+        if (!jpeg_start_output(dinfo, scan)) {
+            return kIncompleteInput;
+        }
+        auto skipRows = [this](int count) {
+            for (int i = 0; i < count; ++i) {
+                if (1 != this->readRows(this->dstInfo(), fIncrementalSkippedRow.get(),
+                                        fIncrementalRowBytes, 1, this->options())) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        int rows = 0;
+        if (skipRows(get_start_coord(sampleY))) {
+            for (; rows < dstHeight; ++rows) {
+                void* dst = SkTAddOffset<void>(fIncrementalDst, rows * fIncrementalRowBytes);
+                if (1 != this->readRows(this->dstInfo(), dst, fIncrementalRowBytes, 1,
+                                        this->options())) {
+                    break;
+                }
+                if (sampleY > 1 && rows < dstHeight - 1 && !skipRows(sampleY - 1)) {
+                    rows++;
+                    break;
+                }
+            }
+        }
+        if (rows < dstHeight || !jpeg_finish_output(dinfo)) {
+            return fDecoderMgr->returnFailure("incrementalDecodeScans", kErrorInInput);
+        }
+        fIncrementalScan = scan;
+        fIncrementalUpdated.setLTRB(0, 0, fSwizzler ? fSwizzler->swizzleWidth()
+                                                    : this->dstInfo().width(), dstHeight);
+    }
+
+    // Once a scan has been shown, every row has been written.
+    if (rowsDecoded) {
+        *rowsDecoded = fIncrementalScan > 0 ? dstHeight : 0;
+    }
+    return complete && scan == fIncrementalScan ? kSuccess : kIncompleteInput;
+}
+
 int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
     int rows = this->readRows(this->dstInfo(), dst, dstRowBytes, count, this->options());
     if (rows < count) {
@@ -10,11 +10,14 @@
 
 #include "SkCodec.h"
 #include "SkImageInfo.h"
+#include "SkMemoryAccounting.h"
 #include "SkSwizzler.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
 
 class JpegDecoderMgr;
+struct SkJpegRestartLayout;
+struct skjpeg_suspending_source_mgr;
 
 /*
  *
@@ -31,6 +34,8 @@ public:
      */
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
 
+    ~SkJpegCodec() override;
+
 protected:
 
     /*
@@ -54,6 +59,11 @@ protected:
 
     bool onRewind() override;
 
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                    const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+    SkIRect onGetIncrementalUpdatedBounds() const override { return fIncrementalUpdated; }
+
     bool onDimensionsSupported(const SkISize&) override;
 
     bool conversionSupported(const SkImageInfo&, bool, bool) override;
@@ -107,6 +117,10 @@ private:
                             bool needsCMYKToRGB);
     void allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
+    const SkJpegRestartLayout* restartLayout();
+    bool decodeInBands(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, SkExecutor*);
+    void startAtRestartBefore(int* skip);
+    Result incrementalDecodeScans(int* rowsDecoded);
 
     /*
      * Scanline decoding.
@@ -117,6 +131,8 @@ private:
     int onGetScanlines(void* dst, int count, size_t rowBytes) override;
     bool onSkipScanlines(int count) override;
 
+    // Holds the jpeg that fDecoderMgr reads when startAtRestartBefore() has swapped it out.
+    std::unique_ptr<SkStream>          fBandStream;
     std::unique_ptr<JpegDecoderMgr>    fDecoderMgr;
 
     // We will save the state of the decompress struct after reading the header.
@@ -124,7 +140,7 @@ private:
     const int                          fReadyState;
 
 
-    SkAutoTMalloc<uint8_t>             fStorage;
+    SkTaggedAutoTMalloc<uint8_t, SkMemoryTag::kCodec> fStorage;
     uint8_t*                           fSwizzleSrcRow;
     uint32_t*                          fColorXformSrcRow;
 
@@ -135,6 +151,22 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    std::unique_ptr<SkJpegRestartLayout> fRestartLayout;
+    bool                               fRestartLayoutParsed;
+
+    // State of an incremental decode.
+    void*                              fIncrementalDst;
+    size_t                             fIncrementalRowBytes;
+    int                                fIncrementalSkip;
+    SkIRect                            fIncrementalUpdated;
+    // Whether the incremental decode shows a progressive image a scan at a time, the last scan
+    // it showed, and a row to decode the rows that sampling skips into.
+    bool                               fIncrementalScans;
+    int                                fIncrementalScan;
+    SkTaggedAutoTMalloc<uint8_t, SkMemoryTag::kCodec> fIncrementalSkippedRow;
+    // Replaces fDecoderMgr's source while showing scans, unless the stream is in memory.
+    std::unique_ptr<skjpeg_suspending_source_mgr> fSuspendingSource;
+
     friend class SkRawCodec;
 
     typedef SkCodec INHERITED;
@@ -140,3 +140,63 @@ skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream)
         term_source = sk_term_source;
     }
 }
+
+// Functions for suspending sources //
+
+static void sk_init_suspending_source(j_decompress_ptr dinfo) {}
+
+static boolean sk_fill_suspending_input_buffer(j_decompress_ptr dinfo) {
+    // Everything that has arrived is already in the buffer, so suspend.
+    return false;
+}
+
+static void sk_skip_suspending_input_data(j_decompress_ptr dinfo, long numBytes) {
+    skjpeg_suspending_source_mgr* src = (skjpeg_suspending_source_mgr*) dinfo->src;
+    if (numBytes <= 0) {
+        return;
+    }
+    size_t bytes = (size_t) numBytes;
+    if (bytes > src->bytes_in_buffer) {
+        // Skipping can't suspend, so skip the rest when it arrives.
+        src->fSkip += bytes - src->bytes_in_buffer;
+        bytes = src->bytes_in_buffer;
+    }
+    src->next_input_byte += bytes;
+    src->bytes_in_buffer -= bytes;
+}
+
+skjpeg_suspending_source_mgr::skjpeg_suspending_source_mgr(SkStream* stream,
+                                                           const jpeg_source_mgr& src)
+    : fStream(stream)
+    , fSkip(0)
+{
+    init_source = sk_init_suspending_source;
+    fill_input_buffer = sk_fill_suspending_input_buffer;
+    skip_input_data = sk_skip_suspending_input_data;
+    resync_to_restart = jpeg_resync_to_restart;
+    term_source = sk_term_source;
+    fData.append(SkToInt(src.bytes_in_buffer), src.next_input_byte);
+    next_input_byte = fData.begin();
+    bytes_in_buffer = fData.count();
+}
+
+void skjpeg_suspending_source_mgr::addAvailableData() {
+    // libjpeg-turbo never backs up past next_input_byte, so drop what comes before it.
+    fData.remove(0, SkToInt(next_input_byte - fData.begin()));
+
+    while (true) {
+        const int kChunkSize = 4096;
+        const int count = fData.count();
+        fData.append(kChunkSize);
+        const size_t bytes = fStream->read(fData.begin() + count, kChunkSize);
+        fData.setCount(count + SkToInt(bytes));
+        if (0 == bytes) {
+            break;
+        }
+    }
+
+    const size_t skip = SkTMin(fSkip, (size_t) fData.count());
+    fSkip -= skip;
+    next_input_byte = fData.begin() + skip;
+    bytes_in_buffer = fData.count() - skip;
+}
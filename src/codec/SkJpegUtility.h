@@ -11,6 +11,7 @@
 
 #include "SkJpegPriv.h"
 #include "SkStream.h"
+#include "SkTDArray.h"
 
 #include <setjmp.h>
 // stdio is needed for jpeglib
@@ -41,4 +42,22 @@ struct skjpeg_source_mgr : jpeg_source_mgr {
     uint8_t fBuffer[kBufferSize];
 };
 
+/*
+ * Source manager for decoding data as it arrives. libjpeg-turbo may suspend anywhere when it runs
+ * out of data, and back up to where it was when it resumes, so this keeps everything from there
+ * on. Call addAvailableData() before each call into libjpeg-turbo to give it what has arrived.
+ */
+struct skjpeg_suspending_source_mgr : jpeg_source_mgr {
+    // Starts with the bytes that 'src' has not handed to libjpeg-turbo yet.
+    skjpeg_suspending_source_mgr(SkStream* stream, const jpeg_source_mgr& src);
+
+    // Reads whatever the stream has.
+    void addAvailableData();
+
+    SkStream*          fStream; // unowned
+    SkTDArray<uint8_t> fData;
+    // Bytes libjpeg-turbo skipped past the end of fData.
+    size_t             fSkip;
+};
+
 #endif
@@ -18,7 +18,9 @@
 #include "SkPoint3.h"
 #include "SkSize.h"
 #include "SkStream.h"
+#include "SkSemaphore.h"
 #include "SkSwizzler.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
 
@@ -131,6 +133,17 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
 
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
+    // If the stream is in memory, hand libpng its memory rather than a copy.
+    if (const void* base = stream->getMemoryBase()) {
+        if (stream->hasPosition() && stream->hasLength()) {
+            const size_t position = stream->getPosition();
+            const size_t bytesToProcess = std::min(stream->getLength() - position, length);
+            png_process_data(png_ptr, info_ptr, (png_bytep) base + position, bytesToProcess);
+            stream->move(bytesToProcess);
+            return bytesToProcess == length;
+        }
+    }
+
     while (length > 0) {
         const size_t bytesToProcess = std::min(bufferSize, length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
@@ -427,6 +440,7 @@ std::unique_ptr<SkEncodedInfo::ICCProfile> read_color_profile(png_structp png_pt
 }
 
 void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
+    fColorXformSrcRowBytes = 0;
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             break;
@@ -440,8 +454,8 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
             // If we have more than 8-bits (per component) of precision, we will keep that
             // extra precision.  Otherwise, we will swizzle to RGBA_8888 before transforming.
             const size_t bytesPerPixel = (bitsPerPixel > 32) ? bitsPerPixel / 8 : 4;
-            const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
-            fStorage.reset(colorXformBytes);
+            fColorXformSrcRowBytes = dstInfo.width() * bytesPerPixel;
+            fStorage.reset(fColorXformSrcRowBytes);
             fColorXformSrcRow = fStorage.get();
             break;
         }
@@ -463,7 +477,7 @@ static skcms_PixelFormat png_select_xform_format(const SkEncodedInfo& info) {
     return skcms_PixelFormat_RGBA_8888;
 }
 
-void SkPngCodec::applyXformRow(void* dst, const void* src) {
+void SkPngCodec::applyXformRow(void* dst, const void* src, void* colorXformSrcRow) {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
@@ -472,8 +486,8 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
             this->applyColorXform(dst, src, fXformWidth);
             break;
         case kSwizzleColor_XformMode:
-            fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            this->applyColorXform(dst, fColorXformSrcRow, fXformWidth);
+            fSwizzler->swizzle(colorXformSrcRow, (const uint8_t*) src);
+            this->applyColorXform(dst, colorXformSrcRow, fXformWidth);
             break;
     }
 }
@@ -488,12 +502,18 @@ public:
         , fRowBytes(0)
         , fFirstRow(0)
         , fLastRow(0)
+        , fPipeline(nullptr)
     {}
 
     static void AllRowsCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int /*pass*/) {
         GetDecoder(png_ptr)->allRowsCallback(row, rowNum);
     }
 
+    static void PipelinedRowsCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum,
+                                      int /*pass*/) {
+        GetDecoder(png_ptr)->pipelinedRowsCallback(row, rowNum);
+    }
+
     static void RowCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int /*pass*/) {
         GetDecoder(png_ptr)->rowCallback(row, rowNum);
     }
@@ -508,6 +528,31 @@ private:
     int                         fLastRow;
     int                         fRowsNeeded;
 
+    // A pipelined decode inflates and unfilters rows (in libpng) on the calling thread, and hands
+    // them in batches to tasks on the executor, which swizzle and color transform them. libpng
+    // does the inflating and unfiltering together, so they can't be split into stages of their
+    // own. Each of the kPipelineBatches batches must be transformed before it is refilled, which
+    // bounds how far ahead of the tasks libpng gets.
+    static constexpr int kPipelineRows = 16;
+    static constexpr int kPipelineBatches = 4;
+
+    struct Pipeline {
+        explicit Pipeline(SkExecutor& executor) : fTaskGroup(executor) {
+            for (SkSemaphore& free : fFree) {
+                free.signal();
+            }
+        }
+
+        size_t                 fSrcRowBytes;
+        size_t                 fBatchBytes;
+        SkTaggedAutoTMalloc<uint8_t, SkMemoryTag::kCodec> fStorage;
+        SkSemaphore            fFree[kPipelineBatches];
+        int                    fBatch = 0;
+        int                    fBatchRows = 0;
+        SkTaskGroup            fTaskGroup;
+    };
+    Pipeline*                   fPipeline;
+
     typedef SkPngCodec INHERITED;
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
@@ -516,7 +561,21 @@ private:
 
     Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) override {
         const int height = this->dimensions().height();
-        png_set_progressive_read_fn(this->png_ptr(), this, nullptr, AllRowsCallback, nullptr);
+        SkExecutor* executor = this->options().fExecutor;
+        std::unique_ptr<Pipeline> pipeline;
+        if (executor && height >= 2 * kPipelineRows) {
+            pipeline.reset(new Pipeline(*executor));
+            pipeline->fSrcRowBytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
+            // Each batch also needs its own row to swizzle into before the color transform.
+            pipeline->fBatchBytes = kPipelineRows * pipeline->fSrcRowBytes
+                                  + fColorXformSrcRowBytes;
+            pipeline->fStorage.reset(kPipelineBatches * pipeline->fBatchBytes);
+            png_set_progressive_read_fn(this->png_ptr(), this, nullptr, PipelinedRowsCallback,
+                                        nullptr);
+        } else {
+            png_set_progressive_read_fn(this->png_ptr(), this, nullptr, AllRowsCallback, nullptr);
+        }
+        fPipeline = pipeline.get();
         fDst = dst;
         fRowBytes = rowBytes;
 
@@ -525,6 +584,13 @@ private:
         fLastRow = height - 1;
 
         const bool success = this->processData();
+        if (pipeline) {
+            if (pipeline->fBatchRows) {
+                this->submitBatch();
+            }
+            pipeline->fTaskGroup.wait();
+            fPipeline = nullptr;
+        }
         if (success && fRowsWrittenToOutput == height) {
             return kSuccess;
         }
@@ -543,6 +609,39 @@ private:
         fDst = SkTAddOffset<void>(fDst, fRowBytes);
     }
 
+    void pipelinedRowsCallback(png_bytep row, int rowNum) {
+        SkASSERT(rowNum == fRowsWrittenToOutput);
+        Pipeline* pipeline = fPipeline;
+        uint8_t* batch = pipeline->fStorage.get() + pipeline->fBatch * pipeline->fBatchBytes;
+        if (0 == pipeline->fBatchRows) {
+            pipeline->fFree[pipeline->fBatch].wait();
+        }
+        memcpy(batch + pipeline->fBatchRows * pipeline->fSrcRowBytes, row,
+               pipeline->fSrcRowBytes);
+        fRowsWrittenToOutput++;
+        if (kPipelineRows == ++pipeline->fBatchRows) {
+            this->submitBatch();
+        }
+    }
+
+    void submitBatch() {
+        Pipeline* pipeline = fPipeline;
+        const int index = pipeline->fBatch;
+        const int count = pipeline->fBatchRows;
+        uint8_t* batch = pipeline->fStorage.get() + index * pipeline->fBatchBytes;
+        void* dst = SkTAddOffset<void>(fDst, (fRowsWrittenToOutput - count) * fRowBytes);
+        pipeline->fTaskGroup.add([this, pipeline, index, count, batch, dst] {
+            uint8_t* xformSrcRow = batch + kPipelineRows * pipeline->fSrcRowBytes;
+            for (int i = 0; i < count; ++i) {
+                this->applyXformRow(SkTAddOffset<void>(dst, i * fRowBytes),
+                                    batch + i * pipeline->fSrcRowBytes, xformSrcRow);
+            }
+            pipeline->fFree[index].signal();
+        });
+        pipeline->fBatch = (index + 1) % kPipelineBatches;
+        pipeline->fBatchRows = 0;
+    }
+
     void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, RowCallback, nullptr);
         fFirstRow = firstRow;
@@ -622,7 +721,7 @@ private:
     int                     fLinesDecoded;
     bool                    fInterlacedComplete;
     size_t                  fPng_rowbytes;
-    SkAutoTMalloc<png_byte> fInterlaceBuffer;
+    SkTaggedAutoTMalloc<png_byte, SkMemoryTag::kCodec> fInterlaceBuffer;
 
     typedef SkPngCodec INHERITED;
 
@@ -964,6 +1063,7 @@ SkPngCodec::SkPngCodec(SkEncodedInfo&& encodedInfo, std::unique_ptr<SkStream> st
     , fPng_ptr(png_ptr)
     , fInfo_ptr(info_ptr)
     , fColorXformSrcRow(nullptr)
+    , fColorXformSrcRowBytes(0)
     , fBitDepth(bitDepth)
     , fIdatLength(0)
     , fDecodedIdat(false)
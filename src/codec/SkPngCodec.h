@@ -12,6 +12,7 @@
 #include "SkPngChunkReader.h"
 #include "SkEncodedImageFormat.h"
 #include "SkImageInfo.h"
+#include "SkMemoryAccounting.h"
 #include "SkRefCnt.h"
 #include "SkSwizzler.h"
 
@@ -53,7 +54,12 @@ protected:
     bool onRewind() override;
 
     SkSampler* getSampler(bool createIfNecessary) override;
-    void applyXformRow(void* dst, const void* src);
+    void applyXformRow(void* dst, const void* src) {
+        this->applyXformRow(dst, src, fColorXformSrcRow);
+    }
+    // Uses colorXformSrcRow, which holds fColorXformSrcRowBytes, as scratch space, so that rows
+    // may be transformed on several threads at once.
+    void applyXformRow(void* dst, const void* src, void* colorXformSrcRow);
 
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
@@ -82,8 +88,9 @@ protected:
     // These are stored here so they can be used both by normal decoding and scanline decoding.
     sk_sp<SkColorTable>         fColorTable;    // May be unpremul.
     std::unique_ptr<SkSwizzler> fSwizzler;
-    SkAutoTMalloc<uint8_t>      fStorage;
+    SkTaggedAutoTMalloc<uint8_t, SkMemoryTag::kCodec> fStorage;
     void*                       fColorXformSrcRow;
+    size_t                      fColorXformSrcRowBytes;
     const int                   fBitDepth;
 
 private:
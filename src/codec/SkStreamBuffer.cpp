@@ -13,6 +13,8 @@ SkStreamBuffer::SkStreamBuffer(std::unique_ptr<SkStream> stream)
     , fBytesBuffered(0)
     , fHasLengthAndPosition(fStream->hasLength() && fStream->hasPosition())
     , fTrulyBuffered(0)
+    , fMemoryBase(fHasLengthAndPosition
+                  ? static_cast<const char*>(fStream->getMemoryBase()) : nullptr)
 {}
 
 SkStreamBuffer::~SkStreamBuffer() {
@@ -21,6 +23,9 @@ SkStreamBuffer::~SkStreamBuffer() {
 
 const char* SkStreamBuffer::get() const {
     SkASSERT(fBytesBuffered >= 1);
+    if (fMemoryBase) {
+        return fMemoryBase + fPosition;
+    }
     if (fHasLengthAndPosition && fTrulyBuffered < fBytesBuffered) {
         const size_t bytesToBuffer = fBytesBuffered - fTrulyBuffered;
         char* dst = SkTAddOffset<char>(const_cast<char*>(fBuffer), fTrulyBuffered);
@@ -74,6 +79,12 @@ sk_sp<SkData> SkStreamBuffer::getDataAtPosition(size_t position, size_t length)
 
     SkASSERT(position + length <= fStream->getLength());
 
+    if (fMemoryBase) {
+        // The stream, and so its memory, outlives the data, which is only
+        // used while decoding.
+        return SkData::MakeWithoutCopy(fMemoryBase + position, length);
+    }
+
     const size_t oldPosition = fStream->getPosition();
     if (!fStream->seek(position)) {
         return nullptr;
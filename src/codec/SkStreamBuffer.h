@@ -20,6 +20,8 @@
  *  Used by GIFImageReader, and currently set up for that use case.
  *
  *  Buffers up to 256 * 3 bytes (256 colors, with 3 bytes each) to support GIF.
+ *  If the stream is in memory, nothing is copied; get() and getDataAtPosition()
+ *  point into the stream's memory.
  *  FIXME (scroggo): Make this more general purpose?
  */
 class SkStreamBuffer : SkNoncopyable {
@@ -108,6 +110,10 @@ private:
     // The second call to get() needs to only truly buffer the part that was
     // not already buffered.
     mutable size_t              fTrulyBuffered;
+    // If the stream has a length and position and is in memory, this points
+    // to its memory, and get() and getDataAtPosition() point into it rather
+    // than reading into a copy. fTrulyBuffered stays 0.
+    const char* const           fMemoryBase;
     // Only used if !fHasLengthAndPosition. In that case, markPosition will
     // copy into an SkData, stored here.
     SkTHashMap<size_t, SkData*> fMarkedData;
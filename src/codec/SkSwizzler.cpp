@@ -545,6 +545,28 @@ static void swizzle_rgb16_to_bgra(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_565(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -575,6 +597,17 @@ static void swizzle_rgba16_to_rgba_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_rgba_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -590,6 +623,19 @@ static void swizzle_rgba16_to_rgba_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    // Strip to 8 bits, then premultiply in place.
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_rgbA((uint32_t*) dst, (const uint32_t*) dst, width);
+}
+
 static void swizzle_rgba16_to_bgra_unpremul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -605,6 +651,17 @@ static void swizzle_rgba16_to_bgra_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -620,6 +677,19 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    // Premultiplying doesn't care about the order of the color channels.
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_rgbA((uint32_t*) dst, (const uint32_t*) dst, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -973,6 +1043,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                     case kRGBA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = &swizzle_rgb16_to_rgba;
+                            fastProc = &fast_swizzle_rgb16_to_rgba;
                             break;
                         }
 
@@ -983,6 +1054,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                     case kBGRA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = &swizzle_rgb16_to_bgra;
+                            fastProc = &fast_swizzle_rgb16_to_bgra;
                             break;
                         }
 
@@ -1008,6 +1080,8 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
                                                  &swizzle_rgba16_to_rgba_unpremul;
+                            fastProc = premultiply ? &fast_swizzle_rgba16_to_rgba_premul :
+                                                     &fast_swizzle_rgba16_to_rgba_unpremul;
                             break;
                         }
 
@@ -1035,6 +1109,8 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
                                                  &swizzle_rgba16_to_bgra_unpremul;
+                            fastProc = premultiply ? &fast_swizzle_rgba16_to_bgra_premul :
+                                                     &fast_swizzle_rgba16_to_bgra_unpremul;
                             break;
                         }
 
@@ -1193,6 +1269,7 @@ SkSwizzler::SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable,
     : fFastProc(fastProc)
     , fSlowProc(proc)
     , fActualProc(fFastProc ? fFastProc : fSlowProc)
+    , fGatherProc(nullptr)
     , fColorTable(ctable)
     , fSrcOffset(srcOffset)
     , fDstOffset(dstOffset)
@@ -1207,6 +1284,16 @@ SkSwizzler::SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable,
     , fDstBPP(dstBPP)
 {}
 
+template <int kBPP>
+static void gather(uint8_t* SK_RESTRICT dst, const uint8_t* SK_RESTRICT src, int width,
+                   int deltaSrc) {
+    for (int x = 0; x < width; x++) {
+        memcpy(dst, src, kBPP);
+        dst += kBPP;
+        src += deltaSrc;
+    }
+}
+
 int SkSwizzler::onSetSampleX(int sampleX) {
     SkASSERT(sampleX > 0);
 
@@ -1216,11 +1303,30 @@ int SkSwizzler::onSetSampleX(int sampleX) {
     fSwizzleWidth = get_scaled_dimension(fSrcWidth, sampleX);
     fAllocatedWidth = get_scaled_dimension(fDstWidth, sampleX);
 
-    // The optimized swizzler functions do not support sampling.  Sampled swizzles
-    // are already fast because they skip pixels.  We haven't seen a situation
-    // where speeding up sampling has a significant impact on total decode time.
+    // The optimized swizzler functions do not support sampling.  When sampling, we
+    // gather the sampled pixels into a contiguous row and then run the optimized
+    // function on that, unless the optimized function would only copy them again.
+    fGatherProc = nullptr;
     if (1 == fSampleX && fFastProc) {
         fActualProc = fFastProc;
+    } else if (fFastProc && fFastProc != &copy &&
+               fFastProc != &SkipLeading8888ZerosThen<copy>) {
+        // Every format with an optimized swizzle is a whole number of bytes per pixel.
+        switch (fSrcBPP) {
+            case 1: fGatherProc = &gather<1>; break;
+            case 2: fGatherProc = &gather<2>; break;
+            case 3: fGatherProc = &gather<3>; break;
+            case 4: fGatherProc = &gather<4>; break;
+            case 6: fGatherProc = &gather<6>; break;
+            case 8: fGatherProc = &gather<8>; break;
+            default: SkASSERT(false); break;
+        }
+        if (fGatherProc) {
+            fGatherBuffer.reset(fSwizzleWidth * fSrcBPP);
+            fActualProc = fFastProc;
+        } else {
+            fActualProc = fSlowProc;
+        }
     } else {
         fActualProc = fSlowProc;
     }
@@ -1230,6 +1336,13 @@ int SkSwizzler::onSetSampleX(int sampleX) {
 
 void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
+    if (fGatherProc) {
+        fGatherProc(fGatherBuffer.get(), src + fSrcOffsetUnits, fSwizzleWidth,
+                    fSampleX * fSrcBPP);
+        fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), fGatherBuffer.get(),
+                    fSwizzleWidth, fSrcBPP, fSrcBPP, 0, fColorTable);
+        return;
+    }
     fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
             fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
 }
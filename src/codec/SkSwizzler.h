@@ -12,6 +12,7 @@
 #include "SkColor.h"
 #include "SkImageInfo.h"
 #include "SkSampler.h"
+#include "SkTemplates.h"
 
 class SkSwizzler : public SkSampler {
 public:
@@ -121,6 +122,15 @@ private:
     // whether or not we are sampling.
     RowProc             fActualProc;
 
+    // Copies every deltaSrc'th pixel of src, starting with the first, to dst.
+    typedef void (*GatherProc)(uint8_t* SK_RESTRICT dst, const uint8_t* SK_RESTRICT src,
+                               int width, int deltaSrc);
+
+    // Non-NULL when we are sampling with fFastProc.  Each row's sampled pixels are gathered into
+    // fGatherBuffer, then fFastProc swizzles them all at once.
+    GatherProc             fGatherProc;
+    SkAutoTMalloc<uint8_t> fGatherBuffer;
+
     const SkPMColor*    fColorTable;      // Unowned pointer
 
     // Subset Swizzles
@@ -10,6 +10,7 @@
 
 #include "SkCodec.h"
 #include "SkColorSpace.h"
+#include "SkMemoryAccounting.h"
 #include "SkSwizzler.h"
 
 class SkWbmpCodec final : public SkCodec {
@@ -54,7 +55,7 @@ private:
 
     // Used for scanline decodes:
     std::unique_ptr<SkSwizzler> fSwizzler;
-    SkAutoTMalloc<uint8_t>      fSrcBuffer;
+    SkTaggedAutoTMalloc<uint8_t, SkMemoryTag::kCodec> fSrcBuffer;
 
     int onGetScanlines(void* dst, int count, size_t dstRowBytes) override;
     bool onSkipScanlines(int count) override;
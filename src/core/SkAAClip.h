@@ -33,6 +33,9 @@ public:
     // If true, getBounds() can be used in place of this clip.
     bool isRect() const;
 
+    // Bytes held by the clip's run data, which copies of it share.
+    size_t bytesUsed() const;
+
     bool setEmpty();
     bool setRect(const SkIRect&);
     bool setRect(const SkRect&, bool doAA = true);
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAAClipCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gAAClipKeyNamespaceLabel;
+
+struct AAClipKey : public SkResourceCache::Key {
+public:
+    AAClipKey(const SkPath& path, const SkMatrix& matrix, const SkIRect& bounds)
+        : fGenID(path.getGenerationID())
+        , fFillType(path.getFillType())
+        , fBounds(bounds)
+    {
+        matrix.get9(fMatrix);
+        this->init(&gAAClipKeyNamespaceLabel, 0,
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fBounds) + sizeof(fMatrix));
+    }
+
+    uint32_t    fGenID;
+    int32_t     fFillType;
+    SkIRect     fBounds;
+    SkScalar    fMatrix[9];
+};
+
+struct AAClipRec : public SkResourceCache::Rec {
+    AAClipRec(const AAClipKey& key, const SkAAClip& clip)
+        : fKey(key)
+        , fClip(clip)
+    {}
+
+    AAClipKey   fKey;
+    SkAAClip    fClip;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fClip.bytesUsed(); }
+    const char* getCategory() const override { return "aa-clip"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const AAClipRec& rec = static_cast<const AAClipRec&>(baseRec);
+        *static_cast<SkAAClip*>(contextData) = rec.fClip;
+        return true;
+    }
+};
+} // namespace
+
+bool SkAAClipCache::ShouldCache(const SkPath& path) {
+    // Simpler paths are about as quick to scan convert as to look up.
+    constexpr int kMinPointsToCache = 16;
+    return !path.isVolatile() && path.countPoints() >= kMinPointsToCache;
+}
+
+bool SkAAClipCache::Find(const SkPath& path, const SkMatrix& matrix, const SkIRect& bounds,
+                         SkAAClip* clip, SkResourceCache* localCache) {
+    AAClipKey key(path, matrix, bounds);
+    return CHECK_LOCAL(localCache, find, Find, key, AAClipRec::Visitor, clip);
+}
+
+void SkAAClipCache::Add(const SkPath& path, const SkMatrix& matrix, const SkIRect& bounds,
+                        const SkAAClip& clip, SkResourceCache* localCache) {
+    AAClipKey key(path, matrix, bounds);
+    return CHECK_LOCAL(localCache, add, Add, new AAClipRec(key, clip));
+}
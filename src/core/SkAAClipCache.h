@@ -0,0 +1,41 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAAClipCache_DEFINED
+#define SkAAClipCache_DEFINED
+
+#include "SkAAClip.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
+#include "SkRect.h"
+#include "SkResourceCache.h"
+
+/**
+ *  Caches the SkAAClips built from antialiased clip paths, keyed by the path's generation ID and
+ *  fill type, the matrix it was drawn with, and the device rect it was clipped to.  Clips are
+ *  shared, not copied, so a hit costs a lookup and a ref.
+ */
+class SkAAClipCache {
+public:
+    /**
+     *  Is the path complex enough that scan converting it costs more than a cache lookup, and
+     *  might it be seen again?
+     */
+    static bool ShouldCache(const SkPath&);
+
+    /**
+     *  On success, set clip to the cached result of clipping path, transformed by matrix, to
+     *  bounds, and return true.
+     */
+    static bool Find(const SkPath& path, const SkMatrix& matrix, const SkIRect& bounds,
+                     SkAAClip* clip, SkResourceCache* localCache = nullptr);
+
+    static void Add(const SkPath& path, const SkMatrix& matrix, const SkIRect& bounds,
+                    const SkAAClip& clip, SkResourceCache* localCache = nullptr);
+};
+
+#endif
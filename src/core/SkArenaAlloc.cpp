@@ -6,6 +6,7 @@
  */
 
 #include "SkArenaAlloc.h"
+#include "SkArenaBlockPool.h"
 #include <algorithm>
 #include <new>
 
@@ -84,7 +85,10 @@ char* SkArenaAlloc::NextBlock(char* footerEnd) {
     char* next;
     memmove(&next, objEnd, sizeof(char*));
     RunDtorsOnBlock(next);
-    delete [] objEnd;
+    char* block = objEnd - sizeof(uint32_t);
+    uint32_t blockSize;
+    memmove(&blockSize, block, sizeof(uint32_t));
+    SkArenaBlockPool::Free(block, blockSize);
     return nullptr;
 }
 
@@ -95,7 +99,7 @@ void SkArenaAlloc::installUint32Footer(FooterAction* action, uint32_t value, uin
 }
 
 void SkArenaAlloc::ensureSpace(uint32_t size, uint32_t alignment) {
-    constexpr uint32_t headerSize = sizeof(Footer) + sizeof(ptrdiff_t);
+    constexpr uint32_t headerSize = sizeof(uint32_t) + sizeof(Footer) + sizeof(ptrdiff_t);
     // The chrome c++ library we use does not define std::max_align_t.
     // This must be conservative to add the right amount of extra memory to handle the alignment
     // padding.
@@ -128,12 +132,19 @@ void SkArenaAlloc::ensureSpace(uint32_t size, uint32_t alignment) {
         allocationSize = (allocationSize + mask) & ~mask;
     }
 
-    char* newBlock = new char[allocationSize];
+    // The pool may round the block up to a larger size class; the arena can use all of it.
+    size_t blockSize = allocationSize;
+    char* newBlock = static_cast<char*>(SkArenaBlockPool::Alloc(&blockSize));
+    allocationSize = ToU32(blockSize);
+    fHeapBytes += allocationSize;
 
     auto previousDtor = fDtorCursor;
     fCursor = newBlock;
     fDtorCursor = newBlock;
     fEnd = fCursor + allocationSize;
+    // NextBlock() needs the block's size to give it back to the pool.
+    memmove(fCursor, &allocationSize, sizeof(uint32_t));
+    fCursor += sizeof(uint32_t);
     this->installPtrFooter(NextBlock, previousDtor, 0);
 }
 
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaBlockPool.h"
+
+#include "SkMalloc.h"
+#include "SkMathPriv.h"
+#include "SkMemoryAccounting.h"
+#include "SkTLS.h"
+
+#include <atomic>
+
+static constexpr int kMinSizeLog2 = 9,   // 512 bytes
+                     kMaxSizeLog2 = 16;  // 64K
+static constexpr int kSizeClassCount = kMaxSizeLog2 - kMinSizeLog2 + 1;
+
+// Up to 4 blocks of each size, at most ~500K per thread.
+static constexpr int kMaxBlocksPerClass = 4;
+
+static std::atomic<int64_t> gAllocs{0},
+                            gReuses{0};
+
+namespace {
+
+struct ThreadBlocks {
+    void* fBlocks[kSizeClassCount][kMaxBlocksPerClass];
+    int   fCount[kSizeClassCount] = {};
+
+    ~ThreadBlocks() {
+        for (int i = 0; i < kSizeClassCount; i++) {
+            for (int j = 0; j < fCount[i]; j++) {
+                sk_free(fBlocks[i][j]);
+            }
+            SkMemoryAccounting::Remove(SkMemoryTag::kArenaBlockPool,
+                                       fCount[i] * ((size_t)1 << (i + kMinSizeLog2)));
+        }
+    }
+};
+
+}  // namespace
+
+static void* create_thread_blocks() { return new ThreadBlocks; }
+static void  delete_thread_blocks(void* blocks) { delete static_cast<ThreadBlocks*>(blocks); }
+
+static ThreadBlocks* thread_blocks() {
+    return static_cast<ThreadBlocks*>(SkTLS::Get(create_thread_blocks, delete_thread_blocks));
+}
+
+// Returns the size class of size bytes, or -1 if it's too large to pool.
+static int size_class(size_t size) {
+    if (size > (size_t)1 << kMaxSizeLog2) {
+        return -1;
+    }
+    return SkTMax(SkNextLog2((uint32_t)size), kMinSizeLog2) - kMinSizeLog2;
+}
+
+void* SkArenaBlockPool::Alloc(size_t* size) {
+    gAllocs.fetch_add(1, std::memory_order_relaxed);
+
+    const int sizeClass = size_class(*size);
+    if (sizeClass < 0) {
+        SkMemoryAccounting::Add(SkMemoryTag::kArenaBlocks, *size);
+        return sk_malloc_throw(*size);
+    }
+
+    *size = (size_t)1 << (sizeClass + kMinSizeLog2);
+    SkMemoryAccounting::Add(SkMemoryTag::kArenaBlocks, *size);
+    ThreadBlocks* blocks = thread_blocks();
+    if (blocks->fCount[sizeClass] > 0) {
+        gReuses.fetch_add(1, std::memory_order_relaxed);
+        SkMemoryAccounting::Remove(SkMemoryTag::kArenaBlockPool, *size);
+        return blocks->fBlocks[sizeClass][--blocks->fCount[sizeClass]];
+    }
+    return sk_malloc_throw(*size);
+}
+
+void SkArenaBlockPool::Free(void* block, size_t size) {
+    SkMemoryAccounting::Remove(SkMemoryTag::kArenaBlocks, size);
+    const int sizeClass = size_class(size);
+    if (sizeClass >= 0) {
+        SkASSERT(size == (size_t)1 << (sizeClass + kMinSizeLog2));
+        ThreadBlocks* blocks = thread_blocks();
+        if (blocks->fCount[sizeClass] < kMaxBlocksPerClass) {
+            blocks->fBlocks[sizeClass][blocks->fCount[sizeClass]++] = block;
+            SkMemoryAccounting::Add(SkMemoryTag::kArenaBlockPool, size);
+            return;
+        }
+    }
+    sk_free(block);
+}
+
+SkArenaBlockPool::Stats SkArenaBlockPool::GetStats() {
+    return { gAllocs.load(std::memory_order_relaxed), gReuses.load(std::memory_order_relaxed) };
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkArenaBlockPool_DEFINED
+#define SkArenaBlockPool_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  Recycles the blocks that SkArenaAlloc and GrMemoryPool get from the heap.  Block sizes are
+ *  rounded up to a power of two from 512 bytes to 64K, and each thread keeps a few freed blocks
+ *  of each size to hand out again, so that the many short-lived arenas made per draw, per op and
+ *  per glyph run mostly stop going to malloc and free.  Larger blocks come straight from the heap.
+ *
+ *  A block can be freed on a different thread than it was allocated on; it joins that thread's
+ *  blocks.
+ */
+class SkArenaBlockPool {
+public:
+    /** Returns a block of at least *size bytes, and sets *size to its actual size. */
+    static void* Alloc(size_t* size);
+
+    /** Frees a block from Alloc(), given the size Alloc() returned for it. */
+    static void Free(void* block, size_t size);
+
+    struct Stats {
+        int64_t fAllocs;    // calls to Alloc()
+        int64_t fReuses;    // ... and of those, the ones handed a recycled block
+    };
+    static Stats GetStats();
+};
+
+#endif
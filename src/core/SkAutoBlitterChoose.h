@@ -11,6 +11,7 @@
 #include "SkArenaAlloc.h"
 #include "SkBlitter.h"
 #include "SkDraw.h"
+#include "SkDrawScratch.h"
 #include "SkMacros.h"
 
 class SkMatrix;
@@ -20,6 +21,9 @@ class SkPixmap;
 class SkAutoBlitterChoose : SkNoncopyable {
 public:
     SkAutoBlitterChoose() {}
+    ~SkAutoBlitterChoose() {
+        fScratch.noteHeapBytes(fAlloc.heapBytes());
+    }
     SkAutoBlitterChoose(const SkDraw& draw, const SkMatrix* matrix, const SkPaint& paint,
                         bool drawCoverage = false) {
         this->choose(draw, matrix, paint, drawCoverage);
@@ -49,7 +53,9 @@ private:
     // Owned by fAlloc, which will handle the delete.
     SkBlitter* fBlitter = nullptr;
 
-    SkSTArenaAlloc<kSkBlitterContextSize> fAlloc;
+    // fAlloc is carved out of this thread's scratch block, so it usually needn't touch the heap.
+    SkDrawScratch fScratch;
+    SkArenaAlloc  fAlloc{fScratch.block(), fScratch.size(), 0};
 };
 #define SkAutoBlitterChoose(...) SK_REQUIRE_LOCAL_VAR(SkAutoBlitterChoose)
 
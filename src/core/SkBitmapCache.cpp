@@ -13,6 +13,7 @@
 #include "SkMipMap.h"
 #include "SkPixelRef.h"
 #include "SkRect.h"
+#include "SkSharedDiscardableMemoryPool.h"
 
 /**
  *  Use this for bitmapcache and mipmapcache entries.
@@ -63,6 +64,26 @@ public:
 
     const SkBitmapCacheDesc fDesc;
 };
+
+// The key of pixels in the shared pool, which has to mean the same thing in every process.
+struct SharedBitmapKey {
+    SharedBitmapKey(const SkBitmapCacheDesc& desc, uint64_t contentID) {
+        // Zero any padding, since the pool compares keys byte by byte.
+        memset(this, 0, sizeof(*this));
+        fContentID = contentID;
+        fColorType = desc.fColorType;
+        fCSXYZHash = desc.fCSXYZHash;
+        fCSTransferFnHash = desc.fCSTransferFnHash;
+        fSubset = desc.fSubset;
+    }
+
+    uint64_t fContentID;
+    int32_t  fColorType;
+    uint32_t fCSXYZHash;
+    uint32_t fCSTransferFnHash;
+    SkIRect  fSubset;
+};
+static_assert(sizeof(SharedBitmapKey) <= SkSharedDiscardableMemoryPool::kMaxKeyBytes, "");
 }
 
 //////////////////////
@@ -147,6 +168,19 @@ public:
         }
     }
 
+    // Pixels allocated from the shared pool under a key are published when they're added.
+    void setSharedPool(sk_sp<SkSharedDiscardableMemoryPool> pool) {
+        SkASSERT(fDM);
+        fSharedPool = std::move(pool);
+    }
+
+    void publish() {
+        if (fSharedPool) {
+            fSharedPool->publish(fDM.get());
+            fSharedPool.reset();
+        }
+    }
+
     bool install(SkBitmap* bitmap) {
         SkAutoMutexAcquire ama(fMutex);
 
@@ -208,6 +242,9 @@ private:
     std::unique_ptr<SkDiscardableMemory> fDM;
     void*       fMalloc;
 
+    // Set until fDM, from the shared pool, is published.
+    sk_sp<SkSharedDiscardableMemoryPool> fSharedPool;
+
     SkImageInfo fInfo;
     size_t      fRowBytes;
     uint32_t    fPrUniqueID;
@@ -261,6 +298,7 @@ SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const
 }
 
 void SkBitmapCache::Add(RecPtr rec, SkBitmap* bitmap) {
+    rec->publish();
     SkResourceCache::Add(rec.release(), bitmap);
 }
 
@@ -269,6 +307,55 @@ bool SkBitmapCache::Find(const SkBitmapCacheDesc& desc, SkBitmap* result) {
     return SkResourceCache::Find(BitmapKey(desc), SkBitmapCache::Rec::Finder, result);
 }
 
+bool SkBitmapCache::FindShared(const SkBitmapCacheDesc& desc, uint64_t contentID,
+                               const SkImageInfo& info, SkBitmap* result) {
+    desc.validate();
+    SkASSERT(info.width() == desc.fSubset.width());
+    SkASSERT(info.height() == desc.fSubset.height());
+    sk_sp<SkSharedDiscardableMemoryPool> pool = SkSharedDiscardableMemoryPool::Global();
+    if (!pool) {
+        return false;
+    }
+
+    const SharedBitmapKey key(desc, contentID);
+    size_t bytes;
+    std::unique_ptr<SkDiscardableMemory> dm = pool->find(&key, sizeof(key), &bytes);
+    if (!dm) {
+        return false;
+    }
+    const size_t rb = info.minRowBytes();
+    if (bytes < info.computeByteSize(rb)) {
+        dm->unlock();
+        return false;
+    }
+    SkResourceCache::Add(new Rec(desc, info, rb, std::move(dm), nullptr), result);
+    return true;
+}
+
+SkBitmapCache::RecPtr SkBitmapCache::AllocShared(const SkBitmapCacheDesc& desc,
+                                                 uint64_t contentID, const SkImageInfo& info,
+                                                 SkPixmap* pmap) {
+    sk_sp<SkSharedDiscardableMemoryPool> pool = SkSharedDiscardableMemoryPool::Global();
+    if (!pool) {
+        return Alloc(desc, info, pmap);
+    }
+
+    const size_t rb = info.minRowBytes();
+    size_t size = info.computeByteSize(rb);
+    if (SkImageInfo::ByteSizeOverflowed(size)) {
+        return nullptr;
+    }
+    const SharedBitmapKey key(desc, contentID);
+    std::unique_ptr<SkDiscardableMemory> dm = pool->createForKey(&key, sizeof(key), size);
+    if (!dm) {
+        return Alloc(desc, info, pmap);
+    }
+    *pmap = SkPixmap(info, dm->data(), rb);
+    RecPtr rec(new Rec(desc, info, rb, std::move(dm), nullptr));
+    rec->setSharedPool(std::move(pool));
+    return rec;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 
@@ -54,6 +54,24 @@ public:
     static RecPtr Alloc(const SkBitmapCacheDesc&, const SkImageInfo&, SkPixmap*);
     static void Add(RecPtr, SkBitmap*);
 
+    /**
+     *  Pixels in the global SkSharedDiscardableMemoryPool are keyed by the desc, but with
+     *  contentID, which must identify the pixels' source in every process (e.g. a hash of the
+     *  encoded image), in place of the process-local image ID.
+     *
+     *  FindShared() looks for the pixels in the shared pool. If they are there, it adds them to
+     *  this process's cache, sets result to them, and returns true.
+     *
+     *  AllocShared() is like Alloc(), but the pixels come from the shared pool when it has room
+     *  for them, and are published there when they are added to the cache. Any process may then
+     *  find them. If there is no shared pool, or another process is already making the pixels,
+     *  this is the same as Alloc().
+     */
+    static bool FindShared(const SkBitmapCacheDesc&, uint64_t contentID, const SkImageInfo&,
+                           SkBitmap* result);
+    static RecPtr AllocShared(const SkBitmapCacheDesc&, uint64_t contentID, const SkImageInfo&,
+                              SkPixmap*);
+
 private:
     static void PrivateDeleteRec(Rec*);
 };
@@ -15,13 +15,17 @@
 #include "SkMatrix.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkPathPriv.h"
 #include "SkPixelRef.h"
 #include "SkPixmap.h"
+#include "SkRRect.h"
 #include "SkRasterClip.h"
 #include "SkRasterHandleAllocator.h"
 #include "SkShader.h"
 #include "SkSpecialImage.h"
 #include "SkSurface.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkTLazy.h"
 #include "SkVertices.h"
 
@@ -271,6 +275,10 @@ SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap, const SkSurfaceProps& sur
     }
 }
 
+SkBitmapDevice::~SkBitmapDevice() {
+    this->flushPathBatch();
+}
+
 SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
                                        const SkSurfaceProps& surfaceProps,
                                        bool trackCoverage,
@@ -320,6 +328,7 @@ SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
 }
 
 void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
+    // The pending fills belong to the new pixels: the surface has already copied the old ones.
     SkASSERT(bm.width() == fBitmap.width());
     SkASSERT(bm.height() == fBitmap.height());
     fBitmap = bm;   // intent is to use bm's pixelRef (and rowbytes/config)
@@ -328,8 +337,12 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
 
 SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPaint*) {
     const SkSurfaceProps surfaceProps(this->surfaceProps().flags(), cinfo.fPixelGeometry);
-    return SkBitmapDevice::Create(cinfo.fInfo, surfaceProps, cinfo.fTrackCoverage,
-                                  cinfo.fAllocator);
+    SkBitmapDevice* device = SkBitmapDevice::Create(cinfo.fInfo, surfaceProps,
+                                                    cinfo.fTrackCoverage, cinfo.fAllocator);
+    if (device) {
+        device->setImageFilterTileSize(fImageFilterTileSize);
+    }
+    return device;
 }
 
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
@@ -341,6 +354,7 @@ bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
 }
 
 bool SkBitmapDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flushPathBatch();
     const SkImageInfo info = fBitmap.info();
     if (fBitmap.getPixels() && (kUnknown_SkColorType != info.colorType())) {
         pmap->reset(fBitmap.info(), fBitmap.getPixels(), fBitmap.rowBytes());
@@ -354,6 +368,7 @@ bool SkBitmapDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
     if (nullptr == fBitmap.getPixels()) {
         return false;
     }
+    this->flushPathBatch();
 
     if (fBitmap.writePixels(pm, x, y)) {
         fBitmap.notifyPixelsChanged();
@@ -363,9 +378,94 @@ bool SkBitmapDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
 }
 
 bool SkBitmapDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flushPathBatch();
     return fBitmap.readPixels(pm, x, y);
 }
 
+void SkBitmapDevice::flush() {
+    this->flushPathBatch();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Past this many paths, checking a new one against all of the batch costs more than it saves.
+static constexpr int kMaxBatchedPaths = 64;
+
+struct SkBitmapDevice::PathBatch {
+    SkPaint            fPaint;
+    SkMatrix           fMatrix;     // only ever used to map the paint's shader
+    SkIRect            fClip;
+    SkPath             fDevPath;    // all of the batched paths, in device space
+    SkTDArray<SkIRect> fBounds;     // the device bounds of each of them, outset for anti-aliasing
+};
+
+bool SkBitmapDevice::tryBatchPath(const SkPath& path, const SkPaint& paint) {
+    const SkRasterClip& rc = fRCStack.rc();
+    if (!this->surfaceProps().isBatchRasterPathFills() || fCoverage || fRasterHandle ||
+        SkDrawTiler::NeedsTiling(this) || !rc.isRect() ||
+        paint.getStyle() != SkPaint::kFill_Style || paint.getPathEffect() ||
+        paint.getMaskFilter() || path.isInverseFillType()) {
+        return false;
+    }
+
+    SkRect devRect;
+    this->ctm().mapRect(&devRect, path.getBounds());
+    if (!devRect.isFinite()) {
+        return false;
+    }
+    const SkIRect devBounds = devRect.roundOut().makeOutset(1, 1);
+
+    PathBatch* batch = fPathBatch.get();
+    bool compatible = batch && !batch->fBounds.isEmpty() &&
+                      batch->fBounds.count() < kMaxBatchedPaths &&
+                      batch->fPaint == paint &&
+                      batch->fClip == rc.getBounds() &&
+                      batch->fDevPath.getFillType() == path.getFillType() &&
+                      (!paint.getShader() || batch->fMatrix == this->ctm());
+    // Overlapping fills must blend one after the other, so they can't share one coverage pass.
+    for (int i = 0; compatible && i < batch->fBounds.count(); ++i) {
+        compatible = !SkIRect::Intersects(batch->fBounds[i], devBounds);
+    }
+
+    if (!compatible) {
+        this->flushPathBatch();
+        if (!fPathBatch) {
+            fPathBatch = skstd::make_unique<PathBatch>();
+        }
+        batch = fPathBatch.get();
+        batch->fPaint = paint;
+        batch->fMatrix = this->ctm();
+        batch->fClip = rc.getBounds();
+        batch->fDevPath.setFillType(path.getFillType());
+    }
+
+    batch->fDevPath.addPath(path, this->ctm());
+    batch->fBounds.push_back(devBounds);
+    return true;
+}
+
+void SkBitmapDevice::flushPathBatch() {
+    if (!fPathBatch || fPathBatch->fBounds.isEmpty()) {
+        return;
+    }
+
+    // Take the batch, so that reaching for the pixels below doesn't flush it again.
+    std::unique_ptr<PathBatch> batch = std::move(fPathBatch);
+    const SkRasterClip rc(batch->fClip);
+
+    BDDraw draw(this);
+    draw.fMatrix = &batch->fMatrix;
+    draw.fRC = &rc;
+    if (!SkPathPriv::TooBigForMath(batch->fDevPath)) {
+        draw.drawDevPath(batch->fDevPath, batch->fPaint, false, nullptr, true);
+    }
+
+    batch->fPaint.reset();
+    batch->fDevPath.rewind();
+    batch->fBounds.rewind();
+    fPathBatch = std::move(batch);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkBitmapDevice::drawPaint(const SkPaint& paint) {
@@ -382,6 +482,14 @@ void SkBitmapDevice::drawRect(const SkRect& r, const SkPaint& paint) {
 }
 
 void SkBitmapDevice::drawOval(const SkRect& oval, const SkPaint& paint) {
+#if !defined(SK_DISABLE_ANALYTIC_RRECTS)
+    // SkDraw::drawRRect() can fill antialiased ovals analytically.
+    if (paint.isAntiAlias() && paint.getStyle() == SkPaint::kFill_Style &&
+        !paint.getPathEffect() && !paint.getMaskFilter()) {
+        this->drawRRect(SkRRect::MakeOval(oval), paint);
+        return;
+    }
+#endif
     SkPath path;
     path.addOval(oval);
     // call the VIRTUAL version, so any subclasses who do handle drawPath aren't
@@ -405,6 +513,10 @@ void SkBitmapDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
 void SkBitmapDevice::drawPath(const SkPath& path,
                               const SkPaint& paint,
                               bool pathIsMutable) {
+    if (this->tryBatchPath(path, paint)) {
+        return;
+    }
+
     const SkRect* bounds = nullptr;
     if (SkDrawTiler::NeedsTiling(this) && !path.isInverseFillType()) {
         bounds = &path.getBounds();
@@ -414,7 +526,10 @@ void SkBitmapDevice::drawPath(const SkPath& path,
         pathIsMutable = false;
     }
     while (const SkDraw* draw = tiler.next()) {
-        draw->drawPath(path, paint, nullptr, pathIsMutable);
+        // Mutable paths are temporaries, never drawn again, so they skip the mask cache.
+        if (pathIsMutable || !draw->drawPathFromMaskCache(path, paint)) {
+            draw->drawPath(path, paint, nullptr, pathIsMutable);
+        }
     }
 }
 
@@ -582,6 +697,12 @@ void SkBitmapDevice::drawVertices(const SkVertices* vertices, const SkVertices::
                               vertices->indexCount(), paint, bones, boneCount);
 }
 
+void SkBitmapDevice::drawAtlas(const SkImage* atlas, const SkRSXform xform[],
+                               const SkRect tex[], const SkColor colors[], int count,
+                               SkBlendMode mode, const SkPaint& paint) {
+    BDDraw(this).drawAtlas(atlas, xform, tex, colors, count, mode, paint);
+}
+
 void SkBitmapDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& origPaint) {
     SkASSERT(!origPaint.getImageFilter());
 
@@ -593,6 +714,8 @@ void SkBitmapDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPain
 
     // hack to test coverage
     SkBitmapDevice* src = static_cast<SkBitmapDevice*>(device);
+    src->flushPathBatch();
+    this->flushPathBatch();
     if (src->fCoverage) {
         SkDraw draw;
         draw.fDst = fBitmap.pixmap();
@@ -632,8 +755,50 @@ private:
     const SkMatrix fPrevCTM;
 };
 
+// The result of filtering one tile of the clip.
+struct FilteredTile {
+    SkIRect               fTile;
+    sk_sp<SkSpecialImage> fImage;
+    SkIPoint              fOffset;
+};
+
 }  // anonymous ns
 
+// Filters the clip one tile at a time on the default executor. Nodes shared within the DAG are
+// still only filtered once per tile, through a cache of the tile's own. Returns false, having
+// done nothing, if the clip is small enough or the filter has to see all of it at once.
+static bool filter_in_tiles(const SkImageFilter* filter, SkSpecialImage* src,
+                            const SkImageFilter::Context& ctx, int tileSize,
+                            SkTArray<FilteredTile>* tiles) {
+    const SkIRect& clip = ctx.clipBounds();
+    if (tileSize <= 0 || (clip.width() <= tileSize && clip.height() <= tileSize) ||
+        !filter->canFilterInTiles()) {
+        return false;
+    }
+
+    for (int top = clip.fTop; top < clip.fBottom; top += tileSize) {
+        for (int left = clip.fLeft; left < clip.fRight; left += tileSize) {
+            tiles->push_back().fTile = SkIRect::MakeLTRB(left, top,
+                                                         SkTMin(left + tileSize, clip.fRight),
+                                                         SkTMin(top + tileSize, clip.fBottom));
+        }
+    }
+
+    SkTaskGroup group;
+    group.batch(tiles->count(), [&](int i) {
+        FilteredTile& tile = (*tiles)[i];
+        // A tile's intermediates are no use to any other tile, so they don't need to outlive it.
+        sk_sp<SkImageFilterCache> cache(
+                SkImageFilterCache::Create(SkImageFilterCache::kDefaultTransientSize));
+        SkImageFilter::Context tileCtx(ctx.ctm(), tile.fTile, cache.get(),
+                                       ctx.outputProperties());
+        tile.fOffset = SkIPoint::Make(0, 0);
+        tile.fImage = filter->filterImage(src, tileCtx, &tile.fOffset);
+    });
+    group.wait();
+    return true;
+}
+
 void SkBitmapDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPaint& origPaint,
                                  SkImage* clipImage, const SkMatrix& clipMatrix) {
     SkASSERT(!src->isTextureBacked());
@@ -650,6 +815,26 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPain
         SkImageFilter::OutputProperties outputProperties(fBitmap.colorType(), fBitmap.colorSpace());
         SkImageFilter::Context ctx(matrix, clipBounds, cache.get(), outputProperties);
 
+        SkSTArray<16, FilteredTile> tiles;
+        if (!clipImage && !paint->getMaskFilter() &&
+                filter_in_tiles(filter, src, ctx, fImageFilterTileSize, &tiles)) {
+            paint.writable()->setImageFilter(nullptr);
+            for (const FilteredTile& tile : tiles) {
+                SkBitmap resultBM, tileBM;
+                if (!tile.fImage || !tile.fImage->getROPixels(&resultBM)) {
+                    continue;
+                }
+                // Each tile only draws its own pixels, even if its filters returned more.
+                SkIRect subset = tile.fTile.makeOffset(-tile.fOffset.x(), -tile.fOffset.y());
+                if (subset.intersect(resultBM.bounds()) &&
+                        resultBM.extractSubset(&tileBM, subset)) {
+                    this->drawSprite(tileBM, x + tile.fOffset.x() + subset.x(),
+                                     y + tile.fOffset.y() + subset.y(), *paint);
+                }
+            }
+            return;
+        }
+
         filteredImage = filter->filterImage(src, ctx, &offset);
         if (!filteredImage) {
             return;
@@ -736,6 +921,7 @@ sk_sp<SkSpecialImage> SkBitmapDevice::makeSpecial(const SkImage* image) {
 }
 
 sk_sp<SkSpecialImage> SkBitmapDevice::snapSpecial() {
+    this->flushPathBatch();
     return this->makeSpecial(fBitmap);
 }
 
@@ -58,6 +58,8 @@ public:
     SkBitmapDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
                    void* externalHandle, const SkBitmap* coverage);
 
+    ~SkBitmapDevice() override;
+
     static SkBitmapDevice* Create(const SkImageInfo&, const SkSurfaceProps&,
                                   bool trackCoverage,
                                   SkRasterHandleAllocator*);
@@ -70,6 +72,15 @@ public:
         return fCoverage ? &fCoverage->pixmap() : nullptr;
     }
 
+    void flush() override;
+
+    /**
+     *  Image filters see clips larger than this in tiles of this size, so that their intermediate
+     *  images stay small and the tiles can be filtered in parallel. 0 filters every clip in one
+     *  piece. Layers made by this device inherit it. Defaults to 512; meant for testing.
+     */
+    void setImageFilterTileSize(int size) { fImageFilterTileSize = size; }
+
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
 
@@ -104,6 +115,8 @@ protected:
     void drawGlyphRunList(const SkGlyphRunList& glyphRunList) override;
     void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount, SkBlendMode,
                       const SkPaint& paint) override;
+    void drawAtlas(const SkImage*, const SkRSXform[], const SkRect[], const SkColor[], int count,
+                   SkBlendMode, const SkPaint&) override;
     void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -144,8 +157,16 @@ private:
     friend class SkDrawIter;
     friend class SkDrawTiler;
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice; // to copy fRCStack
 
     class BDDraw;
+    struct PathBatch;
+
+    // With SkSurfaceProps::kBatchRasterPathFills_Flag, drawPath() appends fills that share the
+    // paint (and clip) of the previous ones, and don't overlap them, to fPathBatch. The batch is
+    // then scan converted and blitted once, before anything else draws or reads the pixels.
+    bool tryBatchPath(const SkPath&, const SkPaint&);
+    void flushPathBatch();
 
     // used to change the backend's pixels (and possibly config/rowbytes)
     // but cannot change the width/height, so there should be no change to
@@ -163,6 +184,8 @@ private:
     SkRasterClipStack  fRCStack;
     std::unique_ptr<SkBitmap> fCoverage;    // if non-null, will have the same dimensions as fBitmap
     SkGlyphRunListPainter fGlyphPainter;
+    std::unique_ptr<PathBatch> fPathBatch;
+    int         fImageFilterTileSize = 512;
 
 
     typedef SkBaseDevice INHERITED;
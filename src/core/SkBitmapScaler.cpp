@@ -0,0 +1,202 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapScaler.h"
+
+#include "SkColorSpace.h"
+#include "SkFloatingPoint.h"
+#include "SkNx.h"
+#include "SkScalar.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
+
+/*  The resize is done in two passes: each source row is filtered horizontally to the
+    destination width, then destination rows are filtered vertically from those.  The
+    horizontally filtered rows live in a small ring buffer, so each source row is converted
+    and filtered only once.  Large resizes are split into bands of destination rows which run
+    in parallel; each band just refilters the few source rows it shares with its neighbors.
+ */
+
+namespace {
+
+float mitchell(float x) {
+    constexpr float B = 1/3.0f,
+                    C = 1/3.0f;
+    x = sk_float_abs(x);
+    if (x < 1) {
+        return ((12 - 9*B - 6*C) * x*x*x + (-18 + 12*B + 6*C) * x*x + (6 - 2*B)) * (1/6.0f);
+    }
+    if (x < 2) {
+        return ((-B - 6*C) * x*x*x + (6*B + 30*C) * x*x + (-12*B - 48*C) * x + (8*B + 24*C))
+               * (1/6.0f);
+    }
+    return 0;
+}
+
+float sinc(float x) {
+    if (sk_float_abs(x) < 1e-6f) {
+        return 1;
+    }
+    x *= SK_ScalarPI;
+    return sk_float_sin(x) / x;
+}
+
+float lanczos3(float x) {
+    return sk_float_abs(x) < 3 ? sinc(x) * sinc(x / 3) : 0;
+}
+
+// The taps of a 1-D resize from srcLen to dstLen pixels: destination pixel i is the sum of
+// fWeights[fOffset[i] + j] * src[fFirst[i] + j] for j in [0, fCount[i]).
+struct Filter1D {
+    SkTArray<int>   fFirst, fCount, fOffset;
+    SkTArray<float> fWeights;
+    int             fMaxCount = 0;
+
+    Filter1D(int srcLen, int dstLen, float (*kernel)(float), float support) {
+        // When shrinking, stretch the kernel to cover all the source pixels under each
+        // destination pixel.  When growing, it's plain interpolation.
+        const float scale   = (float)dstLen / srcLen,
+                    stretch = SkTMin(scale, 1.0f),
+                    radius  = support / stretch;
+
+        for (int i = 0; i < dstLen; i++) {
+            // The center of destination pixel i, in source pixel coordinates.
+            const float center = (i + 0.5f) / scale;
+            int first = SkTMax(0,      (int)sk_float_floor(center - radius)),
+                last  = SkTMin(srcLen, (int)sk_float_ceil (center + radius));
+
+            const int offset = fWeights.count();
+            float sum = 0;
+            for (int s = first; s < last; s++) {
+                float w = kernel((s + 0.5f - center) * stretch);
+                fWeights.push_back(w);
+                sum += w;
+            }
+
+            // Taps past the edge are dropped, which is like clamping but weighs the edge pixel
+            // less; renormalize so flat areas stay flat.  Then trim taps that add nothing.
+            int count = last - first;
+            float* w = fWeights.begin() + offset;
+            for (int j = 0; j < count; j++) {
+                w[j] = sum != 0 ? w[j] / sum : (j == 0 ? 1.0f : 0.0f);
+            }
+            while (count > 1 && w[count - 1] == 0) {
+                count--;
+            }
+            int lead = 0;
+            while (lead < count - 1 && w[lead] == 0) {
+                lead++;
+            }
+
+            fFirst .push_back(first + lead);
+            fCount .push_back(count - lead);
+            fOffset.push_back(offset + lead);
+            fMaxCount = SkTMax(fMaxCount, count - lead);
+        }
+    }
+};
+
+// Bands have at least this many source pixels; resizes with twice this many are split up.
+static constexpr int kMinPixelsPerBand = 256 * 1024;
+
+}  // namespace
+
+bool SkBitmapScaler::Resize(const SkPixmap& dst, const SkPixmap& src, ResizeMethod method) {
+    if (src.colorType() != dst.colorType() ||
+        (src.colorType() != kRGBA_8888_SkColorType && src.colorType() != kBGRA_8888_SkColorType)) {
+        return false;
+    }
+    if (dst.colorSpace() && !SkColorSpace::Equals(src.colorSpace(), dst.colorSpace())) {
+        return false;
+    }
+    const bool srcUnpremul = src.alphaType() == kUnpremul_SkAlphaType,
+               dstUnpremul = dst.alphaType() == kUnpremul_SkAlphaType;
+    if (srcUnpremul != dstUnpremul ||
+        src.width() <= 0 || src.height() <= 0 || dst.width() <= 0 || dst.height() <= 0 ||
+        !src.addr() || !dst.addr()) {
+        return false;
+    }
+
+    float (*kernel)(float) = mitchell;
+    float support = 2;
+    if (method == kLanczos3_ResizeMethod) {
+        kernel  = lanczos3;
+        support = 3;
+    }
+    const Filter1D fx(src.width(),  dst.width(),  kernel, support),
+                   fy(src.height(), dst.height(), kernel, support);
+
+    const int dstW = dst.width();
+    auto rows = [&](int top, int bottom) {
+        // Source rows are converted to floats once, then filtered horizontally into a ring of
+        // fy.fMaxCount rows.  Destination rows only ever move down the source, so a row in the
+        // ring is never needed again once it's overwritten.
+        const int ringRows = fy.fMaxCount;
+        SkAutoTMalloc<Sk4f> srcRow(src.width()),
+                            ring  (ringRows * dstW),
+                            accum (dstW);
+        int next = fy.fFirst[top];
+
+        for (int y = top; y < bottom; y++) {
+            const int first = fy.fFirst[y],
+                      count = fy.fCount[y];
+            next = SkTMax(next, first);
+            for (; next < first + count; next++) {
+                const uint32_t* px = src.addr32(0, next);
+                for (int x = 0; x < src.width(); x++) {
+                    srcRow[x] = SkNx_cast<float>(Sk4b::Load(px + x));
+                }
+                Sk4f* out = ring.get() + (next % ringRows) * dstW;
+                for (int x = 0; x < dstW; x++) {
+                    const Sk4f*  s = srcRow.get() + fx.fFirst[x];
+                    const float* w = fx.fWeights.begin() + fx.fOffset[x];
+                    Sk4f sum = s[0] * w[0];
+                    for (int j = 1; j < fx.fCount[x]; j++) {
+                        sum = sum + s[j] * w[j];
+                    }
+                    out[x] = sum;
+                }
+            }
+
+            const float* w = fy.fWeights.begin() + fy.fOffset[y];
+            for (int j = 0; j < count; j++) {
+                const Sk4f* in = ring.get() + ((first + j) % ringRows) * dstW;
+                if (j == 0) {
+                    for (int x = 0; x < dstW; x++) { accum[x] = in[x] * w[0]; }
+                } else {
+                    for (int x = 0; x < dstW; x++) { accum[x] = accum[x] + in[x] * w[j]; }
+                }
+            }
+
+            // The kernels have negative lobes, so results may overshoot.  Premul colors are
+            // kept no larger than their alpha; both 8888 formats keep alpha last.
+            uint32_t* out = dst.writable_addr32(0, y);
+            for (int x = 0; x < dstW; x++) {
+                Sk4f v = Sk4f::Min(Sk4f::Max(accum[x], 0.0f), 255.0f);
+                if (!dstUnpremul) {
+                    v = Sk4f::Min(v, v[3]);
+                }
+                SkNx_cast<uint8_t>(Sk4f_round(v)).store(out + x);
+            }
+        }
+    };
+
+    const int64_t pixels = src.width() * (int64_t)src.height();
+    const int maxBands = (int)SkTMin<int64_t>(pixels / kMinPixelsPerBand, dst.height());
+    if (maxBands <= 1) {
+        rows(0, dst.height());
+        return true;
+    }
+    const int rowsPerBand = (dst.height() + maxBands - 1) / maxBands,
+              bands       = (dst.height() + rowsPerBand - 1) / rowsPerBand;
+    SkTaskGroup().batch(bands, [&](int i) {
+        int top = i * rowsPerBand;
+        rows(top, SkTMin(top + rowsPerBand, dst.height()));
+    });
+    return true;
+}
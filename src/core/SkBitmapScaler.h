@@ -0,0 +1,36 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapScaler_DEFINED
+#define SkBitmapScaler_DEFINED
+
+#include "SkPixmap.h"
+
+/** \class SkBitmapScaler
+
+    Resizes 8888 pixels with a separable filter whose support is stretched by the scale
+    factor, so every source pixel contributes to the result however large the reduction.
+    Drawing with a bicubic shader instead samples a fixed 4x4 neighborhood, which aliases
+    for large downscales unless mipmaps are built first.
+*/
+class SkBitmapScaler {
+public:
+    enum ResizeMethod {
+        kMitchell_ResizeMethod,     //!< cubic with B = C = 1/3, support 2
+        kLanczos3_ResizeMethod,     //!< windowed sinc, support 3; sharper, may ring
+    };
+
+    /**
+     *  Resizes src into dst, returning false (leaving dst untouched) if the pixmaps aren't
+     *  supported: both must be the same 8888 color type, in the same color space, and src may
+     *  not be unpremul unless dst is too.  Unpremul pixels are filtered as they are and
+     *  clamped to [0,255] instead of to alpha.
+     */
+    static bool Resize(const SkPixmap& dst, const SkPixmap& src, ResizeMethod method);
+};
+
+#endif
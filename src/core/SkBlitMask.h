@@ -12,6 +12,8 @@
 #include "SkMask.h"
 #include "SkPixmap.h"
 
+class SkBlitter;
+
 class SkBlitMask {
 public:
     /**
@@ -21,6 +23,13 @@ public:
     static bool BlitColor(const SkPixmap& device, const SkMask& mask,
                           const SkIRect& clip, SkColor color);
 
+    /**
+     *  Like BlitColor(), for a batch of masks drawn in the same color, picking the blit procs
+     *  once for all of them. Masks that BlitColor() doesn't support go to fallback->blitMask().
+     */
+    static void BlitColors(const SkPixmap& device, const SkMask masks[], const SkIRect clips[],
+                           int count, SkColor color, SkBlitter* fallback);
+
     /**
      *  Function pointer that blits the mask into a device (dst) colorized
      *  by color. The number of pixels to blit is specified by width and height,
@@ -7,6 +7,7 @@
 
 #include "Sk4px.h"
 #include "SkBlitMask.h"
+#include "SkBlitter.h"
 #include "SkColor.h"
 #include "SkColorData.h"
 #include "SkOpts.h"
@@ -74,6 +75,44 @@ bool SkBlitMask::BlitColor(const SkPixmap& device, const SkMask& mask,
     return false;
 }
 
+void SkBlitMask::BlitColors(const SkPixmap& device, const SkMask masks[], const SkIRect clips[],
+                            int count, SkColor color, SkBlitter* fallback) {
+    if (device.colorType() != kN32_SkColorType) {
+        fallback->SkBlitter::blitMasks(masks, clips, count);
+        return;
+    }
+
+    const bool isOpaque = 0xFF == SkColorGetA(color);
+    const SkPMColor opaqueDst = isOpaque ? SkPreMultiplyColor(color) : 0;
+    BlitLCD16RowProc lcdProc = nullptr;     // only looked up if we see an LCD16 mask
+
+    for (int i = 0; i < count; ++i) {
+        const SkMask& mask = masks[i];
+        const SkIRect& clip = clips[i];
+        SkASSERT(mask.fBounds.contains(clip));
+        const int x = clip.fLeft, y = clip.fTop;
+
+        if (mask.fFormat == SkMask::kA8_Format) {
+            SkOpts::blit_mask_d32_a8(device.writable_addr32(x,y), device.rowBytes(),
+                                     (const SkAlpha*)mask.getAddr(x,y), mask.fRowBytes,
+                                     color, clip.width(), clip.height());
+        } else if (mask.fFormat == SkMask::kLCD16_Format) {
+            if (!lcdProc) {
+                lcdProc = BlitLCD16RowFactory(isOpaque);
+            }
+            SkPMColor*      dstRow = device.writable_addr32(x,y);
+            const uint16_t* srcRow = mask.getAddrLCD16(x,y);
+            for (int h = clip.height(); h > 0; --h) {
+                lcdProc(dstRow, srcRow, color, clip.width(), opaqueDst);
+                dstRow = (SkPMColor*)((char*)dstRow + device.rowBytes());
+                srcRow = (const uint16_t*)((const char*)srcRow + mask.fRowBytes);
+            }
+        } else {
+            fallback->blitMask(mask, clip);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 static void A8_RowProc_Blend(
@@ -11,9 +11,12 @@
 #include "SkArenaAlloc.h"
 #include "SkColor.h"
 #include "SkColorFilter.h"
+#include "SkImage.h"
 #include "SkMask.h"
 #include "SkMaskFilterBase.h"
+#include "SkOpts.h"
 #include "SkPaintPriv.h"
+#include "SkRasterPipeline.h"
 #include "SkReadBuffer.h"
 #include "SkRegionPriv.h"
 #include "SkShaderBase.h"
@@ -379,6 +382,12 @@ void SkBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
 
 /////////////////////// these guys are not virtual, just a helpers
 
+void SkBlitter::blitMasks(const SkMask masks[], const SkIRect clips[], int count) {
+    for (int i = 0; i < count; ++i) {
+        this->blitMask(masks[i], clips[i]);
+    }
+}
+
 void SkBlitter::blitMaskRegion(const SkMask& mask, const SkRegion& clip) {
     if (clip.quickReject(mask.fBounds)) {
         return;
@@ -926,6 +935,29 @@ private:
 // hack for testing, not to be exposed to clients
 bool gSkForceRasterPipelineBlitter;
 
+#ifndef SK_SUPPORT_LEGACY_IMAGESHADER_BLITTER
+// SkImageShader samples clamped 8888 images nearest or bilinear entirely in lowp stages, which
+// keeps up with SkBitmapProcState's matrix and sample procs.  Builds without lowp stages (not
+// compiled by Clang) would fall back to highp floats, so they keep using the legacy procs.
+static bool image_shader_runs_in_lowp(const SkPaint& paint) {
+    SkShader* shader = paint.getShader();
+    SkShader::TileMode tileModes[2];
+    SkImage* image = shader ? shader->isAImage(nullptr, tileModes) : nullptr;
+    if (!image) {
+        return false;
+    }
+    if (tileModes[0] != SkShader::kClamp_TileMode || tileModes[1] != SkShader::kClamp_TileMode) {
+        return false;
+    }
+    if (image->colorType() != kRGBA_8888_SkColorType &&
+        image->colorType() != kBGRA_8888_SkColorType) {
+        return false;
+    }
+    return SkOpts::stages_lowp[SkRasterPipeline::gather_8888      ] &&
+           SkOpts::stages_lowp[SkRasterPipeline::bilerp_clamp_8888];
+}
+#endif
+
 bool SkBlitter::UseRasterPipelineBlitter(const SkPixmap& device, const SkPaint& paint,
                                          const SkMatrix& matrix) {
     if (gSkForceRasterPipelineBlitter) {
@@ -960,6 +992,12 @@ bool SkBlitter::UseRasterPipelineBlitter(const SkPixmap& device, const SkPaint&
         return false;
     }
 
+#ifndef SK_SUPPORT_LEGACY_IMAGESHADER_BLITTER
+    if (image_shader_runs_in_lowp(paint)) {
+        return true;
+    }
+#endif
+
     return device.colorType() != kN32_SkColorType;
 #endif
 }
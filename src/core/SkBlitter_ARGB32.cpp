@@ -186,6 +186,15 @@ void SkARGB32_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
     }
 }
 
+void SkARGB32_Blitter::blitMasks(const SkMask masks[], const SkIRect clips[], int count) {
+    if (fSrcA == 0) {
+        return;
+    }
+    // A8 and LCD16 masks are blitted straight from the batch; anything else comes back to us
+    // through the (virtual) blitMask().
+    SkBlitMask::BlitColors(fDevice, masks, clips, count, fColor, this);
+}
+
 void SkARGB32_Opaque_Blitter::blitMask(const SkMask& mask,
                                        const SkIRect& clip) {
     SkASSERT(mask.fBounds.contains(clip));
@@ -25,6 +25,7 @@
 #include "SkLatticeIter.h"
 #include "SkMSAN.h"
 #include "SkMakeUnique.h"
+#include "SkMaskFilterBase.h"
 #include "SkMatrixUtils.h"
 #include "SkMetaData.h"
 #include "SkNoDrawCanvas.h"
@@ -39,6 +40,7 @@
 #include "SkSpecialImage.h"
 #include "SkStrikeCache.h"
 #include "SkString.h"
+#include "SkStrokeRec.h"
 #include "SkSurface_Base.h"
 #include "SkTLazy.h"
 #include "SkTextBlob.h"
@@ -229,12 +231,16 @@ public:
     SkConservativeClip  fRasterClip;
     SkMatrix            fMatrix;
     int                 fDeferredSaveCount;
+    // Whether the devices have saved their clips for this level. They only need to once something
+    // clips at this level (see checkForDeferredDeviceSave()).
+    bool                fDevicesSaved;
 
     MCRec() {
         fLayer      = nullptr;
         fTopLayer   = nullptr;
         fMatrix.reset();
         fDeferredSaveCount = 0;
+        fDevicesSaved = true;   // the bottom level is never restored
 
         // don't bother initializing fNext
         inc_rec();
@@ -243,6 +249,7 @@ public:
         fLayer = nullptr;
         fTopLayer = prev.fTopLayer;
         fDeferredSaveCount = 0;
+        fDevicesSaved = false;
 
         // don't bother initializing fNext
         inc_rec();
@@ -349,13 +356,32 @@ static sk_sp<SkColorFilter> image_to_color_filter(const SkPaint& paint) {
 static const SkRect& apply_paint_to_bounds_sans_imagefilter(const SkPaint& paint,
                                                             const SkRect& rawBounds,
                                                             SkRect* storage) {
-    SkPaint tmpUnfiltered(paint);
-    tmpUnfiltered.setImageFilter(nullptr);
-    if (tmpUnfiltered.canComputeFastBounds()) {
-        return tmpUnfiltered.computeFastBounds(rawBounds, storage);
-    } else {
+    if (paint.getLooper()) {
+        // The looper sees the whole paint, so hand it one without the imagefilter.
+        SkPaint tmpUnfiltered(paint);
+        tmpUnfiltered.setImageFilter(nullptr);
+        if (tmpUnfiltered.canComputeFastBounds()) {
+            return tmpUnfiltered.computeFastBounds(rawBounds, storage);
+        } else {
+            return rawBounds;
+        }
+    }
+
+    // Otherwise this is SkPaint::doComputeFastBounds() minus the imagefilter, which saves copying
+    // (and ref'ing every effect of) the paint on each filtered draw.
+    const SkRect* src = &rawBounds;
+    if (paint.getPathEffect()) {
+        paint.getPathEffect()->computeFastBounds(storage, rawBounds);
+        src = storage;
+    } else if (SkPaint::kFill_Style == paint.getStyle() && !paint.getMaskFilter()) {
         return rawBounds;
     }
+    SkScalar radius = SkStrokeRec::GetInflationRadius(paint, paint.getStyle());
+    *storage = src->makeOutset(radius, radius);
+    if (paint.getMaskFilter()) {
+        as_MFB(paint.getMaskFilter())->computeFastBounds(*storage, storage);
+    }
+    return *storage;
 }
 
 class AutoDrawLooper {
@@ -760,6 +786,18 @@ void SkCanvas::checkForDeferredSave() {
     }
 }
 
+/*
+ *  A save that is resolved because the matrix changed (save/translate/draw/restore) leaves the
+ *  devices alone: their clips are unchanged, and restoring just resets their CTM. The devices
+ *  save their clips the first time something clips at this level.
+ */
+void SkCanvas::checkForDeferredDeviceSave() {
+    if (!fMCRec->fDevicesSaved) {
+        fMCRec->fDevicesSaved = true;
+        FOR_EACH_TOP_DEVICE(device->save());
+    }
+}
+
 int SkCanvas::getSaveCount() const {
 #ifdef SK_DEBUG
     int count = 0;
@@ -823,8 +861,6 @@ void SkCanvas::internalSave() {
     MCRec* newTop = (MCRec*)fMCStack.push_back();
     new (newTop) MCRec(*fMCRec);    // balanced in restore()
     fMCRec = newTop;
-
-    FOR_EACH_TOP_DEVICE(device->save());
 }
 
 bool SkCanvas::BoundsAffectsClip(SaveLayerFlags saveLayerFlags) {
@@ -1006,6 +1042,7 @@ void SkCanvas::internalSaveLayer(const SaveLayerRec& rec, SaveLayerStrategy stra
     // do this before we create the layer. We don't call the public save() since
     // that would invoke a possibly overridden virtual
     this->internalSave();
+    this->checkForDeferredDeviceSave();
 
     SkIRect ir;
     if (!this->clipRectBounds(bounds, saveLayerFlags, &ir, imageFilter)) {
@@ -1098,6 +1135,7 @@ void SkCanvas::internalRestore() {
     DeviceCM* layer = fMCRec->fLayer;   // may be null
     // now detach it from fMCRec so we can pop(). Gets freed after its drawn
     fMCRec->fLayer = nullptr;
+    const bool devicesSaved = fMCRec->fDevicesSaved;
 
     // now do the normal restore()
     fMCRec->~MCRec();       // balanced in save()
@@ -1105,7 +1143,11 @@ void SkCanvas::internalRestore() {
     fMCRec = (MCRec*)fMCStack.back();
 
     if (fMCRec) {
-        FOR_EACH_TOP_DEVICE(device->restore(fMCRec->fMatrix));
+        if (devicesSaved) {
+            FOR_EACH_TOP_DEVICE(device->restore(fMCRec->fMatrix));
+        } else {
+            FOR_EACH_TOP_DEVICE(device->setGlobalCTM(fMCRec->fMatrix));
+        }
     }
 
     /*  Time to draw the layer's offscreen. We can't call the public drawSprite,
@@ -1324,6 +1366,7 @@ void SkCanvas::clipRect(const SkRect& rect, SkClipOp op, bool doAA) {
 void SkCanvas::onClipRect(const SkRect& rect, SkClipOp op, ClipEdgeStyle edgeStyle) {
     const bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipRect(rect, op, isAA));
 
     AutoValidateClip avc(this);
@@ -1340,6 +1383,7 @@ void SkCanvas::androidFramework_setDeviceClipRestriction(const SkIRect& rect) {
         FOR_EACH_TOP_DEVICE(device->androidFramework_setDeviceClipRestriction(&fClipRestrictionRect));
     } else {
         this->checkForDeferredSave();
+        this->checkForDeferredDeviceSave();
         FOR_EACH_TOP_DEVICE(device->androidFramework_setDeviceClipRestriction(&fClipRestrictionRect));
         AutoValidateClip avc(this);
         fMCRec->fRasterClip.opIRect(fClipRestrictionRect, SkRegion::kIntersect_Op);
@@ -1362,6 +1406,7 @@ void SkCanvas::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle edge
 
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipRRect(rrect, op, isAA));
 
     fMCRec->fRasterClip.opRRect(rrect, fMCRec->fMatrix, this->getTopLayerBounds(), (SkRegion::Op)op,
@@ -1399,6 +1444,7 @@ void SkCanvas::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeSty
 
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipPath(path, op, isAA));
 
     const SkPath* rasterClipPath = &path;
@@ -1414,6 +1460,7 @@ void SkCanvas::clipRegion(const SkRegion& rgn, SkClipOp op) {
 }
 
 void SkCanvas::onClipRegion(const SkRegion& rgn, SkClipOp op) {
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipRegion(rgn, op));
 
     AutoValidateClip avc(this);
@@ -2653,14 +2700,14 @@ void SkCanvas::onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], const
         return;
     }
 
-    SkPaint pnt;
-    if (paint) {
-        pnt = *paint;
+    SkLazyPaint lazy;
+    if (nullptr == paint) {
+        paint = lazy.init();
     }
 
-    LOOPER_BEGIN(pnt, nullptr)
+    LOOPER_BEGIN(*paint, nullptr)
     while (iter.next()) {
-        iter.fDevice->drawAtlas(atlas, xform, tex, colors, count, bmode, pnt);
+        iter.fDevice->drawAtlas(atlas, xform, tex, colors, count, bmode, *paint);
     }
     LOOPER_END
 }
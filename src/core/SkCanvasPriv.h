@@ -40,6 +40,10 @@ public:
 
     static SkCanvas::SaveLayerFlags LegacySaveFlagsToSaveLayerFlags(uint32_t legacySaveFlags);
 
+    // Call before writing to the canvas' pixels through some other canvas, so a surface that
+    // owns them can copy them for any outstanding snapshot first.
+    static void WillDrawDirectly(SkCanvas* canvas) { canvas->predrawNotify(); }
+
 };
 
 #endif
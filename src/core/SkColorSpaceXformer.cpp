@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapCache.h"
 #include "SkColorFilter.h"
 #include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformer.h"
@@ -14,6 +15,7 @@
 #include "SkImage_Base.h"
 #include "SkImageFilter.h"
 #include "SkImagePriv.h"
+#include "SkResourceCache.h"
 #include "SkShaderBase.h"
 
 SkColorSpaceXformer::SkColorSpaceXformer(sk_sp<SkColorSpace> dst)
@@ -95,11 +97,78 @@ void SkColorSpaceXformer::purgeCaches() {
     fImageFilterCache.reset();
 }
 
+// Converting a raster image copies all of its pixels, and SkColorSpaceXformCanvas does it every
+// time the image is drawn.  So the converted copies also live in SkResourceCache, keyed by the
+// source image and the destination color space, and are purged along with the source image.
+namespace {
+static unsigned gXformedImageKeyNamespaceLabel;
+
+struct XformedImageKey : public SkResourceCache::Key {
+    XformedImageKey(uint32_t imageID, uint64_t colorSpaceHash)
+        : fImageID(imageID)
+        , fColorSpaceHashLo((uint32_t)colorSpaceHash)
+        , fColorSpaceHashHi((uint32_t)(colorSpaceHash >> 32)) {
+        this->init(&gXformedImageKeyNamespaceLabel, SkMakeResourceCacheSharedIDForBitmap(imageID),
+                   sizeof(fImageID) + sizeof(fColorSpaceHashLo) + sizeof(fColorSpaceHashHi));
+    }
+
+    uint32_t fImageID;
+    uint32_t fColorSpaceHashLo;
+    uint32_t fColorSpaceHashHi;
+};
+
+struct XformedImageRec : public SkResourceCache::Rec {
+    XformedImageRec(const XformedImageKey& key, sk_sp<SkImage> image)
+        : fKey(key)
+        , fImage(std::move(image)) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        // Lazy images only hold on to their generator; their pixels are cached elsewhere.
+        if (fImage->isLazyGenerated()) {
+            return sizeof(*this);
+        }
+        return sizeof(*this) + as_IB(fImage)->onImageInfo().computeMinByteSize();
+    }
+    const char* getCategory() const override { return "xformed-image"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextImage) {
+        const XformedImageRec& rec = static_cast<const XformedImageRec&>(baseRec);
+        *static_cast<sk_sp<SkImage>*>(contextImage) = rec.fImage;
+        return true;
+    }
+
+    XformedImageKey fKey;
+    sk_sp<SkImage>  fImage;
+};
+}  // namespace
+
+static sk_sp<SkImage> make_color_space(const SkImage* src, SkColorSpace* dst) {
+    // Texture-backed images are converted on the GPU, and are cached there.
+    if (src->isTextureBacked()) {
+        return src->makeColorSpace(sk_ref_sp(dst));
+    }
+
+    XformedImageKey key(src->uniqueID(), dst->hash());
+    sk_sp<SkImage> xformed;
+    if (SkResourceCache::Find(key, XformedImageRec::Visitor, &xformed)) {
+        return xformed;
+    }
+
+    xformed = src->makeColorSpace(sk_ref_sp(dst));
+    if (xformed && xformed.get() != src) {
+        SkResourceCache::Add(new XformedImageRec(key, xformed));
+        as_IB(src)->notifyAddedToRasterCache();
+    }
+    return xformed;
+}
+
 sk_sp<SkImage> SkColorSpaceXformer::apply(const SkImage* src) {
     const AutoCachePurge autoPurge(this);
     return this->cachedApply<SkImage>(src, &fImageCache,
         [](const SkImage* img, SkColorSpaceXformer* xformer) {
-            return img->makeColorSpace(xformer->fDst);
+            return make_color_space(img, xformer->fDst.get());
         });
 }
 
@@ -13,6 +13,7 @@
 #include "SkImageInfoPriv.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkTaskGroup.h"
 #include "SkUnPreMultiply.h"
 #include "SkUnPreMultiplyPriv.h"
 #include "../jumper/SkJumper.h"
@@ -166,9 +167,11 @@ static bool convert_to_alpha8(const SkImageInfo& dstInfo,       void* vdst, size
 }
 
 // Default: Use the pipeline.
+// With more than one band, bands of rowsPerBand rows run in parallel.
 static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size_t dstRB,
                                   const SkImageInfo& srcInfo, const void* srcRow, size_t srcRB,
-                                  const SkColorSpaceXformSteps& steps) {
+                                  const SkColorSpaceXformSteps& steps,
+                                  int bands = 1, int rowsPerBand = 0) {
 
     SkJumper_MemoryCtx src = { (void*)srcRow, (int)(srcRB / srcInfo.bytesPerPixel()) },
                        dst = { (void*)dstRow, (int)(dstRB / dstInfo.bytesPerPixel()) };
@@ -193,9 +196,23 @@ static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size
     }
 
     pipeline.append_store(dstInfo.colorType(), &dst);
-    pipeline.run(0,0, srcInfo.width(), srcInfo.height());
+    if (bands <= 1) {
+        pipeline.run(0,0, srcInfo.width(), srcInfo.height());
+        return;
+    }
+
+    // Bands keep their real y, so each dithers just as it would in one big run.
+    auto run = pipeline.compile();
+    SkTaskGroup().batch(bands, [&](int i) {
+        int y = i * rowsPerBand;
+        run(0,y, srcInfo.width(), SkTMin(rowsPerBand, srcInfo.height() - y));
+    });
 }
 
+// Conversions of at least twice this many pixels are split into bands of rows, which run as
+// tasks on the default SkExecutor.
+static constexpr int kMinPixelsPerBand = 256 * 1024;
+
 void SkConvertPixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
                      const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB) {
     SkASSERT(dstInfo.dimensions() == srcInfo.dimensions());
@@ -204,10 +221,41 @@ void SkConvertPixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t d
     SkColorSpaceXformSteps steps{srcInfo.colorSpace(), srcInfo.alphaType(),
                                  dstInfo.colorSpace(), dstInfo.alphaType()};
 
-    for (auto fn : {rect_memcpy, swizzle_and_multiply, convert_to_alpha8}) {
-        if (fn(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps)) {
+    using ConvertFn = decltype(rect_memcpy);
+    ConvertFn* fns[] = {rect_memcpy, swizzle_and_multiply, convert_to_alpha8};
+
+    const int64_t pixels = sk_64_mul(srcInfo.width(), srcInfo.height());
+    const int maxBands = (int)SkTMin<int64_t>(pixels / kMinPixelsPerBand, srcInfo.height());
+    if (maxBands <= 1) {
+        for (auto fn : fns) {
+            if (fn(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps)) {
+                return;
+            }
+        }
+        convert_with_pipeline(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps);
+        return;
+    }
+
+    const int rowsPerBand = (srcInfo.height() + maxBands - 1) / maxBands,
+              bands       = (srcInfo.height() + rowsPerBand - 1) / rowsPerBand;
+    auto convert_band = [&](ConvertFn* fn, int i) {
+        int y    = i * rowsPerBand,
+            rows = SkTMin(rowsPerBand, srcInfo.height() - y);
+        return fn(dstInfo.makeWH(dstInfo.width(), rows),
+                  SkTAddOffset<void>(dstPixels, dstRB * y), dstRB,
+                  srcInfo.makeWH(srcInfo.width(), rows),
+                  SkTAddOffset<const void>(srcPixels, srcRB * y), srcRB,
+                  steps);
+    };
+
+    // The fast paths don't care where a row is, so each band converts as its own short image.
+    // Whichever path takes the first band takes them all.
+    for (ConvertFn* fn : fns) {
+        if (convert_band(fn, 0)) {
+            SkTaskGroup().batch(bands - 1, [&](int i) { convert_band(fn, i + 1); });
             return;
         }
     }
-    convert_with_pipeline(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps);
+    convert_with_pipeline(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps,
+                          bands, rowsPerBand);
 }
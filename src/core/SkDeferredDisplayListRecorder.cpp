@@ -7,9 +7,13 @@
 
 #include "SkDeferredDisplayListRecorder.h"
 
+#include "SkCanvas.h"
 #include "SkDeferredDisplayList.h"
 #include "SkSurface.h"
 #include "SkSurfaceCharacterization.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
+#include "SkTime.h"
 
 #if !SK_SUPPORT_GPU
 SkDeferredDisplayListRecorder::SkDeferredDisplayListRecorder(const SkSurfaceCharacterization&) {}
@@ -53,6 +57,12 @@ sk_sp<SkImage> SkDeferredDisplayListRecorder::makeYUVAPromiseTexture(
     return nullptr;
 }
 
+bool SkDeferredDisplayListRecorder::RecordTiles(const SkPicture*,
+                                                const SkSurfaceCharacterization&,
+                                                int, int, SkExecutor*, SkSurface*, TileStats*) {
+    return false;
+}
+
 #else
 
 #include "GrContextPriv.h"
@@ -289,4 +299,78 @@ sk_sp<SkImage> SkDeferredDisplayListRecorder::makeYUVAPromiseTexture(
                                                textureContexts);
 }
 
+bool SkDeferredDisplayListRecorder::RecordTiles(const SkPicture* picture,
+                                                const SkSurfaceCharacterization& characterization,
+                                                int xDivisions, int yDivisions,
+                                                SkExecutor* executor, SkSurface* dst,
+                                                TileStats* stats) {
+    if (!picture || !dst || !characterization.isValid() || xDivisions < 1 || yDivisions < 1) {
+        return false;
+    }
+
+    const int width  = characterization.width(),
+              height = characterization.height();
+    xDivisions = SkTMin(xDivisions, width);
+    yDivisions = SkTMin(yDivisions, height);
+    const int tileCount = xDivisions * yDivisions;
+
+    // Tiles split the surface as evenly as they can, the same way DDLTileHelper does.
+    auto tileBounds = [&](int i) {
+        int x = i % xDivisions,
+            y = i / xDivisions;
+        return SkIRect::MakeLTRB(x * width  / xDivisions,     y * height / yDivisions,
+                                 (x+1) * width  / xDivisions, (y+1) * height / yDivisions);
+    };
+
+    SkTArray<std::unique_ptr<SkDeferredDisplayList>> ddls(tileCount);
+    SkTArray<double> tileMs(tileCount);
+    for (int i = 0; i < tileCount; i++) {
+        ddls.push_back(nullptr);
+        tileMs.push_back(0);
+    }
+
+    // Each tile gets its own recorder; they share nothing but the (immutable) picture.
+    auto recordTile = [&](int i) {
+        double start = SkTime::GetMSecs();
+        SkDeferredDisplayListRecorder recorder(characterization);
+        if (SkCanvas* canvas = recorder.getCanvas()) {
+            canvas->clipRect(SkRect::Make(tileBounds(i)));
+            canvas->drawPicture(picture);
+            ddls[i] = recorder.detach();
+        }
+        tileMs[i] = SkTime::GetMSecs() - start;
+    };
+
+    const double recordStart = SkTime::GetMSecs();
+    if (executor && tileCount > 1) {
+        SkTaskGroup(*executor).batch(tileCount, recordTile);
+    } else {
+        for (int i = 0; i < tileCount; i++) {
+            recordTile(i);
+        }
+    }
+    const double drawStart = SkTime::GetMSecs();
+
+    // DDLs must be drawn on the thread that owns dst's GrContext; this one.  draw() fails if dst
+    // isn't compatible with characterization.
+    int drawn = 0;
+    for (int i = 0; i < tileCount; i++) {
+        if (ddls[i] && dst->draw(ddls[i].get())) {
+            drawn++;
+        }
+    }
+
+    if (stats) {
+        stats->fTileCount  = tileCount;
+        stats->fTilesDrawn = drawn;
+        stats->fRecordMs   = drawStart - recordStart;
+        stats->fSlowestMs  = 0;
+        for (double ms : tileMs) {
+            stats->fSlowestMs = SkTMax(stats->fSlowestMs, ms);
+        }
+        stats->fDrawMs     = SkTime::GetMSecs() - drawStart;
+    }
+    return drawn == tileCount;
+}
+
 #endif
@@ -329,6 +329,7 @@ private:
     friend class SkDraw;
     friend class SkDrawIter;
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice; // to flush the devices it draws
     friend class DeviceTestingAccess;
 
     // Temporarily friend the SkGlyphRunBuilder until drawPosText is gone.
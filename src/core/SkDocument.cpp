@@ -7,7 +7,11 @@
 
 #include "SkCanvas.h"
 #include "SkDocument.h"
+#include "SkPictureRecorder.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+
+#include <vector>
 
 SkDocument::SkDocument(SkWStream* stream) : fStream(stream), fState(kBetweenPages_State) {}
 
@@ -48,6 +52,34 @@ void SkDocument::endPage() {
     }
 }
 
+void SkDocument::drawPages(int count, const SkSize sizes[],
+                           const std::function<void(int, SkCanvas*)>& drawPage,
+                           SkExecutor* executor) {
+    if (!executor) {
+        for (int i = 0; i < count; ++i) {
+            if (SkCanvas* canvas = this->beginPage(sizes[i].width(), sizes[i].height())) {
+                drawPage(i, canvas);
+            }
+            this->endPage();
+        }
+        return;
+    }
+
+    std::vector<sk_sp<SkPicture>> pages(count);
+    SkTaskGroup(*executor).batch(count, [&](int i) {
+        SkPictureRecorder recorder;
+        drawPage(i, recorder.beginRecording(sizes[i].width(), sizes[i].height()));
+        pages[i] = recorder.finishRecordingAsPicture();
+    });
+    for (int i = 0; i < count; ++i) {
+        if (SkCanvas* canvas = this->beginPage(sizes[i].width(), sizes[i].height())) {
+            canvas->drawPicture(pages[i]);
+        }
+        this->endPage();
+        pages[i] = nullptr;
+    }
+}
+
 void SkDocument::close() {
     for (;;) {
         switch (fState) {
@@ -15,6 +15,7 @@
 #include "SkColorData.h"
 #include "SkDevice.h"
 #include "SkDrawProcs.h"
+#include "SkMaskCache.h"
 #include "SkMaskFilterBase.h"
 #include "SkMacros.h"
 #include "SkMatrix.h"
@@ -933,6 +934,19 @@ void SkDraw::drawRRect(const SkRRect& rrect, const SkPaint& paint) const {
         }
     }
 
+#if !defined(SK_DISABLE_ANALYTIC_RRECTS)
+    if (paint.isAntiAlias() && !paint.getMaskFilter()) {
+        // Scale+translate rrects are filled with analytic coverage, skipping path scan conversion.
+        SkRRect devRRect;
+        if (rrect.transform(*fMatrix, &devRRect)) {
+            SkAutoBlitterChoose blitter(*this, nullptr, paint);
+            if (SkScan::AntiFillRRect(devRRect, *fRC, blitter.get())) {
+                return;
+            }
+        }
+    }
+#endif
+
 DRAW_PATH:
     // Now fall back to the default case of using a path.
     SkPath path;
@@ -974,6 +988,11 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
+    if (fDAARecord && doFill && paint.isAntiAlias()) {
+        SkScan::AntiFillPath(devPath, *fRC, blitter, fDAARecord);
+        return;
+    }
+
     void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
     if (doFill) {
         if (paint.isAntiAlias()) {
@@ -1090,6 +1109,9 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         doFill = paint->getFillPath(*pathPtr, tmpPath, cullRectPtr,
                                     ComputeResScaleForStroking(*fMatrix));
         pathPtr = tmpPath;
+        if (doFill && paint->getStyle() != SkPaint::kFill_Style) {
+            SkPathPriv::SetIsStrokeOutline(*tmpPath, true);
+        }
     }
 
     // avoid possibly allocating a new path in transform if we can
@@ -1101,6 +1123,110 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill);
 }
 
+// Cached path masks are made at quarter pixel offsets, like glyphs, and no larger than this.
+static constexpr int kPathMaskSubpixelSteps = 4;
+static constexpr int kMaxCachedPathMaskArea = 256 * 256;
+
+bool SkDraw::drawPathFromMaskCache(const SkPath& path, const SkPaint& paint) const {
+    const SkMaskFilter* filter = paint.getMaskFilter();
+    if (path.isVolatile() || path.isInverseFillType() || !path.isFinite() ||
+        fCoverage || fDAARecord || paint.getStyle() != SkPaint::kFill_Style ||
+        paint.getPathEffect() || fMatrix->hasPerspective() || fRC->isEmpty()) {
+        return false;
+    }
+    SkMaskFilterBase::BlurRec blur = { 0, kNormal_SkBlurStyle };
+    if (filter) {
+        // Rects and nested rects already blur as cached nine-patches in filterPath().
+        SkRect rects[2];
+        if (!as_MFB(filter)->asABlur(&blur) || path.isRect(nullptr) ||
+            path.isNestedFillRects(rects)) {
+            return false;
+        }
+    } else if (!paint.isAntiAlias()) {
+        return false;
+    }
+
+    if (!(SkScalarAbs(fMatrix->getTranslateX()) < SK_MaxS32 / 2 &&
+          SkScalarAbs(fMatrix->getTranslateY()) < SK_MaxS32 / 2)) {
+        return false;
+    }
+
+    // The mask is made, and keyed, with only the subpixel part of the translation, and then
+    // moved by the integer part. Its draws are snapped to that subpixel grid, cached or not.
+    SkPoint offset = SkPoint::Make(
+            SkScalarRoundToScalar(fMatrix->getTranslateX() * kPathMaskSubpixelSteps),
+            SkScalarRoundToScalar(fMatrix->getTranslateY() * kPathMaskSubpixelSteps));
+    offset.scale(1.0f / kPathMaskSubpixelSteps);
+    const int ix = SkScalarFloorToInt(offset.fX),
+              iy = SkScalarFloorToInt(offset.fY);
+    SkMatrix maskMatrix = *fMatrix;
+    maskMatrix.setTranslateX(offset.fX - ix);
+    maskMatrix.setTranslateY(offset.fY - iy);
+
+    // Cached masks aren't clipped, so they must be small whatever the clip.
+    SkRect devBounds = maskMatrix.mapRect(path.getBounds());
+    SkIRect maskBounds;
+    if (!devBounds.isFinite() || devBounds.width() * devBounds.height() > kMaxCachedPathMaskArea ||
+        !ComputeMaskBounds(devBounds, nullptr, filter, &maskMatrix, &maskBounds) ||
+        (int64_t)maskBounds.width() * maskBounds.height() > kMaxCachedPathMaskArea) {
+        return false;
+    }
+
+    SkMask mask;
+    sk_sp<SkCachedData> data(SkMaskCache::FindAndRef(path, maskMatrix, blur.fSigma, blur.fStyle,
+                                                     &mask));
+    if (!data) {
+        if (!SkMaskCache::SightPath(path, maskMatrix, blur.fSigma, blur.fStyle)) {
+            // Most paths are only drawn once, so only their second draw pays for a cache entry.
+            // This one is drawn directly, snapped like a cached mask would be.
+            SkMatrix snapped = maskMatrix;
+            snapped.postTranslate(ix, iy);
+            SkDraw draw(*this);
+            draw.fMatrix = &snapped;
+            draw.drawPath(path, paint);
+            return true;
+        }
+
+        SkPath devPath;
+        path.transform(maskMatrix, &devPath);
+        SkMask srcM;
+        if (!DrawToMask(devPath, nullptr, filter, &maskMatrix, &srcM,
+                        SkMask::kComputeBoundsAndRenderImage_CreateMode,
+                        SkStrokeRec::kFill_InitStyle)) {
+            return false;
+        }
+        SkAutoMaskFreeImage autoSrc(srcM.fImage);
+        if (filter) {
+            if (!as_MFB(filter)->filterMask(&mask, srcM, maskMatrix, nullptr)) {
+                return false;
+            }
+        } else {
+            mask = srcM;
+            autoSrc.release();
+        }
+        SkAutoMaskFreeImage autoMask(mask.fImage);
+
+        const size_t size = mask.computeTotalImageSize();
+        data.reset(SkResourceCache::NewCachedData(size));
+        if (!data) {
+            return false;
+        }
+        memcpy(data->writable_data(), mask.fImage, size);
+        mask.fImage = (uint8_t*)data->data();
+        SkMaskCache::Add(path, maskMatrix, blur.fSigma, blur.fStyle, mask, data.get());
+    }
+    mask.fBounds.offset(ix, iy);
+
+    SkAutoBlitterChoose blitterStorage(*this, nullptr, paint);
+    SkAAClipBlitterWrapper wrapper(*fRC, blitterStorage.get());
+    SkBlitter* blitter = wrapper.getBlitter();
+    for (SkRegion::Cliperator clipper(wrapper.getRgn(), mask.fBounds); !clipper.done();
+         clipper.next()) {
+        blitter->blitMask(mask, clipper.rect());
+    }
+    return true;
+}
+
 void SkDraw::drawBitmapAsMask(const SkBitmap& bitmap, const SkPaint& paint) const {
     SkASSERT(bitmap.colorType() == kAlpha_8_SkColorType);
 
@@ -1280,18 +1406,20 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         return; // nothing to draw
     }
 
-    SkPaint paint(origPaint);
-    paint.setStyle(SkPaint::kFill_Style);
+    SkTCopyOnFirstWrite<SkPaint> paint(origPaint);
+    if (origPaint.getStyle() != SkPaint::kFill_Style) {
+        paint.writable()->setStyle(SkPaint::kFill_Style);
+    }
 
     SkPixmap pmap;
     if (!bitmap.peekPixels(&pmap)) {
         return;
     }
 
-    if (nullptr == paint.getColorFilter() && clipHandlesSprite(*fRC, x, y, pmap)) {
+    if (nullptr == paint->getColorFilter() && clipHandlesSprite(*fRC, x, y, pmap)) {
         // blitter will be owned by the allocator.
         SkSTArenaAlloc<kSkBlitterContextSize> allocator;
-        SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator);
+        SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, x, y, &allocator);
         if (blitter) {
             SkScan::FillIRect(bounds, *fRC, blitter);
             return;
@@ -1306,7 +1434,7 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
 
     // create shader with offset
     matrix.setTranslate(r.fLeft, r.fTop);
-    SkPaint paintWithShader = make_paint_with_image(paint, bitmap, &matrix);
+    SkPaint paintWithShader = make_paint_with_image(*paint, bitmap, &matrix);
     SkDraw draw(*this);
     matrix.reset();
     draw.fMatrix = &matrix;
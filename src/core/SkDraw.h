@@ -26,6 +26,7 @@ class SkMatrix;
 class SkPath;
 class SkRegion;
 class SkRasterClip;
+struct SkDAARecord;
 struct SkRect;
 class SkRRect;
 
@@ -68,6 +69,8 @@ public:
                          const SkVertices::BoneWeights boneWeights[], SkBlendMode bmode,
                          const uint16_t indices[], int ptCount,
                          const SkPaint& paint, const SkVertices::Bone bones[], int boneCount) const;
+    void    drawAtlas(const SkImage*, const SkRSXform[], const SkRect[], const SkColor[], int count,
+                      SkBlendMode, const SkPaint&) const;
 
     /**
      *  Overwrite the target with the path's coverage (i.e. its mask).
@@ -122,8 +125,11 @@ public:
                                     const SkPaint&, const SkSurfaceProps*) const;
     static SkScalar ComputeResScaleForStroking(const SkMatrix& );
 private:
+    friend class SkBitmapDevice;        // draws its batched device-space fills with drawDevPath()
+    friend class SkThreadedBMPDevice;   // uses drawPath() with a custom blitter to init coverage
+
     void blitARGB32Mask(const SkMask& mask, const SkPaint& paint) const;
-    SkGlyphRunListPainter::PerMask drawOneMaskCreator(
+    SkGlyphRunListPainter::PerMasks drawMasksCreator(
             const SkPaint& paint, SkArenaAlloc* alloc) const;
     void    drawBitmapAsMask(const SkBitmap&, const SkPaint&) const;
 
@@ -134,6 +140,11 @@ private:
     void drawLine(const SkPoint[2], const SkPaint&) const;
     void drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
                      SkBlitter* customBlitter, bool doFill) const;
+    // Draws an anti-aliased or blurred fill of a non-volatile path from a coverage mask kept in
+    // SkResourceCache, so that drawing it again, even at another integer offset, is a single
+    // mask blit. The mask is made on the second draw with the same key. Returns false, having
+    // drawn nothing, if the draw doesn't qualify.
+    bool drawPathFromMaskCache(const SkPath&, const SkPaint&) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -153,6 +164,10 @@ public:
     // optional, will be same dimensions as fDst if present
     const SkPixmap* fCoverage{nullptr};
 
+    // optional, if present anti-aliased path fills compute their coverage into it (when it is
+    // still to be computed) or blit the coverage it already holds (see SkThreadedBMPDevice)
+    SkDAARecord*    fDAARecord{nullptr};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
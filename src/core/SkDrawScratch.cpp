@@ -0,0 +1,70 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDrawScratch.h"
+
+#include "SkTLS.h"
+#include "SkTemplates.h"
+#include "SkTo.h"
+
+#include <atomic>
+
+// A draw needing more than this goes to the heap for the rest, rather than have every thread
+// that ever made such a draw hold on to that much.
+static constexpr size_t kMaxThreadBlockSize = 256 * 1024;
+
+static std::atomic<int64_t> gDraws{0},
+                            gHeapDraws{0};
+
+struct SkDrawScratch::ThreadBlock {
+    SkAutoTMalloc<char> fStorage;
+    size_t              fSize  = 0;
+    bool                fInUse = false;
+};
+
+void* SkDrawScratch::CreateThreadBlock() { return new ThreadBlock; }
+void  SkDrawScratch::DeleteThreadBlock(void* block) { delete static_cast<ThreadBlock*>(block); }
+
+SkDrawScratch::SkDrawScratch()
+    : fThreadBlock(static_cast<ThreadBlock*>(SkTLS::Get(CreateThreadBlock,
+                                                        DeleteThreadBlock)))
+    , fBlock(fInlineStorage)
+    , fSize(sizeof(fInlineStorage)) {
+    if (fThreadBlock->fInUse) {
+        fThreadBlock = nullptr;
+    } else {
+        fThreadBlock->fInUse = true;
+        if (fThreadBlock->fSize > fSize) {
+            fBlock = fThreadBlock->fStorage.get();
+            fSize  = fThreadBlock->fSize;
+        }
+    }
+    gDraws.fetch_add(1, std::memory_order_relaxed);
+}
+
+SkDrawScratch::~SkDrawScratch() {
+    if (fThreadBlock) {
+        // The arena using fBlock is gone by now, so it's safe to replace the thread's block.
+        if (fWantSize > fThreadBlock->fSize) {
+            fThreadBlock->fStorage.reset(fWantSize);
+            fThreadBlock->fSize = fWantSize;
+        }
+        fThreadBlock->fInUse = false;
+    }
+}
+
+void SkDrawScratch::noteHeapBytes(size_t heapBytes) {
+    if (heapBytes > 0) {
+        gHeapDraws.fetch_add(1, std::memory_order_relaxed);
+        // Next time, hold everything this draw used in one block.
+        fWantSize = SkTMin(fSize + heapBytes, kMaxThreadBlockSize);
+    }
+}
+
+SkDrawScratch::Stats SkDrawScratch::GetStats() {
+    return { gDraws.load(std::memory_order_relaxed), gHeapDraws.load(std::memory_order_relaxed) };
+}
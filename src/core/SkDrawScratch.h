@@ -0,0 +1,54 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDrawScratch_DEFINED
+#define SkDrawScratch_DEFINED
+
+#include "SkImagePriv.h"
+#include "SkNoncopyable.h"
+
+/**
+ *  Storage for the SkArenaAlloc holding one draw's temporaries: its blitter, shader contexts
+ *  and so on.  Each thread keeps a block that grows to the most any draw on that thread has
+ *  needed, so after the first few draws their arenas stop going to the heap.  If the thread's
+ *  block is already in use (a draw nested in another, e.g. by a picture shader), this falls
+ *  back to storage of its own.
+ */
+class SkDrawScratch : SkNoncopyable {
+public:
+    SkDrawScratch();
+    ~SkDrawScratch();
+
+    char*  block() const { return fBlock; }
+    size_t size()  const { return fSize;  }
+
+    /**
+     *  Record that the arena built on block() needed another heapBytes from the heap, so the
+     *  thread's block can be grown to hold all of it next time.  Call this before the arena
+     *  is destroyed, and destroy the arena before this.
+     */
+    void noteHeapBytes(size_t heapBytes);
+
+    struct Stats {
+        int64_t fDraws;         // draws that used an SkDrawScratch
+        int64_t fHeapDraws;     // ... and of those, the ones whose arena went to the heap
+    };
+    static Stats GetStats();
+
+private:
+    struct ThreadBlock;
+    static void* CreateThreadBlock();
+    static void  DeleteThreadBlock(void*);
+
+    ThreadBlock* fThreadBlock;  // nullptr if we're using fInlineStorage
+    char*        fBlock;
+    size_t       fSize;
+    size_t       fWantSize = 0;
+    char         fInlineStorage[kSkBlitterContextSize];
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkBlendModePriv.h"
+#include "SkColorSpaceXformSteps.h"
+#include "SkCoreBlitters.h"
+#include "SkDraw.h"
+#include "SkImage.h"
+#include "SkRSXform.h"
+#include "SkRasterClip.h"
+#include "SkRasterPipeline.h"
+#include "SkScan.h"
+#include "SkShaderBase.h"
+
+// Maps the sprite's tex rect to where xform puts it on the device.
+static SkMatrix sprite_matrix(const SkMatrix& ctm, const SkRSXform& xform, const SkRect& tex) {
+    SkMatrix matrix;
+    matrix.setRSXform(xform);
+    matrix.preTranslate(-tex.fLeft, -tex.fTop);
+    matrix.postConcat(ctm);
+    return matrix;
+}
+
+// Fills the sprite the way drawVertices() fills its two triangles.
+static void fill_sprite(const SkMatrix& matrix, const SkRect& tex, const SkRasterClip& clip,
+                        SkBlitter* blitter) {
+    if (matrix.rectStaysRect()) {
+        SkRect devRect;
+        matrix.mapRect(&devRect, tex);
+        SkScan::FillRect(devRect, clip, blitter);
+        return;
+    }
+    SkPoint quad[4];
+    tex.toQuad(quad);
+    matrix.mapPoints(quad, 4);
+    const SkPoint tri0[] = { quad[0], quad[1], quad[2] },
+                  tri1[] = { quad[0], quad[2], quad[3] };
+    SkScan::FillTriangle(tri0, clip, blitter);
+    SkScan::FillTriangle(tri1, clip, blitter);
+}
+
+void SkDraw::drawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect textures[],
+                       const SkColor colors[], int count, SkBlendMode bmode,
+                       const SkPaint& paint) const {
+    sk_sp<SkShader> atlasShader = atlas->makeShader();
+    if (!atlasShader || fRC->isEmpty()) {
+        return;
+    }
+
+    // Like drawVertices(), drawAtlas() never anti-aliases.
+    SkPaint p(paint);
+    p.setAntiAlias(false);
+    p.setStyle(SkPaint::kFill_Style);
+    p.setMaskFilter(nullptr);
+    p.setPathEffect(nullptr);
+    p.setShader(atlasShader);
+
+    // Build the pipeline once, with the atlas' mapping left updatable, and with the sprite's
+    // color as the dst of bmode when there are colors, like SkComposeShader would do it.
+    SkSTArenaAlloc<2048> alloc;
+    SkRasterPipeline_<256> shaderPipeline;
+    SkStageUpdater* updater = nullptr;
+    if (!fMatrix->hasPerspective()) {
+        SkShaderBase::StageRec rec = {
+            &shaderPipeline, &alloc, fDst.colorSpace(), p, nullptr, *fMatrix
+        };
+        updater = as_SB(atlasShader)->appendUpdatableStages(rec);
+    }
+
+    if (!updater) {
+        // Every sprite needs its own pipeline; let drawRect() build them.
+        SkDraw draw(*this);
+        for (int i = 0; i < count; ++i) {
+            if (colors) {
+                p.setShader(SkShader::MakeComposeShader(SkShader::MakeColorShader(colors[i]),
+                                                        atlasShader, bmode));
+            }
+            SkMatrix matrix = sprite_matrix(*fMatrix, xform[i], textures[i]);
+            draw.fMatrix = &matrix;
+            draw.drawRect(textures[i], p);
+        }
+        return;
+    }
+
+    SkJumper_UniformColorCtx* spriteColor = nullptr;
+    SkColorSpaceXformSteps* steps = nullptr;
+    if (colors) {
+        float* rgba = alloc.makeArrayDefault<float>(4 * SkJumper_kMaxStride);
+        shaderPipeline.append(SkRasterPipeline::store_rgba, rgba);
+        spriteColor = alloc.make<SkJumper_UniformColorCtx>();
+        shaderPipeline.append_uniform_color(spriteColor);
+        shaderPipeline.append(SkRasterPipeline::move_src_dst);
+        shaderPipeline.append(SkRasterPipeline::load_rgba, rgba);
+        SkBlendMode_AppendStages(bmode, &shaderPipeline);
+
+        // Same conversion as drawVertices(): into the dst color space, then premul.
+        steps = alloc.make<SkColorSpaceXformSteps>(nullptr, kUnpremul_SkAlphaType,
+                                                   fDst.colorSpace(), kPremul_SkAlphaType);
+    }
+
+    float paintAlpha = paint.getColor4f().fA;
+    if (paintAlpha != 1.0f) {
+        shaderPipeline.append(SkRasterPipeline::scale_1_float, alloc.make<float>(paintAlpha));
+    }
+    bool isOpaque = !colors && atlasShader->isOpaque() && paintAlpha == 1.0f;
+    SkBlitter* blitter = SkCreateRasterPipelineBlitter(fDst, p, shaderPipeline, isOpaque, &alloc);
+
+    for (int i = 0; i < count; ++i) {
+        SkMatrix matrix = sprite_matrix(*fMatrix, xform[i], textures[i]);
+        if (!updater->update(matrix, nullptr)) {
+            continue;
+        }
+        if (spriteColor) {
+            SkColor4f color = SkColor4f::FromColor(colors[i]);
+            steps->apply(color.vec());
+            spriteColor->r = color.fR;
+            spriteColor->g = color.fG;
+            spriteColor->b = color.fB;
+            spriteColor->a = color.fA;
+        }
+        fill_sprite(matrix, textures[i], *fRC, blitter);
+    }
+}
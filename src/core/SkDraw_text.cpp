@@ -48,7 +48,7 @@ void SkDraw::blitARGB32Mask(const SkMask& mask, const SkPaint& paint) const {
     this->drawSprite(bm, mask.fBounds.x(), mask.fBounds.y(), paint);
 }
 
-SkGlyphRunListPainter::PerMask SkDraw::drawOneMaskCreator(
+SkGlyphRunListPainter::PerMasks SkDraw::drawMasksCreator(
         const SkPaint& paint, SkArenaAlloc* alloc) const {
     SkBlitter* blitter = SkBlitter::Choose(fDst, *fMatrix, paint, alloc, false);
     if (fCoverage != nullptr) {
@@ -62,42 +62,62 @@ SkGlyphRunListPainter::PerMask SkDraw::drawOneMaskCreator(
     auto useRegion = fRC->isBW() && !fRC->isRect();
 
     if (useRegion) {
-        return [this, blitter, &paint](const SkMask& mask, const SkGlyph&, SkPoint) {
-            SkRegion::Cliperator clipper(fRC->bwRgn(), mask.fBounds);
-
-            if (!clipper.done()) {
-                if (SkMask::kARGB32_Format == mask.fFormat) {
-                    this->blitARGB32Mask(mask, paint);
-                } else {
-                    const SkIRect& cr = clipper.rect();
-                    do {
-                        blitter->blitMask(mask, cr);
-                        clipper.next();
-                    } while (!clipper.done());
+        return [this, blitter, &paint](SkSpan<const SkMask> masks) {
+            for (const SkMask& mask : masks) {
+                SkRegion::Cliperator clipper(fRC->bwRgn(), mask.fBounds);
+
+                if (!clipper.done()) {
+                    if (SkMask::kARGB32_Format == mask.fFormat) {
+                        this->blitARGB32Mask(mask, paint);
+                    } else {
+                        const SkIRect& cr = clipper.rect();
+                        do {
+                            blitter->blitMask(mask, cr);
+                            clipper.next();
+                        } while (!clipper.done());
+                    }
                 }
             }
         };
     } else {
         SkIRect clipBounds = fRC->isBW() ? fRC->bwRgn().getBounds()
                                          : fRC->aaRgn().getBounds();
-        return [this, blitter, clipBounds, &paint](const SkMask& mask, const SkGlyph&, SkPoint) {
-            SkIRect  storage;
-            const SkIRect* bounds = &mask.fBounds;
-
-            // this extra test is worth it, assuming that most of the time it succeeds
-            // since we can avoid writing to storage
-            if (!clipBounds.containsNoEmptyCheck(mask.fBounds)) {
-                if (!storage.intersectNoEmptyCheck(mask.fBounds, clipBounds)) {
-                    return;
+        return [this, blitter, clipBounds, &paint](SkSpan<const SkMask> masks) {
+            // Masks are handed to the blitter in batches, so it can set up once for all of them
+            // and we skip a virtual call per glyph.  Color glyphs are drawn as sprites in order.
+            constexpr int kMaxBatch = 64;
+            SkMask  batch[kMaxBatch];
+            SkIRect clips[kMaxBatch];
+            int count = 0;
+            auto flush = [&] {
+                if (count > 0) {
+                    blitter->blitMasks(batch, clips, count);
+                    count = 0;
                 }
-                bounds = &storage;
-            }
+            };
+
+            for (const SkMask& mask : masks) {
+                SkIRect clip = mask.fBounds;
 
-            if (SkMask::kARGB32_Format == mask.fFormat) {
-                this->blitARGB32Mask(mask, paint);
-            } else {
-                blitter->blitMask(mask, *bounds);
+                // this extra test is worth it, assuming that most of the time it succeeds
+                if (!clipBounds.containsNoEmptyCheck(mask.fBounds)) {
+                    if (!clip.intersectNoEmptyCheck(mask.fBounds, clipBounds)) {
+                        continue;
+                    }
+                }
+
+                if (SkMask::kARGB32_Format == mask.fFormat) {
+                    flush();
+                    this->blitARGB32Mask(mask, paint);
+                } else {
+                    batch[count] = mask;
+                    clips[count] = clip;
+                    if (++count == kMaxBatch) {
+                        flush();
+                    }
+                }
             }
+            flush();
         };
     }
 }
@@ -127,11 +147,11 @@ void SkDraw::drawGlyphRunList(
         return perPath;
     };
 
-    auto perMaskBuilder = [this](const SkPaint& paint, SkArenaAlloc* alloc) {
-        return this->drawOneMaskCreator(paint, alloc);
+    auto perMasksBuilder = [this](const SkPaint& paint, SkArenaAlloc* alloc) {
+        return this->drawMasksCreator(paint, alloc);
     };
 
-    glyphPainter->drawForBitmapDevice(glyphRunList, *fMatrix, perMaskBuilder, perPathBuilder);
+    glyphPainter->drawForBitmapDevice(glyphRunList, *fMatrix, perMasksBuilder, perPathBuilder);
 }
 
 #if defined _WIN32
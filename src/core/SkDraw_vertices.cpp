@@ -7,6 +7,7 @@
 
 #include "SkArenaAlloc.h"
 #include "SkAutoBlitterChoose.h"
+#include "SkBlendModePriv.h"
 #include "SkComposeShader.h"
 #include "SkConvertPixels.h"
 #include "SkDraw.h"
@@ -20,6 +21,7 @@
 
 #include "SkArenaAlloc.h"
 #include "SkCoreBlitters.h"
+#include "../jumper/SkJumper.h"
 
 struct Matrix43 {
     float fMat[12];    // column major
@@ -149,6 +151,39 @@ static SkPMColor4f* convert_colors(const SkColor src[], int count, SkColorSpace*
     return dst;
 }
 
+// Builds a single blitter for all of a textured mesh's triangles: the texture's stages, blended
+// with the interpolated colors if there are any, the way SkComposeShader would do it.  Each
+// triangle then only needs *updater to re-map the texture.  Returns nullptr if the paint's shader
+// can't be re-mapped like that.
+static SkBlitter* make_updatable_blitter(const SkPixmap& dst, const SkPaint& paint,
+                                         const SkMatrix& ctm, SkShader* textureShader,
+                                         SkTriColorShader* triShader, SkBlendMode bmode,
+                                         SkArenaAlloc* alloc, SkStageUpdater** updater) {
+    SkRasterPipeline_<256> shaderPipeline;
+    SkShaderBase::StageRec rec = {&shaderPipeline, alloc, dst.colorSpace(), paint, nullptr, ctm};
+    *updater = as_SB(textureShader)->appendUpdatableStages(rec);
+    if (!*updater) {
+        return nullptr;
+    }
+    if (triShader) {
+        float* rgba = alloc->makeArrayDefault<float>(4 * SkJumper_kMaxStride);
+        shaderPipeline.append(SkRasterPipeline::store_rgba, rgba);
+        if (!triShader->appendStages(rec)) {
+            return nullptr;
+        }
+        shaderPipeline.append(SkRasterPipeline::move_src_dst);
+        shaderPipeline.append(SkRasterPipeline::load_rgba, rgba);
+        SkBlendMode_AppendStages(bmode, &shaderPipeline);
+    }
+
+    float paintAlpha = paint.getColor4f().fA;
+    if (paintAlpha != 1.0f) {
+        shaderPipeline.append(SkRasterPipeline::scale_1_float, alloc->make<float>(paintAlpha));
+    }
+    bool is_opaque = as_SB(paint.getShader())->isOpaque() && paintAlpha == 1.0f;
+    return SkCreateRasterPipelineBlitter(dst, paint, shaderPipeline, is_opaque, alloc);
+}
+
 static bool compute_is_opaque(const SkColor colors[], int count) {
     uint32_t c = ~0;
     for (int i = 0; i < count; ++i) {
@@ -268,13 +303,13 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int vertexCount,
     if (colors || textures) {
         SkPMColor4f*  dstColors = nullptr;
         Matrix43*   matrix43 = nullptr;
+        SkTriColorShader* triShader = nullptr;
+        SkShader* textureShader = shader;
 
         if (colors) {
             dstColors = convert_colors(colors, vertexCount, fDst.colorSpace(), &outerAlloc);
 
-            SkTriColorShader* triShader = outerAlloc.make<SkTriColorShader>(
-                                                                compute_is_opaque(colors,
-                                                                                  vertexCount));
+            triShader = outerAlloc.make<SkTriColorShader>(compute_is_opaque(colors, vertexCount));
             matrix43 = triShader->getMatrix43();
             if (shader) {
                 shader = outerAlloc.make<SkComposeShader>(sk_ref_sp(triShader), sk_ref_sp(shader),
@@ -303,19 +338,15 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int vertexCount,
                 SkScan::FillTriangle(tmp, *fRC, blitter);
             }
         } else {
+            SkStageUpdater* updater = nullptr;
+            SkBlitter* blitter = make_updatable_blitter(fDst, p, *fMatrix, textureShader,
+                                                        triShader, bmode, &outerAlloc, &updater);
             while (vertProc(&state)) {
-                SkSTArenaAlloc<2048> innerAlloc;
-
-                const SkMatrix* ctm = fMatrix;
-                SkMatrix tmpCtm;
-                if (textures) {
-                    SkMatrix localM;
-                    if (!texture_to_matrix(state, vertices, textures, &localM)) {
-                        continue;
-                    }
-                    tmpCtm = SkMatrix::Concat(*fMatrix, localM);
-                    ctm = &tmpCtm;
+                SkMatrix localM;
+                if (!texture_to_matrix(state, vertices, textures, &localM)) {
+                    continue;
                 }
+                SkMatrix ctm = SkMatrix::Concat(*fMatrix, localM);
 
                 if (matrix43 && !update_tricolor_matrix(ctmInv, vertices, dstColors,
                                                         state.f0, state.f1, state.f2,
@@ -326,8 +357,16 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int vertexCount,
                 SkPoint tmp[] = {
                     devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
                 };
-                auto blitter = SkCreateRasterPipelineBlitter(fDst, p, *ctm, &innerAlloc);
-                SkScan::FillTriangle(tmp, *fRC, blitter);
+                if (blitter) {
+                    if (updater->update(ctm, nullptr)) {
+                        SkScan::FillTriangle(tmp, *fRC, blitter);
+                    }
+                } else {
+                    // Every triangle needs its own pipeline.
+                    SkSTArenaAlloc<2048> innerAlloc;
+                    SkScan::FillTriangle(tmp, *fRC,
+                                         SkCreateRasterPipelineBlitter(fDst, p, ctm, &innerAlloc));
+                }
             }
         }
     } else {
@@ -15,6 +15,7 @@
 #include "SkPath.h"
 #include "SkPathPriv.h"
 #include "SkSafeMath.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -250,18 +251,149 @@ static void setShiftedClip(SkRect* dst, const SkIRect& src, int shift) {
              SkIntToScalar(src.fBottom >> shift));
 }
 
-SkEdgeBuilder::Combine SkEdgeBuilder::checkVertical(const SkEdge* edge, SkEdge** edgePtr) {
-    return !vertical_line(edge) || edgePtr <= (SkEdge**)fEdgeList ? kNo_Combine :
+SkEdgeBuilder::Combine SkEdgeBuilder::checkVertical(const SkEdge* edge, SkEdge** edgePtr,
+                                                    SkEdge** edgeList) {
+    return !vertical_line(edge) || edgePtr <= edgeList ? kNo_Combine :
             CombineVertical(edge, edgePtr[-1]);
 }
 
 SkEdgeBuilder::Combine SkEdgeBuilder::checkVertical(const SkAnalyticEdge* edge,
-        SkAnalyticEdge** edgePtr) {
+        SkAnalyticEdge** edgePtr, SkAnalyticEdge** edgeList) {
     SkASSERT(fEdgeType == kAnalyticEdge);
-    return !vertical_line(edge) || edgePtr <= (SkAnalyticEdge**)fEdgeList ? kNo_Combine :
+    return !vertical_line(edge) || edgePtr <= edgeList ? kNo_Combine :
             CombineVertical(edge, edgePtr[-1]);
 }
 
+// Line-only paths with at least twice this many points have their edges built in runs of about
+// this many lines, which run as tasks on the default SkExecutor.
+static constexpr int kMinLinesPerTask = 32 * 1024;
+
+namespace {
+// Lines from fPts[0] through fPts[fCount], then back to *fClose if it isn't null.
+struct LineRun {
+    const SkPoint* fPts;
+    int            fCount;
+    const SkPoint* fClose;
+};
+
+struct LineTask {
+    int     fFirstRun;
+    int     fRunCount;
+    size_t  fFirstEdge;     // where this task's edges and edge pointers start
+    int     fEdgeCount;
+};
+}  // namespace
+
+int SkEdgeBuilder::buildPolyInTasks(const SkPath& path, const SkRect* clip, int shiftUp,
+                                    bool canCullToTheRight, char* edge, size_t edgeSize,
+                                    size_t maxEdgesPerLine) {
+    if (!path.isFinite()) {
+        return -1;
+    }
+
+    // Find the same lines SkPath::Iter(path, true) would, splitting long contours into runs.
+    const SkPoint* pts = SkPathPriv::PointData(path);
+    SkTDArray<LineRun> runs;
+    int first = -1, last = -1;
+    auto addContour = [&]() {
+        const SkPoint* close = pts[last] != pts[first] ? &pts[first] : nullptr;
+        for (int start = first; start < last; start += kMinLinesPerTask) {
+            int count = SkTMin(kMinLinesPerTask, last - start);
+            runs.push_back({pts + start, count, start + count == last ? close : nullptr});
+        }
+    };
+    bool closed = false;
+    for (SkPath::Verb verb : SkPathPriv::Verbs(path)) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                if (first >= 0) {
+                    addContour();
+                }
+                first = last = last + 1;
+                closed = false;
+                break;
+            case SkPath::kLine_Verb:
+                if (first < 0 || closed) {
+                    // Lines that don't follow a move are left to SkPath::Iter.
+                    return -1;
+                }
+                last += 1;
+                break;
+            case SkPath::kClose_Verb:
+                if (first >= 0) {
+                    addContour();
+                    first = last;
+                }
+                closed = true;
+                break;
+            default:
+                return -1;
+        }
+    }
+    if (first >= 0) {
+        addContour();
+    }
+
+    SkTDArray<LineTask> tasks;
+    size_t edgeCount = 0;
+    int lineCount = 0;
+    for (int i = 0; i < runs.count(); ++i) {
+        int lines = runs[i].fCount + (runs[i].fClose ? 1 : 0);
+        if (tasks.isEmpty() || lineCount + lines > kMinLinesPerTask) {
+            tasks.push_back({i, 0, edgeCount, 0});
+            lineCount = 0;
+        }
+        tasks.top().fRunCount += 1;
+        lineCount += lines;
+        edgeCount += lines * maxEdgesPerLine;
+    }
+
+    // Each task fills its own stretch of the edges and edge pointers, and only combines vertical
+    // edges with its own. That can leave a few more edges than building them in one go would, but
+    // they cover just the same.
+    char** edgeList = (char**)fEdgeList;
+    SkTaskGroup().batch(tasks.count(), [&](int i) {
+        LineTask& task = tasks[i];
+        char* taskEdge = edge + task.fFirstEdge * edgeSize;
+        char** taskList = edgeList + task.fFirstEdge;
+        char** edgePtr = taskList;
+        auto addLine = [&](SkPoint line[2]) {
+            if (clip) {
+                SkPoint lines[SkLineClipper::kMaxPoints];
+                int count = SkLineClipper::ClipLine(line, *clip, lines, canCullToTheRight);
+                SkASSERT((size_t)count <= maxEdgesPerLine);
+                for (int j = 0; j < count; j++) {
+                    this->addPolyLine(lines + j, taskEdge, edgeSize, edgePtr, shiftUp, taskList);
+                }
+            } else {
+                this->addPolyLine(line, taskEdge, edgeSize, edgePtr, shiftUp, taskList);
+            }
+        };
+        for (const LineRun* run = &runs[task.fFirstRun];
+             run < &runs[task.fFirstRun] + task.fRunCount; ++run) {
+            SkPoint line[2];
+            for (int j = 0; j < run->fCount; ++j) {
+                line[0] = run->fPts[j];
+                line[1] = run->fPts[j + 1];
+                addLine(line);
+            }
+            if (run->fClose) {
+                line[0] = run->fPts[run->fCount];
+                line[1] = *run->fClose;
+                addLine(line);
+            }
+        }
+        task.fEdgeCount = SkToInt(edgePtr - taskList);
+    });
+
+    char** edgePtr = edgeList;
+    for (const LineTask& task : tasks) {
+        memmove(edgePtr, edgeList + task.fFirstEdge, task.fEdgeCount * sizeof(char*));
+        edgePtr += task.fEdgeCount;
+    }
+    return SkToInt(edgePtr - edgeList);
+}
+
 int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shiftUp,
                              bool canCullToTheRight) {
     SkPath::Iter    iter(path, true);
@@ -301,10 +433,20 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
     char** edgePtr = fAlloc.makeArrayDefault<char*>(maxEdgeCount);
     fEdgeList = (void**)edgePtr;
 
+    SkRect clip;
     if (iclip) {
-        SkRect clip;
         setShiftedClip(&clip, *iclip, shiftUp);
+    }
+    if (path.countPoints() >= 2 * kMinLinesPerTask) {
+        size_t maxEdgesPerLine = iclip ? SkLineClipper::kMaxClippedLineSegments : 1;
+        int count = this->buildPolyInTasks(path, iclip ? &clip : nullptr, shiftUp,
+                                           canCullToTheRight, edge, edgeSize, maxEdgesPerLine);
+        if (count >= 0) {
+            return fIsFinite ? count : 0;
+        }
+    }
 
+    if (iclip) {
         while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
             switch (verb) {
                 case SkPath::kMove_Verb:
@@ -317,7 +459,8 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
                     int lineCount = SkLineClipper::ClipLine(pts, clip, lines, canCullToTheRight);
                     SkASSERT(lineCount <= SkLineClipper::kMaxClippedLineSegments);
                     for (int i = 0; i < lineCount; i++) {
-                        this->addPolyLine(lines + i, edge, edgeSize, edgePtr, shiftUp);
+                        this->addPolyLine(lines + i, edge, edgeSize, edgePtr, shiftUp,
+                                          (char**)fEdgeList);
                     }
                     break;
                 }
@@ -335,7 +478,7 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
                     // the corresponding line/quad/cubic verbs
                     break;
                 case SkPath::kLine_Verb: {
-                    this->addPolyLine(pts, edge, edgeSize, edgePtr, shiftUp);
+                    this->addPolyLine(pts, edge, edgeSize, edgePtr, shiftUp, (char**)fEdgeList);
                     break;
                 }
                 default:
@@ -64,8 +64,9 @@ private:
 
     Combine CombineVertical(const SkEdge* edge, SkEdge* last);
     Combine CombineVertical(const SkAnalyticEdge* edge, SkAnalyticEdge* last);
-    Combine checkVertical(const SkEdge* edge, SkEdge** edgePtr);
-    Combine checkVertical(const SkAnalyticEdge* edge, SkAnalyticEdge** edgePtr);
+    Combine checkVertical(const SkEdge* edge, SkEdge** edgePtr, SkEdge** edgeList);
+    Combine checkVertical(const SkAnalyticEdge* edge, SkAnalyticEdge** edgePtr,
+                          SkAnalyticEdge** edgeList);
     bool vertical_line(const SkEdge* edge);
     bool vertical_line(const SkAnalyticEdge* edge);
 
@@ -94,8 +95,15 @@ public:
 
     int buildPoly(const SkPath& path, const SkIRect* clip, int shiftUp, bool clipToTheRight);
 
+    // Builds the edges of a huge line-only path in tasks. Returns -1 if the path isn't suitable.
+    int buildPolyInTasks(const SkPath& path, const SkRect* clip, int shiftUp,
+                         bool canCullToTheRight, char* edge, size_t edgeSize,
+                         size_t maxEdgesPerLine);
+
+    // edgeList is where the edges being added to start, so vertical lines only combine with
+    // edges after it.
     inline void addPolyLine(SkPoint pts[], char* &edge, size_t edgeSize, char** &edgePtr,
-            int shiftUp) {
+            int shiftUp, char** edgeList) {
         if (fEdgeType == kBezier) {
             if (((SkLine*)edge)->set(pts)) {
                 *edgePtr++ = edge;
@@ -109,8 +117,9 @@ public:
                 ((SkEdge*)edge)->setLine(pts[0], pts[1], shiftUp);
         if (setLineResult) {
             Combine combine = analyticAA ?
-                    checkVertical((SkAnalyticEdge*)edge, (SkAnalyticEdge**)edgePtr) :
-                    checkVertical((SkEdge*)edge, (SkEdge**)edgePtr);
+                    checkVertical((SkAnalyticEdge*)edge, (SkAnalyticEdge**)edgePtr,
+                                  (SkAnalyticEdge**)edgeList) :
+                    checkVertical((SkEdge*)edge, (SkEdge**)edgePtr, (SkEdge**)edgeList);
             if (kNo_Combine == combine) {
                 *edgePtr++ = edge;
                 edge += edgeSize;
@@ -11,6 +11,8 @@
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTArray.h"
+#include "SkThreadID.h"
+#include <atomic>
 #include <deque>
 #include <thread>
 
@@ -131,6 +133,134 @@ private:
     SkSemaphore           fWorkAvailable;
 };
 
+// An SkWorkStealingThreadPool keeps a deque of work per thread.  Work added from one of its
+// threads goes onto that thread's deque, which it runs LIFO; work added from other threads goes
+// onto a shared FIFO queue.  A thread out of work of its own runs the shared queue, then steals
+// the oldest work of other threads (for SkTaskGroup::batch(), the largest chunks).
+//
+// This keeps nested SkTaskGroups on their own thread's mostly uncontended lock, rather than all
+// threads contending on a single work list.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads)
+        : fWorkers(new Worker[threads])
+        , fWorkerCount(threads) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, &fWorkers[i]);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Signal each thread that it's time to shut down (via the shared queue).
+        for (int i = 0; i < fThreads.count(); i++) {
+            this->add(nullptr);
+        }
+        // Wait for each thread to shut down.
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        Worker* worker = this->currentWorker();
+        {
+            SkAutoExclusive lock(worker ? worker->fLock : fSharedLock);
+            (worker ? worker->fWork : fSharedWork).emplace_back(std::move(work));
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is work waiting, do it.
+        if (fWorkAvailable.try_wait()) {
+            SkAssertResult(this->do_work(this->currentWorker()));
+        }
+    }
+
+private:
+    using WorkList = std::deque<std::function<void(void)>>;
+    // Critical sections are a few pointer moves.
+    using Lock = SkSpinlock;
+
+    struct Worker {
+        std::atomic<SkThreadID> fThreadID{kIllegalThreadID};
+        Lock                    fLock;
+        WorkList                fWork;
+    };
+
+    // Returns the calling thread's Worker, or nullptr if it's not one of ours.
+    Worker* currentWorker() {
+        const SkThreadID id = SkGetThreadID();
+        for (int i = 0; i < fWorkerCount; i++) {
+            // Each thread stores its own ID, so we either see our own store, or a mismatch.
+            if (fWorkers[i].fThreadID.load(std::memory_order_relaxed) == id) {
+                return &fWorkers[i];
+            }
+        }
+        return nullptr;
+    }
+
+    static bool pop_back(Lock* lock, WorkList* list, std::function<void(void)>* work) {
+        SkAutoExclusive l(*lock);
+        if (list->empty()) {
+            return false;
+        }
+        *work = std::move(list->back());
+        list->pop_back();
+        return true;
+    }
+
+    static bool pop_front(Lock* lock, WorkList* list, std::function<void(void)>* work) {
+        SkAutoExclusive l(*lock);
+        if (list->empty()) {
+            return false;
+        }
+        *work = std::move(list->front());
+        list->pop_front();
+        return true;
+    }
+
+    // This method should be called only when fWorkAvailable indicates there's work to do.
+    // Work is always added before fWorkAvailable is signaled, so there is at least as much work
+    // queued as there are callers here: the search below terminates.
+    bool do_work(Worker* self) {
+        const int first_victim = self ? static_cast<int>(self - fWorkers.get()) + 1 : 0;
+
+        std::function<void(void)> work;
+        for (bool found = false; !found; ) {
+            found = (self && pop_back(&self->fLock, &self->fWork, &work))
+                 || pop_front(&fSharedLock, &fSharedWork, &work);
+
+            for (int i = 0; !found && i < fWorkerCount; i++) {
+                Worker* victim = &fWorkers[(first_victim + i) % fWorkerCount];
+                found = victim != self && pop_front(&victim->fLock, &victim->fWork, &work);
+            }
+        }
+
+        if (!work) {
+            return false;  // This is Loop()'s signal to shut down.
+        }
+
+        work();
+        return true;
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, Worker* self) {
+        self->fThreadID.store(SkGetThreadID(), std::memory_order_relaxed);
+        do {
+            pool->fWorkAvailable.wait();
+        } while (pool->do_work(self));
+    }
+
+    std::unique_ptr<Worker[]> fWorkers;
+    const int                 fWorkerCount;
+    SkTArray<std::thread>     fThreads;
+
+    WorkList                  fSharedWork;
+    Lock                      fSharedLock;
+    SkSemaphore               fWorkAvailable;
+};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads) {
     using WorkList = std::deque<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
@@ -139,3 +269,6 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads) {
     using WorkList = SkTArray<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads) {
+    return skstd::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores());
+}
@@ -5,10 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitSet.h"
 #include "SkFontDescriptor.h"
 #include "SkFontMgr.h"
 #include "SkOnce.h"
 #include "SkStream.h"
+#include "SkTemplates.h"
+#include "SkTypeface.h"
 #include "SkTypes.h"
 
 class SkFontStyle;
@@ -118,6 +121,42 @@ SkTypeface* SkFontMgr::matchFamilyStyleCharacter(const char familyName[], const
     return this->onMatchFamilyStyleCharacter(familyName, style, bcp47, bcp47Count, character);
 }
 
+void SkFontMgr::matchFamilyStyleCharacters(const char familyName[], const SkFontStyle& style,
+                                           const char* bcp47[], int bcp47Count,
+                                           const SkUnichar characters[], int count,
+                                           sk_sp<SkTypeface> typefaces[]) const {
+    SkBitSet resolved(count);
+    SkAutoTMalloc<SkGlyphID> glyphs(count);
+    for (int i = 0; i < count; ++i) {
+        if (resolved.has(i)) {
+            continue;
+        }
+        resolved.set(i);
+        typefaces[i].reset(this->onMatchFamilyStyleCharacter(familyName, style,
+                                                             bcp47, bcp47Count, characters[i]));
+        if (!typefaces[i]) {
+            // Don't ask again about the same character.
+            for (int j = i + 1; j < count; ++j) {
+                if (!resolved.has(j) && characters[j] == characters[i]) {
+                    resolved.set(j);
+                    typefaces[j] = nullptr;
+                }
+            }
+            continue;
+        }
+
+        // One cmap lookup finds everything else in the rest of the string this typeface has.
+        typefaces[i]->charsToGlyphs(characters + i, SkTypeface::kUTF32_Encoding,
+                                    glyphs.get(), count - i);
+        for (int j = i + 1; j < count; ++j) {
+            if (!resolved.has(j) && glyphs[j - i] != 0) {
+                resolved.set(j);
+                typefaces[j] = typefaces[i];
+            }
+        }
+    }
+}
+
 SkTypeface* SkFontMgr::matchFaceStyle(const SkTypeface* face,
                                       const SkFontStyle& fs) const {
     return this->onMatchFaceStyle(face, fs);
@@ -333,12 +333,12 @@ struct SkQuadCoeff {
         fA = P2 - times_2(P1) + fC;
     }
 
-    Sk2s eval(SkScalar t) {
+    Sk2s eval(SkScalar t) const {
         Sk2s tt(t);
         return eval(tt);
     }
 
-    Sk2s eval(const Sk2s& tt) {
+    Sk2s eval(const Sk2s& tt) const {
         return (fA * tt + fB) * tt + fC;
     }
 
@@ -388,12 +388,12 @@ struct SkCubicCoeff {
         fD = P0;
     }
 
-    Sk2s eval(SkScalar t) {
+    Sk2s eval(SkScalar t) const {
         Sk2s tt(t);
         return eval(tt);
     }
 
-    Sk2s eval(const Sk2s& t) {
+    Sk2s eval(const Sk2s& t) const {
         return ((fA * t + fB) * t + fC) * t + fD;
     }
 
@@ -7,18 +7,29 @@
 
 #include "SkGlyphCache.h"
 
+#include "SkData.h"
 #include "SkGraphics.h"
 #include "SkMutex.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkReadBuffer.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
+#include "SkWriteBuffer.h"
 #include <cctype>
 
 namespace {
 size_t compute_path_size(const SkPath& path) {
     return sizeof(SkPath) + path.countPoints() * sizeof(SkPoint);
 }
+
+// prepareImages() splits the glyphs missing images into batches of at least this many, each
+// rasterized by its own scaler context. Making a scaler context isn't free, so fewer glyphs
+// are rasterized where they are.
+constexpr int kMinGlyphsPerBatch = 32;
+constexpr int kMaxBatches = 8;
 }  // namespace
 
 SkGlyphCache::SkGlyphCache(
@@ -203,6 +214,47 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     return glyph.fImage;
 }
 
+void SkGlyphCache::prepareImages(SkSpan<const SkGlyph*> glyphs) {
+    // Allocate all the images here, so the batches only write into them.
+    SkSTArray<64, const SkGlyph*> missing;
+    for (const SkGlyph* glyph : glyphs) {
+        if (glyph->fWidth > 0 && glyph->fWidth < kMaxGlyphWidth && nullptr == glyph->fImage) {
+            size_t size = const_cast<SkGlyph*>(glyph)->allocImage(&fAlloc);
+            if (glyph->fImage) {
+                missing.push_back(glyph);
+                fMemoryUsed += size;
+            }
+        }
+    }
+
+    // The first batch uses our own scaler context. If the typeface can't make another, the
+    // glyphs are split among those we have.
+    std::unique_ptr<SkScalerContext> scalers[kMaxBatches];
+    int batches = SkTMin(missing.count() / kMinGlyphsPerBatch, kMaxBatches);
+    int scalerCount = 1;
+    while (scalerCount < batches) {
+        scalers[scalerCount] = fScalerContext->getTypeface()->createScalerContext(
+                fScalerContext->getEffects(), &this->getDescriptor(), true);
+        if (!scalers[scalerCount]) {
+            break;
+        }
+        scalerCount++;
+    }
+
+    const int count = missing.count();
+    auto rasterize = [&](int batch) {
+        SkScalerContext* scaler = batch == 0 ? fScalerContext.get() : scalers[batch].get();
+        for (int i = batch * count / scalerCount; i < (batch + 1) * count / scalerCount; i++) {
+            scaler->getImage(*missing[i]);
+        }
+    };
+    if (scalerCount == 1) {
+        rasterize(0);
+    } else {
+        SkTaskGroup().batch(scalerCount, rasterize);
+    }
+}
+
 void SkGlyphCache::initializeImage(const volatile void* data, size_t size, SkGlyph* glyph) {
     // Don't overwrite the image if we already have one. We could have used a fallback if the
     // glyph was missing earlier.
@@ -261,6 +313,130 @@ bool SkGlyphCache::initializePath(SkGlyph* glyph, const volatile void* data, siz
     return true;
 }
 
+// Bump the version whenever the layout written by serializeGlyphs() changes.
+static constexpr uint32_t kGlyphsMagic   = SkSetFourByteTag('s', 'k', 'g', 'c');
+static constexpr uint32_t kGlyphsVersion = 1;
+
+sk_sp<SkData> SkGlyphCache::serializeGlyphs() const {
+    SkBinaryWriteBuffer buffer;
+    buffer.writeUInt(kGlyphsMagic);
+    buffer.writeUInt(kGlyphsVersion);
+
+    int count = 0;
+    fGlyphMap.foreach([&count](const SkGlyph& glyph) {
+        count += glyph.isJustAdvance() ? 0 : 1;
+    });
+    buffer.writeInt(count);
+
+    fGlyphMap.foreach([&buffer](const SkGlyph& glyph) {
+        if (glyph.isJustAdvance()) {
+            return;
+        }
+        buffer.writeUInt(glyph.getGlyphID());
+        buffer.writeInt(glyph.getSubXFixed());
+        buffer.writeInt(glyph.getSubYFixed());
+        buffer.writeScalar(glyph.fAdvanceX);
+        buffer.writeScalar(glyph.fAdvanceY);
+        buffer.writeUInt(glyph.fWidth);
+        buffer.writeUInt(glyph.fHeight);
+        buffer.writeInt(glyph.fTop);
+        buffer.writeInt(glyph.fLeft);
+        buffer.writeInt(glyph.fForceBW);
+        buffer.writeUInt(glyph.fMaskFormat);
+
+        buffer.writeBool(glyph.fImage != nullptr);
+        if (glyph.fImage) {
+            buffer.writeByteArray(glyph.fImage, glyph.computeImageSize());
+        }
+        const SkPath* path = glyph.fPathData ? glyph.fPathData->fPath : nullptr;
+        buffer.writeBool(path != nullptr);
+        if (path) {
+            buffer.writePath(*path);
+        }
+    });
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(buffer.bytesWritten());
+    buffer.writeToMemory(data->writable_data());
+    return data;
+}
+
+bool SkGlyphCache::deserializeGlyphs(const void* data, size_t length) {
+    SkReadBuffer buffer(data, length);
+    if (!buffer.validate(buffer.readUInt() == kGlyphsMagic &&
+                         buffer.readUInt() == kGlyphsVersion)) {
+        return false;
+    }
+
+    int count = buffer.readInt();
+    for (int i = 0; i < count && buffer.isValid(); i++) {
+        SkGlyph glyph;
+        uint32_t glyphID = buffer.readUInt();
+        SkFixed  subX = buffer.readInt(),
+                 subY = buffer.readInt();
+        if (!buffer.validate(SkTFitsIn<SkGlyphID>(glyphID) &&
+                             0 <= subX && subX < SK_Fixed1 && 0 <= subY && subY < SK_Fixed1)) {
+            break;
+        }
+        glyph.initWithGlyphID(SkPackedGlyphID(SkTo<SkGlyphID>(glyphID), subX, subY));
+        glyph.fAdvanceX = buffer.readScalar();
+        glyph.fAdvanceY = buffer.readScalar();
+        uint32_t width  = buffer.readUInt(),
+                 height = buffer.readUInt();
+        int32_t  top    = buffer.readInt(),
+                 left   = buffer.readInt(),
+                 forceBW = buffer.readInt();
+        uint32_t format = buffer.readUInt();
+        if (!buffer.validate(width < kMaxGlyphWidth && SkTFitsIn<uint16_t>(height) &&
+                             SkTFitsIn<int16_t>(top) && SkTFitsIn<int16_t>(left) &&
+                             SkTFitsIn<int8_t>(forceBW) && format < SkMask::kCountMaskFormats)) {
+            break;
+        }
+        glyph.fWidth      = SkTo<uint16_t>(width);
+        glyph.fHeight     = SkTo<uint16_t>(height);
+        glyph.fTop        = SkTo<int16_t>(top);
+        glyph.fLeft       = SkTo<int16_t>(left);
+        glyph.fForceBW    = SkTo<int8_t>(forceBW);
+        glyph.fMaskFormat = SkTo<uint8_t>(format);
+
+        const void* image = nullptr;
+        size_t imageSize = 0;
+        if (buffer.readBool()) {
+            imageSize = buffer.readUInt();
+            image = buffer.skip(imageSize);
+            if (!buffer.validate(image && imageSize > 0 && imageSize == glyph.computeImageSize())) {
+                break;
+            }
+        }
+        SkPath path;
+        bool hasPath = buffer.readBool();
+        if (hasPath) {
+            buffer.readPath(&path);
+        }
+        if (!buffer.isValid()) {
+            break;
+        }
+
+        if (fGlyphMap.find(glyph.getPackedID())) {
+            continue;
+        }
+        SkGlyph* cached = this->allocateNewGlyph(glyph.getPackedID(), kNothing_MetricsType);
+        *cached = glyph;
+        if (image) {
+            this->initializeImage(image, imageSize, cached);
+        }
+        if (hasPath && cached->fWidth) {
+            SkGlyph::PathData* pathData = fAlloc.make<SkGlyph::PathData>();
+            pathData->fIntercept = nullptr;
+            pathData->fPath = new SkPath(path);
+            pathData->fPath->updateBoundsCache();
+            pathData->fPath->getGenerationID();
+            cached->fPathData = pathData;
+            fMemoryUsed += compute_path_size(path);
+        }
+    }
+    return buffer.isValid();
+}
+
 bool SkGlyphCache::belongsToCache(const SkGlyph* glyph) const {
     return glyph && fGlyphMap.find(glyph->getPackedID()) == glyph;
 }
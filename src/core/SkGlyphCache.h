@@ -12,11 +12,13 @@
 #include "SkGlyph.h"
 #include "SkGlyphRun.h"
 #include "SkPaint.h"
-#include "SkTHash.h"
 #include "SkScalerContext.h"
+#include "SkTFlatHash.h"
 #include "SkTemplates.h"
 #include <memory>
 
+class SkData;
+
 /** \class SkGlyphCache
 
     This class represents a strike: a specific combination of typeface, size, matrix, etc., and
@@ -91,6 +93,12 @@ public:
     */
     const void* findImage(const SkGlyph&);
 
+    /** Generate the images of any of the glyphs that don't have one yet. When there are many,
+        they are split into batches rasterized in parallel on the default SkExecutor, each batch
+        with its own copy of this strike's scaler context.
+    */
+    void prepareImages(SkSpan<const SkGlyph*> glyphs);
+
     /** Initializes the image associated with the glyph with |data|.
      */
     void initializeImage(const volatile void* data, size_t size, SkGlyph*);
@@ -111,6 +119,16 @@ public:
      */
     bool initializePath(SkGlyph*, const volatile void* data, size_t size);
 
+    /** Write the metrics, images and paths of the glyphs cached so far, in a form that
+        deserializeGlyphs() can read back into the same strike in another process.
+    */
+    sk_sp<SkData> serializeGlyphs() const;
+
+    /** Add the glyphs written by serializeGlyphs(), keeping any glyph already cached. Returns
+        false if the data is malformed, though glyphs read before the error are kept.
+    */
+    bool deserializeGlyphs(const void* data, size_t length);
+
     /** Fallback glyphs used during font remoting if the original glyph can't be found.
      */
     bool belongsToCache(const SkGlyph* glyph) const;
@@ -224,7 +242,7 @@ private:
     SkPaint::FontMetrics   fFontMetrics;
 
     // Map from a combined GlyphID and sub-pixel position to a SkGlyph.
-    SkTHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits> fGlyphMap;
+    SkTFlatHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits> fGlyphMap;
 
     // so we don't grow our arrays a lot
     static constexpr size_t kMinGlyphCount = 8;
@@ -36,20 +36,29 @@ SkGlyphRun::SkGlyphRun(const SkPaint& basePaint,
                        SkSpan<const SkGlyphID> uniqueGlyphIDs,
                        SkSpan<const char> text,
                        SkSpan<const uint32_t> clusters)
+        : SkGlyphRun{SkPaint{basePaint, runFont}, denseIndices, positions, glyphIDs,
+                     uniqueGlyphIDs, text, clusters} {}
+
+SkGlyphRun::SkGlyphRun(SkPaint&& runPaint,
+                       SkSpan<const uint16_t> denseIndices,
+                       SkSpan<const SkPoint> positions,
+                       SkSpan<const SkGlyphID> glyphIDs,
+                       SkSpan<const SkGlyphID> uniqueGlyphIDs,
+                       SkSpan<const char> text,
+                       SkSpan<const uint32_t> clusters)
         : fUniqueGlyphIDIndices{denseIndices}
         , fPositions{positions}
         , fGlyphIDs{glyphIDs}
         , fUniqueGlyphIDs{uniqueGlyphIDs}
         , fText{text}
         , fClusters{clusters}
-        , fRunPaint{basePaint, runFont} {}
+        , fRunPaint{std::move(runPaint)} {}
 
 void SkGlyphRun::eachGlyphToGlyphRun(SkGlyphRun::PerGlyph perGlyph) {
     SkPoint point;
     SkGlyphID glyphID;
     SkGlyphRun run{
-        fRunPaint,
-        SkRunFont{fRunPaint},
+        SkPaint{fRunPaint},
         SkSpan<const uint16_t>{},  // No dense indices for now.
         SkSpan<const SkPoint>{&point, 1},
         SkSpan<const SkGlyphID>{&glyphID, 1},
@@ -194,8 +203,7 @@ void SkGlyphRunBuilder::drawTextAtOrigin(
     sk_bzero((void *)positions.data(), positions.size_bytes());
 
     this->makeGlyphRun(
-            paint,
-            SkRunFont{paint},
+            SkPaint{paint},
             glyphIDs,
             positions,
             SkSpan<const uint16_t>{},  // no dense indices for now.,
@@ -367,8 +375,7 @@ SkSpan<const SkGlyphID> SkGlyphRunBuilder::addDenseAndUnique(
 }
 
 void SkGlyphRunBuilder::makeGlyphRun(
-        const SkPaint& basePaint,
-        const SkRunFont& runFont,
+        SkPaint&& runPaint,
         SkSpan<const SkGlyphID> glyphIDs,
         SkSpan<const SkPoint> positions,
         SkSpan<const uint16_t> uniqueGlyphIDIndices,
@@ -379,8 +386,7 @@ void SkGlyphRunBuilder::makeGlyphRun(
     // Ignore empty runs.
     if (!glyphIDs.empty()) {
         fGlyphRunListStorage.emplace_back(
-                basePaint,
-                runFont,
+                std::move(runPaint),
                 uniqueGlyphIDIndices,
                 positions,
                 glyphIDs,
@@ -436,9 +442,9 @@ size_t SkGlyphRunBuilder::simplifyDrawText(
 
         }
 
+        // The run takes runPaint, rather than building another copy from paint and runFont.
         this->makeGlyphRun(
-                paint,
-                runFont,
+                std::move(runPaint),
                 glyphIDs,
                 SkSpan<const SkPoint>{positions, runSize},
                 SkSpan<const uint16_t>{uniqueGlyphIDIndicesBuffer, runSize},
@@ -482,8 +488,7 @@ size_t SkGlyphRunBuilder::simplifyDrawPosText(
     // TODO: when using the unique glyph system have a guard that there are actually glyphs like
     // drawText above.
     this->makeGlyphRun(
-            paint,
-            runFont,
+            SkPaint{paint, runFont},
             glyphIDs,
             SkSpan<const SkPoint>{pos, runSize},
             SkSpan<const SkGlyphID>{uniqueGlyphIDIndicesBuffer, runSize},
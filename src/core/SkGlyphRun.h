@@ -93,6 +93,14 @@ public:
                SkSpan<const SkGlyphID> uniqueGlyphIDs,
                SkSpan<const char> text,
                SkSpan<const uint32_t> clusters);
+    // Takes ownership of a paint that already has the run's font applied.
+    SkGlyphRun(SkPaint&& runPaint,
+               SkSpan<const uint16_t> denseIndices,
+               SkSpan<const SkPoint> positions,
+               SkSpan<const SkGlyphID> glyphIDs,
+               SkSpan<const SkGlyphID> uniqueGlyphIDs,
+               SkSpan<const char> text,
+               SkSpan<const uint32_t> clusters);
 
     // A function that turns an SkGlyphRun into an SkGlyphRun for each glyph.
     using PerGlyph = std::function<void (SkGlyphRun*, SkPaint*)>;
@@ -216,8 +224,7 @@ private:
             SkGlyphID* uniqueGlyphIDs);
 
     void makeGlyphRun(
-            const SkPaint& basePaint,
-            const SkRunFont& runFont,
+            SkPaint&& runPaint,
             SkSpan<const SkGlyphID> glyphIDs,
             SkSpan<const SkPoint> positions,
             SkSpan<const uint16_t> uniqueGlyphIDIndices,
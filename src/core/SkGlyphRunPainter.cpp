@@ -20,10 +20,14 @@
 #include "SkDistanceFieldGen.h"
 #include "SkDraw.h"
 #include "SkGlyphCache.h"
+#include "SkGraphics.h"
 #include "SkMaskFilter.h"
 #include "SkPaintPriv.h"
+#include "SkJumper.h"
 #include "SkPathEffect.h"
 #include "SkRasterClip.h"
+#include "SkRasterPipeline.h"
+#include "SkSDFMaskFilter.h"
 #include "SkStrikeCache.h"
 
 // -- SkGlyphRunListPainter ------------------------------------------------------------------------
@@ -74,9 +78,55 @@ bool SkGlyphRunListPainter::ShouldDrawAsPath(const SkPaint& paint, const SkMatri
     return SkPaint::TooBigToUseCache(matrix, textM, 1024);
 }
 
+// Like GrTextContext, keep distance fields at a few sizes and stretch them to the sizes in
+// between, so that text whose size changes every frame keeps drawing from the same strike.
+static const int kSmallSDFFontSize = 32;
+static const int kMediumSDFFontSize = 72;
+static const int kLargeSDFFontSize = 162;
+static const int kMinSDFFontSize = 18;
+static const int kMaxSDFFontSize = 2 * kLargeSDFFontSize;
+
+bool SkGlyphRunListPainter::ShouldDrawAsSDF(
+        const SkPaint& runPaint, const SkMatrix& matrix, const SkSurfaceProps& props,
+        SkPaint* sdfPaint, SkScalar* textScale) {
+    // Mask filters modify alpha, which doesn't translate well to distance, and the distance
+    // field is from the outline of the fill.
+    if (runPaint.getMaskFilter() || runPaint.getStyle() != SkPaint::kFill_Style ||
+        matrix.hasPerspective()) {
+        return false;
+    }
+
+    // Hinted masks look better at small sizes, so unless the client asks for device independent
+    // fonts, e.g. because it animates the text size, only large text uses distance fields.
+    SkScalar scaledTextSize = matrix.getMaxScale() * runPaint.getTextSize();
+    if (scaledTextSize < kMinSDFFontSize || scaledTextSize > kMaxSDFFontSize) {
+        return false;
+    }
+    if (!props.isUseDeviceIndependentFonts() && scaledTextSize < kLargeSDFFontSize) {
+        return false;
+    }
+
+    int sdfTextSize = scaledTextSize <= kSmallSDFFontSize  ? kSmallSDFFontSize
+                    : scaledTextSize <= kMediumSDFFontSize ? kMediumSDFFontSize
+                                                           : kLargeSDFFontSize;
+    *textScale = runPaint.getTextSize() / sdfTextSize;
+
+    *sdfPaint = runPaint;
+    sdfPaint->setTextSize(SkIntToScalar(sdfTextSize));
+    sdfPaint->setAntiAlias(true);
+    sdfPaint->setLCDRenderText(false);
+    sdfPaint->setAutohinted(false);
+    sdfPaint->setHinting(SkPaint::kNormal_Hinting);
+    sdfPaint->setSubpixelText(true);
+    sdfPaint->setMaskFilter(SkSDFMaskFilter::Make());
+    return true;
+}
+
 bool SkGlyphRunListPainter::ensureBitmapBuffers(size_t runSize) {
     if (runSize > fMaxRunSize) {
         fPositions.reset(runSize);
+        fMasks.reset(runSize);
+        fGlyphs.reset(runSize);
         fMaxRunSize = runSize;
     }
 
@@ -139,10 +189,44 @@ static bool prepare_mask(
     return true;
 }
 
+template <typename LookupGlyph>
+size_t SkGlyphRunListPainter::prepareMasks(
+        SkGlyphCache* cache, SkSpan<const SkGlyphID> glyphIDs, LookupGlyph&& lookupGlyph) {
+    auto finite = [](SkPoint position) { return SkScalarsAreFinite(position.fX, position.fY); };
+
+    // Adding glyphs to the cache moves the ones already in it, so look them all up before
+    // holding on to any of them.
+    for (size_t i = 0; i < glyphIDs.size(); i++) {
+        if (finite(fPositions[i])) {
+            lookupGlyph(glyphIDs[i], fPositions[i]);
+        }
+    }
+    size_t glyphCount = 0;
+    for (size_t i = 0; i < glyphIDs.size(); i++) {
+        if (finite(fPositions[i])) {
+            fGlyphs[glyphCount++] = &lookupGlyph(glyphIDs[i], fPositions[i]);
+        }
+    }
+
+    // Rasterize all the missing images together, so a big run of new glyphs can go in parallel.
+    cache->prepareImages(SkSpan<const SkGlyph*>{fGlyphs.get(), glyphCount});
+
+    const SkGlyph** glyphCursor = fGlyphs.get();
+    size_t maskCount = 0;
+    for (size_t i = 0; i < glyphIDs.size(); i++) {
+        if (finite(fPositions[i])) {
+            if (prepare_mask(cache, **glyphCursor++, fPositions[i], &fMasks[maskCount])) {
+                maskCount++;
+            }
+        }
+    }
+    return maskCount;
+}
+
 void SkGlyphRunListPainter::drawGlyphRunAsSubpixelMask(
         SkGlyphCache* cache, const SkGlyphRun& glyphRun,
         SkPoint origin, const SkMatrix& deviceMatrix,
-        PerMask perMask) {
+        PerMasks perMasks) {
     auto runSize = glyphRun.runSize();
     if (this->ensureBitmapBuffers(runSize)) {
         // Add rounding and origin.
@@ -152,25 +236,18 @@ void SkGlyphRunListPainter::drawGlyphRunAsSubpixelMask(
         matrix.postTranslate(rounding.x(), rounding.y());
         matrix.mapPoints(fPositions, glyphRun.positions().data(), runSize);
 
-        const SkPoint* positionCursor = fPositions;
-        for (auto glyphID : glyphRun.shuntGlyphsIDs()) {
-            auto position = *positionCursor++;
-            if (SkScalarsAreFinite(position.fX, position.fY)) {
-                const SkGlyph& glyph = cache->getGlyphMetrics(glyphID, position);
-
-                SkMask mask;
-                if (prepare_mask(cache, glyph, position, &mask)) {
-                    perMask(mask, glyph, position);
-                }
-            }
-        }
+        auto lookup = [cache](SkGlyphID glyphID, SkPoint position) -> const SkGlyph& {
+            return cache->getGlyphMetrics(glyphID, position);
+        };
+        size_t maskCount = this->prepareMasks(cache, glyphRun.shuntGlyphsIDs(), lookup);
+        perMasks(SkSpan<const SkMask>{fMasks.get(), maskCount});
     }
 }
 
 void SkGlyphRunListPainter::drawGlyphRunAsFullpixelMask(
         SkGlyphCache* cache, const SkGlyphRun& glyphRun,
         SkPoint origin, const SkMatrix& deviceMatrix,
-        PerMask perMask) {
+        PerMasks perMasks) {
     auto runSize = glyphRun.runSize();
     if (this->ensureBitmapBuffers(runSize)) {
 
@@ -180,23 +257,145 @@ void SkGlyphRunListPainter::drawGlyphRunAsFullpixelMask(
         matrix.postTranslate(SK_ScalarHalf, SK_ScalarHalf);
         matrix.mapPoints(fPositions, glyphRun.positions().data(), runSize);
 
-        const SkPoint* positionCursor = fPositions;
-        for (auto glyphID : glyphRun.shuntGlyphsIDs()) {
-            auto position = *positionCursor++;
-            if (SkScalarsAreFinite(position.fX, position.fY)) {
-                const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphID);
-                SkMask mask;
-                if (prepare_mask(cache, glyph, position, &mask)) {
-                    perMask(mask, glyph, position);
-                }
-            }
+        auto lookup = [cache](SkGlyphID glyphID, SkPoint) -> const SkGlyph& {
+            return cache->getGlyphIDMetrics(glyphID);
+        };
+        size_t maskCount = this->prepareMasks(cache, glyphRun.shuntGlyphsIDs(), lookup);
+        perMasks(SkSpan<const SkMask>{fMasks.get(), maskCount});
+    }
+}
+
+bool SkGlyphRunListPainter::drawGlyphRunAsSDF(
+        SkGlyphCache* cache, const SkGlyphRun& glyphRun,
+        SkPoint origin, const SkMatrix& deviceMatrix, SkScalar textScale,
+        PerMasks perMasks) {
+    auto runSize = glyphRun.runSize();
+    if (!this->ensureBitmapBuffers(runSize)) {
+        return false;
+    }
+
+    // Adding glyphs to the cache moves the ones already in it, so look them all up before
+    // holding on to any of them.
+    auto glyphIDs = glyphRun.shuntGlyphsIDs();
+    for (SkGlyphID glyphID : glyphIDs) {
+        cache->getGlyphMetrics(glyphID, {0, 0});
+    }
+    size_t glyphCount = 0;
+    for (size_t i = 0; i < runSize; i++) {
+        const SkGlyph& glyph = cache->getGlyphMetrics(glyphIDs[i], {0, 0});
+        SkPoint position = origin + glyphRun.positions()[i];
+        if (glyph.isEmpty() || !SkScalarsAreFinite(position.fX, position.fY)) {
+            continue;
+        }
+        if (glyph.fMaskFormat != SkMask::kSDF_Format) {
+            return false;
+        }
+        fGlyphs[glyphCount] = &glyph;
+        fPositions[glyphCount] = position;
+        glyphCount++;
+    }
+    cache->prepareImages(SkSpan<const SkGlyph*>{fGlyphs.get(), glyphCount});
+
+    // One pipeline shades every glyph: it maps each mask pixel back into the glyph's distance
+    // field, samples it bilinearly, and turns the distance into coverage.
+    SkSTArenaAlloc<1024> alloc;
+    float mapping[6];
+    float coverageScale;
+    SkJumper_GatherCtx sdf;
+    SkJumper_MemoryCtx dst;
+    auto sampler = alloc.make<SkJumper_SamplerCtx>();
+
+    SkRasterPipeline p(&alloc);
+    p.append(SkRasterPipeline::seed_shader);
+    p.append(SkRasterPipeline::matrix_2x3, mapping);
+    p.append(SkRasterPipeline::save_xy, sampler);
+    auto sample = [&](SkRasterPipeline::StockStage setup_x, SkRasterPipeline::StockStage setup_y) {
+        p.append(setup_x, sampler);
+        p.append(setup_y, sampler);
+        p.append(SkRasterPipeline::gather_a8, &sdf);
+        p.append(SkRasterPipeline::accumulate, sampler);
+    };
+    sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_ny);
+    sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_ny);
+    sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_py);
+    sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_py);
+    p.append(SkRasterPipeline::move_dst_src);
+    p.append(SkRasterPipeline::sdf_to_alpha, &coverageScale);
+    p.append(SkRasterPipeline::store_a8, &dst);
+    auto shade = p.compile();
+
+    // The distance field is stored in 8 bits spanning SK_DistanceFieldMagnitude texels either
+    // side of the edge, and each texel covers this many device pixels.
+    SkMatrix textMatrix = deviceMatrix;
+    textMatrix.preScale(textScale, textScale);
+    SkScalar pixelsPerTexel = SkScalarSqrt(SkScalarAbs(
+            textMatrix.getScaleX() * textMatrix.getScaleY() -
+            textMatrix.getSkewX()  * textMatrix.getSkewY()));
+    coverageScale = 2 * SK_DistanceFieldMagnitude * (255 / 256.0f) * pixelsPerTexel;
+
+    // Like prepare_mask(), keep glyphs well within device space.
+    const SkRect kDeviceSpace = SkRect::MakeLTRB(INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX);
+
+    // Hand the masks over in batches, so that a long run doesn't hold all of them at once.
+    constexpr size_t kMaxBatchBytes = 256 * 1024;
+    SkArenaAlloc maskAlloc(kMaxBatchBytes);
+    size_t batchBytes = 0;
+    size_t maskCount = 0;
+    for (size_t i = 0; i < glyphCount; i++) {
+        const SkGlyph& glyph = *fGlyphs[i];
+        const void* image = cache->findImage(glyph);
+        if (image == nullptr) {
+            continue;
+        }
+
+        // Maps the distance field, which includes its padding, into the device.
+        SkMatrix glyphMatrix = deviceMatrix;
+        glyphMatrix.preTranslate(fPositions[i].fX, fPositions[i].fY);
+        glyphMatrix.preScale(textScale, textScale);
+        glyphMatrix.preTranslate(glyph.fLeft, glyph.fTop);
+
+        SkRect devRect = glyphMatrix.mapRect(SkRect::MakeIWH(glyph.fWidth, glyph.fHeight));
+        SkIRect bounds = devRect.roundOut();
+        if (!kDeviceSpace.contains(devRect) || bounds.isEmpty()) {
+            continue;
+        }
+        SkMatrix inverse;
+        if (!glyphMatrix.invert(&inverse)) {
+            continue;
         }
+        // The pipeline runs over the mask from (0,0).
+        inverse.preTranslate(bounds.fLeft, bounds.fTop);
+
+        size_t maskBytes = bounds.width() * bounds.height();
+        if (maskCount > 0 && batchBytes + maskBytes > kMaxBatchBytes) {
+            perMasks(SkSpan<const SkMask>{fMasks.get(), maskCount});
+            maskAlloc.reset();
+            batchBytes = 0;
+            maskCount = 0;
+        }
+        uint8_t* pixels = maskAlloc.makeArrayDefault<uint8_t>(maskBytes);
+        batchBytes += maskBytes;
+
+        SkAssertResult(inverse.asAffine(mapping));
+        sdf = { image, (int)glyph.rowBytes(), (float)glyph.fWidth, (float)glyph.fHeight };
+        dst = { pixels, bounds.width() };
+        shade(0, 0, bounds.width(), bounds.height());
+
+        SkMask& mask = fMasks[maskCount++];
+        mask.fImage    = pixels;
+        mask.fBounds   = bounds;
+        mask.fRowBytes = bounds.width();
+        mask.fFormat   = SkMask::kA8_Format;
+    }
+    if (maskCount > 0) {
+        perMasks(SkSpan<const SkMask>{fMasks.get(), maskCount});
     }
+    return true;
 }
 
 void SkGlyphRunListPainter::drawForBitmapDevice(
         const SkGlyphRunList& glyphRunList, const SkMatrix& deviceMatrix,
-        PerMaskCreator perMaskCreator, PerPathCreator perPathCreator) {
+        PerMasksCreator perMasksCreator, PerPathCreator perPathCreator) {
 
     SkPoint origin = glyphRunList.origin();
     for (auto& glyphRun : glyphRunList) {
@@ -219,21 +418,34 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
             auto perPath = perPathCreator(paint, matrixScale, &alloc);
             this->drawUsingPaths(glyphRun, origin, pathCache.get(), perPath);
         } else {
+            auto perMasks = perMasksCreator(paint, &alloc);
+
+            SkPaint sdfPaint;
+            SkScalar textScale;
+            if (ShouldDrawAsSDF(paint, deviceMatrix, fDeviceProps, &sdfPaint, &textScale)) {
+                auto sdfCache = SkStrikeCache::FindOrCreateStrikeExclusive(
+                        sdfPaint, &fBitmapFallbackProps, SkScalerContextFlags::kNone,
+                        &SkMatrix::I());
+                if (this->drawGlyphRunAsSDF(
+                        sdfCache.get(), glyphRun, origin, deviceMatrix, textScale, perMasks)) {
+                    continue;
+                }
+            }
+
             auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
                     paint, &props, fScalerContextFlags, &deviceMatrix);
-            auto perMask = perMaskCreator(paint, &alloc);
-            this->drawUsingMasks(cache.get(), glyphRun, origin, deviceMatrix, perMask);
+            this->drawUsingMasks(cache.get(), glyphRun, origin, deviceMatrix, perMasks);
         }
     }
 }
 
 void SkGlyphRunListPainter::drawUsingMasks(
         SkGlyphCache* cache, const SkGlyphRun& glyphRun,
-        SkPoint origin, const SkMatrix& deviceMatrix, PerMask perMask) {
+        SkPoint origin, const SkMatrix& deviceMatrix, PerMasks perMasks) {
     if (cache->isSubpixel()) {
-        this->drawGlyphRunAsSubpixelMask(cache, glyphRun, origin, deviceMatrix, perMask);
+        this->drawGlyphRunAsSubpixelMask(cache, glyphRun, origin, deviceMatrix, perMasks);
     } else {
-        this->drawGlyphRunAsFullpixelMask(cache, glyphRun, origin, deviceMatrix, perMask);
+        this->drawGlyphRunAsFullpixelMask(cache, glyphRun, origin, deviceMatrix, perMasks);
     }
 }
 
@@ -458,6 +670,24 @@ void GrTextContext::AppendGlyph(GrTextBlob* blob, int runIndex,
 }
 
 
+// The smallest scale, relative to viewMatrix, at which SkDraw::ShouldDrawTextAsPaths() still
+// holds for the paint; this mirrors SkPaint::TooBigToUseCache().  Hairlines and perspective are
+// always drawn as paths.
+static SkScalar min_path_scale(const SkPaint& paint, const SkMatrix& viewMatrix) {
+    if ((SkPaint::kStroke_Style == paint.getStyle() && 0 == paint.getStrokeWidth()) ||
+        viewMatrix.hasPerspective()) {
+        return 0;
+    }
+    SkMatrix textM;
+    SkPaintPriv::MakeTextMatrix(&textM, paint);
+    textM.postConcat(viewMatrix);
+    SkScalar maxLength =
+            SkTMax(SkPoint::Length(textM[SkMatrix::kMScaleX], textM[SkMatrix::kMSkewY]),
+                   SkPoint::Length(textM[SkMatrix::kMSkewX], textM[SkMatrix::kMScaleY]));
+    SkScalar limit = SkIntToScalar(SkTMin(SkGraphics::GetFontCachePointSizeLimit(), 1024));
+    return maxLength > 0 ? limit / maxLength : 0;
+}
+
 void GrTextContext::regenerateGlyphRunList(GrTextBlob* cacheBlob,
                                            GrGlyphCache* glyphCache,
                                            const GrShaderCaps& shaderCaps,
@@ -568,8 +798,8 @@ void GrTextContext::regenerateGlyphRunList(GrTextBlob* cacheBlob,
         } else if (SkDraw::ShouldDrawTextAsPaths(runPaint, viewMatrix)) {
             // The glyphs are big, so use paths to draw them.
 
-            // Ensure the blob is set for bitmaptext
-            cacheBlob->setHasBitmap();
+            // Paths can be reused at any larger scale.
+            cacheBlob->setHasPaths(min_path_scale(runPaint, viewMatrix));
 
             // setup our std runPaint, in hopes of getting hits in the cache
             SkPaint pathPaint(runPaint);
@@ -26,17 +26,18 @@ public:
     explicit SkGlyphRunListPainter(const GrRenderTargetContext& renderTargetContext);
 #endif
 
-    using PerMask = std::function<void(const SkMask&, const SkGlyph&, SkPoint)>;
-    using PerMaskCreator = std::function<PerMask(const SkPaint&, SkArenaAlloc* alloc)>;
+    // Called once per glyph run, with the masks of all of its glyphs that have images.
+    using PerMasks = std::function<void(SkSpan<const SkMask>)>;
+    using PerMasksCreator = std::function<PerMasks(const SkPaint&, SkArenaAlloc* alloc)>;
     using PerPath = std::function<void(const SkPath*, const SkGlyph&, SkPoint)>;
     using PerPathCreator = std::function<PerPath(
             const SkPaint&, SkScalar matrixScale, SkArenaAlloc* alloc)>;
     void drawForBitmapDevice(
             const SkGlyphRunList& glyphRunList, const SkMatrix& deviceMatrix,
-            PerMaskCreator perMaskCreator, PerPathCreator perPathCreator);
+            PerMasksCreator perMasksCreator, PerPathCreator perPathCreator);
     void drawUsingMasks(
             SkGlyphCache* cache, const SkGlyphRun& glyphRun, SkPoint origin,
-            const SkMatrix& deviceMatrix, PerMask perMask);
+            const SkMatrix& deviceMatrix, PerMasks perMasks);
     void drawUsingPaths(
             const SkGlyphRun& glyphRun, SkPoint origin, SkGlyphCache* cache, PerPath perPath) const;
 
@@ -76,6 +77,13 @@ public:
 
 private:
     static bool ShouldDrawAsPath(const SkPaint& paint, const SkMatrix& matrix);
+
+    // Sets up the paint for a strike of distance fields to draw the run with, and the scale
+    // from it to the run's text size. Returns false if the run should be drawn with masks.
+    static bool ShouldDrawAsSDF(const SkPaint& runPaint, const SkMatrix& matrix,
+                                const SkSurfaceProps& props, SkPaint* sdfPaint,
+                                SkScalar* textScale);
+
     bool ensureBitmapBuffers(size_t runSize);
 
     void processARGBFallback(
@@ -87,15 +95,29 @@ private:
             const SkGlyphRun& glyphRun, SkPoint origin, const SkMatrix& deviceMatrix,
             SkGlyphCacheInterface* cache, EachGlyph eachGlyph);
 
+    // Fills fMasks for the glyphs at the finite points of fPositions, returning how many there
+    // are. Glyphs without images have them all rasterized at once by the cache.
+    template <typename LookupGlyph>
+    size_t prepareMasks(
+            SkGlyphCache* cache, SkSpan<const SkGlyphID> glyphIDs, LookupGlyph&& lookupGlyph);
+
     void drawGlyphRunAsSubpixelMask(
             SkGlyphCache* cache, const SkGlyphRun& glyphRun,
             SkPoint origin, const SkMatrix& deviceMatrix,
-            PerMask perMask);
+            PerMasks perMasks);
 
     void drawGlyphRunAsFullpixelMask(
             SkGlyphCache* cache, const SkGlyphRun& glyphRun,
             SkPoint origin, const SkMatrix& deviceMatrix,
-            PerMask perMask);
+            PerMasks perMasks);
+
+    // Shades A8 masks for the glyphs from the distance fields in cache, scaled by textScale.
+    // Returns false without drawing anything if some glyph has no distance field, e.g. because
+    // it is a color glyph.
+    bool drawGlyphRunAsSDF(
+            SkGlyphCache* cache, const SkGlyphRun& glyphRun,
+            SkPoint origin, const SkMatrix& deviceMatrix, SkScalar textScale,
+            PerMasks perMasks);
 
     // The props as on the actual device.
     const SkSurfaceProps fDeviceProps;
@@ -105,6 +127,8 @@ private:
     const SkScalerContextFlags fScalerContextFlags;
     size_t fMaxRunSize{0};
     SkAutoTMalloc<SkPoint> fPositions;
+    SkAutoTMalloc<SkMask> fMasks;
+    SkAutoTMalloc<const SkGlyph*> fGlyphs;
 
     // Vectors for tracking ARGB fallback information.
     std::vector<SkGlyphID> fARGBGlyphsIDs;
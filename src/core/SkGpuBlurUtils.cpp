@@ -38,23 +38,19 @@ static void scale_irect(SkIRect* rect, int xScale, int yScale) {
     rect->fBottom *= yScale;
 }
 
-#ifdef SK_DEBUG
-static inline int is_even(int x) { return !(x & 1); }
-#endif
-
-static void shrink_irect_by_2(SkIRect* rect, bool xAxis, bool yAxis) {
-    if (xAxis) {
-        SkASSERT(is_even(rect->fLeft) && is_even(rect->fRight));
-        rect->fLeft /= 2;
-        rect->fRight /= 2;
-    }
-    if (yAxis) {
-        SkASSERT(is_even(rect->fTop) && is_even(rect->fBottom));
-        rect->fTop /= 2;
-        rect->fBottom /= 2;
-    }
+static void shrink_irect(SkIRect* rect, int xDiv, int yDiv) {
+    SkASSERT(rect->fLeft % xDiv == 0 && rect->fRight % xDiv == 0);
+    SkASSERT(rect->fTop % yDiv == 0 && rect->fBottom % yDiv == 0);
+    rect->fLeft   /= xDiv;
+    rect->fTop    /= yDiv;
+    rect->fRight  /= xDiv;
+    rect->fBottom /= yDiv;
 }
 
+// The largest downsample done in one pass after the first. A pass that shrinks by more than 2 on
+// either axis box filters with nearest samples rather than a single bilinear one.
+static constexpr int kMaxDecimateStep = 4;
+
 static float adjust_sigma(float sigma, int maxTextureSize, int *scaleFactor, int *radius) {
     *scaleFactor = 1;
     while (sigma > MAX_BLUR_SIGMA) {
@@ -275,8 +271,15 @@ static sk_sp<GrTextureProxy> decimate(GrContext* context,
 
     sk_sp<GrRenderTargetContext> dstRenderTargetContext;
 
-    for (int i = 1; i < scaleFactorX || i < scaleFactorY; i *= 2) {
-        shrink_irect_by_2(&dstRect, i < scaleFactorX, i < scaleFactorY);
+    for (int i = 1, j = 1; i < scaleFactorX || j < scaleFactorY; ) {
+        // The first pass halves the content so that it can apply the texture domain with a
+        // bilinear sample. Later ones shrink by up to kMaxDecimateStep at once, which saves a
+        // render target (and a switch to it) for every two halvings large sigmas would need.
+        int stepX = 1 == i && 1 == j ? SkTMin(2, scaleFactorX / i)
+                                     : SkTMin(kMaxDecimateStep, scaleFactorX / i);
+        int stepY = 1 == i && 1 == j ? SkTMin(2, scaleFactorY / j)
+                                     : SkTMin(kMaxDecimateStep, scaleFactorY / j);
+        shrink_irect(&dstRect, stepX, stepY);
 
         // We know this will not be the final draw so we are free to make it an approx match.
         dstRenderTargetContext = context->contextPriv().makeDeferredRenderTargetContext(
@@ -291,15 +294,16 @@ static sk_sp<GrTextureProxy> decimate(GrContext* context,
         }
 
         GrPaint paint;
-        if (GrTextureDomain::kIgnore_Mode != mode && i == 1) {
+        bool boxFilter = false;
+        if (GrTextureDomain::kIgnore_Mode != mode && 1 == i && 1 == j) {
             // GrTextureDomainEffect does not support kRepeat_Mode with GrSamplerState::Filter.
             GrTextureDomain::Mode modeForScaling = GrTextureDomain::kRepeat_Mode == mode
                                                                 ? GrTextureDomain::kDecal_Mode
                                                                 : mode;
 
             SkRect domain = SkRect::Make(*contentRect);
-            domain.inset((i < scaleFactorX) ? SK_ScalarHalf : 0.0f,
-                         (i < scaleFactorY) ? SK_ScalarHalf : 0.0f);
+            domain.inset((stepX > 1) ? SK_ScalarHalf : 0.0f,
+                         (stepY > 1) ? SK_ScalarHalf : 0.0f);
             auto fp = GrTextureDomainEffect::Make(std::move(src),
                                                   SkMatrix::I(),
                                                   domain,
@@ -310,22 +314,50 @@ static sk_sp<GrTextureProxy> decimate(GrContext* context,
             // TODO: consume the srcOffset in both first draws and always set it to zero
             // back in GaussianBlur
             srcOffset->set(0, 0);
-        } else {
+        } else if (stepX <= 2 && stepY <= 2) {
             paint.addColorTextureProcessor(std::move(src), SkMatrix::I(),
                                            GrSamplerState::ClampBilerp());
+        } else {
+            // Average each stepX x stepY block of texels, the same result as successive bilinear
+            // halvings would give. Shifting the sample point by half a texel along a shrinking
+            // axis lands every tap on a texel center.
+            SkScalar kernel[kMaxDecimateStep * kMaxDecimateStep];
+            for (int k = 0; k < stepX * stepY; ++k) {
+                kernel[k] = 1.0f / (stepX * stepY);
+            }
+            auto fp = GrMatrixConvolutionEffect::Make(std::move(src), srcRect,
+                                                      SkISize::Make(stepX, stepY), kernel,
+                                                      1.0f, 0.0f,
+                                                      SkIPoint::Make(stepX / 2, stepY / 2),
+                                                      GrTextureDomain::kIgnore_Mode, true);
+            paint.addColorFragmentProcessor(std::move(fp));
+            boxFilter = true;
         }
         paint.setPorterDuffXPFactory(SkBlendMode::kSrc);
 
         GrFixedClip clip(dstRect);
-        dstRenderTargetContext->fillRectToRect(clip, std::move(paint), GrAA::kNo,
-                                               SkMatrix::I(), SkRect::Make(dstRect),
-                                               SkRect::Make(srcRect));
+        if (boxFilter) {
+            SkMatrix localMatrix = SkMatrix::MakeRectToRect(SkRect::Make(dstRect),
+                                                            SkRect::Make(srcRect),
+                                                            SkMatrix::kFill_ScaleToFit);
+            localMatrix.postTranslate((stepX > 1) ? SK_ScalarHalf : 0.0f,
+                                      (stepY > 1) ? SK_ScalarHalf : 0.0f);
+            dstRenderTargetContext->fillRectWithLocalMatrix(clip, std::move(paint), GrAA::kNo,
+                                                            SkMatrix::I(), SkRect::Make(dstRect),
+                                                            localMatrix);
+        } else {
+            dstRenderTargetContext->fillRectToRect(clip, std::move(paint), GrAA::kNo,
+                                                   SkMatrix::I(), SkRect::Make(dstRect),
+                                                   SkRect::Make(srcRect));
+        }
 
         src = dstRenderTargetContext->asTextureProxyRef();
         if (!src) {
             return nullptr;
         }
         srcRect = dstRect;
+        i *= stepX;
+        j *= stepY;
     }
 
     *contentRect = dstRect;
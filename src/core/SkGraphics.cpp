@@ -12,20 +12,27 @@
 #include "SkCpu.h"
 #include "SkGeometry.h"
 #include "SkImageFilter.h"
+#include "SkImageFilterCache.h"
+#include "SkMaskCache.h"
 #include "SkMath.h"
 #include "SkMatrix.h"
+#include "SkMemoryAccounting.h"
+#include "SkMemoryPressure.h"
 #include "SkOpts.h"
 #include "SkPath.h"
 #include "SkPathEffect.h"
 #include "SkPixelRef.h"
+#include "SkRasterPipeline.h"
 #include "SkRefCnt.h"
 #include "SkResourceCache.h"
 #include "SkScalerContext.h"
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkStrikeCache.h"
+#include "SkString.h"
 #include "SkTSearch.h"
 #include "SkTime.h"
+#include "SkTraceMemoryDump.h"
 #include "SkTypefaceCache.h"
 #include "SkUTF.h"
 
@@ -53,15 +60,65 @@ void SkGraphics::Init() {
 
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
+  SkMaskCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkMemoryAccounting::DumpMemoryStatistics(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
+    SkGraphics::PurgeRasterPipelineCache();
     SkImageFilter::PurgeCache();
 }
 
+DECLARE_SKMESSAGEBUS_MESSAGE(SkMemoryPressureMessage)
+
+size_t SkGraphics::OnMemoryPressure(MemoryPressure level, SkTraceMemoryDump* dump) {
+    size_t totalFreed = 0;
+    auto report = [&](const char* cache, size_t freed) {
+        totalFreed += freed;
+        if (dump) {
+            SkString name;
+            name.printf("skia/memory_pressure/%s", cache);
+            dump->dumpNumericValue(name.c_str(), "freed_size", "bytes", freed);
+        }
+    };
+
+    // Glyphs and scaled or decoded images are the cheapest to remake, filtered images the
+    // dearest.
+    SkStrikeCache* strikes = SkStrikeCache::GlobalStrikeCache();
+    report("glyph_cache",
+           strikes->purgeBytes(SkMemoryPressureShare(level, strikes->getTotalMemoryUsed(), 1, 2)));
+    report("resource_cache",
+           SkResourceCache::PurgeBytes(
+                   SkMemoryPressureShare(level, SkResourceCache::GetTotalBytesUsed(), 1, 2)));
+    SkImageFilterCache* filters = SkImageFilterCache::Get();
+    report("image_filter_cache",
+           filters->purgeBytes(SkMemoryPressureShare(level, filters->bytesUsed(), 1, 4)));
+
+    // These are small, and only worth dropping when every byte counts.
+    if (MemoryPressure::kCritical == level) {
+        SkTypefaceCache::PurgeAll();
+        SkGraphics::PurgeRasterPipelineCache();
+    }
+
+    SkMessageBus<SkMemoryPressureMessage>::Post({level});
+    return totalFreed;
+}
+
+int64_t SkGraphics::GetRasterPipelineCacheHits() {
+    return SkRasterPipeline::ProgramCacheHits();
+}
+
+int64_t SkGraphics::GetRasterPipelineCacheMisses() {
+    return SkRasterPipeline::ProgramCacheMisses();
+}
+
+void SkGraphics::PurgeRasterPipelineCache() {
+    SkRasterPipeline::PurgeProgramCache();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const char kFontCacheLimitStr[] = "font-cache-limit";
@@ -146,3 +203,11 @@ void SkGraphics::PurgeFontCache() {
     SkStrikeCache::GlobalStrikeCache()->purgeAll();
     SkTypefaceCache::PurgeAll();
 }
+
+void SkGraphics::SetPersistentFontCache(PersistentFontCache* cache) {
+    SkStrikeCache::GlobalStrikeCache()->setPersistentCache(cache);
+}
+
+void SkGraphics::StoreFontCache() {
+    SkStrikeCache::GlobalStrikeCache()->storeAll();
+}
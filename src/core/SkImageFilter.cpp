@@ -8,6 +8,7 @@
 #include "SkImageFilter.h"
 
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkFuzzLogging.h"
 #include "SkImageFilterCache.h"
 #include "SkLocalMatrixImageFilter.h"
@@ -20,6 +21,7 @@
 #include "SkValidationUtils.h"
 #include "SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
+#include "GrColorSpaceInfo.h"
 #include "GrColorSpaceXform.h"
 #include "GrContext.h"
 #include "GrFixedClip.h"
@@ -237,6 +239,19 @@ bool SkImageFilter::canComputeFastBounds() const {
     return true;
 }
 
+bool SkImageFilter::canFilterInTiles() const {
+    if (!this->onCanFilterInTiles()) {
+        return false;
+    }
+    for (int i = 0; i < this->countInputs(); i++) {
+        SkImageFilter* input = this->getInput(i);
+        if (input && !input->canFilterInTiles()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 #if SK_SUPPORT_GPU
 sk_sp<SkSpecialImage> SkImageFilter::DrawWithFP(GrContext* context,
                                                 std::unique_ptr<GrFragmentProcessor> fp,
@@ -309,6 +324,23 @@ bool SkImageFilter::applyCropRect(const Context& ctx, const SkIRect& srcBounds,
 }
 
 #if SK_SUPPORT_GPU
+std::unique_ptr<GrFragmentProcessor> SkImageFilter::MakeColorFilteredFP(
+        GrContext* context, std::unique_ptr<GrFragmentProcessor> fp, SkColorFilter* colorFilter,
+        const OutputProperties& outProps) {
+    if (!colorFilter || !fp) {
+        return fp;
+    }
+    GrColorSpaceInfo colorSpaceInfo(sk_ref_sp(outProps.colorSpace()),
+                                    SkColorType2GrPixelConfig(outProps.colorType()));
+    std::unique_ptr<GrFragmentProcessor> colorFilterFP =
+            colorFilter->asFragmentProcessor(context, colorSpaceInfo);
+    if (!colorFilterFP) {
+        return nullptr;
+    }
+    std::unique_ptr<GrFragmentProcessor> series[] = { std::move(fp), std::move(colorFilterFP) };
+    return GrFragmentProcessor::RunInSeries(series, 2);
+}
+
 sk_sp<SkSpecialImage> SkImageFilter::ImageToColorSpace(SkSpecialImage* src,
                                                        const OutputProperties& outProps) {
     // There are several conditions that determine if we actually need to convert the source to the
@@ -461,6 +493,24 @@ sk_sp<SkSpecialImage> SkImageFilter::filterInput(int index,
     return result;
 }
 
+sk_sp<SkSpecialImage> SkImageFilter::filterInputDeferringColorFilter(
+        int index, SkSpecialImage* src, const Context& ctx, SkIPoint* offset,
+        sk_sp<SkColorFilter>* colorFilter) const {
+    colorFilter->reset();
+    SkImageFilter* input = this->getInput(index);
+    SkColorFilter* inputCF;
+    if (!input || !input->isColorFilterNode(&inputCF)) {
+        return this->filterInput(index, src, ctx, offset);
+    }
+    colorFilter->reset(inputCF);
+    if ((*colorFilter)->affectsTransparentBlack()) {
+        // The node fills its whole clip, not just its input's bounds, so it needs its own pass.
+        colorFilter->reset();
+        return this->filterInput(index, src, ctx, offset);
+    }
+    return input->filterInput(0, src, this->mapContext(ctx), offset);
+}
+
 void SkImageFilter::PurgeCache() {
     SkImageFilterCache::Get()->purge();
 }
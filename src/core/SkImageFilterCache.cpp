@@ -104,6 +104,20 @@ public:
         }
     }
 
+    size_t purgeBytes(size_t bytes) override {
+        SkAutoMutexAcquire mutex(fMutex);
+        const size_t before = fCurrentBytes;
+        while (fCurrentBytes > 0 && before - fCurrentBytes < bytes) {
+            this->removeInternal(fLRU.tail());
+        }
+        return before - fCurrentBytes;
+    }
+
+    size_t bytesUsed() const override {
+        SkAutoMutexAcquire mutex(fMutex);
+        return fCurrentBytes;
+    }
+
     void purgeByImageFilter(const SkImageFilter* filter) override {
         SkAutoMutexAcquire mutex(fMutex);
         auto* values = fImageFilterValues.find(filter);
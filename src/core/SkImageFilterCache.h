@@ -60,6 +60,9 @@ public:
                      const SkIPoint& offset, const SkImageFilter* filter) = 0;
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
+    // Purges at least bytes, least recently used first, and returns the number of bytes freed.
+    virtual size_t purgeBytes(size_t bytes) = 0;
+    virtual size_t bytesUsed() const = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
 };
 
@@ -66,6 +66,13 @@ sk_sp<GrTextureProxy> SkImageGenerator::generateTexture(GrContext* ctx, const Sk
     return this->onGenerateTexture(ctx, info, origin, willNeedMipMaps);
 }
 
+bool SkImageGenerator::getYUVATextures(GrContext* ctx, YUVATextures* textures) {
+    SkASSERT(ctx);
+    SkASSERT(textures);
+
+    return this->onGetYUVATextures(ctx, textures);
+}
+
 sk_sp<GrTextureProxy> SkImageGenerator::onGenerateTexture(GrContext*, const SkImageInfo&,
                                                           const SkIPoint&,
                                                           bool willNeedMipMaps) {
@@ -9,7 +9,7 @@
 #define SkLRUCache_DEFINED
 
 #include "SkChecksum.h"
-#include "SkTHash.h"
+#include "SkTFlatHash.h"
 #include "SkTInternalLList.h"
 
 /**
@@ -107,9 +107,9 @@ private:
         delete entry;
     }
 
-    int                             fMaxCount;
-    SkTHashTable<Entry*, K, Traits> fMap;
-    SkTInternalLList<Entry>         fLRU;
+    int                                 fMaxCount;
+    SkTFlatHashTable<Entry*, K, Traits> fMap;
+    SkTInternalLList<Entry>             fLRU;
 };
 
 #endif
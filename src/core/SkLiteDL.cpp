@@ -496,6 +496,64 @@ namespace {
     };
 }
 
+namespace {
+    // What GrRenderTargetOpList needs to match to combine two draws, roughly: the kind of op,
+    // the texture it samples, and the paint's blend and effects.  Colors are free to vary.
+    enum class BatchKind : uint8_t { kGeometry, kImage, kText };
+
+    uint64_t batch_key(BatchKind kind, uint32_t textureID, const SkPaint& paint) {
+        uint32_t bits = (uint32_t)paint.getBlendMode()
+                      | (uint32_t)paint.isAntiAlias()                  <<  8
+                      | (uint32_t)paint.getStyle()                     <<  9
+                      | (uint32_t)(paint.getShader()      != nullptr) << 11
+                      | (uint32_t)(paint.getColorFilter() != nullptr) << 12
+                      | (uint32_t)(paint.getMaskFilter()  != nullptr) << 13
+                      | (uint32_t)kind                                 << 24;
+        return (uint64_t)textureID << 32 | bits;
+    }
+
+    // Fills in bounds and key for draws that may be reordered, returning false for all other ops.
+    bool batch_info(const SkRect& geometry, BatchKind kind, uint32_t textureID,
+                    const SkPaint& paint, SkRect* bounds, uint64_t* key) {
+        if (!paint.canComputeFastBounds()) {
+            return false;
+        }
+        SkRect storage;
+        *bounds = paint.computeFastBounds(geometry.makeSorted(), &storage);
+        *key    = batch_key(kind, textureID, paint);
+        return bounds->isFinite();
+    }
+
+    template <typename T>
+    bool batch_info(const T&, SkRect*, uint64_t*) { return false; }
+
+    bool batch_info(const DrawRect& op, SkRect* bounds, uint64_t* key) {
+        return batch_info(op.rect, BatchKind::kGeometry, 0, op.paint, bounds, key);
+    }
+    bool batch_info(const DrawOval& op, SkRect* bounds, uint64_t* key) {
+        return batch_info(op.oval, BatchKind::kGeometry, 0, op.paint, bounds, key);
+    }
+    bool batch_info(const DrawRRect& op, SkRect* bounds, uint64_t* key) {
+        return batch_info(op.rrect.getBounds(), BatchKind::kGeometry, 0, op.paint, bounds, key);
+    }
+    bool batch_info(const DrawPath& op, SkRect* bounds, uint64_t* key) {
+        return !op.path.isInverseFillType() &&
+               batch_info(op.path.getBounds(), BatchKind::kGeometry, 0, op.paint, bounds, key);
+    }
+    bool batch_info(const DrawImage& op, SkRect* bounds, uint64_t* key) {
+        SkRect dst = SkRect::MakeXYWH(op.x, op.y, op.image->width(), op.image->height());
+        return batch_info(dst, BatchKind::kImage, op.image->uniqueID(), op.paint, bounds, key);
+    }
+    bool batch_info(const DrawImageRect& op, SkRect* bounds, uint64_t* key) {
+        return batch_info(op.dst, BatchKind::kImage, op.image->uniqueID(), op.paint, bounds, key);
+    }
+    bool batch_info(const DrawTextBlob& op, SkRect* bounds, uint64_t* key) {
+        // Glyphs all come from the same few atlases.
+        return batch_info(op.blob->bounds().makeOffset(op.x, op.y), BatchKind::kText, 0,
+                          op.paint, bounds, key);
+    }
+}
+
 template <typename T, typename... Args>
 void* SkLiteDL::push(size_t pod, Args&&... args) {
     size_t skip = SkAlignPtr(sizeof(T) + pod);
@@ -508,10 +566,16 @@ void* SkLiteDL::push(size_t pod, Args&&... args) {
     }
     SkASSERT(fUsed + skip <= fReserved);
     auto op = (T*)(fBytes.get() + fUsed);
-    fUsed += skip;
     new (op) T{ std::forward<Args>(args)... };
     op->type = (uint32_t)T::kType;
     op->skip = skip;
+
+    DrawInfo info;
+    if (batch_info(*op, &info.fBounds, &info.fKey)) {
+        info.fOffset = fUsed;
+        fDrawInfo.push_back(info);
+    }
+    fUsed += skip;
     return op+1;
 }
 
@@ -710,6 +774,90 @@ void SkLiteDL::draw(SkCanvas* canvas) const {
     this->map(draw_fns, canvas, canvas->getTotalMatrix());
 }
 
+void SkLiteDL::drawInBatchOrder(SkCanvas* canvas) const {
+    SkAutoCanvasRestore acr(canvas, false);
+    const SkMatrix original = canvas->getTotalMatrix();
+
+    const uint8_t* base = fBytes.get();
+    const uint8_t* end  = base + fUsed;
+    int next = 0;   // The first fDrawInfo entry we haven't drawn yet.
+    for (const uint8_t* ptr = base; ptr < end; ) {
+        auto op = (const Op*)ptr;
+        if (next < fDrawInfo.count() && fDrawInfo[next].fOffset == (size_t)(ptr - base)) {
+            // Extend the run over every reorderable draw that immediately follows.
+            int first = next++;
+            ptr += op->skip;
+            while (next < fDrawInfo.count() && fDrawInfo[next].fOffset == (size_t)(ptr - base)) {
+                ptr += ((const Op*)ptr)->skip;
+                next++;
+            }
+            this->drawRun(canvas, original, first, next);
+            continue;
+        }
+        draw_fns[op->type](op, canvas, original);
+        ptr += op->skip;
+    }
+}
+
+void SkLiteDL::drawRun(SkCanvas* canvas, const SkMatrix& original, int first, int last) const {
+    auto draw = [&](int i) {
+        auto op = (const Op*)(fBytes.get() + fDrawInfo[i].fOffset);
+        draw_fns[op->type](op, canvas, original);
+    };
+    const int count = last - first;
+    if (count < 3) {
+        for (int i = first; i < last; i++) {
+            draw(i);
+        }
+        return;
+    }
+
+    // The matrix and clip don't change within a run, so we compare bounds in device space.
+    // They're outset a pixel so that two antialiased draws sharing an edge pixel stay in order.
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+
+    // Like GrRenderTargetOpList, we look back over a few batches for one to join.  A draw may
+    // join a batch only if it doesn't touch any batch after it; otherwise it starts a new one.
+    constexpr int kMaxBatchLookback = 10;
+    struct Batch {
+        uint64_t fKey;
+        SkRect   fBounds;
+        int      fHead, fTail;
+    };
+    SkTDArray<Batch> batches;
+    SkAutoSTMalloc<32, int> nextInBatch(count);
+
+    for (int i = 0; i < count; i++) {
+        const DrawInfo& info = fDrawInfo[first + i];
+        SkRect bounds = ctm.mapRect(info.fBounds).makeOutset(1, 1);
+        nextInBatch[i] = -1;
+
+        Batch* join = nullptr;
+        for (int b = batches.count() - 1; b >= SkTMax(0, batches.count() - kMaxBatchLookback); b--) {
+            if (batches[b].fKey == info.fKey) {
+                join = &batches[b];
+                break;
+            }
+            if (SkRect::Intersects(batches[b].fBounds, bounds)) {
+                break;
+            }
+        }
+        if (join) {
+            nextInBatch[join->fTail] = i;
+            join->fTail = i;
+            join->fBounds.join(bounds);
+        } else {
+            batches.push_back({info.fKey, bounds, i, i});
+        }
+    }
+
+    for (const Batch& batch : batches) {
+        for (int i = batch.fHead; i >= 0; i = nextInBatch[i]) {
+            draw(first + i);
+        }
+    }
+}
+
 SkLiteDL::~SkLiteDL() {
     this->reset();
 }
@@ -719,4 +867,5 @@ void SkLiteDL::reset() {
 
     // Leave fBytes and fReserved alone.
     fUsed   = 0;
+    fDrawInfo.rewind();
 }
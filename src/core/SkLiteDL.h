@@ -22,6 +22,12 @@ public:
 
     void draw(SkCanvas* canvas) const;
 
+    // Like draw(), but within each run of draws with no state changes between them, draws that
+    // would batch together on the GPU are pulled next to each other.  A draw only moves ahead of
+    // draws it can't touch, so the result matches draw().  GrRenderTargetOpList only looks back
+    // a few ops to combine them, so this helps frames that interleave e.g. text and images.
+    void drawInBatchOrder(SkCanvas* canvas) const;
+
     void reset();
     bool empty() const { return fUsed == 0; }
 
@@ -80,15 +86,25 @@ public:
     void drawShadowRec(const SkPath&, const SkDrawShadowRec&);
 
 private:
+    // Recorded for each draw that may be reordered.
+    struct DrawInfo {
+        size_t   fOffset;   // Of the op in fBytes.
+        SkRect   fBounds;   // Local bounds, including the paint's effects.
+        uint64_t fKey;      // Draws with equal keys may batch together.
+    };
+
     template <typename T, typename... Args>
     void* push(size_t, Args&&...);
 
     template <typename Fn, typename... Args>
     void map(const Fn[], Args...) const;
 
+    void drawRun(SkCanvas*, const SkMatrix& original, int first, int last) const;
+
     SkAutoTMalloc<uint8_t> fBytes;
     size_t                 fUsed = 0;
     size_t                 fReserved = 0;
+    SkTDArray<DrawInfo>    fDrawInfo;
 };
 
 #endif//SkLiteDL_DEFINED
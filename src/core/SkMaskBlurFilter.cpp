@@ -12,6 +12,7 @@
 #include "SkGaussFilter.h"
 #include "SkMalloc.h"
 #include "SkNx.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 
@@ -21,6 +22,9 @@
 namespace {
 static const double kPi = 3.14159265358979323846264338327950288;
 
+// The triple box blur can run kLanes rows side by side, one row per lane of an Sk4u.
+static constexpr int kLanes = 4;
+
 class PlanGauss final {
 public:
     explicit PlanGauss(double sigma) {
@@ -211,6 +215,87 @@ public:
         uint32_t* fBuffer2End;
     };
 
+    // A window of one has empty passes, which only Scan handles.
+    bool canBlurLanes() const { return fPass0Size > 0 && fPass1Size > 0 && fPass2Size > 0; }
+
+    // The lanes of blurLanes() need kLanes times the buffer of a Scan.
+    size_t laneBufferSize() const { return kLanes * this->bufferSize(); }
+
+    // Blurs kLanes rows at once, producing for each exactly what Scan::blur() would. Row k of
+    // the source is srcW values starting at src + k * srcStride. Output value i of all the rows
+    // is stored contiguously at dst + i * dstStride, for i in [0, dstW), so the blur also
+    // transposes kLanes by dstW into dstW rows of kLanes.
+    void blurLanes(const uint8_t* src, size_t srcStride, int srcW,
+                   uint8_t* dst, size_t dstStride, int dstW, uint32_t* buffer) const {
+        SkASSERT(this->canBlurLanes());
+        uint32_t* buffer0    = buffer;
+        uint32_t* buffer0End = buffer0 + kLanes * fPass0Size;
+        uint32_t* buffer1    = buffer0End;
+        uint32_t* buffer1End = buffer1 + kLanes * fPass1Size;
+        uint32_t* buffer2    = buffer1End;
+        uint32_t* buffer2End = buffer2 + kLanes * fPass2Size;
+        int noChangeCount = fSlidingWindow > srcW ? fSlidingWindow - srcW : 0;
+
+        uint32_t *buffer0Cursor, *buffer1Cursor, *buffer2Cursor;
+        Sk4u sum0, sum1, sum2;
+        auto reset = [&] {
+            sk_bzero(buffer, (buffer2End - buffer0) * sizeof(*buffer));
+            buffer0Cursor = buffer0;
+            buffer1Cursor = buffer1;
+            buffer2Cursor = buffer2;
+            sum0 = sum1 = sum2 = 0;
+        };
+
+        // The weight is less than 2^32 for any window over one, so the mulHi() and the high bit
+        // of the low half of the product are the same as (fWeight * sum + kHalf) >> 32.
+        const Sk4u weight = SkTo<uint32_t>(fWeight);
+        auto step = [&](const Sk4u& leadingEdge, uint8_t* to) {
+            sum0 = sum0 + leadingEdge;
+            sum1 = sum1 + sum0;
+            sum2 = sum2 + sum1;
+
+            SkNx_cast<uint8_t>(sum2.mulHi(weight) + ((sum2 * weight) >> 31)).store(to);
+
+            sum2 = sum2 - Sk4u::Load(buffer2Cursor);
+            sum1.store(buffer2Cursor);
+            buffer2Cursor += kLanes;
+            buffer2Cursor = buffer2Cursor < buffer2End ? buffer2Cursor : buffer2;
+
+            sum1 = sum1 - Sk4u::Load(buffer1Cursor);
+            sum0.store(buffer1Cursor);
+            buffer1Cursor += kLanes;
+            buffer1Cursor = buffer1Cursor < buffer1End ? buffer1Cursor : buffer1;
+
+            sum0 = sum0 - Sk4u::Load(buffer0Cursor);
+            leadingEdge.store(buffer0Cursor);
+            buffer0Cursor += kLanes;
+            buffer0Cursor = buffer0Cursor < buffer0End ? buffer0Cursor : buffer0;
+        };
+
+        auto load = [&](int x) {
+            const uint8_t* s = src + x;
+            return Sk4u{s[0 * srcStride], s[1 * srcStride], s[2 * srcStride], s[3 * srcStride]};
+        };
+
+        // Consume the source generating pixels.
+        reset();
+        int x = 0;
+        for (; x < srcW; ++x) {
+            step(load(x), dst + x * dstStride);
+        }
+
+        // The leading edge is off the right side of the mask.
+        for (int i = 0; i < noChangeCount; ++i, ++x) {
+            step(0, dst + x * dstStride);
+        }
+
+        // Starting from the right, fill in the rest of the buffer.
+        reset();
+        for (int i = dstW - 1, s = srcW - 1; i >= x; --i, --s) {
+            step(load(s), dst + i * dstStride);
+        }
+    }
+
     Scan makeBlurScan(int width, uint32_t* buffer) const {
         uint32_t* buffer0, *buffer0End, *buffer1, *buffer1End, *buffer2, *buffer2End;
         buffer0 = buffer;
@@ -949,6 +1034,61 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// Blurs rows [y, yEnd) of an A8 source, transposing them into dst. It goes kLanes rows at a time
+// when the plan allows it and finishes any remaining rows one by one.
+static void blur_a8_rows(const PlanGauss& plan, int y, int yEnd,
+                         const uint8_t* src, size_t srcStride, int srcW,
+                         uint8_t* dst, size_t dstStride, int dstW,
+                         uint32_t* buffer, uint32_t* laneBuffer) {
+    if (plan.canBlurLanes()) {
+        for (; y + kLanes <= yEnd; y += kLanes) {
+            plan.blurLanes(src + y * srcStride, srcStride, srcW,
+                           dst + y, dstStride, dstW, laneBuffer);
+        }
+    }
+
+    const PlanGauss::Scan& scan = plan.makeBlurScan(srcW, buffer);
+    for (; y < yEnd; ++y) {
+        const uint8_t* row = src + y * srcStride;
+        uint8_t* dstStart = dst + y;
+        scan.blur(row, row + srcW, dstStart, dstStride, dstStart + dstStride * dstW);
+    }
+}
+
+// Below this many output values, a pass is not worth splitting across threads.
+static constexpr int kMinBlurValuesPerTask = 128 * 1024;
+
+// blur_a8_rows() for all srcH rows. Big blurs are split into bands of rows, each with its own
+// buffers, which run as tasks on the default SkExecutor.
+static void blur_a8_all_rows(const PlanGauss& plan,
+                             const uint8_t* src, size_t srcStride, int srcW, int srcH,
+                             uint8_t* dst, size_t dstStride, int dstW) {
+    int64_t values = SkTo<int64_t>(srcH) * dstW;
+    int tasks = SkTo<int>(std::min<int64_t>(values / kMinBlurValuesPerTask,
+                                            (srcH + kLanes - 1) / kLanes));
+    if (tasks <= 1) {
+        SkAutoTMalloc<uint32_t> buffer(plan.bufferSize()),
+                                laneBuffer(plan.laneBufferSize());
+        blur_a8_rows(plan, 0, srcH, src, srcStride, srcW, dst, dstStride, dstW,
+                     buffer.get(), laneBuffer.get());
+        return;
+    }
+
+    // Keep each band a whole number of lanes.
+    int rowsPerTask = ((srcH + tasks - 1) / tasks + kLanes - 1) / kLanes * kLanes;
+
+    SkTaskGroup tg;
+    tg.batch(tasks, [&](int i) {
+        int y    = std::min(srcH, i * rowsPerTask),
+            yEnd = std::min(srcH, y + rowsPerTask);
+        SkAutoTMalloc<uint32_t> buffer(plan.bufferSize()),
+                                laneBuffer(plan.laneBufferSize());
+        blur_a8_rows(plan, y, yEnd, src, srcStride, srcW, dst, dstStride, dstW,
+                     buffer.get(), laneBuffer.get());
+    });
+    tg.wait();
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
 SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
@@ -1003,15 +1143,9 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
                 scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
             }
         } break;
-        case SkMask::kA8_Format: {
-            const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
+        case SkMask::kA8_Format:
+            blur_a8_all_rows(planW, src.fImage, src.fRowBytes, srcW, srcH, tmp, tmpW, tmpH);
+            break;
         case SkMask::kARGB32_Format: {
             const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
             auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
@@ -1036,14 +1170,7 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
-
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
-    }
+    blur_a8_all_rows(planH, tmp, tmpW, tmpW, tmpH, dst->fImage, dst->fRowBytes, dstH);
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
@@ -6,6 +6,12 @@
  */
 
 #include "SkMaskCache.h"
+#include "SkMutex.h"
+#include "SkPathPriv.h"
+#include "SkTHash.h"
+#include "SkTraceMemoryDump.h"
+
+#include <atomic>
 
 #define CHECK_LOCAL(localCache, localName, globalName, ...) \
     ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
@@ -183,3 +189,178 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
     RectsBlurKey key(sigma, style, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathMaskKeyNamespaceLabel;
+static unsigned gPathSightingKeyNamespaceLabel;
+
+static std::atomic<int64_t> gPathMaskHits{0},
+                            gPathMaskMisses{0};
+
+static uint64_t path_mask_shared_id(const SkPath& path) {
+    uint64_t sharedID = SkSetFourByteTag('p', 'm', 's', 'k');
+    return (sharedID << 32) | path.getGenerationID();
+}
+
+struct PathMaskKey : public SkResourceCache::Key {
+public:
+    PathMaskKey(const SkPath& path, const SkMatrix& matrix, SkScalar sigma, SkBlurStyle style,
+                void* nameSpace = &gPathMaskKeyNamespaceLabel)
+        : fGenID(path.getGenerationID())
+        , fFillType(path.getFillType())
+        , fSigma(sigma)
+        , fStyle(style)
+        , fMatrix{ matrix.getScaleX(), matrix.getSkewX(), matrix.getTranslateX(),
+                   matrix.getSkewY(), matrix.getScaleY(), matrix.getTranslateY() }
+    {
+        this->init(nameSpace, path_mask_shared_id(path),
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fSigma) + sizeof(fStyle) +
+                   sizeof(fMatrix));
+    }
+
+    uint32_t    fGenID;
+    int32_t     fFillType;
+    SkScalar    fSigma;
+    int32_t     fStyle;
+    SkScalar    fMatrix[6];
+};
+
+struct PathMaskRec : public SkResourceCache::Rec {
+    PathMaskRec(PathMaskKey key, const SkMask& mask, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathMaskRec() override {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathMaskKey    fKey;
+    MaskValue      fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "path-mask"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathMaskRec& rec = static_cast<const PathMaskRec&>(baseRec);
+        MaskValue* result = static_cast<MaskValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+
+// Remembers that a path mask key was asked for, without holding a mask.
+struct PathSightingRec : public SkResourceCache::Rec {
+    explicit PathSightingRec(const PathMaskKey& key) : fKey(key) {}
+
+    PathMaskKey    fKey;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this); }
+    const char* getCategory() const override { return "path-mask-sighting"; }
+
+    static bool Visitor(const SkResourceCache::Rec&, void*) { return true; }
+};
+
+// Generation IDs of the paths that already have a PathMaskInvalidator. Each path gets just one,
+// however many masks it has, so drawing it under ever new matrices doesn't grow its listeners.
+struct ListenedPaths {
+    SkMutex                 fMutex;
+    SkTHashSet<uint32_t>    fGenIDs;
+};
+
+static ListenedPaths* listened_paths() {
+    static ListenedPaths* gListened = new ListenedPaths;
+    return gListened;
+}
+
+// Drops a path's masks once the path changes, as its generation ID will never be drawn again.
+struct PathMaskInvalidator : public SkPathRef::GenIDChangeListener {
+    PathMaskInvalidator(uint32_t genID, uint64_t sharedID) : fGenID(genID), fSharedID(sharedID) {}
+
+    void onChange() override {
+        ListenedPaths* listened = listened_paths();
+        {
+            SkAutoMutexAcquire lock(listened->fMutex);
+            if (listened->fGenIDs.contains(fGenID)) {
+                listened->fGenIDs.remove(fGenID);
+            }
+        }
+        SkResourceCache::PostPurgeSharedID(fSharedID);
+    }
+
+    uint32_t fGenID;
+    uint64_t fSharedID;
+};
+
+static void listen_for_path_changes(const SkPath& path, uint64_t sharedID) {
+    const uint32_t genID = path.getGenerationID();
+    ListenedPaths* listened = listened_paths();
+    {
+        SkAutoMutexAcquire lock(listened->fMutex);
+        if (listened->fGenIDs.contains(genID)) {
+            return;
+        }
+        listened->fGenIDs.add(genID);
+    }
+    SkPathPriv::AddGenIDChangeListener(path, sk_make_sp<PathMaskInvalidator>(genID, sharedID));
+}
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                      SkScalar sigma, SkBlurStyle style, SkMask* mask,
+                                      SkResourceCache* localCache) {
+    MaskValue result;
+    PathMaskKey key(path, matrix, sigma, style);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathMaskRec::Visitor, &result)) {
+        gPathMaskMisses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    gPathMaskHits.fetch_add(1, std::memory_order_relaxed);
+
+    *mask = result.fMask;
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+void SkMaskCache::Add(const SkPath& path, const SkMatrix& matrix,
+                      SkScalar sigma, SkBlurStyle style, const SkMask& mask, SkCachedData* data,
+                      SkResourceCache* localCache) {
+    PathMaskKey key(path, matrix, sigma, style);
+    listen_for_path_changes(path, key.getSharedID());
+    return CHECK_LOCAL(localCache, add, Add, new PathMaskRec(key, mask, data));
+}
+
+bool SkMaskCache::SightPath(const SkPath& path, const SkMatrix& matrix,
+                            SkScalar sigma, SkBlurStyle style, SkResourceCache* localCache) {
+    PathMaskKey key(path, matrix, sigma, style, &gPathSightingKeyNamespaceLabel);
+    if (CHECK_LOCAL(localCache, find, Find, key, PathSightingRec::Visitor, nullptr)) {
+        return true;
+    }
+    listen_for_path_changes(path, key.getSharedID());
+    CHECK_LOCAL(localCache, add, Add, new PathSightingRec(key));
+    return false;
+}
+
+void SkMaskCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static const char* kDumpName = "skia/sk_resource_cache/path-mask";
+    dump->dumpNumericValue(kDumpName, "hits", "objects",
+                           gPathMaskHits.load(std::memory_order_relaxed));
+    dump->dumpNumericValue(kDumpName, "misses", "objects",
+                           gPathMaskMisses.load(std::memory_order_relaxed));
+}
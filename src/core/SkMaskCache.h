@@ -11,10 +11,14 @@
 #include "SkBlurTypes.h"
 #include "SkCachedData.h"
 #include "SkMask.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
 #include "SkRect.h"
 #include "SkResourceCache.h"
 #include "SkRRect.h"
 
+class SkTraceMemoryDump;
+
 class SkMaskCache {
 public:
     /**
@@ -29,6 +33,15 @@ public:
     static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style,
                                     const SkRect rects[], int count, SkMask* mask,
                                     SkResourceCache* localCache = nullptr);
+    /**
+     *  Path masks are keyed by the path's generation ID and fill type, the matrix that maps it to
+     *  the mask, and the blur applied to it (a sigma of zero for plain coverage). Callers should
+     *  take the integer part of the matrix's translation out of the key and offset the found mask
+     *  themselves, so that the same path drawn at a new position still finds it.
+     */
+    static SkCachedData* FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                    SkScalar sigma, SkBlurStyle style, SkMask* mask,
+                                    SkResourceCache* localCache = nullptr);
 
     /**
      * Add a mask and its pixel-data to the cache.
@@ -39,6 +52,26 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+    /**
+     *  Path masks are purged when the path is edited or destroyed.
+     */
+    static void Add(const SkPath& path, const SkMatrix& matrix,
+                    SkScalar sigma, SkBlurStyle style, const SkMask& mask, SkCachedData* data,
+                    SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Returns true if this path mask key was sighted before, and otherwise remembers it and
+     *  returns false. Callers only make and add masks for keys sighted before, so that paths
+     *  drawn just once don't pay for a cache entry.
+     */
+    static bool SightPath(const SkPath& path, const SkMatrix& matrix,
+                          SkScalar sigma, SkBlurStyle style,
+                          SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Dumps how often path masks were found in or had to be added to the cache.
+     */
+    static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 };
 
 #endif
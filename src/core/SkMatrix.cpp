@@ -972,27 +972,52 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
                          const SkPoint src[], int count) {
     SkASSERT(m.hasPerspective());
 
-    if (count > 0) {
-        do {
-            SkScalar sy = src->fY;
-            SkScalar sx = src->fX;
-            src += 1;
+#ifdef SK_LEGACY_MATRIX_MATH_ORDER
+    int scalarCount = count;
+#else
+    int scalarCount = count & 1;
+#endif
+    for (int i = 0; i < scalarCount; ++i) {
+        SkScalar sy = src->fY;
+        SkScalar sx = src->fX;
+        src += 1;
 
-            SkScalar x = sdot(sx, m.fMat[kMScaleX], sy, m.fMat[kMSkewX])  + m.fMat[kMTransX];
-            SkScalar y = sdot(sx, m.fMat[kMSkewY],  sy, m.fMat[kMScaleY]) + m.fMat[kMTransY];
+        SkScalar x = sdot(sx, m.fMat[kMScaleX], sy, m.fMat[kMSkewX])  + m.fMat[kMTransX];
+        SkScalar y = sdot(sx, m.fMat[kMSkewY],  sy, m.fMat[kMScaleY]) + m.fMat[kMTransY];
 #ifdef SK_LEGACY_MATRIX_MATH_ORDER
-            SkScalar z = sx * m.fMat[kMPersp0] + (sy * m.fMat[kMPersp1] + m.fMat[kMPersp2]);
+        SkScalar z = sx * m.fMat[kMPersp0] + (sy * m.fMat[kMPersp1] + m.fMat[kMPersp2]);
 #else
-            SkScalar z = sdot(sx, m.fMat[kMPersp0], sy, m.fMat[kMPersp1]) + m.fMat[kMPersp2];
+        SkScalar z = sdot(sx, m.fMat[kMPersp0], sy, m.fMat[kMPersp1]) + m.fMat[kMPersp2];
 #endif
-            if (z) {
-                z = SkScalarFastInvert(z);
-            }
+        if (z) {
+            z = SkScalarFastInvert(z);
+        }
 
-            dst->fY = y * z;
-            dst->fX = x * z;
-            dst += 1;
-        } while (--count);
+        dst->fY = y * z;
+        dst->fX = x * z;
+        dst += 1;
+    }
+
+    // Two points at a time, in the same order of operations as above, so the results match the
+    // scalar loop exactly.
+    count = (count - scalarCount) >> 1;
+    if (count > 0) {
+        Sk4s trans4(m.fMat[kMTransX], m.fMat[kMTransY], m.fMat[kMTransX], m.fMat[kMTransY]);
+        Sk4s scale4(m.fMat[kMScaleX], m.fMat[kMScaleY], m.fMat[kMScaleX], m.fMat[kMScaleY]);
+        Sk4s  skew4(m.fMat[kMSkewX],  m.fMat[kMSkewY],  m.fMat[kMSkewX],  m.fMat[kMSkewY]);
+        Sk4s persp4(m.fMat[kMPersp0], m.fMat[kMPersp1], m.fMat[kMPersp0], m.fMat[kMPersp1]);
+        Sk4s persp2(m.fMat[kMPersp2]);
+        for (int i = 0; i < count; ++i) {
+            Sk4s src4 = Sk4s::Load(src);
+            Sk4s swz4 = SkNx_shuffle<1,0,3,2>(src4);  // y0 x0, y1 x1
+            Sk4s xy4 = src4 * scale4 + swz4 * skew4 + trans4;
+            Sk4s p4 = src4 * persp4;
+            Sk4s z4 = p4 + SkNx_shuffle<1,0,3,2>(p4) + persp2;
+            z4 = (z4 != 0).thenElse(Sk4s(1) / z4, 0);
+            (xy4 * z4).store(dst);
+            src += 2;
+            dst += 2;
+        }
     }
 }
 
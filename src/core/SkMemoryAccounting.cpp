@@ -0,0 +1,37 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMemoryAccounting.h"
+
+#include "SkString.h"
+#include "SkTraceMemoryDump.h"
+
+SkMemoryAccounting::Counter SkMemoryAccounting::gCounters[kTagCount];
+std::atomic<bool> SkMemoryAccounting::gCountAllocations{false};
+SkMemoryAccounting::AllocationCounter SkMemoryAccounting::gAllocations;
+
+const char* SkMemoryAccounting::Name(SkMemoryTag tag) {
+    switch (tag) {
+        case SkMemoryTag::kArenaBlocks:    return "arena_blocks";
+        case SkMemoryTag::kArenaBlockPool: return "arena_block_pool";
+        case SkMemoryTag::kRecord:         return "record";
+        case SkMemoryTag::kPathRef:        return "path_ref";
+        case SkMemoryTag::kPictureData:    return "picture_data";
+        case SkMemoryTag::kCodec:          return "codec";
+    }
+    SkASSERT(false);
+    return "unknown";
+}
+
+void SkMemoryAccounting::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    for (int i = 0; i < kTagCount; ++i) {
+        SkMemoryTag tag = (SkMemoryTag)i;
+        SkString dumpName = SkStringPrintf("skia/sk_memory/%s", Name(tag));
+        dump->dumpNumericValue(dumpName.c_str(), "size", "bytes", Bytes(tag));
+        dump->setMemoryBacking(dumpName.c_str(), "malloc", nullptr);
+    }
+}
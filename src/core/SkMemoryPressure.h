@@ -0,0 +1,30 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMemoryPressure_DEFINED
+#define SkMemoryPressure_DEFINED
+
+#include "SkGraphics.h"
+#include "SkMessageBus.h"
+
+// Posted by SkGraphics::OnMemoryPressure() to the caches it can't purge from any thread, which
+// poll for it themselves.
+struct SkMemoryPressureMessage {
+    SkGraphics::MemoryPressure fLevel;
+
+    bool shouldSend(uint32_t) const { return true; }
+};
+
+// Returns the share of 'used' bytes to purge at 'level', where moderate pressure purges
+// numerator/denominator of them.
+static inline size_t SkMemoryPressureShare(SkGraphics::MemoryPressure level, size_t used,
+                                           int numerator, int denominator) {
+    return SkGraphics::MemoryPressure::kCritical == level ? used
+                                                          : used / denominator * numerator;
+}
+
+#endif
@@ -15,6 +15,7 @@
 #include "SkRectPriv.h"
 #include "SkTextBlob.h"
 #include <new>
+#include <utility>
 
 using namespace SkRecords;
 
@@ -44,6 +45,67 @@ static SkRect bounds(const DrawTextBlob& op) {
     return adjust_for_paint(op.blob->bounds().makeOffset(op.x, op.y), op.paint);
 }
 
+// Calls fn with op as its real type.
+template <typename Fn>
+static auto visit(SkMiniRecorder::Op* op, Fn&& fn) -> decltype(fn(std::declval<DrawRect&>())) {
+#define CASE(T) \
+    case SkMiniRecorder::Op::Type::k##T: return fn(*reinterpret_cast<T*>(op->fBuffer.get()))
+    switch (op->fType) {
+        CASE(DrawPath);
+        CASE(DrawRect);
+        CASE(DrawTextBlob);
+    }
+#undef CASE
+    SkASSERT(false);
+    return fn(*reinterpret_cast<DrawRect*>(op->fBuffer.get()));
+}
+
+struct Destroy {
+    template <typename T> void operator()(T& op) { op.~T(); }
+};
+struct Bounds {
+    template <typename T> SkRect operator()(const T& op) { return bounds(op); }
+};
+
+// Several ops taken over from an SkMiniRecorder.
+template <int N>
+struct MiniOps {
+    SkMiniRecorder::Op fOps[N];
+
+    ~MiniOps() {
+        for (auto& op : fOps) {
+            visit(&op, Destroy());
+        }
+    }
+};
+
+// The ops were recorded with no matrix or clip changes between them, so this is just a union.
+template <int N>
+static SkRect bounds(const MiniOps<N>& ops) {
+    SkRect total = SkRect::MakeEmpty();
+    for (auto& op : ops.fOps) {
+        total.join(visit(const_cast<SkMiniRecorder::Op*>(&op), Bounds()));
+    }
+    return total;
+}
+
+template <typename T>
+static int op_count(const T&) { return 1; }
+template <int N>
+static int op_count(const MiniOps<N>&) { return N; }
+
+template <typename T>
+static void draw(SkCanvas* c, const T& op) {
+    SkRecords::Draw(c, nullptr, nullptr, 0, nullptr)(op);
+}
+template <int N>
+static void draw(SkCanvas* c, const MiniOps<N>& ops) {
+    SkRecords::Draw drawer(c, nullptr, nullptr, 0, nullptr);
+    for (auto& op : ops.fOps) {
+        visit(const_cast<SkMiniRecorder::Op*>(&op), drawer);
+    }
+}
+
 template <typename T>
 class SkMiniPicture final : public SkPicture {
 public:
@@ -52,11 +114,11 @@ public:
     }
 
     void playback(SkCanvas* c, AbortCallback*) const override {
-        SkRecords::Draw(c, nullptr, nullptr, 0, nullptr)(fOp);
+        draw(c, fOp);
     }
 
     size_t approximateBytesUsed() const override { return sizeof(*this); }
-    int    approximateOpCount()   const override { return 1; }
+    int    approximateOpCount()   const override { return op_count(fOp); }
     SkRect cullRect()             const override { return fCull; }
 
 private:
@@ -65,20 +127,21 @@ private:
 };
 
 
-SkMiniRecorder::SkMiniRecorder() : fState(State::kEmpty) {}
+SkMiniRecorder::SkMiniRecorder() : fCount(0) {}
 SkMiniRecorder::~SkMiniRecorder() {
-    if (fState != State::kEmpty) {
+    if (fCount > 0) {
         // We have internal state pending.
         // Detaching then deleting a picture is an easy way to clean up.
         (void)this->detachAsPicture(nullptr);
     }
-    SkASSERT(fState == State::kEmpty);
+    SkASSERT(fCount == 0);
 }
 
-#define TRY_TO_STORE(Type, ...)                    \
-    if (fState != State::kEmpty) { return false; } \
-    fState = State::k##Type;                       \
-    new (fBuffer.get()) Type{__VA_ARGS__};         \
+#define TRY_TO_STORE(T, ...)                          \
+    if (fCount == kMaxOps) { return false; }          \
+    Op* op = &fOps[fCount++];                         \
+    op->fType = Op::Type::k##T;                       \
+    new (op->fBuffer.get()) T{__VA_ARGS__};           \
     return true
 
 bool SkMiniRecorder::drawRect(const SkRect& rect, const SkPaint& paint) {
@@ -95,43 +158,50 @@ bool SkMiniRecorder::drawTextBlob(const SkTextBlob* b, SkScalar x, SkScalar y, c
 #undef TRY_TO_STORE
 
 
+namespace {
+struct MakeSinglePicture {
+    const SkRect* fCull;
+    template <typename T> sk_sp<SkPicture> operator()(T& op) {
+        return sk_make_sp<SkMiniPicture<T>>(fCull, &op);
+    }
+};
+}  // namespace
+
 sk_sp<SkPicture> SkMiniRecorder::detachAsPicture(const SkRect* cull) {
-#define CASE(Type)              \
-    case State::k##Type:        \
-        fState = State::kEmpty; \
-        return sk_make_sp<SkMiniPicture<Type>>(cull, reinterpret_cast<Type*>(fBuffer.get()))
+#define CASE(N)                                                                    \
+    case N:                                                                        \
+        return sk_make_sp<SkMiniPicture<MiniOps<N>>>(cull, reinterpret_cast<MiniOps<N>*>(fOps))
 
     static SkOnce once;
     static SkPicture* empty;
 
-    switch (fState) {
-        case State::kEmpty:
+    const int count = fCount;
+    fCount = 0;
+    switch (count) {
+        case 0:
             once([]{ empty = new SkEmptyPicture; });
             return sk_ref_sp(empty);
-        CASE(DrawPath);
-        CASE(DrawRect);
-        CASE(DrawTextBlob);
+        case 1:
+            return visit(&fOps[0], MakeSinglePicture{cull});
+        CASE(2);
+        CASE(3);
+        CASE(4);
+        CASE(5);
+        CASE(6);
     }
+    static_assert(kMaxOps == 6, "detachAsPicture() needs a case for each count.");
     SkASSERT(false);
     return nullptr;
 #undef CASE
 }
 
 void SkMiniRecorder::flushAndReset(SkCanvas* canvas) {
-#define CASE(Type)                                                  \
-    case State::k##Type: {                                          \
-        fState = State::kEmpty;                                     \
-        Type* op = reinterpret_cast<Type*>(fBuffer.get());          \
-        SkRecords::Draw(canvas, nullptr, nullptr, 0, nullptr)(*op); \
-        op->~Type();                                                \
-    } return
-
-    switch (fState) {
-        case State::kEmpty: return;
-        CASE(DrawPath);
-        CASE(DrawRect);
-        CASE(DrawTextBlob);
+    const int count = fCount;
+    fCount = 0;
+
+    SkRecords::Draw draw(canvas, nullptr, nullptr, 0, nullptr);
+    for (int i = 0; i < count; i++) {
+        visit(&fOps[i], draw);
+        visit(&fOps[i], Destroy());
     }
-    SkASSERT(false);
-#undef CASE
 }
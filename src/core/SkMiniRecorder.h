@@ -14,8 +14,11 @@
 class SkCanvas;
 
 // Records small pictures, but only a limited subset of the canvas API, and may fail.
+// Up to kMaxOps draws are held inline, so pictures of a few simple draws need no SkRecord.
 class SkMiniRecorder : SkNoncopyable {
 public:
+    static constexpr int kMaxOps = 6;
+
     SkMiniRecorder();
     ~SkMiniRecorder();
 
@@ -24,6 +27,9 @@ public:
     bool drawRect(const SkRect&, const SkPaint&);
     bool drawTextBlob(const SkTextBlob*, SkScalar x, SkScalar y, const SkPaint&);
 
+    // How many ops we've recorded.
+    int count() const { return fCount; }
+
     // Detach anything we've recorded as a picture, resetting this SkMiniRecorder.
     // If cull is nullptr we'll calculate it.
     sk_sp<SkPicture> detachAsPicture(const SkRect* cull);
@@ -34,16 +40,6 @@ public:
     //    pic->playback(canvas);
     void flushAndReset(SkCanvas*);
 
-private:
-    enum class State {
-        kEmpty,
-        kDrawPath,
-        kDrawRect,
-        kDrawTextBlob,
-    };
-
-    State fState;
-
     template <size_t A, size_t B>
     struct Max { static const size_t val = A > B ? A : B; };
 
@@ -51,7 +47,22 @@ private:
         Max<sizeof(SkRecords::DrawPath),
         Max<sizeof(SkRecords::DrawRect),
             sizeof(SkRecords::DrawTextBlob)>::val>::val;
-    SkAlignedSStorage<kInlineStorage> fBuffer;
+
+    // One recorded op.  The pictures we detach take these over wholesale.
+    struct Op {
+        enum class Type {
+            kDrawPath,
+            kDrawRect,
+            kDrawTextBlob,
+        };
+
+        Type                              fType;
+        SkAlignedSStorage<kInlineStorage> fBuffer;
+    };
+
+private:
+    int fCount;
+    Op  fOps[kMaxOps];
 };
 
 #endif//SkMiniRecorder_DEFINED
@@ -13,6 +13,7 @@
 #include "SkImageInfoPriv.h"
 #include "SkMathPriv.h"
 #include "SkNx.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 #include "SkTypes.h"
 #include <new>
@@ -298,22 +299,66 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
+// The 2x2 box filter is the one every level of an even sized image uses, so for 8888 and A8 we
+// filter several dst pixels at a time, falling back to the templates above for the last few.
+// Both produce exactly what the templates would: each channel is summed and then truncated.
 
-size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
-    if (levelCount < 0) {
-        return 0;
+static void downsample_2_2_8888(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint32_t*>(src);
+    auto p1 = (const uint32_t*)((const char*)p0 + srcRB);
+    auto d = static_cast<uint32_t*>(dst);
+
+    // Spread each pixel's channels into two halves with 16 bits per channel, say R_B_ and _G_A.
+    // Four pixels' worth of any channel fits in 16 bits, so we can sum without carrying over.
+    const Sk4u mask(0x00FF00FF);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        Sk4u e0, o0, e1, o1;
+        Sk4u::Load2(p0, &e0, &o0);
+        Sk4u::Load2(p1, &e1, &o1);
+
+        Sk4u rb = (e0 & mask) + (o0 & mask) + (e1 & mask) + (o1 & mask),
+             ga = ((e0 >> 8) & mask) + ((o0 >> 8) & mask) + ((e1 >> 8) & mask) + ((o1 >> 8) & mask);
+
+        (((rb >> 2) & mask) | (((ga >> 2) & mask) << 8)).store(d + i);
+        p0 += 8;
+        p1 += 8;
     }
-    int64_t size = sk_64_mul(levelCount + 1, sizeof(Level)) + pixelSize;
-    if (!SkTFitsIn<int32_t>(size)) {
-        return 0;
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_8888>(d + i, p0, srcRB, count - i);
     }
-    return SkTo<int32_t>(size);
 }
 
-SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+static void downsample_2_2_8(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint8_t*>(src);
+    auto p1 = p0 + srcRB;
+    auto d = static_cast<uint8_t*>(dst);
+
+    // Each 16-bit lane holds a horizontal pair of src pixels.
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        Sk8h r0 = Sk8h::Load(p0),
+             r1 = Sk8h::Load(p1);
 
+        Sk8h sum = (r0 & 0xFF) + (r0 >> 8) + (r1 & 0xFF) + (r1 >> 8);
+        SkNx_cast<uint8_t>(sum >> 2).store(d + i);
+        p0 += 16;
+        p1 += 16;
+    }
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_8>(d + i, p0, srcRB, count - i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+struct FilterProcs {
     FilterProc* proc_1_2 = nullptr;
     FilterProc* proc_1_3 = nullptr;
     FilterProc* proc_2_1 = nullptr;
@@ -323,64 +368,132 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
     FilterProc* proc_3_2 = nullptr;
     FilterProc* proc_3_3 = nullptr;
 
+    template <typename F>
+    void set() {
+        proc_1_2 = downsample_1_2<F>;
+        proc_1_3 = downsample_1_3<F>;
+        proc_2_1 = downsample_2_1<F>;
+        proc_2_2 = downsample_2_2<F>;
+        proc_2_3 = downsample_2_3<F>;
+        proc_3_1 = downsample_3_1<F>;
+        proc_3_2 = downsample_3_2<F>;
+        proc_3_3 = downsample_3_3<F>;
+    }
+
+    // Returns false if we can't build mipmaps for this color type.
+    bool init(SkColorType ct) {
+        switch (ct) {
+            case kRGBA_8888_SkColorType:
+            case kBGRA_8888_SkColorType:
+                this->set<ColorTypeFilter_8888>();
+                proc_2_2 = downsample_2_2_8888;
+                return true;
+            case kRGB_565_SkColorType:
+                this->set<ColorTypeFilter_565>();
+                return true;
+            case kARGB_4444_SkColorType:
+                this->set<ColorTypeFilter_4444>();
+                return true;
+            case kAlpha_8_SkColorType:
+            case kGray_8_SkColorType:
+                this->set<ColorTypeFilter_8>();
+                proc_2_2 = downsample_2_2_8;
+                return true;
+            case kRGBA_F16_SkColorType:
+                this->set<ColorTypeFilter_F16>();
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Picks the filter which takes a src level of this size down to the next level.
+    FilterProc* choose(int width, int height) const {
+        if (height & 1) {
+            if (height == 1) {        // src-height is 1
+                if (width & 1) {      // src-width is 3
+                    return proc_3_1;
+                } else {              // src-width is 2
+                    return proc_2_1;
+                }
+            } else {                  // src-height is 3
+                if (width & 1) {
+                    if (width == 1) { // src-width is 1
+                        return proc_1_3;
+                    } else {          // src-width is 3
+                        return proc_3_3;
+                    }
+                } else {              // src-width is 2
+                    return proc_2_3;
+                }
+            }
+        } else {                      // src-height is 2
+            if (width & 1) {
+                if (width == 1) {     // src-width is 1
+                    return proc_1_2;
+                } else {              // src-width is 3
+                    return proc_3_2;
+                }
+            } else {                  // src-width is 2
+                return proc_2_2;
+            }
+        }
+    }
+};
+
+}  // namespace
+
+// Levels with at least twice this many pixels to filter are split into bands of rows, which run
+// as tasks on the default SkExecutor.  Each level still needs the one before it to be finished.
+static constexpr int kMinPixelsPerBand = 256 * 1024;
+
+// Filters the pixels in |dstRect| of |dstPM|, the level below |srcPM|.
+static void downsample_rect(FilterProc* proc, const SkPixmap& srcPM, const SkPixmap& dstPM,
+                            const SkIRect& dstRect) {
+    const size_t bpp = dstPM.info().bytesPerPixel();
+    const size_t srcRB = srcPM.rowBytes();
+    auto rows = [&](int top, int bottom) {
+        for (int y = top; y < bottom; y++) {
+            proc(dstPM.writable_addr(dstRect.fLeft, y),
+                 (const char*)srcPM.addr(0, 2 * y) + 2 * dstRect.fLeft * bpp,
+                 srcRB, dstRect.width());
+        }
+    };
+
+    const int64_t pixels = sk_64_mul(dstRect.width(), dstRect.height());
+    const int maxBands = (int)SkTMin<int64_t>(pixels / kMinPixelsPerBand, dstRect.height());
+    if (maxBands <= 1) {
+        rows(dstRect.fTop, dstRect.fBottom);
+        return;
+    }
+    const int rowsPerBand = (dstRect.height() + maxBands - 1) / maxBands,
+              bands       = (dstRect.height() + rowsPerBand - 1) / rowsPerBand;
+    SkTaskGroup().batch(bands, [&](int i) {
+        int top = dstRect.fTop + i * rowsPerBand;
+        rows(top, SkTMin(top + rowsPerBand, dstRect.fBottom));
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
+    if (levelCount < 0) {
+        return 0;
+    }
+    int64_t size = sk_64_mul(levelCount + 1, sizeof(Level)) + pixelSize;
+    if (!SkTFitsIn<int32_t>(size)) {
+        return 0;
+    }
+    return SkTo<int32_t>(size);
+}
+
+SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
     const SkColorType ct = src.colorType();
     const SkAlphaType at = src.alphaType();
 
-    switch (ct) {
-        case kRGBA_8888_SkColorType:
-        case kBGRA_8888_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
-            break;
-        case kRGB_565_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
-            break;
-        case kARGB_4444_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
-            break;
-        case kAlpha_8_SkColorType:
-        case kGray_8_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
-            break;
-        case kRGBA_F16_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_F16>;
-            break;
-        default:
-            return nullptr;
+    FilterProcs procs;
+    if (!procs.init(ct)) {
+        return nullptr;
     }
 
     if (src.width() <= 1 && src.height() <= 1) {
@@ -425,36 +538,7 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
     SkPixmap    srcPM(src);
 
     for (int i = 0; i < countLevels; ++i) {
-        FilterProc* proc;
-        if (height & 1) {
-            if (height == 1) {        // src-height is 1
-                if (width & 1) {      // src-width is 3
-                    proc = proc_3_1;
-                } else {              // src-width is 2
-                    proc = proc_2_1;
-                }
-            } else {                  // src-height is 3
-                if (width & 1) {
-                    if (width == 1) { // src-width is 1
-                        proc = proc_1_3;
-                    } else {          // src-width is 3
-                        proc = proc_3_3;
-                    }
-                } else {              // src-width is 2
-                    proc = proc_2_3;
-                }
-            }
-        } else {                      // src-height is 2
-            if (width & 1) {
-                if (width == 1) {     // src-width is 1
-                    proc = proc_1_2;
-                } else {              // src-width is 3
-                    proc = proc_3_2;
-                }
-            } else {                  // src-width is 2
-                proc = proc_2_2;
-            }
-        }
+        FilterProc* proc = procs.choose(width, height);
         width = SkTMax(1, width >> 1);
         height = SkTMax(1, height >> 1);
         rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, width));
@@ -467,15 +551,7 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
                                          SkIntToScalar(height) / src.height());
 
         const SkPixmap& dstPM = levels[i].fPixmap;
-        const void* srcBasePtr = srcPM.addr();
-        void* dstBasePtr = dstPM.writable_addr();
-
-        const size_t srcRB = srcPM.rowBytes();
-        for (int y = 0; y < height; y++) {
-            proc(dstBasePtr, srcBasePtr, srcRB, width);
-            srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-        }
+        downsample_rect(proc, srcPM, dstPM, dstPM.bounds());
         srcPM = dstPM;
         addr += height * rowBytes;
     }
@@ -485,6 +561,40 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
     return mipmap;
 }
 
+bool SkMipMap::refresh(const SkPixmap& src, const SkIRect& dirty) {
+    if (nullptr == fLevels || fCount != ComputeLevelCount(src.width(), src.height())) {
+        return false;
+    }
+    const SkPixmap& first = fLevels[0].fPixmap;
+    if (src.colorType() != first.colorType() ||
+        src.alphaType() != first.alphaType() ||
+        ComputeLevelSize(src.width(), src.height(), 0) != first.info().dimensions()) {
+        return false;
+    }
+
+    FilterProcs procs;
+    SkAssertResult(procs.init(src.colorType()));
+
+    SkIRect rect = dirty;
+    if (!rect.intersect(src.bounds())) {
+        return true;
+    }
+    SkPixmap srcPM(src);
+    for (int i = 0; i < fCount; ++i) {
+        const SkPixmap& dstPM = fLevels[i].fPixmap;
+
+        // A dst pixel reads the two or three src pixels starting from twice its coordinate.
+        // Dividing rounds toward zero, so fLeft and fTop may take in one pixel more than they
+        // strictly need to, which is harmless.
+        rect.setLTRB((rect.fLeft - 1) / 2, (rect.fTop - 1) / 2,
+                     SkTMin(dstPM.width(),  (rect.fRight  + 1) / 2),
+                     SkTMin(dstPM.height(), (rect.fBottom + 1) / 2));
+        downsample_rect(procs.choose(srcPM.width(), srcPM.height()), srcPM, dstPM, rect);
+        srcPM = dstPM;
+    }
+    return true;
+}
+
 int SkMipMap::ComputeLevelCount(int baseWidth, int baseHeight) {
     if (baseWidth < 1 || baseHeight < 1) {
         return 0;
@@ -57,6 +57,12 @@ public:
     // the base level. So index 0 represents mipmap level 1.
     bool getLevel(int index, Level*) const;
 
+    // After the pixels inside |dirty| of |src| have changed, refilters only the parts of each
+    // level that depend on them. |src| must be the same size and type as the image this mipmap
+    // was built from. Returns false, changing nothing, if it isn't or our levels were purged.
+    // Nothing may be reading the levels while they are refreshed.
+    bool refresh(const SkPixmap& src, const SkIRect& dirty);
+
 protected:
     void onDataChange(void* oldData, void* newData) override {
         fLevels = (Level*)newData; // could be nullptr
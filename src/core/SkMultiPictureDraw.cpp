@@ -5,20 +5,78 @@
  * found in the LICENSE file.
  */
 
+#include "SkBigPicture.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkCanvasPriv.h"
+#include "SkImageFilter.h"
 #include "SkMultiPictureDraw.h"
 #include "SkPicture.h"
+#include "SkPicturePriv.h"
+#include "SkRecord.h"
+#include "SkRecords.h"
+#include "SkSurfaceProps.h"
+#include "SkTArray.h"
+#include "SkTLogic.h"
 #include "SkTaskGroup.h"
+#include "SkTime.h"
+
+namespace {
+
+// Bands have at least this many pixels; raster draws with twice this many are split up.
+static constexpr int kMinPixelsPerBand = 256 * 1024;
+
+bool draws_same_in_bands(const SkPicture*);
+
+// An SkRecord visitor that returns true for ops whose pixels may depend on the clip, rather
+// than just being cut off by it.  Layers (including the ones SkCanvas makes for image filters)
+// are allocated to fit the clip, so their origin, and with it their rounding, moves with it.
+struct LayerHunter {
+    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+    static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
+
+    bool operator()(const SkRecords::SaveLayer&)    { return true; }
+    bool operator()(const SkRecords::DrawDrawable&) { return true; }
+    bool operator()(const SkRecords::DrawPicture& op) {
+        return op.paint || !draws_same_in_bands(op.picture.get());
+    }
+
+    template <typename T>
+    SK_WHEN(T::kTags & SkRecords::kHasPaint_Tag, bool) operator()(const T& op) {
+        const SkPaint* paint = AsPtr(op.paint);
+        return paint && paint->getImageFilter();
+    }
+
+    template <typename T>
+    SK_WHEN(!(T::kTags & SkRecords::kHasPaint_Tag), bool) operator()(const T&) { return false; }
+};
+
+bool draws_same_in_bands(const SkPicture* picture) {
+    const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(sk_ref_sp(picture));
+    if (!big) {
+        return false;
+    }
+    const SkRecord& record = *big->record();
+    LayerHunter hunter;
+    for (int i = 0; i < record.count(); i++) {
+        if (record.visit(i, hunter)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
 
 void SkMultiPictureDraw::DrawData::draw() {
     fCanvas->drawPicture(fPicture, &fMatrix, fPaint);
 }
 
 void SkMultiPictureDraw::DrawData::init(SkCanvas* canvas, const SkPicture* picture,
-                                        const SkMatrix* matrix, const SkPaint* paint) {
+                                        const SkMatrix* matrix, const SkPaint* paint, int index) {
     fPicture = SkRef(picture);
     fCanvas = canvas;
+    fIndex = index;
     if (matrix) {
         fMatrix = *matrix;
     } else {
@@ -62,8 +120,9 @@ void SkMultiPictureDraw::add(SkCanvas* canvas,
         return;
     }
 
+    const int index = fGPUDrawData.count() + fThreadSafeDrawData.count();
     SkTDArray<DrawData>& array = canvas->getGrContext() ? fGPUDrawData : fThreadSafeDrawData;
-    array.append()->init(canvas, picture, matrix, paint);
+    array.append()->init(canvas, picture, matrix, paint, index);
 }
 
 class AutoMPDReset : SkNoncopyable {
@@ -75,19 +134,83 @@ public:
 
 //#define FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
 
-void SkMultiPictureDraw::draw(bool flush) {
+void SkMultiPictureDraw::draw(bool flush, SkTDArray<TileTiming>* timings) {
     AutoMPDReset mpdreset(this);
 
-#ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
+    // A large picture drawn into a raster canvas is split into bands of rows.  Each band gets
+    // its own canvas over the same pixels, with the original matrix and clip narrowed to the
+    // band, so device coordinates (and so dithering, AA and rounding) match a serial draw.
+    // SkBigPicture::playback() queries the BBH with the band's bounds, so each band only
+    // replays the ops that touch it.
+    struct Piece {
+        int            fData;
+        SkIRect        fBounds;
+        bool           fBanded;
+        SkPixmap       fPixmap;
+        SkSurfaceProps fProps{0, kUnknown_SkPixelGeometry};
+    };
+    SkTArray<Piece> pieces;
     for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
-        fThreadSafeDrawData[i].draw();
+        const DrawData& data = fThreadSafeDrawData[i];
+        SkCanvas* canvas = data.fCanvas;
+        const SkIRect clip = canvas->getDeviceClipBounds();
+        const int64_t pixels = clip.width() * (int64_t)clip.height();
+        const int maxBands = (int)SkTMin<int64_t>(pixels / kMinPixelsPerBand, clip.height());
+
+        SkPixmap pixmap;
+        if (maxBands <= 1 || data.fPaint || 1 != canvas->getSaveCount() ||
+            !canvas->isClipRect() || !canvas->peekPixels(&pixmap) ||
+            !draws_same_in_bands(data.fPicture)) {
+            pieces.push_back(Piece{i, clip, false, SkPixmap()});
+            continue;
+        }
+
+        SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+        canvas->getProps(&props);
+        SkCanvasPriv::WillDrawDirectly(canvas);
+
+        const int rowsPerBand = (clip.height() + maxBands - 1) / maxBands;
+        for (int top = clip.fTop; top < clip.fBottom; top += rowsPerBand) {
+            SkIRect band = SkIRect::MakeLTRB(clip.fLeft, top,
+                                             clip.fRight, SkTMin(top + rowsPerBand, clip.fBottom));
+            pieces.push_back(Piece{i, band, true, pixmap, props});
+        }
+    }
+
+    SkAutoTMalloc<double> ms(pieces.count());
+    auto drawPiece = [&](int i) {
+        const Piece& piece = pieces[i];
+        DrawData& data = fThreadSafeDrawData[piece.fData];
+        const double start = SkTime::GetMSecs();
+        if (piece.fBanded) {
+            SkBitmap bitmap;
+            bitmap.installPixels(piece.fPixmap);
+            SkCanvas band(bitmap, piece.fProps);
+            band.clipRect(SkRect::Make(piece.fBounds));
+            band.setMatrix(data.fCanvas->getTotalMatrix());
+            band.drawPicture(data.fPicture, &data.fMatrix, nullptr);
+        } else {
+            data.draw();
+        }
+        ms[i] = SkTime::GetMSecs() - start;
+    };
+
+#ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
+    for (int i = 0; i < pieces.count(); ++i) {
+        drawPiece(i);
     }
 #else
-    SkTaskGroup().batch(fThreadSafeDrawData.count(), [&](int i) {
-        fThreadSafeDrawData[i].draw();
-    });
+    SkTaskGroup().batch(pieces.count(), drawPiece);
 #endif
 
+    if (timings) {
+        timings->rewind();
+        for (int i = 0; i < pieces.count(); ++i) {
+            *timings->append() = { fThreadSafeDrawData[pieces[i].fData].fIndex,
+                                   pieces[i].fBounds, ms[i] };
+        }
+    }
+
     // N.B. we could get going on any GPU work from this main thread while the CPU work runs.
     // But in practice, we've either got GPU work or CPU work, not both.
 
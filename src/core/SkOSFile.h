@@ -65,6 +65,10 @@ bool    sk_exists(const char *path, SkFILE_Flags = (SkFILE_Flags)0);
 // Returns true if a directory exists at this path.
 bool    sk_isdir(const char *path);
 
+// Returns true and sets the size and last modification time (in seconds since the epoch) of
+// whatever is at this path, if it exists.
+bool    sk_stat(const char* path, size_t* size, int64_t* modified);
+
 // Like pread, but may affect the file position marker.
 // Returns the number of bytes read or SIZE_MAX if failed.
 size_t sk_qread(FILE*, void* buffer, size_t count, size_t offset);
@@ -45,7 +45,11 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. strip big-endian 16-bit to 8-bit, insert alpha
+                           RGB16_to_BGR1,   // i.e. strip, swap RB and insert an opaque alpha
+                           RGBA16_to_RGBA,  // i.e. strip big-endian 16-bit to 8-bit
+                           RGBA16_to_BGRA;  // i.e. strip and swap RB
 
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_API (*memset32)(uint32_t[], uint32_t, int);
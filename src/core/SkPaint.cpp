@@ -66,12 +66,7 @@ SkPaint::SkPaint() {
 SkPaint::SkPaint(const SkPaint& src)
 #define COPY(field) field(src.field)
     : COPY(fTypeface)
-    , COPY(fPathEffect)
-    , COPY(fShader)
-    , COPY(fMaskFilter)
-    , COPY(fColorFilter)
-    , COPY(fDrawLooper)
-    , COPY(fImageFilter)
+    , COPY(fEffects)
     , COPY(fTextSize)
     , COPY(fTextScaleX)
     , COPY(fTextSkewX)
@@ -86,12 +81,7 @@ SkPaint::SkPaint(const SkPaint& src)
 SkPaint::SkPaint(SkPaint&& src) {
 #define MOVE(field) field = std::move(src.field)
     MOVE(fTypeface);
-    MOVE(fPathEffect);
-    MOVE(fShader);
-    MOVE(fMaskFilter);
-    MOVE(fColorFilter);
-    MOVE(fDrawLooper);
-    MOVE(fImageFilter);
+    MOVE(fEffects);
     MOVE(fTextSize);
     MOVE(fTextScaleX);
     MOVE(fTextSkewX);
@@ -105,6 +95,27 @@ SkPaint::SkPaint(SkPaint&& src) {
 
 SkPaint::~SkPaint() {}
 
+SkPaint::Effects::Effects() {}
+
+SkPaint::Effects::Effects(const Effects& that)
+    : fPathEffect(that.fPathEffect)
+    , fShader(that.fShader)
+    , fMaskFilter(that.fMaskFilter)
+    , fColorFilter(that.fColorFilter)
+    , fDrawLooper(that.fDrawLooper)
+    , fImageFilter(that.fImageFilter) {}
+
+SkPaint::Effects::~Effects() {}
+
+SkPaint::Effects* SkPaint::writableEffects() {
+    if (!fEffects) {
+        fEffects = sk_make_sp<Effects>();
+    } else if (!fEffects->unique()) {
+        fEffects = sk_make_sp<Effects>(*fEffects);
+    }
+    return const_cast<Effects*>(fEffects.get());
+}
+
 SkPaint& SkPaint::operator=(const SkPaint& src) {
     if (this == &src) {
         return *this;
@@ -112,12 +123,7 @@ SkPaint& SkPaint::operator=(const SkPaint& src) {
 
 #define ASSIGN(field) field = src.field
     ASSIGN(fTypeface);
-    ASSIGN(fPathEffect);
-    ASSIGN(fShader);
-    ASSIGN(fMaskFilter);
-    ASSIGN(fColorFilter);
-    ASSIGN(fDrawLooper);
-    ASSIGN(fImageFilter);
+    ASSIGN(fEffects);
     ASSIGN(fTextSize);
     ASSIGN(fTextScaleX);
     ASSIGN(fTextSkewX);
@@ -138,12 +144,7 @@ SkPaint& SkPaint::operator=(SkPaint&& src) {
 
 #define MOVE(field) field = std::move(src.field)
     MOVE(fTypeface);
-    MOVE(fPathEffect);
-    MOVE(fShader);
-    MOVE(fMaskFilter);
-    MOVE(fColorFilter);
-    MOVE(fDrawLooper);
-    MOVE(fImageFilter);
+    MOVE(fEffects);
     MOVE(fTextSize);
     MOVE(fTextScaleX);
     MOVE(fTextSkewX);
@@ -159,13 +160,17 @@ SkPaint& SkPaint::operator=(SkPaint&& src) {
 
 bool operator==(const SkPaint& a, const SkPaint& b) {
 #define EQUAL(field) (a.field == b.field)
+#define EQUAL_EFFECT(getter) (a.getter() == b.getter())
+    // Paints copied from one another share their effects, so this is usually a pointer compare.
+    bool effectsEqual = EQUAL(fEffects)
+        || (   EQUAL_EFFECT(getPathEffect)
+            && EQUAL_EFFECT(getShader)
+            && EQUAL_EFFECT(getMaskFilter)
+            && EQUAL_EFFECT(getColorFilter)
+            && EQUAL_EFFECT(getDrawLooper)
+            && EQUAL_EFFECT(getImageFilter));
     return EQUAL(fTypeface)
-        && EQUAL(fPathEffect)
-        && EQUAL(fShader)
-        && EQUAL(fMaskFilter)
-        && EQUAL(fColorFilter)
-        && EQUAL(fDrawLooper)
-        && EQUAL(fImageFilter)
+        && effectsEqual
         && EQUAL(fTextSize)
         && EQUAL(fTextScaleX)
         && EQUAL(fTextSkewX)
@@ -175,18 +180,21 @@ bool operator==(const SkPaint& a, const SkPaint& b) {
         && EQUAL(fBlendMode)
         && EQUAL(fBitfieldsUInt)
         ;
+#undef EQUAL_EFFECT
 #undef EQUAL
 }
 
-#define DEFINE_REF_FOO(type)    sk_sp<Sk##type> SkPaint::ref##type() const { return f##type; }
+#define DEFINE_REF_FOO(type)    sk_sp<Sk##type> SkPaint::ref##type() const { \
+    return sk_ref_sp(this->get##type());                                       \
+}
 DEFINE_REF_FOO(ColorFilter)
 DEFINE_REF_FOO(DrawLooper)
 DEFINE_REF_FOO(ImageFilter)
 DEFINE_REF_FOO(MaskFilter)
 DEFINE_REF_FOO(PathEffect)
 DEFINE_REF_FOO(Shader)
-DEFINE_REF_FOO(Typeface)
 #undef DEFINE_REF_FOO
+sk_sp<SkTypeface> SkPaint::refTypeface() const { return fTypeface; }
 
 void SkPaint::reset() {
     SkPaint init;
@@ -353,8 +361,14 @@ void SkPaint::setTextEncoding(TextEncoding encoding) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#define MOVE_FIELD(Field) void SkPaint::set##Field(sk_sp<Sk##Field> f) { f##Field = std::move(f); }
-MOVE_FIELD(Typeface)
+void SkPaint::setTypeface(sk_sp<SkTypeface> f) { fTypeface = std::move(f); }
+
+// Setting an effect to what it already is (usually null) leaves a shared bundle shared.
+#define MOVE_FIELD(Field) void SkPaint::set##Field(sk_sp<Sk##Field> f) { \
+    if (f.get() != this->get##Field()) {                                \
+        this->writableEffects()->f##Field = std::move(f);               \
+    }                                                                   \
+}
 MOVE_FIELD(ImageFilter)
 MOVE_FIELD(Shader)
 MOVE_FIELD(ColorFilter)
@@ -362,7 +376,7 @@ MOVE_FIELD(PathEffect)
 MOVE_FIELD(MaskFilter)
 MOVE_FIELD(DrawLooper)
 #undef MOVE_FIELD
-void SkPaint::setLooper(sk_sp<SkDrawLooper> looper) { fDrawLooper = std::move(looper); }
+void SkPaint::setLooper(sk_sp<SkDrawLooper> looper) { this->setDrawLooper(std::move(looper)); }
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -546,7 +560,8 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
     const SkPath* srcPtr = &src;
     SkPath tmpPath;
 
-    if (fPathEffect && fPathEffect->filterPath(&tmpPath, src, &rec, cullRect)) {
+    SkPathEffect* pe = this->getPathEffect();
+    if (pe && pe->filterPath(&tmpPath, src, &rec, cullRect)) {
         srcPtr = &tmpPath;
     }
 
@@ -627,7 +642,7 @@ static bool affects_alpha(const SkImageFilter* imf) {
 }
 
 bool SkPaint::nothingToDraw() const {
-    if (fDrawLooper) {
+    if (this->getLooper()) {
         return false;
     }
     switch ((SkBlendMode)fBlendMode) {
@@ -637,7 +652,8 @@ bool SkPaint::nothingToDraw() const {
         case SkBlendMode::kDstOver:
         case SkBlendMode::kPlus:
             if (0 == this->getAlpha()) {
-                return !affects_alpha(fColorFilter.get()) && !affects_alpha(fImageFilter.get());
+                return !affects_alpha(this->getColorFilter()) &&
+                       !affects_alpha(this->getImageFilter());
             }
             break;
         case SkBlendMode::kDst:
@@ -649,10 +665,25 @@ bool SkPaint::nothingToDraw() const {
 }
 
 uint32_t SkPaint::getHash() const {
-    // We're going to hash 7 pointers and 11 32-bit values, finishing up with fBitfields,
-    // so fBitfields should be 7 pointers and 10 32-bit values from the start.
-    static_assert(offsetof(SkPaint, fBitfields) == 7 * sizeof(void*) + 10 * sizeof(uint32_t),
+    // Hash the effects themselves rather than the bundle holding them, since equal paints need not
+    // share a bundle.
+    const void* pointers[] = {
+        this->getTypeface(),
+        this->getPathEffect(),
+        this->getShader(),
+        this->getMaskFilter(),
+        this->getColorFilter(),
+        this->getDrawLooper(),
+        this->getImageFilter(),
+    };
+
+    // Then 11 32-bit values, finishing up with fBitfields, so fBitfields should be 10 32-bit
+    // values from fTextSize.
+    static_assert(offsetof(SkPaint, fBitfields) ==
+                  offsetof(SkPaint, fTextSize) + 10 * sizeof(uint32_t),
                   "SkPaint_notPackedTightly");
-    return SkOpts::hash(reinterpret_cast<const uint32_t*>(this),
-                        offsetof(SkPaint, fBitfields) + sizeof(fBitfields));
+    return SkOpts::hash(&fTextSize,
+                        offsetof(SkPaint, fBitfields) + sizeof(fBitfields) -
+                        offsetof(SkPaint, fTextSize),
+                        SkOpts::hash(pointers, sizeof(pointers)));
 }
@@ -18,6 +18,7 @@
 #include "SkPathRef.h"
 #include "SkPointPriv.h"
 #include "SkRRect.h"
+#include "SkResourceCache.h"
 #include "SkSafeMath.h"
 #include "SkTLazy.h"
 #include "SkTo.h"
@@ -157,6 +158,7 @@ SkPath::SkPath()
     this->resetFields();
     fIsVolatile = false;
     fIsBadForDAA = false;
+    fIsStrokeOutline = false;
 }
 
 void SkPath::resetFields() {
@@ -197,6 +199,7 @@ void SkPath::copyFields(const SkPath& that) {
     fFillType        = that.fFillType;
     fIsVolatile      = that.fIsVolatile;
     fIsBadForDAA     = that.fIsBadForDAA;
+    fIsStrokeOutline = that.fIsStrokeOutline;
 
     // Non-atomic assignment of atomic values.
     fConvexity     .store(that.fConvexity     .load());
@@ -3202,6 +3205,196 @@ static bool contains_inclusive(const SkRect& r, SkScalar x, SkScalar y) {
     return r.fLeft <= x && x <= r.fRight && r.fTop <= y && y <= r.fBottom;
 }
 
+static int winding_segment(SkPath::Verb verb, const SkPoint pts[], SkScalar weight,
+                           SkScalar x, SkScalar y, int* onCurveCount) {
+    switch (verb) {
+        case SkPath::kLine_Verb:
+            return winding_line(pts, x, y, onCurveCount);
+        case SkPath::kQuad_Verb:
+            return winding_quad(pts, x, y, onCurveCount);
+        case SkPath::kConic_Verb:
+            return winding_conic(pts, x, y, weight, onCurveCount);
+        case SkPath::kCubic_Verb:
+            return winding_cubic(pts, x, y, onCurveCount);
+        default:
+            return 0;
+    }
+}
+
+namespace {
+// Paths with fewer verbs than this are cheaper to walk than to look up.
+static constexpr int kMinContainsIndexVerbs = 64;
+
+static unsigned gContainsIndexKeyNamespaceLabel;
+
+static uint64_t make_contains_index_shared_id(uint32_t pathGenID) {
+    return (static_cast<uint64_t>(SkSetFourByteTag('p', 'c', 'o', 'n')) << 32) | pathGenID;
+}
+
+/**
+ *  The segments of a path, binned by the horizontal bands their control points touch. A segment
+ *  only contributes to the winding at y if y lies within its control points' y range, so
+ *  contains() only needs to visit the segments in y's band.
+ */
+class ContainsIndex : public SkNVRefCnt<ContainsIndex> {
+public:
+    static sk_sp<ContainsIndex> FindOrMake(const SkPath& path);
+
+    int winding(SkScalar x, SkScalar y, int* onCurveCount) const {
+        int band = this->band(y);
+        int w = 0;
+        for (int i = fBandStarts[band]; i < fBandStarts[band + 1]; ++i) {
+            const Segment& seg = fSegments[fSegmentIndices[i]];
+            w += winding_segment(seg.fVerb, seg.fPts, seg.fWeight, x, y, onCurveCount);
+        }
+        return w;
+    }
+
+    size_t bytesUsed() const {
+        return sizeof(*this) + fSegments.reserved() * sizeof(Segment) +
+               (fBandStarts.reserved() + fSegmentIndices.reserved()) * sizeof(int);
+    }
+
+private:
+    struct Segment {
+        SkPoint      fPts[4];
+        SkScalar     fWeight;
+        SkPath::Verb fVerb;
+    };
+
+    static sk_sp<ContainsIndex> Make(const SkPath& path);
+
+    // Monotonic in y, so a segment spanning [y0, y1] is in every band a y in that range maps to.
+    int band(SkScalar y) const {
+        return (int)SkTPin((y - fTop) * fScale, 0.0f, (SkScalar)(fBandCount - 1));
+    }
+
+    SkTDArray<Segment> fSegments;
+    SkTDArray<int>     fBandStarts;         // fBandCount + 1 offsets into fSegmentIndices
+    SkTDArray<int>     fSegmentIndices;
+    SkScalar           fTop;
+    SkScalar           fScale;
+    int                fBandCount;
+};
+
+sk_sp<ContainsIndex> ContainsIndex::Make(const SkPath& path) {
+    sk_sp<ContainsIndex> index(new ContainsIndex);
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        if (SkPath::kMove_Verb == verb || SkPath::kClose_Verb == verb) {
+            continue;
+        }
+        Segment* seg = index->fSegments.append();
+        memcpy(seg->fPts, pts, sizeof(pts));
+        seg->fWeight = SkPath::kConic_Verb == verb ? iter.conicWeight() : 1;
+        seg->fVerb = verb;
+    }
+    index->fSegments.shrinkToFit();
+
+    const SkRect& bounds = path.getBounds();
+    index->fTop = bounds.fTop;
+    index->fBandCount = SkTPin(index->fSegments.count() / 4, 1, 1024);
+    index->fScale = index->fBandCount / bounds.height();
+    if (!SkScalarIsFinite(index->fScale)) {
+        index->fBandCount = 1;
+        index->fScale = 0;
+    }
+
+    // Chopping curves at their y extrema can round a little outside the control points, so
+    // each segment's range is padded.
+    auto bandRange = [&index](const Segment& seg, int* first, int* last) {
+        int ptCount = SkPathPriv::PtsInIter(seg.fVerb);
+        SkScalar minY = seg.fPts[0].fY, maxY = minY;
+        for (int i = 1; i < ptCount; ++i) {
+            minY = SkTMin(minY, seg.fPts[i].fY);
+            maxY = SkTMax(maxY, seg.fPts[i].fY);
+        }
+        SkScalar pad = (maxY - minY + SkScalarAbs(minY) + SkScalarAbs(maxY)) *
+                       SK_ScalarNearlyZero;
+        *first = index->band(minY - pad);
+        *last = index->band(maxY + pad);
+    };
+
+    index->fBandStarts.setCount(index->fBandCount + 1);
+    sk_bzero(index->fBandStarts.begin(), index->fBandStarts.bytes());
+    for (const Segment& seg : index->fSegments) {
+        int first, last;
+        bandRange(seg, &first, &last);
+        for (int band = first; band <= last; ++band) {
+            index->fBandStarts[band + 1] += 1;
+        }
+    }
+    for (int band = 0; band < index->fBandCount; ++band) {
+        index->fBandStarts[band + 1] += index->fBandStarts[band];
+    }
+    index->fSegmentIndices.setCount(index->fBandStarts[index->fBandCount]);
+    SkAutoSTMalloc<64, int> next(index->fBandCount);
+    memcpy(next.get(), index->fBandStarts.begin(), index->fBandCount * sizeof(int));
+    for (int i = 0; i < index->fSegments.count(); ++i) {
+        int first, last;
+        bandRange(index->fSegments[i], &first, &last);
+        for (int band = first; band <= last; ++band) {
+            index->fSegmentIndices[next[band]++] = i;
+        }
+    }
+    return index;
+}
+
+struct ContainsIndexKey : public SkResourceCache::Key {
+    explicit ContainsIndexKey(uint32_t pathGenID) {
+        this->init(&gContainsIndexKeyNamespaceLabel, make_contains_index_shared_id(pathGenID), 0);
+    }
+};
+
+struct ContainsIndexRec : public SkResourceCache::Rec {
+    ContainsIndexRec(const ContainsIndexKey& key, sk_sp<ContainsIndex> index)
+        : fKey(key)
+        , fIndex(std::move(index)) {}
+
+    ContainsIndexKey     fKey;
+    sk_sp<ContainsIndex> fIndex;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fIndex->bytesUsed(); }
+    const char* getCategory() const override { return "path-contains"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const ContainsIndexRec& rec = static_cast<const ContainsIndexRec&>(baseRec);
+        *static_cast<sk_sp<ContainsIndex>*>(contextData) = rec.fIndex;
+        return true;
+    }
+};
+
+// Purges a path's index once nothing can query it again.
+class ContainsIndexInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit ContainsIndexInvalidator(uint32_t pathGenID) : fPathGenID(pathGenID) {}
+
+private:
+    void onChange() override {
+        SkResourceCache::PostPurgeSharedID(make_contains_index_shared_id(fPathGenID));
+    }
+
+    uint32_t fPathGenID;
+};
+
+sk_sp<ContainsIndex> ContainsIndex::FindOrMake(const SkPath& path) {
+    const uint32_t genID = path.getGenerationID();
+    ContainsIndexKey key(genID);
+    sk_sp<ContainsIndex> index;
+    if (SkResourceCache::Find(key, ContainsIndexRec::Visitor, &index)) {
+        return index;
+    }
+    index = Make(path);
+    SkResourceCache::Add(new ContainsIndexRec(key, index));
+    SkPathPriv::AddGenIDChangeListener(path, sk_make_sp<ContainsIndexInvalidator>(genID));
+    return index;
+}
+}  // namespace
+
 bool SkPath::contains(SkScalar x, SkScalar y) const {
     bool isInverse = this->isInverseFillType();
     if (this->isEmpty()) {
@@ -3216,29 +3409,24 @@ bool SkPath::contains(SkScalar x, SkScalar y) const {
     bool done = false;
     int w = 0;
     int onCurveCount = 0;
-    do {
+#if !defined(IS_FUZZING_WITH_LIBFUZZER)
+    // Big paths that are expected to stay the same keep an index of their segments in
+    // SkResourceCache, so repeated hit tests skip the segments that can't cross y.
+    if (!this->isVolatile() && this->countVerbs() >= kMinContainsIndexVerbs && this->isFinite()) {
+        w = ContainsIndex::FindOrMake(*this)->winding(x, y, &onCurveCount);
+        done = true;
+    }
+#endif
+    while (!done) {
         SkPoint pts[4];
-        switch (iter.next(pts, false)) {
-            case SkPath::kMove_Verb:
-            case SkPath::kClose_Verb:
-                break;
-            case SkPath::kLine_Verb:
-                w += winding_line(pts, x, y, &onCurveCount);
-                break;
-            case SkPath::kQuad_Verb:
-                w += winding_quad(pts, x, y, &onCurveCount);
-                break;
-            case SkPath::kConic_Verb:
-                w += winding_conic(pts, x, y, iter.conicWeight(), &onCurveCount);
-                break;
-            case SkPath::kCubic_Verb:
-                w += winding_cubic(pts, x, y, &onCurveCount);
-                break;
-            case SkPath::kDone_Verb:
-                done = true;
-                break;
-       }
-    } while (!done);
+        SkPath::Verb verb = iter.next(pts, false);
+        if (SkPath::kDone_Verb == verb) {
+            done = true;
+        } else {
+            SkScalar weight = SkPath::kConic_Verb == verb ? iter.conicWeight() : 1;
+            w += winding_segment(verb, pts, weight, x, y, &onCurveCount);
+        }
+    }
     bool evenOddFill = SkPath::kEvenOdd_FillType == this->getFillType()
             || SkPath::kInverseEvenOdd_FillType == this->getFillType();
     if (evenOddFill) {
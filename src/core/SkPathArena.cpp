@@ -0,0 +1,71 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPathArena.h"
+#include "SkPathRef.h"
+
+SkPathArena::SkPathArena(size_t blockSize)
+    : fBlockSize(SkAlign4(SkTMax<size_t>(blockSize, 4))) {}
+
+char* SkPathArena::allocate(size_t bytes, sk_sp<SkData>* block) {
+    bytes = SkAlign4(bytes);
+    if (bytes > fBlockSize / 4) {
+        *block = SkData::MakeUninitialized(bytes);
+        fBytesAllocated += bytes;
+        return static_cast<char*>((*block)->writable_data());
+    }
+    if (bytes > (size_t)(fEnd - fCursor)) {
+        // Nothing more will fit in the current block; the paths in it keep it alive.
+        fBlock = SkData::MakeUninitialized(fBlockSize);
+        fCursor = static_cast<char*>(fBlock->writable_data());
+        fEnd = fCursor + fBlockSize;
+        fBytesAllocated += fBlockSize;
+    }
+    char* storage = fCursor;
+    fCursor += bytes;
+    *block = fBlock;
+    return storage;
+}
+
+SkPath SkPathArena::freeze(const SkPath& path) {
+    const SkPathRef& src = *path.fPathRef;
+    if (0 == src.countVerbs()) {
+        // Empty paths already share one path ref.
+        return path;
+    }
+
+    size_t weightBytes = src.countWeights() * sizeof(SkScalar);
+    size_t pointBytes = src.countPoints() * sizeof(SkPoint);
+    size_t verbBytes = src.countVerbs() * sizeof(uint8_t);
+    sk_sp<SkData> block;
+    char* storage = this->allocate(weightBytes + pointBytes + verbBytes, &block);
+    memcpy(storage, src.conicWeights(), weightBytes);
+    memcpy(storage + weightBytes, src.points(), pointBytes);
+    memcpy(storage + weightBytes + pointBytes, src.verbsMemBegin(), verbBytes);
+
+    SkPathRef* ref = new SkPathRef;
+    ref->fSharedStorage = std::move(block);
+    ref->fSharedWeights = weightBytes ? reinterpret_cast<SkScalar*>(storage) : nullptr;
+    ref->fSharedWeightCnt = src.countWeights();
+    ref->fPoints = reinterpret_cast<SkPoint*>(storage + weightBytes);
+    ref->fVerbs = reinterpret_cast<uint8_t*>(storage + weightBytes + pointBytes + verbBytes);
+    ref->fPointCnt = src.countPoints();
+    ref->fVerbCnt = src.countVerbs();
+    ref->fGenerationID = 0;
+    ref->fSegmentMask = src.fSegmentMask;
+    ref->fIsOval = src.fIsOval;
+    ref->fIsRRect = src.fIsRRect;
+    ref->fRRectOrOvalIsCCW = src.fRRectOrOvalIsCCW;
+    ref->fRRectOrOvalStartIdx = src.fRRectOrOvalStartIdx;
+    (void)ref->getBounds();
+    SkDEBUGCODE(ref->validate();)
+
+    SkPath frozen(path);
+    frozen.fPathRef.reset(ref);
+    (void)frozen.getConvexity();
+    return frozen;
+}
@@ -10,6 +10,8 @@
 #include "SkPathMeasurePriv.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
+#include "SkPathPriv.h"
+#include "SkResourceCache.h"
 #include "SkTSearch.h"
 
 #define kMaxTValue  0x3FFFFFFF
@@ -24,6 +26,28 @@ SkScalar SkPathMeasure::Segment::getScalarT() const {
     return tValue2Scalar(fTValue);
 }
 
+struct SkPathMeasure::Table : public SkNVRefCnt<Table> {
+    struct Contour {
+        SkScalar    fLength;
+        int         fSegmentStart;  // index into fSegments
+        int         fSegmentCount;
+        bool        fIsClosed;
+    };
+    SkTDArray<Contour>  fContours;
+    SkTDArray<Segment>  fSegments;
+    SkTDArray<SkPoint>  fPts;
+
+    size_t bytesUsed() const {
+        return sizeof(*this) + fContours.reserved() * sizeof(Contour) +
+               fSegments.reserved() * sizeof(Segment) + fPts.reserved() * sizeof(SkPoint);
+    }
+
+    static sk_sp<Table> Make(const SkPath&, bool forceClosed, SkScalar resScale);
+    static sk_sp<Table> FindOrMake(const SkPath&, bool forceClosed, SkScalar resScale);
+
+    struct Rec;
+};
+
 const SkPathMeasure::Segment* SkPathMeasure::NextSegment(const Segment* seg) {
     unsigned ptIndex = seg->fPtIndex;
 
@@ -313,6 +337,24 @@ SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
 }
 
 void SkPathMeasure::buildSegments() {
+    if (fTable) {
+        // Already measured, so just pick up the next contour.
+        if (fContourIndex < fTable->fContours.count()) {
+            const Table::Contour& contour = fTable->fContours[fContourIndex++];
+            fSegments.reset();
+            fSegments.append(contour.fSegmentCount,
+                             fTable->fSegments.begin() + contour.fSegmentStart);
+            fLength = contour.fLength;
+            fIsClosed = contour.fIsClosed;
+        } else {
+            // Past the last contour, as if the iterator were done.
+            fSegments.reset();
+            fLength = 0;
+            fIsClosed = fForceClosed;
+        }
+        return;
+    }
+
     SkPoint         pts[4];
     unsigned        ptIndex = fFirstPtIndex;
     SkScalar        distance = 0;
@@ -499,6 +541,7 @@ SkPathMeasure::SkPathMeasure() {
     fLength = -1;   // signal we need to compute it
     fForceClosed = false;
     fFirstPtIndex = -1;
+    fContourIndex = 0;
 }
 
 SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resScale) {
@@ -507,6 +550,7 @@ SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resS
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
+    fContourIndex = 0;
 
     fIter.setPath(fPath, forceClosed);
 }
@@ -524,6 +568,8 @@ void SkPathMeasure::setPath(const SkPath* path, bool forceClosed) {
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
+    fTable.reset();
+    fContourIndex = 0;
 
     fIter.setPath(fPath, forceClosed);
     fSegments.reset();
@@ -719,6 +765,123 @@ bool SkPathMeasure::nextContour() {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkPathMeasure::Table> SkPathMeasure::Table::Make(const SkPath& path, bool forceClosed,
+                                                       SkScalar resScale) {
+    sk_sp<Table> table(new Table);
+    SkPathMeasure meas(path, forceClosed, resScale);
+    for (;;) {
+        Contour* contour = table->fContours.append();
+        contour->fLength = meas.getLength();
+        contour->fSegmentStart = table->fSegments.count();
+        contour->fSegmentCount = meas.fSegments.count();
+        contour->fIsClosed = meas.fIsClosed;
+        table->fSegments.append(meas.fSegments.count(), meas.fSegments.begin());
+
+        // Measure up to the contour that the iterator would find nothing in, however many
+        // contours nextContour() would stop short of.
+        SkPath::Iter iter = meas.fIter;
+        SkPoint pts[4];
+        if (SkPath::kDone_Verb == iter.next(pts)) {
+            break;
+        }
+        meas.fLength = -1;
+    }
+    table->fPts.swap(meas.fPts);
+    table->fContours.shrinkToFit();
+    table->fSegments.shrinkToFit();
+    table->fPts.shrinkToFit();
+    return table;
+}
+
+namespace {
+static unsigned gPathMeasureKeyNamespaceLabel;
+
+static uint64_t make_shared_id(uint32_t pathGenID) {
+    return (static_cast<uint64_t>(SkSetFourByteTag('p', 'm', 'e', 's')) << 32) | pathGenID;
+}
+
+struct PathMeasureKey : public SkResourceCache::Key {
+    PathMeasureKey(uint32_t pathGenID, bool forceClosed, SkScalar resScale)
+        : fForceClosed(forceClosed)
+        , fResScale(resScale)
+    {
+        this->init(&gPathMeasureKeyNamespaceLabel, make_shared_id(pathGenID),
+                   sizeof(fForceClosed) + sizeof(fResScale));
+    }
+
+    int32_t  fForceClosed;
+    SkScalar fResScale;
+};
+
+// Purges a path's measurements once nothing can measure it again.
+class PathMeasureInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit PathMeasureInvalidator(uint32_t pathGenID) : fPathGenID(pathGenID) {}
+
+private:
+    void onChange() override {
+        SkResourceCache::PostPurgeSharedID(make_shared_id(fPathGenID));
+    }
+
+    uint32_t fPathGenID;
+};
+}  // namespace
+
+struct SkPathMeasure::Table::Rec : public SkResourceCache::Rec {
+    Rec(const PathMeasureKey& key, sk_sp<Table> table)
+        : fKey(key)
+        , fTable(std::move(table)) {}
+
+    PathMeasureKey  fKey;
+    sk_sp<Table>    fTable;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fTable->bytesUsed(); }
+    const char* getCategory() const override { return "path-measure"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const Rec& rec = static_cast<const Rec&>(baseRec);
+        *static_cast<sk_sp<Table>*>(contextData) = rec.fTable;
+        return true;
+    }
+};
+
+sk_sp<SkPathMeasure::Table> SkPathMeasure::Table::FindOrMake(const SkPath& path,
+                                                             bool forceClosed,
+                                                             SkScalar resScale) {
+    const uint32_t genID = path.getGenerationID();
+    PathMeasureKey key(genID, forceClosed, resScale);
+    sk_sp<Table> table;
+    if (SkResourceCache::Find(key, Rec::Visitor, &table)) {
+        return table;
+    }
+    table = Make(path, forceClosed, resScale);
+    SkResourceCache::Add(new Rec(key, table));
+    SkPathPriv::AddGenIDChangeListener(path, sk_make_sp<PathMeasureInvalidator>(genID));
+    return table;
+}
+
+void SkPathMeasurePriv::SetPathCached(SkPathMeasure* meas, const SkPath& path, bool forceClosed,
+                                      SkScalar resScale) {
+    meas->setPath(&path, forceClosed);
+    meas->fTolerance = CHEAP_DIST_LIMIT * SkScalarInvert(resScale);
+
+#if !defined(IS_FUZZING_WITH_LIBFUZZER)
+    // Lines are cheap enough to measure that looking them up would cost as much. Volatile paths
+    // won't be seen again, and empty ones (including those setPath() rejects) share a generation
+    // ID that never changes.
+    const SkPath& src = meas->fPath;
+    if (src.isVolatile() || src.isEmpty() ||
+        (src.getSegmentMasks() == SkPath::kLine_SegmentMask && src.countPoints() <= 16)) {
+        return;
+    }
+    meas->fTable = SkPathMeasure::Table::FindOrMake(src, forceClosed, resScale);
+    meas->fPts = meas->fTable->fPts;
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
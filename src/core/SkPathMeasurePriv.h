@@ -9,6 +9,7 @@
 #define SkPathMeasurePriv_DEFINED
 
 #include "SkPath.h"
+#include "SkPathMeasure.h"
 #include "SkPoint.h"
 #include "SkGeometry.h"
 
@@ -26,4 +27,15 @@ enum SkSegType {
 void SkPathMeasure_segTo(const SkPoint pts[], unsigned segType,
                    SkScalar startT, SkScalar stopT, SkPath* dst);
 
+class SkPathMeasurePriv {
+public:
+    /**
+     *  Like meas->setPath(&path, forceClosed) with meas made at resScale, except that the contours
+     *  are only measured once per path and then shared through SkResourceCache. For path effects,
+     *  which are applied to the same path again and again as only their phase animates.
+     */
+    static void SetPathCached(SkPathMeasure* meas, const SkPath& path, bool forceClosed,
+                              SkScalar resScale);
+};
+
 #endif  // SkPathMeasurePriv_DEFINED
@@ -223,6 +223,13 @@ public:
     static bool IsBadForDAA(const SkPath& path) { return path.fIsBadForDAA; }
     static void SetIsBadForDAA(SkPath& path, bool isBadForDAA) { path.fIsBadForDAA = isBadForDAA; }
 
+    // Set on the fill path produced by stroking, whose many overlapping contours are cheapest to
+    // scan convert with DAA (see ShouldUseDAA in SkScan_AntiPath.cpp).
+    static bool IsStrokeOutline(const SkPath& path) { return path.fIsStrokeOutline; }
+    static void SetIsStrokeOutline(SkPath& path, bool isStrokeOutline) {
+        path.fIsStrokeOutline = isStrokeOutline;
+    }
+
     /**
      *  Sometimes in the drawing pipeline, we have to perform math on path coordinates, even after
      *  the path is in device-coordinates. Tessellation and clipping are two examples. Usually this
@@ -33,7 +33,7 @@ SkPathRef::Editor::Editor(sk_sp<SkPathRef>* pathRef,
     SkASSERT(incReserveVerbs >= 0);
     SkASSERT(incReservePoints >= 0);
 
-    if ((*pathRef)->unique()) {
+    if ((*pathRef)->isEditable()) {
         (*pathRef)->incReserve(incReserveVerbs, incReservePoints);
     } else {
         SkPathRef* copy = new SkPathRef;
@@ -57,7 +57,7 @@ void SkPath::shrinkToFit() {
         return;
     }
 
-    if (fPathRef->unique()) {
+    if (fPathRef->isEditable()) {
         int pointCount = fPathRef->fPointCnt;
         int verbCount = fPathRef->fVerbCnt;
 
@@ -73,6 +73,8 @@ void SkPath::shrinkToFit() {
         sk_careful_memcpy(newAlloc, fPathRef->fPoints, ptsSize);
         sk_careful_memcpy((char*)newAlloc + minSize - vrbSize, fPathRef->verbsMemBegin(), vrbSize);
 
+        SkMemoryAccounting::Remove(SkMemoryTag::kPathRef, fPathRef->currSize());
+        SkMemoryAccounting::Add(SkMemoryTag::kPathRef, minSize);
         sk_free(fPathRef->fPoints);
         fPathRef->fPoints = static_cast<SkPoint*>(newAlloc);
         fPathRef->fVerbs = (uint8_t*)newAlloc + minSize;
@@ -93,7 +95,10 @@ SkPathRef::~SkPathRef() {
     // Deliberately don't validate() this path ref, otherwise there's no way
     // to read one that's not valid and then free its memory without asserting.
     this->callGenIDChangeListeners();
-    sk_free(fPoints);
+    if (!fSharedStorage) {
+        SkMemoryAccounting::Remove(SkMemoryTag::kPathRef, this->currSize());
+        sk_free(fPoints);
+    }
 
     SkDEBUGCODE(fPoints = nullptr;)
     SkDEBUGCODE(fVerbs = nullptr;)
@@ -183,20 +188,24 @@ void SkPathRef::CreateTransformedCopy(sk_sp<SkPathRef>* dst,
         return;
     }
 
-    if (!(*dst)->unique()) {
+    // Holds on to *dst, which may be src, until src has been copied.
+    sk_sp<SkPathRef> old;
+    if (!(*dst)->isEditable()) {
+        old = std::move(*dst);
         dst->reset(new SkPathRef);
     }
 
     if (dst->get() != &src) {
-        (*dst)->resetToSize(src.fVerbCnt, src.fPointCnt, src.fConicWeights.count());
+        (*dst)->resetToSize(src.fVerbCnt, src.fPointCnt, src.countWeights());
         sk_careful_memcpy((*dst)->verbsMemWritable(), src.verbsMemBegin(),
                            src.fVerbCnt * sizeof(uint8_t));
-        (*dst)->fConicWeights = src.fConicWeights;
+        sk_careful_memcpy((*dst)->fConicWeights.begin(), src.conicWeights(),
+                          src.countWeights() * sizeof(SkScalar));
     }
 
     SkASSERT((*dst)->countPoints() == src.countPoints());
     SkASSERT((*dst)->countVerbs() == src.countVerbs());
-    SkASSERT((*dst)->fConicWeights.count() == src.fConicWeights.count());
+    SkASSERT((*dst)->countWeights() == src.countWeights());
 
     // Need to check this here in case (&src == dst)
     bool canXformBounds = !src.fBoundsIsDirty && matrix.rectStaysRect() && src.countPoints() > 1;
@@ -394,7 +403,7 @@ SkPathRef* SkPathRef::CreateFromBuffer(SkRBuffer* buffer) {
 }
 
 void SkPathRef::Rewind(sk_sp<SkPathRef>* pathRef) {
-    if ((*pathRef)->unique()) {
+    if ((*pathRef)->isEditable()) {
         SkDEBUGCODE((*pathRef)->validate();)
         (*pathRef)->callGenIDChangeListeners();
         (*pathRef)->fBoundsIsDirty = true;  // this also invalidates fIsFinite
@@ -455,7 +464,9 @@ bool SkPathRef::operator== (const SkPathRef& ref) const {
         SkASSERT(!genIDMatch);
         return false;
     }
-    if (fConicWeights != ref.fConicWeights) {
+    if (this->countWeights() != ref.countWeights() ||
+        0 != memcmp(this->conicWeights(), ref.conicWeights(),
+                    ref.countWeights() * sizeof(SkScalar))) {
         SkASSERT(!genIDMatch);
         return false;
     }
@@ -481,10 +492,10 @@ void SkPathRef::writeToBuffer(SkWBuffer* buffer) const {
     buffer->write32(0);
     buffer->write32(fVerbCnt);
     buffer->write32(fPointCnt);
-    buffer->write32(fConicWeights.count());
+    buffer->write32(this->countWeights());
     buffer->write(verbsMemBegin(), fVerbCnt * sizeof(uint8_t));
     buffer->write(fPoints, fPointCnt * sizeof(SkPoint));
-    buffer->write(fConicWeights.begin(), fConicWeights.bytes());
+    buffer->write(this->conicWeights(), this->countWeights() * sizeof(SkScalar));
     buffer->write(&bounds, sizeof(bounds));
 
     SkASSERT(buffer->pos() - beforePos == (size_t) this->writeSize());
@@ -494,7 +505,7 @@ uint32_t SkPathRef::writeSize() const {
     return uint32_t(5 * sizeof(uint32_t) +
                     fVerbCnt * sizeof(uint8_t) +
                     fPointCnt * sizeof(SkPoint) +
-                    fConicWeights.bytes() +
+                    this->countWeights() * sizeof(SkScalar) +
                     sizeof(SkRect));
 }
 
@@ -502,11 +513,12 @@ void SkPathRef::copy(const SkPathRef& ref,
                      int additionalReserveVerbs,
                      int additionalReservePoints) {
     SkDEBUGCODE(this->validate();)
-    this->resetToSize(ref.fVerbCnt, ref.fPointCnt, ref.fConicWeights.count(),
+    this->resetToSize(ref.fVerbCnt, ref.fPointCnt, ref.countWeights(),
                         additionalReserveVerbs, additionalReservePoints);
     sk_careful_memcpy(this->verbsMemWritable(), ref.verbsMemBegin(), ref.fVerbCnt*sizeof(uint8_t));
     sk_careful_memcpy(this->fPoints, ref.fPoints, ref.fPointCnt * sizeof(SkPoint));
-    fConicWeights = ref.fConicWeights;
+    sk_careful_memcpy(fConicWeights.begin(), ref.conicWeights(),
+                      ref.countWeights() * sizeof(SkScalar));
     fBoundsIsDirty = ref.fBoundsIsDirty;
     if (!fBoundsIsDirty) {
         fBounds = ref.fBounds;
@@ -713,6 +725,12 @@ void SkPathRef::addGenIDChangeListener(sk_sp<GenIDChangeListener> listener) {
 
 // we need to be called *before* the genID gets changed or zerod
 void SkPathRef::callGenIDChangeListeners() {
+    // We're only called on path refs that nothing else refers to, so no one can be adding a
+    // listener. Editing paths does this once per verb, so skip the lock when there are none.
+    SkASSERT(this->unique());
+    if (0 == fGenIDChangeListeners.count()) {
+        return;
+    }
     SkAutoMutexAcquire lock(fGenIDChangeListenersMutex);
     for (int i = 0; i < fGenIDChangeListeners.count(); i++) {
         fGenIDChangeListeners[i]->onChange();
@@ -8,11 +8,15 @@
 #include "SkPictureData.h"
 
 #include "SkAutoMalloc.h"
+#include "SkExecutor.h"
 #include "SkImageGenerator.h"
 #include "SkMakeUnique.h"
+#include "SkMemoryAccounting.h"
 #include "SkPictureRecord.h"
 #include "SkPicturePriv.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 #include "SkTextBlobPriv.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
@@ -31,6 +35,18 @@ template <typename T> int SafeCount(const T* obj) {
 SkPictureData::SkPictureData(const SkPictInfo& info)
     : fInfo(info) {}
 
+SkPictureData::~SkPictureData() {
+    SkMemoryAccounting::Remove(SkMemoryTag::kPictureData, fAccountedBytes);
+}
+
+void SkPictureData::accountMemory() {
+    SkASSERT(0 == fAccountedBytes);
+    fAccountedBytes = (fOpData ? fOpData->size() : 0) +
+                      fPaints.count() * sizeof(SkPaint) +
+                      fPaths.count() * sizeof(SkPath);
+    SkMemoryAccounting::Add(SkMemoryTag::kPictureData, fAccountedBytes);
+}
+
 void SkPictureData::initForPlayback() const {
     // ensure that the paths bounds are pre-computed
     for (int i = 0; i < fPaths.count(); i++) {
@@ -59,6 +75,7 @@ SkPictureData::SkPictureData(const SkPictureRecord& record,
     });
 
     this->initForPlayback();
+    this->accountMemory();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -93,6 +110,18 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// The op and buffer blocks are read in place when the stream is in memory (see
+// read_or_share()), which needs them 4-byte aligned.  The tag and size before the block are
+// 8 bytes, so pad until the next tag is aligned.
+static void align_next_tag_data(SkWStream* stream) {
+    const size_t pad = (4 - (stream->bytesWritten() & 3)) & 3;
+    if (pad) {
+        write_tag_size(stream, SK_PICT_PAD_TAG, pad);
+        const uint32_t zero = 0;
+        stream->write(&zero, pad);
+    }
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -199,6 +228,7 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
                               SkRefCntSet* topLevelTypeFaceSet) const {
     // This can happen at pretty much any time, so might as well do it first.
+    align_next_tag_data(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
@@ -238,6 +268,7 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     }
 
     // Write the buffer.
+    align_next_tag_data(stream);
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
@@ -277,18 +308,44 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Reads the next size bytes of stream.  When the stream reads streamData directly and those
+// bytes are 4-byte aligned, as SkReadBuffer needs, they're shared rather than copied.
+static sk_sp<SkData> read_or_share(SkStream* stream, size_t size, const SkData* streamData,
+                                   bool* shared) {
+    *shared = false;
+    if (streamData && stream->hasPosition()) {
+        const size_t offset = stream->getPosition();
+        if (offset <= streamData->size() && size <= streamData->size() - offset &&
+            SkIsAlign4((uintptr_t)streamData->bytes() + offset)) {
+            if (stream->skip(size) != size) {
+                return nullptr;
+            }
+            *shared = true;
+            return SkData::MakeSubset(streamData, offset, size);
+        }
+    }
+    return SkData::MakeFromStream(stream, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    const SkDeserialProcs& procs,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   const SkData* streamData) {
     switch (tag) {
-        case SK_PICT_READER_TAG:
+        case SK_PICT_READER_TAG: {
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            bool shared;
+            fOpData = read_or_share(stream, size, streamData, &shared);
             if (!fOpData) {
                 return false;
             }
+        } break;
+        case SK_PICT_PAD_TAG:
+            if (stream->skip(size) != size) {
+                return false;
+            }
             break;
         case SK_PICT_FACTORY_TAG: {
             if (!stream->readU32(&size)) { return false; }
@@ -321,7 +378,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback,
+                                                     streamData);
                 if (!pic) {
                     return false;
                 }
@@ -329,13 +387,18 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            bool shared;
+            sk_sp<SkData> storage = read_or_share(stream, size, streamData, &shared);
+            if (!storage) {
                 return false;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), size);
             buffer.setVersion(fInfo.getVersion());
+            if (shared) {
+                // Encoded images keep referencing streamData, rather than a copy of the block.
+                buffer.setMemoryOwner(storage.get());
+            }
 
             if (!fFactoryPlayback) {
                 return false;
@@ -435,7 +498,11 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
             new_array_from_buffer(buffer, size, fVertices, create_vertices_from_buffer);
             break;
         case SK_PICT_IMAGE_BUFFER_TAG:
-            new_array_from_buffer(buffer, size, fImages, create_image_from_buffer);
+            if (buffer.getDeserialProcs().fExecutor && size > 1) {
+                this->parseImagesInParallel(buffer, size);
+            } else {
+                new_array_from_buffer(buffer, size, fImages, create_image_from_buffer);
+            }
             break;
         case SK_PICT_READER_TAG: {
             // Preflight check that we can initialize all data from the buffer
@@ -463,18 +530,52 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
     }
 }
 
+// Reading the images is quick: they're mostly encoded bytes.  Making them (checking the
+// encoding, or whatever fImageProc does) is what takes time, and is independent per image.
+void SkPictureData::parseImagesInParallel(SkReadBuffer& buffer, uint32_t inCount) {
+    if (!buffer.validate(fImages.empty() && SkTFitsIn<int>(inCount) &&
+                         buffer.getInflator() == nullptr)) {
+        return;
+    }
+    const int count = SkToInt(inCount);
+
+    SkAutoTArray<SkIRect>       bounds(count);
+    SkAutoTArray<sk_sp<SkData>> encoded(count);
+    for (int i = 0; i < count; ++i) {
+        if (!buffer.readEncodedImage(&bounds[i], &encoded[i])) {
+            return;
+        }
+    }
+
+    SkAutoTArray<sk_sp<SkImage>> images(count);
+    SkTaskGroup(*buffer.getDeserialProcs().fExecutor).batch(count, [&](int i) {
+        images[i] = buffer.makeImage(bounds[i], std::move(encoded[i]));
+    });
+
+    fImages.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (!buffer.validate(images[i] != nullptr)) {
+            fImages.reset();
+            return;
+        }
+        fImages.push_back(std::move(images[i]));
+    }
+}
+
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* streamData) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, procs, topLevelTFPlayback)) {
+    if (!data->parseStream(stream, procs, topLevelTFPlayback, streamData)) {
         return nullptr;
     }
+    data->accountMemory();
     return data.release();
 }
 
@@ -486,12 +587,14 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
     if (!data->parseBuffer(buffer)) {
         return nullptr;
     }
+    data->accountMemory();
     return data.release();
 }
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 const SkDeserialProcs& procs,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                const SkData* streamData) {
     for (;;) {
         uint32_t tag;
         if (!stream->readU32(&tag)) { return false; }
@@ -501,7 +604,7 @@ bool SkPictureData::parseStream(SkStream* stream,
 
         uint32_t size;
         if (!stream->readU32(&size)) { return false; }
-        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback)) {
+        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback, streamData)) {
             return false; // we're invalid
         }
     }
@@ -58,9 +58,13 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
     if (fRecord->count() == 0) {
-        auto pic = fMiniRecorder->detachAsPicture(fBBH ? nullptr : &fCullRect);
-        fBBH.reset(nullptr);
-        return pic;
+        // An SkBBoxHierarchy only helps pictures of several ops, so those get a real SkRecord.
+        if (!fBBH || fMiniRecorder->count() <= 1) {
+            auto pic = fMiniRecorder->detachAsPicture(fBBH ? nullptr : &fCullRect);
+            fBBH.reset(nullptr);
+            return pic;
+        }
+        fRecorder->flushMiniRecorder();
     }
 
     // TODO: delay as much of this work until just before first playback?
@@ -8,6 +8,7 @@
 #include "SkPixmap.h"
 
 #include "SkBitmap.h"
+#include "SkBitmapScaler.h"
 #include "SkCanvas.h"
 #include "SkColorData.h"
 #include "SkConvertPixels.h"
@@ -347,6 +348,14 @@ bool SkPixmap::scalePixels(const SkPixmap& actualDst, SkFilterQuality quality) c
         return src.readPixels(dst);
     }
 
+    // High quality downscales filter every source pixel under each destination pixel, rather
+    // than sampling bicubic from a 4x4 neighborhood (or a mipmap level built just for this).
+    if (quality == kHigh_SkFilterQuality &&
+        dst.width() <= src.width() && dst.height() <= src.height() &&
+        SkBitmapScaler::Resize(dst, src, SkBitmapScaler::kMitchell_ResizeMethod)) {
+        return true;
+    }
+
     // If src and dst are both unpremul, we'll fake the source out to appear as if premul,
     // and mark the destination as opaque.  This odd combination allows us to scale unpremul
     // pixels without ever premultiplying them (perhaps losing information in the color channels).
@@ -7,6 +7,12 @@
 
 #include "SkRTree.h"
 
+#include "SkNx.h"
+#include "SkTaskGroup.h"
+
+// Levels with at least twice this many branches are grouped into nodes in parallel.
+static constexpr int kMinBranchesPerTask = 16 * 1024;
+
 SkRTree::SkRTree(SkScalar aspectRatio)
     : fCount(0), fAspectRatio(isfinite(aspectRatio) ? aspectRatio : 1) {}
 
@@ -40,8 +46,7 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
         if (1 == fCount) {
             fNodes.setReserve(1);
             Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
+            n->setChildren(branches.begin(), 1);
             fRoot.fSubtree = n;
             fRoot.fBounds  = branches[0].fBounds;
         } else {
@@ -60,6 +65,26 @@ SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
     return out;
 }
 
+void SkRTree::Node::setChildren(const Branch branches[], int count) {
+    SkASSERT(0 < count && count <= kMaxChildren);
+    fNumChildren = SkToU16(count);
+    for (int i = 0; i < count; ++i) {
+        fLeft  [i] = branches[i].fBounds.fLeft;
+        fTop   [i] = branches[i].fBounds.fTop;
+        fRight [i] = branches[i].fBounds.fRight;
+        fBottom[i] = branches[i].fBounds.fBottom;
+        if (0 == fLevel) {
+            fChildren[i].fOpIndex = branches[i].fOpIndex;
+        } else {
+            fChildren[i].fSubtree = branches[i].fSubtree;
+        }
+    }
+    for (int i = count; i < kPaddedChildren; ++i) {
+        fLeft[i] = fTop   [i] = SK_ScalarInfinity;
+        fRight[i] = fBottom[i] = SK_ScalarNegativeInfinity;
+    }
+}
+
 // This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
 int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
     if (branches == 1) {
@@ -111,7 +136,6 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
     // difference in playback speed.
     int numBranches = branches->count() / kMaxChildren;
     int remainder   = branches->count() % kMaxChildren;
-    int newBranches = 0;
 
     if (remainder > 0) {
         ++numBranches;
@@ -127,6 +151,10 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
     int numTiles  = SkScalarCeilToInt(SkIntToScalar(numBranches) / SkIntToScalar(numStrips));
     int currentBranch = 0;
 
+    // First decide which run of branches goes into each node, then fill the nodes, which
+    // don't depend on each other.
+    SkTDArray<int> firstBranch;
+    firstBranch.setReserve(numBranches + 1);
     for (int i = 0; i < numStrips; ++i) {
         // Might be worth sorting by X here too.
         for (int j = 0; j < numTiles && currentBranch < branches->count(); ++j) {
@@ -141,24 +169,39 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
                     remainder -= kMaxChildren - kMinChildren;
                 }
             }
-            Node* n = allocateNodeAtLevel(level);
-            n->fNumChildren = 1;
-            n->fChildren[0] = (*branches)[currentBranch];
-            Branch b;
-            b.fBounds = (*branches)[currentBranch].fBounds;
-            b.fSubtree = n;
-            ++currentBranch;
-            for (int k = 1; k < incrementBy && currentBranch < branches->count(); ++k) {
-                b.fBounds.join((*branches)[currentBranch].fBounds);
-                n->fChildren[k] = (*branches)[currentBranch];
-                ++n->fNumChildren;
-                ++currentBranch;
-            }
-            (*branches)[newBranches] = b;
-            ++newBranches;
+            firstBranch.push_back(currentBranch);
+            currentBranch = SkTMin(currentBranch + incrementBy, branches->count());
         }
     }
-    branches->setCount(newBranches);
+    const int newBranches = firstBranch.count();
+    firstBranch.push_back(currentBranch);
+
+    SkDEBUGCODE(Node* p = fNodes.begin());
+    Node* nodes = fNodes.append(newBranches);
+    SkASSERT(fNodes.begin() == p);  // If this fails, we didn't setReserve() enough.
+
+    SkTDArray<Branch> parents;
+    parents.setCount(newBranches);
+    auto fill = [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            const Branch* children = branches->begin() + firstBranch[i];
+            const int count = firstBranch[i + 1] - firstBranch[i];
+            Node* n = nodes + i;
+            n->fLevel = SkToU16(level);
+            n->setChildren(children, count);
+
+            parents[i].fSubtree = n;
+            parents[i].fBounds  = children[0].fBounds;
+            for (int k = 1; k < count; ++k) {
+                parents[i].fBounds.join(children[k].fBounds);
+            }
+        }
+    };
+
+    const int tasks = branches->count() / kMinBranchesPerTask;
+    SkParallelFor(newBranches, tasks > 1 ? (newBranches + tasks - 1) / tasks : newBranches, fill);
+
+    branches->swap(parents);
     return this->bulkLoad(branches, level + 1);
 }
 
@@ -168,13 +211,32 @@ void SkRTree::search(const SkRect& query, SkTDArray<int>* results) const {
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, SkTDArray<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push_back(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+void SkRTree::search(const Node* node, const SkRect& query, SkTDArray<int>* results) const {
+    const Sk4f l(query.fLeft),
+               t(query.fTop),
+               r(query.fRight),
+               b(query.fBottom);
+    for (int i = 0; i < node->fNumChildren; i += 4) {
+        // Like SkRect::Intersects(), four children at a time: they intersect the query if
+        // their overlap is positive both ways.  (Padding overlaps by -infinity.)
+        const Sk4f overlapW = Sk4f::Min(Sk4f::Load(node->fRight  + i), r)
+                            - Sk4f::Max(Sk4f::Load(node->fLeft   + i), l),
+                   overlapH = Sk4f::Min(Sk4f::Load(node->fBottom + i), b)
+                            - Sk4f::Max(Sk4f::Load(node->fTop    + i), t);
+        const Sk4f hit = (overlapW > 0).thenElse(overlapH, 0.0f) > 0;
+        if (!hit.anyTrue()) {
+            continue;
+        }
+        float lanes[4];
+        hit.thenElse(1.0f, 0.0f).store(lanes);
+        // Padding never hits, so we needn't check i + k against fNumChildren.
+        for (int k = 0; k < 4; ++k) {
+            if (lanes[k] != 0) {
+                if (0 == node->fLevel) {
+                    results->push_back(node->fChildren[i + k].fOpIndex);
+                } else {
+                    this->search(node->fChildren[i + k].fSubtree, query, results);
+                }
             }
         }
     }
@@ -18,6 +18,7 @@
  *
  * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
  * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * Nodes live in one array; large levels of the tree are built in parallel.
  *
  * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
  * which groups rects by position on the Hilbert curve, is probably worth a look). There also
@@ -69,18 +70,32 @@ private:
         SkRect fBounds;
     };
 
+    // Children are tested against a query four at a time, so their bounds are stored by edge,
+    // padded to a multiple of four with bounds that never intersect anything.
+    static const int kPaddedChildren = (kMaxChildren + 3) & ~3;
+
     struct Node {
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
+        float fLeft  [kPaddedChildren],
+              fTop   [kPaddedChildren],
+              fRight [kPaddedChildren],
+              fBottom[kPaddedChildren];
+        union {
+            Node* fSubtree;
+            int fOpIndex;
+        } fChildren[kMaxChildren];
+
+        // Call after setting fLevel.
+        void setChildren(const Branch branches[], int count);
     };
 
-    void search(Node* root, const SkRect& query, SkTDArray<int>* results) const;
+    void search(const Node* root, const SkRect& query, SkTDArray<int>* results) const;
 
     // Consumes the input array.
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
 
-    // How many times will bulkLoad() call allocateNodeAtLevel()?
+    // How many nodes will bulkLoad() allocate?
     static int CountNodes(int branches, SkScalar aspectRatio);
 
     Node* allocateNodeAtLevel(uint16_t level);
@@ -10,6 +10,7 @@
 #include "SkAtomics.h"
 #include "SkMakeUnique.h"
 #include "SkMalloc.h"
+#include "SkSemaphore.h"
 #include "SkStream.h"
 #include "SkTo.h"
 
@@ -192,6 +193,73 @@ bool SkROBuffer::Iter::next() {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// What the writer has published to its streaming readers. Like a snapshot, a reader only walks
+// as many bytes as have been published, using block.fCapacity to step over the full blocks, so
+// that it never touches anything the writer is still updating.
+//
+struct SkBufferStreamState : public SkNVRefCnt<SkBufferStreamState> {
+    ~SkBufferStreamState() {
+        if (const SkBufferHead* head = fHead.load(std::memory_order_relaxed)) {
+            head->unref();
+        }
+    }
+
+    // Called by the writer after each append, with all the bytes written into the blocks.
+    void publish(const SkBufferHead* head, size_t available) {
+        if (!fHead.load(std::memory_order_relaxed)) {
+            head->ref();
+            fHead.store(head, std::memory_order_release);
+        }
+        fAvailable.store(available, std::memory_order_seq_cst);
+        this->wakeReaders();
+    }
+
+    void finish() {
+        fFinished.store(true, std::memory_order_seq_cst);
+        this->wakeReaders();
+    }
+
+    const SkBufferHead* head() const { return fHead.load(std::memory_order_acquire); }
+
+    // Returns the number of bytes available, waiting until there are more than |position| or
+    // the writer has finished. The acquire pairs with publish(), so that the blocks holding
+    // those bytes, and the links to them, are visible to the reader.
+    size_t waitForMoreThan(size_t position) {
+        for (;;) {
+            size_t available = fAvailable.load(std::memory_order_acquire);
+            if (available > position || fFinished.load(std::memory_order_acquire)) {
+                // Once finished, nothing more is published, so this is the final size.
+                return fAvailable.load(std::memory_order_acquire);
+            }
+
+            // Announce that we are going to wait, then look again, so that either we see the
+            // writer's next publish() or it sees us and signals.
+            fWaiters.fetch_add(1, std::memory_order_seq_cst);
+            if (fAvailable.load(std::memory_order_seq_cst) > position ||
+                fFinished.load(std::memory_order_seq_cst)) {
+                // A signal meant for us may be left behind; it only causes an extra loop.
+                continue;
+            }
+            fWakeup.wait();
+        }
+    }
+
+private:
+    void wakeReaders() {
+        if (int waiters = fWaiters.exchange(0, std::memory_order_seq_cst)) {
+            fWakeup.signal(waiters);
+        }
+    }
+
+    std::atomic<const SkBufferHead*> fHead{nullptr};
+    std::atomic<size_t>              fAvailable{0};
+    std::atomic<bool>                fFinished{false};
+    std::atomic<int>                 fWaiters{0};
+    SkSemaphore                      fWakeup;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 SkRWBuffer::SkRWBuffer(size_t initialCapacity) : fHead(nullptr), fTail(nullptr), fTotalUsed(0) {
     if (initialCapacity) {
         fHead = SkBufferHead::Alloc(initialCapacity);
@@ -201,6 +269,7 @@ SkRWBuffer::SkRWBuffer(size_t initialCapacity) : fHead(nullptr), fTail(nullptr),
 
 SkRWBuffer::~SkRWBuffer() {
     this->validate();
+    this->finish();
     if (fHead) {
         fHead->unref();
     }
@@ -236,6 +305,10 @@ void SkRWBuffer::append(const void* src, size_t length, size_t reserve) {
         SkASSERT(written == length);
     }
     this->validate();
+
+    if (fStreamState) {
+        fStreamState->publish(fHead, fTotalUsed);
+    }
 }
 
 #ifdef SK_DEBUG
@@ -363,3 +436,112 @@ private:
 std::unique_ptr<SkStreamAsset> SkRWBuffer::makeStreamSnapshot() const {
     return skstd::make_unique<SkROBufferStreamAsset>(this->makeROBufferSnapshot());
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class SkRWBufferStream : public SkStreamSeekable {
+public:
+    SkRWBufferStream(sk_sp<SkBufferStreamState> state) : fState(std::move(state)) {
+        this->rewind();
+    }
+
+    size_t read(void* dst, size_t request) override {
+        size_t bytesRead = 0;
+        while (bytesRead < request) {
+            size_t available = fState->waitForMoreThan(fPosition);
+            if (available <= fPosition) {
+                break;  // the writer has finished
+            }
+            size_t amount = SkTMin(request - bytesRead, available - fPosition);
+            this->copy(dst ? (char*)dst + bytesRead : nullptr, amount);
+            bytesRead += amount;
+        }
+        return bytesRead;
+    }
+
+    // We can't know that we are at the end without waiting to see if the writer appends more.
+    bool isAtEnd() const override {
+        return fPosition == fState->waitForMoreThan(fPosition);
+    }
+
+    bool rewind() override {
+        fBlock = nullptr;
+        fLocalOffset = 0;
+        fPosition = 0;
+        return true;
+    }
+
+    size_t getPosition() const override {
+        return fPosition;
+    }
+
+    bool seek(size_t position) override {
+        if (position < fPosition) {
+            this->rewind();
+        }
+        (void)this->skip(position - fPosition);
+        return true;
+    }
+
+    bool move(long offset) override {
+        offset += fPosition;
+        if (offset <= 0) {
+            this->rewind();
+        } else {
+            (void)this->seek(SkToSizeT(offset));
+        }
+        return true;
+    }
+
+private:
+    // Copies |count| bytes that have been published, starting at fPosition.
+    void copy(char* dst, size_t count) {
+        fPosition += count;
+        while (count) {
+            if (!fBlock) {
+                fBlock = &fState->head()->fBlock;
+            } else if (fLocalOffset == fBlock->fCapacity) {
+                // We only get here when there are more published bytes, so there is a next block.
+                fBlock = fBlock->fNext;
+                fLocalOffset = 0;
+            }
+            size_t amount = SkTMin(count, fBlock->fCapacity - fLocalOffset);
+            if (dst) {
+                memcpy(dst, (const char*)fBlock->startData() + fLocalOffset, amount);
+                dst += amount;
+            }
+            fLocalOffset += amount;
+            count -= amount;
+        }
+    }
+
+    SkStreamSeekable* onDuplicate() const override {
+        return new SkRWBufferStream(fState);
+    }
+
+    SkStreamSeekable* onFork() const override {
+        auto clone = this->duplicate();
+        clone->seek(this->getPosition());
+        return clone.release();
+    }
+
+    sk_sp<SkBufferStreamState> fState;
+    const SkBufferBlock*       fBlock;
+    size_t                     fLocalOffset;
+    size_t                     fPosition;
+};
+
+std::unique_ptr<SkStreamSeekable> SkRWBuffer::makeStreamingReader() {
+    if (!fStreamState) {
+        fStreamState = sk_make_sp<SkBufferStreamState>();
+        if (fHead) {
+            fStreamState->publish(fHead, fTotalUsed);
+        }
+    }
+    return skstd::make_unique<SkRWBufferStream>(fStreamState);
+}
+
+void SkRWBuffer::finish() {
+    if (fStreamState) {
+        fStreamState->finish();
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkRasterClip.h"
+#include "SkAAClipCache.h"
 #include "SkPath.h"
 #include "SkRegionPriv.h"
 
@@ -259,16 +260,9 @@ bool SkRasterClip::op(const SkPath& path, const SkMatrix& matrix, const SkIRect&
     this->applyClipRestriction(op, &bounds);
 
     // base is used to limit the size (and therefore memory allocation) of the
-    // region that results from scan converting devPath.
+    // region that results from scan converting the path.
     SkRegion base;
 
-    SkPath devPath;
-    if (matrix.isIdentity()) {
-        devPath = path;
-    } else {
-        path.transform(matrix, &devPath);
-        devPath.setIsVolatile(true);
-    }
     if (SkRegion::kIntersect_Op == op) {
         // since we are intersect, we can do better (tighter) with currRgn's
         // bounds, than just using the device. However, if currRgn is complex,
@@ -277,26 +271,58 @@ bool SkRasterClip::op(const SkPath& path, const SkMatrix& matrix, const SkIRect&
             // FIXME: we should also be able to do this when this->isBW(),
             // but relaxing the test above triggers GM asserts in
             // SkRgnBuilder::blitH(). We need to investigate what's going on.
-            return this->setPath(devPath, this->bwRgn(), doAA);
+            return this->setPath(path, matrix, this->bwRgn(), doAA);
         } else {
             base.setRect(this->getBounds());
             SkRasterClip clip;
-            clip.setPath(devPath, base, doAA);
+            clip.setPath(path, matrix, base, doAA);
             return this->op(clip, op);
         }
     } else {
         base.setRect(bounds);
 
         if (SkRegion::kReplace_Op == op) {
-            return this->setPath(devPath, base, doAA);
+            return this->setPath(path, matrix, base, doAA);
         } else {
             SkRasterClip clip;
-            clip.setPath(devPath, base, doAA);
+            clip.setPath(path, matrix, base, doAA);
             return this->op(clip, op);
         }
     }
 }
 
+bool SkRasterClip::setPath(const SkPath& path, const SkMatrix& matrix, const SkRegion& clip,
+                           bool doAA) {
+    // Antialiased clips of complex paths are costly to build and often repeat, e.g. the same
+    // clip applied to every tile of a picture, so we keep them in SkResourceCache.
+    const bool useCache = doAA && clip.isRect() && SkAAClipCache::ShouldCache(path);
+    if (useCache) {
+        SkAAClip cached;
+        if (SkAAClipCache::Find(path, matrix, clip.getBounds(), &cached)) {
+            AUTO_RASTERCLIP_VALIDATE(*this);
+            fBW.setEmpty();
+            fAA.swap(cached);
+            fIsBW = false;
+            return this->updateCacheAndReturnNonEmpty();
+        }
+    }
+
+    SkPath devPath;
+    if (matrix.isIdentity()) {
+        devPath = path;
+    } else {
+        path.transform(matrix, &devPath);
+        devPath.setIsVolatile(true);
+    }
+    bool nonEmpty = this->setPath(devPath, clip, doAA);
+
+    // Rect and empty results are cheap to rebuild, and come back as BW.
+    if (useCache && this->isAA()) {
+        SkAAClipCache::Add(path, matrix, clip.getBounds(), fAA);
+    }
+    return nonEmpty;
+}
+
 bool SkRasterClip::setPath(const SkPath& path, const SkIRect& clip, bool doAA) {
     SkRegion tmp;
     tmp.setRect(clip);
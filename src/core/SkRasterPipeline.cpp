@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkChecksum.h"
 #include "SkRasterPipeline.h"
 #include "../jumper/SkJumper.h"
 #include <algorithm>
@@ -16,6 +17,15 @@ void SkRasterPipeline::reset() {
     fStages      = nullptr;
     fNumStages   = 0;
     fSlotsNeeded = 1;  // We always need one extra slot for just_return().
+    fTopologyHash = fTopologyHashBeforeLast = 0;
+    fFusedStore  = nullptr;
+}
+
+void SkRasterPipeline::add_to_topology(const StageList& st) {
+    fTopologyHashBeforeLast = fTopologyHash;
+    uint32_t bits = (uint32_t)st.stage ^ (uint32_t)(st.stage >> 32);
+    bits = (bits << 2) | (st.ctx ? 2 : 0) | (st.rawFunction ? 1 : 0);
+    fTopologyHash = SkChecksum::Mix(fTopologyHash ^ SkChecksum::Mix(bits));
 }
 
 void SkRasterPipeline::append(StockStage stage, void* ctx) {
@@ -26,21 +36,99 @@ void SkRasterPipeline::append(StockStage stage, void* ctx) {
     SkASSERT(stage !=             clamp_gamut);  // Please use append_gamut_clamp_if_normalized().
     this->unchecked_append(stage, ctx);
 }
+// When second is appended right after first, we run them both as the single stage fused.
+// At most one of first and second may have a context, which fused then takes.
+static const struct {
+    SkRasterPipeline::StockStage first, second, fused;
+} kFusions[] = {
+    { SkRasterPipeline::seed_shader, SkRasterPipeline::matrix_translate,
+      SkRasterPipeline::seed_shader_matrix_translate },
+    { SkRasterPipeline::seed_shader, SkRasterPipeline::matrix_scale_translate,
+      SkRasterPipeline::seed_shader_matrix_scale_translate },
+    { SkRasterPipeline::seed_shader, SkRasterPipeline::matrix_2x3,
+      SkRasterPipeline::seed_shader_matrix_2x3 },
+    { SkRasterPipeline::seed_shader, SkRasterPipeline::matrix_perspective,
+      SkRasterPipeline::seed_shader_matrix_perspective },
+
+    // These don't need new stages, just the ones that already swap r and b as they go.
+    { SkRasterPipeline::load_8888,   SkRasterPipeline::swap_rb,     SkRasterPipeline::load_bgra   },
+    { SkRasterPipeline::load_bgra,   SkRasterPipeline::swap_rb,     SkRasterPipeline::load_8888   },
+    { SkRasterPipeline::gather_8888, SkRasterPipeline::swap_rb,     SkRasterPipeline::gather_bgra },
+    { SkRasterPipeline::gather_bgra, SkRasterPipeline::swap_rb,     SkRasterPipeline::gather_8888 },
+    // These leave r and b unswapped for any stage after the store, so are undone if one is added.
+    { SkRasterPipeline::swap_rb,     SkRasterPipeline::store_8888,  SkRasterPipeline::store_bgra  },
+    { SkRasterPipeline::swap_rb,     SkRasterPipeline::store_bgra,  SkRasterPipeline::store_8888  },
+};
+
+static bool is_store_8888_or_bgra(SkRasterPipeline::StockStage stage) {
+    return stage == SkRasterPipeline::store_8888 || stage == SkRasterPipeline::store_bgra;
+}
+
+bool SkRasterPipeline::try_fuse(StockStage stage, void* ctx) {
+    StageList* last = fStages;
+    if (!fFuseStages || !last || last->rawFunction || (last->ctx && ctx)) {
+        return false;
+    }
+    for (const auto& fusion : kFusions) {
+        if (last->stage == (uint64_t)fusion.first && stage == fusion.second) {
+            fSlotsNeeded -= last->ctx ? 2 : 1;
+            last->stage = (uint64_t)fusion.fused;
+            last->ctx   = last->ctx ? last->ctx : ctx;
+            fSlotsNeeded += last->ctx ? 2 : 1;
+
+            fTopologyHash = fTopologyHashBeforeLast;
+            this->add_to_topology(*last);
+            if (is_store_8888_or_bgra(stage)) {
+                fFusedStore = last;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void SkRasterPipeline::unfuse_store() {
+    StageList* store = fStages;
+    if (!store || store != fFusedStore) {
+        return;
+    }
+    StageList* swap = fAlloc->make<StageList>( StageList{store->prev, (uint64_t) swap_rb,
+                                                         nullptr, false} );
+    store->prev  = swap;
+    store->stage = store->stage == (uint64_t)store_bgra ? (uint64_t)store_8888
+                                                        : (uint64_t)store_bgra;
+    fNumStages   += 1;
+    fSlotsNeeded += 1;
+    fFusedStore   = nullptr;
+
+    fTopologyHash = fTopologyHashBeforeLast;
+    this->add_to_topology(*swap);
+    this->add_to_topology(*store);
+}
+
 void SkRasterPipeline::unchecked_append(StockStage stage, void* ctx) {
+    this->unfuse_store();
+    if (this->try_fuse(stage, ctx)) {
+        return;
+    }
     fStages = fAlloc->make<StageList>( StageList{fStages, (uint64_t) stage, ctx, false} );
     fNumStages   += 1;
     fSlotsNeeded += ctx ? 2 : 1;
+    this->add_to_topology(*fStages);
 }
 void SkRasterPipeline::append(void* fn, void* ctx) {
+    this->unfuse_store();
     fStages = fAlloc->make<StageList>( StageList{fStages, (uint64_t) fn, ctx, true} );
     fNumStages   += 1;
     fSlotsNeeded += ctx ? 2 : 1;
+    this->add_to_topology(*fStages);
 }
 
 void SkRasterPipeline::extend(const SkRasterPipeline& src) {
     if (src.empty()) {
         return;
     }
+    this->unfuse_store();
     auto stages = fAlloc->makeArrayDefault<StageList>(src.fNumStages);
 
     int n = src.fNumStages;
@@ -54,8 +142,12 @@ void SkRasterPipeline::extend(const SkRasterPipeline& src) {
     stages[0].prev = fStages;
 
     fStages = &stages[src.fNumStages - 1];
+    fFusedStore = src.fFusedStore == src.fStages ? fStages : nullptr;
     fNumStages   += src.fNumStages;
     fSlotsNeeded += src.fSlotsNeeded - 1;  // Don't double count just_returns().
+    for (int i = 0; i < src.fNumStages; i++) {
+        this->add_to_topology(stages[i]);
+    }
 }
 
 void SkRasterPipeline::dump() const {
@@ -91,6 +183,10 @@ void SkRasterPipeline::dump() const {
     #define INC_COLOR
 #endif
 
+void SkRasterPipeline::append_uniform_color(const SkJumper_UniformColorCtx* ctx) {
+    this->unchecked_append(unbounded_uniform_color, const_cast<SkJumper_UniformColorCtx*>(ctx));
+}
+
 void SkRasterPipeline::append_set_rgb(SkArenaAlloc* alloc, const float rgb[3]) {
     auto arg = alloc->makeArrayDefault<float>(3);
     arg[0] = rgb[0];
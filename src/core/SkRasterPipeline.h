@@ -70,6 +70,8 @@
     M(matrix_translate) M(matrix_scale_translate)                  \
     M(matrix_2x3) M(matrix_3x3) M(matrix_3x4) M(matrix_4x5) M(matrix_4x3) \
     M(matrix_perspective)                                          \
+    M(seed_shader_matrix_translate) M(seed_shader_matrix_scale_translate) \
+    M(seed_shader_matrix_2x3) M(seed_shader_matrix_perspective)    \
     M(parametric) M(gamma)                                         \
     M(mirror_x)   M(repeat_x)                                      \
     M(mirror_y)   M(repeat_y)                                      \
@@ -97,7 +99,11 @@
     M(mask_2pt_conical_degenerates) M(apply_vector_mask)           \
     M(byte_tables)                                                 \
     M(rgb_to_hsl) M(hsl_to_rgb)                                    \
-    M(gauss_a_to_rgba)
+    M(gauss_a_to_rgba)                                             \
+    M(perlin_noise)                                                \
+    M(sdf_to_alpha)
+
+class SkRasterPipelineProgramCache;
 
 class SkRasterPipeline {
 public:
@@ -116,6 +122,8 @@ public:
         SK_RASTER_PIPELINE_STAGES(M)
     #undef M
     };
+    // append() fuses some common pairs of stages, e.g. seed_shader then matrix_2x3 becomes
+    // seed_shader_matrix_2x3, and folds swap_rb into a neighboring 8888 load, store, or gather.
     void append(StockStage, void* = nullptr);
     void append(StockStage stage, const void* ctx) { this->append(stage, const_cast<void*>(ctx)); }
     // For raw functions (i.e. from a JIT).  Don't use this unless you know exactly what fn needs to
@@ -145,6 +153,10 @@ public:
         this->append_constant_color(alloc, color.vec());
     }
 
+    // Appends a stage loading the color in ctx, which may change between runs. The color may be
+    // out of range, so unlike append_constant_color() this never runs in lowp.
+    void append_uniform_color(const SkJumper_UniformColorCtx*);
+
     // Like append_constant_color() but only affecting r,g,b, ignoring the alpha channel.
     void append_set_rgb(SkArenaAlloc*, const float rgb[3]);
 
@@ -160,6 +172,18 @@ public:
 
     bool empty() const { return fStages == nullptr; }
 
+    // Stage fusion is on by default.  Turning it off is mostly useful for benchmarks and tests.
+    void setFuseStages(bool fuse) { fFuseStages = fuse; }
+
+    // run() and compile() cache the programs they build, keyed by the sequence of stages and
+    // independent of the stages' contexts, so repeated pipelines only need their contexts patched.
+    // These report on and purge the global cache.
+    static int64_t ProgramCacheHits();
+    static int64_t ProgramCacheMisses();
+    static void    PurgeProgramCache();
+
+    // Builds programs through this cache instead of the global one.  Mostly useful for tests.
+    void setProgramCache(SkRasterPipelineProgramCache* cache) { fProgramCache = cache; }
 
 private:
     struct StageList {
@@ -171,13 +195,24 @@ private:
 
     using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
     StartPipelineFn build_pipeline(void**) const;
+    StartPipelineFn build_pipeline_uncached(void**) const;
 
     void unchecked_append(StockStage, void*);
+    bool try_fuse(StockStage, void*);
+    void unfuse_store();
+    void add_to_topology(const StageList&);
+
+    friend class SkRasterPipelineProgramCache;
 
     SkArenaAlloc* fAlloc;
     StageList*    fStages;
     int           fNumStages;
     int           fSlotsNeeded;
+    uint32_t      fTopologyHash;  // Hash of the stages in order, ignoring their contexts.
+    uint32_t      fTopologyHashBeforeLast;
+    StageList*    fFusedStore;  // The last stage, if it is a store fused with a swap_rb before it.
+    bool          fFuseStages = true;
+    SkRasterPipelineProgramCache* fProgramCache = nullptr;
 };
 
 template <size_t bytes>
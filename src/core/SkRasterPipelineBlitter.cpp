@@ -56,6 +56,13 @@ private:
     // If we have an burst context, use it to fill our shader buffer.
     void burst_shade(int x, int y, int w);
 
+    // Blits one run of blitAntiH() with constant coverage.
+    void blit_anti_run(int x, int y, int w, SkAlpha);
+
+    // Opaque runs at least this long are blit with blitH() rather than merged into a
+    // span of coverage by blitAntiH().
+    static constexpr int kMinOpaqueRunToBlitH = 16;
+
     SkPixmap               fDst;
     SkBlendMode            fBlend;
     SkArenaAlloc*          fAlloc;
@@ -82,6 +89,7 @@ private:
     float fDitherRate      = 0.0f;
 
     std::vector<SkPMColor4f> fShaderBuffer;
+    std::vector<SkAlpha>     fAntiHCoverage;    // Gathered runs for blitAntiH().
 
     typedef SkBlitter INHERITED;
 };
@@ -323,7 +331,10 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
     }
 }
 
-void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
+void SkRasterPipelineBlitter::blit_anti_run(int x, int y, int w, SkAlpha alpha) {
+    if (alpha == 0xff) {
+        return this->blitH(x,y,w);
+    }
     if (!fBlitAntiH) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
@@ -342,21 +353,57 @@ void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const
         fBlitAntiH = p.compile();
     }
 
+    fCurrentCoverage = alpha * (1/255.0f);
+    if (fBurstCtx) {
+        this->burst_shade(x,y,w);
+    }
+    fBlitAntiH(x,y,w,1);
+}
+
+void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
+    // Antialiased edges come in as lots of short runs.  Rather than run the shader and blend
+    // once per run, we gather touching runs into one span with a row of coverage, and blit
+    // that like an A8 mask.  Gaps and long opaque runs end a span.
+    int spanX    = x,
+        spanW    = 0,
+        spanRuns = 0;
+    auto flush = [&] {
+        if (spanRuns == 1) {
+            this->blit_anti_run(spanX,y,spanW, fAntiHCoverage[0]);
+        } else if (spanRuns > 1) {
+            SkMask mask;
+            mask.fImage    = fAntiHCoverage.data();
+            mask.fBounds   = {spanX,y, spanX+spanW,y+1};
+            mask.fRowBytes = spanW;
+            mask.fFormat   = SkMask::kA8_Format;
+            this->blitMask(mask, mask.fBounds);
+        }
+        spanW = spanRuns = 0;
+    };
+
     for (int16_t run = *runs; run > 0; run = *runs) {
-        switch (*aa) {
-            case 0x00:                       break;
-            case 0xff: this->blitH(x,y,run); break;
-            default:
-                fCurrentCoverage = *aa * (1/255.0f);
-                if (fBurstCtx) {
-                    this->burst_shade(x,y,run);
-                }
-                fBlitAntiH(x,y,run,1);
+        const SkAlpha alpha = *aa;
+        if (alpha == 0x00) {
+            flush();
+        } else if (alpha == 0xff && (run >= kMinOpaqueRunToBlitH || fCanMemsetInBlitRect)) {
+            flush();
+            this->blitH(x,y,run);
+        } else {
+            if (spanRuns == 0) {
+                spanX = x;
+            }
+            if (SkToInt(fAntiHCoverage.size()) < spanW + run) {
+                fAntiHCoverage.resize(spanW + run);
+            }
+            memset(fAntiHCoverage.data() + spanW, alpha, run);
+            spanW += run;
+            spanRuns++;
         }
         x    += run;
         runs += run;
         aa   += run;
     }
+    flush();
 }
 
 void SkRasterPipelineBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRasterPipelineProgramCache.h"
+#include "SkMutex.h"
+
+SkRasterPipelineProgramCache::SkRasterPipelineProgramCache(int maxPrograms) {
+    for (auto& shard : fShards) {
+        shard.reset(new Shard(SkTMax(1, maxPrograms / kShards)));
+    }
+}
+
+SkRasterPipelineProgramCache* SkRasterPipelineProgramCache::Global() {
+    static auto* cache = new SkRasterPipelineProgramCache;
+    return cache;
+}
+
+SkRasterPipelineProgramCache::StartPipelineFn
+SkRasterPipelineProgramCache::find(const SkRasterPipeline& p, void** program) {
+    const Key key = {p.fTopologyHash, p.fNumStages};
+    Shard& shard = this->shardFor(key);
+    SkAutoExclusive lock(shard.fLock);
+    if (const Program* cached = shard.fCache.find(key)) {
+        if (Patch(p, *cached, program)) {
+            shard.fHits++;
+            return cached->start;
+        }
+    }
+    shard.fMisses++;
+    return nullptr;
+}
+
+void SkRasterPipelineProgramCache::add(const SkRasterPipeline& p, void* const* program,
+                                       StartPipelineFn start) {
+    Program built;
+    built.start = start;
+    built.slots.assign(program, program + p.fSlotsNeeded);
+
+    // Walk the stages back to front, just as build_pipeline_uncached() laid them out.
+    int ip = p.fSlotsNeeded - 1;  // just_return
+    for (const SkRasterPipeline::StageList* st = p.fStages; st; st = st->prev) {
+        if (st->ctx) {
+            built.slots[--ip] = nullptr;
+        }
+        --ip;
+        built.stages.push_back({st->stage, st->ctx != nullptr, st->rawFunction});
+    }
+    SkASSERT(ip == 0);
+
+    const Key key = {p.fTopologyHash, p.fNumStages};
+    Shard& shard = this->shardFor(key);
+    SkAutoExclusive lock(shard.fLock);
+    if (Program* existing = shard.fCache.find(key)) {
+        *existing = std::move(built);  // Either a race to add the same program, or a collision.
+    } else {
+        shard.fCache.insert(key, std::move(built));
+    }
+}
+
+int64_t SkRasterPipelineProgramCache::hits() {
+    int64_t hits = 0;
+    for (auto& shard : fShards) {
+        SkAutoExclusive lock(shard->fLock);
+        hits += shard->fHits;
+    }
+    return hits;
+}
+
+int64_t SkRasterPipelineProgramCache::misses() {
+    int64_t misses = 0;
+    for (auto& shard : fShards) {
+        SkAutoExclusive lock(shard->fLock);
+        misses += shard->fMisses;
+    }
+    return misses;
+}
+
+void SkRasterPipelineProgramCache::purge() {
+    for (auto& shard : fShards) {
+        SkAutoExclusive lock(shard->fLock);
+        shard->fCache.reset();
+        shard->fHits = shard->fMisses = 0;
+    }
+}
+
+bool SkRasterPipelineProgramCache::Patch(const SkRasterPipeline& p, const Program& cached,
+                                         void** program) {
+    SkASSERT((int)cached.stages.size() == p.fNumStages);
+    if ((int)cached.slots.size() != p.fSlotsNeeded) {
+        return false;
+    }
+    memcpy(program, cached.slots.data(), p.fSlotsNeeded * sizeof(void*));
+
+    int ip = p.fSlotsNeeded - 1;
+    const Stage* stage = cached.stages.data();
+    for (const SkRasterPipeline::StageList* st = p.fStages; st; st = st->prev, stage++) {
+        if (stage->stage       != st->stage              ||
+            stage->hasCtx      != (st->ctx != nullptr)   ||
+            stage->rawFunction != st->rawFunction) {
+            return false;
+        }
+        if (st->ctx) {
+            program[--ip] = st->ctx;
+        }
+        --ip;
+    }
+    return true;
+}
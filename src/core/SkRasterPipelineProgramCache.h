@@ -0,0 +1,80 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRasterPipelineProgramCache_DEFINED
+#define SkRasterPipelineProgramCache_DEFINED
+
+#include "SkLRUCache.h"
+#include "SkRasterPipeline.h"
+#include "SkSpinlock.h"
+#include <vector>
+
+/**
+ * Caches the programs built by SkRasterPipeline, keyed by the pipeline's topology.  A cached
+ * program keeps its stage functions but has its contexts cleared; a hit copies the program and
+ * patches in the new pipeline's contexts while checking its stages match.
+ *
+ * The cache is split into shards by topology, each with its own lock and LRU list, so that
+ * threads running different pipelines don't wait on each other.
+ */
+class SkRasterPipelineProgramCache : SkNoncopyable {
+public:
+    using StartPipelineFn = SkRasterPipeline::StartPipelineFn;
+
+    explicit SkRasterPipelineProgramCache(int maxPrograms = kDefaultMaxPrograms);
+
+    // The cache shared by every pipeline that doesn't have one of its own.
+    static SkRasterPipelineProgramCache* Global();
+
+    // On a hit, fills program (the pipeline's fSlotsNeeded long) and returns its start function.
+    StartPipelineFn find(const SkRasterPipeline&, void** program);
+
+    void add(const SkRasterPipeline&, void* const* program, StartPipelineFn);
+
+    int64_t hits();
+    int64_t misses();
+    void purge();
+
+private:
+    static constexpr int kDefaultMaxPrograms = 128;
+    static constexpr int kShards = 8;
+
+    struct Key {
+        uint32_t topologyHash;
+        int      numStages;
+
+        bool operator==(const Key& that) const {
+            return topologyHash == that.topologyHash && numStages == that.numStages;
+        }
+    };
+    struct Stage {
+        uint64_t stage;
+        bool     hasCtx;
+        bool     rawFunction;
+    };
+    struct Program {
+        StartPipelineFn    start;
+        std::vector<Stage> stages;  // In fStages order, i.e. last stage first.
+        std::vector<void*> slots;   // The program with every context nulled out.
+    };
+    struct Shard {
+        explicit Shard(int maxPrograms) : fCache(maxPrograms) {}
+
+        SkSpinlock               fLock;
+        SkLRUCache<Key, Program> fCache;
+        int64_t                  fHits   = 0;
+        int64_t                  fMisses = 0;
+    };
+
+    static bool Patch(const SkRasterPipeline&, const Program&, void** program);
+
+    Shard& shardFor(const Key& key) { return *fShards[key.topologyHash % kShards]; }
+
+    std::unique_ptr<Shard> fShards[kShards];
+};
+
+#endif
@@ -268,6 +268,11 @@ sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
         return nullptr;
     }
 
+    if (fMemoryOwner) {
+        (void)this->readUInt();     // the count we just peeked
+        return this->readPad32AsData(numBytes);
+    }
+
     SkAutoMalloc buffer(numBytes);
     if (!this->readByteArray(buffer.get(), numBytes)) {
         return nullptr;
@@ -276,6 +281,24 @@ sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
     return SkData::MakeFromMalloc(buffer.release(), numBytes);
 }
 
+sk_sp<SkData> SkReadBuffer::readPad32AsData(size_t size) {
+    if (fMemoryOwner) {
+        const char* src = static_cast<const char*>(this->skip(size));
+        if (!src) {
+            return nullptr;
+        }
+        const char* base = static_cast<const char*>(fMemoryOwner->data());
+        SkASSERT(base <= src && src + size <= base + fMemoryOwner->size());
+        return SkData::MakeSubset(fMemoryOwner, src - base, size);
+    }
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    if (!this->readPad32(data->writable_data(), size)) {
+        return nullptr;
+    }
+    return data;
+}
+
 uint32_t SkReadBuffer::getArrayCount() {
     const size_t inc = sizeof(uint32_t);
     fError = fError || !IsPtrAlign4(fReader.peek()) || !fReader.isAvailable(inc);
@@ -295,6 +318,15 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
     }
 
     SkIRect bounds;
+    sk_sp<SkData> data;
+    if (!this->readEncodedImage(&bounds, &data)) {
+        return nullptr;
+    }
+    return this->makeImage(bounds, std::move(data));
+}
+
+bool SkReadBuffer::readEncodedImage(SkIRect* boundsPtr, sk_sp<SkData>* dataPtr) {
+    SkIRect& bounds = *boundsPtr;
     if (this->isVersionLT(kStoreImageBounds_Version)) {
         bounds.fLeft = bounds.fTop = 0;
         bounds.fRight = this->read32();
@@ -306,18 +338,20 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
     const int height = bounds.height();
     if (width <= 0 || height <= 0) {    // SkImage never has a zero dimension
         this->validate(false);
-        return nullptr;
+        return false;
     }
 
     int32_t size = this->read32();
     if (size == SK_NaN32) {
         // 0x80000000 is never valid, since it cannot be passed to abs().
         this->validate(false);
-        return nullptr;
+        return false;
     }
     if (size == 0) {
-        // The image could not be encoded at serialization time - return an empty placeholder.
-        return MakeEmptyImage(width, height);
+        // The image could not be encoded at serialization time - makeImage() will return an
+        // empty placeholder.
+        dataPtr->reset();
+        return true;
     }
 
     // we used to negate the size for "custom" encoded images -- ignore that signal (Dec-2017)
@@ -325,25 +359,35 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
     if (size == 1) {
         // legacy check (we stopped writing this for "raw" images Nov-2017)
         this->validate(false);
-        return nullptr;
+        return false;
     }
 
     // Preflight check to make sure there's enough stuff in the buffer before
     // we allocate the memory. This helps the fuzzer avoid OOM when it creates
     // bad/corrupt input.
     if (!this->validateCanReadN<uint8_t>(size)) {
-        return nullptr;
+        return false;
     }
 
-    sk_sp<SkData> data = SkData::MakeUninitialized(size);
-    if (!this->readPad32(data->writable_data(), size)) {
+    sk_sp<SkData> data = this->readPad32AsData(size);
+    if (!data) {
         this->validate(false);
-        return nullptr;
+        return false;
     }
     if (this->isVersionLT(kDontNegateImageSize_Version)) {
         (void)this->read32();   // originX
         (void)this->read32();   // originY
     }
+    *dataPtr = std::move(data);
+    return true;
+}
+
+sk_sp<SkImage> SkReadBuffer::makeImage(const SkIRect& bounds, sk_sp<SkData> data) const {
+    const int width = bounds.width();
+    const int height = bounds.height();
+    if (!data) {
+        return MakeEmptyImage(width, height);
+    }
 
     sk_sp<SkImage> image;
     if (fProcs.fImageProc) {
@@ -410,13 +454,20 @@ SkFlattenable* SkReadBuffer::readFlattenable(SkFlattenable::Type ft) {
         }
         factory = fFactoryArray[index];
     } else {
-        SkString name;
         if (this->peekByte()) {
             // If the first byte is non-zero, the flattenable is specified by a string.
+            SkString name;
             this->readString(&name);
 
-            // Add the string to the dictionary.
-            fFlattenableDict.set(fFlattenableDict.count() + 1, name);
+            // Check if a custom Factory has been specified for this flattenable.
+            if (!(factory = this->getCustomFactory(name))) {
+                // If there is no custom Factory, check for a default.
+                factory = SkFlattenable::NameToFactory(name.c_str());
+            }
+
+            // Add the factory to the dictionary, so that later references to this name by index
+            // don't have to look it up again.
+            fFlattenableDict.push_back(factory);
         } else {
             // Read the index.  We are guaranteed that the first byte
             // is zeroed, so we must shift down a byte.
@@ -424,19 +475,14 @@ SkFlattenable* SkReadBuffer::readFlattenable(SkFlattenable::Type ft) {
             if (index == 0) {
                 return nullptr; // writer failed to give us the flattenable
             }
-            SkString* namePtr = fFlattenableDict.find(index);
-            if (!this->validate(namePtr != nullptr)) {
+            if (!this->validate(index <= SkToU32(fFlattenableDict.count()))) {
                 return nullptr;
             }
-            name = *namePtr;
+            factory = fFlattenableDict[index - 1];
         }
 
-        // Check if a custom Factory has been specified for this flattenable.
-        if (!(factory = this->getCustomFactory(name))) {
-            // If there is no custom Factory, check for a default.
-            if (!(factory = SkFlattenable::NameToFactory(name.c_str()))) {
-                return nullptr; // writer failed to give us the flattenable
-            }
+        if (!factory) {
+            return nullptr; // writer failed to give us the flattenable
         }
     }
 
@@ -20,6 +20,7 @@
 #include "SkReader32.h"
 #include "SkRefCnt.h"
 #include "SkShaderBase.h"
+#include "SkTDArray.h"
 #include "SkTHash.h"
 #include "SkWriteBuffer.h"
 
@@ -81,6 +82,7 @@ public:
         kStoreImageBounds_Version          = 63,
         kRemoveOccluderFromBlurMaskFilter  = 64,
         kFloat4PaintColor_Version          = 65,
+        kAlignedStreamBlocks_Version       = 66,
     };
 
     /**
@@ -180,6 +182,13 @@ public:
     // be created (e.g. it was not originally encoded) then this returns an image that doesn't
     // draw.
     sk_sp<SkImage> readImage();
+
+    // readImage() in two steps, so the second can run on another thread: reading the image's
+    // bounds and encoded data (null if it couldn't be encoded), then making the image.
+    bool readEncodedImage(SkIRect* bounds, sk_sp<SkData>* data);
+    sk_sp<SkImage> makeImage(const SkIRect& bounds, sk_sp<SkData> data) const;
+
+    const SkDeserialProcs& getDeserialProcs() const { return fProcs; }
     sk_sp<SkTypeface> readTypeface();
 
     void setTypefaceArray(sk_sp<SkTypeface> array[], int count) {
@@ -241,6 +250,12 @@ public:
     SkInflator* getInflator() const { return fInflator; }
     void setInflator(SkInflator* inf) { fInflator = inf; }
 
+    /**
+     *  If the memory being read belongs to owner, byte arrays and encoded images are returned
+     *  as subsets of owner rather than copied out.  The caller keeps owner alive while reading.
+     */
+    void setMemoryOwner(const SkData* owner) { fMemoryOwner = owner; }
+
     // Utilities that mark the buffer invalid if the requested value is out-of-range
 
     // If the read value is outside of the range, validate(false) is called, and min
@@ -272,8 +287,10 @@ protected:
 
     SkReader32 fReader;
 
-    // Only used if we do not have an fFactoryArray.
-    SkTHashMap<uint32_t, SkString> fFlattenableDict;
+    // Only used if we do not have an fFactoryArray. Holds the factory that each name written as a
+    // string resolved to, in the order the names were read; names written as an index (base-1)
+    // refer to it. Custom factories are resolved when a name is first read.
+    SkTDArray<SkFlattenable::Factory> fFlattenableDict;
 
 private:
     void setInvalid();
@@ -304,6 +321,11 @@ private:
 
     SkInflator* fInflator = nullptr;
 
+    const SkData* fMemoryOwner = nullptr;
+
+    // Reads size bytes (padded to 4) as an SkData, sharing fMemoryOwner's if set.
+    sk_sp<SkData> readPad32AsData(size_t size);
+
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
     }
@@ -7,6 +7,7 @@
 
 #include "SkRecord.h"
 #include "SkImage.h"
+#include "SkMemoryAccounting.h"
 #include <algorithm>
 
 SkRecord::~SkRecord() {
@@ -14,12 +15,15 @@ SkRecord::~SkRecord() {
     for (int i = 0; i < this->count(); i++) {
         this->mutate(i, destroyer);
     }
+    SkMemoryAccounting::Remove(SkMemoryTag::kRecord, fReserved * sizeof(Record));
 }
 
 void SkRecord::grow() {
     SkASSERT(fCount == fReserved);
+    SkMemoryAccounting::Remove(SkMemoryTag::kRecord, fReserved * sizeof(Record));
     fReserved = fReserved ? fReserved * 2 : 4;
     fRecords.realloc(fReserved);
+    SkMemoryAccounting::Add(SkMemoryTag::kRecord, fReserved * sizeof(Record));
 }
 
 size_t SkRecord::bytesUsed() const {
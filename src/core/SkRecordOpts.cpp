@@ -8,9 +8,14 @@
 #include "SkRecordOpts.h"
 
 #include "SkCanvasPriv.h"
+#include "SkColorFilter.h"
+#include "SkRecordDraw.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkRectPriv.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
+#include "SkTemplates.h"
 
 using namespace SkRecords;
 
@@ -289,6 +294,270 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Does this paint, used to fill a rect, leave every pixel inside it exactly opaque?
+static bool fills_opaque(const SkPaint& paint) {
+    if (paint.getStyle() != SkPaint::kFill_Style ||
+        paint.getPathEffect() || paint.getMaskFilter() || paint.getImageFilter() ||
+        paint.getLooper()) {
+        return false;
+    }
+    if (paint.getBlendMode() != SkBlendMode::kSrcOver && paint.getBlendMode() != SkBlendMode::kSrc) {
+        return false;
+    }
+    if (paint.getAlpha() != 0xFF || (paint.getShader() && !paint.getShader()->isOpaque())) {
+        return false;
+    }
+    const SkColorFilter* cf = paint.getColorFilter();
+    return !cf || (cf->getFlags() & SkColorFilter::kAlphaUnchanged_Flag);
+}
+
+// Walks the record forward, noting for each op whether it may be dropped, which device pixels
+// it's sure to cover with opaque color, and for top-level SaveLayers where their Restore is.
+// Only ops outside any SaveLayer can occlude or be occluded; a whole top-level SaveLayer block
+// may be dropped at once from its Restore.
+class OcclusionFinder {
+public:
+    struct Op {
+        SkIRect fOpaque;        // Pixels this op covers with opaque color; usually empty.
+        int     fLayerStart;    // For the Restore of a top-level SaveLayer, its index; else -1.
+        bool    fRemovable;     // A plain draw, with no side effects other than its pixels.
+        bool    fInLayer;       // Inside a SaveLayer block (including the SaveLayer itself).
+    };
+
+    explicit OcclusionFinder(int count) : fOps(count) {}
+
+    const Op& op(int i) const { return fOps[i]; }
+
+    void setCurrentOp(int i) {
+        fCurrent = &fOps[i];
+        fCurrentIndex = i;
+        fCurrent->fOpaque.setEmpty();
+        fCurrent->fLayerStart = -1;
+        fCurrent->fRemovable = false;
+        fCurrent->fInLayer = fLayerDepth > 0;
+    }
+
+    template <typename T> void operator()(const T&) {
+        fCurrent->fRemovable = SkToBool(T::kTags & kDraw_Tag);
+    }
+    // These may have effects beyond their pixels: links, side effects, annotations of their own.
+    void operator()(const DrawDrawable&)   {}
+    void operator()(const DrawPicture&)    {}
+    void operator()(const DrawAnnotation&) {}
+
+    void operator()(const Save&) { fSaves.push_back({fClip, -1}); }
+    void operator()(const SaveLayer& op) {
+        // A backdrop draws even if nothing is drawn into the layer, which FillBounds won't see.
+        fSaves.push_back({fClip, op.backdrop ? kUnremovableLayer : fCurrentIndex});
+        fLayerDepth++;
+        fCurrent->fInLayer = true;
+    }
+    void operator()(const Restore& op) {
+        fCTM = op.matrix;
+        if (fSaves.isEmpty()) {
+            return;
+        }
+        SaveState saved = fSaves.top();
+        fSaves.pop();
+        fClip = saved.fClip;
+        if (saved.fLayerStart != kNotALayer) {
+            fCurrent->fInLayer = true;
+            if (--fLayerDepth == 0) {
+                fCurrent->fLayerStart = saved.fLayerStart;
+            }
+        }
+    }
+
+    void operator()(const SetMatrix& op) { fCTM = op.matrix; }
+    void operator()(const Concat& op)    { fCTM.preConcat(op.matrix); }
+    void operator()(const Translate& op) { fCTM.preTranslate(op.dx, op.dy); }
+
+    // We only track the largest pixel-aligned rect we're sure is inside the clip.
+    void operator()(const ClipRect& op) {
+        if (op.opAA.op() == SkClipOp::kIntersect && fCTM.rectStaysRect()) {
+            if (!fClip.intersect(this->devicePixelsInside(op.rect))) {
+                fClip.setEmpty();
+            }
+        } else {
+            fClip.setEmpty();
+        }
+    }
+    void operator()(const ClipRRect&)  { fClip.setEmpty(); }
+    void operator()(const ClipPath&)   { fClip.setEmpty(); }
+    void operator()(const ClipRegion&) { fClip.setEmpty(); }
+
+    void operator()(const DrawRect& op) {
+        fCurrent->fRemovable = true;
+        if (fLayerDepth == 0 && fCTM.rectStaysRect() && fills_opaque(op.paint)) {
+            SkIRect opaque = this->devicePixelsInside(op.rect);
+            if (opaque.intersect(fClip)) {
+                fCurrent->fOpaque = opaque;
+            }
+        }
+    }
+    void operator()(const DrawPaint& op) {
+        fCurrent->fRemovable = true;
+        if (fLayerDepth == 0 && fills_opaque(op.paint)) {
+            fCurrent->fOpaque = fClip;
+        }
+    }
+
+private:
+    enum { kNotALayer = -1, kUnremovableLayer = -2 };
+
+    struct SaveState {
+        SkIRect fClip;
+        int     fLayerStart;    // Index of the SaveLayer, kUnremovableLayer, or kNotALayer.
+    };
+
+    // Rounding in keeps us inside the rect whether or not it's antialiased.
+    SkIRect devicePixelsInside(const SkRect& rect) const {
+        SkRect device = fCTM.mapRect(rect.makeSorted());
+        SkIRect inside;
+        device.roundIn(&inside);
+        return inside;
+    }
+
+    SkAutoTMalloc<Op>    fOps;
+    Op*                  fCurrent = nullptr;
+    int                  fCurrentIndex = 0;
+    int                  fLayerDepth = 0;
+    SkMatrix             fCTM = SkMatrix::I();
+    SkIRect              fClip = SkRectPriv::MakeILarge();
+    SkTDArray<SaveState> fSaves;
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record, const SkRect& cullRect) {
+    const int count = record->count();
+    if (count == 0) {
+        return;
+    }
+
+    SkAutoTMalloc<SkRect> bounds(count);
+    SkRecordFillBounds(cullRect, *record, bounds.get());
+
+    OcclusionFinder finder(count);
+    for (int i = 0; i < count; i++) {
+        finder.setCurrentOp(i);
+        record->visit(i, finder);
+    }
+
+    // Walk backwards, remembering the largest few opaque rects drawn later than the current op.
+    // We don't bother with their union; an op must fit entirely inside one of them.
+    constexpr int kMaxOccluders = 8;
+    SkIRect occluders[kMaxOccluders];
+    int occluderCount = 0;
+    auto occluded = [&](const SkRect& r) {
+        for (int j = 0; j < occluderCount; j++) {
+            if (SkRect::Make(occluders[j]).contains(r)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto addOccluder = [&](const SkIRect& r) {
+        int smallest = 0;
+        for (int j = 0; j < occluderCount; j++) {
+            if (occluders[j].contains(r)) {
+                return;
+            }
+            if ((int64_t)occluders[j].width()        * occluders[j].height() <
+                (int64_t)occluders[smallest].width() * occluders[smallest].height()) {
+                smallest = j;
+            }
+        }
+        if (occluderCount < kMaxOccluders) {
+            occluders[occluderCount++] = r;
+        } else if ((int64_t)r.width() * r.height() >
+                   (int64_t)occluders[smallest].width() * occluders[smallest].height()) {
+            occluders[smallest] = r;
+        }
+    };
+
+    for (int i = count - 1; i >= 0; i--) {
+        const OcclusionFinder::Op& op = finder.op(i);
+        if (op.fLayerStart >= 0) {
+            // The Restore's bounds are those of the whole layer block.
+            if (occluded(bounds[i])) {
+                for (int j = op.fLayerStart; j <= i; j++) {
+                    record->replace<NoOp>(j);
+                }
+            }
+            i = op.fLayerStart;
+            continue;
+        }
+        if (op.fInLayer) {
+            continue;
+        }
+        if (op.fRemovable && occluded(bounds[i])) {
+            record->replace<NoOp>(i);
+            continue;
+        }
+        if (!op.fOpaque.isEmpty()) {
+            addOccluder(op.fOpaque);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+enum class OpKind { kDraw, kState, kClip, kSave, kSaveLayer, kRestore };
+
+struct ClassifyOp {
+    template <typename T> OpKind operator()(const T&) { return OpKind::kDraw; }
+    OpKind operator()(const NoOp&)       { return OpKind::kState; }
+    OpKind operator()(const SetMatrix&)  { return OpKind::kState; }
+    OpKind operator()(const Concat&)     { return OpKind::kState; }
+    OpKind operator()(const Translate&)  { return OpKind::kState; }
+    OpKind operator()(const ClipRect&)   { return OpKind::kClip; }
+    OpKind operator()(const ClipRRect&)  { return OpKind::kClip; }
+    OpKind operator()(const ClipPath&)   { return OpKind::kClip; }
+    OpKind operator()(const ClipRegion&) { return OpKind::kClip; }
+    OpKind operator()(const Save&)       { return OpKind::kSave; }
+    OpKind operator()(const SaveLayer&)  { return OpKind::kSaveLayer; }
+    OpKind operator()(const Restore&)    { return OpKind::kRestore; }
+};
+}  // namespace
+
+void SkRecordNoopUnusedClips(SkRecord* record) {
+    // Walking backwards, drawsFollow.top() says whether anything draws between the current op
+    // and the end of its Save block (or of the record).
+    SkTDArray<bool> drawsFollow;
+    drawsFollow.push_back(false);
+
+    ClassifyOp classify;
+    for (int i = record->count() - 1; i >= 0; i--) {
+        switch (record->visit(i, classify)) {
+            case OpKind::kDraw:
+                drawsFollow.top() = true;
+                break;
+            case OpKind::kState:
+                break;
+            case OpKind::kClip:
+                if (!drawsFollow.top()) {
+                    record->replace<NoOp>(i);
+                }
+                break;
+            case OpKind::kRestore:
+                drawsFollow.push_back(false);
+                break;
+            case OpKind::kSave:
+            case OpKind::kSaveLayer: {
+                bool inner = drawsFollow.top();
+                if (drawsFollow.count() > 1) {
+                    drawsFollow.pop();
+                }
+                // A SaveLayer draws when it's restored, even if nothing was drawn inside it.
+                drawsFollow.top() |= inner || OpKind::kSaveLayer == record->visit(i, classify);
+                break;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -312,6 +581,8 @@ void SkRecordOptimize(SkRecord* record) {
 
 void SkRecordOptimize2(SkRecord* record) {
     multiple_set_matrices(record);
+    SkRecordNoopOccludedDraws(record, SkRect::Make(SkRectPriv::MakeILarge()));
+    SkRecordNoopUnusedClips(record);
     SkRecordNoopSaveRestores(record);
     // See why we turn this off in SkRecordOptimize above.
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -26,6 +26,15 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// No-ops draws that are completely covered by later opaque rects and paints, along with
+// whole SaveLayer blocks that are.  cullRect bounds everything the record draws.
+// Ops are only compared in device space, so this is exact when the record is played back with
+// an integer translate; under other matrices the occluders' antialiased edges may differ.
+void SkRecordNoopOccludedDraws(SkRecord*, const SkRect& cullRect);
+
+// No-ops clips that aren't followed by any draws before the end of their Save block.
+void SkRecordNoopUnusedClips(SkRecord*);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
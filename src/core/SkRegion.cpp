@@ -11,6 +11,8 @@
 #include "SkMacros.h"
 #include "SkRegionPriv.h"
 #include "SkSafeMath.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkUTF.h"
@@ -653,16 +655,96 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Builds the union in a single sweep down the rects' edges rather than with one op() per rect,
+// which has to rewrite the whole region each time.
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
+    // Skip the rects setRect() would treat as empty, and sort the rest by top.
+    SkTDArray<SkIRect> sorted;
+    SkTDArray<RunType> ys;
+    sorted.setReserve(count);
+    ys.setReserve(2 * count);
+    for (int i = 0; i < count; ++i) {
+        const SkIRect& r = rects[i];
+        if (r.isEmpty() ||
+            SkRegion_kRunTypeSentinel == r.right() ||
+            SkRegion_kRunTypeSentinel == r.bottom()) {
+            continue;
+        }
+        *sorted.append() = r;
+        *ys.append() = r.fTop;
+        *ys.append() = r.fBottom;
+    }
+    if (sorted.count() <= 1) {
+        return sorted.isEmpty() ? this->setEmpty() : this->setRect(sorted[0]);
+    }
+    SkTQSort(sorted.begin(), sorted.end() - 1, [](const SkIRect& a, const SkIRect& b) {
+        return a.fTop < b.fTop;
+    });
+    SkTQSort(ys.begin(), ys.end() - 1);
+
+    // The rects crossing the current band, sorted by left.
+    SkTDArray<SkIRect> active;
+    int nextRect = 0;
+
+    // Same bookkeeping as RgnOper: adjacent bands with the same spans are merged, and empty
+    // bands are only kept between non-empty ones.
+    RunArray runs;
+    RunType top = ys[0];
+    int prevDst = 1;
+    int prevLen = 0;
+    for (int i = 0; i + 1 < ys.count(); ++i) {
+        RunType y = ys[i];
+        RunType bottom = ys[i + 1];
+        if (y == bottom) {
+            continue;
+        }
+        for (int j = active.count() - 1; j >= 0; --j) {
+            if (active[j].fBottom <= y) {
+                active.remove(j);
+            }
+        }
+        for (; nextRect < sorted.count() && sorted[nextRect].fTop <= y; ++nextRect) {
+            int j = active.count();
+            while (j > 0 && active[j - 1].fLeft > sorted[nextRect].fLeft) {
+                --j;
+            }
+            *active.insert(j) = sorted[nextRect];
+        }
+
+        // Leave room for this band's spans and sentinel, then the next band's bottom and
+        // interval count, or the final Y-sentinel.
+        int start = prevDst + prevLen + 2;
+        runs.resizeToAtLeast(start + 2 * active.count() + 3);
+        int stop = start;
+        for (int j = 0; j < active.count(); ++j) {
+            if (stop > start && active[j].fLeft <= runs[stop - 1]) {
+                runs[stop - 1] = SkTMax(runs[stop - 1], active[j].fRight);
+            } else {
+                runs[stop++] = active[j].fLeft;
+                runs[stop++] = active[j].fRight;
+            }
         }
+        runs[stop++] = SkRegion_kRunTypeSentinel;
+        int len = stop - start;
+
+        if (prevLen == len &&
+            (1 == len || !memcmp(&runs[prevDst], &runs[start], (len - 1) * sizeof(RunType)))) {
+            runs[prevDst - 2] = bottom;
+        } else if (len == 1 && prevLen == 0) {
+            top = bottom;
+        } else {
+            runs[start - 2] = bottom;
+            runs[start - 1] = len >> 1;
+            prevDst = start;
+            prevLen = len;
+        }
+    }
+    if (0 == prevLen) {
+        return this->setEmpty();
     }
-    return !this->isEmpty();
+    runs[0] = top;
+    runs[prevDst + prevLen] = SkRegion_kRunTypeSentinel;
+    return this->setRuns(&runs[0], prevDst + prevLen + 1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@
 
 #include "SkRemoteGlyphCache.h"
 
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <new>
@@ -396,6 +397,127 @@ struct WireTypeface {
     bool            isFixed;
 };
 
+// SkStrikeRingBuffer -------------------------------------
+
+// Both ends count bytes written and read since Init(), so their difference is what's unread,
+// and each count modulo the capacity is where that end is in the buffer. Each message starts
+// at a multiple of 8 bytes, with its length. When a message won't fit before the end of the
+// buffer, the server writes kWrapMarker in place of a length and starts it at the beginning.
+struct SkStrikeRingBuffer::Header {
+    uint32_t              fMagic;
+    uint32_t              fPad;
+    uint64_t              fCapacity;
+    std::atomic<uint64_t> fWritten;
+    std::atomic<uint64_t> fRead;
+};
+
+static constexpr uint32_t kRingBufferMagic = SkSetFourByteTag('s', 'k', 'r', 'b');
+static constexpr uint32_t kWrapMarker      = 0xFFFFFFFF;
+static constexpr uint64_t kFrameSize       = 8;  // The length, padded to keep messages aligned.
+
+static uint64_t ring_capacity(size_t memorySize) {
+    return (memorySize - sizeof(SkStrikeRingBuffer::Header)) & ~7ull;
+}
+
+size_t SkStrikeRingBuffer::MemoryNeeded(size_t capacity) {
+    return sizeof(Header) + SkAlign8(capacity);
+}
+
+void SkStrikeRingBuffer::Init(void* memory, size_t memorySize) {
+    SkASSERT(SkIsAlign8((uintptr_t)memory));
+    SkASSERT(memorySize > sizeof(Header));
+    auto* header = new (memory) Header;
+    header->fMagic    = kRingBufferMagic;
+    header->fPad      = 0;
+    header->fCapacity = ring_capacity(memorySize);
+    header->fWritten.store(0);
+    header->fRead.store(0);
+    // Both processes must see the same atomics.
+    SkASSERT(header->fWritten.is_lock_free());
+}
+
+SkStrikeRingBuffer::SkStrikeRingBuffer(void* memory, size_t memorySize) {
+    if (!memory || !SkIsAlign8((uintptr_t)memory) ||
+        memorySize < sizeof(Header) + kFrameSize) {
+        return;
+    }
+    auto* header = static_cast<Header*>(memory);
+    if (header->fMagic != kRingBufferMagic || header->fCapacity != ring_capacity(memorySize)) {
+        return;
+    }
+    fHeader   = header;
+    fData     = static_cast<uint8_t*>(memory) + sizeof(Header);
+    fCapacity = ring_capacity(memorySize);
+}
+
+bool SkStrikeRingBuffer::write(const void* data, size_t size) {
+    const uint64_t needed = kFrameSize + SkAlign8((uint64_t)size);
+    if (!this->isValid() || size >= kWrapMarker || needed > fCapacity) {
+        return false;
+    }
+
+    // Only we write fWritten. The client may be hostile, so an fRead ahead of it means full.
+    uint64_t written = fHeader->fWritten.load(std::memory_order_relaxed),
+             read    = fHeader->fRead.load(std::memory_order_acquire);
+    uint64_t offset  = written % fCapacity;
+    uint64_t skipped = offset + needed > fCapacity ? fCapacity - offset : 0;
+    if (read > written || written - read + skipped + needed > fCapacity) {
+        return false;
+    }
+
+    if (skipped) {
+        memcpy(fData + offset, &kWrapMarker, sizeof(kWrapMarker));
+        written += skipped;
+        offset = 0;
+    }
+    uint32_t length = SkToU32(size);
+    memcpy(fData + offset, &length, sizeof(length));
+    memcpy(fData + offset + kFrameSize, data, size);
+    fHeader->fWritten.store(written + needed, std::memory_order_release);
+    return true;
+}
+
+const volatile void* SkStrikeRingBuffer::peek(size_t* size) {
+    fPeekedSize = 0;
+    if (!this->isValid()) {
+        return nullptr;
+    }
+
+    // Only we write fRead; the server may be hostile, so check everything it wrote.
+    uint64_t read = fHeader->fRead.load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t written = fHeader->fWritten.load(std::memory_order_acquire);
+        if (written < read + kFrameSize || written - read > fCapacity) {
+            return nullptr;
+        }
+
+        uint64_t offset = read % fCapacity;
+        uint32_t length;
+        memcpy(&length, fData + offset, sizeof(length));
+        if (length == kWrapMarker) {
+            read += fCapacity - offset;
+            fHeader->fRead.store(read, std::memory_order_release);
+            continue;
+        }
+
+        const uint64_t needed = kFrameSize + SkAlign8((uint64_t)length);
+        if (offset + needed > fCapacity || written - read < needed) {
+            return nullptr;
+        }
+        fPeekedSize = needed;
+        *size = length;
+        return fData + offset + kFrameSize;
+    }
+}
+
+void SkStrikeRingBuffer::pop() {
+    if (fPeekedSize) {
+        uint64_t read = fHeader->fRead.load(std::memory_order_relaxed);
+        fHeader->fRead.store(read + fPeekedSize, std::memory_order_release);
+        fPeekedSize = 0;
+    }
+}
+
 // SkStrikeServer -----------------------------------------
 
 SkStrikeServer::SkStrikeServer(DiscardableHandleManager* discardableHandleManager)
@@ -437,6 +559,25 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
     fLockedDescs.clear();
 }
 
+bool SkStrikeServer::writeStrikeData(SkStrikeRingBuffer* ring) {
+    // What didn't fit last time goes first, so the client reads strike data in order.
+    if (!fUnsentStrikeData.empty()) {
+        if (!ring->write(fUnsentStrikeData.data(), fUnsentStrikeData.size())) {
+            return false;
+        }
+        fUnsentStrikeData.clear();
+    }
+
+    this->writeStrikeData(&fUnsentStrikeData);
+    if (!fUnsentStrikeData.empty()) {
+        if (!ring->write(fUnsentStrikeData.data(), fUnsentStrikeData.size())) {
+            return false;
+        }
+        fUnsentStrikeData.clear();
+    }
+    return true;
+}
+
 SkStrikeServer::SkGlyphCacheState* SkStrikeServer::getOrCreateCache(
         const SkPaint& paint,
         const SkSurfaceProps& props,
@@ -509,7 +650,7 @@ SkStrikeServer::SkGlyphCacheState* SkStrikeServer::getOrCreateCache(
     // Create a new cache state and insert it into the map.
     auto newHandle = fDiscardableHandleManager->createHandle();
     auto cacheState = skstd::make_unique<SkGlyphCacheState>(
-            *keyDesc, *deviceDesc, std::move(context), newHandle);
+            *keyDesc, *deviceDesc, std::move(context), newHandle, fGlyphPrefetchRange);
 
     auto* cacheStatePtr = cacheState.get();
 
@@ -538,12 +679,14 @@ SkStrikeServer::SkGlyphCacheState::SkGlyphCacheState(
         const SkDescriptor& keyDescriptor,
         const SkDescriptor& deviceDescriptor,
         std::unique_ptr<SkScalerContext> context,
-        uint32_t discardableHandleId)
+        uint32_t discardableHandleId,
+        int glyphPrefetchRange)
         : fKeyDescriptor{keyDescriptor}
         , fDeviceDescriptor{deviceDescriptor}
         , fDiscardableHandleId(discardableHandleId)
         , fIsSubpixel{context->isSubpixel()}
         , fAxisAlignmentForHText{context->computeAxisAlignmentForHText()}
+        , fGlyphPrefetchRange{glyphPrefetchRange}
         // N.B. context must come last because it is used above.
         , fContext{std::move(context)} {
     SkASSERT(fKeyDescriptor.getDesc() != nullptr);
@@ -569,6 +712,20 @@ void SkStrikeServer::SkGlyphCacheState::addGlyph(SkPackedGlyphID glyph, bool asP
     // this glyph.
     cache->add(glyph);
     pending->push_back(glyph);
+
+    // Speculatively send the rest of the glyph's block of IDs too.
+    if (!asPath && fGlyphPrefetchRange > 1) {
+        int first = glyph.code() / fGlyphPrefetchRange * fGlyphPrefetchRange,
+            last  = SkTMin(first + fGlyphPrefetchRange, (int)fContext->getGlyphCount());
+        for (int code = first; code < last; code++) {
+            SkPackedGlyphID neighbor{SkTo<SkGlyphID>(code),
+                                     glyph.getSubXFixed(), glyph.getSubYFixed()};
+            if (!cache->contains(neighbor)) {
+                cache->add(neighbor);
+                pending->push_back(neighbor);
+            }
+        }
+    }
 }
 
 static void writeGlyph(SkGlyph* glyph, Serializer* serializer) {
@@ -837,6 +994,18 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
     return true;
 }
 
+bool SkStrikeClient::readStrikeData(SkStrikeRingBuffer* ring) {
+    size_t size;
+    while (const volatile void* data = ring->peek(&size)) {
+        bool ok = size > 0 && this->readStrikeData(data, size);
+        ring->pop();
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
 sk_sp<SkTypeface> SkStrikeClient::deserializeTypeface(const void* buf, size_t len) {
     WireTypeface wire;
     if (len != sizeof(wire)) return nullptr;
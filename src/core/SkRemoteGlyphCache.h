@@ -83,6 +83,46 @@ private:
 
 using SkDiscardableHandleId = uint32_t;
 
+// A queue of strike data from one SkStrikeServer to one SkStrikeClient, in memory both can see,
+// e.g. a shared memory region mapped into the server's and the client's processes. The client
+// reads each message in place, where the server wrote it, instead of from a copy sent over IPC.
+// Messages are contiguous, so the buffer should be several times larger than the largest one.
+//
+// The memory is owned by the caller and must stay mapped while either end uses it. One thread
+// on each end may use it at a time. The reader treats everything in the buffer as untrusted.
+class SK_API SkStrikeRingBuffer {
+public:
+    // The memory needed for a buffer that can hold capacity bytes of messages.
+    static size_t MemoryNeeded(size_t capacity);
+
+    // Formats the memory as an empty buffer. Call this once, on either end, before either
+    // end attaches to it.
+    static void Init(void* memory, size_t memorySize);
+
+    // Attaches to memory formatted by Init(). If it's not, isValid() is false, and the buffer
+    // is always full and always empty.
+    SkStrikeRingBuffer(void* memory, size_t memorySize);
+
+    bool isValid() const { return fData != nullptr; }
+
+    // Server: copies in a message. Returns false if there isn't room for it until the client
+    // reads more.
+    bool write(const void* data, size_t size);
+
+    // Client: returns the oldest unread message, or nullptr if there are none or the buffer
+    // is malformed. The message stays valid until pop().
+    const volatile void* peek(size_t* size);
+    void pop();
+
+    struct Header;
+
+private:
+    Header*     fHeader     = nullptr;
+    uint8_t*    fData       = nullptr;
+    uint64_t    fCapacity   = 0;
+    uint64_t    fPeekedSize = 0;  // The framed size of the message peek() last returned.
+};
+
 // This class is not thread-safe.
 class SK_API SkStrikeServer {
 public:
@@ -121,6 +161,16 @@ public:
     // unlocked after this call.
     void writeStrikeData(std::vector<uint8_t>* memory);
 
+    // Serializes the strike data into a ring buffer shared with the client. If there isn't
+    // room, returns false and keeps the data, which is written first on the next call.
+    bool writeStrikeData(SkStrikeRingBuffer*);
+
+    // When a glyph's image is sent, also send the images of the rest of its block of this many
+    // glyph IDs, at the same subpixel position, betting that text which needs one glyph of a
+    // font will soon need its neighbors. Zero (the default) sends only the glyphs drawn.
+    // Applies to strikes first used after the call.
+    void setGlyphPrefetchRange(int glyphCount) { fGlyphPrefetchRange = glyphCount; }
+
     // Methods used internally in skia ------------------------------------------
     class SkGlyphCacheState;
 
@@ -149,6 +199,11 @@ private:
     // State cached until the next serialization.
     SkDescriptorSet fLockedDescs;
     std::vector<WireTypeface> fTypefacesToSend;
+
+    // Serialized strike data that didn't fit in the ring buffer last time.
+    std::vector<uint8_t> fUnsentStrikeData;
+
+    int fGlyphPrefetchRange = 0;
 };
 
 class SK_API SkStrikeClient {
@@ -196,6 +251,10 @@ public:
     // Returns false if the data is invalid.
     bool readStrikeData(const volatile void* memory, size_t memorySize);
 
+    // Deserializes all the strike data waiting in a ring buffer shared with the server.
+    // Returns false if any of it is invalid.
+    bool readStrikeData(SkStrikeRingBuffer*);
+
 private:
     class DiscardableStrikePinner;
 
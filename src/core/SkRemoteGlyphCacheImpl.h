@@ -19,7 +19,8 @@ public:
     SkGlyphCacheState(const SkDescriptor& keyDescriptor,
                       const SkDescriptor& deviceDescriptor,
                       std::unique_ptr<SkScalerContext> context,
-                      SkDiscardableHandleId discardableHandleId);
+                      SkDiscardableHandleId discardableHandleId,
+                      int glyphPrefetchRange = 0);
     ~SkGlyphCacheState() override;
 
     void addGlyph(SkPackedGlyphID, bool pathOnly);
@@ -73,6 +74,9 @@ private:
     const bool fIsSubpixel;
     const SkAxisAlignment fAxisAlignmentForHText;
 
+    // See SkStrikeServer::setGlyphPrefetchRange().
+    const int fGlyphPrefetchRange;
+
     // The context built using fDeviceDescriptor
     std::unique_ptr<SkScalerContext> fContext;
 
@@ -11,10 +11,12 @@
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 #include "SkOpts.h"
 #include "SkTo.h"
 #include "SkTraceMemoryDump.h"
 
+#include <atomic>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -191,21 +193,30 @@ void SkResourceCache::remove(Rec* rec) {
     delete rec;
 }
 
-void SkResourceCache::purgeAsNeeded(bool forcePurge) {
-    size_t byteLimit;
-    int    countLimit;
-
-    if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
-        byteLimit = UINT32_MAX;  // no limit based on bytes
+static void get_purge_limits(SkResourceCache::DiscardableFactory factory, size_t totalByteLimit,
+                             size_t* byteLimit, int* countLimit) {
+    if (factory) {
+        *countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        *byteLimit = UINT32_MAX;  // no limit based on bytes
     } else {
-        countLimit = SK_MaxS32; // no limit based on count
-        byteLimit = fTotalByteLimit;
+        *countLimit = SK_MaxS32; // no limit based on count
+        *byteLimit = totalByteLimit;
+    }
+}
+
+void SkResourceCache::purgeAsNeeded(bool forcePurge) {
+    size_t byteLimit = 0;
+    int    countLimit = 0;
+    if (!forcePurge) {
+        get_purge_limits(fDiscardableFactory, fTotalByteLimit, &byteLimit, &countLimit);
     }
+    this->purgeUntilUnder(byteLimit, countLimit);
+}
 
+void SkResourceCache::purgeUntilUnder(size_t byteLimit, int countLimit) {
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        if (fTotalBytesUsed < byteLimit && fCount < countLimit) {
             break;
         }
 
@@ -282,17 +293,20 @@ size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     return prevLimit;
 }
 
-SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
-    this->checkMessages();
-
-    if (fDiscardableFactory) {
-        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+static SkCachedData* new_cached_data(SkResourceCache::DiscardableFactory factory, size_t bytes) {
+    if (factory) {
+        SkDiscardableMemory* dm = factory(bytes);
         return dm ? new SkCachedData(bytes, dm) : nullptr;
     } else {
         return new SkCachedData(sk_malloc_throw(bytes), bytes);
     }
 }
 
+SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
+    this->checkMessages();
+    return new_cached_data(fDiscardableFactory, bytes);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkResourceCache::release(Rec* rec) {
@@ -416,22 +430,29 @@ size_t SkResourceCache::getSingleAllocationByteLimit() const {
     return fSingleAllocationByteLimit;
 }
 
-size_t SkResourceCache::getEffectiveSingleAllocationByteLimit() const {
-    // fSingleAllocationByteLimit == 0 means the caller is asking for our default
-    size_t limit = fSingleAllocationByteLimit;
+static size_t effective_single_allocation_limit(SkResourceCache::DiscardableFactory factory,
+                                                size_t singleAllocationByteLimit,
+                                                size_t totalByteLimit) {
+    // singleAllocationByteLimit == 0 means the caller is asking for our default
+    size_t limit = singleAllocationByteLimit;
 
     // if we're not discardable (i.e. we are fixed-budget) then cap the single-limit
     // to our budget.
-    if (nullptr == fDiscardableFactory) {
+    if (nullptr == factory) {
         if (0 == limit) {
-            limit = fTotalByteLimit;
+            limit = totalByteLimit;
         } else {
-            limit = SkTMin(limit, fTotalByteLimit);
+            limit = SkTMin(limit, totalByteLimit);
         }
     }
     return limit;
 }
 
+size_t SkResourceCache::getEffectiveSingleAllocationByteLimit() const {
+    return effective_single_allocation_limit(fDiscardableFactory, fSingleAllocationByteLimit,
+                                             fTotalByteLimit);
+}
+
 void SkResourceCache::checkMessages() {
     SkTArray<PurgeSharedIDMessage> msgs;
     fPurgeSharedIDInbox.poll(&msgs);
@@ -442,86 +463,237 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = nullptr;
+// The global cache is split by key hash into shards, each an SkResourceCache behind its own mutex,
+// so that threads looking up different keys rarely wait on each other.  The shards never purge by
+// themselves: the budget is shared, and after an add takes the total over it, the adding thread
+// purges least recently used Recs from one shard after another until it's back under.  That's
+// only approximately LRU across the whole cache, and the total can briefly exceed the budget.
+namespace {
+
+static constexpr int kShardCount = 16;
+
+struct Shard {
+    SkMutex          fMutex;
+    SkResourceCache* fCache = nullptr;
+
+    // Copies of fCache's totals, updated under fMutex, which may be read without it.
+    std::atomic<size_t> fBytesUsed{0};
+    std::atomic<int>    fCount{0};
+};
+
+struct GlobalCache {
+    Shard                               fShards[kShardCount];
+    SkResourceCache::DiscardableFactory fDiscardableFactory = nullptr;
+    std::atomic<size_t>                 fTotalByteLimit{0};
+    std::atomic<size_t>                 fSingleAllocationByteLimit{0};
+
+    std::atomic<int64_t>                fHits{0},
+                                        fMisses{0},
+                                        fContendedLocks{0};
+};
+
+class ShardLock : SkNoncopyable {
+public:
+    ShardLock(GlobalCache* global, Shard* shard) : fShard(shard) {
+        if (!shard->fMutex.tryAcquire()) {
+            global->fContendedLocks.fetch_add(1, std::memory_order_relaxed);
+            shard->fMutex.acquire();
+        }
+    }
+
+    ~ShardLock() {
+        fShard->fBytesUsed.store(fShard->fCache->getTotalBytesUsed(), std::memory_order_relaxed);
+        fShard->fCount.store(fShard->fCache->getCount(), std::memory_order_relaxed);
+        fShard->fMutex.release();
+    }
+
+private:
+    Shard* fShard;
+};
+
+}  // namespace
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (nullptr == gResourceCache) {
+static GlobalCache* get_global_cache() {
+    static GlobalCache* gCache;
+    static SkOnce once;
+    once([] {
+        gCache = new GlobalCache;
+        for (Shard& shard : gCache->fShards) {
+#ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
+            shard.fCache = new SkResourceCache(SkDiscardableMemory::Create);
+#else
+            // Only the shared budget purges.
+            shard.fCache = new SkResourceCache(SIZE_MAX);
+#endif
+        }
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+        gCache->fDiscardableFactory = SkDiscardableMemory::Create;
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+        gCache->fTotalByteLimit.store(SK_DEFAULT_IMAGE_CACHE_LIMIT, std::memory_order_relaxed);
 #endif
+    });
+    return gCache;
+}
+
+static int shard_index(const SkResourceCache::Key& key) {
+    return key.hash() % kShardCount;
+}
+
+static size_t total_bytes_used(const GlobalCache* global) {
+    size_t used = 0;
+    for (const Shard& shard : global->fShards) {
+        used += shard.fBytesUsed.load(std::memory_order_relaxed);
+    }
+    return used;
+}
+
+static int total_count(const GlobalCache* global) {
+    int count = 0;
+    for (const Shard& shard : global->fShards) {
+        count += shard.fCount.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+// Purges shards, starting with firstShard, until the cache as a whole is under budget.
+static void purge_as_needed(GlobalCache* global, int firstShard) {
+    size_t byteLimit;
+    int    countLimit;
+    get_purge_limits(global->fDiscardableFactory,
+                     global->fTotalByteLimit.load(std::memory_order_relaxed),
+                     &byteLimit, &countLimit);
+
+    for (int i = 0; i < kShardCount; i++) {
+        const size_t used = total_bytes_used(global);
+        const int count = total_count(global);
+        if (used < byteLimit && count < countLimit) {
+            return;
+        }
+
+        // Ask this shard to make up the whole excess.  Whatever it can't free, the next one will.
+        Shard* shard = &global->fShards[(firstShard + i) % kShardCount];
+        ShardLock lock(global, shard);
+        SkResourceCache* cache = shard->fCache;
+        size_t shardByteLimit = SIZE_MAX;
+        int    shardCountLimit = SK_MaxS32;
+        if (used >= byteLimit) {
+            shardByteLimit = cache->getTotalBytesUsed() -
+                             SkTMin(used - byteLimit, cache->getTotalBytesUsed());
+        }
+        if (count >= countLimit) {
+            shardCountLimit = cache->getCount() - SkTMin(count - countLimit, cache->getCount());
+        }
+        cache->purgeUntilUnder(shardByteLimit, shardCountLimit);
     }
-    return gResourceCache;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    return total_bytes_used(get_global_cache());
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    return get_global_cache()->fTotalByteLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    GlobalCache* global = get_global_cache();
+    size_t prevLimit = global->fTotalByteLimit.exchange(newLimit, std::memory_order_relaxed);
+    if (newLimit < prevLimit) {
+        purge_as_needed(global, 0);
+    }
+    return prevLimit;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    return get_global_cache()->fDiscardableFactory;
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    return new_cached_data(get_global_cache()->fDiscardableFactory, bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    GlobalCache* global = get_global_cache();
+    SkDebugf("SkResourceCache: count=%d bytes=%zu %s, %d shards\n",
+             total_count(global), total_bytes_used(global),
+             global->fDiscardableFactory ? "discardable" : "malloc", kShardCount);
+    SkDebugf("SkResourceCache: hits=%lld misses=%lld contended locks=%lld\n",
+             (long long)global->fHits.load(std::memory_order_relaxed),
+             (long long)global->fMisses.load(std::memory_order_relaxed),
+             (long long)global->fContendedLocks.load(std::memory_order_relaxed));
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    return get_global_cache()->fSingleAllocationByteLimit.exchange(size,
+                                                                   std::memory_order_relaxed);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    return get_global_cache()->fSingleAllocationByteLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    GlobalCache* global = get_global_cache();
+    return effective_single_allocation_limit(
+            global->fDiscardableFactory,
+            global->fSingleAllocationByteLimit.load(std::memory_order_relaxed),
+            global->fTotalByteLimit.load(std::memory_order_relaxed));
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    GlobalCache* global = get_global_cache();
+    for (Shard& shard : global->fShards) {
+        ShardLock lock(global, &shard);
+        shard.fCache->purgeAll();
+    }
+}
+
+size_t SkResourceCache::PurgeBytes(size_t bytesToPurge) {
+    // Each shard gives up its share, in proportion to what it holds.
+    GlobalCache* global = get_global_cache();
+    const size_t used = total_bytes_used(global);
+    if (0 == used || 0 == bytesToPurge) {
+        return 0;
+    }
+    const double fraction = SkTMin(1.0, (double)bytesToPurge / used);
+    for (Shard& shard : global->fShards) {
+        ShardLock lock(global, &shard);
+        SkResourceCache* cache = shard.fCache;
+        const size_t shardUsed = cache->getTotalBytesUsed();
+        // purgeUntilUnder() takes a strict bound.
+        cache->purgeUntilUnder(shardUsed - (size_t)(shardUsed * fraction) + 1, SK_MaxS32);
+    }
+    return used - SkTMin(used, total_bytes_used(global));
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    GlobalCache* global = get_global_cache();
+    Shard* shard = &global->fShards[shard_index(key)];
+    bool found;
+    {
+        ShardLock lock(global, shard);
+        found = shard->fCache->find(key, visitor, context);
+    }
+    (found ? global->fHits : global->fMisses).fetch_add(1, std::memory_order_relaxed);
+    return found;
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec, payload);
+    GlobalCache* global = get_global_cache();
+    const int index = shard_index(rec->getKey());
+    {
+        ShardLock lock(global, &global->fShards[index]);
+        global->fShards[index].fCache->add(rec, payload);
+    }
+    purge_as_needed(global, index);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->visitAll(visitor, context);
+    GlobalCache* global = get_global_cache();
+    for (Shard& shard : global->fShards) {
+        ShardLock lock(global, &shard);
+        shard.fCache->visitAll(visitor, context);
+    }
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -588,6 +760,18 @@ static void sk_trace_dump_visitor(const SkResourceCache::Rec& rec, void* context
 }
 
 void SkResourceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static const char* kDumpName = "skia/sk_resource_cache";
+    GlobalCache* global = get_global_cache();
+    dump->dumpNumericValue(kDumpName, "size", "bytes", total_bytes_used(global));
+    dump->dumpNumericValue(kDumpName, "budget_size", "bytes",
+                           global->fTotalByteLimit.load(std::memory_order_relaxed));
+    dump->dumpNumericValue(kDumpName, "hits", "objects",
+                           global->fHits.load(std::memory_order_relaxed));
+    dump->dumpNumericValue(kDumpName, "misses", "objects",
+                           global->fMisses.load(std::memory_order_relaxed));
+    dump->dumpNumericValue(kDumpName, "contended_locks", "objects",
+                           global->fContendedLocks.load(std::memory_order_relaxed));
+
     // Since resource could be backed by malloc or discardable, the cache always dumps detailed
     // stats to be accurate.
     VisitAll(sk_trace_dump_visitor, dump);
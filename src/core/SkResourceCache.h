@@ -25,6 +25,8 @@ class SkTraceMemoryDump;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  It is split into shards by key, each with its own lock and LRU, sharing
+ *  one budget.
  */
 class SkResourceCache {
 public:
@@ -168,6 +170,8 @@ public:
     static size_t GetEffectiveSingleAllocationByteLimit();
 
     static void PurgeAll();
+    /** Purges about bytesToPurge bytes, least recently used first. Returns the bytes freed. */
+    static size_t PurgeBytes(size_t bytesToPurge);
 
     static void TestDumpMemoryStatistics();
 
@@ -224,6 +228,7 @@ public:
     void visitAll(Visitor, void* context);
 
     size_t getTotalBytesUsed() const { return fTotalBytesUsed; }
+    int getCount() const { return fCount; }
     size_t getTotalByteLimit() const { return fTotalByteLimit; }
 
     /**
@@ -250,6 +255,12 @@ public:
         this->purgeAsNeeded(true);
     }
 
+    /**
+     *  Purge the least recently used Recs that can be purged, until fewer than byteLimit bytes
+     *  are used by fewer than countLimit Recs (or none are left that can be purged).
+     */
+    void purgeUntilUnder(size_t byteLimit, int countLimit);
+
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
 
     SkCachedData* newCachedData(size_t bytes);
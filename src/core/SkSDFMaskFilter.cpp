@@ -5,7 +5,7 @@
  * found in the LICENSE file.
  */
 
-#include "GrSDFMaskFilter.h"
+#include "SkSDFMaskFilter.h"
 #include "SkDistanceFieldGen.h"
 #include "SkMaskFilterBase.h"
 #include "SkReadBuffer.h"
@@ -13,9 +13,9 @@
 #include "SkWriteBuffer.h"
 #include "SkString.h"
 
-class SK_API GrSDFMaskFilterImpl : public SkMaskFilterBase {
+class SK_API SkSDFMaskFilterImpl : public SkMaskFilterBase {
 public:
-    GrSDFMaskFilterImpl();
+    SkSDFMaskFilterImpl();
 
     // overrides from SkMaskFilterBase
     //  This method is not exported to java.
@@ -26,24 +26,24 @@ public:
 
     void computeFastBounds(const SkRect&, SkRect*) const override;
 
-    SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(GrSDFMaskFilterImpl)
+    SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkSDFMaskFilterImpl)
 
 protected:
 
 private:
     typedef SkMaskFilter INHERITED;
-    friend void gr_register_sdf_maskfilter_createproc();
+    friend void sk_register_sdf_maskfilter_createproc();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
-GrSDFMaskFilterImpl::GrSDFMaskFilterImpl() {}
+SkSDFMaskFilterImpl::SkSDFMaskFilterImpl() {}
 
-SkMask::Format GrSDFMaskFilterImpl::getFormat() const {
+SkMask::Format SkSDFMaskFilterImpl::getFormat() const {
     return SkMask::kSDF_Format;
 }
 
-bool GrSDFMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
+bool SkSDFMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
                                      const SkMatrix& matrix, SkIPoint* margin) const {
     if (src.fFormat != SkMask::kA8_Format && src.fFormat != SkMask::kBW_Format) {
         return false;
@@ -76,22 +76,22 @@ bool GrSDFMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
     }
 }
 
-void GrSDFMaskFilterImpl::computeFastBounds(const SkRect& src,
+void SkSDFMaskFilterImpl::computeFastBounds(const SkRect& src,
                                             SkRect* dst) const {
     dst->set(src.fLeft  - SK_DistanceFieldPad, src.fTop    - SK_DistanceFieldPad,
              src.fRight + SK_DistanceFieldPad, src.fBottom + SK_DistanceFieldPad);
 }
 
-sk_sp<SkFlattenable> GrSDFMaskFilterImpl::CreateProc(SkReadBuffer& buffer) {
-    return GrSDFMaskFilter::Make();
+sk_sp<SkFlattenable> SkSDFMaskFilterImpl::CreateProc(SkReadBuffer& buffer) {
+    return SkSDFMaskFilter::Make();
 }
 
-void gr_register_sdf_maskfilter_createproc() {
-    SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(GrSDFMaskFilterImpl)
+void sk_register_sdf_maskfilter_createproc() {
+    SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkSDFMaskFilterImpl)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-sk_sp<SkMaskFilter> GrSDFMaskFilter::Make() {
-    return sk_sp<SkMaskFilter>(new GrSDFMaskFilterImpl());
+sk_sp<SkMaskFilter> SkSDFMaskFilter::Make() {
+    return sk_sp<SkMaskFilter>(new SkSDFMaskFilterImpl());
 }
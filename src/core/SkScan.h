@@ -18,6 +18,7 @@ class SkRasterClip;
 class SkRegion;
 class SkBlitter;
 class SkPath;
+class SkRRect;
 
 /** Defines a fixed-point rectangle, identical to the integer SkIRect, but its
     coordinates are treated as SkFixed rather than int32_t.
@@ -54,6 +55,9 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*, SkDAARecord*);
+    // Fills an axis-aligned device-space rrect with analytic coverage.  Returns false, having
+    // drawn nothing, if it's too large for that and should be filled as a path instead.
+    static bool AntiFillRRect(const SkRRect&, const SkRasterClip&, SkBlitter*);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
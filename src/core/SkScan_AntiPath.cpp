@@ -648,6 +648,12 @@ static bool ShouldUseDAA(const SkPath& path, SkScalar avgLength, SkScalar comple
         return false;
     }
 
+    // Stroke outlines overlap themselves at every join and cap. DAA accumulates all of their
+    // edges into one coverage pass, while AAA and SAA have to sort and walk every crossing.
+    if (SkPathPriv::IsStrokeOutline(path) && !path.isConvex()) {
+        return true;
+    }
+
     #ifdef SK_SUPPORT_LEGACY_AA_CHOICE
         const SkRect& bounds = path.getBounds();
         return !path.isConvex()
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScan.h"
+
+#include "SkBlitter.h"
+#include "SkRRect.h"
+#include "SkRasterClip.h"
+#include "SkTemplates.h"
+#include "SkTo.h"
+
+/*  Fills an axis-aligned rrect by computing each pixel's coverage directly, like GrRRectEffect
+    does on the GPU, instead of building a path and scan converting it.
+
+    Straight edges get their exact area coverage.  Pixels whose centers fall in one of the
+    elliptical corners are covered by 0.5 - d, where d is the signed distance from the pixel
+    center to the ellipse, approximated as f / |grad f| for f(x,y) = x^2/a^2 + y^2/b^2 - 1.
+    Only the few pixels per row near an edge are computed; the rest of each row is one run.
+ */
+
+namespace {
+
+struct Corner {
+    SkScalar fCX, fCY;   // center of the ellipse
+    SkScalar fRX, fRY;   // its radii, or zero for a square corner
+
+    // Coverage of a pixel centered at (x,y) by this corner's ellipse, assuming that
+    // (x,y) is on the corner's side of the ellipse's center.
+    float coverage(float x, float y) const {
+        float dx = (x - fCX) / fRX,
+              dy = (y - fCY) / fRY;
+        float f = dx*dx + dy*dy - 1;
+        float gx = dx / fRX,
+              gy = dy / fRY;
+        float g = 2 * sk_float_sqrt(gx*gx + gy*gy);
+        if (g <= 0) {
+            return 1;
+        }
+        return SkTPin(0.5f - f / g, 0.0f, 1.0f);
+    }
+
+    // The x where this corner's curve crosses the horizontal line at y, which must be between
+    // the ellipse's center and its top or bottom.
+    float edgeX(float y, float side) const {
+        float dy = (y - fCY) / fRY;
+        return fCX + side * fRX * sk_float_sqrt(SkTMax(0.0f, 1 - dy*dy));
+    }
+};
+
+class RRectCoverage {
+public:
+    RRectCoverage(const SkRRect& rr) : fBounds(rr.rect()) {
+        const SkRect& r = fBounds;
+        // Radii too small to show up as a curve are drawn as square corners.
+        auto corner = [](SkScalar cx, SkScalar cy, SkVector rad, SkScalar sx, SkScalar sy) {
+            if (rad.fX < 0.5f || rad.fY < 0.5f) {
+                return Corner{ cx, cy, 0, 0 };
+            }
+            return Corner{ cx + sx * rad.fX, cy + sy * rad.fY, rad.fX, rad.fY };
+        };
+        fUL = corner(r.fLeft,  r.fTop,    rr.radii(SkRRect::kUpperLeft_Corner),   1,  1);
+        fUR = corner(r.fRight, r.fTop,    rr.radii(SkRRect::kUpperRight_Corner), -1,  1);
+        fLR = corner(r.fRight, r.fBottom, rr.radii(SkRRect::kLowerRight_Corner), -1, -1);
+        fLL = corner(r.fLeft,  r.fBottom, rr.radii(SkRRect::kLowerLeft_Corner),   1, -1);
+    }
+
+    const SkRect& bounds() const { return fBounds; }
+
+    // Rows in [top,bottom) have no corners and are fully covered vertically.
+    void straightRows(int* top, int* bottom) const {
+        *top    = SkScalarCeilToInt (SkTMax(fUL.fRX ? fUL.fCY : fBounds.fTop,
+                                            fUR.fRX ? fUR.fCY : fBounds.fTop));
+        *bottom = SkScalarFloorToInt(SkTMin(fLL.fRX ? fLL.fCY : fBounds.fBottom,
+                                            fLR.fRX ? fLR.fCY : fBounds.fBottom));
+    }
+
+    // Blits row y, limited to the pixels in [clipL, clipR).
+    void blitRow(int y, int clipL, int clipR, SkBlitter* blitter,
+                 SkAlpha alphas[], int16_t runs[]) const {
+        const float top = (float)y,
+                    bot = top + 1,
+                    cy  = top + 0.5f;
+        const float vcov = SkTMin(bot, fBounds.fBottom) - SkTMax(top, fBounds.fTop);
+        if (vcov <= 0) {
+            return;
+        }
+
+        // Pick the corners this row's pixel centers may fall in.
+        const Corner* left  = nullptr;
+        const Corner* right = nullptr;
+        if (fUL.fRX && cy < fUL.fCY) { left  = &fUL; }
+        if (fLL.fRX && cy > fLL.fCY) { left  = &fLL; }
+        if (fUR.fRX && cy < fUR.fCY) { right = &fUR; }
+        if (fLR.fRX && cy > fLR.fCY) { right = &fLR; }
+
+        // Pixels in [fullL, fullR) only see vcov.  A corner's curve reaches furthest in at the
+        // edge of the row nearest its ellipse's center; we leave one more pixel of slack there
+        // for the smoothing in Corner::coverage().
+        auto nearest_y = [&](const Corner* c) {
+            return c->fCY > cy ? SkTMax(top, fBounds.fTop) : SkTMin(bot, fBounds.fBottom);
+        };
+        int fullL = left  ? (int)ceilf (left ->edgeX(nearest_y(left ), -1) + 1)
+                          : SkScalarCeilToInt(fBounds.fLeft);
+        int fullR = right ? (int)floorf(right->edgeX(nearest_y(right), +1) - 1)
+                          : SkScalarFloorToInt(fBounds.fRight);
+
+        const int L = SkTMax(clipL, SkScalarFloorToInt(fBounds.fLeft)),
+                  R = SkTMin(clipR, SkScalarCeilToInt (fBounds.fRight));
+        if (L >= R) {
+            return;
+        }
+        fullL = SkTPin(fullL, L, R);
+        fullR = SkTPin(fullR, fullL, R);
+
+        auto pixel = [&](int x) -> SkAlpha {
+            const float cx = x + 0.5f;
+            // The corner's coverage already accounts for the pixel center being above or below
+            // the rrect, so it's not scaled by vcov again.
+            float hcov = SkTMin(x + 1.0f, fBounds.fRight) - SkTMax((float)x, fBounds.fLeft),
+                  cov  = hcov * vcov;
+            if (left && cx < left->fCX) {
+                cov = SkTMin(cov, left->coverage(cx, cy));
+            } else if (right && cx > right->fCX) {
+                cov = SkTMin(cov, right->coverage(cx, cy));
+            }
+            return (SkAlpha)(SkTPin(cov, 0.0f, 1.0f) * 255 + 0.5f);
+        };
+
+        int n = 0;
+        for (int x = L; x < fullL; x++) {
+            alphas[n] = pixel(x);
+            runs[n++] = 1;
+        }
+        if (fullL < fullR) {
+            alphas[n] = (SkAlpha)(vcov * 255 + 0.5f);
+            runs[n]   = SkToS16(fullR - fullL);
+            // blitAntiH() expects the runs to be spaced out like the pixels they cover.
+            n += fullR - fullL;
+        }
+        for (int x = fullR; x < R; x++) {
+            alphas[n] = pixel(x);
+            runs[n++] = 1;
+        }
+        runs[n] = 0;
+        blitter->blitAntiH(L, y, alphas, runs);
+    }
+
+private:
+    SkRect fBounds;
+    Corner fUL, fUR, fLR, fLL;
+};
+
+}  // namespace
+
+bool SkScan::AntiFillRRect(const SkRRect& rrect, const SkRasterClip& clip, SkBlitter* blitter) {
+    // Keep every pixel coordinate and run length comfortably inside int16_t.
+    const SkRect& bounds = rrect.getBounds();
+    if (!bounds.isFinite() ||
+        !SkRect::MakeLTRB(-32767, -32767, 32767, 32767).contains(bounds) ||
+        clip.getBounds().width() > 32767) {
+        return false;
+    }
+    if (clip.isEmpty()) {
+        return true;
+    }
+
+    const SkIRect outerBounds = bounds.roundOut();
+    if (clip.isBW()) {
+        SkBlitterClipper clipper;
+        SkBlitter* clipped = clipper.apply(blitter, &clip.bwRgn(), &outerBounds);
+        SkIRect ir = clip.bwRgn().getBounds();
+        if (ir.intersect(outerBounds)) {
+            RRectCoverage coverage(rrect);
+            int straightTop, straightBottom;
+            coverage.straightRows(&straightTop, &straightBottom);
+
+            SkAutoSTMalloc<256, SkAlpha> alphas(ir.width() + 1);
+            SkAutoSTMalloc<256, int16_t> runs  (ir.width() + 1);
+            for (int y = ir.fTop; y < ir.fBottom; y++) {
+                if (straightTop <= y && y < straightBottom) {
+                    // The rows between the corners are just an antialiased rect.
+                    const int bottom = SkTMin(straightBottom, ir.fBottom);
+                    const SkRect& r = coverage.bounds();
+                    SkRect middle = SkRect::MakeLTRB(r.fLeft,  SkIntToScalar(y),
+                                                     r.fRight, SkIntToScalar(bottom));
+                    SkScan::AntiFillRect(middle, clip, blitter);
+                    y = bottom - 1;
+                    continue;
+                }
+                coverage.blitRow(y, ir.fLeft, ir.fRight, clipped, alphas.get(), runs.get());
+            }
+        }
+    } else {
+        SkAAClipBlitterWrapper wrap(clip, blitter);
+        SkRasterClip bw(wrap.getRgn());
+        return AntiFillRRect(rrect, bw, wrap.getBlitter());
+    }
+    return true;
+}
@@ -203,8 +203,10 @@ void SkScan::HairRect(const SkRect& rect, const SkRasterClip& clip, SkBlitter* b
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkPath.h"
+#include "SkPathPriv.h"
 #include "SkGeometry.h"
 #include "SkNx.h"
+#include "SkStroke.h"
 
 #define kMaxCubicSubdivideLevel 9
 #define kMaxQuadSubdivideLevel  5
@@ -630,12 +632,47 @@ void hair_path(const SkPath& path, const SkRasterClip& rclip, SkBlitter* blitter
     }
 }
 
+// Below this many verbs, blitting each anti-aliased segment on its own is cheaper than stroking.
+static constexpr int kMinAntiHairVerbsForDAA = 16;
+
+/*
+ *  An anti-aliased hairline blits every segment (and every piece of a chopped curve) on its own.
+ *  When there are many of them, stroke the hairline into a one pixel wide outline instead, and
+ *  let DAA accumulate the coverage of the whole path into a single delta list or mask.
+ */
+template <SkPaint::Cap capStyle>
+static bool anti_hair_path_with_daa(const SkPath& path, const SkRasterClip& clip,
+                                    SkBlitter* blitter) {
+#if defined(SK_DISABLE_DAA)
+    return false;
+#else
+    // Hairlines ignore the fill type, but the outline would not.
+    if (!gSkUseDeltaAA || SkPathPriv::IsBadForDAA(path) || path.isInverseFillType() ||
+            path.countVerbs() < kMinAntiHairVerbsForDAA) {
+        return false;
+    }
+
+    SkStroke stroker;
+    stroker.setWidth(SK_Scalar1);
+    stroker.setCap(capStyle);
+    stroker.setJoin(SkPaint::kBevel_Join);
+
+    SkPath outline;
+    stroker.strokePath(path, &outline);
+    SkPathPriv::SetIsStrokeOutline(outline, true);
+    SkScan::AntiFillPath(outline, clip, blitter);
+    return true;
+#endif
+}
+
 void SkScan::HairPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
     hair_path<SkPaint::kButt_Cap>(path, clip, blitter, SkScan::HairLineRgn);
 }
 
 void SkScan::AntiHairPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
-    hair_path<SkPaint::kButt_Cap>(path, clip, blitter, SkScan::AntiHairLineRgn);
+    if (!anti_hair_path_with_daa<SkPaint::kButt_Cap>(path, clip, blitter)) {
+        hair_path<SkPaint::kButt_Cap>(path, clip, blitter, SkScan::AntiHairLineRgn);
+    }
 }
 
 void SkScan::HairSquarePath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
@@ -643,7 +680,9 @@ void SkScan::HairSquarePath(const SkPath& path, const SkRasterClip& clip, SkBlit
 }
 
 void SkScan::AntiHairSquarePath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
-    hair_path<SkPaint::kSquare_Cap>(path, clip, blitter, SkScan::AntiHairLineRgn);
+    if (!anti_hair_path_with_daa<SkPaint::kSquare_Cap>(path, clip, blitter)) {
+        hair_path<SkPaint::kSquare_Cap>(path, clip, blitter, SkScan::AntiHairLineRgn);
+    }
 }
 
 void SkScan::HairRoundPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
@@ -651,7 +690,9 @@ void SkScan::HairRoundPath(const SkPath& path, const SkRasterClip& clip, SkBlitt
 }
 
 void SkScan::AntiHairRoundPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
-    hair_path<SkPaint::kRound_Cap>(path, clip, blitter, SkScan::AntiHairLineRgn);
+    if (!anti_hair_path_with_daa<SkPaint::kRound_Cap>(path, clip, blitter)) {
+        hair_path<SkPaint::kRound_Cap>(path, clip, blitter, SkScan::AntiHairLineRgn);
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -8,10 +8,13 @@
 #include "SkStrikeCache.h"
 
 #include <cctype>
+#include <vector>
 
+#include "SkData.h"
 #include "SkGlyphCache.h"
 #include "SkGraphics.h"
 #include "SkMutex.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTraceMemoryDump.h"
 #include "SkTypeface.h"
@@ -32,10 +35,59 @@ struct SkStrikeCache::Node {
 
     Node*                           fNext{nullptr};
     Node*                           fPrev{nullptr};
+    uint64_t                        fLastUse{0};
     SkGlyphCache                    fCache;
     std::unique_ptr<SkStrikePinner> fPinner;
+    sk_sp<SkData>                   fPersistentKey;        // Null unless persistent.
+    size_t                          fStoredMemoryUsed{0};  // fCache's size when loaded or stored.
 };
 
+// Font IDs are only unique within a process, so persistent keys identify the typeface by a hash
+// of its 'head' table, which holds a checksum of the whole font along with its revision and
+// modification date, and of its variation position.  Typefaces without one aren't persisted.
+static sk_sp<SkData> make_persistent_key(const SkDescriptor& desc, const SkTypeface& typeface) {
+    static constexpr SkFontTableTag kHeadTag = SkSetFourByteTag('h', 'e', 'a', 'd');
+    // Bump this whenever the key or SkGlyphCache::serializeGlyphs() changes.
+    static constexpr uint32_t kKeyVersion = 1;
+
+    size_t headSize = typeface.getTableSize(kHeadTag);
+    if (headSize == 0) {
+        return nullptr;
+    }
+    SkAutoTMalloc<uint8_t> head(headSize);
+    if (typeface.getTableData(kHeadTag, 0, headSize, head.get()) != headSize) {
+        return nullptr;
+    }
+    uint32_t typefaceHash = SkOpts::hash(head.get(), headSize);
+
+    using Coordinate = SkFontArguments::VariationPosition::Coordinate;
+    int axisCount = typeface.getVariationDesignPosition(nullptr, 0);
+    if (axisCount > 0) {
+        SkAutoSTMalloc<4, Coordinate> position(axisCount);
+        if (typeface.getVariationDesignPosition(position.get(), axisCount) == axisCount) {
+            typefaceHash = SkOpts::hash(position.get(), axisCount * sizeof(Coordinate),
+                                        typefaceHash);
+        }
+    }
+
+    // The key is the version, the typeface hash, then the descriptor without the font ID.
+    const size_t headerSize = 2 * sizeof(uint32_t);
+    sk_sp<SkData> key = SkData::MakeUninitialized(headerSize + desc.getLength());
+    auto* header = static_cast<uint32_t*>(key->writable_data());
+    header[0] = kKeyVersion;
+    header[1] = typefaceHash;
+    auto* keyDesc = reinterpret_cast<SkDescriptor*>(header + 2);
+    memcpy(keyDesc, &desc, desc.getLength());
+
+    uint32_t recSize;
+    if (auto* rec = (SkScalerContextRec*)keyDesc->findEntry(kRec_SkDescriptorTag, &recSize)) {
+        SkASSERT(recSize == sizeof(SkScalerContextRec));
+        rec->fFontID = 0;
+    }
+    keyDesc->computeChecksum();
+    return key;
+}
+
 SkStrikeCache::ExclusiveStrikePtr::ExclusiveStrikePtr(
         SkStrikeCache::Node* node, SkStrikeCache* strikeCache)
     : fNode{node}
@@ -100,14 +152,20 @@ bool operator == (decltype(nullptr), const SkStrikeCache::ExclusiveStrikePtr& rh
 }
 
 SkStrikeCache::~SkStrikeCache() {
-    Node* node = fHead;
-    while (node) {
-        Node* next = node->fNext;
-        delete node;
-        node = next;
+    for (Shard& shard : fShards) {
+        Node* node = shard.fHead;
+        while (node) {
+            Node* next = node->fNext;
+            delete node;
+            node = next;
+        }
     }
 }
 
+SkStrikeCache::Shard& SkStrikeCache::shardFor(const SkDescriptor& desc) {
+    return fShards[desc.getChecksum() % kShardCount];
+}
+
 SkExclusiveStrikePtr SkStrikeCache::FindStrikeExclusive(const SkDescriptor& desc) {
     return GlobalStrikeCache()->findStrikeExclusive(desc);
 }
@@ -241,21 +299,30 @@ void SkStrikeCache::attachNode(Node* node) {
     if (node == nullptr) {
         return;
     }
-    SkAutoExclusive ac(fLock);
-
-    this->validate();
     node->fCache.validate();
+    node->fLastUse = fUseCount.fetch_add(1, std::memory_order_relaxed);
 
-    this->internalAttachToHead(node);
-    this->internalPurge();
+    {
+        Shard* shard = &this->shardFor(node->fCache.getDescriptor());
+        SkAutoExclusive ac(shard->fLock);
+        this->internalAttachToHead(shard, node);
+    }
+
+    if (fTotalMemoryUsed.load(std::memory_order_relaxed) >
+                fCacheSizeLimit.load(std::memory_order_relaxed) ||
+        fCacheCount.load(std::memory_order_relaxed) >
+                fCacheCountLimit.load(std::memory_order_relaxed)) {
+        this->purge();
+    }
 }
 
 SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc) {
-    SkAutoExclusive ac(fLock);
+    Shard* shard = &this->shardFor(desc);
+    SkAutoExclusive ac(shard->fLock);
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
+    for (Node* node = shard->fHead; node != nullptr; node = node->fNext) {
         if (node->fCache.getDescriptor() == desc) {
-            this->internalDetachCache(node);
+            this->internalDetachCache(shard, node);
             return SkExclusiveStrikePtr(node, this);
         }
     }
@@ -291,28 +358,31 @@ static bool loose_compare(const SkDescriptor& lhs, const SkDescriptor& rhs) {
 
 bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph* glyph,
                                               SkGlyphCache* targetCache) {
-    SkAutoExclusive ac(fLock);
-
     SkGlyphID glyphID = glyph->getGlyphID();
     SkFixed targetSubX = glyph->getSubXFixed(),
             targetSubY = glyph->getSubYFixed();
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fCache.getDescriptor(), desc)) {
-            auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
-            if (node->fCache.isGlyphCached(glyphID, targetSubX, targetSubY)) {
-                SkGlyph* fallback = node->fCache.getRawGlyphByID(targetGlyphID);
-                // This desperate-match node may disappear as soon as we drop fLock, so we
-                // need to copy the glyph from node into this strike, including a
-                // deep copy of the mask.
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
-            }
+    // Loosely matching strikes may be in any shard.
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fCache.getDescriptor(), desc)) {
+                auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
+                if (node->fCache.isGlyphCached(glyphID, targetSubX, targetSubY)) {
+                    SkGlyph* fallback = node->fCache.getRawGlyphByID(targetGlyphID);
+                    // This desperate-match node may disappear as soon as we drop the shard's
+                    // lock, so we need to copy the glyph from node into this strike, including
+                    // a deep copy of the mask.
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
 
-            // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
-            if (const auto* fallback = node->fCache.getCachedGlyphAnySubPix(glyphID)) {
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
+                // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
+                if (const auto* fallback = node->fCache.getCachedGlyphAnySubPix(glyphID)) {
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
             }
         }
     }
@@ -322,7 +392,6 @@ bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph*
 
 bool SkStrikeCache::desperationSearchForPath(
         const SkDescriptor& desc, SkGlyphID glyphID, SkPath* path) {
-    SkAutoExclusive ac(fLock);
 
     // The following is wrong there is subpixel positioning with paths...
     // Paths are only ever at sub-pixel position (0,0), so we can just try that directly rather
@@ -330,15 +399,19 @@ bool SkStrikeCache::desperationSearchForPath(
     //
     // This will have to search the sub-pixel positions too.
     // There is also a problem with accounting for cache size with shared path data.
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fCache.getDescriptor(), desc)) {
-            if (node->fCache.isGlyphCached(glyphID, 0, 0)) {
-                SkGlyph* from = node->fCache.getRawGlyphByID(SkPackedGlyphID(glyphID));
-                if (from->fPathData != nullptr && from->fPathData->fPath != nullptr) {
-                    // We can just copy the path out by value here, so no need to worry
-                    // about the lifetime of this desperate-match node.
-                    *path = *from->fPathData->fPath;
-                    return true;
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fCache.getDescriptor(), desc)) {
+                if (node->fCache.isGlyphCached(glyphID, 0, 0)) {
+                    SkGlyph* from = node->fCache.getRawGlyphByID(SkPackedGlyphID(glyphID));
+                    if (from->fPathData != nullptr && from->fPathData->fPath != nullptr) {
+                        // We can just copy the path out by value here, so no need to worry
+                        // about the lifetime of this desperate-match node.
+                        *path = *from->fPathData->fPath;
+                        return true;
+                    }
                 }
             }
         }
@@ -369,28 +442,43 @@ SkExclusiveStrikePtr SkStrikeCache::createStrikeExclusive(
         scaler->getFontMetrics(&fontMetrics);
     }
 
+    SkGraphics::PersistentFontCache* persistentCache =
+            pinner == nullptr ? fPersistentCache.load(std::memory_order_relaxed) : nullptr;
+
     auto* node = new Node(desc, std::move(scaler), fontMetrics, std::move(pinner));
+    if (persistentCache) {
+        node->fPersistentKey =
+                make_persistent_key(desc, *node->fCache.getScalerContext()->getTypeface());
+        if (node->fPersistentKey) {
+            if (sk_sp<SkData> glyphs = persistentCache->load(*node->fPersistentKey)) {
+                if (!node->fCache.deserializeGlyphs(glyphs->data(), glyphs->size())) {
+                    SkDebugf("SkStrikeCache: dropped part of a malformed persistent strike.\n");
+                }
+            }
+            node->fStoredMemoryUsed = node->fCache.getMemoryUsed();
+        }
+    }
     return SkExclusiveStrikePtr(node, this);
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(fTotalMemoryUsed.load());
+}
+
+size_t SkStrikeCache::purgeBytes(size_t bytes) {
+    return this->purge(bytes);
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fTotalMemoryUsed;
+    return fTotalMemoryUsed.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheCount;
+    return fCacheCount.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheCountLimit;
+    return fCacheCountLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
@@ -399,17 +487,13 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
+    this->purge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheSizeLimit;
+    return fCacheSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCacheCountLimit(int newCount) {
@@ -417,17 +501,13 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount);
+    this->purge();
     return prevCount;
 }
 
 int SkStrikeCache::getCachePointSizeLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fPointSizeLimit;
+    return fPointSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
@@ -435,41 +515,92 @@ int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
         newLimit = 0;
     }
 
-    SkAutoExclusive ac(fLock);
+    return fPointSizeLimit.exchange(newLimit);
+}
 
-    int prevLimit = fPointSizeLimit;
-    fPointSizeLimit = newLimit;
-    return prevLimit;
+void SkStrikeCache::setPersistentCache(SkGraphics::PersistentFontCache* cache) {
+    fPersistentCache.store(cache);
+}
+
+sk_sp<SkData> SkStrikeCache::serializeIfChanged(Node* node) {
+    if (node->fPersistentKey == nullptr ||
+        fPersistentCache.load(std::memory_order_relaxed) == nullptr ||
+        node->fCache.getMemoryUsed() == node->fStoredMemoryUsed) {
+        return nullptr;
+    }
+    node->fStoredMemoryUsed = node->fCache.getMemoryUsed();
+    return node->fCache.serializeGlyphs();
+}
+
+void SkStrikeCache::storeAll() {
+    SkGraphics::PersistentFontCache* persistentCache = fPersistentCache.load();
+    if (persistentCache == nullptr) {
+        return;
+    }
+
+    // Serialize under each shard's lock, but leave the (probably slow) stores until after.
+    std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> pending;
+    for (Shard& shard : fShards) {
+        {
+            SkAutoExclusive ac(shard.fLock);
+            for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+                if (sk_sp<SkData> glyphs = this->serializeIfChanged(node)) {
+                    pending.emplace_back(node->fPersistentKey, std::move(glyphs));
+                }
+            }
+        }
+        for (const auto& keyAndGlyphs : pending) {
+            persistentCache->store(*keyAndGlyphs.first, *keyAndGlyphs.second);
+        }
+        pending.clear();
+    }
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkGlyphCache&)> visitor) const {
-    SkAutoExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
 
-    this->validate();
+        this->internalValidate(shard);
 
-    for (Node* node = this->internalGetHead(); node != nullptr; node = node->fNext) {
-        visitor(node->fCache);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            visitor(node->fCache);
+        }
     }
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
-    this->validate();
+size_t SkStrikeCache::purge(size_t minBytesNeeded) {
+    SkAutoExclusive purging(fPurgeLock);
+
+    // The least recently used node in a shard that we're allowed to delete.
+    auto oldest_deletable = [](Node* tail) -> Node* {
+        for (Node* node = tail; node != nullptr; node = node->fPrev) {
+            if (node->fPinner == nullptr || node->fPinner->canDelete()) {
+                return node;
+            }
+        }
+        return nullptr;
+    };
+
+    const size_t totalMemoryUsed = fTotalMemoryUsed.load(),
+                 cacheSizeLimit  = fCacheSizeLimit.load();
+    const int32_t cacheCount      = fCacheCount.load(),
+                  cacheCountLimit = fCacheCountLimit.load();
 
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > cacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - cacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > cacheCountLimit) {
+        countNeeded = cacheCount - cacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -479,24 +610,54 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
 
     size_t  bytesFreed = 0;
     int     countFreed = 0;
+    SkTDArray<Node*> retired;
+
+    // Each shard's list is in LRU order, with unimportant entries at the tail.  Delete from
+    // whichever shard has the oldest tail, until it's no longer the oldest; then look again.
+    while (bytesFreed < bytesNeeded || countFreed < countNeeded) {
+        Shard* oldest = nullptr;
+        uint64_t oldestUse = UINT64_MAX,
+                 runnerUpUse = UINT64_MAX;
+        for (Shard& shard : fShards) {
+            SkAutoExclusive ac(shard.fLock);
+            if (Node* node = oldest_deletable(shard.fTail)) {
+                if (node->fLastUse < oldestUse) {
+                    runnerUpUse = oldestUse;
+                    oldestUse = node->fLastUse;
+                    oldest = &shard;
+                } else {
+                    runnerUpUse = SkTMin(runnerUpUse, node->fLastUse);
+                }
+            }
+        }
+        if (oldest == nullptr) {
+            break;  // Everything left is pinned.
+        }
 
-    // Start at the tail and proceed backwards deleting; the list is in LRU
-    // order, with unimportant entries at the tail.
-    Node* node = this->internalGetTail();
-    while (node != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        Node* prev = node->fPrev;
-
-        // Only delete if the strike is not pinned.
-        if (node->fPinner == nullptr || node->fPinner->canDelete()) {
+        SkAutoExclusive ac(oldest->fLock);
+        // Other threads may have changed the shard since we looked, but any node in it now is
+        // either one we saw or more recently used.
+        Node* node = oldest_deletable(oldest->fTail);
+        while (node != nullptr && node->fLastUse <= runnerUpUse &&
+               (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
+            Node* prev = node->fPrev;
             bytesFreed += node->fCache.getMemoryUsed();
             countFreed += 1;
-            this->internalDetachCache(node);
-            delete node;
+            this->internalDetachCache(oldest, node);
+            retired.push_back(node);
+            node = oldest_deletable(prev);
         }
-        node = prev;
+        this->internalValidate(*oldest);
     }
 
-    this->validate();
+    // The purged strikes are no longer in any shard, so can be stored without holding a lock.
+    SkGraphics::PersistentFontCache* persistentCache = fPersistentCache.load();
+    for (Node* node : retired) {
+        if (sk_sp<SkData> glyphs = persistentCache ? this->serializeIfChanged(node) : nullptr) {
+            persistentCache->store(*node->fPersistentKey, *glyphs);
+        }
+        delete node;
+    }
 
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
@@ -508,36 +669,42 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(Node* node) {
+void SkStrikeCache::internalAttachToHead(Shard* shard, Node* node) {
     SkASSERT(nullptr == node->fPrev && nullptr == node->fNext);
-    if (fHead) {
-        fHead->fPrev = node;
-        node->fNext = fHead;
+    if (shard->fHead) {
+        shard->fHead->fPrev = node;
+        node->fNext = shard->fHead;
     }
-    fHead = node;
+    shard->fHead = node;
 
-    if (fTail == nullptr) {
-        fTail = node;
+    if (shard->fTail == nullptr) {
+        shard->fTail = node;
     }
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += node->fCache.getMemoryUsed();
+    size_t memoryUsed = node->fCache.getMemoryUsed();
+    shard->fCount += 1;
+    shard->fMemoryUsed += memoryUsed;
+    fCacheCount.fetch_add(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_add(memoryUsed, std::memory_order_relaxed);
 }
 
-void SkStrikeCache::internalDetachCache(Node* node) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= node->fCache.getMemoryUsed();
+void SkStrikeCache::internalDetachCache(Shard* shard, Node* node) {
+    SkASSERT(shard->fCount > 0);
+    size_t memoryUsed = node->fCache.getMemoryUsed();
+    shard->fCount -= 1;
+    shard->fMemoryUsed -= memoryUsed;
+    fCacheCount.fetch_sub(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_sub(memoryUsed, std::memory_order_relaxed);
 
     if (node->fPrev) {
         node->fPrev->fNext = node->fNext;
     } else {
-        fHead = node->fNext;
+        shard->fHead = node->fNext;
     }
     if (node->fNext) {
         node->fNext->fPrev = node->fPrev;
     } else {
-        fTail = node->fPrev;
+        shard->fTail = node->fPrev;
     }
     node->fPrev = node->fNext = nullptr;
 }
@@ -561,17 +728,35 @@ void SkStrikeCache::validate() const {
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const Node* node = fHead;
+    for (const Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        this->internalValidate(shard);
+        computedBytes += shard.fMemoryUsed;
+        computedCount += shard.fCount;
+    }
+
+    // Other threads may be attaching and detaching strikes, so this only holds when we're idle.
+    SkASSERTF(fCacheCount.load() == computedCount, "fCacheCount: %d, computedCount: %d",
+              fCacheCount.load(), computedCount);
+    SkASSERTF(fTotalMemoryUsed.load() == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
+              fTotalMemoryUsed.load(), computedBytes);
+}
+
+void SkStrikeCache::internalValidate(const Shard& shard) const {
+    size_t computedBytes = 0;
+    int computedCount = 0;
+
+    const Node* node = shard.fHead;
     while (node != nullptr) {
         computedBytes += node->fCache.getMemoryUsed();
         computedCount += 1;
         node = node->fNext;
     }
 
-    SkASSERTF(fCacheCount == computedCount, "fCacheCount: %d, computedCount: %d", fCacheCount,
+    SkASSERTF(shard.fCount == computedCount, "fCount: %d, computedCount: %d", shard.fCount,
               computedCount);
-    SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
-              fTotalMemoryUsed, computedBytes);
+    SkASSERTF(shard.fMemoryUsed == computedBytes, "fMemoryUsed: %d, computedBytes: %d",
+              shard.fMemoryUsed, computedBytes);
 }
 #endif
 
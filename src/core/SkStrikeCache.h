@@ -8,10 +8,12 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "SkDescriptor.h"
+#include "SkGraphics.h"
 #include "SkSpinlock.h"
 #include "SkTemplates.h"
 
@@ -125,6 +127,9 @@ public:
     void attachNode(Node* node);
 
     void purgeAll(); // does not change budget
+    // Purges at least bytes (or everything that can be purged), least recently used first.
+    // Returns the number of bytes freed.
+    size_t purgeBytes(size_t bytes);
 
     int getCacheCountLimit() const;
     int setCacheCountLimit(int limit);
@@ -137,6 +142,11 @@ public:
     int  getCachePointSizeLimit() const;
     int  setCachePointSizeLimit(int limit);
 
+    // Unpinned strikes for fonts with a 'head' table start out with the glyphs last stored for
+    // them in the persistent cache, and store theirs when purged or on storeAll().
+    void setPersistentCache(SkGraphics::PersistentFontCache*);
+    void storeAll();
+
 #ifdef SK_DEBUG
     // A simple accounting of what each glyph cache reports and the strike cache total.
     void validate() const;
@@ -148,28 +158,51 @@ public:
 #endif
 
 private:
+    // Strikes not checked out are spread over shards by descriptor, each with its own lock and
+    // LRU list, so threads looking up different strikes rarely contend.  Totals and limits are
+    // atomics, readable without any lock.
+    static constexpr int kShardCount = 16;
+
+    struct Shard {
+        mutable SkSpinlock fLock;
+        Node*              fHead{nullptr};
+        Node*              fTail{nullptr};
+        size_t             fMemoryUsed{0};
+        int32_t            fCount{0};
+    };
+
+    Shard& shardFor(const SkDescriptor&);
 
-    // The following methods can only be called when mutex is already held.
-    Node* internalGetHead() const { return fHead; }
-    Node* internalGetTail() const { return fTail; }
-    void internalDetachCache(Node*);
-    void internalAttachToHead(Node*);
+    // The following methods can only be called when the shard's lock is already held.
+    void internalDetachCache(Shard*, Node*);
+    void internalAttachToHead(Shard*, Node*);
+#ifdef SK_DEBUG
+    void internalValidate(const Shard&) const;
+#else
+    void internalValidate(const Shard&) const {}
+#endif
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
-    // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0);
+    // and attempt to purge the least recently used caches across all shards to match.
+    // Takes the locks it needs.  Returns number of bytes freed.
+    size_t purge(size_t minBytesNeeded = 0);
 
     void forEachStrike(std::function<void(const SkGlyphCache&)> visitor) const;
 
-    mutable SkSpinlock fLock;
-    Node*              fHead{nullptr};
-    Node*              fTail{nullptr};
-    size_t             fTotalMemoryUsed{0};
-    size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t            fCacheCount{0};
-    int32_t            fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    // If the node is persistent and has new glyphs since it was loaded or last stored, returns
+    // them serialized and counts them as stored; otherwise returns null.  The node must be
+    // detached, or its shard's lock held.
+    sk_sp<SkData> serializeIfChanged(Node*);
+
+    Shard                 fShards[kShardCount];
+    SkSpinlock            fPurgeLock;       // Serializes purges; taken before any shard's lock.
+    std::atomic<uint64_t> fUseCount{0};     // Stamps strikes as they're attached, for LRU order.
+    std::atomic<size_t>   fTotalMemoryUsed{0};
+    std::atomic<size_t>   fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<int32_t>  fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    std::atomic<int32_t>  fCacheCount{0};
+    std::atomic<int32_t>  fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    std::atomic<SkGraphics::PersistentFontCache*> fPersistentCache{nullptr};
 };
 
 using SkExclusiveStrikePtr = SkStrikeCache::ExclusiveStrikePtr;
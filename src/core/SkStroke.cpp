@@ -9,6 +9,7 @@
 
 #include "SkGeometry.h"
 #include "SkMacros.h"
+#include "SkNx.h"
 #include "SkPathPriv.h"
 #include "SkPointPriv.h"
 #include "SkTo.h"
@@ -242,23 +243,41 @@ private:
 
     void    finishContour(bool close, bool isLine);
     bool    preJoinTo(const SkPoint&, SkVector* normal, SkVector* unitNormal,
-                      bool isLine);
+                      bool isLine, const SkVector* lineUnitNormal = nullptr);
     void    postJoinTo(const SkPoint&, const SkVector& normal,
                        const SkVector& unitNormal);
 
     void    line_to(const SkPoint& currPt, const SkVector& normal);
+
+    // Polylines spend much of their time normalizing, so lineTo() looks ahead through the
+    // iterator and finds the unit normals of the next run of lines four at a time.
+    struct LineNormal {
+        SkPoint  fBefore;
+        SkVector fUnitNormal;   // (0, 0) if the line can't be normalized without doubles
+    };
+    static constexpr int kMaxLineNormals = 32;
+    LineNormal  fLineNormals[kMaxLineNormals];
+    int         fLineNormalIndex;
+    int         fLineNormalCount;
+
+    const SkVector* nextLineUnitNormal(const SkPoint& currPt, const SkPath::Iter& iter);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkPathStroker::preJoinTo(const SkPoint& currPt, SkVector* normal,
-                              SkVector* unitNormal, bool currIsLine) {
+                              SkVector* unitNormal, bool currIsLine,
+                              const SkVector* lineUnitNormal) {
     SkASSERT(fSegmentCount >= 0);
 
     SkScalar    prevX = fPrevPt.fX;
     SkScalar    prevY = fPrevPt.fY;
 
-    if (!set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius, normal, unitNormal)) {
+    if (lineUnitNormal) {
+        *unitNormal = *lineUnitNormal;
+        unitNormal->scale(fRadius, normal);
+    } else if (!set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius, normal,
+                                      unitNormal)) {
         if (SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper) {
             return false;
         }
@@ -366,6 +385,7 @@ SkPathStroker::SkPathStroker(const SkPath& src,
     fSegmentCount = -1;
     fFirstOuterPtIndexInContour = 0;
     fPrevIsLine = false;
+    fLineNormalIndex = fLineNormalCount = 0;
 
     // Need some estimate of how large our final result (fOuter)
     // and our per-contour temp (fInner) will be, so we don't spend
@@ -430,7 +450,63 @@ static bool has_valid_tangent(const SkPath::Iter* iter) {
     return false;
 }
 
+const SkVector* SkPathStroker::nextLineUnitNormal(const SkPoint& currPt,
+                                                 const SkPath::Iter& iter) {
+    if (fLineNormalIndex == fLineNormalCount) {
+        // Gather this line and the ones right after it, up to the next verb that isn't a line.
+        SkPoint after[kMaxLineNormals];
+        fLineNormals[0].fBefore = fPrevPt;
+        after[0] = currPt;
+        int count = 1;
+        SkPath::Iter copy = iter;
+        SkPoint pts[4];
+        while (count < kMaxLineNormals && SkPath::kLine_Verb == copy.next(pts, false)) {
+            fLineNormals[count].fBefore = pts[0];
+            after[count] = pts[1];
+            count += 1;
+        }
+
+        // This matches set_normal_unitnormal() bit for bit, except that lines too short to
+        // normalize or too long to normalize in floats are left to it.
+        const Sk4f scale(fResScale);
+        const Sk4f nearlyZeroSqd(SK_ScalarNearlyZero * SK_ScalarNearlyZero);
+        const Sk4f infinity(SK_FloatInfinity);
+        for (int i = 0; i < count; i += 4) {
+            float bx[4], by[4], ax[4], ay[4];
+            for (int j = 0; j < 4; ++j) {
+                int k = SkTMin(i + j, count - 1);
+                bx[j] = fLineNormals[k].fBefore.fX;
+                by[j] = fLineNormals[k].fBefore.fY;
+                ax[j] = after[k].fX;
+                ay[j] = after[k].fY;
+            }
+            Sk4f x = (Sk4f::Load(ax) - Sk4f::Load(bx)) * scale;
+            Sk4f y = (Sk4f::Load(ay) - Sk4f::Load(by)) * scale;
+            Sk4f mag2 = x * x + y * y;
+            Sk4f invMag = Sk4f(1) / mag2.sqrt();
+            // Rotate counter-clockwise as we go.
+            Sk4f nx = (mag2 < infinity).thenElse(y * invMag, 0);
+            Sk4f ny = (mag2 < infinity).thenElse(-(x * invMag), 0);
+            nx = (mag2 > nearlyZeroSqd).thenElse(nx, 0);
+            ny = (mag2 > nearlyZeroSqd).thenElse(ny, 0);
+            for (int j = 0; j < 4 && i + j < count; ++j) {
+                fLineNormals[i + j].fUnitNormal.set(nx[j], ny[j]);
+            }
+        }
+        fLineNormalIndex = 0;
+        fLineNormalCount = count;
+    }
+    const LineNormal& line = fLineNormals[fLineNormalIndex++];
+    // A skipped teeny line leaves us starting from an earlier point than the line did.
+    if (line.fBefore != fPrevPt || line.fUnitNormal.isZero()) {
+        return nullptr;
+    }
+    return &line.fUnitNormal;
+}
+
 void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter) {
+    // Every line the iterator returns comes through here, so this stays in step with it.
+    const SkVector* lineUnitNormal = iter ? this->nextLineUnitNormal(currPt, *iter) : nullptr;
     bool teenyLine = SkPointPriv::EqualsWithinTolerance(fPrevPt, currPt, SK_ScalarNearlyZero * fInvResScale);
     if (SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper && teenyLine) {
         return;
@@ -440,7 +516,7 @@ void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter) {
     }
     SkVector    normal, unitNormal;
 
-    if (!this->preJoinTo(currPt, &normal, &unitNormal, true)) {
+    if (!this->preJoinTo(currPt, &normal, &unitNormal, true, lineUnitNormal)) {
         return;
     }
     this->line_to(currPt, normal);
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTFlatHash_DEFINED
+#define SkTFlatHash_DEFINED
+
+#include "SkMathPriv.h"
+#include "SkTemplates.h"
+#include "SkTo.h"
+#include "SkTypes.h"
+#include <new>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+// A drop-in replacement for SkTHashTable for hot lookups.  Alongside the entries it keeps one
+// control byte per slot: 7 bits of the entry's hash, or a marker for an empty or deleted slot.
+// Lookups compare 16 control bytes at once (with SSE2) against the key's 7 hash bits, so they only
+// touch the entries whose bits match, and usually just the one they are looking for.
+//
+// T and K are treated as ordinary movable C++ types, and Traits must have:
+//   - static K GetKey(T)
+//   - static uint32_t Hash(K)
+// The pointers returned by set() and find() are valid only until the next call to set().
+template <typename T, typename K, typename Traits = T>
+class SkTFlatHashTable {
+public:
+    SkTFlatHashTable() {}
+    SkTFlatHashTable(SkTFlatHashTable&& that)
+        : fCount(that.fCount)
+        , fGrowthLeft(that.fGrowthLeft)
+        , fCapacity(that.fCapacity)
+        , fCtrl(std::move(that.fCtrl))
+        , fSlots(std::move(that.fSlots)) {
+        that.fCount = that.fGrowthLeft = that.fCapacity = 0;
+    }
+
+    SkTFlatHashTable& operator=(SkTFlatHashTable&& that) {
+        if (this != &that) {
+            this->~SkTFlatHashTable();
+            new (this) SkTFlatHashTable(std::move(that));
+        }
+        return *this;
+    }
+
+    ~SkTFlatHashTable() {
+        this->foreach([](T* val) { val->~T(); });
+    }
+
+    // Clear the table.
+    void reset() { *this = SkTFlatHashTable(); }
+
+    // How many entries are in the table?
+    int count() const { return fCount; }
+
+    // Approximately how many bytes of memory do we use beyond sizeof(*this)?
+    size_t approxBytesUsed() const {
+        return fCapacity ? fCapacity * (sizeof(T) + 1) + kGroupWidth : 0;
+    }
+
+    // Copy val into the hash table, returning a pointer to the copy now in the table.
+    // If there already is an entry in the table with the same key, we overwrite it.
+    T* set(T val) {
+        if (T* existing = this->find(Traits::GetKey(val))) {
+            *existing = std::move(val);
+            return existing;
+        }
+        if (0 == fGrowthLeft) {
+            this->grow();
+        }
+        return this->uncheckedInsert(std::move(val));
+    }
+
+    // If there is an entry in the table with this key, return a pointer to it.  If not, null.
+    T* find(const K& key) const {
+        if (0 == fCapacity) {
+            return nullptr;
+        }
+        const uint32_t hash = Traits::Hash(key);
+        const int mask = fCapacity - 1;
+        int pos = H1(hash) & mask;
+        for (int stride = kGroupWidth; ; stride += kGroupWidth) {
+            const Group group(&fCtrl[pos]);
+            for (uint32_t bits = group.match(H2(hash)); bits; bits &= bits - 1) {
+                const int index = (pos + LowestBit(bits)) & mask;
+                if (key == Traits::GetKey(*this->slot(index))) {
+                    return this->slot(index);
+                }
+            }
+            if (group.matchEmpty()) {
+                return nullptr;
+            }
+            pos = (pos + stride) & mask;
+        }
+    }
+
+    // Remove the value with this key from the hash table.
+    void remove(const K& key) {
+        T* val = this->find(key);
+        SkASSERT(val);
+        val->~T();
+        this->setCtrl(SkToInt(val - fSlots.get()), kDeleted);
+        fCount--;
+    }
+
+    // Call fn on every entry in the table.  You may mutate the entries, but be very careful.
+    template <typename Fn>  // f(T*)
+    void foreach(Fn&& fn) {
+        for (int i = 0; i < fCapacity; i++) {
+            if (IsFull(fCtrl[i])) {
+                fn(&fSlots[i]);
+            }
+        }
+    }
+
+    // Call fn on every entry in the table.  You may not mutate anything.
+    template <typename Fn>  // f(T) or f(const T&)
+    void foreach(Fn&& fn) const {
+        for (int i = 0; i < fCapacity; i++) {
+            if (IsFull(fCtrl[i])) {
+                fn(fSlots[i]);
+            }
+        }
+    }
+
+private:
+    // Control bytes.  A full slot holds the low 7 bits of its entry's hash.
+    static constexpr int8_t kEmpty   = -128,
+                            kDeleted = -2;
+    static constexpr int    kGroupWidth = 16;
+
+    static bool IsFull(int8_t ctrl) { return ctrl >= 0; }
+    static uint32_t H1(uint32_t hash) { return hash >> 7; }
+    static int8_t   H2(uint32_t hash) { return (int8_t)(hash & 0x7f); }
+    static int LowestBit(uint32_t bits) { return 31 - SkCLZ(bits & (0 - bits)); }
+
+    // kGroupWidth control bytes, starting at any slot.
+    class Group {
+    public:
+        explicit Group(const int8_t* ctrl) {
+        #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            fCtrl = _mm_loadu_si128((const __m128i*)ctrl);
+        #else
+            fCtrl = ctrl;
+        #endif
+        }
+
+        // Bit i is set if control byte i is h2.
+        uint32_t match(int8_t h2) const {
+        #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(fCtrl, _mm_set1_epi8(h2)));
+        #else
+            uint32_t bits = 0;
+            for (int i = 0; i < kGroupWidth; i++) {
+                bits |= (uint32_t)(fCtrl[i] == h2) << i;
+            }
+            return bits;
+        #endif
+        }
+
+        uint32_t matchEmpty() const { return this->match(kEmpty); }
+
+        // Empty and deleted slots are the ones with the sign bit set.
+        uint32_t matchEmptyOrDeleted() const {
+        #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            return _mm_movemask_epi8(fCtrl);
+        #else
+            uint32_t bits = 0;
+            for (int i = 0; i < kGroupWidth; i++) {
+                bits |= (uint32_t)!IsFull(fCtrl[i]) << i;
+            }
+            return bits;
+        #endif
+        }
+
+    private:
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i       fCtrl;
+    #else
+        const int8_t* fCtrl;
+    #endif
+    };
+
+    // Like SkTHashTable, find() on a const table still returns a mutable entry.
+    T* slot(int index) const { return const_cast<T*>(fSlots.get()) + index; }
+
+    // The first kGroupWidth control bytes are mirrored after the last, so that a Group can be
+    // loaded starting at any slot.
+    void setCtrl(int index, int8_t ctrl) {
+        fCtrl[index] = ctrl;
+        if (index < kGroupWidth) {
+            fCtrl[fCapacity + index] = ctrl;
+        }
+    }
+
+    T* uncheckedInsert(T&& val) {
+        const uint32_t hash = Traits::Hash(Traits::GetKey(val));
+        const int mask = fCapacity - 1;
+        int pos = H1(hash) & mask;
+        for (int stride = kGroupWidth; ; stride += kGroupWidth) {
+            if (uint32_t bits = Group(&fCtrl[pos]).matchEmptyOrDeleted()) {
+                const int index = (pos + LowestBit(bits)) & mask;
+                if (kEmpty == fCtrl[index]) {
+                    fGrowthLeft--;
+                }
+                this->setCtrl(index, H2(hash));
+                fCount++;
+                return new (&fSlots[index]) T(std::move(val));
+            }
+            pos = (pos + stride) & mask;
+        }
+    }
+
+    // Makes room for at least one more entry, at most 7/8 full.  If the table is mostly deleted
+    // slots, this rehashes it at the same capacity.
+    void grow() {
+        int capacity = fCapacity ? fCapacity : kGroupWidth;
+        if (16 * (fCount + 1) > 7 * capacity) {
+            capacity *= 2;
+        }
+
+        const int oldCapacity = fCapacity;
+        SkAutoTMalloc<int8_t> oldCtrl = std::move(fCtrl);
+        SkAutoTMalloc<T> oldSlots = std::move(fSlots);
+
+        fCapacity = capacity;
+        fCtrl.reset(capacity + kGroupWidth);
+        memset(fCtrl.get(), kEmpty, capacity + kGroupWidth);
+        fSlots.reset(capacity);
+        fCount = 0;
+        fGrowthLeft = capacity - capacity / 8;
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (IsFull(oldCtrl[i])) {
+                this->uncheckedInsert(std::move(oldSlots[i]));
+                oldSlots[i].~T();
+            }
+        }
+    }
+
+    int                   fCount      = 0,
+                          fGrowthLeft = 0,  // empty slots we may still fill before growing
+                          fCapacity   = 0;
+    SkAutoTMalloc<int8_t> fCtrl;            // fCapacity + kGroupWidth control bytes
+    SkAutoTMalloc<T>      fSlots;           // uninitialized unless the control byte is full
+
+    SkTFlatHashTable(const SkTFlatHashTable&) = delete;
+    SkTFlatHashTable& operator=(const SkTFlatHashTable&) = delete;
+};
+
+#endif
@@ -19,14 +19,29 @@ void SkTaskGroup::add(std::function<void(void)> fn) {
 }
 
 void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
-    // TODO: I really thought we had some sort of more clever chunking logic.
+    if (N <= 0) {
+        return;
+    }
+
     fPending.fetch_add(+N, std::memory_order_relaxed);
-    for (int i = 0; i < N; i++) {
-        fExecutor.add([=] {
-            fn(i);
-            fPending.fetch_add(-1, std::memory_order_release);
-        });
+    auto shared_fn = std::make_shared<const std::function<void(int)>>(std::move(fn));
+    fExecutor.add([=] { this->runBatch(0, N, shared_fn); });
+}
+
+void SkTaskGroup::runBatch(int start, int end,
+                           const std::shared_ptr<const std::function<void(int)>>& fn) {
+    // Hand off the lower half of the range until we're left with a single call.  The calling
+    // thread only adds one task however large the batch, and the halves added first (the largest)
+    // are the first to be stolen by idle threads.  An executor which runs work right away still
+    // calls fn in order.
+    while (end - start > 1) {
+        const int mid = start + (end - start) / 2;
+        fExecutor.add([=] { this->runBatch(start, mid, fn); });
+        start = mid;
     }
+
+    (*fn)(start);
+    fPending.fetch_add(-1, std::memory_order_release);
 }
 
 bool SkTaskGroup::done() const {
@@ -43,9 +58,77 @@ void SkTaskGroup::wait() {
     }
 }
 
+void SkParallelFor(int N, int grain, const std::function<void(int, int)>& fn,
+                   SkExecutor& executor) {
+    if (N <= 0) {
+        return;
+    }
+    SkASSERT(grain > 0);
+    if (N <= grain) {
+        fn(0, N);
+        return;
+    }
+
+    SkTaskGroup group(executor);
+    group.batch((N + grain - 1) / grain, [&](int i) {
+        const int start = i * grain;
+        fn(start, SkTMin(start + grain, N));
+    });
+    group.wait();
+}
+
+SkPipelineStages::SkPipelineStages(int maxInFlight, SkExecutor& executor)
+    : fMaxInFlight(SkTMax(maxInFlight, 1))
+    , fExecutor(executor) {}
+
+void SkPipelineStages::addStage(std::function<void(int)> stage) {
+    fStages.push_back(std::move(stage));
+}
+
+void SkPipelineStages::run(int N) {
+    const int stages = fStages.count();
+    if (N <= 0 || 0 == stages) {
+        return;
+    }
+
+    // done[s] counts the items stage s has finished, and busy[s] is set while it runs one.
+    // Only this thread starts stages, so a stage it sees idle stays idle until it starts it again.
+    std::unique_ptr<std::atomic<int>[]>  done(new std::atomic<int>[stages]);
+    std::unique_ptr<std::atomic<bool>[]> busy(new std::atomic<bool>[stages]);
+    for (int s = 0; s < stages; s++) {
+        done[s].store(0, std::memory_order_relaxed);
+        busy[s].store(false, std::memory_order_relaxed);
+    }
+
+    SkTaskGroup group(fExecutor);
+    while (done[stages - 1].load(std::memory_order_acquire) < N) {
+        // Back to front, so that finishing items takes priority over starting new ones.
+        for (int s = stages - 1; s >= 0; s--) {
+            if (busy[s].load(std::memory_order_acquire)) {
+                continue;
+            }
+            const int item = done[s].load(std::memory_order_relaxed);
+            const int ready = s > 0
+                    ? done[s - 1].load(std::memory_order_acquire)
+                    : done[stages - 1].load(std::memory_order_acquire) + fMaxInFlight;
+            if (item < SkTMin(ready, N)) {
+                busy[s].store(true, std::memory_order_relaxed);
+                group.add([&, s, item] {
+                    fStages[s](item);
+                    done[s].store(item + 1, std::memory_order_release);
+                    busy[s].store(false, std::memory_order_release);
+                });
+            }
+        }
+        // Like wait(), help out rather than block while the stages run.
+        fExecutor.borrow();
+    }
+    group.wait();
+}
+
 SkTaskGroup::Enabler::Enabler(int threads) {
     if (threads) {
-        fThreadPool = SkExecutor::MakeLIFOThreadPool(threads);
+        fThreadPool = SkExecutor::MakeWorkStealingThreadPool(threads);
         SkExecutor::SetDefault(fThreadPool.get());
     }
 }
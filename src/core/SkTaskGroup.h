@@ -10,9 +10,11 @@
 
 #include "SkExecutor.h"
 #include "SkNoncopyable.h"
+#include "SkTArray.h"
 #include "SkTypes.h"
 #include <atomic>
 #include <functional>
+#include <memory>
 
 class SkTaskGroup : SkNoncopyable {
 public:
@@ -24,6 +26,7 @@ public:
     void add(std::function<void(void)> fn);
 
     // Add a batch of N tasks, all calling fn with different arguments.
+    // The range is split recursively, by the tasks themselves.
     void batch(int N, std::function<void(int)> fn);
 
     // Returns true if all Tasks previously add()ed to this SkTaskGroup have run.
@@ -41,8 +44,36 @@ public:
     };
 
 private:
+    void runBatch(int start, int end, const std::shared_ptr<const std::function<void(int)>>&);
+
     std::atomic<int32_t> fPending;
     SkExecutor&          fExecutor;
 };
 
+// Calls fn(start, end) on consecutive ranges of at most grain indices covering [0, N), in parallel
+// on executor, and returns once they have all run.  If N fits in a single grain, fn runs right
+// away on the calling thread.
+void SkParallelFor(int N, int grain, const std::function<void(int start, int end)>& fn,
+                   SkExecutor& executor = SkExecutor::GetDefault());
+
+// Runs items through a series of stages, e.g. decode -> swizzle, or encode -> deflate.  Each stage
+// sees the items one at a time and in order, while different stages work on different items
+// concurrently.  No more than maxInFlight items are ever between starting the first stage and
+// finishing the last, so buffers passed from stage to stage can be indexed by item % maxInFlight.
+class SkPipelineStages : SkNoncopyable {
+public:
+    explicit SkPipelineStages(int maxInFlight, SkExecutor& executor = SkExecutor::GetDefault());
+
+    // Stages run in the order they are added.
+    void addStage(std::function<void(int item)> stage);
+
+    // Runs items [0, N) through every stage, and returns once the last stage has run them all.
+    void run(int N);
+
+private:
+    SkTArray<std::function<void(int)>> fStages;
+    const int                          fMaxInFlight;
+    SkExecutor&                        fExecutor;
+};
+
 #endif//SkTaskGroup_DEFINED
@@ -226,12 +226,7 @@ private:
 // (paint->getFlags() & ~kFlagsMask) | fFlags
 inline SkPaint::SkPaint(const SkPaint& basePaint, const SkRunFont& runFont)
         : fTypeface{runFont.fTypeface}
-        , fPathEffect{basePaint.fPathEffect}
-        , fShader{basePaint.fShader}
-        , fMaskFilter{basePaint.fMaskFilter}
-        , fColorFilter{basePaint.fColorFilter}
-        , fDrawLooper{basePaint.fDrawLooper}
-        , fImageFilter{basePaint.fImageFilter}
+        , fEffects{basePaint.fEffects}
         , fTextSize{runFont.fSize}
         , fTextScaleX{runFont.fScaleX}
         , fTextSkewX{runFont.fSkewX}
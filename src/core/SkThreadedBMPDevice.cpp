@@ -0,0 +1,335 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkBlitter.h"
+#include "SkDraw.h"
+#include "SkExecutor.h"
+#include "SkMakeUnique.h"
+#include "SkPaint.h"
+#include "SkImage.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkRSXform.h"
+#include "SkRectPriv.h"
+#include "SkSpecialImage.h"
+#include "SkTaskGroup.h"
+#include "SkVertices.h"
+
+// A tile is a horizontal band of rows, so two tiles never touch the same row of the coverage
+// deltas (SkCoverageDeltaList sorts its rows lazily while blitting).
+static constexpr int kMinTileHeight = 64;
+static constexpr int kMaxTiles = 128;
+
+// Small paths are cheaper to scan convert per tile than to init-once and share.
+static constexpr int kMinVerbsForInitOnce = 4;
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap, int tiles, SkExecutor* executor)
+    : INHERITED(bitmap)
+    , fExecutor(executor ? executor : &SkExecutor::GetDefault()) {
+    this->init(tiles);
+}
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& props,
+                                         int tiles, SkExecutor* executor)
+    : INHERITED(bitmap, props, nullptr, nullptr)
+    , fExecutor(executor ? executor : &SkExecutor::GetDefault()) {
+    this->init(tiles);
+}
+
+SkThreadedBMPDevice::~SkThreadedBMPDevice() {
+    this->flush();
+}
+
+void SkThreadedBMPDevice::init(int tiles) {
+    if (tiles <= 0) {
+        tiles = this->height() / kMinTileHeight;
+    }
+    fTileCnt = SkTPin(SkTMin(tiles, this->height()), 1, kMaxTiles);
+}
+
+SkIRect SkThreadedBMPDevice::tileBounds(int tile) const {
+    SkASSERT(tile >= 0 && tile < fTileCnt);
+    int h = this->height();
+    return SkIRect::MakeLTRB(0, h * tile / fTileCnt, this->width(), h * (tile + 1) / fTileCnt);
+}
+
+SkIRect SkThreadedBMPDevice::transformDrawBounds(const SkRect* localBounds) const {
+    const SkIRect& clipBounds = fRCStack.rc().getBounds();
+    if (!localBounds) {
+        return clipBounds;
+    }
+
+    SkRect devBounds;
+    this->ctm().mapRect(&devBounds, *localBounds);
+    if (!devBounds.isFinite()) {
+        return clipBounds;
+    }
+    // outset for anti-aliasing and hairlines
+    devBounds.outset(1, 1);
+
+    SkIRect drawBounds = devBounds.roundOut();
+    if (!drawBounds.intersect(clipBounds)) {
+        return SkIRect::MakeEmpty();
+    }
+    return drawBounds;
+}
+
+void SkThreadedBMPDevice::push(const SkIRect& drawBounds, DrawFn drawFn, DrawFn initFn) {
+    const SkRasterClip& rc = fRCStack.rc();
+    if (rc.isEmpty() || drawBounds.isEmpty()) {
+        return;
+    }
+
+    DrawElement& elem = fQueue.emplace_back(drawBounds, this->ctm(), rc,
+                                            std::move(drawFn), std::move(initFn));
+    if (elem.fInitFn) {
+        elem.fAlloc = skstd::make_unique<SkArenaAlloc>(0);
+        elem.fDAARecord = elem.fAlloc->make<SkDAARecord>(elem.fAlloc.get());
+    }
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (fQueue.empty()) {
+        return;
+    }
+
+    SkPixmap dst;
+    if (!this->INHERITED::onPeekPixels(&dst)) {
+        fQueue.reset();
+        return;
+    }
+
+    SkTaskGroup group(*fExecutor);
+
+    // Init-once: compute the coverage of the shared draws, out of order, against their full clip.
+    group.batch(fQueue.count(), [this, &dst](int i) {
+        DrawElement& elem = fQueue[i];
+        if (!elem.fInitFn) {
+            return;
+        }
+        SkDraw draw;
+        draw.fDst = dst;
+        draw.fMatrix = &elem.fMatrix;
+        draw.fRC = &elem.fRC;
+        draw.fDAARecord = elem.fDAARecord;
+        elem.fInitFn(draw);
+
+        // If nothing got computed (e.g. the draw was rejected or turned into a hairline), the
+        // tiles have to scan convert on their own.
+        if (elem.fDAARecord->fType != SkDAARecord::Type::kMask &&
+            elem.fDAARecord->fType != SkDAARecord::Type::kList) {
+            elem.fDAARecord = nullptr;
+        }
+    });
+    group.wait();
+
+    // Draw: each tile replays, in order, the draws that touch it.
+    group.batch(fTileCnt, [this, &dst](int tile) {
+        const SkIRect tileBounds = this->tileBounds(tile);
+        for (int i = 0; i < fQueue.count(); ++i) {
+            const DrawElement& elem = fQueue[i];
+            if (!SkIRect::Intersects(elem.fDrawBounds, tileBounds)) {
+                continue;
+            }
+            SkRasterClip tileRC(elem.fRC);
+            if (!tileRC.op(tileBounds, SkRegion::kIntersect_Op)) {
+                continue;
+            }
+            SkDraw draw;
+            draw.fDst = dst;
+            draw.fMatrix = &elem.fMatrix;
+            draw.fRC = &tileRC;
+            draw.fDAARecord = elem.fDAARecord;
+            elem.fDrawFn(draw);
+        }
+    });
+    group.wait();
+
+    fQueue.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkRect get_fast_bounds(const SkRect& r, const SkPaint& paint) {
+    SkRect storage;
+    return paint.canComputeFastBounds() ? paint.computeFastBounds(r, &storage)
+                                        : SkRectPriv::MakeLargest();
+}
+
+void SkThreadedBMPDevice::drawPaint(const SkPaint& paint) {
+    this->push(this->transformDrawBounds(nullptr), [=](const SkDraw& draw) {
+        draw.drawPaint(paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    SkTArray<SkPoint> points(pts, SkToInt(count));
+    SkRect bounds;
+    bounds.setBounds(pts, SkToInt(count));
+    SkRect storage;
+    const SkRect* boundsPtr = nullptr;
+    if (paint.canComputeFastBounds()) {
+        bounds = paint.computeFastStrokeBounds(bounds, &storage);
+        boundsPtr = &bounds;
+    }
+    this->push(this->transformDrawBounds(boundsPtr), [=](const SkDraw& draw) {
+        draw.drawPoints(mode, count, points.begin(), paint, nullptr);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    SkRect bounds = get_fast_bounds(r, paint);
+    this->push(this->transformDrawBounds(&bounds), [=](const SkDraw& draw) {
+        draw.drawRect(r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+#ifdef SK_IGNORE_BLURRED_RRECT_OPT
+    SkPath path;
+    path.addRRect(rrect);
+    this->drawPath(path, paint, true);
+#else
+    SkRect bounds = get_fast_bounds(rrect.getBounds(), paint);
+    this->push(this->transformDrawBounds(&bounds), [=](const SkDraw& draw) {
+        draw.drawRRect(rrect, paint);
+    });
+#endif
+}
+
+void SkThreadedBMPDevice::drawPath(const SkPath& path, const SkPaint& paint, bool) {
+    SkRect bounds;
+    const SkRect* boundsPtr = nullptr;
+    if (!path.isInverseFillType()) {
+        bounds = get_fast_bounds(path.getBounds(), paint);
+        boundsPtr = &bounds;
+    }
+
+    DrawFn drawFn = [=](const SkDraw& draw) {
+        draw.drawPath(path, paint, nullptr, false);
+    };
+
+#if !defined(SK_DISABLE_DAA)
+    // Mask filters draw through their own masks, so only plain anti-aliased draws can share the
+    // coverage computed once.
+    if (paint.isAntiAlias() && !paint.getMaskFilter() &&
+        path.countVerbs() >= kMinVerbsForInitOnce) {
+        DrawFn initFn = [=](const SkDraw& draw) {
+            SkNullBlitter nullBlitter;
+            draw.drawPath(path, paint, nullptr, false, false, &nullBlitter);
+        };
+        this->push(this->transformDrawBounds(boundsPtr), std::move(drawFn), std::move(initFn));
+        return;
+    }
+#endif
+
+    this->push(this->transformDrawBounds(boundsPtr), std::move(drawFn));
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& paint) {
+    // drawSprite ignores the ctm, so its bounds are already in device space
+    SkIRect drawBounds = SkIRect::MakeXYWH(x, y, bitmap.width(), bitmap.height());
+    if (!drawBounds.intersect(fRCStack.rc().getBounds())) {
+        return;
+    }
+    this->push(drawBounds, [=](const SkDraw& draw) {
+        draw.drawSprite(bitmap, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
+                                     const SkRect* dstOrNull, const SkPaint& paint) {
+    SkRect storage;
+    matrix.mapRect(&storage, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
+    SkRect bounds = get_fast_bounds(dstOrNull ? *dstOrNull : storage, paint);
+
+    bool hasDst = dstOrNull != nullptr;
+    SkRect dst = hasDst ? *dstOrNull : SkRect::MakeEmpty();
+    this->push(this->transformDrawBounds(&bounds), [=](const SkDraw& draw) {
+        draw.drawBitmap(bitmap, matrix, hasDst ? &dst : nullptr, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkVertices* vertices, const SkVertices::Bone bones[],
+                                       int boneCount, SkBlendMode bmode, const SkPaint& paint) {
+    sk_sp<const SkVertices> verts = sk_ref_sp(vertices);
+    SkTArray<SkVertices::Bone> boneArray(bones, boneCount);
+    // Bones can move the vertices anywhere, so only trust the bounds without them.
+    SkRect bounds = boneCount ? SkRectPriv::MakeLargest() : vertices->bounds();
+    this->push(this->transformDrawBounds(&bounds), [=](const SkDraw& draw) {
+        draw.drawVertices(verts->mode(), verts->vertexCount(), verts->positions(),
+                          verts->texCoords(), verts->colors(), verts->boneIndices(),
+                          verts->boneWeights(), bmode, verts->indices(), verts->indexCount(),
+                          paint, boneArray.begin(), boneArray.count());
+    });
+}
+
+void SkThreadedBMPDevice::drawAtlas(const SkImage* atlas, const SkRSXform xform[],
+                                    const SkRect tex[], const SkColor colors[], int count,
+                                    SkBlendMode bmode, const SkPaint& paint) {
+    sk_sp<const SkImage> image = sk_ref_sp(atlas);
+    SkTArray<SkRSXform> xformArray(xform, count);
+    SkTArray<SkRect> texArray(tex, count);
+    SkTArray<SkColor> colorArray(colors, colors ? count : 0);
+    SkRect bounds = SkRect::MakeEmpty();
+    for (int i = 0; i < count; ++i) {
+        SkPoint quad[4];
+        xform[i].toQuad(tex[i].width(), tex[i].height(), quad);
+        SkRect spriteBounds;
+        spriteBounds.set(quad, 4);
+        bounds.join(spriteBounds);
+    }
+    this->push(this->transformDrawBounds(&bounds), [=](const SkDraw& draw) {
+        draw.drawAtlas(image.get(), xformArray.begin(), texArray.begin(),
+                       colorArray.empty() ? nullptr : colorArray.begin(), count, bmode, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawGlyphRunList(const SkGlyphRunList& glyphRunList) {
+    this->flush();
+    this->INHERITED::drawGlyphRunList(glyphRunList);
+}
+
+void SkThreadedBMPDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& paint) {
+    device->flush();
+    this->flush();
+    this->INHERITED::drawDevice(device, x, y, paint);
+}
+
+void SkThreadedBMPDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPaint& paint,
+                                      SkImage* clipImage, const SkMatrix& clipMatrix) {
+    this->flush();
+    this->INHERITED::drawSpecial(src, x, y, paint, clipImage, clipMatrix);
+}
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    this->flush();
+    return this->INHERITED::snapSpecial();
+}
+
+bool SkThreadedBMPDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return this->INHERITED::onReadPixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return this->INHERITED::onWritePixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flush();
+    return this->INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flush();
+    return this->INHERITED::onAccessPixels(pmap);
+}
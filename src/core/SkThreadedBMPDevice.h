@@ -0,0 +1,119 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkArenaAlloc.h"
+#include "SkBitmapDevice.h"
+#include "SkCoverageDelta.h"
+#include "SkRasterClip.h"
+#include "SkTArray.h"
+
+#include <functional>
+#include <memory>
+
+class SkDraw;
+class SkExecutor;
+
+/**
+ *  A raster device that defers its draws and replays them in parallel, one horizontal tile per
+ *  task, on an SkExecutor (SkExecutor::GetDefault() unless one is provided).
+ *
+ *  Each recorded draw keeps a copy of its matrix and clip. On flush(), anti-aliased path fills
+ *  first compute their coverage once (in parallel across draws) into an SkDAARecord; then every
+ *  tile replays the draws that intersect it, in order, blitting the shared coverage clipped to
+ *  the tile. Tiles never share a row of pixels, so they can be drawn concurrently.
+ *
+ *  Anything that reads the pixels (readPixels, peekPixels, snapshots, drawing this device into
+ *  another one) flushes first.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    // When tiles <= 0, we pick a tile count based on the bitmap's height.
+    // When executor is nullptr, we use SkExecutor::GetDefault().
+    SkThreadedBMPDevice(const SkBitmap& bitmap, int tiles = 0, SkExecutor* executor = nullptr);
+    SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
+                        int tiles = 0, SkExecutor* executor = nullptr);
+    ~SkThreadedBMPDevice() override;
+
+    int tileCount() const { return fTileCnt; }
+
+    void flush() override;
+
+protected:
+    void drawPaint(const SkPaint& paint) override;
+    void drawPoints(SkCanvas::PointMode mode, size_t count,
+                    const SkPoint[], const SkPaint& paint) override;
+    void drawRect(const SkRect& r, const SkPaint& paint) override;
+    void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
+    void drawPath(const SkPath&, const SkPaint&, bool pathIsMutable) override;
+    void drawSprite(const SkBitmap&, int x, int y, const SkPaint&) override;
+    void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
+                    const SkPaint&) override;
+    void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount, SkBlendMode,
+                      const SkPaint& paint) override;
+    void drawAtlas(const SkImage*, const SkRSXform[], const SkRect[], const SkColor[], int count,
+                   SkBlendMode, const SkPaint&) override;
+
+    // These draws either reference memory we don't own or read other devices, so they flush and
+    // then draw directly.
+    void drawGlyphRunList(const SkGlyphRunList& glyphRunList) override;
+    void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
+    void drawSpecial(SkSpecialImage*, int x, int y, const SkPaint&,
+                     SkImage*, const SkMatrix&) override;
+
+    sk_sp<SkSpecialImage> snapSpecial() override;
+
+    bool onReadPixels(const SkPixmap&, int x, int y) override;
+    bool onWritePixels(const SkPixmap&, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+private:
+    using DrawFn = std::function<void(const SkDraw&)>;
+
+    struct DrawElement {
+        DrawElement(const SkIRect& drawBounds, const SkMatrix& matrix, const SkRasterClip& rc,
+                    DrawFn drawFn, DrawFn initFn)
+            : fDrawBounds(drawBounds)
+            , fMatrix(matrix)
+            , fRC(rc)
+            , fDrawFn(std::move(drawFn))
+            , fInitFn(std::move(initFn))
+            , fDAARecord(nullptr) {}
+
+        SkIRect                       fDrawBounds;  // device space, already clipped
+        SkMatrix                      fMatrix;
+        SkRasterClip                  fRC;
+        DrawFn                        fDrawFn;
+
+        // Only set for draws whose coverage is computed once and shared by all tiles.
+        DrawFn                        fInitFn;
+        std::unique_ptr<SkArenaAlloc> fAlloc;
+        SkDAARecord*                  fDAARecord;
+    };
+
+    void init(int tiles);
+
+    // Returns the device-space bounds of a draw, clipped to the current clip. A null localBounds
+    // means the draw may touch anything inside the clip.
+    SkIRect transformDrawBounds(const SkRect* localBounds) const;
+
+    // Records a draw touching at most drawBounds (device space, see transformDrawBounds).
+    void push(const SkIRect& drawBounds, DrawFn drawFn, DrawFn initFn = nullptr);
+
+    SkIRect tileBounds(int tile) const;
+
+    SkExecutor*            fExecutor;
+    int                    fTileCnt;
+    SkTArray<DrawElement>  fQueue;
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif // SkThreadedBMPDevice_DEFINED
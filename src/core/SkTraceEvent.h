@@ -14,6 +14,8 @@
 #include "SkEventTracer.h"
 #include "SkTraceEventCommon.h"
 
+#include <type_traits>
+
 ////////////////////////////////////////////////////////////////////////////////
 // Implementation specific tracing API definitions.
 
@@ -108,13 +110,27 @@
           reinterpret_cast<TRACE_EVENT_API_ATOMIC_WORD>(category_group_enabled)); \
     }
 
+// Categories named in SK_TRACE_COMPILED_OUT_CATEGORIES, a comma separated string literal such as
+// "skia.gpu,skia.gpu.cache", are compiled out: their trace sites never ask the tracer about them,
+// so the hottest sites can stay cheap while a tracer that records everything is installed.
+#ifndef SK_TRACE_COMPILED_OUT_CATEGORIES
+    #define SK_TRACE_COMPILED_OUT_CATEGORIES ""
+#endif
+
+#define INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_OUT(category_group) \
+    std::integral_constant<bool, skia::tracing_internals::CategoryInList( \
+        category_group, SK_TRACE_COMPILED_OUT_CATEGORIES)>::value
+
 #define INTERNAL_TRACE_EVENT_GET_CATEGORY_INFO(category_group) \
     static TRACE_EVENT_API_ATOMIC_WORD INTERNAL_TRACE_EVENT_UID(atomic) = 0; \
-    const uint8_t* INTERNAL_TRACE_EVENT_UID(category_group_enabled); \
-    INTERNAL_TRACE_EVENT_GET_CATEGORY_INFO_CUSTOM_VARIABLES( \
-        TRACE_CATEGORY_PREFIX category_group, \
-        INTERNAL_TRACE_EVENT_UID(atomic), \
-        INTERNAL_TRACE_EVENT_UID(category_group_enabled));
+    const uint8_t* INTERNAL_TRACE_EVENT_UID(category_group_enabled) = \
+        &skia::tracing_internals::kCompiledOutCategoryEnabled; \
+    if (!INTERNAL_TRACE_EVENT_CATEGORY_COMPILED_OUT(category_group)) { \
+        INTERNAL_TRACE_EVENT_GET_CATEGORY_INFO_CUSTOM_VARIABLES( \
+            TRACE_CATEGORY_PREFIX category_group, \
+            INTERNAL_TRACE_EVENT_UID(atomic), \
+            INTERNAL_TRACE_EVENT_UID(category_group_enabled)); \
+    }
 
 // Implementation detail: internal macro to create static category and add
 // event if the category is enabled.
@@ -169,6 +185,29 @@ namespace tracing_internals {
 const int kZeroNumArgs = 0;
 const uint64_t kNoEventId = 0;
 
+// The enabled flag of every compiled out category.
+static constexpr uint8_t kCompiledOutCategoryEnabled = 0;
+
+// Is category one of the names in the comma separated list?
+constexpr bool CategoryInList(const char* category, const char* list) {
+    while (*list) {
+        int i = 0;
+        while (category[i] && category[i] == list[i]) {
+            ++i;
+        }
+        if (!category[i] && (!list[i] || ',' == list[i])) {
+            return true;
+        }
+        while (*list && ',' != *list) {
+            ++list;
+        }
+        if (*list) {
+            ++list;
+        }
+    }
+    return false;
+}
+
 // TraceID encapsulates an ID that can either be an integer or pointer. Pointers
 // are by default mangled with the Process ID so that they are unlikely to
 // collide when the same pointer is used on different processes.
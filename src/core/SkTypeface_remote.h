@@ -100,7 +100,8 @@ protected:
         return 0;
     }
     size_t onGetTableData(SkFontTableTag, size_t offset, size_t length, void* data) const override {
-        SK_ABORT("Should never be called.");
+        // Used by SkStrikeCache to key persistent strikes. Proxies have no tables, so their
+        // strikes are never persisted.
         return 0;
     }
     SkScalerContext* onCreateScalerContext(const SkScalerContextEffects& effects,
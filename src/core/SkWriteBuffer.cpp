@@ -236,8 +236,9 @@ void SkBinaryWriteBuffer::writeFlattenable(const SkFlattenable* flattenable) {
         } else {
             const char* name = flattenable->getTypeName();
             SkASSERT(name);
-            SkString key(name);
-            if (uint32_t* indexPtr = fFlattenableDict.find(key)) {
+            // Type names are string literals, so the pointer is enough to find them again. At
+            // worst, the same name at two addresses gets written out twice.
+            if (uint32_t* indexPtr = fFlattenableDict.find(name)) {
                 // We will write the index as a 32-bit int.  We want the first byte
                 // that we send to be zero - this will act as a sentinel that we
                 // have an index (not a string).  This means that we will send the
@@ -253,7 +254,7 @@ void SkBinaryWriteBuffer::writeFlattenable(const SkFlattenable* flattenable) {
                 this->writeString(name);
 
                 // Add key to dictionary.
-                fFlattenableDict.set(key, fFlattenableDict.count() + 1);
+                fFlattenableDict.set(name, fFlattenableDict.count() + 1);
             }
         }
     }
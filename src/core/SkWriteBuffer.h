@@ -134,8 +134,9 @@ private:
 
     SkWriter32 fWriter;
 
-    // Only used if we do not have an fFactorySet
-    SkTHashMap<SkString, uint32_t> fFlattenableDict;
+    // Only used if we do not have an fFactorySet. Maps type names, by address, to their base-1
+    // index in the order they were written.
+    SkTHashMap<const char*, uint32_t> fFlattenableDict;
 };
 
 #endif // SkWriteBuffer_DEFINED
@@ -10,6 +10,7 @@
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkPathMeasure.h"
+#include "SkPathMeasurePriv.h"
 #include "SkStrokeRec.h"
 
 // Since we are stepping by a float, the do/while loop might go on forever (or nearly so).
@@ -18,7 +19,8 @@
 
 bool Sk1DPathEffect::onFilterPath(SkPath* dst, const SkPath& src,
                                   SkStrokeRec*, const SkRect*) const {
-    SkPathMeasure   meas(src, false);
+    SkPathMeasure   meas;
+    SkPathMeasurePriv::SetPathCached(&meas, src, false, 1);
     do {
         int governor = MAX_REASONABLE_ITERATIONS;
         SkScalar    length = meas.getLength();
@@ -6,6 +6,7 @@
  */
 
 #include "SkPathMeasure.h"
+#include "SkPathMeasurePriv.h"
 #include "SkTrimPathEffect.h"
 #include "SkTrimPE.h"
 #include "SkReadBuffer.h"
@@ -16,8 +17,9 @@ namespace {
 class Segmentator : public SkNoncopyable {
 public:
     Segmentator(const SkPath& src, SkPath* dst)
-        : fMeasure(src, false)
-        , fDst(dst) {}
+        : fDst(dst) {
+        SkPathMeasurePriv::SetPathCached(&fMeasure, src, false, 1);
+    }
 
     void add(SkScalar start, SkScalar stop) {
         SkASSERT(start < stop);
@@ -62,7 +64,9 @@ bool SkTrimPE::onFilterPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
 
     // First pass: compute the total len.
     SkScalar len = 0;
-    SkPathMeasure meas(src, false);
+    // Animated trims measure the same path every frame.
+    SkPathMeasure meas;
+    SkPathMeasurePriv::SetPathCached(&meas, src, false, 1);
     do {
         len += meas.getLength();
     } while (meas.nextContour());
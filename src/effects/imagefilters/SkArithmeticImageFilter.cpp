@@ -7,6 +7,7 @@
 
 #include "SkArithmeticImageFilter.h"
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkColorSpaceXformer.h"
 #include "SkImageFilterPriv.h"
 #include "SkNx.h"
@@ -64,8 +65,10 @@ protected:
     sk_sp<SkSpecialImage> filterImageGPU(SkSpecialImage* source,
                                          sk_sp<SkSpecialImage> background,
                                          const SkIPoint& backgroundOffset,
+                                         SkColorFilter* backgroundColorFilter,
                                          sk_sp<SkSpecialImage> foreground,
                                          const SkIPoint& foregroundOffset,
+                                         SkColorFilter* foregroundColorFilter,
                                          const SkIRect& bounds,
                                          const OutputProperties& outputProperties) const;
 #endif
@@ -165,11 +168,22 @@ static bool intersect(SkPixmap* dst, SkPixmap* src, int srcDx, int srcDy) {
 sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(SkSpecialImage* source,
                                                                const Context& ctx,
                                                                SkIPoint* offset) const {
+    // Inputs that are just color filters are applied as the inputs are drawn. The raster
+    // foreground is read straight from its pixels, so it needs its color filter applied already.
     SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
+    sk_sp<SkColorFilter> backgroundCF;
+    sk_sp<SkSpecialImage> background(this->filterInputDeferringColorFilter(
+            0, source, ctx, &backgroundOffset, &backgroundCF));
 
     SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    sk_sp<SkColorFilter> foregroundCF;
+    sk_sp<SkSpecialImage> foreground;
+    if (source->isTextureBacked()) {
+        foreground = this->filterInputDeferringColorFilter(1, source, ctx, &foregroundOffset,
+                                                           &foregroundCF);
+    } else {
+        foreground = this->filterInput(1, source, ctx, &foregroundOffset);
+    }
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
@@ -198,8 +212,9 @@ sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(SkSpecialImage* s
 
 #if SK_SUPPORT_GPU
     if (source->isTextureBacked()) {
-        return this->filterImageGPU(source, background, backgroundOffset, foreground,
-                                    foregroundOffset, bounds, ctx.outputProperties());
+        return this->filterImageGPU(source, background, backgroundOffset, backgroundCF.get(),
+                                    foreground, foregroundOffset, foregroundCF.get(), bounds,
+                                    ctx.outputProperties());
     }
 #endif
 
@@ -217,6 +232,7 @@ sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(SkSpecialImage* s
     if (background) {
         SkPaint paint;
         paint.setBlendMode(SkBlendMode::kSrc);
+        paint.setColorFilter(std::move(backgroundCF));
         background->draw(canvas, SkIntToScalar(backgroundOffset.fX),
                          SkIntToScalar(backgroundOffset.fY), &paint);
     }
@@ -286,8 +302,10 @@ sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::filterImageGPU(
         SkSpecialImage* source,
         sk_sp<SkSpecialImage> background,
         const SkIPoint& backgroundOffset,
+        SkColorFilter* backgroundColorFilter,
         sk_sp<SkSpecialImage> foreground,
         const SkIPoint& foregroundOffset,
+        SkColorFilter* foregroundColorFilter,
         const SkIRect& bounds,
         const OutputProperties& outputProperties) const {
     SkASSERT(source->isTextureBacked());
@@ -317,6 +335,11 @@ sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::filterImageGPU(
         bgFP = GrColorSpaceXformEffect::Make(std::move(bgFP), background->getColorSpace(),
                                              background->alphaType(),
                                              outputProperties.colorSpace());
+        bgFP = MakeColorFilteredFP(context, std::move(bgFP), backgroundColorFilter,
+                                   outputProperties);
+        if (!bgFP) {
+            return nullptr;
+        }
     } else {
         bgFP = GrConstColorProcessor::Make(SK_PMColor4fTRANSPARENT,
                                            GrConstColorProcessor::InputMode::kIgnore);
@@ -333,6 +356,11 @@ sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::filterImageGPU(
                                                      foreground->getColorSpace(),
                                                      foreground->alphaType(),
                                                      outputProperties.colorSpace());
+        foregroundFP = MakeColorFilteredFP(context, std::move(foregroundFP),
+                                           foregroundColorFilter, outputProperties);
+        if (!foregroundFP) {
+            return nullptr;
+        }
         paint.addColorFragmentProcessor(std::move(foregroundFP));
 
         static int arithmeticIndex = GrSkSLFP::NewIndex();
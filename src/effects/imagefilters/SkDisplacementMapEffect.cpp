@@ -13,6 +13,7 @@
 #include "SkImageFilterPriv.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
+#include "SkTaskGroup.h"
 #include "SkWriteBuffer.h"
 #include "SkUnPreMultiply.h"
 #include "SkColorData.h"
@@ -52,23 +53,17 @@ struct Extractor {
 
     unsigned fShiftX, fShiftY;
 
-    unsigned getX(SkPMColor c) const { return (c >> fShiftX) & 0xFF; }
-    unsigned getY(SkPMColor c) const { return (c >> fShiftY) & 0xFF; }
-};
+    // The unpremultiplied channels, unpremultiplying only the two that are used. The scale is
+    // exact for opaque pixels and zero for transparent ones.
+    unsigned getX(SkPMColor c, unsigned scale) const { return get(c, fShiftX, scale); }
+    unsigned getY(SkPMColor c, unsigned scale) const { return get(c, fShiftY, scale); }
 
-static SkPMColor unpremul_pm(SkPMColor c) {
-    const U8CPU a = SkGetPackedA32(c);
-    if (0 == a) {
-        return 0;
-    } else if (0xFF == a) {
-        return c;
+private:
+    static unsigned get(SkPMColor c, unsigned shift, unsigned scale) {
+        const unsigned channel = (c >> shift) & 0xFF;
+        return shift == SK_A32_SHIFT ? channel : SkUnPreMultiply::ApplyScale(scale, channel);
     }
-    const unsigned scale = SkUnPreMultiply::GetScale(a);
-    return SkPackARGB32NoCheck(a,
-                               SkUnPreMultiply::ApplyScale(scale, SkGetPackedR32(c)),
-                               SkUnPreMultiply::ApplyScale(scale, SkGetPackedG32(c)),
-                               SkUnPreMultiply::ApplyScale(scale, SkGetPackedB32(c)));
-}
+};
 
 void computeDisplacement(Extractor ex, const SkVector& scale, SkBitmap* dst,
                          const SkBitmap& displ, const SkIPoint& offset,
@@ -80,21 +75,30 @@ void computeDisplacement(Extractor ex, const SkVector& scale, SkBitmap* dst,
     const SkVector scaleForColor = SkVector::Make(scale.fX * Inv8bit, scale.fY * Inv8bit);
     const SkVector scaleAdj = SkVector::Make(SK_ScalarHalf - scale.fX * SK_ScalarHalf,
                                              SK_ScalarHalf - scale.fY * SK_ScalarHalf);
-    SkPMColor* dstPtr = dst->getAddr32(0, 0);
-    for (int y = bounds.top(); y < bounds.bottom(); ++y) {
-        const SkPMColor* displPtr = displ.getAddr32(bounds.left() + offset.fX, y + offset.fY);
-        for (int x = bounds.left(); x < bounds.right(); ++x, ++displPtr) {
-            SkPMColor c = unpremul_pm(*displPtr);
-
-            SkScalar displX = scaleForColor.fX * ex.getX(c) + scaleAdj.fX;
-            SkScalar displY = scaleForColor.fY * ex.getY(c) + scaleAdj.fY;
-            // Truncate the displacement values
-            const int32_t srcX = Sk32_sat_add(x, SkScalarTruncToInt(displX));
-            const int32_t srcY = Sk32_sat_add(y, SkScalarTruncToInt(displY));
-            *dstPtr++ = ((srcX < 0) || (srcX >= srcW) || (srcY < 0) || (srcY >= srcH)) ?
-                      0 : *(src.getAddr32(srcX, srcY));
+    auto displaceRows = [&](int top, int bottom) {
+        for (int y = top; y < bottom; ++y) {
+            SkPMColor* dstPtr = dst->getAddr32(0, y - bounds.top());
+            const SkPMColor* displPtr = displ.getAddr32(bounds.left() + offset.fX,
+                                                        y + offset.fY);
+            for (int x = bounds.left(); x < bounds.right(); ++x, ++displPtr) {
+                const SkPMColor c = *displPtr;
+                const unsigned scale = SkUnPreMultiply::GetScale(SkGetPackedA32(c));
+
+                SkScalar displX = scaleForColor.fX * ex.getX(c, scale) + scaleAdj.fX;
+                SkScalar displY = scaleForColor.fY * ex.getY(c, scale) + scaleAdj.fY;
+                // Truncate the displacement values
+                const int32_t srcX = Sk32_sat_add(x, SkScalarTruncToInt(displX));
+                const int32_t srcY = Sk32_sat_add(y, SkScalarTruncToInt(displY));
+                *dstPtr++ = ((srcX < 0) || (srcX >= srcW) || (srcY < 0) || (srcY >= srcH)) ?
+                          0 : *(src.getAddr32(srcX, srcY));
+            }
         }
-    }
+    };
+    // Rows are independent; chunks of about 64K pixels keep small bounds on this thread.
+    SkParallelFor(bounds.height(), SkTMax(1, (1 << 16) / SkTMax(bounds.width(), 1)),
+                  [&](int start, int end) {
+                      displaceRows(bounds.top() + start, bounds.top() + end);
+                  });
 }
 
 bool channel_selector_type_is_valid(SkDisplacementMapEffect::ChannelSelectorType cst) {
@@ -14,6 +14,7 @@
 #include "SkPoint3.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 #include "SkWriteBuffer.h"
 
@@ -150,7 +151,7 @@ public:
                             const SkPoint3& lightColor) const= 0;
 };
 
-class DiffuseLightingType : public BaseLightingType {
+class DiffuseLightingType final : public BaseLightingType {
 public:
     DiffuseLightingType(SkScalar kd)
         : fKD(kd) {}
@@ -172,7 +173,7 @@ static SkScalar max_component(const SkPoint3& p) {
     return p.x() > p.y() ? (p.x() > p.z() ? p.x() : p.z()) : (p.y() > p.z() ? p.y() : p.z());
 }
 
-class SpecularLightingType : public BaseLightingType {
+class SpecularLightingType final : public BaseLightingType {
 public:
     SpecularLightingType(SkScalar ks, SkScalar shininess)
         : fKS(ks), fShininess(shininess) {}
@@ -279,9 +280,12 @@ public:
     }
 };
 
-template <class PixelFetcher>
-static void lightBitmap(const BaseLightingType& lightingType,
-                 const SkImageFilterLight* l,
+// LightingType and Light are the concrete (final) types, so the per-pixel calls below are not
+// virtual. The top and bottom rows use their own edge normals; the rows between are independent
+// and are lit in parallel.
+template <class LightingType, class Light, class PixelFetcher>
+static void lightBitmap(const LightingType& lightingType,
+                 const Light* l,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
@@ -291,8 +295,8 @@ static void lightBitmap(const BaseLightingType& lightingType,
     int bottom = bounds.bottom();
     int y = bounds.top();
     SkIRect srcBounds = src.bounds();
-    SkPMColor* dptr = dst->getAddr32(0, 0);
     {
+        SkPMColor* dptr = dst->getAddr32(0, 0);
         int x = left;
         int m[9];
         m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
@@ -317,34 +321,44 @@ static void lightBitmap(const BaseLightingType& lightingType,
                                      l->lightColor(surfaceToLight));
     }
 
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
+    auto lightRows = [&](int top, int bottom) {
+        for (int y = top; y < bottom; ++y) {
+            SkPMColor* dptr = dst->getAddr32(0, y - bounds.top());
+            int x = left;
+            int m[9];
+            m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
             m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
+            m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
             m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+            m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
             m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
+            SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+            *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
+                                         l->lightColor(surfaceToLight));
+            for (++x; x < right - 1; ++x) {
+                shiftMatrixLeft(m);
+                m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
+                m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+                m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
+                surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+                *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
+                                             l->lightColor(surfaceToLight));
+            }
+            shiftMatrixLeft(m);
             surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
+            *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
                                          l->lightColor(surfaceToLight));
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
+    };
+    const int middleRows = SkTMax(bounds.height() - 2, 0);
+    SkParallelFor(middleRows, SkTMax(1, (1 << 15) / SkTMax(bounds.width(), 1)),
+                  [&](int start, int end) {
+                      lightRows(y + 1 + start, y + 1 + end);
+                  });
+    y = SkTMax(y + 1, bottom - 1);
 
     {
+        SkPMColor* dptr = dst->getAddr32(0, y - bounds.top());
         int x = left;
         int m[9];
         m[1] = PixelFetcher::Fetch(src, x,     bottom - 2, srcBounds);
@@ -370,21 +384,6 @@ static void lightBitmap(const BaseLightingType& lightingType,
     }
 }
 
-static void lightBitmap(const BaseLightingType& lightingType,
-                 const SkImageFilterLight* light,
-                 const SkBitmap& src,
-                 SkBitmap* dst,
-                 SkScalar surfaceScale,
-                 const SkIRect& bounds) {
-    if (src.bounds().contains(bounds)) {
-        lightBitmap<UncheckedPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    } else {
-        lightBitmap<DecalPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    }
-}
-
 enum BoundaryMode {
     kTopLeft_BoundaryMode,
     kTop_BoundaryMode,
@@ -829,7 +828,7 @@ static SkColor xform_color(const SkPoint3& color, SkColorSpaceXformer* xformer)
     return xformer->apply(origColor);
 }
 
-class SkDistantLight : public SkImageFilterLight {
+class SkDistantLight final : public SkImageFilterLight {
 public:
     SkDistantLight(const SkPoint3& direction, SkColor color)
       : INHERITED(color), fDirection(direction) {
@@ -887,7 +886,7 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class SkPointLight : public SkImageFilterLight {
+class SkPointLight final : public SkImageFilterLight {
 public:
     SkPointLight(const SkPoint3& location, SkColor color)
      : INHERITED(color), fLocation(location) {}
@@ -954,7 +953,7 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class SkSpotLight : public SkImageFilterLight {
+class SkSpotLight final : public SkImageFilterLight {
 public:
     SkSpotLight(const SkPoint3& location,
                 const SkPoint3& target,
@@ -1117,6 +1116,45 @@ private:
 const SkScalar SkSpotLight::kSpecularExponentMin = 1.0f;
 const SkScalar SkSpotLight::kSpecularExponentMax = 128.0f;
 
+template <class LightingType, class Light>
+static void lightBitmap(const LightingType& lightingType,
+                 const Light* light,
+                 const SkBitmap& src,
+                 SkBitmap* dst,
+                 SkScalar surfaceScale,
+                 const SkIRect& bounds) {
+    if (src.bounds().contains(bounds)) {
+        lightBitmap<LightingType, Light, UncheckedPixelFetcher>(
+            lightingType, light, src, dst, surfaceScale, bounds);
+    } else {
+        lightBitmap<LightingType, Light, DecalPixelFetcher>(
+            lightingType, light, src, dst, surfaceScale, bounds);
+    }
+}
+
+template <class LightingType>
+static void lightBitmap(const LightingType& lightingType,
+                 const SkImageFilterLight* light,
+                 const SkBitmap& src,
+                 SkBitmap* dst,
+                 SkScalar surfaceScale,
+                 const SkIRect& bounds) {
+    switch (light->type()) {
+        case SkImageFilterLight::kDistant_LightType:
+            lightBitmap(lightingType, static_cast<const SkDistantLight*>(light),
+                        src, dst, surfaceScale, bounds);
+            break;
+        case SkImageFilterLight::kPoint_LightType:
+            lightBitmap(lightingType, static_cast<const SkPointLight*>(light),
+                        src, dst, surfaceScale, bounds);
+            break;
+        case SkImageFilterLight::kSpot_LightType:
+            lightBitmap(lightingType, static_cast<const SkSpotLight*>(light),
+                        src, dst, surfaceScale, bounds);
+            break;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkImageFilterLight::flattenLight(SkWriteBuffer& buffer) const {
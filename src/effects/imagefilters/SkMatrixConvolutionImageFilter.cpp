@@ -11,8 +11,10 @@
 #include "SkColorSpaceXformer.h"
 #include "SkFlattenablePriv.h"
 #include "SkImageFilterPriv.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
+#include "SkTaskGroup.h"
 #include "SkWriteBuffer.h"
 #include "SkRect.h"
 #include "SkUnPreMultiply.h"
@@ -183,39 +185,42 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     if (!rect.intersect(bounds)) {
         return;
     }
-    for (int y = rect.fTop; y < rect.fBottom; ++y) {
-        SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
-        for (int x = rect.fLeft; x < rect.fRight; ++x) {
-            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
-            for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
-                for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
-                    SkPMColor s = PixelFetcher::fetch(src,
-                                                      x + cx - fKernelOffset.fX,
-                                                      y + cy - fKernelOffset.fY,
-                                                      bounds);
-                    SkScalar k = fKernel[cy * fKernelSize.fWidth + cx];
-                    if (convolveAlpha) {
-                        sumA += SkGetPackedA32(s) * k;
+    // All four channels are summed at once, in the order they are packed in an SkPMColor.
+    auto filterRows = [&](int top, int bottom) {
+        for (int y = top; y < bottom; ++y) {
+            SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+            for (int x = rect.fLeft; x < rect.fRight; ++x) {
+                Sk4f sum(0);
+                for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
+                    for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
+                        SkPMColor s = PixelFetcher::fetch(src,
+                                                          x + cx - fKernelOffset.fX,
+                                                          y + cy - fKernelOffset.fY,
+                                                          bounds);
+                        sum += SkNx_cast<float>(Sk4b::Load(&s)) *
+                               fKernel[cy * fKernelSize.fWidth + cx];
                     }
-                    sumR += SkGetPackedR32(s) * k;
-                    sumG += SkGetPackedG32(s) * k;
-                    sumB += SkGetPackedB32(s) * k;
                 }
-            }
-            int a = convolveAlpha
-                  ? SkClampMax(SkScalarFloorToInt(sumA * fGain + fBias), 255)
-                  : 255;
-            int r = SkClampMax(SkScalarFloorToInt(sumR * fGain + fBias), a);
-            int g = SkClampMax(SkScalarFloorToInt(sumG * fGain + fBias), a);
-            int b = SkClampMax(SkScalarFloorToInt(sumB * fGain + fBias), a);
-            if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
-            } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
+                // Pinning before the conversion keeps huge sums from overflowing it.
+                float channels[4];
+                Sk4f::Max(0, Sk4f::Min((sum * fGain + fBias).floor(), 255)).store(channels);
+                int a = convolveAlpha ? (int)channels[SK_A32_SHIFT / 8] : 255;
+                int r = SkTMin((int)channels[SK_R32_SHIFT / 8], a);
+                int g = SkTMin((int)channels[SK_G32_SHIFT / 8], a);
+                int b = SkTMin((int)channels[SK_B32_SHIFT / 8], a);
+                if (!convolveAlpha) {
+                    a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
+                    *dptr++ = SkPreMultiplyARGB(a, r, g, b);
+                } else {
+                    *dptr++ = SkPackARGB32(a, r, g, b);
+                }
             }
         }
-    }
+    };
+    // Aim for chunks of about 64K kernel taps, so that small rects stay on this thread.
+    const int taps = rect.width() * fKernelSize.width() * fKernelSize.height();
+    SkParallelFor(rect.height(), SkTMax(1, (1 << 16) / SkTMax(taps, 1)),
+                  [&](int start, int end) { filterRows(rect.fTop + start, rect.fTop + end); });
 }
 
 template<class PixelFetcher>
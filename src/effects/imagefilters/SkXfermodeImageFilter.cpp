@@ -9,6 +9,7 @@
 #include "SkArithmeticImageFilter.h"
 #include "SkCanvas.h"
 #include "SkColorData.h"
+#include "SkColorFilter.h"
 #include "SkColorSpaceXformer.h"
 #include "SkFlattenablePriv.h"
 #include "SkImageFilterPriv.h"
@@ -49,15 +50,18 @@ protected:
     sk_sp<SkSpecialImage> filterImageGPU(SkSpecialImage* source,
                                          sk_sp<SkSpecialImage> background,
                                          const SkIPoint& backgroundOffset,
+                                         SkColorFilter* backgroundColorFilter,
                                          sk_sp<SkSpecialImage> foreground,
                                          const SkIPoint& foregroundOffset,
+                                         SkColorFilter* foregroundColorFilter,
                                          const SkIRect& bounds,
                                          const OutputProperties& outputProperties) const;
 #endif
 
     void flatten(SkWriteBuffer&) const override;
 
-    void drawForeground(SkCanvas* canvas, SkSpecialImage*, const SkIRect&) const;
+    void drawForeground(SkCanvas* canvas, SkSpecialImage*, const SkIRect&,
+                        sk_sp<SkColorFilter>) const;
 #if SK_SUPPORT_GPU
     std::unique_ptr<GrFragmentProcessor> makeFGFrag(
             std::unique_ptr<GrFragmentProcessor> bgFP) const;
@@ -114,11 +118,16 @@ void SkXfermodeImageFilter_Base::flatten(SkWriteBuffer& buffer) const {
 sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::onFilterImage(SkSpecialImage* source,
                                                                 const Context& ctx,
                                                                 SkIPoint* offset) const {
+    // Inputs that are just color filters are applied as the inputs are drawn.
     SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
+    sk_sp<SkColorFilter> backgroundCF;
+    sk_sp<SkSpecialImage> background(this->filterInputDeferringColorFilter(
+            0, source, ctx, &backgroundOffset, &backgroundCF));
 
     SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    sk_sp<SkColorFilter> foregroundCF;
+    sk_sp<SkSpecialImage> foreground(this->filterInputDeferringColorFilter(
+            1, source, ctx, &foregroundOffset, &foregroundCF));
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
@@ -148,8 +157,8 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::onFilterImage(SkSpecialImage*
 #if SK_SUPPORT_GPU
     if (source->isTextureBacked()) {
         return this->filterImageGPU(source,
-                                    background, backgroundOffset,
-                                    foreground, foregroundOffset,
+                                    background, backgroundOffset, backgroundCF.get(),
+                                    foreground, foregroundOffset, foregroundCF.get(),
                                     bounds, ctx.outputProperties());
     }
 #endif
@@ -168,12 +177,13 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::onFilterImage(SkSpecialImage*
     if (background) {
         SkPaint paint;
         paint.setBlendMode(SkBlendMode::kSrc);
+        paint.setColorFilter(std::move(backgroundCF));
         background->draw(canvas,
                          SkIntToScalar(backgroundOffset.fX), SkIntToScalar(backgroundOffset.fY),
                          &paint);
     }
 
-    this->drawForeground(canvas, foreground.get(), foregroundBounds);
+    this->drawForeground(canvas, foreground.get(), foregroundBounds, std::move(foregroundCF));
 
     return surf->makeImageSnapshot();
 }
@@ -236,11 +246,14 @@ const {
 }
 
 void SkXfermodeImageFilter_Base::drawForeground(SkCanvas* canvas, SkSpecialImage* img,
-                                                const SkIRect& fgBounds) const {
+                                                const SkIRect& fgBounds,
+                                                sk_sp<SkColorFilter> colorFilter) const {
     SkPaint paint;
     paint.setBlendMode(fMode);
     if (img) {
+        paint.setColorFilter(std::move(colorFilter));
         img->draw(canvas, SkIntToScalar(fgBounds.fLeft), SkIntToScalar(fgBounds.fTop), &paint);
+        paint.setColorFilter(nullptr);
     }
 
     SkAutoCanvasRestore acr(canvas, true);
@@ -257,8 +270,10 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::filterImageGPU(
                                                    SkSpecialImage* source,
                                                    sk_sp<SkSpecialImage> background,
                                                    const SkIPoint& backgroundOffset,
+                                                   SkColorFilter* backgroundColorFilter,
                                                    sk_sp<SkSpecialImage> foreground,
                                                    const SkIPoint& foregroundOffset,
+                                                   SkColorFilter* foregroundColorFilter,
                                                    const SkIRect& bounds,
                                                    const OutputProperties& outputProperties) const {
     SkASSERT(source->isTextureBacked());
@@ -288,6 +303,11 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::filterImageGPU(
         bgFP = GrColorSpaceXformEffect::Make(std::move(bgFP), background->getColorSpace(),
                                              background->alphaType(),
                                              outputProperties.colorSpace());
+        bgFP = MakeColorFilteredFP(context, std::move(bgFP), backgroundColorFilter,
+                                   outputProperties);
+        if (!bgFP) {
+            return nullptr;
+        }
     } else {
         bgFP = GrConstColorProcessor::Make(SK_PMColor4fTRANSPARENT,
                                            GrConstColorProcessor::InputMode::kIgnore);
@@ -304,6 +324,11 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::filterImageGPU(
                                                      foreground->getColorSpace(),
                                                      foreground->alphaType(),
                                                      outputProperties.colorSpace());
+        foregroundFP = MakeColorFilteredFP(context, std::move(foregroundFP),
+                                           foregroundColorFilter, outputProperties);
+        if (!foregroundFP) {
+            return nullptr;
+        }
         paint.addColorFragmentProcessor(std::move(foregroundFP));
 
         std::unique_ptr<GrFragmentProcessor> xferFP = this->makeFGFrag(std::move(bgFP));
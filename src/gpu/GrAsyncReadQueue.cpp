@@ -0,0 +1,161 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrAsyncReadQueue.h"
+
+#include "GrCaps.h"
+#include "GrGpu.h"
+#include "SkAutoMalloc.h"
+
+// How long checkCompletion(true) waits on a fence before giving up on its read.
+static constexpr uint64_t kWaitTimeoutNs = 10ull * 1000 * 1000 * 1000;
+
+std::unique_ptr<GrAsyncReadQueue> GrAsyncReadQueue::Make(GrGpu* gpu) {
+    if (!gpu->caps()->transferBufferSupport() || !gpu->caps()->fenceSyncSupport()) {
+        return nullptr;
+    }
+    return std::unique_ptr<GrAsyncReadQueue>(new GrAsyncReadQueue(gpu));
+}
+
+GrAsyncReadQueue::~GrAsyncReadQueue() {
+    // The GrGpu is disconnected, or its context destroyed, before we are, and either way the
+    // buffers are gone. All that's left is telling the clients.
+    this->abandon(false);
+}
+
+bool GrAsyncReadQueue::addRead(const Plane planes[], int planeCount, Callback callback) {
+    SkASSERT(planeCount > 0 && planeCount <= kMaxPlanes);
+    if (!fGpu) {
+        return false;
+    }
+
+    Read read;
+    for (int i = 0; i < planeCount; ++i) {
+        const Plane& plane = planes[i];
+        size_t rowBytes = plane.fRect.width() * GrColorTypeBytesPerPixel(plane.fColorType);
+        sk_sp<GrBuffer> buffer(fGpu->createBuffer(rowBytes * plane.fRect.height(),
+                                                  kXferGpuToCpu_GrBufferType,
+                                                  kStream_GrAccessPattern));
+        if (!buffer ||
+            !fGpu->transferPixelsFrom(plane.fSurface, plane.fRect.fLeft, plane.fRect.fTop,
+                                      plane.fRect.width(), plane.fRect.height(), plane.fColorType,
+                                      buffer.get(), 0)) {
+            return false;
+        }
+        read.fBuffers[i] = std::move(buffer);
+        read.fRowBytes[i] = rowBytes;
+        read.fHeights[i] = plane.fRect.height();
+        read.fFlipY[i] = plane.fFlipY;
+    }
+    read.fPlaneCount = planeCount;
+    read.fCallback = std::move(callback);
+    read.fFence = 0;
+    read.fSubmitted = false;
+    read.fFenced = false;
+    fReads.push_back(std::move(read));
+    return true;
+}
+
+void GrAsyncReadQueue::didSubmit() {
+    if (!fGpu) {
+        return;
+    }
+    // Fences only cover work that was submitted before them, so one per submit covers every read
+    // added since the previous one.
+    if (fReads.empty() || fReads.back().fSubmitted) {
+        return;
+    }
+    fReads.back().fFence = fGpu->insertFence();
+    fReads.back().fFenced = true;
+    for (auto iter = fReads.rbegin(); iter != fReads.rend() && !iter->fSubmitted; ++iter) {
+        iter->fSubmitted = true;
+    }
+}
+
+void GrAsyncReadQueue::checkCompletion(bool wait) {
+    if (!fGpu) {
+        return;
+    }
+    // Reads share the fence of the last read of their submit, and fences signal in order, so we
+    // can stop at the first one that hasn't.
+    while (!fReads.empty() && fReads.front().fSubmitted) {
+        auto last = fReads.begin();
+        while (!last->fFenced) {
+            ++last;
+            SkASSERT(last != fReads.end() && last->fSubmitted);
+        }
+        GrFence fence = last->fFence;
+        bool signaled = fGpu->waitFence(fence, wait ? kWaitTimeoutNs : 0);
+        if (!signaled && !wait) {
+            return;
+        }
+        fGpu->deleteFence(fence);
+
+        // Pop the reads before calling them back, in case a callback adds a read or checks again.
+        std::deque<Read> done;
+        for (auto iter = fReads.begin(); iter <= last; ++iter) {
+            done.push_back(std::move(*iter));
+        }
+        fReads.erase(fReads.begin(), last + 1);
+        for (Read& read : done) {
+            Complete(&read, signaled);
+        }
+        if (!fGpu) {
+            return;  // A callback abandoned the context.
+        }
+    }
+}
+
+void GrAsyncReadQueue::abandon(bool deleteFences) {
+    if (deleteFences && fGpu) {
+        for (const Read& read : fReads) {
+            if (read.fFenced) {
+                fGpu->deleteFence(read.fFence);
+            }
+        }
+    }
+    fGpu = nullptr;
+    std::deque<Read> reads;
+    reads.swap(fReads);
+    for (Read& read : reads) {
+        Complete(&read, false);
+    }
+}
+
+void GrAsyncReadQueue::Complete(Read* read, bool map) {
+    const void* planes[kMaxPlanes] = {};
+    size_t rowBytes[kMaxPlanes] = {};
+    SkAutoMalloc flipped[kMaxPlanes];
+    int mapped = 0;
+    for (; map && mapped < read->fPlaneCount; ++mapped) {
+        const char* data = static_cast<const char*>(read->fBuffers[mapped]->map());
+        if (!data) {
+            break;
+        }
+        planes[mapped] = data;
+        rowBytes[mapped] = read->fRowBytes[mapped];
+        if (read->fFlipY[mapped]) {
+            int height = read->fHeights[mapped];
+            char* dst = static_cast<char*>(flipped[mapped].reset(rowBytes[mapped] * height));
+            const char* src = data + rowBytes[mapped] * (height - 1);
+            for (int y = 0; y < height; ++y, dst += rowBytes[mapped], src -= rowBytes[mapped]) {
+                memcpy(dst, src, rowBytes[mapped]);
+            }
+            planes[mapped] = flipped[mapped].get();
+        }
+    }
+    if (mapped < read->fPlaneCount) {
+        // All or nothing.
+        for (int i = 0; i < kMaxPlanes; ++i) {
+            planes[i] = nullptr;
+        }
+    }
+    read->fCallback(planes, rowBytes);
+    for (int i = 0; i < mapped; ++i) {
+        read->fBuffers[i]->unmap();
+    }
+}
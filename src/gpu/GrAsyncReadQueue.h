@@ -0,0 +1,97 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrAsyncReadQueue_DEFINED
+#define GrAsyncReadQueue_DEFINED
+
+#include "GrBuffer.h"
+#include "GrTypesPriv.h"
+#include "SkRect.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+class GrGpu;
+class GrSurface;
+
+/**
+ * Reads pixels back from the GPU without stalling on it. Each read transfers one or more
+ * rectangles of surfaces (planes) into transfer buffers of their own. After the next submit the
+ * reads are fenced, and once a read's fence has signaled its buffers are mapped and handed to its
+ * callback. Reads complete in the order they were added.
+ */
+class GrAsyncReadQueue {
+public:
+    static constexpr int kMaxPlanes = 3;
+
+    /**
+     * Receives the pixels of each of a read's planes, in the order they were given to addRead().
+     * The pixels are only valid for the duration of the call. If the read failed, or was abandoned
+     * along with the context, each plane's pixels are nullptr.
+     */
+    using Callback = std::function<void(const void* const planes[], const size_t rowBytes[])>;
+
+    struct Plane {
+        GrSurface*  fSurface;
+        SkIRect     fRect;
+        GrColorType fColorType;
+        bool        fFlipY;      // The rows are read bottom-up and handed back top-down.
+    };
+
+    /** Returns nullptr if the GrGpu doesn't support transfer buffers and fences. */
+    static std::unique_ptr<GrAsyncReadQueue> Make(GrGpu*);
+
+    ~GrAsyncReadQueue();
+
+    /**
+     * Issues the transfers for a read and queues it. Returns false, without queueing anything, if
+     * the backend can't transfer one of the planes; the caller should read them synchronously.
+     */
+    bool addRead(const Plane planes[], int planeCount, Callback);
+
+    /** Called by GrGpu after each submit to fence the reads added since the previous one. */
+    void didSubmit();
+
+    /**
+     * Calls back the reads the GPU has finished. If 'wait' is true this blocks until every read
+     * submitted so far is finished. Reads not yet submitted are left queued either way.
+     */
+    void checkCompletion(bool wait);
+
+    bool hasPendingReads() const { return !fReads.empty(); }
+
+    /**
+     * Fails all queued reads. Their buffers have already been released or abandoned along with the
+     * rest of the cache, so they are never mapped. If 'deleteFences' is false the fences are
+     * dropped without calling into the backend API.
+     */
+    void abandon(bool deleteFences);
+
+private:
+    struct Read {
+        sk_sp<GrBuffer> fBuffers[kMaxPlanes];
+        size_t          fRowBytes[kMaxPlanes];
+        int             fHeights[kMaxPlanes];
+        bool            fFlipY[kMaxPlanes];
+        int             fPlaneCount;
+        Callback        fCallback;
+        GrFence         fFence;
+        bool            fSubmitted;
+        bool            fFenced;    // The last read of its submit, which holds the fence.
+    };
+
+    explicit GrAsyncReadQueue(GrGpu* gpu) : fGpu(gpu) {}
+
+    // Calls back the read, with its buffers' contents if 'map' is true or as failed otherwise.
+    static void Complete(Read*, bool map);
+
+    GrGpu*           fGpu;
+    std::deque<Read> fReads;
+};
+
+#endif
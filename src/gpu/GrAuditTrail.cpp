@@ -6,6 +6,9 @@
  */
 
 #include "GrAuditTrail.h"
+#include "GrFragmentProcessor.h"
+#include "GrPipeline.h"
+#include "GrPrimitiveProcessor.h"
 #include "ops/GrOp.h"
 
 const int GrAuditTrail::kGrAuditTrailInvalidID = -1;
@@ -84,12 +87,93 @@ void GrAuditTrail::opsCombined(const GrOp* consumer, const GrOp* consumed) {
     fIDLookup.remove(consumed->uniqueID());
 }
 
+void GrAuditTrail::opExecuting(const GrOp* op) {
+    SkASSERT(fCollectCosts);
+    // Ops recorded while the trail was disabled aren't known, and their draws are only counted in
+    // the heatmap.
+    int* indexPtr = fIDLookup.find(op->uniqueID());
+    fExecutingOpListID = indexPtr ? *indexPtr : kGrAuditTrailInvalidID;
+}
+
+void GrAuditTrail::drawExecuted(const GrPrimitiveProcessor& primProc, const GrPipeline& pipeline,
+                                int meshCount, const SkRect& bounds) {
+    SkASSERT(fCollectCosts);
+    const GrRenderTargetProxy* proxy = pipeline.proxy();
+    SkRect drawBounds = bounds;
+    if (!proxy || !drawBounds.intersect(proxy->getBoundsRect())) {
+        return;
+    }
+
+    int fragmentProcessors = 0;
+    int textureSamples = primProc.numTextureSamplers();
+    GrFragmentProcessor::Iter iter(pipeline);
+    while (const GrFragmentProcessor* fp = iter.next()) {
+        ++fragmentProcessors;
+        textureSamples += fp->numTextureSamplers();
+    }
+    if (pipeline.dstTextureProxy()) {
+        ++textureSamples;
+    }
+    GrXferProcessor::BlendInfo blendInfo;
+    pipeline.getXferProcessor().getBlendInfo(&blendInfo);
+    bool readsDst = pipeline.getXferProcessor().willReadDstColor() ||
+                    GrBlendCoeffsUseDstColor(blendInfo.fSrcBlend, blendInfo.fDstBlend);
+
+    const double pixels = drawBounds.width() * drawBounds.height();
+    const int bpp = (int)GrBytesPerPixel(proxy->config());
+    const int bytesPerPixel = (blendInfo.fWriteColor ? bpp : 0) + (readsDst ? bpp : 0) +
+                              4 * textureSamples;
+
+    if (kGrAuditTrailInvalidID != fExecutingOpListID && fOpList[fExecutingOpListID]) {
+        OpCost& cost = fOpList[fExecutingOpListID]->fCost;
+        cost.fDraws += meshCount;
+        cost.fFragmentProcessors += fragmentProcessors;
+        cost.fTextureSamples += textureSamples;
+        cost.fReadsDst |= readsDst;
+        cost.fPixels += pixels;
+        cost.fBytes += pixels * bytesPerPixel;
+    }
+
+    Heatmap* heatmap = fHeatmaps.find(proxy->uniqueID().asUInt());
+    if (!heatmap) {
+        heatmap = fHeatmaps.set(proxy->uniqueID().asUInt(), Heatmap());
+        heatmap->fWidth = (proxy->width() + kHeatmapCellSize - 1) / kHeatmapCellSize;
+        heatmap->fHeight = (proxy->height() + kHeatmapCellSize - 1) / kHeatmapCellSize;
+        heatmap->fCells.push_back_n(heatmap->fWidth * heatmap->fHeight, 0.f);
+    }
+    const float pixelCost = 1 + fragmentProcessors + textureSamples + (readsDst ? 1 : 0);
+    const SkScalar cellSize = kHeatmapCellSize;
+    const int left   = SkTMax(SkScalarFloorToInt(drawBounds.fLeft / cellSize), 0);
+    const int top    = SkTMax(SkScalarFloorToInt(drawBounds.fTop / cellSize), 0);
+    const int right  = SkTMin(SkScalarCeilToInt(drawBounds.fRight / cellSize), heatmap->fWidth);
+    const int bottom = SkTMin(SkScalarCeilToInt(drawBounds.fBottom / cellSize), heatmap->fHeight);
+    for (int y = top; y < bottom; ++y) {
+        for (int x = left; x < right; ++x) {
+            SkRect cell = SkRect::MakeXYWH(x * cellSize, y * cellSize, cellSize, cellSize);
+            if (cell.intersect(drawBounds)) {
+                heatmap->fCells[y * heatmap->fWidth + x] +=
+                        pixelCost * cell.width() * cell.height() / (cellSize * cellSize);
+            }
+        }
+    }
+}
+
+bool GrAuditTrail::getHeatmap(GrSurfaceProxy::UniqueID proxyID, Heatmap* heatmap) const {
+    const Heatmap* found = fHeatmaps.find(proxyID.asUInt());
+    if (!found) {
+        return false;
+    }
+    *heatmap = *found;
+    return true;
+}
+
 void GrAuditTrail::copyOutFromOpList(OpInfo* outOpInfo, int opListID) {
     SkASSERT(opListID < fOpList.count());
     const OpNode* bn = fOpList[opListID].get();
     SkASSERT(bn);
     outOpInfo->fBounds = bn->fBounds;
     outOpInfo->fProxyUniqueID    = bn->fProxyUniqueID;
+    outOpInfo->fCost = bn->fCost;
     for (int j = 0; j < bn->fChildren.count(); j++) {
         OpInfo::Op& outOp = outOpInfo->fOps.push_back();
         const Op* currentOp = bn->fChildren[j];
@@ -132,6 +216,8 @@ void GrAuditTrail::fullReset() {
     // free all client ops
     fClientIDLookup.foreach ([](const int&, Ops** ops) { delete *ops; });
     fClientIDLookup.reset();
+    fHeatmaps.reset();
+    fExecutingOpListID = kGrAuditTrailInvalidID;
     fOpPool.reset();  // must be last, frees all of the memory
 }
 
@@ -227,6 +313,23 @@ SkString GrAuditTrail::toJson(bool prettyPrint) const {
     SkString json;
     json.append("{");
     JsonifyTArray(&json, "Ops", fOpList, false);
+    if (fHeatmaps.count()) {
+        json.append(",\"Heatmaps\": [");
+        const char* separator = "";
+        fHeatmaps.foreach([&](uint32_t proxyID, const Heatmap& heatmap) {
+            json.appendf("%s{\"ProxyID\": \"%u\",", separator, proxyID);
+            json.appendf("\"CellSize\": %d,", kHeatmapCellSize);
+            json.appendf("\"Width\": %d,", heatmap.fWidth);
+            json.appendf("\"Height\": %d,", heatmap.fHeight);
+            json.append("\"Cells\": [");
+            for (int i = 0; i < heatmap.fCells.count(); i++) {
+                json.appendf("%s%g", i ? "," : "", heatmap.fCells[i]);
+            }
+            json.append("]}");
+            separator = ",";
+        });
+        json.append("]");
+    }
     json.append("}");
 
     if (prettyPrint) {
@@ -288,6 +391,16 @@ SkString GrAuditTrail::OpNode::toJson() const {
     json.append("{");
     json.appendf("\"ProxyID\": \"%u\",", fProxyUniqueID.asUInt());
     skrect_to_json(&json, "Bounds", fBounds);
+    if (fCost.fDraws) {
+        json.append(",\"Cost\": {");
+        json.appendf("\"Draws\": %d,", fCost.fDraws);
+        json.appendf("\"FragmentProcessors\": %d,", fCost.fFragmentProcessors);
+        json.appendf("\"TextureSamples\": %d,", fCost.fTextureSamples);
+        json.appendf("\"ReadsDst\": %s,", fCost.fReadsDst ? "true" : "false");
+        json.appendf("\"Pixels\": %.0f,", fCost.fPixels);
+        json.appendf("\"Bytes\": %.0f", fCost.fBytes);
+        json.append("}");
+    }
     JsonifyTArray(&json, "Ops", fChildren, true);
     json.append("}");
     return json;
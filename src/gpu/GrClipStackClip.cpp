@@ -213,6 +213,10 @@ bool GrClipStackClip::apply(GrContext* context, GrRenderTargetContext* renderTar
 
     GrReducedClip reducedClip(*fStack, devBounds, context->contextPriv().caps(),
                               maxWindowRectangles, maxAnalyticFPs, ccpr ? maxAnalyticFPs : 0);
+    if (ccpr && !reducedClip.maskElements().isEmpty()) {
+        // Rather than render a mask texture for this clip, try to render it into CCPR's atlas.
+        reducedClip.convertMaskElementsToCCPRClipPath(ccpr);
+    }
     if (InitialState::kAllOut == reducedClip.initialState() &&
         reducedClip.maskElements().isEmpty()) {
         return false;
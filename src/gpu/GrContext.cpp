@@ -6,12 +6,14 @@
  */
 
 #include "GrContext.h"
+#include "GrAsyncReadQueue.h"
 #include "GrBackendSemaphore.h"
 #include "GrClip.h"
 #include "GrContextOptions.h"
 #include "GrContextPriv.h"
 #include "GrDrawingManager.h"
 #include "GrGpu.h"
+#include "GrGpuTimingQueue.h"
 #include "GrMemoryPool.h"
 #include "GrProxyProvider.h"
 #include "GrRenderTargetContext.h"
@@ -30,9 +32,12 @@
 #include "SkDeferredDisplayList.h"
 #include "SkGr.h"
 #include "SkImageInfoPriv.h"
+#include "SkImage_Gpu.h"
 #include "SkMakeUnique.h"
+#include "SkMemoryPressure.h"
 #include "SkSurface_Gpu.h"
 #include "SkTaskGroup.h"
+#include "SkTraceMemoryDump.h"
 #include "SkUnPreMultiplyPriv.h"
 #include "effects/GrConfigConversionEffect.h"
 #include "effects/GrSkSLFP.h"
@@ -73,6 +78,7 @@ GrContext::GrContext(GrBackendApi backend, int32_t id)
     fResourceProvider = nullptr;
     fProxyProvider = nullptr;
     fGlyphCache = nullptr;
+    fShaderCapture = nullptr;
 }
 
 bool GrContext::initCommon(const GrContextOptions& options) {
@@ -84,7 +90,8 @@ bool GrContext::initCommon(const GrContextOptions& options) {
         fCaps = fGpu->refCaps();
         fResourceCache = new GrResourceCache(fCaps.get(), fUniqueID);
         fResourceProvider = new GrResourceProvider(fGpu.get(), fResourceCache, &fSingleOwner,
-                                                   options.fExplicitlyAllocateGPUResources);
+                                                   options.fExplicitlyAllocateGPUResources,
+                                                   options.fStagedTextureUploads);
         fProxyProvider =
                 new GrProxyProvider(fResourceProvider, fResourceCache, fCaps, &fSingleOwner);
     } else {
@@ -97,10 +104,12 @@ bool GrContext::initCommon(const GrContextOptions& options) {
 
     fDisableGpuYUVConversion = options.fDisableGpuYUVConversion;
     fSharpenMipmappedTextures = options.fSharpenMipmappedTextures;
+    fReduceProgramVariants = options.fReduceProgramVariants;
     fDidTestPMConversions = false;
 
     GrPathRendererChain::Options prcOptions;
     prcOptions.fAllowPathMaskCaching = options.fAllowPathMaskCaching;
+    prcOptions.fCompactPathMaskAtlases = options.fCompactPathMaskAtlases;
 #if GR_TEST_UTILS
     prcOptions.fGpuPathRenderers = options.fGpuPathRenderers;
 #endif
@@ -135,7 +144,8 @@ bool GrContext::initCommon(const GrContextOptions& options) {
     fDrawingManager.reset(new GrDrawingManager(this, prcOptions, textContextOptions,
                                                &fSingleOwner, explicitlyAllocatingResources,
                                                options.fSortRenderTargets,
-                                               options.fReduceOpListSplitting));
+                                               options.fReduceOpListSplitting,
+                                               options.fSpatialOpCombining));
 
     fGlyphCache = new GrGlyphCache(fCaps.get(), options.fGlyphCacheTextureMaximumBytes);
 
@@ -156,6 +166,22 @@ bool GrContext::initCommon(const GrContextOptions& options) {
 GrContext::~GrContext() {
     ASSERT_SINGLE_OWNER
 
+    if (fGpu && fDrawingManager) {
+        bool abandoned = fDrawingManager->wasAbandoned();
+        if (GrAsyncReadQueue* queue = fGpu->asyncReadQueue()) {
+            // Deliver what the GPU finishes while the buffers are still around, and fail the rest.
+            if (!abandoned) {
+                queue->checkCompletion(true);
+            }
+            queue->abandon(!abandoned);
+        }
+        if (GrGpuTimingQueue* timing = fGpu->gpuTimingQueue()) {
+            timing->abandon(!abandoned);
+        }
+        if (!abandoned) {
+            fGpu->storeVkPipelineCacheData();
+        }
+    }
     if (fDrawingManager) {
         fDrawingManager->cleanup();
     }
@@ -236,6 +262,40 @@ SkSurfaceCharacterization GrContextThreadSafeProxy::createCharacterization(
                                      surfaceProps);
 }
 
+sk_sp<SkImage> GrContextThreadSafeProxy::makeTextureImage(sk_sp<SkImage> image,
+                                                          GrMipMapped mipMapped) {
+    if (!image || image->isTextureBacked()) {
+        return nullptr;
+    }
+    // This decodes lazily generated images.
+    sk_sp<SkImage> raster = image->makeRasterImage();
+    SkBitmap bitmap;
+    if (!raster || !as_IB(raster)->getROPixels(&bitmap, nullptr, SkImage::kDisallow_CachingHint)) {
+        return nullptr;
+    }
+
+    // A DDL context's proxy provider only makes lazy proxies, which the GrContext this proxy
+    // came from instantiates when it flushes them. The two contexts share an ID, so the image
+    // can be drawn by that GrContext as well as by DDLs recorded for it.
+    sk_sp<GrContext> context = GrContextPriv::MakeDDL(sk_ref_sp(this));
+    if (!context) {
+        return nullptr;
+    }
+    GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
+    sk_sp<GrTextureProxy> proxy;
+    if (GrMipMapped::kYes == mipMapped && fCaps->mipMapSupport()) {
+        proxy = proxyProvider->createMipMapProxyFromBitmap(bitmap);
+    } else {
+        proxy = proxyProvider->createTextureProxy(raster, kNone_GrSurfaceFlags, 1, SkBudgeted::kYes,
+                                                  SkBackingFit::kExact);
+    }
+    if (!proxy) {
+        return nullptr;
+    }
+    return sk_make_sp<SkImage_Gpu>(std::move(context), raster->uniqueID(), raster->alphaType(),
+                                   std::move(proxy), raster->refColorSpace(), SkBudgeted::kYes);
+}
+
 void GrContext::abandonContext() {
     ASSERT_SINGLE_OWNER
 
@@ -315,6 +375,40 @@ void GrContext::purgeUnlockedResources(size_t bytesToPurge, bool preferScratchRe
     fResourceCache->purgeUnlockedResources(bytesToPurge, preferScratchResources);
 }
 
+size_t GrContext::onMemoryPressure(SkGraphics::MemoryPressure level, SkTraceMemoryDump* dump) {
+    ASSERT_SINGLE_OWNER
+    if (this->abandoned()) {
+        return 0;
+    }
+
+    size_t totalFreed = 0;
+    auto report = [&](const char* cache, size_t freed) {
+        totalFreed += freed;
+        if (dump) {
+            SkString name;
+            name.printf("skia/memory_pressure/gr_context_%u/%s", fUniqueID, cache);
+            dump->dumpNumericValue(name.c_str(), "freed_size", "bytes", freed);
+        }
+    };
+
+    // Scratch resources go first: they have no contents to upload again.
+    const size_t resourceBytes = fResourceCache->getResourceBytes();
+    fResourceCache->purgeUnlockedResources(
+            SkMemoryPressureShare(level, fResourceCache->getPurgeableBytes(), 1, 2), true);
+    report("resource_cache", resourceBytes - fResourceCache->getResourceBytes());
+
+    report("text_blob_cache",
+           fTextBlobCache->purgeBytes(SkMemoryPressureShare(level, fTextBlobCache->usedBytes(),
+                                                            1, 2)));
+
+    // Programs are the dearest to remake. Their memory belongs to the driver, so it goes
+    // uncounted.
+    if (SkGraphics::MemoryPressure::kCritical == level) {
+        fGpu->purgeProgramCache();
+    }
+    return totalFreed;
+}
+
 void GrContext::getResourceCacheUsage(int* resourceCount, size_t* resourceBytes) const {
     ASSERT_SINGLE_OWNER
 
@@ -365,7 +459,26 @@ void GrContext::flush() {
     ASSERT_SINGLE_OWNER
     RETURN_IF_ABANDONED
 
-    fDrawingManager->flush(nullptr);
+    fDrawingManager->flush(nullptr, 0, nullptr, true);
+}
+
+void GrContext::setWorkPriority(WorkPriority priority) {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    fDrawingManager->setRecordingBackgroundWork(WorkPriority::kBackground == priority);
+}
+
+GrContext::WorkPriority GrContext::workPriority() const {
+    return fDrawingManager->recordingBackgroundWork() ? WorkPriority::kBackground
+                                                      : WorkPriority::kCritical;
+}
+
+void GrContext::setFlushTimeBudget(uint64_t microseconds) {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    fDrawingManager->setFlushTimeBudget(microseconds);
 }
 
 GrSemaphoresSubmitted GrContext::flushAndSignalSemaphores(int numSemaphores,
@@ -376,6 +489,51 @@ GrSemaphoresSubmitted GrContext::flushAndSignalSemaphores(int numSemaphores,
     return fDrawingManager->flush(nullptr, numSemaphores, signalSemaphores);
 }
 
+void GrContext::checkAsyncWorkCompletion() {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    if (GrAsyncReadQueue* queue = fGpu ? fGpu->asyncReadQueue() : nullptr) {
+        queue->checkCompletion(false);
+    }
+    if (GrGpuTimingQueue* timing = fGpu ? fGpu->gpuTimingQueue() : nullptr) {
+        timing->checkCompletion();
+    }
+}
+
+bool GrContext::setGpuTiming(GpuTimingLevel level, GpuTimingCallback callback,
+                             void* callbackContext) {
+    ASSERT_SINGLE_OWNER
+    RETURN_FALSE_IF_ABANDONED
+
+    return fGpu && fGpu->setGpuTiming(level, callback, callbackContext);
+}
+
+void GrContext::storeVkPipelineCacheData() {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    if (fGpu) {
+        fGpu->storeVkPipelineCacheData();
+    }
+}
+
+bool GrContext::precompileShader(const SkData& key, const SkData& data) {
+    ASSERT_SINGLE_OWNER
+    RETURN_FALSE_IF_ABANDONED
+
+    return fGpu && fGpu->precompileShader(key, data);
+}
+
+int GrContext::precompileShaders(const SkData& capturedShaders) {
+    ASSERT_SINGLE_OWNER
+    if (fDrawingManager->wasAbandoned()) {
+        return 0;
+    }
+
+    return fGpu ? fGpu->precompileShaders(capturedShaders) : 0;
+}
+
 void GrContextPriv::flush(GrSurfaceProxy* proxy) {
     ASSERT_SINGLE_OWNER_PRIV
     RETURN_IF_ABANDONED_PRIV
@@ -408,6 +566,7 @@ static bool valid_premul_config(GrPixelConfig config) {
         case kAlpha_half_as_Red_GrPixelConfig:  return false;
         case kGray_8_as_Lum_GrPixelConfig:      return false;
         case kGray_8_as_Red_GrPixelConfig:      return false;
+        case kRGB_ETC1_GrPixelConfig:           return false;
     }
     SK_ABORT("Invalid GrPixelConfig");
     return false;
@@ -795,6 +954,58 @@ bool GrContextPriv::readSurfacePixels(GrSurfaceContext* src, int left, int top,
     return true;
 }
 
+bool GrContextPriv::asyncReadSurfacePixels(GrSurfaceContext* const srcs[],
+                                           const SkIRect srcRects[],
+                                           const GrColorType dstColorTypes[], int planeCount,
+                                           GrAsyncReadQueue::Callback callback) {
+    ASSERT_SINGLE_OWNER_PRIV
+    RETURN_FALSE_IF_ABANDONED_PRIV
+    GR_CREATE_TRACE_MARKER_CONTEXT("GrContextPriv", "asyncReadSurfacePixels", fContext);
+
+    GrAsyncReadQueue* queue = fContext->fGpu ? fContext->fGpu->asyncReadQueue() : nullptr;
+    if (!queue || planeCount < 1 || planeCount > GrAsyncReadQueue::kMaxPlanes) {
+        return false;
+    }
+
+    GrAsyncReadQueue::Plane planes[GrAsyncReadQueue::kMaxPlanes];
+    bool pendingWrites = false;
+    for (int i = 0; i < planeCount; ++i) {
+        GrSurfaceProxy* srcProxy = srcs[i]->asSurfaceProxy();
+        ASSERT_OWNED_PROXY_PRIV(srcProxy);
+        if (!srcProxy->instantiate(this->resourceProvider())) {
+            return false;
+        }
+        GrSurface* srcSurface = srcProxy->peekSurface();
+        SkIRect rect = srcRects[i];
+        if (rect.isEmpty() ||
+            !SkIRect::MakeWH(srcProxy->width(), srcProxy->height()).contains(rect)) {
+            return false;
+        }
+        if (!this->caps()->surfaceSupportsReadPixels(srcSurface) ||
+            this->caps()->supportedReadPixelsColorType(srcProxy->config(), dstColorTypes[i]) !=
+                    dstColorTypes[i]) {
+            return false;
+        }
+        bool flip = kBottomLeft_GrSurfaceOrigin == srcProxy->origin();
+        if (flip) {
+            rect = SkIRect::MakeLTRB(rect.fLeft, srcSurface->height() - rect.fBottom,
+                                     rect.fRight, srcSurface->height() - rect.fTop);
+        }
+        planes[i] = {srcSurface, rect, dstColorTypes[i], flip};
+        pendingWrites = pendingWrites || srcSurface->surfacePriv().hasPendingWrite();
+    }
+
+    if (pendingWrites) {
+        this->flush(nullptr);  // MDB TODO: tighten this
+    }
+    if (!queue->addRead(planes, planeCount, std::move(callback))) {
+        return false;
+    }
+    // The transfers don't go through an opList, so this just submits them.
+    this->flush(nullptr);
+    return true;
+}
+
 void GrContextPriv::prepareSurfaceForExternalIO(GrSurfaceProxy* proxy) {
     ASSERT_SINGLE_OWNER_PRIV
     RETURN_IF_ABANDONED_PRIV
@@ -975,6 +1186,7 @@ static inline GrPixelConfig GrPixelConfigFallback(GrPixelConfig config) {
         case kBGRA_8888_GrPixelConfig:
         case kRGBA_1010102_GrPixelConfig:
         case kRGBA_half_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:
             return kRGBA_8888_GrPixelConfig;
         case kSBGRA_8888_GrPixelConfig:
             return kSRGBA_8888_GrPixelConfig;
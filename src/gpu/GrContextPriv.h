@@ -8,6 +8,7 @@
 #ifndef GrContextPriv_DEFINED
 #define GrContextPriv_DEFINED
 
+#include "GrAsyncReadQueue.h"
 #include "GrContext.h"
 #include "GrSurfaceContext.h"
 #include "text/GrAtlasManager.h"
@@ -77,6 +78,7 @@ public:
 
     bool disableGpuYUVConversion() const { return fContext->fDisableGpuYUVConversion; }
     bool sharpenMipmappedTextures() const { return fContext->fSharpenMipmappedTextures; }
+    bool reduceProgramVariants() const { return fContext->fReduceProgramVariants; }
 
     /**
      * Call to ensure all drawing to the context has been issued to the
@@ -156,6 +158,22 @@ public:
                            GrColorType dstColorType, SkColorSpace* dstColorSpace, void* buffer,
                            size_t rowBytes = 0, uint32_t pixelOpsFlags = 0);
 
+    /**
+     * Reads rectangles of one or more surfaces (the planes of a single read) without waiting on the
+     * GPU. The reads are flushed and submitted before this returns, and the callback is called
+     * from a later GrContext::checkAsyncWorkCompletion() once the GPU is done, or as failed if the
+     * context is abandoned or destroyed first.
+     *
+     * There are no conversions: each color type must be the one the caps support reading from its
+     * surface's config, and the pixels keep the surface's color space and premultiplication.
+     *
+     * @return false, without calling the callback, if the reads can't be done this way; the
+     *         caller should use readSurfacePixels() instead.
+     */
+    bool asyncReadSurfacePixels(GrSurfaceContext* const srcs[], const SkIRect srcRects[],
+                                const GrColorType dstColorTypes[], int planeCount,
+                                GrAsyncReadQueue::Callback);
+
     /**
      * Writes a rectangle of pixels to a surface.
      *
@@ -272,6 +290,13 @@ public:
 
     GrContextOptions::PersistentCache* getPersistentCache() { return fContext->fPersistentCache; }
 
+    /**
+     * While set, the backend records the SkSL of each program it builds into the capture, which
+     * must outlive the context or be unset first. Currently only GL records programs.
+     */
+    void setShaderCapture(GrShaderCapture* capture) { fContext->fShaderCapture = capture; }
+    GrShaderCapture* getShaderCapture() { return fContext->fShaderCapture; }
+
     sk_sp<GrSkSLFPFactoryCache> getFPFactoryCache() {
         return fContext->fFPFactoryCache;
     }
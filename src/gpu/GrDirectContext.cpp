@@ -82,7 +82,8 @@ protected:
 
         fAtlasManager = new GrAtlasManager(proxyProvider, glyphCache,
                                            options.fGlyphCacheTextureMaximumBytes,
-                                           allowMultitexturing);
+                                           allowMultitexturing,
+                                           options.fGlyphCacheTextureMaximumPages);
         this->contextPriv().addOnFlushCallbackObject(fAtlasManager);
 
         return true;
@@ -204,6 +204,7 @@ inline void GrDrawOpAtlas::processEviction(AtlasID id) {
         (*fEvictionCallbacks[i].fFunc)(id, fEvictionCallbacks[i].fData);
     }
     ++fAtlasGeneration;
+    ++fStats.fPlotEvictions;
 }
 
 inline bool GrDrawOpAtlas::updatePlot(GrDeferredUploadTarget* target, AtlasID* id, Plot* plot) {
@@ -213,18 +214,33 @@ inline bool GrDrawOpAtlas::updatePlot(GrDeferredUploadTarget* target, AtlasID* i
     // If our most recent upload has already occurred then we have to insert a new
     // upload. Otherwise, we already have a scheduled upload that hasn't yet ocurred.
     // This new update will piggy back on that previously scheduled update.
-    if (plot->lastUploadToken() < target->tokenTracker()->nextTokenToFlush()) {
-        // With c+14 we could move sk_sp into lamba to only ref once.
-        sk_sp<Plot> plotsp(SkRef(plot));
-
-        GrTextureProxy* proxy = fProxies[pageIdx].get();
-        SkASSERT(proxy->isInstantiated());  // This is occurring at flush time
-
-        GrDeferredUploadToken lastUploadToken = target->addASAPUpload(
-                [plotsp, proxy](GrDeferredTextureUploadWritePixelsFn& writePixels) {
-                    plotsp->uploadToTexture(writePixels, proxy);
-                });
-        plot->setLastUploadToken(lastUploadToken);
+    GrDeferredUploadToken nextTokenToFlush = target->tokenTracker()->nextTokenToFlush();
+    if (plot->lastUploadToken() < nextTokenToFlush) {
+        // Likewise, if the page already has an ASAP upload scheduled, the plot joins it rather
+        // than scheduling its own.
+        Page& page = fPages[pageIdx];
+        if (!page.fUpload || page.fUploadToken < nextTokenToFlush) {
+            page.fUpload.reset(new PageUpload);
+
+            // With c+14 we could move sk_sp into lamba to only ref once.
+            sk_sp<PageUpload> upload = page.fUpload;
+            GrTextureProxy* proxy = fProxies[pageIdx].get();
+            SkASSERT(proxy->isInstantiated());  // This is occurring at flush time
+
+            page.fUploadToken = target->addASAPUpload(
+                    [upload, proxy](GrDeferredTextureUploadWritePixelsFn& writePixels) {
+                        for (const sk_sp<Plot>& plot : upload->fPlots) {
+                            // The plot may have been evicted since it joined the upload.
+                            if (plot->needsUpload()) {
+                                plot->uploadToTexture(writePixels, proxy);
+                            }
+                        }
+                    });
+            ++fStats.fASAPUploads;
+        }
+        page.fUpload->fPlots.push_back(sk_ref_sp(plot));
+        plot->setLastUploadToken(page.fUploadToken);
+        ++fStats.fASAPPlotUploads;
     }
     *id = plot->id();
     return true;
@@ -274,27 +290,33 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
         }
     }
 
-    // If the above fails, then see if the least recently used plot per page has already been
+    // If the above fails, then see if the least recently used plot of any page has already been
     // flushed to the gpu if we're at max page allocation, or if the plot has aged out otherwise.
     // We wait until we've grown to the full number of pages to begin evicting already flushed
     // plots so that we can maximize the opportunity for reuse.
-    // As before we prioritize this upload to the first pages, not the most recently used.
+    // Of the candidates we evict the one used longest ago, preferring the first pages on ties.
     if (fNumActivePages == this->maxPages()) {
+        Plot* plot = nullptr;
         for (unsigned int pageIdx = 0; pageIdx < fNumActivePages; ++pageIdx) {
-            Plot* plot = fPages[pageIdx].fPlotList.tail();
-            SkASSERT(plot);
-            if (plot->lastUseToken() < target->tokenTracker()->nextTokenToFlush() ||
-                plot->flushesSinceLastUsed() >= kRecentlyUsedCount) {
-                this->processEvictionAndResetRects(plot);
-                SkASSERT(GrBytesPerPixel(fProxies[pageIdx]->config()) == plot->bpp());
-                SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
-                SkASSERT(verify);
-                if (!this->updatePlot(target, id, plot)) {
-                    return ErrorCode::kError;
-                }
-                return ErrorCode::kSucceeded;
+            Plot* candidate = fPages[pageIdx].fPlotList.tail();
+            SkASSERT(candidate);
+            if ((candidate->lastUseToken() < target->tokenTracker()->nextTokenToFlush() ||
+                 candidate->flushesSinceLastUsed() >= kRecentlyUsedCount) &&
+                (!plot || candidate->lastUseToken() < plot->lastUseToken())) {
+                plot = candidate;
             }
         }
+        if (plot) {
+            this->processEvictionAndResetRects(plot);
+            SkASSERT(GrBytesPerPixel(fProxies[GetPageIndexFromID(plot->id())]->config()) ==
+                     plot->bpp());
+            SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
+            SkASSERT(verify);
+            if (!this->updatePlot(target, id, plot)) {
+                return ErrorCode::kError;
+            }
+            return ErrorCode::kSucceeded;
+        }
     } else {
         // If we haven't activated all the available pages, try to create a new one and add to it
         if (!this->activateNewPage(resourceProvider)) {
@@ -331,6 +353,7 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
     // continue past this branch and prepare an inline upload that will occur after the enqueued
     // draw which references the plot's pre-upload content.
     if (!plot) {
+        ++fStats.fTryAgains;
         return ErrorCode::kTryAgain;
     }
 
@@ -358,6 +381,7 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
                 plotsp->uploadToTexture(writePixels, proxy);
             });
     newPlot->setLastUploadToken(lastUploadToken);
+    ++fStats.fInlineUploads;
 
     *id = newPlot->id();
 
@@ -563,6 +587,7 @@ bool GrDrawOpAtlas::activateNewPage(GrResourceProvider* resourceProvider) {
 #endif
 
     ++fNumActivePages;
+    ++fStats.fPageActivations;
     return true;
 }
 
@@ -591,7 +616,16 @@ inline void GrDrawOpAtlas::deactivateLastPage() {
         }
     }
 
+    fPages[lastPageIndex].fUpload.reset();
+    fPages[lastPageIndex].fUploadToken = GrDeferredUploadToken::AlreadyFlushedToken();
+
     // remove ref to the backing texture
     fProxies[lastPageIndex]->deInstantiate();
     --fNumActivePages;
+    ++fStats.fPageDeactivations;
+}
+
+void GrDrawOpAtlas::setMaxPages(uint32_t maxPages) {
+    SkASSERT(!fNumActivePages);
+    fMaxPages = SkTMin(maxPages, fMaxPages);
 }
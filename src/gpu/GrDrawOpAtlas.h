@@ -42,6 +42,9 @@ class GrRectanizer;
  * is checked to see whether it was used in that flush; if it is not, a counter is incremented.
  * Once that counter reaches a threshold that subarea is considered to be no longer in use.
  *
+ * ASAP uploads are batched per page: all of the plots on a page that are dirtied before a flush
+ * executes its uploads are written by a single upload task.
+ *
  * Garbage collection is initiated by the GrDrawOpAtlas's client via the compact() method. One
  * solution is to make the client a subclass of GrOnFlushCallbackObject, register it with the
  * GrContext via addOnFlushCallbackObject(), and the client's postFlush() method calls compact()
@@ -157,6 +160,24 @@ public:
 
     uint32_t numActivePages() { return fNumActivePages; }
 
+    /** Counters for how much the atlas has churned over its lifetime. */
+    struct Stats {
+        int fPageActivations = 0;
+        int fPageDeactivations = 0;
+        // Plots whose contents were evicted to make room for new data.
+        int fPlotEvictions = 0;
+        // ASAP upload tasks. Each writes every plot dirtied on one page before the flush.
+        int fASAPUploads = 0;
+        // Plots written by ASAP uploads.
+        int fASAPPlotUploads = 0;
+        // Uploads issued between draws because no plot could be evicted ahead of the flush.
+        int fInlineUploads = 0;
+        // Times an op had to end its draw before more data could be added.
+        int fTryAgains = 0;
+    };
+
+    const Stats& stats() const { return fStats; }
+
     /**
      * A class which can be handed back to GrDrawOpAtlas for updating last use tokens in bulk.  The
      * current max number of plots per page the GrDrawOpAtlas can handle is 32. If in the future
@@ -236,6 +257,12 @@ public:
         return fMaxPages;
     }
 
+    /**
+     * Lowers the number of pages the atlas may grow to. This can only shrink the limit set by
+     * AllowMultitexturing, and must be called before any pages are active.
+     */
+    void setMaxPages(uint32_t maxPages);
+
     int numAllocated_TestingOnly() const;
     void setMaxPages_TestingOnly(uint32_t maxPages);
 
@@ -281,6 +308,7 @@ private:
         void setLastUploadToken(GrDeferredUploadToken token) { fLastUpload = token; }
         void setLastUseToken(GrDeferredUploadToken token) { fLastUse = token; }
 
+        bool needsUpload() const { return !fDirtyRect.isEmpty(); }
         void uploadToTexture(GrDeferredTextureUploadWritePixelsFn&, GrTextureProxy*);
         void resetRects();
 
@@ -341,6 +369,11 @@ private:
 
     typedef SkTInternalLList<Plot> PlotList;
 
+    // The plots that a page's pending ASAP upload will write.
+    struct PageUpload : public SkRefCnt {
+        SkTArray<sk_sp<Plot>> fPlots;
+    };
+
     static uint32_t GetPlotIndexFromID(AtlasID id) {
         return (id >> 8) & 0xff;
     }
@@ -400,6 +433,9 @@ private:
         std::unique_ptr<sk_sp<Plot>[]> fPlotArray;
         // LRU list of Plots (MRU at head - LRU at tail)
         PlotList fPlotList;
+        // The ASAP upload that plots dirtied on this page join until it has been flushed.
+        sk_sp<PageUpload> fUpload;
+        GrDeferredUploadToken fUploadToken = GrDeferredUploadToken::AlreadyFlushedToken();
     };
     // proxies kept separate to make it easier to pass them up to client
     sk_sp<GrTextureProxy> fProxies[kMaxMultitexturePages];
@@ -407,6 +443,8 @@ private:
     uint32_t fMaxPages;
 
     uint32_t fNumActivePages;
+
+    Stats fStats;
 };
 
 // There are three atlases (A8, 565, ARGB) that are kept in relation with one another. In
@@ -10,6 +10,7 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrGpu.h"
+#include "GrGpuTimingQueue.h"
 #include "GrMemoryPool.h"
 #include "GrOnFlushResourceProvider.h"
 #include "GrOpList.h"
@@ -28,7 +29,9 @@
 #include "GrTracing.h"
 #include "SkDeferredDisplayList.h"
 #include "SkSurface_Gpu.h"
+#include "SkTHash.h"
 #include "SkTTopoSort.h"
+#include "SkTime.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
 #include "text/GrTextContext.h"
 
@@ -57,6 +60,7 @@ void GrDrawingManager::OpListDAG::gatherIDs(SkSTArray<8, uint32_t, true>* idArra
 
 void GrDrawingManager::OpListDAG::reset() {
     fOpLists.reset();
+    fIntentionalSplit = false;
 }
 
 void GrDrawingManager::OpListDAG::removeOpList(int index) {
@@ -90,6 +94,56 @@ void GrDrawingManager::OpListDAG::swap(SkTArray<sk_sp<GrOpList>>* opLists) {
     opLists->swap(fOpLists);
 }
 
+void GrDrawingManager::OpListDAG::removeBackgroundOpLists(SkTArray<sk_sp<GrOpList>>* background) {
+    SkASSERT(background->empty());
+
+    bool anyBackground = false;
+    for (int i = 0; i < fOpLists.count() && !anyBackground; ++i) {
+        anyBackground = fOpLists[i] && fOpLists[i]->isBackground();
+    }
+    if (!anyBackground) {
+        return;
+    }
+
+    // Walk backwards so that everything the kept opLists need is known by the time we reach it. A
+    // background opList has to stay put if a kept opList depends on it, or if it reads or writes
+    // a surface that a later kept opList writes.
+    SkTHashSet<GrOpList*> needed;
+    SkTHashSet<GrSurfaceProxy*> laterTargets;
+    SkSTArray<16, bool, true> keep;
+    keep.push_back_n(fOpLists.count(), true);
+    for (int i = fOpLists.count() - 1; i >= 0; --i) {
+        GrOpList* opList = fOpLists[i].get();
+        if (!opList) {
+            continue;
+        }
+        bool stay = !opList->isBackground() || needed.contains(opList) ||
+                    laterTargets.contains(opList->fTarget.get());
+        if (!stay) {
+            opList->visitOpProxies([&](GrSurfaceProxy* proxy) {
+                stay = stay || laterTargets.contains(proxy);
+            });
+        }
+        keep[i] = stay;
+        if (stay) {
+            laterTargets.add(opList->fTarget.get());
+            for (GrOpList* dependedOn : opList->fDependencies) {
+                needed.add(dependedOn);
+            }
+        }
+    }
+
+    int numKept = 0;
+    for (int i = 0; i < fOpLists.count(); ++i) {
+        if (!keep[i]) {
+            background->push_back(std::move(fOpLists[i]));
+        } else if (numKept++ != i) {
+            fOpLists[numKept - 1] = std::move(fOpLists[i]);
+        }
+    }
+    fOpLists.pop_back_n(fOpLists.count() - numKept);
+}
+
 void GrDrawingManager::OpListDAG::prepForFlush() {
     if (fSortOpLists) {
         SkDEBUGCODE(bool result =) SkTTopoSort<GrOpList, GrOpList::TopoSortTraits>(&fOpLists);
@@ -104,7 +158,7 @@ void GrDrawingManager::OpListDAG::prepForFlush() {
         for (int i = 1; i < fOpLists.count(); ++i) {
             GrRenderTargetOpList* curOpList = fOpLists[i]->asRenderTargetOpList();
 
-            if (prevOpList && curOpList) {
+            if (prevOpList && curOpList && !fIntentionalSplit) {
                 SkASSERT(prevOpList->fTarget.get() != curOpList->fTarget.get());
             }
 
@@ -142,6 +196,7 @@ void GrDrawingManager::OpListDAG::cleanup(const GrCaps* caps) {
     }
 
     fOpLists.reset();
+    fIntentionalSplit = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -151,7 +206,8 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
                                    GrSingleOwner* singleOwner,
                                    bool explicitlyAllocating,
                                    GrContextOptions::Enable sortOpLists,
-                                   GrContextOptions::Enable reduceOpListSplitting)
+                                   GrContextOptions::Enable reduceOpListSplitting,
+                                   GrContextOptions::Enable spatialOpCombining)
         : fContext(context)
         , fOptionsForPathRendererChain(optionsForPathRendererChain)
         , fOptionsForTextContext(optionsForTextContext)
@@ -161,7 +217,8 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
         , fTextContext(nullptr)
         , fPathRendererChain(nullptr)
         , fSoftwarePathRenderer(nullptr)
-        , fFlushing(false) {
+        , fFlushing(false)
+        , fSpatialOpCombining(GrContextOptions::Enable::kYes == spatialOpCombining) {
     if (GrContextOptions::Enable::kNo == reduceOpListSplitting) {
         fReduceOpListSplitting = false;
     } else if (GrContextOptions::Enable::kYes == reduceOpListSplitting) {
@@ -173,6 +230,17 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
     }
 }
 
+void GrDrawingManager::setRecordingBackgroundWork(bool background) {
+    if (fRecordingBackgroundWork == background) {
+        return;
+    }
+    // Ops recorded from here on must not land in an opList recorded at the other priority.
+    fDAG.closeAll(fContext->contextPriv().caps());
+    fDAG.noteIntentionalSplit();
+    fActiveOpList = nullptr;
+    fRecordingBackgroundWork = background;
+}
+
 void GrDrawingManager::cleanup() {
     fDAG.cleanup(fContext->contextPriv().caps());
 
@@ -207,7 +275,8 @@ void GrDrawingManager::freeGpuResources() {
 // MDB TODO: make use of the 'proxy' parameter.
 GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
                                               int numSemaphores,
-                                              GrBackendSemaphore backendSemaphores[]) {
+                                              GrBackendSemaphore backendSemaphores[],
+                                              bool mayDeferBackgroundWork) {
     GR_CREATE_TRACE_MARKER_CONTEXT("GrDrawingManager", "flush", fContext);
 
     if (fFlushing || this->wasAbandoned()) {
@@ -220,6 +289,7 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
         return GrSemaphoresSubmitted::kNo; // Can't flush while DDL recording
     }
     fFlushing = true;
+    const double flushStartNs = SkTime::GetNSecs();
 
     // Semi-usually the GrOpLists are already closed at this point, but sometimes Ganesh
     // needs to flush mid-draw. In that case, the SkGpuDevice's GrOpLists won't be closed
@@ -230,20 +300,108 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
 
     fDAG.prepForFlush();
 
+    // Background opLists that nothing else is waiting on are moved to the end of the flush.
+    SkSTArray<8, sk_sp<GrOpList>> background;
+    fDAG.removeBackgroundOpLists(&background);
+
     GrOpFlushState flushState(gpu, fContext->contextPriv().resourceProvider(),
-                              &fTokenTracker);
+                              &fTokenTracker, fContext->contextPriv().getTaskGroup());
 
     GrOnFlushResourceProvider onFlushProvider(this);
     // TODO: AFAICT the only reason fFlushState is on GrDrawingManager rather than on the
     // stack here is to preserve the flush tokens.
 
+    bool flushed = this->executeDAG(&flushState, &onFlushProvider);
+
+    int numExecuted = 0;
+    if (fContext->contextPriv().resourceProvider()->explicitlyAllocateGPUResources()) {
+        // The resource allocator has to see every opList of the flush at once, so here
+        // background work is only reordered, never deferred.
+        if (!background.empty()) {
+            this->callPostFlush();
+            fDAG.add(background);
+            background.reset();
+            flushed = this->executeDAG(&flushState, &onFlushProvider) || flushed;
+        }
+    } else {
+        // Otherwise each background opList gets a pass of its own, so the flush can stop between
+        // any two of them once its time budget is spent.
+        for (; numExecuted < background.count(); ++numExecuted) {
+            if (mayDeferBackgroundWork && fFlushTimeBudgetNs &&
+                SkTime::GetNSecs() - flushStartNs >= fFlushTimeBudgetNs) {
+                break;
+            }
+            this->callPostFlush();
+            fDAG.add(std::move(background[numExecuted]));
+            flushed = this->executeDAG(&flushState, &onFlushProvider) || flushed;
+        }
+    }
+
+#ifdef SK_DEBUG
+    // In non-DDL mode this checks that all the flushed ops have been freed from the memory pool.
+    // When we move to partial flushes this assert will no longer be valid.
+    // In DDL mode this check is somewhat superfluous since the memory for most of the ops/opLists
+    // will be stored in the DDL's GrOpMemoryPools.
+    GrOpMemoryPool* opMemoryPool = fContext->contextPriv().opMemoryPool();
+    opMemoryPool->isEmpty();
+#endif
+
+    GrSemaphoresSubmitted result = gpu->finishFlush(numSemaphores, backendSemaphores);
+    if (GrGpuTimingQueue* timing = gpu->gpuTimingQueue()) {
+        timing->checkCompletion();
+    }
+
+    flushState.uninstantiateProxyTracker()->uninstantiateAllProxies();
+
+    // Give the cache a chance to purge resources that become purgeable due to flushing.
+    if (flushed) {
+        fContext->contextPriv().getResourceCache()->purgeAsNeeded();
+    }
+    this->callPostFlush();
+
+    SkTArray<SkMemoryPressureMessage> pressure;
+    fMemoryPressureInbox.poll(&pressure);
+    if (!pressure.empty()) {
+        SkGraphics::MemoryPressure level = SkGraphics::MemoryPressure::kModerate;
+        for (const SkMemoryPressureMessage& msg : pressure) {
+            level = SkTMax(level, msg.fLevel);
+        }
+        fContext->onMemoryPressure(level);
+    }
+
+    // Whatever background work the budget left over goes at the front of the next flush. The
+    // opLists that did execute have been freed, so they must no longer be depended on.
+    if (numExecuted < background.count()) {
+        SkTHashSet<GrOpList*> deferred;
+        for (int i = numExecuted; i < background.count(); ++i) {
+            deferred.add(background[i].get());
+        }
+        for (int i = numExecuted; i < background.count(); ++i) {
+            GrOpList* opList = background[i].get();
+            for (int j = opList->fDependencies.count() - 1; j >= 0; --j) {
+                if (!deferred.contains(opList->fDependencies[j])) {
+                    opList->fDependencies.removeShuffle(j);
+                }
+            }
+            opList->resetFlag(GrOpList::kWasOutput_Flag);
+            fDAG.add(std::move(background[i]));
+        }
+        fDAG.noteIntentionalSplit();
+    }
+    fFlushing = false;
+
+    return result;
+}
+
+bool GrDrawingManager::executeDAG(GrOpFlushState* flushState,
+                                  GrOnFlushResourceProvider* onFlushProvider) {
     // Prepare any onFlush op lists (e.g. atlases).
     if (!fOnFlushCBObjects.empty()) {
         fDAG.gatherIDs(&fFlushingOpListIDs);
 
         SkSTArray<4, sk_sp<GrRenderTargetContext>> renderTargetContexts;
         for (GrOnFlushCallbackObject* onFlushCBObject : fOnFlushCBObjects) {
-            onFlushCBObject->preFlush(&onFlushProvider,
+            onFlushCBObject->preFlush(onFlushProvider,
                                       fFlushingOpListIDs.begin(), fFlushingOpListIDs.count(),
                                       &renderTargetContexts);
             for (const sk_sp<GrRenderTargetContext>& rtc : renderTargetContexts) {
@@ -260,7 +418,7 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
                 });
 #endif
                 onFlushOpList->makeClosed(*fContext->contextPriv().caps());
-                onFlushOpList->prepare(&flushState);
+                onFlushOpList->prepare(flushState);
                 fOnFlushCBOpLists.push_back(std::move(onFlushOpList));
             }
             renderTargetContexts.reset();
@@ -287,7 +445,7 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
         }
 
         GrResourceAllocator::AssignError error = GrResourceAllocator::AssignError::kNoError;
-        while (alloc.assign(&startIndex, &stopIndex, flushState.uninstantiateProxyTracker(),
+        while (alloc.assign(&startIndex, &stopIndex, flushState->uninstantiateProxyTracker(),
                             &error)) {
             if (GrResourceAllocator::AssignError::kFailedProxyInstantiation == error) {
                 for (int i = startIndex; i < stopIndex; ++i) {
@@ -301,7 +459,7 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
                 }
             }
 
-            if (this->executeOpLists(startIndex, stopIndex, &flushState)) {
+            if (this->executeOpLists(startIndex, stopIndex, flushState)) {
                 flushed = true;
             }
         }
@@ -317,31 +475,29 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
 #endif
     fDAG.reset();
 
-#ifdef SK_DEBUG
-    // In non-DDL mode this checks that all the flushed ops have been freed from the memory pool.
-    // When we move to partial flushes this assert will no longer be valid.
-    // In DDL mode this check is somewhat superfluous since the memory for most of the ops/opLists
-    // will be stored in the DDL's GrOpMemoryPools.
-    GrOpMemoryPool* opMemoryPool = fContext->contextPriv().opMemoryPool();
-    opMemoryPool->isEmpty();
-#endif
-
-    GrSemaphoresSubmitted result = gpu->finishFlush(numSemaphores, backendSemaphores);
-
-    flushState.uninstantiateProxyTracker()->uninstantiateAllProxies();
+    return flushed;
+}
 
-    // Give the cache a chance to purge resources that become purgeable due to flushing.
-    if (flushed) {
-        fContext->contextPriv().getResourceCache()->purgeAsNeeded();
-    }
+void GrDrawingManager::callPostFlush() {
     for (GrOnFlushCallbackObject* onFlushCBObject : fOnFlushCBObjects) {
         onFlushCBObject->postFlush(fTokenTracker.nextTokenToFlush(), fFlushingOpListIDs.begin(),
                                    fFlushingOpListIDs.count());
     }
     fFlushingOpListIDs.reset();
-    fFlushing = false;
+}
 
-    return result;
+// Executes the opList, bracketed by GPU timestamps if GrContext::setGpuTiming() asked for them.
+static bool execute_op_list(GrOpList* opList, GrOpFlushState* flushState) {
+    GrGpuTimingQueue* timing = flushState->gpu()->gpuTimingQueue();
+    if (!timing || !timing->timeOpLists()) {
+        return opList->execute(flushState);
+    }
+    int64_t bracket = timing->begin(opList->asRenderTargetOpList() ? "RenderTargetOpList"
+                                                                   : "TextureOpList",
+                                    opList->uniqueID());
+    bool executed = opList->execute(flushState);
+    timing->end(bracket);
+    return executed;
 }
 
 bool GrDrawingManager::executeOpLists(int startIndex, int stopIndex, GrOpFlushState* flushState) {
@@ -391,7 +547,7 @@ bool GrDrawingManager::executeOpLists(int startIndex, int stopIndex, GrOpFlushSt
 
     // Execute the onFlush op lists first, if any.
     for (sk_sp<GrOpList>& onFlushOpList : fOnFlushCBOpLists) {
-        if (!onFlushOpList->execute(flushState)) {
+        if (!execute_op_list(onFlushOpList.get(), flushState)) {
             SkDebugf("WARNING: onFlushOpList failed to execute.\n");
         }
         SkASSERT(onFlushOpList->unique());
@@ -405,10 +561,11 @@ bool GrDrawingManager::executeOpLists(int startIndex, int stopIndex, GrOpFlushSt
             continue;
         }
 
-        if (fDAG.opList(i)->execute(flushState)) {
+        if (execute_op_list(fDAG.opList(i), flushState)) {
             anyOpListsExecuted = true;
         }
     }
+    flushState->endRenderPass();
 
     SkASSERT(!flushState->commandBuffer());
     SkASSERT(fTokenTracker.nextDrawToken() == fTokenTracker.nextTokenToFlush());
@@ -563,10 +720,14 @@ sk_sp<GrRenderTargetOpList> GrDrawingManager::newRTOpList(GrRenderTargetProxy* r
                                                         resourceProvider,
                                                         fContext->contextPriv().refOpMemoryPool(),
                                                         rtp,
-                                                        fContext->contextPriv().getAuditTrail()));
+                                                        fContext->contextPriv().getAuditTrail(),
+                                                        fSpatialOpCombining));
     SkASSERT(rtp->getLastOpList() == opList.get());
 
     if (managedOpList) {
+        if (fRecordingBackgroundWork) {
+            opList->setFlag(GrOpList::kBackground_Flag);
+        }
         fDAG.add(opList);
 
         if (!fDAG.sortingOpLists() || !fReduceOpListSplitting) {
@@ -607,6 +768,9 @@ sk_sp<GrTextureOpList> GrDrawingManager::newTextureOpList(GrTextureProxy* textur
 
     SkASSERT(textureProxy->getLastOpList() == opList.get());
 
+    if (fRecordingBackgroundWork) {
+        opList->setFlag(GrOpList::kBackground_Flag);
+    }
     fDAG.add(opList);
     if (!fDAG.sortingOpLists() || !fReduceOpListSplitting) {
         fActiveOpList = opList.get();
@@ -11,12 +11,14 @@
 #include "GrPathRenderer.h"
 #include "GrPathRendererChain.h"
 #include "GrResourceCache.h"
+#include "SkMemoryPressure.h"
 #include "SkTArray.h"
 #include "text/GrTextContext.h"
 
 class GrContext;
 class GrCoverageCountingPathRenderer;
 class GrOnFlushCallbackObject;
+class GrOnFlushResourceProvider;
 class GrRenderTargetContext;
 class GrRenderTargetProxy;
 class GrSingleOWner;
@@ -80,6 +82,11 @@ public:
     void moveOpListsToDDL(SkDeferredDisplayList* ddl);
     void copyOpListsFromDDL(const SkDeferredDisplayList*, GrRenderTargetProxy* newDest);
 
+    // See GrContext::setWorkPriority() and GrContext::setFlushTimeBudget().
+    void setRecordingBackgroundWork(bool background);
+    bool recordingBackgroundWork() const { return fRecordingBackgroundWork; }
+    void setFlushTimeBudget(uint64_t microseconds) { fFlushTimeBudgetNs = microseconds * 1000; }
+
 private:
     // This class encapsulates maintenance and manipulation of the drawing manager's DAG of opLists.
     class OpListDAG {
@@ -122,17 +129,27 @@ private:
 
         void swap(SkTArray<sk_sp<GrOpList>>* opLists);
 
+        // Moves the background opLists that can run after all the others out of the DAG, keeping
+        // their order. Call after prepForFlush().
+        void removeBackgroundOpLists(SkTArray<sk_sp<GrOpList>>* background);
+
         bool sortingOpLists() const { return fSortOpLists; }
 
+        // Notes that opLists were split on purpose, by a change of work priority or by deferring
+        // background work, so sequential opLists may now share a target.
+        void noteIntentionalSplit() { fIntentionalSplit = true; }
+
     private:
         SkTArray<sk_sp<GrOpList>> fOpLists;
         bool                      fSortOpLists;
+        bool                      fIntentionalSplit = false;
     };
 
     GrDrawingManager(GrContext*, const GrPathRendererChain::Options&,
                      const GrTextContext::Options&, GrSingleOwner*,
                      bool explicitlyAllocating, GrContextOptions::Enable sortRenderTargets,
-                     GrContextOptions::Enable reduceOpListSplitting);
+                     GrContextOptions::Enable reduceOpListSplitting,
+                     GrContextOptions::Enable spatialOpCombining);
 
     void abandon();
     void cleanup();
@@ -140,9 +157,18 @@ private:
     // return true if any opLists were actually executed; false otherwise
     bool executeOpLists(int startIndex, int stopIndex, GrOpFlushState*);
 
+    // Runs the onFlush callbacks for, allocates, and executes every opList in the DAG, leaving it
+    // empty. Returns true if any opLists were actually executed.
+    bool executeDAG(GrOpFlushState*, GrOnFlushResourceProvider*);
+    // Ends the onFlush callbacks' view of the last executeDAG() pass.
+    void callPostFlush();
+
+    // Only GrContext::flush() sets 'mayDeferBackgroundWork'; every other flush must execute all
+    // the work recorded so far.
     GrSemaphoresSubmitted flush(GrSurfaceProxy* proxy,
                                 int numSemaphores = 0,
-                                GrBackendSemaphore backendSemaphores[] = nullptr);
+                                GrBackendSemaphore backendSemaphores[] = nullptr,
+                                bool mayDeferBackgroundWork = false);
 
     SkDEBUGCODE(void validate() const);
 
@@ -176,8 +202,14 @@ private:
     GrTokenTracker                    fTokenTracker;
     bool                              fFlushing;
     bool                              fReduceOpListSplitting;
+    bool                              fSpatialOpCombining;
+    bool                              fRecordingBackgroundWork = false;
+    uint64_t                          fFlushTimeBudgetNs = 0;
 
     SkTArray<GrOnFlushCallbackObject*> fOnFlushCBObjects;
+
+    // SkGraphics::OnMemoryPressure() posts here; the context frees memory after its next flush.
+    SkMessageBus<SkMemoryPressureMessage>::Inbox fMemoryPressureInbox;
 };
 
 #endif
@@ -8,6 +8,7 @@
 
 #include "GrGpu.h"
 
+#include "GrAsyncReadQueue.h"
 #include "GrBackendSemaphore.h"
 #include "GrBackendSurface.h"
 #include "GrBuffer.h"
@@ -15,6 +16,7 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrGpuResourcePriv.h"
+#include "GrGpuTimingQueue.h"
 #include "GrMesh.h"
 #include "GrPathRendering.h"
 #include "GrPipeline.h"
@@ -41,7 +43,14 @@ GrGpu::GrGpu(GrContext* context)
 
 GrGpu::~GrGpu() {}
 
-void GrGpu::disconnect(DisconnectType) {}
+void GrGpu::disconnect(DisconnectType type) {
+    if (fAsyncReadQueue) {
+        fAsyncReadQueue->abandon(DisconnectType::kCleanup == type);
+    }
+    if (fGpuTimingQueue) {
+        fGpuTimingQueue->abandon(DisconnectType::kCleanup == type);
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -123,6 +132,12 @@ sk_sp<GrTexture> GrGpu::createTexture(const GrSurfaceDesc& origDesc, SkBudgeted
         return nullptr;
     }
 
+    // Compressed textures get all of their data, a single level of it, when they are created.
+    if (GrPixelConfigIsCompressed(desc.fConfig) &&
+        (isRT || 1 != mipLevelCount || !texels[0].fPixels)) {
+        return nullptr;
+    }
+
     this->handleDirtyContext();
     sk_sp<GrTexture> tex = this->onCreateTexture(desc, budgeted, texels, mipLevelCount);
     if (tex) {
@@ -221,6 +236,9 @@ bool GrGpu::copySurface(GrSurface* dst, GrSurfaceOrigin dstOrigin,
 bool GrGpu::readPixels(GrSurface* surface, int left, int top, int width, int height,
                        GrColorType dstColorType, void* buffer, size_t rowBytes) {
     SkASSERT(surface);
+    if (GrPixelConfigIsCompressed(surface->config())) {
+        return false;
+    }
 
     int bpp = GrColorTypeBytesPerPixel(dstColorType);
     if (!GrSurfacePriv::AdjustReadPixelParams(surface->width(), surface->height(), bpp,
@@ -238,6 +256,9 @@ bool GrGpu::readPixels(GrSurface* surface, int left, int top, int width, int hei
 bool GrGpu::writePixels(GrSurface* surface, int left, int top, int width, int height,
                         GrColorType srcColorType, const GrMipLevel texels[], int mipLevelCount) {
     SkASSERT(surface);
+    if (GrPixelConfigIsCompressed(surface->config())) {
+        return false;
+    }
     if (1 == mipLevelCount) {
         // We require that if we are not mipped, then the write region is contained in the surface
         SkIRect subRect = SkIRect::MakeXYWH(left, top, width, height);
@@ -271,6 +292,9 @@ bool GrGpu::transferPixels(GrTexture* texture, int left, int top, int width, int
                            GrColorType bufferColorType, GrBuffer* transferBuffer, size_t offset,
                            size_t rowBytes) {
     SkASSERT(transferBuffer);
+    if (GrPixelConfigIsCompressed(texture->config())) {
+        return false;
+    }
 
     // We require that the write region is contained in the texture
     SkIRect subRect = SkIRect::MakeXYWH(left, top, width, height);
@@ -291,6 +315,51 @@ bool GrGpu::transferPixels(GrTexture* texture, int left, int top, int width, int
     return false;
 }
 
+bool GrGpu::transferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                               GrColorType bufferColorType, GrBuffer* transferBuffer,
+                               size_t offset) {
+    SkASSERT(surface);
+    SkASSERT(transferBuffer);
+
+    // We require that the read region is contained in the surface
+    SkIRect subRect = SkIRect::MakeXYWH(left, top, width, height);
+    SkIRect bounds = SkIRect::MakeWH(surface->width(), surface->height());
+    if (subRect.isEmpty() || !bounds.contains(subRect)) {
+        return false;
+    }
+    size_t size = (size_t)width * height * GrColorTypeBytesPerPixel(bufferColorType);
+    if (offset + size > transferBuffer->sizeInBytes()) {
+        return false;
+    }
+
+    this->handleDirtyContext();
+    return this->onTransferPixelsFrom(surface, left, top, width, height, bufferColorType,
+                                      transferBuffer, offset);
+}
+
+GrAsyncReadQueue* GrGpu::asyncReadQueue() {
+    if (!fTriedAsyncReadQueue) {
+        fAsyncReadQueue = GrAsyncReadQueue::Make(this);
+        fTriedAsyncReadQueue = true;
+    }
+    return fAsyncReadQueue.get();
+}
+
+bool GrGpu::setGpuTiming(GrContext::GpuTimingLevel level, GrContext::GpuTimingCallback callback,
+                         void* context) {
+    if (!fGpuTimingQueue) {
+        if (GrContext::GpuTimingLevel::kNone == level) {
+            return true;
+        }
+        fGpuTimingQueue = GrGpuTimingQueue::Make(this);
+        if (!fGpuTimingQueue) {
+            return false;
+        }
+    }
+    fGpuTimingQueue->setLevel(level, callback, context);
+    return true;
+}
+
 bool GrGpu::regenerateMipMapLevels(GrTexture* texture) {
     SkASSERT(texture);
     SkASSERT(this->caps()->mipMapSupport());
@@ -353,6 +422,13 @@ GrSemaphoresSubmitted GrGpu::finishFlush(int numSemaphores,
         }
     }
     this->onFinishFlush((numSemaphores > 0 && this->caps()->fenceSyncSupport()));
+    // Fence the staged uploads and async reads only now that their transfers have been submitted.
+    if (GrStagingBufferRing* ring = resourceProvider->stagingBufferRing()) {
+        ring->didSubmit();
+    }
+    if (fAsyncReadQueue) {
+        fAsyncReadQueue->didSubmit();
+    }
     return this->caps()->fenceSyncSupport() ? GrSemaphoresSubmitted::kYes
                                             : GrSemaphoresSubmitted::kNo;
 }
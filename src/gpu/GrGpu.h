@@ -9,6 +9,7 @@
 #define GrGpu_DEFINED
 
 #include "GrCaps.h"
+#include "GrContext.h"
 #include "GrGpuCommandBuffer.h"
 #include "GrProgramDesc.h"
 #include "GrSwizzle.h"
@@ -20,6 +21,8 @@
 #include "SkTArray.h"
 #include <map>
 
+class GrAsyncReadQueue;
+class GrGpuTimingQueue;
 class GrBackendRenderTarget;
 class GrBackendSemaphore;
 class GrBuffer;
@@ -39,6 +42,7 @@ class GrStencilAttachment;
 class GrStencilSettings;
 class GrSurface;
 class GrTexture;
+class SkData;
 class SkJSONWriter;
 
 class GrGpu : public SkRefCnt {
@@ -213,6 +217,38 @@ public:
                         GrColorType bufferColorType, GrBuffer* transferBuffer, size_t offset,
                         size_t rowBytes);
 
+    /**
+     * Reads the pixels in a rectangle of a surface into a buffer without waiting for them. The
+     * read is ordered after all previously issued GPU work, and the buffer may only be mapped once
+     * a fence inserted after the next submit has signaled. Unlike readPixels() there is no
+     * conversion: the color type must be what the caps report as supported for reading the
+     * surface's config.
+     *
+     * @param surface          The surface to read from.
+     * @param left             left edge of the rectangle to read (inclusive)
+     * @param top              top edge of the rectangle to read (inclusive)
+     * @param width            width of rectangle to read in pixels.
+     * @param height           height of rectangle to read in pixels.
+     * @param bufferColorType  the color type of the transfer buffer's pixel data
+     * @param transferBuffer   GrBuffer to write pixels to (type must be "kXferGpuToCpu")
+     * @param offset           offset from the start of the buffer. Rows are tightly packed.
+     */
+    bool transferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                            GrColorType bufferColorType, GrBuffer* transferBuffer, size_t offset);
+
+    /**
+     * Returns the queue of reads waiting on transferPixelsFrom() to complete, creating it on first
+     * use. Returns nullptr if the backend lacks transfer buffer or fence support.
+     */
+    GrAsyncReadQueue* asyncReadQueue();
+
+    /**
+     * Returns the queue that times opLists and ops for GrContext::setGpuTiming(), or nullptr if
+     * timing has never been turned on.
+     */
+    GrGpuTimingQueue* gpuTimingQueue() { return fGpuTimingQueue.get(); }
+    bool setGpuTiming(GrContext::GpuTimingLevel, GrContext::GpuTimingCallback, void* context);
+
     // After the client interacts directly with the 3D context state the GrGpu
     // must resync its internal state and assumptions about 3D context state.
     // Each time this occurs the GrGpu bumps a timestamp.
@@ -262,6 +298,15 @@ public:
     virtual bool waitFence(GrFence, uint64_t timeout = 1000) = 0;
     virtual void deleteFence(GrFence) const = 0;
 
+    /**
+     * Writes a GPU timestamp once the GPU has finished the work issued so far. Returns 0 if the
+     * backend can't (see GrCaps::gpuTimingSupport()). getTimestamp() returns false, without
+     * waiting, if the GPU hasn't written the timestamp yet.
+     */
+    virtual GrTimestampQuery insertTimestamp() { return 0; }
+    virtual bool getTimestamp(GrTimestampQuery, uint64_t* nanoseconds) { return false; }
+    virtual void deleteTimestamp(GrTimestampQuery) {}
+
     virtual sk_sp<GrSemaphore> SK_WARN_UNUSED_RESULT makeSemaphore(bool isOwned = true) = 0;
     virtual sk_sp<GrSemaphore> wrapBackendSemaphore(const GrBackendSemaphore& semaphore,
                                                     GrResourceProvider::SemaphoreWrapType wrapType,
@@ -276,6 +321,24 @@ public:
      */
     virtual sk_sp<GrSemaphore> prepareTextureForCrossContextUsage(GrTexture*) = 0;
 
+    /** Saves the backend's pipeline cache, if it has one, to the context's PersistentCache. */
+    virtual void storeVkPipelineCacheData() {}
+
+    /** Deletes the programs the backend has cached, if it caches them. */
+    virtual void purgeProgramCache() {}
+
+    /**
+     * Starts building the program for a PersistentCache entry ahead of its first use. Returns
+     * false if the backend can't, or the entry isn't one of its programs.
+     */
+    virtual bool precompileShader(const SkData& key, const SkData& data) { return false; }
+
+    /**
+     * Starts generating shaders for the programs of a serialized GrShaderCapture. Returns how many
+     * were started, or -1 if the data isn't a capture.
+     */
+    virtual int precompileShaders(const SkData& capturedShaders) { return 0; }
+
     ///////////////////////////////////////////////////////////////////////////
     // Debugging and Stats
 
@@ -293,6 +356,19 @@ public:
             fStencilAttachmentCreates = 0;
             fNumDraws = 0;
             fNumFailedDraws = 0;
+            fPersistentCacheHits = 0;
+            fPersistentCacheMisses = 0;
+            fProgramCacheHits = 0;
+            fProgramCacheMisses = 0;
+            fShaderCompileNs = 0;
+            fPipelineCreates = 0;
+            fPipelineCreateNs = 0;
+            fUniformUploads = 0;
+            fUniformUploadsElided = 0;
+            fVertexAttribSetups = 0;
+            fVertexAttribSetupsElided = 0;
+            fBufferBinds = 0;
+            fBufferBindsElided = 0;
         }
 
         int renderTargetBinds() const { return fRenderTargetBinds; }
@@ -312,6 +388,38 @@ public:
         void dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values);
         int numDraws() const { return fNumDraws; }
         int numFailedDraws() const { return fNumFailedDraws; }
+        // Programs whose compiled shaders were or weren't found in the PersistentCache.
+        int persistentCacheHits() const { return fPersistentCacheHits; }
+        void incPersistentCacheHits() { fPersistentCacheHits++; }
+        int persistentCacheMisses() const { return fPersistentCacheMisses; }
+        void incPersistentCacheMisses() { fPersistentCacheMisses++; }
+        // Programs (or pipeline states) found in, or missing from, the backend's runtime cache.
+        int programCacheHits() const { return fProgramCacheHits; }
+        void incProgramCacheHits() { fProgramCacheHits++; }
+        int programCacheMisses() const { return fProgramCacheMisses; }
+        void incProgramCacheMisses() { fProgramCacheMisses++; }
+        // Time spent turning SkSL into backend shaders, where the backend can measure it.
+        double shaderCompileNs() const { return fShaderCompileNs; }
+        void addShaderCompileNs(double ns) { fShaderCompileNs += ns; }
+        // Backend pipeline objects (e.g. VkPipelines) created, and the time spent creating them.
+        int pipelineCreates() const { return fPipelineCreates; }
+        void incPipelineCreates() { fPipelineCreates++; }
+        double pipelineCreateNs() const { return fPipelineCreateNs; }
+        void addPipelineCreateNs(double ns) { fPipelineCreateNs += ns; }
+        // Backend state calls that were issued, and those skipped because the backend already
+        // had the requested state.
+        int uniformUploads() const { return fUniformUploads; }
+        void incUniformUploads() { fUniformUploads++; }
+        int uniformUploadsElided() const { return fUniformUploadsElided; }
+        void incUniformUploadsElided() { fUniformUploadsElided++; }
+        int vertexAttribSetups() const { return fVertexAttribSetups; }
+        void incVertexAttribSetups() { fVertexAttribSetups++; }
+        int vertexAttribSetupsElided() const { return fVertexAttribSetupsElided; }
+        void incVertexAttribSetupsElided() { fVertexAttribSetupsElided++; }
+        int bufferBinds() const { return fBufferBinds; }
+        void incBufferBinds() { fBufferBinds++; }
+        int bufferBindsElided() const { return fBufferBindsElided; }
+        void incBufferBindsElided() { fBufferBindsElided++; }
     private:
         int fRenderTargetBinds;
         int fShaderCompilations;
@@ -321,6 +429,19 @@ public:
         int fStencilAttachmentCreates;
         int fNumDraws;
         int fNumFailedDraws;
+        int fPersistentCacheHits;
+        int fPersistentCacheMisses;
+        int fProgramCacheHits;
+        int fProgramCacheMisses;
+        double fShaderCompileNs;
+        int fPipelineCreates;
+        double fPipelineCreateNs;
+        int fUniformUploads;
+        int fUniformUploadsElided;
+        int fVertexAttribSetups;
+        int fVertexAttribSetupsElided;
+        int fBufferBinds;
+        int fBufferBindsElided;
 #else
         void dump(SkString*) {}
         void dumpKeyValuePairs(SkTArray<SkString>*, SkTArray<double>*) {}
@@ -332,6 +453,19 @@ public:
         void incStencilAttachmentCreates() {}
         void incNumDraws() {}
         void incNumFailedDraws() {}
+        void incPersistentCacheHits() {}
+        void incPersistentCacheMisses() {}
+        void incProgramCacheHits() {}
+        void incProgramCacheMisses() {}
+        void addShaderCompileNs(double) {}
+        void incPipelineCreates() {}
+        void addPipelineCreateNs(double) {}
+        void incUniformUploads() {}
+        void incUniformUploadsElided() {}
+        void incVertexAttribSetups() {}
+        void incVertexAttribSetupsElided() {}
+        void incBufferBinds() {}
+        void incBufferBindsElided() {}
 #endif
     };
 
@@ -454,6 +588,10 @@ private:
                                   GrColorType colorType, GrBuffer* transferBuffer, size_t offset,
                                   size_t rowBytes) = 0;
 
+    // overridden by backend-specific derived class to perform the transfer to a buffer
+    virtual bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height,
+                                      GrColorType, GrBuffer* transferBuffer, size_t offset) = 0;
+
     // overridden by backend-specific derived class to perform the resolve
     virtual void onResolveRenderTarget(GrRenderTarget* target) = 0;
 
@@ -482,6 +620,9 @@ private:
     uint32_t fResetBits;
     // The context owns us, not vice-versa, so this ptr is not ref'ed by Gpu.
     GrContext* fContext;
+    std::unique_ptr<GrAsyncReadQueue> fAsyncReadQueue;
+    bool fTriedAsyncReadQueue = false;
+    std::unique_ptr<GrGpuTimingQueue> fGpuTimingQueue;
 
     friend class GrPathRendering;
     typedef SkRefCnt INHERITED;
@@ -7,6 +7,7 @@
 
 #include "GrGpuCommandBuffer.h"
 
+#include "GrAuditTrail.h"
 #include "GrContext.h"
 #include "GrCaps.h"
 #include "GrFixedClip.h"
@@ -70,5 +71,7 @@ bool GrGpuRTCommandBuffer::draw(const GrPrimitiveProcessor& primProc, const GrPi
     }
     this->onDraw(primProc, pipeline, fixedDynamicState, dynamicStateArrays, meshes, meshCount,
                  bounds);
+    GR_AUDIT_TRAIL_DRAW_EXECUTED(this->gpu()->getContext()->contextPriv().getAuditTrail(),
+                                 primProc, pipeline, meshCount, bounds);
     return true;
 }
@@ -27,6 +27,7 @@ GrGpuResource::GrGpuResource(GrGpu* gpu)
     , fRefsWrappedObjects(false)
     , fUniqueID(CreateUniqueID()) {
     SkDEBUGCODE(fCacheArrayIndex = -1);
+    fCachePartition = 0;
 }
 
 void GrGpuResource::registerWithCache(SkBudgeted budgeted) {
@@ -73,6 +73,9 @@ private:
 
     int* accessCacheIndex() const { return &fResource->fCacheArrayIndex; }
 
+    int partition() const { return fResource->fCachePartition; }
+    void setPartition(int partition) { fResource->fCachePartition = partition; }
+
     CacheAccess(GrGpuResource* resource) : fResource(resource) {}
     CacheAccess(const CacheAccess& that) : fResource(that.fResource) {}
     CacheAccess& operator=(const CacheAccess&); // unimpl
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrGpuTimingQueue.h"
+
+#include "GrCaps.h"
+#include "GrGpu.h"
+
+std::unique_ptr<GrGpuTimingQueue> GrGpuTimingQueue::Make(GrGpu* gpu) {
+    if (!gpu->caps()->gpuTimingSupport()) {
+        return nullptr;
+    }
+    return std::unique_ptr<GrGpuTimingQueue>(new GrGpuTimingQueue(gpu));
+}
+
+GrGpuTimingQueue::~GrGpuTimingQueue() {
+    // The GrGpu is disconnected, or its context destroyed, before we are, and either way the
+    // queries have been deleted already or can't be anymore.
+    this->abandon(false);
+}
+
+void GrGpuTimingQueue::setLevel(Level level, GrContext::GpuTimingCallback callback,
+                                void* callbackContext) {
+    this->checkCompletion();
+    if (fGpu) {
+        for (const Bracket& bracket : fBrackets) {
+            this->deleteQueries(bracket);
+        }
+    }
+    fFirstBracketID += fBrackets.size();
+    fBrackets.clear();
+
+    fLevel = callback ? level : Level::kNone;
+    fCallback = callback;
+    fCallbackContext = callbackContext;
+}
+
+int64_t GrGpuTimingQueue::begin(const char* name, uint32_t opListID) {
+    SkASSERT(this->timeOpLists());
+    if (!fGpu) {
+        return -1;
+    }
+    GrTimestampQuery start = fGpu->insertTimestamp();
+    if (!start) {
+        return -1;
+    }
+    fBrackets.push_back({name, opListID, start, 0});
+    return fFirstBracketID + fBrackets.size() - 1;
+}
+
+void GrGpuTimingQueue::end(int64_t bracketID) {
+    if (bracketID < fFirstBracketID || !fGpu) {
+        return;  // Dropped by setLevel() or abandon() in the meantime.
+    }
+    SkASSERT(bracketID - fFirstBracketID < (int64_t)fBrackets.size());
+    Bracket& bracket = fBrackets[bracketID - fFirstBracketID];
+    SkASSERT(!bracket.fEnd);
+    bracket.fEnd = fGpu->insertTimestamp();
+    if (!bracket.fEnd) {
+        // Leave a zero-length bracket rather than holding up the ones after it.
+        bracket.fEnd = bracket.fStart;
+        bracket.fStart = 0;
+    }
+}
+
+void GrGpuTimingQueue::checkCompletion() {
+    while (fGpu && !fBrackets.empty() && fBrackets.front().fEnd) {
+        const Bracket& bracket = fBrackets.front();
+        uint64_t start, end;
+        if (!fGpu->getTimestamp(bracket.fEnd, &end)) {
+            return;
+        }
+        if (!bracket.fStart) {
+            start = end;
+        } else if (!fGpu->getTimestamp(bracket.fStart, &start)) {
+            return;
+        }
+        // Pop the bracket before calling back, in case the callback changes the level.
+        const char* name = bracket.fName;
+        uint32_t opListID = bracket.fOpListID;
+        this->deleteQueries(bracket);
+        fBrackets.pop_front();
+        ++fFirstBracketID;
+        if (fCallback) {
+            fCallback(fCallbackContext, name, opListID, end > start ? end - start : 0);
+        }
+    }
+}
+
+void GrGpuTimingQueue::abandon(bool deleteQueries) {
+    if (deleteQueries && fGpu) {
+        for (const Bracket& bracket : fBrackets) {
+            this->deleteQueries(bracket);
+        }
+    }
+    fGpu = nullptr;
+    fFirstBracketID += fBrackets.size();
+    fBrackets.clear();
+    fLevel = Level::kNone;
+}
+
+void GrGpuTimingQueue::deleteQueries(const Bracket& bracket) {
+    if (bracket.fStart) {
+        fGpu->deleteTimestamp(bracket.fStart);
+    }
+    if (bracket.fEnd) {
+        fGpu->deleteTimestamp(bracket.fEnd);
+    }
+}
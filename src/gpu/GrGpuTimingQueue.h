@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrGpuTimingQueue_DEFINED
+#define GrGpuTimingQueue_DEFINED
+
+#include "GrContext.h"
+#include "GrTypesPriv.h"
+
+#include <deque>
+#include <memory>
+
+class GrGpu;
+
+/**
+ * Times opLists and ops on the GPU for GrContext::setGpuTiming(). Each bracket is a pair of GPU
+ * timestamps written before and after the work. Brackets are kept in the order they began, and
+ * since the GPU writes timestamps in order they are reported in that order too, once both of the
+ * timestamps of a bracket, and of every bracket before it, are available.
+ */
+class GrGpuTimingQueue {
+public:
+    using Level = GrContext::GpuTimingLevel;
+
+    /** Returns nullptr if the GrGpu can't write timestamps. */
+    static std::unique_ptr<GrGpuTimingQueue> Make(GrGpu*);
+
+    ~GrGpuTimingQueue();
+
+    /** Reports the finished brackets to the old callback and drops the rest. */
+    void setLevel(Level, GrContext::GpuTimingCallback, void* callbackContext);
+
+    bool timeOpLists() const { return fLevel >= Level::kOpLists; }
+    bool timeOps() const { return fLevel >= Level::kOps; }
+
+    /**
+     * Writes the start timestamp of a bracket. Returns the ID to pass to end(), or -1 if the
+     * timestamp couldn't be written.
+     */
+    int64_t begin(const char* name, uint32_t opListID);
+    void end(int64_t bracketID);
+
+    /** Reports the brackets the GPU has finished. This never waits on the GPU. */
+    void checkCompletion();
+
+    /**
+     * Drops every bracket without reporting it. If 'deleteQueries' is false the queries are
+     * dropped without calling into the backend API.
+     */
+    void abandon(bool deleteQueries);
+
+private:
+    struct Bracket {
+        const char*      fName;
+        uint32_t         fOpListID;
+        GrTimestampQuery fStart;
+        GrTimestampQuery fEnd;
+    };
+
+    explicit GrGpuTimingQueue(GrGpu* gpu)
+            : fGpu(gpu)
+            , fLevel(Level::kNone)
+            , fCallback(nullptr)
+            , fCallbackContext(nullptr)
+            , fFirstBracketID(0) {}
+
+    void deleteQueries(const Bracket&);
+
+    GrGpu*                       fGpu;
+    Level                        fLevel;
+    GrContext::GpuTimingCallback fCallback;
+    void*                        fCallbackContext;
+    std::deque<Bracket>          fBrackets;
+    // The ID of fBrackets.front(). IDs count up from 0 in the order the brackets begin.
+    int64_t                      fFirstBracketID;
+};
+
+#endif
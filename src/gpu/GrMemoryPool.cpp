@@ -6,6 +6,7 @@
  */
 
 #include "GrMemoryPool.h"
+#include "SkArenaBlockPool.h"
 #include "SkMalloc.h"
 #ifdef SK_DEBUG
 #include "SkAtomics.h"
@@ -147,8 +148,9 @@ void GrMemoryPool::release(void* p) {
 
 GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t blockSize) {
     blockSize = SkTMax<size_t>(blockSize, kHeaderSize);
+    // The pool may round blockSize up, which just leaves more free space in the block.
     BlockHeader* block =
-        reinterpret_cast<BlockHeader*>(sk_malloc_throw(blockSize));
+        reinterpret_cast<BlockHeader*>(SkArenaBlockPool::Alloc(&blockSize));
     // we assume malloc gives us aligned memory
     SkASSERT(!(reinterpret_cast<intptr_t>(block) % kAlignment));
     SkDEBUGCODE(block->fBlockSentinal = kAssignedMarker);
@@ -163,7 +165,7 @@ GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t blockSize) {
 void GrMemoryPool::DeleteBlock(BlockHeader* block) {
     SkASSERT(kAssignedMarker == block->fBlockSentinal);
     SkDEBUGCODE(block->fBlockSentinal = kFreedMarker); // FWIW
-    sk_free(block);
+    SkArenaBlockPool::Free(block, block->fSize);
 }
 
 void GrMemoryPool::validate() {
@@ -10,6 +10,7 @@
 #include "GrContextPriv.h"
 #include "GrDrawOpAtlas.h"
 #include "GrGpu.h"
+#include "GrGpuCommandBuffer.h"
 #include "GrResourceProvider.h"
 #include "GrTexture.h"
 
@@ -17,12 +18,14 @@
 
 GrOpFlushState::GrOpFlushState(GrGpu* gpu,
                                GrResourceProvider* resourceProvider,
-                               GrTokenTracker* tokenTracker)
+                               GrTokenTracker* tokenTracker,
+                               SkTaskGroup* taskGroup)
         : fVertexPool(gpu)
         , fIndexPool(gpu)
         , fGpu(gpu)
         , fResourceProvider(resourceProvider)
-        , fTokenTracker(tokenTracker) {
+        , fTokenTracker(tokenTracker)
+        , fTaskGroup(taskGroup) {
 }
 
 const GrCaps& GrOpFlushState::caps() const {
@@ -33,6 +36,36 @@ GrGpuRTCommandBuffer* GrOpFlushState::rtCommandBuffer() {
     return fCommandBuffer->asRTCommandBuffer();
 }
 
+GrGpuRTCommandBuffer* GrOpFlushState::continueRenderPass(const GrRenderTarget* rt,
+                                                         GrSurfaceOrigin origin,
+                                                         const SkRect& bounds) {
+    if (!fOpenRTCommandBuffer || fOpenRenderTarget != rt || fOpenOrigin != origin ||
+        fOpenBounds != bounds || GrStoreOp::kStore != fOpenColorStoreOp) {
+        return nullptr;
+    }
+    return fOpenRTCommandBuffer;
+}
+
+void GrOpFlushState::setOpenRenderPass(GrGpuRTCommandBuffer* commandBuffer,
+                                       const GrRenderTarget* rt, GrSurfaceOrigin origin,
+                                       const SkRect& bounds, GrStoreOp colorStoreOp) {
+    SkASSERT(!fOpenRTCommandBuffer || fOpenRTCommandBuffer == commandBuffer);
+    fOpenRTCommandBuffer = commandBuffer;
+    fOpenRenderTarget = rt;
+    fOpenOrigin = origin;
+    fOpenBounds = bounds;
+    fOpenColorStoreOp = colorStoreOp;
+}
+
+void GrOpFlushState::endRenderPass() {
+    if (fOpenRTCommandBuffer) {
+        fOpenRTCommandBuffer->end();
+        fGpu->submit(fOpenRTCommandBuffer);
+        fOpenRTCommandBuffer = nullptr;
+        fOpenRenderTarget = nullptr;
+    }
+}
+
 void GrOpFlushState::executeDrawsAndUploadsForMeshDrawOp(uint32_t opID, const SkRect& opBounds) {
     SkASSERT(this->rtCommandBuffer());
     while (fCurrDraw != fDraws.end() && fCurrDraw->fOpID == opID) {
@@ -65,6 +98,7 @@ void GrOpFlushState::preExecuteDraws() {
 void GrOpFlushState::reset() {
     SkASSERT(fCurrDraw == fDraws.end());
     SkASSERT(fCurrUpload == fInlineUploads.end());
+    SkASSERT(!fOpenRTCommandBuffer);
     fVertexPool.reset();
     fIndexPool.reset();
     fArena.reset();
@@ -21,11 +21,13 @@ class GrGpu;
 class GrGpuCommandBuffer;
 class GrGpuRTCommandBuffer;
 class GrResourceProvider;
+class SkTaskGroup;
 
 /** Tracks the state across all the GrOps (really just the GrDrawOps) in a GrOpList flush. */
 class GrOpFlushState final : public GrDeferredUploadTarget, public GrMeshDrawOp::Target {
 public:
-    GrOpFlushState(GrGpu*, GrResourceProvider*, GrTokenTracker*);
+    /** If there's a task group, ops' prePrepare() may run on it. */
+    GrOpFlushState(GrGpu*, GrResourceProvider*, GrTokenTracker*, SkTaskGroup* = nullptr);
 
     ~GrOpFlushState() final { this->reset(); }
 
@@ -43,8 +45,23 @@ public:
     GrGpuRTCommandBuffer* rtCommandBuffer();
     void setCommandBuffer(GrGpuCommandBuffer* buffer) { fCommandBuffer = buffer; }
 
+    /**
+     * The render pass the last GrRenderTargetOpList drew is left open, so that a following opList
+     * that only loads what it left can keep drawing into it instead of the target being stored and
+     * loaded again in between. This returns that pass's command buffer if it targets 'rt' with the
+     * same origin and bounds and stores its color, or null otherwise.
+     */
+    GrGpuRTCommandBuffer* continueRenderPass(const GrRenderTarget* rt, GrSurfaceOrigin,
+                                             const SkRect& bounds);
+    void setOpenRenderPass(GrGpuRTCommandBuffer*, const GrRenderTarget*, GrSurfaceOrigin,
+                           const SkRect& bounds, GrStoreOp colorStoreOp);
+    /** Ends and submits the open render pass, if any. */
+    void endRenderPass();
+
     GrGpu* gpu() { return fGpu; }
 
+    SkTaskGroup* taskGroup() const { return fTaskGroup; }
+
     void reset();
 
     /** Additional data required on a per-op basis when executing GrOps. */
@@ -154,8 +171,16 @@ private:
     GrGpu* fGpu;
     GrResourceProvider* fResourceProvider;
     GrTokenTracker* fTokenTracker;
+    SkTaskGroup* fTaskGroup;
     GrGpuCommandBuffer* fCommandBuffer = nullptr;
 
+    // The render pass left open by the last GrRenderTargetOpList, if any.
+    GrGpuRTCommandBuffer* fOpenRTCommandBuffer = nullptr;
+    const GrRenderTarget* fOpenRenderTarget = nullptr;
+    GrSurfaceOrigin fOpenOrigin = kTopLeft_GrSurfaceOrigin;
+    SkRect fOpenBounds = SkRect::MakeEmpty();
+    GrStoreOp fOpenColorStoreOp = GrStoreOp::kStore;
+
     // Variables that are used to track where we are in lists as ops are executed
     SkArenaAllocList<Draw>::Iter fCurrDraw;
     SkArenaAllocList<InlineUpload>::Iter fCurrUpload;
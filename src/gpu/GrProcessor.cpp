@@ -13,7 +13,9 @@
 #include "GrSamplerState.h"
 #include "GrTextureProxy.h"
 #include "GrXferProcessor.h"
+#include "SkChecksum.h"
 #include "SkSpinlock.h"
+#include "SkThreadID.h"
 
 #if GR_TEST_UTILS
 
@@ -91,37 +93,74 @@ void GrXPFactoryTestFactory::VerifyFactoryCount() {
 #endif
 
 
-// We use a global pool protected by a mutex(spinlock). Chrome may use the same GrContext on
+// We use global pools protected by mutexes(spinlocks). Chrome may use the same GrContext on
 // different threads. The GrContext is not used concurrently on different threads and there is a
 // memory barrier between accesses of a context on different threads. Also, there may be multiple
-// GrContexts and those contexts may be in use concurrently on different threads.
+// GrContexts and those contexts may be in use concurrently on different threads, e.g. when DDLs
+// are recorded in parallel. So that those threads rarely contend for the same lock, each thread
+// allocates from one of several pools picked by its thread ID. A processor may be freed on another
+// thread than the one that made it, so the index of its pool is stored just in front of it.
 namespace {
-#if !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-static SkSpinlock gProcessorSpinlock;
+#if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
+static constexpr int kNumPools = 1;
+#else
+static constexpr int kNumPools = 8;
+static SkSpinlock gProcessorSpinlocks[kNumPools];
+#endif
+
+// Keeps the processor itself 8-byte aligned, as GrMemoryPool promises.
+static constexpr size_t kPoolIndexPad = 8;
+
+static int pool_index_for_this_thread() {
+#if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
+    return 0;
+#else
+    uint64_t id = SkGetThreadID();
+    return SkChecksum::CheapMix(static_cast<uint32_t>(id ^ (id >> 32))) % kNumPools;
 #endif
+}
+
 class MemoryPoolAccessor {
 public:
 
 // We know in the Android framework there is only one GrContext.
 #if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-    MemoryPoolAccessor() {}
+    explicit MemoryPoolAccessor(int index) : fIndex(index) {}
     ~MemoryPoolAccessor() {}
 #else
-    MemoryPoolAccessor() { gProcessorSpinlock.acquire(); }
-    ~MemoryPoolAccessor() { gProcessorSpinlock.release(); }
+    explicit MemoryPoolAccessor(int index) : fIndex(index) {
+        gProcessorSpinlocks[fIndex].acquire();
+    }
+    ~MemoryPoolAccessor() { gProcessorSpinlocks[fIndex].release(); }
 #endif
 
     GrMemoryPool* pool() const {
-        static GrMemoryPool gPool(4096, 4096);
-        return &gPool;
+        struct Pool {
+            Pool() : fPool(4096, 4096) {}
+            GrMemoryPool fPool;
+        };
+        static Pool gPools[kNumPools];
+        return &gPools[fIndex].fPool;
     }
+
+private:
+    int fIndex;
 };
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void* GrProcessor::operator new(size_t size) { return MemoryPoolAccessor().pool()->allocate(size); }
+void* GrProcessor::operator new(size_t size) {
+    int index = pool_index_for_this_thread();
+    char* mem = static_cast<char*>(
+            MemoryPoolAccessor(index).pool()->allocate(size + kPoolIndexPad));
+    *reinterpret_cast<int*>(mem) = index;
+    return mem + kPoolIndexPad;
+}
 
 void GrProcessor::operator delete(void* target) {
-    return MemoryPoolAccessor().pool()->release(target);
+    char* mem = static_cast<char*>(target) - kPoolIndexPad;
+    int index = *reinterpret_cast<int*>(mem);
+    SkASSERT(index >= 0 && index < kNumPools);
+    return MemoryPoolAccessor(index).pool()->release(mem);
 }
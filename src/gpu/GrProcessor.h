@@ -61,6 +61,8 @@ private:
 class GrProcessor {
 public:
     enum ClassID {
+        kAAFillRectGeometryProcessor_ClassID,
+        kAtlasSpriteGeometryProcessor_ClassID,
         kBigKeyProcessor_ClassID,
         kBlockInputFragmentProcessor_ClassID,
         kButtCapStrokedCircleGeometryProcessor_ClassID,
@@ -84,6 +86,7 @@ public:
         kEllipticalRRectEffect_ClassID,
         kGP_ClassID,
         kVertexColorSpaceBenchGP_ClassID,
+        kCacheBenchFP_ClassID,
         kGrAARectEffect_ClassID,
         kGrAlphaThresholdFragmentProcessor_ClassID,
         kGrArithmeticFP_ClassID,
@@ -146,6 +149,7 @@ public:
         kGrUnpremulInputFragmentProcessor_ClassID,
         kGrUnrolledBinaryGradientColorizer_ClassID,
         kGrYUVtoRGBEffect_ClassID,
+        kHairlineQuadGeometryProcessor_ClassID,
         kHighContrastFilterEffect_ClassID,
         kInstanceProcessor_ClassID,
         kLatticeGP_ClassID,
@@ -234,3 +234,17 @@ bool GrProgramDesc::Build(GrProgramDesc* desc,
     header->fHasPointSize = hasPointSize ? 1 : 0;
     return true;
 }
+
+bool GrProgramDesc::BuildFromData(GrProgramDesc* desc, const void* keyData, size_t keyLength) {
+    if (!SkIsAlign4(keyLength) || keyLength < kProcessorKeysOffset) {
+        return false;
+    }
+    desc->fKey.reset(SkToInt(keyLength));
+    memcpy(desc->fKey.begin(), keyData, keyLength);
+    if (desc->keyLength() != keyLength) {
+        return false;
+    }
+    uint32_t checksum = desc->getChecksum();
+    desc->finalize();
+    return desc->getChecksum() == checksum;
+}
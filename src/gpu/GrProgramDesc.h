@@ -45,6 +45,12 @@ public:
                       const GrPipeline&,
                       const GrShaderCaps&);
 
+    /**
+     * Rebuilds a finalized descriptor from the bytes of another's asKey(), e.g. a PersistentCache
+     * key. Returns false if they aren't a well formed key.
+     */
+    static bool BuildFromData(GrProgramDesc*, const void* keyData, size_t keyLength);
+
     // Returns this as a uint32_t array to be used as a key in the program cache.
     const uint32_t* asKey() const {
         return reinterpret_cast<const uint32_t*>(fKey.begin());
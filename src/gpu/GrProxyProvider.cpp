@@ -19,6 +19,7 @@
 #include "../private/GrSingleOwner.h"
 #include "SkAutoPixmapStorage.h"
 #include "SkBitmap.h"
+#include "SkData.h"
 #include "SkGr.h"
 #include "SkImage.h"
 #include "SkImage_Base.h"
@@ -266,6 +267,53 @@ sk_sp<GrTextureProxy> GrProxyProvider::createTextureProxy(sk_sp<SkImage> srcImag
     return proxy;
 }
 
+sk_sp<GrTextureProxy> GrProxyProvider::createCompressedTextureProxy(int width, int height,
+                                                                    SkBudgeted budgeted,
+                                                                    GrPixelConfig config,
+                                                                    sk_sp<SkData> data) {
+    ASSERT_SINGLE_OWNER
+    SkASSERT(GrPixelConfigIsCompressed(config));
+    SkASSERT(data);
+
+    if (this->isAbandoned()) {
+        return nullptr;
+    }
+
+    if (!this->caps()->isConfigTexturable(config) ||
+        data->size() != GrCompressedFormatDataSize(config, width, height)) {
+        return nullptr;
+    }
+
+    GrSurfaceDesc desc;
+    desc.fWidth = width;
+    desc.fHeight = height;
+    desc.fConfig = config;
+
+    sk_sp<GrTextureProxy> proxy = this->createLazyProxy(
+            [desc, budgeted, data](GrResourceProvider* resourceProvider) {
+                if (!resourceProvider) {
+                    return sk_sp<GrTexture>();
+                }
+                // Compressed data has no row padding, so there are no row bytes to pass along.
+                GrMipLevel mipLevel = { data->data(), 0 };
+                return resourceProvider->createTexture(desc, budgeted, &mipLevel, 1);
+            },
+            desc, kTopLeft_GrSurfaceOrigin, GrMipMapped::kNo, GrTextureType::k2D,
+            SkBackingFit::kExact, budgeted);
+
+    if (!proxy) {
+        return nullptr;
+    }
+
+    if (fResourceProvider) {
+        // As with raster images, don't defer the upload when we aren't recording a DDL.
+        if (!proxy->priv().doLazyInstantiation(fResourceProvider)) {
+            return nullptr;
+        }
+    }
+    return proxy;
+}
+
 sk_sp<GrTextureProxy> GrProxyProvider::createMipMapProxy(const GrSurfaceDesc& desc,
                                                          GrSurfaceOrigin origin,
                                                          SkBudgeted budgeted) {
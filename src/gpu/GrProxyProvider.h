@@ -19,6 +19,7 @@ class GrResourceProvider;
 class GrSingleOwner;
 class GrBackendRenderTarget;
 class SkBitmap;
+class SkData;
 class SkImage;
 
 /*
@@ -69,6 +70,14 @@ public:
             sk_sp<SkImage> srcImage, GrSurfaceDescFlags, int sampleCnt, SkBudgeted, SkBackingFit,
             GrInternalSurfaceFlags = GrInternalSurfaceFlags::kNone);
 
+    /*
+     * Create an un-mipmapped texture proxy from data that is already in a compressed config. The
+     * data must hold exactly GrCompressedFormatDataSize() bytes. We take a ref on it to keep it
+     * alive until the upload.
+     */
+    sk_sp<GrTextureProxy> createCompressedTextureProxy(int width, int height, SkBudgeted,
+                                                       GrPixelConfig, sk_sp<SkData>);
+
     /*
      * Create a mipmapped texture proxy without any data.
      *
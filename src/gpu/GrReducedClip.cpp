@@ -21,6 +21,7 @@
 #include "GrStyle.h"
 #include "GrUserStencilSettings.h"
 #include "SkClipOpPriv.h"
+#include "SkPathOps.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
 #include "effects/GrAARectEffect.h"
 #include "effects/GrConvexPolyEffect.h"
@@ -956,6 +957,69 @@ bool GrReducedClip::drawStencilClipMask(GrContext* context,
     return true;
 }
 
+// Combining elements with path ops gets expensive quickly, so only small masks are converted.
+static constexpr int kMaxCCPRClipMaskElements = 4;
+
+static bool mask_elements_to_path(const GrReducedClip::ElementList& elements,
+                                  GrReducedClip::InitialState initialState,
+                                  const SkIRect& scissor, SkPath* out) {
+    SkPath result;
+    if (GrReducedClip::InitialState::kAllIn == initialState) {
+        result.addRect(SkRect::Make(scissor));
+    }
+    for (GrReducedClip::ElementList::Iter iter(elements); iter.get(); iter.next()) {
+        const GrReducedClip::Element* element = iter.get();
+        SkPath path;
+        element->asDeviceSpacePath(&path);
+        if (kReplace_SkClipOp == element->getOp()) {
+            result = path;
+            continue;
+        }
+        // The first five clip ops match SkPathOp.
+        GR_STATIC_ASSERT((int)kDifference_SkPathOp == (int)kDifference_SkClipOp);
+        GR_STATIC_ASSERT((int)kIntersect_SkPathOp == (int)kIntersect_SkClipOp);
+        GR_STATIC_ASSERT((int)kUnion_SkPathOp == (int)kUnion_SkClipOp);
+        GR_STATIC_ASSERT((int)kXOR_SkPathOp == (int)kXOR_SkClipOp);
+        GR_STATIC_ASSERT((int)kReverseDifference_SkPathOp == (int)kReverseDifference_SkClipOp);
+        if (!Op(result, path, (SkPathOp)element->getOp(), &result)) {
+            return false;
+        }
+    }
+    out->swap(result);
+    return true;
+}
+
+bool GrReducedClip::convertMaskElementsToCCPRClipPath(GrCoverageCountingPathRenderer* ccpr) {
+    SkASSERT(ccpr);
+    SkASSERT(!fMaskElements.isEmpty());
+    if (fCCPRClipPaths.count() >= fMaxCCPRClipPaths ||
+        fMaskElements.count() > kMaxCCPRClipMaskElements) {
+        return false;
+    }
+    // CCPR always antialiases, so non-AA elements would come out differently.
+    for (ElementList::Iter iter(fMaskElements); iter.get(); iter.next()) {
+        if (!iter.get()->isAA()) {
+            return false;
+        }
+    }
+
+    const SkPath* maskPath = ccpr->findClipMaskPath(fMaskGenID, fScissor, this->numAnalyticFPs());
+    if (!maskPath) {
+        SkPath path;
+        if (!mask_elements_to_path(fMaskElements, fInitialState, fScissor, &path)) {
+            return false;
+        }
+        maskPath = ccpr->addClipMaskPath(fMaskGenID, fScissor, this->numAnalyticFPs(),
+                                         std::move(path));
+    }
+
+    // Copying the SkPath keeps its gen ID, which CCPR uses to find the clip path in each opList.
+    fCCPRClipPaths.push_back(*maskPath);
+    fMaskElements.reset();
+    fInitialState = InitialState::kAllIn;
+    return true;
+}
+
 std::unique_ptr<GrFragmentProcessor> GrReducedClip::finishAndDetachAnalyticFPs(
         GrCoverageCountingPathRenderer* ccpr, uint32_t opListID, int rtWidth, int rtHeight) {
     // Make sure finishAndDetachAnalyticFPs hasn't been called already.
@@ -87,6 +87,14 @@ public:
 
     int numAnalyticFPs() const { return fAnalyticFPs.count() + fCCPRClipPaths.count(); }
 
+    /**
+     * Attempts to replace the mask elements with a single CCPR clip path, so the mask gets
+     * rendered on the GPU into CCPR's per-flush atlas rather than into a whole texture of its own.
+     * This combines the elements with path ops. It only handles small numbers of AA elements, and
+     * leaves the mask elements alone on failure. Returns true if the mask elements were replaced.
+     */
+    bool convertMaskElementsToCCPRClipPath(GrCoverageCountingPathRenderer*);
+
     /**
      * Called once the client knows the ID of the opList that the clip FPs will operate in. This
      * method finishes any outstanding work that was waiting for the opList ID, then detaches and
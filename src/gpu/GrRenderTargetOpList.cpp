@@ -10,12 +10,17 @@
 #include "GrCaps.h"
 #include "GrGpu.h"
 #include "GrGpuCommandBuffer.h"
+#include "GrGpuResourcePriv.h"
+#include "GrGpuTimingQueue.h"
 #include "GrMemoryPool.h"
 #include "GrRect.h"
 #include "GrRenderTargetContext.h"
 #include "GrResourceAllocator.h"
+#include "GrSurfaceProxyPriv.h"
+#include "GrTextureProxy.h"
 #include "ops/GrClearOp.h"
 #include "ops/GrCopySurfaceOp.h"
+#include "SkTaskGroup.h"
 #include "SkTraceEvent.h"
 
 
@@ -24,14 +29,92 @@
 // Experimentally we have found that most combining occurs within the first 10 comparisons.
 static const int kMaxOpLookback = 10;
 static const int kMaxOpLookahead = 10;
+// Bounds how much work spatial combining does per recorded op.
+static const int kMaxSpatialCandidates = 16;
+static const int kMaxBinScan = 64;
 
 GrRenderTargetOpList::GrRenderTargetOpList(GrResourceProvider* resourceProvider,
                                            sk_sp<GrOpMemoryPool> opMemoryPool,
                                            GrRenderTargetProxy* proxy,
-                                           GrAuditTrail* auditTrail)
+                                           GrAuditTrail* auditTrail,
+                                           bool spatialOpCombining)
         : INHERITED(resourceProvider, std::move(opMemoryPool), proxy, auditTrail)
         , fLastClipStackGenID(SK_InvalidUniqueID)
         SkDEBUGCODE(, fNumClips(0)) {
+    if (spatialOpCombining) {
+        fCombineIndex.reset(new CombineIndex(proxy->width(), proxy->height()));
+    }
+}
+
+GrRenderTargetOpList::CombineIndex::CombineIndex(int width, int height)
+        : fBinWidth(SkTMax(width, 1) / SkIntToScalar(kGridSize))
+        , fBinHeight(SkTMax(height, 1) / SkIntToScalar(kGridSize)) {}
+
+SkIRect GrRenderTargetOpList::CombineIndex::binsFor(const SkRect& bounds) const {
+    // Anything off the render target lands in the edge bins.
+    auto bin = [](SkScalar v, SkScalar binSize) {
+        return SkTPin(sk_float_saturate2int(v / binSize), 0, kGridSize - 1);
+    };
+    return SkIRect::MakeLTRB(bin(bounds.fLeft, fBinWidth), bin(bounds.fTop, fBinHeight),
+                             bin(bounds.fRight, fBinWidth), bin(bounds.fBottom, fBinHeight));
+}
+
+void GrRenderTargetOpList::CombineIndex::addBounds(int opIdx, const SkRect& bounds) {
+    SkIRect bins = this->binsFor(bounds);
+    for (int y = bins.fTop; y <= bins.fBottom; ++y) {
+        for (int x = bins.fLeft; x <= bins.fRight; ++x) {
+            SkTDArray<int>& bin = fBins[y * kGridSize + x];
+            // Ops that grew are older than what's already in the bin; keep it sorted.
+            int i = bin.count();
+            while (i > 0 && bin[i - 1] > opIdx) {
+                --i;
+            }
+            if (i == 0 || bin[i - 1] != opIdx) {
+                *bin.insert(i) = opIdx;
+            }
+        }
+    }
+}
+
+void GrRenderTargetOpList::CombineIndex::addOp(int opIdx, const GrOp& op) {
+    this->addBounds(opIdx, op.bounds());
+    SkTDArray<int>* ofClass = fOpsByClass.find(op.classID());
+    if (!ofClass) {
+        ofClass = fOpsByClass.set(op.classID(), SkTDArray<int>());
+    }
+    ofClass->push_back(opIdx);
+}
+
+int GrRenderTargetOpList::CombineIndex::lastOverlapping(
+        const SkRect& bounds, const SkTArray<RecordedOp, true>& ops) const {
+    int last = -1;
+    SkIRect bins = this->binsFor(bounds);
+    for (int y = bins.fTop; y <= bins.fBottom; ++y) {
+        for (int x = bins.fLeft; x <= bins.fRight; ++x) {
+            const SkTDArray<int>& bin = fBins[y * kGridSize + x];
+            int stop = SkTMax(0, bin.count() - kMaxBinScan);
+            int i = bin.count() - 1;
+            for (; i >= stop && bin[i] > last; --i) {
+                const GrOp* op = ops[bin[i]].fOp.get();
+                if (op && GrRectsOverlap(op->bounds(), bounds)) {
+                    last = bin[i];
+                    break;
+                }
+            }
+            // Gave up before reaching the start of the bin: assume the worst.
+            if (i >= 0 && i < stop) {
+                last = SkTMax(last, bin[i]);
+            }
+        }
+    }
+    return last;
+}
+
+void GrRenderTargetOpList::CombineIndex::reset() {
+    for (SkTDArray<int>& bin : fBins) {
+        bin.reset();
+    }
+    fOpsByClass.reset();
 }
 
 void GrRenderTargetOpList::RecordedOp::deleteOp(GrOpMemoryPool* opMemoryPool) {
@@ -45,6 +128,9 @@ void GrRenderTargetOpList::deleteOps() {
         }
     }
     fRecordedOps.reset();
+    if (fCombineIndex) {
+        fCombineIndex->reset();
+    }
 }
 
 GrRenderTargetOpList::~GrRenderTargetOpList() {
@@ -74,9 +160,7 @@ void GrRenderTargetOpList::dump(bool printDependencies) const {
 }
 
 void GrRenderTargetOpList::visitProxies_debugOnly(const GrOp::VisitProxyFunc& func) const {
-    for (const RecordedOp& recordedOp : fRecordedOps) {
-        recordedOp.visitProxies(func, GrOp::VisitorType::kOther);
-    }
+    this->visitOpProxies(func);
 }
 
 static void assert_chain_bounds(const GrOp* op) {
@@ -95,6 +179,20 @@ void GrRenderTargetOpList::onPrepare(GrOpFlushState* flushState) {
     TRACE_EVENT0("skia", TRACE_FUNC);
 #endif
 
+    // Let ops do their CPU-only preparation in parallel first, if there's somewhere to do it.
+    if (SkTaskGroup* taskGroup = flushState->taskGroup()) {
+        SkSTArray<16, GrOp*, true> ops;
+        for (const RecordedOp& recordedOp : fRecordedOps) {
+            if (recordedOp.fOp && recordedOp.fOp->canPrePrepare()) {
+                ops.push_back(recordedOp.fOp.get());
+            }
+        }
+        if (ops.count() > 1) {
+            taskGroup->batch(ops.count(), [&ops](int i) { ops[i]->prePrepare(); });
+            taskGroup->wait();
+        }
+    }
+
     // Loop over the ops that haven't yet been prepared.
     for (int i = 0; i < fRecordedOps.count(); ++i) {
         if (fRecordedOps[i].fOp && fRecordedOps[i].fOp->isChainHead()) {
@@ -120,11 +218,12 @@ static GrGpuRTCommandBuffer* create_command_buffer(GrGpu* gpu,
                                                    GrSurfaceOrigin origin,
                                                    const SkRect& bounds,
                                                    GrLoadOp colorLoadOp,
+                                                   GrStoreOp colorStoreOp,
                                                    GrColor loadClearColor,
                                                    GrLoadOp stencilLoadOp) {
     const GrGpuRTCommandBuffer::LoadAndStoreInfo kColorLoadStoreInfo {
         colorLoadOp,
-        GrStoreOp::kStore,
+        colorStoreOp,
         loadClearColor
     };
 
@@ -159,18 +258,34 @@ bool GrRenderTargetOpList::onExecute(GrOpFlushState* flushState) {
     SkASSERT(fTarget.get()->peekRenderTarget());
     TRACE_EVENT0("skia", TRACE_FUNC);
 
-    // TODO: at the very least, we want the stencil store op to always be discard (at this
-    // level). In Vulkan, sub-command buffers would still need to load & store the stencil buffer.
-    GrGpuRTCommandBuffer* commandBuffer = create_command_buffer(
-                                                    flushState->gpu(),
-                                                    fTarget.get()->peekRenderTarget(),
-                                                    fTarget.get()->origin(),
-                                                    fTarget.get()->getBoundsRect(),
-                                                    fColorLoadOp,
-                                                    fLoadClearColor,
-                                                    fStencilLoadOp);
+    GrRenderTarget* rt = fTarget.get()->peekRenderTarget();
+    GrSurfaceOrigin origin = fTarget.get()->origin();
+    SkRect bounds = fTarget.get()->getBoundsRect();
+
+    // If the last opList drew to the same target and this one only loads what it left, carry on
+    // in its render pass rather than storing the target and loading it straight back.
+    GrGpuRTCommandBuffer* commandBuffer = nullptr;
+    if (GrLoadOp::kLoad == fColorLoadOp && GrLoadOp::kLoad == fStencilLoadOp) {
+        commandBuffer = flushState->continueRenderPass(rt, origin, bounds);
+    }
+    if (!commandBuffer) {
+        flushState->endRenderPass();
+
+        // TODO: at the very least, we want the stencil store op to always be discard (at this
+        // level). In Vulkan, sub-command buffers would still need to load & store the stencil
+        // buffer.
+        GrStoreOp colorStoreOp = this->targetIsTransient() ? GrStoreOp::kDiscard
+                                                           : GrStoreOp::kStore;
+        commandBuffer = create_command_buffer(flushState->gpu(), rt, origin, bounds,
+                                              fColorLoadOp, colorStoreOp, fLoadClearColor,
+                                              fStencilLoadOp);
+        commandBuffer->begin();
+        flushState->setOpenRenderPass(commandBuffer, rt, origin, bounds, colorStoreOp);
+    }
     flushState->setCommandBuffer(commandBuffer);
-    commandBuffer->begin();
+
+    GrGpuTimingQueue* timing = flushState->gpu()->gpuTimingQueue();
+    bool timeOps = timing && timing->timeOps();
 
     // Draw all the generated geometry.
     for (int i = 0; i < fRecordedOps.count(); ++i) {
@@ -189,17 +304,40 @@ bool GrRenderTargetOpList::onExecute(GrOpFlushState* flushState) {
         };
 
         flushState->setOpArgs(&opArgs);
+        int64_t bracket = timeOps ? timing->begin(fRecordedOps[i].fOp->name(), this->uniqueID())
+                                  : -1;
+        GR_AUDIT_TRAIL_OP_EXECUTING(fAuditTrail, fRecordedOps[i].fOp.get());
         fRecordedOps[i].fOp->execute(flushState);
+        GR_AUDIT_TRAIL_OP_EXECUTED(fAuditTrail);
+        if (bracket >= 0) {
+            timing->end(bracket);
+        }
         flushState->setOpArgs(nullptr);
     }
 
-    commandBuffer->end();
-    flushState->gpu()->submit(commandBuffer);
+    // The pass is ended and submitted by whatever executes next (see
+    // GrOpFlushState::endRenderPass()).
     flushState->setCommandBuffer(nullptr);
 
     return true;
 }
 
+bool GrRenderTargetOpList::targetIsTransient() const {
+    // The opList's own ref and pending write must be all there is on the target. Anything that
+    // could still read it, be it a later opList, an image or a render target context, holds more.
+    const GrSurfaceProxy* proxy = fTarget.get();
+    if (!proxy->priv().isOnlyReferencedByWriter()) {
+        return false;
+    }
+    // The client may read a wrapped target, and a keyed one can be found again.
+    const GrSurface* surface = proxy->peekSurface();
+    if (surface->resourcePriv().refsWrappedObjects() || surface->getUniqueKey().isValid()) {
+        return false;
+    }
+    const GrTextureProxy* texProxy = proxy->asTextureProxy();
+    return !texProxy || !texProxy->getUniqueKey().isValid();
+}
+
 void GrRenderTargetOpList::endFlush() {
     fLastClipStackGenID = SK_InvalidUniqueID;
     this->deleteOps();
@@ -259,6 +397,12 @@ bool GrRenderTargetOpList::copySurface(GrContext* context,
     return true;
 }
 
+void GrRenderTargetOpList::visitOpProxies(const std::function<void(GrSurfaceProxy*)>& func) const {
+    for (const RecordedOp& recordedOp : fRecordedOps) {
+        recordedOp.visitProxies(func, GrOp::VisitorType::kOther);
+    }
+}
+
 void GrRenderTargetOpList::purgeOpsWithUninstantiatedProxies() {
     bool hasUninstantiatedProxy = false;
     auto checkInstantiation = [&hasUninstantiatedProxy](GrSurfaceProxy* p) {
@@ -408,6 +552,16 @@ uint32_t GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
     } else {
         GrOP_INFO("\t\tBackward: FirstOp\n");
     }
+    if (fCombineIndex && fRecordedOps.count() > kMaxOpLookback) {
+        int mergedIdx = this->spatialCombine(op.get(), clip, dstProxy, caps);
+        if (mergedIdx >= 0) {
+            const RecordedOp& candidate = fRecordedOps[mergedIdx];
+            GR_AUDIT_TRAIL_OPS_RESULT_COMBINED(fAuditTrail, candidate.fOp.get(), op.get());
+            fCombineIndex->addBounds(mergedIdx, candidate.fOp->bounds());
+            fOpMemoryPool->release(std::move(op));
+            return SK_InvalidUniqueID;
+        }
+    }
     GR_AUDIT_TRAIL_OP_RESULT_NEW(fAuditTrail, op);
     if (clip) {
         clip = fClipAllocator.make<GrAppliedClip>(std::move(*clip));
@@ -443,9 +597,47 @@ uint32_t GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
         }
     }
     fRecordedOps.emplace_back(std::move(op), clip, dstProxy);
+    if (fCombineIndex) {
+        fCombineIndex->addOp(fRecordedOps.count() - 1, *fRecordedOps.back().fOp);
+    }
     return this->uniqueID();
 }
 
+int GrRenderTargetOpList::spatialCombine(GrOp* op, const GrAppliedClip* clip,
+                                         const DstProxy* dstProxy, const GrCaps& caps) {
+    const SkTDArray<int>* candidates = fCombineIndex->opsOfClass(op->classID());
+    if (!candidates) {
+        return -1;
+    }
+    // The op may only move back as far as the most recent op it overlaps, which it could still
+    // merge into.
+    int barrier = fCombineIndex->lastOverlapping(op->bounds(), fRecordedOps);
+    int firstTried = fRecordedOps.count() - kMaxOpLookback;
+    int tries = 0;
+    for (int i = candidates->count() - 1; i >= 0 && tries < kMaxSpatialCandidates; --i) {
+        int idx = (*candidates)[i];
+        if (idx < barrier) {
+            break;
+        }
+        if (idx >= firstTried) {
+            continue;
+        }
+        // Ops in a chain draw in their chain head's slot, so only consider unchained ops.
+        const RecordedOp& candidate = fRecordedOps[idx];
+        if (!candidate.fOp || !candidate.fOp->isChainHead() || !candidate.fOp->isChainTail()) {
+            continue;
+        }
+        ++tries;
+        if (GrOp::CombineResult::kMerged ==
+                this->combineIfPossible(candidate, op, clip, dstProxy, caps)) {
+            GrOP_INFO("\t\tSpatial: Combining with (%s, opID: %u)\n",
+                      candidate.fOp->name(), candidate.fOp->uniqueID());
+            return idx;
+        }
+    }
+    return -1;
+}
+
 void GrRenderTargetOpList::forwardCombine(const GrCaps& caps) {
     SkASSERT(!this->isClosed());
 
@@ -19,6 +19,8 @@
 #include "SkStringUtils.h"
 #include "SkStrokeRec.h"
 #include "SkTArray.h"
+#include "SkTDArray.h"
+#include "SkTHash.h"
 #include "SkTLazy.h"
 #include "SkTypes.h"
 
@@ -32,8 +34,12 @@ private:
     using DstProxy = GrXferProcessor::DstProxy;
 
 public:
+    /**
+     * With spatialOpCombining, ops may also combine with compatible ops recorded before the
+     * fixed lookback window, as long as no op recorded since overlaps them.
+     */
     GrRenderTargetOpList(GrResourceProvider*, sk_sp<GrOpMemoryPool>,
-                         GrRenderTargetProxy*, GrAuditTrail*);
+                         GrRenderTargetProxy*, GrAuditTrail*, bool spatialOpCombining = false);
 
     ~GrRenderTargetOpList() override;
 
@@ -43,6 +49,7 @@ public:
         }
 
         this->forwardCombine(caps);
+        fCombineIndex.reset();
 
         INHERITED::makeClosed(caps);
     }
@@ -128,6 +135,10 @@ private:
 
     void deleteOps();
 
+    // True if nothing can read the target's color once this opList has drawn it, so that the
+    // render pass need not store it.
+    bool targetIsTransient() const;
+
     struct RecordedOp {
         RecordedOp(std::unique_ptr<GrOp> op, GrAppliedClip* appliedClip, const DstProxy* dstProxy)
                 : fOp(std::move(op)), fAppliedClip(appliedClip) {
@@ -162,6 +173,8 @@ private:
 
     void purgeOpsWithUninstantiatedProxies() override;
 
+    void visitOpProxies(const std::function<void(GrSurfaceProxy*)>&) const override;
+
     void gatherProxyIntervals(GrResourceAllocator*) const override;
 
     // Returns this opList's id if the Op was recorded, or SK_InvalidUniqueID if it was combined
@@ -174,6 +187,45 @@ private:
     GrOp::CombineResult combineIfPossible(const RecordedOp& a, GrOp* b, const GrAppliedClip* bClip,
                                           const DstProxy* bDstTexture, const GrCaps&);
 
+    // Tries to merge op into a compatible op recorded before the lookback window, using
+    // fCombineIndex. Returns the index of the op it merged into, or -1.
+    int spatialCombine(GrOp* op, const GrAppliedClip* clip, const DstProxy* dstProxy,
+                       const GrCaps&);
+
+    /**
+     * Indexes recorded ops by where they draw, on a coarse grid over the render target, and by
+     * op class, so spatialCombine() can find the most recent op that a new op would have to
+     * draw after, and the older ops of its class that it could merge into.
+     */
+    class CombineIndex {
+    public:
+        CombineIndex(int width, int height);
+
+        // The op at opIdx now draws within bounds; called when it is recorded and as it grows.
+        void addBounds(int opIdx, const SkRect& bounds);
+        void addOp(int opIdx, const GrOp&);
+
+        // Returns the index of the last op whose bounds overlap bounds, or an index at or after
+        // it if finding it exactly would take too long; -1 if there's none.
+        int lastOverlapping(const SkRect& bounds, const SkTArray<RecordedOp, true>& ops) const;
+        // The indices of the recorded ops of this class, in recording order.
+        const SkTDArray<int>* opsOfClass(uint32_t classID) const {
+            return fOpsByClass.find(classID);
+        }
+
+        void reset();
+
+    private:
+        static constexpr int kGridSize = 16;
+
+        SkIRect binsFor(const SkRect& bounds) const;
+
+        SkScalar fBinWidth;
+        SkScalar fBinHeight;
+        SkTDArray<int> fBins[kGridSize * kGridSize];  // Op indices, ascending.
+        SkTHashMap<uint32_t, SkTDArray<int>> fOpsByClass;
+    };
+
     uint32_t                       fLastClipStackGenID;
     SkIRect                        fLastDevClipBounds;
     int                            fLastClipNumAnalyticFPs;
@@ -181,6 +233,9 @@ private:
     // For ops/opList we have mean: 5 stdDev: 28
     SkSTArray<25, RecordedOp, true> fRecordedOps;
 
+    // Only while recording, and only with spatial op combining.
+    std::unique_ptr<CombineIndex>  fCombineIndex;
+
     // MDB TODO: 4096 for the first allocation of the clip space will be huge overkill.
     // Gather statistics to determine the correct size.
     SkArenaAlloc                   fClipAllocator{4096};
@@ -217,6 +217,15 @@ void GrResourceAllocator::recycleSurface(sk_sp<GrSurface> surface) {
     fFreePool.insert(key, surface.release());
 }
 
+// An approx-fit proxy whose dimensions aren't powers of two is treated as inexact by everything
+// that samples it (see GrProxyProvider::IsFunctionallyExact), so it can be backed by any surface at
+// least as large as its bin. Proxies with power of two dimensions are relied on to fill theirs.
+static bool can_use_larger_surface(const GrSurfaceProxy* proxy) {
+    SkASSERT(!proxy->isInstantiated());
+    return !proxy->priv().isExact() &&
+           (!SkIsPow2(proxy->width()) || !SkIsPow2(proxy->height()));
+}
+
 // First try to reuse one of the recently allocated/used GrSurfaces in the free pool.
 // If we can't find a useable one, create a new one.
 sk_sp<GrSurface> GrResourceAllocator::findSurfaceFor(const GrSurfaceProxy* proxy,
@@ -245,6 +254,17 @@ sk_sp<GrSurface> GrResourceAllocator::findSurfaceFor(const GrSurfaceProxy* proxy
         return !proxy->priv().requiresNoPendingIO() || !s->surfacePriv().hasPendingIO();
     };
     sk_sp<GrSurface> surface(fFreePool.findAndRemove(key, filter));
+    if (!surface && can_use_larger_surface(proxy)) {
+        // Rather than create a surface for the proxy's own bin, take an idle larger one. The
+        // candidates are tried from smallest to largest.
+        static const int kScales[][2] = { { 2, 1 }, { 1, 2 }, { 2, 2 } };
+        int width = proxy->worstCaseWidth();
+        int height = proxy->worstCaseHeight();
+        for (int i = 0; i < (int)SK_ARRAY_COUNT(kScales) && !surface; ++i) {
+            proxy->priv().computeScratchKey(width * kScales[i][0], height * kScales[i][1], &key);
+            surface.reset(fFreePool.findAndRemove(key, filter));
+        }
+    }
     if (surface) {
         if (SkBudgeted::kYes == proxy->isBudgeted() &&
             SkBudgeted::kNo == surface->resourcePriv().isBudgeted()) {
@@ -17,8 +17,11 @@
 #include "SkMessageBus.h"
 #include "SkOpts.h"
 #include "SkTSort.h"
+#include "SkTraceMemoryDump.h"
 #include "SkTo.h"
 
+#include <algorithm>
+
 DECLARE_SKMESSAGEBUS_MESSAGE(GrUniqueKeyInvalidatedMessage);
 
 DECLARE_SKMESSAGEBUS_MESSAGE(GrGpuResourceFreedMessage);
@@ -78,6 +81,7 @@ GrResourceCache::GrResourceCache(const GrCaps* caps, uint32_t contextUniqueID)
         , fBudgetedCount(0)
         , fBudgetedBytes(0)
         , fPurgeableBytes(0)
+        , fHasPartitionPriorities(false)
         , fInvalidUniqueKeyInbox(contextUniqueID)
         , fFreedGpuResourceInbox(contextUniqueID)
         , fContextUniqueID(contextUniqueID)
@@ -97,6 +101,91 @@ void GrResourceCache::setLimits(int count, size_t bytes) {
     this->purgeAsNeeded();
 }
 
+const char* GrResourceCache::PartitionName(Partition partition) {
+    switch (partition) {
+        case Partition::kOther:   return "other";
+        case Partition::kScratch: return "scratch";
+        case Partition::kImages:  return "images";
+        case Partition::kPaths:   return "paths";
+        case Partition::kAtlases: return "atlases";
+    }
+    SK_ABORT("Invalid partition");
+    return "<invalid>";
+}
+
+GrResourceCache::Partition GrResourceCache::ComputePartition(const GrGpuResource* resource) {
+    const GrUniqueKey& key = resource->getUniqueKey();
+    if (!key.isValid()) {
+        return Partition::kScratch;
+    }
+    if (!key.tag()) {
+        return Partition::kOther;
+    }
+    static const struct {
+        const char* fTag;
+        Partition   fPartition;
+    } kTags[] = {
+        { "Image",               Partition::kImages  },
+        { "Path",                Partition::kPaths   },
+        { "SW Path Mask",        Partition::kPaths   },
+        { "Mask Filtered Masks", Partition::kPaths   },
+        { "CCPR Atlas",          Partition::kAtlases },
+    };
+    for (const auto& entry : kTags) {
+        if (0 == strcmp(key.tag(), entry.fTag)) {
+            return entry.fPartition;
+        }
+    }
+    return Partition::kOther;
+}
+
+void GrResourceCache::setPartitionLimits(Partition partition, size_t maxBytes, int priority) {
+    PartitionBudget& budget = fPartitions[static_cast<int>(partition)];
+    budget.fMaxBytes = maxBytes;
+    budget.fPriority = priority;
+
+    fHasPartitionPriorities = false;
+    for (int i = 1; i < kPartitionCount; ++i) {
+        fHasPartitionPriorities |= fPartitions[i].fPriority != fPartitions[0].fPriority;
+    }
+    this->purgeAsNeeded();
+}
+
+void GrResourceCache::addToPartition(GrGpuResource* resource) {
+    PartitionBudget& budget = this->partitionOf(resource);
+    size_t size = resource->gpuMemorySize();
+    if (SkBudgeted::kYes == resource->resourcePriv().isBudgeted()) {
+        ++budget.fBudgetedCount;
+        budget.fBudgetedBytes += size;
+    }
+    int index = *resource->cacheAccess().accessCacheIndex();
+    if (index < fPurgeableQueue.count() && fPurgeableQueue.at(index) == resource) {
+        budget.fPurgeableBytes += size;
+    }
+}
+
+void GrResourceCache::removeFromPartition(GrGpuResource* resource) {
+    PartitionBudget& budget = this->partitionOf(resource);
+    size_t size = resource->gpuMemorySize();
+    if (SkBudgeted::kYes == resource->resourcePriv().isBudgeted()) {
+        --budget.fBudgetedCount;
+        budget.fBudgetedBytes -= size;
+    }
+    int index = *resource->cacheAccess().accessCacheIndex();
+    if (index < fPurgeableQueue.count() && fPurgeableQueue.at(index) == resource) {
+        budget.fPurgeableBytes -= size;
+    }
+}
+
+void GrResourceCache::updatePartition(GrGpuResource* resource) {
+    int partition = static_cast<int>(ComputePartition(resource));
+    if (partition != resource->cacheAccess().partition()) {
+        this->removeFromPartition(resource);
+        resource->cacheAccess().setPartition(partition);
+        this->addToPartition(resource);
+    }
+}
+
 void GrResourceCache::insertResource(GrGpuResource* resource) {
     SkASSERT(resource);
     SkASSERT(!this->isInCache(resource));
@@ -108,6 +197,8 @@ void GrResourceCache::insertResource(GrGpuResource* resource) {
     resource->cacheAccess().setTimestamp(this->getNextTimestamp());
 
     this->addToNonpurgeableArray(resource);
+    resource->cacheAccess().setPartition(static_cast<int>(ComputePartition(resource)));
+    this->addToPartition(resource);
 
     size_t size = resource->gpuMemorySize();
     SkDEBUGCODE(++fCount;)
@@ -140,6 +231,7 @@ void GrResourceCache::removeResource(GrGpuResource* resource) {
     SkASSERT(this->isInCache(resource));
 
     size_t size = resource->gpuMemorySize();
+    this->removeFromPartition(resource);
     if (resource->isPurgeable()) {
         fPurgeableQueue.remove(resource);
         fPurgeableBytes -= size;
@@ -301,6 +393,7 @@ void GrResourceCache::removeUniqueKey(GrGpuResource* resource) {
         fUniqueHash.remove(resource->getUniqueKey());
     }
     resource->cacheAccess().removeUniqueKey();
+    this->updatePartition(resource);
 
     if (resource->resourcePriv().getScratchKey().isValid()) {
         fScratchMap.insert(resource->resourcePriv().getScratchKey(), resource);
@@ -340,6 +433,7 @@ void GrResourceCache::changeUniqueKey(GrGpuResource* resource, const GrUniqueKey
 
         resource->cacheAccess().setUniqueKey(newKey);
         fUniqueHash.add(resource);
+        this->updatePartition(resource);
     } else {
         this->removeUniqueKey(resource);
     }
@@ -354,6 +448,7 @@ void GrResourceCache::refAndMakeResourceMRU(GrGpuResource* resource) {
     if (resource->isPurgeable()) {
         // It's about to become unpurgeable.
         fPurgeableBytes -= resource->gpuMemorySize();
+        this->partitionOf(resource).fPurgeableBytes -= resource->gpuMemorySize();
         fPurgeableQueue.remove(resource);
         this->addToNonpurgeableArray(resource);
     }
@@ -395,6 +490,7 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
     fPurgeableQueue.insert(resource);
     resource->cacheAccess().setTimeWhenResourceBecomePurgeable();
     fPurgeableBytes += resource->gpuMemorySize();
+    this->partitionOf(resource).fPurgeableBytes += resource->gpuMemorySize();
 
     bool hasUniqueKey = resource->getUniqueKey().isValid();
 
@@ -408,8 +504,10 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
         if (!resource->resourcePriv().refsWrappedObjects() &&
             resource->resourcePriv().getScratchKey().isValid()) {
             // We won't purge an existing resource to make room for this one.
+            const PartitionBudget& budget = this->partitionOf(resource);
             if (fBudgetedCount < fMaxCount &&
-                fBudgetedBytes + resource->gpuMemorySize() <= fMaxBytes) {
+                fBudgetedBytes + resource->gpuMemorySize() <= fMaxBytes &&
+                budget.fBudgetedBytes + resource->gpuMemorySize() <= budget.fMaxBytes) {
                 resource->resourcePriv().makeBudgeted();
                 return;
             }
@@ -419,8 +517,16 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
         // Also purge if the resource has neither a valid scratch key nor a unique key.
         bool hasKey = resource->resourcePriv().getScratchKey().isValid() ||
                       hasUniqueKey;
-        if (!this->overBudget() && hasKey) {
-            return;
+        if (hasKey) {
+            bool partitionOverBudget = this->partitionOf(resource).overBudget();
+            if (!this->overBudget() && !partitionOverBudget) {
+                return;
+            }
+            if (fHasPartitionPriorities || partitionOverBudget) {
+                // The partition policies pick what to purge at the next purgeAsNeeded(), which may
+                // not be this resource. Purging here could also reenter a purge in progress.
+                return;
+            }
         }
     }
 
@@ -437,9 +543,12 @@ void GrResourceCache::didChangeBudgetStatus(GrGpuResource* resource) {
 
     size_t size = resource->gpuMemorySize();
 
+    PartitionBudget& budget = this->partitionOf(resource);
     if (SkBudgeted::kYes == resource->resourcePriv().isBudgeted()) {
         ++fBudgetedCount;
         fBudgetedBytes += size;
+        ++budget.fBudgetedCount;
+        budget.fBudgetedBytes += size;
 #if GR_CACHE_STATS
         fBudgetedHighWaterBytes = SkTMax(fBudgetedBytes, fBudgetedHighWaterBytes);
         fBudgetedHighWaterCount = SkTMax(fBudgetedCount, fBudgetedHighWaterCount);
@@ -448,6 +557,8 @@ void GrResourceCache::didChangeBudgetStatus(GrGpuResource* resource) {
     } else {
         --fBudgetedCount;
         fBudgetedBytes -= size;
+        --budget.fBudgetedCount;
+        budget.fBudgetedBytes -= size;
     }
     TRACE_COUNTER2("skia.gpu.cache", "skia budget", "used",
                    fBudgetedBytes, "free", fMaxBytes - fBudgetedBytes);
@@ -464,6 +575,27 @@ void GrResourceCache::purgeAsNeeded() {
 
     this->processFreedGpuResources();
 
+    this->purgePartitionsAsNeeded();
+
+    this->validate();
+}
+
+void GrResourceCache::purgePartitionsAsNeeded() {
+    for (int i = 0; i < kPartitionCount; ++i) {
+        const PartitionBudget& budget = fPartitions[i];
+        if (budget.overBudget() && budget.fPurgeableBytes) {
+            this->purgeFromPartition(static_cast<Partition>(i),
+                                     budget.fBudgetedBytes - budget.fMaxBytes, true);
+        }
+    }
+
+    if (fHasPartitionPriorities) {
+        if (this->overBudget() && fPurgeableQueue.count()) {
+            this->purgeByPriority();
+        }
+        return;
+    }
+
     bool stillOverbudget = this->overBudget();
     while (stillOverbudget && fPurgeableQueue.count()) {
         GrGpuResource* resource = fPurgeableQueue.peek();
@@ -471,8 +603,54 @@ void GrResourceCache::purgeAsNeeded() {
         resource->cacheAccess().release();
         stillOverbudget = this->overBudget();
     }
+}
 
-    this->validate();
+void GrResourceCache::purgeFromPartition(Partition partition, size_t bytesToPurge,
+                                         bool budgetedOnly) {
+    const int index = static_cast<int>(partition);
+
+    // Sort the queue
+    fPurgeableQueue.sort();
+
+    // Make a list of the partition's resources to delete, in LRU order
+    SkTDArray<GrGpuResource*> resources;
+    size_t byteCount = 0;
+    for (int i = 0; i < fPurgeableQueue.count() && byteCount < bytesToPurge; i++) {
+        GrGpuResource* resource = fPurgeableQueue.at(i);
+        SkASSERT(resource->isPurgeable());
+        if (resource->cacheAccess().partition() == index &&
+            (!budgetedOnly || SkBudgeted::kYes == resource->resourcePriv().isBudgeted())) {
+            resources.push_back(resource);
+            byteCount += resource->gpuMemorySize();
+        }
+    }
+
+    // Delete the resources. This must be done as a separate pass to avoid messing up the sorted
+    // order of the queue
+    for (int i = 0; i < resources.count(); i++) {
+        resources[i]->cacheAccess().release();
+    }
+}
+
+void GrResourceCache::purgeByPriority() {
+    fPurgeableQueue.sort();
+
+    // Lower priority partitions go first. The sort is stable so each priority stays in LRU order.
+    SkTDArray<GrGpuResource*> resources;
+    resources.setReserve(fPurgeableQueue.count());
+    for (int i = 0; i < fPurgeableQueue.count(); i++) {
+        resources.push_back(fPurgeableQueue.at(i));
+    }
+    std::stable_sort(resources.begin(), resources.end(),
+                     [this](GrGpuResource* a, GrGpuResource* b) {
+                         return this->partitionOf(a).fPriority < this->partitionOf(b).fPriority;
+                     });
+
+    // Nothing in the list has a ref, so releasing one resource can't free another in the list.
+    for (int i = 0; i < resources.count() && this->overBudget(); i++) {
+        SkASSERT(resources[i]->isPurgeable());
+        resources[i]->cacheAccess().release();
+    }
 }
 
 void GrResourceCache::purgeUnlockedResources(bool scratchResourcesOnly) {
@@ -508,6 +686,14 @@ void GrResourceCache::purgeUnlockedResources(bool scratchResourcesOnly) {
     this->validate();
 }
 
+void GrResourceCache::purgeUnlockedResources(Partition partition, size_t bytesToPurge) {
+    if (fPartitions[static_cast<int>(partition)].fPurgeableBytes) {
+        this->purgeFromPartition(partition, bytesToPurge, false);
+    }
+
+    this->validate();
+}
+
 void GrResourceCache::purgeResourcesNotUsedSince(GrStdSteadyClock::time_point purgeTime) {
     while (fPurgeableQueue.count()) {
         const GrStdSteadyClock::time_point resourceTime =
@@ -692,6 +878,24 @@ void GrResourceCache::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) c
     for (int i = 0; i < fPurgeableQueue.count(); ++i) {
         fPurgeableQueue.at(i)->dumpMemoryStatistics(traceMemoryDump);
     }
+
+    // The partitions only summarize the resources dumped above, so they don't report a "size".
+    for (int i = 0; i < kPartitionCount; ++i) {
+        const PartitionBudget& budget = fPartitions[i];
+        if (!budget.fBudgetedCount && !budget.fPurgeableBytes) {
+            continue;
+        }
+        SkString dumpName("skia/gpu_resource_partitions/");
+        dumpName.append(PartitionName(static_cast<Partition>(i)));
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "budgeted_size", "bytes",
+                                          budget.fBudgetedBytes);
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "purgeable_size", "bytes",
+                                          budget.fPurgeableBytes);
+        if (budget.fMaxBytes != SIZE_MAX) {
+            traceMemoryDump->dumpNumericValue(dumpName.c_str(), "limit", "bytes",
+                                              budget.fMaxBytes);
+        }
+    }
 }
 
 #ifdef SK_DEBUG
@@ -711,6 +915,7 @@ void GrResourceCache::validate() const {
         int fScratch;
         int fCouldBeScratch;
         int fContent;
+        size_t fPartitionBudgetedBytes[kPartitionCount];
         const ScratchMap* fScratchMap;
         const UniqueHash* fUniqueHash;
 
@@ -755,9 +960,13 @@ void GrResourceCache::validate() const {
                 }
             }
 
+            SkASSERT(resource->cacheAccess().partition() ==
+                     static_cast<int>(ComputePartition(resource)));
             if (SkBudgeted::kYes == resource->resourcePriv().isBudgeted()) {
                 ++fBudgetedCount;
                 fBudgetedBytes += resource->gpuMemorySize();
+                fPartitionBudgetedBytes[resource->cacheAccess().partition()] +=
+                        resource->gpuMemorySize();
             }
         }
     };
@@ -777,6 +986,7 @@ void GrResourceCache::validate() const {
 
     Stats stats(this);
     size_t purgeableBytes = 0;
+    size_t partitionPurgeableBytes[kPartitionCount] = {};
 
     for (int i = 0; i < fNonpurgeableResources.count(); ++i) {
         SkASSERT(!fNonpurgeableResources[i]->isPurgeable() ||
@@ -791,6 +1001,8 @@ void GrResourceCache::validate() const {
         SkASSERT(!fPurgeableQueue.at(i)->wasDestroyed());
         stats.update(fPurgeableQueue.at(i));
         purgeableBytes += fPurgeableQueue.at(i)->gpuMemorySize();
+        partitionPurgeableBytes[fPurgeableQueue.at(i)->cacheAccess().partition()] +=
+                fPurgeableQueue.at(i)->gpuMemorySize();
     }
 
     SkASSERT(fCount == this->getResourceCount());
@@ -800,6 +1012,10 @@ void GrResourceCache::validate() const {
     SkASSERT(stats.fBudgetedBytes == fBudgetedBytes);
     SkASSERT(stats.fBudgetedCount == fBudgetedCount);
     SkASSERT(purgeableBytes == fPurgeableBytes);
+    for (int i = 0; i < kPartitionCount; ++i) {
+        SkASSERT(stats.fPartitionBudgetedBytes[i] == fPartitions[i].fBudgetedBytes);
+        SkASSERT(partitionPurgeableBytes[i] == fPartitions[i].fPurgeableBytes);
+    }
 #if GR_CACHE_STATS
     SkASSERT(fBudgetedHighWaterCount <= fHighWaterCount);
     SkASSERT(fBudgetedHighWaterBytes <= fHighWaterBytes);
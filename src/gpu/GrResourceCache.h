@@ -16,6 +16,7 @@
 #include "SkRefCnt.h"
 #include "SkTArray.h"
 #include "SkTDPQueue.h"
+#include "SkTFlatHash.h"
 #include "SkTInternalLList.h"
 #include "SkTMultiMap.h"
 
@@ -107,6 +108,54 @@ public:
      */
     size_t getMaxResourceBytes() const { return fMaxBytes; }
 
+    /**
+     * Budgeted resources are also accounted against a partition, decided by their keys: resources
+     * without a unique key are scratch, and uniquely keyed resources are partitioned by the tag of
+     * their key. By default partitions have no limit of their own and equal priority, so only the
+     * overall budget applies.
+     */
+    enum class Partition {
+        kOther,
+        kScratch,
+        kImages,
+        kPaths,
+        kAtlases,
+
+        kLast = kAtlases
+    };
+    static const int kPartitionCount = static_cast<int>(Partition::kLast) + 1;
+
+    static const char* PartitionName(Partition);
+
+    /**
+     * Sets a byte limit of the partition's own, enforced in addition to the overall budget, and
+     * its priority. When the cache is over its overall budget, purgeable resources in lower
+     * priority partitions are purged before those in higher ones, in LRU order within a priority.
+     */
+    void setPartitionLimits(Partition, size_t maxBytes, int priority);
+
+    size_t getPartitionMaxBytes(Partition partition) const {
+        return fPartitions[static_cast<int>(partition)].fMaxBytes;
+    }
+
+    int getPartitionPriority(Partition partition) const {
+        return fPartitions[static_cast<int>(partition)].fPriority;
+    }
+
+    /**
+     * Returns the number of bytes consumed by budgeted resources in the partition.
+     */
+    size_t getPartitionBudgetedBytes(Partition partition) const {
+        return fPartitions[static_cast<int>(partition)].fBudgetedBytes;
+    }
+
+    /**
+     * Returns the number of bytes held by unlocked resources in the partition.
+     */
+    size_t getPartitionPurgeableBytes(Partition partition) const {
+        return fPartitions[static_cast<int>(partition)].fPurgeableBytes;
+    }
+
     /**
      * Abandons the backend API resources owned by all GrGpuResource objects and removes them from
      * the cache.
@@ -187,6 +236,12 @@ public:
      */
     void purgeUnlockedResources(size_t bytesToPurge, bool preferScratchResources);
 
+    /**
+     * Purge unlocked resources in the partition, in LRU order, until the provided byte count has
+     * been reached or all of the partition's unlocked resources have been purged.
+     */
+    void purgeUnlockedResources(Partition, size_t bytesToPurge = SIZE_MAX);
+
     /** Returns true if the cache would like a flush to occur in order to make more resources
         purgeable. */
     bool requestsFlush() const { return this->overBudget() && !fPurgeableQueue.count(); }
@@ -270,6 +325,35 @@ private:
         return fBudgetedBytes+bytes <= fMaxBytes && fBudgetedCount+1 <= fMaxCount;
     }
 
+    struct PartitionBudget {
+        size_t fMaxBytes = SIZE_MAX;
+        int    fPriority = 0;
+        int    fBudgetedCount = 0;
+        size_t fBudgetedBytes = 0;
+        size_t fPurgeableBytes = 0;
+
+        bool overBudget() const { return fBudgetedBytes > fMaxBytes; }
+    };
+
+    static Partition ComputePartition(const GrGpuResource*);
+
+    PartitionBudget& partitionOf(const GrGpuResource* resource) {
+        return fPartitions[resource->cacheAccess().partition()];
+    }
+
+    // Adds or removes the resource's bytes to or from its partition's counters.
+    void addToPartition(GrGpuResource*);
+    void removeFromPartition(GrGpuResource*);
+    // Moves the resource to the partition its keys now call for.
+    void updatePartition(GrGpuResource*);
+
+    // Purges for partitions over their own limit, then for the overall budget.
+    void purgePartitionsAsNeeded();
+    // Releases the partition's purgeable resources in LRU order until bytesToPurge is reached.
+    void purgeFromPartition(Partition, size_t bytesToPurge, bool budgetedOnly);
+    // Releases purgeable resources in order of partition priority, then LRU, while over budget.
+    void purgeByPriority();
+
     uint32_t getNextTimestamp();
 
 #ifdef SK_DEBUG
@@ -293,12 +377,38 @@ private:
     };
     typedef SkTMultiMap<GrGpuResource, GrScratchKey, ScratchMapTraits> ScratchMap;
 
-    struct UniqueHashTraits {
-        static const GrUniqueKey& GetKey(const GrGpuResource& r) { return r.getUniqueKey(); }
+    // findAndRefUniqueResource() is hot, so this is a flat table: a lookup usually touches just
+    // its control bytes and then the one resource with the key.
+    class UniqueHash {
+    public:
+        GrGpuResource* find(const GrUniqueKey& key) const {
+            GrGpuResource** resource = fTable.find(key);
+            return resource ? *resource : nullptr;
+        }
+
+        // There must not be a resource with this key already.
+        void add(GrGpuResource* resource) {
+            SkASSERT(!this->find(resource->getUniqueKey()));
+            fTable.set(resource);
+        }
+
+        void remove(const GrUniqueKey& key) { fTable.remove(key); }
 
-        static uint32_t Hash(const GrUniqueKey& key) { return key.hash(); }
+        int count() const { return fTable.count(); }
+
+        template <typename Fn>  // f(const GrGpuResource&)
+        void foreach(Fn&& fn) const {
+            fTable.foreach([&fn](GrGpuResource* resource) { fn(*resource); });
+        }
+
+    private:
+        struct Traits {
+            static const GrUniqueKey& GetKey(GrGpuResource* r) { return r->getUniqueKey(); }
+
+            static uint32_t Hash(const GrUniqueKey& key) { return key.hash(); }
+        };
+        SkTFlatHashTable<GrGpuResource*, GrUniqueKey, Traits> fTable;
     };
-    typedef SkTDynamicHash<GrGpuResource, GrUniqueKey, UniqueHashTraits> UniqueHash;
 
     static bool CompareTimestamp(GrGpuResource* const& a, GrGpuResource* const& b) {
         return a->cacheAccess().timestamp() < b->cacheAccess().timestamp();
@@ -346,6 +456,10 @@ private:
     size_t                              fBudgetedBytes;
     size_t                              fPurgeableBytes;
 
+    PartitionBudget                     fPartitions[kPartitionCount];
+    // Set when the partitions don't all have the same priority.
+    bool                                fHasPartitionPriorities;
+
     InvalidUniqueKeyInbox               fInvalidUniqueKeyInbox;
     FreedGpuResourceInbox               fFreedGpuResourceInbox;
 
@@ -40,7 +40,8 @@ static const bool kDefaultExplicitlyAllocateGPUResources = true;
     SkDEBUGCODE(GrSingleOwner::AutoEnforce debug_SingleOwner(fSingleOwner);)
 
 GrResourceProvider::GrResourceProvider(GrGpu* gpu, GrResourceCache* cache, GrSingleOwner* owner,
-                                       GrContextOptions::Enable explicitlyAllocateGPUResources)
+                                       GrContextOptions::Enable explicitlyAllocateGPUResources,
+                                       GrContextOptions::Enable stagedTextureUploads)
         : fCache(cache)
         , fGpu(gpu)
 #ifdef SK_DEBUG
@@ -57,6 +58,10 @@ GrResourceProvider::GrResourceProvider(GrGpu* gpu, GrResourceCache* cache, GrSin
 
     fCaps = sk_ref_sp(fGpu->caps());
 
+    if (GrContextOptions::Enable::kYes == stagedTextureUploads) {
+        fStagingBufferRing = GrStagingBufferRing::Make(fGpu);
+    }
+
     GR_DEFINE_STATIC_UNIQUE_KEY(gQuadIndexBufferKey);
     fQuadIndexBufferKey = gQuadIndexBufferKey;
 }
@@ -120,6 +125,13 @@ sk_sp<GrTexture> GrResourceProvider::createTexture(const GrSurfaceDesc& desc,
             return nullptr;
         }
 
+        if (fStagingBufferRing &&
+            fStagingBufferRing->uploadPixels(tex.get(), 0, 0, desc.fWidth, desc.fHeight,
+                                             SkColorTypeToGrColorType(colorType),
+                                             mipLevel.fPixels, mipLevel.fRowBytes)) {
+            return tex;
+        }
+
         sk_sp<GrTextureProxy> proxy = proxyProvider->createWrapped(std::move(tex),
                                                                    kTopLeft_GrSurfaceOrigin);
         if (!proxy) {
@@ -11,6 +11,7 @@
 #include "GrBuffer.h"
 #include "GrContextOptions.h"
 #include "GrResourceCache.h"
+#include "GrStagingBufferRing.h"
 #include "SkImageInfoPriv.h"
 #include "SkScalerContext.h"
 
@@ -58,7 +59,8 @@ public:
     };
 
     GrResourceProvider(GrGpu*, GrResourceCache*, GrSingleOwner*,
-                       GrContextOptions::Enable explicitlyAllocateGPUResources);
+                       GrContextOptions::Enable explicitlyAllocateGPUResources,
+                       GrContextOptions::Enable stagedTextureUploads);
 
     /**
      * Finds a resource in the cache, based on the specified key. Prior to calling this, the caller
@@ -240,8 +242,17 @@ public:
     void abandon() {
         fCache = nullptr;
         fGpu = nullptr;
+        if (fStagingBufferRing) {
+            fStagingBufferRing->abandon();
+        }
     }
 
+    /**
+     * The ring of transfer buffers that raster uploads go through, or nullptr if uploads write
+     * their pixels directly.
+     */
+    GrStagingBufferRing* stagingBufferRing() { return fStagingBufferRing.get(); }
+
     uint32_t contextUniqueID() const { return fCache->contextUniqueID(); }
     const GrCaps* caps() const { return fCaps.get(); }
     bool overBudget() const { return fCache->overBudget(); }
@@ -293,6 +304,7 @@ private:
     sk_sp<const GrCaps> fCaps;
     GrUniqueKey         fQuadIndexBufferKey;
     bool                fExplicitlyAllocateGPUResources;
+    std::unique_ptr<GrStagingBufferRing> fStagingBufferRing;
 
     // In debug builds we guard against improper thread handling
     SkDEBUGCODE(mutable GrSingleOwner* fSingleOwner;)
@@ -10,6 +10,7 @@
 
 #include "GrContextOptions.h"
 #include "SkJSONWriter.h"
+#include "SkString.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -51,6 +52,7 @@ GrShaderCaps::GrShaderCaps(const GrContextOptions& options) {
     fFPManipulationSupport = false;
     fFloatIs32Bits = true;
     fHalfIs32Bits = false;
+    fUnsignedSupport = false;
 
     fVersionDeclString = nullptr;
     fShaderDerivativeExtensionString = nullptr;
@@ -65,6 +67,7 @@ GrShaderCaps::GrShaderCaps(const GrContextOptions& options) {
     fFBFetchExtensionString = nullptr;
     fImageLoadStoreExtensionString = nullptr;
     fMaxFragmentSamplers = 0;
+    fDisableImageMultitexturingDstRectAreaThreshold = 0;
     fAdvBlendEqInteraction = kNotSupported_AdvBlendEqInteraction;
 }
 
@@ -122,6 +125,8 @@ void GrShaderCaps::dumpJSON(SkJSONWriter* writer) const {
     writer->appendBool("half == fp32", fHalfIs32Bits);
 
     writer->appendS32("Max FS Samplers", fMaxFragmentSamplers);
+    writer->appendU64("Image multitexturing dst rect area threshold",
+                      fDisableImageMultitexturingDstRectAreaThreshold);
     writer->appendString("Advanced blend equation interaction",
                          kAdvBlendEqInteractionStr[fAdvBlendEqInteraction]);
 
@@ -131,6 +136,42 @@ void GrShaderCaps::dumpJSON(SkJSONWriter* writer) const {
 void GrShaderCaps::dumpJSON(SkJSONWriter* writer) const { }
 #endif
 
+void GrShaderCaps::appendCodeGenKey(SkString* key) const {
+    const bool flags[] = {
+        fShaderDerivativeSupport, fGeometryShaderSupport, fGSInvocationsSupport,
+        fPathRenderingSupport, fDstReadInShaderSupport, fDualSourceBlendingSupport,
+        fIntegerSupport, fImageLoadStoreSupport, fDropsTileOnZeroDivide, fFBFetchSupport,
+        fFBFetchNeedsCustomOutput, fUsesPrecisionModifiers, fFlatInterpolationSupport,
+        fPreferFlatInterpolation, fNoPerspectiveInterpolationSupport, fExternalTextureSupport,
+        fVertexIDSupport, fFPManipulationSupport, fFloatIs32Bits, fHalfIs32Bits,
+        fUnsignedSupport, fCanUseAnyFunctionInShader, fCanUseMinAndAbsTogether,
+        fCanUseFractForNegativeValues, fMustForceNegatedAtanParamToFloat,
+        fAtan2ImplementedAsAtanYOverX, fMustDoOpBetweenFloorAndAbs,
+        fRequiresLocalOutputColorForFBFetch, fMustObfuscateUniformColor,
+        fMustGuardDivisionEvenAfterExplicitZeroCheck, fCanUseFragCoord,
+        fIncompleteShortIntPrecision, fAddAndTrueToLoopCondition, fUnfoldShortCircuitAsTernary,
+        fEmulateAbsIntFunction, fRewriteDoWhileLoops, fRemovePowWithConstantExponent,
+    };
+    key->appendf("%d:%d:%d:", fGLSLGeneration, fMaxFragmentSamplers, fAdvBlendEqInteraction);
+    for (bool flag : flags) {
+        key->append(flag ? "1" : "0");
+    }
+    const char* strings[] = {
+        fVersionDeclString, fShaderDerivativeExtensionString, fGeometryShaderExtensionString,
+        fGSInvocationsExtensionString, fFragCoordConventionsExtensionString,
+        fSecondaryOutputExtensionString, fExternalTextureExtensionString,
+        fSecondExternalTextureExtensionString, fNoPerspectiveInterpolationExtensionString,
+        fImageLoadStoreExtensionString, fFBFetchColorName, fFBFetchExtensionString,
+    };
+    for (const char* str : strings) {
+        // Keep null and empty strings apart; the generators test for null.
+        key->append(str ? ":s" : ":n");
+        if (str) {
+            key->append(str);
+        }
+    }
+}
+
 void GrShaderCaps::applyOptionsOverrides(const GrContextOptions& options) {
     if (options.fDisableDriverCorrectnessWorkarounds) {
         SkASSERT(fCanUseAnyFunctionInShader);
@@ -151,6 +192,9 @@ void GrShaderCaps::applyOptionsOverrides(const GrContextOptions& options) {
         SkASSERT(!fRemovePowWithConstantExponent);
     }
 #if GR_TEST_UTILS
+    if (options.fDisableImageMultitexturing) {
+        fDisableImageMultitexturingDstRectAreaThreshold = 0;
+    }
     fDualSourceBlendingSupport = fDualSourceBlendingSupport && !options.fSuppressDualSourceBlending;
 #endif
 }
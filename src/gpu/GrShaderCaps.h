@@ -19,6 +19,7 @@ class ShaderCapsFactory;
 
 struct GrContextOptions;
 class SkJSONWriter;
+class SkString;
 
 class GrShaderCaps : public SkRefCnt {
 public:
@@ -39,6 +40,12 @@ public:
 
     void dumpJSON(SkJSONWriter*) const;
 
+    /**
+     * Appends every cap that can affect the code SkSL generates. Caps that append equal keys
+     * produce identical GLSL for identical SkSL, even when they belong to different contexts.
+     */
+    void appendCodeGenKey(SkString*) const;
+
     bool supportsDistanceFieldText() const { return fShaderDerivativeSupport; }
 
     bool shaderDerivativeSupport() const { return fShaderDerivativeSupport; }
@@ -211,6 +218,14 @@ public:
 
     int maxFragmentSamplers() const { return fMaxFragmentSamplers; }
 
+    /**
+     * Image draws whose dst rects are all smaller than this area may be batched across several
+     * textures by binding them to different samplers of one draw. Zero disables that batching.
+     */
+    size_t disableImageMultitexturingDstRectAreaThreshold() const {
+        return fDisableImageMultitexturingDstRectAreaThreshold;
+    }
+
     /**
      * Given a texture's config, this determines what swizzle must be appended to accesses to the
      * texture in generated shader code. Swizzling may be implemented in texture parameters or a
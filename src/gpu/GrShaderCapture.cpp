@@ -0,0 +1,110 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrShaderCapture.h"
+
+#include "GrProgramDesc.h"
+#include "SkBuffer.h"
+#include "SkStream.h"
+
+// The serialized form is:
+//   kMagic, kVersion, program count
+//   for each program: settings flags, key length, key bytes,
+//                     then for each stage: SkSL length, SkSL bytes
+// with every length and flag word a native endian uint32_t. It is only meant to be read by the
+// same version of Skia that wrote it.
+static const uint32_t kMagic = SkSetFourByteTag('S', 'K', 'S', 'C');
+static const uint32_t kVersion = 1;
+
+enum SettingsFlags {
+    kFlipY_SettingsFlag              = 1 << 0,
+    kFragColorIsInOut_SettingsFlag   = 1 << 1,
+    kSharpenTextures_SettingsFlag    = 1 << 2,
+    kForceHighPrecision_SettingsFlag = 1 << 3,
+};
+
+void GrShaderCapture::record(const GrProgramDesc& desc, Program&& program) {
+    SkString key(reinterpret_cast<const char*>(desc.asKey()), desc.keyLength());
+    if (fKeys.contains(key)) {
+        return;
+    }
+    fKeys.add(key);
+    program.fKey = std::move(key);
+    fPrograms.push_back(std::move(program));
+}
+
+static void write_string(SkWStream* stream, const char* data, size_t length) {
+    stream->write32(SkToU32(length));
+    stream->write(data, length);
+}
+
+sk_sp<SkData> GrShaderCapture::serialize() const {
+    SkDynamicMemoryWStream stream;
+    stream.write32(kMagic);
+    stream.write32(kVersion);
+    stream.write32(fPrograms.count());
+    for (const Program& program : fPrograms) {
+        uint32_t flags = (program.fFlipY ? kFlipY_SettingsFlag : 0) |
+                         (program.fFragColorIsInOut ? kFragColorIsInOut_SettingsFlag : 0) |
+                         (program.fSharpenTextures ? kSharpenTextures_SettingsFlag : 0) |
+                         (program.fForceHighPrecision ? kForceHighPrecision_SettingsFlag : 0);
+        stream.write32(flags);
+        write_string(&stream, program.fKey.c_str(), program.fKey.size());
+        for (int i = 0; i < kStageCount; ++i) {
+            write_string(&stream, program.fSkSL[i].c_str(), program.fSkSL[i].size());
+        }
+    }
+    return stream.detachAsData();
+}
+
+static bool read_string(SkRBuffer* buffer, const char** data, uint32_t* length) {
+    if (!buffer->readU32(length) || *length > buffer->available()) {
+        return false;
+    }
+    *data = static_cast<const char*>(buffer->skip(*length));
+    return nullptr != *data;
+}
+
+bool GrShaderCapture::deserialize(const SkData& data) {
+    SkRBuffer buffer(data.data(), data.size());
+    uint32_t magic, version, count;
+    if (!buffer.readU32(&magic) || kMagic != magic ||
+        !buffer.readU32(&version) || kVersion != version ||
+        !buffer.readU32(&count)) {
+        return false;
+    }
+
+    SkTArray<Program> programs;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t flags;
+        const char* bytes;
+        uint32_t length;
+        if (!buffer.readU32(&flags) || !read_string(&buffer, &bytes, &length)) {
+            return false;
+        }
+        Program& program = programs.push_back();
+        program.fKey.set(bytes, length);
+        program.fFlipY = SkToBool(flags & kFlipY_SettingsFlag);
+        program.fFragColorIsInOut = SkToBool(flags & kFragColorIsInOut_SettingsFlag);
+        program.fSharpenTextures = SkToBool(flags & kSharpenTextures_SettingsFlag);
+        program.fForceHighPrecision = SkToBool(flags & kForceHighPrecision_SettingsFlag);
+        for (int stage = 0; stage < kStageCount; ++stage) {
+            if (!read_string(&buffer, &bytes, &length)) {
+                return false;
+            }
+            program.fSkSL[stage] = SkSL::String(bytes, length);
+        }
+    }
+
+    for (Program& program : programs) {
+        if (!fKeys.contains(program.fKey)) {
+            fKeys.add(program.fKey);
+            fPrograms.push_back(std::move(program));
+        }
+    }
+    return true;
+}
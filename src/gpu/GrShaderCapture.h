@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrShaderCapture_DEFINED
+#define GrShaderCapture_DEFINED
+
+#include "SkData.h"
+#include "SkSLString.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+
+class GrProgramDesc;
+
+/**
+ * Records the SkSL of every program a context builds, keyed by its GrProgramDesc, so that a later
+ * process can generate the backend shaders before it first draws (GrContext::precompileShaders).
+ * Install one with GrContextPriv::setShaderCapture; tools/skpshaders records captures by replaying
+ * SKPs. Programs are recorded once per desc. Not thread safe.
+ */
+class GrShaderCapture {
+public:
+    enum Stage {
+        kVertex_Stage,
+        kGeometry_Stage,
+        kFragment_Stage,
+
+        kLast_Stage = kFragment_Stage
+    };
+    static const int kStageCount = kLast_Stage + 1;
+
+    struct Program {
+        // the bytes of the GrProgramDesc's asKey()
+        SkString fKey;
+        bool fFlipY;
+        bool fFragColorIsInOut;
+        bool fSharpenTextures;
+        bool fForceHighPrecision;
+        // empty for stages the program doesn't have
+        SkSL::String fSkSL[kStageCount];
+    };
+
+    GrShaderCapture() {}
+
+    /** Adds the program unless one was already recorded for the desc. fKey is filled in here. */
+    void record(const GrProgramDesc&, Program&& program);
+
+    int count() const { return fPrograms.count(); }
+
+    const Program& program(int i) const { return fPrograms[i]; }
+
+    sk_sp<SkData> serialize() const;
+
+    /**
+     * Adds the programs from a serialized capture. Returns false, and adds nothing, if the data
+     * isn't one.
+     */
+    bool deserialize(const SkData&);
+
+private:
+    SkTArray<Program> fPrograms;
+    SkTHashSet<SkString> fKeys;
+};
+
+#endif
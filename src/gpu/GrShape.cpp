@@ -7,6 +7,11 @@
 
 #include "GrShape.h"
 
+#include "SkLRUCache.h"
+#include "SkMutex.h"
+#include "SkOpts.h"
+#include "SkTDArray.h"
+
 #include <utility>
 
 GrShape& GrShape::operator=(const GrShape& that) {
@@ -307,52 +312,54 @@ void GrShape::writeUnstyledKey(uint32_t* key) const {
     SkASSERT(key - origKey == this->unstyledKeySize());
 }
 
+bool GrShape::ComputeInheritedKey(const GrShape& parent, GrStyle::Apply apply, SkScalar scale,
+                                  SkAutoSTArray<8, uint32_t>* key) {
+    // We want ApplyFullStyle(ApplyPathEffect(shape)) to have the same key as
+    // ApplyFullStyle(shape).
+    // The full key is structured as (geo,path_effect,stroke).
+    // If we do ApplyPathEffect we get geo,path_effect as the inherited key. If we then
+    // do ApplyFullStyle we'll memcpy geo,path_effect into the new inherited key
+    // and then append the style key (which should now be stroke only) at the end.
+    int parentCnt = parent.fInheritedKey.count();
+    bool useParentGeoKey = !parentCnt;
+    if (useParentGeoKey) {
+        parentCnt = parent.unstyledKeySize();
+        if (parentCnt < 0) {
+            // The parent's geometry has no key so we will have no key.
+            return false;
+        }
+    }
+    uint32_t styleKeyFlags = 0;
+    if (parent.knownToBeClosed()) {
+        styleKeyFlags |= GrStyle::kClosed_KeyFlag;
+    }
+    if (parent.asLine(nullptr, nullptr)) {
+        styleKeyFlags |= GrStyle::kNoJoins_KeyFlag;
+    }
+    int styleCnt = GrStyle::KeySize(parent.fStyle, apply, styleKeyFlags);
+    if (styleCnt < 0) {
+        // The style doesn't allow a key.
+        return false;
+    }
+    key->reset(parentCnt + styleCnt);
+    if (useParentGeoKey) {
+        // This will be the geo key.
+        parent.writeUnstyledKey(key->get());
+    } else {
+        // This should be (geo,path_effect).
+        memcpy(key->get(), parent.fInheritedKey.get(), parentCnt * sizeof(uint32_t));
+    }
+    // Now turn (geo,path_effect) or (geo) into (geo,path_effect,stroke)
+    GrStyle::WriteKey(key->get() + parentCnt, parent.fStyle, apply, scale, styleKeyFlags);
+    return true;
+}
+
 void GrShape::setInheritedKey(const GrShape &parent, GrStyle::Apply apply, SkScalar scale) {
     SkASSERT(!fInheritedKey.count());
     // If the output shape turns out to be simple, then we will just use its geometric key
-    if (Type::kPath == fType) {
-        // We want ApplyFullStyle(ApplyPathEffect(shape)) to have the same key as
-        // ApplyFullStyle(shape).
-        // The full key is structured as (geo,path_effect,stroke).
-        // If we do ApplyPathEffect we get geo,path_effect as the inherited key. If we then
-        // do ApplyFullStyle we'll memcpy geo,path_effect into the new inherited key
-        // and then append the style key (which should now be stroke only) at the end.
-        int parentCnt = parent.fInheritedKey.count();
-        bool useParentGeoKey = !parentCnt;
-        if (useParentGeoKey) {
-            parentCnt = parent.unstyledKeySize();
-            if (parentCnt < 0) {
-                // The parent's geometry has no key so we will have no key.
-                fPathData.fGenID = 0;
-                return;
-            }
-        }
-        uint32_t styleKeyFlags = 0;
-        if (parent.knownToBeClosed()) {
-            styleKeyFlags |= GrStyle::kClosed_KeyFlag;
-        }
-        if (parent.asLine(nullptr, nullptr)) {
-            styleKeyFlags |= GrStyle::kNoJoins_KeyFlag;
-        }
-        int styleCnt = GrStyle::KeySize(parent.fStyle, apply, styleKeyFlags);
-        if (styleCnt < 0) {
-            // The style doesn't allow a key, set the path gen ID to 0 so that we fail when
-            // we try to get a key for the shape.
-            fPathData.fGenID = 0;
-            return;
-        }
-        fInheritedKey.reset(parentCnt + styleCnt);
-        if (useParentGeoKey) {
-            // This will be the geo key.
-            parent.writeUnstyledKey(fInheritedKey.get());
-        } else {
-            // This should be (geo,path_effect).
-            memcpy(fInheritedKey.get(), parent.fInheritedKey.get(),
-                   parentCnt * sizeof(uint32_t));
-        }
-        // Now turn (geo,path_effect) or (geo) into (geo,path_effect,stroke)
-        GrStyle::WriteKey(fInheritedKey.get() + parentCnt, parent.fStyle, apply, scale,
-                          styleKeyFlags);
+    if (Type::kPath == fType && !ComputeInheritedKey(parent, apply, scale, &fInheritedKey)) {
+        // Set the path gen ID to 0 so that we fail when we try to get a key for the shape.
+        fPathData.fGenID = 0;
     }
 }
 
@@ -414,6 +421,30 @@ GrShape::GrShape(const GrShape& that) : fStyle(that.fStyle) {
     }
 }
 
+namespace {
+
+struct StyledShapeKeyHash {
+    uint32_t operator()(const SkTDArray<uint32_t>& key) const {
+        return SkOpts::hash(key.begin(), key.bytes());
+    }
+};
+
+}  // anonymous namespace
+
+// Static dashed or stroked paths get styled again every frame, so we keep the last few results.
+// The key holds the parent's geometry key (with the path's gen ID) and its style key, so stale
+// entries are never found again and just age out.
+static const int kMaxCachedStyledShapes = 32;
+
+SK_DECLARE_STATIC_MUTEX(gStyledShapeCacheMutex);
+
+static SkLRUCache<SkTDArray<uint32_t>, GrShape, StyledShapeKeyHash>* styled_shape_cache() {
+    static auto* cache =
+            new SkLRUCache<SkTDArray<uint32_t>, GrShape, StyledShapeKeyHash>(
+                    kMaxCachedStyledShapes);
+    return cache;
+}
+
 GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
     // TODO: Add some quantization of scale for better cache performance here or leave that up
     // to caller?
@@ -426,6 +457,37 @@ GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
         return;
     }
 
+    // The inherited key only describes the styled geometry. The resulting shape also carries the
+    // part of the style that wasn't applied, so the cache key adds that to it.
+    SkTDArray<uint32_t> cacheKey;
+    {
+        SkAutoSTArray<8, uint32_t> key;
+        if (ComputeInheritedKey(parent, apply, scale, &key)) {
+            const SkStrokeRec& strokeRec = parent.fStyle.strokeRec();
+            SkScalar width = strokeRec.getWidth();
+            SkScalar miter = strokeRec.getMiter();
+            cacheKey.append(key.count(), key.get());
+            *cacheKey.append() = static_cast<uint32_t>(apply);
+            *cacheKey.append() = strokeRec.getStyle() | (strokeRec.getCap() << 8) |
+                                 (strokeRec.getJoin() << 16);
+            memcpy(cacheKey.append(), &width, sizeof(uint32_t));
+            memcpy(cacheKey.append(), &miter, sizeof(uint32_t));
+        }
+    }
+    if (!cacheKey.isEmpty()) {
+        SkAutoMutexAcquire lock(gStyledShapeCacheMutex);
+        if (const GrShape* cached = styled_shape_cache()->find(cacheKey)) {
+            this->initType(Type::kEmpty);
+            *this = *cached;
+            // The cached copy doesn't keep the original path alive; refer to this parent's.
+            const SkPath* originalPath = parent.originalPathForListeners();
+            if (Type::kPath == fType && originalPath) {
+                fInheritedPathForListeners.set(*originalPath);
+            }
+            return;
+        }
+    }
+
     SkPathEffect* pe = parent.fStyle.pathEffect();
     SkTLazy<SkPath> tmpPath;
     const GrShape* parentForKey = &parent;
@@ -504,6 +566,15 @@ GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
     }
     this->attemptToSimplifyPath();
     this->setInheritedKey(*parentForKey, apply, scale);
+
+    if (!cacheKey.isEmpty()) {
+        GrShape cached(*this);
+        cached.fInheritedPathForListeners.reset();
+        SkAutoMutexAcquire lock(gStyledShapeCacheMutex);
+        if (!styled_shape_cache()->find(cacheKey)) {
+            styled_shape_cache()->insert(cacheKey, std::move(cached));
+        }
+    }
 }
 
 void GrShape::attemptToSimplifyPath() {
@@ -513,6 +513,13 @@ private:
      */
     void setInheritedKey(const GrShape& parentShape, GrStyle::Apply, SkScalar scale);
 
+    /**
+     * Computes the key setInheritedKey() uses for a path result. Returns false if the parent's
+     * geometry or style has no key, in which case the key is left unchanged.
+     */
+    static bool ComputeInheritedKey(const GrShape& parentShape, GrStyle::Apply, SkScalar scale,
+                                    SkAutoSTArray<8, uint32_t>* key);
+
     void attemptToSimplifyPath();
     void attemptToSimplifyRRect();
     void attemptToSimplifyLine();
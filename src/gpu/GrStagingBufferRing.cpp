@@ -0,0 +1,131 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrStagingBufferRing.h"
+
+#include "GrCaps.h"
+#include "GrGpu.h"
+#include "SkConvertPixels.h"
+#include "SkMathPriv.h"
+
+std::unique_ptr<GrStagingBufferRing> GrStagingBufferRing::Make(GrGpu* gpu) {
+    if (!gpu->caps()->transferBufferSupport() || !gpu->caps()->fenceSyncSupport()) {
+        return nullptr;
+    }
+    return std::unique_ptr<GrStagingBufferRing>(new GrStagingBufferRing(gpu));
+}
+
+GrStagingBufferRing::~GrStagingBufferRing() {
+    if (!fGpu) {
+        return;
+    }
+    for (const Slot& slot : fSlots) {
+        if (Slot::State::kInFlight == slot.fState) {
+            fGpu->deleteFence(slot.fFence);
+        }
+    }
+}
+
+void GrStagingBufferRing::abandon() {
+    // The buffers are abandoned along with the rest of the cache. We keep our refs until we're
+    // deleted so that dropping them can't release anything through the backend API.
+    fGpu = nullptr;
+}
+
+GrStagingBufferRing::Slot* GrStagingBufferRing::findFreeSlot(size_t size) {
+    // Recycle the buffers the GPU is done with, without waiting for the others.
+    for (Slot& slot : fSlots) {
+        if (Slot::State::kInFlight == slot.fState && fGpu->waitFence(slot.fFence, 0)) {
+            fGpu->deleteFence(slot.fFence);
+            slot.fState = Slot::State::kFree;
+        }
+    }
+
+    Slot* best = nullptr;
+    for (Slot& slot : fSlots) {
+        if (Slot::State::kFree == slot.fState && slot.fBuffer->sizeInBytes() >= size &&
+            (!best || slot.fBuffer->sizeInBytes() < best->fBuffer->sizeInBytes())) {
+            best = &slot;
+        }
+    }
+    if (best) {
+        return best;
+    }
+
+    // Make room for a new buffer by dropping free ones that are too small.
+    size_t allocSize = SkTMax(kMinBufferSize, GrNextSizePow2(size));
+    for (int i = fSlots.count() - 1; i >= 0 && fBufferBytes + allocSize > kMaxBufferBytes; --i) {
+        if (Slot::State::kFree == fSlots[i].fState) {
+            fBufferBytes -= fSlots[i].fBuffer->sizeInBytes();
+            fSlots.removeShuffle(i);
+        }
+    }
+    if (fBufferBytes + allocSize > kMaxBufferBytes) {
+        return nullptr;
+    }
+
+    sk_sp<GrBuffer> buffer(fGpu->createBuffer(allocSize, kXferCpuToGpu_GrBufferType,
+                                              kStream_GrAccessPattern));
+    if (!buffer) {
+        return nullptr;
+    }
+    fBufferBytes += buffer->sizeInBytes();
+
+    Slot& slot = fSlots.push_back();
+    slot.fBuffer = std::move(buffer);
+    slot.fFence = 0;
+    slot.fState = Slot::State::kFree;
+    return &slot;
+}
+
+bool GrStagingBufferRing::uploadPixels(GrTexture* texture, int left, int top, int width,
+                                       int height, GrColorType colorType, const void* pixels,
+                                       size_t rowBytes) {
+    SkASSERT(texture);
+    SkASSERT(pixels);
+    if (!fGpu || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    size_t trimRowBytes = width * GrColorTypeBytesPerPixel(colorType);
+    size_t size = trimRowBytes * height;
+    if (!size || size > kMaxBufferBytes) {
+        return false;
+    }
+
+    Slot* slot = this->findFreeSlot(size);
+    if (!slot) {
+        return false;
+    }
+
+    GrBuffer* buffer = slot->fBuffer.get();
+    if (void* data = buffer->map()) {
+        SkRectMemcpy(data, trimRowBytes, pixels, rowBytes, trimRowBytes, height);
+        buffer->unmap();
+    } else if (rowBytes != trimRowBytes || !buffer->updateData(pixels, size)) {
+        return false;
+    }
+
+    if (!fGpu->transferPixels(texture, left, top, width, height, colorType, buffer, 0,
+                              trimRowBytes)) {
+        return false;
+    }
+    slot->fState = Slot::State::kStaged;
+    return true;
+}
+
+void GrStagingBufferRing::didSubmit() {
+    if (!fGpu) {
+        return;
+    }
+    for (Slot& slot : fSlots) {
+        if (Slot::State::kStaged == slot.fState) {
+            slot.fFence = fGpu->insertFence();
+            slot.fState = Slot::State::kInFlight;
+        }
+    }
+}
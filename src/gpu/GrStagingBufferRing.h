@@ -0,0 +1,80 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrStagingBufferRing_DEFINED
+#define GrStagingBufferRing_DEFINED
+
+#include "GrBuffer.h"
+#include "GrTypesPriv.h"
+#include "SkTArray.h"
+
+#include <memory>
+
+class GrGpu;
+class GrTexture;
+
+/**
+ * Uploads pixels to textures through transfer buffers rather than GrGpu::writePixels(), so the
+ * backend can copy them into the texture asynchronously instead of on the calling thread.
+ *
+ * Each upload is staged in a buffer of its own from a small ring. After each submit the buffers
+ * used since the previous one are fenced, and a buffer is reused once its fence has signaled. The
+ * ring never waits on a fence: when no buffer is free and the ring is at its size limit the upload
+ * is declined, and the caller should write the pixels directly instead.
+ */
+class GrStagingBufferRing {
+public:
+    /** Returns nullptr if the GrGpu doesn't support transfer buffers and fences. */
+    static std::unique_ptr<GrStagingBufferRing> Make(GrGpu*);
+
+    ~GrStagingBufferRing();
+
+    /**
+     * Copies the pixels into a staging buffer and issues a transfer from it to the texture. The
+     * transfer is ordered before any later GPU work, so the texture can be used right away.
+     * Returns false, having done nothing, if no staging buffer was available.
+     */
+    bool uploadPixels(GrTexture*, int left, int top, int width, int height, GrColorType,
+                      const void* pixels, size_t rowBytes);
+
+    /** Called by GrGpu after each submit to fence the buffers used since the previous one. */
+    void didSubmit();
+
+    /** Drops the buffers and fences without calling into the backend API. */
+    void abandon();
+
+    int bufferCount() const { return fSlots.count(); }
+    size_t bufferBytes() const { return fBufferBytes; }
+
+private:
+    // The most memory the ring's buffers may use in total.
+    static constexpr size_t kMaxBufferBytes = 32 * (1 << 20);
+    static constexpr size_t kMinBufferSize = 1 << 16;
+
+    struct Slot {
+        enum class State {
+            kFree,
+            kStaged,    // Used since the last submit.
+            kInFlight,  // Waiting on fFence.
+        };
+
+        sk_sp<GrBuffer> fBuffer;
+        GrFence         fFence;
+        State           fState;
+    };
+
+    explicit GrStagingBufferRing(GrGpu* gpu) : fGpu(gpu), fBufferBytes(0) {}
+
+    // Finds or makes a free buffer of at least 'size' bytes, returning nullptr if there is none.
+    Slot* findFreeSlot(size_t size);
+
+    GrGpu*         fGpu;
+    SkTArray<Slot> fSlots;
+    size_t         fBufferBytes;
+};
+
+#endif
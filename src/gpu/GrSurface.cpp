@@ -44,6 +44,8 @@ size_t GrSurface::WorstCaseSize(const GrSurfaceDesc& desc, bool useNextPow2) {
 
         size = colorValuesPerPixel * colorBytes;
         size += colorBytes/3; // in case we have to mipmap
+    } else if (GrPixelConfigIsCompressed(desc.fConfig)) {
+        size = GrCompressedFormatDataSize(desc.fConfig, width, height);
     } else {
         size = (size_t) width * height * GrBytesPerPixel(desc.fConfig);
 
@@ -67,7 +69,9 @@ size_t GrSurface::ComputeSize(GrPixelConfig config,
             : height;
 
     SkASSERT(kUnknown_GrPixelConfig != config);
-    size_t colorSize = (size_t)width * height * GrBytesPerPixel(config);
+    size_t colorSize = GrPixelConfigIsCompressed(config)
+            ? GrCompressedFormatDataSize(config, width, height)
+            : (size_t)width * height * GrBytesPerPixel(config);
     SkASSERT(colorSize > 0);
 
     size_t finalSize = colorSamplesPerPixel * colorSize;
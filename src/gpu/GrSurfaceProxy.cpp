@@ -206,7 +206,13 @@ void GrSurfaceProxy::assign(sk_sp<GrSurface> surface) {
         }
     }
 
-    if (kInvalidGpuMemorySize != this->getRawGpuMemorySize_debugOnly()) {
+    // The resource allocator may back an approx proxy with a surface larger than its own bin.
+    bool largerThanBin = SkBackingFit::kApprox == fFit &&
+            (fTarget->width() > SkToInt(SkTMax(GrResourceProvider::kMinScratchTextureSize,
+                                               GrNextPow2(fWidth))) ||
+             fTarget->height() > SkToInt(SkTMax(GrResourceProvider::kMinScratchTextureSize,
+                                                GrNextPow2(fHeight))));
+    if (kInvalidGpuMemorySize != this->getRawGpuMemorySize_debugOnly() && !largerThanBin) {
         SkASSERT(fTarget->gpuMemorySize() <= this->getRawGpuMemorySize_debugOnly());
     }
 #endif
@@ -249,6 +255,10 @@ void GrSurfaceProxy::deInstantiate() {
 
 void GrSurfaceProxy::computeScratchKey(GrScratchKey* key) const {
     SkASSERT(LazyState::kFully != this->lazyInstantiationState());
+    this->computeScratchKey(this->worstCaseWidth(), this->worstCaseHeight(), key);
+}
+
+void GrSurfaceProxy::computeScratchKey(int width, int height, GrScratchKey* key) const {
     const GrRenderTargetProxy* rtp = this->asRenderTargetProxy();
     int sampleCount = 1;
     if (rtp) {
@@ -261,9 +271,6 @@ void GrSurfaceProxy::computeScratchKey(GrScratchKey* key) const {
         mipMapped = tp->mipMapped();
     }
 
-    int width = this->worstCaseWidth();
-    int height = this->worstCaseHeight();
-
     GrTexturePriv::ComputeScratchKey(this->config(), width, height, SkToBool(rtp), sampleCount,
                                      mipMapped, key);
 }
@@ -33,8 +33,19 @@ public:
     // future when the proxy is actually used/instantiated.
     bool hasPendingWrite() const { return fProxy->hasPendingWrite(); }
 
+    // Unlike the above this only looks at the proxy's own counts, not those of a backing surface
+    // that other proxies may share. It is true when a single GrProxyRef, like an opList's target,
+    // holds the only ref on the proxy and nothing else is pending.
+    bool isOnlyReferencedByWriter() const { return fProxy->isOnlyReferencedByWriter(); }
+
     void computeScratchKey(GrScratchKey* key) const { return fProxy->computeScratchKey(key); }
 
+    // The scratch key of a surface that could back the proxy, but with the given dimensions
+    // rather than those of the proxy's bin.
+    void computeScratchKey(int width, int height, GrScratchKey* key) const {
+        return fProxy->computeScratchKey(width, height, key);
+    }
+
     // Create a GrSurface-derived class that meets the requirements (i.e, desc, renderability)
     // of the GrSurfaceProxy.
     sk_sp<GrSurface> createSurface(GrResourceProvider* resourceProvider) const {
@@ -691,10 +691,9 @@ void append_point_to_contour(const SkPoint& p, VertexList* contour, SkArenaAlloc
     contour->append(v);
 }
 
-SkScalar quad_error_at(const SkPoint pts[3], SkScalar t, SkScalar u) {
-    SkQuadCoeff quad(pts);
+// mid is quad evaluated at t, which stays the same while we search for u.
+SkScalar quad_error_at(const SkQuadCoeff& quad, const SkPoint& mid, SkScalar t, SkScalar u) {
     SkPoint p0 = to_point(quad.eval(t - 0.5f * u));
-    SkPoint mid = to_point(quad.eval(t));
     SkPoint p1 = to_point(quad.eval(t + 0.5f * u));
     if (!p0.isFinite() || !mid.isFinite() || !p1.isFinite()) {
         return 0;
@@ -709,13 +708,14 @@ void append_quadratic_to_contour(const SkPoint pts[3], SkScalar toleranceSqd, Ve
     SkScalar denom = 2.0f * (aa[0] + aa[1]);
     Sk2s ab = quad.fA * quad.fB;
     SkScalar t = denom ? (-ab[0] - ab[1]) / denom : 0.0f;
+    SkPoint mid = to_point(quad.eval(t));
     int nPoints = 1;
     SkScalar u = 1.0f;
     // Test possible subdivision values only at the point of maximum curvature.
     // If it passes the flatness metric there, it'll pass everywhere.
     while (nPoints < GrPathUtils::kMaxPointsPerCurve) {
         u = 1.0f / nPoints;
-        if (quad_error_at(pts, t, u) < toleranceSqd) {
+        if (quad_error_at(quad, mid, t, u) < toleranceSqd) {
             break;
         }
         nPoints++;
@@ -11,6 +11,7 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrGpu.h"
+#include "GrGpuTimingQueue.h"
 #include "GrMemoryPool.h"
 #include "GrResourceAllocator.h"
 #include "GrTextureProxy.h"
@@ -99,11 +100,17 @@ bool GrTextureOpList::onExecute(GrOpFlushState* flushState) {
 
     SkASSERT(fTarget.get()->peekTexture());
 
+    // Copies and writes may touch the target of the pass a GrRenderTargetOpList left open.
+    flushState->endRenderPass();
+
     GrGpuTextureCommandBuffer* commandBuffer(
                          flushState->gpu()->getCommandBuffer(fTarget.get()->peekTexture(),
                                                              fTarget.get()->origin()));
     flushState->setCommandBuffer(commandBuffer);
 
+    GrGpuTimingQueue* timing = flushState->gpu()->gpuTimingQueue();
+    bool timeOps = timing && timing->timeOps();
+
     for (int i = 0; i < fRecordedOps.count(); ++i) {
         if (!fRecordedOps[i]) {
             continue;
@@ -116,7 +123,11 @@ bool GrTextureOpList::onExecute(GrOpFlushState* flushState) {
             GrXferProcessor::DstProxy()
         };
         flushState->setOpArgs(&opArgs);
+        int64_t bracket = timeOps ? timing->begin(fRecordedOps[i]->name(), this->uniqueID()) : -1;
         fRecordedOps[i]->execute(flushState);
+        if (bracket >= 0) {
+            timing->end(bracket);
+        }
         flushState->setOpArgs(nullptr);
     }
 
@@ -157,6 +168,14 @@ bool GrTextureOpList::copySurface(GrContext* context,
     return true;
 }
 
+void GrTextureOpList::visitOpProxies(const std::function<void(GrSurfaceProxy*)>& func) const {
+    for (const std::unique_ptr<GrOp>& op : fRecordedOps) {
+        if (op) {
+            op->visitProxies(func);
+        }
+    }
+}
+
 void GrTextureOpList::purgeOpsWithUninstantiatedProxies() {
     bool hasUninstantiatedProxy = false;
     auto checkInstantiation = [&hasUninstantiatedProxy](GrSurfaceProxy* p) {
@@ -68,6 +68,8 @@ private:
 
     void gatherProxyIntervals(GrResourceAllocator*) const override;
 
+    void visitOpProxies(const std::function<void(GrSurfaceProxy*)>&) const override;
+
     void recordOp(std::unique_ptr<GrOp>);
 
     // The memory for the ops in 'fRecordedOps' is actually stored in 'fOpMemoryPool'
@@ -635,22 +635,10 @@ static inline int get_tile_count(const SkIRect& srcRect, int tileSize)  {
     return tilesX * tilesY;
 }
 
-static int determine_tile_size(const SkIRect& src, int maxTileSize) {
-    if (maxTileSize <= kBmpSmallTileSize) {
-        return maxTileSize;
-    }
-
-    size_t maxTileTotalTileSize = get_tile_count(src, maxTileSize);
-    size_t smallTotalTileSize = get_tile_count(src, kBmpSmallTileSize);
-
-    maxTileTotalTileSize *= maxTileSize * maxTileSize;
-    smallTotalTileSize *= kBmpSmallTileSize * kBmpSmallTileSize;
-
-    if (maxTileTotalTileSize > 2 * smallTotalTileSize) {
-        return kBmpSmallTileSize;
-    } else {
-        return maxTileSize;
-    }
+// Tiles are cached by their subset of the bitmap, so the grid must not depend on what's visible:
+// otherwise every pan or zoom would pick new tiles and upload them all again.
+static int determine_tile_size(int maxTileSize) {
+    return SkTMin(maxTileSize, kBmpSmallTileSize);
 }
 
 // Given a bitmap, an optional src rect, and a context with a clip and matrix determine what
@@ -698,7 +686,7 @@ bool SkGpuDevice::shouldTileImageID(uint32_t imageID,
         determine_clipped_src_rect(fRenderTargetContext->width(), fRenderTargetContext->height(),
                                    this->clip(), viewMatrix, srcToDstRect, imageRect.size(),
                                    srcRectPtr, clippedSubset);
-        *tileSize = determine_tile_size(*clippedSubset, maxTileSize);
+        *tileSize = determine_tile_size(maxTileSize);
         return true;
     }
 
@@ -887,16 +875,26 @@ void SkGpuDevice::drawTiledBitmap(const SkBitmap& bitmap,
     }
     SkRect clippedSrcRect = SkRect::Make(clippedSrcIRect);
 
-    int nx = bitmap.width() / tileSize;
-    int ny = bitmap.height() / tileSize;
-    for (int x = 0; x <= nx; x++) {
-        for (int y = 0; y <= ny; y++) {
-            SkRect tileR;
-            tileR.set(SkIntToScalar(x * tileSize),
-                      SkIntToScalar(y * tileSize),
-                      SkIntToScalar((x + 1) * tileSize),
-                      SkIntToScalar((y + 1) * tileSize));
+    // Only visit the tiles that the clipped src rect touches.
+    if (clippedSrcIRect.isEmpty()) {
+        return;
+    }
+    int x0 = clippedSrcIRect.fLeft / tileSize,
+        y0 = clippedSrcIRect.fTop / tileSize,
+        x1 = (clippedSrcIRect.fRight - 1) / tileSize,
+        y1 = (clippedSrcIRect.fBottom - 1) / tileSize;
+    const SkIRect bitmapBounds = SkIRect::MakeWH(bitmap.width(), bitmap.height());
+    for (int x = x0; x <= x1; x++) {
+        for (int y = y0; y <= y1; y++) {
+            // The tile we upload is always a whole cell of the grid, so that it is found in the
+            // cache again however srcRect and the clip move. Only the part of it that we draw
+            // depends on them; in strict mode the texture domain keeps sampling inside that part.
+            SkIRect iTileR = SkIRect::MakeXYWH(x * tileSize, y * tileSize, tileSize, tileSize);
+            if (!iTileR.intersect(bitmapBounds)) {
+                continue;
+            }
 
+            SkRect tileR = SkRect::Make(iTileR);
             if (!SkRect::Intersects(tileR, clippedSrcRect)) {
                 continue;
             }
@@ -905,27 +903,15 @@ void SkGpuDevice::drawTiledBitmap(const SkBitmap& bitmap,
                 continue;
             }
 
-            SkIRect iTileR;
-            tileR.roundOut(&iTileR);
             SkVector offset = SkPoint::Make(SkIntToScalar(iTileR.fLeft),
                                             SkIntToScalar(iTileR.fTop));
             SkRect rectToDraw = tileR;
             dstMatrix.mapRect(&rectToDraw);
             if (GrSamplerState::Filter::kNearest != params.filter() || bicubic) {
-                SkIRect iClampRect;
-
-                if (SkCanvas::kFast_SrcRectConstraint == constraint) {
-                    // In bleed mode we want to always expand the tile on all edges
-                    // but stay within the bitmap bounds
-                    iClampRect = SkIRect::MakeWH(bitmap.width(), bitmap.height());
-                } else {
-                    // In texture-domain/clamp mode we only want to expand the
-                    // tile on edges interior to "srcRect" (i.e., we want to
-                    // not bleed across the original clamped edges)
-                    srcRect.roundOut(&iClampRect);
-                }
+                // Expand the tile on all edges so that filtering can read across the seams, but
+                // stay within the bitmap bounds.
                 int outset = bicubic ? GrBicubicEffect::kFilterTexelPad : 1;
-                clamped_outset_with_offset(&iTileR, outset, &offset, iClampRect);
+                clamped_outset_with_offset(&iTileR, outset, &offset, bitmapBounds);
             }
 
             SkBitmap tmpB;
@@ -1274,6 +1260,10 @@ void SkGpuDevice::drawImage(const SkImage* image, SkScalar x, SkScalar y, const
     ASSERT_SINGLE_OWNER
     SkMatrix viewMatrix = this->ctm();
     viewMatrix.preTranslate(x, y);
+    if (this->drawYUVAImage(image, nullptr, SkRect::MakeIWH(image->width(), image->height()),
+                            SkCanvas::kFast_SrcRectConstraint, viewMatrix, paint)) {
+        return;
+    }
     uint32_t pinnedUniqueID;
     if (sk_sp<GrTextureProxy> proxy = as_IB(image)->refPinnedTextureProxy(&pinnedUniqueID)) {
         this->drawPinnedTextureProxy(std::move(proxy), pinnedUniqueID, as_IB(image)->colorSpace(),
@@ -1311,6 +1301,9 @@ void SkGpuDevice::drawImageRect(const SkImage* image, const SkRect* src, const S
     if (!src || src->contains(image->bounds())) {
         constraint = SkCanvas::kFast_SrcRectConstraint;
     }
+    if (this->drawYUVAImage(image, src, dst, constraint, this->ctm(), paint)) {
+        return;
+    }
     if (sk_sp<GrTextureProxy> proxy = as_IB(image)->refPinnedTextureProxy(&pinnedUniqueID)) {
         this->drawPinnedTextureProxy(std::move(proxy), pinnedUniqueID, as_IB(image)->colorSpace(),
                                      image->alphaType(), src, &dst, constraint, this->ctm(), paint);
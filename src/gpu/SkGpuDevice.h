@@ -213,6 +213,11 @@ private:
                                 const SkMatrix& viewMatrix,
                                 const SkPaint&);
 
+    // Draws a YUVA image straight from its planes rather than flattening it to RGB first. Returns
+    // false, having drawn nothing, if the image or paint needs the general path.
+    bool drawYUVAImage(const SkImage*, const SkRect* srcRect, const SkRect& dstRect,
+                       SkCanvas::SrcRectConstraint, const SkMatrix& viewMatrix, const SkPaint&);
+
     void drawTextureMaker(GrTextureMaker* maker,
                           int imageW,
                           int imageH,
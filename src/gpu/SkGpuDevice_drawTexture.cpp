@@ -14,6 +14,7 @@
 #include "GrStyle.h"
 #include "GrTextureAdjuster.h"
 #include "GrTextureMaker.h"
+#include "SkImage_GpuYUVA.h"
 #include "SkDraw.h"
 #include "SkGr.h"
 #include "SkMaskFilterBase.h"
@@ -327,3 +328,56 @@ void SkGpuDevice::drawTextureProducerImpl(GrTextureProducer* producer,
     GrBlurUtils::drawShapeWithMaskFilter(this->context(), fRenderTargetContext.get(), this->clip(),
                                          shape, std::move(grPaint), viewMatrix, mf);
 }
+
+bool SkGpuDevice::drawYUVAImage(const SkImage* image, const SkRect* srcRect,
+                                const SkRect& dstRect, SkCanvas::SrcRectConstraint constraint,
+                                const SkMatrix& viewMatrix, const SkPaint& paint) {
+    if (!as_IB(image)->isYUVA() || as_IB(image)->context() != fContext.get()) {
+        return false;
+    }
+    const SkImage_GpuYUVA* yuvaImage = static_cast<const SkImage_GpuYUVA*>(as_IB(image));
+
+    // Mask filters change the geometry, so the plane samples could not use the src rect as their
+    // local coords. Strict constraints would need a domain on each plane; leave both to the
+    // flattened image.
+    if (paint.getMaskFilter()) {
+        return false;
+    }
+    const SkRect bounds = SkRect::MakeIWH(image->width(), image->height());
+    SkRect src = srcRect ? *srcRect : bounds;
+    if (!bounds.contains(src)) {
+        return false;
+    }
+    if (SkCanvas::kStrict_SrcRectConstraint == constraint && src != bounds) {
+        return false;
+    }
+
+    SkMatrix srcToDstMatrix;
+    if (!srcToDstMatrix.setRectToRect(src, dstRect, SkMatrix::kFill_ScaleToFit)) {
+        return false;
+    }
+    bool doBicubic;
+    GrSamplerState::Filter filterMode = GrSkFilterQualityToGrFilterMode(
+            paint.getFilterQuality(), viewMatrix, srcToDstMatrix,
+            fContext->contextPriv().sharpenMipmappedTextures(), &doBicubic);
+    if (doBicubic) {
+        return false;
+    }
+
+    auto fp = yuvaImage->asYUVAFragmentProcessor(filterMode);
+    if (!fp) {
+        return false;
+    }
+    fp = GrColorSpaceXformEffect::Make(std::move(fp), as_IB(image)->colorSpace(),
+                                       image->alphaType(),
+                                       fRenderTargetContext->colorSpaceInfo().colorSpace());
+
+    GrPaint grPaint;
+    if (!SkPaintToGrPaintWithTexture(fContext.get(), fRenderTargetContext->colorSpaceInfo(), paint,
+                                     viewMatrix, std::move(fp), false, &grPaint)) {
+        return true;
+    }
+    fRenderTargetContext->fillRectToRect(this->clip(), std::move(grPaint),
+                                         GrAA(paint.isAntiAlias()), viewMatrix, dstRect, src);
+    return true;
+}
@@ -342,6 +342,7 @@ static inline int32_t dither_range_type_for_config(GrPixelConfig dstConfig) {
         case kAlpha_8_GrPixelConfig:
         case kAlpha_8_as_Alpha_GrPixelConfig:
         case kAlpha_8_as_Red_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:
             return -1;
     }
     SkASSERT(false);
@@ -258,7 +258,17 @@ void GrCCDrawPathsOp::accountForOwnPaths(GrCCPathCache* pathCache,
                     (draw.fCachedAtlasProxy = onFlushRP->findOrCreateProxyByUniqueKey(
                                                      cacheEntry->atlasKey(),
                                                      GrCCAtlas::kTextureOrigin))) {
-                    ++specs->fNumCachedPaths;
+                    if (cacheEntry->needsCompaction()) {
+                        // The atlas is fragmented. Move the path into a fresh one. (We decide
+                        // here, since later lookups may invalidate more of the atlas.)
+                        draw.fCompactCachedMask = true;
+                        ++specs->fNumCompactedPaths;
+                        specs->fCopyAtlasSpecs.accountForSpace(cacheEntry->width(),
+                                                               cacheEntry->height());
+                    } else {
+                        ++specs->fNumCachedPaths;
+                    }
+                    pathCache->stats()->incHits();
                     continue;
                 }
 
@@ -273,6 +283,7 @@ void GrCCDrawPathsOp::accountForOwnPaths(GrCCPathCache* pathCache,
                     specs->fCopyPathStats[idx].statPath(path);
                     specs->fCopyAtlasSpecs.accountForSpace(cacheEntry->width(),
                                                            cacheEntry->height());
+                    pathCache->stats()->incHits();
                     continue;
                 }
 
@@ -290,6 +301,8 @@ void GrCCDrawPathsOp::accountForOwnPaths(GrCCPathCache* pathCache,
                     draw.fMaskVisibility = Visibility::kComplete;
                 }
             }
+
+            pathCache->stats()->incMisses();
         }
 
         int idx = (draw.fShape.style().strokeRec().isFillStyle())
@@ -321,11 +334,33 @@ void GrCCDrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
         if (auto cacheEntry = draw.fCacheEntry.get()) {
             // Does the path already exist in a cached atlas texture?
             if (auto proxy = draw.fCachedAtlasProxy.get()) {
-                SkASSERT(!cacheEntry->currFlushAtlas());
-                this->recordInstance(proxy, resources->nextPathInstanceIdx());
-                resources->appendDrawPathInstance().set(*cacheEntry, draw.fCachedMaskShift,
-                                                        draw.fColor);
-                continue;
+                if (DoCopiesToCache::kYes == doCopies && draw.fCompactCachedMask &&
+                    !cacheEntry->currFlushAtlas()) {
+                    // The cached atlas is fragmented. Copy the path into a new one on the GPU.
+                    // (Cached atlases hold literal coverage, so the copy never does even/odd.)
+                    SkASSERT(cacheEntry->needsCompaction());
+                    SkIVector newOffset;
+                    GrCCAtlas* atlas = resources->copyPathToCachedAtlas(
+                            *cacheEntry, DoEvenOddFill::kNo, proxy, &newOffset);
+                    cacheEntry->updateToCachedAtlas(atlas->getOrAssignUniqueKey(onFlushRP),
+                                                    onFlushRP->contextUniqueID(), newOffset,
+                                                    atlas->refOrMakeCachedAtlasInfo());
+                    this->recordInstance(atlas->textureProxy(), resources->nextPathInstanceIdx());
+                    resources->appendDrawPathInstance().set(*cacheEntry, draw.fCachedMaskShift,
+                                                            draw.fColor);
+                    // Remember this atlas in case we encounter the path again during the flush.
+                    cacheEntry->setCurrFlushAtlas(atlas);
+                    continue;
+                }
+
+                // If the path was already moved to a new atlas during this flush, draw it from
+                // there instead (below).
+                if (!cacheEntry->currFlushAtlas()) {
+                    this->recordInstance(proxy, resources->nextPathInstanceIdx());
+                    resources->appendDrawPathInstance().set(*cacheEntry, draw.fCachedMaskShift,
+                                                            draw.fColor);
+                    continue;
+                }
             }
 
             // Have we already encountered this path during the flush? (i.e. was the same SkPath
@@ -343,8 +378,8 @@ void GrCCDrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
             // 8-bit atlas in the resource cache.
             if (DoCopiesToCache::kYes == doCopies && cacheEntry->atlasKey().isValid()) {
                 SkIVector newOffset;
-                GrCCAtlas* atlas =
-                        resources->copyPathToCachedAtlas(*cacheEntry, doEvenOddFill, &newOffset);
+                GrCCAtlas* atlas = resources->copyPathToCachedAtlas(*cacheEntry, doEvenOddFill,
+                                                                    nullptr, &newOffset);
                 cacheEntry->updateToCachedAtlas(atlas->getOrAssignUniqueKey(onFlushRP),
                                                 onFlushRP->contextUniqueID(), newOffset,
                                                 atlas->refOrMakeCachedAtlasInfo());
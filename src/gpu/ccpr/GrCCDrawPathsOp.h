@@ -60,7 +60,8 @@ public:
     };
 
     // Allocates the GPU resources indicated by accountForOwnPaths(), in preparation for drawing. If
-    // DoCopiesToCache is kNo, the paths slated for copy will instead be re-rendered from scratch.
+    // DoCopiesToCache is kNo, the paths slated for copy will instead be re-rendered from scratch,
+    // and paths slated for compaction will be drawn from the fragmented atlas they are already in.
     //
     // NOTE: If using DoCopiesToCache::kNo, it is the caller's responsibility to call
     //       convertCopiesToRenders() on the GrCCPerFlushResourceSpecs.
@@ -107,6 +108,8 @@ private:
         sk_sp<GrCCPathCacheEntry> fCacheEntry;
         sk_sp<GrTextureProxy> fCachedAtlasProxy;
         SkIVector fCachedMaskShift;
+        // Set during accountForOwnPaths() if the mask should move out of a fragmented atlas.
+        bool fCompactCachedMask = false;
 
         SingleDraw* fNext = nullptr;
     };
@@ -10,8 +10,8 @@
 #include "GrShape.h"
 #include "SkNx.h"
 
-// The maximum number of cache entries we allow in our own cache.
-static constexpr int kMaxCacheCount = 1 << 16;
+// The number of least recently used entries we choose from when the cache is full.
+static constexpr int kNumEvictionCandidates = 8;
 
 GrCCPathCache::MaskTransform::MaskTransform(const SkMatrix& m, SkIVector* shift)
         : fMatrix2x2{m.getScaleX(), m.getSkewX(), m.getSkewY(), m.getScaleY()} {
@@ -171,7 +171,8 @@ sk_sp<GrCCPathCacheEntry> GrCCPathCache::find(const GrShape& shape, const MaskTr
             return nullptr;
         }
         if (fHashTable.count() >= kMaxCacheCount) {
-            this->evict(fLRU.tail());  // We've exceeded our limit.
+            this->evict(this->findEvictionCandidate());  // We've exceeded our limit.
+            fStats.incEvictions();
         }
         entry = fHashTable.set(HashNode(this, m, shape))->entry();
         shape.addGenIDChangeListener(sk_ref_sp(entry));
@@ -184,6 +185,36 @@ sk_sp<GrCCPathCacheEntry> GrCCPathCache::find(const GrShape& shape, const MaskTr
     return sk_ref_sp(entry);
 }
 
+// Entries that never got a mask go first, fewest hits first, since nothing was invested in them.
+// Among entries that have a mask, the one with the fewest hits per mask pixel is worth the least.
+static bool is_worth_less(const GrCCPathCacheEntry& a, const GrCCPathCacheEntry& b) {
+    bool aHasMask = a.atlasKey().isValid(), bHasMask = b.atlasKey().isValid();
+    if (aHasMask != bHasMask) {
+        return !aHasMask;
+    }
+    if (!aHasMask) {
+        return a.hitCount() < b.hitCount();
+    }
+    int64_t aArea = SkTMax(sk_64_mul(a.width(), a.height()), (int64_t)1);
+    int64_t bArea = SkTMax(sk_64_mul(b.width(), b.height()), (int64_t)1);
+    return a.hitCount() * bArea < b.hitCount() * aArea;
+}
+
+GrCCPathCacheEntry* GrCCPathCache::findEvictionCandidate() const {
+    // Rather than strictly evicting the least recently used entry, choose the one worth the least
+    // among the few least recently used. Ties go to the least recently used.
+    SkTInternalLList<GrCCPathCacheEntry>::Iter iter;
+    GrCCPathCacheEntry* candidate =
+            iter.init(fLRU, SkTInternalLList<GrCCPathCacheEntry>::Iter::kTail_IterStart);
+    GrCCPathCacheEntry* entry = candidate;
+    for (int i = 1; i < kNumEvictionCandidates && (entry = iter.prev()); ++i) {
+        if (is_worth_less(*entry, *candidate)) {
+            candidate = entry;
+        }
+    }
+    return candidate;
+}
+
 void GrCCPathCache::evict(const GrCCPathCacheEntry* entry) {
     SkASSERT(entry);
     SkASSERT(this == entry->fCacheWeakPtr);
@@ -230,10 +261,19 @@ void GrCCPathCacheEntry::updateToCachedAtlas(const GrUniqueKey& atlasKey, uint32
 
     fContextUniqueID = contextUniqueID;
 
+    if (fCachedAtlasInfo) {
+        // The mask was copied out of a cached atlas that is being compacted.
+        SkASSERT(this->needsCompaction());
+        this->invalidateAtlas();
+        if (fCacheWeakPtr) {
+            fCacheWeakPtr->stats()->incCompactedPaths();
+        }
+    }
+
     fAtlasKey = atlasKey;
     fAtlasOffset = newAtlasOffset;
 
-    SkASSERT(!fCachedAtlasInfo);  // Otherwise we need to invalidate our pixels in the old info.
+    SkASSERT(!fCachedAtlasInfo);
     fCachedAtlasInfo = std::move(info);
     fCachedAtlasInfo->fNumPathPixels += this->height() * this->width();
 }
@@ -242,8 +282,11 @@ void GrCCPathCacheEntry::invalidateAtlas() {
     if (fCachedAtlasInfo) {
         // Mark our own pixels invalid in the cached atlas texture.
         fCachedAtlasInfo->fNumInvalidatedPathPixels += this->height() * this->width();
+        // When compacting, the atlas stays until all its paths have moved out or gone away.
+        int purgeThreshold = fCompactAtlases ? fCachedAtlasInfo->fNumPathPixels
+                                             : fCachedAtlasInfo->fNumPathPixels / 2;
         if (!fCachedAtlasInfo->fIsPurgedFromResourceCache &&
-            fCachedAtlasInfo->fNumInvalidatedPathPixels >= fCachedAtlasInfo->fNumPathPixels / 2) {
+            fCachedAtlasInfo->fNumInvalidatedPathPixels >= purgeThreshold) {
             // Too many invalidated pixels: purge the atlas texture from the resource cache.
             SkMessageBus<GrUniqueKeyInvalidatedMessage>::Post(
                     GrUniqueKeyInvalidatedMessage(fAtlasKey, fContextUniqueID));
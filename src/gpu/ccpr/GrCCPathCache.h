@@ -9,6 +9,7 @@
 #define GrCCPathCache_DEFINED
 
 #include "SkExchange.h"
+#include "SkTArray.h"
 #include "SkTHash.h"
 #include "SkTInternalLList.h"
 #include "ccpr/GrCCAtlas.h"
@@ -16,14 +17,26 @@
 
 class GrCCPathCacheEntry;
 class GrShape;
+class SkString;
 
 /**
  * This class implements an LRU cache that maps from GrShape to GrCCPathCacheEntry objects. Shapes
  * are only given one entry in the cache, so any time they are accessed with a different matrix, the
  * old entry gets evicted.
+ *
+ * By default, a cached atlas is purged from the resource cache once half of its pixels belong to
+ * paths that are gone, and the paths still in it get rendered again. If 'compactAtlases' is true,
+ * the atlas is instead marked as needing compaction: each time one of its remaining paths gets
+ * drawn, the mask is copied on the GPU into a fresh atlas and the entry moves there. The old atlas
+ * is purged once none of its paths are left.
  */
 class GrCCPathCache {
 public:
+    // The maximum number of cache entries we allow in our own cache.
+    static constexpr int kMaxCacheCount = 1 << 16;
+
+    explicit GrCCPathCache(bool compactAtlases = false) : fCompactAtlases(compactAtlases) {}
+
 #ifdef SK_DEBUG
     ~GrCCPathCache() {
         // Ensure the hash table and LRU list are still coherent.
@@ -57,7 +70,48 @@ public:
 
     void evict(const GrCCPathCacheEntry*);
 
+    int count() const { return fHashTable.count(); }
+
+    bool compactsAtlases() const { return fCompactAtlases; }
+
+    // Counts how well the cache serves draws. Only collected if GR_CACHE_STATS == 1.
+    class Stats {
+    public:
+#if GR_CACHE_STATS
+        // Draws whose mask was found in a cached atlas, or in the atlas stashed from last flush.
+        int hits() const { return fHits; }
+        void incHits() { ++fHits; }
+        // Draws of cacheable paths whose mask had to be rendered.
+        int misses() const { return fMisses; }
+        void incMisses() { ++fMisses; }
+        // Masks copied out of fragmented atlases into fresh ones.
+        int compactedPaths() const { return fCompactedPaths; }
+        void incCompactedPaths() { ++fCompactedPaths; }
+        // Entries evicted to make room for new ones.
+        int evictions() const { return fEvictions; }
+        void incEvictions() { ++fEvictions; }
+        void dump(SkString*) const;
+        void dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values) const;
+    private:
+        int fHits = 0;
+        int fMisses = 0;
+        int fCompactedPaths = 0;
+        int fEvictions = 0;
+#else
+        void incHits() {}
+        void incMisses() {}
+        void incCompactedPaths() {}
+        void incEvictions() {}
+#endif
+    };
+
+    Stats* stats() { return &fStats; }
+    const Stats& stats() const { return fStats; }
+
 private:
+    // Chooses which entry to evict once the cache is full.
+    GrCCPathCacheEntry* findEvictionCandidate() const;
+
     // Wrapper around a raw GrShape key that has a specialized operator==. Used by the hash table.
     struct HashKey {
         const uint32_t* fData;
@@ -90,6 +144,8 @@ private:
 
     SkTHashTable<HashNode, HashKey> fHashTable;
     SkTInternalLList<GrCCPathCacheEntry> fLRU;
+    const bool fCompactAtlases;
+    Stats fStats;
 };
 
 /**
@@ -114,6 +170,14 @@ public:
     // (i.e. not a temporarily-stashed, fp16 coverage count atlas.)
     bool hasCachedAtlas() const { return SkToBool(fCachedAtlasInfo); }
 
+    // Does this entry reference a cached atlas that the path cache wants compacted? If so, the
+    // caller should copy the mask into a new cached atlas the next time it draws the path.
+    bool needsCompaction() const {
+        return fCompactAtlases && fCachedAtlasInfo &&
+               !fCachedAtlasInfo->fIsPurgedFromResourceCache &&
+               fCachedAtlasInfo->fNumInvalidatedPathPixels >= fCachedAtlasInfo->fNumPathPixels / 2;
+    }
+
     const SkIRect& devIBounds() const { return fDevIBounds; }
     int width() const { return fDevIBounds.width(); }
     int height() const { return fDevIBounds.height(); }
@@ -127,7 +191,8 @@ public:
                             const SkIVector& maskShift);
 
     // Called once our path mask has been copied into a permanent, 8-bit atlas. This method points
-    // the entry at the new atlas and updates the CachedAtlasInfo data.
+    // the entry at the new atlas and updates the CachedAtlasInfo data. If the mask was copied out
+    // of another cached atlas (see needsCompaction()), its pixels there are marked invalid.
     void updateToCachedAtlas(const GrUniqueKey& atlasKey, uint32_t contextUniqueID,
                              const SkIVector& newAtlasOffset, sk_sp<GrCCAtlas::CachedAtlasInfo>);
 
@@ -154,7 +219,7 @@ private:
     using MaskTransform = GrCCPathCache::MaskTransform;
 
     GrCCPathCacheEntry(GrCCPathCache* cache, const MaskTransform& m)
-            : fCacheWeakPtr(cache), fMaskTransform(m) {}
+            : fCacheWeakPtr(cache), fMaskTransform(m), fCompactAtlases(cache->compactsAtlases()) {}
 
     // Resets this entry back to not having an atlas, and purges its previous atlas texture from the
     // resource cache if needed.
@@ -166,6 +231,7 @@ private:
     uint32_t fContextUniqueID;
     GrCCPathCache* fCacheWeakPtr;  // Gets manually reset to null by the path cache upon eviction.
     MaskTransform fMaskTransform;
+    const bool fCompactAtlases;  // Outlives fCacheWeakPtr, since we invalidate upon destruction.
     int fHitCount = 1;
 
     GrUniqueKey fAtlasKey;
@@ -50,52 +50,64 @@ protected:
     const sk_sp<const GrCCPerFlushResources> fResources;
 };
 
-// Copies paths from a stashed coverage count atlas into an 8-bit literal-coverage atlas.
+// Copies paths from a stashed coverage count atlas, or from cached atlases that are being
+// compacted, into an 8-bit literal-coverage atlas.
 class CopyAtlasOp : public AtlasOp {
 public:
     DEFINE_OP_CLASS_ID
 
+    // The instances from the previous range's end (or baseInstance) up to fEndInstance are copied
+    // out of fSrcProxy.
+    struct SrcRange {
+        sk_sp<GrTextureProxy> fSrcProxy;
+        int fEndInstance;
+    };
+
     static std::unique_ptr<GrDrawOp> Make(GrContext* context,
                                           sk_sp<const GrCCPerFlushResources> resources,
-                                          sk_sp<GrTextureProxy> copyProxy, int baseInstance,
-                                          int endInstance, const SkISize& drawBounds) {
+                                          SkTArray<SrcRange>&& srcRanges, int baseInstance,
+                                          const SkISize& drawBounds) {
         GrOpMemoryPool* pool = context->contextPriv().opMemoryPool();
 
-        return pool->allocate<CopyAtlasOp>(std::move(resources), std::move(copyProxy),
-                                           baseInstance, endInstance, drawBounds);
+        return pool->allocate<CopyAtlasOp>(std::move(resources), std::move(srcRanges),
+                                           baseInstance, drawBounds);
     }
 
     const char* name() const override { return "CopyAtlasOp (CCPR)"; }
     void visitProxies(const VisitProxyFunc& fn, VisitorType) const override {
-        fn(fStashedAtlasProxy.get());
+        for (const SrcRange& range : fSrcRanges) {
+            fn(range.fSrcProxy.get());
+        }
     }
 
     void onExecute(GrOpFlushState* flushState) override {
-        SkASSERT(fStashedAtlasProxy);
-        GrPipeline::FixedDynamicState dynamicState;
-        auto atlasProxy = fStashedAtlasProxy.get();
-        dynamicState.fPrimitiveProcessorTextures = &atlasProxy;
-
         GrPipeline pipeline(flushState->proxy(), GrScissorTest::kDisabled, SkBlendMode::kSrc);
-        GrCCPathProcessor pathProc(atlasProxy);
-        pathProc.drawPaths(flushState, pipeline, &dynamicState, *fResources, fBaseInstance,
-                           fEndInstance, this->bounds());
+        GrPipeline::FixedDynamicState dynamicState;
+        int baseInstance = fBaseInstance;
+        for (const SrcRange& range : fSrcRanges) {
+            SkASSERT(range.fSrcProxy);
+            auto srcProxy = range.fSrcProxy.get();
+            dynamicState.fPrimitiveProcessorTextures = &srcProxy;
+
+            GrCCPathProcessor pathProc(srcProxy);
+            pathProc.drawPaths(flushState, pipeline, &dynamicState, *fResources, baseInstance,
+                               range.fEndInstance, this->bounds());
+            baseInstance = range.fEndInstance;
+        }
     }
 
 private:
     friend class ::GrOpMemoryPool; // for ctor
 
-    CopyAtlasOp(sk_sp<const GrCCPerFlushResources> resources, sk_sp<GrTextureProxy> copyProxy,
-                int baseInstance, int endInstance, const SkISize& drawBounds)
+    CopyAtlasOp(sk_sp<const GrCCPerFlushResources> resources, SkTArray<SrcRange>&& srcRanges,
+                int baseInstance, const SkISize& drawBounds)
             : AtlasOp(ClassID(), std::move(resources), drawBounds)
-            , fStashedAtlasProxy(copyProxy)
-            , fBaseInstance(baseInstance)
-            , fEndInstance(endInstance) {
+            , fSrcRanges(std::move(srcRanges))
+            , fBaseInstance(baseInstance) {
     }
 
-    sk_sp<GrTextureProxy> fStashedAtlasProxy;
+    SkTArray<SrcRange> fSrcRanges;
     const int fBaseInstance;
-    const int fEndInstance;
 };
 
 // Renders coverage counts to a CCPR atlas using the resources' pre-filled GrCCPathParser.
@@ -142,7 +154,7 @@ private:
 static int inst_buffer_count(const GrCCPerFlushResourceSpecs& specs) {
     return specs.fNumCachedPaths +
            // Copies get two instances per draw: 1 copy + 1 draw.
-           (specs.fNumCopiedPaths[kFillIdx] + specs.fNumCopiedPaths[kStrokeIdx]) * 2 +
+           specs.numCopies() * 2 +
            specs.fNumRenderedPaths[kFillIdx] + specs.fNumRenderedPaths[kStrokeIdx];
            // No clips in instance buffers.
 }
@@ -169,8 +181,7 @@ GrCCPerFlushResources::GrCCPerFlushResources(GrOnFlushResourceProvider* onFlushR
         , fInstanceBuffer(onFlushRP->makeBuffer(kVertex_GrBufferType,
                                                 inst_buffer_count(specs) * sizeof(PathInstance)))
         , fNextCopyInstanceIdx(0)
-        , fNextPathInstanceIdx(specs.fNumCopiedPaths[kFillIdx] +
-                               specs.fNumCopiedPaths[kStrokeIdx]) {
+        , fNextPathInstanceIdx(specs.numCopies()) {
     if (!fIndexBuffer) {
         SkDebugf("WARNING: failed to allocate CCPR index buffer. No paths will be drawn.\n");
         return;
@@ -185,17 +196,20 @@ GrCCPerFlushResources::GrCCPerFlushResources(GrOnFlushResourceProvider* onFlushR
     }
     fPathInstanceData = static_cast<PathInstance*>(fInstanceBuffer->map());
     SkASSERT(fPathInstanceData);
-    SkDEBUGCODE(fEndCopyInstance =
-                        specs.fNumCopiedPaths[kFillIdx] + specs.fNumCopiedPaths[kStrokeIdx]);
+    SkDEBUGCODE(fEndCopyInstance = specs.numCopies());
     SkDEBUGCODE(fEndPathInstance = inst_buffer_count(specs));
 }
 
 GrCCAtlas* GrCCPerFlushResources::copyPathToCachedAtlas(const GrCCPathCacheEntry& entry,
                                                         GrCCPathProcessor::DoEvenOddFill evenOdd,
+                                                        GrTextureProxy* srcCachedAtlasProxy,
                                                         SkIVector* newAtlasOffset) {
     SkASSERT(this->isMapped());
     SkASSERT(fNextCopyInstanceIdx < fEndCopyInstance);
-    SkASSERT(!entry.hasCachedAtlas());  // Unexpected, but not necessarily a problem.
+    // Paths only get copied out of a cached atlas when it is being compacted. Cached atlases
+    // already hold literal coverage.
+    SkASSERT(entry.hasCachedAtlas() == SkToBool(srcCachedAtlasProxy));
+    SkASSERT(!srcCachedAtlasProxy || GrCCPathProcessor::DoEvenOddFill::kNo == evenOdd);
 
     if (GrCCAtlas* retiredAtlas = fCopyAtlasStack.addRect(entry.devIBounds(), newAtlasOffset)) {
         // We did not fit in the previous copy atlas and it was retired. We will render the copies
@@ -204,6 +218,11 @@ GrCCAtlas* GrCCPerFlushResources::copyPathToCachedAtlas(const GrCCPathCacheEntry
     }
 
     fPathInstanceData[fNextCopyInstanceIdx++].set(entry, *newAtlasOffset, GrColor_WHITE, evenOdd);
+    if (fCopyPathRanges.empty() || fCopyPathRanges.back().fSrcProxy.get() != srcCachedAtlasProxy) {
+        fCopyPathRanges.push_back({sk_ref_sp(srcCachedAtlasProxy), fNextCopyInstanceIdx});
+    } else {
+        fCopyPathRanges.back().fEndInstance = fNextCopyInstanceIdx;
+    }
     return &fCopyAtlasStack.current();
 }
 
@@ -387,18 +406,37 @@ bool GrCCPerFlushResources::finalize(GrOnFlushResourceProvider* onFlushRP,
         return false;
     }
 
-    // Draw the copies from the stashed atlas into 8-bit cached atlas(es).
+    // Draw the copies from the stashed atlas, and from cached atlases being compacted, into 8-bit
+    // cached atlas(es).
     int baseCopyInstance = 0;
+    const CopyPathRange* copyRange = fCopyPathRanges.begin();
     for (GrCCAtlasStack::Iter atlas(fCopyAtlasStack); atlas.next();) {
         int endCopyInstance = atlas->getFillBatchID();
         if (endCopyInstance <= baseCopyInstance) {
             SkASSERT(endCopyInstance == baseCopyInstance);
             continue;
         }
+        // Split the atlas's copies up by the atlas they read from. Source ranges may span more
+        // than one destination atlas.
+        SkSTArray<4, CopyAtlasOp::SrcRange> srcRanges;
+        for (;;) {
+            SkASSERT(copyRange != fCopyPathRanges.end());
+            const sk_sp<GrTextureProxy>& srcProxy =
+                    copyRange->fSrcProxy ? copyRange->fSrcProxy : stashedAtlasProxy;
+            if (copyRange->fEndInstance >= endCopyInstance) {
+                srcRanges.push_back({srcProxy, endCopyInstance});
+                if (copyRange->fEndInstance == endCopyInstance) {
+                    ++copyRange;
+                }
+                break;
+            }
+            srcRanges.push_back({srcProxy, copyRange->fEndInstance});
+            ++copyRange;
+        }
         if (auto rtc = atlas->makeRenderTargetContext(onFlushRP)) {
             GrContext* ctx = rtc->surfPriv().getContext();
-            auto op = CopyAtlasOp::Make(ctx, sk_ref_sp(this), stashedAtlasProxy, baseCopyInstance,
-                                        endCopyInstance, atlas->drawBounds());
+            auto op = CopyAtlasOp::Make(ctx, sk_ref_sp(this), std::move(srcRanges),
+                                        baseCopyInstance, atlas->drawBounds());
             rtc->addDrawOp(GrNoClip(), std::move(op));
             out->push_back(std::move(rtc));
         }
@@ -432,6 +470,9 @@ bool GrCCPerFlushResources::finalize(GrOnFlushResourceProvider* onFlushRP,
 }
 
 void GrCCPerFlushResourceSpecs::convertCopiesToRenders() {
+    fNumCachedPaths += fNumCompactedPaths;
+    fNumCompactedPaths = 0;
+
     for (int i = 0; i < 2; ++i) {
         fNumRenderedPaths[i] += fNumCopiedPaths[i];
         fNumCopiedPaths[i] = 0;
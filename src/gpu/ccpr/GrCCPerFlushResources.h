@@ -39,6 +39,8 @@ struct GrCCPerFlushResourceSpecs {
     static constexpr int kStrokeIdx = 1;
 
     int fNumCachedPaths = 0;
+    // Cached paths whose atlas needs compaction. These get copied into a new cached atlas.
+    int fNumCompactedPaths = 0;
 
     int fNumCopiedPaths[2] = {0, 0};
     GrCCRenderedPathStats fCopyPathStats[2];
@@ -50,9 +52,15 @@ struct GrCCPerFlushResourceSpecs {
     GrCCAtlas::Specs fRenderedAtlasSpecs;
 
     bool isEmpty() const {
-        return 0 == fNumCachedPaths + fNumCopiedPaths[kFillIdx] + fNumCopiedPaths[kStrokeIdx] +
-                    fNumRenderedPaths[kFillIdx] + fNumRenderedPaths[kStrokeIdx] + fNumClipPaths;
+        return 0 == fNumCachedPaths + fNumCompactedPaths + fNumCopiedPaths[kFillIdx] +
+                    fNumCopiedPaths[kStrokeIdx] + fNumRenderedPaths[kFillIdx] +
+                    fNumRenderedPaths[kStrokeIdx] + fNumClipPaths;
     }
+    int numCopies() const {
+        return fNumCompactedPaths + fNumCopiedPaths[kFillIdx] + fNumCopiedPaths[kStrokeIdx];
+    }
+    // Paths from the stashed atlas get rendered instead, and paths that need compaction get drawn
+    // from their current cached atlas.
     void convertCopiesToRenders();
 };
 
@@ -70,7 +78,11 @@ public:
     // Copies a path out of the the previous flush's stashed mainline coverage count atlas, and into
     // a cached, 8-bit, literal-coverage atlas. The actual source texture to copy from will be
     // provided at the time finalize() is called.
+    //
+    // If 'srcCachedAtlasProxy' is not null, the path is instead copied out of that cached atlas
+    // (i.e. the cached atlas is being compacted), and the fill type must be DoEvenOddFill::kNo.
     GrCCAtlas* copyPathToCachedAtlas(const GrCCPathCacheEntry&, GrCCPathProcessor::DoEvenOddFill,
+                                     GrTextureProxy* srcCachedAtlasProxy,
                                      SkIVector* newAtlasOffset);
 
     // These two methods render a path into a temporary coverage count atlas. See
@@ -102,7 +114,7 @@ public:
 
     // Finishes off the GPU buffers and renders the atlas(es). 'stashedAtlasProxy', if provided, is
     // the mainline coverage count atlas from the previous flush. It will be used as the source
-    // texture for any copies setup by copyStashedPathToAtlas().
+    // texture for any copies setup by copyPathToCachedAtlas() without a cached atlas proxy.
     bool finalize(GrOnFlushResourceProvider*, sk_sp<GrTextureProxy> stashedAtlasProxy,
                   SkTArray<sk_sp<GrRenderTargetContext>>* out);
 
@@ -130,6 +142,13 @@ public:
     }
 
 private:
+    // A run of consecutive copy instances that all read from the same source atlas. A null
+    // fSrcProxy stands for the stashed atlas, which is not known until finalize().
+    struct CopyPathRange {
+        sk_sp<GrTextureProxy> fSrcProxy;
+        int fEndInstance;
+    };
+
     bool placeRenderedPathInAtlas(const SkIRect& clipIBounds, const SkIRect& pathIBounds,
                                   GrScissorTest*, SkIRect* clippedPathIBounds,
                                   SkIVector* devToAtlasOffset);
@@ -145,6 +164,7 @@ private:
     const sk_sp<GrBuffer> fInstanceBuffer;
 
     GrCCPathProcessor::Instance* fPathInstanceData = nullptr;
+    SkSTArray<4, CopyPathRange> fCopyPathRanges;
     int fNextCopyInstanceIdx;
     SkDEBUGCODE(int fEndCopyInstance);
     int fNextPathInstanceIdx;
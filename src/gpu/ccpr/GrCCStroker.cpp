@@ -9,6 +9,7 @@
 
 #include "GrGpuCommandBuffer.h"
 #include "GrOnFlushResourceProvider.h"
+#include "SkGeometry.h"
 #include "SkPathPriv.h"
 #include "SkStrokeRec.h"
 #include "ccpr/GrCCCoverageProcessor.h"
@@ -292,6 +293,10 @@ constexpr GrPrimitiveProcessor::Attribute CubicStrokeProcessor::kInstanceAttribs
 
 }  // anonymous namespace
 
+// The maximum distance, in device-space pixels, between a stroked conic and the quadratics that
+// approximate it.
+static constexpr float kConicToQuadsTolerance = .25f;
+
 void GrCCStroker::parseDeviceSpaceStroke(const SkPath& path, const SkPoint* deviceSpacePts,
                                          const SkStrokeRec& stroke, float strokeDevWidth,
                                          GrScissorTest scissorTest,
@@ -326,7 +331,9 @@ void GrCCStroker::parseDeviceSpaceStroke(const SkPath& path, const SkPoint* devi
 
     fPathInfos.push_back() = {devToAtlasOffset, strokeDevWidth/2, scissorTest};
 
+    const float* conicWeights = SkPathPriv::ConicWeightData(path);
     int devPtsIdx = 0;
+    int conicWeightsIdx = 0;
     SkPath::Verb previousVerb = SkPath::kClose_Verb;
 
     for (SkPath::Verb verb : SkPathPriv::Verbs(path)) {
@@ -360,16 +367,28 @@ void GrCCStroker::parseDeviceSpaceStroke(const SkPath& path, const SkPoint* devi
                 devPtsIdx += 3;
                 break;
             }
-            case SkPath::kConic_Verb:
+            case SkPath::kConic_Verb: {
                 SkASSERT(SkPath::kClose_Verb != previousVerb);
-                SK_ABORT("Stroked conics not supported.");
+                // The stroke geometry has no conic strokes. Approximate with quadratics instead.
+                // (The points are already in device space, so the tolerance is in pixels.)
+                SkAutoConicToQuads quadConverter;
+                const SkPoint* quadPts = quadConverter.computeQuads(
+                        P, conicWeights[conicWeightsIdx], kConicToQuadsTolerance);
+                for (int i = 0; i < quadConverter.countQuads(); ++i) {
+                    fGeometry.quadraticTo(quadPts + i * 2);
+                }
+                devPtsIdx += 2;
+                ++conicWeightsIdx;
                 break;
+            }
             case SkPath::kDone_Verb:
                 break;
         }
         previousVerb = verb;
     }
 
+    SkASSERT(conicWeightsIdx == SkPathPriv::ConicWeightCnt(path));
+
     if (devPtsIdx > 0 && SkPath::kClose_Verb != previousVerb) {
         fGeometry.capContourAndExit();
     }
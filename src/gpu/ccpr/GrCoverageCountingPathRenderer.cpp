@@ -30,14 +30,16 @@ bool GrCoverageCountingPathRenderer::IsSupported(const GrCaps& caps) {
 }
 
 sk_sp<GrCoverageCountingPathRenderer> GrCoverageCountingPathRenderer::CreateIfSupported(
-        const GrCaps& caps, AllowCaching allowCaching) {
+        const GrCaps& caps, AllowCaching allowCaching, CompactAtlases compactAtlases) {
     return sk_sp<GrCoverageCountingPathRenderer>(
-            IsSupported(caps) ? new GrCoverageCountingPathRenderer(allowCaching) : nullptr);
+            IsSupported(caps) ? new GrCoverageCountingPathRenderer(allowCaching, compactAtlases)
+                              : nullptr);
 }
 
-GrCoverageCountingPathRenderer::GrCoverageCountingPathRenderer(AllowCaching allowCaching) {
+GrCoverageCountingPathRenderer::GrCoverageCountingPathRenderer(AllowCaching allowCaching,
+                                                               CompactAtlases compactAtlases) {
     if (AllowCaching::kYes == allowCaching) {
-        fPathCache = skstd::make_unique<GrCCPathCache>();
+        fPathCache = skstd::make_unique<GrCCPathCache>(CompactAtlases::kYes == compactAtlases);
     }
 }
 
@@ -53,7 +55,10 @@ GrCCPerOpListPaths* GrCoverageCountingPathRenderer::lookupPendingPaths(uint32_t
 GrPathRenderer::CanDrawPath GrCoverageCountingPathRenderer::onCanDrawPath(
         const CanDrawPathArgs& args) const {
     const GrShape& shape = *args.fShape;
-    if (GrAAType::kCoverage != args.fAAType || shape.style().hasPathEffect() ||
+    // Dashes get applied on the CPU in onDrawPath, and then stroked like any other path. The
+    // dashed path is no larger and has no other kinds of verbs than the original, so we can decide
+    // based on the original.
+    if (GrAAType::kCoverage != args.fAAType || shape.style().hasNonDashPathEffect() ||
         args.fViewMatrix->hasPerspective() || shape.inverseFilled()) {
         return CanDrawPath::kNo;
     }
@@ -115,10 +120,6 @@ GrPathRenderer::CanDrawPath GrCoverageCountingPathRenderer::onCanDrawPath(
                 return CanDrawPath::kNo;
             }
             SkASSERT(!SkScalarIsNaN(inflationRadius));
-            if (SkPathPriv::ConicWeightCnt(path)) {
-                // The stroker does not support conics yet.
-                return CanDrawPath::kNo;
-            }
             return CanDrawPath::kYes;
         }
 
@@ -137,7 +138,20 @@ bool GrCoverageCountingPathRenderer::onDrawPath(const DrawPathArgs& args) {
     GrRenderTargetContext* rtc = args.fRenderTargetContext;
     args.fClip->getConservativeBounds(rtc->width(), rtc->height(), &clipIBounds, nullptr);
 
-    auto op = GrCCDrawPathsOp::Make(args.fContext, clipIBounds, *args.fViewMatrix, *args.fShape,
+    const GrShape* shape = args.fShape;
+    GrShape dashedShape;
+    if (shape->style().isDashed()) {
+        // Break the path up into its dashes. They get stroked like any other path.
+        dashedShape = shape->applyStyle(GrStyle::Apply::kPathEffectOnly,
+                                        GrStyle::MatrixToScaleFactor(*args.fViewMatrix));
+        if (dashedShape.isEmpty()) {
+            return true;
+        }
+        SkASSERT(!dashedShape.style().hasPathEffect());
+        shape = &dashedShape;
+    }
+
+    auto op = GrCCDrawPathsOp::Make(args.fContext, clipIBounds, *args.fViewMatrix, *shape,
                                     std::move(args.fPaint));
     this->recordOp(std::move(op), args);
     return true;
@@ -183,6 +197,18 @@ std::unique_ptr<GrFragmentProcessor> GrCoverageCountingPathRenderer::makeClipPro
                                                  deviceSpacePath.getFillType());
 }
 
+const SkPath* GrCoverageCountingPathRenderer::findClipMaskPath(uint32_t maskGenID,
+                                                              const SkIRect& maskBounds,
+                                                              int numAnalyticFPs) {
+    return fClipMaskPaths.find({maskGenID, maskBounds, numAnalyticFPs});
+}
+
+const SkPath* GrCoverageCountingPathRenderer::addClipMaskPath(uint32_t maskGenID,
+                                                             const SkIRect& maskBounds,
+                                                             int numAnalyticFPs, SkPath&& path) {
+    return fClipMaskPaths.insert({maskGenID, maskBounds, numAnalyticFPs}, std::move(path));
+}
+
 void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlushRP,
                                               const uint32_t* opListIDs, int numOpListIDs,
                                               SkTArray<sk_sp<GrRenderTargetContext>>* out) {
@@ -243,16 +269,16 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
         return;  // Nothing to draw.
     }
 
-    // Determine if there are enough reusable paths from last flush for it to be worth our time to
-    // copy them to cached atlas(es).
-    int numCopies = specs.fNumCopiedPaths[GrCCPerFlushResourceSpecs::kFillIdx] +
-                    specs.fNumCopiedPaths[GrCCPerFlushResourceSpecs::kStrokeIdx];
+    // Determine if there are enough reusable paths from last flush, and paths to move out of
+    // fragmented cached atlases, for it to be worth our time to copy them to cached atlas(es).
+    int numCopies = specs.numCopies();
     DoCopiesToCache doCopies = DoCopiesToCache(numCopies > 100 ||
                                                specs.fCopyAtlasSpecs.fApproxNumPixels > 256 * 256);
     if (numCopies && DoCopiesToCache::kNo == doCopies) {
         specs.convertCopiesToRenders();
         SkASSERT(!specs.fNumCopiedPaths[GrCCPerFlushResourceSpecs::kFillIdx]);
         SkASSERT(!specs.fNumCopiedPaths[GrCCPerFlushResourceSpecs::kStrokeIdx]);
+        SkASSERT(!specs.fNumCompactedPaths);
     }
 
     auto resources = sk_make_sp<GrCCPerFlushResources>(onFlushRP, specs);
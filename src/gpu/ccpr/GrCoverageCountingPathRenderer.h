@@ -13,6 +13,7 @@
 #include "GrOnFlushResourceProvider.h"
 #include "GrPathRenderer.h"
 #include "GrRenderTargetOpList.h"
+#include "SkLRUCache.h"
 #include "ccpr/GrCCPerFlushResources.h"
 
 class GrCCDrawPathsOp;
@@ -34,7 +35,15 @@ public:
         kYes = true
     };
 
-    static sk_sp<GrCoverageCountingPathRenderer> CreateIfSupported(const GrCaps&, AllowCaching);
+    // Whether the path cache should copy the live masks out of fragmented atlases into new ones,
+    // rather than purge fragmented atlases and render their paths again. (See GrCCPathCache.)
+    enum class CompactAtlases : bool {
+        kNo = false,
+        kYes = true
+    };
+
+    static sk_sp<GrCoverageCountingPathRenderer> CreateIfSupported(
+            const GrCaps&, AllowCaching, CompactAtlases = CompactAtlases::kNo);
 
     using PendingPathsMap = std::map<uint32_t, sk_sp<GrCCPerOpListPaths>>;
 
@@ -60,6 +69,15 @@ public:
                                                            const SkIRect& accessRect, int rtWidth,
                                                            int rtHeight, const GrCaps&);
 
+    // GrReducedClip may reduce a whole clip mask to a single device-space path, which it then clips
+    // with through makeClipProcessor(). These paths are cached on the mask's gen ID, bounds, and
+    // the number of analytic FPs the reduced clip used, so that a clip reused across draws and
+    // frames keeps the same SkPath: path ops run once, and each opList's atlas renders it once.
+    const SkPath* findClipMaskPath(uint32_t maskGenID, const SkIRect& maskBounds,
+                                   int numAnalyticFPs);
+    const SkPath* addClipMaskPath(uint32_t maskGenID, const SkIRect& maskBounds,
+                                  int numAnalyticFPs, SkPath&&);
+
     // GrOnFlushCallbackObject overrides.
     void preFlush(GrOnFlushResourceProvider*, const uint32_t* opListIDs, int numOpListIDs,
                   SkTArray<sk_sp<GrRenderTargetContext>>* out) override;
@@ -68,6 +86,9 @@ public:
     void testingOnly_drawPathDirectly(const DrawPathArgs&);
     const GrUniqueKey& testingOnly_getStashedAtlasKey() const;
 
+    // Returns null if caching is not allowed.
+    const GrCCPathCache* pathCache() const { return fPathCache.get(); }
+
     // If a path spans more pixels than this, we need to crop it or else analytic AA can run out of
     // fp32 precision.
     static constexpr float kPathCropThreshold = 1 << 16;
@@ -82,7 +103,7 @@ public:
                                    float* inflationRadius = nullptr);
 
 private:
-    GrCoverageCountingPathRenderer(AllowCaching);
+    GrCoverageCountingPathRenderer(AllowCaching, CompactAtlases);
 
     // GrPathRenderer overrides.
     StencilSupport onGetStencilSupport(const GrShape&) const override {
@@ -106,6 +127,20 @@ private:
     std::unique_ptr<GrCCPathCache> fPathCache;
     GrUniqueKey fStashedAtlasKey;
 
+    struct ClipMaskKey {
+        uint32_t fMaskGenID;
+        SkIRect fMaskBounds;
+        int fNumAnalyticFPs;
+
+        bool operator==(const ClipMaskKey& that) const {
+            return fMaskGenID == that.fMaskGenID && fMaskBounds == that.fMaskBounds &&
+                   fNumAnalyticFPs == that.fNumAnalyticFPs;
+        }
+    };
+
+    static constexpr int kMaxCachedClipMaskPaths = 32;
+    SkLRUCache<ClipMaskKey, SkPath> fClipMaskPaths{kMaxCachedClipMaskPaths};
+
     SkDEBUGCODE(bool fFlushing = false);
 };
 
@@ -30,20 +30,25 @@ static const float kRec709ConversionMatrix[16] = {
 
 std::unique_ptr<GrFragmentProcessor> GrYUVtoRGBEffect::Make(const sk_sp<GrTextureProxy> proxies[],
                                                             const SkYUVAIndex yuvaIndices[4],
-                                                            SkYUVColorSpace yuvColorSpace) {
+                                                            SkYUVColorSpace yuvColorSpace,
+                                                            GrSamplerState::Filter filterMode) {
     int numPlanes;
     SkAssertResult(SkYUVAIndex::AreValidIndices(yuvaIndices, &numPlanes));
 
     const SkISize YSize = proxies[yuvaIndices[SkYUVAIndex::kY_Index].fIndex]->isize();
 
+    // The planes are never mipmapped, and subsampled planes always need bilerp to be upsampled.
+    if (GrSamplerState::Filter::kMipMap == filterMode) {
+        filterMode = GrSamplerState::Filter::kBilerp;
+    }
+
     GrSamplerState::Filter filterModes[4];
     SkSize scales[4];
     for (int i = 0; i < numPlanes; ++i) {
         SkISize size = proxies[i]->isize();
         scales[i] = SkSize::Make(SkIntToScalar(size.width()) / SkIntToScalar(YSize.width()),
                                  SkIntToScalar(size.height()) / SkIntToScalar(YSize.height()));
-        filterModes[i] = (size == YSize) ? GrSamplerState::Filter::kNearest
-                                         : GrSamplerState::Filter::kBilerp;
+        filterModes[i] = (size == YSize) ? filterMode : GrSamplerState::Filter::kBilerp;
     }
 
     SkMatrix44 mat;
@@ -408,6 +408,10 @@ sk_sp<const GrGLInterface> GrGLMakeAssembledGLInterface(void *ctx, GrGLGetProc g
         GET_PROC(ProgramParameteri);
     }
 
+    if (extensions.has("GL_KHR_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, KHR);
+    }
+
     if (glVer >= GR_GL_VER(3,2) || extensions.has("GL_ARB_sampler_objects")) {
         GET_PROC(BindSampler);
         GET_PROC(DeleteSamplers);
@@ -855,6 +859,10 @@ sk_sp<const GrGLInterface> GrGLMakeAssembledGLESInterface(void *ctx, GrGLGetProc
         GET_PROC(ProgramParameteri);
     }
 
+    if (extensions.has("GL_KHR_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, KHR);
+    }
+
     if (version >= GR_GL_VER(3,0)) {
         GET_PROC(BindSampler);
         GET_PROC(DeleteSamplers);
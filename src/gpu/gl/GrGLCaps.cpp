@@ -63,6 +63,7 @@ GrGLCaps::GrGLCaps(const GrContextOptions& contextOptions,
     fRequiresFlushBetweenNonAndInstancedDraws = false;
     fDetachStencilFromMSAABuffersBeforeReadPixels = false;
     fProgramBinarySupport = false;
+    fParallelShaderCompileSupport = false;
     fSamplerObjectSupport = false;
 
     fBlitFramebufferFlags = kNoSupport_BlitFramebufferFlag;
@@ -364,6 +365,12 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
     GR_GL_GetIntegerv(gli, GR_GL_MAX_TEXTURE_IMAGE_UNITS, &maxSamplers);
     shaderCaps->fMaxFragmentSamplers = SkTMin<GrGLint>(kMaxSaneSamplers, maxSamplers);
 
+    // Multitextured image draws select their sampler with a flat int varying. They trade draw
+    // calls for a branchier fragment shader, which only pays off for small images.
+    if (shaderCaps->fIntegerSupport && shaderCaps->fFlatInterpolationSupport) {
+        shaderCaps->fDisableImageMultitexturingDstRectAreaThreshold = 256 * 256;
+    }
+
     // SGX and Mali GPUs that are based on a tiled-deferred architecture that have trouble with
     // frequently changing VBOs. We've measured a performance increase using non-VBO vertex
     // data for dynamic content on these GPUs. Perhaps we should read the renderer string and
@@ -495,6 +502,12 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
     }
 
     fGpuTracingSupport = ctxInfo.hasExtension("GL_EXT_debug_marker");
+    // Timestamps are written with glQueryCounter, which ES only has in
+    // GL_EXT_disjoint_timer_query; GrGLAssembleInterface doesn't load that yet.
+    fGpuTimingSupport = kGL_GrGLStandard == standard &&
+                        (version >= GR_GL_VER(3,3) || ctxInfo.hasExtension("GL_ARB_timer_query")) &&
+                        gli->fFunctions.fGenQueries && gli->fFunctions.fDeleteQueries &&
+                        gli->fFunctions.fGetQueryObjectuiv;
 
     // Disable scratch texture reuse on Mali and Adreno devices
     fReuseScratchTextures = kARM_GrGLVendor != ctxInfo.vendor();
@@ -592,6 +605,7 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         GR_GL_GetIntegerv(gli, GR_GL_NUM_PROGRAM_BINARY_FORMATS, &count);
         fProgramBinarySupport = count > 0;
     }
+    fParallelShaderCompileSupport = ctxInfo.hasExtension("GL_KHR_parallel_shader_compile");
     if (kGL_GrGLStandard == standard) {
         fSamplerObjectSupport =
                 version >= GR_GL_VER(3,3) || ctxInfo.hasExtension("GL_ARB_sampler_objects");
@@ -606,6 +620,8 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         this->applyDriverCorrectnessWorkarounds(ctxInfo, contextOptions, shaderCaps);
     }
 
+    fTransferBufferSupport = kNone_TransferBufferType != fTransferBufferType;
+
     this->applyOptionsOverrides(contextOptions);
     shaderCaps->applyOptionsOverrides(contextOptions);
 
@@ -1869,6 +1885,27 @@ void GrGLCaps::initConfigTable(const GrContextOptions& contextOptions,
     }
     fConfigTable[kRGBA_half_GrPixelConfig].fSwizzle = GrSwizzle::RGBA();
 
+    // ETC1 data is only ever uploaded with glCompressedTexImage2D and can't be read back, so it
+    // has no external format. ETC2 decoders (GL 4.3, ES 3.0) accept ETC1 data as-is.
+    ConfigInfo& etc1 = fConfigTable[kRGB_ETC1_GrPixelConfig];
+    etc1.fFormats.fExternalFormat[kReadPixels_ExternalFormatUsage] = 0;
+    etc1.fFormats.fExternalType = 0;
+    etc1.fFormatType = kNormalizedFixedPoint_FormatType;
+    etc1.fSwizzle = GrSwizzle::RGBA();
+    if ((kGL_GrGLStandard == standard && version >= GR_GL_VER(4, 3)) ||
+        ctxInfo.hasExtension("GL_ARB_ES3_compatibility") ||
+        (kGLES_GrGLStandard == standard && version >= GR_GL_VER(3, 0))) {
+        etc1.fFormats.fBaseInternalFormat = GR_GL_COMPRESSED_RGB8_ETC2;
+        etc1.fFormats.fSizedInternalFormat = GR_GL_COMPRESSED_RGB8_ETC2;
+        etc1.fFlags = ConfigInfo::kTextureable_Flag;
+    } else {
+        etc1.fFormats.fBaseInternalFormat = GR_GL_COMPRESSED_ETC1_RGB8;
+        etc1.fFormats.fSizedInternalFormat = GR_GL_COMPRESSED_ETC1_RGB8;
+        if (ctxInfo.hasExtension("GL_OES_compressed_ETC1_RGB8_texture")) {
+            etc1.fFlags = ConfigInfo::kTextureable_Flag;
+        }
+    }
+
     // Bulk populate the texture internal/external formats here and then deal with exceptions below.
 
     // ES 2.0 requires that the internal/external formats match.
@@ -427,6 +427,12 @@ public:
 
     bool programBinarySupport() const { return fProgramBinarySupport; }
 
+    /**
+     * GL_KHR_parallel_shader_compile: compiles and links run on driver threads, and don't block
+     * until their status is queried.
+     */
+    bool parallelShaderCompileSupport() const { return fParallelShaderCompileSupport; }
+
     bool samplerObjectSupport() const { return fSamplerObjectSupport; }
 
     bool validateBackendTexture(const GrBackendTexture&, SkColorType,
@@ -515,6 +521,7 @@ private:
     bool fUseBufferDataNullHint                : 1;
     bool fClearTextureSupport : 1;
     bool fProgramBinarySupport : 1;
+    bool fParallelShaderCompileSupport : 1;
     bool fSamplerObjectSupport : 1;
 
     // Driver workarounds
@@ -1077,4 +1077,8 @@
 #define GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT               0x8257
 #define GL_PROGRAM_BINARY_LENGTH                            0x8741
 
+/* GL_KHR_parallel_shader_compile */
+#define GR_GL_MAX_SHADER_COMPILER_THREADS                   0x91B0
+#define GR_GL_COMPLETION_STATUS                             0x91B1
+
 #endif
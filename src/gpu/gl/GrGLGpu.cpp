@@ -234,6 +234,11 @@ GrGLGpu::GrGLGpu(std::unique_ptr<GrGLContext> ctx, GrContext* context)
         fPathRendering.reset(new GrGLPathRendering(this));
     }
 
+    if (this->glCaps().parallelShaderCompileSupport()) {
+        // Let the driver choose how many threads to compile and link on.
+        GL_CALL(MaxShaderCompilerThreads(0xFFFFFFFF));
+    }
+
     GrGLClearErr(this->glInterface());
 }
 
@@ -679,6 +684,23 @@ bool GrGLGpu::onWritePixels(GrSurface* surface, int left, int top, int width, in
                                mipLevelCount);
 }
 
+bool GrGLGpu::uploadCompressedTexData(GrPixelConfig config, int width, int height,
+                                      GrGLenum target, const void* data) {
+    SkASSERT(this->caps()->isConfigTexturable(config));
+    SkASSERT(data);
+
+    this->unbindCpuToGpuXferBuffer();
+
+    GrGLenum internalFormat = this->glCaps().configSizedInternalFormat(config);
+    size_t dataSize = GrCompressedFormatDataSize(config, width, height);
+
+    CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
+    GL_ALLOC_CALL(this->glInterface(), CompressedTexImage2D(target, 0, internalFormat,
+                                                            width, height, 0,
+                                                            SkToInt(dataSize), data));
+    return GR_GL_NO_ERROR == CHECK_ALLOC_ERROR(this->glInterface());
+}
+
 // For GL_[UN]PACK_ALIGNMENT. TODO: This really wants to be GrColorType.
 static inline GrGLint config_alignment(GrPixelConfig config) {
     switch (config) {
@@ -705,6 +727,7 @@ static inline GrGLint config_alignment(GrPixelConfig config) {
         case kRG_float_GrPixelConfig:
             return 4;
         case kUnknown_GrPixelConfig:
+        case kRGB_ETC1_GrPixelConfig:  // Compressed uploads ignore the unpack state.
             return 0;
     }
     SK_ABORT("Invalid pixel config");
@@ -918,6 +941,14 @@ void GrGLGpu::unbindCpuToGpuXferBuffer() {
 
 }
 
+void GrGLGpu::unbindGpuToCpuXferBuffer() {
+    auto& xferBufferState = fHWBufferState[kXferGpuToCpu_GrBufferType];
+    if (!xferBufferState.fBoundBufferUniqueID.isInvalid()) {
+        GL_CALL(BindBuffer(xferBufferState.fGLTarget, 0));
+        xferBufferState.invalidate();
+    }
+}
+
 // TODO: Make this take a GrColorType instead of dataConfig. This requires updating GrGLCaps to
 // convert from GrColorType to externalFormat/externalType GLenum values.
 bool GrGLGpu::uploadTexData(GrPixelConfig texConfig, int texWidth, int texHeight, GrGLenum target,
@@ -1523,6 +1554,18 @@ bool GrGLGpu::createTextureImpl(const GrSurfaceDesc& desc, GrGLTextureInfo* info
         set_initial_texture_params(this->glInterface(), *info, initialTexParams);
     }
 
+    if (GrPixelConfigIsCompressed(desc.fConfig)) {
+        SkASSERT(1 == mipLevelCount);
+        if (!this->uploadCompressedTexData(desc.fConfig, desc.fWidth, desc.fHeight, info->fTarget,
+                                           texels[0].fPixels)) {
+            GL_CALL(DeleteTextures(1, &(info->fID)));
+            return false;
+        }
+        *mipMapsStatus = GrMipMapsStatus::kNotAllocated;
+        info->fFormat = this->glCaps().configSizedInternalFormat(desc.fConfig);
+        return true;
+    }
+
     if (!this->uploadTexData(desc.fConfig, desc.fWidth, desc.fHeight, info->fTarget,
                              kNewTexture_UploadType, 0, 0, desc.fWidth, desc.fHeight, desc.fConfig,
                              texels, mipLevelCount, mipMapsStatus)) {
@@ -1867,6 +1910,9 @@ GrGLenum GrGLGpu::bindBuffer(GrBufferType type, const GrBuffer* buffer) {
         }
         bufferState.fBufferZeroKnownBound = buffer->isCPUBacked();
         bufferState.fBoundBufferUniqueID = buffer->uniqueID();
+        fStats.incBufferBinds();
+    } else {
+        fStats.incBufferBindsElided();
     }
 
     return bufferState.fGLTarget;
@@ -2064,6 +2110,26 @@ bool GrGLGpu::readPixelsSupported(GrSurface* surfaceForConfig, GrPixelConfig rea
 
 bool GrGLGpu::onReadPixels(GrSurface* surface, int left, int top, int width, int height,
                            GrColorType dstColorType, void* buffer, size_t rowBytes) {
+    this->unbindGpuToCpuXferBuffer();
+    return this->readOrTransferPixelsFrom(surface, left, top, width, height, dstColorType, buffer,
+                                          rowBytes);
+}
+
+bool GrGLGpu::onTransferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                                   GrColorType dstColorType, GrBuffer* transferBuffer,
+                                   size_t offset) {
+    SkASSERT(!transferBuffer->isMapped());
+    SkASSERT(!transferBuffer->isCPUBacked());
+    const GrGLBuffer* glBuffer = static_cast<const GrGLBuffer*>(transferBuffer);
+    this->bindBuffer(kXferGpuToCpu_GrBufferType, glBuffer);
+    size_t tightRowBytes = GrColorTypeBytesPerPixel(dstColorType) * width;
+    return this->readOrTransferPixelsFrom(surface, left, top, width, height, dstColorType,
+                                          (void*)offset, tightRowBytes);
+}
+
+bool GrGLGpu::readOrTransferPixelsFrom(GrSurface* surface, int left, int top, int width,
+                                       int height, GrColorType dstColorType, void* buffer,
+                                       size_t rowBytes) {
     SkASSERT(surface);
 
     GrGLRenderTarget* renderTarget = static_cast<GrGLRenderTarget*>(surface->asRenderTarget());
@@ -4248,6 +4314,39 @@ void GrGLGpu::deleteFence(GrFence fence) const {
     this->deleteSync((GrGLsync)fence);
 }
 
+GrTimestampQuery GrGLGpu::insertTimestamp() {
+    if (!this->caps()->gpuTimingSupport()) {
+        return 0;
+    }
+    GrGLuint query = 0;
+    GL_CALL(GenQueries(1, &query));
+    if (!query) {
+        return 0;
+    }
+    GL_CALL(QueryCounter(query, GR_GL_TIMESTAMP));
+    GR_STATIC_ASSERT(sizeof(GrTimestampQuery) >= sizeof(GrGLuint));
+    return query;
+}
+
+bool GrGLGpu::getTimestamp(GrTimestampQuery timestamp, uint64_t* nanoseconds) {
+    GrGLuint query = (GrGLuint)timestamp;
+    // Repeatedly asking whether the result is available guarantees it eventually becomes so.
+    GrGLuint available = 0;
+    GL_CALL(GetQueryObjectuiv(query, GR_GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available) {
+        return false;
+    }
+    GrGLuint64 result;
+    GL_CALL(GetQueryObjectui64v(query, GR_GL_QUERY_RESULT, &result));
+    *nanoseconds = result;
+    return true;
+}
+
+void GrGLGpu::deleteTimestamp(GrTimestampQuery timestamp) {
+    GrGLuint query = (GrGLuint)timestamp;
+    GL_CALL(DeleteQueries(1, &query));
+}
+
 sk_sp<GrSemaphore> SK_WARN_UNUSED_RESULT GrGLGpu::makeSemaphore(bool isOwned) {
     SkASSERT(this->caps()->fenceSyncSupport());
     return GrGLSemaphore::Make(this, isOwned);
@@ -153,12 +153,26 @@ public:
     void testingOnly_flushGpuAndSync() override;
 #endif
 
+    bool precompileShader(const SkData& key, const SkData& data) override {
+        return fProgramCache->precompileShader(key, data);
+    }
+
+    int precompileShaders(const SkData& capturedShaders) override {
+        return fProgramCache->precompileShaders(capturedShaders);
+    }
+
+    void purgeProgramCache() override { fProgramCache->reset(); }
+
     void submit(GrGpuCommandBuffer* buffer) override;
 
     GrFence SK_WARN_UNUSED_RESULT insertFence() override;
     bool waitFence(GrFence, uint64_t timeout) override;
     void deleteFence(GrFence) const override;
 
+    GrTimestampQuery insertTimestamp() override;
+    bool getTimestamp(GrTimestampQuery, uint64_t* nanoseconds) override;
+    void deleteTimestamp(GrTimestampQuery) override;
+
     sk_sp<GrSemaphore> SK_WARN_UNUSED_RESULT makeSemaphore(bool isOwned) override;
     sk_sp<GrSemaphore> wrapBackendSemaphore(const GrBackendSemaphore& semaphore,
                                             GrResourceProvider::SemaphoreWrapType wrapType,
@@ -228,16 +242,28 @@ private:
     bool onReadPixels(GrSurface*, int left, int top, int width, int height, GrColorType,
                       void* buffer, size_t rowBytes) override;
 
+    // Calls glReadPixels, which reads into client memory at 'buffer', or at offset 'buffer' of the
+    // PIXEL_PACK_BUFFER if one is bound.
+    bool readOrTransferPixelsFrom(GrSurface*, int left, int top, int width, int height,
+                                  GrColorType, void* buffer, size_t rowBytes);
+
     bool onWritePixels(GrSurface*, int left, int top, int width, int height, GrColorType,
                        const GrMipLevel texels[], int mipLevelCount) override;
 
     bool onTransferPixels(GrTexture*, int left, int top, int width, int height, GrColorType,
                           GrBuffer* transferBuffer, size_t offset, size_t rowBytes) override;
 
+    bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height, GrColorType,
+                              GrBuffer* transferBuffer, size_t offset) override;
+
     // Before calling any variation of TexImage, TexSubImage, etc..., call this to ensure that the
     // PIXEL_UNPACK_BUFFER is unbound.
     void unbindCpuToGpuXferBuffer();
 
+    // Before calling ReadPixels into client memory, call this to ensure that the PIXEL_PACK_BUFFER
+    // is unbound.
+    void unbindGpuToCpuXferBuffer();
+
     void onResolveRenderTarget(GrRenderTarget* target) override;
 
     bool onRegenerateMipMapLevels(GrTexture*) override;
@@ -308,8 +334,12 @@ private:
         ~ProgramCache();
 
         void abandon();
+        // Deletes every cached program.
+        void reset();
         GrGLProgram* refProgram(const GrGLGpu*, const GrPrimitiveProcessor&, const GrPipeline&,
                                 bool hasPointSize);
+        bool precompileShader(const SkData& key, const SkData& data);
+        int precompileShaders(const SkData& capturedShaders);
 
     private:
         // We may actually have kMaxEntries+1 shaders in the GL context because we create a new
@@ -387,6 +417,11 @@ private:
                        GrPixelConfig dataConfig, const GrMipLevel texels[], int mipLevelCount,
                        GrMipMapsStatus* mipMapsStatus = nullptr);
 
+    // Creates the base level of a texture in a compressed config. The data must be exactly
+    // GrCompressedFormatDataSize() bytes.
+    bool uploadCompressedTexData(GrPixelConfig config, int width, int height, GrGLenum target,
+                                 const void* data);
+
     bool createRenderTargetObjects(const GrSurfaceDesc&, const GrGLTextureInfo& texInfo,
                                    GrGLRenderTarget::IDDesc*);
 
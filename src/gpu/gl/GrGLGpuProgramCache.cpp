@@ -8,12 +8,18 @@
 #include "GrGLGpu.h"
 
 #include "builders/GrGLProgramBuilder.h"
+#include "builders/GrGLShaderStringBuilder.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
 #include "GrProcessor.h"
 #include "GrProgramDesc.h"
+#include "GrShaderCapture.h"
 #include "GrGLPathRendering.h"
 #include "glsl/GrGLSLFragmentProcessor.h"
 #include "glsl/GrGLSLProgramDataManager.h"
+#include "SkSLCompiler.h"
 #include "SkTSearch.h"
+#include "SkTaskGroup.h"
 
 #ifdef PROGRAM_CACHE_STATS
 // Display program cache usage
@@ -25,7 +31,19 @@ typedef GrGLSLProgramDataManager::UniformHandle UniformHandle;
 struct GrGLGpu::ProgramCache::Entry {
     Entry(sk_sp<GrGLProgram> program) : fProgram(std::move(program)) {}
 
+    Entry(const GrGLGpu* gpu, const GrGLPrecompiledProgram& precompiledProgram)
+            : fGpu(gpu), fPrecompiledProgram(precompiledProgram) {}
+
+    ~Entry() {
+        if (fPrecompiledProgram.fProgramID) {
+            GR_GL_CALL(fGpu->glInterface(), DeleteProgram(fPrecompiledProgram.fProgramID));
+        }
+    }
+
+    // Null until a precompiled program is first used.
     sk_sp<GrGLProgram> fProgram;
+    const GrGLGpu* fGpu = nullptr;
+    GrGLPrecompiledProgram fPrecompiledProgram;
 };
 
 GrGLGpu::ProgramCache::ProgramCache(GrGLGpu* gpu)
@@ -63,11 +81,18 @@ void GrGLGpu::ProgramCache::abandon() {
 #endif
 
     fMap.foreach([](std::unique_ptr<Entry>* e) {
-        (*e)->fProgram->abandon();
+        if ((*e)->fProgram) {
+            (*e)->fProgram->abandon();
+        }
+        (*e)->fPrecompiledProgram.fProgramID = 0;
     });
     fMap.reset();
 }
 
+void GrGLGpu::ProgramCache::reset() {
+    fMap.reset();
+}
+
 GrGLProgram* GrGLGpu::ProgramCache::refProgram(const GrGLGpu* gpu,
                                                const GrPrimitiveProcessor& primProc,
                                                const GrPipeline& pipeline,
@@ -96,12 +121,100 @@ GrGLProgram* GrGLGpu::ProgramCache::refProgram(const GrGLGpu* gpu,
 #ifdef PROGRAM_CACHE_STATS
         ++fCacheMisses;
 #endif
+        fGpu->stats()->incProgramCacheMisses();
         GrGLProgram* program = GrGLProgramBuilder::CreateProgram(primProc, pipeline, &desc, fGpu);
         if (nullptr == program) {
             return nullptr;
         }
         entry = fMap.insert(desc, std::unique_ptr<Entry>(new Entry(sk_sp<GrGLProgram>(program))));
+        return SkRef((*entry)->fProgram.get());
+    }
+
+    fGpu->stats()->incProgramCacheHits();
+    if (!(*entry)->fProgram) {
+        // A precompiled program, which we can finish now that we have its processors.
+        GrGLProgram* program = GrGLProgramBuilder::CreateProgram(primProc, pipeline, &desc, fGpu,
+                                                                 &(*entry)->fPrecompiledProgram);
+        if (nullptr == program) {
+            return nullptr;
+        }
+        (*entry)->fProgram.reset(program);
     }
 
     return SkRef((*entry)->fProgram.get());
 }
+
+bool GrGLGpu::ProgramCache::precompileShader(const SkData& key, const SkData& data) {
+    GrProgramDesc desc;
+    if (!GrProgramDesc::BuildFromData(&desc, key.data(), key.size())) {
+        return false;
+    }
+    if (fMap.find(desc)) {
+        return true;
+    }
+
+    GrGLPrecompiledProgram precompiledProgram;
+    if (!GrGLProgramBuilder::PrecompileProgram(&precompiledProgram, fGpu, data)) {
+        return false;
+    }
+    fMap.insert(desc, std::unique_ptr<Entry>(new Entry(fGpu, precompiledProgram)));
+    return true;
+}
+
+// Each task builds its own SkSL compiler, which costs about as much as compiling a few programs.
+static const int kProgramsPerPrecompileTask = 16;
+
+int GrGLGpu::ProgramCache::precompileShaders(const SkData& capturedShaders) {
+    auto capture = std::make_shared<GrShaderCapture>();
+    if (!capture->deserialize(capturedShaders)) {
+        return -1;
+    }
+
+    // Programs whose binaries are in the persistent cache never compile SkSL.
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    auto programs = std::make_shared<std::vector<int>>();
+    for (int i = 0; i < capture->count(); ++i) {
+        const SkString& key = capture->program(i).fKey;
+        if (persistentCache && fGpu->glCaps().programBinarySupport() &&
+            persistentCache->load(*SkData::MakeWithoutCopy(key.c_str(), key.size()))) {
+            continue;
+        }
+        programs->push_back(i);
+    }
+
+    // The tasks keep their own refs, in case the context goes away before they run.
+    sk_sp<const GrShaderCaps> caps = fGpu->caps()->refShaderCaps();
+    auto compile = [capture, programs, caps](int start, int end) {
+        static const GrGLenum kTypes[GrShaderCapture::kStageCount] = {
+            GR_GL_VERTEX_SHADER, GR_GL_GEOMETRY_SHADER, GR_GL_FRAGMENT_SHADER
+        };
+        SkSL::Compiler compiler;
+        for (int i = start; i < end; ++i) {
+            const GrShaderCapture::Program& program = capture->program((*programs)[i]);
+            SkSL::Program::Settings settings;
+            settings.fCaps = caps.get();
+            settings.fFlipY = program.fFlipY;
+            settings.fFragColorIsInOut = program.fFragColorIsInOut;
+            settings.fSharpenTextures = program.fSharpenTextures;
+            settings.fForceHighPrecision = program.fForceHighPrecision;
+            for (int stage = 0; stage < GrShaderCapture::kStageCount; ++stage) {
+                if (!program.fSkSL[stage].empty()) {
+                    GrPrecompileSkSLtoGLSL(&compiler, kTypes[stage], program.fSkSL[stage],
+                                           settings);
+                }
+            }
+        }
+    };
+
+    int count = SkToInt(programs->size());
+    SkTaskGroup* taskGroup = fGpu->getContext()->contextPriv().getTaskGroup();
+    if (!taskGroup) {
+        compile(0, count);
+        return count;
+    }
+    for (int start = 0; start < count; start += kProgramsPerPrecompileTask) {
+        int end = SkTMin(start + kProgramsPerPrecompileTask, count);
+        taskGroup->add([compile, start, end]() { compile(start, end); });
+    }
+    return count;
+}
@@ -646,6 +646,12 @@ bool GrGLInterface::validate() const {
         }
     }
 
+    if (fExtensions.has("GL_KHR_parallel_shader_compile")) {
+        if (!fFunctions.fMaxShaderCompilerThreads) {
+            RETURN_FALSE_INTERFACE;
+        }
+    }
+
 #if 0  // Update Chrome before enabling this.
     if ((kGL_GrGLStandard == fStandard && glVer >= GR_GL_VER(4,1)) ||
         (kGLES_GrGLStandard == fStandard && glVer >= GR_GL_VER(3,0))) {
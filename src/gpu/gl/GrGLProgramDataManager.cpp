@@ -14,6 +14,24 @@
          SkASSERT((COUNT) <= (UNI).fArrayCount || \
                   (1 == (COUNT) && GrShaderVar::kNonArray == (UNI).fArrayCount))
 
+// The number of 32 bit values in one element of a uniform of the given type, or 0 if the type isn't
+// one whose values are shadowed.
+static int shadow_value_count(GrSLType type) {
+    switch (type) {
+        case kFloat2x2_GrSLType:
+        case kHalf2x2_GrSLType:
+            return 4;
+        case kFloat3x3_GrSLType:
+        case kHalf3x3_GrSLType:
+            return 9;
+        case kFloat4x4_GrSLType:
+        case kHalf4x4_GrSLType:
+            return 16;
+        default:
+            return SkTMax(GrSLTypeVecLength(type), 0);
+    }
+}
+
 GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
                                                const UniformInfoArray& uniforms,
                                                const VaryingInfoArray& pathProcVaryings)
@@ -21,6 +39,7 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
     , fProgramID(programID) {
     int count = uniforms.count();
     fUniforms.push_back_n(count);
+    int shadowSize = 0;
     for (int i = 0; i < count; i++) {
         Uniform& uniform = fUniforms[i];
         const UniformInfo& builderUniform = uniforms[i];
@@ -31,7 +50,16 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
             uniform.fType = builderUniform.fVariable.getType();
         );
         uniform.fLocation = builderUniform.fLocation;
+        uniform.fShadowOffset = shadowSize;
+        uniform.fShadowElementSize = shadow_value_count(builderUniform.fVariable.getType()) *
+                                     sizeof(uint32_t);
+        uniform.fShadowElementCount = SkTMax(builderUniform.fVariable.getArrayCount(), 1);
+        uniform.fShadowValidSize = 0;
+        if (kUnusedUniform != uniform.fLocation) {
+            shadowSize += uniform.fShadowElementSize * uniform.fShadowElementCount;
+        }
     }
+    fShadowValues.reset(shadowSize);
 
     // NVPR programs have separable varyings
     count = pathProcVaryings.count();
@@ -66,7 +94,10 @@ void GrGLProgramDataManager::set1i(UniformHandle u, int32_t i) const {
     SkASSERT(uni.fType == kInt_GrSLType || uni.fType == kShort_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fLocation, i));
+        const int32_t v[] = { i };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fLocation, i));
+        }
     }
 }
 
@@ -77,7 +108,7 @@ void GrGLProgramDataManager::set1iv(UniformHandle u,
     SkASSERT(uni.fType == kInt_GrSLType || uni.fType == kShort_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1iv(uni.fLocation, arrayCount, v));
     }
 }
@@ -87,7 +118,10 @@ void GrGLProgramDataManager::set1f(UniformHandle u, float v0) const {
     SkASSERT(uni.fType == kFloat_GrSLType || uni.fType == kHalf_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fLocation, v0));
+        const float v[] = { v0 };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fLocation, v0));
+        }
     }
 }
 
@@ -102,7 +136,7 @@ void GrGLProgramDataManager::set1fv(UniformHandle u,
     // Once the uniform manager is responsible for inserting the duplicate uniform
     // arrays in VS and FS driver bug workaround, this can be enabled.
     // this->printUni(uni);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -112,7 +146,10 @@ void GrGLProgramDataManager::set2i(UniformHandle u, int32_t i0, int32_t i1) cons
     SkASSERT(uni.fType == kInt2_GrSLType || uni.fType == kShort2_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform2i(uni.fLocation, i0, i1));
+        const int32_t v[] = { i0, i1 };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform2i(uni.fLocation, i0, i1));
+        }
     }
 }
 
@@ -123,7 +160,7 @@ void GrGLProgramDataManager::set2iv(UniformHandle u,
     SkASSERT(uni.fType == kInt2_GrSLType || uni.fType == kShort2_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2iv(uni.fLocation, arrayCount, v));
     }
 }
@@ -133,7 +170,10 @@ void GrGLProgramDataManager::set2f(UniformHandle u, float v0, float v1) const {
     SkASSERT(uni.fType == kFloat2_GrSLType || uni.fType == kHalf2_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fLocation, v0, v1));
+        const float v[] = { v0, v1 };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fLocation, v0, v1));
+        }
     }
 }
 
@@ -144,7 +184,7 @@ void GrGLProgramDataManager::set2fv(UniformHandle u,
     SkASSERT(uni.fType == kFloat2_GrSLType || uni.fType == kHalf2_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -154,7 +194,10 @@ void GrGLProgramDataManager::set3i(UniformHandle u, int32_t i0, int32_t i1, int3
     SkASSERT(uni.fType == kInt3_GrSLType || uni.fType == kShort3_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform3i(uni.fLocation, i0, i1, i2));
+        const int32_t v[] = { i0, i1, i2 };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform3i(uni.fLocation, i0, i1, i2));
+        }
     }
 }
 
@@ -165,7 +208,7 @@ void GrGLProgramDataManager::set3iv(UniformHandle u,
     SkASSERT(uni.fType == kInt3_GrSLType || uni.fType == kShort3_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3iv(uni.fLocation, arrayCount, v));
     }
 }
@@ -175,7 +218,10 @@ void GrGLProgramDataManager::set3f(UniformHandle u, float v0, float v1, float v2
     SkASSERT(uni.fType == kFloat3_GrSLType || uni.fType == kHalf3_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fLocation, v0, v1, v2));
+        const float v[] = { v0, v1, v2 };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fLocation, v0, v1, v2));
+        }
     }
 }
 
@@ -186,7 +232,7 @@ void GrGLProgramDataManager::set3fv(UniformHandle u,
     SkASSERT(uni.fType == kFloat3_GrSLType || uni.fType == kHalf3_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -200,7 +246,10 @@ void GrGLProgramDataManager::set4i(UniformHandle u,
     SkASSERT(uni.fType == kInt4_GrSLType || uni.fType == kShort4_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform4i(uni.fLocation, i0, i1, i2, i3));
+        const int32_t v[] = { i0, i1, i2, i3 };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform4i(uni.fLocation, i0, i1, i2, i3));
+        }
     }
 }
 
@@ -211,7 +260,7 @@ void GrGLProgramDataManager::set4iv(UniformHandle u,
     SkASSERT(uni.fType == kInt4_GrSLType || uni.fType == kShort4_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4iv(uni.fLocation, arrayCount, v));
     }
 }
@@ -225,7 +274,10 @@ void GrGLProgramDataManager::set4f(UniformHandle u,
     SkASSERT(uni.fType == kFloat4_GrSLType || uni.fType == kHalf4_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
     if (kUnusedUniform != uni.fLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fLocation, v0, v1, v2, v3));
+        const float v[] = { v0, v1, v2, v3 };
+        if (this->needsUpload(uni, 1, v)) {
+            GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fLocation, v0, v1, v2, v3));
+        }
     }
 }
 
@@ -236,7 +288,7 @@ void GrGLProgramDataManager::set4fv(UniformHandle u,
     SkASSERT(uni.fType == kFloat4_GrSLType || uni.fType == kHalf4_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -265,6 +317,24 @@ void GrGLProgramDataManager::setMatrix4fv(UniformHandle u, int arrayCount, const
     this->setMatrices<4>(u, arrayCount, m);
 }
 
+bool GrGLProgramDataManager::needsUpload(const Uniform& uni, int arrayCount,
+                                         const void* values) const {
+    if (!uni.fShadowElementSize || arrayCount > uni.fShadowElementCount) {
+        fGpu->stats()->incUniformUploads();
+        return true;
+    }
+    int size = uni.fShadowElementSize * arrayCount;
+    uint8_t* shadow = fShadowValues.get() + uni.fShadowOffset;
+    if (size <= uni.fShadowValidSize && !memcmp(shadow, values, size)) {
+        fGpu->stats()->incUniformUploadsElided();
+        return false;
+    }
+    memcpy(shadow, values, size);
+    uni.fShadowValidSize = SkTMax(uni.fShadowValidSize, size);
+    fGpu->stats()->incUniformUploads();
+    return true;
+}
+
 template<int N> struct set_uniform_matrix;
 
 template<int N> inline void GrGLProgramDataManager::setMatrices(UniformHandle u,
@@ -275,7 +345,7 @@ template<int N> inline void GrGLProgramDataManager::setMatrices(UniformHandle u,
              uni.fType == kHalf2x2_GrSLType + (N - 2));
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && this->needsUpload(uni, arrayCount, matrices)) {
         set_uniform_matrix<N>::set(fGpu->glInterface(), uni.fLocation, arrayCount, matrices);
     }
 }
@@ -14,6 +14,7 @@
 #include "glsl/GrGLSLProgramDataManager.h"
 
 #include "SkTArray.h"
+#include "SkTemplates.h"
 
 class GrGLGpu;
 class SkMatrix;
@@ -86,6 +87,13 @@ private:
 
     struct Uniform {
         GrGLint     fLocation;
+        // Where this uniform's last uploaded values live in fShadowValues. fShadowElementSize is 0
+        // for uniforms that aren't shadowed. fShadowValidSize is how many bytes from the start of
+        // the uniform have been uploaded since the program was created.
+        int         fShadowOffset;
+        int         fShadowElementSize;
+        int         fShadowElementCount;
+        mutable int fShadowValidSize;
 #ifdef SK_DEBUG
         GrSLType    fType;
         int         fArrayCount;
@@ -106,7 +114,12 @@ private:
     template<int N> inline void setMatrices(UniformHandle, int arrayCount,
                                             const float matrices[]) const;
 
+    // Uniform values are program state, so uploading the values the program already holds is
+    // redundant. Returns false if that is the case, otherwise records the values and returns true.
+    bool needsUpload(const Uniform&, int arrayCount, const void* values) const;
+
     SkTArray<Uniform, true> fUniforms;
+    SkAutoTMalloc<uint8_t> fShadowValues;
     SkTArray<PathProcVarying, true> fPathProcVaryings;
     GrGLGpu* fGpu;
     GrGLuint fProgramID;
@@ -118,6 +118,9 @@ void GrGLAttribArrayState::set(GrGLGpu* gpu,
         array->fGPUType = gpuType;
         array->fStride = stride;
         array->fOffset = offsetInBytes;
+        gpu->stats()->incVertexAttribSetups();
+    } else {
+        gpu->stats()->incVertexAttribSetupsElided();
     }
     if (gpu->caps()->instanceAttribSupport() && array->fDivisor != divisor) {
         SkASSERT(0 == divisor || 1 == divisor); // not necessarily a requirement but what we expect.
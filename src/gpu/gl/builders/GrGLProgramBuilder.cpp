@@ -13,6 +13,7 @@
 #include "GrCoordTransform.h"
 #include "GrGLProgramBuilder.h"
 #include "GrProgramDesc.h"
+#include "GrShaderCapture.h"
 #include "GrShaderCaps.h"
 #include "GrSwizzle.h"
 #include "SkAutoMalloc.h"
@@ -32,7 +33,8 @@
 GrGLProgram* GrGLProgramBuilder::CreateProgram(const GrPrimitiveProcessor& primProc,
                                                const GrPipeline& pipeline,
                                                GrProgramDesc* desc,
-                                               GrGLGpu* gpu) {
+                                               GrGLGpu* gpu,
+                                               GrGLPrecompiledProgram* precompiledProgram) {
     SkASSERT(!pipeline.isBad());
 
     ATRACE_ANDROID_FRAMEWORK("Shader Compile");
@@ -42,20 +44,91 @@ GrGLProgram* GrGLProgramBuilder::CreateProgram(const GrPrimitiveProcessor& primP
     // uniforms, varyings, textures, etc
     GrGLProgramBuilder builder(gpu, pipeline, primProc, desc);
 
+    if (precompiledProgram && precompiledProgram->fProgramID) {
+        // This waits for the link if it is still running in the background. If it failed (e.g.
+        // the driver was updated since the binary was made) we compile the program from scratch.
+        GrGLint linked = GR_GL_INIT_ZERO;
+        GR_GL_CALL(gpu->glInterface(), GetProgramiv(precompiledProgram->fProgramID,
+                                                    GR_GL_LINK_STATUS, &linked));
+        if (linked) {
+            builder.fPrecompiled = *precompiledProgram;
+        } else {
+            GR_GL_CALL(gpu->glInterface(), DeleteProgram(precompiledProgram->fProgramID));
+        }
+        precompiledProgram->fProgramID = 0;
+    }
+
     auto persistentCache = gpu->getContext()->contextPriv().getPersistentCache();
-    if (persistentCache && gpu->glCaps().programBinarySupport()) {
+    if (!builder.fPrecompiled.fProgramID && persistentCache &&
+        gpu->glCaps().programBinarySupport()) {
         sk_sp<SkData> key = SkData::MakeWithoutCopy(desc->asKey(), desc->keyLength());
         builder.fCached = persistentCache->load(*key);
+        if (builder.fCached) {
+            gpu->stats()->incPersistentCacheHits();
+        } else {
+            gpu->stats()->incPersistentCacheMisses();
+        }
         // the eventual end goal is to completely skip emitAndInstallProcs on a cache hit, but it's
         // doing necessary setup in addition to generating the SkSL code. Currently we are only able
         // to skip the SkSL->GLSL step on a cache hit.
     }
     if (!builder.emitAndInstallProcs()) {
+        if (builder.fPrecompiled.fProgramID) {
+            GR_GL_CALL(gpu->glInterface(), DeleteProgram(builder.fPrecompiled.fProgramID));
+        }
         return nullptr;
     }
     return builder.finalize();
 }
 
+bool GrGLProgramBuilder::PrecompileProgram(GrGLPrecompiledProgram* precompiledProgram,
+                                           GrGLGpu* gpu,
+                                           const SkData& cachedData) {
+    if (!gpu->glCaps().programBinarySupport()) {
+        return false;
+    }
+
+    // The data is laid out as described at fCached.
+    SkSL::Program::Inputs inputs;
+    int binaryFormat;
+    if (cachedData.size() <= sizeof(inputs) + sizeof(binaryFormat)) {
+        return false;
+    }
+    const uint8_t* bytes = cachedData.bytes();
+    size_t offset = 0;
+    memcpy(&inputs, bytes + offset, sizeof(inputs));
+    offset += sizeof(inputs);
+    memcpy(&binaryFormat, bytes + offset, sizeof(binaryFormat));
+    offset += sizeof(binaryFormat);
+
+    const GrGLInterface* gl = gpu->glInterface();
+    GrGLuint programID;
+    GR_GL_CALL_RET(gl, programID, CreateProgram());
+    if (0 == programID) {
+        return false;
+    }
+
+    GrGLClearErr(gl);
+    GR_GL_CALL_NOERRCHECK(gl, ProgramBinary(programID, binaryFormat, (void*) (bytes + offset),
+                                            cachedData.size() - offset));
+    bool success = GR_GL_GET_ERROR(gl) == GR_GL_NO_ERROR;
+    if (success && !gpu->glCaps().parallelShaderCompileSupport()) {
+        // Without parallel compiles the link has already finished, so we may as well check it
+        // now rather than hold on to a program we can't use.
+        GrGLint linked = GR_GL_INIT_ZERO;
+        GR_GL_CALL(gl, GetProgramiv(programID, GR_GL_LINK_STATUS, &linked));
+        success = SkToBool(linked);
+    }
+    if (!success) {
+        GR_GL_CALL(gl, DeleteProgram(programID));
+        return false;
+    }
+
+    precompiledProgram->fProgramID = programID;
+    precompiledProgram->fInputs = inputs;
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 GrGLProgramBuilder::GrGLProgramBuilder(GrGLGpu* gpu,
@@ -112,13 +185,15 @@ bool GrGLProgramBuilder::compileAndAttachShaders(GrGLSLShaderBuilder& shader,
                                                  const SkSL::Program::Settings& settings,
                                                  SkSL::Program::Inputs* outInputs) {
     SkSL::String glsl;
-    std::unique_ptr<SkSL::Program> program = GrSkSLtoGLSL(gpu()->glContext(), type,
-                                                 shader.fCompilerStrings.begin(),
-                                                 shader.fCompilerStringLengths.begin(),
-                                                 shader.fCompilerStrings.count(),
-                                                 settings,
-                                                 &glsl);
-    *outInputs = program->fInputs;
+    if (!GrSkSLtoGLSLCached(gpu()->glContext(), type,
+                            shader.fCompilerStrings.begin(),
+                            shader.fCompilerStringLengths.begin(),
+                            shader.fCompilerStrings.count(),
+                            settings,
+                            &glsl,
+                            outInputs)) {
+        return false;
+    }
     return this->compileAndAttachShaders(glsl.c_str(),
                                          glsl.size(),
                                          programId,
@@ -173,13 +248,16 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
     TRACE_EVENT0("skia", TRACE_FUNC);
 
     // verify we can get a program id
-    GrGLuint programID;
-    GL_CALL_RET(programID, CreateProgram());
+    bool precompiled = 0 != fPrecompiled.fProgramID;
+    GrGLuint programID = fPrecompiled.fProgramID;
+    if (!precompiled) {
+        GL_CALL_RET(programID, CreateProgram());
+    }
     if (0 == programID) {
         return nullptr;
     }
 
-    if (this->gpu()->glCaps().programBinarySupport() &&
+    if (!precompiled && this->gpu()->glCaps().programBinarySupport() &&
         this->gpu()->getContext()->contextPriv().getPersistentCache()) {
         GL_CALL(ProgramParameteri(programID, GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GR_GL_TRUE));
     }
@@ -197,7 +275,13 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
     SkSL::Program::Inputs inputs;
     SkTDArray<GrGLuint> shadersToDelete;
     bool cached = fGpu->glCaps().programBinarySupport() && nullptr != fCached.get();
-    if (cached) {
+    if (precompiled) {
+        // Linked from the cached binary by PrecompileProgram().
+        this->bindProgramResourceLocations(programID);
+        inputs = fPrecompiled.fInputs;
+        this->addInputVars(inputs);
+        this->computeCountsAndStrides(programID, primProc, false);
+    } else if (cached) {
         this->bindProgramResourceLocations(programID);
         // cache hit, just hand the binary to GL
         const uint8_t* bytes = fCached->bytes();
@@ -221,24 +305,23 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
             cached = false;
         }
     }
-    if (!cached) {
+    if (!cached && !precompiled) {
         // cache miss, compile shaders
         if (fFS.fForceHighPrecision) {
             settings.fForceHighPrecision = true;
         }
         SkSL::String glsl;
-        std::unique_ptr<SkSL::Program> fs = GrSkSLtoGLSL(gpu()->glContext(),
-                                                         GR_GL_FRAGMENT_SHADER,
-                                                         fFS.fCompilerStrings.begin(),
-                                                         fFS.fCompilerStringLengths.begin(),
-                                                         fFS.fCompilerStrings.count(),
-                                                         settings,
-                                                         &glsl);
-        if (!fs) {
+        if (!GrSkSLtoGLSLCached(gpu()->glContext(),
+                                GR_GL_FRAGMENT_SHADER,
+                                fFS.fCompilerStrings.begin(),
+                                fFS.fCompilerStringLengths.begin(),
+                                fFS.fCompilerStrings.count(),
+                                settings,
+                                &glsl,
+                                &inputs)) {
             this->cleanupProgram(programID, shadersToDelete);
             return nullptr;
         }
-        inputs = fs->fInputs;
         this->addInputVars(inputs);
         if (!this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
                                            GR_GL_FRAGMENT_SHADER, &shadersToDelete, settings,
@@ -247,16 +330,18 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
             return nullptr;
         }
 
-        std::unique_ptr<SkSL::Program> vs = GrSkSLtoGLSL(gpu()->glContext(),
-                                                         GR_GL_VERTEX_SHADER,
-                                                         fVS.fCompilerStrings.begin(),
-                                                         fVS.fCompilerStringLengths.begin(),
-                                                         fVS.fCompilerStrings.count(),
-                                                         settings,
-                                                         &glsl);
-        if (!vs || !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
-                                                  GR_GL_VERTEX_SHADER, &shadersToDelete, settings,
-                                                  inputs)) {
+        SkSL::Program::Inputs vsInputs;
+        if (!GrSkSLtoGLSLCached(gpu()->glContext(),
+                                GR_GL_VERTEX_SHADER,
+                                fVS.fCompilerStrings.begin(),
+                                fVS.fCompilerStringLengths.begin(),
+                                fVS.fCompilerStrings.count(),
+                                settings,
+                                &glsl,
+                                &vsInputs) ||
+            !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
+                                           GR_GL_VERTEX_SHADER, &shadersToDelete, settings,
+                                           inputs)) {
             this->cleanupProgram(programID, shadersToDelete);
             return nullptr;
         }
@@ -268,17 +353,18 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
         }
 
         if (primProc.willUseGeoShader()) {
-            std::unique_ptr<SkSL::Program> gs;
-            gs = GrSkSLtoGLSL(gpu()->glContext(),
-                              GR_GL_GEOMETRY_SHADER,
-                              fGS.fCompilerStrings.begin(),
-                              fGS.fCompilerStringLengths.begin(),
-                              fGS.fCompilerStrings.count(),
-                              settings,
-                              &glsl);
-            if (!gs || !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
-                                                      GR_GL_GEOMETRY_SHADER, &shadersToDelete,
-                                                      settings, inputs)) {
+            SkSL::Program::Inputs gsInputs;
+            if (!GrSkSLtoGLSLCached(gpu()->glContext(),
+                                    GR_GL_GEOMETRY_SHADER,
+                                    fGS.fCompilerStrings.begin(),
+                                    fGS.fCompilerStringLengths.begin(),
+                                    fGS.fCompilerStrings.count(),
+                                    settings,
+                                    &glsl,
+                                    &gsInputs) ||
+                !this->compileAndAttachShaders(glsl.c_str(), glsl.size(), programID,
+                                               GR_GL_GEOMETRY_SHADER, &shadersToDelete,
+                                               settings, inputs)) {
                 this->cleanupProgram(programID, shadersToDelete);
                 return nullptr;
             }
@@ -314,7 +400,7 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
     this->resolveProgramResourceLocations(programID);
 
     this->cleanupShaders(shadersToDelete);
-    if (!cached && this->gpu()->getContext()->contextPriv().getPersistentCache() &&
+    if (!cached && !precompiled && this->gpu()->getContext()->contextPriv().getPersistentCache() &&
         fGpu->glCaps().programBinarySupport()) {
         GrGLsizei length = 0;
         GL_CALL(GetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length));
@@ -336,6 +422,26 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
                                             *key, *SkData::MakeWithoutCopy(data.get(), dataLength));
         }
     }
+    if (GrShaderCapture* capture = this->gpu()->getContext()->contextPriv().getShaderCapture()) {
+        auto join = [](const GrGLSLShaderBuilder& shader) {
+            SkSL::String sksl;
+            for (int i = 0; i < shader.fCompilerStrings.count(); ++i) {
+                sksl.append(shader.fCompilerStrings[i], shader.fCompilerStringLengths[i]);
+            }
+            return sksl;
+        };
+        GrShaderCapture::Program program;
+        program.fFlipY = settings.fFlipY;
+        program.fFragColorIsInOut = settings.fFragColorIsInOut;
+        program.fSharpenTextures = settings.fSharpenTextures;
+        program.fForceHighPrecision = fFS.fForceHighPrecision;
+        program.fSkSL[GrShaderCapture::kVertex_Stage] = join(fVS);
+        if (primProc.willUseGeoShader()) {
+            program.fSkSL[GrShaderCapture::kGeometry_Stage] = join(fGS);
+        }
+        program.fSkSL[GrShaderCapture::kFragment_Stage] = join(fFS);
+        capture->record(*this->desc(), std::move(program));
+    }
     return this->createProgram(programID);
 }
 
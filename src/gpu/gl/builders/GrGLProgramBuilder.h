@@ -22,6 +22,16 @@ class GrGLContextInfo;
 class GrProgramDesc;
 class GrGLSLShaderBuilder;
 class GrShaderCaps;
+class SkData;
+
+/**
+ * A GL program linked ahead of first use from a PersistentCache entry, which still needs the
+ * processors to finish being built into a GrGLProgram.
+ */
+struct GrGLPrecompiledProgram {
+    GrGLuint              fProgramID = 0;
+    SkSL::Program::Inputs fInputs;
+};
 
 class GrGLProgramBuilder : public GrGLSLProgramBuilder {
 public:
@@ -33,12 +43,22 @@ public:
      * This function may modify the GrProgramDesc by setting the surface origin
      * key to 0 (unspecified) if it turns out the program does not care about
      * the surface origin.
+     * If a precompiled program is given, its GL program is used instead of compiling one, and is
+     * owned by the result (or deleted on failure) either way.
      * @return true if generation was successful.
      */
     static GrGLProgram* CreateProgram(const GrPrimitiveProcessor&,
                                       const GrPipeline&,
                                       GrProgramDesc*,
-                                      GrGLGpu*);
+                                      GrGLGpu*,
+                                      GrGLPrecompiledProgram* = nullptr);
+
+    /**
+     * Starts linking a program from data the builder stored in the PersistentCache. With
+     * GL_KHR_parallel_shader_compile the link continues in the background until the program is
+     * first used. Returns false if the data can't be used.
+     */
+    static bool PrecompileProgram(GrGLPrecompiledProgram*, GrGLGpu*, const SkData& cachedData);
 
     const GrCaps* caps() const override;
 
@@ -95,6 +115,9 @@ private:
     // (all remaining bytes) char[] binary
     sk_sp<SkData> fCached;
 
+    // Already linked program to finish building, if fProgramID isn't 0.
+    GrGLPrecompiledProgram fPrecompiled;
+
     typedef GrGLSLProgramBuilder INHERITED;
 };
 #endif
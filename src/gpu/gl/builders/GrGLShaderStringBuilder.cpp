@@ -8,6 +8,8 @@
 #include "GrGLShaderStringBuilder.h"
 #include "GrSKSLPrettyPrint.h"
 #include "SkAutoMalloc.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkSLCompiler.h"
 #include "SkSLGLSLCodeGenerator.h"
 #include "SkTraceEvent.h"
@@ -60,6 +62,16 @@ void print_shader_banner(GrGLenum type) {
     SkDebugf("---- %s shader ----------------------------------------------------\n", typeName);
 }
 
+static SkSL::Program::Kind program_kind(GrGLenum type) {
+    switch (type) {
+        case GR_GL_VERTEX_SHADER:   return SkSL::Program::kVertex_Kind;
+        case GR_GL_FRAGMENT_SHADER: return SkSL::Program::kFragment_Kind;
+        case GR_GL_GEOMETRY_SHADER: return SkSL::Program::kGeometry_Kind;
+        default: SK_ABORT("unsupported shader kind");
+    }
+    return SkSL::Program::kFragment_Kind;
+}
+
 std::unique_ptr<SkSL::Program> GrSkSLtoGLSL(const GrGLContext& context, GrGLenum type,
                                             const char** skslStrings, int* lengths, int count,
                                             const SkSL::Program::Settings& settings,
@@ -88,14 +100,7 @@ std::unique_ptr<SkSL::Program> GrSkSLtoGLSL(const GrGLContext& context, GrGLenum
 #endif
     SkSL::Compiler* compiler = context.compiler();
     std::unique_ptr<SkSL::Program> program;
-    SkSL::Program::Kind programKind;
-    switch (type) {
-        case GR_GL_VERTEX_SHADER:   programKind = SkSL::Program::kVertex_Kind;   break;
-        case GR_GL_FRAGMENT_SHADER: programKind = SkSL::Program::kFragment_Kind; break;
-        case GR_GL_GEOMETRY_SHADER: programKind = SkSL::Program::kGeometry_Kind; break;
-        default: SK_ABORT("unsupported shader kind");
-    }
-    program = compiler->convertProgram(programKind, sksl, settings);
+    program = compiler->convertProgram(program_kind(type), sksl, settings);
     if (!program || !compiler->toGLSL(*program, glsl)) {
         SkDebugf("SKSL compilation error\n----------------------\n");
         print_sksl_line_by_line(skslStrings, lengths, count);
@@ -110,6 +115,109 @@ std::unique_ptr<SkSL::Program> GrSkSLtoGLSL(const GrGLContext& context, GrGLenum
     return program;
 }
 
+namespace {
+
+struct CachedGLSL {
+    SkSL::String fGLSL;
+    SkSL::Program::Inputs fInputs;
+};
+
+}  // anonymous namespace
+
+// Roughly a few hundred programs' worth of shaders; each entry holds its SkSL key and its GLSL.
+static const int kMaxCachedGLSL = 1024;
+
+SK_DECLARE_STATIC_MUTEX(gGLSLCacheMutex);
+
+static SkLRUCache<SkString, CachedGLSL>* glsl_cache() {
+    static auto* cache = new SkLRUCache<SkString, CachedGLSL>(kMaxCachedGLSL);
+    return cache;
+}
+
+// The key holds the full SkSL text so that a hash collision can never return the wrong GLSL.
+static SkString glsl_cache_key(GrGLenum type, const char** skslStrings, int* lengths, int count,
+                               const SkSL::Program::Settings& settings) {
+    SkString key;
+    key.appendf("%u:%d%d%d%d%d:", type, settings.fFlipY, settings.fFragColorIsInOut,
+                settings.fReplaceSettings, settings.fForceHighPrecision,
+                settings.fSharpenTextures);
+    settings.fCaps->appendCodeGenKey(&key);
+    key.append("\n");
+    for (int i = 0; i < count; i++) {
+        key.append(skslStrings[i], lengths[i]);
+    }
+    return key;
+}
+
+bool GrSkSLtoGLSLCached(const GrGLContext& context, GrGLenum type,
+                        const char** skslStrings, int* lengths, int count,
+                        const SkSL::Program::Settings& settings,
+                        SkSL::String* glsl, SkSL::Program::Inputs* inputs) {
+    // Program args are only used for runtime effects and are not worth keying on.
+    if (!settings.fArgs.empty() || !settings.fCaps) {
+        std::unique_ptr<SkSL::Program> program =
+                GrSkSLtoGLSL(context, type, skslStrings, lengths, count, settings, glsl);
+        if (!program) {
+            return false;
+        }
+        *inputs = program->fInputs;
+        return true;
+    }
+
+    SkString key = glsl_cache_key(type, skslStrings, lengths, count, settings);
+    {
+        SkAutoMutexAcquire lock(gGLSLCacheMutex);
+        if (const CachedGLSL* cached = glsl_cache()->find(key)) {
+            *glsl = cached->fGLSL;
+            *inputs = cached->fInputs;
+            return true;
+        }
+    }
+
+    // Compile outside the lock; each context still uses its own compiler.
+    std::unique_ptr<SkSL::Program> program =
+            GrSkSLtoGLSL(context, type, skslStrings, lengths, count, settings, glsl);
+    if (!program) {
+        return false;
+    }
+    *inputs = program->fInputs;
+
+    SkAutoMutexAcquire lock(gGLSLCacheMutex);
+    if (!glsl_cache()->find(key)) {
+        glsl_cache()->insert(key, CachedGLSL{*glsl, *inputs});
+    }
+    return true;
+}
+
+bool GrPrecompileSkSLtoGLSL(SkSL::Compiler* compiler, GrGLenum type, const SkSL::String& sksl,
+                            const SkSL::Program::Settings& settings) {
+    SkASSERT(settings.fCaps && settings.fArgs.empty());
+    const char* skslString = sksl.c_str();
+    int length = SkToInt(sksl.size());
+    SkString key = glsl_cache_key(type, &skslString, &length, 1, settings);
+    {
+        SkAutoMutexAcquire lock(gGLSLCacheMutex);
+        if (glsl_cache()->find(key)) {
+            return true;
+        }
+    }
+
+    // Captured SkSL may come from a build or device whose processors emit code these caps can't
+    // compile; that only costs the precompile, so don't report it like a program build failure.
+    std::unique_ptr<SkSL::Program> program =
+            compiler->convertProgram(program_kind(type), sksl, settings);
+    SkSL::String glsl;
+    if (!program || !compiler->toGLSL(*program, &glsl)) {
+        return false;
+    }
+
+    SkAutoMutexAcquire lock(gGLSLCacheMutex);
+    if (!glsl_cache()->find(key)) {
+        glsl_cache()->insert(key, CachedGLSL{std::move(glsl), program->fInputs});
+    }
+    return true;
+}
+
 GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
                                     GrGLuint programId,
                                     GrGLenum type,
@@ -130,8 +238,11 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
     stats->incShaderCompilations();
     GR_GL_CALL(gli, CompileShader(shaderId));
 
-    // Calling GetShaderiv in Chromium is quite expensive. Assume success in release builds.
-    bool checkCompiled = kChromium_GrGLDriver != glCtx.driver();
+    // Calling GetShaderiv in Chromium is quite expensive. Assume success in release builds. With
+    // parallel compiles it would also wait for this shader before the next one is started, so we
+    // leave it to the link to report errors.
+    bool checkCompiled = kChromium_GrGLDriver != glCtx.driver() &&
+                         !glCtx.caps()->parallelShaderCompileSupport();
 #ifdef SK_DEBUG
     checkCompiled = true;
 #endif
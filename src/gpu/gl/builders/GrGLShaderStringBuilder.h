@@ -19,6 +19,25 @@ std::unique_ptr<SkSL::Program> GrSkSLtoGLSL(const GrGLContext& context, GrGLenum
                                             const SkSL::Program::Settings& settings,
                                             SkSL::String* glsl);
 
+/**
+ * Like GrSkSLtoGLSL, but reuses GLSL already generated in this process for the same SkSL, program
+ * kind, settings, and shader caps, even when it was generated for a different GrContext. Only the
+ * GLSL and the program's inputs are available, so callers that need the program itself must use
+ * GrSkSLtoGLSL.
+ */
+bool GrSkSLtoGLSLCached(const GrGLContext& context, GrGLenum type,
+                        const char** skslStrings, int* lengths, int count,
+                        const SkSL::Program::Settings& settings,
+                        SkSL::String* glsl, SkSL::Program::Inputs* inputs);
+
+/**
+ * Generates the GLSL that GrSkSLtoGLSLCached would for a single string of SkSL and adds it to the
+ * cache, unless it's there already. This uses the given compiler rather than a context's, so it
+ * can run on any thread while contexts keep drawing. Returns false if the SkSL doesn't compile.
+ */
+bool GrPrecompileSkSLtoGLSL(SkSL::Compiler*, GrGLenum type, const SkSL::String& sksl,
+                            const SkSL::Program::Settings&);
+
 GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
                                     GrGLuint programId,
                                     GrGLenum type,
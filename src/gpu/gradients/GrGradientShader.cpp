@@ -78,6 +78,10 @@ static std::unique_ptr<GrFragmentProcessor> make_colorizer(const SkPMColor4f* co
     // The same is true for pos[end] == 1
     bool topHardStop = SkScalarNearlyEqual(positions[count - 2], positions[count - 1]);
 
+    // When reducing program variants, every gradient that has an analytic form uses the unrolled
+    // colorizer searching all of its intervals, instead of the colorizer specialized to its stops.
+    bool reduceVariants = args.fContext->contextPriv().reduceProgramVariants();
+
     int offset = 0;
     if (bottomHardStop) {
         offset += 1;
@@ -89,7 +93,7 @@ static std::unique_ptr<GrFragmentProcessor> make_colorizer(const SkPMColor4f* co
 
     // Two remaining colors means a single interval from 0 to 1
     // (but it may have originally been a 3 or 4 color gradient with 1-2 hard stops at the ends)
-    if (count == 2) {
+    if (count == 2 && !reduceVariants) {
         return GrSingleIntervalGradientColorizer::Make(colors[offset], colors[offset + 1]);
     }
 
@@ -116,7 +120,7 @@ static std::unique_ptr<GrFragmentProcessor> make_colorizer(const SkPMColor4f* co
         }
     }
 
-    if (tryAnalyticColorizer) {
+    if (tryAnalyticColorizer && !reduceVariants) {
         if (count == 3) {
             // Must be a dual interval gradient, where the middle point is at offset+1 and the two
             // intervals share the middle color stop.
@@ -130,12 +134,14 @@ static std::unique_ptr<GrFragmentProcessor> make_colorizer(const SkPMColor4f* co
                                                          colors[offset + 2], colors[offset + 3],
                                                          positions[offset + 1]);
         }
+    }
 
+    if (tryAnalyticColorizer) {
         // The single and dual intervals are a specialized case of the unrolled binary search
         // colorizer which can analytically render gradients of up to 8 intervals (up to 9 or 16
         // colors depending on how many hard stops are inserted).
         std::unique_ptr<GrFragmentProcessor> unrolled = GrUnrolledBinaryGradientColorizer::Make(
-                colors + offset, positions + offset, count);
+                colors + offset, positions + offset, count, reduceVariants);
         if (unrolled) {
             return unrolled;
         }
@@ -200,7 +206,9 @@ static std::unique_ptr<GrFragmentProcessor> make_gradient(const SkGradientShader
     // or all the colors have a = 1, in which case premul is a no op. Note that this allOpaque
     // check is more permissive than SkGradientShaderBase's isOpaque(), since we can optimize away
     // the make-premul op for two point conical gradients (which report false for isOpaque).
-    bool makePremul = !inputPremul && !allOpaque;
+    // When reducing program variants the premul op is kept for opaque colors as well.
+    bool makePremul = !inputPremul &&
+                      (!allOpaque || args.fContext->contextPriv().reduceProgramVariants());
 
     // All tile modes are supported (unless something was added to SkShader)
     std::unique_ptr<GrFragmentProcessor> master;
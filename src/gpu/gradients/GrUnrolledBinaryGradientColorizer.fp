@@ -114,15 +114,19 @@ void main() {
 }
 
 @make {
+    // If padToMaxIntervals is true, the unused intervals repeat the last one so that every
+    // gradient of any interval count shares one program, at the cost of a full binary search.
     static std::unique_ptr<GrFragmentProcessor> Make(const SkPMColor4f* colors,
                                                      const SkScalar* positions,
-                                                     int count);
+                                                     int count,
+                                                     bool padToMaxIntervals = false);
 }
 
 @cppEnd {
     static const int kMaxIntervals = 8;
     std::unique_ptr<GrFragmentProcessor> GrUnrolledBinaryGradientColorizer::Make(
-            const SkPMColor4f* colors, const SkScalar* positions, int count) {
+            const SkPMColor4f* colors, const SkScalar* positions, int count,
+            bool padToMaxIntervals) {
         // Depending on how the positions resolve into hard stops or regular stops, the number of
         // intervals specified by the number of colors/positions can change. For instance, a plain
         // 3 color gradient is two intervals, but a 4 color gradient with a hard stop is also
@@ -171,11 +175,22 @@ void main() {
             intervalCount++;
         }
 
-        // For isEqual to make sense, set the unused values to something consistent
-        for (int i = intervalCount; i < kMaxIntervals; i++) {
-            scales[i] = SK_PMColor4fTRANSPARENT;
-            biases[i] = SK_PMColor4fTRANSPARENT;
-            thresholds[i] = 0.0;
+        if (padToMaxIntervals && intervalCount > 0) {
+            // Search all kMaxIntervals intervals, with the unused ones at the top repeating the
+            // last used one, so t at or past its end threshold still gets its color.
+            for (int i = intervalCount; i < kMaxIntervals; i++) {
+                scales[i] = scales[intervalCount - 1];
+                biases[i] = biases[intervalCount - 1];
+                thresholds[i] = thresholds[intervalCount - 1];
+            }
+            intervalCount = kMaxIntervals;
+        } else {
+            // For isEqual to make sense, set the unused values to something consistent
+            for (int i = intervalCount; i < kMaxIntervals; i++) {
+                scales[i] = SK_PMColor4fTRANSPARENT;
+                biases[i] = SK_PMColor4fTRANSPARENT;
+                thresholds[i] = 0.0;
+            }
         }
 
         return std::unique_ptr<GrFragmentProcessor>(new GrUnrolledBinaryGradientColorizer(
@@ -36,9 +36,12 @@ public:
     const SkRect& thresholds1_7() const { return fThresholds1_7; }
     const SkRect& thresholds9_13() const { return fThresholds9_13; }
 
+    // If padToMaxIntervals is true, the unused intervals repeat the last one so that every
+    // gradient of any interval count shares one program, at the cost of a full binary search.
     static std::unique_ptr<GrFragmentProcessor> Make(const SkPMColor4f* colors,
                                                      const SkScalar* positions,
-                                                     int count);
+                                                     int count,
+                                                     bool padToMaxIntervals = false);
     GrUnrolledBinaryGradientColorizer(const GrUnrolledBinaryGradientColorizer& src);
     std::unique_ptr<GrFragmentProcessor> clone() const override;
     const char* name() const override { return "UnrolledBinaryGradientColorizer"; }
@@ -17,6 +17,8 @@ public:
             : INHERITED(contextOptions), fOptions(options) {
         fInstanceAttribSupport = options.fInstanceAttribSupport;
         fMapBufferFlags = options.fMapBufferFlags;
+        fFenceSyncSupport = options.fFenceSyncSupport;
+        fTransferBufferSupport = options.fTransferBufferSupport;
         fBufferMapThreshold = SK_MaxS32; // Overridable in GrContextOptions.
         fMaxTextureSize = options.fMaxTextureSize;
         fMaxRenderTargetSize = SkTMin(options.fMaxRenderTargetSize, fMaxTextureSize);
@@ -17,6 +17,7 @@
 #include "GrMtlCopyManager.h"
 #include "GrMtlResourceProvider.h"
 #include "GrMtlStencilAttachment.h"
+#include "GrMtlUniformRingBuffer.h"
 
 #import <Metal/Metal.h>
 
@@ -44,6 +45,8 @@ public:
 
     GrMtlResourceProvider& resourceProvider() { return fResourceProvider; }
 
+    GrMtlUniformRingBuffer& uniformRingBuffer() { return fUniformRingBuffer; }
+
     enum SyncQueue {
         kForce_SyncQueue,
         kSkip_SyncQueue
@@ -94,7 +97,8 @@ public:
 
     GrGpuTextureCommandBuffer* getCommandBuffer(GrTexture*, GrSurfaceOrigin) override;
 
-    SkSL::Compiler* shaderCompiler() const { return fCompiler.get(); }
+    // Created on first use: context creation shouldn't pay for parsing the SkSL includes.
+    SkSL::Compiler* shaderCompiler() const;
 
     void submit(GrGpuCommandBuffer* buffer) override;
 
@@ -158,6 +162,11 @@ private:
         return false;
     }
 
+    bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height,
+                              GrColorType, GrBuffer*, size_t offset) override {
+        return false;
+    }
+
     bool onRegenerateMipMapLevels(GrTexture*) override { return false; }
 
     void onResolveRenderTarget(GrRenderTarget* target) override { return; }
@@ -188,9 +197,10 @@ private:
 
     id<MTLCommandBuffer> fCmdBuffer;
 
-    std::unique_ptr<SkSL::Compiler> fCompiler;
+    mutable std::unique_ptr<SkSL::Compiler> fCompiler;
     GrMtlCopyManager fCopyManager;
     GrMtlResourceProvider fResourceProvider;
+    GrMtlUniformRingBuffer fUniformRingBuffer;
 
     typedef GrGpu INHERITED;
 };
@@ -96,9 +96,9 @@ GrMtlGpu::GrMtlGpu(GrContext* context, const GrContextOptions& options,
         : INHERITED(context)
         , fDevice(device)
         , fQueue(queue)
-        , fCompiler(new SkSL::Compiler())
         , fCopyManager(this)
-        , fResourceProvider(this) {
+        , fResourceProvider(this)
+        , fUniformRingBuffer(this) {
 
     fMtlCaps.reset(new GrMtlCaps(options, fDevice, featureSet));
     fCaps = fMtlCaps;
@@ -106,6 +106,13 @@ GrMtlGpu::GrMtlGpu(GrContext* context, const GrContextOptions& options,
     fCmdBuffer = [fQueue commandBuffer];
 }
 
+SkSL::Compiler* GrMtlGpu::shaderCompiler() const {
+    if (!fCompiler) {
+        fCompiler.reset(new SkSL::Compiler());
+    }
+    return fCompiler.get();
+}
+
 GrGpuRTCommandBuffer* GrMtlGpu::getCommandBuffer(
             GrRenderTarget* renderTarget, GrSurfaceOrigin origin, const SkRect& bounds,
             const GrGpuRTCommandBuffer::LoadAndStoreInfo& colorInfo,
@@ -124,6 +131,7 @@ void GrMtlGpu::submit(GrGpuCommandBuffer* buffer) {
 
 void GrMtlGpu::submitCommandBuffer(SyncQueue sync) {
     SkASSERT(fCmdBuffer);
+    fUniformRingBuffer.submit(fCmdBuffer);
     [fCmdBuffer commit];
     if (SyncQueue::kForce_SyncQueue == sync) {
         [fCmdBuffer waitUntilCompleted];
@@ -9,8 +9,8 @@
 
 #include "GrColor.h"
 #include "GrFixedClip.h"
+#include "GrMtlBuffer.h"
 #include "GrMtlPipelineState.h"
-#include "GrMtlPipelineStateBuilder.h"
 #include "GrMtlRenderTarget.h"
 #include "GrRenderTargetPriv.h"
 
@@ -111,22 +111,17 @@ GrMtlPipelineState* GrMtlGpuRTCommandBuffer::prepareDrawState(
         const GrMesh meshes[],
         int meshCount) {
     // TODO: resolve textures and regenerate mipmaps as needed
-    bool hasPoints = false;
+    // The pipeline state only depends on the primitive type through whether it writes a point size.
+    GrPrimitiveType primitiveType = meshes[0].primitiveType();
     for (int i = 0; i < meshCount; ++i) {
         if (meshes[i].primitiveType() == GrPrimitiveType::kPoints) {
-            hasPoints = true;
+            primitiveType = GrPrimitiveType::kPoints;
             break;
         }
     }
-    GrProgramDesc desc;
-    if (!GrProgramDesc::Build(&desc, primProc, hasPoints, pipeline, *fGpu->caps()->shaderCaps())) {
-        return nullptr;
-    }
-    desc.finalize();
-
-    // TODO: use resource provider for pipeline
     GrMtlPipelineState* pipelineState =
-            GrMtlPipelineStateBuilder::CreatePipelineState(primProc, pipeline, &desc, fGpu);
+            fGpu->resourceProvider().findOrCreateCompatiblePipelineState(pipeline, primProc,
+                                                                         primitiveType);
     if (!pipelineState) {
         return nullptr;
     }
@@ -158,8 +153,8 @@ void GrMtlGpuRTCommandBuffer::onDraw(const GrPrimitiveProcessor& primProc,
         return; // TODO: ScissorRects are not supported.
     }
 
-    std::unique_ptr<GrMtlPipelineState> pipelineState(
-            this->prepareDrawState(primProc, pipeline, fixedDynamicState, meshes, meshCount));
+    GrMtlPipelineState* pipelineState =
+            this->prepareDrawState(primProc, pipeline, fixedDynamicState, meshes, meshCount);
     if (!pipelineState) {
         return;
     }
@@ -8,7 +8,6 @@
 #ifndef GrMtlPipelineState_DEFINED
 #define GrMtlPipelineState_DEFINED
 
-#include "GrMtlBuffer.h"
 #include "GrMtlPipelineStateDataManager.h"
 #include "GrStencilSettings.h"
 #include "GrTypesPriv.h"
@@ -37,8 +36,8 @@ public:
             MTLPixelFormat pixelFormat,
             const GrGLSLBuiltinUniformHandles& builtinUniformHandles,
             const UniformInfoArray& uniforms,
-            GrMtlBuffer* geometryUniformBuffer,
-            GrMtlBuffer* fragmentUniformBuffer,
+            uint32_t geometryUniformSize,
+            uint32_t fragmentUniformSize,
             uint32_t numSamplers,
             std::unique_ptr<GrGLSLPrimitiveProcessor> geometryProcessor,
             std::unique_ptr<GrGLSLXferProcessor> xferPRocessor,
@@ -50,6 +49,9 @@ public:
     void setData(const GrPrimitiveProcessor& primPRoc, const GrPipeline& pipeline,
                  const GrTextureProxy* const primProcTextures[]);
 
+    // Binds the uniforms and samplers of the last setData(). The uniforms are copied into the gpu's
+    // uniform ring buffer, so other draws may use this pipeline state before the GPU is done with
+    // this one.
     void bind(id<MTLRenderCommandEncoder>);
 
     void setBlendConstants(id<MTLRenderCommandEncoder>, GrPixelConfig, const GrXferProcessor&);
@@ -111,9 +113,6 @@ private:
 
     GrStencilSettings fStencil;
 
-    sk_sp<GrMtlBuffer> fGeometryUniformBuffer;
-    sk_sp<GrMtlBuffer> fFragmentUniformBuffer;
-
     int fNumSamplers;
     SkTArray<SamplerBindings> fSamplerBindings;
 
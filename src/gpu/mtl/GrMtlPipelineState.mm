@@ -13,7 +13,6 @@
 #include "GrRenderTarget.h"
 #include "GrRenderTargetPriv.h"
 #include "GrTexturePriv.h"
-#include "GrMtlBuffer.h"
 #include "GrMtlGpu.h"
 #include "GrMtlSampler.h"
 #include "GrMtlTexture.h"
@@ -25,9 +24,8 @@ GrMtlPipelineState::SamplerBindings::SamplerBindings(const GrSamplerState& state
                                                      GrTexture* texture,
                                                      GrMtlGpu* gpu)
         : fTexture(static_cast<GrMtlTexture*>(texture)->mtlTexture()) {
-    // TODO: use resource provider to get sampler.
-    std::unique_ptr<GrMtlSampler> sampler(
-            GrMtlSampler::Create(gpu, state, texture->texturePriv().maxMipMapLevel()));
+    GrMtlSampler* sampler = gpu->resourceProvider().findOrCreateCompatibleSampler(
+            state, texture->texturePriv().maxMipMapLevel());
     fSampler = sampler->mtlSamplerState();
 }
 
@@ -37,8 +35,8 @@ GrMtlPipelineState::GrMtlPipelineState(
         MTLPixelFormat pixelFormat,
         const GrGLSLBuiltinUniformHandles& builtinUniformHandles,
         const UniformInfoArray& uniforms,
-        GrMtlBuffer* geometryUniformBuffer,
-        GrMtlBuffer* fragmentUniformBuffer,
+        uint32_t geometryUniformSize,
+        uint32_t fragmentUniformSize,
         uint32_t numSamplers,
         std::unique_ptr<GrGLSLPrimitiveProcessor> geometryProcessor,
         std::unique_ptr<GrGLSLXferProcessor> xferProcessor,
@@ -48,15 +46,12 @@ GrMtlPipelineState::GrMtlPipelineState(
         , fPipelineState(pipelineState)
         , fPixelFormat(pixelFormat)
         , fBuiltinUniformHandles(builtinUniformHandles)
-        , fGeometryUniformBuffer(geometryUniformBuffer)
-        , fFragmentUniformBuffer(fragmentUniformBuffer)
         , fNumSamplers(numSamplers)
         , fGeometryProcessor(std::move(geometryProcessor))
         , fXferProcessor(std::move(xferProcessor))
         , fFragmentProcessors(std::move(fragmentProcessors))
         , fFragmentProcessorCnt(fragmentProcessorCnt)
-        , fDataManager(uniforms, geometryUniformBuffer->sizeInBytes(),
-                       fragmentUniformBuffer->sizeInBytes()) {
+        , fDataManager(uniforms, geometryUniformSize, fragmentUniformSize) {
     (void) fPixelFormat; // Suppress unused-var warning.
 }
 
@@ -104,30 +99,20 @@ void GrMtlPipelineState::setData(const GrPrimitiveProcessor& primProc,
     }
 
     SkASSERT(fNumSamplers == fSamplerBindings.count());
-    if (fGeometryUniformBuffer || fFragmentUniformBuffer) {
-        fDataManager.uploadUniformBuffers(fGpu, fGeometryUniformBuffer.get(),
-                                          fFragmentUniformBuffer.get());
-    }
 
     if (pipeline.isStencilEnabled()) {
         GrRenderTarget* rt = pipeline.renderTarget();
         SkASSERT(rt->renderTargetPriv().getStencilAttachment());
         fStencil.reset(*pipeline.getUserStencil(), pipeline.hasStencilClip(),
                        rt->renderTargetPriv().numStencilBits());
+    } else {
+        // Pipeline states are cached, so an earlier draw may have left stencil settings behind.
+        fStencil.setDisabled();
     }
 }
 
 void GrMtlPipelineState::bind(id<MTLRenderCommandEncoder> renderCmdEncoder) {
-    if (fGeometryUniformBuffer) {
-        [renderCmdEncoder setVertexBuffer: fGeometryUniformBuffer->mtlBuffer()
-                                   offset: 0
-                                  atIndex: GrMtlUniformHandler::kGeometryBinding];
-    }
-    if (fFragmentUniformBuffer) {
-        [renderCmdEncoder setFragmentBuffer: fFragmentUniformBuffer->mtlBuffer()
-                                     offset: 0
-                                    atIndex: GrMtlUniformHandler::kFragBinding];
-    }
+    fDataManager.uploadAndBindUniformBuffers(fGpu, renderCmdEncoder);
     SkASSERT(fNumSamplers == fSamplerBindings.count());
     for (int index = 0; index < fNumSamplers; ++index) {
         [renderCmdEncoder setFragmentTexture: fSamplerBindings[index].fTexture
@@ -19,12 +19,41 @@
 
 class GrMtlGpu;
 class GrMtlPipelineState;
+class SkData;
 
 class GrMtlPipelineStateBuilder : public GrGLSLProgramBuilder {
 public:
+    /**
+     * For Metal we want to cache the entire pipeline for reuse of draws. The Desc here holds all
+     * the information needed to differentiate one pipeline from another.
+     *
+     * The GrProgramDesc contains all the information need to create the actual shaders for the
+     * pipeline.
+     *
+     * For Metal we need to add to the GrProgramDesc to include the rest of the state on the
+     * pipeline. This includes the render target's pixel format and the blend state.
+     */
+    class Desc : public GrProgramDesc {
+    public:
+        static bool Build(Desc*,
+                          const GrPrimitiveProcessor&,
+                          const GrPipeline&,
+                          bool hasPointSize,
+                          const GrShaderCaps&);
+
+    private:
+        typedef GrProgramDesc INHERITED;
+    };
+
+    /** Generates a pipeline state.
+     *
+     * This function may modify the program key by setting the surface origin key to 0
+     * (unspecified) if it turns out the program does not care about the surface origin.
+     * @return the pipeline state, or nullptr if generation failed.
+     */
     static GrMtlPipelineState* CreatePipelineState(const GrPrimitiveProcessor&,
                                                    const GrPipeline&,
-                                                   GrProgramDesc*,
+                                                   Desc*,
                                                    GrMtlGpu*);
 
 private:
@@ -43,12 +72,29 @@ private:
 
     void finalizeFragmentSecondaryColor(GrShaderVar& outputColor) override;
 
+    // Compiles the builder's SkSL, returning the MSL and inputs so they can be cached.
     id<MTLLibrary> createMtlShaderLibrary(const GrGLSLShaderBuilder& builder,
                                           SkSL::Program::Kind kind,
                                           const SkSL::Program::Settings& settings,
-                                          GrProgramDesc* desc);
+                                          Desc* desc,
+                                          SkSL::String* outMSL,
+                                          SkSL::Program::Inputs* outInputs);
 
-    GrMtlPipelineState* finalize(const GrPrimitiveProcessor&, const GrPipeline&, GrProgramDesc*);
+    // Makes the library from MSL found in the PersistentCache.
+    id<MTLLibrary> installMtlShaderLibrary(const SkSL::String& msl,
+                                           const SkSL::Program::Inputs& inputs,
+                                           Desc* desc);
+
+    void applyShaderInputs(const SkSL::Program::Inputs&, Desc*);
+
+    static sk_sp<SkData> MSLCacheKey(const GrProgramDesc&);
+    static sk_sp<SkData> EncodeShaders(const SkSL::String msl[],
+                                       const SkSL::Program::Inputs inputs[], int stageCount);
+    // Returns false if the data is malformed.
+    static bool DecodeShaders(const SkData&, SkSL::String msl[], SkSL::Program::Inputs inputs[],
+                              int stageCount);
+
+    GrMtlPipelineState* finalize(const GrPrimitiveProcessor&, const GrPipeline&, Desc*);
 
     GrMtlGpu* fGpu;
     GrMtlUniformHandler fUniformHandler;
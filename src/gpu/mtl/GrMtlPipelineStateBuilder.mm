@@ -13,13 +13,16 @@
 #include "GrMtlGpu.h"
 #include "GrMtlPipelineState.h"
 #include "GrMtlUtil.h"
+#include "SkAutoMalloc.h"
+#include "SkData.h"
+#include "SkStream.h"
 
 #import <simd/simd.h>
 
 GrMtlPipelineState* GrMtlPipelineStateBuilder::CreatePipelineState(
         const GrPrimitiveProcessor& primProc,
         const GrPipeline& pipeline,
-        GrProgramDesc* desc,
+        Desc* desc,
         GrMtlGpu* gpu) {
     GrMtlPipelineStateBuilder builder(primProc, pipeline, desc, gpu);
 
@@ -55,7 +58,9 @@ id<MTLLibrary> GrMtlPipelineStateBuilder::createMtlShaderLibrary(
         const GrGLSLShaderBuilder& builder,
         SkSL::Program::Kind kind,
         const SkSL::Program::Settings& settings,
-        GrProgramDesc* desc) {
+        Desc* desc,
+        SkSL::String* outMSL,
+        SkSL::Program::Inputs* outInputs) {
     SkString shaderString;
     for (int i = 0; i < builder.fCompilerStrings.count(); ++i) {
         if (builder.fCompilerStrings[i]) {
@@ -64,12 +69,26 @@ id<MTLLibrary> GrMtlPipelineStateBuilder::createMtlShaderLibrary(
         }
     }
 
-    SkSL::Program::Inputs inputs;
-    id<MTLLibrary> shaderLibrary = GrCompileMtlShaderLibrary(fGpu, shaderString.c_str(),
-                                                             kind, settings, &inputs);
+    if (!GrSkSLToMSL(fGpu, shaderString.c_str(), kind, settings, outMSL, outInputs)) {
+        return nil;
+    }
+    return this->installMtlShaderLibrary(*outMSL, *outInputs, desc);
+}
+
+id<MTLLibrary> GrMtlPipelineStateBuilder::installMtlShaderLibrary(
+        const SkSL::String& msl,
+        const SkSL::Program::Inputs& inputs,
+        Desc* desc) {
+    id<MTLLibrary> shaderLibrary = GrCompileMtlShaderLibraryFromMSL(fGpu, msl);
     if (shaderLibrary == nil) {
         return nil;
     }
+    this->applyShaderInputs(inputs, desc);
+    return shaderLibrary;
+}
+
+void GrMtlPipelineStateBuilder::applyShaderInputs(const SkSL::Program::Inputs& inputs,
+                                                  Desc* desc) {
     if (inputs.fRTHeight) {
         this->addRTHeightUniform(SKSL_RTHEIGHT_NAME);
     }
@@ -78,7 +97,54 @@ id<MTLLibrary> GrMtlPipelineStateBuilder::createMtlShaderLibrary(
                                                                this->pipeline().proxy()->origin()));
         desc->finalize();
     }
-    return shaderLibrary;
+}
+
+// Distinguishes our MSL from anything else a client may keep in the same PersistentCache.
+static constexpr uint32_t kMSLCacheKeyTag = SkSetFourByteTag('M', 'S', 'L', ' ');
+
+sk_sp<SkData> GrMtlPipelineStateBuilder::MSLCacheKey(const GrProgramDesc& desc) {
+    SkAutoMalloc key(sizeof(kMSLCacheKeyTag) + desc.keyLength());
+    memcpy(key.get(), &kMSLCacheKeyTag, sizeof(kMSLCacheKeyTag));
+    memcpy(SkTAddOffset<void>(key.get(), sizeof(kMSLCacheKeyTag)), desc.asKey(),
+           desc.keyLength());
+    return SkData::MakeWithCopy(key.get(), sizeof(kMSLCacheKeyTag) + desc.keyLength());
+}
+
+// The cached data is, for each shader stage in order, its SkSL::Program::Inputs, the length of its
+// MSL as a uint32_t, and the MSL itself.
+sk_sp<SkData> GrMtlPipelineStateBuilder::EncodeShaders(const SkSL::String msl[],
+                                                       const SkSL::Program::Inputs inputs[],
+                                                       int stageCount) {
+    SkDynamicMemoryWStream stream;
+    for (int i = 0; i < stageCount; ++i) {
+        uint32_t size = SkToU32(msl[i].size());
+        stream.write(&inputs[i], sizeof(inputs[i]));
+        stream.write(&size, sizeof(size));
+        stream.write(msl[i].c_str(), size);
+    }
+    return stream.detachAsData();
+}
+
+bool GrMtlPipelineStateBuilder::DecodeShaders(const SkData& data, SkSL::String msl[],
+                                              SkSL::Program::Inputs inputs[], int stageCount) {
+    const uint8_t* bytes = data.bytes();
+    size_t offset = 0;
+    for (int i = 0; i < stageCount; ++i) {
+        uint32_t size;
+        if (data.size() - offset < sizeof(inputs[i]) + sizeof(size)) {
+            return false;
+        }
+        memcpy(&inputs[i], bytes + offset, sizeof(inputs[i]));
+        offset += sizeof(inputs[i]);
+        memcpy(&size, bytes + offset, sizeof(size));
+        offset += sizeof(size);
+        if (data.size() - offset < size || !size) {
+            return false;
+        }
+        msl[i] = SkSL::String(reinterpret_cast<const char*>(bytes + offset), size);
+        offset += size;
+    }
+    return offset == data.size();
 }
 
 static inline MTLVertexFormat attribute_type_to_mtlformat(GrVertexAttribType type) {
@@ -306,7 +372,7 @@ static MTLRenderPipelineColorAttachmentDescriptor* create_color_attachment(
 
 GrMtlPipelineState* GrMtlPipelineStateBuilder::finalize(const GrPrimitiveProcessor& primProc,
                                                         const GrPipeline& pipeline,
-                                                        GrProgramDesc* desc) {
+                                                        Desc* desc) {
     auto pipelineDescriptor = [[MTLRenderPipelineDescriptor alloc] init];
 
     fVS.extensions().appendf("#extension GL_ARB_separate_shader_objects : enable\n");
@@ -322,23 +388,51 @@ GrMtlPipelineState* GrMtlPipelineStateBuilder::finalize(const GrPrimitiveProcess
     settings.fSharpenTextures = fGpu->getContext()->contextPriv().sharpenMipmappedTextures();
     SkASSERT(!this->fragColorIsInOut());
 
-    id<MTLLibrary> vertexLibrary = nil;
-    id<MTLLibrary> fragmentLibrary = nil;
-    vertexLibrary = this->createMtlShaderLibrary(fVS,
-                                                 SkSL::Program::kVertex_Kind,
-                                                 settings,
-                                                 desc);
-    fragmentLibrary = this->createMtlShaderLibrary(fFS,
-                                                   SkSL::Program::kFragment_Kind,
-                                                   settings,
-                                                   desc);
     SkASSERT(!this->primitiveProcessor().willUseGeoShader());
 
-    SkASSERT(vertexLibrary);
-    SkASSERT(fragmentLibrary);
+    static constexpr int kStageCount = 2;
+    const SkSL::Program::Kind kinds[kStageCount] = {
+        SkSL::Program::kVertex_Kind, SkSL::Program::kFragment_Kind
+    };
+    const GrGLSLShaderBuilder* builders[kStageCount] = { &fVS, &fFS };
+    id<MTLLibrary> libraries[kStageCount] = { nil, nil };
+    SkSL::String msl[kStageCount];
+    SkSL::Program::Inputs inputs[kStageCount];
+
+    // Compiling may change the desc's surface origin key, so the key is made up front. Metal still
+    // has to compile the MSL on a hit, but SkSL's part of the work is skipped.
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    sk_sp<SkData> cacheKey;
+    bool cached = false;
+    if (persistentCache) {
+        cacheKey = MSLCacheKey(*desc);
+        sk_sp<SkData> data = persistentCache->load(*cacheKey);
+        cached = data && DecodeShaders(*data, msl, inputs, kStageCount);
+        if (cached) {
+            fGpu->stats()->incPersistentCacheHits();
+        } else {
+            fGpu->stats()->incPersistentCacheMisses();
+        }
+    }
+
+    for (int i = 0; i < kStageCount; ++i) {
+        if (cached) {
+            libraries[i] = this->installMtlShaderLibrary(msl[i], inputs[i], desc);
+        } else {
+            libraries[i] = this->createMtlShaderLibrary(*builders[i], kinds[i], settings, desc,
+                                                        &msl[i], &inputs[i]);
+        }
+        if (libraries[i] == nil) {
+            return nullptr;
+        }
+    }
 
-    id<MTLFunction> vertexFunction = [vertexLibrary newFunctionWithName: @"vertexMain"];
-    id<MTLFunction> fragmentFunction = [fragmentLibrary newFunctionWithName: @"fragmentMain"];
+    if (persistentCache && !cached) {
+        persistentCache->store(*cacheKey, *EncodeShaders(msl, inputs, kStageCount));
+    }
+
+    id<MTLFunction> vertexFunction = [libraries[0] newFunctionWithName: @"vertexMain"];
+    id<MTLFunction> fragmentFunction = [libraries[1] newFunctionWithName: @"fragmentMain"];
 
     pipelineDescriptor.vertexFunction = vertexFunction;
     pipelineDescriptor.fragmentFunction = fragmentFunction;
@@ -364,17 +458,48 @@ GrMtlPipelineState* GrMtlPipelineStateBuilder::finalize(const GrPrimitiveProcess
                                   pipelineDescriptor.colorAttachments[0].pixelFormat,
                                   fUniformHandles,
                                   fUniformHandler.fUniforms,
-                                  GrMtlBuffer::Create(fGpu,
-                                                      fUniformHandler.fCurrentGeometryUBOOffset,
-                                                      kVertex_GrBufferType,
-                                                      kStatic_GrAccessPattern),
-                                  GrMtlBuffer::Create(fGpu,
-                                                      fUniformHandler.fCurrentFragmentUBOOffset,
-                                                      kVertex_GrBufferType,
-                                                      kStatic_GrAccessPattern),
+                                  fUniformHandler.fCurrentGeometryUBOOffset,
+                                  fUniformHandler.fCurrentFragmentUBOOffset,
                                   (uint32_t)fUniformHandler.numSamplers(),
                                   std::move(fGeometryProcessor),
                                   std::move(fXferProcessor),
                                   std::move(fFragmentProcessors),
                                   fFragmentProcessorCnt);
 }
+
+//////////////////////////////////////////////////////////////////////////////
+
+static uint32_t get_blend_info_key(const GrPipeline& pipeline) {
+    GrXferProcessor::BlendInfo blendInfo;
+    pipeline.getXferProcessor().getBlendInfo(&blendInfo);
+
+    static const uint32_t kBlendWriteShift = 1;
+    static const uint32_t kBlendCoeffShift = 5;
+    GR_STATIC_ASSERT(kLast_GrBlendCoeff < (1 << kBlendCoeffShift));
+    GR_STATIC_ASSERT(kFirstAdvancedGrBlendEquation - 1 < 4);
+
+    uint32_t key = blendInfo.fWriteColor;
+    key |= (blendInfo.fSrcBlend << kBlendWriteShift);
+    key |= (blendInfo.fDstBlend << (kBlendWriteShift + kBlendCoeffShift));
+    key |= (blendInfo.fEquation << (kBlendWriteShift + 2 * kBlendCoeffShift));
+
+    return key;
+}
+
+bool GrMtlPipelineStateBuilder::Desc::Build(Desc* desc,
+                                            const GrPrimitiveProcessor& primProc,
+                                            const GrPipeline& pipeline,
+                                            bool hasPointSize,
+                                            const GrShaderCaps& caps) {
+    if (!INHERITED::Build(desc, primProc, hasPointSize, pipeline, caps)) {
+        return false;
+    }
+
+    // The MTLRenderPipelineState bakes in the color attachment's format and blending.
+    GrProcessorKeyBuilder b(&desc->key());
+    b.add32((uint32_t)pipeline.renderTarget()->config());
+
+    b.add32(get_blend_info_key(pipeline));
+
+    return true;
+}
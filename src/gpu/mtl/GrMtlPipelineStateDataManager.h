@@ -12,8 +12,10 @@
 #include "GrMtlUniformHandler.h"
 #include "SkAutoMalloc.h"
 
-class GrMtlBuffer;
+#import <metal/metal.h>
+
 class GrMtlGpu;
+class GrMtlUniformRingBuffer;
 
 class GrMtlPipelineStateDataManager : public GrGLSLProgramDataManager {
 public:
@@ -54,9 +56,9 @@ public:
         SK_ABORT("Only supported in NVPR, which is not in Metal");
     }
 
-    void uploadUniformBuffers(GrMtlGpu* gpu,
-                              GrMtlBuffer* geometryBuffer,
-                              GrMtlBuffer* fragmentBuffer) const;
+    // Copies any uniforms that changed into the gpu's uniform ring buffer and binds them.
+    void uploadAndBindUniformBuffers(GrMtlGpu* gpu,
+                                     id<MTLRenderCommandEncoder> renderCmdEncoder) const;
 
 private:
     struct Uniform {
@@ -71,8 +73,18 @@ private:
     template<int N> inline void setMatrices(UniformHandle, int arrayCount,
                                             const float matrices[]) const;
 
+    // Where in the uniform ring buffer a stage's uniforms were last copied to.
+    struct RingAllocation {
+        id<MTLBuffer> fBuffer;
+        uint32_t      fOffset;
+        uint32_t      fSubmitCount;
+    };
+
     void* getBufferPtrAndMarkDirty(const Uniform& uni) const;
 
+    bool uploadUniforms(GrMtlUniformRingBuffer*, const void* data, uint32_t size, bool* dirty,
+                        RingAllocation*) const;
+
     uint32_t fGeometryUniformSize;
     uint32_t fFragmentUniformSize;
 
@@ -82,6 +94,9 @@ private:
     mutable SkAutoMalloc fFragmentUniformData;
     mutable bool         fGeometryUniformsDirty;
     mutable bool         fFragmentUniformsDirty;
+
+    mutable RingAllocation fGeometryAllocation;
+    mutable RingAllocation fFragmentAllocation;
 };
 
 #endif
@@ -7,8 +7,8 @@
 
 #include "GrMtlPipelineStateDataManager.h"
 
-#include "GrMtlBuffer.h"
 #include "GrMtlGpu.h"
+#include "GrMtlUniformRingBuffer.h"
 
 GrMtlPipelineStateDataManager::GrMtlPipelineStateDataManager(const UniformInfoArray& uniforms,
                                                              uint32_t geometryUniformSize,
@@ -16,7 +16,9 @@ GrMtlPipelineStateDataManager::GrMtlPipelineStateDataManager(const UniformInfoAr
         : fGeometryUniformSize(geometryUniformSize)
         , fFragmentUniformSize(fragmentUniformSize)
         , fGeometryUniformsDirty(false)
-        , fFragmentUniformsDirty(false) {
+        , fFragmentUniformsDirty(false)
+        , fGeometryAllocation{nil, 0, 0}
+        , fFragmentAllocation{nil, 0, 0} {
     fGeometryUniformData.reset(geometryUniformSize);
     fFragmentUniformData.reset(fragmentUniformSize);
     int count = uniforms.count();
@@ -360,17 +362,45 @@ template<> struct set_uniform_matrix<4> {
     }
 };
 
-void GrMtlPipelineStateDataManager::uploadUniformBuffers(GrMtlGpu* gpu,
-                                                         GrMtlBuffer* geometryBuffer,
-                                                         GrMtlBuffer* fragmentBuffer) const {
-    if (geometryBuffer && fGeometryUniformsDirty) {
-        SkAssertResult(geometryBuffer->updateData(fGeometryUniformData.get(),
-                                                  fGeometryUniformSize));
-        fGeometryUniformsDirty = false;
+bool GrMtlPipelineStateDataManager::uploadUniforms(GrMtlUniformRingBuffer* ring,
+                                                   const void* data,
+                                                   uint32_t size,
+                                                   bool* dirty,
+                                                   RingAllocation* allocation) const {
+    // Unchanged uniforms that were copied since the last submit can still be bound where they are.
+    if (!*dirty && allocation->fBuffer && allocation->fSubmitCount == ring->submitCount()) {
+        return true;
     }
-    if (fragmentBuffer && fFragmentUniformsDirty) {
-        SkAssertResult(fragmentBuffer->updateData(fFragmentUniformData.get(),
-                                                  fFragmentUniformSize));
-        fFragmentUniformsDirty = false;
+    id<MTLBuffer> buffer;
+    uint32_t offset;
+    void* dst = ring->allocate(size, &buffer, &offset);
+    if (!dst) {
+        return false;
+    }
+    memcpy(dst, data, size);
+    allocation->fBuffer = buffer;
+    allocation->fOffset = offset;
+    allocation->fSubmitCount = ring->submitCount();
+    *dirty = false;
+    return true;
+}
+
+void GrMtlPipelineStateDataManager::uploadAndBindUniformBuffers(
+        GrMtlGpu* gpu,
+        id<MTLRenderCommandEncoder> renderCmdEncoder) const {
+    GrMtlUniformRingBuffer* ring = &gpu->uniformRingBuffer();
+    if (fGeometryUniformSize &&
+        this->uploadUniforms(ring, fGeometryUniformData.get(), fGeometryUniformSize,
+                             &fGeometryUniformsDirty, &fGeometryAllocation)) {
+        [renderCmdEncoder setVertexBuffer: fGeometryAllocation.fBuffer
+                                   offset: fGeometryAllocation.fOffset
+                                  atIndex: GrMtlUniformHandler::kGeometryBinding];
+    }
+    if (fFragmentUniformSize &&
+        this->uploadUniforms(ring, fFragmentUniformData.get(), fFragmentUniformSize,
+                             &fFragmentUniformsDirty, &fFragmentAllocation)) {
+        [renderCmdEncoder setFragmentBuffer: fFragmentAllocation.fBuffer
+                                     offset: fFragmentAllocation.fOffset
+                                    atIndex: GrMtlUniformHandler::kFragBinding];
     }
 }
@@ -9,24 +9,75 @@
 #define GrMtlResourceProvider_DEFINED
 
 #include "GrMtlCopyPipelineState.h"
+#include "GrMtlPipelineStateBuilder.h"
+#include "GrMtlSampler.h"
+#include "SkLRUCache.h"
+#include "SkOpts.h"
 #include "SkTArray.h"
+#include "SkTDynamicHash.h"
 
 #import <metal/metal.h>
 
 class GrMtlGpu;
+class GrMtlPipelineState;
+class GrSamplerState;
 
 class GrMtlResourceProvider {
 public:
-    GrMtlResourceProvider(GrMtlGpu* gpu) : fGpu(gpu) {}
+    GrMtlResourceProvider(GrMtlGpu* gpu);
+    ~GrMtlResourceProvider();
 
     GrMtlCopyPipelineState* findOrCreateCopyPipelineState(MTLPixelFormat dstPixelFormat,
                                                           id<MTLFunction> vertexFunction,
                                                           id<MTLFunction> fragmentFunction,
                                                           MTLVertexDescriptor* vertexDescriptor);
 
+    // Finds or creates a pipeline state for the draw. The provider owns the result, which other
+    // draws may reuse once it has been bound.
+    GrMtlPipelineState* findOrCreateCompatiblePipelineState(const GrPipeline&,
+                                                            const GrPrimitiveProcessor&,
+                                                            GrPrimitiveType);
+
+    // Finds or creates a compatible GrMtlSampler based on the GrSamplerState. The provider owns
+    // the result.
+    GrMtlSampler* findOrCreateCompatibleSampler(const GrSamplerState&, uint32_t maxMipLevel);
+
 private:
+    class PipelineStateCache : public ::SkNoncopyable {
+    public:
+        PipelineStateCache(GrMtlGpu* gpu);
+
+        GrMtlPipelineState* refPipelineState(const GrPrimitiveProcessor&,
+                                             const GrPipeline&,
+                                             GrPrimitiveType);
+
+    private:
+        enum {
+            // We may actually have kMaxEntries+1 PipelineStates in context because we create a new
+            // PipelineState before evicting from the cache.
+            kMaxEntries = 128,
+        };
+
+        struct DescHash {
+            uint32_t operator()(const GrProgramDesc& desc) const {
+                return SkOpts::hash_fn(desc.asKey(), desc.keyLength(), 0);
+            }
+        };
+
+        SkLRUCache<const GrMtlPipelineStateBuilder::Desc, std::unique_ptr<GrMtlPipelineState>,
+                   DescHash> fMap;
+
+        GrMtlGpu* fGpu;
+    };
+
     SkTArray<std::unique_ptr<GrMtlCopyPipelineState>> fCopyPipelineStateCache;
 
+    std::unique_ptr<PipelineStateCache> fPipelineStateCache;
+
+    // Stores GrMtlSampler objects that we've already created so we can reuse them across multiple
+    // GrMtlPipelineStates
+    SkTDynamicHash<GrMtlSampler, uint16_t> fSamplers;
+
     GrMtlGpu* fGpu;
 };
 
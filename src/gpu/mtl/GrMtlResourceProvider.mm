@@ -9,10 +9,23 @@
 
 #include "GrMtlCopyManager.h"
 #include "GrMtlGpu.h"
+#include "GrMtlPipelineState.h"
 #include "GrMtlUtil.h"
 
 #include "SkSLCompiler.h"
 
+GrMtlResourceProvider::GrMtlResourceProvider(GrMtlGpu* gpu)
+        : fPipelineStateCache(new PipelineStateCache(gpu))
+        , fGpu(gpu) {}
+
+GrMtlResourceProvider::~GrMtlResourceProvider() {
+    SkTDynamicHash<GrMtlSampler, uint16_t>::Iter iter(&fSamplers);
+    for (; !iter.done(); ++iter) {
+        delete &(*iter);
+    }
+    fSamplers.reset();
+}
+
 GrMtlCopyPipelineState* GrMtlResourceProvider::findOrCreateCopyPipelineState(
         MTLPixelFormat dstPixelFormat,
         id<MTLFunction> vertexFunction,
@@ -29,3 +42,58 @@ GrMtlCopyPipelineState* GrMtlResourceProvider::findOrCreateCopyPipelineState(
              fGpu, dstPixelFormat, vertexFunction, fragmentFunction, vertexDescriptor));
     return fCopyPipelineStateCache.back().get();
 }
+
+GrMtlPipelineState* GrMtlResourceProvider::findOrCreateCompatiblePipelineState(
+        const GrPipeline& pipeline, const GrPrimitiveProcessor& proc,
+        GrPrimitiveType primitiveType) {
+    return fPipelineStateCache->refPipelineState(proc, pipeline, primitiveType);
+}
+
+GrMtlSampler* GrMtlResourceProvider::findOrCreateCompatibleSampler(const GrSamplerState& params,
+                                                                   uint32_t maxMipLevel) {
+    GrMtlSampler* sampler = fSamplers.find(GrMtlSampler::GenerateKey(params, maxMipLevel));
+    if (!sampler) {
+        sampler = GrMtlSampler::Create(fGpu, params, maxMipLevel);
+        fSamplers.add(sampler);
+    }
+    SkASSERT(sampler);
+    return sampler;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+GrMtlResourceProvider::PipelineStateCache::PipelineStateCache(GrMtlGpu* gpu)
+        : fMap(kMaxEntries)
+        , fGpu(gpu) {}
+
+GrMtlPipelineState* GrMtlResourceProvider::PipelineStateCache::refPipelineState(
+        const GrPrimitiveProcessor& primProc,
+        const GrPipeline& pipeline,
+        GrPrimitiveType primitiveType) {
+    GrMtlPipelineStateBuilder::Desc desc;
+    if (!GrMtlPipelineStateBuilder::Desc::Build(&desc, primProc, pipeline,
+                                                GrPrimitiveType::kPoints == primitiveType,
+                                                *fGpu->caps()->shaderCaps())) {
+        GrCapsDebugf(fGpu->caps(), "Failed to build mtl program descriptor!\n");
+        return nullptr;
+    }
+    desc.finalize();
+
+    std::unique_ptr<GrMtlPipelineState>* entry = fMap.find(desc);
+    if (!entry) {
+        // Didn't find an origin-independent version, check with the specific origin
+        GrSurfaceOrigin origin = pipeline.proxy()->origin();
+        desc.setSurfaceOriginKey(GrGLSLFragmentShaderBuilder::KeyForSurfaceOrigin(origin));
+        desc.finalize();
+        entry = fMap.find(desc);
+    }
+    if (!entry) {
+        GrMtlPipelineState* pipelineState =
+                GrMtlPipelineStateBuilder::CreatePipelineState(primProc, pipeline, &desc, fGpu);
+        if (!pipelineState) {
+            return nullptr;
+        }
+        entry = fMap.insert(desc, std::unique_ptr<GrMtlPipelineState>(pipelineState));
+    }
+    return entry->get();
+}
@@ -13,18 +13,26 @@
 class GrSamplerState;
 class GrMtlGpu;
 
-// This class only acts as a wrapper for a MTLSamplerState object for now, but will be more useful
-// once we start caching sampler states.
+// Wraps a MTLSamplerState object. GrMtlResourceProvider caches these by their key.
 class GrMtlSampler {
 public:
     static GrMtlSampler* Create(const GrMtlGpu* gpu, const GrSamplerState&, uint32_t maxMipLevel);
 
     id<MTLSamplerState> mtlSamplerState() const { return fMtlSamplerState; }
 
+    // Helpers for hashing GrMtlSampler
+    static uint16_t GenerateKey(const GrSamplerState&, uint32_t maxMipLevel);
+
+    static const uint16_t& GetKey(const GrMtlSampler& sampler) { return sampler.fKey; }
+    static uint32_t Hash(const uint16_t& key) { return key; }
+
 private:
-    GrMtlSampler(id<MTLSamplerState> mtlSamplerState) : fMtlSamplerState(mtlSamplerState) {}
+    GrMtlSampler(id<MTLSamplerState> mtlSamplerState, uint16_t key)
+            : fMtlSamplerState(mtlSamplerState)
+            , fKey(key) {}
 
     id<MTLSamplerState> fMtlSamplerState;
+    uint16_t            fKey;
 };
 
 #endif
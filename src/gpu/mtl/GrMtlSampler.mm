@@ -49,5 +49,26 @@ GrMtlSampler* GrMtlSampler::Create(const GrMtlGpu* gpu, const GrSamplerState& sa
     samplerDesc.normalizedCoordinates = true;
     samplerDesc.compareFunction = MTLCompareFunctionNever;
 
-    return new GrMtlSampler([gpu->device() newSamplerStateWithDescriptor: samplerDesc]);
+    return new GrMtlSampler([gpu->device() newSamplerStateWithDescriptor: samplerDesc],
+                            GenerateKey(samplerState, maxMipLevel));
+}
+
+uint16_t GrMtlSampler::GenerateKey(const GrSamplerState& samplerState, uint32_t maxMipLevel) {
+    const int kTileModeXShift = 2;
+    const int kTileModeYShift = 4;
+    const int kMipLevelShift = 6;
+
+    SkASSERT(static_cast<int>(samplerState.filter()) <= 3);
+    uint16_t key = static_cast<uint16_t>(samplerState.filter());
+
+    SkASSERT(static_cast<int>(samplerState.wrapModeX()) <= 4);
+    key |= (static_cast<uint16_t>(samplerState.wrapModeX()) << kTileModeXShift);
+
+    SkASSERT(static_cast<int>(samplerState.wrapModeY()) <= 4);
+    key |= (static_cast<uint16_t>(samplerState.wrapModeY()) << kTileModeYShift);
+
+    SkASSERT(maxMipLevel < 1024);
+    key |= (maxMipLevel << kMipLevelShift);
+
+    return key;
 }
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrMtlUniformRingBuffer_DEFINED
+#define GrMtlUniformRingBuffer_DEFINED
+
+#include "SkTypes.h"
+
+#import <metal/metal.h>
+
+class GrMtlGpu;
+
+/**
+ * Hands out space for the uniforms of every GrMtlPipelineState from a few large MTLBuffers
+ * ("chunks") in shared storage. Draws bind a chunk at the offset of their uniforms, so pipeline
+ * states can be reused by several draws in one command buffer without overwriting data that an
+ * earlier draw still reads.
+ *
+ * Space is handed out front to back. When the current chunk is full the ring moves on to one that
+ * no command buffer is using anymore, or makes a new one. Every chunk used since the last submit
+ * goes with the submitted command buffer and comes back to the ring once that has completed.
+ */
+class GrMtlUniformRingBuffer {
+public:
+    // The size of each chunk.
+    static constexpr uint32_t kChunkSize = 256 * 1024;
+    // macOS requires the offsets of buffers bound in the constant address space to be multiples of
+    // 256 bytes. iOS only needs 4, but one alignment keeps things simple.
+    static constexpr uint32_t kAlignment = 256;
+
+    explicit GrMtlUniformRingBuffer(GrMtlGpu* gpu);
+
+    /**
+     * Returns a pointer to 'size' bytes for the caller to copy uniforms into, and sets 'buffer' and
+     * 'offset' to what to bind them with. Returns nullptr if a new chunk was needed and could not
+     * be made.
+     */
+    void* allocate(uint32_t size, id<MTLBuffer>* buffer, uint32_t* offset);
+
+    /**
+     * Gives the chunks used since the last submit to the command buffer, which returns them to the
+     * ring once it has completed. Must be called before the command buffer is committed.
+     */
+    void submit(id<MTLCommandBuffer> commandBuffer);
+
+    // Changes on every submit. Data allocated while the count was different may have been
+    // overwritten.
+    uint32_t submitCount() const { return fSubmitCount; }
+
+private:
+    bool nextChunk();
+
+    GrMtlGpu*                       fGpu;
+    id<MTLBuffer>                   fCurrentChunk;
+    uint32_t                        fCurrentOffset;
+    uint32_t                        fSubmitCount;
+    // The chunks used since the last submit, including the current one.
+    NSMutableArray<id<MTLBuffer>>*  fUsedChunks;
+    // Chunks no command buffer is using. Completion handlers add to this from Metal's threads, so
+    // it is only touched while synchronized on it.
+    NSMutableArray<id<MTLBuffer>>*  fAvailableChunks;
+};
+
+#endif
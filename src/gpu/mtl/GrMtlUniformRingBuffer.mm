@@ -0,0 +1,71 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrMtlUniformRingBuffer.h"
+
+#include "GrMtlGpu.h"
+#include "GrTypesPriv.h"
+
+GrMtlUniformRingBuffer::GrMtlUniformRingBuffer(GrMtlGpu* gpu)
+        : fGpu(gpu)
+        , fCurrentChunk(nil)
+        , fCurrentOffset(0)
+        , fSubmitCount(0)
+        , fUsedChunks([[NSMutableArray alloc] init])
+        , fAvailableChunks([[NSMutableArray alloc] init]) {}
+
+void* GrMtlUniformRingBuffer::allocate(uint32_t size, id<MTLBuffer>* buffer, uint32_t* offset) {
+    SkASSERT(size <= kChunkSize);
+    if (!fCurrentChunk || fCurrentOffset + size > kChunkSize) {
+        if (!this->nextChunk()) {
+            return nullptr;
+        }
+    }
+    *buffer = fCurrentChunk;
+    *offset = fCurrentOffset;
+    fCurrentOffset = GrUIAlignUp(fCurrentOffset + size, kAlignment);
+    return static_cast<char*>([fCurrentChunk contents]) + *offset;
+}
+
+bool GrMtlUniformRingBuffer::nextChunk() {
+    fCurrentChunk = nil;
+    @synchronized(fAvailableChunks) {
+        if ([fAvailableChunks count]) {
+            fCurrentChunk = [fAvailableChunks lastObject];
+            [fAvailableChunks removeLastObject];
+        }
+    }
+    if (!fCurrentChunk) {
+        // Shared storage needs no didModifyRange: calls, on macOS or iOS.
+        fCurrentChunk = [fGpu->device() newBufferWithLength: kChunkSize
+                                                    options: MTLResourceStorageModeShared];
+        if (!fCurrentChunk) {
+            return false;
+        }
+    }
+    [fUsedChunks addObject: fCurrentChunk];
+    fCurrentOffset = 0;
+    return true;
+}
+
+void GrMtlUniformRingBuffer::submit(id<MTLCommandBuffer> commandBuffer) {
+    ++fSubmitCount;
+    if (![fUsedChunks count]) {
+        return;
+    }
+    // The block holds the chunks and the available list, so it is fine for it to run after the
+    // ring is gone.
+    NSArray<id<MTLBuffer>>* usedChunks = fUsedChunks;
+    NSMutableArray<id<MTLBuffer>>* availableChunks = fAvailableChunks;
+    [commandBuffer addCompletedHandler: ^(id<MTLCommandBuffer>) {
+        @synchronized(availableChunks) {
+            [availableChunks addObjectsFromArray: usedChunks];
+        }
+    }];
+    fUsedChunks = [[NSMutableArray alloc] init];
+    fCurrentChunk = nil;
+}
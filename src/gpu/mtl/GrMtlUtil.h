@@ -48,6 +48,21 @@ const void* GrReleaseId(id idObject);
  */
 MTLTextureDescriptor* GrGetMTLTextureDescriptor(id<MTLTexture> mtlTexture);
 
+/**
+ * Translates SkSL to MSL. Returns false if SkSLC fails.
+ */
+bool GrSkSLToMSL(const GrMtlGpu* gpu,
+                 const char* shaderString,
+                 SkSL::Program::Kind kind,
+                 const SkSL::Program::Settings& settings,
+                 SkSL::String* msl,
+                 SkSL::Program::Inputs* outInputs);
+
+/**
+ * Returns a compiled MTLLibrary created from MSL code, or nil if it fails to compile.
+ */
+id<MTLLibrary> GrCompileMtlShaderLibraryFromMSL(const GrMtlGpu* gpu, const SkSL::String& msl);
+
 /**
  * Returns a compiled MTLLibrary created from MSL code generated by SkSLC
  */
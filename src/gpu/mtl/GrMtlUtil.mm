@@ -27,6 +27,9 @@ bool GrPixelConfigToMTLFormat(GrPixelConfig config, MTLPixelFormat* format) {
     switch (config) {
         case kUnknown_GrPixelConfig:
             return false;
+        case kRGB_ETC1_GrPixelConfig:
+            // Compressed uploads are not implemented for Metal yet.
+            return false;
         case kRGBA_8888_GrPixelConfig:
             *format = MTLPixelFormatRGBA8Unorm;
             return true;
@@ -165,11 +168,12 @@ void print_msl(const char* source) {
 }
 #endif
 
-id<MTLLibrary> GrCompileMtlShaderLibrary(const GrMtlGpu* gpu,
-                                         const char* shaderString,
-                                         SkSL::Program::Kind kind,
-                                         const SkSL::Program::Settings& settings,
-                                         SkSL::Program::Inputs* outInputs) {
+bool GrSkSLToMSL(const GrMtlGpu* gpu,
+                 const char* shaderString,
+                 SkSL::Program::Kind kind,
+                 const SkSL::Program::Settings& settings,
+                 SkSL::String* msl,
+                 SkSL::Program::Inputs* outInputs) {
     std::unique_ptr<SkSL::Program> program =
             gpu->shaderCompiler()->convertProgram(kind,
                                                   SkSL::String(shaderString),
@@ -178,16 +182,20 @@ id<MTLLibrary> GrCompileMtlShaderLibrary(const GrMtlGpu* gpu,
     if (!program) {
         SkDebugf("SkSL error:\n%s\n", gpu->shaderCompiler()->errorText().c_str());
         SkASSERT(false);
+        return false;
     }
 
     *outInputs = program->fInputs;
-    SkSL::String code;
-    if (!gpu->shaderCompiler()->toMetal(*program, &code)) {
+    if (!gpu->shaderCompiler()->toMetal(*program, msl)) {
         SkDebugf("%s\n", gpu->shaderCompiler()->errorText().c_str());
         SkASSERT(false);
-        return nil;
+        return false;
     }
-    NSString* mtlCode = [[NSString alloc] initWithCString: code.c_str()
+    return true;
+}
+
+id<MTLLibrary> GrCompileMtlShaderLibraryFromMSL(const GrMtlGpu* gpu, const SkSL::String& msl) {
+    NSString* mtlCode = [[NSString alloc] initWithCString: msl.c_str()
                                                  encoding: NSASCIIStringEncoding];
 #if PRINT_MSL
     print_msl([mtlCode cStringUsingEncoding: NSASCIIStringEncoding]);
@@ -206,6 +214,18 @@ id<MTLLibrary> GrCompileMtlShaderLibrary(const GrMtlGpu* gpu,
     return compiledLibrary;
 }
 
+id<MTLLibrary> GrCompileMtlShaderLibrary(const GrMtlGpu* gpu,
+                                         const char* shaderString,
+                                         SkSL::Program::Kind kind,
+                                         const SkSL::Program::Settings& settings,
+                                         SkSL::Program::Inputs* outInputs) {
+    SkSL::String code;
+    if (!GrSkSLToMSL(gpu, shaderString, kind, settings, &code, outInputs)) {
+        return nil;
+    }
+    return GrCompileMtlShaderLibraryFromMSL(gpu, code);
+}
+
 id<MTLTexture> GrGetMTLTextureFromSurface(GrSurface* surface, bool doResolve) {
     id<MTLTexture> mtlTexture = nil;
 
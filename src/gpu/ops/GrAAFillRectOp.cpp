@@ -17,10 +17,15 @@
 #include "SkMatrixPriv.h"
 #include "SkRect.h"
 #include "SkPointPriv.h"
+#include "glsl/GrGLSLFragmentShaderBuilder.h"
+#include "glsl/GrGLSLGeometryProcessor.h"
+#include "glsl/GrGLSLVarying.h"
+#include "glsl/GrGLSLVertexGeoBuilder.h"
 #include "ops/GrSimpleMeshDrawOpHelper.h"
 #include <new>
 
 GR_DECLARE_STATIC_UNIQUE_KEY(gAAFillRectIndexBufferKey);
+GR_DECLARE_STATIC_UNIQUE_KEY(gAAFillRectCornerBufferKey);
 
 static inline bool view_matrix_ok_for_aa_fill_rect(const SkMatrix& viewMatrix) {
     return viewMatrix.preservesRightAngles();
@@ -163,8 +168,179 @@ static void generate_aa_fill_rect_geometry(intptr_t verts,
     }
 }
 
+// When instancing is supported each rect is drawn as an instance of this template, in the same
+// vertex order as generate_aa_fill_rect_geometry(): the outer fan and then the inner one. xy are
+// the signs of the corner's outward direction and z is 1 on the outer fan and 0 on the inner.
+static constexpr float kAAFillRectCorners[kVertsPerAAFillRect * 3] = {
+    -1, -1, 1,    -1, +1, 1,    +1, +1, 1,    +1, -1, 1,
+    -1, -1, 0,    -1, +1, 0,    +1, +1, 0,    +1, -1, 0,
+};
+
+static sk_sp<const GrBuffer> get_corner_buffer(GrResourceProvider* resourceProvider) {
+    GR_DEFINE_STATIC_UNIQUE_KEY(gAAFillRectCornerBufferKey);
+    return resourceProvider->findOrMakeStaticBuffer(kVertex_GrBufferType,
+                                                    sizeof(kAAFillRectCorners),
+                                                    kAAFillRectCorners,
+                                                    gAAFillRectCornerBufferKey);
+}
+
 namespace {
 
+/**
+ * Expands a per-rect instance into the same eight vertices generate_aa_fill_rect_geometry() writes
+ * on the CPU. Each instance holds the rect, the rows of its view matrix, and its color, plus the
+ * rows of the matrix from device space to local coords when the pipeline uses them.
+ */
+class AAFillRectGeometryProcessor : public GrGeometryProcessor {
+public:
+    struct Instance {
+        float   fMatrixX[3];
+        float   fMatrixY[3];
+        SkRect  fRect;
+        GrColor fColor;
+
+        void set(const SkMatrix& viewMatrix, const SkRect& rect, GrColor color) {
+            fMatrixX[0] = viewMatrix.getScaleX();
+            fMatrixX[1] = viewMatrix.getSkewX();
+            fMatrixX[2] = viewMatrix.getTranslateX();
+            fMatrixY[0] = viewMatrix.getSkewY();
+            fMatrixY[1] = viewMatrix.getScaleY();
+            fMatrixY[2] = viewMatrix.getTranslateY();
+            fRect = rect;
+            fColor = color;
+        }
+    };
+
+    // Follows an Instance when the pipeline uses local coords.
+    struct LocalCoordsInstance {
+        float fLocalX[3];
+        float fLocalY[3];
+
+        void set(const SkMatrix& deviceToLocal) {
+            fLocalX[0] = deviceToLocal.getScaleX();
+            fLocalX[1] = deviceToLocal.getSkewX();
+            fLocalX[2] = deviceToLocal.getTranslateX();
+            fLocalY[0] = deviceToLocal.getSkewY();
+            fLocalY[1] = deviceToLocal.getScaleY();
+            fLocalY[2] = deviceToLocal.getTranslateY();
+        }
+    };
+
+    explicit AAFillRectGeometryProcessor(bool usesLocalCoords)
+            : INHERITED(kAAFillRectGeometryProcessor_ClassID)
+            , fUsesLocalCoords(usesLocalCoords) {
+        this->setVertexAttributeCnt(1);
+        this->setInstanceAttributeCnt(usesLocalCoords ? kNumInstanceAttribs
+                                                      : kNumInstanceAttribs - 2);
+        SkASSERT(this->debugOnly_instanceAttributeOffset(2) == offsetof(Instance, fRect));
+        SkASSERT(this->debugOnly_instanceAttributeOffset(3) == offsetof(Instance, fColor));
+        SkASSERT(this->debugOnly_instanceStride() == this->instanceStride());
+    }
+
+    const char* name() const override { return "AAFillRectGeometryProcessor"; }
+
+    size_t instanceStride() const {
+        return sizeof(Instance) + (fUsesLocalCoords ? sizeof(LocalCoordsInstance) : 0);
+    }
+
+    void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
+        b->add32(fUsesLocalCoords);
+    }
+
+    GrGLSLPrimitiveProcessor* createGLSLInstance(const GrShaderCaps&) const override {
+        return new GLSLProcessor();
+    }
+
+private:
+    class GLSLProcessor : public GrGLSLGeometryProcessor {
+    public:
+        void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+            const AAFillRectGeometryProcessor& proc =
+                    args.fGP.cast<AAFillRectGeometryProcessor>();
+            GrGLSLVertexBuilder* v = args.fVertBuilder;
+            GrGLSLVaryingHandler* varyingHandler = args.fVaryingHandler;
+
+            varyingHandler->emitAttributes(proc);
+            varyingHandler->addPassThroughAttribute(
+                    kInstanceAttribs[3], args.fOutputColor,
+                    GrGLSLVaryingHandler::Interpolation::kCanBeFlat);
+
+            v->codeAppendf("float3 corner = %s;", kInCorner.name());
+            v->codeAppendf("float3 mx = %s;", kInstanceAttribs[0].name());
+            v->codeAppendf("float3 my = %s;", kInstanceAttribs[1].name());
+            v->codeAppendf("float4 rect = %s;", kInstanceAttribs[2].name());
+            v->codeAppend ("float3 pt = float3(mix(rect.xy, rect.zw, corner.xy * .5 + .5), 1.0);");
+            v->codeAppend ("float2 devPos = float2(dot(mx, pt), dot(my, pt));");
+
+            // The outer fan is outset by half a pixel along the transformed axes of the rect.
+            v->codeAppend ("float2 axis0 = float2(mx.x, my.x);");
+            v->codeAppend ("float2 axis1 = float2(mx.y, my.y);");
+            v->codeAppend ("float len0 = length(axis0);");
+            v->codeAppend ("float len1 = length(axis1);");
+            v->codeAppend ("float2 vec0 = len0 > 0.0 ? axis0 * (.5 / len0) : float2(0);");
+            v->codeAppend ("float2 vec1 = len1 > 0.0 ? axis1 * (.5 / len1) : float2(0);");
+            v->codeAppend ("float2 outset = corner.x * vec0 + corner.y * vec1;");
+            v->codeAppend ("float inset = .5 * min(min(len0 * (rect.z - rect.x), 1.0), "
+                                                   "len1 * (rect.w - rect.y));");
+            // Rects that stay rects have their inner fan inset by 'inset'; others by half a pixel.
+            v->codeAppend ("bool staysRect = (0.0 == mx.y && 0.0 == my.x) || "
+                                          "(0.0 == mx.x && 0.0 == my.y);");
+            v->codeAppend ("float innerScale = staysRect ? 2.0 * inset : 1.0;");
+            v->codeAppend ("devPos += 0.0 != corner.z ? outset : -innerScale * outset;");
+            gpArgs->fPositionVar.set(kFloat2_GrSLType, "devPos");
+
+            GrGLSLVarying coverage(kHalf_GrSLType);
+            varyingHandler->addVarying("coverage", &coverage);
+            v->codeAppendf("%s = 0.0 != corner.z ? 0.0 : "
+                           "(inset < .5 ? floor(512.0 * inset / (inset + .5)) / 255.0 : 1.0);",
+                           coverage.vsOut());
+
+            const char* localCoordsName = "devPos";
+            if (proc.fUsesLocalCoords) {
+                v->codeAppendf("float2 localCoord = float2(dot(%s, float3(devPos, 1.0)), "
+                                                          "dot(%s, float3(devPos, 1.0)));",
+                               kInstanceAttribs[4].name(), kInstanceAttribs[5].name());
+                localCoordsName = "localCoord";
+            }
+            this->emitTransforms(v, varyingHandler, args.fUniformHandler,
+                                 GrShaderVar(localCoordsName, kFloat2_GrSLType), SkMatrix::I(),
+                                 args.fFPCoordTransformHandler);
+
+            args.fFragBuilder->codeAppendf("%s = half4(%s);", args.fOutputCoverage,
+                                           coverage.fsIn());
+        }
+
+        void setData(const GrGLSLProgramDataManager& pdman, const GrPrimitiveProcessor&,
+                     FPCoordTransformIter&& transformIter) override {
+            this->setTransformDataHelper(SkMatrix::I(), pdman, &transformIter);
+        }
+
+    private:
+        typedef GrGLSLGeometryProcessor INHERITED;
+    };
+
+    const Attribute& onVertexAttribute(int) const override { return kInCorner; }
+    const Attribute& onInstanceAttribute(int i) const override { return kInstanceAttribs[i]; }
+
+    static constexpr int kNumInstanceAttribs = 6;
+    static constexpr Attribute kInCorner =
+            {"inCorner", kFloat3_GrVertexAttribType, kFloat3_GrSLType};
+    static constexpr Attribute kInstanceAttribs[kNumInstanceAttribs] = {
+            {"inMatrixX", kFloat3_GrVertexAttribType, kFloat3_GrSLType},
+            {"inMatrixY", kFloat3_GrVertexAttribType, kFloat3_GrSLType},
+            {"inRect", kFloat4_GrVertexAttribType, kFloat4_GrSLType},
+            {"inColor", kUByte4_norm_GrVertexAttribType, kHalf4_GrSLType},
+            {"inLocalX", kFloat3_GrVertexAttribType, kFloat3_GrSLType},
+            {"inLocalY", kFloat3_GrVertexAttribType, kFloat3_GrSLType}
+    };
+
+    bool fUsesLocalCoords;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+constexpr GrPrimitiveProcessor::Attribute AAFillRectGeometryProcessor::kInCorner;
+constexpr GrPrimitiveProcessor::Attribute AAFillRectGeometryProcessor::kInstanceAttribs[];
+
 class AAFillRectOp final : public GrMeshDrawOp {
 private:
     using Helper = GrSimpleMeshDrawOpHelperWithStencil;
@@ -238,9 +414,62 @@ public:
     }
 
 private:
+    // Writes one compact instance per rect and lets the vertex shader expand it, rather than
+    // writing all eight vertices of each rect on the CPU.
+    void drawInstanced(Target* target) {
+        bool usesLocalCoords = fHelper.usesLocalCoords();
+        sk_sp<AAFillRectGeometryProcessor> gp(new AAFillRectGeometryProcessor(usesLocalCoords));
+        size_t instanceStride = gp->instanceStride();
+
+        sk_sp<const GrBuffer> indexBuffer = get_index_buffer(target->resourceProvider());
+        sk_sp<const GrBuffer> cornerBuffer = get_corner_buffer(target->resourceProvider());
+        const GrBuffer* instanceBuffer;
+        int baseInstance;
+        void* instances = target->makeVertexSpace(instanceStride, fRectCnt, &instanceBuffer,
+                                                  &baseInstance);
+        if (!instances || !indexBuffer || !cornerBuffer) {
+            SkDebugf("Could not allocate instances\n");
+            return;
+        }
+
+        const RectInfo* info = this->first();
+        for (int i = 0; i < fRectCnt; i++) {
+            intptr_t instance = reinterpret_cast<intptr_t>(instances) + i * instanceStride;
+            reinterpret_cast<AAFillRectGeometryProcessor::Instance*>(instance)->set(
+                    info->viewMatrix(), info->rect(), info->color());
+            if (usesLocalCoords) {
+                SkMatrix deviceToLocal;
+                if (!info->viewMatrix().invert(&deviceToLocal)) {
+                    SkDebugf("View matrix is non-invertible, local coords will be wrong.");
+                    deviceToLocal = SkMatrix::I();
+                }
+                if (info->hasLocalMatrix()) {
+                    deviceToLocal.postConcat(
+                            static_cast<const RectWithLocalMatrixInfo*>(info)->localMatrix());
+                }
+                reinterpret_cast<AAFillRectGeometryProcessor::LocalCoordsInstance*>(
+                        instance + sizeof(AAFillRectGeometryProcessor::Instance))
+                        ->set(deviceToLocal);
+            }
+            info = this->next(info);
+        }
+
+        GrMesh* mesh = target->allocMesh(GrPrimitiveType::kTriangles);
+        mesh->setIndexedInstanced(indexBuffer.get(), kIndicesPerAAFillRect, instanceBuffer,
+                                  fRectCnt, baseInstance, GrPrimitiveRestart::kNo);
+        mesh->setVertexData(cornerBuffer.get());
+        auto pipe = fHelper.makePipeline(target);
+        target->draw(std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState, mesh);
+    }
+
     void onPrepareDraws(Target* target) override {
         using namespace GrDefaultGeoProcFactory;
 
+        if (target->caps().instanceAttribSupport()) {
+            this->drawInstanced(target);
+            return;
+        }
+
         size_t vertexStride = sizeof(SkPoint) + sizeof(GrColor);
         Color color(Color::kPremulGrColorAttribute_Type);
         Coverage::Type coverageType = Coverage::kSolid_Type;
@@ -27,6 +27,12 @@
 #include "SkStroke.h"
 #include "SkTemplates.h"
 #include "effects/GrBezierEffect.h"
+#include "glsl/GrGLSLFragmentShaderBuilder.h"
+#include "glsl/GrGLSLGeometryProcessor.h"
+#include "glsl/GrGLSLProgramDataManager.h"
+#include "glsl/GrGLSLUniformHandler.h"
+#include "glsl/GrGLSLVarying.h"
+#include "glsl/GrGLSLVertexGeoBuilder.h"
 #include "ops/GrMeshDrawOp.h"
 
 #define PREALLOC_PTARRAY(N) SkSTArray<(N),SkPoint, true>
@@ -75,6 +81,17 @@ static sk_sp<const GrBuffer> get_quads_index_buffer(GrResourceProvider* resource
         gQuadsIndexBufferKey);
 }
 
+// When instancing is supported, quads are drawn as instances of the five vertices above. Each
+// vertex only knows which of a0, a1, b0, c0, c1 it is; the vertex shader finds its position.
+static constexpr float kQuadCorners[kQuadNumVertices] = { 0, 1, 2, 3, 4 };
+GR_DECLARE_STATIC_UNIQUE_KEY(gQuadCornersBufferKey);
+
+static sk_sp<const GrBuffer> get_quad_corners_buffer(GrResourceProvider* resourceProvider) {
+    GR_DEFINE_STATIC_UNIQUE_KEY(gQuadCornersBufferKey);
+    return resourceProvider->findOrMakeStaticBuffer(kVertex_GrBufferType, sizeof(kQuadCorners),
+                                                    kQuadCorners, gQuadCornersBufferKey);
+}
+
 
 // Each line segment is rendered as two quads and two triangles.
 // p0 and p1 have alpha = 1 while all other points have alpha = 0.
@@ -774,6 +791,187 @@ bool check_bounds(const SkMatrix& viewMatrix, const SkRect& devBounds, void* ver
 
 namespace {
 
+/**
+ * Draws the pieces of subdivided hairline quads without the CPU chopping, bloating or computing
+ * UVs for any of them. Each instance holds a device space quad and the [t0, t1] range of one of
+ * its pieces. The vertex shader finds the piece's control points by blossoming, and then does
+ * what bloat_quad() and set_uv_quad() do on the CPU. Coverage is computed as in GrQuadEffect.
+ */
+class HairlineQuadGeometryProcessor : public GrGeometryProcessor {
+public:
+    struct Instance {
+        SkPoint fPts[3];
+        float   fT0;
+        float   fT1;
+    };
+
+    HairlineQuadGeometryProcessor(GrColor color, uint8_t coverage, const SkMatrix& localMatrix,
+                                  bool usesLocalCoords)
+            : INHERITED(kHairlineQuadGeometryProcessor_ClassID)
+            , fColor(color)
+            , fCoverageScale(coverage)
+            , fLocalMatrix(localMatrix)
+            , fUsesLocalCoords(usesLocalCoords) {
+        this->setVertexAttributeCnt(1);
+        this->setInstanceAttributeCnt(kNumInstanceAttribs);
+        SkASSERT(this->debugOnly_instanceStride() == sizeof(Instance));
+    }
+
+    const char* name() const override { return "HairlineQuadGeometryProcessor"; }
+
+    void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
+        uint32_t key = 0xff != fCoverageScale ? 0x1 : 0x0;
+        key |= fUsesLocalCoords && fLocalMatrix.hasPerspective() ? 0x2 : 0x0;
+        b->add32(key);
+    }
+
+    GrGLSLPrimitiveProcessor* createGLSLInstance(const GrShaderCaps&) const override {
+        return new GLSLProcessor();
+    }
+
+private:
+    class GLSLProcessor : public GrGLSLGeometryProcessor {
+    public:
+        GLSLProcessor() : fColor(GrColor_ILLEGAL), fCoverageScale(0xff) {}
+
+        void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+            const HairlineQuadGeometryProcessor& proc =
+                    args.fGP.cast<HairlineQuadGeometryProcessor>();
+            GrGLSLVertexBuilder* v = args.fVertBuilder;
+            GrGLSLFPFragmentBuilder* f = args.fFragBuilder;
+            GrGLSLVaryingHandler* varyingHandler = args.fVaryingHandler;
+            GrGLSLUniformHandler* uniformHandler = args.fUniformHandler;
+
+            varyingHandler->emitAttributes(proc);
+            this->setupUniformColor(f, uniformHandler, args.fOutputColor, &fColorUniform);
+
+            // The control points of the piece over [t0, t1] are the blossoms B(t0, t0),
+            // B(t0, t1) and B(t1, t1). These match what repeated SkChopQuadAtHalf() produces.
+            v->codeAppendf("float2 p0 = %s, p1 = %s, p2 = %s;", kInstanceAttribs[0].name(),
+                           kInstanceAttribs[1].name(), kInstanceAttribs[2].name());
+            v->codeAppendf("float2 t = %s;", kInstanceAttribs[3].name());
+            v->codeAppend ("float2 q0 = mix(p0, p1, t.x), q1 = mix(p1, p2, t.x);");
+            v->codeAppend ("float2 r0 = mix(p0, p1, t.y), r1 = mix(p1, p2, t.y);");
+            v->codeAppend ("float2 a = mix(q0, q1, t.x);");
+            v->codeAppend ("float2 b = mix(q0, q1, t.y);");
+            v->codeAppend ("float2 c = mix(r0, r1, t.y);");
+
+            // Bloat the piece's hull exactly as bloat_quad() does.
+            v->codeAppend ("float2 ab = b - a, ac = c - a, cb = b - c;");
+            v->codeAppend ("float2 abN = normalize(float2(ab.y, -ab.x));");
+            v->codeAppend ("if (dot(abN, ac) > 0.0) { abN = -abN; }");
+            v->codeAppend ("float2 cbN = normalize(float2(cb.y, -cb.x));");
+            v->codeAppend ("if (dot(cbN, ac) < 0.0) { cbN = -cbN; }");
+            v->codeAppendf("float corner = %s;", kInCorner.name());
+            v->codeAppend ("float2 devPos;");
+            v->codeAppend ("if (corner < 0.5) {");
+            v->codeAppend (    "devPos = a + abN;");
+            v->codeAppend ("} else if (corner < 1.5) {");
+            v->codeAppend (    "devPos = a - abN;");
+            v->codeAppend ("} else if (corner < 2.5) {");
+            v->codeAppend (    "float2 a0 = a + abN, c0 = c + cbN;");
+            v->codeAppend (    "float lineAW = -dot(abN, a0), lineBW = -dot(cbN, c0);");
+            v->codeAppend (    "float w = abN.x * cbN.y - abN.y * cbN.x;");
+            v->codeAppend (    "devPos = 0.0 != w ? float2(abN.y * lineBW - lineAW * cbN.y,");
+            v->codeAppend (                               "lineAW * cbN.x - abN.x * lineBW) / w");
+            v->codeAppend (                   ": (a0 + c0) * 0.5 + abN;");
+            v->codeAppend ("} else if (corner < 3.5) {");
+            v->codeAppend (    "devPos = c + cbN;");
+            v->codeAppend ("} else {");
+            v->codeAppend (    "devPos = c - cbN;");
+            v->codeAppend ("}");
+            gpArgs->fPositionVar.set(kFloat2_GrSLType, "devPos");
+
+            // Map to the canonical quad's (u, v) as GrPathUtils::QuadUVMatrix does, relative to a
+            // for precision. Flat pieces get (0, distance to their longest edge) instead.
+            GrGLSLVarying uv(kHalf4_GrSLType);
+            varyingHandler->addVarying("HairQuadEdge", &uv);
+            v->codeAppend ("float2 d = devPos - a;");
+            v->codeAppend ("float det = ab.x * ac.y - ab.y * ac.x;");
+            v->codeAppend ("float2 quadCoord;");
+            v->codeAppend ("if (abs(det) > 1e-6) {");
+            v->codeAppend (    "float s = (ac.y * d.x - ac.x * d.y) / det;");
+            v->codeAppend (    "float r = (ab.x * d.y - ab.y * d.x) / det;");
+            v->codeAppend (    "quadCoord = float2(0.5 * s + r, r);");
+            v->codeAppend ("} else {");
+            v->codeAppend (    "float2 edge = dot(ab, ab) > dot(ac, ac) ? ab : ac;");
+            v->codeAppend (    "quadCoord = float2(0, dot(float2(edge.y, -edge.x), d));");
+            v->codeAppend ("}");
+            v->codeAppendf("%s = half4(half2(quadCoord), 0, 0);", uv.vsOut());
+
+            this->emitTransforms(v, varyingHandler, uniformHandler,
+                                 GrShaderVar("devPos", kFloat2_GrSLType), proc.fLocalMatrix,
+                                 args.fFPCoordTransformHandler);
+
+            f->codeAppendf("half2 duvdx = dFdx(%s.xy);", uv.fsIn());
+            f->codeAppendf("half2 duvdy = dFdy(%s.xy);", uv.fsIn());
+            f->codeAppendf("half2 gF = half2(2.0 * %s.x * duvdx.x - duvdx.y,"
+                           "               2.0 * %s.x * duvdy.x - duvdy.y);",
+                           uv.fsIn(), uv.fsIn());
+            f->codeAppendf("half edgeAlpha = (%s.x * %s.x - %s.y);",
+                           uv.fsIn(), uv.fsIn(), uv.fsIn());
+            f->codeAppend ("edgeAlpha = sqrt(edgeAlpha * edgeAlpha / dot(gF, gF));");
+            f->codeAppend ("edgeAlpha = max(1.0 - edgeAlpha, 0.0);");
+            if (0xff != proc.fCoverageScale) {
+                const char* coverageScale;
+                fCoverageScaleUniform = uniformHandler->addUniform(kFragment_GrShaderFlag,
+                                                                   kHalf_GrSLType, "Coverage",
+                                                                   &coverageScale);
+                f->codeAppendf("%s = half4(%s * edgeAlpha);", args.fOutputCoverage,
+                               coverageScale);
+            } else {
+                f->codeAppendf("%s = half4(edgeAlpha);", args.fOutputCoverage);
+            }
+        }
+
+        void setData(const GrGLSLProgramDataManager& pdman, const GrPrimitiveProcessor& primProc,
+                     FPCoordTransformIter&& transformIter) override {
+            const HairlineQuadGeometryProcessor& proc =
+                    primProc.cast<HairlineQuadGeometryProcessor>();
+            if (proc.fColor != fColor) {
+                float c[4];
+                GrColorToRGBAFloat(proc.fColor, c);
+                pdman.set4fv(fColorUniform, 1, c);
+                fColor = proc.fColor;
+            }
+            if (0xff != proc.fCoverageScale && proc.fCoverageScale != fCoverageScale) {
+                pdman.set1f(fCoverageScaleUniform, GrNormalizeByteToFloat(proc.fCoverageScale));
+                fCoverageScale = proc.fCoverageScale;
+            }
+            this->setTransformDataHelper(proc.fLocalMatrix, pdman, &transformIter);
+        }
+
+    private:
+        GrColor fColor;
+        uint8_t fCoverageScale;
+        UniformHandle fColorUniform;
+        UniformHandle fCoverageScaleUniform;
+
+        typedef GrGLSLGeometryProcessor INHERITED;
+    };
+
+    const Attribute& onVertexAttribute(int) const override { return kInCorner; }
+    const Attribute& onInstanceAttribute(int i) const override { return kInstanceAttribs[i]; }
+
+    static constexpr int kNumInstanceAttribs = 4;
+    static constexpr Attribute kInCorner = {"inCorner", kFloat_GrVertexAttribType, kFloat_GrSLType};
+    static constexpr Attribute kInstanceAttribs[kNumInstanceAttribs] = {
+            {"inP0", kFloat2_GrVertexAttribType, kFloat2_GrSLType},
+            {"inP1", kFloat2_GrVertexAttribType, kFloat2_GrSLType},
+            {"inP2", kFloat2_GrVertexAttribType, kFloat2_GrSLType},
+            {"inT", kFloat2_GrVertexAttribType, kFloat2_GrSLType}
+    };
+
+    GrColor  fColor;
+    uint8_t  fCoverageScale;
+    SkMatrix fLocalMatrix;
+    bool     fUsesLocalCoords;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+constexpr GrPrimitiveProcessor::Attribute HairlineQuadGeometryProcessor::kInCorner;
+constexpr GrPrimitiveProcessor::Attribute HairlineQuadGeometryProcessor::kInstanceAttribs[];
+
 class AAHairlineOp final : public GrMeshDrawOp {
 private:
     using Helper = GrSimpleMeshDrawOpHelperWithStencil;
@@ -996,6 +1194,49 @@ void AAHairlineOp::onPrepareDraws(Target* target) {
         target->draw(std::move(lineGP), pipe.fPipeline, pipe.fFixedDynamicState, mesh);
     }
 
+    // Without perspective the quads are already in device space, and the GPU can do all the work
+    // of subdividing them.
+    if (quadCount && !hasPerspective && target->caps().instanceAttribSupport()) {
+        sk_sp<GrGeometryProcessor> quadGP(new HairlineQuadGeometryProcessor(
+                this->color(), this->coverage(), *geometryProcessorLocalM,
+                fHelper.usesLocalCoords()));
+
+        sk_sp<const GrBuffer> quadsIndexBuffer = get_quads_index_buffer(target->resourceProvider());
+        sk_sp<const GrBuffer> cornersBuffer = get_quad_corners_buffer(target->resourceProvider());
+        const GrBuffer* instanceBuffer;
+        int baseInstance;
+        auto* instances = reinterpret_cast<HairlineQuadGeometryProcessor::Instance*>(
+                target->makeVertexSpace(sizeof(HairlineQuadGeometryProcessor::Instance), quadCount,
+                                        &instanceBuffer, &baseInstance));
+        if (!instances || !quadsIndexBuffer || !cornersBuffer) {
+            SkDebugf("Could not allocate instances\n");
+            return;
+        }
+
+        int unsubdivQuadCnt = quads.count() / 3;
+        for (int i = 0; i < unsubdivQuadCnt; ++i) {
+            SkASSERT(qSubdivs[i] >= 0);
+            int pieceCnt = 1 << qSubdivs[i];
+            float dt = 1.f / pieceCnt;
+            for (int j = 0; j < pieceCnt; ++j) {
+                memcpy(instances->fPts, &quads[3*i], sizeof(instances->fPts));
+                instances->fT0 = j * dt;
+                instances->fT1 = (j + 1) * dt;
+                ++instances;
+            }
+        }
+
+        GrMesh* mesh = target->allocMesh(GrPrimitiveType::kTriangles);
+        mesh->setIndexedInstanced(quadsIndexBuffer.get(), kIdxsPerQuad, instanceBuffer, quadCount,
+                                  baseInstance, GrPrimitiveRestart::kNo);
+        mesh->setVertexData(cornersBuffer.get());
+        target->draw(std::move(quadGP), pipe.fPipeline, pipe.fFixedDynamicState, mesh);
+
+        quads.reset();
+        quadAndConicCount -= quadCount;
+        quadCount = 0;
+    }
+
     if (quadCount || conicCount) {
         sk_sp<GrGeometryProcessor> quadGP(GrQuadEffect::Make(this->color(),
                                                              *geometryProcessorViewM,
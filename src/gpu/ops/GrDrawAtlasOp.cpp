@@ -8,10 +8,16 @@
 #include "GrDrawAtlasOp.h"
 #include "GrDrawOpTest.h"
 #include "GrOpFlushState.h"
+#include "GrResourceProvider.h"
 #include "SkGr.h"
 #include "SkRSXform.h"
 #include "SkRandom.h"
 #include "SkRectPriv.h"
+#include "glsl/GrGLSLFragmentShaderBuilder.h"
+#include "glsl/GrGLSLGeometryProcessor.h"
+#include "glsl/GrGLSLUtil.h"
+#include "glsl/GrGLSLVarying.h"
+#include "glsl/GrGLSLVertexGeoBuilder.h"
 
 static sk_sp<GrGeometryProcessor> make_gp(const GrShaderCaps* shaderCaps,
                                           bool hasColors,
@@ -27,6 +33,133 @@ static sk_sp<GrGeometryProcessor> make_gp(const GrShaderCaps* shaderCaps,
                                          LocalCoords::kHasExplicit_Type, viewMatrix);
 }
 
+// When instancing is supported each sprite is drawn as an instance of this strip, in the same
+// order as SkRSXform::toTriStrip(): the corners of the sprite in units of its size.
+static constexpr float kSpriteCorners[4 * 2] = {
+    0, 0,    0, 1,    1, 0,    1, 1,
+};
+
+GR_DECLARE_STATIC_UNIQUE_KEY(gSpriteCornerBufferKey);
+
+static sk_sp<const GrBuffer> get_corner_buffer(GrResourceProvider* resourceProvider) {
+    GR_DEFINE_STATIC_UNIQUE_KEY(gSpriteCornerBufferKey);
+    return resourceProvider->findOrMakeStaticBuffer(kVertex_GrBufferType,
+                                                    sizeof(kSpriteCorners),
+                                                    kSpriteCorners,
+                                                    gSpriteCornerBufferKey);
+}
+
+namespace {
+
+/**
+ * Expands a per-sprite instance (its RSXform, tex rect and color) into the four vertices
+ * GrDrawAtlasOp otherwise writes on the CPU. The view matrix is a uniform.
+ */
+class AtlasSpriteGeometryProcessor : public GrGeometryProcessor {
+public:
+    struct Instance {
+        SkRSXform fXform;
+        SkRect    fTex;
+        GrColor   fColor;
+    };
+
+    explicit AtlasSpriteGeometryProcessor(const SkMatrix& viewMatrix)
+            : INHERITED(kAtlasSpriteGeometryProcessor_ClassID)
+            , fViewMatrix(viewMatrix) {
+        this->setVertexAttributeCnt(1);
+        this->setInstanceAttributeCnt(kNumInstanceAttribs);
+        SkASSERT(this->debugOnly_instanceAttributeOffset(1) == offsetof(Instance, fTex));
+        SkASSERT(this->debugOnly_instanceAttributeOffset(2) == offsetof(Instance, fColor));
+        SkASSERT(this->debugOnly_instanceStride() == sizeof(Instance));
+    }
+
+    const char* name() const override { return "AtlasSpriteGeometryProcessor"; }
+
+    void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
+        GLSLProcessor::GenKey(*this, b);
+    }
+
+    GrGLSLPrimitiveProcessor* createGLSLInstance(const GrShaderCaps&) const override {
+        return new GLSLProcessor();
+    }
+
+private:
+    class GLSLProcessor : public GrGLSLGeometryProcessor {
+    public:
+        GLSLProcessor() : fViewMatrix(SkMatrix::InvalidMatrix()) {}
+
+        static void GenKey(const AtlasSpriteGeometryProcessor& gp, GrProcessorKeyBuilder* b) {
+            b->add32(ComputePosKey(gp.fViewMatrix));
+        }
+
+        void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+            const AtlasSpriteGeometryProcessor& proc =
+                    args.fGP.cast<AtlasSpriteGeometryProcessor>();
+            GrGLSLVertexBuilder* v = args.fVertBuilder;
+            GrGLSLVaryingHandler* varyingHandler = args.fVaryingHandler;
+
+            varyingHandler->emitAttributes(proc);
+            varyingHandler->addPassThroughAttribute(
+                    kInstanceAttribs[2], args.fOutputColor,
+                    GrGLSLVaryingHandler::Interpolation::kCanBeFlat);
+
+            v->codeAppendf("float4 xform = %s;", kInstanceAttribs[0].name());
+            v->codeAppendf("float4 tex = %s;", kInstanceAttribs[1].name());
+            v->codeAppendf("float2 extent = %s * (tex.zw - tex.xy);", kInCorner.name());
+            // xform is (scos, ssin, tx, ty).
+            v->codeAppend ("float2 position = float2(xform.x * extent.x - xform.y * extent.y, "
+                                                    "xform.y * extent.x + xform.x * extent.y) + "
+                                             "xform.zw;");
+            v->codeAppend ("float2 localCoord = tex.xy + extent;");
+            this->writeOutputPosition(v, args.fUniformHandler, gpArgs, "position",
+                                      proc.fViewMatrix, &fViewMatrixUniform);
+            this->emitTransforms(v, varyingHandler, args.fUniformHandler,
+                                 GrShaderVar("localCoord", kFloat2_GrSLType),
+                                 args.fFPCoordTransformHandler);
+
+            args.fFragBuilder->codeAppendf("%s = half4(1);", args.fOutputCoverage);
+        }
+
+        void setData(const GrGLSLProgramDataManager& pdman, const GrPrimitiveProcessor& gp,
+                     FPCoordTransformIter&& transformIter) override {
+            const AtlasSpriteGeometryProcessor& proc = gp.cast<AtlasSpriteGeometryProcessor>();
+            if (!proc.fViewMatrix.isIdentity() && !fViewMatrix.cheapEqualTo(proc.fViewMatrix)) {
+                fViewMatrix = proc.fViewMatrix;
+                float viewMatrix[3 * 3];
+                GrGLSLGetMatrix<3>(viewMatrix, fViewMatrix);
+                pdman.setMatrix3f(fViewMatrixUniform, viewMatrix);
+            }
+            this->setTransformDataHelper(SkMatrix::I(), pdman, &transformIter);
+        }
+
+    private:
+        SkMatrix fViewMatrix;
+        UniformHandle fViewMatrixUniform;
+
+        typedef GrGLSLGeometryProcessor INHERITED;
+    };
+
+    const Attribute& onVertexAttribute(int) const override { return kInCorner; }
+    const Attribute& onInstanceAttribute(int i) const override { return kInstanceAttribs[i]; }
+
+    static constexpr int kNumInstanceAttribs = 3;
+    static constexpr Attribute kInCorner =
+            {"inCorner", kFloat2_GrVertexAttribType, kFloat2_GrSLType};
+    static constexpr Attribute kInstanceAttribs[kNumInstanceAttribs] = {
+            {"inXform", kFloat4_GrVertexAttribType, kFloat4_GrSLType},
+            {"inTex", kFloat4_GrVertexAttribType, kFloat4_GrSLType},
+            {"inColor", kUByte4_norm_GrVertexAttribType, kHalf4_GrSLType},
+    };
+
+    SkMatrix fViewMatrix;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+constexpr GrPrimitiveProcessor::Attribute AtlasSpriteGeometryProcessor::kInCorner;
+constexpr GrPrimitiveProcessor::Attribute AtlasSpriteGeometryProcessor::kInstanceAttribs[];
+
+}  // anonymous namespace
+
 GrDrawAtlasOp::GrDrawAtlasOp(const Helper::MakeArgs& helperArgs, GrColor color,
                              const SkMatrix& viewMatrix, GrAAType aaType, int spriteCount,
                              const SkRSXform* xforms, const SkRect* rects, const SkColor* colors)
@@ -37,72 +170,35 @@ GrDrawAtlasOp::GrDrawAtlasOp(const Helper::MakeArgs& helperArgs, GrColor color,
     fViewMatrix = viewMatrix;
     Geometry& installedGeo = fGeoData.push_back();
     installedGeo.fColor = color;
-
-    // Figure out stride and offsets
-    // Order within the vertex is: position [color] texCoord
-    size_t texOffset = sizeof(SkPoint);
-    size_t vertexStride = 2 * sizeof(SkPoint);
     fHasColors = SkToBool(colors);
-    if (colors) {
-        texOffset += sizeof(GrColor);
-        vertexStride += sizeof(GrColor);
-    }
 
-    // Compute buffer size and alloc buffer
+    // Only record the sprites here. Their vertices (or instances) are written in onPrepareDraws(),
+    // once finalize() has settled whether the colors are needed.
     fQuadCount = spriteCount;
-    int allocSize = static_cast<int>(4 * vertexStride * spriteCount);
-    installedGeo.fVerts.reset(allocSize);
-    uint8_t* currVertex = installedGeo.fVerts.begin();
+    Sprite* sprites = installedGeo.fSprites.push_back_n(spriteCount);
 
     SkRect bounds = SkRectPriv::MakeLargestInverted();
     int paintAlpha = GrColorUnpackA(installedGeo.fColor);
     for (int spriteIndex = 0; spriteIndex < spriteCount; ++spriteIndex) {
-        // Transform rect
-        SkPoint strip[4];
-        const SkRect& currRect = rects[spriteIndex];
-        xforms[spriteIndex].toTriStrip(currRect.width(), currRect.height(), strip);
-
-        // Copy colors if necessary
+        Sprite& sprite = sprites[spriteIndex];
+        sprite.fXform = xforms[spriteIndex];
+        sprite.fTex = rects[spriteIndex];
+        sprite.fColor = color;
         if (colors) {
             // convert to GrColor
-            SkColor color = colors[spriteIndex];
+            SkColor spriteColor = colors[spriteIndex];
             if (paintAlpha != 255) {
-                color = SkColorSetA(color, SkMulDiv255Round(SkColorGetA(color), paintAlpha));
+                spriteColor = SkColorSetA(spriteColor,
+                                          SkMulDiv255Round(SkColorGetA(spriteColor), paintAlpha));
             }
-            GrColor grColor = SkColorToPremulGrColor(color);
-
-            *(reinterpret_cast<GrColor*>(currVertex + sizeof(SkPoint))) = grColor;
-            *(reinterpret_cast<GrColor*>(currVertex + vertexStride + sizeof(SkPoint))) = grColor;
-            *(reinterpret_cast<GrColor*>(currVertex + 2 * vertexStride + sizeof(SkPoint))) =
-                    grColor;
-            *(reinterpret_cast<GrColor*>(currVertex + 3 * vertexStride + sizeof(SkPoint))) =
-                    grColor;
+            sprite.fColor = SkColorToPremulGrColor(spriteColor);
         }
 
-        // Copy position and uv to verts
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[0];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fLeft, currRect.fTop);
-        SkRectPriv::GrowToInclude(&bounds, strip[0]);
-        currVertex += vertexStride;
-
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[1];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fLeft, currRect.fBottom);
-        SkRectPriv::GrowToInclude(&bounds, strip[1]);
-        currVertex += vertexStride;
-
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[2];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fRight, currRect.fTop);
-        SkRectPriv::GrowToInclude(&bounds, strip[2]);
-        currVertex += vertexStride;
-
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[3];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fRight, currRect.fBottom);
-        SkRectPriv::GrowToInclude(&bounds, strip[3]);
-        currVertex += vertexStride;
+        SkPoint strip[4];
+        sprite.fXform.toTriStrip(sprite.fTex.width(), sprite.fTex.height(), strip);
+        for (const SkPoint& pt : strip) {
+            SkRectPriv::GrowToInclude(&bounds, pt);
+        }
     }
 
     this->setTransformedBounds(bounds, viewMatrix, HasAABloat::kNo, IsZeroArea::kNo);
@@ -111,23 +207,66 @@ GrDrawAtlasOp::GrDrawAtlasOp(const Helper::MakeArgs& helperArgs, GrColor color,
 SkString GrDrawAtlasOp::dumpInfo() const {
     SkString string;
     for (const auto& geo : fGeoData) {
-        string.appendf("Color: 0x%08x, Quads: %d\n", geo.fColor, geo.fVerts.count() / 4);
+        string.appendf("Color: 0x%08x, Quads: %d\n", geo.fColor, geo.fSprites.count());
     }
     string += fHelper.dumpInfo();
     string += INHERITED::dumpInfo();
     return string;
 }
 
+// Writes one compact instance per sprite and lets the vertex shader expand it, rather than writing
+// all four vertices of each sprite on the CPU.
+void GrDrawAtlasOp::drawInstanced(Target* target, sk_sp<const GrBuffer> cornerBuffer) {
+    sk_sp<GrGeometryProcessor> gp(new AtlasSpriteGeometryProcessor(this->viewMatrix()));
+
+    using Instance = AtlasSpriteGeometryProcessor::Instance;
+    const GrBuffer* instanceBuffer;
+    int baseInstance;
+    void* instances = target->makeVertexSpace(sizeof(Instance), this->quadCount(),
+                                              &instanceBuffer, &baseInstance);
+    if (!instances) {
+        SkDebugf("Could not allocate instances\n");
+        return;
+    }
+
+    Instance* instance = reinterpret_cast<Instance*>(instances);
+    for (const Geometry& geo : fGeoData) {
+        for (const Sprite& sprite : geo.fSprites) {
+            instance->fXform = sprite.fXform;
+            instance->fTex = sprite.fTex;
+            instance->fColor = this->hasColors() ? sprite.fColor : this->color();
+            ++instance;
+        }
+    }
+
+    GrMesh* mesh = target->allocMesh(GrPrimitiveType::kTriangleStrip);
+    mesh->setInstanced(instanceBuffer, this->quadCount(), baseInstance, 4);
+    mesh->setVertexData(cornerBuffer.get());
+    auto pipe = fHelper.makePipeline(target);
+    target->draw(std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState, mesh);
+}
+
 void GrDrawAtlasOp::onPrepareDraws(Target* target) {
+    if (target->caps().instanceAttribSupport()) {
+        if (sk_sp<const GrBuffer> cornerBuffer = get_corner_buffer(target->resourceProvider())) {
+            this->drawInstanced(target, std::move(cornerBuffer));
+            return;
+        }
+    }
+
     // Setup geometry processor
     sk_sp<GrGeometryProcessor> gp(make_gp(target->caps().shaderCaps(),
                                           this->hasColors(),
                                           this->color(),
                                           this->viewMatrix()));
 
-    int instanceCount = fGeoData.count();
-    size_t vertexStride =
-            sizeof(SkPoint) + sizeof(SkPoint) + (this->hasColors() ? sizeof(GrColor) : 0);
+    // Order within the vertex is: position [color] texCoord
+    size_t texOffset = sizeof(SkPoint);
+    size_t vertexStride = 2 * sizeof(SkPoint);
+    if (this->hasColors()) {
+        texOffset += sizeof(GrColor);
+        vertexStride += sizeof(GrColor);
+    }
     SkASSERT(vertexStride == gp->debugOnly_vertexStride());
 
     int numQuads = this->quadCount();
@@ -138,13 +277,27 @@ void GrDrawAtlasOp::onPrepareDraws(Target* target) {
         return;
     }
 
-    uint8_t* vertPtr = reinterpret_cast<uint8_t*>(verts);
-    for (int i = 0; i < instanceCount; i++) {
-        const Geometry& args = fGeoData[i];
-
-        size_t allocSize = args.fVerts.count();
-        memcpy(vertPtr, args.fVerts.begin(), allocSize);
-        vertPtr += allocSize;
+    uint8_t* currVertex = reinterpret_cast<uint8_t*>(verts);
+    for (const Geometry& geo : fGeoData) {
+        for (const Sprite& sprite : geo.fSprites) {
+            SkPoint strip[4];
+            const SkRect& currRect = sprite.fTex;
+            sprite.fXform.toTriStrip(currRect.width(), currRect.height(), strip);
+            const SkPoint texStrip[4] = {
+                {currRect.fLeft, currRect.fTop},
+                {currRect.fLeft, currRect.fBottom},
+                {currRect.fRight, currRect.fTop},
+                {currRect.fRight, currRect.fBottom},
+            };
+            for (int i = 0; i < 4; ++i) {
+                *(reinterpret_cast<SkPoint*>(currVertex)) = strip[i];
+                if (this->hasColors()) {
+                    *(reinterpret_cast<GrColor*>(currVertex + sizeof(SkPoint))) = sprite.fColor;
+                }
+                *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) = texStrip[i];
+                currVertex += vertexStride;
+            }
+        }
     }
     auto pipe = fHelper.makePipeline(target);
     helper.recordDraw(target, std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState);
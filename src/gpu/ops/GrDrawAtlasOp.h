@@ -12,6 +12,7 @@
 #include "GrDefaultGeoProcFactory.h"
 #include "GrMeshDrawOp.h"
 #include "GrSimpleMeshDrawOpHelper.h"
+#include "SkRSXform.h"
 
 class GrDrawAtlasOp final : public GrMeshDrawOp {
 private:
@@ -58,11 +59,20 @@ private:
 
     CombineResult onCombineIfPossible(GrOp* t, const GrCaps&) override;
 
+    // What each sprite needs, whether it is drawn as an instance or as four vertices.
+    struct Sprite {
+        SkRSXform fXform;
+        SkRect    fTex;
+        GrColor   fColor;  // Premul, with the paint alpha applied. Unused without colors.
+    };
+
     struct Geometry {
         GrColor fColor;
-        SkTArray<uint8_t, true> fVerts;
+        SkTArray<Sprite, true> fSprites;
     };
 
+    void drawInstanced(Target*, sk_sp<const GrBuffer> cornerBuffer);
+
     SkSTArray<1, Geometry, true> fGeoData;
     Helper fHelper;
     SkMatrix fViewMatrix;
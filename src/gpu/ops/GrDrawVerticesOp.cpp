@@ -9,6 +9,7 @@
 #include "GrCaps.h"
 #include "GrDefaultGeoProcFactory.h"
 #include "GrOpFlushState.h"
+#include "SkAutoMalloc.h"
 #include "SkGr.h"
 #include "SkRectPriv.h"
 
@@ -207,8 +208,7 @@ sk_sp<GrGeometryProcessor> GrDrawVerticesOp::makeGP(const GrShaderCaps* shaderCa
 }
 
 void GrDrawVerticesOp::onPrepareDraws(Target* target) {
-    bool hasMapBufferSupport = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
-    if (fMeshes[0].fVertices->isVolatile() || !hasMapBufferSupport) {
+    if (fMeshes[0].fVertices->isVolatile()) {
         this->drawVolatile(target);
     } else {
         this->drawNonVolatile(target);
@@ -275,17 +275,28 @@ void GrDrawVerticesOp::drawNonVolatile(Target* target) {
                                                  &hasBoneAttribute);
 
     SkASSERT(fMeshes.count() == 1); // Non-volatile meshes should never combine.
+    const Mesh& mesh = fMeshes[0];
 
     // Get the resource provider.
     GrResourceProvider* rp = target->resourceProvider();
 
-    // Generate keys for the buffers.
+    // Generate keys for the buffers. The same SkVertices can be drawn with paints that need
+    // different attributes, so the vertex buffer's layout is part of its key. So is the paint
+    // color when it has to be written into every vertex.
+    bool bakesPaintColor = hasColorAttribute && !mesh.hasPerVertexColors();
     GrUniqueKey vertexKey, indexKey;
-    GrUniqueKey::Builder vertexKeyBuilder(&vertexKey, kDomain, 2);
+    GrUniqueKey::Builder vertexKeyBuilder(&vertexKey, kDomain, bakesPaintColor ? 3 : 2);
     GrUniqueKey::Builder indexKeyBuilder(&indexKey, kDomain, 2);
-    vertexKeyBuilder[0] = indexKeyBuilder[0] = fMeshes[0].fVertices->uniqueID();
-    vertexKeyBuilder[1] = 0;
-    indexKeyBuilder[1] = 1;
+    vertexKeyBuilder[0] = indexKeyBuilder[0] = mesh.fVertices->uniqueID();
+    vertexKeyBuilder[1] = 0x01 |
+                          (hasColorAttribute             ? 0x02 : 0) |
+                          (hasLocalCoordsAttribute       ? 0x04 : 0) |
+                          (hasBoneAttribute              ? 0x08 : 0) |
+                          (mesh.hasExplicitLocalCoords() ? 0x10 : 0);
+    if (bakesPaintColor) {
+        vertexKeyBuilder[2] = mesh.fColor;
+    }
+    indexKeyBuilder[1] = 0;
     vertexKeyBuilder.finish();
     indexKeyBuilder.finish();
 
@@ -308,48 +319,86 @@ void GrDrawVerticesOp::drawNonVolatile(Target* target) {
                           (hasBoneAttribute ? 4 * (sizeof(int8_t) + sizeof(uint8_t)) : 0);
     SkASSERT(vertexStride == gp->debugOnly_vertexStride());
 
-    // Allocate vertex buffer.
-    vertexBuffer.reset(rp->createBuffer(fVertexCount * vertexStride,
-                                        kVertex_GrBufferType,
-                                        kStatic_GrAccessPattern,
-                                        GrResourceProvider::Flags::kNone));
-    void* verts = vertexBuffer ? vertexBuffer->map() : nullptr;
-    if (!verts) {
-        SkDebugf("Could not allocate vertices\n");
-        return;
-    }
-
-    // Allocate index buffer.
-    uint16_t* indices = nullptr;
-    if (this->isIndexed()) {
-        indexBuffer.reset(rp->createBuffer(fIndexCount * sizeof(uint16_t),
-                                           kIndex_GrBufferType,
-                                           kStatic_GrAccessPattern,
-                                           GrResourceProvider::Flags::kNone));
-        indices = indexBuffer ? static_cast<uint16_t*>(indexBuffer->map()) : nullptr;
-        if (!indices) {
-            SkDebugf("Could not allocate indices\n");
+    // The indices don't depend on the vertex layout, so they may well be in the cache already.
+    size_t vertexSize = fVertexCount * vertexStride;
+    size_t indexSize = (!this->isIndexed() || indexBuffer) ? 0 : fIndexCount * sizeof(uint16_t);
+
+    if (GrCaps::kNone_MapFlags != target->caps().mapBufferFlags()) {
+        // Allocate and map the buffers.
+        vertexBuffer.reset(rp->createBuffer(vertexSize,
+                                            kVertex_GrBufferType,
+                                            kStatic_GrAccessPattern,
+                                            GrResourceProvider::Flags::kNone));
+        void* verts = vertexBuffer ? vertexBuffer->map() : nullptr;
+        if (!verts) {
+            SkDebugf("Could not allocate vertices\n");
             return;
         }
-    }
+        uint16_t* indices = nullptr;
+        if (indexSize) {
+            indexBuffer.reset(rp->createBuffer(indexSize,
+                                               kIndex_GrBufferType,
+                                               kStatic_GrAccessPattern,
+                                               GrResourceProvider::Flags::kNone));
+            indices = indexBuffer ? static_cast<uint16_t*>(indexBuffer->map()) : nullptr;
+            if (!indices) {
+                SkDebugf("Could not allocate indices\n");
+                return;
+            }
+        }
 
-    // Fill the buffers.
-    this->fillBuffers(hasColorAttribute,
-                      hasLocalCoordsAttribute,
-                      hasBoneAttribute,
-                      vertexStride,
-                      verts,
-                      indices);
+        // Fill the buffers.
+        this->fillBuffers(hasColorAttribute,
+                          hasLocalCoordsAttribute,
+                          hasBoneAttribute,
+                          vertexStride,
+                          verts,
+                          indices);
 
-    // Unmap the buffers.
-    vertexBuffer->unmap();
-    if (indexBuffer) {
-        indexBuffer->unmap();
+        // Unmap the buffers.
+        vertexBuffer->unmap();
+        if (indices) {
+            indexBuffer->unmap();
+        }
+    } else {
+        // Without mapping, fill the buffers in system memory and upload them when creating them.
+        SkAutoMalloc storage(vertexSize + indexSize);
+        void* verts = storage.get();
+        uint16_t* indices = indexSize ? (uint16_t*)((char*)storage.get() + vertexSize) : nullptr;
+        this->fillBuffers(hasColorAttribute,
+                          hasLocalCoordsAttribute,
+                          hasBoneAttribute,
+                          vertexStride,
+                          verts,
+                          indices);
+        vertexBuffer.reset(rp->createBuffer(vertexSize,
+                                            kVertex_GrBufferType,
+                                            kStatic_GrAccessPattern,
+                                            GrResourceProvider::Flags::kNone,
+                                            verts));
+        if (!vertexBuffer) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+        if (indices) {
+            indexBuffer.reset(rp->createBuffer(indexSize,
+                                               kIndex_GrBufferType,
+                                               kStatic_GrAccessPattern,
+                                               GrResourceProvider::Flags::kNone,
+                                               indices));
+            if (!indexBuffer) {
+                SkDebugf("Could not allocate indices\n");
+                return;
+            }
+        }
     }
 
-    // Cache the buffers.
+    // Cache the buffers. They are budgeted, so the cache purges them like any other resource
+    // once the SkVertices stops being drawn.
     rp->assignUniqueKeyToResource(vertexKey, vertexBuffer.get());
-    rp->assignUniqueKeyToResource(indexKey, indexBuffer.get());
+    if (indexSize) {
+        rp->assignUniqueKeyToResource(indexKey, indexBuffer.get());
+    }
 
     // Draw the vertices.
     this->drawVertices(target, std::move(gp), vertexBuffer.get(), 0, indexBuffer.get(), 0);
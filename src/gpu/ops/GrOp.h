@@ -166,6 +166,15 @@ public:
         return fUniqueID;
     }
 
+    /**
+     * Ops that do significant CPU-only work when preparing, like generating vertices, can do it in
+     * prePrepare() instead, into memory they own. It is called before prepare(), possibly on
+     * another thread concurrently with other ops' prePrepare(), so it must not touch the flush
+     * state or any GPU resources. prepare() must still work if prePrepare() wasn't called.
+     */
+    virtual bool canPrePrepare() const { return false; }
+    void prePrepare() { this->onPrePrepare(); }
+
     /**
      * Called prior to executing. The op should perform any resource creation or data transfers
      * necessary before execute() is called.
@@ -282,6 +291,7 @@ private:
         return CombineResult::kCannotCombine;
     }
 
+    virtual void onPrePrepare() {}
     virtual void onPrepare(GrOpFlushState*) = 0;
     virtual void onExecute(GrOpFlushState*) = 0;
 
@@ -22,6 +22,8 @@
 #include "SkPaint.h"
 #include "SkPointPriv.h"
 #include "SkRasterClip.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
 #include "effects/GrBitmapTextGeoProc.h"
 #include "effects/GrDistanceFieldGeoProc.h"
 #include "ops/GrMeshDrawOp.h"
@@ -218,6 +220,186 @@ GrPathRenderer::CanDrawPath GrSmallPathRenderer::onCanDrawPath(const CanDrawPath
 // padding around path bounds to allow for antialiased pixels
 static const SkScalar kAntiAliasPad = 1.0f;
 
+// Returns the dimension of the distance field generated for a shape drawn with a view matrix.
+static SkScalar df_desired_dimension(const SkRect& bounds, const SkMatrix& viewMatrix) {
+    // get mip level
+    SkScalar maxScale;
+    if (viewMatrix.hasPerspective()) {
+        // approximate the scale since we can't get it from the matrix
+        SkRect xformedBounds;
+        viewMatrix.mapRect(&xformedBounds, bounds);
+        maxScale = SkScalarAbs(SkTMax(xformedBounds.width() / bounds.width(),
+                                      xformedBounds.height() / bounds.height()));
+    } else {
+        maxScale = SkScalarAbs(viewMatrix.getMaxScale());
+    }
+    SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+    // We try to create the DF at a 2^n scaled path resolution (1/2, 1, 2, 4, etc.)
+    // In the majority of cases this will yield a crisper rendering.
+    SkScalar mipScale = 1.0f;
+    // Our mipscale is the maxScale clamped to the next highest power of 2
+    if (maxScale <= SK_ScalarHalf) {
+        SkScalar log = SkScalarFloorToScalar(SkScalarLog2(SkScalarInvert(maxScale)));
+        mipScale = SkScalarPow(2, -log);
+    } else if (maxScale > SK_Scalar1) {
+        SkScalar log = SkScalarCeilToScalar(SkScalarLog2(maxScale));
+        mipScale = SkScalarPow(2, log);
+    }
+    SkASSERT(maxScale <= mipScale);
+
+    SkScalar mipSize = mipScale*SkScalarAbs(maxDim);
+    // For sizes less than kIdealMinMIP we want to use as large a distance field as we can
+    // so we can preserve as much detail as possible. However, we can't scale down more
+    // than a 1/4 of the size without artifacts. So the idea is that we pick the mipsize
+    // just bigger than the ideal, and then scale down until we are no more than 4x the
+    // original mipsize.
+    if (mipSize < kIdealMinMIP) {
+        SkScalar newMipSize = mipSize;
+        do {
+            newMipSize *= 2;
+        } while (newMipSize < kIdealMinMIP);
+        while (newMipSize > 4 * mipSize) {
+            newMipSize *= 0.25f;
+        }
+        mipSize = newMipSize;
+    }
+    return SkTMin(mipSize, kMaxMIP);
+}
+
+// Where the pixels of a shape's distance field lie, for the scale it is generated at.
+struct DistanceFieldLayout {
+    DistanceFieldLayout(const SkRect& bounds, SkScalar scale) {
+        // generate bounding rect for bitmap draw
+        SkRect scaledBounds = bounds;
+        // scale to mip level size
+        scaledBounds.fLeft *= scale;
+        scaledBounds.fTop *= scale;
+        scaledBounds.fRight *= scale;
+        scaledBounds.fBottom *= scale;
+        // subtract out integer portion of origin
+        // (SDF created will be placed with fractional offset burnt in)
+        SkScalar dx = SkScalarFloorToScalar(scaledBounds.fLeft);
+        SkScalar dy = SkScalarFloorToScalar(scaledBounds.fTop);
+        scaledBounds.offset(-dx, -dy);
+        // get integer boundary
+        scaledBounds.roundOut(&fDevPathBounds);
+        // pad to allow room for antialiasing
+        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
+        // place devBounds at origin
+        int width = fDevPathBounds.width() + 2*intPad;
+        int height = fDevPathBounds.height() + 2*intPad;
+        fDevPathBounds = SkIRect::MakeWH(width, height);
+        fTranslateX = intPad - dx;
+        fTranslateY = intPad - dy;
+
+        // draw path to bitmap
+        fDrawMatrix.setScale(scale, scale);
+        fDrawMatrix.postTranslate(fTranslateX, fTranslateY);
+
+        SkASSERT(fDevPathBounds.fLeft == 0);
+        SkASSERT(fDevPathBounds.fTop == 0);
+        SkASSERT(fDevPathBounds.width() > 0);
+        SkASSERT(fDevPathBounds.height() > 0);
+
+        // setup signed distance field storage
+        SkIRect dfBounds = fDevPathBounds.makeOutset(SK_DistanceFieldPad, SK_DistanceFieldPad);
+        fWidth = dfBounds.width();
+        fHeight = dfBounds.height();
+    }
+
+    SkIRect  fDevPathBounds;
+    SkMatrix fDrawMatrix;
+    SkScalar fTranslateX;
+    SkScalar fTranslateY;
+    // The size of the distance field, including SK_DistanceFieldPad.
+    int      fWidth;
+    int      fHeight;
+};
+
+// Writes the distance field of a path into fWidth x fHeight bytes of storage.
+static bool generate_distance_field(unsigned char* dfStorage, const SkPath& path,
+                                    const DistanceFieldLayout& layout) {
+#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+    int width = layout.fWidth;
+    int height = layout.fHeight;
+    // Generate signed distance field directly from SkPath
+    bool succeed = GrGenerateDistanceFieldFromPath(dfStorage, path, layout.fDrawMatrix,
+                                                   width, height, width * sizeof(unsigned char));
+    if (!succeed) {
+#endif
+        // setup bitmap backing
+        SkAutoPixmapStorage dst;
+        if (!dst.tryAlloc(SkImageInfo::MakeA8(layout.fDevPathBounds.width(),
+                                              layout.fDevPathBounds.height()))) {
+            return false;
+        }
+        sk_bzero(dst.writable_addr(), dst.computeByteSize());
+
+        // rasterize path
+        SkPaint paint;
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setAntiAlias(true);
+
+        SkDraw draw;
+        sk_bzero(&draw, sizeof(draw));
+
+        SkRasterClip rasterClip;
+        rasterClip.setRect(layout.fDevPathBounds);
+        draw.fRC = &rasterClip;
+        draw.fMatrix = &layout.fDrawMatrix;
+        draw.fDst = dst;
+
+        draw.drawPathCoverage(path, paint);
+
+        // Generate signed distance field
+        SkGenerateDistanceFieldFromA8Image(dfStorage, (const unsigned char*)dst.addr(),
+                                           dst.width(), dst.height(), dst.rowBytes());
+#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+    }
+#endif
+    return true;
+}
+
+// A distance field generated on one of the context's worker threads while recording continues, so
+// that preparing the draw only has to upload it.
+class PendingDistanceField : public SkRefCnt {
+public:
+    PendingDistanceField(const GrShape& shape, uint32_t dimension, SkScalar scale)
+            : fDimension(dimension), fLayout(shape.bounds(), scale) {
+        shape.asPath(&fPath);
+    }
+
+    void run() {
+        if (fStorage.reset(fLayout.fWidth * fLayout.fHeight)) {
+            fSucceeded = generate_distance_field(static_cast<unsigned char*>(fStorage.get()),
+                                                 fPath, fLayout);
+        }
+        fPath.reset();
+        fReady.signal();
+    }
+
+    void wait() {
+        if (!fWaited) {
+            fReady.wait();
+            fWaited = true;
+        }
+    }
+
+    uint32_t dimension() const { return fDimension; }
+
+    // These may only be called after wait().
+    const void* distanceField() const { return fSucceeded ? fStorage.get() : nullptr; }
+
+private:
+    uint32_t            fDimension;
+    DistanceFieldLayout fLayout;
+    SkPath              fPath;
+    SkAutoMalloc        fStorage;
+    bool                fSucceeded = false;
+    SkSemaphore         fReady;
+    bool                fWaited = false;
+};
+
 class GrSmallPathRenderer::SmallPathOp final : public GrMeshDrawOp {
 private:
     using Helper = GrSimpleMeshDrawOpHelperWithStencil;
@@ -237,9 +419,11 @@ public:
                                           ShapeDataList* shapeList,
                                           bool gammaCorrect,
                                           const GrUserStencilSettings* stencilSettings) {
-        return Helper::FactoryHelper<SmallPathOp>(context, std::move(paint), shape, viewMatrix,
-                                                  atlas, shapeCache, shapeList, gammaCorrect,
-                                                  stencilSettings);
+        std::unique_ptr<GrDrawOp> op = Helper::FactoryHelper<SmallPathOp>(
+                context, std::move(paint), shape, viewMatrix, atlas, shapeCache, shapeList,
+                gammaCorrect, stencilSettings);
+        static_cast<SmallPathOp*>(op.get())->startGeneratingDistanceField(context);
+        return op;
     }
 
     SmallPathOp(Helper::MakeArgs helperArgs, GrColor color, const GrShape& shape,
@@ -260,7 +444,7 @@ public:
         // always use distance fields if in perspective
         fUsesDistanceField = fUsesDistanceField || viewMatrix.hasPerspective();
 
-        fShapes.emplace_back(Entry{color, shape, viewMatrix});
+        fShapes.emplace_back(Entry{color, shape, viewMatrix, nullptr});
 
         fAtlas = atlas;
         fShapeCache = shapeCache;
@@ -395,49 +579,9 @@ private:
 
             ShapeData* shapeData;
             if (fUsesDistanceField) {
-                // get mip level
-                SkScalar maxScale;
                 const SkRect& bounds = args.fShape.bounds();
-                if (args.fViewMatrix.hasPerspective()) {
-                    // approximate the scale since we can't get it from the matrix
-                    SkRect xformedBounds;
-                    args.fViewMatrix.mapRect(&xformedBounds, bounds);
-                    maxScale = SkScalarAbs(SkTMax(xformedBounds.width() / bounds.width(),
-                                                  xformedBounds.height() / bounds.height()));
-                } else {
-                    maxScale = SkScalarAbs(args.fViewMatrix.getMaxScale());
-                }
                 SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
-                // We try to create the DF at a 2^n scaled path resolution (1/2, 1, 2, 4, etc.)
-                // In the majority of cases this will yield a crisper rendering.
-                SkScalar mipScale = 1.0f;
-                // Our mipscale is the maxScale clamped to the next highest power of 2
-                if (maxScale <= SK_ScalarHalf) {
-                    SkScalar log = SkScalarFloorToScalar(SkScalarLog2(SkScalarInvert(maxScale)));
-                    mipScale = SkScalarPow(2, -log);
-                } else if (maxScale > SK_Scalar1) {
-                    SkScalar log = SkScalarCeilToScalar(SkScalarLog2(maxScale));
-                    mipScale = SkScalarPow(2, log);
-                }
-                SkASSERT(maxScale <= mipScale);
-
-                SkScalar mipSize = mipScale*SkScalarAbs(maxDim);
-                // For sizes less than kIdealMinMIP we want to use as large a distance field as we can
-                // so we can preserve as much detail as possible. However, we can't scale down more
-                // than a 1/4 of the size without artifacts. So the idea is that we pick the mipsize
-                // just bigger than the ideal, and then scale down until we are no more than 4x the
-                // original mipsize.
-                if (mipSize < kIdealMinMIP) {
-                    SkScalar newMipSize = mipSize;
-                    do {
-                        newMipSize *= 2;
-                    } while (newMipSize < kIdealMinMIP);
-                    while (newMipSize > 4 * mipSize) {
-                        newMipSize *= 0.25f;
-                    }
-                    mipSize = newMipSize;
-                }
-                SkScalar desiredDimension = SkTMin(mipSize, kMaxMIP);
+                SkScalar desiredDimension = df_desired_dimension(bounds, args.fViewMatrix);
 
                 // check to see if df path is cached
                 ShapeDataKey key(args.fShape, SkScalarCeilToInt(desiredDimension));
@@ -458,7 +602,8 @@ private:
                                                 shapeData,
                                                 args.fShape,
                                                 SkScalarCeilToInt(desiredDimension),
-                                                scale)) {
+                                                scale,
+                                                args.fPendingDistanceField.get())) {
                         delete shapeData;
                         continue;
                     }
@@ -525,98 +670,36 @@ private:
 
     bool addDFPathToAtlas(GrMeshDrawOp::Target* target, FlushInfo* flushInfo,
                           GrDrawOpAtlas* atlas, ShapeData* shapeData, const GrShape& shape,
-                          uint32_t dimension, SkScalar scale) const {
-
-        const SkRect& bounds = shape.bounds();
-
-        // generate bounding rect for bitmap draw
-        SkRect scaledBounds = bounds;
-        // scale to mip level size
-        scaledBounds.fLeft *= scale;
-        scaledBounds.fTop *= scale;
-        scaledBounds.fRight *= scale;
-        scaledBounds.fBottom *= scale;
-        // subtract out integer portion of origin
-        // (SDF created will be placed with fractional offset burnt in)
-        SkScalar dx = SkScalarFloorToScalar(scaledBounds.fLeft);
-        SkScalar dy = SkScalarFloorToScalar(scaledBounds.fTop);
-        scaledBounds.offset(-dx, -dy);
-        // get integer boundary
-        SkIRect devPathBounds;
-        scaledBounds.roundOut(&devPathBounds);
-        // pad to allow room for antialiasing
-        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
-        // place devBounds at origin
-        int width = devPathBounds.width() + 2*intPad;
-        int height = devPathBounds.height() + 2*intPad;
-        devPathBounds = SkIRect::MakeWH(width, height);
-        SkScalar translateX = intPad - dx;
-        SkScalar translateY = intPad - dy;
-
-        // draw path to bitmap
-        SkMatrix drawMatrix;
-        drawMatrix.setScale(scale, scale);
-        drawMatrix.postTranslate(translateX, translateY);
-
-        SkASSERT(devPathBounds.fLeft == 0);
-        SkASSERT(devPathBounds.fTop == 0);
-        SkASSERT(devPathBounds.width() > 0);
-        SkASSERT(devPathBounds.height() > 0);
-
-        // setup signed distance field storage
-        SkIRect dfBounds = devPathBounds.makeOutset(SK_DistanceFieldPad, SK_DistanceFieldPad);
-        width = dfBounds.width();
-        height = dfBounds.height();
+                          uint32_t dimension, SkScalar scale,
+                          PendingDistanceField* pending) const {
+        DistanceFieldLayout layout(shape.bounds(), scale);
+        const SkIRect& devPathBounds = layout.fDevPathBounds;
+        int width = layout.fWidth;
+        int height = layout.fHeight;
+
+        const void* df = nullptr;
+        if (pending && pending->dimension() == dimension) {
+            pending->wait();
+            df = pending->distanceField();
+        }
         // TODO We should really generate this directly into the plot somehow
-        SkAutoSMalloc<1024> dfStorage(width * height * sizeof(unsigned char));
-
-        SkPath path;
-        shape.asPath(&path);
-#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
-        // Generate signed distance field directly from SkPath
-        bool succeed = GrGenerateDistanceFieldFromPath((unsigned char*)dfStorage.get(),
-                                        path, drawMatrix,
-                                        width, height, width * sizeof(unsigned char));
-        if (!succeed) {
-#endif
-            // setup bitmap backing
-            SkAutoPixmapStorage dst;
-            if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
-                                                  devPathBounds.height()))) {
+        SkAutoSMalloc<1024> dfStorage;
+        if (!df) {
+            dfStorage.reset(width * height * sizeof(unsigned char));
+            SkPath path;
+            shape.asPath(&path);
+            if (!generate_distance_field((unsigned char*)dfStorage.get(), path, layout)) {
                 return false;
             }
-            sk_bzero(dst.writable_addr(), dst.computeByteSize());
-
-            // rasterize path
-            SkPaint paint;
-            paint.setStyle(SkPaint::kFill_Style);
-            paint.setAntiAlias(true);
-
-            SkDraw draw;
-            sk_bzero(&draw, sizeof(draw));
-
-            SkRasterClip rasterClip;
-            rasterClip.setRect(devPathBounds);
-            draw.fRC = &rasterClip;
-            draw.fMatrix = &drawMatrix;
-            draw.fDst = dst;
-
-            draw.drawPathCoverage(path, paint);
-
-            // Generate signed distance field
-            SkGenerateDistanceFieldFromA8Image((unsigned char*)dfStorage.get(),
-                                               (const unsigned char*)dst.addr(),
-                                               dst.width(), dst.height(), dst.rowBytes());
-#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+            df = dfStorage.get();
         }
-#endif
 
         // add to atlas
         SkIPoint16 atlasLocation;
         GrDrawOpAtlas::AtlasID id;
 
         if (!this->addToAtlas(target, flushInfo, atlas,
-                              width, height, dfStorage.get(), &id, &atlasLocation)) {
+                              width, height, df, &id, &atlasLocation)) {
             return false;
         }
 
@@ -625,7 +708,7 @@ private:
         shapeData->fID = id;
 
         shapeData->fBounds = SkRect::Make(devPathBounds);
-        shapeData->fBounds.offset(-translateX, -translateY);
+        shapeData->fBounds.offset(-layout.fTranslateX, -layout.fTranslateY);
         shapeData->fBounds.fLeft /= scale;
         shapeData->fBounds.fTop /= scale;
         shapeData->fBounds.fRight /= scale;
@@ -847,6 +930,29 @@ private:
         }
     }
 
+    // If the context has worker threads, starts generating the op's distance field on one of them
+    // right away, so that it runs ahead while recording continues, unless the cache already has it.
+    void startGeneratingDistanceField(GrContext* context) {
+        SkTaskGroup* taskGroup = context->contextPriv().getTaskGroup();
+        if (!fUsesDistanceField || !taskGroup) {
+            return;
+        }
+        SkASSERT(1 == fShapes.count());
+        Entry& entry = fShapes[0];
+        const SkRect& bounds = entry.fShape.bounds();
+        SkScalar desiredDimension = df_desired_dimension(bounds, entry.fViewMatrix);
+        uint32_t dimension = SkScalarCeilToInt(desiredDimension);
+        ShapeData* shapeData = fShapeCache->find(ShapeDataKey(entry.fShape, dimension));
+        if (shapeData && fAtlas->hasID(shapeData->fID)) {
+            return;
+        }
+        SkScalar scale = desiredDimension / SkMaxScalar(bounds.width(), bounds.height());
+        entry.fPendingDistanceField = sk_make_sp<PendingDistanceField>(entry.fShape, dimension,
+                                                                       scale);
+        sk_sp<PendingDistanceField> pending = entry.fPendingDistanceField;
+        taskGroup->add([pending] { pending->run(); });
+    }
+
     GrColor color() const { return fShapes[0].fColor; }
     bool usesDistanceField() const { return fUsesDistanceField; }
 
@@ -893,6 +999,7 @@ private:
         GrColor  fColor;
         GrShape  fShape;
         SkMatrix fViewMatrix;
+        sk_sp<PendingDistanceField> fPendingDistanceField;
     };
 
     SkSTArray<1, Entry> fShapes;
@@ -6,9 +6,11 @@
  */
 
 #include "GrTessellatingPathRenderer.h"
+#include <cmath>
 #include <stdio.h>
 #include "GrAuditTrail.h"
 #include "GrClip.h"
+#include "GrContextPriv.h"
 #include "GrDefaultGeoProcFactory.h"
 #include "GrDrawOpTest.h"
 #include "GrMesh.h"
@@ -20,7 +22,11 @@
 #include "GrSimpleMeshDrawOpHelper.h"
 #include "GrStyle.h"
 #include "GrTessellator.h"
+#include "SkAutoMalloc.h"
 #include "SkGeometry.h"
+#include "SkMakeUnique.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
 #include "ops/GrMeshDrawOp.h"
 
 #ifndef GR_AA_TESSELLATOR_MAX_VERB_COUNT
@@ -132,6 +138,77 @@ private:
     void* fVertices;
 };
 
+class CPUVertexAllocator : public GrTessellator::VertexAllocator {
+public:
+    CPUVertexAllocator(size_t stride, SkAutoMalloc* storage)
+            : VertexAllocator(stride)
+            , fStorage(storage) {}
+    void* lock(int vertexCount) override {
+        return fStorage->reset(vertexCount * stride());
+    }
+    void unlock(int actualCount) override {}
+private:
+    SkAutoMalloc* fStorage;
+};
+
+// Tessellates a non-AA path in path space into CPU memory on a worker thread, for an op to
+// upload into a cached vertex buffer when it is prepared.
+class PendingTessellation : SkNoncopyable {
+public:
+    PendingTessellation(const SkPath& path, SkScalar tol, const SkRect& clipBounds)
+            : fPath(path), fTolerance(tol), fClipBounds(clipBounds) {}
+
+    ~PendingTessellation() { this->wait(); }
+
+    void run() {
+        CPUVertexAllocator allocator(sizeof(SkPoint), &fVertices);
+        fCount = GrTessellator::PathToTriangles(fPath, fTolerance, fClipBounds, &allocator, false,
+                                                GrColor(), false, &fIsLinear);
+        fPath.reset();
+        fReady.signal();
+    }
+
+    void wait() {
+        if (!fWaited) {
+            fReady.wait();
+            fWaited = true;
+        }
+    }
+
+    // These may only be called after wait().
+    const void* vertices() const { return fVertices.get(); }
+    int count() const { return fCount; }
+    bool isLinear() const { return fIsLinear; }
+
+private:
+    SkPath       fPath;
+    SkScalar     fTolerance;
+    SkRect       fClipBounds;
+    SkAutoMalloc fVertices;
+    int          fCount = 0;
+    bool         fIsLinear = false;
+    SkSemaphore  fReady;
+    bool         fWaited = false;
+};
+
+// Rounds the path space tolerance down to a power of two and returns its exponent, so that draws
+// of a path at scales within a factor of two of each other share a tessellation. Paths of only
+// lines tessellate the same at any tolerance, so they all share one bucket.
+int tolerance_bucket(const SkPath& path, SkScalar* tol) {
+    static constexpr int kLinearBucket = 0x7fffffff;
+    if (SkPath::kLine_SegmentMask == path.getSegmentMasks()) {
+        return kLinearBucket;
+    }
+    int exp;
+    std::frexp(*tol, &exp);
+    SkScalar rounded = std::ldexp(0.5f, exp);
+    // Don't go below GrPathUtils' minimum tolerance.
+    if (rounded >= 0.0001f) {
+        *tol = rounded;
+    }
+    return exp;
+}
+
 }  // namespace
 
 GrTessellatingPathRenderer::GrTessellatingPathRenderer() {
@@ -177,9 +254,13 @@ public:
                                           SkIRect devClipBounds,
                                           GrAAType aaType,
                                           const GrUserStencilSettings* stencilSettings) {
-        return Helper::FactoryHelper<TessellatingPathOp>(context, std::move(paint), shape,
-                                                         viewMatrix, devClipBounds,
-                                                         aaType, stencilSettings);
+        std::unique_ptr<GrDrawOp> op = Helper::FactoryHelper<TessellatingPathOp>(
+                context, std::move(paint), shape, viewMatrix, devClipBounds, aaType,
+                stencilSettings);
+        if (op) {
+            static_cast<TessellatingPathOp*>(op.get())->startTessellating(context);
+        }
+        return op;
     }
 
     const char* name() const override { return "TessellatingPathOp"; }
@@ -210,6 +291,11 @@ public:
             , fViewMatrix(viewMatrix)
             , fDevClipBounds(devClipBounds)
             , fAntiAlias(GrAAType::kCoverage == aaType) {
+        if (!fAntiAlias) {
+            fTolerance = GrPathUtils::scaleToleranceToSrc(GrPathUtils::kDefaultTolerance,
+                                                          viewMatrix, shape.bounds());
+            fToleranceBucket = tolerance_bucket(this->getPath(), &fTolerance);
+        }
         SkRect devBounds;
         viewMatrix.mapRect(&devBounds, shape.bounds());
         if (shape.inverseFilled()) {
@@ -222,6 +308,9 @@ public:
 
     FixedFunctionFlags fixedFunctionFlags() const override { return fHelper.fixedFunctionFlags(); }
 
+    // Non-AA paths are tessellated ahead by startTessellating() instead, since they are cached.
+    bool canPrePrepare() const override { return fAntiAlias; }
+
     RequiresDstTexture finalize(const GrCaps& caps, const GrAppliedClip* clip) override {
         GrProcessorAnalysisCoverage coverage = fAntiAlias
                                                        ? GrProcessorAnalysisCoverage::kSingleChannel
@@ -237,72 +326,162 @@ private:
         return path;
     }
 
-    void draw(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
+    // Builds the cache key for a non-AA tessellation. The vertices are in path space, so apart
+    // from inverse fills' clip bounds the key depends on the view matrix only through the
+    // tolerance bucket, and is shared by draws of the path under any transform of similar scale.
+    void makeKey(GrUniqueKey* key) const {
         SkASSERT(!fAntiAlias);
-        GrResourceProvider* rp = target->resourceProvider();
-        bool inverseFill = fShape.inverseFilled();
-        // construct a cache key from the path's genID and the view matrix
         static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
-        GrUniqueKey key;
         static constexpr int kClipBoundsCnt = sizeof(fDevClipBounds) / sizeof(uint32_t);
         int shapeKeyDataCnt = fShape.unstyledKeySize();
         SkASSERT(shapeKeyDataCnt >= 0);
-        GrUniqueKey::Builder builder(&key, kDomain, shapeKeyDataCnt + kClipBoundsCnt, "Path");
+        GrUniqueKey::Builder builder(key, kDomain, shapeKeyDataCnt + kClipBoundsCnt + 1, "Path");
         fShape.writeUnstyledKey(&builder[0]);
         // For inverse fills, the tessellation is dependent on clip bounds.
-        if (inverseFill) {
+        if (fShape.inverseFilled()) {
             memcpy(&builder[shapeKeyDataCnt], &fDevClipBounds, sizeof(fDevClipBounds));
         } else {
             memset(&builder[shapeKeyDataCnt], 0, sizeof(fDevClipBounds));
         }
+        builder[shapeKeyDataCnt + kClipBoundsCnt] = fToleranceBucket;
         builder.finish();
+    }
+
+    bool pathSpaceClipBounds(SkRect* clipBounds) const {
+        SkMatrix vmi;
+        if (!fViewMatrix.invert(&vmi)) {
+            return false;
+        }
+        vmi.mapRect(clipBounds, SkRect::Make(fDevClipBounds));
+        return true;
+    }
+
+    // If the context has worker threads, starts tessellating a non-AA path on one of them right
+    // away, so that it runs ahead while recording continues, unless the cache already has it.
+    void startTessellating(GrContext* context) {
+        SkTaskGroup* taskGroup = context->contextPriv().getTaskGroup();
+        if (fAntiAlias || !taskGroup) {
+            return;
+        }
+        if (GrResourceProvider* rp = context->contextPriv().resourceProvider()) {
+            GrUniqueKey key;
+            this->makeKey(&key);
+            sk_sp<GrBuffer> cachedVertexBuffer(rp->findByUniqueKey<GrBuffer>(key));
+            int actualCount;
+            if (cache_match(cachedVertexBuffer.get(), fTolerance, &actualCount)) {
+                return;
+            }
+        }
+        SkRect clipBounds;
+        if (!this->pathSpaceClipBounds(&clipBounds)) {
+            return;
+        }
+        fPendingTessellation = skstd::make_unique<PendingTessellation>(this->getPath(), fTolerance,
+                                                                       clipBounds);
+        PendingTessellation* pending = fPendingTessellation.get();
+        taskGroup->add([pending] { pending->run(); });
+    }
+
+    void draw(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
+        SkASSERT(!fAntiAlias);
+        SkASSERT(vertexStride == sizeof(SkPoint));
+        GrResourceProvider* rp = target->resourceProvider();
+        GrUniqueKey key;
+        this->makeKey(&key);
         sk_sp<GrBuffer> cachedVertexBuffer(rp->findByUniqueKey<GrBuffer>(key));
         int actualCount;
-        SkScalar tol = GrPathUtils::kDefaultTolerance;
-        tol = GrPathUtils::scaleToleranceToSrc(tol, fViewMatrix, fShape.bounds());
-        if (cache_match(cachedVertexBuffer.get(), tol, &actualCount)) {
+        if (cache_match(cachedVertexBuffer.get(), fTolerance, &actualCount)) {
             this->drawVertices(target, std::move(gp), cachedVertexBuffer.get(), 0, actualCount);
             return;
         }
 
-        SkRect clipBounds = SkRect::Make(fDevClipBounds);
-
-        SkMatrix vmi;
-        if (!fViewMatrix.invert(&vmi)) {
-            return;
-        }
-        vmi.mapRect(&clipBounds);
+        sk_sp<GrBuffer> vertexBuffer;
+        int count;
         bool isLinear;
-        bool canMapVB = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
-        StaticVertexAllocator allocator(vertexStride, rp, canMapVB);
-        int count = GrTessellator::PathToTriangles(getPath(), tol, clipBounds, &allocator,
+        if (fPendingTessellation) {
+            // Tessellated already on a worker thread; just upload the vertices.
+            fPendingTessellation->wait();
+            count = fPendingTessellation->count();
+            isLinear = fPendingTessellation->isLinear();
+            if (count > 0) {
+                vertexBuffer.reset(rp->createBuffer(count * vertexStride, kVertex_GrBufferType,
+                                                    kStatic_GrAccessPattern,
+                                                    GrResourceProvider::Flags::kNone,
+                                                    fPendingTessellation->vertices()));
+            }
+            fPendingTessellation.reset();
+        } else {
+            SkRect clipBounds;
+            if (!this->pathSpaceClipBounds(&clipBounds)) {
+                return;
+            }
+            bool canMapVB = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
+            StaticVertexAllocator allocator(vertexStride, rp, canMapVB);
+            count = GrTessellator::PathToTriangles(getPath(), fTolerance, clipBounds, &allocator,
                                                    false, GrColor(), false, &isLinear);
-        if (count == 0) {
+            vertexBuffer.reset(SkSafeRef(allocator.vertexBuffer()));
+        }
+        if (count == 0 || !vertexBuffer) {
             return;
         }
-        this->drawVertices(target, std::move(gp), allocator.vertexBuffer(), 0, count);
+        this->drawVertices(target, std::move(gp), vertexBuffer.get(), 0, count);
         TessInfo info;
-        info.fTolerance = isLinear ? 0 : tol;
+        info.fTolerance = isLinear ? 0 : fTolerance;
         info.fCount = count;
         key.setCustomData(SkData::MakeWithCopy(&info, sizeof(info)));
-        rp->assignUniqueKeyToResource(key, allocator.vertexBuffer());
+        rp->assignUniqueKeyToResource(key, vertexBuffer.get());
         fShape.addGenIDChangeListener(sk_make_sp<PathInvalidator>(key, target->contextUniqueID()));
     }
 
-    void drawAA(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
+    size_t aaVertexStride() const {
+        // position, color, and coverage if it can't be folded into the color's alpha.
+        return sizeof(SkPoint) + sizeof(uint32_t) +
+               (fHelper.compatibleWithAlphaAsCoverage() ? 0 : 4);
+    }
+
+    int tessellateAA(GrTessellator::VertexAllocator* allocator) const {
         SkASSERT(fAntiAlias);
         SkPath path = getPath();
         if (path.isEmpty()) {
-            return;
+            return 0;
         }
         SkRect clipBounds = SkRect::Make(fDevClipBounds);
         path.transform(fViewMatrix);
         SkScalar tol = GrPathUtils::kDefaultTolerance;
         bool isLinear;
+        return GrTessellator::PathToTriangles(path, tol, clipBounds, allocator, true, fColor,
+                                              fHelper.compatibleWithAlphaAsCoverage(), &isLinear);
+    }
+
+    void onPrePrepare() override {
+        CPUVertexAllocator allocator(this->aaVertexStride(), &fPrePreparedVertices);
+        fPrePreparedCount = this->tessellateAA(&allocator);
+    }
+
+    void drawAA(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
+        SkASSERT(fAntiAlias);
+        SkASSERT(vertexStride == this->aaVertexStride());
+        if (fPrePreparedCount >= 0) {
+            // Tessellated already; just copy the vertices in.
+            int count = fPrePreparedCount;
+            if (count == 0) {
+                return;
+            }
+            const GrBuffer* vertexBuffer;
+            int firstVertex;
+            void* vertices = target->makeVertexSpace(vertexStride, count, &vertexBuffer,
+                                                     &firstVertex);
+            if (!vertices) {
+                return;
+            }
+            memcpy(vertices, fPrePreparedVertices.get(), count * vertexStride);
+            fPrePreparedVertices.reset(0);
+            this->drawVertices(target, std::move(gp), vertexBuffer, firstVertex, count);
+            return;
+        }
+
         DynamicVertexAllocator allocator(vertexStride, target);
-        int count =
-                GrTessellator::PathToTriangles(path, tol, clipBounds, &allocator, true, fColor,
-                                               fHelper.compatibleWithAlphaAsCoverage(), &isLinear);
+        int count = this->tessellateAA(&allocator);
         if (count == 0) {
             return;
         }
@@ -372,6 +551,14 @@ private:
     SkMatrix                fViewMatrix;
     SkIRect                 fDevClipBounds;
     bool                    fAntiAlias;
+    // Vertices from prePrepare(), if it was called.
+    SkAutoMalloc            fPrePreparedVertices;
+    int                     fPrePreparedCount = -1;
+    // Non-AA only: the path space tolerance, and the bucket of the key it was rounded to.
+    SkScalar                fTolerance = 0;
+    int                     fToleranceBucket = 0;
+    // Non-AA only: the tessellation started by startTessellating(), if it was called.
+    std::unique_ptr<PendingTessellation> fPendingTessellation;
 
     typedef GrMeshDrawOp INHERITED;
 };
@@ -28,6 +28,7 @@
 #include "SkPoint.h"
 #include "SkPoint3.h"
 #include "SkRectPriv.h"
+#include "SkTemplates.h"
 #include "SkTo.h"
 #include "glsl/GrGLSLColorSpaceXformHelper.h"
 #include "glsl/GrGLSLFragmentShaderBuilder.h"
@@ -38,11 +39,16 @@
 namespace {
 
 enum class Domain : bool { kNo = false, kYes = true };
+enum class MultiTexture : bool { kNo = false, kYes = true };
+
+// The most textures a TextureGeometryProcessor will sample from in one draw.
+static constexpr int kMaxTextures = 8;
 
 /**
  * Geometry Processor that draws a texture modulated by a vertex color (though, this is meant to be
  * the same value across all vertices of a quad and uses flat interpolation when available). This is
- * used by TextureOp below.
+ * used by TextureOp below. When it has more than one sampler each vertex also carries the index of
+ * the texture its quad samples from.
  */
 class TextureGeometryProcessor : public GrGeometryProcessor {
 public:
@@ -75,17 +81,39 @@ public:
         SkPoint3 fEdges[4];
     };
 
+    template <typename Pos, Domain D, GrAA AA, MultiTexture MT> struct OptionalMultiTextureVertex;
+    template <typename Pos, Domain D, GrAA AA>
+    struct OptionalMultiTextureVertex<Pos, D, AA, MultiTexture::kNo>
+            : OptionalAAVertex<Pos, D, AA> {
+        static constexpr MultiTexture kMultiTexture = MultiTexture::kNo;
+    };
     template <typename Pos, Domain D, GrAA AA>
-    using Vertex = OptionalAAVertex<Pos, D, AA>;
+    struct OptionalMultiTextureVertex<Pos, D, AA, MultiTexture::kYes>
+            : OptionalAAVertex<Pos, D, AA> {
+        static constexpr MultiTexture kMultiTexture = MultiTexture::kYes;
+        int fTextureIdx;
+    };
+
+    template <typename Pos, Domain D, GrAA AA, MultiTexture MT>
+    using Vertex = OptionalMultiTextureVertex<Pos, D, AA, MT>;
+
+    // The number of textures one draw may sample from; 1 if multitexturing isn't supported.
+    static int MaxTextures(const GrShaderCaps& caps) {
+        if (!caps.disableImageMultitexturingDstRectAreaThreshold()) {
+            return 1;
+        }
+        SkASSERT(caps.integerSupport() && caps.flatInterpolationSupport());
+        return SkTMin(caps.maxFragmentSamplers(), kMaxTextures);
+    }
 
     static sk_sp<GrGeometryProcessor> Make(GrTextureType textureType, GrPixelConfig textureConfig,
-                                           const GrSamplerState::Filter filter,
+                                           const GrSamplerState::Filter filter, int samplerCnt,
                                            sk_sp<GrColorSpaceXform> textureColorSpaceXform,
                                            sk_sp<GrColorSpaceXform> paintColorSpaceXform,
                                            bool coverageAA, bool perspective, Domain domain,
                                            const GrShaderCaps& caps) {
         return sk_sp<TextureGeometryProcessor>(new TextureGeometryProcessor(
-                textureType, textureConfig, filter, std::move(textureColorSpaceXform),
+                textureType, textureConfig, filter, samplerCnt, std::move(textureColorSpaceXform),
                 std::move(paintColorSpaceXform), coverageAA, perspective, domain, caps));
     }
 
@@ -97,6 +125,7 @@ public:
         uint32_t x = this->usesCoverageEdgeAA() ? 0 : 1;
         x |= kFloat3_GrVertexAttribType == fPositions.cpuType() ? 0 : 2;
         x |= fDomain.isInitialized() ? 4 : 0;
+        x |= this->numTextureSamplers() << 3;
         b->add32(x);
     }
 
@@ -156,11 +185,31 @@ public:
                     args.fFragBuilder->codeAppend(
                             "texCoord = clamp(texCoord, domain.xy, domain.zw);");
                 }
-                args.fFragBuilder->codeAppendf("%s = ", args.fOutputColor);
-                args.fFragBuilder->appendTextureLookupAndModulate(
-                        args.fOutputColor, args.fTexSamplers[0], "texCoord", kFloat2_GrSLType,
-                        &fTextureColorSpaceXformHelper);
-                args.fFragBuilder->codeAppend(";");
+                int samplerCnt = textureGP.numTextureSamplers();
+                if (samplerCnt > 1) {
+                    args.fFragBuilder->codeAppend("int texIdx;");
+                    args.fVaryingHandler->addPassThroughAttribute(textureGP.fTextureIdx, "texIdx",
+                                                                  Interpolation::kMustBeFlat);
+                    for (int i = 0; i < samplerCnt - 1; ++i) {
+                        args.fFragBuilder->codeAppendf("if (texIdx == %d) { %s = ", i,
+                                                       args.fOutputColor);
+                        args.fFragBuilder->appendTextureLookupAndModulate(
+                                args.fOutputColor, args.fTexSamplers[i], "texCoord",
+                                kFloat2_GrSLType, &fTextureColorSpaceXformHelper);
+                        args.fFragBuilder->codeAppend("; } else ");
+                    }
+                    args.fFragBuilder->codeAppendf("{ %s = ", args.fOutputColor);
+                    args.fFragBuilder->appendTextureLookupAndModulate(
+                            args.fOutputColor, args.fTexSamplers[samplerCnt - 1], "texCoord",
+                            kFloat2_GrSLType, &fTextureColorSpaceXformHelper);
+                    args.fFragBuilder->codeAppend("; }");
+                } else {
+                    args.fFragBuilder->codeAppendf("%s = ", args.fOutputColor);
+                    args.fFragBuilder->appendTextureLookupAndModulate(
+                            args.fOutputColor, args.fTexSamplers[0], "texCoord", kFloat2_GrSLType,
+                            &fTextureColorSpaceXformHelper);
+                    args.fFragBuilder->codeAppend(";");
+                }
                 if (textureGP.usesCoverageEdgeAA()) {
                     bool mulByFragCoordW = false;
                     GrGLSLVarying aaDistVarying(kFloat4_GrSLType,
@@ -213,15 +262,18 @@ public:
 
 private:
     TextureGeometryProcessor(GrTextureType textureType, GrPixelConfig textureConfig,
-                             GrSamplerState::Filter filter,
+                             GrSamplerState::Filter filter, int samplerCnt,
                              sk_sp<GrColorSpaceXform> textureColorSpaceXform,
                              sk_sp<GrColorSpaceXform> paintColorSpaceXform, bool coverageAA,
                              bool perspective, Domain domain, const GrShaderCaps& caps)
             : INHERITED(kTextureGeometryProcessor_ClassID)
             , fTextureColorSpaceXform(std::move(textureColorSpaceXform))
-            , fPaintColorSpaceXform(std::move(paintColorSpaceXform))
-            , fSampler(textureType, textureConfig, filter) {
-        this->setTextureSamplerCnt(1);
+            , fPaintColorSpaceXform(std::move(paintColorSpaceXform)) {
+        SkASSERT(samplerCnt >= 1 && samplerCnt <= MaxTextures(caps));
+        for (int i = 0; i < samplerCnt; ++i) {
+            fSamplers[i].reset(textureType, textureConfig, filter);
+        }
+        this->setTextureSamplerCnt(samplerCnt);
 
         if (perspective) {
             fPositions = {"position", kFloat3_GrVertexAttribType, kFloat3_GrSLType};
@@ -243,24 +295,29 @@ private:
             fAAEdges[3] = {"aaEdge3", kFloat3_GrVertexAttribType, kFloat3_GrSLType};
             vertexAttributeCnt += 4;
         }
+        if (samplerCnt > 1) {
+            fTextureIdx = {"textureIdx", kInt_GrVertexAttribType, kInt_GrSLType};
+            ++vertexAttributeCnt;
+        }
         this->setVertexAttributeCnt(vertexAttributeCnt);
     }
 
     const Attribute& onVertexAttribute(int i) const override {
         return IthInitializedAttribute(i, fPositions, fColors, fTextureCoords, fDomain, fAAEdges[0],
-                                       fAAEdges[1], fAAEdges[2], fAAEdges[3]);
+                                       fAAEdges[1], fAAEdges[2], fAAEdges[3], fTextureIdx);
     }
 
-    const TextureSampler& onTextureSampler(int) const override { return fSampler; }
+    const TextureSampler& onTextureSampler(int i) const override { return fSamplers[i]; }
 
     Attribute fPositions;
     Attribute fColors;
     Attribute fTextureCoords;
     Attribute fDomain;
     Attribute fAAEdges[4];
+    Attribute fTextureIdx;
     sk_sp<GrColorSpaceXform> fTextureColorSpaceXform;
     sk_sp<GrColorSpaceXform> fPaintColorSpaceXform;
-    TextureSampler fSampler;
+    TextureSampler fSamplers[kMaxTextures];
 
     typedef GrGeometryProcessor INHERITED;
 };
@@ -568,6 +625,20 @@ template <typename V> struct DomainAssigner<V, Domain::kNo> {
     }
 };
 
+template <typename V, MultiTexture MT = V::kMultiTexture> struct TextureIdxAssigner;
+
+template <typename V> struct TextureIdxAssigner<V, MultiTexture::kYes> {
+    static void Assign(V* vertices, int textureIdx) {
+        for (int i = 0; i < 4; ++i) {
+            vertices[i].fTextureIdx = textureIdx;
+        }
+    }
+};
+
+template <typename V> struct TextureIdxAssigner<V, MultiTexture::kNo> {
+    static void Assign(V*, int textureIdx) { SkASSERT(!textureIdx); }
+};
+
 }  // anonymous namespace
 
 template <typename V>
@@ -843,11 +914,11 @@ private:
         fDomain = static_cast<unsigned>(false);
     }
 
-    template <typename Pos, Domain D, GrAA AA>
-    void tess(void* v, const GrGeometryProcessor* gp, const GrTextureProxy* proxy, int start,
-              int cnt) const {
+    template <typename Pos, Domain D, GrAA AA, MultiTexture MT>
+    void tess(void* v, const GrGeometryProcessor* gp, const GrTextureProxy* proxy, int textureIdx,
+              int start, int cnt) const {
         TRACE_EVENT0("skia", TRACE_FUNC);
-        using Vertex = TextureGeometryProcessor::Vertex<Pos, D, AA>;
+        using Vertex = TextureGeometryProcessor::Vertex<Pos, D, AA, MT>;
         SkASSERT(gp->debugOnly_vertexStride() == sizeof(Vertex));
         auto vertices = static_cast<Vertex*>(v);
         auto origin = proxy->origin();
@@ -859,12 +930,26 @@ private:
             const auto q = fQuads[i];
             tessellate_quad<Vertex>(q.quad(), q.aaFlags(), q.srcRect(), q.color(), origin,
                                     this->filter(), vertices, iw, ih, q.domain());
+            TextureIdxAssigner<Vertex>::Assign(vertices, textureIdx);
             vertices += 4;
         }
     }
 
+    // A run of chained proxies that is drawn with a single mesh, each bound to its own sampler.
+    struct TextureGroup {
+        GrTextureProxy* fProxies[kMaxTextures];
+        int fProxyCnt;
+        int fQuadCnt;
+    };
+
     void onPrepareDraws(Target* target) override {
         TRACE_EVENT0("skia", TRACE_FUNC);
+        const GrShaderCaps& shaderCaps = *target->caps().shaderCaps();
+        // Chained draws from different textures can share a draw by binding each texture to its
+        // own sampler, but that only pays off when every quad is small.
+        int maxTextures = TextureGeometryProcessor::MaxTextures(shaderCaps);
+        SkScalar maxMultitextureArea =
+                SkIntToScalar(shaderCaps.disableImageMultitexturingDstRectAreaThreshold());
         bool hasPerspective = false;
         Domain domain = Domain::kNo;
         int numProxies = 0;
@@ -891,13 +976,52 @@ private:
                 SkASSERT(aaType == GrAAType::kCoverage || aaType == GrAAType::kNone);
                 aaType = GrAAType::kCoverage;
             }
+            for (int q = 0; q < op.fQuads.count() && maxTextures > 1; ++q) {
+                SkRect bounds = op.fQuads[q].quad().bounds();
+                if (bounds.width() * bounds.height() > maxMultitextureArea) {
+                    maxTextures = 1;
+                }
+            }
+        }
+
+        // Split the proxies into groups of at most maxTextures distinct proxies, remembering the
+        // sampler each proxy is bound to within its group.
+        SkSTArray<1, TextureGroup, true> groups;
+        SkAutoSTMalloc<32, int> textureIdxs(numProxies);
+        int samplerCnt = 1;
+        int i = 0;
+        for (const auto& op : ChainRange<TextureOp>(this)) {
+            for (unsigned p = 0; p < op.fProxyCnt; ++p, ++i) {
+                auto* proxy = op.fProxies[p].fProxy;
+                TextureGroup* group = groups.empty() ? nullptr : &groups.back();
+                int t = 0;
+                if (group) {
+                    while (t < group->fProxyCnt && group->fProxies[t] != proxy) {
+                        ++t;
+                    }
+                }
+                if (!group || t == maxTextures) {
+                    group = &groups.push_back();
+                    group->fProxyCnt = 0;
+                    group->fQuadCnt = 0;
+                    t = 0;
+                }
+                if (t == group->fProxyCnt) {
+                    group->fProxies[group->fProxyCnt++] = proxy;
+                    samplerCnt = SkTMax(samplerCnt, group->fProxyCnt);
+                }
+                group->fQuadCnt += op.fProxies[p].fQuadCnt;
+                textureIdxs[i] = t;
+            }
         }
+        int numMeshes = groups.count();
+        bool multitexture = samplerCnt > 1;
 
         bool coverageAA = GrAAType::kCoverage == aaType;
         sk_sp<GrGeometryProcessor> gp = TextureGeometryProcessor::Make(
-                textureType, config, this->filter(), std::move(fTextureColorSpaceXform),
-                std::move(fPaintColorSpaceXform), coverageAA, hasPerspective, domain,
-                *target->caps().shaderCaps());
+                textureType, config, this->filter(), samplerCnt,
+                std::move(fTextureColorSpaceXform), std::move(fPaintColorSpaceXform), coverageAA,
+                hasPerspective, domain, shaderCaps);
         GrPipeline::InitArgs args;
         args.fProxy = target->proxy();
         args.fCaps = &target->caps();
@@ -908,48 +1032,68 @@ private:
         }
 
         auto clip = target->detachAppliedClip();
-        // We'll use a dynamic state array for the GP textures when there are multiple ops.
-        // Otherwise, we use fixed dynamic state to specify the single op's proxy.
+        // We'll use a dynamic state array for the GP textures when there are multiple groups.
+        // Otherwise, we use fixed dynamic state to specify the single group's proxies.
         GrPipeline::DynamicStateArrays* dynamicStateArrays = nullptr;
         GrPipeline::FixedDynamicState* fixedDynamicState;
-        if (numProxies > 1) {
-            dynamicStateArrays = target->allocDynamicStateArrays(numProxies, 1, false);
+        GrTextureProxy** groupTextures;
+        if (numMeshes > 1) {
+            dynamicStateArrays = target->allocDynamicStateArrays(numMeshes, samplerCnt, false);
             fixedDynamicState = target->allocFixedDynamicState(clip.scissorState().rect(), 0);
+            groupTextures = dynamicStateArrays->fPrimitiveProcessorTextures;
         } else {
-            fixedDynamicState = target->allocFixedDynamicState(clip.scissorState().rect(), 1);
-            fixedDynamicState->fPrimitiveProcessorTextures[0] = fProxies[0].fProxy;
+            fixedDynamicState =
+                    target->allocFixedDynamicState(clip.scissorState().rect(), samplerCnt);
+            groupTextures = fixedDynamicState->fPrimitiveProcessorTextures;
+        }
+        for (int g = 0; g < numMeshes; ++g) {
+            // Samplers the group doesn't use still need a texture bound.
+            for (int t = 0; t < samplerCnt; ++t) {
+                int proxyIdx = t < groups[g].fProxyCnt ? t : 0;
+                groupTextures[g * samplerCnt + t] = groups[g].fProxies[proxyIdx];
+            }
         }
         const auto* pipeline =
                 target->allocPipeline(args, GrProcessorSet::MakeEmptySet(), std::move(clip));
-        using TessFn = decltype(&TextureOp::tess<SkPoint, Domain::kNo, GrAA::kNo>);
-#define TESS_FN_AND_VERTEX_SIZE(Point, Domain, AA)                          \
-    {                                                                       \
-        &TextureOp::tess<Point, Domain, AA>,                                \
-                sizeof(TextureGeometryProcessor::Vertex<Point, Domain, AA>) \
+        using TessFn =
+                decltype(&TextureOp::tess<SkPoint, Domain::kNo, GrAA::kNo, MultiTexture::kNo>);
+#define TESS_FN_AND_VERTEX_SIZE(Point, Domain, AA, MT)                          \
+    {                                                                           \
+        &TextureOp::tess<Point, Domain, AA, MT>,                                \
+                sizeof(TextureGeometryProcessor::Vertex<Point, Domain, AA, MT>) \
     }
         static constexpr struct {
             TessFn fTessFn;
             size_t fVertexSize;
         } kTessFnsAndVertexSizes[] = {
-                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kNo,  GrAA::kNo),
-                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kNo,  GrAA::kYes),
-                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kYes, GrAA::kNo),
-                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kYes, GrAA::kYes),
-                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kNo,  GrAA::kNo),
-                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kNo,  GrAA::kYes),
-                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kYes, GrAA::kNo),
-                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kYes, GrAA::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kNo,  GrAA::kNo,  MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kNo,  GrAA::kYes, MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kYes, GrAA::kNo,  MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kYes, GrAA::kYes, MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kNo,  GrAA::kNo,  MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kNo,  GrAA::kYes, MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kYes, GrAA::kNo,  MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kYes, GrAA::kYes, MultiTexture::kNo),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kNo,  GrAA::kNo,  MultiTexture::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kNo,  GrAA::kYes, MultiTexture::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kYes, GrAA::kNo,  MultiTexture::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint,  Domain::kYes, GrAA::kYes, MultiTexture::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kNo,  GrAA::kNo,  MultiTexture::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kNo,  GrAA::kYes, MultiTexture::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kYes, GrAA::kNo,  MultiTexture::kYes),
+                TESS_FN_AND_VERTEX_SIZE(SkPoint3, Domain::kYes, GrAA::kYes, MultiTexture::kYes),
         };
 #undef TESS_FN_AND_VERTEX_SIZE
         int tessFnIdx = 0;
         tessFnIdx |= coverageAA               ? 0x1 : 0x0;
         tessFnIdx |= (domain == Domain::kYes) ? 0x2 : 0x0;
         tessFnIdx |= hasPerspective           ? 0x4 : 0x0;
+        tessFnIdx |= multitexture             ? 0x8 : 0x0;
 
         size_t vertexSize = kTessFnsAndVertexSizes[tessFnIdx].fVertexSize;
         SkASSERT(vertexSize == gp->debugOnly_vertexStride());
 
-        GrMesh* meshes = target->allocMeshes(numProxies);
+        GrMesh* meshes = target->allocMeshes(numMeshes);
         const GrBuffer* vbuffer;
         int vertexOffsetInBuffer = 0;
         int numQuadVerticesLeft = numTotalQuads * 4;
@@ -957,57 +1101,68 @@ private:
         void* vdata = nullptr;
 
         int m = 0;
+        int meshVertexCnt = 0;
+        int meshQuadsLeft = 0;
+        i = 0;
         for (const auto& op : ChainRange<TextureOp>(this)) {
             int q = 0;
-            for (unsigned p = 0; p < op.fProxyCnt; ++p) {
-                int quadCnt = op.fProxies[p].fQuadCnt;
-                auto* proxy = op.fProxies[p].fProxy;
-                int meshVertexCnt = quadCnt * 4;
-                if (numAllocatedVertices < meshVertexCnt) {
-                    vdata = target->makeVertexSpaceAtLeast(
-                            vertexSize, meshVertexCnt, numQuadVerticesLeft, &vbuffer,
-                            &vertexOffsetInBuffer, &numAllocatedVertices);
-                    SkASSERT(numAllocatedVertices <= numQuadVerticesLeft);
-                    if (!vdata) {
-                        SkDebugf("Could not allocate vertices\n");
-                        return;
+            for (unsigned p = 0; p < op.fProxyCnt; ++p, ++i) {
+                if (!meshQuadsLeft) {
+                    // Start the mesh for the next group.
+                    int quadCnt = groups[m].fQuadCnt;
+                    meshVertexCnt = quadCnt * 4;
+                    if (numAllocatedVertices < meshVertexCnt) {
+                        vdata = target->makeVertexSpaceAtLeast(
+                                vertexSize, meshVertexCnt, numQuadVerticesLeft, &vbuffer,
+                                &vertexOffsetInBuffer, &numAllocatedVertices);
+                        SkASSERT(numAllocatedVertices <= numQuadVerticesLeft);
+                        if (!vdata) {
+                            SkDebugf("Could not allocate vertices\n");
+                            return;
+                        }
                     }
-                }
-                SkASSERT(numAllocatedVertices >= meshVertexCnt);
-
-                (op.*(kTessFnsAndVertexSizes[tessFnIdx].fTessFn))(vdata, gp.get(), proxy, q,
-                                                                  quadCnt);
-
-                if (quadCnt > 1) {
-                    meshes[m].setPrimitiveType(GrPrimitiveType::kTriangles);
-                    sk_sp<const GrBuffer> ibuffer =
-                            target->resourceProvider()->refQuadIndexBuffer();
-                    if (!ibuffer) {
-                        SkDebugf("Could not allocate quad indices\n");
-                        return;
+                    SkASSERT(numAllocatedVertices >= meshVertexCnt);
+
+                    if (quadCnt > 1) {
+                        meshes[m].setPrimitiveType(GrPrimitiveType::kTriangles);
+                        sk_sp<const GrBuffer> ibuffer =
+                                target->resourceProvider()->refQuadIndexBuffer();
+                        if (!ibuffer) {
+                            SkDebugf("Could not allocate quad indices\n");
+                            return;
+                        }
+                        meshes[m].setIndexedPatterned(ibuffer.get(), 6, 4, quadCnt,
+                                                      GrResourceProvider::QuadCountOfQuadBuffer());
+                    } else {
+                        meshes[m].setPrimitiveType(GrPrimitiveType::kTriangleStrip);
+                        meshes[m].setNonIndexedNonInstanced(4);
                     }
-                    meshes[m].setIndexedPatterned(ibuffer.get(), 6, 4, quadCnt,
-                                                  GrResourceProvider::QuadCountOfQuadBuffer());
-                } else {
-                    meshes[m].setPrimitiveType(GrPrimitiveType::kTriangleStrip);
-                    meshes[m].setNonIndexedNonInstanced(4);
+                    meshes[m].setVertexData(vbuffer, vertexOffsetInBuffer);
+                    meshQuadsLeft = quadCnt;
                 }
-                meshes[m].setVertexData(vbuffer, vertexOffsetInBuffer);
-                if (dynamicStateArrays) {
-                    dynamicStateArrays->fPrimitiveProcessorTextures[m] = proxy;
-                }
-                ++m;
-                numAllocatedVertices -= meshVertexCnt;
-                numQuadVerticesLeft -= meshVertexCnt;
-                vertexOffsetInBuffer += meshVertexCnt;
-                vdata = reinterpret_cast<char*>(vdata) + vertexSize * meshVertexCnt;
+
+                int quadCnt = op.fProxies[p].fQuadCnt;
+                auto* proxy = op.fProxies[p].fProxy;
+                (op.*(kTessFnsAndVertexSizes[tessFnIdx].fTessFn))(vdata, gp.get(), proxy,
+                                                                  textureIdxs[i], q, quadCnt);
+                vdata = reinterpret_cast<char*>(vdata) + vertexSize * quadCnt * 4;
                 q += quadCnt;
+
+                meshQuadsLeft -= quadCnt;
+                SkASSERT(meshQuadsLeft >= 0);
+                if (!meshQuadsLeft) {
+                    ++m;
+                    numAllocatedVertices -= meshVertexCnt;
+                    numQuadVerticesLeft -= meshVertexCnt;
+                    vertexOffsetInBuffer += meshVertexCnt;
+                }
             }
         }
+        SkASSERT(m == numMeshes);
         SkASSERT(!numQuadVerticesLeft);
         SkASSERT(!numAllocatedVertices);
         target->draw(std::move(gp), pipeline, fixedDynamicState, dynamicStateArrays, meshes,
-                     numProxies);
+                     numMeshes);
     }
 
     CombineResult onCombineIfPossible(GrOp* t, const GrCaps& caps) override {
@@ -12,8 +12,10 @@
 
 GrAtlasManager::GrAtlasManager(GrProxyProvider* proxyProvider, GrGlyphCache* glyphCache,
                                size_t maxTextureBytes,
-                               GrDrawOpAtlas::AllowMultitexturing allowMultitexturing)
+                               GrDrawOpAtlas::AllowMultitexturing allowMultitexturing,
+                               int maxPages)
             : fAllowMultitexturing{allowMultitexturing}
+            , fMaxPages{maxPages}
             , fProxyProvider{proxyProvider}
             , fCaps{fProxyProvider->refCaps()}
             , fGlyphCache{glyphCache}
@@ -41,6 +43,14 @@ void GrAtlasManager::freeAll() {
     }
 }
 
+GrDrawOpAtlas::Stats GrAtlasManager::atlasStats(GrMaskFormat format) const {
+    int atlasIndex = MaskFormatToAtlasIndex(this->resolveMaskFormat(format));
+    if (!fAtlases[atlasIndex]) {
+        return GrDrawOpAtlas::Stats();
+    }
+    return fAtlases[atlasIndex]->stats();
+}
+
 bool GrAtlasManager::hasGlyph(GrGlyph* glyph) {
     SkASSERT(glyph);
     return this->getAtlas(glyph->fMaskFormat)->hasID(glyph->fID);
@@ -171,6 +181,9 @@ bool GrAtlasManager::initAtlas(GrMaskFormat format) {
         if (!fAtlases[index]) {
             return false;
         }
+        if (fMaxPages > 0) {
+            fAtlases[index]->setMaxPages(fMaxPages);
+        }
     }
     return true;
 }
@@ -27,7 +27,8 @@ struct GrGlyph;
 class GrAtlasManager : public GrOnFlushCallbackObject {
 public:
     GrAtlasManager(GrProxyProvider*, GrGlyphCache*,
-                   size_t maxTextureBytes, GrDrawOpAtlas::AllowMultitexturing);
+                   size_t maxTextureBytes, GrDrawOpAtlas::AllowMultitexturing,
+                   int maxPages = -1);
     ~GrAtlasManager() override;
 
     // Change an expected 565 mask format to 8888 if 565 is not supported (will happen when using
@@ -86,6 +87,9 @@ public:
         return this->getAtlas(format)->atlasGeneration();
     }
 
+    // How much the atlas for this format has churned, or all zeros if it hasn't been created.
+    GrDrawOpAtlas::Stats atlasStats(GrMaskFormat) const;
+
     // GrOnFlushCallbackObject overrides
 
     void preFlush(GrOnFlushResourceProvider* onFlushResourceProvider, const uint32_t*, int,
@@ -143,6 +147,7 @@ private:
     }
 
     GrDrawOpAtlas::AllowMultitexturing fAllowMultitexturing;
+    int fMaxPages;
     std::unique_ptr<GrDrawOpAtlas> fAtlases[kMaskFormatCount];
     GrProxyProvider* fProxyProvider;
     sk_sp<const GrCaps> fCaps;
@@ -159,11 +159,6 @@ bool GrTextBlob::mustRegenerate(const SkPaint& paint, bool anyRunHasSubpixelPosi
         return true;
     }
 
-    /** This could be relaxed for blobs with only distance field glyphs. */
-    if (fInitialViewMatrix.hasPerspective() && !fInitialViewMatrix.cheapEqualTo(viewMatrix)) {
-        return true;
-    }
-
     // We only cache one masked version
     if (fKey.fHasBlur &&
         (fBlurRec.fSigma != blurRec.fSigma || fBlurRec.fStyle != blurRec.fStyle)) {
@@ -178,6 +173,13 @@ bool GrTextBlob::mustRegenerate(const SkPaint& paint, bool anyRunHasSubpixelPosi
         return true;
     }
 
+    // Distance field and path glyphs are positioned in source space and mapped by the view
+    // matrix at draw time, so only bitmap glyphs tie a perspective blob to one matrix.  Under
+    // perspective distance fields always use the medium size, and glyphs are always paths.
+    if (fInitialViewMatrix.hasPerspective()) {
+        return this->hasBitmap() && !fInitialViewMatrix.cheapEqualTo(viewMatrix);
+    }
+
     // Mixed blobs must be regenerated.  We could probably figure out a way to do integer scrolls
     // for mixed blobs if this becomes an issue.
     if (this->hasBitmap() && this->hasDistanceField()) {
@@ -215,20 +217,27 @@ bool GrTextBlob::mustRegenerate(const SkPaint& paint, bool anyRunHasSubpixelPosi
                 return true;
             }
         }
-    } else if (this->hasDistanceField()) {
+        return false;
+    }
+
+    // What is left are distance field and path glyphs, which are reusable across scales as long
+    // as every run would still pick the same distance field size, or still be drawn as paths.
+    SkScalar newMaxScale = viewMatrix.getMaxScale();
+    SkScalar oldMaxScale = fInitialViewMatrix.getMaxScale();
+    SkScalar scaleAdjust = newMaxScale / oldMaxScale;
+    if (this->hasDistanceField()) {
         // A scale outside of [blob.fMaxMinScale, blob.fMinMaxScale] would result in a different
         // distance field being generated, so we have to regenerate in those cases
-        SkScalar newMaxScale = viewMatrix.getMaxScale();
-        SkScalar oldMaxScale = fInitialViewMatrix.getMaxScale();
-        SkScalar scaleAdjust = newMaxScale / oldMaxScale;
         if (scaleAdjust < fMaxMinScale || scaleAdjust > fMinMaxScale) {
             return true;
         }
     }
+    if (this->hasPaths() && scaleAdjust < fMinPathScale) {
+        return true;
+    }
 
-    // It is possible that a blob has neither distanceField nor bitmaptext.  This is in the case
-    // when all of the runs inside the blob are drawn as paths.  In this case, we always regenerate
-    // the blob anyways at flush time, so no need to regenerate explicitly
+    // It is possible that a blob has neither distanceField nor bitmaptext nor paths, when all of
+    // its glyphs are empty.  There is nothing to regenerate in that case.
     return false;
 }
 
@@ -462,6 +471,7 @@ void GrTextBlob::AssertEqual(const GrTextBlob& l, const GrTextBlob& r) {
     //SkASSERT_RELEASE(l.fPaintColor == r.fPaintColor); // Colors might not actually be identical
     SkASSERT_RELEASE(l.fMaxMinScale == r.fMaxMinScale);
     SkASSERT_RELEASE(l.fMinMaxScale == r.fMinMaxScale);
+    SkASSERT_RELEASE(l.fMinPathScale == r.fMinPathScale);
     SkASSERT_RELEASE(l.fTextType == r.fTextType);
 
     SkASSERT_RELEASE(l.fRunCount == r.fRunCount);
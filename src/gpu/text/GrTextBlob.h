@@ -116,9 +116,18 @@ public:
 
     bool hasDistanceField() const { return SkToBool(fTextType & kHasDistanceField_TextType); }
     bool hasBitmap() const { return SkToBool(fTextType & kHasBitmap_TextType); }
+    bool hasPaths() const { return SkToBool(fTextType & kHasPaths_TextType); }
     void setHasDistanceField() { fTextType |= kHasDistanceField_TextType; }
     void setHasBitmap() { fTextType |= kHasBitmap_TextType; }
 
+    // Path glyphs are transformed by the view matrix at draw time, so they stay valid under any
+    // scale.  minScale is the smallest scale, relative to the initial view matrix, at which the
+    // run would still be drawn as paths; below it the blob is regenerated to get masks back.
+    void setHasPaths(SkScalar minScale) {
+        fTextType |= kHasPaths_TextType;
+        fMinPathScale = SkMaxScalar(minScale, fMinPathScale);
+    }
+
     int runCount() const { return fRunCount; }
 
     void push_back_run(int currRun) {
@@ -284,6 +293,7 @@ private:
     GrTextBlob()
         : fMaxMinScale(-SK_ScalarMax)
         , fMinMaxScale(SK_ScalarMax)
+        , fMinPathScale(0)
         , fTextType(0) {}
 
 
@@ -525,6 +535,7 @@ private:
     enum TextType {
         kHasDistanceField_TextType = 0x1,
         kHasBitmap_TextType = 0x2,
+        kHasPaths_TextType = 0x4,
     };
 
     // all glyph / vertex offsets are into these pools.
@@ -546,6 +557,8 @@ private:
     // maximum minimum scale, and minimum maximum scale, we can support before we need to regen
     SkScalar fMaxMinScale;
     SkScalar fMinMaxScale;
+    // The largest of the path runs' minimum scales; see setHasPaths().
+    SkScalar fMinPathScale;
     int fRunCount;
     uint8_t fTextType;
 };
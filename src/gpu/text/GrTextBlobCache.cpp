@@ -55,6 +55,18 @@ void GrTextBlobCache::purgeStaleBlobs() {
     }
 }
 
+size_t GrTextBlobCache::purgeBytes(size_t bytes) {
+    const size_t before = fCurrentSize;
+    while (before - fCurrentSize < bytes) {
+        GrTextBlob* lruBlob = fBlobList.tail();
+        if (!lruBlob) {
+            break;
+        }
+        this->remove(lruBlob);
+    }
+    return before - fCurrentSize;
+}
+
 void GrTextBlobCache::checkPurge(GrTextBlob* blob) {
     // First, purge all stale blob IDs.
     this->purgeStaleBlobs();
@@ -108,6 +108,11 @@ public:
         }
     }
 
+    size_t usedBytes() const { return fCurrentSize; }
+
+    // Purges at least bytes of blobs, least recently used first. Returns the bytes freed.
+    size_t purgeBytes(size_t bytes);
+
     void setBudget(size_t budget) {
         fSizeBudget = budget;
         this->checkPurge();
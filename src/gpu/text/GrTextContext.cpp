@@ -10,7 +10,6 @@
 #include "GrCaps.h"
 #include "GrContext.h"
 #include "GrContextPriv.h"
-#include "GrSDFMaskFilter.h"
 #include "GrTextBlobCache.h"
 #include "SkDistanceFieldGen.h"
 #include "SkDraw.h"
@@ -21,6 +20,7 @@
 #include "SkMakeUnique.h"
 #include "SkMaskFilterBase.h"
 #include "SkPaintPriv.h"
+#include "SkSDFMaskFilter.h"
 #include "SkTo.h"
 #include "ops/GrMeshDrawOp.h"
 
@@ -191,7 +191,7 @@ void GrTextContext::InitDistanceFieldPaint(GrTextBlob* blob,
     skPaint->setHinting(SkPaint::kNormal_Hinting);
     skPaint->setSubpixelText(true);
 
-    skPaint->setMaskFilter(GrSDFMaskFilter::Make());
+    skPaint->setMaskFilter(SkSDFMaskFilter::Make());
 
     // We apply the fake-gamma by altering the distance in the shader, so we ignore the
     // passed-in scaler context flags. (It's only used when we fall-back to bitmap text).
@@ -8,6 +8,7 @@
 #include "GrVkBuffer.h"
 #include "GrVkGpu.h"
 #include "GrVkMemory.h"
+#include "GrVkResourceProvider.h"
 #include "GrVkTransferBuffer.h"
 #include "GrVkUtil.h"
 
@@ -20,6 +21,16 @@
 #endif
 
 const GrVkBuffer::Resource* GrVkBuffer::Create(const GrVkGpu* gpu, const Desc& desc) {
+    bool persistentlyMapped = desc.fDynamic && (kVertex_Type == desc.fType ||
+                                                kIndex_Type == desc.fType);
+    if (persistentlyMapped) {
+        GrVkResourceProvider& provider = const_cast<GrVkGpu*>(gpu)->resourceProvider();
+        if (const GrVkResource* resource = provider.findDynamicBufferResource(desc.fType,
+                                                                              desc.fSizeInBytes)) {
+            return static_cast<const Resource*>(resource);
+        }
+    }
+
     VkBuffer       buffer;
     GrVkAlloc      alloc;
 
@@ -70,12 +81,17 @@ const GrVkBuffer::Resource* GrVkBuffer::Create(const GrVkGpu* gpu, const Desc& d
         return nullptr;
     }
 
-    const GrVkBuffer::Resource* resource = new GrVkBuffer::Resource(buffer, alloc, desc.fType);
+    GrVkBuffer::Resource* resource = new GrVkBuffer::Resource(buffer, alloc, desc.fType);
     if (!resource) {
         VK_CALL(gpu, DestroyBuffer(gpu->device(), buffer, nullptr));
         GrVkMemory::FreeBufferMemory(gpu, desc.fType, alloc);
         return nullptr;
     }
+    resource->fSizeInBytes = desc.fSizeInBytes;
+    if (persistentlyMapped) {
+        // If this fails the buffer is mapped each time it is written instead.
+        resource->fMapPtr = GrVkMemory::MapAlloc(gpu, alloc);
+    }
 
     return resource;
 }
@@ -105,10 +121,21 @@ void GrVkBuffer::addMemoryBarrier(const GrVkGpu* gpu,
 void GrVkBuffer::Resource::freeGPUData(const GrVkGpu* gpu) const {
     SkASSERT(fBuffer);
     SkASSERT(fAlloc.fMemory);
+    if (fMapPtr) {
+        GrVkMemory::UnmapAlloc(gpu, fAlloc);
+    }
     VK_CALL(gpu, DestroyBuffer(gpu->device(), fBuffer, nullptr));
     GrVkMemory::FreeBufferMemory(gpu, fType, fAlloc);
 }
 
+void GrVkBuffer::Resource::onRecycle(GrVkGpu* gpu) const {
+    if (fMapPtr) {
+        gpu->resourceProvider().recycleDynamicBufferResource(fType, fSizeInBytes, this);
+    } else {
+        this->unref(gpu);
+    }
+}
+
 void GrVkBuffer::vkRelease(const GrVkGpu* gpu) {
     VALIDATE();
     fResource->recycle(const_cast<GrVkGpu*>(gpu));
@@ -148,7 +175,8 @@ void GrVkBuffer::internalMap(GrVkGpu* gpu, size_t size, bool* createdNewBuffer)
     VALIDATE();
     SkASSERT(!this->vkIsMapped());
 
-    if (!fResource->unique()) {
+    // A buffer the GPU copies into is mapped to read what it wrote, so it is never replaced.
+    if (!fResource->unique() && kCopyWrite_Type != fDesc.fType) {
         if (fDesc.fDynamic) {
             // in use by the command buffer, so we need to create a new one
             fResource->recycle(gpu);
@@ -173,7 +201,14 @@ void GrVkBuffer::internalMap(GrVkGpu* gpu, size_t size, bool* createdNewBuffer)
         SkASSERT(alloc.fSize >= size);
         SkASSERT(0 == fOffset);
 
-        fMapPtr = GrVkMemory::MapAlloc(gpu, alloc);
+        if (fResource->fMapPtr) {
+            fMapPtr = fResource->fMapPtr;
+        } else {
+            fMapPtr = GrVkMemory::MapAlloc(gpu, alloc);
+            if (fMapPtr && kCopyWrite_Type == fDesc.fType) {
+                GrVkMemory::InvalidateMappedAlloc(gpu, alloc, 0, alloc.fSize);
+            }
+        }
     } else {
         if (!fMapPtr) {
             fMapPtr = new unsigned char[this->size()];
@@ -195,7 +230,9 @@ void GrVkBuffer::internalUnmap(GrVkGpu* gpu, size_t size) {
         SkASSERT(0 == fOffset);
 
         GrVkMemory::FlushMappedAlloc(gpu, alloc, 0, size);
-        GrVkMemory::UnmapAlloc(gpu, alloc);
+        if (!fResource->fMapPtr) {
+            GrVkMemory::UnmapAlloc(gpu, alloc);
+        }
         fMapPtr = nullptr;
     } else {
         // vkCmdUpdateBuffer requires size < 64k and 4-byte alignment.
@@ -58,7 +58,8 @@ protected:
     class Resource : public GrVkRecycledResource {
     public:
         Resource(VkBuffer buf, const GrVkAlloc& alloc, Type type)
-            : INHERITED(), fBuffer(buf), fAlloc(alloc), fType(type) {}
+            : INHERITED(), fBuffer(buf), fAlloc(alloc), fType(type), fSizeInBytes(0)
+            , fMapPtr(nullptr) {}
 
 #ifdef SK_TRACE_VK_RESOURCES
         void dumpInfo() const override {
@@ -68,11 +69,16 @@ protected:
         VkBuffer           fBuffer;
         GrVkAlloc          fAlloc;
         Type               fType;
+        // Dynamic vertex and index buffers stay mapped for as long as they live. Once no command
+        // buffer uses them anymore they go back to the resource provider, to be reused by the next
+        // buffer of the same type and size.
+        size_t             fSizeInBytes;
+        void*              fMapPtr;
 
     private:
         void freeGPUData(const GrVkGpu* gpu) const override;
 
-        void onRecycle(GrVkGpu* gpu) const override { this->unref(gpu); }
+        void onRecycle(GrVkGpu* gpu) const override;
 
         typedef GrVkRecycledResource INHERITED;
     };
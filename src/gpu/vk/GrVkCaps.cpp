@@ -33,6 +33,7 @@ GrVkCaps::GrVkCaps(const GrContextOptions& contextOptions, const GrVkInterface*
     fInstanceAttribSupport = true;
 
     fFenceSyncSupport = true;   // always available in Vulkan
+    fTransferBufferSupport = true;
     fCrossContextTextureSupport = true;
     fHalfFloatVertexAttributeSupport = true;
 
@@ -527,6 +528,10 @@ void GrVkCaps::initShaderCaps(const VkPhysicalDeviceProperties& properties,
                                        SkTMin(properties.limits.maxPerStageDescriptorSampledImages,
                                               properties.limits.maxPerStageDescriptorSamplers),
                                               (uint32_t)INT_MAX);
+
+    // Multitextured image draws trade draw calls for a branchier fragment shader, which only pays
+    // off for small images.
+    shaderCaps->fDisableImageMultitexturingDstRectAreaThreshold = 256 * 256;
 }
 
 bool stencil_format_supported(const GrVkInterface* interface,
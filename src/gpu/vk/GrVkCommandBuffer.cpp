@@ -22,6 +22,7 @@
 #include "GrVkUtil.h"
 #include "GrVkVertexBuffer.h"
 #include "SkRect.h"
+#include "SkTaskGroup.h"
 
 void GrVkCommandBuffer::invalidateState() {
     for (auto& boundInputBuffer : fBoundInputBuffers) {
@@ -54,8 +55,11 @@ void GrVkCommandBuffer::freeGPUData(const GrVkGpu* gpu) const {
         fTrackedRecordingResources[i]->unref(gpu);
     }
 
-    GR_VK_CALL(gpu->vkInterface(), FreeCommandBuffers(gpu->device(), gpu->cmdPool(),
-                                                      1, &fCmdBuffer));
+    {
+        SkAutoMutexAcquire lock(fCmdPoolMutex);
+        GR_VK_CALL(gpu->vkInterface(), FreeCommandBuffers(gpu->device(), fCmdPool, 1,
+                                                          &fCmdBuffer));
+    }
 
     this->onFreeGPUData(gpu);
 }
@@ -107,7 +111,10 @@ void GrVkCommandBuffer::reset(GrVkGpu* gpu) {
 
     // we will retain resources for later use
     VkCommandBufferResetFlags flags = 0;
-    GR_VK_CALL(gpu->vkInterface(), ResetCommandBuffer(fCmdBuffer, flags));
+    {
+        SkAutoMutexAcquire lock(fCmdPoolMutex);
+        GR_VK_CALL(gpu->vkInterface(), ResetCommandBuffer(fCmdBuffer, flags));
+    }
 
     this->onReset(gpu);
 }
@@ -175,13 +182,17 @@ void GrVkCommandBuffer::bindInputBuffer(GrVkGpu* gpu, uint32_t binding,
     // to know if we can skip binding or not.
     if (vkBuffer != fBoundInputBuffers[binding]) {
         VkDeviceSize offset = vbuffer->offset();
-        GR_VK_CALL(gpu->vkInterface(), CmdBindVertexBuffers(fCmdBuffer,
-                                                            binding,
-                                                            1,
-                                                            &vkBuffer,
-                                                            &offset));
+        if (fDeferredCommands) {
+            fDeferredCommands->bindVertexBuffer(binding, vkBuffer, offset);
+        } else {
+            GR_VK_CALL(gpu->vkInterface(), CmdBindVertexBuffers(fCmdBuffer,
+                                                                binding,
+                                                                1,
+                                                                &vkBuffer,
+                                                                &offset));
+        }
         fBoundInputBuffers[binding] = vkBuffer;
-        addResource(vbuffer->resource());
+        this->addRecycledResource(vbuffer->resource());
     }
 }
 
@@ -191,12 +202,16 @@ void GrVkCommandBuffer::bindIndexBuffer(GrVkGpu* gpu, const GrVkIndexBuffer* ibu
     // TODO: once ibuffer->offset() no longer always returns 0, we will need to track the offset
     // to know if we can skip binding or not.
     if (vkBuffer != fBoundIndexBuffer) {
-        GR_VK_CALL(gpu->vkInterface(), CmdBindIndexBuffer(fCmdBuffer,
-                                                          vkBuffer,
-                                                          ibuffer->offset(),
-                                                          VK_INDEX_TYPE_UINT16));
+        if (fDeferredCommands) {
+            fDeferredCommands->bindIndexBuffer(vkBuffer, ibuffer->offset());
+        } else {
+            GR_VK_CALL(gpu->vkInterface(), CmdBindIndexBuffer(fCmdBuffer,
+                                                              vkBuffer,
+                                                              ibuffer->offset(),
+                                                              VK_INDEX_TYPE_UINT16));
+        }
         fBoundIndexBuffer = vkBuffer;
-        addResource(ibuffer->resource());
+        this->addRecycledResource(ibuffer->resource());
     }
 }
 
@@ -218,6 +233,10 @@ void GrVkCommandBuffer::clearAttachments(const GrVkGpu* gpu,
         }
     }
 #endif
+    if (fDeferredCommands) {
+        fDeferredCommands->clearAttachments(numAttachments, attachments, numRects, clearRects);
+        return;
+    }
     GR_VK_CALL(gpu->vkInterface(), CmdClearAttachments(fCmdBuffer,
                                                        numAttachments,
                                                        attachments,
@@ -234,14 +253,19 @@ void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
                                            uint32_t dynamicOffsetCount,
                                            const uint32_t* dynamicOffsets) {
     SkASSERT(fIsActive);
-    GR_VK_CALL(gpu->vkInterface(), CmdBindDescriptorSets(fCmdBuffer,
-                                                         VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                         layout->layout(),
-                                                         firstSet,
-                                                         setCount,
-                                                         descriptorSets,
-                                                         dynamicOffsetCount,
-                                                         dynamicOffsets));
+    if (fDeferredCommands) {
+        fDeferredCommands->bindDescriptorSets(layout->layout(), firstSet, setCount,
+                                              descriptorSets, dynamicOffsetCount, dynamicOffsets);
+    } else {
+        GR_VK_CALL(gpu->vkInterface(), CmdBindDescriptorSets(fCmdBuffer,
+                                                             VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                             layout->layout(),
+                                                             firstSet,
+                                                             setCount,
+                                                             descriptorSets,
+                                                             dynamicOffsetCount,
+                                                             dynamicOffsets));
+    }
     this->addRecordingResource(layout);
 }
 
@@ -255,14 +279,19 @@ void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
                                            uint32_t dynamicOffsetCount,
                                            const uint32_t* dynamicOffsets) {
     SkASSERT(fIsActive);
-    GR_VK_CALL(gpu->vkInterface(), CmdBindDescriptorSets(fCmdBuffer,
-                                                         VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                         layout->layout(),
-                                                         firstSet,
-                                                         setCount,
-                                                         descriptorSets,
-                                                         dynamicOffsetCount,
-                                                         dynamicOffsets));
+    if (fDeferredCommands) {
+        fDeferredCommands->bindDescriptorSets(layout->layout(), firstSet, setCount,
+                                              descriptorSets, dynamicOffsetCount, dynamicOffsets);
+    } else {
+        GR_VK_CALL(gpu->vkInterface(), CmdBindDescriptorSets(fCmdBuffer,
+                                                             VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                             layout->layout(),
+                                                             firstSet,
+                                                             setCount,
+                                                             descriptorSets,
+                                                             dynamicOffsetCount,
+                                                             dynamicOffsets));
+    }
     this->addRecordingResource(layout);
     for (int i = 0; i < recycled.count(); ++i) {
         this->addRecycledResource(recycled[i]);
@@ -274,9 +303,13 @@ void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
 
 void GrVkCommandBuffer::bindPipeline(const GrVkGpu* gpu, const GrVkPipeline* pipeline) {
     SkASSERT(fIsActive);
-    GR_VK_CALL(gpu->vkInterface(), CmdBindPipeline(fCmdBuffer,
-                                                   VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                   pipeline->pipeline()));
+    if (fDeferredCommands) {
+        fDeferredCommands->bindPipeline(pipeline->pipeline());
+    } else {
+        GR_VK_CALL(gpu->vkInterface(), CmdBindPipeline(fCmdBuffer,
+                                                       VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                       pipeline->pipeline()));
+    }
     this->addResource(pipeline);
 }
 
@@ -288,6 +321,11 @@ void GrVkCommandBuffer::drawIndexed(const GrVkGpu* gpu,
                                     uint32_t firstInstance) const {
     SkASSERT(fIsActive);
     SkASSERT(fActiveRenderPass);
+    if (fDeferredCommands) {
+        fDeferredCommands->drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset,
+                                       firstInstance);
+        return;
+    }
     GR_VK_CALL(gpu->vkInterface(), CmdDrawIndexed(fCmdBuffer,
                                                   indexCount,
                                                   instanceCount,
@@ -303,6 +341,10 @@ void GrVkCommandBuffer::draw(const GrVkGpu* gpu,
                              uint32_t firstInstance) const {
     SkASSERT(fIsActive);
     SkASSERT(fActiveRenderPass);
+    if (fDeferredCommands) {
+        fDeferredCommands->draw(vertexCount, instanceCount, firstVertex, firstInstance);
+        return;
+    }
     GR_VK_CALL(gpu->vkInterface(), CmdDraw(fCmdBuffer,
                                            vertexCount,
                                            instanceCount,
@@ -317,10 +359,15 @@ void GrVkCommandBuffer::setViewport(const GrVkGpu* gpu,
     SkASSERT(fIsActive);
     SkASSERT(1 == viewportCount);
     if (memcmp(viewports, &fCachedViewport, sizeof(VkViewport))) {
-        GR_VK_CALL(gpu->vkInterface(), CmdSetViewport(fCmdBuffer,
-                                                      firstViewport,
-                                                      viewportCount,
-                                                      viewports));
+        if (fDeferredCommands) {
+            SkASSERT(0 == firstViewport);
+            fDeferredCommands->setViewport(viewports[0]);
+        } else {
+            GR_VK_CALL(gpu->vkInterface(), CmdSetViewport(fCmdBuffer,
+                                                          firstViewport,
+                                                          viewportCount,
+                                                          viewports));
+        }
         fCachedViewport = viewports[0];
     }
 }
@@ -332,10 +379,15 @@ void GrVkCommandBuffer::setScissor(const GrVkGpu* gpu,
     SkASSERT(fIsActive);
     SkASSERT(1 == scissorCount);
     if (memcmp(scissors, &fCachedScissor, sizeof(VkRect2D))) {
-        GR_VK_CALL(gpu->vkInterface(), CmdSetScissor(fCmdBuffer,
-                                                     firstScissor,
-                                                     scissorCount,
-                                                     scissors));
+        if (fDeferredCommands) {
+            SkASSERT(0 == firstScissor);
+            fDeferredCommands->setScissor(scissors[0]);
+        } else {
+            GR_VK_CALL(gpu->vkInterface(), CmdSetScissor(fCmdBuffer,
+                                                         firstScissor,
+                                                         scissorCount,
+                                                         scissors));
+        }
         fCachedScissor = scissors[0];
     }
 }
@@ -344,7 +396,11 @@ void GrVkCommandBuffer::setBlendConstants(const GrVkGpu* gpu,
                                           const float blendConstants[4]) {
     SkASSERT(fIsActive);
     if (memcmp(blendConstants, fCachedBlendConstant, 4 * sizeof(float))) {
-        GR_VK_CALL(gpu->vkInterface(), CmdSetBlendConstants(fCmdBuffer, blendConstants));
+        if (fDeferredCommands) {
+            fDeferredCommands->setBlendConstants(blendConstants);
+        } else {
+            GR_VK_CALL(gpu->vkInterface(), CmdSetBlendConstants(fCmdBuffer, blendConstants));
+        }
         memcpy(fCachedBlendConstant, blendConstants, 4 * sizeof(float));
     }
 }
@@ -374,7 +430,7 @@ GrVkPrimaryCommandBuffer* GrVkPrimaryCommandBuffer::Create(const GrVkGpu* gpu,
     if (err) {
         return nullptr;
     }
-    return new GrVkPrimaryCommandBuffer(cmdBuffer);
+    return new GrVkPrimaryCommandBuffer(cmdBuffer, cmdPool);
 }
 
 void GrVkPrimaryCommandBuffer::begin(const GrVkGpu* gpu) {
@@ -803,7 +859,8 @@ void GrVkPrimaryCommandBuffer::onFreeGPUData(const GrVkGpu* gpu) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 GrVkSecondaryCommandBuffer* GrVkSecondaryCommandBuffer::Create(const GrVkGpu* gpu,
-                                                               VkCommandPool cmdPool) {
+                                                               VkCommandPool cmdPool,
+                                                               SkMutex* cmdPoolMutex) {
     const VkCommandBufferAllocateInfo cmdInfo = {
         VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,   // sType
         nullptr,                                          // pNext
@@ -813,29 +870,25 @@ GrVkSecondaryCommandBuffer* GrVkSecondaryCommandBuffer::Create(const GrVkGpu* gp
     };
 
     VkCommandBuffer cmdBuffer;
+    SkAutoMutexAcquire lock(cmdPoolMutex);
     VkResult err = GR_VK_CALL(gpu->vkInterface(), AllocateCommandBuffers(gpu->device(),
                                                                          &cmdInfo,
                                                                          &cmdBuffer));
     if (err) {
         return nullptr;
     }
-    return new GrVkSecondaryCommandBuffer(cmdBuffer);
+    return new GrVkSecondaryCommandBuffer(cmdBuffer, cmdPool, cmdPoolMutex);
 }
 
-
-void GrVkSecondaryCommandBuffer::begin(const GrVkGpu* gpu, const GrVkFramebuffer* framebuffer,
-                                       const GrVkRenderPass* compatibleRenderPass) {
-    SkASSERT(!fIsActive);
-    SkASSERT(compatibleRenderPass);
-    fActiveRenderPass = compatibleRenderPass;
-
+static void begin_secondary_command_buffer(const GrVkGpu* gpu, VkCommandBuffer cmdBuffer,
+                                           VkRenderPass renderPass, VkFramebuffer framebuffer) {
     VkCommandBufferInheritanceInfo inheritanceInfo;
     memset(&inheritanceInfo, 0, sizeof(VkCommandBufferInheritanceInfo));
     inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
     inheritanceInfo.pNext = nullptr;
-    inheritanceInfo.renderPass = fActiveRenderPass->vkRenderPass();
+    inheritanceInfo.renderPass = renderPass;
     inheritanceInfo.subpass = 0; // Currently only using 1 subpass for each render pass
-    inheritanceInfo.framebuffer = framebuffer ? framebuffer->framebuffer() : VK_NULL_HANDLE;
+    inheritanceInfo.framebuffer = framebuffer;
     inheritanceInfo.occlusionQueryEnable = false;
     inheritanceInfo.queryFlags = 0;
     inheritanceInfo.pipelineStatistics = 0;
@@ -848,15 +901,61 @@ void GrVkSecondaryCommandBuffer::begin(const GrVkGpu* gpu, const GrVkFramebuffer
                                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     cmdBufferBeginInfo.pInheritanceInfo = &inheritanceInfo;
 
-    GR_VK_CALL_ERRCHECK(gpu->vkInterface(), BeginCommandBuffer(fCmdBuffer,
+    GR_VK_CALL_ERRCHECK(gpu->vkInterface(), BeginCommandBuffer(cmdBuffer,
                                                                &cmdBufferBeginInfo));
+}
+
+void GrVkSecondaryCommandBuffer::begin(const GrVkGpu* gpu, const GrVkFramebuffer* framebuffer,
+                                       const GrVkRenderPass* compatibleRenderPass) {
+    SkASSERT(!fIsActive);
+    SkASSERT(!fRecordingPending);
+    SkASSERT(compatibleRenderPass);
+    fActiveRenderPass = compatibleRenderPass;
+
+    VkFramebuffer vkFramebuffer = framebuffer ? framebuffer->framebuffer() : VK_NULL_HANDLE;
+    if (fDeferredCommands) {
+        fDeferredRenderPass = fActiveRenderPass->vkRenderPass();
+        fDeferredFramebuffer = vkFramebuffer;
+    } else {
+        begin_secondary_command_buffer(gpu, fCmdBuffer, fActiveRenderPass->vkRenderPass(),
+                                       vkFramebuffer);
+    }
     fIsActive = true;
 }
 
 void GrVkSecondaryCommandBuffer::end(const GrVkGpu* gpu) {
     SkASSERT(fIsActive);
-    GR_VK_CALL_ERRCHECK(gpu->vkInterface(), EndCommandBuffer(fCmdBuffer));
+    if (fDeferredCommands) {
+        SkASSERT(gpu->recordingTaskGroup());
+        // The render pass, framebuffer and everything the commands use are kept alive by the
+        // resources we track, and nothing touches this command buffer until waitForRecording().
+        fRecordingPending = true;
+        gpu->recordingTaskGroup()->add([this, gpu] {
+            SkAutoMutexAcquire lock(fCmdPoolMutex);
+            begin_secondary_command_buffer(gpu, fCmdBuffer, fDeferredRenderPass,
+                                           fDeferredFramebuffer);
+            fDeferredCommands->replay(gpu->vkInterface(), fCmdBuffer);
+            GR_VK_CALL_ERRCHECK(gpu->vkInterface(), EndCommandBuffer(fCmdBuffer));
+            lock.release();
+            fRecorded.signal();
+        });
+    } else {
+        GR_VK_CALL_ERRCHECK(gpu->vkInterface(), EndCommandBuffer(fCmdBuffer));
+    }
     this->invalidateState();
     fIsActive = false;
 }
 
+void GrVkSecondaryCommandBuffer::waitForRecording() {
+    if (fRecordingPending) {
+        fRecorded.wait();
+        fRecordingPending = false;
+    }
+}
+
+void GrVkSecondaryCommandBuffer::onReset(GrVkGpu* gpu) {
+    SkASSERT(!fRecordingPending);
+    if (fDeferredCommands) {
+        fDeferredCommands->reset();
+    }
+}
@@ -8,10 +8,13 @@
 #ifndef GrVkCommandBuffer_DEFINED
 #define GrVkCommandBuffer_DEFINED
 
+#include "GrVkDeferredCommands.h"
 #include "GrVkGpu.h"
 #include "GrVkResource.h"
 #include "GrVkSemaphore.h"
 #include "GrVkUtil.h"
+#include "SkMutex.h"
+#include "SkSemaphore.h"
 #include "vk/GrVkDefines.h"
 
 class GrVkBuffer;
@@ -126,10 +129,13 @@ public:
     void reset(GrVkGpu* gpu);
 
 protected:
-        GrVkCommandBuffer(VkCommandBuffer cmdBuffer, const GrVkRenderPass* rp = VK_NULL_HANDLE)
+        GrVkCommandBuffer(VkCommandBuffer cmdBuffer, VkCommandPool cmdPool, SkMutex* cmdPoolMutex,
+                          const GrVkRenderPass* rp = VK_NULL_HANDLE)
             : fIsActive(false)
             , fActiveRenderPass(rp)
             , fCmdBuffer(cmdBuffer)
+            , fCmdPool(cmdPool)
+            , fCmdPoolMutex(cmdPoolMutex)
             , fNumResets(0) {
             fTrackedResources.setReserve(kInitialTrackedResourcesCount);
             fTrackedRecycledResources.setReserve(kInitialTrackedResourcesCount);
@@ -152,6 +158,13 @@ protected:
 
         VkCommandBuffer           fCmdBuffer;
 
+        // The pool fCmdBuffer was allocated from. If the pool's command buffers are recorded on
+        // other threads fCmdPoolMutex guards it, and the commands are collected in
+        // fDeferredCommands to be recorded there, instead of going straight into fCmdBuffer.
+        VkCommandPool                         fCmdPool;
+        SkMutex*                              fCmdPoolMutex;
+        std::unique_ptr<GrVkDeferredCommands> fDeferredCommands;
+
 private:
     static const int kInitialTrackedResourcesCount = 32;
 
@@ -289,8 +302,8 @@ public:
 #endif
 
 private:
-    explicit GrVkPrimaryCommandBuffer(VkCommandBuffer cmdBuffer)
-        : INHERITED(cmdBuffer)
+    GrVkPrimaryCommandBuffer(VkCommandBuffer cmdBuffer, VkCommandPool cmdPool)
+        : INHERITED(cmdBuffer, cmdPool, nullptr)
         , fSubmitFence(VK_NULL_HANDLE) {}
 
     void onFreeGPUData(const GrVkGpu* gpu) const override;
@@ -305,12 +318,21 @@ private:
 
 class GrVkSecondaryCommandBuffer : public GrVkCommandBuffer {
 public:
-    static GrVkSecondaryCommandBuffer* Create(const GrVkGpu* gpu, VkCommandPool cmdPool);
+    /**
+     * If 'cmdPoolMutex' is not null the command buffer is recorded on the GrVkGpu's recording
+     * task group: the commands are collected until end(), and then recorded into the
+     * VkCommandBuffer on another thread while holding the mutex.
+     */
+    static GrVkSecondaryCommandBuffer* Create(const GrVkGpu* gpu, VkCommandPool cmdPool,
+                                              SkMutex* cmdPoolMutex = nullptr);
 
     void begin(const GrVkGpu* gpu, const GrVkFramebuffer* framebuffer,
                const GrVkRenderPass* compatibleRenderPass);
     void end(const GrVkGpu* gpu);
 
+    /** Blocks until the VkCommandBuffer has been recorded, if it is being recorded elsewhere. */
+    void waitForRecording();
+
 #ifdef SK_TRACE_VK_RESOURCES
     void dumpInfo() const override {
         SkDebugf("GrVkSecondaryCommandBuffer: %d (%d refs)\n", fCmdBuffer, this->getRefCnt());
@@ -318,11 +340,27 @@ public:
 #endif
 
 private:
-    explicit GrVkSecondaryCommandBuffer(VkCommandBuffer cmdBuffer)
-        : INHERITED(cmdBuffer) {
+    GrVkSecondaryCommandBuffer(VkCommandBuffer cmdBuffer, VkCommandPool cmdPool,
+                               SkMutex* cmdPoolMutex)
+        : INHERITED(cmdBuffer, cmdPool, cmdPoolMutex)
+        , fRecordingPending(false) {
+        if (cmdPoolMutex) {
+            fDeferredCommands.reset(new GrVkDeferredCommands);
+        }
+    }
+
+    void onFreeGPUData(const GrVkGpu* gpu) const override {
+        SkASSERT(!fRecordingPending);
     }
 
-    void onFreeGPUData(const GrVkGpu* gpu) const override {}
+    void onReset(GrVkGpu* gpu) override;
+
+    // Handles of the render pass and framebuffer passed to begin(), when recording is deferred.
+    VkRenderPass  fDeferredRenderPass;
+    VkFramebuffer fDeferredFramebuffer;
+
+    bool          fRecordingPending;
+    SkSemaphore   fRecorded;
 
     friend class GrVkPrimaryCommandBuffer;
 
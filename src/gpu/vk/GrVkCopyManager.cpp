@@ -245,7 +245,7 @@ bool GrVkCopyManager::copySurfaceAsDraw(GrVkGpu* gpu,
     descriptorWrites.dstBinding = GrVkUniformHandler::kGeometryBinding;
     descriptorWrites.dstArrayElement = 0;
     descriptorWrites.descriptorCount = 1;
-    descriptorWrites.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrites.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descriptorWrites.pImageInfo = nullptr;
     descriptorWrites.pBufferInfo = &uniBufferInfo;
     descriptorWrites.pTexelBufferView = nullptr;
@@ -371,6 +371,8 @@ bool GrVkCopyManager::copySurfaceAsDraw(GrVkGpu* gpu,
     descriptorResources.push_back(srcTex->textureView());
     descriptorResources.push_back(srcTex->resource());
 
+    // The uniform bindings are dynamic, but the copy's uniforms are at the start of their buffer.
+    static const uint32_t kDynamicOffsets[] = { 0, 0 };
     cmdBuffer->bindDescriptorSets(gpu,
                                   descriptorRecycledResources,
                                   descriptorResources,
@@ -378,8 +380,8 @@ bool GrVkCopyManager::copySurfaceAsDraw(GrVkGpu* gpu,
                                   0,
                                   2,
                                   vkDescSets,
-                                  0,
-                                  nullptr);
+                                  SK_ARRAY_COUNT(kDynamicOffsets),
+                                  kDynamicOffsets);
 
     // Set Dynamic viewport and stencil
     // We always use one viewport the size of the RT
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrVkDeferredCommands.h"
+
+#include "GrVkInterface.h"
+#include "GrVkUtil.h"
+
+void GrVkDeferredCommands::bindVertexBuffer(uint32_t binding, VkBuffer buffer,
+                                            VkDeviceSize offset) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kBindVertexBuffer;
+    command.fBindBuffer.fBinding = binding;
+    command.fBindBuffer.fBuffer = buffer;
+    command.fBindBuffer.fOffset = offset;
+}
+
+void GrVkDeferredCommands::bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kBindIndexBuffer;
+    command.fBindBuffer.fBinding = 0;
+    command.fBindBuffer.fBuffer = buffer;
+    command.fBindBuffer.fOffset = offset;
+}
+
+void GrVkDeferredCommands::bindPipeline(VkPipeline pipeline) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kBindPipeline;
+    command.fPipeline = pipeline;
+}
+
+void GrVkDeferredCommands::bindDescriptorSets(VkPipelineLayout layout, uint32_t firstSet,
+                                              uint32_t setCount,
+                                              const VkDescriptorSet* descriptorSets,
+                                              uint32_t dynamicOffsetCount,
+                                              const uint32_t* dynamicOffsets) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kBindDescriptorSets;
+    command.fBindDescriptorSets.fLayout = layout;
+    command.fBindDescriptorSets.fFirstSet = firstSet;
+    command.fBindDescriptorSets.fSetCount = setCount;
+    command.fBindDescriptorSets.fSetIndex = fDescriptorSets.count();
+    command.fBindDescriptorSets.fDynamicOffsetCount = dynamicOffsetCount;
+    command.fBindDescriptorSets.fDynamicOffsetIndex = fDynamicOffsets.count();
+    fDescriptorSets.push_back_n(setCount, descriptorSets);
+    fDynamicOffsets.push_back_n(dynamicOffsetCount, dynamicOffsets);
+}
+
+void GrVkDeferredCommands::setViewport(const VkViewport& viewport) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kSetViewport;
+    command.fViewport = viewport;
+}
+
+void GrVkDeferredCommands::setScissor(const VkRect2D& scissor) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kSetScissor;
+    command.fScissor = scissor;
+}
+
+void GrVkDeferredCommands::setBlendConstants(const float blendConstants[4]) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kSetBlendConstants;
+    memcpy(command.fBlendConstants, blendConstants, 4 * sizeof(float));
+}
+
+void GrVkDeferredCommands::clearAttachments(int numAttachments,
+                                            const VkClearAttachment* attachments,
+                                            int numRects, const VkClearRect* clearRects) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kClearAttachments;
+    command.fClearAttachments.fAttachmentCount = numAttachments;
+    command.fClearAttachments.fAttachmentIndex = fClearAttachments.count();
+    command.fClearAttachments.fRectCount = numRects;
+    command.fClearAttachments.fRectIndex = fClearRects.count();
+    fClearAttachments.push_back_n(numAttachments, attachments);
+    fClearRects.push_back_n(numRects, clearRects);
+}
+
+void GrVkDeferredCommands::drawIndexed(uint32_t indexCount, uint32_t instanceCount,
+                                       uint32_t firstIndex, int32_t vertexOffset,
+                                       uint32_t firstInstance) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kDrawIndexed;
+    command.fDraw.fCount = indexCount;
+    command.fDraw.fInstanceCount = instanceCount;
+    command.fDraw.fFirst = firstIndex;
+    command.fDraw.fVertexOffset = vertexOffset;
+    command.fDraw.fFirstInstance = firstInstance;
+}
+
+void GrVkDeferredCommands::draw(uint32_t vertexCount, uint32_t instanceCount,
+                                uint32_t firstVertex, uint32_t firstInstance) {
+    Command& command = fCommands.push_back();
+    command.fType = Type::kDraw;
+    command.fDraw.fCount = vertexCount;
+    command.fDraw.fInstanceCount = instanceCount;
+    command.fDraw.fFirst = firstVertex;
+    command.fDraw.fVertexOffset = 0;
+    command.fDraw.fFirstInstance = firstInstance;
+}
+
+void GrVkDeferredCommands::replay(const GrVkInterface* iface, VkCommandBuffer cmdBuffer) const {
+    for (const Command& command : fCommands) {
+        switch (command.fType) {
+            case Type::kBindVertexBuffer:
+                GR_VK_CALL(iface, CmdBindVertexBuffers(cmdBuffer, command.fBindBuffer.fBinding, 1,
+                                                       &command.fBindBuffer.fBuffer,
+                                                       &command.fBindBuffer.fOffset));
+                break;
+            case Type::kBindIndexBuffer:
+                GR_VK_CALL(iface, CmdBindIndexBuffer(cmdBuffer, command.fBindBuffer.fBuffer,
+                                                     command.fBindBuffer.fOffset,
+                                                     VK_INDEX_TYPE_UINT16));
+                break;
+            case Type::kBindPipeline:
+                GR_VK_CALL(iface, CmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                  command.fPipeline));
+                break;
+            case Type::kBindDescriptorSets: {
+                const auto& bind = command.fBindDescriptorSets;
+                GR_VK_CALL(iface, CmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                        bind.fLayout, bind.fFirstSet,
+                                                        bind.fSetCount,
+                                                        fDescriptorSets.begin() + bind.fSetIndex,
+                                                        bind.fDynamicOffsetCount,
+                                                        fDynamicOffsets.begin() +
+                                                                bind.fDynamicOffsetIndex));
+                break;
+            }
+            case Type::kSetViewport:
+                GR_VK_CALL(iface, CmdSetViewport(cmdBuffer, 0, 1, &command.fViewport));
+                break;
+            case Type::kSetScissor:
+                GR_VK_CALL(iface, CmdSetScissor(cmdBuffer, 0, 1, &command.fScissor));
+                break;
+            case Type::kSetBlendConstants:
+                GR_VK_CALL(iface, CmdSetBlendConstants(cmdBuffer, command.fBlendConstants));
+                break;
+            case Type::kClearAttachments: {
+                const auto& clear = command.fClearAttachments;
+                GR_VK_CALL(iface, CmdClearAttachments(cmdBuffer, clear.fAttachmentCount,
+                                                      fClearAttachments.begin() +
+                                                              clear.fAttachmentIndex,
+                                                      clear.fRectCount,
+                                                      fClearRects.begin() + clear.fRectIndex));
+                break;
+            }
+            case Type::kDrawIndexed:
+                GR_VK_CALL(iface, CmdDrawIndexed(cmdBuffer, command.fDraw.fCount,
+                                                 command.fDraw.fInstanceCount, command.fDraw.fFirst,
+                                                 command.fDraw.fVertexOffset,
+                                                 command.fDraw.fFirstInstance));
+                break;
+            case Type::kDraw:
+                GR_VK_CALL(iface, CmdDraw(cmdBuffer, command.fDraw.fCount,
+                                          command.fDraw.fInstanceCount, command.fDraw.fFirst,
+                                          command.fDraw.fFirstInstance));
+                break;
+        }
+    }
+}
+
+void GrVkDeferredCommands::reset() {
+    fCommands.reset();
+    fDescriptorSets.reset();
+    fDynamicOffsets.reset();
+    fClearAttachments.reset();
+    fClearRects.reset();
+}
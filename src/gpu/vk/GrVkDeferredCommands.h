@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrVkDeferredCommands_DEFINED
+#define GrVkDeferredCommands_DEFINED
+
+#include "SkTArray.h"
+#include "vk/GrVkDefines.h"
+
+struct GrVkInterface;
+
+/**
+ * A list of the Vulkan commands a secondary command buffer records inside a render pass, kept on
+ * the CPU so that they can be put into the VkCommandBuffer later, on another thread. Only the
+ * Vulkan handles and values are stored; the GrVkCommandBuffer still tracks the resources behind
+ * them when the commands are added.
+ */
+class GrVkDeferredCommands {
+public:
+    void bindVertexBuffer(uint32_t binding, VkBuffer, VkDeviceSize offset);
+    void bindIndexBuffer(VkBuffer, VkDeviceSize offset);
+    void bindPipeline(VkPipeline);
+    void bindDescriptorSets(VkPipelineLayout, uint32_t firstSet, uint32_t setCount,
+                            const VkDescriptorSet* descriptorSets, uint32_t dynamicOffsetCount,
+                            const uint32_t* dynamicOffsets);
+    void setViewport(const VkViewport&);
+    void setScissor(const VkRect2D&);
+    void setBlendConstants(const float blendConstants[4]);
+    void clearAttachments(int numAttachments, const VkClearAttachment* attachments,
+                          int numRects, const VkClearRect* clearRects);
+    void drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex,
+                     int32_t vertexOffset, uint32_t firstInstance);
+    void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex,
+              uint32_t firstInstance);
+
+    /** Records the commands into 'cmdBuffer', which must have been begun. */
+    void replay(const GrVkInterface*, VkCommandBuffer cmdBuffer) const;
+
+    void reset();
+
+private:
+    enum class Type {
+        kBindVertexBuffer,
+        kBindIndexBuffer,
+        kBindPipeline,
+        kBindDescriptorSets,
+        kSetViewport,
+        kSetScissor,
+        kSetBlendConstants,
+        kClearAttachments,
+        kDrawIndexed,
+        kDraw,
+    };
+
+    // Arrays of handles or structs are appended to the matching array below, and commands refer
+    // to them by index and count.
+    struct Command {
+        Type fType;
+        union {
+            struct {
+                uint32_t     fBinding;
+                VkBuffer     fBuffer;
+                VkDeviceSize fOffset;
+            } fBindBuffer;
+            VkPipeline fPipeline;
+            struct {
+                VkPipelineLayout fLayout;
+                uint32_t         fFirstSet;
+                uint32_t         fSetCount;
+                int              fSetIndex;
+                uint32_t         fDynamicOffsetCount;
+                int              fDynamicOffsetIndex;
+            } fBindDescriptorSets;
+            VkViewport fViewport;
+            VkRect2D   fScissor;
+            float      fBlendConstants[4];
+            struct {
+                int fAttachmentCount;
+                int fAttachmentIndex;
+                int fRectCount;
+                int fRectIndex;
+            } fClearAttachments;
+            struct {
+                uint32_t fCount;
+                uint32_t fInstanceCount;
+                uint32_t fFirst;
+                int32_t  fVertexOffset;
+                uint32_t fFirstInstance;
+            } fDraw;
+        };
+    };
+
+    SkTArray<Command, true>           fCommands;
+    SkTArray<VkDescriptorSet, true>   fDescriptorSets;
+    SkTArray<uint32_t, true>          fDynamicOffsets;
+    SkTArray<VkClearAttachment, true> fClearAttachments;
+    SkTArray<VkClearRect, true>       fClearRects;
+};
+
+#endif
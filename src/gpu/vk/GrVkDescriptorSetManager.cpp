@@ -23,7 +23,8 @@ GrVkDescriptorSetManager* GrVkDescriptorSetManager::CreateUniformManager(GrVkGpu
     }
     visibilities.push_back(geomStages);
     visibilities.push_back(kFragment_GrShaderFlag);
-    return new GrVkDescriptorSetManager(gpu, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, visibilities);
+    return new GrVkDescriptorSetManager(gpu, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                        visibilities);
 }
 
 GrVkDescriptorSetManager* GrVkDescriptorSetManager::CreateSamplerManager(
@@ -187,7 +188,7 @@ GrVkDescriptorSetManager::DescriptorPoolManager::DescriptorPoolManager(
                                                       &fDescLayout));
         fDescCountPerSet = visibilities.count();
     } else {
-        SkASSERT(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER == type);
+        SkASSERT(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC == type);
         GR_STATIC_ASSERT(2 == kUniformDescPerSet);
         SkASSERT(kUniformDescPerSet == visibilities.count());
         // Create Uniform Buffer Descriptor
@@ -197,7 +198,7 @@ GrVkDescriptorSetManager::DescriptorPoolManager::DescriptorPoolManager(
         memset(&dsUniBindings, 0, kUniformDescPerSet * sizeof(VkDescriptorSetLayoutBinding));
         for (int i = 0; i < kUniformDescPerSet; ++i) {
             dsUniBindings[i].binding = bindings[i];
-            dsUniBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            dsUniBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
             dsUniBindings[i].descriptorCount = 1;
             dsUniBindings[i].stageFlags = visibility_to_vk_stage_flags(visibilities[i]);
             dsUniBindings[i].pImmutableSamplers = nullptr;
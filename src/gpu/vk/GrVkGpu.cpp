@@ -35,6 +35,7 @@
 #include "SkConvertPixels.h"
 #include "SkMipMap.h"
 #include "SkSLCompiler.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 
 #include "vk/GrVkExtensions.h"
@@ -123,6 +124,7 @@ GrVkGpu::GrVkGpu(GrContext* context, const GrContextOptions& options,
         , fQueue(backendContext.fQueue)
         , fQueueIndex(backendContext.fGraphicsQueueIndex)
         , fResourceProvider(this)
+        , fNextRecordingCmdPool(0)
         , fDisconnected(false) {
     SkASSERT(!backendContext.fOwnsInstanceAndDevice);
 
@@ -132,8 +134,6 @@ GrVkGpu::GrVkGpu(GrContext* context, const GrContextOptions& options,
                                                           fDevice, fInterface));
     }
 
-    fCompiler = new SkSL::Compiler();
-
     uint32_t instanceVersion = backendContext.fInstanceVersion ? backendContext.fInstanceVersion
                                                                : backendContext.fMinAPIVersion;
 
@@ -178,6 +178,18 @@ GrVkGpu::GrVkGpu(GrContext* context, const GrContextOptions& options,
     GR_VK_CALL_ERRCHECK(this->vkInterface(), CreateCommandPool(fDevice, &cmdPoolInfo, nullptr,
                                                                &fCmdPool));
 
+    for (int i = 0; i < kRecordingCmdPoolCount; ++i) {
+        fRecordingCmdPools[i] = VK_NULL_HANDLE;
+    }
+    if (options.fExecutor) {
+        fRecordingTaskGroup.reset(new SkTaskGroup(*options.fExecutor));
+        for (int i = 0; i < kRecordingCmdPoolCount; ++i) {
+            GR_VK_CALL_ERRCHECK(this->vkInterface(), CreateCommandPool(fDevice, &cmdPoolInfo,
+                                                                       nullptr,
+                                                                       &fRecordingCmdPools[i]));
+        }
+    }
+
     // must call this after creating the CommandPool
     fResourceProvider.init();
     fCurrentCmdBuffer = fResourceProvider.findOrCreatePrimaryCommandBuffer();
@@ -186,6 +198,9 @@ GrVkGpu::GrVkGpu(GrContext* context, const GrContextOptions& options,
 }
 
 void GrVkGpu::destroyResources() {
+    if (fRecordingTaskGroup) {
+        fRecordingTaskGroup->wait();
+    }
     if (fCurrentCmdBuffer) {
         fCurrentCmdBuffer->end(this);
         fCurrentCmdBuffer->unref(this);
@@ -232,6 +247,11 @@ void GrVkGpu::destroyResources() {
     if (fCmdPool != VK_NULL_HANDLE) {
         VK_CALL(DestroyCommandPool(fDevice, fCmdPool, nullptr));
     }
+    for (int i = 0; i < kRecordingCmdPoolCount; ++i) {
+        if (fRecordingCmdPools[i] != VK_NULL_HANDLE) {
+            VK_CALL(DestroyCommandPool(fDevice, fRecordingCmdPools[i], nullptr));
+        }
+    }
 
     fMemoryAllocator.reset();
 
@@ -247,6 +267,13 @@ GrVkGpu::~GrVkGpu() {
     delete fCompiler;
 }
 
+SkSL::Compiler* GrVkGpu::shaderCompiler() const {
+    if (!fCompiler) {
+        fCompiler = new SkSL::Compiler();
+    }
+    return fCompiler;
+}
+
 
 void GrVkGpu::disconnect(DisconnectType type) {
     INHERITED::disconnect(type);
@@ -254,6 +281,9 @@ void GrVkGpu::disconnect(DisconnectType type) {
         if (DisconnectType::kCleanup == type) {
             this->destroyResources();
         } else {
+            if (fRecordingTaskGroup) {
+                fRecordingTaskGroup->wait();
+            }
             if (fCurrentCmdBuffer) {
                 fCurrentCmdBuffer->unrefAndAbandon();
             }
@@ -274,6 +304,9 @@ void GrVkGpu::disconnect(DisconnectType type) {
         fSemaphoresToSignal.reset();
         fCurrentCmdBuffer = nullptr;
         fCmdPool = VK_NULL_HANDLE;
+        for (int i = 0; i < kRecordingCmdPoolCount; ++i) {
+            fRecordingCmdPools[i] = VK_NULL_HANDLE;
+        }
         fDisconnected = true;
     }
 }
@@ -762,6 +795,44 @@ bool GrVkGpu::uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int widt
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+bool GrVkGpu::uploadCompressedTexData(GrVkTexture* tex, const void* data) {
+    SkASSERT(data);
+    SkASSERT(!tex->isLinearTiled());
+
+    size_t dataSize = GrCompressedFormatDataSize(tex->config(), tex->width(), tex->height());
+    GrVkTransferBuffer* transferBuffer =
+                   GrVkTransferBuffer::Create(this, dataSize, GrVkBuffer::kCopyRead_Type);
+    if (!transferBuffer) {
+        return false;
+    }
+
+    // Compressed blocks have no padding to trim, so the data goes into the buffer as is.
+    memcpy(transferBuffer->map(), data, dataSize);
+    transferBuffer->unmap();
+
+    // A zero row length and image height tell Vulkan the blocks are tightly packed.
+    VkBufferImageCopy region;
+    memset(&region, 0, sizeof(VkBufferImageCopy));
+    region.bufferOffset = transferBuffer->offset();
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { (uint32_t)tex->width(), (uint32_t)tex->height(), 1 };
+
+    tex->setImageLayout(this,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_ACCESS_TRANSFER_WRITE_BIT,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        false);
+    fCurrentCmdBuffer->copyBufferToImage(this,
+                                         transferBuffer,
+                                         tex,
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                         1,
+                                         &region);
+    transferBuffer->unref();
+    return true;
+}
+
 sk_sp<GrTexture> GrVkGpu::onCreateTexture(const GrSurfaceDesc& desc, SkBudgeted budgeted,
                                           const GrMipLevel texels[], int mipLevelCount) {
     bool renderTarget = SkToBool(desc.fFlags & kRenderTarget_GrSurfaceFlag);
@@ -821,6 +892,14 @@ sk_sp<GrTexture> GrVkGpu::onCreateTexture(const GrSurfaceDesc& desc, SkBudgeted
         return nullptr;
     }
 
+    if (GrPixelConfigIsCompressed(desc.fConfig)) {
+        SkASSERT(1 == mipLevelCount);
+        if (!this->uploadCompressedTexData(tex.get(), texels[0].fPixels)) {
+            return nullptr;
+        }
+        return std::move(tex);
+    }
+
     auto colorType = GrPixelConfigToColorType(desc.fConfig);
     if (mipLevelCount) {
         if (!this->uploadTexDataOptimal(tex.get(), 0, 0, desc.fWidth, desc.fHeight, colorType,
@@ -1813,32 +1892,34 @@ bool GrVkGpu::onCopySurface(GrSurface* dst, GrSurfaceOrigin dstOrigin,
     return false;
 }
 
+GrVkImage* GrVkGpu::prepareSurfaceForRead(GrSurface* surface) {
+    GrVkRenderTarget* rt = static_cast<GrVkRenderTarget*>(surface->asRenderTarget());
+    if (!rt) {
+        return static_cast<GrVkTexture*>(surface->asTexture());
+    }
+    // resolve the render target if necessary
+    switch (rt->getResolveType()) {
+        case GrVkRenderTarget::kCantResolve_ResolveType:
+            return nullptr;
+        case GrVkRenderTarget::kAutoResolves_ResolveType:
+            break;
+        case GrVkRenderTarget::kCanResolve_ResolveType:
+            this->internalResolveRenderTarget(rt, false);
+            break;
+        default:
+            SK_ABORT("Unknown resolve type");
+    }
+    return rt;
+}
+
 bool GrVkGpu::onReadPixels(GrSurface* surface, int left, int top, int width, int height,
                            GrColorType dstColorType, void* buffer, size_t rowBytes) {
     if (GrPixelConfigToColorType(surface->config()) != dstColorType) {
         return false;
     }
 
-    GrVkImage* image = nullptr;
     GrVkRenderTarget* rt = static_cast<GrVkRenderTarget*>(surface->asRenderTarget());
-    if (rt) {
-        // resolve the render target if necessary
-        switch (rt->getResolveType()) {
-            case GrVkRenderTarget::kCantResolve_ResolveType:
-                return false;
-            case GrVkRenderTarget::kAutoResolves_ResolveType:
-                break;
-            case GrVkRenderTarget::kCanResolve_ResolveType:
-                this->internalResolveRenderTarget(rt, false);
-                break;
-            default:
-                SK_ABORT("Unknown resolve type");
-        }
-        image = rt;
-    } else {
-        image = static_cast<GrVkTexture*>(surface->asTexture());
-    }
-
+    GrVkImage* image = this->prepareSurfaceForRead(surface);
     if (!image) {
         return false;
     }
@@ -1958,8 +2039,6 @@ bool GrVkGpu::onReadPixels(GrSurface* surface, int left, int top, int width, int
     // we can copy the data out of the buffer.
     this->submitCommandBuffer(kForce_SyncQueue);
     void* mappedMemory = transferBuffer->map();
-    const GrVkAlloc& transAlloc = transferBuffer->alloc();
-    GrVkMemory::InvalidateMappedAlloc(this, transAlloc, 0, transAlloc.fSize);
 
     if (copyFromOrigin) {
         uint32_t skipRows = region.imageExtent.height - height;
@@ -1973,6 +2052,56 @@ bool GrVkGpu::onReadPixels(GrSurface* surface, int left, int top, int width, int
     return true;
 }
 
+bool GrVkGpu::onTransferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                                   GrColorType dstColorType, GrBuffer* transferBuffer,
+                                   size_t offset) {
+    // Unlike onReadPixels() we can't copy into a temporary image first, or crop rows read from the
+    // origin, without a CPU step after the GPU is done.
+    if (GrPixelConfigToColorType(surface->config()) != dstColorType ||
+        GrColorType::kRGB_888x == dstColorType || this->vkCaps().mustDoCopiesFromOrigin()) {
+        return false;
+    }
+
+    GrVkImage* image = this->prepareSurfaceForRead(surface);
+    if (!image) {
+        return false;
+    }
+
+    // Change layout of our target so it can be used as copy
+    image->setImageLayout(this,
+                          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                          VK_ACCESS_TRANSFER_READ_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          false);
+
+    GrVkTransferBuffer* vkBuffer = static_cast<GrVkTransferBuffer*>(transferBuffer);
+
+    VkBufferImageCopy region;
+    memset(&region, 0, sizeof(VkBufferImageCopy));
+    region.bufferOffset = vkBuffer->offset() + offset;
+    region.bufferRowLength = 0; // Forces RowLength to be width.
+    region.bufferImageHeight = 0; // Forces height to be tightly packed. Only useful for 3d images.
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageOffset = { left, top, 0 };
+    region.imageExtent = { (uint32_t)width, (uint32_t)height, 1 };
+
+    fCurrentCmdBuffer->copyImageToBuffer(this,
+                                         image,
+                                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                         vkBuffer,
+                                         1,
+                                         &region);
+
+    // Make the copy visible to the host once the fence after this submit has signaled.
+    vkBuffer->addMemoryBarrier(this,
+                               VK_ACCESS_TRANSFER_WRITE_BIT,
+                               VK_ACCESS_HOST_READ_BIT,
+                               VK_PIPELINE_STAGE_TRANSFER_BIT,
+                               VK_PIPELINE_STAGE_HOST_BIT,
+                               false);
+    return true;
+}
+
 // The RenderArea bounds we pass into BeginRenderPass must have a start x value that is a multiple
 // of the granularity. The width must also be a multiple of the granularity or eaqual to the width
 // the the entire attachment. Similar requirements for the y and height components.
@@ -2058,6 +2187,7 @@ void GrVkGpu::submitSecondaryCommandBuffer(const SkTArray<GrVkSecondaryCommandBu
 
     fCurrentCmdBuffer->beginRenderPass(this, renderPass, clears, *target, *pBounds, true);
     for (int i = 0; i < buffers.count(); ++i) {
+        buffers[i]->waitForRecording();
         fCurrentCmdBuffer->executeCommands(this, buffers[i]);
     }
     fCurrentCmdBuffer->endRenderPass(this);
@@ -2065,6 +2195,17 @@ void GrVkGpu::submitSecondaryCommandBuffer(const SkTArray<GrVkSecondaryCommandBu
     this->didWriteToSurface(target, origin, &bounds);
 }
 
+VkCommandPool GrVkGpu::secondaryCmdPool(SkMutex** cmdPoolMutex) {
+    if (!fRecordingTaskGroup) {
+        *cmdPoolMutex = nullptr;
+        return fCmdPool;
+    }
+    int index = fNextRecordingCmdPool;
+    fNextRecordingCmdPool = (fNextRecordingCmdPool + 1) % kRecordingCmdPoolCount;
+    *cmdPoolMutex = &fRecordingCmdPoolMutexes[index];
+    return fRecordingCmdPools[index];
+}
+
 void GrVkGpu::submit(GrGpuCommandBuffer* buffer) {
     if (buffer->asRTCommandBuffer()) {
         SkASSERT(fCachedRTCommandBuffer.get() == buffer);
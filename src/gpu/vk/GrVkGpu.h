@@ -18,6 +18,7 @@
 #include "GrVkSemaphore.h"
 #include "GrVkVertexBuffer.h"
 #include "GrVkUtil.h"
+#include "SkMutex.h"
 #include "vk/GrVkDefines.h"
 
 class GrPipeline;
@@ -33,6 +34,7 @@ class GrVkRenderPass;
 class GrVkSecondaryCommandBuffer;
 class GrVkTexture;
 struct GrVkInterface;
+class SkTaskGroup;
 
 namespace SkSL {
     class Compiler;
@@ -56,6 +58,18 @@ public:
     VkQueue  queue() const { return fQueue; }
     uint32_t  queueIndex() const { return fQueueIndex; }
     VkCommandPool cmdPool() const { return fCmdPool; }
+
+    /**
+     * If the context was given an executor, secondary command buffers are recorded on its threads
+     * through this task group. Otherwise it is null and they are recorded as they are written.
+     */
+    SkTaskGroup* recordingTaskGroup() const { return fRecordingTaskGroup.get(); }
+
+    /**
+     * Returns the pool to allocate the next secondary command buffer from. If the pool's command
+     * buffers are recorded on other threads, 'cmdPoolMutex' is set to the mutex guarding it.
+     */
+    VkCommandPool secondaryCmdPool(SkMutex** cmdPoolMutex);
     VkPhysicalDeviceProperties physicalDeviceProperties() const {
         return fPhysDevProps;
     }
@@ -112,9 +126,8 @@ public:
                                bool byRegion,
                                VkImageMemoryBarrier* barrier) const;
 
-    SkSL::Compiler* shaderCompiler() const {
-        return fCompiler;
-    }
+    // Created on first use: context creation shouldn't pay for parsing the SkSL includes.
+    SkSL::Compiler* shaderCompiler() const;
 
     bool onRegenerateMipMapLevels(GrTexture* tex) override;
 
@@ -143,6 +156,8 @@ public:
 
     sk_sp<GrSemaphore> prepareTextureForCrossContextUsage(GrTexture*) override;
 
+    void storeVkPipelineCacheData() override { fResourceProvider.storePipelineCacheData(); }
+
     void copyBuffer(GrVkBuffer* srcBuffer, GrVkBuffer* dstBuffer, VkDeviceSize srcOffset,
                     VkDeviceSize dstOffset, VkDeviceSize size);
     bool updateBuffer(GrVkBuffer* buffer, const void* src, VkDeviceSize offset, VkDeviceSize size);
@@ -179,6 +194,13 @@ private:
     bool onTransferPixels(GrTexture*, int left, int top, int width, int height, GrColorType,
                           GrBuffer* transferBuffer, size_t offset, size_t rowBytes) override;
 
+    bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height, GrColorType,
+                              GrBuffer* transferBuffer, size_t offset) override;
+
+    // Resolves the surface if it's a render target that needs it, and returns its image to copy
+    // from, or nullptr if it can't be read.
+    GrVkImage* prepareSurfaceForRead(GrSurface*);
+
     bool onCopySurface(GrSurface* dst, GrSurfaceOrigin dstOrigin, GrSurface* src,
                        GrSurfaceOrigin srcOrigin, const SkIRect& srcRect,
                        const SkIPoint& dstPoint, bool canDiscardOutsideDstRect) override;
@@ -217,6 +239,8 @@ private:
                              GrColorType colorType, const void* data, size_t rowBytes);
     bool uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int width, int height,
                               GrColorType colorType, const GrMipLevel texels[], int mipLevelCount);
+    // Uploads the base level of a texture in a compressed config.
+    bool uploadCompressedTexData(GrVkTexture* tex, const void* data);
 
     void resolveImage(GrSurface* dst, GrVkRenderTarget* src, const SkIRect& srcRect,
                       const SkIPoint& dstPoint);
@@ -241,6 +265,15 @@ private:
     GrVkResourceProvider                   fResourceProvider;
     VkCommandPool                          fCmdPool;
 
+    // When recording secondary command buffers on other threads, each is allocated from one of a
+    // few pools in turn. Recording holds its pool's mutex, so command buffers of different pools
+    // are recorded in parallel.
+    static constexpr int kRecordingCmdPoolCount = 4;
+    std::unique_ptr<SkTaskGroup>           fRecordingTaskGroup;
+    VkCommandPool                          fRecordingCmdPools[kRecordingCmdPoolCount];
+    SkMutex                                fRecordingCmdPoolMutexes[kRecordingCmdPoolCount];
+    int                                    fNextRecordingCmdPool;
+
     GrVkPrimaryCommandBuffer*              fCurrentCmdBuffer;
 
     SkSTArray<1, GrVkSemaphore::Resource*> fSemaphoresToWaitOn;
@@ -253,7 +286,7 @@ private:
 
     // compiler used for compiling sksl into spirv. We only want to create the compiler once since
     // there is significant overhead to the first compile of any compiler.
-    SkSL::Compiler*                        fCompiler;
+    mutable SkSL::Compiler*                fCompiler = nullptr;
 
     // We need a bool to track whether or not we've already disconnected all the gpu resources from
     // vulkan context.
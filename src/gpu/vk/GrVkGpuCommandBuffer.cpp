@@ -22,6 +22,10 @@
 #include "GrVkTexture.h"
 #include "SkRect.h"
 
+// When secondary command buffers are recorded on other threads, a render pass is split into
+// command buffers of about this many draws, so that one long render pass can be spread over them.
+static constexpr int kMaxDrawsPerRecordedCommandBuffer = 128;
+
 void GrVkGpuTextureCommandBuffer::copy(GrSurface* src, GrSurfaceOrigin srcOrigin,
                                        const SkIRect& srcRect, const SkIPoint& dstPoint) {
     fCopies.emplace_back(src, srcOrigin, srcRect, dstPoint);
@@ -255,6 +259,8 @@ void GrVkGpuRTCommandBuffer::reset() {
     for (int i = 0; i < fCommandBufferInfos.count(); ++i) {
         CommandBufferInfo& cbInfo = fCommandBufferInfos[i];
         for (int j = 0; j < cbInfo.fCommandBuffers.count(); ++j) {
+            // Command buffers that weren't submitted may still be being recorded.
+            cbInfo.fCommandBuffers[j]->waitForRecording();
             cbInfo.fCommandBuffers[j]->unref(fGpu);
         }
         cbInfo.fRenderPass->unref(fGpu);
@@ -459,6 +465,7 @@ void GrVkGpuRTCommandBuffer::addAdditionalCommandBuffer() {
     cbInfo.currentCmdBuf()->end(fGpu);
     cbInfo.fCommandBuffers.push_back(fGpu->resourceProvider().findOrCreateSecondaryCommandBuffer());
     cbInfo.currentCmdBuf()->begin(fGpu, vkRT->framebuffer(), cbInfo.fRenderPass);
+    cbInfo.fDrawCount = 0;
 }
 
 void GrVkGpuRTCommandBuffer::addAdditionalRenderPass() {
@@ -610,12 +617,19 @@ GrVkPipelineState* GrVkGpuRTCommandBuffer::prepareDrawState(
         fLastPipelineState && fLastPipelineState != pipelineState &&
         fGpu->vkCaps().newCBOnPipelineChange()) {
         this->addAdditionalCommandBuffer();
+    } else if (fGpu->recordingTaskGroup() &&
+               cbInfo.fDrawCount >= kMaxDrawsPerRecordedCommandBuffer) {
+        // Everything below is bound again, so the draws can carry on in a new command buffer and
+        // the full one can start recording.
+        this->addAdditionalCommandBuffer();
     }
     fLastPipelineState = pipelineState;
 
     pipelineState->bindPipeline(fGpu, cbInfo.currentCmdBuf());
 
-    pipelineState->setAndBindUniforms(fGpu, primProc, pipeline, cbInfo.currentCmdBuf());
+    if (!pipelineState->setAndBindUniforms(fGpu, primProc, pipeline, cbInfo.currentCmdBuf())) {
+        return nullptr;
+    }
 
     // Check whether we need to bind textures between each GrMesh. If not we can bind them all now.
     bool setTextures = !(dynamicStateArrays && dynamicStateArrays->fPrimitiveProcessorTextures);
@@ -757,6 +771,7 @@ void GrVkGpuRTCommandBuffer::sendInstancedMeshToGpu(GrPrimitiveType,
     CommandBufferInfo& cbInfo = fCommandBufferInfos[fCurrentCmdInfo];
     this->bindGeometry(nullptr, vertexBuffer, instanceBuffer);
     cbInfo.currentCmdBuf()->draw(fGpu, vertexCount, instanceCount, baseVertex, baseInstance);
+    ++cbInfo.fDrawCount;
     fGpu->stats()->incNumDraws();
 }
 
@@ -775,5 +790,6 @@ void GrVkGpuRTCommandBuffer::sendIndexedInstancedMeshToGpu(GrPrimitiveType,
     this->bindGeometry(indexBuffer, vertexBuffer, instanceBuffer);
     cbInfo.currentCmdBuf()->drawIndexed(fGpu, indexCount, instanceCount,
                                         baseIndex, baseVertex, baseInstance);
+    ++cbInfo.fDrawCount;
     fGpu->stats()->incNumDraws();
 }
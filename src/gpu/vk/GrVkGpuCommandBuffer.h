@@ -176,6 +176,8 @@ private:
         VkClearValue                           fColorClearValue;
         SkRect                                 fBounds;
         bool                                   fIsEmpty = true;
+        // Draws recorded into the current secondary command buffer.
+        int                                    fDrawCount = 0;
         LoadStoreState                         fLoadStoreState = LoadStoreState::kUnknown;
         // The PreDrawUploads and PreCopies are sent to the GPU before submitting the secondary
         // command buffer.
@@ -170,7 +170,7 @@ void GrVkMemory::GetNonCoherentMappedMemoryRange(const GrVkAlloc& alloc, VkDevic
     offset = offset + alloc.fOffset;
     VkDeviceSize offsetDiff = offset & (alignment -1);
     offset = offset - offsetDiff;
-    size = (size + alignment - 1) & ~(alignment - 1);
+    size = (size + offsetDiff + alignment - 1) & ~(alignment - 1);
 #ifdef SK_DEBUG
     SkASSERT(offset >= alloc.fOffset);
     SkASSERT(offset + size <= alloc.fOffset + alloc.fSize);
@@ -189,8 +189,7 @@ void GrVkMemory::GetNonCoherentMappedMemoryRange(const GrVkAlloc& alloc, VkDevic
 void GrVkMemory::FlushMappedAlloc(const GrVkGpu* gpu, const GrVkAlloc& alloc, VkDeviceSize offset,
                                   VkDeviceSize size) {
     if (alloc.fFlags & GrVkAlloc::kNoncoherent_Flag) {
-        SkASSERT(offset == 0);
-        SkASSERT(size <= alloc.fSize);
+        SkASSERT(offset + size <= alloc.fSize);
         if (alloc.fBackendMemory) {
             GrVkMemoryAllocator* allocator = gpu->memoryAllocator();
             allocator->flushMappedMemory(alloc.fBackendMemory, offset, size);
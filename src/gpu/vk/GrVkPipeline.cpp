@@ -13,6 +13,7 @@
 #include "GrVkGpu.h"
 #include "GrVkRenderTarget.h"
 #include "GrVkUtil.h"
+#include "SkTime.h"
 
 static inline VkFormat attrib_type_to_vkformat(GrVertexAttribType type) {
     switch (type) {
@@ -557,10 +558,17 @@ GrVkPipeline* GrVkPipeline::Create(GrVkGpu* gpu, const GrPrimitiveProcessor& pri
     pipelineCreateInfo.basePipelineIndex = -1;
 
     VkPipeline vkPipeline;
+#if GR_GPU_STATS
+    double startNs = SkTime::GetNSecs();
+#endif
     VkResult err = GR_VK_CALL(gpu->vkInterface(), CreateGraphicsPipelines(gpu->device(),
                                                                           cache, 1,
                                                                           &pipelineCreateInfo,
                                                                           nullptr, &vkPipeline));
+#if GR_GPU_STATS
+    gpu->stats()->incPipelineCreates();
+    gpu->stats()->addPipelineCreateNs(SkTime::GetNSecs() - startNs);
+#endif
     if (err) {
         SkDebugf("Failed to create pipeline. Error: %d\n", err);
         return nullptr;
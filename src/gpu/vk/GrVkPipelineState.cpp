@@ -22,7 +22,7 @@
 #include "GrVkPipelineLayout.h"
 #include "GrVkSampler.h"
 #include "GrVkTexture.h"
-#include "GrVkUniformBuffer.h"
+#include "GrVkUniformRingBuffer.h"
 #include "SkMipMap.h"
 #include "glsl/GrGLSLFragmentProcessor.h"
 #include "glsl/GrGLSLGeometryProcessor.h"
@@ -44,9 +44,10 @@ GrVkPipelineState::GrVkPipelineState(
         int fragmentProcessorCnt)
         : fPipeline(pipeline)
         , fPipelineLayout(new GrVkPipelineLayout(layout))
-        , fUniformDescriptorSet(nullptr)
         , fSamplerDescriptorSet(nullptr)
         , fSamplerDSHandle(samplerDSHandle)
+        , fSamplerDescriptors(numSamplers)
+        , fHasUniforms(geometryUniformSize || fragmentUniformSize)
         , fBuiltinUniformHandles(builtinUniformHandles)
         , fGeometryProcessor(std::move(geometryProcessor))
         , fXferProcessor(std::move(xferProcessor))
@@ -57,10 +58,10 @@ GrVkPipelineState::GrVkPipelineState(
     fDescriptorSets[1] = VK_NULL_HANDLE;
     fDescriptorSets[2] = VK_NULL_HANDLE;
 
-    fGeometryUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, geometryUniformSize));
-    fFragmentUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, fragmentUniformSize));
-
     fNumSamplers = numSamplers;
+    for (int i = 0; i < fNumSamplers; ++i) {
+        fSamplerDescriptors[i] = {nullptr, nullptr};
+    }
 }
 
 GrVkPipelineState::~GrVkPipelineState() {
@@ -80,25 +81,18 @@ void GrVkPipelineState::freeGPUResources(const GrVkGpu* gpu) {
         fPipelineLayout = nullptr;
     }
 
-    if (fGeometryUniformBuffer) {
-        fGeometryUniformBuffer->release(gpu);
-        fGeometryUniformBuffer.reset();
-    }
-
-    if (fFragmentUniformBuffer) {
-        fFragmentUniformBuffer->release(gpu);
-        fFragmentUniformBuffer.reset();
-    }
-
-    if (fUniformDescriptorSet) {
-        fUniformDescriptorSet->recycle(const_cast<GrVkGpu*>(gpu));
-        fUniformDescriptorSet = nullptr;
-    }
-
     if (fSamplerDescriptorSet) {
         fSamplerDescriptorSet->recycle(const_cast<GrVkGpu*>(gpu));
         fSamplerDescriptorSet = nullptr;
     }
+
+    for (int i = 0; i < fNumSamplers; ++i) {
+        if (fSamplerDescriptors[i].fSampler) {
+            fSamplerDescriptors[i].fSampler->unref(gpu);
+            fSamplerDescriptors[i].fImageView->unref(gpu);
+            fSamplerDescriptors[i] = {nullptr, nullptr};
+        }
+    }
 }
 
 void GrVkPipelineState::abandonGPUResources() {
@@ -112,28 +106,21 @@ void GrVkPipelineState::abandonGPUResources() {
         fPipelineLayout = nullptr;
     }
 
-    if (fGeometryUniformBuffer) {
-        fGeometryUniformBuffer->abandon();
-        fGeometryUniformBuffer.reset();
-    }
-
-    if (fFragmentUniformBuffer) {
-        fFragmentUniformBuffer->abandon();
-        fFragmentUniformBuffer.reset();
-    }
-
-    if (fUniformDescriptorSet) {
-        fUniformDescriptorSet->unrefAndAbandon();
-        fUniformDescriptorSet = nullptr;
-    }
-
     if (fSamplerDescriptorSet) {
         fSamplerDescriptorSet->unrefAndAbandon();
         fSamplerDescriptorSet = nullptr;
     }
+
+    for (int i = 0; i < fNumSamplers; ++i) {
+        if (fSamplerDescriptors[i].fSampler) {
+            fSamplerDescriptors[i].fSampler->unrefAndAbandon();
+            fSamplerDescriptors[i].fImageView->unrefAndAbandon();
+            fSamplerDescriptors[i] = {nullptr, nullptr};
+        }
+    }
 }
 
-void GrVkPipelineState::setAndBindUniforms(GrVkGpu* gpu,
+bool GrVkPipelineState::setAndBindUniforms(GrVkGpu* gpu,
                                            const GrPrimitiveProcessor& primProc,
                                            const GrPipeline& pipeline,
                                            GrVkCommandBuffer* commandBuffer) {
@@ -159,31 +146,22 @@ void GrVkPipelineState::setAndBindUniforms(GrVkGpu* gpu,
         fXferProcessor->setData(fDataManager, pipeline.getXferProcessor(), dstTexture, offset);
     }
 
-    // Get new descriptor set
-    if (fGeometryUniformBuffer || fFragmentUniformBuffer) {
-        int uniformDSIdx = GrVkUniformHandler::kUniformBufferDescSet;
-        if (fDataManager.uploadUniformBuffers(
-                    gpu, fGeometryUniformBuffer.get(), fFragmentUniformBuffer.get()) ||
-            !fUniformDescriptorSet) {
-            if (fUniformDescriptorSet) {
-                fUniformDescriptorSet->recycle(gpu);
-            }
-            fUniformDescriptorSet = gpu->resourceProvider().getUniformDescriptorSet();
-            fDescriptorSets[uniformDSIdx] = fUniformDescriptorSet->descriptorSet();
-            this->writeUniformBuffers(gpu);
+    // The uniforms live in the ring's current chunk, whose descriptor set is shared by every draw
+    // using the chunk; only the dynamic offsets differ.
+    if (fHasUniforms) {
+        GrVkUniformRingBuffer& ring = gpu->resourceProvider().uniformRingBuffer();
+        uint32_t dynamicOffsets[2];
+        if (!fDataManager.uploadUniforms(&ring, dynamicOffsets)) {
+            return false;
         }
+        int uniformDSIdx = GrVkUniformHandler::kUniformBufferDescSet;
+        fDescriptorSets[uniformDSIdx] = ring.currentChunk()->descriptorSet();
         commandBuffer->bindDescriptorSets(gpu, this, fPipelineLayout, uniformDSIdx, 1,
-                                          &fDescriptorSets[uniformDSIdx], 0, nullptr);
-        if (fUniformDescriptorSet) {
-            commandBuffer->addRecycledResource(fUniformDescriptorSet);
-        }
-        if (fGeometryUniformBuffer) {
-            commandBuffer->addRecycledResource(fGeometryUniformBuffer->resource());
-        }
-        if (fFragmentUniformBuffer) {
-            commandBuffer->addRecycledResource(fFragmentUniformBuffer->resource());
-        }
+                                          &fDescriptorSets[uniformDSIdx],
+                                          SK_ARRAY_COUNT(dynamicOffsets), dynamicOffsets);
+        commandBuffer->addRecycledResource(ring.currentChunk());
     }
+    return true;
 }
 
 void GrVkPipelineState::setAndBindTextures(GrVkGpu* gpu,
@@ -229,47 +207,71 @@ void GrVkPipelineState::setAndBindTextures(GrVkGpu* gpu,
                 static_cast<GrVkTexture*>(dstTextureProxy->peekTexture())};
     }
 
-    // Get new descriptor set
     SkASSERT(fNumSamplers == currTextureBinding);
     if (fNumSamplers) {
-        if (fSamplerDescriptorSet) {
-            fSamplerDescriptorSet->recycle(gpu);
-        }
-        fSamplerDescriptorSet = gpu->resourceProvider().getSamplerDescriptorSet(fSamplerDSHandle);
-        int samplerDSIdx = GrVkUniformHandler::kSamplerDescSet;
-        fDescriptorSets[samplerDSIdx] = fSamplerDescriptorSet->descriptorSet();
+        GrVkResourceProvider& resourceProvider = gpu->resourceProvider();
+        SkAutoSTMalloc<8, SamplerDescriptor> descriptors(fNumSamplers);
+        bool descriptorsChanged = !fSamplerDescriptorSet;
         for (int i = 0; i < fNumSamplers; ++i) {
-            const GrSamplerState& state = samplerBindings[i].fState;
             GrVkTexture* texture = samplerBindings[i].fTexture;
+            descriptors[i].fSampler = resourceProvider.findOrCreateCompatibleSampler(
+                    samplerBindings[i].fState, texture->texturePriv().maxMipMapLevel());
+            descriptors[i].fImageView = texture->textureView();
+            descriptorsChanged = descriptorsChanged ||
+                                 descriptors[i].fSampler != fSamplerDescriptors[i].fSampler ||
+                                 descriptors[i].fImageView != fSamplerDescriptors[i].fImageView;
+        }
+
+        int samplerDSIdx = GrVkUniformHandler::kSamplerDescSet;
+        if (descriptorsChanged) {
+            // The old set may still be in use by a command buffer, so write a new one.
+            if (fSamplerDescriptorSet) {
+                fSamplerDescriptorSet->recycle(gpu);
+            }
+            fSamplerDescriptorSet = resourceProvider.getSamplerDescriptorSet(fSamplerDSHandle);
+            fDescriptorSets[samplerDSIdx] = fSamplerDescriptorSet->descriptorSet();
+
+            SkAutoSTMalloc<8, VkDescriptorImageInfo> imageInfos(fNumSamplers);
+            SkAutoSTMalloc<8, VkWriteDescriptorSet> writeInfos(fNumSamplers);
+            for (int i = 0; i < fNumSamplers; ++i) {
+                VkDescriptorImageInfo& imageInfo = imageInfos[i];
+                memset(&imageInfo, 0, sizeof(VkDescriptorImageInfo));
+                imageInfo.sampler = descriptors[i].fSampler->sampler();
+                imageInfo.imageView = descriptors[i].fImageView->imageView();
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+                VkWriteDescriptorSet& writeInfo = writeInfos[i];
+                memset(&writeInfo, 0, sizeof(VkWriteDescriptorSet));
+                writeInfo.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writeInfo.pNext = nullptr;
+                writeInfo.dstSet = fDescriptorSets[samplerDSIdx];
+                writeInfo.dstBinding = i;
+                writeInfo.dstArrayElement = 0;
+                writeInfo.descriptorCount = 1;
+                writeInfo.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                writeInfo.pImageInfo = &imageInfo;
+                writeInfo.pBufferInfo = nullptr;
+                writeInfo.pTexelBufferView = nullptr;
+
+                // The cache takes over the ref findOrCreateCompatibleSampler gave us.
+                if (fSamplerDescriptors[i].fSampler) {
+                    fSamplerDescriptors[i].fSampler->unref(gpu);
+                    fSamplerDescriptors[i].fImageView->unref(gpu);
+                }
+                descriptors[i].fImageView->ref();
+                fSamplerDescriptors[i] = descriptors[i];
+            }
+            GR_VK_CALL(gpu->vkInterface(), UpdateDescriptorSets(gpu->device(), fNumSamplers,
+                                                                writeInfos.get(), 0, nullptr));
+        } else {
+            for (int i = 0; i < fNumSamplers; ++i) {
+                descriptors[i].fSampler->unref(gpu);
+            }
+        }
 
-            const GrVkImageView* textureView = texture->textureView();
-            GrVkSampler* sampler = gpu->resourceProvider().findOrCreateCompatibleSampler(
-                    state, texture->texturePriv().maxMipMapLevel());
-
-            VkDescriptorImageInfo imageInfo;
-            memset(&imageInfo, 0, sizeof(VkDescriptorImageInfo));
-            imageInfo.sampler = sampler->sampler();
-            imageInfo.imageView = textureView->imageView();
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-            VkWriteDescriptorSet writeInfo;
-            memset(&writeInfo, 0, sizeof(VkWriteDescriptorSet));
-            writeInfo.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writeInfo.pNext = nullptr;
-            writeInfo.dstSet = fDescriptorSets[GrVkUniformHandler::kSamplerDescSet];
-            writeInfo.dstBinding = i;
-            writeInfo.dstArrayElement = 0;
-            writeInfo.descriptorCount = 1;
-            writeInfo.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            writeInfo.pImageInfo = &imageInfo;
-            writeInfo.pBufferInfo = nullptr;
-            writeInfo.pTexelBufferView = nullptr;
-
-            GR_VK_CALL(gpu->vkInterface(),
-                       UpdateDescriptorSets(gpu->device(), 1, &writeInfo, 0, nullptr));
-            commandBuffer->addResource(sampler);
-            sampler->unref(gpu);
-            commandBuffer->addResource(samplerBindings[i].fTexture->textureView());
+        for (int i = 0; i < fNumSamplers; ++i) {
+            commandBuffer->addResource(fSamplerDescriptors[i].fSampler);
+            commandBuffer->addResource(fSamplerDescriptors[i].fImageView);
             commandBuffer->addResource(samplerBindings[i].fTexture->resource());
         }
 
@@ -279,64 +281,6 @@ void GrVkPipelineState::setAndBindTextures(GrVkGpu* gpu,
     }
 }
 
-void set_uniform_descriptor_writes(VkWriteDescriptorSet* descriptorWrite,
-                                   VkDescriptorBufferInfo* bufferInfo,
-                                   const GrVkUniformBuffer* buffer,
-                                   VkDescriptorSet descriptorSet,
-                                   uint32_t binding) {
-
-    memset(bufferInfo, 0, sizeof(VkDescriptorBufferInfo));
-    bufferInfo->buffer = buffer->buffer();
-    bufferInfo->offset = buffer->offset();
-    bufferInfo->range = buffer->size();
-
-    memset(descriptorWrite, 0, sizeof(VkWriteDescriptorSet));
-    descriptorWrite->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrite->pNext = nullptr;
-    descriptorWrite->dstSet = descriptorSet;
-    descriptorWrite->dstBinding = binding;
-    descriptorWrite->dstArrayElement = 0;
-    descriptorWrite->descriptorCount = 1;
-    descriptorWrite->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorWrite->pImageInfo = nullptr;
-    descriptorWrite->pBufferInfo = bufferInfo;
-    descriptorWrite->pTexelBufferView = nullptr;
-}
-
-void GrVkPipelineState::writeUniformBuffers(const GrVkGpu* gpu) {
-    VkWriteDescriptorSet descriptorWrites[3];
-    VkDescriptorBufferInfo bufferInfos[3];
-
-    uint32_t writeCount = 0;
-
-    // Geometry Uniform Buffer
-    if (fGeometryUniformBuffer.get()) {
-        set_uniform_descriptor_writes(&descriptorWrites[writeCount],
-                                      &bufferInfos[writeCount],
-                                      fGeometryUniformBuffer.get(),
-                                      fDescriptorSets[GrVkUniformHandler::kUniformBufferDescSet],
-                                      GrVkUniformHandler::kGeometryBinding);
-        ++writeCount;
-    }
-
-    // Fragment Uniform Buffer
-    if (fFragmentUniformBuffer.get()) {
-        set_uniform_descriptor_writes(&descriptorWrites[writeCount],
-                                      &bufferInfos[writeCount],
-                                      fFragmentUniformBuffer.get(),
-                                      fDescriptorSets[GrVkUniformHandler::kUniformBufferDescSet],
-                                      GrVkUniformHandler::kFragBinding);
-        ++writeCount;
-    }
-
-    if (writeCount) {
-        GR_VK_CALL(gpu->vkInterface(), UpdateDescriptorSets(gpu->device(),
-                                                            writeCount,
-                                                            descriptorWrites,
-                                                            0, nullptr));
-    }
-}
-
 void GrVkPipelineState::setRenderTargetState(const GrRenderTargetProxy* proxy) {
     GrRenderTarget* rt = proxy->peekRenderTarget();
 
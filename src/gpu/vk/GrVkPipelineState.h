@@ -26,7 +26,6 @@ class GrVkPipeline;
 class GrVkPipelineLayout;
 class GrVkSampler;
 class GrVkTexture;
-class GrVkUniformBuffer;
 
 /**
  * This class holds onto a GrVkPipeline object that we use for draws. Besides storing the acutal
@@ -56,7 +55,11 @@ public:
 
     ~GrVkPipelineState();
 
-    void setAndBindUniforms(GrVkGpu*, const GrPrimitiveProcessor&, const GrPipeline&,
+    /**
+     * Returns false if the uniforms could not be uploaded, in which case the draw should be
+     * skipped.
+     */
+    bool setAndBindUniforms(GrVkGpu*, const GrPrimitiveProcessor&, const GrPipeline&,
                             GrVkCommandBuffer*);
     /**
      * This must be called after setAndBindUniforms() since that function invalidates texture
@@ -75,8 +78,6 @@ public:
     void abandonGPUResources();
 
 private:
-    void writeUniformBuffers(const GrVkGpu* gpu);
-
     /**
      * We use the RT's size and origin to adjust from Skia device space to vulkan normalized device
      * space and to make device space positions have the correct origin for processors that require
@@ -130,13 +131,21 @@ private:
     // GrVkPipelineState since we update the descriptor sets and bind them at separate times;
     VkDescriptorSet fDescriptorSets[3];
 
-    const GrVkDescriptorSet* fUniformDescriptorSet;
     const GrVkDescriptorSet* fSamplerDescriptorSet;
 
     const GrVkDescriptorSetManager::Handle fSamplerDSHandle;
 
-    std::unique_ptr<GrVkUniformBuffer> fGeometryUniformBuffer;
-    std::unique_ptr<GrVkUniformBuffer> fFragmentUniformBuffer;
+    // The samplers and image views that fSamplerDescriptorSet was written with, one per binding.
+    // We hold refs on them so that they can't be replaced by others at the same address. As long
+    // as draws bind the same ones the set is bound again rather than a new one being written.
+    struct SamplerDescriptor {
+        const GrVkSampler*   fSampler;
+        const GrVkImageView* fImageView;
+    };
+    SkAutoTMalloc<SamplerDescriptor> fSamplerDescriptors;
+
+    // Uniforms are suballocated from the resource provider's GrVkUniformRingBuffer.
+    bool fHasUniforms;
 
     // Tracks the current render target uniforms stored in the vertex buffer.
     RenderTargetState fRenderTargetState;
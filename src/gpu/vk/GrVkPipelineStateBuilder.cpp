@@ -11,6 +11,10 @@
 #include "GrShaderCaps.h"
 #include "GrStencilSettings.h"
 #include "GrVkRenderTarget.h"
+#include "SkAutoMalloc.h"
+#include "SkData.h"
+#include "SkStream.h"
+#include "SkTime.h"
 #include "vk/GrVkDescriptorSetManager.h"
 #include "vk/GrVkGpu.h"
 #include "vk/GrVkRenderPass.h"
@@ -60,7 +64,9 @@ bool GrVkPipelineStateBuilder::createVkShaderModule(VkShaderStageFlagBits stage,
                                                     VkShaderModule* shaderModule,
                                                     VkPipelineShaderStageCreateInfo* stageInfo,
                                                     const SkSL::Program::Settings& settings,
-                                                    Desc* desc) {
+                                                    Desc* desc,
+                                                    SkSL::String* outSPIRV,
+                                                    SkSL::Program::Inputs* outInputs) {
     SkString shaderString;
     for (int i = 0; i < builder.fCompilerStrings.count(); ++i) {
         if (builder.fCompilerStrings[i]) {
@@ -69,12 +75,33 @@ bool GrVkPipelineStateBuilder::createVkShaderModule(VkShaderStageFlagBits stage,
         }
     }
 
-    SkSL::Program::Inputs inputs;
+    double startNs = SkTime::GetNSecs();
     bool result = GrCompileVkShaderModule(fGpu, shaderString.c_str(), stage, shaderModule,
-                                          stageInfo, settings, &inputs);
+                                          stageInfo, settings, outInputs, outSPIRV);
+    fGpu->stats()->incShaderCompilations();
+    fGpu->stats()->addShaderCompileNs(SkTime::GetNSecs() - startNs);
     if (!result) {
         return false;
     }
+    this->applyShaderInputs(*outInputs, desc);
+    return true;
+}
+
+bool GrVkPipelineStateBuilder::installVkShaderModule(VkShaderStageFlagBits stage,
+                                                     const SkSL::String& spirv,
+                                                     const SkSL::Program::Inputs& inputs,
+                                                     VkShaderModule* shaderModule,
+                                                     VkPipelineShaderStageCreateInfo* stageInfo,
+                                                     Desc* desc) {
+    if (!GrInstallVkShaderModule(fGpu, spirv, stage, shaderModule, stageInfo)) {
+        return false;
+    }
+    this->applyShaderInputs(inputs, desc);
+    return true;
+}
+
+void GrVkPipelineStateBuilder::applyShaderInputs(const SkSL::Program::Inputs& inputs,
+                                                 Desc* desc) {
     if (inputs.fRTHeight) {
         this->addRTHeightUniform(SKSL_RTHEIGHT_NAME);
     }
@@ -83,7 +110,54 @@ bool GrVkPipelineStateBuilder::createVkShaderModule(VkShaderStageFlagBits stage,
                                                      this->pipeline().proxy()->origin()));
         desc->finalize();
     }
-    return result;
+}
+
+// Distinguishes our SPIR-V from anything else a client may keep in the same PersistentCache.
+static constexpr uint32_t kSPIRVCacheKeyTag = SkSetFourByteTag('S', 'P', 'R', 'V');
+
+sk_sp<SkData> GrVkPipelineStateBuilder::SPIRVCacheKey(const GrProgramDesc& desc) {
+    SkAutoMalloc key(sizeof(kSPIRVCacheKeyTag) + desc.keyLength());
+    memcpy(key.get(), &kSPIRVCacheKeyTag, sizeof(kSPIRVCacheKeyTag));
+    memcpy(SkTAddOffset<void>(key.get(), sizeof(kSPIRVCacheKeyTag)), desc.asKey(),
+           desc.keyLength());
+    return SkData::MakeWithCopy(key.get(), sizeof(kSPIRVCacheKeyTag) + desc.keyLength());
+}
+
+// The cached data is, for each shader stage in order, its SkSL::Program::Inputs, the size of its
+// SPIR-V as a uint32_t, and the SPIR-V itself.
+sk_sp<SkData> GrVkPipelineStateBuilder::EncodeShaders(const SkSL::String spirv[],
+                                                      const SkSL::Program::Inputs inputs[],
+                                                      int stageCount) {
+    SkDynamicMemoryWStream stream;
+    for (int i = 0; i < stageCount; ++i) {
+        uint32_t size = SkToU32(spirv[i].size());
+        stream.write(&inputs[i], sizeof(inputs[i]));
+        stream.write(&size, sizeof(size));
+        stream.write(spirv[i].c_str(), size);
+    }
+    return stream.detachAsData();
+}
+
+bool GrVkPipelineStateBuilder::DecodeShaders(const SkData& data, SkSL::String spirv[],
+                                             SkSL::Program::Inputs inputs[], int stageCount) {
+    const uint8_t* bytes = data.bytes();
+    size_t offset = 0;
+    for (int i = 0; i < stageCount; ++i) {
+        uint32_t size;
+        if (data.size() - offset < sizeof(inputs[i]) + sizeof(size)) {
+            return false;
+        }
+        memcpy(&inputs[i], bytes + offset, sizeof(inputs[i]));
+        offset += sizeof(inputs[i]);
+        memcpy(&size, bytes + offset, sizeof(size));
+        offset += sizeof(size);
+        if (data.size() - offset < size || !size || SkAlign4(size) != size) {
+            return false;
+        }
+        spirv[i] = SkSL::String(reinterpret_cast<const char*>(bytes + offset), size);
+        offset += size;
+    }
+    return offset == data.size();
 }
 
 GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& stencil,
@@ -137,29 +211,46 @@ GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& s
     settings.fFlipY = this->pipeline().proxy()->origin() != kTopLeft_GrSurfaceOrigin;
     settings.fSharpenTextures = this->gpu()->getContext()->contextPriv().sharpenMipmappedTextures();
     SkASSERT(!this->fragColorIsInOut());
-    SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_VERTEX_BIT,
-                                              fVS,
-                                              &vertShaderModule,
-                                              &shaderStageInfo[0],
-                                              settings,
-                                              desc));
-
-    SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_FRAGMENT_BIT,
-                                              fFS,
-                                              &fragShaderModule,
-                                              &shaderStageInfo[1],
-                                              settings,
-                                              desc));
-
-    int numShaderStages = 2; // We always have at least vertex and fragment stages.
-    if (this->primitiveProcessor().willUseGeoShader()) {
-        SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_GEOMETRY_BIT,
-                                                  fGS,
-                                                  &geomShaderModule,
-                                                  &shaderStageInfo[2],
-                                                  settings,
-                                                  desc));
-        ++numShaderStages;
+
+    // We always have at least vertex and fragment stages.
+    int numShaderStages = this->primitiveProcessor().willUseGeoShader() ? 3 : 2;
+    const VkShaderStageFlagBits stages[3] = {
+        VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_GEOMETRY_BIT
+    };
+    const GrGLSLShaderBuilder* builders[3] = { &fVS, &fFS, &fGS };
+    VkShaderModule* shaderModules[3] = { &vertShaderModule, &fragShaderModule, &geomShaderModule };
+    SkSL::String spirv[3];
+    SkSL::Program::Inputs inputs[3];
+
+    // Compiling may change the desc's surface origin key, so the key is made up front.
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    sk_sp<SkData> cacheKey;
+    bool cached = false;
+    if (persistentCache) {
+        cacheKey = SPIRVCacheKey(*desc);
+        sk_sp<SkData> data = persistentCache->load(*cacheKey);
+        cached = data && DecodeShaders(*data, spirv, inputs, numShaderStages);
+        if (cached) {
+            fGpu->stats()->incPersistentCacheHits();
+        } else {
+            fGpu->stats()->incPersistentCacheMisses();
+        }
+    }
+
+    for (int i = 0; i < numShaderStages; ++i) {
+        if (cached) {
+            SkAssertResult(this->installVkShaderModule(stages[i], spirv[i], inputs[i],
+                                                       shaderModules[i], &shaderStageInfo[i],
+                                                       desc));
+        } else {
+            SkAssertResult(this->createVkShaderModule(stages[i], *builders[i], shaderModules[i],
+                                                      &shaderStageInfo[i], settings, desc,
+                                                      &spirv[i], &inputs[i]));
+        }
+    }
+
+    if (persistentCache && !cached) {
+        persistentCache->store(*cacheKey, *EncodeShaders(spirv, inputs, numShaderStages));
     }
 
     GrVkPipeline* pipeline = resourceProvider.createPipeline(fPrimProc,
@@ -20,6 +20,7 @@
 
 class GrVkGpu;
 class GrVkRenderPass;
+class SkData;
 
 class GrVkPipelineStateBuilder : public GrGLSLProgramBuilder {
 public:
@@ -83,12 +84,32 @@ private:
                                 VkRenderPass compatibleRenderPass,
                                 Desc*);
 
+    // Compiles the builder's SkSL, returning the SPIR-V and inputs so they can be cached.
     bool createVkShaderModule(VkShaderStageFlagBits stage,
                               const GrGLSLShaderBuilder& builder,
                               VkShaderModule* shaderModule,
                               VkPipelineShaderStageCreateInfo* stageInfo,
                               const SkSL::Program::Settings& settings,
-                              Desc* desc);
+                              Desc* desc,
+                              SkSL::String* outSPIRV,
+                              SkSL::Program::Inputs* outInputs);
+
+    // Makes the shader module from SPIR-V found in the PersistentCache.
+    bool installVkShaderModule(VkShaderStageFlagBits stage,
+                               const SkSL::String& spirv,
+                               const SkSL::Program::Inputs& inputs,
+                               VkShaderModule* shaderModule,
+                               VkPipelineShaderStageCreateInfo* stageInfo,
+                               Desc* desc);
+
+    void applyShaderInputs(const SkSL::Program::Inputs&, Desc*);
+
+    static sk_sp<SkData> SPIRVCacheKey(const GrProgramDesc&);
+    static sk_sp<SkData> EncodeShaders(const SkSL::String spirv[],
+                                       const SkSL::Program::Inputs inputs[], int stageCount);
+    // Returns false if the data is malformed.
+    static bool DecodeShaders(const SkData&, SkSL::String spirv[], SkSL::Program::Inputs inputs[],
+                              int stageCount);
 
     GrGLSLUniformHandler* uniformHandler() override { return &fUniformHandler; }
     const GrGLSLUniformHandler* uniformHandler() const override { return &fUniformHandler; }
@@ -111,6 +111,7 @@ GrVkPipelineState* GrVkResourceProvider::PipelineStateCache::refPipelineState(
 #ifdef GR_PIPELINE_STATE_CACHE_STATS
         ++fCacheMisses;
 #endif
+        fGpu->stats()->incProgramCacheMisses();
         GrVkPipelineState* pipelineState(GrVkPipelineStateBuilder::CreatePipelineState(
                 fGpu, primProc, pipeline, stencil, primitiveType, &desc, compatibleRenderPass));
         if (nullptr == pipelineState) {
@@ -119,5 +120,6 @@ GrVkPipelineState* GrVkResourceProvider::PipelineStateCache::refPipelineState(
         entry = fMap.insert(desc, std::unique_ptr<Entry>(new Entry(fGpu, pipelineState)));
         return (*entry)->fPipelineState.get();
     }
+    fGpu->stats()->incProgramCacheHits();
     return (*entry)->fPipelineState.get();
 }
@@ -7,8 +7,7 @@
 
 #include "GrVkPipelineStateDataManager.h"
 
-#include "GrVkGpu.h"
-#include "GrVkUniformBuffer.h"
+#include "GrVkUniformRingBuffer.h"
 
 GrVkPipelineStateDataManager::GrVkPipelineStateDataManager(const UniformInfoArray& uniforms,
                                                            uint32_t geometryUniformSize,
@@ -16,7 +15,10 @@ GrVkPipelineStateDataManager::GrVkPipelineStateDataManager(const UniformInfoArra
     : fGeometryUniformSize(geometryUniformSize)
     , fFragmentUniformSize(fragmentUniformSize)
     , fGeometryUniformsDirty(false)
-    , fFragmentUniformsDirty(false) {
+    , fFragmentUniformsDirty(false)
+    , fRingGeneration(0)
+    , fGeometryOffset(0)
+    , fFragmentOffset(0) {
     fGeometryUniformData.reset(geometryUniformSize);
     fFragmentUniformData.reset(fragmentUniformSize);
     int count = uniforms.count();
@@ -359,20 +361,38 @@ template<> struct set_uniform_matrix<4> {
     }
 };
 
-bool GrVkPipelineStateDataManager::uploadUniformBuffers(GrVkGpu* gpu,
-                                                        GrVkUniformBuffer* geometryBuffer,
-                                                        GrVkUniformBuffer* fragmentBuffer) const {
-    bool updatedBuffer = false;
-    if (geometryBuffer && fGeometryUniformsDirty) {
-        SkAssertResult(geometryBuffer->updateData(gpu, fGeometryUniformData.get(),
-                                                  fGeometryUniformSize, &updatedBuffer));
+bool GrVkPipelineStateDataManager::uploadUniforms(GrVkUniformRingBuffer* ring,
+                                                  uint32_t dynamicOffsets[2]) const {
+    // The ring's generation starts at zero and is bumped when it makes its first chunk, so the
+    // first upload always happens.
+    if (fGeometryUniformsDirty || fFragmentUniformsDirty ||
+        ring->generation() != fRingGeneration) {
+        // Both blocks go in one allocation, so that they can't end up in different chunks.
+        uint32_t fragmentStart = GrUIAlignUp(fGeometryUniformSize, ring->alignment());
+        uint32_t size = fragmentStart + fFragmentUniformSize;
+        uint32_t offset;
+        char* dst = static_cast<char*>(ring->allocate(size, &offset));
+        if (!dst) {
+            return false;
+        }
+        if (fGeometryUniformSize) {
+            memcpy(dst, fGeometryUniformData.get(), fGeometryUniformSize);
+        }
+        if (fFragmentUniformSize) {
+            memcpy(dst + fragmentStart, fFragmentUniformData.get(), fFragmentUniformSize);
+        }
+        ring->flush(offset, size);
+
+        fRingGeneration = ring->generation();
+        fGeometryOffset = offset;
+        fFragmentOffset = offset + fragmentStart;
         fGeometryUniformsDirty = false;
-    }
-    if (fragmentBuffer && fFragmentUniformsDirty) {
-        SkAssertResult(fragmentBuffer->updateData(gpu, fFragmentUniformData.get(),
-                                                  fFragmentUniformSize, &updatedBuffer));
         fFragmentUniformsDirty = false;
     }
 
-    return updatedBuffer;
+    GR_STATIC_ASSERT(0 == GrVkUniformHandler::kGeometryBinding);
+    GR_STATIC_ASSERT(1 == GrVkUniformHandler::kFragBinding);
+    dynamicOffsets[0] = fGeometryOffset;
+    dynamicOffsets[1] = fFragmentOffset;
+    return true;
 }
@@ -13,8 +13,7 @@
 #include "SkAutoMalloc.h"
 #include "vk/GrVkUniformHandler.h"
 
-class GrVkGpu;
-class GrVkUniformBuffer;
+class GrVkUniformRingBuffer;
 
 class GrVkPipelineStateDataManager : public GrGLSLProgramDataManager {
 public:
@@ -55,12 +54,11 @@ public:
         SK_ABORT("Only supported in NVPR, which is not in vulkan");
     }
 
-    // Returns true if either the geometry or fragment buffers needed to generate a new underlying
-    // VkBuffer object in order upload data. If true is returned, this is a signal to the caller
-    // that they will need to update the descriptor set that is using these buffers.
-    bool uploadUniformBuffers(GrVkGpu* gpu,
-                              GrVkUniformBuffer* geometryBuffer,
-                              GrVkUniformBuffer* fragmentBuffer) const;
+    // Copies the geometry and fragment uniforms into the ring's current chunk if any of them
+    // changed since the last upload, or if the ring has moved on to a new chunk since then. Sets
+    // 'dynamicOffsets' to where the two blocks are, in binding order. Returns false if the ring
+    // could not make room for them.
+    bool uploadUniforms(GrVkUniformRingBuffer*, uint32_t dynamicOffsets[2]) const;
 private:
     struct Uniform {
         uint32_t fBinding;
@@ -85,6 +83,11 @@ private:
     mutable SkAutoMalloc fFragmentUniformData;
     mutable bool         fGeometryUniformsDirty;
     mutable bool         fFragmentUniformsDirty;
+
+    // Where the uniforms were last uploaded to.
+    mutable uint32_t     fRingGeneration;
+    mutable uint32_t     fGeometryOffset;
+    mutable uint32_t     fFragmentOffset;
 };
 
 #endif
@@ -7,6 +7,8 @@
 
 #include "GrVkResourceProvider.h"
 
+#include "GrContext.h"
+#include "GrContextPriv.h"
 #include "GrSamplerState.h"
 #include "GrVkCommandBuffer.h"
 #include "GrVkCopyPipeline.h"
@@ -15,7 +17,10 @@
 #include "GrVkRenderTarget.h"
 #include "GrVkSampler.h"
 #include "GrVkUniformBuffer.h"
+#include "GrVkUniformRingBuffer.h"
 #include "GrVkUtil.h"
+#include "SkAutoMalloc.h"
+#include "SkData.h"
 
 #ifdef SK_TRACE_VK_RESOURCES
 uint32_t GrVkResource::fKeyCounter = 0;
@@ -34,26 +39,114 @@ GrVkResourceProvider::~GrVkResourceProvider() {
 }
 
 void GrVkResourceProvider::init() {
+    // Init uniform descriptor objects
+    GrVkDescriptorSetManager* dsm = GrVkDescriptorSetManager::CreateUniformManager(fGpu);
+    fDescriptorSetManagers.emplace_back(dsm);
+    SkASSERT(1 == fDescriptorSetManagers.count());
+    fUniformDSHandle = GrVkDescriptorSetManager::Handle(0);
+
+    fUniformRingBuffer.reset(new GrVkUniformRingBuffer(fGpu));
+}
+
+// The PersistentCache key for the VkPipelineCache's data. There is one per context; the data's
+// own header says which device it is for.
+static const char kPipelineCacheKey[] = "VkPipelineCache";
+
+static sk_sp<SkData> pipeline_cache_key() {
+    return SkData::MakeWithoutCopy(kPipelineCacheKey, sizeof(kPipelineCacheKey) - 1);
+}
+
+// Drivers are meant to reject data made by another device or driver version, but not all do, so
+// we check the header (section 9.6 of the Vulkan spec) ourselves.
+static bool pipeline_cache_data_is_compatible(const SkData& data,
+                                              const VkPhysicalDeviceProperties& props) {
+    struct Header {
+        uint32_t fSize;
+        uint32_t fVersion;
+        uint32_t fVendorID;
+        uint32_t fDeviceID;
+        uint8_t  fUUID[VK_UUID_SIZE];
+    };
+    Header header;
+    if (data.size() < sizeof(Header)) {
+        return false;
+    }
+    memcpy(&header, data.data(), sizeof(Header));
+    return header.fSize >= sizeof(Header) &&
+           header.fVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.fVendorID == props.vendorID &&
+           header.fDeviceID == props.deviceID &&
+           !memcmp(header.fUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+VkPipelineCache GrVkResourceProvider::pipelineCache() {
+    if (VK_NULL_HANDLE != fPipelineCache) {
+        return fPipelineCache;
+    }
+
+    sk_sp<SkData> cached;
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    if (persistentCache) {
+        cached = persistentCache->load(*pipeline_cache_key());
+        if (cached &&
+            !pipeline_cache_data_is_compatible(*cached, fGpu->physicalDeviceProperties())) {
+            cached.reset();
+        }
+        if (cached) {
+            fGpu->stats()->incPersistentCacheHits();
+        } else {
+            fGpu->stats()->incPersistentCacheMisses();
+        }
+    }
+
     VkPipelineCacheCreateInfo createInfo;
     memset(&createInfo, 0, sizeof(VkPipelineCacheCreateInfo));
     createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
     createInfo.pNext = nullptr;
     createInfo.flags = 0;
-    createInfo.initialDataSize = 0;
-    createInfo.pInitialData = nullptr;
+    createInfo.initialDataSize = cached ? cached->size() : 0;
+    createInfo.pInitialData = cached ? cached->data() : nullptr;
     VkResult result = GR_VK_CALL(fGpu->vkInterface(),
                                  CreatePipelineCache(fGpu->device(), &createInfo, nullptr,
                                                      &fPipelineCache));
+    if (VK_SUCCESS != result && cached) {
+        // Start over empty rather than go without a cache.
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        result = GR_VK_CALL(fGpu->vkInterface(),
+                            CreatePipelineCache(fGpu->device(), &createInfo, nullptr,
+                                                &fPipelineCache));
+    }
     SkASSERT(VK_SUCCESS == result);
     if (VK_SUCCESS != result) {
         fPipelineCache = VK_NULL_HANDLE;
     }
+    return fPipelineCache;
+}
 
-    // Init uniform descriptor objects
-    GrVkDescriptorSetManager* dsm = GrVkDescriptorSetManager::CreateUniformManager(fGpu);
-    fDescriptorSetManagers.emplace_back(dsm);
-    SkASSERT(1 == fDescriptorSetManagers.count());
-    fUniformDSHandle = GrVkDescriptorSetManager::Handle(0);
+void GrVkResourceProvider::storePipelineCacheData() {
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    if (!persistentCache || VK_NULL_HANDLE == fPipelineCache) {
+        return;
+    }
+
+    size_t dataSize = 0;
+    VkResult result = GR_VK_CALL(fGpu->vkInterface(), GetPipelineCacheData(fGpu->device(),
+                                                                           fPipelineCache,
+                                                                           &dataSize, nullptr));
+    if (VK_SUCCESS != result || !dataSize) {
+        return;
+    }
+
+    SkAutoMalloc data(dataSize);
+    result = GR_VK_CALL(fGpu->vkInterface(), GetPipelineCacheData(fGpu->device(),
+                                                                  fPipelineCache,
+                                                                  &dataSize, data.get()));
+    if (VK_SUCCESS != result) {
+        return;
+    }
+
+    persistentCache->store(*pipeline_cache_key(), *SkData::MakeWithoutCopy(data.get(), dataSize));
 }
 
 GrVkPipeline* GrVkResourceProvider::createPipeline(const GrPrimitiveProcessor& primProc,
@@ -66,7 +159,7 @@ GrVkPipeline* GrVkResourceProvider::createPipeline(const GrPrimitiveProcessor& p
                                                    VkPipelineLayout layout) {
     return GrVkPipeline::Create(fGpu, primProc, pipeline, stencil, shaderStageInfo,
                                 shaderStageCount, primitiveType, compatibleRenderPass, layout,
-                                fPipelineCache);
+                                this->pipelineCache());
 }
 
 GrVkCopyPipeline* GrVkResourceProvider::findOrCreateCopyPipeline(
@@ -85,7 +178,7 @@ GrVkCopyPipeline* GrVkResourceProvider::findOrCreateCopyPipeline(
                                             pipelineLayout,
                                             dst->numColorSamples(),
                                             *dst->simpleRenderPass(),
-                                            fPipelineCache);
+                                            this->pipelineCache());
         if (!pipeline) {
             return nullptr;
         }
@@ -288,7 +381,9 @@ GrVkSecondaryCommandBuffer* GrVkResourceProvider::findOrCreateSecondaryCommandBu
         cmdBuffer = fAvailableSecondaryCommandBuffers[count-1];
         fAvailableSecondaryCommandBuffers.removeShuffle(count - 1);
     } else {
-        cmdBuffer = GrVkSecondaryCommandBuffer::Create(fGpu, fGpu->cmdPool());
+        SkMutex* cmdPoolMutex;
+        VkCommandPool cmdPool = fGpu->secondaryCmdPool(&cmdPoolMutex);
+        cmdBuffer = GrVkSecondaryCommandBuffer::Create(fGpu, cmdPool, cmdPoolMutex);
     }
     return cmdBuffer;
 }
@@ -314,6 +409,29 @@ void GrVkResourceProvider::recycleStandardUniformBufferResource(const GrVkResour
     fAvailableUniformBufferResources.push_back(resource);
 }
 
+const GrVkResource* GrVkResourceProvider::findDynamicBufferResource(GrVkBuffer::Type type,
+                                                                    size_t size) {
+    for (int i = fAvailableDynamicBufferResources.count() - 1; i >= 0; --i) {
+        const DynamicBufferResource& available = fAvailableDynamicBufferResources[i];
+        if (available.fType == type && available.fSize == size) {
+            const GrVkResource* resource = available.fResource;
+            fAvailableDynamicBufferResources.removeShuffle(i);
+            return resource;
+        }
+    }
+    return nullptr;
+}
+
+void GrVkResourceProvider::recycleDynamicBufferResource(GrVkBuffer::Type type, size_t size,
+                                                        const GrVkResource* resource) {
+    SkASSERT(resource->unique());
+    if (fAvailableDynamicBufferResources.count() >= kMaxAvailableDynamicBufferResources) {
+        resource->unref(fGpu);
+        return;
+    }
+    fAvailableDynamicBufferResources.push_back({type, size, resource});
+}
+
 void GrVkResourceProvider::destroyResources(bool deviceLost) {
     // release our active command buffers
     for (int i = 0; i < fActiveCommandBuffers.count(); ++i) {
@@ -358,6 +476,11 @@ void GrVkResourceProvider::destroyResources(bool deviceLost) {
 
     fPipelineStateCache->release();
 
+    // The ring's chunks hold uniform descriptor sets, so they go before the
+    // GrVkDescriptorSetManagers.
+    fUniformRingBuffer->release();
+    fUniformRingBuffer.reset();
+
     GR_VK_CALL(fGpu->vkInterface(), DestroyPipelineCache(fGpu->device(), fPipelineCache, nullptr));
     fPipelineCache = VK_NULL_HANDLE;
 
@@ -374,6 +497,13 @@ void GrVkResourceProvider::destroyResources(bool deviceLost) {
         fAvailableUniformBufferResources[i]->unref(fGpu);
     }
     fAvailableUniformBufferResources.reset();
+
+    // release our dynamic vertex and index buffers
+    for (int i = 0; i < fAvailableDynamicBufferResources.count(); ++i) {
+        SkASSERT(fAvailableDynamicBufferResources[i].fResource->unique());
+        fAvailableDynamicBufferResources[i].fResource->unref(fGpu);
+    }
+    fAvailableDynamicBufferResources.reset();
 }
 
 void GrVkResourceProvider::abandonResources() {
@@ -417,6 +547,9 @@ void GrVkResourceProvider::abandonResources() {
 
     fPipelineStateCache->abandon();
 
+    fUniformRingBuffer->abandon();
+    fUniformRingBuffer.reset();
+
     fPipelineCache = VK_NULL_HANDLE;
 
     // We must abandon all command buffers and pipeline states before abandoning the
@@ -432,6 +565,13 @@ void GrVkResourceProvider::abandonResources() {
         fAvailableUniformBufferResources[i]->unrefAndAbandon();
     }
     fAvailableUniformBufferResources.reset();
+
+    // release our dynamic vertex and index buffers
+    for (int i = 0; i < fAvailableDynamicBufferResources.count(); ++i) {
+        SkASSERT(fAvailableDynamicBufferResources[i].fResource->unique());
+        fAvailableDynamicBufferResources[i].fResource->unrefAndAbandon();
+    }
+    fAvailableDynamicBufferResources.reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
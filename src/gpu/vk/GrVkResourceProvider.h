@@ -9,6 +9,7 @@
 #define GrVkResourceProvider_DEFINED
 
 #include "GrResourceHandle.h"
+#include "GrVkBuffer.h"
 #include "GrVkDescriptorPool.h"
 #include "GrVkDescriptorSetManager.h"
 #include "GrVkPipelineStateBuilder.h"
@@ -34,6 +35,7 @@ class GrVkRenderTarget;
 class GrVkSampler;
 class GrVkSecondaryCommandBuffer;
 class GrVkUniformHandler;
+class GrVkUniformRingBuffer;
 
 class GrVkResourceProvider {
 public:
@@ -133,6 +135,9 @@ public:
     const GrVkDescriptorSet* getSamplerDescriptorSet(const GrVkDescriptorSetManager::Handle&);
 
 
+    // Returns the ring that GrVkPipelineStates suballocate their uniforms from.
+    GrVkUniformRingBuffer& uniformRingBuffer() { return *fUniformRingBuffer; }
+
     // Signals that the descriptor set passed it, which is compatible with the passed in handle,
     // can be reused by the next allocation request.
     void recycleDescriptorSet(const GrVkDescriptorSet* descSet,
@@ -146,6 +151,14 @@ public:
     // can be reused by the next uniform buffer resource request.
     void recycleStandardUniformBufferResource(const GrVkResource*);
 
+    // Finds a persistently mapped dynamic vertex or index buffer resource, of the given type and
+    // size, that no command buffer is using anymore. Returns nullptr if there isn't one.
+    const GrVkResource* findDynamicBufferResource(GrVkBuffer::Type, size_t size);
+
+    // Signals that the persistently mapped buffer resource passed to it can be reused by the next
+    // request for a dynamic buffer of the same type and size.
+    void recycleDynamicBufferResource(GrVkBuffer::Type, size_t size, const GrVkResource*);
+
     // Destroy any cached resources. To be called before destroying the VkDevice.
     // The assumption is that all queues are idle and all command buffers are finished.
     // For resource tracing to work properly, this should be called after unrefing all other
@@ -159,6 +172,9 @@ public:
     // resource usages.
     void abandonResources();
 
+    // Writes the VkPipelineCache's data to the context's PersistentCache, if it has one.
+    void storePipelineCacheData();
+
 private:
 #ifdef SK_DEBUG
 #define GR_PIPELINE_STATE_CACHE_STATS
@@ -229,6 +245,10 @@ private:
         int                           fLastReturnedIndex;
     };
 
+    // Creates the VkPipelineCache on first use, so it can be seeded from the PersistentCache,
+    // which the context only provides after the GrVkGpu is made.
+    VkPipelineCache pipelineCache();
+
     GrVkGpu* fGpu;
 
     // Central cache for creating pipelines
@@ -250,6 +270,18 @@ private:
     // Array of available uniform buffer resources
     SkSTArray<16, const GrVkResource*, true> fAvailableUniformBufferResources;
 
+    struct DynamicBufferResource {
+        GrVkBuffer::Type    fType;
+        size_t              fSize;
+        const GrVkResource* fResource;
+    };
+    // The most recycled dynamic vertex and index buffers we hold on to for reuse
+    static constexpr int kMaxAvailableDynamicBufferResources = 32;
+    // Array of available dynamic vertex and index buffer resources
+    SkSTArray<16, DynamicBufferResource, true> fAvailableDynamicBufferResources;
+
+    std::unique_ptr<GrVkUniformRingBuffer> fUniformRingBuffer;
+
     // Stores GrVkSampler objects that we've already created so we can reuse them across multiple
     // GrVkPipelineStates
     SkTDynamicHash<GrVkSampler, uint16_t> fSamplers;
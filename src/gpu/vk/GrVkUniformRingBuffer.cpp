@@ -0,0 +1,183 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrVkUniformRingBuffer.h"
+
+#include "GrVkDescriptorSet.h"
+#include "GrVkGpu.h"
+#include "GrVkMemory.h"
+#include "GrVkUniformHandler.h"
+
+#define VK_CALL(GPU, X) GR_VK_CALL(GPU->vkInterface(), X)
+
+VkDescriptorSet GrVkUniformRingBuffer::Chunk::descriptorSet() const {
+    return fDescriptorSet->descriptorSet();
+}
+
+void GrVkUniformRingBuffer::Chunk::freeGPUData(const GrVkGpu* gpu) const {
+    GrVkMemory::UnmapAlloc(gpu, fAlloc);
+    VK_CALL(gpu, DestroyBuffer(gpu->device(), fBuffer, nullptr));
+    GrVkMemory::FreeBufferMemory(gpu, GrVkBuffer::kUniform_Type, fAlloc);
+    fDescriptorSet->unref(gpu);
+}
+
+void GrVkUniformRingBuffer::Chunk::abandonGPUData() const {
+    fDescriptorSet->unrefAndAbandon();
+}
+
+void GrVkUniformRingBuffer::Chunk::onRecycle(GrVkGpu*) const {
+    fRing->fAvailableChunks.push_back(this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+GrVkUniformRingBuffer::GrVkUniformRingBuffer(GrVkGpu* gpu)
+        : fGpu(gpu)
+        , fCurrentChunk(nullptr)
+        , fCurrentOffset(0)
+        , fGeneration(0) {
+    // Offsets are also kept aligned to the non-coherent atom size, so that flushing one
+    // allocation never needs to round out into its neighbours.
+    const VkPhysicalDeviceLimits& limits = gpu->physicalDeviceProperties().limits;
+    fAlignment = SkTMax<uint32_t>(limits.minUniformBufferOffsetAlignment,
+                                  limits.nonCoherentAtomSize);
+    SkASSERT(SkIsPow2(fAlignment));
+    SkASSERT(kBindingRange <= limits.maxUniformBufferRange);
+}
+
+GrVkUniformRingBuffer::~GrVkUniformRingBuffer() {
+    // Must have released or abandoned all chunks before this is destroyed
+    SkASSERT(!fCurrentChunk);
+    SkASSERT(fAvailableChunks.empty());
+}
+
+void* GrVkUniformRingBuffer::allocate(uint32_t size, uint32_t* offset) {
+    SkASSERT(size <= kChunkSize - kBindingRange);
+    // The whole binding range from any offset within the allocation has to lie within the chunk.
+    if (!fCurrentChunk || fCurrentOffset + size + kBindingRange > kChunkSize) {
+        if (!this->nextChunk()) {
+            return nullptr;
+        }
+    }
+    *offset = fCurrentOffset;
+    fCurrentOffset = GrUIAlignUp(fCurrentOffset + size, fAlignment);
+    return static_cast<char*>(fCurrentChunk->fMapPtr) + *offset;
+}
+
+void GrVkUniformRingBuffer::flush(uint32_t offset, uint32_t size) {
+    SkASSERT(fCurrentChunk);
+    GrVkMemory::FlushMappedAlloc(fGpu, fCurrentChunk->fAlloc, offset, size);
+}
+
+bool GrVkUniformRingBuffer::nextChunk() {
+    if (fCurrentChunk) {
+        // If no command buffer is still using the chunk this puts it straight back on the
+        // available list; otherwise the last command buffer to finish with it will.
+        fCurrentChunk->recycle(fGpu);
+        fCurrentChunk = nullptr;
+    }
+    if (!fAvailableChunks.empty()) {
+        fCurrentChunk = fAvailableChunks.back();
+        fAvailableChunks.pop_back();
+    } else {
+        fCurrentChunk = this->createChunk();
+        if (!fCurrentChunk) {
+            return false;
+        }
+    }
+    fCurrentOffset = 0;
+    ++fGeneration;
+    return true;
+}
+
+const GrVkUniformRingBuffer::Chunk* GrVkUniformRingBuffer::createChunk() {
+    VkBufferCreateInfo bufInfo;
+    memset(&bufInfo, 0, sizeof(VkBufferCreateInfo));
+    bufInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufInfo.flags = 0;
+    bufInfo.size = kChunkSize;
+    bufInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufInfo.queueFamilyIndexCount = 0;
+    bufInfo.pQueueFamilyIndices = nullptr;
+
+    VkBuffer buffer;
+    VkResult err = VK_CALL(fGpu, CreateBuffer(fGpu->device(), &bufInfo, nullptr, &buffer));
+    if (err) {
+        return nullptr;
+    }
+
+    GrVkAlloc alloc;
+    if (!GrVkMemory::AllocAndBindBufferMemory(fGpu, buffer, GrVkBuffer::kUniform_Type,
+                                              true,  // dynamic
+                                              &alloc)) {
+        VK_CALL(fGpu, DestroyBuffer(fGpu->device(), buffer, nullptr));
+        return nullptr;
+    }
+
+    void* mapPtr = GrVkMemory::MapAlloc(fGpu, alloc);
+    if (!mapPtr) {
+        VK_CALL(fGpu, DestroyBuffer(fGpu->device(), buffer, nullptr));
+        GrVkMemory::FreeBufferMemory(fGpu, GrVkBuffer::kUniform_Type, alloc);
+        return nullptr;
+    }
+
+    // The descriptor set always points at the chunk, so it is written only this once. Both
+    // bindings cover the same range; the dynamic offsets pick out each draw's blocks.
+    const GrVkDescriptorSet* descriptorSet = fGpu->resourceProvider().getUniformDescriptorSet();
+
+    static const uint32_t kBindings[] = { GrVkUniformHandler::kGeometryBinding,
+                                          GrVkUniformHandler::kFragBinding };
+    VkDescriptorBufferInfo bufferInfo;
+    memset(&bufferInfo, 0, sizeof(VkDescriptorBufferInfo));
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = kBindingRange;
+
+    VkWriteDescriptorSet descriptorWrites[SK_ARRAY_COUNT(kBindings)];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kBindings); ++i) {
+        memset(&descriptorWrites[i], 0, sizeof(VkWriteDescriptorSet));
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].pNext = nullptr;
+        descriptorWrites[i].dstSet = descriptorSet->descriptorSet();
+        descriptorWrites[i].dstBinding = kBindings[i];
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrites[i].pImageInfo = nullptr;
+        descriptorWrites[i].pBufferInfo = &bufferInfo;
+        descriptorWrites[i].pTexelBufferView = nullptr;
+    }
+    VK_CALL(fGpu, UpdateDescriptorSets(fGpu->device(), SK_ARRAY_COUNT(descriptorWrites),
+                                       descriptorWrites, 0, nullptr));
+
+    return new Chunk(this, buffer, alloc, mapPtr, descriptorSet);
+}
+
+void GrVkUniformRingBuffer::release() {
+    if (fCurrentChunk) {
+        fCurrentChunk->unref(fGpu);
+        fCurrentChunk = nullptr;
+    }
+    for (int i = 0; i < fAvailableChunks.count(); ++i) {
+        SkASSERT(fAvailableChunks[i]->unique());
+        fAvailableChunks[i]->unref(fGpu);
+    }
+    fAvailableChunks.reset();
+}
+
+void GrVkUniformRingBuffer::abandon() {
+    if (fCurrentChunk) {
+        fCurrentChunk->unrefAndAbandon();
+        fCurrentChunk = nullptr;
+    }
+    for (int i = 0; i < fAvailableChunks.count(); ++i) {
+        SkASSERT(fAvailableChunks[i]->unique());
+        fAvailableChunks[i]->unrefAndAbandon();
+    }
+    fAvailableChunks.reset();
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrVkUniformRingBuffer_DEFINED
+#define GrVkUniformRingBuffer_DEFINED
+
+#include "GrVkResource.h"
+#include "SkTArray.h"
+#include "vk/GrVkDefines.h"
+#include "vk/GrVkTypes.h"
+
+class GrVkDescriptorSet;
+class GrVkGpu;
+
+/**
+ * Hands out space for the uniforms of every GrVkPipelineState from a few large, persistently
+ * mapped buffers ("chunks"). Each chunk has one descriptor set, written when the chunk is made,
+ * whose bindings are VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC. Draws bind that set with the
+ * dynamic offsets of their uniforms rather than writing a descriptor set of their own.
+ *
+ * Space is handed out front to back. When the current chunk is full the ring moves on to one that
+ * no command buffer is using anymore, or makes a new one. Command buffers that bind a chunk must
+ * hold it as a recycled resource until they finish.
+ */
+class GrVkUniformRingBuffer {
+public:
+    class Chunk : public GrVkRecycledResource {
+    public:
+        VkDescriptorSet descriptorSet() const;
+
+#ifdef SK_TRACE_VK_RESOURCES
+        void dumpInfo() const override {
+            SkDebugf("GrVkUniformRingBuffer::Chunk: %d (%d refs)\n", fBuffer, this->getRefCnt());
+        }
+#endif
+
+    private:
+        Chunk(GrVkUniformRingBuffer* ring, VkBuffer buffer, const GrVkAlloc& alloc, void* mapPtr,
+              const GrVkDescriptorSet* descriptorSet)
+                : fRing(ring)
+                , fBuffer(buffer)
+                , fAlloc(alloc)
+                , fMapPtr(mapPtr)
+                , fDescriptorSet(descriptorSet) {}
+
+        void freeGPUData(const GrVkGpu* gpu) const override;
+        void abandonGPUData() const override;
+        void onRecycle(GrVkGpu* gpu) const override;
+
+        GrVkUniformRingBuffer*   fRing;
+        VkBuffer                 fBuffer;
+        GrVkAlloc                fAlloc;
+        void*                    fMapPtr;
+        const GrVkDescriptorSet* fDescriptorSet;
+
+        friend class GrVkUniformRingBuffer;
+
+        typedef GrVkRecycledResource INHERITED;
+    };
+
+    // The size of each chunk.
+    static constexpr uint32_t kChunkSize = 256 * 1024;
+    // The range of each dynamic binding. Vulkan guarantees maxUniformBufferRange is at least this,
+    // and no uniform block may be larger than it.
+    static constexpr uint32_t kBindingRange = 16 * 1024;
+
+    explicit GrVkUniformRingBuffer(GrVkGpu* gpu);
+    ~GrVkUniformRingBuffer();
+
+    /**
+     * Returns a pointer to 'size' bytes of the current chunk for the caller to copy uniforms into,
+     * and sets 'offset' to the dynamic offset to bind them with. Any offset within the allocation
+     * that is a multiple of alignment() may be bound too. This may move the ring on to a new chunk.
+     * Returns nullptr if a new chunk was needed and could not be made.
+     */
+    void* allocate(uint32_t size, uint32_t* offset);
+
+    // The alignment of every offset returned by allocate().
+    uint32_t alignment() const { return fAlignment; }
+
+    // Makes the caller's writes to the current chunk visible to the device.
+    void flush(uint32_t offset, uint32_t size);
+
+    const Chunk* currentChunk() const { return fCurrentChunk; }
+
+    // Changes whenever the ring moves on to a new chunk. Data allocated while the generation was
+    // different may have been overwritten.
+    uint32_t generation() const { return fGeneration; }
+
+    void release();
+    void abandon();
+
+private:
+    bool nextChunk();
+    const Chunk* createChunk();
+
+    GrVkGpu*                          fGpu;
+    const Chunk*                      fCurrentChunk;
+    uint32_t                          fCurrentOffset;
+    uint32_t                          fGeneration;
+    uint32_t                          fAlignment;
+    SkSTArray<4, const Chunk*, true>  fAvailableChunks;
+};
+
+#endif
@@ -48,6 +48,17 @@ bool GrCompileVkShaderModule(const GrVkGpu* gpu,
                              VkShaderModule* shaderModule,
                              VkPipelineShaderStageCreateInfo* stageInfo,
                              const SkSL::Program::Settings& settings,
-                             SkSL::Program::Inputs* outInputs);
+                             SkSL::Program::Inputs* outInputs,
+                             SkSL::String* outSPIRV = nullptr);
+
+/**
+ * Creates a shader module from SPIR-V previously returned by GrCompileVkShaderModule, skipping the
+ * SkSL compiler.
+ */
+bool GrInstallVkShaderModule(const GrVkGpu* gpu,
+                             const SkSL::String& spirv,
+                             VkShaderStageFlagBits stage,
+                             VkShaderModule* shaderModule,
+                             VkPipelineShaderStageCreateInfo* stageInfo);
 
 #endif
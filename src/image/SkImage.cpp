@@ -369,6 +369,10 @@ sk_sp<SkImage> SkImage::MakeFromAdoptedTexture(GrContext* ctx,
     return nullptr;
 }
 
+sk_sp<SkImage> SkImage::MakeFromCompressed(GrContext*, sk_sp<SkData>, int, int, CompressionType) {
+    return nullptr;
+}
+
 sk_sp<SkImage> SkImage::MakeFromYUVATexturesCopy(GrContext* context,
                                                  SkYUVColorSpace yuvColorSpace,
                                                  const GrBackendTexture yuvaTextures[],
@@ -83,6 +83,9 @@ public:
     // True for images instantiated in GPU memory
     virtual bool onIsTextureBacked() const { return false; }
 
+    // True for GPU images made of separate YUVA planes (SkImage_GpuYUVA).
+    virtual bool isYUVA() const { return false; }
+
     // Call when this image is part of the key to a resourcecache entry. This allows the cache
     // to know automatically those entries can be purged when this SkImage deleted.
     virtual void notifyAddedToRasterCache() const {
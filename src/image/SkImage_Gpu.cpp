@@ -55,7 +55,10 @@ SkImage_Gpu::~SkImage_Gpu() {}
 
 SkImageInfo SkImage_Gpu::onImageInfo() const {
     SkColorType colorType;
-    if (!GrPixelConfigToColorType(fProxy->config(), &colorType)) {
+    if (GrPixelConfigIsCompressed(fProxy->config())) {
+        // Compressed configs decode to opaque RGB when sampled.
+        colorType = kRGB_888x_SkColorType;
+    } else if (!GrPixelConfigToColorType(fProxy->config(), &colorType)) {
         colorType = kUnknown_SkColorType;
     }
 
@@ -116,6 +119,28 @@ sk_sp<SkImage> SkImage::MakeFromAdoptedTexture(GrContext* ctx,
                                       kAdopt_GrWrapOwnership, nullptr, nullptr);
 }
 
+sk_sp<SkImage> SkImage::MakeFromCompressed(GrContext* context, sk_sp<SkData> data,
+                                           int width, int height, CompressionType type) {
+    if (!context || !data || width <= 0 || height <= 0) {
+        return nullptr;
+    }
+    GrPixelConfig config = kUnknown_GrPixelConfig;
+    switch (type) {
+        case CompressionType::kETC1:
+            config = kRGB_ETC1_GrPixelConfig;
+            break;
+    }
+
+    GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
+    sk_sp<GrTextureProxy> proxy = proxyProvider->createCompressedTextureProxy(
+            width, height, SkBudgeted::kYes, config, std::move(data));
+    if (!proxy) {
+        return nullptr;
+    }
+    return sk_make_sp<SkImage_Gpu>(sk_ref_sp(context), kNeedNewImageUniqueID, kOpaque_SkAlphaType,
+                                   std::move(proxy), nullptr, SkBudgeted::kYes);
+}
+
 sk_sp<SkImage> SkImage_Gpu::ConvertYUVATexturesToRGB(
         GrContext* ctx, SkYUVColorSpace yuvColorSpace, const GrBackendTexture yuvaTextures[],
         const SkYUVAIndex yuvaIndices[4], SkISize size, GrSurfaceOrigin origin,
@@ -357,7 +382,7 @@ sk_sp<SkImage> SkImage::makeTextureImage(GrContext* context, SkColorSpace* dstCo
         return nullptr;
     }
     if (GrContext* incumbent = as_IB(this)->context()) {
-        if (incumbent != context) {
+        if (incumbent->uniqueID() != context->uniqueID()) {
             return nullptr;
         }
         sk_sp<GrTextureProxy> proxy = as_IB(this)->asTextureProxyRef();
@@ -294,7 +294,9 @@ bool SkImage_GpuBase::onIsValid(GrContext* context) const {
         return false;
     }
 
-    if (context && context != fContext.get()) {
+    // Images made by GrContextThreadSafeProxy::makeTextureImage() hold a DDL context that shares
+    // the ID of the context they are for.
+    if (context && context->uniqueID() != fContext->uniqueID()) {
         return false;
     }
 
@@ -95,6 +95,20 @@ sk_sp<GrTextureProxy> SkImage_GpuYUVA::asTextureProxyRef() const {
     return fRGBProxy;
 }
 
+std::unique_ptr<GrFragmentProcessor> SkImage_GpuYUVA::asYUVAFragmentProcessor(
+        GrSamplerState::Filter filterMode) const {
+    if (fRGBProxy || this->hasAlphaPlane()) {
+        return nullptr;
+    }
+    for (int i = 0; i < 4; ++i) {
+        int index = fYUVAIndices[i].fIndex;
+        if (index >= 0 && !fProxies[index]) {
+            return nullptr;
+        }
+    }
+    return GrYUVtoRGBEffect::Make(fProxies, fYUVAIndices, fYUVColorSpace, filterMode);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 //*** bundle this into a helper function used by this and SkImage_Gpu?
@@ -105,9 +119,27 @@ sk_sp<SkImage> SkImage_GpuYUVA::MakeFromYUVATextures(GrContext* ctx,
                                                      int width,
                                                      int height,
                                                      GrSurfaceOrigin origin,
-                                                     sk_sp<SkColorSpace> imageColorSpace) {
+                                                     sk_sp<SkColorSpace> imageColorSpace,
+                                                     TextureReleaseProc textureReleaseProc,
+                                                     ReleaseContext textureReleaseContexts[]) {
     GrProxyProvider* proxyProvider = ctx->contextPriv().proxyProvider();
 
+    // Each texture's release proc is handed off to its proxy once it is wrapped. On failure, call
+    // it for the textures that weren't wrapped yet.
+    bool released[4] = { false, false, false, false };
+    auto releaseRemaining = [&] {
+        if (!textureReleaseProc) {
+            return;
+        }
+        for (int i = 0; i < 4; ++i) {
+            int textureIndex = yuvaIndices[i].fIndex;
+            if (textureIndex >= 0 && textureIndex <= 3 && !released[textureIndex]) {
+                released[textureIndex] = true;
+                textureReleaseProc(textureReleaseContexts[textureIndex]);
+            }
+        }
+    };
+
     // Right now this still only deals with YUV and NV12 formats. Assuming that YUV has different
     // textures for U and V planes, while NV12 uses same texture for U and V planes.
     bool nv12 = (yuvaIndices[SkYUVAIndex::kU_Index].fIndex ==
@@ -126,6 +158,7 @@ sk_sp<SkImage> SkImage_GpuYUVA::MakeFromYUVATextures(GrContext* ctx,
         if (yuvaIndex.fIndex == -1 || yuvaIndex.fIndex > 3) {
             // Y plane, U plane, and V plane must refer to image sources being passed in. There are
             // at most 4 image sources being passed in, could not have a index more than 3.
+            releaseRemaining();
             return nullptr;
         }
         SkColorType ct = kUnknown_SkColorType;
@@ -144,6 +177,7 @@ sk_sp<SkImage> SkImage_GpuYUVA::MakeFromYUVATextures(GrContext* ctx,
             if (!ValidateBackendTexture(ctx, yuvaTexturesCopy[yuvaIndex.fIndex],
                                         &yuvaTexturesCopy[yuvaIndex.fIndex].fConfig,
                                         ct, kUnpremul_SkAlphaType, nullptr)) {
+                releaseRemaining();
                 return nullptr;
             }
         }
@@ -165,11 +199,15 @@ sk_sp<SkImage> SkImage_GpuYUVA::MakeFromYUVATextures(GrContext* ctx,
 
         if (!tempTextureProxies[textureIndex]) {
             SkASSERT(yuvaTexturesCopy[textureIndex].isValid());
-            tempTextureProxies[textureIndex] =
-                proxyProvider->wrapBackendTexture(yuvaTexturesCopy[textureIndex], origin);
+            tempTextureProxies[textureIndex] = proxyProvider->wrapBackendTexture(
+                    yuvaTexturesCopy[textureIndex], origin, kBorrow_GrWrapOwnership,
+                    textureReleaseProc,
+                    textureReleaseProc ? textureReleaseContexts[textureIndex] : nullptr);
             if (!tempTextureProxies[textureIndex]) {
+                releaseRemaining();
                 return nullptr;
             }
+            released[textureIndex] = true;
         }
     }
 
@@ -10,10 +10,12 @@
 
 #include "GrBackendSurface.h"
 #include "GrContext.h"
+#include "GrSamplerState.h"
 #include "SkCachedData.h"
 #include "SkImage_GpuBase.h"
 #include "SkYUVAIndex.h"
 
+class GrFragmentProcessor;
 class GrTexture;
 
 // Wraps the 3 or 4 planes of a YUVA image for consumption by the GPU.
@@ -34,6 +36,16 @@ public:
 
     virtual bool onIsTextureBacked() const override { return SkToBool(fProxies[0].get()); }
 
+    bool isYUVA() const override { return true; }
+
+    /**
+     * Returns a fragment processor that samples the planes and converts them to RGB, with local
+     * coords in the image's pixel space, so the image can be drawn without being flattened first.
+     * Returns nullptr once the image has been flattened, since the flattened proxy is then the
+     * cheaper thing to draw, and for images with an alpha plane, which the effect does not premul.
+     */
+    std::unique_ptr<GrFragmentProcessor> asYUVAFragmentProcessor(GrSamplerState::Filter) const;
+
     /**
         Create a new SkImage_GpuYUVA that's very similar to SkImage created by MakeFromYUVATextures.
         The main difference is that the client doesn't have the backend textures on the gpu yet but
@@ -88,6 +100,11 @@ public:
                                                  PromiseDoneProc promiseDoneProc,
                                                  TextureContext textureContexts[]);
 
+    /**
+        If textureReleaseProc is not null, it is called with textureReleaseContexts[i] once Skia is
+        done with yuvaTextures[i], for each texture the indices refer to. It is called even if
+        creating the image fails.
+     */
     static sk_sp<SkImage> MakeFromYUVATextures(GrContext* context,
                                                SkYUVColorSpace yuvColorSpace,
                                                const GrBackendTexture yuvaTextures[],
@@ -95,9 +112,13 @@ public:
                                                int width,
                                                int height,
                                                GrSurfaceOrigin imageOrigin,
-                                               sk_sp<SkColorSpace> imageColorSpace);
+                                               sk_sp<SkColorSpace> imageColorSpace,
+                                               TextureReleaseProc textureReleaseProc = nullptr,
+                                               ReleaseContext textureReleaseContexts[] = nullptr);
 
 private:
+    bool hasAlphaPlane() const { return -1 != fYUVAIndices[SkYUVAIndex::kA_Index].fIndex; }
+
     // This array will usually only be sparsely populated.
     // The actual non-null fields are dictated by the 'fYUVAIndices' indices
     sk_sp<GrTextureProxy>            fProxies[4];
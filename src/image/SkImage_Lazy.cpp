@@ -13,7 +13,9 @@
 #include "SkImageGenerator.h"
 #include "SkImagePriv.h"
 #include "SkNextID.h"
+#include "SkOpts.h"
 #include "SkPixelRef.h"
+#include "SkSharedDiscardableMemoryPool.h"
 
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -25,6 +27,7 @@
 #include "GrSamplerState.h"
 #include "GrYUVProvider.h"
 #include "SkGr.h"
+#include "SkImage_GpuYUVA.h"
 #endif
 
 // Ref-counted tuple(SkImageGenerator, SkMutex) which allows sharing one generator among N images
@@ -120,7 +123,8 @@ SkImage_Lazy::SkImage_Lazy(Validator* validator)
         : INHERITED(validator->fInfo.width(), validator->fInfo.height(), validator->fUniqueID)
         , fSharedGenerator(std::move(validator->fSharedGenerator))
         , fInfo(validator->fInfo)
-        , fOrigin(validator->fOrigin) {
+        , fOrigin(validator->fOrigin)
+        , fContentID(0) {
     SkASSERT(fSharedGenerator);
     fUniqueID = validator->fUniqueID;
 }
@@ -161,7 +165,7 @@ bool SkImage_Lazy::directGeneratePixels(const SkImageInfo& info, void* pixels, s
 bool SkImage_Lazy::lockAsBitmapOnlyIfAlreadyCached(SkBitmap* bitmap,
                                                    const SkImageInfo& dstInfo) const {
     auto desc = SkBitmapCacheDesc::Make(fUniqueID, dstInfo.colorType(), dstInfo.colorSpace(),
-                                        SkIRect::MakeSize(fInfo.dimensions()));
+                                        this->onGetSubset());
     return SkBitmapCache::Find(desc, bitmap) &&
            check_output_bitmap(*bitmap, dstInfo);
 }
@@ -213,8 +217,18 @@ bool SkImage_Lazy::lockAsBitmap(SkBitmap* bitmap, SkImage::CachingHint chint,
     SkPixmap pmap;
     if (SkImage::kAllow_CachingHint == chint) {
         auto desc = SkBitmapCacheDesc::Make(fUniqueID, info.colorType(), info.colorSpace(),
-                                            SkIRect::MakeSize(info.dimensions()));
-        cacheRec = SkBitmapCache::Alloc(desc, info, &pmap);
+                                            this->onGetSubset());
+        if (uint64_t contentID = this->sharedContentID()) {
+            // Another process may have decoded us already.
+            if (SkBitmapCache::FindShared(desc, contentID, info, bitmap)) {
+                this->notifyAddedToRasterCache();
+                check_output_bitmap(*bitmap, info);
+                return true;
+            }
+            cacheRec = SkBitmapCache::AllocShared(desc, contentID, info, &pmap);
+        } else {
+            cacheRec = SkBitmapCache::Alloc(desc, info, &pmap);
+        }
         if (!cacheRec) {
             return false;
         }
@@ -244,6 +258,25 @@ bool SkImage_Lazy::lockAsBitmap(SkBitmap* bitmap, SkImage::CachingHint chint,
     return true;
 }
 
+uint64_t SkImage_Lazy::sharedContentID() const {
+    if (!SkSharedDiscardableMemoryPool::Global()) {
+        return 0;
+    }
+    fContentIDOnce([this] {
+        sk_sp<SkData> encoded = this->onRefEncoded();
+        if (encoded) {
+            // Two 32-bit hashes with different seeds, so that collisions are unlikely across
+            // every image on the machine. The subset, color type and color space are keyed
+            // separately.
+            const uint32_t hi = SkOpts::hash(encoded->data(), encoded->size(),
+                                             SkToU32(encoded->size()));
+            const uint32_t lo = SkOpts::hash(encoded->data(), encoded->size(), ~hi);
+            fContentID = (uint64_t)hi << 32 | lo;
+        }
+    });
+    return fContentID;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool SkImage_Lazy::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
@@ -404,8 +437,9 @@ sk_sp<SkCachedData> SkImage_Lazy::getPlanes(SkYUVSizeInfo* yuvSizeInfo,
  *
  *  1. Check the cache for a pre-existing one
  *  2. Ask the generator to natively create one
- *  3. Ask the generator to return YUV planes, which the GPU can convert
- *  4. Ask the generator to return RGB(A) data, which the GPU can convert
+ *  3. Ask the generator to return YUV planes in textures, which the GPU can convert
+ *  4. Ask the generator to return YUV planes, which the GPU can convert
+ *  5. Ask the generator to return RGB(A) data, which the GPU can convert
  */
 sk_sp<GrTextureProxy> SkImage_Lazy::lockTextureProxy(
         GrContext* ctx,
@@ -423,9 +457,10 @@ sk_sp<GrTextureProxy> SkImage_Lazy::lockTextureProxy(
         kCompressed_LockTexturePath, // Deprecated
         kYUV_LockTexturePath,
         kRGBA_LockTexturePath,
+        kYUVATextures_LockTexturePath,
     };
 
-    enum { kLockTexturePathCount = kRGBA_LockTexturePath + 1 };
+    enum { kLockTexturePathCount = kYUVATextures_LockTexturePath + 1 };
 
     // Build our texture key.
     // Even though some proxies created here may have a specific origin and use that origin, we do
@@ -470,7 +505,33 @@ sk_sp<GrTextureProxy> SkImage_Lazy::lockTextureProxy(
         }
     }
 
-    // 3. Ask the generator to return YUV planes, which the GPU can convert. If we will be mipping
+    // 3. Ask the generator to return YUV planes in textures, which the GPU can convert. This only
+    //    applies to the whole image, in the generator's color space.
+    if (!proxy && !ctx->contextPriv().disableGpuYUVConversion()) {
+        ScopedGenerator generator(fSharedGenerator);
+        const SkImageInfo& generatorInfo = generator->getInfo();
+        SkImageGenerator::YUVATextures textures;
+        if (fOrigin.isZero() && fInfo.dimensions() == generatorInfo.dimensions() &&
+                SkColorSpace::Equals(fInfo.colorSpace(), generatorInfo.colorSpace()) &&
+                generator->getYUVATextures(ctx, &textures)) {
+            sk_sp<SkImage> image = SkImage_GpuYUVA::MakeFromYUVATextures(
+                    ctx, textures.fYUVColorSpace, textures.fTextures, textures.fIndices,
+                    fInfo.width(), fInfo.height(), textures.fOrigin, fInfo.refColorSpace(),
+                    textures.fReleaseProc, textures.fReleaseContexts);
+            if (image && (proxy = as_IB(image)->asTextureProxyRef())) {
+                SK_HISTOGRAM_ENUMERATION("LockTexturePath", kYUVATextures_LockTexturePath,
+                                         kLockTexturePathCount);
+                set_key_on_proxy(proxyProvider, proxy.get(), nullptr, key);
+                if (!willBeMipped) {
+                    *fUniqueKeyInvalidatedMessages.append() =
+                            new GrUniqueKeyInvalidatedMessage(key, ctx->uniqueID());
+                    return proxy;
+                }
+            }
+        }
+    }
+
+    // 4. Ask the generator to return YUV planes, which the GPU can convert. If we will be mipping
     //    the texture we fall through here and have the CPU generate the mip maps for us.
     if (!proxy && !willBeMipped && !ctx->contextPriv().disableGpuYUVConversion()) {
         const GrSurfaceDesc desc = GrImageInfoToSurfaceDesc(fInfo);
@@ -496,7 +557,7 @@ sk_sp<GrTextureProxy> SkImage_Lazy::lockTextureProxy(
         }
     }
 
-    // 4. Ask the generator to return RGB(A) data, which the GPU can convert
+    // 5. Ask the generator to return RGB(A) data, which the GPU can convert
     SkBitmap bitmap;
     if (!proxy && this->lockAsBitmap(&bitmap, chint, fInfo)) {
         if (willBeMipped) {
@@ -10,6 +10,7 @@
 
 #include "SkImage_Base.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 
 #if SK_SUPPORT_GPU
 #include "GrTextureMaker.h"
@@ -90,6 +91,13 @@ private:
      */
     bool lockAsBitmap(SkBitmap*, SkImage::CachingHint, const SkImageInfo&) const;
 
+    /**
+     *  Returns an ID for our pixels that is the same in every process, to share them through the
+     *  global SkSharedDiscardableMemoryPool. Returns 0 if there is no such pool, or we have no
+     *  encoded data to make the ID from.
+     */
+    uint64_t sharedContentID() const;
+
     sk_sp<SharedGenerator> fSharedGenerator;
     // Note that fInfo is not necessarily the info from the generator. It may be cropped by
     // onMakeSubset and its color space may be changed by onMakeColorSpace.
@@ -98,6 +106,9 @@ private:
 
     uint32_t fUniqueID;
 
+    mutable SkOnce   fContentIDOnce;
+    mutable uint64_t fContentID;
+
     // Repeated calls to onMakeColorSpace will result in a proliferation of unique IDs and
     // SkImage_Lazy instances. Cache the result of the last successful onMakeColorSpace call.
     mutable SkMutex             fOnMakeColorSpaceMutex;
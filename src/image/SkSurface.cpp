@@ -6,10 +6,13 @@
  */
 
 #include "SkAtomics.h"
+#include "SkAutoPixmapStorage.h"
 #include "SkCanvas.h"
 #include "SkFontLCDConfig.h"
+#include "SkImageInfoPriv.h"
 #include "SkImagePriv.h"
 #include "SkSurface_Base.h"
+#include "SkTemplates.h"
 
 #include "GrBackendSurface.h"
 
@@ -87,6 +90,113 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y, const SkPa
     }
 }
 
+void SkSurface_Base::onAsyncReadPixels(const SkImageInfo& info, int srcX, int srcY,
+                                       ReadPixelsCallback callback, ReadPixelsContext context) {
+    SkAutoPixmapStorage pm;
+    if (!pm.tryAlloc(info) || !this->getCanvas()->readPixels(pm, srcX, srcY)) {
+        callback(context, nullptr, 0);
+        return;
+    }
+    callback(context, pm.addr(), pm.rowBytes());
+}
+
+void SkSurface_Base::onAsyncReadPixelsYUV420(SkYUVColorSpace yuvColorSpace,
+                                             const SkIRect& srcRect,
+                                             ReadPixelsYUV420Callback callback,
+                                             ReadPixelsContext context) {
+    const void* planes[3] = {};
+    size_t rowBytes[3] = {};
+
+    int w = srcRect.width(),
+        h = srcRect.height();
+    SkAutoPixmapStorage rgba;
+    auto info = SkImageInfo::Make(w, h, kRGBA_8888_SkColorType, kPremul_SkAlphaType,
+                                  this->getCanvas()->imageInfo().refColorSpace());
+    if (!rgba.tryAlloc(info) ||
+        !this->getCanvas()->readPixels(rgba, srcRect.fLeft, srcRect.fTop)) {
+        callback(context, planes, rowBytes);
+        return;
+    }
+
+    float m[12];
+    RGBToYUVMatrix(yuvColorSpace, m);
+    auto convert = [&m](int plane, float r, float g, float b) {
+        const float* row = m + 4 * plane;
+        float v = row[0] * r + row[1] * g + row[2] * b + row[3];
+        return SkToU8(SkTPin(sk_float_round2int(v * 255), 0, 255));
+    };
+
+    int cw = (w + 1) / 2,
+        ch = (h + 1) / 2;
+    SkAutoTMalloc<uint8_t> y(w * h), u(cw * ch), v(cw * ch);
+    for (int j = 0; j < h; ++j) {
+        for (int i = 0; i < w; ++i) {
+            const uint8_t* p = static_cast<const uint8_t*>(rgba.addr(i, j));
+            y[j * w + i] = convert(0, p[0] / 255.f, p[1] / 255.f, p[2] / 255.f);
+        }
+    }
+    // Each U and V sample is of the average of the 2x2 block it covers, or as much of it as there
+    // is at the right and bottom edges.
+    for (int j = 0; j < ch; ++j) {
+        for (int i = 0; i < cw; ++i) {
+            float r = 0, g = 0, b = 0;
+            int n = 0;
+            for (int jj = 2 * j; jj < SkTMin(2 * j + 2, h); ++jj) {
+                for (int ii = 2 * i; ii < SkTMin(2 * i + 2, w); ++ii, ++n) {
+                    const uint8_t* p = static_cast<const uint8_t*>(rgba.addr(ii, jj));
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            float scale = 1.f / (255 * n);
+            u[j * cw + i] = convert(1, r * scale, g * scale, b * scale);
+            v[j * cw + i] = convert(2, r * scale, g * scale, b * scale);
+        }
+    }
+
+    planes[0] = y.get();
+    planes[1] = u.get();
+    planes[2] = v.get();
+    rowBytes[0] = w;
+    rowBytes[1] = rowBytes[2] = cw;
+    callback(context, planes, rowBytes);
+}
+
+void SkSurface_Base::RGBToYUVMatrix(SkYUVColorSpace yuvColorSpace, float matrix[12]) {
+    // Full range BT.601.
+    static const float kJPEG[12] = {
+         0.299000f,  0.587000f,  0.114000f, 0,
+        -0.168736f, -0.331264f,  0.500000f, 128 / 255.f,
+         0.500000f, -0.418688f, -0.081312f, 128 / 255.f,
+    };
+    // Limited (video) range BT.601.
+    static const float kRec601[12] = {
+         0.256788f,  0.504129f,  0.097906f, 16 / 255.f,
+        -0.148223f, -0.290993f,  0.439216f, 128 / 255.f,
+         0.439216f, -0.367788f, -0.071427f, 128 / 255.f,
+    };
+    // Limited (video) range BT.709.
+    static const float kRec709[12] = {
+         0.182586f,  0.614231f,  0.062007f, 16 / 255.f,
+        -0.100644f, -0.338572f,  0.439216f, 128 / 255.f,
+         0.439216f, -0.398942f, -0.040274f, 128 / 255.f,
+    };
+    const float* src = kJPEG;
+    switch (yuvColorSpace) {
+        case kJPEG_SkYUVColorSpace:
+            src = kJPEG;
+            break;
+        case kRec601_SkYUVColorSpace:
+            src = kRec601;
+            break;
+        case kRec709_SkYUVColorSpace:
+            src = kRec709;
+            break;
+    }
+    memcpy(matrix, src, sizeof(kJPEG));
+}
+
 bool SkSurface_Base::outstandingImageSnapshot() const {
     return fCachedImage && !fCachedImage->unique();
 }
@@ -194,6 +304,29 @@ bool SkSurface::readPixels(const SkBitmap& bitmap, int srcX, int srcY) {
     return bitmap.peekPixels(&pm) && this->readPixels(pm, srcX, srcY);
 }
 
+void SkSurface::asyncReadPixels(const SkImageInfo& dstInfo, int srcX, int srcY,
+                                ReadPixelsCallback callback, ReadPixelsContext context) {
+    SkIRect srcRect = SkIRect::MakeXYWH(srcX, srcY, dstInfo.width(), dstInfo.height());
+    if (!SkImageInfoIsValid(dstInfo) ||
+        !SkIRect::MakeWH(this->width(), this->height()).contains(srcRect)) {
+        callback(context, nullptr, 0);
+        return;
+    }
+    asSB(this)->onAsyncReadPixels(dstInfo, srcX, srcY, callback, context);
+}
+
+void SkSurface::asyncReadPixelsYUV420(SkYUVColorSpace yuvColorSpace, const SkIRect& srcRect,
+                                      ReadPixelsYUV420Callback callback,
+                                      ReadPixelsContext context) {
+    if (srcRect.isEmpty() || !SkIRect::MakeWH(this->width(), this->height()).contains(srcRect)) {
+        const void* planes[3] = {};
+        size_t rowBytes[3] = {};
+        callback(context, planes, rowBytes);
+        return;
+    }
+    asSB(this)->onAsyncReadPixelsYUV420(yuvColorSpace, srcRect, callback, context);
+}
+
 void SkSurface::writePixels(const SkPixmap& pmap, int x, int y) {
     if (pmap.addr() == nullptr || pmap.width() <= 0 || pmap.height() <= 0) {
         return;
@@ -42,6 +42,21 @@ public:
 
     virtual void onWritePixels(const SkPixmap&, int x, int y) = 0;
 
+    /**
+     *  Default implementations read the pixels synchronously and call back right away. The source
+     *  rectangle has already been checked to lie within the surface.
+     */
+    virtual void onAsyncReadPixels(const SkImageInfo&, int srcX, int srcY, ReadPixelsCallback,
+                                   ReadPixelsContext);
+    virtual void onAsyncReadPixelsYUV420(SkYUVColorSpace, const SkIRect& srcRect,
+                                         ReadPixelsYUV420Callback, ReadPixelsContext);
+
+    /**
+     *  Fills in the RGB to YUV conversion for the color space: a row each for Y, U, and V, of the
+     *  weights of R, G, and B followed by an offset, all in the range 0 to 1.
+     */
+    static void RGBToYUVMatrix(SkYUVColorSpace, float matrix[12]);
+
     /**
      *  Default implementation:
      *
@@ -8,12 +8,14 @@
 #include "SkSurface_Gpu.h"
 #include "GrBackendSurface.h"
 #include "GrCaps.h"
+#include "GrClip.h"
 #include "GrContextPriv.h"
 #include "GrRenderTarget.h"
 #include "GrRenderTargetContextPriv.h"
 #include "GrRenderTargetProxyPriv.h"
 #include "GrTexture.h"
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkDeferredDisplayList.h"
 #include "SkGpuDevice.h"
 #include "SkImagePriv.h"
@@ -21,6 +23,8 @@
 #include "SkImage_Gpu.h"
 #include "SkSurfaceCharacterization.h"
 #include "SkSurface_Base.h"
+#include "effects/GrSimpleTextureEffect.h"
+#include "effects/GrTextureDomain.h"
 
 #if SK_SUPPORT_GPU
 
@@ -123,6 +127,107 @@ void SkSurface_Gpu::onWritePixels(const SkPixmap& src, int x, int y) {
     fDevice->writePixels(src, x, y);
 }
 
+void SkSurface_Gpu::onAsyncReadPixels(const SkImageInfo& info, int srcX, int srcY,
+                                      ReadPixelsCallback callback, ReadPixelsContext context) {
+    GrRenderTargetContext* rtc = fDevice->accessRenderTargetContext();
+    SkColorSpace* srcColorSpace = rtc->colorSpaceInfo().colorSpace();
+    GrColorType colorType = SkColorTypeToGrColorType(info.colorType());
+    // Anything that has to be done to the pixels on the CPU is left to the synchronous read.
+    bool needsConversion =
+            GrColorType::kUnknown == colorType ||
+            (srcColorSpace && !SkColorSpace::Equals(srcColorSpace, info.colorSpace())) ||
+            (kUnpremul_SkAlphaType == info.alphaType() && !fDevice->imageInfo().isOpaque());
+    if (!needsConversion) {
+        GrSurfaceContext* src = rtc;
+        SkIRect srcRect = SkIRect::MakeXYWH(srcX, srcY, info.width(), info.height());
+        auto readDone = [callback, context](const void* const planes[], const size_t rowBytes[]) {
+            callback(context, planes[0], rowBytes[0]);
+        };
+        if (fDevice->context()->contextPriv().asyncReadSurfacePixels(&src, &srcRect, &colorType, 1,
+                                                                      readDone)) {
+            return;
+        }
+    }
+    INHERITED::onAsyncReadPixels(info, srcX, srcY, callback, context);
+}
+
+void SkSurface_Gpu::onAsyncReadPixelsYUV420(SkYUVColorSpace yuvColorSpace, const SkIRect& srcRect,
+                                            ReadPixelsYUV420Callback callback,
+                                            ReadPixelsContext context) {
+    GrContext* ctx = fDevice->context();
+    GrRenderTargetContext* rtc = fDevice->accessRenderTargetContext();
+    sk_sp<GrTextureProxy> srcProxy = rtc->asTextureProxyRef();
+    if (!srcProxy || !ctx->contextPriv().caps()->isConfigRenderable(kAlpha_8_GrPixelConfig)) {
+        INHERITED::onAsyncReadPixelsYUV420(yuvColorSpace, srcRect, callback, context);
+        return;
+    }
+
+    float yuv[12];
+    RGBToYUVMatrix(yuvColorSpace, yuv);
+
+    // Draw each plane into an A8 target: a color matrix puts the plane's value in alpha. U and V
+    // sample between each 2x2 block of pixels so that bilerp averages it, clamped to srcRect.
+    int w = srcRect.width(),
+        h = srcRect.height();
+    const SkISize sizes[3] = {{w, h}, {(w + 1) / 2, (h + 1) / 2}, {(w + 1) / 2, (h + 1) / 2}};
+    sk_sp<GrRenderTargetContext> planes[3];
+    for (int i = 0; i < 3; ++i) {
+        planes[i] = ctx->contextPriv().makeDeferredRenderTargetContext(
+                SkBackingFit::kApprox, sizes[i].width(), sizes[i].height(),
+                kAlpha_8_GrPixelConfig, nullptr, 1, GrMipMapped::kNo, kTopLeft_GrSurfaceOrigin);
+        if (!planes[i]) {
+            INHERITED::onAsyncReadPixelsYUV420(yuvColorSpace, srcRect, callback, context);
+            return;
+        }
+
+        float matrix[20] = {};
+        matrix[15] = yuv[4 * i + 0];
+        matrix[16] = yuv[4 * i + 1];
+        matrix[17] = yuv[4 * i + 2];
+        matrix[19] = yuv[4 * i + 3] * 255;
+        auto matrixFP = SkColorFilter::MakeMatrixFilterRowMajor255(matrix)->asFragmentProcessor(
+                ctx, planes[i]->colorSpaceInfo());
+
+        std::unique_ptr<GrFragmentProcessor> textureFP;
+        SkRect localRect = SkRect::Make(srcRect);
+        if (0 == i) {
+            textureFP = GrSimpleTextureEffect::Make(srcProxy, SkMatrix::I(),
+                                                    GrSamplerState::Filter::kNearest);
+        } else {
+            textureFP = GrTextureDomainEffect::Make(srcProxy, SkMatrix::I(),
+                                                    localRect.makeInset(0.5f, 0.5f),
+                                                    GrTextureDomain::kClamp_Mode,
+                                                    GrSamplerState::Filter::kBilerp);
+            localRect.fRight = localRect.fLeft + 2 * sizes[i].width();
+            localRect.fBottom = localRect.fTop + 2 * sizes[i].height();
+        }
+        if (!matrixFP || !textureFP) {
+            INHERITED::onAsyncReadPixelsYUV420(yuvColorSpace, srcRect, callback, context);
+            return;
+        }
+
+        GrPaint paint;
+        paint.setPorterDuffXPFactory(SkBlendMode::kSrc);
+        paint.addColorFragmentProcessor(std::move(textureFP));
+        paint.addColorFragmentProcessor(std::move(matrixFP));
+        planes[i]->fillRectToRect(GrNoClip(), std::move(paint), GrAA::kNo, SkMatrix::I(),
+                                  SkRect::Make(sizes[i]), localRect);
+    }
+
+    GrSurfaceContext* srcs[3] = {planes[0].get(), planes[1].get(), planes[2].get()};
+    const SkIRect srcRects[3] = {SkIRect::MakeSize(sizes[0]), SkIRect::MakeSize(sizes[1]),
+                                 SkIRect::MakeSize(sizes[2])};
+    const GrColorType colorTypes[3] = {GrColorType::kAlpha_8, GrColorType::kAlpha_8,
+                                       GrColorType::kAlpha_8};
+    auto readDone = [callback, context](const void* const planes[], const size_t rowBytes[]) {
+        const void* yuvPlanes[3] = {planes[0], planes[1], planes[2]};
+        callback(context, yuvPlanes, rowBytes);
+    };
+    if (!ctx->contextPriv().asyncReadSurfacePixels(srcs, srcRects, colorTypes, 3, readDone)) {
+        INHERITED::onAsyncReadPixelsYUV420(yuvColorSpace, srcRect, callback, context);
+    }
+}
+
 // Create a new render target and, if necessary, copy the contents of the old
 // render target into it. Note that this flushes the SkGpuDevice but
 // doesn't force an OpenGL flush.
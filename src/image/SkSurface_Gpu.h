@@ -30,6 +30,10 @@ public:
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
     sk_sp<SkImage> onNewImageSnapshot() override;
     void onWritePixels(const SkPixmap&, int x, int y) override;
+    void onAsyncReadPixels(const SkImageInfo&, int srcX, int srcY, ReadPixelsCallback,
+                           ReadPixelsContext) override;
+    void onAsyncReadPixelsYUV420(SkYUVColorSpace, const SkIRect& srcRect,
+                                 ReadPixelsYUV420Callback, ReadPixelsContext) override;
     void onCopyOnWrite(ContentChangeMode) override;
     void onDiscard() override;
     GrSemaphoresSubmitted onFlush(int numSemaphores,
@@ -11,6 +11,7 @@
 #include "SkCanvas.h"
 #include "SkDevice.h"
 #include "SkMallocPixelRef.h"
+#include "SkThreadedBMPDevice.h"
 
 class SkSurface_Raster : public SkSurface_Base {
 public:
@@ -26,11 +27,17 @@ public:
     void onDraw(SkCanvas*, SkScalar x, SkScalar y, const SkPaint*) override;
     void onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
+    void onDiscard() override;
 
 private:
-    SkBitmap    fBitmap;
-    size_t      fRowBytes;
-    bool        fWeOwnThePixels;
+    void flushPendingDraws();
+
+    SkBitmap            fBitmap;
+    size_t              fRowBytes;
+    bool                fWeOwnThePixels;
+    // The pixels we last forked away from, still shared with an earlier snapshot. Once that
+    // snapshot is gone, the next copy-on-write reuses them instead of allocating new ones.
+    sk_sp<SkPixelRef>   fRetiredPixelRef;
 
     typedef SkSurface_Base INHERITED;
 };
@@ -87,7 +94,19 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (this->props().isThreadedRaster()) {
+        return new SkCanvas(sk_make_sp<SkThreadedBMPDevice>(fBitmap, this->props()));
+    }
+    return new SkCanvas(fBitmap, this->props());
+}
+
+void SkSurface_Raster::flushPendingDraws() {
+    // Only the threaded device and batched path fills defer their draws.
+    if (this->props().isThreadedRaster() || this->props().isBatchRasterPathFills()) {
+        this->getCachedCanvas()->flush();
+    }
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
     return SkSurface::MakeRaster(info, &this->props());
@@ -95,10 +114,13 @@ sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
 
 void SkSurface_Raster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                               const SkPaint* paint) {
+    this->flushPendingDraws();
     canvas->drawBitmap(fBitmap, x, y, paint);
 }
 
 sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot() {
+    this->flushPendingDraws();
+
     SkCopyPixelsMode cpm = kIfMutable_SkCopyPixelsMode;
     if (fWeOwnThePixels) {
         // SkImage_raster requires these pixels are immutable for its full lifetime.
@@ -116,6 +138,7 @@ sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot() {
 }
 
 void SkSurface_Raster::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushPendingDraws();
     fBitmap.writePixels(src, x, y);
 }
 
@@ -124,6 +147,12 @@ void SkSurface_Raster::onRestoreBackingMutability() {
     if (SkPixelRef* pr = fBitmap.pixelRef()) {
         pr->restoreMutability();
     }
+    // Snapshots aren't outliving our draws, so we're unlikely to fork again soon.
+    fRetiredPixelRef.reset();
+}
+
+void SkSurface_Raster::onDiscard() {
+    fRetiredPixelRef.reset();
 }
 
 void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
@@ -132,11 +161,19 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     SkASSERT(cached);
     if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
         SkASSERT(fWeOwnThePixels);
-        if (kDiscard_ContentChangeMode == mode) {
-            fBitmap.allocPixels();
+        SkBitmap prev(fBitmap);
+        if (fRetiredPixelRef && fRetiredPixelRef->unique()) {
+            // The snapshot that shared these pixels is gone, so they're ours to draw into again.
+            // Give them a new generation ID so nothing cached against their old contents is hit.
+            fRetiredPixelRef->restoreMutability();
+            fRetiredPixelRef->notifyPixelsChanged();
+            fBitmap.setPixelRef(std::move(fRetiredPixelRef), 0, 0);
         } else {
-            SkBitmap prev(fBitmap);
             fBitmap.allocPixels();
+        }
+        fRetiredPixelRef = sk_ref_sp(prev.pixelRef());
+
+        if (kRetain_ContentChangeMode == mode) {
             SkASSERT(prev.info() == fBitmap.info());
             SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
             memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.computeByteSize());
@@ -10,11 +10,13 @@
 #ifdef SK_HAS_JPEG_LIBRARY
 
 #include "SkColorData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoderFns.h"
 #include "SkImageInfoPriv.h"
 #include "SkJpegEncoder.h"
 #include "SkJPEGWriteUtility.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
 #include <stdio.h>
@@ -166,6 +168,23 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     return true;
 }
 
+static void write_icc_marker(jpeg_compress_struct* cinfo, const SkImageInfo& info) {
+    sk_sp<SkData> icc = icc_from_color_space(info);
+    if (icc) {
+        // Create a contiguous block of memory with the icc signature followed by the profile.
+        sk_sp<SkData> markerData =
+                SkData::MakeUninitialized(kICCMarkerHeaderSize + icc->size());
+        uint8_t* ptr = (uint8_t*) markerData->writable_data();
+        memcpy(ptr, kICCSig, sizeof(kICCSig));
+        ptr += sizeof(kICCSig);
+        *ptr++ = 1; // This is the first marker.
+        *ptr++ = 1; // Out of one total markers.
+        memcpy(ptr, icc->data(), icc->size());
+
+        jpeg_write_marker(cinfo, kICCMarker, markerData->bytes(), markerData->size());
+    }
+}
+
 std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                                const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -185,21 +204,7 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
-
-    sk_sp<SkData> icc = icc_from_color_space(src.info());
-    if (icc) {
-        // Create a contiguous block of memory with the icc signature followed by the profile.
-        sk_sp<SkData> markerData =
-                SkData::MakeUninitialized(kICCMarkerHeaderSize + icc->size());
-        uint8_t* ptr = (uint8_t*) markerData->writable_data();
-        memcpy(ptr, kICCSig, sizeof(kICCSig));
-        ptr += sizeof(kICCSig);
-        *ptr++ = 1; // This is the first marker.
-        *ptr++ = 1; // Out of one total markers.
-        memcpy(ptr, icc->data(), icc->size());
-
-        jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
-    }
+    write_icc_marker(encoderMgr->cinfo(), src.info());
 
     return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
 }
@@ -238,7 +243,175 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
     return true;
 }
 
+// Aim for strips of about this many pixels, so that each task has enough work to be worth it.
+static constexpr int kStripPixels = 64 * 1024;
+
+// Size of a minimum coded unit, in pixels.  Strips must be a whole number of MCUs tall.
+static SkISize mcu_size(SkColorType colorType, SkJpegEncoder::Downsample downsample) {
+    if (kGray_8_SkColorType == colorType) {
+        return {8, 8};
+    }
+    switch (downsample) {
+        case SkJpegEncoder::Downsample::k420: return {16, 16};
+        case SkJpegEncoder::Downsample::k422: return {16,  8};
+        case SkJpegEncoder::Downsample::k444: return { 8,  8};
+    }
+    return {8, 8};
+}
+
+// Encodes |src| on its own, with the standard Huffman tables so that its entropy coded
+// data can be spliced into another image encoded the same way.  Only the first strip's
+// headers are kept, so only it needs the color profile.
+static bool encode_strip(SkWStream* dst, const SkPixmap& src,
+                         const SkJpegEncoder::Options& options, bool first) {
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    jpeg_compress_struct* cinfo = encoderMgr->cinfo();
+    SkAutoTMalloc<uint8_t> storage;
+
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return false;
+    }
+
+    if (!encoderMgr->setParams(src.info(), options)) {
+        return false;
+    }
+    cinfo->optimize_coding = FALSE;
+    jpeg_set_quality(cinfo, options.fQuality, TRUE);
+    jpeg_start_compress(cinfo, TRUE);
+    if (first) {
+        write_icc_marker(cinfo, src.info());
+    }
+
+    if (encoderMgr->proc()) {
+        storage.reset(cinfo->input_components * src.width());
+    }
+    for (int y = 0; y < src.height(); y++) {
+        JSAMPLE* jpegSrcRow = (JSAMPLE*) src.addr(0, y);
+        if (encoderMgr->proc()) {
+            encoderMgr->proc()((char*)storage.get(), (const char*)jpegSrcRow, src.width(),
+                               cinfo->input_components, nullptr);
+            jpegSrcRow = storage.get();
+        }
+        jpeg_write_scanlines(cinfo, &jpegSrcRow, 1);
+    }
+    jpeg_finish_compress(cinfo);
+    return true;
+}
+
+// Finds the SOF0 and SOS segments of an encoded strip, and the start of its entropy coded
+// data.  The data runs until the EOI marker that ends the strip.
+static bool find_scan(const SkData* strip, size_t* sof, size_t* sos, size_t* scan) {
+    const uint8_t* data = strip->bytes();
+    const size_t size = strip->size();
+    if (size < 4 || 0xFF != data[0] || 0xD8 != data[1] ||
+        0xFF != data[size - 2] || 0xD9 != data[size - 1]) {
+        return false;
+    }
+
+    *sof = 0;
+    for (size_t offset = 2; offset + 4 <= size - 2; ) {
+        if (0xFF != data[offset]) {
+            return false;
+        }
+        const uint8_t marker = data[offset + 1];
+        const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+        if (0xC0 == marker) {
+            *sof = offset;
+        } else if (0xDA == marker) {
+            *sos = offset;
+            *scan = offset + 2 + length;
+            return *sof && *scan <= size - 2;
+        }
+        offset += 2 + length;
+    }
+    return false;
+}
+
+static bool encode_in_parallel(SkWStream* dst, const SkPixmap& src,
+                               const SkJpegEncoder::Options& options, int rowsPerStrip,
+                               int restartInterval) {
+    struct Strip {
+        sk_sp<SkData> fData;
+        size_t        fScan;
+    };
+    const int count = (src.height() + rowsPerStrip - 1) / rowsPerStrip;
+    std::unique_ptr<Strip[]> strips(new Strip[count]);
+
+    SkTaskGroup taskGroup(*options.fExecutor);
+    taskGroup.batch(count, [&](int i) {
+        int top = i * rowsPerStrip;
+        SkPixmap strip;
+        SkAssertResult(src.extractSubset(&strip, SkIRect::MakeLTRB(0, top, src.width(),
+                       SkTMin(top + rowsPerStrip, src.height()))));
+        SkDynamicMemoryWStream stream;
+        if (encode_strip(&stream, strip, options, 0 == i)) {
+            strips[i].fData = stream.detachAsData();
+        }
+    });
+    taskGroup.wait();
+
+    size_t sof = 0, sos = 0;
+    for (int i = 0; i < count; ++i) {
+        size_t stripSof, stripSos;
+        if (!strips[i].fData ||
+            !find_scan(strips[i].fData.get(), &stripSof, &stripSos, &strips[i].fScan)) {
+            return false;
+        }
+        if (0 == i) {
+            sof = stripSof;
+            sos = stripSos;
+        }
+    }
+
+    // The headers of the first strip describe the whole image, once its height is fixed and
+    // a DRI segment tells the decoder where the strips restart.  The rest only contribute
+    // their entropy coded data.
+    const uint8_t* header = strips[0].fData->bytes();
+    const uint8_t height[] = {
+        (uint8_t) (src.height() >> 8), (uint8_t) src.height(),
+    };
+    const uint8_t dri[] = {
+        0xFF, 0xDD, 0x00, 0x04, (uint8_t) (restartInterval >> 8), (uint8_t) restartInterval,
+    };
+    // The height follows the SOF0 marker, its length, and its sample precision.
+    const size_t heightOffset = sof + 5;
+    if (!dst->write(header, heightOffset) ||
+        !dst->write(height, sizeof(height)) ||
+        !dst->write(header + heightOffset + sizeof(height),
+                    sos - heightOffset - sizeof(height)) ||
+        !dst->write(dri, sizeof(dri)) ||
+        !dst->write(header + sos, strips[0].fData->size() - 2 - sos)) {
+        return false;
+    }
+    for (int i = 1; i < count; ++i) {
+        const uint8_t rst[] = { 0xFF, (uint8_t) (0xD0 + ((i - 1) & 7)) };
+        const Strip& strip = strips[i];
+        if (!dst->write(rst, sizeof(rst)) ||
+            !dst->write(strip.fData->bytes() + strip.fScan,
+                        strip.fData->size() - 2 - strip.fScan)) {
+            return false;
+        }
+    }
+    const uint8_t eoi[] = { 0xFF, 0xD9 };
+    return dst->write(eoi, sizeof(eoi));
+}
+
 bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (options.fExecutor && SkPixmapIsValid(src)) {
+        const SkISize mcu = mcu_size(src.colorType(), options.fDownsample);
+        const int mcusPerRow = (src.width() + mcu.width() - 1) / mcu.width();
+
+        // The restart interval counts MCUs, and has to fit in 16 bits.
+        int mcuRowsPerStrip = SkTMax(1, kStripPixels / (src.width() * mcu.height()));
+        mcuRowsPerStrip = SkTMin(mcuRowsPerStrip, 0xFFFF / mcusPerRow);
+        const int rowsPerStrip = mcuRowsPerStrip * mcu.height();
+        if (mcuRowsPerStrip > 0 && src.height() > rowsPerStrip) {
+            return encode_in_parallel(dst, src, options, rowsPerStrip,
+                                      mcusPerRow * mcuRowsPerStrip);
+        }
+    }
+
     auto encoder = SkJpegEncoder::Make(dst, src, options);
     return encoder.get() && encoder->encodeRows(src.height());
 }
@@ -10,14 +10,17 @@
 #ifdef SK_HAS_PNG_LIBRARY
 
 #include "SkColorTable.h"
+#include "SkExecutor.h"
 #include "SkImageEncoderFns.h"
 #include "SkImageInfoPriv.h"
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkPngEncoder.h"
 #include "SkPngPriv.h"
+#include "SkTaskGroup.h"
 
 #include "png.h"
+#include "zlib.h"
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -62,21 +65,45 @@ public:
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
     transform_scanline_proc proc() const { return fProc; }
 
+    SkExecutor* executor() const { return fExecutor; }
+    // Whether writeRowsInParallel() would split an image of this height into several segments.
+    bool shouldWriteInParallel(int height) const;
+    // Filters and deflates all of src's rows on the executor, and writes them and the IEND chunk.
+    bool writeRowsInParallel(const SkPixmap& src);
+
     ~SkPngEncoderMgr() {
         png_destroy_write_struct(&fPngPtr, &fInfoPtr);
     }
 
 private:
+    struct Segment;
 
     SkPngEncoderMgr(png_structp pngPtr, png_infop infoPtr)
         : fPngPtr(pngPtr)
         , fInfoPtr(infoPtr)
     {}
 
+    int rowsPerSegment() const;
+    void transformRow(uint8_t* dst, const SkPixmap& src, int y) const;
+    bool deflateSegment(const SkPixmap& src, Segment* segment, bool last) const;
+    bool writeSegments(const Segment* segments, int count, uLong adler);
+
     png_structp             fPngPtr;
     png_infop               fInfoPtr;
     int                     fPngBytesPerPixel;
     transform_scanline_proc fProc;
+
+    // Used by writeRowsInParallel().
+    SkExecutor*             fExecutor;
+    int                     fZLibLevel;
+    // The filters (PNG_FILTER_VALUE_*) to try on each row.
+    int                     fFilters[2];
+    int                     fFilterCount;
+    // The size of each row in the png, without its filter byte, and of each pixel.
+    size_t                  fRowBytes;
+    int                     fBytesPerPixel;
+    // Whether fProc writes an alpha channel that libpng would strip (see writeInfo()).
+    bool                    fStripFiller;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -199,6 +226,25 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
     SkASSERT(zlibLevel == options.fZLibLevel);
     png_set_compression_level(fPngPtr, zlibLevel);
 
+    fExecutor = options.fExecutor;
+    fZLibLevel = zlibLevel;
+    // Paeth and Sub win most often, so those are the two we prefer to try.
+    static const int kFilterPreference[] = { PNG_FILTER_VALUE_PAETH, PNG_FILTER_VALUE_SUB,
+                                             PNG_FILTER_VALUE_UP, PNG_FILTER_VALUE_AVG,
+                                             PNG_FILTER_VALUE_NONE };
+    fFilterCount = 0;
+    for (int filter : kFilterPreference) {
+        if (fFilterCount < 2 && (filters & (PNG_FILTER_NONE << filter))) {
+            fFilters[fFilterCount++] = filter;
+        }
+    }
+    if (!fFilterCount) {
+        fFilters[fFilterCount++] = PNG_FILTER_VALUE_NONE;
+    }
+    fRowBytes = png_get_rowbytes(fPngPtr, fInfoPtr);
+    fBytesPerPixel = (int) (fRowBytes / srcInfo.width());
+    fStripFiller = kRGBA_F16_SkColorType == srcInfo.colorType() && srcInfo.isOpaque();
+
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
     if (comments != nullptr) {
@@ -367,6 +413,229 @@ void SkPngEncoderMgr::chooseProc(const SkImageInfo& srcInfo) {
     fProc = choose_proc(srcInfo);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Parallel encoding
+///////////////////////////////////////////////////////////////////////////////
+
+// In the way of pigz, the rows are split into segments that are filtered and deflated on their
+// own, and the raw deflate streams are joined into one zlib stream. Every segment but the last
+// ends on a byte boundary with a sync flush, and each is primed with the last 32K of the
+// filtered rows before it, which it filters again itself, so it can still refer back to them.
+static constexpr size_t kSegmentBytes = 128 * 1024;
+static constexpr size_t kWindowBytes = 32 * 1024;
+
+struct SkPngEncoderMgr::Segment {
+    int                    fTop;
+    int                    fBottom;
+    SkAutoTMalloc<uint8_t> fDeflated;
+    size_t                 fDeflatedSize = 0;
+    uLong                  fAdler = 0;
+    size_t                 fFilteredSize = 0;
+    bool                   fSuccess = false;
+};
+
+static inline int paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = SkTAbs(p - a);
+    const int pb = SkTAbs(p - b);
+    const int pc = SkTAbs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes the filter type byte and 'row' filtered against 'prev' to dst. The loops are simple
+// enough for the compiler to vectorize.
+static void filter_row(int filter, uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                       size_t rowBytes, int bpp) {
+    *dst++ = filter;
+    switch (filter) {
+        case PNG_FILTER_VALUE_NONE:
+            memcpy(dst, row, rowBytes);
+            break;
+        case PNG_FILTER_VALUE_SUB:
+            memcpy(dst, row, bpp);
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case PNG_FILTER_VALUE_UP:
+            for (size_t i = 0; i < rowBytes; ++i) {
+                dst[i] = row[i] - prev[i];
+            }
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            for (int i = 0; i < bpp; ++i) {
+                dst[i] = row[i] - (prev[i] >> 1);
+            }
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            for (int i = 0; i < bpp; ++i) {
+                dst[i] = row[i] - prev[i];
+            }
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] - paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+        default:
+            SkASSERT(false);
+    }
+}
+
+// libpng's measure of how well a filtered row will compress: the sum of its bytes as signed
+// magnitudes, so that rows of small differences win.
+static uint32_t filtered_row_cost(const uint8_t* filtered, size_t rowBytes) {
+    uint32_t cost = 0;
+    for (size_t i = 0; i < rowBytes; ++i) {
+        cost += SkTAbs((int) (int8_t) filtered[i]);
+    }
+    return cost;
+}
+
+int SkPngEncoderMgr::rowsPerSegment() const {
+    return SkTMax<int>(1, kSegmentBytes / (fRowBytes + 1));
+}
+
+bool SkPngEncoderMgr::shouldWriteInParallel(int height) const {
+    return fExecutor && height > this->rowsPerSegment();
+}
+
+void SkPngEncoderMgr::transformRow(uint8_t* dst, const SkPixmap& src, int y) const {
+    fProc((char*) dst, (const char*) src.addr(0, y), src.width(),
+          SkColorTypeBytesPerPixel(src.colorType()), nullptr);
+    if (fStripFiller) {
+        for (int x = 0; x < src.width(); ++x) {
+            memmove(dst + x * 6, dst + x * 8, 6);
+        }
+    }
+}
+
+bool SkPngEncoderMgr::deflateSegment(const SkPixmap& src, Segment* segment, bool last) const {
+    const size_t filteredRowBytes = fRowBytes + 1;
+    const int windowRows = (int) ((kWindowBytes + filteredRowBytes - 1) / filteredRowBytes);
+    const int first = SkTMax(segment->fTop - windowRows, 0);
+
+    // Two rows for fProc to write to, which may be wider than fRowBytes, and one to try the
+    // second filter in.
+    const size_t procRowBytes = fPngBytesPerPixel * src.width();
+    SkAutoTMalloc<uint8_t> rows(2 * procRowBytes + filteredRowBytes);
+    uint8_t* prev = rows.get();
+    uint8_t* curr = prev + procRowBytes;
+    uint8_t* trial = curr + procRowBytes;
+    if (first > 0) {
+        this->transformRow(prev, src, first - 1);
+    } else {
+        memset(prev, 0, procRowBytes);
+    }
+
+    SkAutoTMalloc<uint8_t> filtered((segment->fBottom - first) * filteredRowBytes);
+    for (int y = first; y < segment->fBottom; ++y) {
+        this->transformRow(curr, src, y);
+        uint8_t* dst = filtered.get() + (y - first) * filteredRowBytes;
+        filter_row(fFilters[0], dst, curr, prev, fRowBytes, fBytesPerPixel);
+        if (fFilterCount > 1) {
+            filter_row(fFilters[1], trial, curr, prev, fRowBytes, fBytesPerPixel);
+            if (filtered_row_cost(trial + 1, fRowBytes) < filtered_row_cost(dst + 1, fRowBytes)) {
+                memcpy(dst, trial, filteredRowBytes);
+            }
+        }
+        std::swap(prev, curr);
+    }
+
+    const uint8_t* data = filtered.get() + (segment->fTop - first) * filteredRowBytes;
+    const size_t size = (segment->fBottom - segment->fTop) * filteredRowBytes;
+    segment->fFilteredSize = size;
+    segment->fAdler = adler32(adler32(0L, Z_NULL, 0), data, size);
+
+    z_stream stream;
+    sk_bzero(&stream, sizeof(stream));
+    if (Z_OK != deflateInit2(&stream, fZLibLevel, Z_DEFLATED, -MAX_WBITS, 8,
+                             Z_DEFAULT_STRATEGY)) {
+        return false;
+    }
+    const size_t windowSize = SkTMin(kWindowBytes, (segment->fTop - first) * filteredRowBytes);
+    if (windowSize && Z_OK != deflateSetDictionary(&stream, data - windowSize, windowSize)) {
+        deflateEnd(&stream);
+        return false;
+    }
+
+    // deflateBound() does not count the few bytes of a sync flush.
+    const size_t capacity = deflateBound(&stream, size) + 16;
+    segment->fDeflated.reset(capacity);
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = size;
+    stream.next_out = segment->fDeflated.get();
+    stream.avail_out = capacity;
+    const int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    const bool success = last ? Z_STREAM_END == result
+                              : Z_OK == result && !stream.avail_in && stream.avail_out;
+    segment->fDeflatedSize = capacity - stream.avail_out;
+    deflateEnd(&stream);
+    return success;
+}
+
+bool SkPngEncoderMgr::writeSegments(const Segment* segments, int count, uLong adler) {
+    if (setjmp(png_jmpbuf(fPngPtr))) {
+        return false;
+    }
+
+    // The zlib header, for a 32K window and the compression level.
+    const int levelFlag = fZLibLevel < 2 ? 0 : fZLibLevel < 6 ? 1 : 6 == fZLibLevel ? 2 : 3;
+    uint8_t header[2] = { 0x78, (uint8_t) (levelFlag << 6) };
+    header[1] += 31 - (header[0] * 256 + header[1]) % 31;
+    const uint8_t trailer[4] = { (uint8_t) (adler >> 24), (uint8_t) (adler >> 16),
+                                 (uint8_t) (adler >> 8), (uint8_t) adler };
+
+    // One IDAT chunk per segment.
+    for (int i = 0; i < count; ++i) {
+        const bool first = 0 == i;
+        const bool last = count - 1 == i;
+        png_write_chunk_start(fPngPtr, (png_const_bytep) "IDAT",
+                              segments[i].fDeflatedSize + (first ? 2 : 0) + (last ? 4 : 0));
+        if (first) {
+            png_write_chunk_data(fPngPtr, header, sizeof(header));
+        }
+        png_write_chunk_data(fPngPtr, segments[i].fDeflated.get(), segments[i].fDeflatedSize);
+        if (last) {
+            png_write_chunk_data(fPngPtr, trailer, sizeof(trailer));
+        }
+        png_write_chunk_end(fPngPtr);
+    }
+
+    // We wrote the IDATs around libpng, so png_write_end() would think there were none.
+    png_write_chunk(fPngPtr, (png_const_bytep) "IEND", nullptr, 0);
+    return true;
+}
+
+bool SkPngEncoderMgr::writeRowsInParallel(const SkPixmap& src) {
+    const int height = src.height();
+    const int rowsPerSegment = this->rowsPerSegment();
+    const int count = (height + rowsPerSegment - 1) / rowsPerSegment;
+    std::unique_ptr<Segment[]> segments(new Segment[count]);
+
+    SkTaskGroup taskGroup(*fExecutor);
+    taskGroup.batch(count, [&](int i) {
+        Segment* segment = &segments[i];
+        segment->fTop = i * rowsPerSegment;
+        segment->fBottom = SkTMin(segment->fTop + rowsPerSegment, height);
+        segment->fSuccess = this->deflateSegment(src, segment, count - 1 == i);
+    });
+    taskGroup.wait();
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for (int i = 0; i < count; ++i) {
+        if (!segments[i].fSuccess) {
+            return false;
+        }
+        adler = adler32_combine(adler, segments[i].fAdler, segments[i].fFilteredSize);
+    }
+    return this->writeSegments(segments.get(), count, adler);
+}
+
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                               const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -403,6 +672,12 @@ SkPngEncoder::SkPngEncoder(std::unique_ptr<SkPngEncoderMgr> encoderMgr, const Sk
 SkPngEncoder::~SkPngEncoder() {}
 
 bool SkPngEncoder::onEncodeRows(int numRows) {
+    if (0 == fCurrRow && fSrc.height() == numRows &&
+        fEncoderMgr->shouldWriteInParallel(fSrc.height())) {
+        fCurrRow = fSrc.height();
+        return fEncoderMgr->writeRowsInParallel(fSrc);
+    }
+
     if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
         return false;
     }
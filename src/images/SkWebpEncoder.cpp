@@ -153,6 +153,7 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
         webp_config.method = 0;
         pic.use_argb = 1;
     }
+    webp_config.thread_level = opts.fMultithreaded ? 1 : 0;
 
     // If there is no need to embed an ICC profile, we write directly to the input stream.
     // Otherwise, we will first encode to |tmp| and use a mux to add the ICC chunk.  libwebp
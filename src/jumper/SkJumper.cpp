@@ -8,9 +8,32 @@
 #include "SkJumper.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkRasterPipelineProgramCache.h"
 #include "SkTemplates.h"
 
+int64_t SkRasterPipeline::ProgramCacheHits() {
+    return SkRasterPipelineProgramCache::Global()->hits();
+}
+int64_t SkRasterPipeline::ProgramCacheMisses() {
+    return SkRasterPipelineProgramCache::Global()->misses();
+}
+void SkRasterPipeline::PurgeProgramCache() {
+    SkRasterPipelineProgramCache::Global()->purge();
+}
+
 SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) const {
+    SkRasterPipelineProgramCache* cache = fProgramCache ? fProgramCache
+                                                        : SkRasterPipelineProgramCache::Global();
+    void** program = ip - fSlotsNeeded;
+    if (auto start = cache->find(*this, program)) {
+        return start;
+    }
+    auto start = this->build_pipeline_uncached(ip);
+    cache->add(*this, program, start);
+    return start;
+}
+
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline_uncached(void** ip) const {
 #ifndef SK_JUMPER_DISABLE_8BIT
     // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
     void** reset_point = ip;
@@ -86,6 +86,16 @@ struct SkJumper_2PtConicalCtx {
              fP1;
 };
 
+struct SkJumper_PerlinNoiseCtx {
+    float        translate[2];      // Added to whole-pixel x,y before rounding.
+    float        baseFrequency[2];
+    int          octaves;
+    bool         turbulence;        // Sum abs(noise) per octave; otherwise fractal noise.
+    const float* stitch;            // width, wrapX, height, wrapY per octave, or null.
+    const float* gradient[4];       // Per channel, 256 interleaved x,y unit vectors.
+    uint32_t     latticeSelector[256];
+};
+
 struct SkJumper_UniformColorCtx {
     float r,g,b,a;
     uint16_t rgba[4];  // [0,255] in a 16-bit lane.
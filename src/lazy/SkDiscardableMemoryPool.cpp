@@ -6,12 +6,22 @@
  */
 
 #include "SkDiscardableMemoryPool.h"
+#include "SkAtomics.h"
 #include "SkDiscardableMemory.h"
 #include "SkMakeUnique.h"
 #include "SkMalloc.h"
 #include "SkMutex.h"
 #include "SkTInternalLList.h"
 #include "SkTemplates.h"
+#include "SkTo.h"
+
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #if defined(MADV_FREE)
+        #define SK_DISCARDABLE_PAGES 1
+    #endif
+#endif
 
 // Note:
 // A PoolDiscardableMemory is memory that is counted in a pool.
@@ -19,6 +29,97 @@
 
 namespace {
 
+#if defined(SK_DISCARDABLE_PAGES)
+/**
+ *  Anonymous pages that the kernel may reclaim while they are unlocked.  unlock() hands them back
+ *  with MADV_FREE, which leaves their contents alone unless the system runs short of memory; then
+ *  the kernel drops them, and they read back as zeros.  So before handing them back, unlock()
+ *  stashes the first word of each page and stamps it with a marker.  lock() swaps each marker
+ *  back for the stashed word with a compare-and-swap: writing to a page the kernel hasn't dropped
+ *  yet takes it back, and a page it has dropped no longer holds the marker.
+ */
+class DiscardablePages {
+public:
+    static std::unique_ptr<DiscardablePages> Make(size_t bytes) {
+        const size_t pageSize = sysconf(_SC_PAGESIZE);
+        const size_t mapped = (bytes + pageSize - 1) / pageSize * pageSize;
+        void* addr = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1, 0);
+        if (MAP_FAILED == addr) {
+            return nullptr;
+        }
+        return std::unique_ptr<DiscardablePages>(new DiscardablePages(addr, mapped, pageSize));
+    }
+
+    ~DiscardablePages() { munmap(fAddr, fMapped); }
+
+    void* data() const { return fAddr; }
+
+    void unlock() {
+        for (int i = 0; i < fPageCount; ++i) {
+            fFirstWords[i] = *this->firstWord(i);
+            *this->firstWord(i) = kMarker;
+        }
+        fAdvised = 0 == madvise(fAddr, fMapped, MADV_FREE);
+        if (!fAdvised) {
+            // Old kernels don't know MADV_FREE.  The pages just stay put.
+            this->restoreFirstWords();
+        }
+    }
+
+    /** Returns false if the kernel dropped any of the pages while they were unlocked. */
+    bool lock() {
+        if (!fAdvised) {
+            return true;
+        }
+        for (int i = 0; i < fPageCount; ++i) {
+            uint64_t expected = kMarker;
+            if (!sk_atomic_compare_exchange(this->firstWord(i), &expected, fFirstWords[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint64_t kMarker = 0x5344697363617264;  // 'SDiscard'
+
+    DiscardablePages(void* addr, size_t mapped, size_t pageSize)
+        : fAddr(addr)
+        , fMapped(mapped)
+        , fPageSize(pageSize)
+        , fPageCount(SkToInt(mapped / pageSize))
+        , fFirstWords(fPageCount)
+        , fAdvised(false) {}
+
+    uint64_t* firstWord(int page) const {
+        return reinterpret_cast<uint64_t*>(static_cast<char*>(fAddr) + page * fPageSize);
+    }
+
+    void restoreFirstWords() {
+        for (int i = 0; i < fPageCount; ++i) {
+            *this->firstWord(i) = fFirstWords[i];
+        }
+    }
+
+    void* const              fAddr;
+    const size_t             fMapped;
+    const size_t             fPageSize;
+    const int                fPageCount;
+    SkAutoTMalloc<uint64_t>  fFirstWords;
+    bool                     fAdvised;
+};
+#else
+// Without MADV_FREE, every allocation comes from the heap.
+class DiscardablePages {
+public:
+    static std::unique_ptr<DiscardablePages> Make(size_t) { return nullptr; }
+    void* data() const { return nullptr; }
+    void unlock() {}
+    bool lock() { return true; }
+};
+#endif
+
 class PoolDiscardableMemory;
 
 /**
@@ -27,7 +128,7 @@ class PoolDiscardableMemory;
  */
 class DiscardableMemoryPool : public SkDiscardableMemoryPool {
 public:
-    DiscardableMemoryPool(size_t budget);
+    DiscardableMemoryPool(size_t budget, size_t minPagedBytes);
     ~DiscardableMemoryPool() override;
 
     std::unique_ptr<SkDiscardableMemory> make(size_t bytes);
@@ -56,10 +157,13 @@ private:
     SkMutex      fMutex;
     size_t       fBudget;
     size_t       fUsed;
+    const size_t fMinPagedBytes;
     SkTInternalLList<PoolDiscardableMemory> fList;
 
     /** Function called to free memory if needed */
     void dumpDownTo(size_t budget);
+    /** Frees dm's memory and takes it out of the list. */
+    void purge(PoolDiscardableMemory* dm);
     /** called by DiscardableMemoryPool upon destruction */
     void removeFromPool(PoolDiscardableMemory* dm);
     /** called by DiscardableMemoryPool::lock() */
@@ -78,7 +182,8 @@ private:
  */
 class PoolDiscardableMemory : public SkDiscardableMemory {
 public:
-    PoolDiscardableMemory(sk_sp<DiscardableMemoryPool> pool, SkAutoFree pointer, size_t bytes);
+    PoolDiscardableMemory(sk_sp<DiscardableMemoryPool> pool, SkAutoFree pointer,
+                          std::unique_ptr<DiscardablePages> pages, size_t bytes);
     ~PoolDiscardableMemory() override;
     bool lock() override;
     void* data() override;
@@ -86,18 +191,27 @@ public:
     friend class DiscardableMemoryPool;
 private:
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(PoolDiscardableMemory);
-    sk_sp<DiscardableMemoryPool> fPool;
-    bool                         fLocked;
-    SkAutoFree                   fPointer;
-    const size_t                 fBytes;
+    bool isPurged() const { return nullptr == fPointer && nullptr == fPages; }
+
+    sk_sp<DiscardableMemoryPool>      fPool;
+    bool                              fLocked;
+    // Exactly one of these holds the memory, until it's purged.
+    SkAutoFree                        fPointer;
+    std::unique_ptr<DiscardablePages> fPages;
+    const size_t                      fBytes;
 };
 
 PoolDiscardableMemory::PoolDiscardableMemory(sk_sp<DiscardableMemoryPool> pool,
                                              SkAutoFree pointer,
+                                             std::unique_ptr<DiscardablePages> pages,
                                              size_t bytes)
-        : fPool(std::move(pool)), fLocked(true), fPointer(std::move(pointer)), fBytes(bytes) {
+        : fPool(std::move(pool))
+        , fLocked(true)
+        , fPointer(std::move(pointer))
+        , fPages(std::move(pages))
+        , fBytes(bytes) {
     SkASSERT(fPool != nullptr);
-    SkASSERT(fPointer != nullptr);
+    SkASSERT((fPointer != nullptr) != (fPages != nullptr));
     SkASSERT(fBytes > 0);
 }
 
@@ -113,7 +227,7 @@ bool PoolDiscardableMemory::lock() {
 
 void* PoolDiscardableMemory::data() {
     SkASSERT(fLocked); // contract for SkDiscardableMemory
-    return fPointer.get();
+    return fPages ? fPages->data() : fPointer.get();
 }
 
 void PoolDiscardableMemory::unlock() {
@@ -123,9 +237,10 @@ void PoolDiscardableMemory::unlock() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-DiscardableMemoryPool::DiscardableMemoryPool(size_t budget)
+DiscardableMemoryPool::DiscardableMemoryPool(size_t budget, size_t minPagedBytes)
     : fBudget(budget)
-    , fUsed(0) {
+    , fUsed(0)
+    , fMinPagedBytes(minPagedBytes) {
     #if SK_LAZY_CACHE_STATS
     fCacheHits = 0;
     fCacheMisses = 0;
@@ -149,26 +264,40 @@ void DiscardableMemoryPool::dumpDownTo(size_t budget) {
     while ((fUsed > budget) && (cur)) {
         if (!cur->fLocked) {
             PoolDiscardableMemory* dm = cur;
-            SkASSERT(dm->fPointer != nullptr);
-            dm->fPointer = nullptr;
-            SkASSERT(fUsed >= dm->fBytes);
-            fUsed -= dm->fBytes;
             cur = iter.prev();
-            // Purged DMs are taken out of the list.  This saves times
-            // looking them up.  Purged DMs are NOT deleted.
-            fList.remove(dm);
+            this->purge(dm);
         } else {
             cur = iter.prev();
         }
     }
 }
 
+void DiscardableMemoryPool::purge(PoolDiscardableMemory* dm) {
+    fMutex.assertHeld();
+    SkASSERT(!dm->isPurged());
+    dm->fPointer = nullptr;
+    dm->fPages = nullptr;
+    SkASSERT(fUsed >= dm->fBytes);
+    fUsed -= dm->fBytes;
+    // Purged DMs are taken out of the list.  This saves times
+    // looking them up.  Purged DMs are NOT deleted.
+    fList.remove(dm);
+}
+
 std::unique_ptr<SkDiscardableMemory> DiscardableMemoryPool::make(size_t bytes) {
-    SkAutoFree addr(sk_malloc_canfail(bytes));
-    if (nullptr == addr) {
-        return nullptr;
+    std::unique_ptr<DiscardablePages> pages;
+    SkAutoFree addr;
+    if (bytes >= fMinPagedBytes) {
+        pages = DiscardablePages::Make(bytes);
+    }
+    if (nullptr == pages) {
+        addr.reset(sk_malloc_canfail(bytes));
+        if (nullptr == addr) {
+            return nullptr;
+        }
     }
-    auto dm = skstd::make_unique<PoolDiscardableMemory>(sk_ref_sp(this), std::move(addr), bytes);
+    auto dm = skstd::make_unique<PoolDiscardableMemory>(sk_ref_sp(this), std::move(addr),
+                                                        std::move(pages), bytes);
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     fList.addToHead(dm.get());
     fUsed += bytes;
@@ -179,7 +308,7 @@ std::unique_ptr<SkDiscardableMemory> DiscardableMemoryPool::make(size_t bytes) {
 void DiscardableMemoryPool::removeFromPool(PoolDiscardableMemory* dm) {
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     // This is called by dm's destructor.
-    if (dm->fPointer != nullptr) {
+    if (!dm->isPurged()) {
         SkASSERT(fUsed >= dm->fBytes);
         fUsed -= dm->fBytes;
         fList.remove(dm);
@@ -191,7 +320,11 @@ void DiscardableMemoryPool::removeFromPool(PoolDiscardableMemory* dm) {
 bool DiscardableMemoryPool::lock(PoolDiscardableMemory* dm) {
     SkASSERT(dm != nullptr);
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    if (nullptr == dm->fPointer) {
+    if (dm->fPages && !dm->isPurged() && !dm->fPages->lock()) {
+        // The kernel reclaimed some of its pages.
+        this->purge(dm);
+    }
+    if (dm->isPurged()) {
         // May have been purged while waiting for lock.
         #if SK_LAZY_CACHE_STATS
         ++fCacheMisses;
@@ -211,6 +344,9 @@ void DiscardableMemoryPool::unlock(PoolDiscardableMemory* dm) {
     SkASSERT(dm != nullptr);
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     dm->fLocked = false;
+    if (dm->fPages) {
+        dm->fPages->unlock();
+    }
     this->dumpDownTo(fBudget);
 }
 
@@ -230,12 +366,18 @@ void DiscardableMemoryPool::dumpPool() {
 }  // namespace
 
 sk_sp<SkDiscardableMemoryPool> SkDiscardableMemoryPool::Make(size_t size) {
-    return sk_make_sp<DiscardableMemoryPool>(size);
+    return sk_make_sp<DiscardableMemoryPool>(size, SIZE_MAX);
+}
+
+sk_sp<SkDiscardableMemoryPool> SkDiscardableMemoryPool::MakePaged(size_t size,
+                                                                  size_t minPagedBytes) {
+    return sk_make_sp<DiscardableMemoryPool>(size, minPagedBytes);
 }
 
 SkDiscardableMemoryPool* SkGetGlobalDiscardableMemoryPool() {
     // Intentionally leak this global pool.
     static SkDiscardableMemoryPool* global =
-            new DiscardableMemoryPool(SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE);
+            new DiscardableMemoryPool(SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE,
+                                      SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_MIN_PAGED_BYTES);
     return global;
 }
@@ -52,6 +52,14 @@ public:
      *  the pool works.
      */
     static sk_sp<SkDiscardableMemoryPool> Make(size_t size);
+
+    /**
+     *  Like Make(), but allocations of at least minPagedBytes get pages of their own that the
+     *  kernel may reclaim while they are unlocked (MADV_FREE on Linux and Android), so memory
+     *  pressure can purge them before the budget does.  lock() fails if the kernel took any of
+     *  an allocation's pages.  Where that isn't supported, this is the same as Make().
+     */
+    static sk_sp<SkDiscardableMemoryPool> MakePaged(size_t size, size_t minPagedBytes);
 };
 
 /**
@@ -64,4 +72,9 @@ SkDiscardableMemoryPool* SkGetGlobalDiscardableMemoryPool();
 #define SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE (128 * 1024 * 1024)
 #endif
 
+/** Allocations at least this big from the global pool are paged (see MakePaged()). */
+#if !defined(SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_MIN_PAGED_BYTES)
+#define SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_MIN_PAGED_BYTES (256 * 1024)
+#endif
+
 #endif  // SkDiscardableMemoryPool_DEFINED
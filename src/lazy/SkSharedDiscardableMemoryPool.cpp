@@ -0,0 +1,394 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSharedDiscardableMemoryPool.h"
+
+#include "SkMutex.h"
+#include "SkSpinlock.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+// The block starts with a header, followed by an entry per page (no allocation is smaller than a
+// page, so that is as many as there can be), a byte per page saying whether it's in use, and then
+// the pages themselves. All zeros is a valid state for every field, so a zero-filled block needs
+// only its header filled in to be laid out.
+
+struct SkSharedDiscardableMemoryHeader {
+    enum {
+        kUninitialized,
+        kLayingOut,
+        kReady,
+    };
+
+    std::atomic<uint32_t> fState;
+    uint32_t              fVersion;
+    uint64_t              fBytes;
+    uint64_t              fDataOffset;
+    uint32_t              fPageCount;
+    SkSpinlock            fLock;
+
+    // Everything below here is guarded by fLock.
+    uint64_t              fClock;
+};
+
+struct SkSharedDiscardableMemoryEntry {
+    enum {
+        kFree,
+        kAnonymous,     // from create(); owned by one SkDiscardableMemory
+        kWriting,       // from createForKey(); owned by one SkDiscardableMemory until published
+        kPublished,     // findable by key; owned by the pool
+    };
+
+    uint32_t fState;
+    // Bumped whenever the entry is freed, so SkDiscardableMemory that referred to it can tell.
+    uint32_t fGeneration;
+    int32_t  fLockCount;
+    uint32_t fFirstPage;
+    uint32_t fPageCount;
+    uint32_t fKeyBytes;
+    uint64_t fBytes;
+    uint64_t fLastUse;
+    uint8_t  fKey[SkSharedDiscardableMemoryPool::kMaxKeyBytes];
+
+    bool matches(const void* key, size_t keyBytes) const {
+        return fKeyBytes == keyBytes && !memcmp(fKey, key, keyBytes);
+    }
+};
+
+static constexpr uint32_t kVersion = 1;
+static constexpr size_t kDataAlignment = 64;
+
+static size_t align_data(size_t offset) {
+    return (offset + kDataAlignment - 1) & ~(kDataAlignment - 1);
+}
+
+static size_t page_map_offset(uint32_t pageCount) {
+    return sizeof(SkSharedDiscardableMemoryHeader) +
+           pageCount * sizeof(SkSharedDiscardableMemoryEntry);
+}
+
+static size_t data_offset(uint32_t pageCount) {
+    return align_data(page_map_offset(pageCount) + pageCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SkSharedDiscardableMemoryPool::Memory : public SkDiscardableMemory {
+public:
+    Memory(sk_sp<SkSharedDiscardableMemoryPool> pool, int index, uint32_t generation, void* data)
+            : fPool(std::move(pool))
+            , fIndex(index)
+            , fGeneration(generation)
+            , fData(data)
+            , fLocked(true) {}
+
+    ~Memory() override {
+        SkASSERT(!fLocked); // contract for SkDiscardableMemory
+        fPool->release(fIndex, fGeneration);
+    }
+
+    bool lock() override {
+        SkASSERT(!fLocked); // contract for SkDiscardableMemory
+        fLocked = fPool->lock(fIndex, fGeneration);
+        return fLocked;
+    }
+
+    void* data() override {
+        SkASSERT(fLocked); // contract for SkDiscardableMemory
+        return fData;
+    }
+
+    void unlock() override {
+        SkASSERT(fLocked); // contract for SkDiscardableMemory
+        fPool->unlock(fIndex, fGeneration);
+        fLocked = false;
+    }
+
+private:
+    sk_sp<SkSharedDiscardableMemoryPool> fPool;
+    const int                            fIndex;
+    const uint32_t                       fGeneration;
+    void* const                          fData;
+    bool                                 fLocked;
+
+    friend class SkSharedDiscardableMemoryPool;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSharedDiscardableMemoryPool> SkSharedDiscardableMemoryPool::Make(void* memory,
+                                                                         size_t bytes) {
+    const size_t headerBytes = sizeof(SkSharedDiscardableMemoryHeader) + kDataAlignment;
+    if (!memory || bytes < headerBytes) {
+        return nullptr;
+    }
+    uint64_t pageCount = (bytes - headerBytes) /
+                         (kPageSize + sizeof(SkSharedDiscardableMemoryEntry) + 1);
+    pageCount = SkTMin<uint64_t>(pageCount, UINT32_MAX);
+    if (0 == pageCount) {
+        return nullptr;
+    }
+    SkASSERT(data_offset(pageCount) + pageCount * kPageSize <= bytes);
+
+    auto header = static_cast<SkSharedDiscardableMemoryHeader*>(memory);
+    uint32_t state = SkSharedDiscardableMemoryHeader::kUninitialized;
+    if (header->fState.compare_exchange_strong(state, SkSharedDiscardableMemoryHeader::kLayingOut,
+                                               std::memory_order_acquire)) {
+        header->fVersion = kVersion;
+        header->fBytes = bytes;
+        header->fDataOffset = data_offset(pageCount);
+        header->fPageCount = pageCount;
+        header->fState.store(SkSharedDiscardableMemoryHeader::kReady, std::memory_order_release);
+    } else {
+        // Another pool is laying the block out; that only takes a moment.
+        while (header->fState.load(std::memory_order_acquire) !=
+               SkSharedDiscardableMemoryHeader::kReady) {
+            std::this_thread::yield();
+        }
+        if (header->fVersion != kVersion || header->fBytes != bytes) {
+            return nullptr;
+        }
+    }
+    return sk_sp<SkSharedDiscardableMemoryPool>(new SkSharedDiscardableMemoryPool(header));
+}
+
+SkSharedDiscardableMemoryPool::SkSharedDiscardableMemoryPool(
+        SkSharedDiscardableMemoryHeader* header)
+        : fHeader(header) {}
+
+SkSharedDiscardableMemoryEntry* SkSharedDiscardableMemoryPool::entries() const {
+    return reinterpret_cast<SkSharedDiscardableMemoryEntry*>(fHeader + 1);
+}
+
+uint8_t* SkSharedDiscardableMemoryPool::pageMap() const {
+    return reinterpret_cast<uint8_t*>(fHeader) + page_map_offset(fHeader->fPageCount);
+}
+
+void* SkSharedDiscardableMemoryPool::pageData(uint32_t page) const {
+    return reinterpret_cast<uint8_t*>(fHeader) + fHeader->fDataOffset + page * kPageSize;
+}
+
+int SkSharedDiscardableMemoryPool::findFreePagesLocked(uint32_t count) const {
+    const uint8_t* pageMap = this->pageMap();
+    uint32_t run = 0;
+    for (uint32_t page = 0; page < fHeader->fPageCount; ++page) {
+        run = pageMap[page] ? 0 : run + 1;
+        if (run == count) {
+            return page + 1 - count;
+        }
+    }
+    return -1;
+}
+
+void SkSharedDiscardableMemoryPool::freeLocked(SkSharedDiscardableMemoryEntry* entry) {
+    SkASSERT(SkSharedDiscardableMemoryEntry::kFree != entry->fState);
+    memset(this->pageMap() + entry->fFirstPage, 0, entry->fPageCount);
+    entry->fState = SkSharedDiscardableMemoryEntry::kFree;
+    entry->fGeneration++;
+    entry->fLockCount = 0;
+    entry->fKeyBytes = 0;
+}
+
+bool SkSharedDiscardableMemoryPool::evictOneLocked() {
+    SkSharedDiscardableMemoryEntry* entries = this->entries();
+    SkSharedDiscardableMemoryEntry* oldest = nullptr;
+    for (uint32_t i = 0; i < fHeader->fPageCount; ++i) {
+        // Unlocked memory that is still being written belongs to a writer that is about to delete
+        // it, or that died; either way nobody will publish it.
+        if (SkSharedDiscardableMemoryEntry::kFree != entries[i].fState &&
+            0 == entries[i].fLockCount &&
+            (!oldest || entries[i].fLastUse < oldest->fLastUse)) {
+            oldest = &entries[i];
+        }
+    }
+    if (!oldest) {
+        return false;
+    }
+    this->freeLocked(oldest);
+    return true;
+}
+
+int SkSharedDiscardableMemoryPool::allocateLocked(size_t bytes) {
+    const uint64_t pageCount = SkTMax<uint64_t>((bytes + kPageSize - 1) / kPageSize, 1);
+    if (pageCount > fHeader->fPageCount) {
+        return -1;
+    }
+
+    SkSharedDiscardableMemoryEntry* entries = this->entries();
+    while (true) {
+        int index = -1;
+        for (uint32_t i = 0; i < fHeader->fPageCount; ++i) {
+            if (SkSharedDiscardableMemoryEntry::kFree == entries[i].fState) {
+                index = i;
+                break;
+            }
+        }
+        const int firstPage = index >= 0 ? this->findFreePagesLocked(pageCount) : -1;
+        if (firstPage >= 0) {
+            SkSharedDiscardableMemoryEntry* entry = &entries[index];
+            entry->fFirstPage = firstPage;
+            entry->fPageCount = pageCount;
+            entry->fBytes = bytes;
+            entry->fLockCount = 1;
+            entry->fLastUse = ++fHeader->fClock;
+            memset(this->pageMap() + firstPage, 1, pageCount);
+            return index;
+        }
+        if (!this->evictOneLocked()) {
+            return -1;
+        }
+    }
+}
+
+std::unique_ptr<SkDiscardableMemory> SkSharedDiscardableMemoryPool::make(size_t bytes,
+                                                                         const void* key,
+                                                                         size_t keyBytes) {
+    if (keyBytes > kMaxKeyBytes) {
+        return nullptr;
+    }
+
+    SkAutoExclusive lock(fHeader->fLock);
+    SkSharedDiscardableMemoryEntry* entries = this->entries();
+    if (key) {
+        for (uint32_t i = 0; i < fHeader->fPageCount; ++i) {
+            if ((SkSharedDiscardableMemoryEntry::kWriting == entries[i].fState ||
+                 SkSharedDiscardableMemoryEntry::kPublished == entries[i].fState) &&
+                entries[i].matches(key, keyBytes)) {
+                return nullptr;
+            }
+        }
+    }
+
+    const int index = this->allocateLocked(bytes);
+    if (index < 0) {
+        return nullptr;
+    }
+    SkSharedDiscardableMemoryEntry* entry = &entries[index];
+    if (key) {
+        entry->fState = SkSharedDiscardableMemoryEntry::kWriting;
+        entry->fKeyBytes = keyBytes;
+        memcpy(entry->fKey, key, keyBytes);
+    } else {
+        entry->fState = SkSharedDiscardableMemoryEntry::kAnonymous;
+    }
+    return std::unique_ptr<SkDiscardableMemory>(new Memory(sk_ref_sp(this), index,
+                                                           entry->fGeneration,
+                                                           this->pageData(entry->fFirstPage)));
+}
+
+SkDiscardableMemory* SkSharedDiscardableMemoryPool::create(size_t bytes) {
+    return this->make(bytes, nullptr, 0).release();
+}
+
+std::unique_ptr<SkDiscardableMemory> SkSharedDiscardableMemoryPool::createForKey(
+        const void* key, size_t keyBytes, size_t bytes) {
+    SkASSERT(key && keyBytes > 0);
+    return this->make(bytes, key, keyBytes);
+}
+
+void SkSharedDiscardableMemoryPool::publish(SkDiscardableMemory* dm) {
+    Memory* memory = static_cast<Memory*>(dm);
+    SkASSERT(memory->fPool.get() == this);
+
+    SkAutoExclusive lock(fHeader->fLock);
+    SkSharedDiscardableMemoryEntry* entry = &this->entries()[memory->fIndex];
+    if (entry->fGeneration == memory->fGeneration &&
+        SkSharedDiscardableMemoryEntry::kWriting == entry->fState) {
+        entry->fState = SkSharedDiscardableMemoryEntry::kPublished;
+    }
+}
+
+std::unique_ptr<SkDiscardableMemory> SkSharedDiscardableMemoryPool::find(const void* key,
+                                                                         size_t keyBytes,
+                                                                         size_t* bytes) {
+    SkAutoExclusive lock(fHeader->fLock);
+    SkSharedDiscardableMemoryEntry* entries = this->entries();
+    for (uint32_t i = 0; i < fHeader->fPageCount; ++i) {
+        SkSharedDiscardableMemoryEntry* entry = &entries[i];
+        if (SkSharedDiscardableMemoryEntry::kPublished == entry->fState &&
+            entry->matches(key, keyBytes)) {
+            entry->fLockCount++;
+            entry->fLastUse = ++fHeader->fClock;
+            *bytes = entry->fBytes;
+            return std::unique_ptr<SkDiscardableMemory>(new Memory(
+                    sk_ref_sp(this), i, entry->fGeneration, this->pageData(entry->fFirstPage)));
+        }
+    }
+    return nullptr;
+}
+
+bool SkSharedDiscardableMemoryPool::lock(int index, uint32_t generation) {
+    SkAutoExclusive lock(fHeader->fLock);
+    SkSharedDiscardableMemoryEntry* entry = &this->entries()[index];
+    if (entry->fGeneration != generation) {
+        return false;
+    }
+    SkASSERT(SkSharedDiscardableMemoryEntry::kFree != entry->fState);
+    entry->fLockCount++;
+    entry->fLastUse = ++fHeader->fClock;
+    return true;
+}
+
+void SkSharedDiscardableMemoryPool::unlock(int index, uint32_t generation) {
+    SkAutoExclusive lock(fHeader->fLock);
+    SkSharedDiscardableMemoryEntry* entry = &this->entries()[index];
+    // Locked memory is never freed, so this is still ours.
+    SkASSERT(entry->fGeneration == generation);
+    SkASSERT(entry->fLockCount > 0);
+    entry->fLockCount--;
+}
+
+void SkSharedDiscardableMemoryPool::release(int index, uint32_t generation) {
+    SkAutoExclusive lock(fHeader->fLock);
+    SkSharedDiscardableMemoryEntry* entry = &this->entries()[index];
+    if (entry->fGeneration == generation &&
+        (SkSharedDiscardableMemoryEntry::kAnonymous == entry->fState ||
+         SkSharedDiscardableMemoryEntry::kWriting == entry->fState)) {
+        this->freeLocked(entry);
+    }
+}
+
+void SkSharedDiscardableMemoryPool::purgeUnlocked() {
+    SkAutoExclusive lock(fHeader->fLock);
+    while (this->evictOneLocked()) {}
+}
+
+size_t SkSharedDiscardableMemoryPool::getBytesUsed() {
+    SkAutoExclusive lock(fHeader->fLock);
+    const uint8_t* pageMap = this->pageMap();
+    size_t used = 0;
+    for (uint32_t page = 0; page < fHeader->fPageCount; ++page) {
+        used += pageMap[page] ? kPageSize : 0;
+    }
+    return used;
+}
+
+size_t SkSharedDiscardableMemoryPool::getByteLimit() const {
+    return fHeader->fPageCount * kPageSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkSpinlock gGlobalLock;
+static SkSharedDiscardableMemoryPool* gGlobal = nullptr;
+
+sk_sp<SkSharedDiscardableMemoryPool> SkSharedDiscardableMemoryPool::Global() {
+    SkAutoExclusive lock(gGlobalLock);
+    return sk_ref_sp(gGlobal);
+}
+
+void SkSharedDiscardableMemoryPool::SetGlobal(sk_sp<SkSharedDiscardableMemoryPool> pool) {
+    SkSharedDiscardableMemoryPool* old;
+    {
+        SkAutoExclusive lock(gGlobalLock);
+        old = gGlobal;
+        gGlobal = pool.release();
+    }
+    SkSafeUnref(old);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSharedDiscardableMemoryPool_DEFINED
+#define SkSharedDiscardableMemoryPool_DEFINED
+
+#include "SkDiscardableMemory.h"
+
+#include <memory>
+
+struct SkSharedDiscardableMemoryHeader;
+struct SkSharedDiscardableMemoryEntry;
+
+/**
+ *  Discardable memory carved out of a block of memory that several processes map, e.g. a named
+ *  shared memory region. Memory can be published under a key, after which any process's pool can
+ *  find and lock it, so that something expensive to make (like decoded pixels) is made once per
+ *  machine rather than once per process.
+ *
+ *  The block is split into fixed-size pages. When an allocation doesn't fit, the least recently
+ *  locked unlocked memory is discarded until it does. Every process's pool shares one spinlock
+ *  that lives in the block.
+ *
+ *  Published memory must not be written to. Memory that a process still has locked when it dies
+ *  stays in the pool until the block is remade.
+ */
+class SkSharedDiscardableMemoryPool : public SkDiscardableMemory::Factory {
+public:
+    static constexpr size_t kPageSize = 64 * 1024;
+    static constexpr size_t kMaxKeyBytes = 64;
+
+    /**
+     *  Returns a pool over 'bytes' bytes at 'memory', or nullptr if that is too small to hold
+     *  even one page. The memory must be zero-filled the first time any process makes a pool over
+     *  it (new shared memory mappings are); that pool lays it out, and later pools, in any process,
+     *  join it. It must stay mapped as long as the pool or any memory it made is alive, and every
+     *  process must map the same number of bytes.
+     */
+    static sk_sp<SkSharedDiscardableMemoryPool> Make(void* memory, size_t bytes);
+
+    /**
+     *  Returns locked memory that nothing else can find. Like any other discardable memory, it is
+     *  freed when it is deleted.
+     */
+    SkDiscardableMemory* create(size_t bytes) override;
+
+    /**
+     *  Returns locked, writable memory that will be found under 'key' once it is published. Returns
+     *  nullptr if there is no room, or if some process has already published or is writing memory
+     *  under 'key'. If the memory is deleted before it is published, it is freed.
+     */
+    std::unique_ptr<SkDiscardableMemory> createForKey(const void* key, size_t keyBytes,
+                                                      size_t bytes);
+
+    /**
+     *  Makes memory from createForKey() findable by every pool over this block. It stays in the
+     *  pool after it is deleted, until it is discarded.
+     */
+    void publish(SkDiscardableMemory*);
+
+    /**
+     *  Returns the memory published under 'key', locked, and sets 'bytes' to its size. Returns
+     *  nullptr if nothing is published under 'key' or it was discarded.
+     */
+    std::unique_ptr<SkDiscardableMemory> find(const void* key, size_t keyBytes, size_t* bytes);
+
+    /** Discards all unlocked memory, in every process. */
+    void purgeUnlocked();
+
+    /** The bytes of pages in use by every process. */
+    size_t getBytesUsed();
+    size_t getByteLimit() const;
+
+    /**
+     *  The pool that SkImage_Lazy shares decoded images through, or nullptr if there isn't one.
+     *  There isn't unless the embedder sets one.
+     */
+    static sk_sp<SkSharedDiscardableMemoryPool> Global();
+    static void SetGlobal(sk_sp<SkSharedDiscardableMemoryPool>);
+
+private:
+    SkSharedDiscardableMemoryPool(SkSharedDiscardableMemoryHeader*);
+
+    class Memory;
+    friend class Memory;
+
+    SkSharedDiscardableMemoryEntry* entries() const;
+    uint8_t* pageMap() const;
+    void* pageData(uint32_t page) const;
+
+    // These must be called with the block's lock held.
+    int allocateLocked(size_t bytes);
+    bool evictOneLocked();
+    void freeLocked(SkSharedDiscardableMemoryEntry*);
+    int findFreePagesLocked(uint32_t count) const;
+
+    std::unique_ptr<SkDiscardableMemory> make(size_t bytes, const void* key, size_t keyBytes);
+    bool lock(int index, uint32_t generation);
+    void unlock(int index, uint32_t generation);
+    void release(int index, uint32_t generation);
+
+    SkSharedDiscardableMemoryHeader* fHeader;
+
+    typedef SkDiscardableMemory::Factory INHERITED;
+};
+
+#endif
@@ -589,6 +589,11 @@ public:
     AI void store(void* ptr) const {
         return vst1q_u32((uint32_t*)ptr, fVec);
     }
+    AI static void Load2(const void* ptr, SkNx* x, SkNx* y) {
+        uint32x4x2_t xy = vld2q_u32((const uint32_t*) ptr);
+        *x = xy.val[0];
+        *y = xy.val[1];
+    }
     AI uint32_t operator[](int k) const {
         SkASSERT(0 <= k && k < 4);
         union { uint32x4_t v; uint32_t us[4]; } pun = {fVec};
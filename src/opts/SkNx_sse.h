@@ -369,6 +369,13 @@ public:
 
     AI void store(void* ptr) const { _mm_storeu_si128((__m128i*)ptr, fVec); }
 
+    AI static void Load2(const void* ptr, SkNx* x, SkNx* y) {
+        __m128 lo = _mm_loadu_ps(((const float*)ptr) + 0),
+               hi = _mm_loadu_ps(((const float*)ptr) + 4);
+        *x = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0)));
+        *y = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3,1,3,1)));
+    }
+
     AI SkNx operator + (const SkNx& o) const { return _mm_add_epi32(fVec, o.fVec); }
     AI SkNx operator - (const SkNx& o) const { return _mm_sub_epi32(fVec, o.fVec); }
     AI SkNx operator * (const SkNx& o) const { return mullo32(fVec, o.fVec);       }
@@ -0,0 +1,306 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkNx_wasm_DEFINED
+#define SkNx_wasm_DEFINED
+
+#include <wasm_simd128.h>
+
+// WebAssembly SIMD128 has only one 128-bit vector type, v128_t, so only the 4-lane float and
+// 32-bit int types are specialized here.  Everything narrower stays portable, and the casts below
+// move lanes in and out of those types through memory.
+
+namespace {
+
+template <>
+class SkNx<4, float> {
+public:
+    AI SkNx(const v128_t& vec) : fVec(vec) {}
+
+    AI SkNx() {}
+    AI SkNx(float val) : fVec(wasm_f32x4_splat(val)) {}
+    AI SkNx(float a, float b, float c, float d) : fVec(wasm_f32x4_make(a,b,c,d)) {}
+
+    AI static SkNx Load(const void* ptr) { return wasm_v128_load(ptr); }
+    AI void store(void* ptr) const { wasm_v128_store(ptr, fVec); }
+
+    AI static void Load2(const void* ptr, SkNx* x, SkNx* y) {
+        v128_t lo = wasm_v128_load((const float*)ptr + 0),
+               hi = wasm_v128_load((const float*)ptr + 4);
+        *x = wasm_i32x4_shuffle(lo, hi, 0,2,4,6);
+        *y = wasm_i32x4_shuffle(lo, hi, 1,3,5,7);
+    }
+
+    AI static void Load4(const void* ptr, SkNx* r, SkNx* g, SkNx* b, SkNx* a) {
+        transpose(wasm_v128_load((const float*)ptr +  0),
+                  wasm_v128_load((const float*)ptr +  4),
+                  wasm_v128_load((const float*)ptr +  8),
+                  wasm_v128_load((const float*)ptr + 12), r, g, b, a);
+    }
+    AI static void Store4(void* dst, const SkNx& r, const SkNx& g, const SkNx& b, const SkNx& a) {
+        SkNx v0, v1, v2, v3;
+        transpose(r.fVec, g.fVec, b.fVec, a.fVec, &v0, &v1, &v2, &v3);
+        wasm_v128_store((float*)dst +  0, v0.fVec);
+        wasm_v128_store((float*)dst +  4, v1.fVec);
+        wasm_v128_store((float*)dst +  8, v2.fVec);
+        wasm_v128_store((float*)dst + 12, v3.fVec);
+    }
+
+    AI SkNx operator - () const { return wasm_f32x4_neg(fVec); }
+
+    AI SkNx operator + (const SkNx& o) const { return wasm_f32x4_add(fVec, o.fVec); }
+    AI SkNx operator - (const SkNx& o) const { return wasm_f32x4_sub(fVec, o.fVec); }
+    AI SkNx operator * (const SkNx& o) const { return wasm_f32x4_mul(fVec, o.fVec); }
+    AI SkNx operator / (const SkNx& o) const { return wasm_f32x4_div(fVec, o.fVec); }
+
+    AI SkNx operator == (const SkNx& o) const { return wasm_f32x4_eq(fVec, o.fVec); }
+    AI SkNx operator != (const SkNx& o) const { return wasm_f32x4_ne(fVec, o.fVec); }
+    AI SkNx operator  < (const SkNx& o) const { return wasm_f32x4_lt(fVec, o.fVec); }
+    AI SkNx operator  > (const SkNx& o) const { return wasm_f32x4_gt(fVec, o.fVec); }
+    AI SkNx operator <= (const SkNx& o) const { return wasm_f32x4_le(fVec, o.fVec); }
+    AI SkNx operator >= (const SkNx& o) const { return wasm_f32x4_ge(fVec, o.fVec); }
+
+    // pmin/pmax are l < r ? l : r, so like SSE's min/max they return r when either is NaN.
+    AI static SkNx Min(const SkNx& l, const SkNx& r) { return wasm_f32x4_pmin(r.fVec, l.fVec); }
+    AI static SkNx Max(const SkNx& l, const SkNx& r) { return wasm_f32x4_pmax(r.fVec, l.fVec); }
+
+    AI SkNx abs() const { return wasm_f32x4_abs(fVec); }
+    AI SkNx floor() const { return wasm_f32x4_floor(fVec); }
+
+    // There are no estimate instructions, so these are exact.
+    AI SkNx   sqrt() const { return wasm_f32x4_sqrt(fVec); }
+    AI SkNx  rsqrt() const { return wasm_f32x4_div(wasm_f32x4_splat(1), wasm_f32x4_sqrt(fVec)); }
+    AI SkNx invert() const { return wasm_f32x4_div(wasm_f32x4_splat(1), fVec); }
+
+    AI float operator[](int k) const {
+        SkASSERT(0 <= k && k < 4);
+        union { v128_t v; float fs[4]; } pun = {fVec};
+        return pun.fs[k&3];
+    }
+
+    AI float min() const {
+        SkNx min = Min(*this, wasm_i32x4_shuffle(fVec, fVec, 1,0,3,2));
+        min = Min(min, wasm_i32x4_shuffle(min.fVec, min.fVec, 2,3,0,1));
+        return min[0];
+    }
+
+    AI float max() const {
+        SkNx max = Max(*this, wasm_i32x4_shuffle(fVec, fVec, 1,0,3,2));
+        max = Max(max, wasm_i32x4_shuffle(max.fVec, max.fVec, 2,3,0,1));
+        return max[0];
+    }
+
+    AI bool allTrue() const { return wasm_i32x4_all_true(fVec); }
+    AI bool anyTrue() const { return wasm_v128_any_true(fVec); }
+
+    AI SkNx thenElse(const SkNx& t, const SkNx& e) const {
+        return wasm_v128_bitselect(t.fVec, e.fVec, fVec);
+    }
+
+    v128_t fVec;
+
+private:
+    AI static void transpose(v128_t v0, v128_t v1, v128_t v2, v128_t v3,
+                             SkNx* c0, SkNx* c1, SkNx* c2, SkNx* c3) {
+        v128_t t0 = wasm_i32x4_shuffle(v0, v1, 0,4,1,5),
+               t1 = wasm_i32x4_shuffle(v2, v3, 0,4,1,5),
+               t2 = wasm_i32x4_shuffle(v0, v1, 2,6,3,7),
+               t3 = wasm_i32x4_shuffle(v2, v3, 2,6,3,7);
+        *c0 = wasm_i32x4_shuffle(t0, t1, 0,1,4,5);
+        *c1 = wasm_i32x4_shuffle(t0, t1, 2,3,6,7);
+        *c2 = wasm_i32x4_shuffle(t2, t3, 0,1,4,5);
+        *c3 = wasm_i32x4_shuffle(t2, t3, 2,3,6,7);
+    }
+};
+
+template <>
+class SkNx<4, int32_t> {
+public:
+    AI SkNx(const v128_t& vec) : fVec(vec) {}
+
+    AI SkNx() {}
+    AI SkNx(int32_t val) : fVec(wasm_i32x4_splat(val)) {}
+    AI static SkNx Load(const void* ptr) { return wasm_v128_load(ptr); }
+    AI SkNx(int32_t a, int32_t b, int32_t c, int32_t d) : fVec(wasm_i32x4_make(a,b,c,d)) {}
+
+    AI void store(void* ptr) const { wasm_v128_store(ptr, fVec); }
+
+    AI SkNx operator + (const SkNx& o) const { return wasm_i32x4_add(fVec, o.fVec); }
+    AI SkNx operator - (const SkNx& o) const { return wasm_i32x4_sub(fVec, o.fVec); }
+    AI SkNx operator * (const SkNx& o) const { return wasm_i32x4_mul(fVec, o.fVec); }
+
+    AI SkNx operator & (const SkNx& o) const { return wasm_v128_and(fVec, o.fVec); }
+    AI SkNx operator | (const SkNx& o) const { return wasm_v128_or (fVec, o.fVec); }
+    AI SkNx operator ^ (const SkNx& o) const { return wasm_v128_xor(fVec, o.fVec); }
+
+    AI SkNx operator << (int bits) const { return wasm_i32x4_shl(fVec, bits); }
+    AI SkNx operator >> (int bits) const { return wasm_i32x4_shr(fVec, bits); }
+
+    AI SkNx operator == (const SkNx& o) const { return wasm_i32x4_eq(fVec, o.fVec); }
+    AI SkNx operator  < (const SkNx& o) const { return wasm_i32x4_lt(fVec, o.fVec); }
+    AI SkNx operator  > (const SkNx& o) const { return wasm_i32x4_gt(fVec, o.fVec); }
+
+    AI int32_t operator[](int k) const {
+        SkASSERT(0 <= k && k < 4);
+        union { v128_t v; int32_t is[4]; } pun = {fVec};
+        return pun.is[k&3];
+    }
+
+    AI SkNx thenElse(const SkNx& t, const SkNx& e) const {
+        return wasm_v128_bitselect(t.fVec, e.fVec, fVec);
+    }
+
+    AI SkNx abs() const { return wasm_i32x4_abs(fVec); }
+
+    AI static SkNx Min(const SkNx& x, const SkNx& y) { return wasm_i32x4_min(x.fVec, y.fVec); }
+    AI static SkNx Max(const SkNx& x, const SkNx& y) { return wasm_i32x4_max(x.fVec, y.fVec); }
+
+    v128_t fVec;
+};
+
+template <>
+class SkNx<4, uint32_t> {
+public:
+    AI SkNx(const v128_t& vec) : fVec(vec) {}
+
+    AI SkNx() {}
+    AI SkNx(uint32_t val) : fVec(wasm_u32x4_splat(val)) {}
+    AI static SkNx Load(const void* ptr) { return wasm_v128_load(ptr); }
+    AI SkNx(uint32_t a, uint32_t b, uint32_t c, uint32_t d) : fVec(wasm_u32x4_make(a,b,c,d)) {}
+
+    AI void store(void* ptr) const { wasm_v128_store(ptr, fVec); }
+
+    AI static void Load2(const void* ptr, SkNx* x, SkNx* y) {
+        v128_t lo = wasm_v128_load((const uint32_t*)ptr + 0),
+               hi = wasm_v128_load((const uint32_t*)ptr + 4);
+        *x = wasm_i32x4_shuffle(lo, hi, 0,2,4,6);
+        *y = wasm_i32x4_shuffle(lo, hi, 1,3,5,7);
+    }
+
+    AI SkNx operator + (const SkNx& o) const { return wasm_i32x4_add(fVec, o.fVec); }
+    AI SkNx operator - (const SkNx& o) const { return wasm_i32x4_sub(fVec, o.fVec); }
+    AI SkNx operator * (const SkNx& o) const { return wasm_i32x4_mul(fVec, o.fVec); }
+
+    AI SkNx operator & (const SkNx& o) const { return wasm_v128_and(fVec, o.fVec); }
+    AI SkNx operator | (const SkNx& o) const { return wasm_v128_or (fVec, o.fVec); }
+    AI SkNx operator ^ (const SkNx& o) const { return wasm_v128_xor(fVec, o.fVec); }
+
+    AI SkNx operator << (int bits) const { return wasm_i32x4_shl(fVec, bits); }
+    AI SkNx operator >> (int bits) const { return wasm_u32x4_shr(fVec, bits); }
+
+    AI SkNx operator == (const SkNx& o) const { return wasm_i32x4_eq(fVec, o.fVec); }
+    AI SkNx operator != (const SkNx& o) const { return wasm_i32x4_ne(fVec, o.fVec); }
+    AI SkNx operator  < (const SkNx& o) const { return wasm_u32x4_lt(fVec, o.fVec); }
+    AI SkNx operator  > (const SkNx& o) const { return wasm_u32x4_gt(fVec, o.fVec); }
+
+    AI uint32_t operator[](int k) const {
+        SkASSERT(0 <= k && k < 4);
+        union { v128_t v; uint32_t us[4]; } pun = {fVec};
+        return pun.us[k&3];
+    }
+
+    AI static SkNx Min(const SkNx& x, const SkNx& y) { return wasm_u32x4_min(x.fVec, y.fVec); }
+
+    AI SkNx thenElse(const SkNx& t, const SkNx& e) const {
+        return wasm_v128_bitselect(t.fVec, e.fVec, fVec);
+    }
+
+    AI SkNx mulHi(const SkNx& m) const {
+        v128_t lo = wasm_u64x2_extmul_low_u32x4 (fVec, m.fVec),
+               hi = wasm_u64x2_extmul_high_u32x4(fVec, m.fVec);
+        return wasm_i32x4_shuffle(lo, hi, 1,3,5,7);
+    }
+
+    v128_t fVec;
+};
+
+// Sk4b and Sk4h are 4 and 8 bytes of a vector's low lane(s).
+AI static v128_t load_4b(const Sk4b& src) {
+    uint32_t bytes;
+    src.store(&bytes);
+    return wasm_v128_load32_zero(&bytes);
+}
+AI static Sk4b store_4b(v128_t v) {
+    uint32_t bytes = wasm_i32x4_extract_lane(v, 0);
+    return Sk4b::Load(&bytes);
+}
+AI static v128_t load_4h(const Sk4h& src) {
+    uint64_t shorts;
+    src.store(&shorts);
+    return wasm_v128_load64_zero(&shorts);
+}
+AI static Sk4h store_4h(v128_t v) {
+    uint64_t shorts = wasm_i64x2_extract_lane(v, 0);
+    return Sk4h::Load(&shorts);
+}
+
+template<> AI /*static*/ Sk4f SkNx_cast<float, int32_t>(const Sk4i& src) {
+    return wasm_f32x4_convert_i32x4(src.fVec);
+}
+
+template<> AI /*static*/ Sk4f SkNx_cast<float, uint32_t>(const Sk4u& src) {
+    return SkNx_cast<float>(Sk4i::Load(&src));
+}
+
+template<> AI /*static*/ Sk4i SkNx_cast<int32_t, float>(const Sk4f& src) {
+    return wasm_i32x4_trunc_sat_f32x4(src.fVec);
+}
+
+template<> AI /*static*/ Sk4h SkNx_cast<uint16_t, int32_t>(const Sk4i& src) {
+    return store_4h(wasm_i8x16_shuffle(src.fVec, src.fVec, 0,1, 4,5, 8,9, 12,13,
+                                                           0,1, 4,5, 8,9, 12,13));
+}
+
+template<> AI /*static*/ Sk4h SkNx_cast<uint16_t, float>(const Sk4f& src) {
+    return SkNx_cast<uint16_t>(SkNx_cast<int32_t>(src));
+}
+
+// Like SSE's packus, these saturate.
+template<> AI /*static*/ Sk4b SkNx_cast<uint8_t, int32_t>(const Sk4i& src) {
+    v128_t _16 = wasm_u16x8_narrow_i32x4(src.fVec, src.fVec);
+    return store_4b(wasm_u8x16_narrow_i16x8(_16, _16));
+}
+
+template<> AI /*static*/ Sk4b SkNx_cast<uint8_t, uint32_t>(const Sk4u& src) {
+    return SkNx_cast<uint8_t>(Sk4i(src.fVec));
+}
+
+template<> AI /*static*/ Sk4b SkNx_cast<uint8_t, float>(const Sk4f& src) {
+    return SkNx_cast<uint8_t>(SkNx_cast<int32_t>(src));
+}
+
+template<> AI /*static*/ Sk4u SkNx_cast<uint32_t, uint8_t>(const Sk4b& src) {
+    return wasm_u32x4_extend_low_u16x8(wasm_u16x8_extend_low_u8x16(load_4b(src)));
+}
+
+template<> AI /*static*/ Sk4i SkNx_cast<int32_t, uint8_t>(const Sk4b& src) {
+    return SkNx_cast<uint32_t>(src).fVec;
+}
+
+template<> AI /*static*/ Sk4f SkNx_cast<float, uint8_t>(const Sk4b& src) {
+    return wasm_f32x4_convert_i32x4(SkNx_cast<int32_t>(src).fVec);
+}
+
+template<> AI /*static*/ Sk4f SkNx_cast<float, uint16_t>(const Sk4h& src) {
+    return wasm_f32x4_convert_i32x4(wasm_u32x4_extend_low_u16x8(load_4h(src)));
+}
+
+template<> AI /*static*/ Sk4i SkNx_cast<int32_t, uint16_t>(const Sk4h& src) {
+    return wasm_u32x4_extend_low_u16x8(load_4h(src));
+}
+
+template<> AI /*static*/ Sk4i SkNx_cast<int32_t, uint32_t>(const Sk4u& src) {
+    return src.fVec;
+}
+
+AI static Sk4i Sk4f_round(const Sk4f& x) {
+    return wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_nearest(x.fVec));
+}
+
+}  // namespace
+
+#endif//SkNx_wasm_DEFINED
@@ -8,11 +8,14 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS hsw
+#include "SkBlitMask_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkUtils_opts.h"
 
 namespace SkOpts {
     void Init_hsw() {
+        blit_mask_d32_a8 = SK_OPTS_NS::blit_mask_d32_a8;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
@@ -222,7 +222,190 @@ namespace SK_OPTS_NS {
         }
     }
 
-#elif defined(JUMPER_IS_AVX) || defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#elif defined(JUMPER_IS_AVX512)
+    // These are __m512 and __m512i, but friendlier and strongly-typed.
+    template <typename T> using V = T __attribute__((ext_vector_type(16)));
+    using F   = V<float   >;
+    using I32 = V< int32_t>;
+    using U64 = V<uint64_t>;
+    using U32 = V<uint32_t>;
+    using U16 = V<uint16_t>;
+    using U8  = V<uint8_t >;
+
+    SI F   mad(F f, F m, F a)   { return _mm512_fmadd_ps(f,m,a);  }
+    SI F   min(F a, F b)        { return _mm512_min_ps(a,b);      }
+    SI F   max(F a, F b)        { return _mm512_max_ps(a,b);      }
+    SI F   abs_  (F v)          { return _mm512_and_ps(v, 0-v);   }
+    SI F   floor_(F v)          { return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF); }
+    SI F   rcp   (F v)          { return _mm512_rcp14_ps  (v);    }
+    SI F   rsqrt (F v)          { return _mm512_rsqrt14_ps(v);    }
+    SI F    sqrt_(F v)          { return _mm512_sqrt_ps   (v);    }
+    SI U32 round (F v, F scale) { return _mm512_cvtps_epi32(v*scale); }
+
+    SI U16 pack(U32 v) { return _mm512_cvtepi32_epi16(v); }
+    SI U8  pack(U16 v) { return _mm256_cvtepi16_epi8 (v); }
+
+    SI F if_then_else(I32 c, F t, F e) {
+        return _mm512_mask_blend_ps(_mm512_movepi32_mask(c), e,t);
+    }
+
+    template <typename T>
+    SI V<T> gather(const T* p, U32 ix) {
+        return { p[ix[ 0]], p[ix[ 1]], p[ix[ 2]], p[ix[ 3]],
+                 p[ix[ 4]], p[ix[ 5]], p[ix[ 6]], p[ix[ 7]],
+                 p[ix[ 8]], p[ix[ 9]], p[ix[10]], p[ix[11]],
+                 p[ix[12]], p[ix[13]], p[ix[14]], p[ix[15]], };
+    }
+    SI F   gather(const float*    p, U32 ix) { return _mm512_i32gather_ps   (ix, p, 4); }
+    SI U32 gather(const uint32_t* p, U32 ix) { return _mm512_i32gather_epi32(ix, p, 4); }
+    SI U64 gather(const uint64_t* p, U32 ix) {
+        __m512i parts[] = {
+            _mm512_i32gather_epi64(_mm512_castsi512_si256   (ix   ), p, 8),
+            _mm512_i32gather_epi64(_mm512_extracti64x4_epi64(ix, 1), p, 8),
+        };
+        return bit_cast<U64>(parts);
+    }
+
+    // Tails are handled with masked loads and stores, which never touch inactive lanes' memory.
+    // tail_mask() sets a bit for each lane of the first tail pixels, or of all 16 if tail == 0.
+    SI uint64_t tail_mask(size_t tail, size_t lanes_per_pixel) {
+        size_t lanes = (tail ? tail : 16) * lanes_per_pixel;  // 1 <= lanes <= 64
+        return ~0ull >> (64 - lanes);
+    }
+
+    SI V<uint8_t > mask_load(const uint8_t * p, __mmask16 m) { return _mm_maskz_loadu_epi8    (m,p); }
+    SI V<uint16_t> mask_load(const uint16_t* p, __mmask16 m) { return _mm256_maskz_loadu_epi16(m,p); }
+    SI V<uint32_t> mask_load(const uint32_t* p, __mmask16 m) { return _mm512_maskz_loadu_epi32(m,p); }
+    SI V<float   > mask_load(const float   * p, __mmask16 m) { return _mm512_maskz_loadu_ps   (m,p); }
+
+    SI void mask_store(uint8_t * p, __mmask16 m, V<uint8_t > v) { _mm_mask_storeu_epi8    (p,m,v); }
+    SI void mask_store(uint16_t* p, __mmask16 m, V<uint16_t> v) { _mm256_mask_storeu_epi16(p,m,v); }
+    SI void mask_store(uint32_t* p, __mmask16 m, V<uint32_t> v) { _mm512_mask_storeu_epi32(p,m,v); }
+    SI void mask_store(float   * p, __mmask16 m, V<float   > v) { _mm512_mask_storeu_ps   (p,m,v); }
+
+    SI void load3(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b) {
+        // 16 rgb pixels are 48 uint16_t, which we load as 32 + 16 (zeros past that).
+        const uint64_t m = tail_mask(tail, 3);
+        __m512i _0 = _mm512_maskz_loadu_epi16((__mmask32)(m >>  0), ptr +  0),
+                _1 = _mm512_maskz_loadu_epi16((__mmask32)(m >> 32), ptr + 32);
+
+        // _mm512_permutex2var_epi16() picks lane i from _0 and lane 32+i from _1.
+        static const uint16_t lanes[] = {
+            0, 3, 6, 9,12,15,18,21,24,27,30,33,36,39,42,45,  // r
+            1, 4, 7,10,13,16,19,22,25,28,31,34,37,40,43,46,  // g
+            2, 5, 8,11,14,17,20,23,26,29,32,35,38,41,44,47,  // b
+            2, 5, 8,11,14,17,20,23,26,29,32,35,38,41,44,47,  // (b again, ignored)
+        };
+        __m512i rg = _mm512_permutex2var_epi16(_0, _mm512_loadu_si512(lanes +  0), _1),
+                bb = _mm512_permutex2var_epi16(_0, _mm512_loadu_si512(lanes + 32), _1);
+
+        *r = _mm512_castsi512_si256   (rg   );
+        *g = _mm512_extracti64x4_epi64(rg, 1);
+        *b = _mm512_castsi512_si256   (bb   );
+    }
+    SI void load4(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b, U16* a) {
+        // Each pixel is 64 bits, so we mask in 64-bit lanes, 8 pixels per register.
+        const uint64_t m = tail_mask(tail, 1);
+        __m512i _0 = _mm512_maskz_loadu_epi64((__mmask8)(m >> 0), ptr +  0),
+                _1 = _mm512_maskz_loadu_epi64((__mmask8)(m >> 8), ptr + 32);
+
+        static const uint16_t lanes[] = {
+            0, 4, 8,12,16,20,24,28,32,36,40,44,48,52,56,60,  // r
+            1, 5, 9,13,17,21,25,29,33,37,41,45,49,53,57,61,  // g
+            2, 6,10,14,18,22,26,30,34,38,42,46,50,54,58,62,  // b
+            3, 7,11,15,19,23,27,31,35,39,43,47,51,55,59,63,  // a
+        };
+        __m512i rg = _mm512_permutex2var_epi16(_0, _mm512_loadu_si512(lanes +  0), _1),
+                ba = _mm512_permutex2var_epi16(_0, _mm512_loadu_si512(lanes + 32), _1);
+
+        *r = _mm512_castsi512_si256   (rg   );
+        *g = _mm512_extracti64x4_epi64(rg, 1);
+        *b = _mm512_castsi512_si256   (ba   );
+        *a = _mm512_extracti64x4_epi64(ba, 1);
+    }
+    SI void store4(uint16_t* ptr, size_t tail, U16 r, U16 g, U16 b, U16 a) {
+        __m512i rg = _mm512_inserti64x4(_mm512_castsi256_si512(r), g, 1),  // r0 ... r15 g0 ... g15
+                ba = _mm512_inserti64x4(_mm512_castsi256_si512(b), a, 1);  // b0 ... b15 a0 ... a15
+
+        // Pixel i is {rg[i], rg[16+i], ba[i], ba[16+i]}, and lane 32+i picks ba[i].
+        static const uint16_t lanes[] = {
+             0,16,32,48,  1,17,33,49,  2,18,34,50,  3,19,35,51,
+             4,20,36,52,  5,21,37,53,  6,22,38,54,  7,23,39,55,
+             8,24,40,56,  9,25,41,57, 10,26,42,58, 11,27,43,59,
+            12,28,44,60, 13,29,45,61, 14,30,46,62, 15,31,47,63,
+        };
+        __m512i _0 = _mm512_permutex2var_epi16(rg, _mm512_loadu_si512(lanes +  0), ba),
+                _1 = _mm512_permutex2var_epi16(rg, _mm512_loadu_si512(lanes + 32), ba);
+
+        const uint64_t m = tail_mask(tail, 1);
+        _mm512_mask_storeu_epi64(ptr +  0, (__mmask8)(m >> 0), _0);
+        _mm512_mask_storeu_epi64(ptr + 32, (__mmask8)(m >> 8), _1);
+    }
+
+    SI void load4(const float* ptr, size_t tail, F* r, F* g, F* b, F* a) {
+        const uint64_t m = tail_mask(tail, 4);
+        F _0123 = _mm512_maskz_loadu_ps((__mmask16)(m >>  0), ptr +  0),
+          _4567 = _mm512_maskz_loadu_ps((__mmask16)(m >> 16), ptr + 16),
+          _89AB = _mm512_maskz_loadu_ps((__mmask16)(m >> 32), ptr + 32),
+          _CDEF = _mm512_maskz_loadu_ps((__mmask16)(m >> 48), ptr + 48);
+
+        // First split each pair of registers into rg and ba halves for 8 pixels,
+        static const int32_t rgba[] = {
+            0, 4, 8,12,16,20,24,28,  1, 5, 9,13,17,21,25,29,  // r0 ... r7 g0 ... g7
+            2, 6,10,14,18,22,26,30,  3, 7,11,15,19,23,27,31,  // b0 ... b7 a0 ... a7
+        };
+        auto RG = _mm512_loadu_si512(rgba +  0),
+             BA = _mm512_loadu_si512(rgba + 16);
+        F rg07 = _mm512_permutex2var_ps(_0123, RG, _4567),
+          ba07 = _mm512_permutex2var_ps(_0123, BA, _4567),
+          rg8F = _mm512_permutex2var_ps(_89AB, RG, _CDEF),
+          ba8F = _mm512_permutex2var_ps(_89AB, BA, _CDEF);
+
+        // ... then join those halves into the 16 pixels of each channel.
+        static const int32_t halves[] = {
+            0, 1, 2, 3, 4, 5, 6, 7, 16,17,18,19,20,21,22,23,  // the low halves
+            8, 9,10,11,12,13,14,15, 24,25,26,27,28,29,30,31,  // the high halves
+        };
+        auto LO = _mm512_loadu_si512(halves +  0),
+             HI = _mm512_loadu_si512(halves + 16);
+        *r = _mm512_permutex2var_ps(rg07, LO, rg8F);
+        *g = _mm512_permutex2var_ps(rg07, HI, rg8F);
+        *b = _mm512_permutex2var_ps(ba07, LO, ba8F);
+        *a = _mm512_permutex2var_ps(ba07, HI, ba8F);
+    }
+    SI void store4(float* ptr, size_t tail, F r, F g, F b, F a) {
+        // This is load4() backwards: first interleave 8-pixel halves of r,g and b,a,
+        static const int32_t halves[] = {
+            0, 1, 2, 3, 4, 5, 6, 7, 16,17,18,19,20,21,22,23,  // the low halves
+            8, 9,10,11,12,13,14,15, 24,25,26,27,28,29,30,31,  // the high halves
+        };
+        auto LO = _mm512_loadu_si512(halves +  0),
+             HI = _mm512_loadu_si512(halves + 16);
+        F rg07 = _mm512_permutex2var_ps(r, LO, g),  // r0 ... r7 g0 ... g7
+          rg8F = _mm512_permutex2var_ps(r, HI, g),  // r8 ... rF g8 ... gF
+          ba07 = _mm512_permutex2var_ps(b, LO, a),
+          ba8F = _mm512_permutex2var_ps(b, HI, a);
+
+        // ... then pick out rgba for 4 pixels at a time.
+        static const int32_t pixels[] = {
+            0, 8,16,24,  1, 9,17,25,  2,10,18,26,  3,11,19,27,  // pixels 0-3 (or 8-B)
+            4,12,20,28,  5,13,21,29,  6,14,22,30,  7,15,23,31,  // pixels 4-7 (or C-F)
+        };
+        auto P0 = _mm512_loadu_si512(pixels +  0),
+             P1 = _mm512_loadu_si512(pixels + 16);
+        F _0123 = _mm512_permutex2var_ps(rg07, P0, ba07),
+          _4567 = _mm512_permutex2var_ps(rg07, P1, ba07),
+          _89AB = _mm512_permutex2var_ps(rg8F, P0, ba8F),
+          _CDEF = _mm512_permutex2var_ps(rg8F, P1, ba8F);
+
+        const uint64_t m = tail_mask(tail, 4);
+        _mm512_mask_storeu_ps(ptr +  0, (__mmask16)(m >>  0), _0123);
+        _mm512_mask_storeu_ps(ptr + 16, (__mmask16)(m >> 16), _4567);
+        _mm512_mask_storeu_ps(ptr + 32, (__mmask16)(m >> 32), _89AB);
+        _mm512_mask_storeu_ps(ptr + 48, (__mmask16)(m >> 48), _CDEF);
+    }
+
+#elif defined(JUMPER_IS_AVX) || defined(JUMPER_IS_HSW)
     // These are __m256 and __m256i, but friendlier and strongly-typed.
     template <typename T> using V = T __attribute__((ext_vector_type(8)));
     using F   = V<float   >;
@@ -233,7 +416,7 @@ namespace SK_OPTS_NS {
     using U8  = V<uint8_t >;
 
     SI F mad(F f, F m, F a)  {
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+    #if defined(JUMPER_IS_HSW)
         return _mm256_fmadd_ps(f,m,a);
     #else
         return f*m+a;
@@ -265,7 +448,7 @@ namespace SK_OPTS_NS {
         return { p[ix[0]], p[ix[1]], p[ix[2]], p[ix[3]],
                  p[ix[4]], p[ix[5]], p[ix[6]], p[ix[7]], };
     }
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+    #if defined(JUMPER_IS_HSW)
         SI F   gather(const float*    p, U32 ix) { return _mm256_i32gather_ps   (p, ix, 4); }
         SI U32 gather(const uint32_t* p, U32 ix) { return _mm256_i32gather_epi32(p, ix, 4); }
         SI U64 gather(const uint64_t* p, U32 ix) {
@@ -661,7 +844,10 @@ SI F from_half(U16 h) {
 #if defined(SK_CPU_ARM64) && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f32_f16(h);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#elif defined(JUMPER_IS_AVX512)
+    return _mm512_cvtph_ps(h);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtph_ps(h);
 
 #else
@@ -681,7 +867,10 @@ SI U16 to_half(F f) {
 #if defined(SK_CPU_ARM64) && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f16_f32(f);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#elif defined(JUMPER_IS_AVX512)
+    return _mm512_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
 
 #else
@@ -816,7 +1005,12 @@ static void start_pipeline(size_t dx, size_t dy, size_t xlimit, size_t ylimit, v
 
 template <typename V, typename T>
 SI V load(const T* src, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_AVX512)
+    __builtin_assume(tail < N);
+    if (__builtin_expect(tail, 0)) {
+        return mask_load(src, (__mmask16)tail_mask(tail, 1));
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         V v{};  // Any inactive lanes are zeroed.
@@ -837,7 +1031,13 @@ SI V load(const T* src, size_t tail) {
 
 template <typename V, typename T>
 SI void store(T* dst, V v, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_AVX512)
+    __builtin_assume(tail < N);
+    if (__builtin_expect(tail, 0)) {
+        mask_store(dst, (__mmask16)tail_mask(tail, 1), v);
+        return;
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         switch (tail) {
@@ -940,7 +1140,7 @@ STAGE(seed_shader, Ctx::None) {
 
 STAGE(dither, const float* rate) {
     // Get [(dx,dy), (dx+1,dy), (dx+2,dy), ...] loaded up in integer vectors.
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7, 8,9,10,11,12,13,14,15};
     U32 X = dx + unaligned_load<U32>(iota),
         Y = dy;
 
@@ -1884,10 +2084,34 @@ STAGE(matrix_perspective, const float* m) {
     g = G * rcp(Z);
 }
 
+// Fused stages run two stages back to back, saving the tail call and register shuffling between
+// them.  Each half reads its own context (if any) from the program, in order.
+#define FUSE(first, second)                                                  \
+    STAGE(first##_##second, Ctx fused) {                                     \
+        first##_k (Ctx{fused.program}, dx,dy,tail, r,g,b,a, dr,dg,db,da);   \
+        second##_k(Ctx{fused.program}, dx,dy,tail, r,g,b,a, dr,dg,db,da);   \
+    }
+FUSE(seed_shader, matrix_translate)
+FUSE(seed_shader, matrix_scale_translate)
+FUSE(seed_shader, matrix_2x3)
+FUSE(seed_shader, matrix_perspective)
+#undef FUSE
+
 SI void gradient_lookup(const SkJumper_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_AVX512)
+    if (c->stopCount <= 16) {
+        fr = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[0]));
+        br = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[0]));
+        fg = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[1]));
+        bg = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[1]));
+        fb = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[2]));
+        bb = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[2]));
+        fa = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[3]));
+        ba = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[3]));
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         fr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->fs[0]), idx);
         br = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->bs[0]), idx);
@@ -2168,6 +2392,91 @@ STAGE(gauss_a_to_rgba, Ctx::None) {
     b = a;
 }
 
+// Turns a sample of a distance field (see SkDistanceFieldGen.h) into coverage.  128/255 is on
+// the edge, and *scale converts the distance from there into device pixels, over which the
+// coverage ramps from 0 to 1.
+STAGE(sdf_to_alpha, const float* scale) {
+    a = clamp_01(mad(a - 128/255.0f, *scale, 0.5f));
+    r = g = b = 0;
+}
+
+// Lattice coordinates wrap at 256; this is v & 255 for integral v, negative or not.
+SI U32 perlin_lattice(F v) {
+    return trunc_(v - floor_(v * (1/256.0f)) * 256.0f);
+}
+
+// SVG's feTurbulence: fractal noise or turbulence, evaluated for all four channels at once.
+// Writes unpremultiplied r,g,b,a.
+STAGE(perlin_noise, const SkJumper_PerlinNoiseCtx* c) {
+    // Noise is sampled at whole pixels, and the scale of the matrix is in baseFrequency.
+    F x = floor_(floor_(r) + c->translate[0] + 0.5f) * c->baseFrequency[0],
+      y = floor_(floor_(g) + c->translate[1] + 0.5f) * c->baseFrequency[1];
+
+    F sum[4] = { 0, 0, 0, 0 };
+    float ratio = 1.0f;
+    for (int octave = 0; octave < c->octaves; octave++) {
+        F px = x + 4096.0f,
+          py = y + 4096.0f;
+        F x0 = floor_(px),
+          y0 = floor_(py);
+        F fx = px - x0,
+          fy = py - y0;
+        F x1 = x0 + 1.0f,
+          y1 = y0 + 1.0f;
+        if (c->stitch) {
+            // When stitching, lattice points past the tile wrap back to its start.
+            const float* s = c->stitch + 4*octave;
+            x0 = if_then_else(x0 >= s[1], x0 - s[0], x0);
+            x1 = if_then_else(x1 >= s[1], x1 - s[0], x1);
+            y0 = if_then_else(y0 >= s[3], y0 - s[2], y0);
+            y1 = if_then_else(y1 >= s[3], y1 - s[2], y1);
+        }
+        U32 i = gather(c->latticeSelector, perlin_lattice(x0)),
+            j = gather(c->latticeSelector, perlin_lattice(x1));
+        U32 iy0 = perlin_lattice(y0),
+            iy1 = perlin_lattice(y1);
+        U32 b00 = ((i + iy0) & 255) * 2,
+            b10 = ((j + iy0) & 255) * 2,
+            b01 = ((i + iy1) & 255) * 2,
+            b11 = ((j + iy1) & 255) * 2;
+
+        F sx = fx * fx * (3 - 2 * fx),
+          sy = fy * fy * (3 - 2 * fy);
+        I32 pathological = (sx < 0) | (sy < 0) | (sx > 1) | (sy > 1);
+        const float scale = 1.0f / ratio;
+
+        for (int channel = 0; channel < 4; channel++) {
+            const float* grad = c->gradient[channel];
+            auto dot = [&](U32 ix, F u, F v) {
+                return gather(grad, ix) * u + gather(grad, ix + 1) * v;
+            };
+            F u = dot(b00, fx, fy),
+              v = dot(b10, fx - 1, fy);
+            F lo = u + (v - u) * sx;
+            u = dot(b01, fx, fy - 1);
+            v = dot(b11, fx - 1, fy - 1);
+            F hi = u + (v - u) * sx;
+            F noise = if_then_else(pathological, 0, lo + (hi - lo) * sy);
+            sum[channel] += (c->turbulence ? abs_(noise) : noise) * scale;
+        }
+
+        x *= 2.0f;
+        y *= 2.0f;
+        ratio *= 2.0f;
+    }
+
+    for (int channel = 0; channel < 4; channel++) {
+        if (!c->turbulence) {
+            sum[channel] = (sum[channel] + 1) * 0.5f;
+        }
+        sum[channel] = min(max(sum[channel], 0), 1.0f);
+    }
+    r = sum[0];
+    g = sum[1];
+    b = sum[2];
+    a = sum[3];
+}
+
 // A specialized fused image shader for clamp-x, clamp-y, non-sRGB sampling.
 STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
     // (cx,cy) are the center of our sample.
@@ -2449,6 +2758,9 @@ SI F min(F x, F y) { return if_then_else(x < y, x, y); }
 SI F mad(F f, F m, F a) { return f*m+a; }
 SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 
+// Rounds v, in [0,255] units like our U16 channels, back to a channel, clamping it first.
+SI U16 round_255(F v) { return cast<U16>(min(max(0, v), 255.0f) + 0.5f); }
+
 SI F rcp(F x) {
 #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
     __m256 lo,hi;
@@ -2556,6 +2868,17 @@ STAGE_GG(matrix_perspective, const float* m) {
     y = Y * rcp(Z);
 }
 
+#define FUSE_GG(first, second)                                \
+    STAGE_GG(first##_##second, Ctx fused) {                   \
+        first##_k (Ctx{fused.program}, dx,dy,tail, x,y);      \
+        second##_k(Ctx{fused.program}, dx,dy,tail, x,y);      \
+    }
+FUSE_GG(seed_shader, matrix_translate)
+FUSE_GG(seed_shader, matrix_scale_translate)
+FUSE_GG(seed_shader, matrix_2x3)
+FUSE_GG(seed_shader, matrix_perspective)
+#undef FUSE_GG
+
 STAGE_PP(uniform_color, const SkJumper_UniformColorCtx* c) {
     r = c->rgba[0];
     g = c->rgba[1];
@@ -2604,6 +2927,27 @@ STAGE_PP(premul_dst, Ctx::None) {
 STAGE_PP(force_opaque    , Ctx::None) {  a = 255; }
 STAGE_PP(force_opaque_dst, Ctx::None) { da = 255; }
 
+STAGE_PP(unpremul, Ctx::None) {
+    F fa    = cast<F>(a),
+      scale = if_then_else(fa > 0, 255.0f / fa, F(0));
+    r = round_255(cast<F>(r) * scale);
+    g = round_255(cast<F>(g) * scale);
+    b = round_255(cast<F>(b) * scale);
+}
+
+// The matrix works in [0,1] units, so its translation column is scaled up to match ours.
+// Results are clamped here, since we can't hold them out of range until clamp_0 or clamp_1.
+STAGE_PP(matrix_4x5, const float* m) {
+    F R = cast<F>(r),
+      G = cast<F>(g),
+      B = cast<F>(b),
+      A = cast<F>(a);
+    r = round_255(mad(R,m[0], mad(G,m[4], mad(B,m[ 8], mad(A,m[12], m[16]*255.0f)))));
+    g = round_255(mad(R,m[1], mad(G,m[5], mad(B,m[ 9], mad(A,m[13], m[17]*255.0f)))));
+    b = round_255(mad(R,m[2], mad(G,m[6], mad(B,m[10], mad(A,m[14], m[18]*255.0f)))));
+    a = round_255(mad(R,m[3], mad(G,m[7], mad(B,m[11], mad(A,m[15], m[19]*255.0f)))));
+}
+
 STAGE_PP(swap_rb, Ctx::None) {
     auto tmp = r;
     r = b;
@@ -2677,6 +3021,20 @@ STAGE_PP(move_dst_src, Ctx::None) {
         return div255( s*inv(da) + d*inv(sa) +
                        if_then_else(2*d <= da, 2*s*d, sa*da - 2*(sa-s)*(da-d)) );
     }
+
+    // These divide, which we do in float.  Lanes that would divide by zero take another branch.
+    BLEND_MODE(colorburn) {
+        U16 burn = da - min(da, round_255(cast<F>((da-d)*sa) / cast<F>(s)));
+        return if_then_else(d == da, d + div255( s*inv(da) ),
+               if_then_else(s ==  0,     div255( d*inv(sa) ),
+                                         div255( sa*burn + s*inv(da) + d*inv(sa) )));
+    }
+    BLEND_MODE(colordodge) {
+        U16 dodge = min(da, round_255(cast<F>(d*sa) / cast<F>(sa-s)));
+        return if_then_else(d ==  0,     div255( s*inv(da) ),
+               if_then_else(s == sa, s + div255( d*inv(sa) ),
+                                         div255( sa*dodge + s*inv(da) + d*inv(sa) )));
+    }
 #undef BLEND_MODE
 
 // ~~~~~~ Helpers for interacting with memory ~~~~~~ //
@@ -2886,6 +3244,43 @@ STAGE_GP(gather_bgra, const SkJumper_GatherCtx* ctx) {
     from_8888(gather<U32>(ptr, ix), &b, &g, &r, &a);
 }
 
+STAGE_GP(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
+    // (cx,cy) are the center of our sample, just like highp bilerp_clamp_8888.
+    F cx = x,
+      cy = y;
+
+    // All sample points are at the same fractional offset (fx,fy), which we weight with
+    // in 1/256ths so that the whole filter fits in 16-bit math.
+    U16 wx = cast<U16>(fract(cx + 0.5f) * 256.0f + 0.5f),
+        wy = cast<U16>(fract(cy + 0.5f) * 256.0f + 0.5f);
+
+    // ix_and_ptr() will clamp to the image's bounds for us.
+    auto sample = [&](F sx, F sy, U16* sr, U16* sg, U16* sb, U16* sa) {
+        const uint32_t* ptr;
+        U32 ix = ix_and_ptr(&ptr, ctx, sx,sy);
+        from_8888(gather<U32>(ptr, ix), sr,sg,sb,sa);
+    };
+    // Each product is at most 255*256, so adding the rounding bias can't overflow.
+    auto lerp_256 = [](U16 from, U16 to, U16 t) {
+        return (from*(256 - t) + to*t + 128) >> 8;
+    };
+
+    U16 r0,g0,b0,a0, r1,g1,b1,a1;
+    sample(cx - 0.5f, cy - 0.5f, &r0,&g0,&b0,&a0);
+    sample(cx + 0.5f, cy - 0.5f, &r1,&g1,&b1,&a1);
+    U16 tr = lerp_256(r0,r1, wx),
+        tg = lerp_256(g0,g1, wx),
+        tb = lerp_256(b0,b1, wx),
+        ta = lerp_256(a0,a1, wx);
+
+    sample(cx - 0.5f, cy + 0.5f, &r0,&g0,&b0,&a0);
+    sample(cx + 0.5f, cy + 0.5f, &r1,&g1,&b1,&a1);
+    r = lerp_256(tr, lerp_256(r0,r1, wx), wy);
+    g = lerp_256(tg, lerp_256(g0,g1, wx), wy);
+    b = lerp_256(tb, lerp_256(b0,b1, wx), wy);
+    a = lerp_256(ta, lerp_256(a0,a1, wx), wy);
+}
+
 // ~~~~~~ 16-bit memory loads and stores ~~~~~~ //
 
 SI void from_565(U16 rgb, U16* r, U16* g, U16* b) {
@@ -3131,7 +3526,18 @@ SI void gradient_lookup(const SkJumper_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_AVX512)
+#if defined(JUMPER_IS_AVX512)
+    if (c->stopCount <= 16) {
+        fr = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[0]));
+        br = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[0]));
+        fg = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[1]));
+        bg = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[1]));
+        fb = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[2]));
+        bb = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[2]));
+        fa = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[3]));
+        ba = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[3]));
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
@@ -3258,22 +3664,23 @@ using NotImplemented = void(*)(void);
 static NotImplemented
         callback, load_rgba, store_rgba,
         unbounded_set_rgb, unbounded_uniform_color,
-        unpremul, dither,
+        dither,
         from_srgb, from_srgb_dst, to_srgb,
         load_f16    , load_f16_dst    , store_f16    , gather_f16,
         load_f32    , load_f32_dst    , store_f32    , gather_f32,
         load_1010102, load_1010102_dst, store_1010102, gather_1010102,
         store_u16_be,
         byte_tables,
-        colorburn, colordodge, softlight, hue, saturation, color, luminosity,
-        matrix_3x3, matrix_3x4, matrix_4x5, matrix_4x3,
+        softlight, hue, saturation, color, luminosity,
+        matrix_3x3, matrix_3x4, matrix_4x3,
         parametric, gamma,
         rgb_to_hsl, hsl_to_rgb,
         gauss_a_to_rgba,
+        perlin_noise,
+        sdf_to_alpha,
         mirror_x, repeat_x,
         mirror_y, repeat_y,
         negate_x,
-        bilerp_clamp_8888,
         bilinear_nx, bilinear_ny, bilinear_px, bilinear_py,
         bicubic_n3x, bicubic_n1x, bicubic_p1x, bicubic_p3x,
         bicubic_n3y, bicubic_n1y, bicubic_p1y, bicubic_p3y,
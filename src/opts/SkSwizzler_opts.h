@@ -158,6 +158,61 @@ static void inverted_CMYK_to_BGR1_portable(uint32_t* dst, const uint32_t* src, i
     }
 }
 
+// 16-bit components are big-endian, so the first byte of each is its most significant 8 bits.
+static void RGB16_to_RGB1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4];
+        src += 6;
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)b    << 16
+               | (uint32_t)g    <<  8
+               | (uint32_t)r    <<  0;
+    }
+}
+
+static void RGB16_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4];
+        src += 6;
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)r    << 16
+               | (uint32_t)g    <<  8
+               | (uint32_t)b    <<  0;
+    }
+}
+
+static void RGBA16_to_RGBA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)b << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)r <<  0;
+    }
+}
+
+static void RGBA16_to_BGRA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)r << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)b <<  0;
+    }
+}
+
 #if defined(SK_ARM_HAS_NEON)
 
 // Rounded divide by 255, (x + 127) / 255
@@ -477,6 +532,80 @@ static void inverted_cmyk_to(uint32_t* dst, const uint32_t* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+template <bool kSwapRB>
+static void strip16_insert_alpha_should_swaprb(uint32_t dst[], const uint8_t* src, int count) {
+    while (count >= 8) {
+        // Load 8 pixels.  Read as little-endian, the low byte of each component is the one we keep.
+        uint16x8x3_t rgb = vld3q_u16((const uint16_t*) src);
+
+        // Narrow to 8 bits, insert an opaque alpha channel, and swap if needed.
+        uint8x8x4_t rgba;
+        if (kSwapRB) {
+            rgba.val[0] = vmovn_u16(rgb.val[2]);
+            rgba.val[2] = vmovn_u16(rgb.val[0]);
+        } else {
+            rgba.val[0] = vmovn_u16(rgb.val[0]);
+            rgba.val[2] = vmovn_u16(rgb.val[2]);
+        }
+        rgba.val[1] = vmovn_u16(rgb.val[1]);
+        rgba.val[3] = vdup_n_u8(0xFF);
+
+        // Store 8 pixels.
+        vst4_u8((uint8_t*) dst, rgba);
+        src += 8*6;
+        dst += 8;
+        count -= 8;
+    }
+
+    auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_insert_alpha_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_insert_alpha_should_swaprb<true>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void strip16_should_swaprb(uint32_t dst[], const uint8_t* src, int count) {
+    while (count >= 8) {
+        // Load 8 pixels.
+        uint16x8x4_t rgba16 = vld4q_u16((const uint16_t*) src);
+
+        // Narrow to 8 bits and swap if needed.
+        uint8x8x4_t rgba;
+        if (kSwapRB) {
+            rgba.val[0] = vmovn_u16(rgba16.val[2]);
+            rgba.val[2] = vmovn_u16(rgba16.val[0]);
+        } else {
+            rgba.val[0] = vmovn_u16(rgba16.val[0]);
+            rgba.val[2] = vmovn_u16(rgba16.val[2]);
+        }
+        rgba.val[1] = vmovn_u16(rgba16.val[1]);
+        rgba.val[3] = vmovn_u16(rgba16.val[3]);
+
+        // Store 8 pixels.
+        vst4_u8((uint8_t*) dst, rgba);
+        src += 8*8;
+        dst += 8;
+        count -= 8;
+    }
+
+    auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_should_swaprb<true>(dst, src, count);
+}
+
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
 
 // Scale a byte by another.
@@ -774,6 +903,92 @@ static void inverted_cmyk_to(uint32_t* dst, const uint32_t* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+template <bool kSwapRB>
+static void strip16_insert_alpha_should_swaprb(uint32_t dst[], const uint8_t* src, int count) {
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    // X zeroes its byte, so that the two halves can be or'd together.
+    const uint8_t X = 0x80;
+    __m128i expandLo, expandHi;
+    if (kSwapRB) {
+        expandLo = _mm_setr_epi8(4,2,0,X, 10,8,6,X, X,X,X,X, X,X,X,X);
+        expandHi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 8,6,4,X, 14,12,10,X);
+    } else {
+        expandLo = _mm_setr_epi8(0,2,4,X, 6,8,10,X, X,X,X,X, X,X,X,X);
+        expandHi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 4,6,8,X, 10,12,14,X);
+    }
+
+    while (count >= 4) {
+        // Four pixels are 24 bytes.  The first two are in the vector at src, and the last two
+        // are in the vector at src + 8.
+        __m128i lo = _mm_loadu_si128((const __m128i*) (src + 0)),
+                hi = _mm_loadu_si128((const __m128i*) (src + 8));
+
+        // Keep the high byte of each component, then insert an opaque alpha.
+        __m128i rgba = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(lo, expandLo),
+                                                 _mm_shuffle_epi8(hi, expandHi)),
+                                    alphaMask);
+
+        // Store 4 pixels.
+        _mm_storeu_si128((__m128i*) dst, rgba);
+
+        src += 4*6;
+        dst += 4;
+        count -= 4;
+    }
+
+    // Call portable code to finish up the tail of [0,4) pixels.
+    auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_insert_alpha_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_insert_alpha_should_swaprb<true>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void strip16_should_swaprb(uint32_t dst[], const uint8_t* src, int count) {
+    const uint8_t X = 0x80;
+    __m128i strip;
+    if (kSwapRB) {
+        strip = _mm_setr_epi8(4,2,0,6, 12,10,8,14, X,X,X,X, X,X,X,X);
+    } else {
+        strip = _mm_setr_epi8(0,2,4,6, 8,10,12,14, X,X,X,X, X,X,X,X);
+    }
+
+    while (count >= 4) {
+        // Load 4 pixels, two per vector.
+        __m128i lo = _mm_loadu_si128((const __m128i*) (src +  0)),
+                hi = _mm_loadu_si128((const __m128i*) (src + 16));
+
+        // Keep the high byte of each component, packing each vector's two pixels into its low
+        // half, then put the halves together.
+        __m128i rgba = _mm_unpacklo_epi64(_mm_shuffle_epi8(lo, strip),
+                                          _mm_shuffle_epi8(hi, strip));
+
+        // Store 4 pixels.
+        _mm_storeu_si128((__m128i*) dst, rgba);
+
+        src += 4*8;
+        dst += 4;
+        count -= 4;
+    }
+
+    auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16_should_swaprb<true>(dst, src, count);
+}
+
 #else
 
 /*not static*/ inline void RGBA_to_rgbA(uint32_t* dst, const uint32_t* src, int count) {
@@ -816,6 +1031,22 @@ static void inverted_cmyk_to(uint32_t* dst, const uint32_t* src, int count) {
     inverted_CMYK_to_BGR1_portable(dst, src, count);
 }
 
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+    RGB16_to_RGB1_portable(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+    RGB16_to_BGR1_portable(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+    RGBA16_to_RGBA_portable(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+    RGBA16_to_BGRA_portable(dst, src, count);
+}
+
 #endif
 
 }
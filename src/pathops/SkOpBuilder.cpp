@@ -11,6 +11,12 @@
 #include "SkPathPriv.h"
 #include "SkPathOps.h"
 #include "SkPathOpsCommon.h"
+#include "SkTaskGroup.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
 
 static bool one_contour(const SkPath& path) {
     SkSTArenaAlloc<256> allocator;
@@ -120,15 +126,122 @@ void SkOpBuilder::reset() {
     fOps.reset();
 }
 
+// Like SkRect::Intersects, but rects that only share an edge intersect too.
+static bool bounds_touch(const SkRect& a, const SkRect& b) {
+    return a.fLeft <= b.fRight && b.fLeft <= a.fRight && a.fTop <= b.fBottom && b.fTop <= a.fBottom;
+}
+
+// Groups the paths whose bounds touch, directly or through other paths. Paths in different
+// clusters can't touch each other. Sweeps the bounds from left to right, so only paths whose
+// horizontal extents overlap are compared.
+static std::vector<std::vector<int>> find_clusters(const SkTArray<SkPath>& paths) {
+    const int count = paths.count();
+    std::vector<int> parent(count);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&parent](int i) {
+        while (parent[i] != i) {
+            i = parent[i] = parent[parent[i]];
+        }
+        return i;
+    };
+    std::vector<int> order(parent);
+    std::sort(order.begin(), order.end(), [&paths](int a, int b) {
+        return paths[a].getBounds().fLeft < paths[b].getBounds().fLeft;
+    });
+    std::vector<int> active;
+    for (int index : order) {
+        const SkRect& bounds = paths[index].getBounds();
+        active.erase(std::remove_if(active.begin(), active.end(), [&](int other) {
+            return paths[other].getBounds().fRight < bounds.fLeft;
+        }), active.end());
+        for (int other : active) {
+            if (bounds_touch(paths[other].getBounds(), bounds)) {
+                parent[root(other)] = root(index);
+            }
+        }
+        active.push_back(index);
+    }
+    std::vector<std::vector<int>> clusters;
+    std::vector<int> clusterOfRoot(count, -1);
+    for (int index = 0; index < count; ++index) {
+        int& cluster = clusterOfRoot[root(index)];
+        if (cluster < 0) {
+            cluster = SkToInt(clusters.size());
+            clusters.emplace_back();
+        }
+        clusters[cluster].push_back(index);
+    }
+    return clusters;
+}
+
+// Unions the paths pairwise, then the pairs' results pairwise, and so on, so no path takes part
+// in more than log2(count) ops. Leaves the union, simplified, in paths[0].
+static bool union_cluster(SkPath paths[], int count) {
+    if (1 == count) {
+        return Simplify(paths[0], &paths[0]);
+    }
+    for (int step = 1; step < count; step *= 2) {
+        for (int index = 0; index + step < count; index += 2 * step) {
+            if (!Op(paths[index], paths[index + step], kUnion_SkPathOp, &paths[index])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// All of the ops are unions, but some paths overlap. Rather than op each path into the running
+// result, whose size grows with every op, union each cluster of overlapping paths on its own.
+// The clusters don't touch, so their unions can be summed and simplified like disjoint paths.
+bool SkOpBuilder::resolveUnionClusters(SkPath* result, SkExecutor* executor) {
+    std::vector<std::vector<int>> clusters = find_clusters(fPathRefs);
+    const int clusterCount = SkToInt(clusters.size());
+    std::vector<std::vector<SkPath>> clusterPaths(clusterCount);
+    for (int cluster = 0; cluster < clusterCount; ++cluster) {
+        for (int index : clusters[cluster]) {
+            clusterPaths[cluster].push_back(fPathRefs[index]);
+        }
+    }
+    reset();
+    std::unique_ptr<bool[]> succeeded(new bool[clusterCount]);
+    auto unionCluster = [&](int cluster) {
+        std::vector<SkPath>& paths = clusterPaths[cluster];
+        succeeded[cluster] = union_cluster(paths.data(), SkToInt(paths.size())) &&
+                             (paths[0].isEmpty() || FixWinding(&paths[0]));
+    };
+    if (executor && clusterCount > 1) {
+        SkTaskGroup(*executor).batch(clusterCount, unionCluster);
+    } else {
+        for (int cluster = 0; cluster < clusterCount; ++cluster) {
+            unionCluster(cluster);
+        }
+    }
+    SkPath sum;
+    for (int cluster = 0; cluster < clusterCount; ++cluster) {
+        if (!succeeded[cluster]) {
+            return false;
+        }
+        sum.addPath(clusterPaths[cluster][0]);
+    }
+    return Simplify(sum, result);
+}
+
 /* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more convex
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
-bool SkOpBuilder::resolve(SkPath* result) {
+bool SkOpBuilder::resolve(SkPath* result, SkExecutor* executor) {
     SkPath original = *result;
     int count = fOps.count();
     bool allUnion = true;
-    SkPathPriv::FirstDirection firstDir = SkPathPriv::kUnknown_FirstDirection;
+    bool onlyUnionOps = true;
     for (int index = 0; index < count; ++index) {
+        if (kUnion_SkPathOp != fOps[index] || fPathRefs[index].isInverseFillType()) {
+            onlyUnionOps = false;
+            break;
+        }
+    }
+    SkPathPriv::FirstDirection firstDir = SkPathPriv::kUnknown_FirstDirection;
+    for (int index = 0; allUnion && index < count; ++index) {
         SkPath* test = &fPathRefs[index];
         if (kUnion_SkPathOp != fOps[index] || test->isInverseFillType()) {
             allUnion = false;
@@ -158,6 +271,13 @@ bool SkOpBuilder::resolve(SkPath* result) {
             }
         }
     }
+    if (!allUnion && onlyUnionOps) {
+        if (!this->resolveUnionClusters(result, executor)) {
+            *result = original;
+            return false;
+        }
+        return true;
+    }
     if (!allUnion) {
         *result = fPathRefs[0];
         for (int index = 1; index < count; ++index) {
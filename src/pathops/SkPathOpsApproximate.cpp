@@ -0,0 +1,487 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using std::vector;
+
+// ApproximateOp() flattens its paths into line edges and sweeps them a band of y at a time. Each
+// band is cut where edges cross, so that within it no two edges change order. The left and
+// right sides of the runs of each band that are inside the result, and the horizontals where the
+// runs of one band don't line up with those of the next, are the result's outline.
+
+namespace {
+
+static const int kMaxSubdivisions = 1 << 10;
+
+struct Edge {
+    SkPoint fTop;
+    SkPoint fBottom;
+    int fWinding;  // +1 if the edge runs down, -1 if it runs up.
+    int fOperand;  // 0 for the first path, 1 for the second.
+    double fDxDy;
+
+    // Every band that meets at y must compute the same x, so this is the only way to find it.
+    SkScalar x(SkScalar y) const {
+        if (y <= fTop.fY) {
+            return fTop.fX;
+        }
+        if (y >= fBottom.fY) {
+            return fBottom.fX;
+        }
+        return (float) (fTop.fX + ((double) y - fTop.fY) * fDxDy);
+    }
+};
+
+// An edge that crosses the current band, and where it is at the band's top and bottom.
+struct Crossing {
+    int fEdge;
+    SkScalar fTopX;
+    SkScalar fBottomX;
+};
+
+// A run of the current band that is inside the result, between two edges.
+struct Run {
+    int fLeft;
+    int fRight;
+    SkScalar fLeftTopX;
+    SkScalar fLeftBottomX;
+    SkScalar fRightTopX;
+    SkScalar fRightBottomX;
+};
+
+// A piece of the result's outline, along fEdge, or horizontal if fEdge is negative.
+struct Segment {
+    SkPoint fStart;
+    SkPoint fEnd;
+    int fEdge;
+};
+
+class EdgeBuilder {
+public:
+    EdgeBuilder(SkScalar tolerance, vector<Edge>* edges)
+        : fTolerance(tolerance)
+        , fEdges(edges) {
+    }
+
+    void addPath(const SkPath& path, int operand) {
+        fOperand = operand;
+        SkPath::Iter iter(path, true);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kLine_Verb:
+                    this->addLine(pts[0], pts[1]);
+                    break;
+                case SkPath::kQuad_Verb:
+                    this->addQuad(pts, fTolerance);
+                    break;
+                case SkPath::kConic_Verb: {
+                    // Spend half of the tolerance on the quads, and half on their lines.
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quads = quadder.computeQuads(pts, iter.conicWeight(),
+                                                                fTolerance / 2);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->addQuad(quads + 2 * i, fTolerance / 2);
+                    }
+                    break;
+                }
+                case SkPath::kCubic_Verb:
+                    this->addCubic(pts);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+private:
+    // A curve split into n equal pieces in t strays from their chords by at most its largest
+    // second difference over 4n^2 for a quad, or 3/4 of it over n^2 for a cubic.
+    static int subdivisions(SkScalar deviation, SkScalar tolerance) {
+        SkScalar n = SkScalarCeilToScalar(SkScalarSqrt(deviation / tolerance));
+        return n < kMaxSubdivisions ? SkTMax(1, (int) n) : kMaxSubdivisions;
+    }
+
+    void addQuad(const SkPoint pts[3], SkScalar tolerance) {
+        SkScalar dd = (pts[0] - pts[1] * 2 + pts[2]).length();
+        int n = subdivisions(dd / 4, tolerance);
+        const SkQuadCoeff quad(pts);
+        SkPoint last = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next = to_point(quad.eval((SkScalar) i / n));
+            this->addLine(last, next);
+            last = next;
+        }
+        this->addLine(last, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        SkScalar dd = SkTMax((pts[0] - pts[1] * 2 + pts[2]).length(),
+                             (pts[1] - pts[2] * 2 + pts[3]).length());
+        int n = subdivisions(dd * 3 / 4, fTolerance);
+        const SkCubicCoeff cubic(pts);
+        SkPoint last = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next = to_point(cubic.eval((SkScalar) i / n));
+            this->addLine(last, next);
+            last = next;
+        }
+        this->addLine(last, pts[3]);
+    }
+
+    void addLine(const SkPoint& start, const SkPoint& end) {
+        if (start.fY == end.fY) {
+            // Horizontals don't change the winding of any band.
+            return;
+        }
+        double dxdy = ((double) end.fX - start.fX) / ((double) end.fY - start.fY);
+        if (start.fY < end.fY) {
+            fEdges->push_back({start, end, 1, fOperand, dxdy});
+        } else {
+            fEdges->push_back({end, start, -1, fOperand, dxdy});
+        }
+    }
+
+    const SkScalar fTolerance;
+    vector<Edge>* fEdges;
+    int fOperand = 0;
+};
+
+static bool apply_op(SkPathOp op, bool one, bool two) {
+    switch (op) {
+        case kDifference_SkPathOp:
+            return one && !two;
+        case kIntersect_SkPathOp:
+            return one && two;
+        case kUnion_SkPathOp:
+            return one || two;
+        case kXOR_SkPathOp:
+            return one != two;
+        case kReverseDifference_SkPathOp:
+            return two && !one;
+    }
+    return false;
+}
+
+class Sweep {
+public:
+    Sweep(const SkPath& one, const SkPath& two, SkPathOp op, SkScalar tolerance)
+        : fOp(op)
+        , fEpsilon(tolerance / 16) {
+        const SkPath* operands[] = { &one, &two };
+        for (int i = 0; i < 2; ++i) {
+            fEvenOdd[i] = operands[i]->getFillType() & 1;
+            fInverse[i] = operands[i]->isInverseFillType();
+        }
+        // The result is built inside out if it covers everything far from both paths.
+        fInverseResult = apply_op(op, fInverse[0], fInverse[1]);
+        EdgeBuilder builder(tolerance, &fEdges);
+        builder.addPath(one, 0);
+        builder.addPath(two, 1);
+    }
+
+    void run(SkPath* result) {
+        std::sort(fEdges.begin(), fEdges.end(), [](const Edge& a, const Edge& b) {
+            return a.fTop.fY < b.fTop.fY;
+        });
+        vector<SkScalar> ys;
+        ys.reserve(fEdges.size() * 2);
+        for (const Edge& edge : fEdges) {
+            ys.push_back(edge.fTop.fY);
+            ys.push_back(edge.fBottom.fY);
+        }
+        std::sort(ys.begin(), ys.end());
+        ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+        fOpenSegments.resize(fEdges.size(), -1);
+        size_t nextEdge = 0;
+        for (size_t i = 0; i + 1 < ys.size(); ++i) {
+            SkScalar top = ys[i];
+            fCrossings.erase(std::remove_if(fCrossings.begin(), fCrossings.end(),
+                    [this, top](const Crossing& crossing) {
+                        return fEdges[crossing.fEdge].fBottom.fY <= top;
+                    }), fCrossings.end());
+            for (; nextEdge < fEdges.size() && fEdges[nextEdge].fTop.fY <= top; ++nextEdge) {
+                fCrossings.push_back({(int) nextEdge, fEdges[nextEdge].fTop.fX, 0});
+            }
+            while (top < ys[i + 1]) {
+                top = this->band(top, ys[i + 1]);
+            }
+        }
+        this->addHorizontals(fLastBottom);
+        this->buildPath(result);
+    }
+
+private:
+    bool inside(const int winding[2]) const {
+        bool in[2];
+        for (int i = 0; i < 2; ++i) {
+            in[i] = fInverse[i] != (fEvenOdd[i] ? SkToBool(winding[i] & 1) : winding[i] != 0);
+        }
+        return apply_op(fOp, in[0], in[1]) != fInverseResult;
+    }
+
+    // Adds the outline of the runs between 'top' and the first place at or above 'bottom' where
+    // two edges cross, and returns that place. The crossings come in with their tops set, and
+    // leave with them set for the next band.
+    SkScalar band(SkScalar top, SkScalar bottom) {
+        for (Crossing& crossing : fCrossings) {
+            crossing.fBottomX = fEdges[crossing.fEdge].x(bottom);
+        }
+        // The crossings are mostly still in order from the band above, so insertion sort them.
+        auto less = [](const Crossing& a, const Crossing& b) {
+            return a.fTopX < b.fTopX || (a.fTopX == b.fTopX && a.fBottomX < b.fBottomX);
+        };
+        for (size_t i = 1; i < fCrossings.size(); ++i) {
+            Crossing crossing = fCrossings[i];
+            size_t j = i;
+            for (; j > 0 && less(crossing, fCrossings[j - 1]); --j) {
+                fCrossings[j] = fCrossings[j - 1];
+            }
+            fCrossings[j] = crossing;
+        }
+
+        // Edges closer together than epsilon are treated as one, so don't split for them.
+        SkScalar split = bottom;
+        for (size_t i = 1; i < fCrossings.size(); ++i) {
+            const Crossing& a = fCrossings[i - 1];
+            const Crossing& b = fCrossings[i];
+            if (a.fBottomX > b.fBottomX + fEpsilon) {
+                double topGap = (double) b.fTopX - a.fTopX;
+                double bottomGap = (double) a.fBottomX - b.fBottomX;
+                double t = topGap / (topGap + bottomGap);
+                SkScalar y = (float) (top + t * ((double) bottom - top));
+                if (y <= top) {
+                    y = std::nextafter(top, bottom);
+                }
+                split = SkTMin(split, y);
+            }
+        }
+        if (split != bottom) {
+            for (Crossing& crossing : fCrossings) {
+                crossing.fBottomX = fEdges[crossing.fEdge].x(split);
+            }
+        }
+
+        int winding[2] = { 0, 0 };
+        bool wasInside = false;
+        size_t left = 0;
+        for (size_t i = 0; i < fCrossings.size(); ) {
+            const Crossing& first = fCrossings[i];
+            size_t next = i;
+            do {
+                const Edge& edge = fEdges[fCrossings[next].fEdge];
+                winding[edge.fOperand] += edge.fWinding;
+                ++next;
+            } while (next < fCrossings.size()
+                    && SkScalarAbs(fCrossings[next].fTopX - first.fTopX) <= fEpsilon
+                    && SkScalarAbs(fCrossings[next].fBottomX - first.fBottomX) <= fEpsilon);
+            bool isInside = this->inside(winding);
+            if (isInside != wasInside) {
+                if (isInside) {
+                    left = i;
+                } else {
+                    const Crossing& l = fCrossings[left];
+                    fRuns.push_back({l.fEdge, first.fEdge, l.fTopX, l.fBottomX,
+                                     first.fTopX, first.fBottomX});
+                }
+                wasInside = isInside;
+            }
+            i = next;
+        }
+        SkASSERT(!wasInside);
+
+        for (const Run& run : fRuns) {
+            this->addSide({run.fLeftBottomX, split}, {run.fLeftTopX, top}, run.fLeft);
+            this->addSide({run.fRightTopX, top}, {run.fRightBottomX, split}, run.fRight);
+        }
+        this->addHorizontals(top);
+        for (Crossing& crossing : fCrossings) {
+            crossing.fTopX = crossing.fBottomX;
+        }
+        fLastBottom = split;
+        return split;
+    }
+
+    // Adds a side along the edge, or lengthens the side along it from the band above if the
+    // two meet.
+    void addSide(const SkPoint& start, const SkPoint& end, int edge) {
+        int& open = fOpenSegments[edge];
+        if (open >= 0) {
+            Segment& segment = fSegments[open];
+            if (segment.fStart == end) {
+                segment.fStart = start;
+                return;
+            }
+            if (segment.fEnd == start) {
+                segment.fEnd = end;
+                return;
+            }
+        }
+        open = (int) fSegments.size();
+        fSegments.push_back({start, end, edge});
+    }
+
+    // Adds the horizontals at y between the runs of the band above it, whose bottoms are
+    // outlined right to left, and the runs of the band starting at y, whose tops are outlined
+    // left to right. Where those overlap they cancel. The band starting at y becomes the one
+    // above.
+    void addHorizontals(SkScalar y) {
+        if (fAbove.size() == fRuns.size() && std::equal(fAbove.begin(), fAbove.end(),
+                fRuns.begin(), [](const Run& above, const Run& below) {
+                    return above.fLeftBottomX == below.fLeftTopX
+                        && above.fRightBottomX == below.fRightTopX;
+                })) {
+            // Most of the time the runs just carry on.
+            fAbove.swap(fRuns);
+            fRuns.clear();
+            return;
+        }
+        fEnds.clear();
+        for (const Run& run : fAbove) {
+            fEnds.push_back({run.fRightBottomX, 1});
+            fEnds.push_back({run.fLeftBottomX, -1});
+        }
+        for (const Run& run : fRuns) {
+            fEnds.push_back({run.fLeftTopX, 1});
+            fEnds.push_back({run.fRightTopX, -1});
+        }
+        std::sort(fEnds.begin(), fEnds.end(), [](const End& a, const End& b) {
+            return a.fX < b.fX;
+        });
+        int count = 0;
+        for (size_t i = 0; i + 1 < fEnds.size(); ++i) {
+            count += fEnds[i].fDelta;
+            SkScalar x0 = fEnds[i].fX;
+            SkScalar x1 = fEnds[i + 1].fX;
+            if (x0 == x1) {
+                continue;
+            }
+            for (int n = 0; n < count; ++n) {
+                fSegments.push_back({{x0, y}, {x1, y}, -1});
+            }
+            for (int n = 0; n < -count; ++n) {
+                fSegments.push_back({{x1, y}, {x0, y}, -1});
+            }
+        }
+        fAbove.swap(fRuns);
+        fRuns.clear();
+    }
+
+    // Each point has as many segments leaving it as arriving, so following unused segments from
+    // any one always leads back to it.
+    void buildPath(SkPath* result) {
+        auto less = [](const SkPoint& a, const SkPoint& b) {
+            return a.fY < b.fY || (a.fY == b.fY && a.fX < b.fX);
+        };
+        std::sort(fSegments.begin(), fSegments.end(), [less](const Segment& a, const Segment& b) {
+            return less(a.fStart, b.fStart);
+        });
+        // The next unused segment starting at each segment's start.
+        vector<size_t> unused(fSegments.size());
+        for (size_t i = 0; i < fSegments.size(); ++i) {
+            unused[i] = i;
+        }
+        vector<bool> used(fSegments.size(), false);
+
+        result->reset();
+        result->setFillType(fInverseResult ? SkPath::kInverseEvenOdd_FillType
+                                           : SkPath::kEvenOdd_FillType);
+        vector<const Segment*> loop;
+        for (size_t start = 0; start < fSegments.size(); ++start) {
+            if (used[start]) {
+                continue;
+            }
+            loop.clear();
+            size_t index = start;
+            while (true) {
+                used[index] = true;
+                loop.push_back(&fSegments[index]);
+                const SkPoint& end = fSegments[index].fEnd;
+                size_t first = std::lower_bound(fSegments.begin(), fSegments.end(), end,
+                        [less](const Segment& s, const SkPoint& p) {
+                            return less(s.fStart, p);
+                        }) - fSegments.begin();
+                size_t& next = unused[first];
+                while (next < fSegments.size() && used[next] && fSegments[next].fStart == end) {
+                    ++next;
+                }
+                if (next >= fSegments.size() || fSegments[next].fStart != end) {
+                    break;
+                }
+                index = next;
+            }
+            SkASSERT(loop.back()->fEnd == loop.front()->fStart);
+            this->addLoop(loop, result);
+        }
+    }
+
+    // Adds the loop, leaving out the points between pieces of the same edge or horizontal.
+    static void addLoop(const vector<const Segment*>& loop, SkPath* result) {
+        auto joined = [](const Segment* a, const Segment* b) {
+            return a->fEdge == b->fEdge;
+        };
+        size_t count = loop.size();
+        size_t first = 0;
+        while (first < count && joined(loop[(first + count - 1) % count], loop[first])) {
+            ++first;
+        }
+        if (first == count) {
+            // The whole loop is along one line, so it has no area.
+            return;
+        }
+        result->moveTo(loop[first]->fStart);
+        for (size_t i = 1; i < count; ++i) {
+            const Segment* segment = loop[(first + i) % count];
+            if (!joined(loop[(first + i - 1) % count], segment)) {
+                result->lineTo(segment->fStart);
+            }
+        }
+        result->close();
+    }
+
+    struct End {
+        SkScalar fX;
+        int fDelta;
+    };
+
+    vector<Edge> fEdges;
+    vector<Crossing> fCrossings;
+    vector<Run> fAbove;
+    vector<Run> fRuns;
+    vector<End> fEnds;
+    vector<Segment> fSegments;
+    vector<int> fOpenSegments;  // The last segment along each edge.
+    SkPathOp fOp;
+    SkScalar fEpsilon;
+    SkScalar fLastBottom = 0;
+    bool fEvenOdd[2];
+    bool fInverse[2];
+    bool fInverseResult;
+};
+
+}  // namespace
+
+bool ApproximateOp(const SkPath& one, const SkPath& two, SkPathOp op, SkScalar tolerance,
+                   SkPath* result) {
+    if (!SkScalarIsFinite(tolerance) || tolerance <= 0 || !one.isFinite() || !two.isFinite()) {
+        return false;
+    }
+    Sweep sweep(one, two, op, tolerance);
+    sweep.run(result);
+    return true;
+}
+
+bool ApproximateSimplify(const SkPath& path, SkScalar tolerance, SkPath* result) {
+    return ApproximateOp(path, SkPath(), kUnion_SkPathOp, tolerance, result);
+}
@@ -103,6 +103,14 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
     }
     const char* buffer = (const char*)void_buffer;
     while (len > 0) {
+        // Hand big writes to zlib as they are, rather than copying them
+        // through fInBuffer a piece at a time.
+        if (0 == fImpl->fInBufferIndex && len >= sizeof(fImpl->fInBuffer)) {
+            // zlib does not write to its input.
+            unsigned char* input = (unsigned char*)buffer;
+            do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut, input, len);
+            return true;
+        }
         size_t tocopy =
                 SkTMin(len, sizeof(fImpl->fInBuffer) - fImpl->fInBufferIndex);
         memcpy(fImpl->fInBuffer + fImpl->fInBufferIndex, buffer, tocopy);
@@ -7,6 +7,7 @@
 
 #include "SkJpegInfo.h"
 
+#include "SkCodecPriv.h"
 #include "SkTo.h"
 
 #ifndef SK_HAS_JPEG_LIBRARY
@@ -84,44 +85,77 @@ bool SkGetJpegInfo(const void* data, size_t len,
                    SkEncodedOrigin* orientation) {
     static const uint16_t kSOI = 0xFFD8;
     static const uint16_t kAPP0 = 0xFFE0;
+    static const uint16_t kAPP1 = 0xFFE1;
+    static const uint16_t kAPP14 = 0xFFEE;
     JpegSegment segment(data, len);
     if (!segment.read() || segment.marker() != kSOI) {
         return false;  // not a JPEG
     }
-    if (!segment.read() || segment.marker() != kAPP0) {
-        return false;  // not an APP0 segment
-    }
-    static const char kJfif[] = {'J', 'F', 'I', 'F', '\0'};
-    SkASSERT(segment.data());
-    if (SkToSizeT(segment.length()) < sizeof(kJfif) ||
-        0 != memcmp(segment.data(), kJfif, sizeof(kJfif))) {
-        return false;  // Not JFIF JPEG
+    if (!segment.read() || (segment.marker() & 0xFFF0) != kAPP0) {
+        return false;  // not an APPn segment
     }
+    // Like libjpeg, read the header through the start of the scan, and use the Adobe marker's
+    // transform flag, if there is one, to tell what the components are.
+    static const uint16_t kSOS = 0xFFDA;
+    static const char kAdobe[] = {'A', 'd', 'o', 'b', 'e'};
+    static const char kExif[] = {'E', 'x', 'i', 'f', '\0'};
+    int adobeTransform = -1;
+    SkEncodedOrigin exifOrientation = kTopLeft_SkEncodedOrigin;
+    const char* frame = nullptr;
+    uint16_t frameLength = 0;
     do {
+        if (segment.isSOF()) {
+            if (frame) {
+                return false;  // Only one frame is allowed.
+            }
+            frame = segment.data();
+            frameLength = segment.length();
+        } else if (segment.marker() == kAPP14 && segment.length() >= 12 &&
+                   0 == memcmp(segment.data(), kAdobe, sizeof(kAdobe))) {
+            adobeTransform = static_cast<uint8_t>(segment.data()[11]);
+        } else if (segment.marker() == kAPP1 && segment.length() >= 6 &&
+                   0 == memcmp(segment.data(), kExif, sizeof(kExif))) {
+            // Skip 'E', 'x', 'i', 'f', '\0', and the fill byte.
+            is_orientation_marker(reinterpret_cast<const uint8_t*>(segment.data()) + 6,
+                                  segment.length() - 6, &exifOrientation);
+        }
         if (!segment.read()) {
             return false;  // malformed JPEG
         }
-    } while (!segment.isSOF());
-    if (segment.length() < 6) {
+    } while (segment.marker() != kSOS);
+    if (!frame) {
+        return false;  // No SOF segment
+    }
+    if (frameLength < 6) {
         return false;  // SOF segment is short
     }
-    if (8 != segment.data()[0]) {
+    if (8 != frame[0]) {
         return false;  // Only support 8-bit precision
     }
-    int numberOfComponents = segment.data()[5];
-    if (numberOfComponents != 1 && numberOfComponents != 3) {
-        return false;  // Invalid JFIF
+    SkEncodedInfo::Color color;
+    switch (frame[5]) {
+        case 1:
+            color = SkEncodedInfo::kGray_Color;
+            break;
+        case 3:
+            color = adobeTransform == 0 ? SkEncodedInfo::kRGB_Color : SkEncodedInfo::kYUV_Color;
+            break;
+        case 4:
+            color = adobeTransform == 2 ? SkEncodedInfo::kYCCK_Color
+                                        : SkEncodedInfo::kInvertedCMYK_Color;
+            break;
+        default:
+            return false;  // Unknown color space.
     }
     if (size) {
-        *size = {JpegSegment::GetBigendianUint16(&segment.data()[3]),
-                 JpegSegment::GetBigendianUint16(&segment.data()[1])};
+        *size = {JpegSegment::GetBigendianUint16(&frame[3]),
+                 JpegSegment::GetBigendianUint16(&frame[1])};
     }
     if (colorType) {
-        *colorType = numberOfComponents == 3 ? SkEncodedInfo::kYUV_Color
-                                             : SkEncodedInfo::kGray_Color;
+        *colorType = color;
     }
     if (orientation) {
-        *orientation = kTopLeft_SkEncodedOrigin;
+        *orientation = exifOrientation;
     }
     return true;
 }
@@ -10,12 +10,17 @@
 #include "SkColorData.h"
 #include "SkData.h"
 #include "SkDeflate.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
+#include "SkJpegEncoder.h"
 #include "SkJpegInfo.h"
+#include "SkMD5.h"
 #include "SkPDFCanon.h"
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
+#include "SkTHash.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 #include "SkUnPreMultiply.h"
 
@@ -280,6 +285,7 @@ static void emit_image_xobject(SkWStream* stream,
                                const SkImage* image,
                                bool alpha,
                                const sk_sp<SkPDFObject>& smask,
+                               int compressionLevel,
                                const SkPDFObjNumMap& objNumMap) {
     SkBitmap bitmap;
     if (!SkPDFUtils::ToBitmap(image, &bitmap)) {
@@ -289,7 +295,7 @@ static void emit_image_xobject(SkWStream* stream,
 
     // Write to a temporary buffer to get the compressed length.
     SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
+    SkDeflateWStream deflateWStream(&buffer, compressionLevel);
     if (alpha) {
         bitmap_alpha_to_a8(bitmap, &deflateWStream);
     } else {
@@ -327,16 +333,18 @@ namespace {
 // This SkPDFObject only outputs the alpha layer of the given bitmap.
 class PDFAlphaBitmap final : public SkPDFObject {
 public:
-    PDFAlphaBitmap(sk_sp<SkImage> image) : fImage(std::move(image)) { SkASSERT(fImage); }
+    PDFAlphaBitmap(sk_sp<SkImage> image, int compressionLevel)
+        : fImage(std::move(image)), fCompressionLevel(compressionLevel) { SkASSERT(fImage); }
     void emitObject(SkWStream*  stream,
                     const SkPDFObjNumMap& objNumMap) const override {
         SkASSERT(fImage);
-        emit_image_xobject(stream, fImage.get(), true, nullptr, objNumMap);
+        emit_image_xobject(stream, fImage.get(), true, nullptr, fCompressionLevel, objNumMap);
     }
     void drop() override { fImage = nullptr; }
 
 private:
     sk_sp<SkImage> fImage;
+    int fCompressionLevel;
 };
 
 }  // namespace
@@ -349,18 +357,21 @@ public:
     void emitObject(SkWStream* stream,
                     const SkPDFObjNumMap& objNumMap) const override {
         SkASSERT(fImage);
-        emit_image_xobject(stream, fImage.get(), false, fSMask, objNumMap);
+        emit_image_xobject(stream, fImage.get(), false, fSMask, fCompressionLevel, objNumMap);
     }
     void addResources(SkPDFObjNumMap* catalog) const override {
         catalog->addObjectRecursively(fSMask.get());
     }
     void drop() override { fImage = nullptr; fSMask = nullptr; }
-    PDFDefaultBitmap(sk_sp<SkImage> image, sk_sp<SkPDFObject> smask)
-        : fImage(std::move(image)), fSMask(std::move(smask)) { SkASSERT(fImage); }
+    PDFDefaultBitmap(sk_sp<SkImage> image, sk_sp<SkPDFObject> smask, int compressionLevel)
+        : fImage(std::move(image))
+        , fSMask(std::move(smask))
+        , fCompressionLevel(compressionLevel) { SkASSERT(fImage); }
 
 private:
     sk_sp<SkImage> fImage;
     sk_sp<SkPDFObject> fSMask;
+    int fCompressionLevel;
 };
 }  // namespace
 
@@ -368,17 +379,17 @@ private:
 
 namespace {
 /**
- *  This PDFObject assumes that its constructor was handed YUV or
- *  Grayscale JFIF Jpeg-encoded data that can be directly embedded
- *  into a PDF.
+ *  This PDFObject assumes that its constructor was handed Grayscale,
+ *  YUV, RGB, CMYK or YCCK Jpeg-encoded data, baseline or progressive,
+ *  that can be directly embedded into a PDF.
  */
 class PDFJpegBitmap final : public SkPDFObject {
 public:
     SkISize fSize;
     sk_sp<SkData> fData;
-    bool fIsYUV;
-    PDFJpegBitmap(SkISize size, sk_sp<SkData> data, bool isYUV)
-        : fSize(size), fData(std::move(data)), fIsYUV(isYUV) { SkASSERT(fData); }
+    SkEncodedInfo::Color fColor;
+    PDFJpegBitmap(SkISize size, sk_sp<SkData> data, SkEncodedInfo::Color color)
+        : fSize(size), fData(std::move(data)), fColor(color) { SkASSERT(fData); }
     void emitObject(SkWStream*, const SkPDFObjNumMap&) const override;
     void drop() override { fData = nullptr; }
 };
@@ -390,14 +401,30 @@ void PDFJpegBitmap::emitObject(SkWStream* stream,
     pdfDict.insertName("Subtype", "Image");
     pdfDict.insertInt("Width", fSize.width());
     pdfDict.insertInt("Height", fSize.height());
-    if (fIsYUV) {
-        pdfDict.insertName("ColorSpace", "DeviceRGB");
-    } else {
-        pdfDict.insertName("ColorSpace", "DeviceGray");
+    int colorTransform = 0;
+    switch (fColor) {
+        case SkEncodedInfo::kGray_Color:
+            pdfDict.insertName("ColorSpace", "DeviceGray");
+            break;
+        case SkEncodedInfo::kYUV_Color:
+        case SkEncodedInfo::kRGB_Color:
+            pdfDict.insertName("ColorSpace", "DeviceRGB");
+            break;
+        case SkEncodedInfo::kYCCK_Color:
+            colorTransform = 1;
+            // fall through
+        case SkEncodedInfo::kInvertedCMYK_Color:
+            // Like SkJpegCodec, treat the ink as inverted, as Photoshop writes it.
+            pdfDict.insertName("ColorSpace", "DeviceCMYK");
+            pdfDict.insertObject("Decode", SkPDFMakeArray(1, 0, 1, 0, 1, 0, 1, 0));
+            break;
+        default:
+            SkASSERT(false);
+            break;
     }
     pdfDict.insertInt("BitsPerComponent", 8);
     pdfDict.insertName("Filter", "DCTDecode");
-    pdfDict.insertInt("ColorTransform", 0);
+    pdfDict.insertInt("ColorTransform", colorTransform);
     pdfDict.insertInt("Length", SkToInt(fData->size()));
     pdfDict.emitObject(stream, objNumMap);
     stream->writeText(kStreamBegin);
@@ -407,51 +434,145 @@ void PDFJpegBitmap::emitObject(SkWStream* stream,
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
-sk_sp<PDFJpegBitmap> make_jpeg_bitmap(sk_sp<SkData> data, SkISize size) {
+// Returns true if 'data' is a jpeg of 'size' that can be embedded as is.
+static bool is_embeddable_jpeg(const SkData* data, SkISize size, SkEncodedInfo::Color* color) {
     SkISize jpegSize;
-    SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
-    if (data && SkGetJpegInfo(data->data(), data->size(), &jpegSize,
-                              &jpegColorType, &exifOrientation)) {
-        bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
-        bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
-        if (jpegSize == size  // Sanity check.
+    if (data && SkGetJpegInfo(data->data(), data->size(), &jpegSize, color, &exifOrientation)) {
+        bool goodColorType = *color == SkEncodedInfo::kGray_Color ||
+                             *color == SkEncodedInfo::kYUV_Color ||
+                             *color == SkEncodedInfo::kRGB_Color ||
+                             *color == SkEncodedInfo::kInvertedCMYK_Color ||
+                             *color == SkEncodedInfo::kYCCK_Color;
+        return jpegSize == size  // Sanity check.
                 && goodColorType
-                && kTopLeft_SkEncodedOrigin == exifOrientation) {
-            // hold on to data, not image.
-            #ifdef SK_PDF_IMAGE_STATS
-            gJpegImageObjects.fetch_add(1);
-            #endif
-            return sk_make_sp<PDFJpegBitmap>(jpegSize, std::move(data), yuv);
-        }
+                && kTopLeft_SkEncodedOrigin == exifOrientation;
+    }
+    return false;
+}
+
+sk_sp<PDFJpegBitmap> make_jpeg_bitmap(sk_sp<SkData> data, SkISize size) {
+    SkEncodedInfo::Color color;
+    if (is_embeddable_jpeg(data.get(), size, &color)) {
+        // hold on to data, not image.
+        #ifdef SK_PDF_IMAGE_STATS
+        gJpegImageObjects.fetch_add(1);
+        #endif
+        return sk_make_sp<PDFJpegBitmap>(size, std::move(data), color);
     }
     return nullptr;
 }
 
-sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage> image, int encodingQuality) {
+// Returns true if the pixels look like a photograph, which DCT compresses far smaller than
+// flate does, rather than like text, line art or a screenshot, which flate keeps sharp and
+// usually compresses smaller. It only looks at a sparse grid of pixels, so it is cheap.
+static bool looks_photographic(const SkPixmap& pixmap) {
+    constexpr int kSamplesPerSide = 64;
+    constexpr int kPhotographicColors = 256;
+    const int dx = SkTMax(1, pixmap.width() / kSamplesPerSide);
+    const int dy = SkTMax(1, pixmap.height() / kSamplesPerSide);
+    SkTHashSet<SkColor> colors;
+    int samples = 0, flat = 0;
+    for (int y = 0; y < pixmap.height(); y += dy) {
+        for (int x = 0; x + 1 < pixmap.width(); x += dx) {
+            SkColor color = pixmap.getColor(x, y);
+            // Flat fills and hard edges make runs of identical neighbors; photographs rarely do.
+            flat += color == pixmap.getColor(x + 1, y);
+            ++samples;
+            if (colors.count() < kPhotographicColors) {
+                colors.add(color);
+            }
+        }
+    }
+    return colors.count() >= kPhotographicColors && 2 * flat < samples;
+}
+
+// Returns a jpeg of the image if it looks photographic, or nullptr if flate suits it better.
+// With an executor, the image is encoded while it is being classified.
+static sk_sp<PDFJpegBitmap> make_encoded_jpeg_bitmap(const SkImage* image, int encodingQuality,
+                                                     SkExecutor* executor) {
+    SkBitmap bitmap;
+    SkPixmap pixmap;
+    if (!SkPDFUtils::ToBitmap(image, &bitmap) || !bitmap.peekPixels(&pixmap)) {
+        return nullptr;
+    }
+    sk_sp<SkData> data;
+    auto encode = [&]() {
+        SkDynamicMemoryWStream buffer;
+        SkJpegEncoder::Options options;
+        options.fQuality = encodingQuality;
+        if (SkJpegEncoder::Encode(&buffer, pixmap, options)) {
+            data = buffer.detachAsData();
+        }
+    };
+    bool photographic;
+    if (executor) {
+        SkTaskGroup group(*executor);
+        group.add(encode);
+        photographic = looks_photographic(pixmap);
+        group.wait();
+    } else {
+        photographic = looks_photographic(pixmap);
+        if (photographic) {
+            encode();
+        }
+    }
+    return photographic ? make_jpeg_bitmap(std::move(data), image->dimensions()) : nullptr;
+}
+
+sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage> image, int encodingQuality,
+                                           int compressionLevel, SkExecutor* executor) {
     SkASSERT(image);
     SkASSERT(encodingQuality >= 0);
-    SkISize dimensions = image->dimensions();
     sk_sp<SkData> data = image->refEncodedData();
-    if (auto jpeg = make_jpeg_bitmap(std::move(data), dimensions)) {
+    if (auto jpeg = make_jpeg_bitmap(std::move(data), image->dimensions())) {
         return std::move(jpeg);
     }
 
     const bool isOpaque = image_compute_is_opaque(image.get());
 
     if (encodingQuality <= 100 && isOpaque) {
-        data = image->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality);
-        if (auto jpeg = make_jpeg_bitmap(std::move(data), dimensions)) {
+        if (auto jpeg = make_encoded_jpeg_bitmap(image.get(), encodingQuality, executor)) {
             return std::move(jpeg);
         }
     }
 
     sk_sp<SkPDFObject> smask;
     if (!isOpaque) {
-        smask = sk_make_sp<PDFAlphaBitmap>(image);
+        smask = sk_make_sp<PDFAlphaBitmap>(image, compressionLevel);
     }
     #ifdef SK_PDF_IMAGE_STATS
     gRegularImageObjects.fetch_add(1);
     #endif
-    return sk_make_sp<PDFDefaultBitmap>(std::move(image), std::move(smask));
+    return sk_make_sp<PDFDefaultBitmap>(std::move(image), std::move(smask), compressionLevel);
+}
+
+bool SkPDFImageDigest(const SkImage* image, SkMD5::Digest* digest) {
+    SkASSERT(image);
+    SkMD5 md5;
+    const int32_t dimensions[] = { image->width(), image->height() };
+    md5.write(dimensions, sizeof(dimensions));
+
+    // A jpeg that is embedded as is is identified by its bytes, without decoding it.
+    sk_sp<SkData> data = image->refEncodedData();
+    SkEncodedInfo::Color color;
+    if (is_embeddable_jpeg(data.get(), image->dimensions(), &color)) {
+        md5.write8(1);
+        md5.write(data->data(), data->size());
+        md5.finish(*digest);
+        return true;
+    }
+
+    SkBitmap bitmap;
+    if (!SkPDFUtils::ToBitmap(image, &bitmap)) {
+        return false;
+    }
+    const uint8_t info[] = { 0, SkToU8(bitmap.colorType()), SkToU8(bitmap.alphaType()) };
+    md5.write(info, sizeof(info));
+    const size_t rowBytes = bitmap.info().minRowBytes();
+    for (int y = 0; y < bitmap.height(); ++y) {
+        md5.write(bitmap.getAddr(0, y), rowBytes);
+    }
+    md5.finish(*digest);
+    return true;
 }
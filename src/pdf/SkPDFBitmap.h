@@ -7,8 +7,10 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "SkMD5.h"
 #include "SkRefCnt.h"
 
+class SkExecutor;
 class SkImage;
 class SkPDFObject;
 
@@ -17,8 +19,24 @@ class SkPDFObject;
  * It is designed to use a minimal amout of memory, aside from refing
  * the image, and its emitObject() does not cache any data.
  *
- *  quality > 100 means lossless
+ *  quality > 100 means lossless. Otherwise, opaque images that look
+ *  photographic and aren't already embeddable jpegs are jpeg-encoded with
+ *  that quality; the rest are compressed losslessly.
+ *
+ *  compressionLevel is as for SkDeflateWStream.
+ *
+ *  If executor is not null, jpeg encoding runs on it while the image is
+ *  being classified.
+ */
+sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage>, int encodingQuality = 101,
+                                           int compressionLevel = -1,
+                                           SkExecutor* executor = nullptr);
+
+/**
+ *  Computes a digest of what SkPDFCreateBitmapObject() would embed for the
+ *  image: the bytes of a jpeg it embeds as is, or else its pixels. Returns
+ *  false if the pixels can't be read.
  */
-sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage>, int encodingQuality = 101);
+bool SkPDFImageDigest(const SkImage*, SkMD5::Digest*);
 
 #endif  // SkPDFBitmap_DEFINED
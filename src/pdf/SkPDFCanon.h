@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "SkBitmapKey.h"
+#include "SkMD5.h"
 #include "SkMacros.h"
 #include "SkPDFGradientShader.h"
 #include "SkPDFGraphicState.h"
@@ -39,6 +40,8 @@ public:
     SkPDFGradientShader::HashMap fGradientPatternMap;
 
     SkTHashMap<SkBitmapKey, sk_sp<SkPDFObject>> fPDFBitmapMap;
+    // Only filled in with SkPDF::Metadata::fDeduplicateImages.
+    SkTHashMap<SkMD5::Digest, sk_sp<SkPDFObject>> fPDFBitmapDigestMap;
 
     SkTHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
     SkTHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
@@ -42,6 +42,7 @@
 #include "SkScopeExit.h"
 #include "SkString.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTextBlob.h"
 #include "SkTextFormatParams.h"
@@ -62,6 +63,13 @@
     // encoding.
 #endif
 
+#ifndef SK_PDF_RASTER_TILE_SIZE
+    // Features PDF can't express are rasterized in tiles at most this many
+    // pixels on a side, each one its own image, so that memory use doesn't
+    // grow with the raster DPI.
+    #define SK_PDF_RASTER_TILE_SIZE 1024
+#endif
+
 // Utility functions
 
 static SkPath to_path(const SkRect& r) {
@@ -1461,7 +1469,8 @@ sk_sp<SkPDFObject> SkPDFDevice::makeFormXObjectFromDevice(bool alpha) {
     sk_sp<SkPDFObject> xobject =
         SkPDFMakeFormXObject(this->content(),
                              SkPDFMakeArray(0, 0, this->width(), this->height()),
-                             this->makeResourceDict(), inverseTransform, colorSpace);
+                             this->makeResourceDict(), inverseTransform, colorSpace,
+                             fDocument->compressionLevel());
     // We always draw the form xobjects that we create back into the device, so
     // we simply preserve the font usage instead of pulling it out and merging
     // it back in later.
@@ -1948,13 +1957,6 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
 
         SkISize wh = rect_to_size(physicalPerspectiveBounds).toCeil();
 
-        auto surface = SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(wh));
-        if (!surface) {
-            return;
-        }
-        SkCanvas* canvas = surface->getCanvas();
-        canvas->clear(SK_ColorTRANSPARENT);
-
         SkScalar deltaX = bounds.left();
         SkScalar deltaY = bounds.top();
 
@@ -1962,22 +1964,21 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
         offsetMatrix.postTranslate(-deltaX, -deltaY);
         offsetMatrix.postScale(scaleX, scaleY);
 
-        // Translate the draw in the new canvas, so we perfectly fit the
-        // shape in the bitmap.
-        canvas->setMatrix(offsetMatrix);
-        canvas->drawImage(imageSubset.image(), 0, 0);
-        // Make sure the final bits are in the bitmap.
-        canvas->flush();
-
         // In the new space, we use the identity matrix translated
         // and scaled to reflect DPI.
-        matrix.setScale(1 / scaleX, 1 / scaleY);
-        matrix.postTranslate(deltaX, deltaY);
+        SkMatrix rasterToDevice = SkMatrix::MakeScale(1 / scaleX, 1 / scaleY);
+        rasterToDevice.postTranslate(deltaX, deltaY);
 
-        imageSubset = SkKeyedImage(surface->makeImageSnapshot());
-        if (!imageSubset) {
-            return;
-        }
+        // Translate the draw in the new canvas, so we perfectly fit the
+        // shape in the bitmap.
+        sk_sp<SkImage> image = imageSubset.image();
+        this->drawRasterTiles(wh,
+                              [&](SkCanvas* canvas) {
+                                  canvas->concat(offsetMatrix);
+                                  canvas->drawImage(image, 0, 0);
+                              },
+                              rasterToDevice, paint);
+        return;
     }
 
     SkMatrix scaled;
@@ -2017,18 +2018,87 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     sk_sp<SkPDFObject> pdfimage = pdfimagePtr ? *pdfimagePtr : nullptr;
     if (!pdfimage) {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFCreateBitmapObject(imageSubset.release(),
-                                           fDocument->metadata().fEncodingQuality);
+        // Different images with the same contents can share an image XObject.
+        SkMD5::Digest digest;
+        const bool hasDigest = fDocument->metadata().fDeduplicateImages &&
+                               SkPDFImageDigest(imageSubset.image().get(), &digest);
+        if (hasDigest) {
+            if (sk_sp<SkPDFObject>* found =
+                        fDocument->canon()->fPDFBitmapDigestMap.find(digest)) {
+                pdfimage = *found;
+            }
+        }
         if (!pdfimage) {
-            return;
+            pdfimage = SkPDFCreateBitmapObject(imageSubset.release(),
+                                               fDocument->metadata().fEncodingQuality,
+                                               fDocument->compressionLevel(),
+                                               fDocument->metadata().fExecutor);
+            if (!pdfimage) {
+                return;
+            }
+            fDocument->serialize(pdfimage);  // serialize images early.
+            if (hasDigest) {
+                fDocument->canon()->fPDFBitmapDigestMap.set(digest, pdfimage);
+            }
         }
-        fDocument->serialize(pdfimage);  // serialize images early.
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
         fDocument->canon()->fPDFBitmapMap.set(key, pdfimage);
     }
     this->drawFormXObject(std::move(pdfimage), content.stream());
 }
 
+void SkPDFDevice::drawRasterTiles(SkISize size,
+                                  const std::function<void(SkCanvas*)>& draw,
+                                  const SkMatrix& rasterToDevice,
+                                  const SkPaint& paint) {
+    std::vector<SkIRect> tiles;
+    for (int y = 0; y < size.height(); y += SK_PDF_RASTER_TILE_SIZE) {
+        for (int x = 0; x < size.width(); x += SK_PDF_RASTER_TILE_SIZE) {
+            tiles.push_back(SkIRect::MakeLTRB(x, y,
+                                              SkTMin(x + SK_PDF_RASTER_TILE_SIZE, size.width()),
+                                              SkTMin(y + SK_PDF_RASTER_TILE_SIZE, size.height())));
+        }
+    }
+    auto rasterize = [&draw](const SkIRect& tile) -> sk_sp<SkImage> {
+        auto surface = SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(tile.size()));
+        if (!surface) {
+            return nullptr;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(SK_ColorTRANSPARENT);
+        canvas->translate(-SkIntToScalar(tile.x()), -SkIntToScalar(tile.y()));
+        draw(canvas);
+        // Make sure the final bits are in the bitmap.
+        canvas->flush();
+        return surface->makeImageSnapshot();
+    };
+
+    // With an executor, a few tiles are rasterized at once. Each batch is drawn, and its images
+    // serialized, before the next is rasterized, so memory stays bounded either way.
+    constexpr size_t kTilesPerBatch = 4;
+    SkExecutor* executor = fDocument->metadata().fExecutor;
+    const size_t batchSize = executor ? kTilesPerBatch : 1;
+    std::vector<sk_sp<SkImage>> images(batchSize);
+    for (size_t start = 0; start < tiles.size(); start += batchSize) {
+        const int count = SkToInt(SkTMin(batchSize, tiles.size() - start));
+        if (executor && count > 1) {
+            SkTaskGroup(*executor).batch(count, [&](int i) {
+                images[i] = rasterize(tiles[start + i]);
+            });
+        } else {
+            for (int i = 0; i < count; ++i) {
+                images[i] = rasterize(tiles[start + i]);
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            if (images[i]) {
+                this->internalDrawImageRect(SkKeyedImage(std::move(images[i])), nullptr,
+                                            SkRect::Make(tiles[start + i]), paint, rasterToDevice);
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SkSpecialImage.h"
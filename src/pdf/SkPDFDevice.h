@@ -20,6 +20,7 @@
 #include "SkTextBlobPriv.h"
 #include "SkKeyedImage.h"
 
+#include <functional>
 #include <vector>
 
 class SkGlyphRunList;
@@ -231,6 +232,13 @@ private:
                                const SkPaint&,
                                const SkMatrix& canvasTransformationMatrix);
 
+    // Rasterizes 'draw' into a 'size' raster, one tile at a time, and draws each tile as its own
+    // image, mapped into the device by 'rasterToDevice'.
+    void drawRasterTiles(SkISize size,
+                         const std::function<void(SkCanvas*)>& draw,
+                         const SkMatrix& rasterToDevice,
+                         const SkPaint&);
+
     void internalDrawPath(const SkClipStack&,
                           const SkMatrix&,
                           const SkPath&,
@@ -14,8 +14,10 @@
 #include "SkPDFTag.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 
+#include <atomic>
 #include <utility>
 
 // For use in SkCanvas::drawAnnotation
@@ -24,18 +26,26 @@ const char* SkPDFGetNodeIdKey() {
     return key;
 }
 
-SkPDFObjectSerializer::SkPDFObjectSerializer() : fBaseOffset(0), fNextToBeSerialized(0) {}
+struct SkPDFObjectSerializer::PendingObject {
+    SkPDFObject* fObject;
+    int32_t fObjectNumber;
+    SkDynamicMemoryWStream fEmitted;
+    std::atomic<bool> fDone{false};
+};
+
+SkPDFObjectSerializer::SkPDFObjectSerializer()
+    : fBaseOffset(0), fNextToBeSerialized(0), fExecutor(nullptr) {}
 
 SkPDFObjectSerializer::~SkPDFObjectSerializer() {
+    if (fTaskGroup) {
+        // The pending objects must not be dropped while they are emitted.
+        fTaskGroup->wait();
+    }
     for (const sk_sp<SkPDFObject>& obj: fObjNumMap.objects()) {
         obj->drop();
     }
 }
 
-SkPDFObjectSerializer::SkPDFObjectSerializer(SkPDFObjectSerializer&&) = default;
-
-SkPDFObjectSerializer& SkPDFObjectSerializer::operator=(SkPDFObjectSerializer&&) = default;
-
 void SkPDFObjectSerializer::addObjectRecursively(const sk_sp<SkPDFObject>& object) {
     fObjNumMap.addObjectRecursively(object.get());
 }
@@ -50,6 +60,10 @@ static_assert((SKPDF_MAGIC[3] & 0x7F) == "Skia"[3], "");
 void SkPDFObjectSerializer::serializeHeader(SkWStream* wStream,
                                             const SkPDF::Metadata& md) {
     fBaseOffset = wStream->bytesWritten();
+    fExecutor = md.fExecutor;
+    if (fExecutor) {
+        fTaskGroup = skstd::make_unique<SkTaskGroup>(*fExecutor);
+    }
     static const char kHeader[] = "%PDF-1.4\n%" SKPDF_MAGIC "\n";
     wStream->writeText(kHeader);
     // The PDF spec recommends including a comment with four
@@ -62,24 +76,79 @@ void SkPDFObjectSerializer::serializeHeader(SkWStream* wStream,
 #undef SKPDF_MAGIC
 
 // Serialize all objects in the fObjNumMap that have not yet been serialized;
+// with an executor, start emitting them, and write out those that are done.
 void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream) {
     const std::vector<sk_sp<SkPDFObject>>& objects = fObjNumMap.objects();
     while (fNextToBeSerialized < objects.size()) {
         SkPDFObject* object = objects[fNextToBeSerialized].get();
-        // Maximum number of indirect objects is 2^23-1.
-        int32_t index = SkToS32(fNextToBeSerialized + 1);  // Skip object 0.
-        // "The first entry in the [XREF] table (object number 0) is
-        // always free and has a generation number of 65,535; it is
-        // the head of the linked list of free objects."
-        SkASSERT(fOffsets.size() == fNextToBeSerialized);
-        fOffsets.push_back(this->offset(wStream));
-        wStream->writeDecAsText(index);
-        wStream->writeText(" 0 obj\n");  // Generation number is always 0.
-        object->emitObject(wStream, fObjNumMap);
-        wStream->writeText("\nendobj\n");
-        object->drop();
         ++fNextToBeSerialized;
+        // Deferred objects are serialized by serializeDeferredObjects().
+        if (!fObjNumMap.isDeferred(object)) {
+            this->serializeObject(wStream, object, SkToS32(fNextToBeSerialized));
+        }
+    }
+    // Don't let emitted objects pile up in memory behind a slow one.
+    static constexpr size_t kMaxPendingObjects = 256;
+    this->writePendingObjects(wStream, fPendingObjects.size() > kMaxPendingObjects);
+}
+
+void SkPDFObjectSerializer::serializeDeferredObjects(SkWStream* wStream) {
+    std::vector<SkPDFObject*> deferred = fObjNumMap.undeferObjects();
+    this->serializeObjects(wStream);
+    for (SkPDFObject* object : deferred) {
+        this->serializeObject(wStream, object, fObjNumMap.getObjectNumber(object));
+    }
+}
+
+void SkPDFObjectSerializer::serializeObject(SkWStream* wStream, SkPDFObject* object,
+                                            int32_t objectNumber) {
+    if (!fExecutor) {
+        this->writeObject(wStream, object, objectNumber, nullptr);
+        return;
+    }
+    fPendingObjects.emplace_back(new PendingObject{object, objectNumber});
+    PendingObject* pending = fPendingObjects.back().get();
+    fTaskGroup->add([this, pending]() {
+        pending->fObject->emitObject(&pending->fEmitted, fObjNumMap);
+        pending->fDone.store(true, std::memory_order_release);
+    });
+}
+
+void SkPDFObjectSerializer::writePendingObjects(SkWStream* wStream, bool wait) {
+    if (wait && fTaskGroup) {
+        fTaskGroup->wait();
+    }
+    while (!fPendingObjects.empty() &&
+           fPendingObjects.front()->fDone.load(std::memory_order_acquire)) {
+        PendingObject* pending = fPendingObjects.front().get();
+        this->writeObject(wStream, pending->fObject, pending->fObjectNumber,
+                          &pending->fEmitted);
+        fPendingObjects.pop_front();
+    }
+}
+
+void SkPDFObjectSerializer::writeObject(SkWStream* wStream, SkPDFObject* object,
+                                        int32_t objectNumber, SkDynamicMemoryWStream* emitted) {
+    // Maximum number of indirect objects is 2^23-1.
+    // "The first entry in the [XREF] table (object number 0) is
+    // always free and has a generation number of 65,535; it is
+    // the head of the linked list of free objects."
+    SkASSERT(objectNumber > 0);
+    // Deferred objects are written after objects numbered after them.
+    if (fOffsets.size() < SkToSizeT(objectNumber)) {
+        fOffsets.resize(objectNumber, 0);
+    }
+    SkASSERT(0 == fOffsets[objectNumber - 1]);
+    fOffsets[objectNumber - 1] = this->offset(wStream);
+    wStream->writeDecAsText(objectNumber);
+    wStream->writeText(" 0 obj\n");  // Generation number is always 0.
+    if (emitted) {
+        emitted->writeToAndReset(wStream);
+    } else {
+        object->emitObject(wStream, fObjNumMap);
     }
+    wStream->writeText("\nendobj\n");
+    object->drop();
 }
 
 // Xref table and footer
@@ -87,6 +156,9 @@ void SkPDFObjectSerializer::serializeFooter(SkWStream* wStream,
                                             const sk_sp<SkPDFObject> docCatalog,
                                             sk_sp<SkPDFObject> id) {
     this->serializeObjects(wStream);
+    this->writePendingObjects(wStream, true);
+    SkASSERT(fPendingObjects.empty());
+    SkASSERT(fOffsets.size() == fObjNumMap.objects().size());
     int32_t xRefFileOffset = this->offset(wStream);
     // Include the special zeroth object in the count.
     int32_t objCount = SkToS32(fOffsets.size() + 1);
@@ -193,9 +265,7 @@ SkPDFDocument::SkPDFDocument(SkWStream* stream,
         fInverseRasterScale = kDpiForRasterScaleOne / fMetadata.fRasterDPI;
         fRasterScale        = fMetadata.fRasterDPI / kDpiForRasterScaleOne;
     }
-    if (fMetadata.fStructureElementTreeRoot) {
-        fTagRoot = recursiveBuildTagTree(*fMetadata.fStructureElementTreeRoot, nullptr);
-    }
+    fTagTree.init(fMetadata.fStructureElementTreeRoot);
 }
 
 SkPDFDocument::~SkPDFDocument() {
@@ -255,13 +325,23 @@ void SkPDFDocument::onEndPage() {
     auto page = sk_make_sp<SkPDFDict>("Page");
 
     SkSize mediaSize = fPageDevice->imageInfo().dimensions() * fInverseRasterScale;
-    auto contentObject = sk_make_sp<SkPDFStream>(fPageDevice->content());
+    // With an executor, the content is compressed on it as it is serialized.
+    auto contentObject = fMetadata.fExecutor
+            ? SkPDFStream::MakeDeferred(fPageDevice->content(), this->compressionLevel())
+            : sk_make_sp<SkPDFStream>(fPageDevice->content(), this->compressionLevel());
     auto resourceDict = fPageDevice->makeResourceDict();
     auto annotations = fPageDevice->getAnnotations();
     fPageDevice->appendDestinations(fDests.get(), page.get());
     fPageDevice = nullptr;
 
-    page->insertObject("Resources", resourceDict);
+    if (fMetadata.fStreaming) {
+        // Write the resources out now, so only the page's reference to them
+        // is kept until close. Fonts are deferred until then.
+        page->insertObjRef("Resources", resourceDict);
+        this->serialize(resourceDict);
+    } else {
+        page->insertObject("Resources", resourceDict);
+    }
     page->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
 
     if (annotations) {
@@ -272,21 +352,39 @@ void SkPDFDocument::onEndPage() {
     // The StructParents unique identifier for each page is just its
     // 0-based page index.
     page->insertInt("StructParents", static_cast<int>(fPages.size()));
+    if (fMetadata.fStreaming) {
+        // Write the page's part of the parent tree now. The tags it
+        // refers to are only written at close, once they're complete.
+        if (sk_sp<SkPDFArray> marks = fTagTree.finishPage(SkToUInt(fPages.size()),
+                                                          &fObjectSerializer.fObjNumMap)) {
+            this->serialize(marks);
+        }
+    }
     fPages.emplace_back(std::move(page));
 }
 
+void SkPDFDocument::registerFont(SkPDFFont* font) {
+    fFonts.add(font);
+    if (fMetadata.fStreaming) {
+        // Later pages may use more of the font's glyphs, so it can't be
+        // subset and written until the document closes.
+        fObjectSerializer.fObjNumMap.deferObject(font);
+    }
+}
+
 void SkPDFDocument::onAbort() {
     this->reset();
 }
 
 void SkPDFDocument::reset() {
-    fObjectSerializer = SkPDFObjectSerializer();
+    reset_object(&fObjectSerializer);
     fCanon = SkPDFCanon();
     reset_object(&fCanvas);
     fPages = std::vector<sk_sp<SkPDFDict>>();
     fFonts.reset();
     fDests = nullptr;
     fPageDevice = nullptr;
+    fTagTree.reset();
     fID = nullptr;
     fXMP = nullptr;
     fMetadata = SkPDF::Metadata();
@@ -448,31 +546,7 @@ sk_sp<SkPDFDict> SkPDFDocument::getPage(int pageIndex) const {
 }
 
 int SkPDFDocument::getMarkIdForNodeId(int nodeId) {
-    sk_sp<SkPDFTag>* tagPtr = fNodeIdToTag.find(nodeId);
-    if (tagPtr == nullptr) {
-        return -1;
-    }
-
-    sk_sp<SkPDFTag> tag = *tagPtr;
-    int pageIndex = static_cast<int>(fPages.size());
-    while (fMarksPerPage.count() < pageIndex + 1) {
-        fMarksPerPage.push_back();
-    }
-    int markId = fMarksPerPage[pageIndex].count();
-    tag->addMarkedContent(pageIndex, markId);
-    fMarksPerPage[pageIndex].push_back(std::move(tag));
-    return markId;
-}
-
-sk_sp<SkPDFTag> SkPDFDocument::recursiveBuildTagTree(
-        const SkPDF::StructureElementNode& node, sk_sp<SkPDFTag> parent) {
-    sk_sp<SkPDFTag> tag = sk_make_sp<SkPDFTag>(node.fNodeId, node.fType, parent);
-    fNodeIdToTag.set(tag->fNodeId, tag);
-    tag->fChildren.reserve(node.fChildCount);
-    for (size_t i = 0; i < node.fChildCount; i++) {
-        tag->appendChild(recursiveBuildTagTree(node.fChildren[i], tag));
-    }
-    return tag;
+    return fTagTree.getMarkIdForNodeId(nodeId, SkToUInt(fPages.size()));
 }
 
 void SkPDFDocument::onClose(SkWStream* stream) {
@@ -498,55 +572,32 @@ void SkPDFDocument::onClose(SkWStream* stream) {
     }
 
     // Handle tagged PDFs.
-    if (fTagRoot) {
+    if (sk_sp<SkPDFDict> structTreeRoot = fTagTree.makeStructTreeRoot(this)) {
         // In the document catalog, indicate that this PDF is tagged.
         auto markInfo = sk_make_sp<SkPDFDict>("MarkInfo");
         markInfo->insertBool("Marked", true);
         docCatalog->insertObject("MarkInfo", markInfo);
-
-        // Prepare the tag tree, this automatically skips over any
-        // tags that weren't referenced from any marked content.
-        bool success = fTagRoot->prepareTagTreeToEmit(*this);
-        if (!success) {
-            SkDEBUGFAIL("PDF has tag tree but no marked content.");
-        }
-
-        // Build the StructTreeRoot.
-        auto structTreeRoot = sk_make_sp<SkPDFDict>("StructTreeRoot");
-        docCatalog->insertObjRef("StructTreeRoot", structTreeRoot);
-        structTreeRoot->insertObjRef("K", fTagRoot);
-        int pageCount = static_cast<int>(fPages.size());
-        structTreeRoot->insertInt("ParentTreeNextKey", pageCount);
-
-        // The parent of the tag root is the StructTreeRoot.
-        fTagRoot->insertObjRef("P", structTreeRoot);
-
-        // Build the parent tree, which is a mapping from the marked
-        // content IDs on each page to their corressponding tags.
-        auto parentTree = sk_make_sp<SkPDFDict>("ParentTree");
-        structTreeRoot->insertObjRef("ParentTree", parentTree);
-        structTreeRoot->insertInt("ParentTreeNextKey", pageCount);
-        auto parentTreeNums = sk_make_sp<SkPDFArray>();
-        parentTree->insertObject("Nums", parentTreeNums);
-        for (int pageIndex = 0; pageIndex < pageCount; pageIndex++) {
-            // Exit now if there are no more pages with marked content.
-            if (fMarksPerPage.count() <= pageIndex) {
-                break;
-            }
-
-            parentTreeNums->appendInt(pageIndex);
-            auto markToTagArray = sk_make_sp<SkPDFArray>();
-            parentTreeNums->appendObjRef(markToTagArray);
-
-            for (int i = 0; i < fMarksPerPage[pageIndex].count(); i++) {
-                markToTagArray->appendObjRef(fMarksPerPage[pageIndex][i]);
-            }
-        }
+        docCatalog->insertObjRef("StructTreeRoot", std::move(structTreeRoot));
     }
 
     // Build font subsetting info before calling addObjectRecursively().
     SkPDFCanon* canon = &fCanon;
-    fFonts.foreach([canon](SkPDFFont* p){ p->getFontSubset(canon); });
+    if (fMetadata.fExecutor) {
+        // Subsetting only reads the metrics and unicode maps from the canon,
+        // so fill those in first, and then subset each font on the executor.
+        std::vector<SkPDFFont*> fonts;
+        fFonts.foreach([canon, &fonts](SkPDFFont* p) {
+            SkPDFFont::GetMetrics(p->typeface(), canon);
+            SkPDFFont::GetUnicodeMap(p->typeface(), canon);
+            fonts.push_back(p);
+        });
+        SkTaskGroup(*fMetadata.fExecutor).batch(SkToInt(fonts.size()), [canon, &fonts](int i) {
+            fonts[i]->getFontSubset(canon);
+        });
+    } else {
+        fFonts.foreach([canon](SkPDFFont* p){ p->getFontSubset(canon); });
+    }
+    fObjectSerializer.serializeDeferredObjects(this->getStream());
     fObjectSerializer.addObjectRecursively(docCatalog);
     fObjectSerializer.serializeObjects(this->getStream());
     fObjectSerializer.serializeFooter(this->getStream(), docCatalog, fID);
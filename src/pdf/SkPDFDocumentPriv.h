@@ -12,33 +12,57 @@
 #include "SkPDFCanon.h"
 #include "SkPDFFont.h"
 #include "SkPDFMetadata.h"
+#include "SkPDFTag.h"
 
+#include <deque>
+
+class SkExecutor;
 class SkPDFDevice;
-class SkPDFTag;
+class SkTaskGroup;
 
 const char* SkPDFGetNodeIdKey();
 
 // Logically part of SkPDFDocument (like SkPDFCanon), but separate to
 // keep similar functionality together.
 struct SkPDFObjectSerializer {
+    // An object being emitted on the executor.
+    struct PendingObject;
+
     SkPDFObjNumMap fObjNumMap;
     std::vector<int32_t> fOffsets;
     sk_sp<SkPDFObject> fInfoDict;
     size_t fBaseOffset;
     size_t fNextToBeSerialized;  // index in fObjNumMap
+    // With an executor, objects are emitted on it as they are serialized, and
+    // written out in order once emitted, so that their numbers and offsets
+    // are the same as without one.
+    SkExecutor* fExecutor;
+    std::unique_ptr<SkTaskGroup> fTaskGroup;
+    std::deque<std::unique_ptr<PendingObject>> fPendingObjects;
 
     SkPDFObjectSerializer();
     ~SkPDFObjectSerializer();
-    SkPDFObjectSerializer(SkPDFObjectSerializer&&);
-    SkPDFObjectSerializer& operator=(SkPDFObjectSerializer&&);
     SkPDFObjectSerializer(const SkPDFObjectSerializer&) = delete;
     SkPDFObjectSerializer& operator=(const SkPDFObjectSerializer&) = delete;
 
     void addObjectRecursively(const sk_sp<SkPDFObject>&);
     void serializeHeader(SkWStream*, const SkPDF::Metadata&);
     void serializeObjects(SkWStream*);
+    // Serializes the objects deferred by fObjNumMap, and their dependencies.
+    void serializeDeferredObjects(SkWStream*);
     void serializeFooter(SkWStream*, const sk_sp<SkPDFObject>, sk_sp<SkPDFObject>);
     int32_t offset(SkWStream*);
+
+private:
+    // Writes 'object' now, or with an executor, starts emitting it.
+    void serializeObject(SkWStream*, SkPDFObject* object, int32_t objectNumber);
+    // Writes out pending objects that have been emitted, in order. If 'wait'
+    // is true, first waits for all of them to be.
+    void writePendingObjects(SkWStream*, bool wait);
+    // Writes 'object' as indirect object 'objectNumber'. If 'emitted' is not
+    // nullptr, it holds the object already emitted.
+    void writeObject(SkWStream*, SkPDFObject* object, int32_t objectNumber,
+                     SkDynamicMemoryWStream* emitted);
 };
 
 /** Concrete implementation of SkDocument that creates PDF files. This
@@ -64,16 +88,17 @@ public:
      */
     void serialize(const sk_sp<SkPDFObject>&);
     SkPDFCanon* canon() { return &fCanon; }
-    void registerFont(SkPDFFont* f) { fFonts.add(f); }
+    void registerFont(SkPDFFont* f);
     const SkPDF::Metadata& metadata() const { return fMetadata; }
+    // As for SkDeflateWStream.
+    int compressionLevel() const { return static_cast<int>(fMetadata.fCompressionLevel); }
 
     sk_sp<SkPDFDict> getPage(int pageIndex) const;
+    size_t pageCount() const { return fPages.size(); }
     // Returns -1 if no mark ID.
     int getMarkIdForNodeId(int nodeId);
 
 private:
-    sk_sp<SkPDFTag> recursiveBuildTagTree(const SkPDF::StructureElementNode& node,
-                                          sk_sp<SkPDFTag> parent);
 
     SkPDFObjectSerializer fObjectSerializer;
     SkPDFCanon fCanon;
@@ -89,13 +114,7 @@ private:
     SkScalar fInverseRasterScale = 1;
 
     // For tagged PDFs.
-
-    // The tag root, which owns its child tags and so on.
-    sk_sp<SkPDFTag> fTagRoot;
-    // Array of page -> array of marks mapping to tags.
-    SkTArray<SkTArray<sk_sp<SkPDFTag>>> fMarksPerPage;
-    // A mapping from node ID to tag for fast lookup.
-    SkTHashMap<int, sk_sp<SkPDFTag>> fNodeIdToTag;
+    SkPDFTagTree fTagTree;
 
     void reset();
 };
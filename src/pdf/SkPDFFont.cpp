@@ -19,6 +19,7 @@
 #include "SkPDFMakeCIDGlyphWidthsArray.h"
 #include "SkPDFMakeToUnicodeCmap.h"
 #include "SkPDFResourceDict.h"
+#include "SkPDFSubsetFontCache.h"
 #include "SkPDFUtils.h"
 #include "SkPaint.h"
 #include "SkRefCnt.h"
@@ -334,8 +335,9 @@ void SkPDFType0Font::emitObject(SkWStream* stream,
 #endif
 
 #ifdef SK_PDF_USE_SFNTLY
-// if possible, make no copy.
-static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
+// if possible, make no copy.  Copies are cached, so the next document using this font
+// doesn't read it again.
+static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream, SkFontID fontID) {
     SkASSERT(stream);
     (void)stream->rewind();
     SkASSERT(stream->hasLength());
@@ -345,11 +347,26 @@ static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
             [](const void*, void* ctx) { delete (SkStreamAsset*)ctx; };
         return SkData::MakeWithProc(base, size, proc, stream.release());
     }
-    return SkData::MakeFromStream(stream.get(), size);
+    sk_sp<SkData> data = SkPDFSubsetFontCache::FindFontData(fontID);
+    if (data && data->size() == size) {
+        return data;
+    }
+    data = SkData::MakeFromStream(stream.get(), size);
+    if (data) {
+        SkPDFSubsetFontCache::AddFontData(fontID, data);
+    }
+    return data;
+}
+
+static sk_sp<SkPDFStream> make_subset_font_stream(sk_sp<SkData> subsetFont) {
+    auto subsetStream = sk_make_sp<SkPDFStream>(subsetFont);
+    subsetStream->dict()->insertInt("Length1", SkToInt(subsetFont->size()));
+    return subsetStream;
 }
 
 static sk_sp<SkPDFStream> get_subset_font_stream(
-        std::unique_ptr<SkStreamAsset> fontAsset,
+        const SkStreamAsset& fontAsset,
+        SkFontID fontID,
         const SkBitSet& glyphUsage,
         const char* fontName,
         int ttcIndex) {
@@ -361,8 +378,17 @@ static sk_sp<SkPDFStream> get_subset_font_stream(
     }
     glyphUsage.exportTo(&subset);
 
+    // Documents drawn with the same fonts and text often need the very same subsets.
+    if (sk_sp<SkData> cached = SkPDFSubsetFontCache::FindSubset(fontID, subset)) {
+        return make_subset_font_stream(std::move(cached));
+    }
+    std::unique_ptr<SkStreamAsset> fontCopy = fontAsset.duplicate();
+    if (!fontCopy) {
+        return nullptr;
+    }
+
     unsigned char* subsetFont{nullptr};
-    sk_sp<SkData> fontData(stream_to_data(std::move(fontAsset)));
+    sk_sp<SkData> fontData(stream_to_data(std::move(fontCopy), fontID));
 #if defined(SK_BUILD_FOR_GOOGLE3)
     // TODO(halcanary): update SK_BUILD_FOR_GOOGLE3 to newest version of Sfntly.
     (void)ttcIndex;
@@ -382,19 +408,17 @@ static sk_sp<SkPDFStream> get_subset_font_stream(
                                                    &subsetFont);
 #endif
     fontData.reset();
-    subset = std::vector<unsigned>();
     SkASSERT(subsetFontSize > 0 || subsetFont == nullptr);
     if (subsetFontSize < 1) {
         return nullptr;
     }
     SkASSERT(subsetFont != nullptr);
-    auto subsetStream = sk_make_sp<SkPDFStream>(
-            SkData::MakeWithProc(
-                    subsetFont, subsetFontSize,
-                    [](const void* p, void*) { delete[] (unsigned char*)p; },
-                    nullptr));
-    subsetStream->dict()->insertInt("Length1", subsetFontSize);
-    return subsetStream;
+    sk_sp<SkData> subsetData = SkData::MakeWithProc(
+            subsetFont, subsetFontSize,
+            [](const void* p, void*) { delete[] (unsigned char*)p; },
+            nullptr);
+    SkPDFSubsetFontCache::AddSubset(fontID, subset, subsetData);
+    return make_subset_font_stream(std::move(subsetData));
 }
 #endif  // SK_PDF_USE_SFNTLY
 
@@ -427,17 +451,13 @@ void SkPDFType0Font::getFontSubset(SkPDFCanon* canon) {
                 if (!SkToBool(metrics.fFlags &
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     sk_sp<SkPDFStream> subsetStream = get_subset_font_stream(
-                            std::move(fontAsset), this->glyphUsage(),
+                            *fontAsset, face->uniqueID(), this->glyphUsage(),
                             metrics.fFontName.c_str(), ttcIndex);
                     if (subsetStream) {
                         descriptor->insertObjRef("FontFile2", std::move(subsetStream));
                         break;
                     }
                     // If subsetting fails, fall back to original font data.
-                    fontAsset.reset(face->openStream(&ttcIndex));
-                    SkASSERT(fontAsset);
-                    SkASSERT(fontAsset->getLength() == fontSize);
-                    if (!fontAsset || fontAsset->getLength() == 0) { break; }
                 }
                 #endif  // SK_PDF_USE_SFNTLY
                 auto fontStream = sk_make_sp<SkPDFSharedStream>(std::move(fontAsset));
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPDFSubsetFontCache.h"
+
+#include "SkMD5.h"
+#include "SkResourceCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gPDFSubsetFontKeyNamespaceLabel;
+static unsigned gPDFFontDataKeyNamespaceLabel;
+
+struct PDFSubsetFontKey : public SkResourceCache::Key {
+    PDFSubsetFontKey(SkFontID fontID, const std::vector<unsigned>& glyphs) : fFontID(fontID) {
+        SkMD5 md5;
+        md5.write(glyphs.data(), glyphs.size() * sizeof(unsigned));
+        md5.finish(fGlyphsDigest);
+        this->init(&gPDFSubsetFontKeyNamespaceLabel, 0, sizeof(fFontID) + sizeof(fGlyphsDigest));
+    }
+
+    SkFontID       fFontID;
+    SkMD5::Digest  fGlyphsDigest;
+};
+
+struct PDFFontDataKey : public SkResourceCache::Key {
+    PDFFontDataKey(SkFontID fontID) : fFontID(fontID) {
+        this->init(&gPDFFontDataKeyNamespaceLabel, 0, sizeof(fFontID));
+    }
+
+    SkFontID fFontID;
+};
+
+template <typename K>
+struct PDFFontDataRec : public SkResourceCache::Rec {
+    PDFFontDataRec(const K& key, sk_sp<SkData> data, const char* category)
+        : fKey(key), fData(std::move(data)), fCategory(category) {}
+
+    K             fKey;
+    sk_sp<SkData> fData;
+    const char*   fCategory;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return fCategory; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PDFFontDataRec& rec = static_cast<const PDFFontDataRec&>(baseRec);
+        *static_cast<sk_sp<SkData>*>(contextData) = rec.fData;
+        return true;
+    }
+};
+} // namespace
+
+sk_sp<SkData> SkPDFSubsetFontCache::FindSubset(SkFontID fontID,
+                                               const std::vector<unsigned>& glyphs,
+                                               SkResourceCache* localCache) {
+    sk_sp<SkData> result;
+    PDFSubsetFontKey key(fontID, glyphs);
+    if (!CHECK_LOCAL(localCache, find, Find, key,
+                     PDFFontDataRec<PDFSubsetFontKey>::Visitor, &result)) {
+        return nullptr;
+    }
+    return result;
+}
+
+void SkPDFSubsetFontCache::AddSubset(SkFontID fontID, const std::vector<unsigned>& glyphs,
+                                     sk_sp<SkData> subset, SkResourceCache* localCache) {
+    SkASSERT(subset);
+    PDFSubsetFontKey key(fontID, glyphs);
+    return CHECK_LOCAL(localCache, add, Add, new PDFFontDataRec<PDFSubsetFontKey>(
+            key, std::move(subset), "pdf-font-subset"));
+}
+
+sk_sp<SkData> SkPDFSubsetFontCache::FindFontData(SkFontID fontID, SkResourceCache* localCache) {
+    sk_sp<SkData> result;
+    PDFFontDataKey key(fontID);
+    if (!CHECK_LOCAL(localCache, find, Find, key,
+                     PDFFontDataRec<PDFFontDataKey>::Visitor, &result)) {
+        return nullptr;
+    }
+    return result;
+}
+
+void SkPDFSubsetFontCache::AddFontData(SkFontID fontID, sk_sp<SkData> fontData,
+                                       SkResourceCache* localCache) {
+    SkASSERT(fontData);
+    PDFFontDataKey key(fontID);
+    return CHECK_LOCAL(localCache, add, Add, new PDFFontDataRec<PDFFontDataKey>(
+            key, std::move(fontData), "pdf-font-data"));
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPDFSubsetFontCache_DEFINED
+#define SkPDFSubsetFontCache_DEFINED
+
+#include "SkData.h"
+#include "SkTypeface.h"
+
+#include <vector>
+
+class SkResourceCache;
+
+/**
+ *  Keeps font subsets, and the font files they were made from, in the SkResourceCache, so that
+ *  documents drawn with the same fonts don't read and subset them again.
+ */
+class SkPDFSubsetFontCache {
+public:
+    /**
+     *  Returns the subset of typeface 'fontID' that keeps exactly 'glyphs', or nullptr if it
+     *  isn't cached. Subsets are found by a digest of 'glyphs', so the order of 'glyphs' matters.
+     */
+    static sk_sp<SkData> FindSubset(SkFontID fontID, const std::vector<unsigned>& glyphs,
+                                    SkResourceCache* localCache = nullptr);
+    static void AddSubset(SkFontID fontID, const std::vector<unsigned>& glyphs,
+                          sk_sp<SkData> subset, SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Returns the font file of typeface 'fontID', or nullptr if it isn't cached. Only fonts that
+     *  had to be copied out of their streams are worth adding.
+     */
+    static sk_sp<SkData> FindFontData(SkFontID fontID, SkResourceCache* localCache = nullptr);
+    static void AddFontData(SkFontID fontID, sk_sp<SkData> fontData,
+                            SkResourceCache* localCache = nullptr);
+};
+
+#endif
@@ -5,9 +5,11 @@
  * found in the LICENSE file.
  */
 
-#include "SkPDFDocumentPriv.h"
 #include "SkPDFTag.h"
 
+#include "SkPDFDocumentPriv.h"
+#include "SkTo.h"
+
 namespace {
 
 // Table 333 in PDF 32000-1:2008
@@ -107,100 +109,237 @@ const char* tagNameFromType(SkPDF::DocumentStructureType type) {
     return "";
 }
 
-}  // namespace
-
-SkPDFTag::SkPDFTag(int nodeId, SkPDF::DocumentStructureType type, sk_sp<SkPDFTag> parent)
-    : SkPDFDict("StructElem")
-    , fNodeId(nodeId) {
-    insertName("S", tagNameFromType(type));
-    if (parent) {
-        insertObjRef("P", std::move(parent));
-    }
-}
-
-SkPDFTag::~SkPDFTag() {
-}
+struct MarkedContentInfo {
+    unsigned fPageIndex;
+    int fMarkId;
+    MarkedContentInfo* fNext;
+};
 
-void SkPDFTag::appendChild(sk_sp<SkPDFTag> child) {
-    fChildren.emplace_back(child);
-}
+}  // namespace
 
-void SkPDFTag::drop() {
-    // Disconnect the tree so as not to cause reference count loops.
-    fChildren.reset();
+struct SkPDFTagNode {
+    SkPDFTagNode* fChildren = nullptr;
+    size_t fChildCount = 0;
+    // A [page index, mark ID] pair for each piece of marked content
+    // associated with this tag, in the order they were marked.
+    MarkedContentInfo* fFirstMark = nullptr;
+    MarkedContentInfo* fLastMark = nullptr;
+    int fMarkCount = 0;
+    sk_sp<SkPDFDict> fRef;
+    // This tag's node ID, which must correspond to the node ID set
+    // on the SkCanvas when content inside this tag is drawn.
+    // The node IDs are arbitrary and are not output to the PDF.
+    int fNodeId = 0;
+    SkPDF::DocumentStructureType fType = SkPDF::DocumentStructureType::kDocument;
+};
 
-    SkPDFDict::drop();
+static void copy(const SkPDF::StructureElementNode& node,
+                 SkPDFTagNode* dst,
+                 SkArenaAlloc* arena,
+                 SkTHashMap<int, SkPDFTagNode*>* nodeMap) {
+    nodeMap->set(node.fNodeId, dst);
+    dst->fNodeId = node.fNodeId;
+    dst->fType = node.fType;
+    dst->fChildCount = node.fChildCount;
+    dst->fChildren = arena->makeArray<SkPDFTagNode>(node.fChildCount);
+    for (size_t i = 0; i < node.fChildCount; ++i) {
+        copy(node.fChildren[i], &dst->fChildren[i], arena, nodeMap);
+    }
 }
 
-void SkPDFTag::addMarkedContent(int pageIndex, int markId) {
-    MarkedContentInfo mark;
-    mark.pageIndex = pageIndex;
-    mark.markId = markId;
-    fMarkedContent.emplace_back(mark);
+static const sk_sp<SkPDFDict>& ref(SkPDFTagNode* node, SkPDFObjNumMap* deferTo = nullptr) {
+    if (!node->fRef) {
+        node->fRef = sk_make_sp<SkPDFDict>("StructElem");
+        if (deferTo) {
+            deferTo->deferObject(node->fRef.get());
+        }
+    }
+    return node->fRef;
 }
 
-bool SkPDFTag::prepareTagTreeToEmit(const SkPDFDocument& document) {
+// Fills in the StructElems of 'node' and its descendants. Returns true if this tag is valid, and
+// false if no tag in this subtree was referred to by any marked content.
+static bool prepare_tag_tree_to_emit(SkPDFTagNode* node,
+                                     const sk_sp<SkPDFDict>& parent,
+                                     SkPDFDocument* doc) {
     // Scan the marked content. If it's all on the page, output a
     // Pg to the dict. If not, we'll use MCR dicts, below.
     bool allSamePage = true;
-    if (fMarkedContent.count() > 0) {
-        int firstPageIndex = fMarkedContent[0].pageIndex;
-        for (int i = 1; i < fMarkedContent.count(); i++) {
-            if (fMarkedContent[i].pageIndex != firstPageIndex) {
+    if (node->fFirstMark) {
+        unsigned firstPageIndex = node->fFirstMark->fPageIndex;
+        for (MarkedContentInfo* mark = node->fFirstMark->fNext; mark; mark = mark->fNext) {
+            if (mark->fPageIndex != firstPageIndex) {
                 allSamePage = false;
                 break;
             }
         }
-
-        if (allSamePage) {
-            insertObjRef("Pg", document.getPage(firstPageIndex));
-        }
     }
 
-    // Recursively prepare all child tags of this node.
-    SkTArray<sk_sp<SkPDFTag>> validChildren;
-    for (int i = 0; i < fChildren.count(); i++) {
-        if (fChildren[i]->prepareTagTreeToEmit(document)) {
-            validChildren.push_back(fChildren[i]);
+    // Recursively prepare all child tags of this node. A valid child
+    // makes its parent's StructElem, so invalid subtrees never get one.
+    SkTArray<SkPDFTagNode*> validChildren;
+    for (size_t i = 0; i < node->fChildCount; i++) {
+        SkPDFTagNode* child = &node->fChildren[i];
+        if (prepare_tag_tree_to_emit(child, ref(node), doc)) {
+            validChildren.push_back(child);
         }
     }
+    int kidCount = validChildren.count() + node->fMarkCount;
+    if (kidCount == 0) {
+        // This tag didn't have any marked content or any children with
+        // marked content, so return false. This subtree will be omitted
+        // from the structure tree.
+        return false;
+    }
 
-    // fChildren is no longer needed.
-    fChildren.reset();
+    const sk_sp<SkPDFDict>& dict = ref(node);
+    dict->insertName("S", tagNameFromType(node->fType));
+    dict->insertObjRef("P", parent);
+    if (node->fFirstMark && allSamePage) {
+        dict->insertObjRef("Pg", doc->getPage(node->fFirstMark->fPageIndex));
+    }
 
     // Now set the kids of this node, which includes both child tags
     // and marked content IDs.
-    if (validChildren.count() + fMarkedContent.count() == 1) {
+    if (kidCount == 1) {
         // If there's just one valid kid, or one marked content,
         // we can just output the reference directly with no array.
         if (validChildren.count() == 1) {
-            insertObjRef("K", validChildren[0]);
+            dict->insertObjRef("K", validChildren[0]->fRef);
         } else {
-            insertInt("K", fMarkedContent[0].markId);
+            dict->insertInt("K", node->fFirstMark->fMarkId);
         }
         return true;
-    } else if (validChildren.count() + fMarkedContent.count() > 1) {
-        // If there's more than one kid, output them in an array.
-        auto kids = sk_make_sp<SkPDFArray>();
-        for (int i = 0; i < validChildren.count(); i++) {
-            kids->appendObjRef(validChildren[i]);
+    }
+
+    // If there's more than one kid, output them in an array.
+    auto kids = sk_make_sp<SkPDFArray>();
+    kids->reserve(kidCount);
+    for (SkPDFTagNode* child : validChildren) {
+        kids->appendObjRef(child->fRef);
+    }
+    for (MarkedContentInfo* mark = node->fFirstMark; mark; mark = mark->fNext) {
+        if (allSamePage) {
+            kids->appendInt(mark->fMarkId);
+        } else {
+            auto mcr = sk_make_sp<SkPDFDict>("MCR");
+            mcr->insertObjRef("Pg", doc->getPage(mark->fPageIndex));
+            mcr->insertInt("MCID", mark->fMarkId);
+            kids->appendObject(std::move(mcr));
         }
-        for (int i = 0; i < fMarkedContent.count(); i++) {
-            if (allSamePage) {
-                kids->appendInt(fMarkedContent[i].markId);
-            } else {
-                auto mcr = sk_make_sp<SkPDFDict>("MCR");
-                mcr->insertObjRef("Pg", document.getPage(fMarkedContent[i].pageIndex));
-                mcr->insertInt("MCID", fMarkedContent[i].markId);
-                kids->appendObject(mcr);
-            }
+    }
+    dict->insertObject("K", std::move(kids));
+    return true;
+}
+
+static void drop_tag_tree(SkPDFTagNode* node) {
+    if (node->fRef) {
+        // Disconnect the tree so as not to cause reference count loops.
+        node->fRef->drop();
+        node->fRef = nullptr;
+    }
+    for (size_t i = 0; i < node->fChildCount; ++i) {
+        drop_tag_tree(&node->fChildren[i]);
+    }
+}
+
+SkPDFTagTree::SkPDFTagTree() : fArena(4 * sizeof(SkPDFTagNode)) {}
+
+SkPDFTagTree::~SkPDFTagTree() { this->reset(); }
+
+void SkPDFTagTree::init(const SkPDF::StructureElementNode* node) {
+    if (node) {
+        fRoot = fArena.make<SkPDFTagNode>();
+        copy(*node, fRoot, &fArena, &fNodeMap);
+    }
+}
+
+void SkPDFTagTree::reset() {
+    if (fRoot) {
+        drop_tag_tree(fRoot);
+    }
+    fRoot = nullptr;
+    fNodeMap.reset();
+    fMarksPerPage.reset();
+    fParentTreeEntries = std::vector<sk_sp<SkPDFArray>>();
+    fArena.reset();
+}
+
+int SkPDFTagTree::getMarkIdForNodeId(int nodeId, unsigned pageIndex) {
+    SkPDFTagNode** tagPtr = fNodeMap.find(nodeId);
+    if (!tagPtr) {
+        return -1;
+    }
+    SkPDFTagNode* tag = *tagPtr;
+    SkASSERT(tag);
+    while (SkToUInt(fMarksPerPage.count()) < pageIndex + 1) {
+        fMarksPerPage.push_back();
+    }
+    SkTArray<SkPDFTagNode*>& pageMarks = fMarksPerPage[pageIndex];
+    int markId = pageMarks.count();
+    MarkedContentInfo* mark = fArena.make<MarkedContentInfo>(
+            MarkedContentInfo{pageIndex, markId, nullptr});
+    if (tag->fLastMark) {
+        tag->fLastMark->fNext = mark;
+    } else {
+        tag->fFirstMark = mark;
+    }
+    tag->fLastMark = mark;
+    tag->fMarkCount++;
+    pageMarks.push_back(tag);
+    return markId;
+}
+
+sk_sp<SkPDFArray> SkPDFTagTree::finishPage(unsigned pageIndex, SkPDFObjNumMap* deferTo) {
+    if (SkToUInt(fMarksPerPage.count()) <= pageIndex) {
+        return nullptr;
+    }
+    if (fParentTreeEntries.size() <= pageIndex) {
+        fParentTreeEntries.resize(pageIndex + 1);
+    }
+    if (!fParentTreeEntries[pageIndex]) {
+        SkTArray<SkPDFTagNode*>& pageMarks = fMarksPerPage[pageIndex];
+        auto markToTagArray = sk_make_sp<SkPDFArray>();
+        markToTagArray->reserve(pageMarks.count());
+        for (SkPDFTagNode* tag : pageMarks) {
+            markToTagArray->appendObjRef(ref(tag, deferTo));
         }
-        insertObject("K", kids);
-        return true;
+        pageMarks.reset();
+        fParentTreeEntries[pageIndex] = std::move(markToTagArray);
     }
+    return fParentTreeEntries[pageIndex];
+}
 
-    // This tag didn't have any marked content or any children with
-    // marked content, so return false. This subtree will be omitted
-    // from the structure tree.
-    return false;
+sk_sp<SkPDFDict> SkPDFTagTree::makeStructTreeRoot(SkPDFDocument* doc) {
+    if (!fRoot) {
+        return nullptr;
+    }
+    auto structTreeRoot = sk_make_sp<SkPDFDict>("StructTreeRoot");
+
+    // Prepare the tag tree, this automatically skips over any
+    // tags that weren't referenced from any marked content.
+    // The parent of the tag root is the StructTreeRoot.
+    if (!prepare_tag_tree_to_emit(fRoot, structTreeRoot, doc)) {
+        SkDEBUGFAIL("PDF has tag tree but no marked content.");
+    }
+    structTreeRoot->insertObjRef("K", ref(fRoot));
+
+    // Build the parent tree, which is a mapping from the marked
+    // content IDs on each page to their corressponding tags.
+    unsigned pageCount = SkToUInt(doc->pageCount());
+    auto parentTreeNums = sk_make_sp<SkPDFArray>();
+    for (unsigned pageIndex = 0; pageIndex < pageCount; pageIndex++) {
+        sk_sp<SkPDFArray> markToTagArray = this->finishPage(pageIndex, nullptr);
+        // Exit now if there are no more pages with marked content.
+        if (!markToTagArray) {
+            break;
+        }
+        parentTreeNums->appendInt(SkToInt(pageIndex));
+        parentTreeNums->appendObjRef(std::move(markToTagArray));
+    }
+    auto parentTree = sk_make_sp<SkPDFDict>("ParentTree");
+    parentTree->insertObject("Nums", std::move(parentTreeNums));
+    structTreeRoot->insertObjRef("ParentTree", std::move(parentTree));
+    structTreeRoot->insertInt("ParentTreeNextKey", SkToInt(pageCount));
+    return structTreeRoot;
 }
@@ -8,60 +8,67 @@
 #ifndef SkPDFTag_DEFINED
 #define SkPDFTag_DEFINED
 
-#include "SkDocument.h"
+#include "SkArenaAlloc.h"
+#include "SkPDFDocument.h"
 #include "SkPDFTypes.h"
 #include "SkRefCnt.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+
+#include <vector>
 
 class SkPDFDocument;
+struct SkPDFTagNode;
 
-/** \class SkPDFTag
+/** \class SkPDFTagTree
 
-    A PDF Tag represents a semantic tag in the tag tree for an
-    accessible tagged PDF. Documents can create an accessible PDF by
-    creating a tree of SkPDFTags representing the semantic tree
-    structure of the overall document, and then calling
+    The structure tree of an accessible tagged PDF. Documents can
+    create an accessible PDF by giving the tree of
+    SkPDF::StructureElementNodes in their metadata, and then calling
     SkPDF::SetNodeId with the SkCanvas used to draw to the page and
     the same corresponding node IDs to mark the content for each
     page. It's allowed for the marked content for one tag to span
     multiple pages.
+
+    The tree's nodes and the marks on them are allocated from an
+    arena. A node's StructElem dictionary is only made once it's
+    known to be needed, when the page its content is on is finished
+    or the tree is emitted.
 */
-class SkPDFTag final : public SkPDFDict {
+class SkPDFTagTree {
 public:
-    SkPDFTag(int nodeId, SkPDF::DocumentStructureType type, sk_sp<SkPDFTag> parent);
-    ~SkPDFTag() override;
+    SkPDFTagTree();
+    ~SkPDFTagTree();
 
-    void appendChild(sk_sp<SkPDFTag> child);
-
-private:
-    friend class SkPDFDocument;
+    void init(const SkPDF::StructureElementNode*);
+    void reset();
 
-    void drop() override;
+    // Returns -1 if nodeId isn't in the tree.
+    int getMarkIdForNodeId(int nodeId, unsigned pageIndex);
 
-    void addMarkedContent(int pageIndex, int markId);
+    // Makes page 'pageIndex's entry in the parent tree: the StructElem
+    // for each of its marks, in mark ID order. StructElems first made
+    // here are deferred in 'deferTo', if given, because they aren't
+    // filled in until makeStructTreeRoot(). Returns nullptr if no
+    // page so far or after has any marks.
+    sk_sp<SkPDFArray> finishPage(unsigned pageIndex, SkPDFObjNumMap* deferTo);
 
-    // Should be called after all content has been emitted. Fills in
-    // all of the SkPDFDict fields in this tag and all descendants.
-    // Returns true if this tag is valid, and false if no tag in this
-    // subtree was referred to by any marked content.
-    bool prepareTagTreeToEmit(const SkPDFDocument& document);
+    // Should be called after all content has been emitted. Fills in the
+    // StructElems of every tag with marked content, and of its ancestors,
+    // and returns the StructTreeRoot, or nullptr if there is no tree.
+    sk_sp<SkPDFDict> makeStructTreeRoot(SkPDFDocument* doc);
 
-    struct MarkedContentInfo {
-        int pageIndex;
-        int markId;
-    };
-
-    // This tag's node ID, which must correspond to the node ID set
-    // on the SkCanvas when content inside this tag is drawn.
-    // The node IDs are arbitrary and are not output to the PDF.
-    int fNodeId;
-
-    // The children of this tag. Some tags like lists and tables require
-    // a particular hierarchical structure, similar to HTML.
-    SkTArray<sk_sp<SkPDFTag>> fChildren;
+private:
+    SkArenaAlloc fArena;
+    SkTHashMap<int, SkPDFTagNode*> fNodeMap;
+    SkPDFTagNode* fRoot = nullptr;
+    // Page -> the tags of its marks, in mark ID order.
+    SkTArray<SkTArray<SkPDFTagNode*>> fMarksPerPage;
+    // Page -> its finished parent tree entry.
+    std::vector<sk_sp<SkPDFArray>> fParentTreeEntries;
 
-    // An array consisting of a [page index, mark ID] pair for each piece
-    // of marked content associated with this tag.
-    SkTArray<MarkedContentInfo> fMarkedContent;
+    SkPDFTagTree(const SkPDFTagTree&) = delete;
+    SkPDFTagTree& operator=(const SkPDFTagTree&) = delete;
 };
 
 #endif
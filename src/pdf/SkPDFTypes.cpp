@@ -547,55 +547,54 @@ void SkPDFSharedStream::addResources(
 
 ////////////////////////////////////////////////////////////////////////////////
 
-SkPDFStream:: SkPDFStream(sk_sp<SkData> data) {
-    this->setData(skstd::make_unique<SkMemoryStream>(std::move(data)));
+SkPDFStream:: SkPDFStream(sk_sp<SkData> data, int compressionLevel) {
+    this->setData(skstd::make_unique<SkMemoryStream>(std::move(data)), compressionLevel);
 }
 
-SkPDFStream::SkPDFStream(std::unique_ptr<SkStreamAsset> stream) {
-    this->setData(std::move(stream));
+SkPDFStream::SkPDFStream(std::unique_ptr<SkStreamAsset> stream, int compressionLevel) {
+    this->setData(std::move(stream), compressionLevel);
 }
 
 SkPDFStream::SkPDFStream() {}
 
 SkPDFStream::~SkPDFStream() {}
 
+sk_sp<SkPDFStream> SkPDFStream::MakeDeferred(std::unique_ptr<SkStreamAsset> stream,
+                                             int compressionLevel) {
+    SkASSERT(stream);
+    sk_sp<SkPDFStream> pdfStream(new SkPDFStream);
+    pdfStream->fUncompressedData = std::move(stream);
+    pdfStream->fCompressionLevel = compressionLevel;
+    return pdfStream;
+}
+
 void SkPDFStream::addResources(SkPDFObjNumMap* catalog) const {
-    SkASSERT(fCompressedData);
+    SkASSERT(fCompressedData || fUncompressedData);
     fDict.addResources(catalog);
 }
 
 void SkPDFStream::drop() {
     fCompressedData.reset(nullptr);
+    fUncompressedData.reset(nullptr);
     fDict.drop();
 }
 
-void SkPDFStream::emitObject(SkWStream* stream,
-                             const SkPDFObjNumMap& objNumMap) const {
-    SkASSERT(fCompressedData);
-    fDict.emitObject(stream, objNumMap);
-    // duplicate (a cheap operation) preserves const on fCompressedData.
-    std::unique_ptr<SkStreamAsset> dup(fCompressedData->duplicate());
-    SkASSERT(dup);
-    SkASSERT(dup->hasLength());
-    stream->writeText(" stream\n");
-    stream->writeStream(dup.get(), dup->getLength());
-    stream->writeText("\nendstream");
-}
-
-void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
-    SkASSERT(!fCompressedData);  // Only call this function once.
-    SkASSERT(stream);
+// Returns the data to emit for 'stream', compressed if that makes it smaller,
+// and inserts its Length and Filter into 'dict'.
+static std::unique_ptr<SkStreamAsset> compress_stream(std::unique_ptr<SkStreamAsset> stream,
+                                                      SkPDFDict* dict, int compressionLevel) {
     // Code assumes that the stream starts at the beginning.
-
     #ifdef SK_PDF_LESS_COMPRESSION
-    fCompressedData = std::move(stream);
-    SkASSERT(fCompressedData && fCompressedData->hasLength());
-    fDict.insertInt("Length", fCompressedData->getLength());
-    #else
+    compressionLevel = 0;
+    #endif
+    SkASSERT(stream && stream->hasLength());
+    if (0 == compressionLevel) {
+        dict->insertInt("Length", stream->getLength());
+        return stream;
+    }
 
-    SkASSERT(stream->hasLength());
     SkDynamicMemoryWStream compressedData;
-    SkDeflateWStream deflateWStream(&compressedData);
+    SkDeflateWStream deflateWStream(&compressedData, compressionLevel);
     if (stream->getLength() > 0) {
         SkStreamCopy(&deflateWStream, stream.get());
     }
@@ -605,27 +604,85 @@ void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
 
     if (originalLength <= compressedLength + strlen("/Filter_/FlateDecode_")) {
         SkAssertResult(stream->rewind());
-        fCompressedData = std::move(stream);
-        fDict.insertInt("Length", originalLength);
-        return;
+        dict->insertInt("Length", originalLength);
+        return stream;
     }
-    fCompressedData = compressedData.detachAsStream();
-    fDict.insertName("Filter", "FlateDecode");
-    fDict.insertInt("Length", compressedLength);
-    #endif
+    dict->insertName("Filter", "FlateDecode");
+    dict->insertInt("Length", compressedLength);
+    return compressedData.detachAsStream();
+}
+
+void SkPDFStream::emitObject(SkWStream* stream,
+                             const SkPDFObjNumMap& objNumMap) const {
+    std::unique_ptr<SkStreamAsset> dup;
+    if (fUncompressedData) {
+        // The Length and Filter go first, as if they had been inserted by setData().
+        SkPDFDict lengthDict;
+        dup = compress_stream(fUncompressedData->duplicate(), &lengthDict, fCompressionLevel);
+        stream->writeText("<<");
+        lengthDict.emitAll(stream, objNumMap);
+        if (fDict.size() > 0) {
+            stream->writeText("\n");
+            fDict.emitAll(stream, objNumMap);
+        }
+        stream->writeText(">>");
+    } else {
+        SkASSERT(fCompressedData);
+        fDict.emitObject(stream, objNumMap);
+        // duplicate (a cheap operation) preserves const on fCompressedData.
+        dup = fCompressedData->duplicate();
+    }
+    SkASSERT(dup);
+    SkASSERT(dup->hasLength());
+    stream->writeText(" stream\n");
+    stream->writeStream(dup.get(), dup->getLength());
+    stream->writeText("\nendstream");
+}
+
+void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream, int compressionLevel) {
+    SkASSERT(!fCompressedData);  // Only call this function once.
+    SkASSERT(stream);
+    fCompressedData = compress_stream(std::move(stream), &fDict, compressionLevel);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void SkPDFObjNumMap::addObjectRecursively(SkPDFObject* obj) {
-    if (obj && !fObjectNumbers.find(obj)) {
+    if (!obj) {
+        return;
+    }
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (fObjectNumbers.find(obj)) {
+            return;
+        }
         fObjectNumbers.set(obj, fObjectNumbers.count() + 1);
-        fObjects.emplace_back(sk_ref_sp(obj));
+    }
+    fObjects.emplace_back(sk_ref_sp(obj));
+    if (!fDeferred.contains(obj)) {
+        obj->addResources(this);
+    }
+}
+
+std::vector<SkPDFObject*> SkPDFObjNumMap::undeferObjects() {
+    std::vector<SkPDFObject*> numbered;
+    if (fDeferred.count() == 0) {
+        return numbered;
+    }
+    for (const sk_sp<SkPDFObject>& obj : fObjects) {
+        if (fDeferred.contains(obj.get())) {
+            numbered.push_back(obj.get());
+        }
+    }
+    fDeferred.reset();
+    for (SkPDFObject* obj : numbered) {
         obj->addResources(this);
     }
+    return numbered;
 }
 
 int32_t SkPDFObjNumMap::getObjectNumber(SkPDFObject* obj) const {
+    SkAutoMutexAcquire lock(fMutex);
     int32_t* objectNumberFound = fObjectNumbers.find(obj);
     SkASSERT(objectNumberFound);
     return *objectNumberFound;
@@ -9,6 +9,7 @@
 #define SkPDFTypes_DEFINED
 
 #include "SkRefCnt.h"
+#include "SkMutex.h"
 #include "SkScalar.h"
 #include "SkTHash.h"
 #include "SkTo.h"
@@ -372,11 +373,19 @@ public:
     /** Create a PDF stream. A Length entry is automatically added to the
      *  stream dictionary.
      *  @param data   The data part of the stream.
-     *  @param stream The data part of the stream. */
-    explicit SkPDFStream(sk_sp<SkData> data);
-    explicit SkPDFStream(std::unique_ptr<SkStreamAsset> stream);
+     *  @param stream The data part of the stream.
+     *  @param compressionLevel As for SkDeflateWStream; 0 leaves the data
+     *                          uncompressed. */
+    explicit SkPDFStream(sk_sp<SkData> data, int compressionLevel = -1);
+    explicit SkPDFStream(std::unique_ptr<SkStreamAsset> stream, int compressionLevel = -1);
     ~SkPDFStream() override;
 
+    /** Create a PDF stream that compresses its data when it is emitted
+     *  rather than now, so the work happens on whichever thread emits it.
+     *  The bytes emitted are the same. */
+    static sk_sp<SkPDFStream> MakeDeferred(std::unique_ptr<SkStreamAsset> stream,
+                                           int compressionLevel = -1);
+
     SkPDFDict* dict() { return &fDict; }
 
     // The SkPDFObject interface.
@@ -391,10 +400,13 @@ protected:
     SkPDFStream();
 
     /** Only call this function once. */
-    void setData(std::unique_ptr<SkStreamAsset> stream);
+    void setData(std::unique_ptr<SkStreamAsset> stream, int compressionLevel = -1);
 
 private:
     std::unique_ptr<SkStreamAsset> fCompressedData;
+    // Only set for streams from MakeDeferred(), which leave fCompressedData empty.
+    std::unique_ptr<SkStreamAsset> fUncompressedData;
+    int fCompressionLevel = -1;
     SkPDFDict fDict;
 
     typedef SkPDFDict INHERITED;
@@ -421,8 +433,25 @@ public:
 
     const std::vector<sk_sp<SkPDFObject>>& objects() const { return fObjects; }
 
+    /** Number the passed object when it is added, but neither add its
+     *  dependencies nor serialize it until undeferObjects(). Used for
+     *  objects that may still change after they are first referenced.
+     */
+    void deferObject(SkPDFObject* obj) { fDeferred.add(obj); }
+
+    bool isDeferred(SkPDFObject* obj) const { return fDeferred.contains(obj); }
+
+    /** Stop deferring objects, add the dependencies of those that have been
+     *  numbered, and return those, in order.
+     */
+    std::vector<SkPDFObject*> undeferObjects();
+
 private:
     std::vector<sk_sp<SkPDFObject>> fObjects;
+    SkTHashSet<SkPDFObject*> fDeferred;
+    // Objects may be emitted on other threads, looking up object numbers,
+    // while more objects are added.
+    mutable SkMutex fMutex;
     SkTHashMap<SkPDFObject*, int32_t> fObjectNumbers;
 };
 
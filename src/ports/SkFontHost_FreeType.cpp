@@ -1939,6 +1939,35 @@ bool SkTypeface_FreeType::Scanner::scanFont(
     return success;
 }
 
+bool SkTypeface_FreeType::Scanner::scanCoverage(SkStreamAsset* stream, int ttcIndex,
+                                                SkTDArray<SkUnichar>* ranges) const
+{
+    SkAutoMutexAcquire libraryLock(fLibraryMutex);
+
+    FT_StreamRec streamRec;
+    FT_Face face = this->openFace(stream, ttcIndex, &streamRec);
+    if (nullptr == face) {
+        return false;
+    }
+
+    // FT_Get_Next_Char walks the charmap in increasing order.
+    FT_UInt glyphIndex;
+    FT_ULong charCode = FT_Get_First_Char(face, &glyphIndex);
+    while (glyphIndex != 0) {
+        SkUnichar character = SkToS32(charCode);
+        if (!ranges->isEmpty() && ranges->top() + 1 == character) {
+            ranges->top() = character;
+        } else {
+            ranges->push_back(character);
+            ranges->push_back(character);
+        }
+        charCode = FT_Get_Next_Char(face, charCode, &glyphIndex);
+    }
+
+    FT_Done_Face(face);
+    return true;
+}
+
 bool SkTypeface_FreeType::Scanner::GetAxes(FT_Face face, AxisDefinitions* axes) {
     if (axes && face->face_flags & FT_FACE_FLAG_MULTIPLE_MASTERS) {
         FT_MM_Var* variations = nullptr;
@@ -12,7 +12,9 @@
 #include "SkColorData.h"
 #include "SkFDot6.h"
 #include "SkFontHost_FreeType_common.h"
+#include "SkNx.h"
 #include "SkPath.h"
+#include "SkTemplates.h"
 #include "SkTo.h"
 
 #include <utility>
@@ -693,51 +695,119 @@ void SkScalerContext_FreeType_Base::generateGlyphImage(
 
 namespace {
 
-int move_proc(const FT_Vector* pt, void* ctx) {
-    SkPath* path = (SkPath*)ctx;
-    path->close();  // to close the previous contour (if any)
-    path->moveTo(SkFDot6ToScalar(pt->x), -SkFDot6ToScalar(pt->y));
-    return 0;
-}
-
-int line_proc(const FT_Vector* pt, void* ctx) {
-    SkPath* path = (SkPath*)ctx;
-    path->lineTo(SkFDot6ToScalar(pt->x), -SkFDot6ToScalar(pt->y));
-    return 0;
-}
-
-int quad_proc(const FT_Vector* pt0, const FT_Vector* pt1, void* ctx) {
-    SkPath* path = (SkPath*)ctx;
-    path->quadTo(SkFDot6ToScalar(pt0->x), -SkFDot6ToScalar(pt0->y),
-                 SkFDot6ToScalar(pt1->x), -SkFDot6ToScalar(pt1->y));
-    return 0;
+// Converts FreeType's 26.6 y-up points to SkPoints, two at a time.
+void convert_points(const FT_Vector* src, int count, SkPoint* dst) {
+    const Sk4f scale(1.0f/64, -1.0f/64, 1.0f/64, -1.0f/64);
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        Sk4f xyxy((float)src[i].x, (float)src[i].y, (float)src[i+1].x, (float)src[i+1].y);
+        (xyxy * scale).store(&dst[i]);
+    }
+    for (; i < count; i++) {
+        dst[i].set(SkFDot6ToScalar(src[i].x), -SkFDot6ToScalar(src[i].y));
+    }
 }
 
-int cubic_proc(const FT_Vector* pt0, const FT_Vector* pt1, const FT_Vector* pt2, void* ctx) {
-    SkPath* path = (SkPath*)ctx;
-    path->cubicTo(SkFDot6ToScalar(pt0->x), -SkFDot6ToScalar(pt0->y),
-                  SkFDot6ToScalar(pt1->x), -SkFDot6ToScalar(pt1->y),
-                  SkFDot6ToScalar(pt2->x), -SkFDot6ToScalar(pt2->y));
-    return 0;
+// The point halfway between two conic control points, rounded the way FT_Outline_Decompose does.
+SkPoint implied_on_point(const FT_Vector& a, const FT_Vector& b) {
+    return SkPoint::Make(SkFDot6ToScalar((a.x + b.x) / 2), -SkFDot6ToScalar((a.y + b.y) / 2));
 }
 
 }  // namespace
 
+// Builds the path straight from the outline's arrays rather than through FT_Outline_Decompose's
+// per-segment callbacks, so the path's storage is reserved once and the points are converted in
+// bulk. Produces exactly the verbs and points FT_Outline_Decompose would.
 bool SkScalerContext_FreeType_Base::generateGlyphPath(FT_Face face, SkPath* path) {
-    FT_Outline_Funcs    funcs;
-
-    funcs.move_to   = move_proc;
-    funcs.line_to   = line_proc;
-    funcs.conic_to  = quad_proc;
-    funcs.cubic_to  = cubic_proc;
-    funcs.shift     = 0;
-    funcs.delta     = 0;
+    const FT_Outline& outline = face->glyph->outline;
+    path->reset();
+    if (outline.n_points <= 0 || outline.n_contours <= 0) {
+        return true;
+    }
 
-    FT_Error err = FT_Outline_Decompose(&face->glyph->outline, &funcs, path);
+    SkAutoSTMalloc<128, SkPoint> storage(outline.n_points);
+    SkPoint* pts = storage.get();
+    convert_points(outline.points, outline.n_points, pts);
+    // At most one extra on-curve point per control point, plus each contour's closing line.
+    path->incReserve(2 * outline.n_points + outline.n_contours);
+
+    const FT_Vector* src = outline.points;
+    int first = 0;
+    for (int n = 0; n < outline.n_contours; n++) {
+        int last = outline.contours[n];
+        if (last < first || last >= outline.n_points) {
+            path->reset();
+            return false;
+        }
+        int limit = last;
+
+        SkPoint start = pts[first];
+        int point = first;
+        char tag = FT_CURVE_TAG(outline.tags[first]);
+        if (tag == FT_CURVE_TAG_CUBIC) {
+            path->reset();
+            return false;
+        }
+        if (tag == FT_CURVE_TAG_CONIC) {
+            // Start at the last point if it is on the curve, otherwise between the first and last.
+            if (FT_CURVE_TAG(outline.tags[last]) == FT_CURVE_TAG_ON) {
+                start = pts[last];
+                limit--;
+            } else {
+                start = implied_on_point(src[first], src[last]);
+            }
+            point--;
+        }
 
-    if (err != 0) {
-        path->reset();
-        return false;
+        path->close();  // to close the previous contour (if any)
+        path->moveTo(start);
+
+        bool closed = false;
+        while (point < limit && !closed) {
+            point++;
+            tag = FT_CURVE_TAG(outline.tags[point]);
+            if (tag == FT_CURVE_TAG_ON) {
+                path->lineTo(pts[point]);
+            } else if (tag == FT_CURVE_TAG_CONIC) {
+                int control = point;
+                for (;;) {
+                    if (point >= limit) {
+                        path->quadTo(pts[control], start);
+                        closed = true;
+                        break;
+                    }
+                    point++;
+                    tag = FT_CURVE_TAG(outline.tags[point]);
+                    if (tag == FT_CURVE_TAG_ON) {
+                        path->quadTo(pts[control], pts[point]);
+                        break;
+                    }
+                    if (tag != FT_CURVE_TAG_CONIC) {
+                        path->reset();
+                        return false;
+                    }
+                    path->quadTo(pts[control], implied_on_point(src[control], src[point]));
+                    control = point;
+                }
+            } else {
+                if (point + 1 > limit ||
+                    FT_CURVE_TAG(outline.tags[point + 1]) != FT_CURVE_TAG_CUBIC) {
+                    path->reset();
+                    return false;
+                }
+                point += 2;
+                if (point <= limit) {
+                    path->cubicTo(pts[point - 2], pts[point - 1], pts[point]);
+                } else {
+                    path->cubicTo(pts[point - 2], pts[point - 1], start);
+                    closed = true;
+                }
+            }
+        }
+        if (!closed) {
+            path->lineTo(start);
+        }
+        first = last + 1;
     }
 
     path->close();
@@ -12,6 +12,7 @@
 #include "SkGlyph.h"
 #include "SkMutex.h"
 #include "SkScalerContext.h"
+#include "SkTDArray.h"
 #include "SkTypeface.h"
 #include "SkTypes.h"
 
@@ -72,6 +73,8 @@ public:
         bool scanFont(SkStreamAsset* stream, int ttcIndex,
                       SkString* name, SkFontStyle* style, bool* isFixedPitch,
                       AxisDefinitions* axes) const;
+        /** Appends the inclusive [first, last] pairs of characters the face maps to glyphs. */
+        bool scanCoverage(SkStreamAsset* stream, int ttcIndex, SkTDArray<SkUnichar>* ranges) const;
         static void computeAxisValues(
             AxisDefinitions axisDefinitions,
             const SkFontArguments::VariationPosition position,
@@ -45,6 +45,25 @@ void SkTypeface_Custom::onGetFontDescriptor(SkFontDescriptor* desc, bool* isLoca
 
 int SkTypeface_Custom::getIndex() const { return fIndex; }
 
+void SkTypeface_Custom::setCoverage(SkTDArray<SkUnichar> ranges) {
+    SkASSERT(ranges.count() % 2 == 0);
+    fCoverage = std::move(ranges);
+}
+
+bool SkTypeface_Custom::covers(SkUnichar character) const {
+    // Find the first range which ends at or after the character.
+    int lo = 0, hi = fCoverage.count() / 2;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (fCoverage[2 * mid + 1] < character) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < fCoverage.count() / 2 && fCoverage[2 * lo] <= character;
+}
+
 
 SkTypeface_Empty::SkTypeface_Empty() : INHERITED(SkFontStyle(), false, true, SkString(), 0) {}
 
@@ -206,10 +225,38 @@ SkTypeface* SkFontMgr_Custom::onMatchFamilyStyle(const char familyName[],
 }
 
 SkTypeface* SkFontMgr_Custom::onMatchFamilyStyleCharacter(const char familyName[],
-                                                          const SkFontStyle&,
+                                                          const SkFontStyle& style,
                                                           const char* bcp47[], int bcp47Count,
                                                           SkUnichar character) const
 {
+    // Only typefaces whose coverage is known are candidates, so no font files are opened here.
+    auto match = [&](SkFontStyleSet_Custom* family) -> SkTypeface* {
+        sk_sp<SkTypeface> best(family->matchStyle(style));
+        if (best && static_cast<SkTypeface_Custom*>(best.get())->covers(character)) {
+            return best.release();
+        }
+        for (const sk_sp<SkTypeface_Custom>& typeface : family->fStyles) {
+            if (typeface->covers(character)) {
+                return SkRef(typeface.get());
+            }
+        }
+        return nullptr;
+    };
+
+    sk_sp<SkFontStyleSet_Custom> requested(familyName ? this->onMatchFamily(familyName) : nullptr);
+    if (requested) {
+        if (SkTypeface* typeface = match(requested.get())) {
+            return typeface;
+        }
+    }
+    for (int i = 0; i < fFamilies.count(); ++i) {
+        if (fFamilies[i] == requested) {
+            continue;
+        }
+        if (SkTypeface* typeface = match(fFamilies[i].get())) {
+            return typeface;
+        }
+    }
     return nullptr;
 }
 
@@ -14,6 +14,7 @@
 #include "SkRefCnt.h"
 #include "SkString.h"
 #include "SkTArray.h"
+#include "SkTDArray.h"
 #include "SkTypes.h"
 
 class SkData;
@@ -28,6 +29,13 @@ public:
                       bool sysFont, const SkString familyName, int index);
     bool isSysFont() const;
 
+    /** Sets the sorted, inclusive [first, last] pairs of characters this typeface maps, so that
+     *  character fallback can consider it without opening the font.
+     */
+    void setCoverage(SkTDArray<SkUnichar> ranges);
+    /** Returns true if the coverage has been set and includes the character. */
+    bool covers(SkUnichar character) const;
+
 protected:
     void onGetFamilyName(SkString* familyName) const override;
     void onGetFontDescriptor(SkFontDescriptor* desc, bool* isLocal) const override;
@@ -37,6 +45,7 @@ private:
     const bool fIsSysFont;
     const SkString fFamilyName;
     const int fIndex;
+    SkTDArray<SkUnichar> fCoverage;
 
     typedef SkTypeface_FreeType INHERITED;
 };
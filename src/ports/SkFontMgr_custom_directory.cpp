@@ -5,23 +5,150 @@
  * found in the LICENSE file.
  */
 
+#include "SkData.h"
 #include "SkFontMgr_custom.h"
 #include "SkFontMgr_directory.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
+#include "SkReadBuffer.h"
 #include "SkStream.h"
+#include "SkTHash.h"
+#include "SkTo.h"
+#include "SkWriteBuffer.h"
+
+namespace {
+
+// Bump the version whenever the layout written by write_index() changes.
+static constexpr uint32_t kIndexMagic   = SkSetFourByteTag('s', 'k', 'f', 'i');
+static constexpr uint32_t kIndexVersion = 1;
+
+struct IndexedFace {
+    SkString fFamilyName;
+    SkFontStyle fStyle;
+    bool fIsFixedPitch = false;
+    int fIndex = 0;
+    SkTDArray<SkUnichar> fCoverage;
+};
+
+// What scanning a font file found, and the file's size and modification time at the time.
+struct IndexedFile {
+    size_t fSize = 0;
+    int64_t fModified = 0;
+    SkTArray<IndexedFace> fFaces;  // Empty if the file is not a font.
+};
+
+using Index = SkTHashMap<SkString, IndexedFile>;
+
+bool read_index(const char* path, Index* index) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(path);
+    if (!data) {
+        return false;
+    }
+    SkReadBuffer buffer(data->data(), data->size());
+    if (!buffer.validate(buffer.readUInt() == kIndexMagic &&
+                         buffer.readUInt() == kIndexVersion)) {
+        return false;
+    }
+
+    int fileCount = buffer.readInt();
+    for (int i = 0; i < fileCount && buffer.isValid(); ++i) {
+        SkString filename;
+        buffer.readString(&filename);
+        IndexedFile file;
+        uint64_t size     = buffer.readUInt();
+        size             |= (uint64_t)buffer.readUInt() << 32;
+        uint64_t modified = buffer.readUInt();
+        modified         |= (uint64_t)buffer.readUInt() << 32;
+        file.fSize = SkTo<size_t>(size);
+        file.fModified = (int64_t)modified;
+
+        int faceCount = buffer.readInt();
+        for (int j = 0; j < faceCount && buffer.isValid(); ++j) {
+            IndexedFace& face = file.fFaces.push_back();
+            buffer.readString(&face.fFamilyName);
+            int weight = buffer.readInt(),
+                width  = buffer.readInt(),
+                slant  = buffer.readInt();
+            face.fIsFixedPitch = buffer.readBool();
+            face.fIndex = buffer.readInt();
+            uint32_t coverageCount = buffer.getArrayCount();
+            if (!buffer.validate(slant >= SkFontStyle::kUpright_Slant &&
+                                 slant <= SkFontStyle::kOblique_Slant &&
+                                 face.fIndex >= 0 && coverageCount % 2 == 0 &&
+                                 coverageCount <= buffer.available() / sizeof(SkUnichar))) {
+                break;
+            }
+            face.fStyle = SkFontStyle(weight, width, (SkFontStyle::Slant)slant);
+            face.fCoverage.setCount(coverageCount);
+            buffer.readIntArray(face.fCoverage.begin(), coverageCount);
+        }
+        index->set(std::move(filename), std::move(file));
+    }
+    if (!buffer.isValid()) {
+        index->reset();
+        return false;
+    }
+    return true;
+}
+
+void write_index(const char* path, const Index& index) {
+    SkBinaryWriteBuffer buffer;
+    buffer.writeUInt(kIndexMagic);
+    buffer.writeUInt(kIndexVersion);
+    buffer.writeInt(index.count());
+    index.foreach([&buffer](const SkString& filename, const IndexedFile& file) {
+        buffer.writeString(filename.c_str());
+        buffer.writeUInt((uint64_t)file.fSize & 0xFFFFFFFF);
+        buffer.writeUInt((uint64_t)file.fSize >> 32);
+        buffer.writeUInt((uint64_t)file.fModified & 0xFFFFFFFF);
+        buffer.writeUInt((uint64_t)file.fModified >> 32);
+        buffer.writeInt(file.fFaces.count());
+        for (const IndexedFace& face : file.fFaces) {
+            buffer.writeString(face.fFamilyName.c_str());
+            buffer.writeInt(face.fStyle.weight());
+            buffer.writeInt(face.fStyle.width());
+            buffer.writeInt(face.fStyle.slant());
+            buffer.writeBool(face.fIsFixedPitch);
+            buffer.writeInt(face.fIndex);
+            buffer.writeIntArray(face.fCoverage.begin(), face.fCoverage.count());
+        }
+    });
+
+    SkFILEWStream stream(path);
+    if (!stream.isValid() || !buffer.writeToStream(&stream)) {
+        SkDebugf("---- failed to write font index <%s>\n", path);
+    }
+}
+
+}  // namespace
 
 class DirectorySystemFontLoader : public SkFontMgr_Custom::SystemFontLoader {
 public:
-    DirectorySystemFontLoader(const char* dir) : fBaseDirectory(dir) { }
+    DirectorySystemFontLoader(const char* dir, const char* indexPath = nullptr)
+        : fBaseDirectory(dir), fIndexPath(indexPath) { }
 
     void loadSystemFonts(const SkTypeface_FreeType::Scanner& scanner,
                          SkFontMgr_Custom::Families* families) const override
     {
-        load_directory_fonts(scanner, fBaseDirectory, ".ttf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".ttc", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".otf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".pfb", families);
+        // With an index, font files which are unchanged since it was written are not opened.
+        Index previous, current;
+        bool indexChanged = false;
+        Index* index = nullptr;
+        if (!fIndexPath.isEmpty()) {
+            indexChanged = !read_index(fIndexPath.c_str(), &previous);
+            index = &current;
+        }
+
+        Loader loader{scanner, families, &previous, index, &indexChanged};
+        loader.loadDirectoryFonts(fBaseDirectory, ".ttf");
+        loader.loadDirectoryFonts(fBaseDirectory, ".ttc");
+        loader.loadDirectoryFonts(fBaseDirectory, ".otf");
+        loader.loadDirectoryFonts(fBaseDirectory, ".pfb");
+
+        // A font which was removed leaves the index with fewer files.
+        if (index && (indexChanged || previous.count() != current.count())) {
+            write_index(fIndexPath.c_str(), current);
+        }
 
         if (families->empty()) {
             SkFontStyleSet_Custom* family = new SkFontStyleSet_Custom(SkString());
@@ -42,63 +169,114 @@ private:
         return nullptr;
     }
 
-    static void load_directory_fonts(const SkTypeface_FreeType::Scanner& scanner,
-                                     const SkString& directory, const char* suffix,
-                                     SkFontMgr_Custom::Families* families)
+    static bool scan_file(const SkTypeface_FreeType::Scanner& scanner, const SkString& filename,
+                          bool withCoverage, IndexedFile* file)
     {
-        SkOSFile::Iter iter(directory.c_str(), suffix);
-        SkString name;
+        std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename.c_str());
+        if (!stream) {
+            SkDebugf("---- failed to open <%s>\n", filename.c_str());
+            return false;
+        }
 
-        while (iter.next(&name, false)) {
-            SkString filename(SkOSPath::Join(directory.c_str(), name.c_str()));
-            std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename.c_str());
-            if (!stream) {
-                SkDebugf("---- failed to open <%s>\n", filename.c_str());
+        int numFaces;
+        if (!scanner.recognizedFont(stream.get(), &numFaces)) {
+            SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
+            return true;
+        }
+
+        for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+            IndexedFace face;
+            face.fIndex = faceIndex;
+            if (!scanner.scanFont(stream.get(), faceIndex, &face.fFamilyName, &face.fStyle,
+                                  &face.fIsFixedPitch, nullptr) ||
+                (withCoverage && !scanner.scanCoverage(stream.get(), faceIndex, &face.fCoverage)))
+            {
+                SkDebugf("---- failed to open <%s> <%d> as a font\n",
+                         filename.c_str(), faceIndex);
                 continue;
             }
+            file->fFaces.push_back(std::move(face));
+        }
+        return true;
+    }
 
-            int numFaces;
-            if (!scanner.recognizedFont(stream.get(), &numFaces)) {
-                SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
-                continue;
+    struct Loader {
+        const SkTypeface_FreeType::Scanner& fScanner;
+        SkFontMgr_Custom::Families* fFamilies;
+        Index* fPrevious;
+        Index* fCurrent;  // Null when not indexing.
+        bool* fChanged;
+
+        // Returns what the file holds, from the previous index if it is still accurate.
+        const IndexedFile* find(const SkString& filename, IndexedFile* scratch) {
+            if (!fCurrent) {
+                return scan_file(fScanner, filename, false, scratch) ? scratch : nullptr;
+            }
+
+            IndexedFile file;
+            if (!sk_stat(filename.c_str(), &file.fSize, &file.fModified)) {
+                SkDebugf("---- failed to open <%s>\n", filename.c_str());
+                return nullptr;
+            }
+            IndexedFile* cached = fPrevious->find(filename);
+            if (cached && cached->fSize == file.fSize && cached->fModified == file.fModified) {
+                return fCurrent->set(filename, std::move(*cached));
+            }
+            if (!scan_file(fScanner, filename, true, &file)) {
+                return nullptr;
             }
+            *fChanged = true;
+            return fCurrent->set(filename, std::move(file));
+        }
+
+        void loadDirectoryFonts(const SkString& directory, const char* suffix) {
+            SkOSFile::Iter iter(directory.c_str(), suffix);
+            SkString name;
 
-            for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
-                bool isFixedPitch;
-                SkString realname;
-                SkFontStyle style = SkFontStyle(); // avoid uninitialized warning
-                if (!scanner.scanFont(stream.get(), faceIndex,
-                                      &realname, &style, &isFixedPitch, nullptr))
-                {
-                    SkDebugf("---- failed to open <%s> <%d> as a font\n",
-                             filename.c_str(), faceIndex);
+            while (iter.next(&name, false)) {
+                SkString filename(SkOSPath::Join(directory.c_str(), name.c_str()));
+                IndexedFile scratch;
+                const IndexedFile* file = this->find(filename, &scratch);
+                if (!file) {
                     continue;
                 }
 
-                SkFontStyleSet_Custom* addTo = find_family(*families, realname.c_str());
-                if (nullptr == addTo) {
-                    addTo = new SkFontStyleSet_Custom(realname);
-                    families->push_back().reset(addTo);
+                for (const IndexedFace& face : file->fFaces) {
+                    SkFontStyleSet_Custom* addTo = find_family(*fFamilies,
+                                                               face.fFamilyName.c_str());
+                    if (nullptr == addTo) {
+                        addTo = new SkFontStyleSet_Custom(face.fFamilyName);
+                        fFamilies->push_back().reset(addTo);
+                    }
+                    auto typeface = sk_make_sp<SkTypeface_File>(face.fStyle, face.fIsFixedPitch,
+                                                                true, face.fFamilyName,
+                                                                filename.c_str(), face.fIndex);
+                    if (fCurrent) {
+                        typeface->setCoverage(face.fCoverage);
+                    }
+                    addTo->appendTypeface(std::move(typeface));
                 }
-                addTo->appendTypeface(sk_make_sp<SkTypeface_File>(style, isFixedPitch, true,
-                                                                  realname, filename.c_str(),
-                                                                  faceIndex));
             }
-        }
 
-        SkOSFile::Iter dirIter(directory.c_str());
-        while (dirIter.next(&name, true)) {
-            if (name.startsWith(".")) {
-                continue;
+            SkOSFile::Iter dirIter(directory.c_str());
+            while (dirIter.next(&name, true)) {
+                if (name.startsWith(".")) {
+                    continue;
+                }
+                SkString dirname(SkOSPath::Join(directory.c_str(), name.c_str()));
+                this->loadDirectoryFonts(dirname, suffix);
             }
-            SkString dirname(SkOSPath::Join(directory.c_str(), name.c_str()));
-            load_directory_fonts(scanner, dirname, suffix, families);
         }
-    }
+    };
 
     SkString fBaseDirectory;
+    SkString fIndexPath;
 };
 
 SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir) {
     return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir));
 }
+
+SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir, const char* indexPath) {
+    return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir, indexPath));
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkMalloc.h"
+#include "SkMemoryAccounting.h"
 
 #include <cstdlib>
 
@@ -54,6 +55,7 @@ void sk_out_of_memory(void) {
 }
 
 void* sk_realloc_throw(void* addr, size_t size) {
+    SkMemoryAccounting::CountAllocation(size);
     return throw_on_failure(size, realloc(addr, size));
 }
 
@@ -64,6 +66,7 @@ void sk_free(void* p) {
 }
 
 void* sk_malloc_flags(size_t size, unsigned flags) {
+    SkMemoryAccounting::CountAllocation(size);
     void* p;
     if (flags & SK_MALLOC_ZERO_INITIALIZE) {
         p = calloc(size, 1);
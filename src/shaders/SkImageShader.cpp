@@ -248,7 +248,58 @@ SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_START(SkShaderBase)
 SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkImageShader)
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_END
 
+// See skia:4649 and the GM image_scale_aligned.
+static void nudge_nearest_neighbor_matrix(SkMatrix* matrix) {
+    if (matrix->getScaleX() >= 0) {
+        matrix->setTranslateX(nextafterf(matrix->getTranslateX(),
+                                         floorf(matrix->getTranslateX())));
+    }
+    if (matrix->getScaleY() >= 0) {
+        matrix->setTranslateY(nextafterf(matrix->getTranslateY(),
+                                         floorf(matrix->getTranslateY())));
+    }
+}
+
+// Owns the matrix_2x3 context of an image shader's pipeline, so that it can be re-targeted.
+class SkImageStageUpdater : public SkStageUpdater {
+public:
+    SkImageStageUpdater(const SkImageShader* shader, SkFilterQuality quality)
+        : fShader(shader), fQuality(quality) {}
+
+    bool update(const SkMatrix& ctm, const SkMatrix* localM) override {
+        SkMatrix matrix;
+        if (!fShader->computeTotalInverse(ctm, localM, &matrix) || matrix.hasPerspective()) {
+            return false;
+        }
+        if (fQuality == kNone_SkFilterQuality) {
+            nudge_nearest_neighbor_matrix(&matrix);
+        }
+        return matrix.asAffine(fMatrix);
+    }
+
+    float fMatrix[6];
+
+private:
+    const SkImageShader*  fShader;
+    const SkFilterQuality fQuality;
+};
+
 bool SkImageShader::onAppendStages(const StageRec& rec) const {
+    return this->doStages(rec);
+}
+
+SkStageUpdater* SkImageShader::onAppendUpdatableStages(const StageRec& rec) const {
+    // Only the matrix may change from update to update.  Medium and high quality pick a mip level
+    // or filter from the scale, so they need a whole new pipeline for every matrix.
+    auto quality = rec.fPaint.getFilterQuality();
+    if (quality > kLow_SkFilterQuality || rec.fCTM.hasPerspective()) {
+        return nullptr;
+    }
+    auto updater = rec.fAlloc->make<SkImageStageUpdater>(this, quality);
+    return this->doStages(rec, updater) ? updater : nullptr;
+}
+
+bool SkImageShader::doStages(const StageRec& rec, SkImageStageUpdater* updater) const {
     SkRasterPipeline* p = rec.fPipeline;
     SkArenaAlloc* alloc = rec.fAlloc;
 
@@ -257,6 +308,9 @@ bool SkImageShader::onAppendStages(const StageRec& rec) const {
         return false;
     }
     auto quality = rec.fPaint.getFilterQuality();
+    if (updater && !updater->update(rec.fCTM, rec.fLocalM)) {
+        return false;
+    }
 
     SkBitmapProvider provider(fImage.get());
     const auto* state = SkBitmapController::RequestBitmap(provider, matrix, quality, alloc);
@@ -270,27 +324,25 @@ bool SkImageShader::onAppendStages(const StageRec& rec) const {
     auto info = pm.info();
 
     // When the matrix is just an integer translate, bilerp == nearest neighbor.
-    if (quality == kLow_SkFilterQuality &&
+    // That needn't hold for the matrices an updater will see later.
+    if (!updater &&
+        quality == kLow_SkFilterQuality &&
         matrix.getType() <= SkMatrix::kTranslate_Mask &&
         matrix.getTranslateX() == (int)matrix.getTranslateX() &&
         matrix.getTranslateY() == (int)matrix.getTranslateY()) {
         quality = kNone_SkFilterQuality;
     }
 
-    // See skia:4649 and the GM image_scale_aligned.
     if (quality == kNone_SkFilterQuality) {
-        if (matrix.getScaleX() >= 0) {
-            matrix.setTranslateX(nextafterf(matrix.getTranslateX(),
-                                            floorf(matrix.getTranslateX())));
-        }
-        if (matrix.getScaleY() >= 0) {
-            matrix.setTranslateY(nextafterf(matrix.getTranslateY(),
-                                            floorf(matrix.getTranslateY())));
-        }
+        nudge_nearest_neighbor_matrix(&matrix);
     }
 
     p->append(SkRasterPipeline::seed_shader);
-    p->append_matrix(alloc, matrix);
+    if (updater) {
+        p->append(SkRasterPipeline::matrix_2x3, updater->fMatrix);
+    } else {
+        p->append_matrix(alloc, matrix);
+    }
 
     auto gather = alloc->make<SkJumper_GatherCtx>();
     gather->pixels = pm.addr();
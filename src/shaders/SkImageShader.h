@@ -13,6 +13,8 @@
 #include "SkImage.h"
 #include "SkShaderBase.h"
 
+class SkImageStageUpdater;
+
 class SkImageShader : public SkShaderBase {
 public:
     static sk_sp<SkShader> Make(sk_sp<SkImage>,
@@ -43,6 +45,9 @@ private:
     SkImage* onIsAImage(SkMatrix*, SkShader::TileMode*) const override;
 
     bool onAppendStages(const StageRec&) const override;
+    SkStageUpdater* onAppendUpdatableStages(const StageRec&) const override;
+
+    bool doStages(const StageRec&, SkImageStageUpdater* = nullptr) const;
 
     sk_sp<SkShader> onMakeColorSpace(SkColorSpaceXformer* xformer) const override {
         return xformer->apply(fImage.get())->makeShader(fTileModeX, fTileModeY,
@@ -54,6 +59,7 @@ private:
     const SkShader::TileMode fTileModeY;
     const bool               fClampAsIfUnpremul;
 
+    friend class SkImageStageUpdater;
     friend class SkShaderBase;
     typedef SkShaderBase INHERITED;
 };
@@ -10,11 +10,13 @@
 #include "SkArenaAlloc.h"
 #include "SkColorFilter.h"
 #include "SkMakeUnique.h"
+#include "SkRasterPipeline.h"
 #include "SkReadBuffer.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkUnPreMultiply.h"
 #include "SkWriteBuffer.h"
+#include "../jumper/SkJumper.h"
 
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -347,16 +349,10 @@ public:
         void shadeSpan(int x, int y, SkPMColor[], int count) override;
 
     private:
-        SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
-        SkScalar calculateTurbulenceValueForPoint(
-                                                  int channel,
-                                                  StitchData& stitchData, const SkPoint& point) const;
+        SkPMColor shade(const SkPoint& point) const;
         SkScalar calculateImprovedNoiseValueForPoint(int channel, const SkPoint& point) const;
-        SkScalar noise2D(int channel,
-                         const StitchData& stitchData, const SkPoint& noiseVector) const;
 
-        SkMatrix     fMatrix;
-        PaintingData fPaintingData;
+        SkMatrix fMatrix;
 
         typedef Context INHERITED;
     };
@@ -369,6 +365,7 @@ public:
 
 protected:
     void flatten(SkWriteBuffer&) const override;
+    bool onAppendStages(const StageRec&) const override;
 #ifdef SK_ENABLE_LEGACY_SHADERCONTEXT
     Context* onMakeContext(const ContextRec&, SkArenaAlloc*) const override;
 #endif
@@ -387,27 +384,6 @@ private:
     typedef SkShaderBase INHERITED;
 };
 
-namespace {
-
-// noiseValue is the color component's value (or color)
-// limitValue is the maximum perlin noise array index value allowed
-// newValue is the current noise dimension (either width or height)
-inline int checkNoise(int noiseValue, int limitValue, int newValue) {
-    // If the noise value would bring us out of bounds of the current noise array while we are
-    // stiching noise tiles together, wrap the noise around the current dimension of the noise to
-    // stay within the array bounds in a continuous fashion (so that tiling lines are not visible)
-    if (noiseValue >= limitValue) {
-        noiseValue -= newValue;
-    }
-    return noiseValue;
-}
-
-inline SkScalar smoothCurve(SkScalar t) {
-    return t * t * (3 - 2 * t);
-}
-
-} // end namespace
-
 SkPerlinNoiseShaderImpl::SkPerlinNoiseShaderImpl(SkPerlinNoiseShaderImpl::Type type,
                                                  SkScalar baseFrequencyX,
                                                  SkScalar baseFrequencyY,
@@ -463,105 +439,52 @@ void SkPerlinNoiseShaderImpl::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
-    struct Noise {
-        int noisePositionIntegerValue;
-        int nextNoisePositionIntegerValue;
-        SkScalar noisePositionFractionValue;
-        Noise(SkScalar component)
-        {
-            SkScalar position = component + kPerlinNoise;
-            noisePositionIntegerValue = SkScalarFloorToInt(position);
-            noisePositionFractionValue = position - SkIntToScalar(noisePositionIntegerValue);
-            nextNoisePositionIntegerValue = noisePositionIntegerValue + 1;
-        }
-    };
-    Noise noiseX(noiseVector.x());
-    Noise noiseY(noiseVector.y());
-    SkScalar u, v;
-    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
-    // If stitching, adjust lattice points accordingly.
-    if (perlinNoiseShader.fStitchTiles) {
-        noiseX.noisePositionIntegerValue =
-            checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.noisePositionIntegerValue =
-            checkNoise(noiseY.noisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
-        noiseX.nextNoisePositionIntegerValue =
-            checkNoise(noiseX.nextNoisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.nextNoisePositionIntegerValue =
-            checkNoise(noiseY.nextNoisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
+bool SkPerlinNoiseShaderImpl::onAppendStages(const StageRec& rec) const {
+    if (kImprovedNoise_Type == fType) {
+        return INHERITED::onAppendStages(rec);
     }
-    noiseX.noisePositionIntegerValue &= kBlockMask;
-    noiseY.noisePositionIntegerValue &= kBlockMask;
-    noiseX.nextNoisePositionIntegerValue &= kBlockMask;
-    noiseY.nextNoisePositionIntegerValue &= kBlockMask;
-    int i = fPaintingData.fLatticeSelector[noiseX.noisePositionIntegerValue];
-    int j = fPaintingData.fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
-    int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
-    SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
-
-    if (sx < 0 || sy < 0 || sx > 1 || sy > 1) {
-        return 0;  // Check for pathological inputs.
-    }
-
-    // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData.fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData.fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData.fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData.fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
-}
 
-SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
-    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
-    if (perlinNoiseShader.fStitchTiles) {
-        // Set up TurbulenceInitial stitch values.
-        stitchData = fPaintingData.fStitchDataInit;
+    SkMatrix matrix = SkMatrix::Concat(rec.fCTM, this->getLocalMatrix());
+    if (rec.fLocalM) {
+        matrix.preConcat(*rec.fLocalM);
     }
-    SkScalar turbulenceFunctionResult = 0;
-    SkPoint noiseVector(SkPoint::Make(point.x() * fPaintingData.fBaseFrequency.fX,
-                                      point.y() * fPaintingData.fBaseFrequency.fY));
-    SkScalar ratio = SK_Scalar1;
-    for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        SkScalar numer = (perlinNoiseShader.fType == kFractalNoise_Type) ?
-                            noise : SkScalarAbs(noise);
-        turbulenceFunctionResult += numer / ratio;
-        noiseVector.fX *= 2;
-        noiseVector.fY *= 2;
-        ratio *= 2;
-        if (perlinNoiseShader.fStitchTiles) {
-            // Update stitch values
+    auto paintingData = rec.fAlloc->make<PaintingData>(fTileSize, fSeed, fBaseFrequencyX,
+                                                       fBaseFrequencyY, matrix);
+
+    auto ctx = rec.fAlloc->make<SkJumper_PerlinNoiseCtx>();
+    // The same (1,1) translation for WebKit's 1 based noise coordinates as the context uses.
+    ctx->translate[0] = -matrix.getTranslateX() + SK_Scalar1;
+    ctx->translate[1] = -matrix.getTranslateY() + SK_Scalar1;
+    ctx->baseFrequency[0] = paintingData->fBaseFrequency.fX;
+    ctx->baseFrequency[1] = paintingData->fBaseFrequency.fY;
+    ctx->octaves = fNumOctaves;
+    ctx->turbulence = kTurbulence_Type == fType;
+    ctx->stitch = nullptr;
+    if (fStitchTiles && fNumOctaves > 0) {
+        // Each octave doubles the frequency, and with it the size of the stitched tile.
+        float* stitch = rec.fAlloc->makeArrayDefault<float>(4 * fNumOctaves);
+        StitchData stitchData = paintingData->fStitchDataInit;
+        for (int octave = 0; octave < fNumOctaves; ++octave) {
+            stitch[4 * octave + 0] = SkIntToScalar(stitchData.fWidth);
+            stitch[4 * octave + 1] = SkIntToScalar(stitchData.fWrapX);
+            stitch[4 * octave + 2] = SkIntToScalar(stitchData.fHeight);
+            stitch[4 * octave + 3] = SkIntToScalar(stitchData.fWrapY);
             stitchData = StitchData(SkIntToScalar(stitchData.fWidth)  * 2,
                                     SkIntToScalar(stitchData.fHeight) * 2);
         }
+        ctx->stitch = stitch;
     }
-
-    // The value of turbulenceFunctionResult comes from ((turbulenceFunctionResult) + 1) / 2
-    // by fractalNoise and (turbulenceFunctionResult) by turbulence.
-    if (perlinNoiseShader.fType == kFractalNoise_Type) {
-        turbulenceFunctionResult = SkScalarHalf(turbulenceFunctionResult + 1);
+    for (int channel = 0; channel < 4; ++channel) {
+        ctx->gradient[channel] = &paintingData->fGradient[channel][0].fX;
     }
-
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult *= SkIntToScalar(getPaintAlpha()) / 255;
+    for (int i = 0; i < kBlockSize; ++i) {
+        ctx->latticeSelector[i] = paintingData->fLatticeSelector[i];
     }
 
-    // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
+    rec.fPipeline->append(SkRasterPipeline::seed_shader);
+    rec.fPipeline->append(SkRasterPipeline::perlin_noise, ctx);
+    rec.fPipeline->append(SkRasterPipeline::premul);
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -627,8 +550,7 @@ SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateImprovedNoi
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
-        const SkPoint& point, StitchData& stitchData) const {
-    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
+        const SkPoint& point) const {
     SkPoint newPoint;
     fMatrix.mapPoints(&newPoint, &point, 1);
     newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
@@ -636,13 +558,7 @@ SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
 
     U8CPU rgba[4];
     for (int channel = 3; channel >= 0; --channel) {
-        SkScalar value;
-        if (perlinNoiseShader.fType == kImprovedNoise_Type) {
-            value = calculateImprovedNoiseValueForPoint(channel, newPoint);
-        }
-        else {
-            value = calculateTurbulenceValueForPoint(channel, stitchData, newPoint);
-        }
+        SkScalar value = calculateImprovedNoiseValueForPoint(channel, newPoint);
         rgba[channel] = SkScalarFloorToInt(255 * value);
     }
     return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
@@ -651,6 +567,10 @@ SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
 #ifdef SK_ENABLE_LEGACY_SHADERCONTEXT
 SkShaderBase::Context* SkPerlinNoiseShaderImpl::onMakeContext(const ContextRec& rec,
                                                               SkArenaAlloc* alloc) const {
+    if (kImprovedNoise_Type != fType) {
+        // Fractal noise and turbulence only run in SkRasterPipeline.
+        return nullptr;
+    }
     return alloc->make<PerlinNoiseShaderContext>(*this, rec);
 }
 #endif
@@ -669,8 +589,6 @@ SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
         const SkPerlinNoiseShaderImpl& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
     , fMatrix(total_matrix(rec, shader)) // used for temp storage, adjusted below
-    , fPaintingData(shader.fTileSize, shader.fSeed, shader.fBaseFrequencyX,
-                    shader.fBaseFrequencyY, fMatrix)
 {
     // This (1,1) translation is due to WebKit's 1 based coordinates for the noise
     // (as opposed to 0 based, usually). The same adjustment is in the setData() function.
@@ -681,9 +599,8 @@ SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
 void SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shadeSpan(
         int x, int y, SkPMColor result[], int count) {
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
-    StitchData stitchData;
     for (int i = 0; i < count; ++i) {
-        result[i] = shade(point, stitchData);
+        result[i] = shade(point);
         point.fX += SK_Scalar1;
     }
 }
@@ -172,11 +172,26 @@ void SkPictureShader::flatten(SkWriteBuffer& buffer) const {
     SkPicturePriv::Flatten(fPicture, buffer);
 }
 
+// Tiles are rasterized at quarter-octave scales, rounding up, so that small zoom changes share one
+// instead of each rasterizing the picture again.
+static constexpr int kScaleBucketsPerOctave = 4;
+
+// Returns the scale of the bucket containing |scale|, or of one |bucketsUp| buckets above it.
+static SkScalar bucket_scale(SkScalar scale, int bucketsUp) {
+    if (!(scale > 0) || !SkScalarIsFinite(scale)) {
+        return scale;
+    }
+    // A little slack keeps scales a rounding error above a bucket (e.g. 1.0000001) in it.
+    SkScalar bucket = SkScalarCeilToScalar(SkScalarLog2(scale) * kScaleBucketsPerOctave - 0.01f);
+    return SkScalarPow(2, (bucket + bucketsUp) / kScaleBucketsPerOctave);
+}
+
 // Returns a cached image shader, which wraps a single picture tile at the given
 // CTM/local matrix.  Also adjusts the local matrix for tile scaling.
 sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
                                                  SkTCopyOnFirstWrite<SkMatrix>* localMatrix,
                                                  SkColorSpace* dstColorSpace,
+                                                 SkFilterQuality filterQuality,
                                                  const int maxTextureSize) const {
     SkASSERT(fPicture && !fPicture->cullRect().isEmpty());
 
@@ -192,37 +207,50 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
         scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
                   SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
     }
-    SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.x() * fTile.width()),
-                                     SkScalarAbs(scale.y() * fTile.height()));
-
-    // Clamp the tile size to about 4M pixels
-    static const SkScalar kMaxTileArea = 2048 * 2048;
-    SkScalar tileArea = scaledSize.width() * scaledSize.height();
-    if (tileArea > kMaxTileArea) {
-        SkScalar clampScale = SkScalarSqrt(kMaxTileArea / tileArea);
-        scaledSize.set(scaledSize.width() * clampScale,
-                       scaledSize.height() * clampScale);
-    }
+
+    struct Tile {
+        SkISize fSize;
+        SkSize  fScale;
+    };
+    auto tileFor = [&](int bucketsUp) {
+        SkSize scaledSize =
+                SkSize::Make(bucket_scale(SkScalarAbs(scale.x()), bucketsUp) * fTile.width(),
+                             bucket_scale(SkScalarAbs(scale.y()), bucketsUp) * fTile.height());
+
+        // Clamp the tile size to about 4M pixels
+        static const SkScalar kMaxTileArea = 2048 * 2048;
+        SkScalar tileArea = scaledSize.width() * scaledSize.height();
+        if (tileArea > kMaxTileArea) {
+            SkScalar clampScale = SkScalarSqrt(kMaxTileArea / tileArea);
+            scaledSize.set(scaledSize.width() * clampScale,
+                           scaledSize.height() * clampScale);
+        }
 #if SK_SUPPORT_GPU
-    // Scale down the tile size if larger than maxTextureSize for GPU Path or it should fail on create texture
-    if (maxTextureSize) {
-        if (scaledSize.width() > maxTextureSize || scaledSize.height() > maxTextureSize) {
-            SkScalar downScale = maxTextureSize / SkMaxScalar(scaledSize.width(), scaledSize.height());
-            scaledSize.set(SkScalarFloorToScalar(scaledSize.width() * downScale),
-                           SkScalarFloorToScalar(scaledSize.height() * downScale));
+        // Scale down the tile size if larger than maxTextureSize for GPU Path or it should fail
+        // on create texture
+        if (maxTextureSize) {
+            if (scaledSize.width() > maxTextureSize || scaledSize.height() > maxTextureSize) {
+                SkScalar downScale = maxTextureSize / SkMaxScalar(scaledSize.width(),
+                                                                  scaledSize.height());
+                scaledSize.set(SkScalarFloorToScalar(scaledSize.width() * downScale),
+                               SkScalarFloorToScalar(scaledSize.height() * downScale));
+            }
         }
-    }
 #endif
 
-    const SkISize tileSize = scaledSize.toCeil();
-    if (tileSize.isEmpty()) {
+        Tile tile;
+        tile.fSize = scaledSize.toCeil();
+        // The actual scale, compensating for rounding & clamping.
+        tile.fScale = SkSize::Make(SkIntToScalar(tile.fSize.width()) / fTile.width(),
+                                   SkIntToScalar(tile.fSize.height()) / fTile.height());
+        return tile;
+    };
+
+    Tile tile = tileFor(0);
+    if (tile.fSize.isEmpty()) {
         return SkShader::MakeEmptyShader();
     }
 
-    // The actual scale, compensating for rounding & clamping.
-    const SkSize tileScale = SkSize::Make(SkIntToScalar(tileSize.width()) / fTile.width(),
-                                          SkIntToScalar(tileSize.height()) / fTile.height());
-
     // |fColorSpace| will only be set when using an SkColorSpaceXformCanvas to do pre-draw xforms.
     // This canvas is strictly for legacy mode.  A non-null |dstColorSpace| indicates that we
     // should perform color correct rendering and xform at draw time.
@@ -231,21 +259,31 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
     bool hasDstColorSpace = SkToBool(dstColorSpace);
 
     sk_sp<SkShader> tileShader;
-    BitmapShaderKey key(std::move(keyCS),
-                        fUniqueID,
-                        fTile,
-                        fTmx,
-                        fTmy,
-                        tileScale,
-                        hasDstColorSpace);
-
-    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+    auto findTile = [&](const Tile& t) {
+        BitmapShaderKey key(keyCS, fUniqueID, fTile, fTmx, fTmy, t.fScale, hasDstColorSpace);
+        return SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader);
+    };
+
+    bool found = findTile(tile);
+    // Mip-mapped sampling filters a tile up to an octave larger down to what this one would be,
+    // so one that is already cached is as good as a new tile at this scale.
+    const bool mipMapped = filterQuality >= kMedium_SkFilterQuality;
+    for (int bucketsUp = 1; !found && mipMapped && bucketsUp <= kScaleBucketsPerOctave;
+         ++bucketsUp) {
+        Tile larger = tileFor(bucketsUp);
+        if (larger.fSize != tile.fSize && findTile(larger)) {
+            tile = larger;
+            found = true;
+        }
+    }
+
+    if (!found) {
         SkMatrix tileMatrix;
-        tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
+        tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tile.fSize.width(), tile.fSize.height()),
                                  SkMatrix::kFill_ScaleToFit);
 
         sk_sp<SkImage> tileImage = SkImage::MakeFromGenerator(
-                SkPictureImageGenerator::Make(tileSize, fPicture, &tileMatrix, nullptr,
+                SkPictureImageGenerator::Make(tile.fSize, fPicture, &tileMatrix, nullptr,
                                               SkImage::BitDepth::kU8, sk_ref_sp(dstColorSpace)));
         if (!tileImage) {
             return nullptr;
@@ -257,12 +295,14 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
 
         tileShader = tileImage->makeShader(fTmx, fTmy);
 
+        BitmapShaderKey key(std::move(keyCS), fUniqueID, fTile, fTmx, fTmy, tile.fScale,
+                            hasDstColorSpace);
         SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get()));
         fAddedToCache.store(true);
     }
 
-    if (tileScale.width() != 1 || tileScale.height() != 1) {
-        localMatrix->writable()->preScale(1 / tileScale.width(), 1 / tileScale.height());
+    if (tile.fScale.width() != 1 || tile.fScale.height() != 1) {
+        localMatrix->writable()->preScale(1 / tile.fScale.width(), 1 / tile.fScale.height());
     }
 
     return tileShader;
@@ -273,7 +313,8 @@ bool SkPictureShader::onAppendStages(const StageRec& rec) const {
 
     // Keep bitmapShader alive by using alloc instead of stack memory
     auto& bitmapShader = *rec.fAlloc->make<sk_sp<SkShader>>();
-    bitmapShader = this->refBitmapShader(rec.fCTM, &lm, rec.fDstCS);
+    bitmapShader = this->refBitmapShader(rec.fCTM, &lm, rec.fDstCS,
+                                         rec.fPaint.getFilterQuality());
 
     if (!bitmapShader) {
         return false;
@@ -291,7 +332,8 @@ bool SkPictureShader::onAppendStages(const StageRec& rec) const {
 SkShaderBase::Context* SkPictureShader::onMakeContext(const ContextRec& rec, SkArenaAlloc* alloc)
 const {
     auto lm = this->totalLocalMatrix(rec.fLocalMatrix);
-    sk_sp<SkShader> bitmapShader = this->refBitmapShader(*rec.fMatrix, &lm, rec.fDstColorSpace);
+    sk_sp<SkShader> bitmapShader = this->refBitmapShader(*rec.fMatrix, &lm, rec.fDstColorSpace,
+                                                         rec.fPaint->getFilterQuality());
     if (!bitmapShader) {
         return nullptr;
     }
@@ -351,7 +393,7 @@ std::unique_ptr<GrFragmentProcessor> SkPictureShader::asFragmentProcessor(
     auto lm = this->totalLocalMatrix(args.fPreLocalMatrix, args.fPostLocalMatrix);
     sk_sp<SkShader> bitmapShader(this->refBitmapShader(*args.fViewMatrix, &lm,
                                                        args.fDstColorSpaceInfo->colorSpace(),
-                                                       maxTextureSize));
+                                                       args.fFilterQuality, maxTextureSize));
     if (!bitmapShader) {
         return nullptr;
     }
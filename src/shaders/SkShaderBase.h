@@ -32,6 +32,18 @@ struct SkImageInfo;
 class SkPaint;
 class SkRasterPipeline;
 
+/**
+ *  Returned by SkShaderBase::appendUpdatableStages(): re-targets stages that were already appended
+ *  to a pipeline at a new CTM and local matrix, without rebuilding the pipeline.
+ */
+class SkStageUpdater {
+public:
+    virtual ~SkStageUpdater() {}
+
+    // Returns false if the stages can't draw with these matrices; draw nothing in that case.
+    virtual bool update(const SkMatrix& ctm, const SkMatrix* localM) = 0;
+};
+
 class SkShaderBase : public SkShader {
 public:
     ~SkShaderBase() override;
@@ -182,6 +194,13 @@ public:
     // If this returns false, then we draw nothing (do not fall back to shader context)
     bool appendStages(const StageRec&) const;
 
+    // Like appendStages(), but the returned updater (owned by rec.fAlloc) can later move the
+    // stages to another CTM and local matrix, which is much cheaper than building a new pipeline
+    // for each.  Returns nullptr, having appended nothing, if the shader can't do that.
+    SkStageUpdater* appendUpdatableStages(const StageRec& rec) const {
+        return this->onAppendUpdatableStages(rec);
+    }
+
     bool SK_WARN_UNUSED_RESULT computeTotalInverse(const SkMatrix& ctm,
                                                    const SkMatrix* outerLocalMatrix,
                                                    SkMatrix* totalInverse) const;
@@ -233,6 +252,8 @@ protected:
     // Default impl creates shadercontext and calls that (not very efficient)
     virtual bool onAppendStages(const StageRec&) const;
 
+    virtual SkStageUpdater* onAppendUpdatableStages(const StageRec&) const { return nullptr; }
+
 private:
     // This is essentially const, but not officially so it can be modified in constructors.
     SkMatrix fLocalMatrix;
@@ -10,6 +10,7 @@
 #include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformer.h"
 #include "SkConvertPixels.h"
+#include "SkData.h"
 #include "SkFlattenablePriv.h"
 #include "SkFloatBits.h"
 #include "SkGradientShaderPriv.h"
@@ -273,7 +274,125 @@ static void init_stop_pos(
     add_stop_color(ctx, stop, Fs, Bs);
 }
 
+// Resamples the (arbitrarily spaced) stops in ctx into the 8 planes (fs then bs) of an evenly
+// spaced gradient with a power of two number of intervals, so that t * intervals is exact.
+// Intervals that fall inside one stop interval keep its factor and bias, so they are exact. The
+// ones that straddle stops are a chord, and the fewest intervals that keep every chord within
+// half of an 8-bit step are used. Returns empty data when even the most intervals we allow
+// can't, e.g. across hard stops. If t will be clamped, the colors outside [0,1] must match.
+static sk_sp<SkData> resample_stops(const SkJumper_GradientCtx& ctx, bool clamped) {
+    static constexpr float kMaxError = 0.5f / 255;
+
+    // The stop interval containing t (or ending at t, for right ends), and the color there.
+    auto interval = [&ctx](float t, bool rightEnd) {
+        size_t i = 0;
+        while (i + 1 < ctx.stopCount && (rightEnd ? t > ctx.ts[i + 1] : t >= ctx.ts[i + 1])) {
+            i++;
+        }
+        return i;
+    };
+    auto color = [&ctx](size_t i, float t, int c) {
+        return ctx.fs[c][i] * t + ctx.bs[c][i];
+    };
+
+    const size_t first = interval(0, false),
+                 last  = interval(1, false);
+    for (int c = 0; clamped && c < 4; ++c) {
+        if (SkTAbs(color(0, 0, c) - color(first, 0, c)) > kMaxError ||
+            SkTAbs(color(ctx.stopCount - 1, 1, c) - color(last, 1, c)) > kMaxError) {
+            return SkData::MakeEmpty();
+        }
+    }
+
+    for (int intervals = 256; intervals <= 1024; intervals *= 2) {
+        const int stops = intervals + 1;
+        sk_sp<SkData> resampled = SkData::MakeUninitialized(8 * stops * sizeof(float));
+        float* data = static_cast<float*>(resampled->writable_data());
+
+        bool accurate = true;
+        for (int k = 0; accurate && k < intervals; ++k) {
+            float t_l = k / (float)intervals,
+                  t_r = (k + 1) / (float)intervals;
+            size_t i_l = interval(t_l, false),
+                   i_r = interval(t_r, true);
+            for (int c = 0; c < 4; ++c) {
+                float* fs = data + c * stops;
+                float* bs = data + (c + 4) * stops;
+                if (i_l == i_r) {
+                    fs[k] = ctx.fs[c][i_l];
+                    bs[k] = ctx.bs[c][i_l];
+                    continue;
+                }
+                float c_l = color(i_l, t_l, c),
+                      c_r = color(i_r, t_r, c);
+                fs[k] = (c_r - c_l) * intervals;
+                bs[k] = c_l - fs[k] * t_l;
+                // The chord is furthest from the stops' colors at the stops themselves.
+                for (size_t i = i_l + 1; i <= i_r; ++i) {
+                    if (SkTAbs(fs[k] * ctx.ts[i] + bs[k] - color(i, ctx.ts[i], c)) > kMaxError) {
+                        accurate = false;
+                    }
+                }
+            }
+        }
+        if (!accurate) {
+            continue;
+        }
+        // Like the evenly spaced stops, t == 1 lands on a constant color of its own.
+        for (int c = 0; c < 4; ++c) {
+            data[c * stops + intervals] = 0;
+            data[(c + 4) * stops + intervals] = color(last, 1, c);
+        }
+        return resampled;
+    }
+    return SkData::MakeEmpty();
+}
+
+SkJumper_GradientCtx* SkGradientShaderBase::resampleStops(SkArenaAlloc* alloc,
+                                                          const SkJumper_GradientCtx& ctx,
+                                                          SkColorSpace* dstCS) const {
+    const bool clamped = fTileMode == kClamp_TileMode || fTileMode == kDecal_TileMode;
+
+    sk_sp<SkData> resampled;
+    {
+        SkAutoMutexAcquire lock(fResampledMutex);
+        if (fResampledStops && SkColorSpace::Equals(fResampledColorSpace.get(), dstCS)) {
+            resampled = fResampledStops;
+        }
+    }
+    if (!resampled) {
+        resampled = resample_stops(ctx, clamped);
+
+        SkAutoMutexAcquire lock(fResampledMutex);
+        fResampledStops = resampled;
+        fResampledColorSpace = sk_ref_sp(dstCS);
+    }
+    if (resampled->isEmpty()) {
+        return nullptr;
+    }
+
+    // The pipeline reads the resampled stops after this returns, so it keeps them alive.
+    const size_t stops = resampled->size() / (8 * sizeof(float));
+    float* data = static_cast<float*>(const_cast<void*>(
+            alloc->make<sk_sp<SkData>>(std::move(resampled))->get()->data()));
+
+    auto* resampledCtx = alloc->make<SkJumper_GradientCtx>();
+    resampledCtx->stopCount = stops;
+    for (int c = 0; c < 4; ++c) {
+        resampledCtx->fs[c] = data + c * stops;
+        resampledCtx->bs[c] = data + (c + 4) * stops;
+    }
+    resampledCtx->ts = nullptr;
+    resampledCtx->interpolatedInPremul = ctx.interpolatedInPremul;
+    return resampledCtx;
+}
+
 bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
+    return this->appendStagesSearchingUpTo(rec, kMaxSearchedStops);
+}
+
+bool SkGradientShaderBase::appendStagesSearchingUpTo(const StageRec& rec,
+                                                     int maxSearchedStops) const {
     SkRasterPipeline* p = rec.fPipeline;
     SkArenaAlloc* alloc = rec.fAlloc;
     SkJumper_DecalTileCtx* decal_ctx = nullptr;
@@ -340,9 +459,9 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
         // Note: In order to handle clamps in search, the search assumes a stop conceptully placed
         // at -inf. Therefore, the max number of stops is fColorCount+1.
         for (int i = 0; i < 4; i++) {
-            // Allocate at least at for the AVX2 gather from a YMM register.
-            ctx->fs[i] = alloc->makeArray<float>(std::max(fColorCount+1, 8));
-            ctx->bs[i] = alloc->makeArray<float>(std::max(fColorCount+1, 8));
+            // Allocate at least 16 for the AVX-512 gather from a ZMM register.
+            ctx->fs[i] = alloc->makeArray<float>(std::max(fColorCount+1, 16));
+            ctx->bs[i] = alloc->makeArray<float>(std::max(fColorCount+1, 16));
         }
 
         if (fOrigPos == nullptr) {
@@ -400,7 +519,18 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
             add_const_color(ctx, stopCount++, c_l);
 
             ctx->stopCount = stopCount;
-            p->append(SkRasterPipeline::gradient, ctx);
+            SkJumper_GradientCtx* resampled = nullptr;
+            if ((int)stopCount > maxSearchedStops) {
+                resampled = this->resampleStops(alloc, *ctx, rec.fDstCS);
+            }
+            if (resampled) {
+                if (fTileMode == kClamp_TileMode || fTileMode == kDecal_TileMode) {
+                    p->append(SkRasterPipeline::clamp_x_1);
+                }
+                p->append(SkRasterPipeline::evenly_spaced_gradient, resampled);
+            } else {
+                p->append(SkRasterPipeline::gradient, ctx);
+            }
         }
     }
 
@@ -12,6 +12,7 @@
 
 #include "SkArenaAlloc.h"
 #include "SkMatrix.h"
+#include "SkMutex.h"
 #include "SkPM4f.h"
 #include "SkShaderBase.h"
 #include "SkTArray.h"
@@ -19,9 +20,11 @@
 
 class SkColorSpace;
 class SkColorSpaceXformer;
+class SkData;
 class SkRasterPipeline;
 class SkReadBuffer;
 class SkWriteBuffer;
+struct SkJumper_GradientCtx;
 
 class SkGradientShaderBase : public SkShaderBase {
 public:
@@ -68,6 +71,15 @@ public:
 
     const SkMatrix& getGradientMatrix() const { return fPtsToUnit; }
 
+    // Raster pipelines search for the stop interval of each pixel when the stops are not evenly
+    // spaced. Gradients with more stops than this are instead resampled into evenly spaced
+    // intervals that are indexed directly, when that is accurate.
+    static constexpr int kMaxSearchedStops = 8;
+
+    // Like appendStages(), but only resamples gradients with more than maxSearchedStops stops.
+    // INT_MAX always searches. Exposed for testing.
+    bool appendStagesSearchingUpTo(const StageRec&, int maxSearchedStops) const;
+
 protected:
     class GradientShaderBase4fContext;
 
@@ -123,6 +135,11 @@ public:
     TileMode getTileMode() const { return fTileMode; }
 
 private:
+    // Returns an evenly spaced resampling of the (arbitrarily spaced) stops in ctx, cached for
+    // the last destination color space it was made for, or nullptr if it would not be accurate.
+    SkJumper_GradientCtx* resampleStops(SkArenaAlloc*, const SkJumper_GradientCtx& ctx,
+                                        SkColorSpace* dstCS) const;
+
     // Reserve inline space for up to 4 stops.
     static constexpr size_t kInlineStopCount   = 4;
     static constexpr size_t kInlineStorageSize = (sizeof(SkColor4f) + sizeof(SkScalar))
@@ -131,6 +148,10 @@ private:
 
     bool                                        fColorsAreOpaque;
 
+    mutable SkMutex                             fResampledMutex;
+    mutable sk_sp<SkData>                       fResampledStops;
+    mutable sk_sp<SkColorSpace>                 fResampledColorSpace;
+
     typedef SkShaderBase INHERITED;
 };
 
@@ -0,0 +1,446 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLCommonSubexpressions.h"
+
+#include "SkSLCompiler.h"
+#include "ir/SkSLAppendStage.h"
+#include "ir/SkSLBinaryExpression.h"
+#include "ir/SkSLBlock.h"
+#include "ir/SkSLConstructor.h"
+#include "ir/SkSLDoStatement.h"
+#include "ir/SkSLExpressionStatement.h"
+#include "ir/SkSLFieldAccess.h"
+#include "ir/SkSLForStatement.h"
+#include "ir/SkSLFunctionCall.h"
+#include "ir/SkSLIfStatement.h"
+#include "ir/SkSLIndexExpression.h"
+#include "ir/SkSLPostfixExpression.h"
+#include "ir/SkSLPrefixExpression.h"
+#include "ir/SkSLReturnStatement.h"
+#include "ir/SkSLSwitchStatement.h"
+#include "ir/SkSLSwizzle.h"
+#include "ir/SkSLTernaryExpression.h"
+#include "ir/SkSLVarDeclarationsStatement.h"
+#include "ir/SkSLVariableReference.h"
+#include "ir/SkSLWhileStatement.h"
+
+#include <algorithm>
+
+namespace SkSL {
+
+static void children(Expression* e, std::vector<std::unique_ptr<Expression>*>* out) {
+    switch (e->fKind) {
+        case Expression::kAppendStage_Kind:
+            for (auto& arg : ((AppendStage*) e)->fArguments) {
+                out->push_back(&arg);
+            }
+            break;
+        case Expression::kBinary_Kind:
+            out->push_back(&((BinaryExpression*) e)->fLeft);
+            out->push_back(&((BinaryExpression*) e)->fRight);
+            break;
+        case Expression::kConstructor_Kind:
+            for (auto& arg : ((Constructor*) e)->fArguments) {
+                out->push_back(&arg);
+            }
+            break;
+        case Expression::kFieldAccess_Kind:
+            out->push_back(&((FieldAccess*) e)->fBase);
+            break;
+        case Expression::kFunctionCall_Kind:
+            for (auto& arg : ((FunctionCall*) e)->fArguments) {
+                out->push_back(&arg);
+            }
+            break;
+        case Expression::kIndex_Kind:
+            out->push_back(&((IndexExpression*) e)->fBase);
+            out->push_back(&((IndexExpression*) e)->fIndex);
+            break;
+        case Expression::kPrefix_Kind:
+            out->push_back(&((PrefixExpression*) e)->fOperand);
+            break;
+        case Expression::kPostfix_Kind:
+            out->push_back(&((PostfixExpression*) e)->fOperand);
+            break;
+        case Expression::kSwizzle_Kind:
+            out->push_back(&((Swizzle*) e)->fBase);
+            break;
+        case Expression::kTernary_Kind:
+            out->push_back(&((TernaryExpression*) e)->fTest);
+            out->push_back(&((TernaryExpression*) e)->fIfTrue);
+            out->push_back(&((TernaryExpression*) e)->fIfFalse);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Appends every variable read by the expression, in evaluation order. Returns false if the
+ * expression writes to any variable (e.g. through an out parameter of an intrinsic), as such an
+ * expression cannot be replaced by a previously computed value.
+ */
+static bool collect_references(const Expression& e, std::vector<const Variable*>* out) {
+    if (e.fKind == Expression::kVariableReference_Kind) {
+        const VariableReference& ref = (const VariableReference&) e;
+        out->push_back(&ref.fVariable);
+        return ref.refKind() == VariableReference::kRead_RefKind;
+    }
+    std::vector<std::unique_ptr<Expression>*> args;
+    children((Expression*) &e, &args);
+    for (auto arg : args) {
+        if (!collect_references(**arg, out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if the expression does enough work that reusing an earlier result is worthwhile.
+ * Plain variables, literals, and swizzles or casts of them are cheaper to recompute.
+ */
+static bool is_worth_caching(const Expression& e) {
+    switch (e.fKind) {
+        case Expression::kBinary_Kind:
+            return !Compiler::IsAssignment(((const BinaryExpression&) e).fOperator);
+        case Expression::kFunctionCall_Kind:
+        case Expression::kTernary_Kind:
+            return true;
+        case Expression::kConstructor_Kind:
+            for (const auto& arg : ((const Constructor&) e).fArguments) {
+                if (is_worth_caching(*arg)) {
+                    return true;
+                }
+            }
+            return false;
+        case Expression::kFieldAccess_Kind:
+            return is_worth_caching(*((const FieldAccess&) e).fBase);
+        case Expression::kIndex_Kind:
+            return is_worth_caching(*((const IndexExpression&) e).fBase) ||
+                   is_worth_caching(*((const IndexExpression&) e).fIndex);
+        case Expression::kPrefix_Kind: {
+            const PrefixExpression& p = (const PrefixExpression&) e;
+            return p.fOperator != Token::PLUSPLUS && p.fOperator != Token::MINUSMINUS &&
+                   is_worth_caching(*p.fOperand);
+        }
+        case Expression::kSwizzle_Kind:
+            return is_worth_caching(*((const Swizzle&) e).fBase);
+        default:
+            return false;
+    }
+}
+
+static void collect_writes(const Expression& e, CommonSubexpressionEliminator::Writes* writes) {
+    switch (e.fKind) {
+        case Expression::kVariableReference_Kind: {
+            const VariableReference& ref = (const VariableReference&) e;
+            if (ref.refKind() != VariableReference::kRead_RefKind) {
+                writes->fVariables.insert(&ref.fVariable);
+            }
+            return;
+        }
+        case Expression::kAppendStage_Kind:
+            writes->fHasSideEffects = true;
+            break;
+        case Expression::kFunctionCall_Kind:
+            if (((const FunctionCall&) e).fFunction.fModifiers.fFlags &
+                Modifiers::kHasSideEffects_Flag) {
+                writes->fHasSideEffects = true;
+            }
+            break;
+        default:
+            break;
+    }
+    std::vector<std::unique_ptr<Expression>*> args;
+    children((Expression*) &e, &args);
+    for (auto arg : args) {
+        collect_writes(**arg, writes);
+    }
+}
+
+static void collect_writes(const Statement& s, CommonSubexpressionEliminator::Writes* writes) {
+    switch (s.fKind) {
+        case Statement::kBlock_Kind:
+            for (const auto& child : ((const Block&) s).fStatements) {
+                collect_writes(*child, writes);
+            }
+            break;
+        case Statement::kDo_Kind:
+            collect_writes(*((const DoStatement&) s).fStatement, writes);
+            collect_writes(*((const DoStatement&) s).fTest, writes);
+            break;
+        case Statement::kExpression_Kind:
+            collect_writes(*((const ExpressionStatement&) s).fExpression, writes);
+            break;
+        case Statement::kFor_Kind: {
+            const ForStatement& f = (const ForStatement&) s;
+            if (f.fInitializer) {
+                collect_writes(*f.fInitializer, writes);
+            }
+            if (f.fTest) {
+                collect_writes(*f.fTest, writes);
+            }
+            if (f.fNext) {
+                collect_writes(*f.fNext, writes);
+            }
+            collect_writes(*f.fStatement, writes);
+            break;
+        }
+        case Statement::kIf_Kind: {
+            const IfStatement& i = (const IfStatement&) s;
+            collect_writes(*i.fTest, writes);
+            collect_writes(*i.fIfTrue, writes);
+            if (i.fIfFalse) {
+                collect_writes(*i.fIfFalse, writes);
+            }
+            break;
+        }
+        case Statement::kReturn_Kind:
+            if (((const ReturnStatement&) s).fExpression) {
+                collect_writes(*((const ReturnStatement&) s).fExpression, writes);
+            }
+            break;
+        case Statement::kSwitch_Kind: {
+            const SwitchStatement& sw = (const SwitchStatement&) s;
+            collect_writes(*sw.fValue, writes);
+            for (const auto& c : sw.fCases) {
+                for (const auto& child : c->fStatements) {
+                    collect_writes(*child, writes);
+                }
+            }
+            break;
+        }
+        case Statement::kVarDeclarations_Kind:
+            for (const auto& decl : ((const VarDeclarationsStatement&) s).fDeclaration->fVars) {
+                if (decl->fKind == Statement::kVarDeclaration_Kind &&
+                    ((const VarDeclaration&) *decl).fValue) {
+                    collect_writes(*((const VarDeclaration&) *decl).fValue, writes);
+                }
+            }
+            break;
+        case Statement::kWhile_Kind:
+            collect_writes(*((const WhileStatement&) s).fTest, writes);
+            collect_writes(*((const WhileStatement&) s).fStatement, writes);
+            break;
+        default:
+            break;
+    }
+}
+
+void CommonSubexpressionEliminator::eliminate(FunctionDefinition& f) {
+    fValues.clear();
+    fDeclared.clear();
+    fDepth = 0;
+    this->scanStatement(f.fBody.get());
+}
+
+void CommonSubexpressionEliminator::replace(std::unique_ptr<Expression>* e) {
+    Expression& expr = **e;
+    if (fValues.size() && is_worth_caching(expr)) {
+        std::vector<const Variable*> references;
+        if (collect_references(expr, &references)) {
+            String key = expr.description();
+            for (const Value& v : fValues) {
+                if (v.fKey == key && v.fReferences == references &&
+                    v.fHolder->fType == expr.fType) {
+                    e->reset(new VariableReference(expr.fOffset, *v.fHolder));
+                    return;
+                }
+            }
+        }
+    }
+    std::vector<std::unique_ptr<Expression>*> args;
+    children(&expr, &args);
+    for (auto arg : args) {
+        this->replace(arg);
+    }
+}
+
+void CommonSubexpressionEliminator::record(const Variable& holder, const Expression& value) {
+    if (holder.fStorage != Variable::kLocal_Storage || holder.fType != value.fType ||
+        !is_worth_caching(value)) {
+        return;
+    }
+    std::vector<const Variable*> references;
+    if (!collect_references(value, &references) ||
+        std::find(references.begin(), references.end(), &holder) != references.end()) {
+        return;
+    }
+    fValues.push_back({ value.description(), std::move(references), &holder, fDepth });
+}
+
+void CommonSubexpressionEliminator::invalidate(const Writes& writes) {
+    auto written = [&writes](const Variable* v) {
+        return writes.fVariables.count(v) ||
+               (writes.fHasSideEffects && v->fStorage == Variable::kGlobal_Storage);
+    };
+    fValues.erase(std::remove_if(fValues.begin(), fValues.end(), [&written](const Value& v) {
+        return written(v.fHolder) ||
+               std::any_of(v.fReferences.begin(), v.fReferences.end(), written);
+    }), fValues.end());
+}
+
+void CommonSubexpressionEliminator::exitScope(const std::vector<const Variable*>& declared) {
+    // values held in variables that are going out of scope can no longer be referenced, and
+    // values computed in a conditional scope may not have been computed at all
+    int depth = fDepth;
+    fValues.erase(std::remove_if(fValues.begin(), fValues.end(), [&](const Value& v) {
+        return v.fDepth > depth ||
+               std::find(declared.begin(), declared.end(), v.fHolder) != declared.end();
+    }), fValues.end());
+}
+
+void CommonSubexpressionEliminator::scanConditional(Statement* s) {
+    ++fDepth;
+    fDeclared.emplace_back();
+    this->scanStatement(s);
+    --fDepth;
+    this->exitScope(fDeclared.back());
+    fDeclared.pop_back();
+}
+
+void CommonSubexpressionEliminator::scanLoop(const Statement& loop, Statement* initializer,
+                                             std::unique_ptr<Expression>* test, Statement* body) {
+    // later iterations see the writes made anywhere in the loop, so values depending on them are
+    // unusable even before we reach the writing statement
+    Writes writes;
+    collect_writes(loop, &writes);
+    this->invalidate(writes);
+    ++fDepth;
+    fDeclared.emplace_back();
+    if (initializer) {
+        this->scanStatement(initializer);
+    }
+    if (*test && !(*test)->hasSideEffects()) {
+        this->replace(test);
+    }
+    this->scanStatement(body);
+    --fDepth;
+    this->exitScope(fDeclared.back());
+    fDeclared.pop_back();
+}
+
+void CommonSubexpressionEliminator::scanStatement(Statement* s) {
+    switch (s->fKind) {
+        case Statement::kBlock_Kind:
+            fDeclared.emplace_back();
+            for (auto& child : ((Block*) s)->fStatements) {
+                this->scanStatement(child.get());
+            }
+            this->exitScope(fDeclared.back());
+            fDeclared.pop_back();
+            break;
+        case Statement::kVarDeclarations_Kind:
+            for (auto& stmt : ((VarDeclarationsStatement*) s)->fDeclaration->fVars) {
+                if (stmt->fKind != Statement::kVarDeclaration_Kind) {
+                    continue;
+                }
+                VarDeclaration& decl = (VarDeclaration&) *stmt;
+                bool isConst = decl.fVar->fModifiers.fFlags & Modifiers::kConst_Flag;
+                if (decl.fValue) {
+                    if (!isConst && !decl.fValue->hasSideEffects()) {
+                        this->replace(&decl.fValue);
+                    }
+                    Writes writes;
+                    collect_writes(*decl.fValue, &writes);
+                    this->invalidate(writes);
+                    if (!isConst && !decl.fSizes.size() && !decl.fValue->hasSideEffects()) {
+                        this->record(*decl.fVar, *decl.fValue);
+                    }
+                }
+                if (fDeclared.size()) {
+                    fDeclared.back().push_back(decl.fVar);
+                }
+            }
+            break;
+        case Statement::kExpression_Kind: {
+            std::unique_ptr<Expression>& expr = ((ExpressionStatement*) s)->fExpression;
+            BinaryExpression* assignment = nullptr;
+            if (expr->fKind == Expression::kBinary_Kind &&
+                Compiler::IsAssignment(((BinaryExpression&) *expr).fOperator)) {
+                assignment = (BinaryExpression*) expr.get();
+                if (!assignment->fRight->hasSideEffects()) {
+                    this->replace(&assignment->fRight);
+                }
+            } else if (!expr->hasSideEffects()) {
+                this->replace(&expr);
+            }
+            Writes writes;
+            collect_writes(*expr, &writes);
+            this->invalidate(writes);
+            if (assignment && assignment->fOperator == Token::EQ &&
+                assignment->fLeft->fKind == Expression::kVariableReference_Kind &&
+                !assignment->fRight->hasSideEffects()) {
+                this->record(((VariableReference&) *assignment->fLeft).fVariable,
+                             *assignment->fRight);
+            }
+            break;
+        }
+        case Statement::kIf_Kind: {
+            IfStatement* i = (IfStatement*) s;
+            if (!i->fIsStatic && !i->fTest->hasSideEffects()) {
+                this->replace(&i->fTest);
+            }
+            Writes writes;
+            collect_writes(*i->fTest, &writes);
+            this->invalidate(writes);
+            this->scanConditional(i->fIfTrue.get());
+            if (i->fIfFalse) {
+                this->scanConditional(i->fIfFalse.get());
+            }
+            break;
+        }
+        case Statement::kFor_Kind: {
+            ForStatement* f = (ForStatement*) s;
+            this->scanLoop(*f, f->fInitializer.get(), &f->fTest, f->fStatement.get());
+            break;
+        }
+        case Statement::kWhile_Kind: {
+            WhileStatement* w = (WhileStatement*) s;
+            this->scanLoop(*w, nullptr, &w->fTest, w->fStatement.get());
+            break;
+        }
+        case Statement::kDo_Kind: {
+            DoStatement* d = (DoStatement*) s;
+            this->scanLoop(*d, nullptr, &d->fTest, d->fStatement.get());
+            break;
+        }
+        case Statement::kSwitch_Kind: {
+            SwitchStatement* sw = (SwitchStatement*) s;
+            if (!sw->fIsStatic && !sw->fValue->hasSideEffects()) {
+                this->replace(&sw->fValue);
+            }
+            Writes writes;
+            collect_writes(*sw, &writes);
+            this->invalidate(writes);
+            for (auto& c : sw->fCases) {
+                ++fDepth;
+                fDeclared.emplace_back();
+                for (auto& child : c->fStatements) {
+                    this->scanStatement(child.get());
+                }
+                --fDepth;
+                this->exitScope(fDeclared.back());
+                fDeclared.pop_back();
+            }
+            break;
+        }
+        case Statement::kReturn_Kind: {
+            std::unique_ptr<Expression>& value = ((ReturnStatement*) s)->fExpression;
+            if (value && !value->hasSideEffects()) {
+                this->replace(&value);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+}
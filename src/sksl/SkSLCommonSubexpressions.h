@@ -0,0 +1,76 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_COMMONSUBEXPRESSIONS
+#define SKSL_COMMONSUBEXPRESSIONS
+
+#include "ir/SkSLExpression.h"
+#include "ir/SkSLFunctionDefinition.h"
+#include "ir/SkSLVariable.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace SkSL {
+
+/**
+ * Replaces pure expressions which have already been computed into a local variable with a read of
+ * that variable. In the sequence:
+ *
+ * half4 color = texture(s, coords);
+ * ...
+ * sk_OutColor = texture(s, coords) * scale;
+ *
+ * the second texture lookup becomes a reference to 'color', provided neither 'color' nor 'coords'
+ * can have been written in between. Ganesh assembles fragment shaders out of independently
+ * generated processors, so this catches the lookups and transforms they redo between each other.
+ */
+class CommonSubexpressionEliminator {
+public:
+    CommonSubexpressionEliminator() {}
+
+    void eliminate(FunctionDefinition& f);
+
+    // the variables a statement or expression may assign, and whether it calls anything which
+    // could write to globals
+    struct Writes {
+        std::unordered_set<const Variable*> fVariables;
+        bool fHasSideEffects = false;
+    };
+
+private:
+    struct Value {
+        String fKey;
+        std::vector<const Variable*> fReferences;
+        const Variable* fHolder;
+        int fDepth;
+    };
+
+    void scanStatement(Statement* s);
+
+    void scanLoop(const Statement& loop, Statement* initializer, std::unique_ptr<Expression>* test,
+                  Statement* body);
+
+    void scanConditional(Statement* s);
+
+    void replace(std::unique_ptr<Expression>* e);
+
+    void record(const Variable& holder, const Expression& value);
+
+    void invalidate(const Writes& writes);
+
+    void exitScope(const std::vector<const Variable*>& declared);
+
+    std::vector<Value> fValues;
+    // variables declared by the enclosing blocks, innermost last
+    std::vector<std::vector<const Variable*>> fDeclared;
+    int fDepth = 0;
+};
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "SkSLCompiler.h"
 
 #include "SkSLCFGGenerator.h"
+#include "SkSLCommonSubexpressions.h"
 #include "SkSLCPPCodeGenerator.h"
 #include "SkSLGLSLCodeGenerator.h"
 #include "SkSLHCodeGenerator.h"
@@ -1299,6 +1300,13 @@ bool Compiler::optimize(Program& program) {
         for (auto& element : program) {
             if (element.fKind == ProgramElement::kFunction_Kind) {
                 this->scanCFG((FunctionDefinition&) element);
+                if (!fErrorCount && (program.fKind == Program::kVertex_Kind ||
+                                     program.fKind == Program::kFragment_Kind ||
+                                     program.fKind == Program::kGeometry_Kind)) {
+                    // the fragment processor and pipeline stage generators translate the IR
+                    // back into C++ that mirrors the source, so only real shaders are rewritten
+                    CommonSubexpressionEliminator().eliminate((FunctionDefinition&) element);
+                }
             }
         }
         fSource = nullptr;
@@ -1189,6 +1189,23 @@ void GLSLCodeGenerator::writeTypePrecision(const Type& type) {
     this->write(this->getTypePrecision(type));
 }
 
+// Ganesh's shaders are assembled out of independent processors, which frequently declare uniforms
+// their code ends up not using once it has been optimized. GL tolerates querying or setting a
+// uniform the shader doesn't have, so there's no reason to make the driver parse them.
+static bool is_dead_uniform(const Variable& var) {
+    return (var.fModifiers.fFlags & Modifiers::kUniform_Flag) && !var.fReadCount &&
+           !var.fWriteCount;
+}
+
+static bool all_dead_uniforms(const VarDeclarations& decl) {
+    for (const auto& stmt : decl.fVars) {
+        if (!is_dead_uniform(*((VarDeclaration&) *stmt).fVar)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void GLSLCodeGenerator::writeVarDeclarations(const VarDeclarations& decl, bool global) {
     if (!decl.fVars.size()) {
         return;
@@ -1196,6 +1213,9 @@ void GLSLCodeGenerator::writeVarDeclarations(const VarDeclarations& decl, bool g
     bool wroteType = false;
     for (const auto& stmt : decl.fVars) {
         VarDeclaration& var = (VarDeclaration&) *stmt;
+        if (global && is_dead_uniform(*var.fVar)) {
+            continue;
+        }
         if (wroteType) {
             this->write(", ");
         } else {
@@ -1450,6 +1470,9 @@ void GLSLCodeGenerator::writeProgramElement(const ProgramElement& e) {
                 int builtin = ((VarDeclaration&) *decl.fVars[0]).fVar->fModifiers.fLayout.fBuiltin;
                 if (builtin == -1) {
                     // normal var
+                    if (all_dead_uniforms(decl)) {
+                        break;
+                    }
                     this->writeVarDeclarations(decl, true);
                     this->writeLine();
                 } else if (builtin == SK_FRAGCOLOR_BUILTIN &&
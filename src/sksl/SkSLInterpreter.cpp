@@ -9,6 +9,7 @@
 
 #include "SkSLInterpreter.h"
 #include "ir/SkSLBinaryExpression.h"
+#include "ir/SkSLConstructor.h"
 #include "ir/SkSLExpressionStatement.h"
 #include "ir/SkSLForStatement.h"
 #include "ir/SkSLFunctionCall.h"
@@ -19,15 +20,30 @@
 #include "ir/SkSLPrefixExpression.h"
 #include "ir/SkSLProgram.h"
 #include "ir/SkSLStatement.h"
+#include "ir/SkSLSwizzle.h"
 #include "ir/SkSLTernaryExpression.h"
 #include "ir/SkSLVarDeclarations.h"
 #include "ir/SkSLVarDeclarationsStatement.h"
 #include "ir/SkSLVariableReference.h"
+#include "ir/SkSLWhileStatement.h"
+#include "SkArenaAlloc.h"
+#include "SkMutex.h"
+#include "SkNx.h"
 #include "SkRasterPipeline.h"
+#include "SkSLCompiler.h"
+#include "SkSLJIT.h"
 #include "../jumper/SkJumper.h"
 
 namespace SkSL {
 
+Interpreter::Interpreter(std::unique_ptr<Program> program, SkRasterPipeline* pipeline,
+                         std::vector<Value>* stack)
+: fProgram(std::move(program))
+, fPipeline(*pipeline)
+, fStack(*stack) {}
+
+Interpreter::~Interpreter() {}
+
 void Interpreter::run() {
     for (const auto& e : *fProgram) {
         if (ProgramElement::kFunction_Kind == e.fKind) {
@@ -213,13 +229,641 @@ Interpreter::StackIndex Interpreter::getLValue(const Expression& expr) {
     ABORT("unsupported lvalue");
 }
 
+static constexpr int kLanes = SkJumper_kMaxStride;
+static_assert(0 == kLanes % 4, "the byte code runs four lanes at a time");
+
+struct Interpreter::ByteCode {
+    enum class Op {
+        kConst,       // dst = imm
+        kCopy,        // dst = a
+        kStore,       // dst = c ? a : dst, where c is the execution mask
+        kSelect,      // dst = c ? a : b
+        kAddF, kSubF, kMulF, kDivF, kNegF,
+        kAddI, kSubI, kMulI, kDivI, kNegI,
+        kAnd, kOr, kXor, kNot,
+        kIntToFloat, kFloatToInt,
+        kEqF, kNeqF, kLtF, kGtF, kLteF, kGteF,
+        kEqI, kNeqI, kLtI, kGtI, kLteI, kGteI,
+        kJump,        // pc = imm
+        kJumpIfNone,  // pc = imm if no lane of a is set
+    };
+
+    struct Instruction {
+        Op fOp;
+        int fDst;
+        int fA;
+        int fB;
+        int fC;
+        int32_t fImm;
+    };
+
+    class Generator;
+
+    // Runs the code over planar registers, then writes the color channels back for the active
+    // pixels. The code itself is never modified, so one ByteCode may run on many threads.
+    void run(const float* rgba, float* readFrom, int activePixels) const;
+
+    std::vector<Instruction> fCode;
+    // Every register holds kLanes 32-bit values. Register 0 is the mask of active pixels.
+    int fRegisterCount = 1;
+    // The registers holding r, g, b, and (for float4 colors) a.
+    int fChannels[4];
+    int fChannelCount;
+};
+
+class Interpreter::ByteCode::Generator {
+public:
+    Generator(ByteCode* code) : fCode(*code) {}
+
+    // Accepts either void f(inout float r, inout float g, inout float b), as appended by
+    // appendStages(), or the JIT's void f(int x, int y, inout float4 color). The callback stage
+    // does not know pixel coordinates, so functions that read x or y are rejected.
+    bool generate(const FunctionDefinition& f) {
+        const auto& params = f.fDeclaration.fParameters;
+        if (params.size() != 3) {
+            return false;
+        }
+        if (kFloat_Kind == scalar_kind(params[0]->fType) &&
+            kFloat_Kind == scalar_kind(params[1]->fType) &&
+            kFloat_Kind == scalar_kind(params[2]->fType)) {
+            fCode.fChannelCount = 3;
+            for (int i = 0; i < 3; ++i) {
+                fCode.fChannels[i] = fVariables[params[i]] = this->newRegister();
+            }
+        } else if (kInt_Kind == scalar_kind(params[0]->fType) &&
+                   kInt_Kind == scalar_kind(params[1]->fType) &&
+                   (params[2]->fType.fName == "float4" || params[2]->fType.fName == "half4")) {
+            fCode.fChannelCount = 4;
+            fColor = params[2];
+            for (int i = 0; i < 4; ++i) {
+                fCode.fChannels[i] = this->newRegister();
+            }
+        } else {
+            return false;
+        }
+        return this->writeStatement(*f.fBody);
+    }
+
+private:
+    enum ScalarKind {
+        kFloat_Kind,
+        kInt_Kind,
+        kBool_Kind,
+        kUnsupported_Kind,
+    };
+
+    static ScalarKind scalar_kind(const Type& type) {
+        if (type.fName == "float" || type.fName == "half") {
+            return kFloat_Kind;
+        } else if (type.fName == "int" || type.fName == "short") {
+            return kInt_Kind;
+        } else if (type.fName == "bool") {
+            return kBool_Kind;
+        }
+        return kUnsupported_Kind;
+    }
+
+    int newRegister() {
+        return fCode.fRegisterCount++;
+    }
+
+    int emit(Op op, int a = -1, int b = -1, int c = -1, int32_t imm = 0) {
+        int dst = this->newRegister();
+        fCode.fCode.push_back({ op, dst, a, b, c, imm });
+        return dst;
+    }
+
+    void store(int dst, int src) {
+        fCode.fCode.push_back({ Op::kStore, dst, src, -1, fExec, 0 });
+    }
+
+    size_t emitJump(Op op, int a = -1) {
+        fCode.fCode.push_back({ op, -1, a, -1, -1, 0 });
+        return fCode.fCode.size() - 1;
+    }
+
+    void patchJump(size_t jump) {
+        fCode.fCode[jump].fImm = (int32_t) fCode.fCode.size();
+    }
+
+    int constant(int32_t bits) {
+        return this->emit(Op::kConst, -1, -1, -1, bits);
+    }
+
+    int getLValue(const Expression& expr) {
+        if (Expression::kSwizzle_Kind == expr.fKind) {
+            // Single channels of the color are plain registers.
+            const Swizzle& s = (const Swizzle&) expr;
+            if (s.fComponents.size() == 1 && s.fComponents[0] >= 0 && s.fComponents[0] < 4 &&
+                Expression::kVariableReference_Kind == s.fBase->fKind &&
+                &((const VariableReference&) *s.fBase).fVariable == fColor) {
+                return fCode.fChannels[s.fComponents[0]];
+            }
+            return -1;
+        }
+        if (Expression::kVariableReference_Kind != expr.fKind) {
+            return -1;
+        }
+        auto found = fVariables.find(&((const VariableReference&) expr).fVariable);
+        return found != fVariables.end() ? found->second : -1;
+    }
+
+    static bool arithmetic_op(Token::Kind op, ScalarKind kind, Op* result) {
+        bool isFloat = kFloat_Kind == kind;
+        if (!isFloat && kInt_Kind != kind) {
+            return false;
+        }
+        switch (op) {
+            case Token::PLUS:
+            case Token::PLUSEQ:
+                *result = isFloat ? Op::kAddF : Op::kAddI;
+                return true;
+            case Token::MINUS:
+            case Token::MINUSEQ:
+                *result = isFloat ? Op::kSubF : Op::kSubI;
+                return true;
+            case Token::STAR:
+            case Token::STAREQ:
+                *result = isFloat ? Op::kMulF : Op::kMulI;
+                return true;
+            case Token::SLASH:
+            case Token::SLASHEQ:
+                *result = isFloat ? Op::kDivF : Op::kDivI;
+                return true;
+            case Token::BITWISEAND:
+            case Token::BITWISEANDEQ:
+                *result = Op::kAnd;
+                return !isFloat;
+            case Token::BITWISEOR:
+            case Token::BITWISEOREQ:
+                *result = Op::kOr;
+                return !isFloat;
+            case Token::BITWISEXOR:
+            case Token::BITWISEXOREQ:
+                *result = Op::kXor;
+                return !isFloat;
+            default:
+                return false;
+        }
+    }
+
+    static bool comparison_op(Token::Kind op, ScalarKind kind, Op* result) {
+        bool isFloat = kFloat_Kind == kind;
+        if (!isFloat && kInt_Kind != kind && kBool_Kind != kind) {
+            return false;
+        }
+        switch (op) {
+            case Token::EQEQ: *result = isFloat ? Op::kEqF  : Op::kEqI;  return true;
+            case Token::NEQ:  *result = isFloat ? Op::kNeqF : Op::kNeqI; return true;
+            default:
+                break;
+        }
+        if (kBool_Kind == kind) {
+            return false;
+        }
+        switch (op) {
+            case Token::LT:   *result = isFloat ? Op::kLtF  : Op::kLtI;  return true;
+            case Token::GT:   *result = isFloat ? Op::kGtF  : Op::kGtI;  return true;
+            case Token::LTEQ: *result = isFloat ? Op::kLteF : Op::kLteI; return true;
+            case Token::GTEQ: *result = isFloat ? Op::kGteF : Op::kGteI; return true;
+            default:
+                return false;
+        }
+    }
+
+    // Evaluates 'expr' with 'mask' as the execution mask, so side effects only reach its lanes.
+    int writeMasked(const Expression& expr, int mask) {
+        int saved = fExec;
+        fExec = mask;
+        int result = this->writeExpression(expr);
+        fExec = saved;
+        return result;
+    }
+
+    int writeBinary(const BinaryExpression& b) {
+        ScalarKind kind = scalar_kind(b.fLeft->fType);
+        if (kind != scalar_kind(b.fRight->fType)) {
+            return -1;
+        }
+        Op op;
+        switch (b.fOperator) {
+            case Token::EQ: {
+                int lvalue = this->getLValue(*b.fLeft);
+                int right = this->writeExpression(*b.fRight);
+                if (lvalue < 0 || right < 0) {
+                    return -1;
+                }
+                this->store(lvalue, right);
+                return right;
+            }
+            case Token::LOGICALAND:
+            case Token::LOGICALOR: {
+                int left = this->writeExpression(*b.fLeft);
+                if (left < 0) {
+                    return -1;
+                }
+                if (b.fRight->hasSideEffects()) {
+                    left = this->emit(Op::kCopy, left);
+                }
+                // Only lanes that did not short circuit evaluate the right side.
+                int needed = Token::LOGICALAND == b.fOperator ? left : this->emit(Op::kNot, left);
+                int right = this->writeMasked(*b.fRight, this->emit(Op::kAnd, fExec, needed));
+                if (right < 0) {
+                    return -1;
+                }
+                return this->emit(Token::LOGICALAND == b.fOperator ? Op::kAnd : Op::kOr,
+                                  left, right);
+            }
+            case Token::LOGICALXOR: {
+                int left = this->writeExpression(*b.fLeft);
+                int right = left < 0 ? -1 : this->writeExpression(*b.fRight);
+                return right < 0 ? -1 : this->emit(Op::kXor, left, right);
+            }
+            case Token::PLUSEQ:
+            case Token::MINUSEQ:
+            case Token::STAREQ:
+            case Token::SLASHEQ:
+            case Token::BITWISEANDEQ:
+            case Token::BITWISEOREQ:
+            case Token::BITWISEXOREQ: {
+                int lvalue = this->getLValue(*b.fLeft);
+                if (lvalue < 0 || !arithmetic_op(b.fOperator, kind, &op)) {
+                    return -1;
+                }
+                int right = this->writeExpression(*b.fRight);
+                if (right < 0) {
+                    return -1;
+                }
+                int result = this->emit(op, lvalue, right);
+                this->store(lvalue, result);
+                return result;
+            }
+            default:
+                break;
+        }
+        bool isComparison = comparison_op(b.fOperator, kind, &op);
+        if (!isComparison && !arithmetic_op(b.fOperator, kind, &op)) {
+            return -1;
+        }
+        int left = this->writeExpression(*b.fLeft);
+        if (left < 0) {
+            return -1;
+        }
+        if (b.fRight->hasSideEffects()) {
+            // The right side might assign to a variable the left side read directly.
+            left = this->emit(Op::kCopy, left);
+        }
+        int right = this->writeExpression(*b.fRight);
+        return right < 0 ? -1 : this->emit(op, left, right);
+    }
+
+    int writeIncrement(const Expression& operand, Token::Kind op, bool returnOld) {
+        ScalarKind kind = scalar_kind(operand.fType);
+        int lvalue = this->getLValue(operand);
+        if (lvalue < 0 || (kFloat_Kind != kind && kInt_Kind != kind)) {
+            return -1;
+        }
+        int old = returnOld ? this->emit(Op::kCopy, lvalue) : -1;
+        int one = kFloat_Kind == kind ? this->constant(float_bits(1)) : this->constant(1);
+        Op add = kFloat_Kind == kind ? Op::kAddF : Op::kAddI;
+        Op sub = kFloat_Kind == kind ? Op::kSubF : Op::kSubI;
+        int result = this->emit(Token::PLUSPLUS == op ? add : sub, lvalue, one);
+        this->store(lvalue, result);
+        return returnOld ? old : result;
+    }
+
+    static int32_t float_bits(float f) {
+        int32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+
+    int writeExpression(const Expression& expr) {
+        switch (expr.fKind) {
+            case Expression::kBinary_Kind:
+                return this->writeBinary((const BinaryExpression&) expr);
+            case Expression::kBoolLiteral_Kind:
+                return this->constant(((const BoolLiteral&) expr).fValue ? ~0 : 0);
+            case Expression::kIntLiteral_Kind:
+                return this->constant((int32_t) ((const IntLiteral&) expr).fValue);
+            case Expression::kFloatLiteral_Kind:
+                return this->constant(float_bits((float) ((const FloatLiteral&) expr).fValue));
+            case Expression::kPrefix_Kind: {
+                const PrefixExpression& p = (const PrefixExpression&) expr;
+                ScalarKind kind = scalar_kind(p.fType);
+                switch (p.fOperator) {
+                    case Token::PLUSPLUS:
+                    case Token::MINUSMINUS:
+                        return this->writeIncrement(*p.fOperand, p.fOperator, false);
+                    default:
+                        break;
+                }
+                int operand = this->writeExpression(*p.fOperand);
+                if (operand < 0) {
+                    return -1;
+                }
+                switch (p.fOperator) {
+                    case Token::MINUS:
+                        if (kFloat_Kind == kind || kInt_Kind == kind) {
+                            return this->emit(kFloat_Kind == kind ? Op::kNegF : Op::kNegI,
+                                              operand);
+                        }
+                        return -1;
+                    case Token::LOGICALNOT:
+                        return kBool_Kind == kind ? this->emit(Op::kNot, operand) : -1;
+                    case Token::BITWISENOT:
+                        return kInt_Kind == kind ? this->emit(Op::kNot, operand) : -1;
+                    default:
+                        return -1;
+                }
+            }
+            case Expression::kPostfix_Kind: {
+                const PostfixExpression& p = (const PostfixExpression&) expr;
+                return this->writeIncrement(*p.fOperand, p.fOperator, true);
+            }
+            case Expression::kConstructor_Kind: {
+                const Constructor& c = (const Constructor&) expr;
+                if (c.fArguments.size() != 1) {
+                    return -1;
+                }
+                ScalarKind from = scalar_kind(c.fArguments[0]->fType);
+                ScalarKind to = scalar_kind(c.fType);
+                int arg = this->writeExpression(*c.fArguments[0]);
+                if (arg < 0 || kUnsupported_Kind == from || kUnsupported_Kind == to) {
+                    return -1;
+                }
+                if (from == to) {
+                    return arg;
+                } else if (kInt_Kind == from && kFloat_Kind == to) {
+                    return this->emit(Op::kIntToFloat, arg);
+                } else if (kFloat_Kind == from && kInt_Kind == to) {
+                    return this->emit(Op::kFloatToInt, arg);
+                }
+                return -1;
+            }
+            case Expression::kTernary_Kind: {
+                const TernaryExpression& t = (const TernaryExpression&) expr;
+                int test = this->writeExpression(*t.fTest);
+                if (test < 0) {
+                    return -1;
+                }
+                if (t.fIfTrue->hasSideEffects() || t.fIfFalse->hasSideEffects()) {
+                    test = this->emit(Op::kCopy, test);
+                }
+                int ifTrue = this->writeMasked(*t.fIfTrue, this->emit(Op::kAnd, fExec, test));
+                int notTest = this->emit(Op::kNot, test);
+                int ifFalse = this->writeMasked(*t.fIfFalse, this->emit(Op::kAnd, fExec, notTest));
+                if (ifTrue < 0 || ifFalse < 0) {
+                    return -1;
+                }
+                return this->emit(Op::kSelect, ifTrue, ifFalse, test);
+            }
+            case Expression::kSwizzle_Kind:
+            case Expression::kVariableReference_Kind:
+                return this->getLValue(expr);
+            default:
+                return -1;
+        }
+    }
+
+    bool writeStatement(const Statement& stmt) {
+        switch (stmt.fKind) {
+            case Statement::kBlock_Kind:
+                for (const auto& s : ((const Block&) stmt).fStatements) {
+                    if (!this->writeStatement(*s)) {
+                        return false;
+                    }
+                }
+                return true;
+            case Statement::kExpression_Kind:
+                return this->writeExpression(*((const ExpressionStatement&) stmt).fExpression) >= 0;
+            case Statement::kFor_Kind: {
+                const ForStatement& f = (const ForStatement&) stmt;
+                if (f.fInitializer && !this->writeStatement(*f.fInitializer)) {
+                    return false;
+                }
+                return this->writeLoop(f.fTest.get(), *f.fStatement, f.fNext.get());
+            }
+            case Statement::kWhile_Kind: {
+                const WhileStatement& w = (const WhileStatement&) stmt;
+                return this->writeLoop(w.fTest.get(), *w.fStatement, nullptr);
+            }
+            case Statement::kIf_Kind: {
+                const IfStatement& i = (const IfStatement&) stmt;
+                int test = this->writeExpression(*i.fTest);
+                if (test < 0) {
+                    return false;
+                }
+                int saved = fExec;
+                // Both masks come from the test as it was, before either branch can change it.
+                int elseMask = i.fIfFalse ? this->emit(Op::kAnd, saved, this->emit(Op::kNot, test))
+                                          : -1;
+                fExec = this->emit(Op::kAnd, saved, test);
+                size_t skipTrue = this->emitJump(Op::kJumpIfNone, fExec);
+                bool result = this->writeStatement(*i.fIfTrue);
+                this->patchJump(skipTrue);
+                if (result && i.fIfFalse) {
+                    fExec = elseMask;
+                    size_t skipFalse = this->emitJump(Op::kJumpIfNone, fExec);
+                    result = this->writeStatement(*i.fIfFalse);
+                    this->patchJump(skipFalse);
+                }
+                fExec = saved;
+                return result;
+            }
+            case Statement::kNop_Kind:
+                return true;
+            case Statement::kVarDeclarations_Kind:
+                for (const auto& decl :
+                         ((const VarDeclarationsStatement&) stmt).fDeclaration->fVars) {
+                    const VarDeclaration& v = (const VarDeclaration&) *decl;
+                    if (v.fSizes.size() || kUnsupported_Kind == scalar_kind(v.fVar->fType)) {
+                        return false;
+                    }
+                    int reg = this->newRegister();
+                    fVariables[v.fVar] = reg;
+                    if (v.fValue) {
+                        int value = this->writeExpression(*v.fValue);
+                        if (value < 0) {
+                            return false;
+                        }
+                        this->store(reg, value);
+                    }
+                }
+                return true;
+            default:
+                // break, continue, discard, return, switch, etc. are left to the tree walker.
+                return false;
+        }
+    }
+
+    bool writeLoop(const Expression* test, const Statement& body, const Expression* next) {
+        int saved = fExec;
+        fExec = this->emit(Op::kCopy, saved);
+        int32_t top = (int32_t) fCode.fCode.size();
+        if (test) {
+            int result = this->writeExpression(*test);
+            if (result < 0) {
+                return false;
+            }
+            // Lanes leave the loop as their test fails and never come back.
+            fCode.fCode.push_back({ Op::kAnd, fExec, fExec, result, -1, 0 });
+        }
+        size_t exit = this->emitJump(Op::kJumpIfNone, fExec);
+        if (!this->writeStatement(body) || (next && this->writeExpression(*next) < 0)) {
+            return false;
+        }
+        fCode.fCode.push_back({ Op::kJump, -1, -1, -1, -1, top });
+        this->patchJump(exit);
+        fExec = saved;
+        return true;
+    }
+
+    ByteCode& fCode;
+    std::unordered_map<const Variable*, int> fVariables;
+    const Variable* fColor = nullptr;
+    int fExec = 0;
+};
+
+void Interpreter::ByteCode::run(const float* rgba, float* readFrom, int activePixels) const {
+    SkAutoSTMalloc<64 * kLanes, int32_t> storage(fRegisterCount * kLanes);
+    int32_t* registers = storage.get();
+    auto reg = [registers](int index) { return registers + index * kLanes; };
+    for (int i = 0; i < kLanes; ++i) {
+        bool active = i < activePixels;
+        reg(0)[i] = active ? ~0 : 0;
+        for (int c = 0; c < fChannelCount; ++c) {
+            float value = active ? rgba[i * 4 + c] : 0;
+            memcpy(reg(fChannels[c]) + i, &value, sizeof(value));
+        }
+    }
+
+    #define UNARY_OP(T, expr)                                       \
+        for (int i = 0; i < kLanes; i += 4) {                       \
+            T x = T::Load(reg(inst.fA) + i);                        \
+            (expr).store(reg(inst.fDst) + i);                       \
+        }                                                           \
+        break;
+    #define BINARY_OP(T, expr)                                      \
+        for (int i = 0; i < kLanes; i += 4) {                       \
+            T x = T::Load(reg(inst.fA) + i);                        \
+            T y = T::Load(reg(inst.fB) + i);                        \
+            (expr).store(reg(inst.fDst) + i);                       \
+        }                                                           \
+        break;
+    const Instruction* code = fCode.data();
+    size_t pc = 0;
+    while (pc < fCode.size()) {
+        const Instruction& inst = code[pc++];
+        switch (inst.fOp) {
+            case Op::kConst:
+                for (int i = 0; i < kLanes; i += 4) {
+                    Sk4i(inst.fImm).store(reg(inst.fDst) + i);
+                }
+                break;
+            case Op::kCopy:
+                memcpy(reg(inst.fDst), reg(inst.fA), kLanes * sizeof(int32_t));
+                break;
+            case Op::kStore:
+                for (int i = 0; i < kLanes; i += 4) {
+                    Sk4i mask = Sk4i::Load(reg(inst.fC) + i);
+                    mask.thenElse(Sk4i::Load(reg(inst.fA) + i), Sk4i::Load(reg(inst.fDst) + i))
+                        .store(reg(inst.fDst) + i);
+                }
+                break;
+            case Op::kSelect:
+                for (int i = 0; i < kLanes; i += 4) {
+                    Sk4i mask = Sk4i::Load(reg(inst.fC) + i);
+                    mask.thenElse(Sk4i::Load(reg(inst.fA) + i), Sk4i::Load(reg(inst.fB) + i))
+                        .store(reg(inst.fDst) + i);
+                }
+                break;
+            case Op::kAddF: BINARY_OP(Sk4f, x + y)
+            case Op::kSubF: BINARY_OP(Sk4f, x - y)
+            case Op::kMulF: BINARY_OP(Sk4f, x * y)
+            case Op::kDivF: BINARY_OP(Sk4f, x / y)
+            case Op::kNegF: UNARY_OP(Sk4f, -x)
+            case Op::kAddI: BINARY_OP(Sk4i, x + y)
+            case Op::kSubI: BINARY_OP(Sk4i, x - y)
+            case Op::kMulI: BINARY_OP(Sk4i, x * y)
+            case Op::kNegI: UNARY_OP(Sk4i, Sk4i(0) - x)
+            case Op::kDivI: {
+                const int32_t* a = reg(inst.fA);
+                const int32_t* b = reg(inst.fB);
+                int32_t* dst = reg(inst.fDst);
+                for (int i = 0; i < kLanes; ++i) {
+                    // Inactive lanes hold garbage; keep them from trapping.
+                    bool safe = b[i] != 0 && !(a[i] == INT32_MIN && b[i] == -1);
+                    dst[i] = safe ? a[i] / b[i] : 0;
+                }
+                break;
+            }
+            case Op::kAnd:  BINARY_OP(Sk4i, x & y)
+            case Op::kOr:   BINARY_OP(Sk4i, x | y)
+            case Op::kXor:  BINARY_OP(Sk4i, x ^ y)
+            case Op::kNot:  UNARY_OP(Sk4i, x ^ Sk4i(~0))
+            case Op::kIntToFloat: UNARY_OP(Sk4i, SkNx_cast<float>(x))
+            case Op::kFloatToInt: UNARY_OP(Sk4f, SkNx_cast<int32_t>(x))
+            case Op::kEqF:  BINARY_OP(Sk4f, x == y)
+            case Op::kNeqF: BINARY_OP(Sk4f, x != y)
+            case Op::kLtF:  BINARY_OP(Sk4f, x <  y)
+            case Op::kGtF:  BINARY_OP(Sk4f, x >  y)
+            case Op::kLteF: BINARY_OP(Sk4f, x <= y)
+            case Op::kGteF: BINARY_OP(Sk4f, x >= y)
+            case Op::kEqI:  BINARY_OP(Sk4i, x == y)
+            case Op::kNeqI: BINARY_OP(Sk4i, (x == y) ^ Sk4i(~0))
+            case Op::kLtI:  BINARY_OP(Sk4i, x <  y)
+            case Op::kGtI:  BINARY_OP(Sk4i, x >  y)
+            case Op::kLteI: BINARY_OP(Sk4i, (x > y) ^ Sk4i(~0))
+            case Op::kGteI: BINARY_OP(Sk4i, (x < y) ^ Sk4i(~0))
+            case Op::kJump:
+                pc = inst.fImm;
+                break;
+            case Op::kJumpIfNone: {
+                const int32_t* mask = reg(inst.fA);
+                int32_t any = 0;
+                for (int i = 0; i < kLanes; ++i) {
+                    any |= mask[i];
+                }
+                if (!any) {
+                    pc = inst.fImm;
+                }
+                break;
+            }
+        }
+    }
+    #undef UNARY_OP
+    #undef BINARY_OP
+
+    for (int i = 0; i < activePixels; ++i) {
+        for (int c = 0; c < fChannelCount; ++c) {
+            memcpy(&readFrom[i * 4 + c], reg(fChannels[c]) + i, sizeof(float));
+        }
+    }
+}
+
+std::unique_ptr<Interpreter::ByteCode> Interpreter::compile(const FunctionDefinition& f) {
+    std::unique_ptr<ByteCode> code(new ByteCode());
+    ByteCode::Generator generator(code.get());
+    if (!generator.generate(f)) {
+        return nullptr;
+    }
+    return code;
+}
+
 struct CallbackCtx : public SkJumper_CallbackCtx {
     Interpreter* fInterpreter;
     const FunctionDefinition* fFunction;
+    // Null if the function uses anything the byte code does not support.
+    const Interpreter::ByteCode* fByteCode;
 };
 
 static void do_callback(SkJumper_CallbackCtx* raw, int activePixels) {
     CallbackCtx& ctx = (CallbackCtx&) *raw;
+    if (ctx.fByteCode) {
+        ctx.fByteCode->run(ctx.rgba, ctx.read_from, activePixels);
+        return;
+    }
     for (int i = 0; i < activePixels; ++i) {
         ctx.fInterpreter->push(Interpreter::Value(ctx.rgba[i * 4 + 0]));
         ctx.fInterpreter->push(Interpreter::Value(ctx.rgba[i * 4 + 1]));
@@ -231,25 +875,131 @@ static void do_callback(SkJumper_CallbackCtx* raw, int activePixels) {
     }
 }
 
+namespace {
+
+// Everything compiled for one (source, name) pair. Pipelines keep pointers into these, so they
+// live for the rest of the process.
+struct CompiledStage {
+    // Pipeline-stage programs leave their functions behind in the compiler's symbol table, so
+    // each program gets its own compiler.
+    std::unique_ptr<Compiler> fCompiler;
+    std::unique_ptr<Program> fProgram;
+    std::unique_ptr<Interpreter::ByteCode> fByteCode;
+#ifdef SK_LLVM_AVAILABLE
+    std::unique_ptr<JIT> fJIT;
+    std::unique_ptr<JIT::Module> fModule;
+#endif
+    void* fNativeStage = nullptr;
+};
+
+}  // anonymous namespace
+
+SK_DECLARE_STATIC_MUTEX(gStageCacheMutex);
+
+static const FunctionDefinition* find_function(const Program& program, const char* name) {
+    for (const auto& e : program) {
+        if (ProgramElement::kFunction_Kind == e.fKind &&
+            ((const FunctionDefinition&) e).fDeclaration.fName == name) {
+            return (const FunctionDefinition*) &e;
+        }
+    }
+    return nullptr;
+}
+
+static std::unique_ptr<CompiledStage> compile_stage(const String& src, const char* name) {
+    std::unique_ptr<CompiledStage> stage(new CompiledStage());
+    stage->fCompiler.reset(new Compiler());
+    Program::Settings settings;
+#ifdef SK_LLVM_AVAILABLE
+    std::unique_ptr<Program> jitProgram =
+            stage->fCompiler->convertProgram(Program::kPipelineStage_Kind, src, settings);
+    // Module::getJumperStage() aborts on a missing symbol, so look the function up first.
+    if (!jitProgram || !find_function(*jitProgram, name)) {
+        return nullptr;
+    }
+    stage->fJIT.reset(new JIT(stage->fCompiler.get()));
+    stage->fModule = stage->fJIT->compile(std::move(jitProgram));
+    if (stage->fModule) {
+        stage->fNativeStage = stage->fModule->getJumperStage(name);
+        return stage;
+    }
+    // Fall back to byte code, which needs a fresh compiler for the same reason as above.
+    stage->fJIT.reset();
+    stage->fCompiler.reset(new Compiler());
+#endif
+    stage->fProgram = stage->fCompiler->convertProgram(Program::kPipelineStage_Kind, src,
+                                                       settings);
+    if (!stage->fProgram) {
+        return nullptr;
+    }
+    const FunctionDefinition* f = find_function(*stage->fProgram, name);
+    if (!f) {
+        return nullptr;
+    }
+    stage->fByteCode.reset(new Interpreter::ByteCode());
+    Interpreter::ByteCode::Generator generator(stage->fByteCode.get());
+    if (!generator.generate(*f)) {
+        return nullptr;
+    }
+    return stage;
+}
+
+bool Interpreter::AppendRuntimeStage(SkRasterPipeline* pipeline, SkArenaAlloc* alloc,
+                                     const String& src, const char* name) {
+    static auto* cache = new std::unordered_map<String, std::unique_ptr<CompiledStage>>();
+
+    const CompiledStage* stage;
+    {
+        SkAutoMutexAcquire lock(gStageCacheMutex);
+        String key = src + String("\n") + String(name);
+        auto found = cache->find(key);
+        if (found == cache->end()) {
+            // Failures are cached too, so a bad program is only compiled once.
+            found = cache->insert({ key, compile_stage(src, name) }).first;
+        }
+        stage = found->second.get();
+    }
+    if (!stage) {
+        return false;
+    }
+    if (stage->fNativeStage) {
+        pipeline->append(stage->fNativeStage, nullptr);
+        return true;
+    }
+    CallbackCtx* ctx = alloc->make<CallbackCtx>();
+    ctx->fn = do_callback;
+    ctx->fInterpreter = nullptr;
+    ctx->fFunction = nullptr;
+    ctx->fByteCode = stage->fByteCode.get();
+    pipeline->append(SkRasterPipeline::callback, ctx);
+    return true;
+}
+
 void Interpreter::appendStage(const AppendStage& a) {
     switch (a.fStage) {
+        // fArguments[0] is the pipeline itself.
         case SkRasterPipeline::matrix_4x5: {
-            SkASSERT(a.fArguments.size() == 1);
-            StackIndex transpose = evaluate(*a.fArguments[0]).fInt;
+            SkASSERT(a.fArguments.size() == 2);
+            StackIndex transpose = evaluate(*a.fArguments[1]).fInt;
             fPipeline.append(SkRasterPipeline::matrix_4x5, &fStack[transpose]);
             break;
         }
         case SkRasterPipeline::callback: {
-            SkASSERT(a.fArguments.size() == 1);
+            SkASSERT(a.fArguments.size() == 2);
             CallbackCtx* ctx = new CallbackCtx();
             ctx->fInterpreter = this;
             ctx->fn = do_callback;
+            ctx->fByteCode = nullptr;
             for (const auto& e : *fProgram) {
                 if (ProgramElement::kFunction_Kind == e.fKind) {
                     const FunctionDefinition& f = (const FunctionDefinition&) e;
                     if (&f.fDeclaration ==
-                                      ((const FunctionReference&) *a.fArguments[0]).fFunctions[0]) {
+                                      ((const FunctionReference&) *a.fArguments[1]).fFunctions[0]) {
                         ctx->fFunction = &f;
+                        if (std::unique_ptr<ByteCode> code = this->compile(f)) {
+                            ctx->fByteCode = code.get();
+                            fByteCode.push_back(std::move(code));
+                        }
                     }
                 }
             }
@@ -17,6 +17,7 @@
 
 #include <stack>
 
+class SkArenaAlloc;
 class SkRasterPipeline;
 
 namespace SkSL {
@@ -51,10 +52,28 @@ public:
         kBool_TypeKind
     };
 
-    Interpreter(std::unique_ptr<Program> program, SkRasterPipeline* pipeline, std::vector<Value>* stack)
-    : fProgram(std::move(program))
-    , fPipeline(*pipeline)
-    , fStack(*stack) {}
+    // A callback function flattened into instructions that each operate on every lane of the
+    // pipeline stride at once, so a callback stage runs its code once per batch of pixels instead
+    // of walking the IR once per pixel.
+    struct ByteCode;
+
+    Interpreter(std::unique_ptr<Program> program, SkRasterPipeline* pipeline,
+                std::vector<Value>* stack);
+
+    ~Interpreter();
+
+    /**
+     * Appends the function 'name' from the pipeline-stage program 'src' to 'pipeline' as a single
+     * stage. The function must have the signature void <name>(int x, int y, inout float4 color).
+     *
+     * When Skia is built with skia_llvm_path the function is JIT compiled to native code;
+     * otherwise it runs as lane-wide byte code, which cannot read x or y. Compiled stages are
+     * cached by source and name for the life of the process, so appending a stage again does not
+     * recompile it. Returns false if the program does not compile or uses something neither
+     * backend supports.
+     */
+    static bool AppendRuntimeStage(SkRasterPipeline* pipeline, SkArenaAlloc* alloc,
+                                   const String& src, const char* name);
 
     void run();
 
@@ -77,11 +96,14 @@ public:
     Value evaluate(const Expression& expr);
 
 private:
+    std::unique_ptr<ByteCode> compile(const FunctionDefinition& f);
+
     std::unique_ptr<Program> fProgram;
     SkRasterPipeline& fPipeline;
     std::vector<StatementIndex> fCurrentIndex;
     std::vector<std::unordered_map<const Variable*, StackIndex>> fVars;
     std::vector<Value> &fStack;
+    std::vector<std::unique_ptr<ByteCode>> fByteCode;
 };
 
 } // namespace
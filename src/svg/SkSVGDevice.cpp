@@ -145,8 +145,8 @@ bool RequiresViewportReset(const SkPaint& paint) {
 
 }  // namespace
 
-// For now all this does is serve unique serial IDs, but it will eventually evolve to track
-// and deduplicate resources.
+// Serves unique serial IDs, and deduplicates gradients, clips and paths so that each is only
+// written once.
 class SkSVGDevice::ResourceBucket : ::SkNoncopyable {
 public:
     ResourceBucket()
@@ -157,16 +157,38 @@ public:
             , fPatternCount(0)
             , fColorFilterCount(0) {}
 
-    SkString addLinearGradient() {
-        return SkStringPrintf("gradient_%d", fGradientCount++);
+    // These return true if 'key' is new, and its resource must be written under 'id'.
+    bool addLinearGradient(const SkString& key, SkString* id) {
+        return add(&fGradients, key, "gradient_%d", &fGradientCount, id);
     }
 
-    SkString addClip() {
-        return SkStringPrintf("clip_%d", fClipCount++);
+    bool addClip(const SkString& key, SkString* id) {
+        return add(&fClips, key, "clip_%d", &fClipCount, id);
     }
 
-    SkString addPath() {
-        return SkStringPrintf("path_%d", fPathCount++);
+    enum class PathUse {
+        kInline,  // Write the path data on the drawn element.
+        kDefine,  // Write the path data in <defs> under 'id', and <use> it.
+        kReuse,   // <use> the path already defined under 'id'.
+    };
+
+    // Paths are inlined the first time they're seen, so paths drawn once don't pay for a <use>.
+    PathUse addPath(const SkString& pathData, SkString* id) {
+        if (pathData.size() < kMinSharedPathLength) {
+            return PathUse::kInline;
+        }
+        SkString* pathID = fPaths.find(pathData);
+        if (!pathID) {
+            fPaths.set(pathData, SkString());
+            return PathUse::kInline;
+        }
+        if (pathID->isEmpty()) {
+            pathID->printf("path_%d", fPathCount++);
+            *id = *pathID;
+            return PathUse::kDefine;
+        }
+        *id = *pathID;
+        return PathUse::kReuse;
     }
 
     SkString addImage() {
@@ -180,12 +202,31 @@ public:
     }
 
 private:
+    // Shorter paths take fewer bytes written out again than referenced.
+    static constexpr size_t kMinSharedPathLength = 64;
+
+    static bool add(SkTHashMap<SkString, SkString>* map, const SkString& key, const char format[],
+                    uint32_t* count, SkString* id) {
+        if (const SkString* found = map->find(key)) {
+            *id = *found;
+            return false;
+        }
+        id->printf(format, (*count)++);
+        map->set(key, *id);
+        return true;
+    }
+
     uint32_t fGradientCount;
     uint32_t fClipCount;
     uint32_t fPathCount;
     uint32_t fImageCount;
     uint32_t fPatternCount;
     uint32_t fColorFilterCount;
+
+    SkTHashMap<SkString, SkString> fGradients;
+    SkTHashMap<SkString, SkString> fClips;
+    // Path data seen, and the id it's defined under once it's been seen twice.
+    SkTHashMap<SkString, SkString> fPaths;
 };
 
 struct SkSVGDevice::MxCp {
@@ -256,11 +297,19 @@ public:
     void addTextAttributes(const SkPaint&);
 
 private:
+    // Opens the <defs> element that resources are written into, when the first one is.
+    typedef std::unique_ptr<AutoElement> LazyDefs;
+    void openDefs(LazyDefs* defs) {
+        if (!*defs) {
+            defs->reset(new AutoElement("defs", fWriter));
+        }
+    }
+
     Resources addResources(const MxCp&, const SkPaint& paint);
-    void addClipResources(const MxCp&, Resources* resources);
-    void addShaderResources(const SkPaint& paint, Resources* resources);
+    void addClipResources(const MxCp&, Resources* resources, LazyDefs* defs);
+    void addShaderResources(const SkPaint& paint, Resources* resources, LazyDefs* defs);
     void addGradientShaderResources(const SkShader* shader, const SkPaint& paint,
-                                    Resources* resources);
+                                    Resources* resources, LazyDefs* defs);
     void addColorFilterResources(const SkColorFilter& cf, Resources* resources);
     void addImageShaderResources(const SkShader* shader, const SkPaint& paint,
                                  Resources* resources);
@@ -270,7 +319,8 @@ private:
     void addPaint(const SkPaint& paint, const Resources& resources);
 
 
-    SkString addLinearGradientDef(const SkShader::GradientInfo& info, const SkShader* shader);
+    SkString addLinearGradientDef(const SkShader::GradientInfo& info, const SkShader* shader,
+                                  LazyDefs* defs);
 
     SkXMLWriter*               fWriter;
     ResourceBucket*            fResourceBucket;
@@ -334,14 +384,15 @@ Resources SkSVGDevice::AutoElement::addResources(const MxCp& mc, const SkPaint&
     bool hasShader = SkToBool(paint.getShader());
 
     if (hasClip || hasShader) {
-        AutoElement defs("defs", fWriter);
+        // Clips and gradients that were already written are only referenced.
+        LazyDefs defs;
 
         if (hasClip) {
-            this->addClipResources(mc, &resources);
+            this->addClipResources(mc, &resources, &defs);
         }
 
         if (hasShader) {
-            this->addShaderResources(paint, &resources);
+            this->addShaderResources(paint, &resources, &defs);
         }
     }
 
@@ -357,7 +408,8 @@ Resources SkSVGDevice::AutoElement::addResources(const MxCp& mc, const SkPaint&
 
 void SkSVGDevice::AutoElement::addGradientShaderResources(const SkShader* shader,
                                                           const SkPaint& paint,
-                                                          Resources* resources) {
+                                                          Resources* resources,
+                                                          LazyDefs* defs) {
     SkShader::GradientInfo grInfo;
     grInfo.fColorCount = 0;
     if (SkShader::kLinear_GradientType != shader->asAGradient(&grInfo)) {
@@ -375,7 +427,8 @@ void SkSVGDevice::AutoElement::addGradientShaderResources(const SkShader* shader
     SkASSERT(grInfo.fColorCount <= grColors.count());
     SkASSERT(grInfo.fColorCount <= grOffsets.count());
 
-    resources->fPaintServer.printf("url(#%s)", addLinearGradientDef(grInfo, shader).c_str());
+    resources->fPaintServer.printf("url(#%s)",
+                                   addLinearGradientDef(grInfo, shader, defs).c_str());
 }
 
 void SkSVGDevice::AutoElement::addColorFilterResources(const SkColorFilter& cf,
@@ -501,28 +554,38 @@ void SkSVGDevice::AutoElement::addImageShaderResources(const SkShader* shader, c
     resources->fPaintServer.printf("url(#%s)", patternID.c_str());
 }
 
-void SkSVGDevice::AutoElement::addShaderResources(const SkPaint& paint, Resources* resources) {
+void SkSVGDevice::AutoElement::addShaderResources(const SkPaint& paint, Resources* resources,
+                                                  LazyDefs* defs) {
     const SkShader* shader = paint.getShader();
     SkASSERT(shader);
 
     if (shader->asAGradient(nullptr) != SkShader::kNone_GradientType) {
-        this->addGradientShaderResources(shader, paint, resources);
+        this->addGradientShaderResources(shader, paint, resources, defs);
     } else if (shader->isAImage()) {
+        this->openDefs(defs);
         this->addImageShaderResources(shader, paint, resources);
     }
     // TODO: other shader types?
 }
 
-void SkSVGDevice::AutoElement::addClipResources(const MxCp& mc, Resources* resources) {
+void SkSVGDevice::AutoElement::addClipResources(const MxCp& mc, Resources* resources,
+                                                LazyDefs* defs) {
     SkASSERT(!mc.fClipStack->isWideOpen());
 
     SkPath clipPath;
     (void) mc.fClipStack->asPath(&clipPath);
 
-    SkString clipID = fResourceBucket->addClip();
     const char* clipRule = clipPath.getFillType() == SkPath::kEvenOdd_FillType ?
                            "evenodd" : "nonzero";
-    {
+    SkString clipKey(clipRule);
+    SkString clipData;
+    SkParsePath::ToSVGString(clipPath, &clipData);
+    clipKey.append(clipData);
+
+    SkString clipID;
+    if (fResourceBucket->addClip(clipKey, &clipID)) {
+        this->openDefs(defs);
+
         // clipPath is in device space, but since we're only pushing transform attributes
         // to the leaf nodes, so are all our elements => SVG userSpaceOnUse == device space.
         AutoElement clipPathElement("clipPath", fWriter);
@@ -535,7 +598,7 @@ void SkSVGDevice::AutoElement::addClipResources(const MxCp& mc, Resources* resou
             rectElement.addAttribute("clip-rule", clipRule);
         } else {
             AutoElement pathElement("path", fWriter);
-            pathElement.addPathAttributes(clipPath);
+            pathElement.addAttribute("d", clipData);
             pathElement.addAttribute("clip-rule", clipRule);
         }
     }
@@ -544,11 +607,24 @@ void SkSVGDevice::AutoElement::addClipResources(const MxCp& mc, Resources* resou
 }
 
 SkString SkSVGDevice::AutoElement::addLinearGradientDef(const SkShader::GradientInfo& info,
-                                                        const SkShader* shader) {
+                                                        const SkShader* shader,
+                                                        LazyDefs* defs) {
     SkASSERT(fResourceBucket);
-    SkString id = fResourceBucket->addLinearGradient();
 
-    {
+    // Everything written below, as bytes.
+    SkScalar localMatrix[9];
+    shader->getLocalMatrix().get9(localMatrix);
+    SkString key;
+    key.append(reinterpret_cast<const char*>(info.fPoint), sizeof(info.fPoint));
+    key.append(reinterpret_cast<const char*>(localMatrix), sizeof(localMatrix));
+    key.append(reinterpret_cast<const char*>(info.fColors), info.fColorCount * sizeof(SkColor));
+    key.append(reinterpret_cast<const char*>(info.fColorOffsets),
+               info.fColorCount * sizeof(SkScalar));
+
+    SkString id;
+    if (fResourceBucket->addLinearGradient(key, &id)) {
+        this->openDefs(defs);
+
         AutoElement gradient("linearGradient", fWriter);
 
         gradient.addAttribute("id", id);
@@ -775,13 +851,35 @@ void SkSVGDevice::drawRRect(const SkRRect& rr, const SkPaint& paint) {
     SkPath path;
     path.addRRect(rr);
 
-    AutoElement elem("path", fWriter, fResourceBucket.get(), MxCp(this), paint);
-    elem.addPathAttributes(path);
+    this->drawPathCommon(path, paint);
 }
 
 void SkSVGDevice::drawPath(const SkPath& path, const SkPaint& paint, bool pathIsMutable) {
-    AutoElement elem("path", fWriter, fResourceBucket.get(), MxCp(this), paint);
-    elem.addPathAttributes(path);
+    this->drawPathCommon(path, paint);
+}
+
+void SkSVGDevice::drawPathCommon(const SkPath& path, const SkPaint& paint) {
+    SkString pathData;
+    SkParsePath::ToSVGString(path, &pathData);
+
+    // Paths drawn more than once are defined once, and <use>d with each draw's paint and
+    // transform, which the defined path inherits.
+    SkString pathID;
+    ResourceBucket::PathUse use = fResourceBucket->addPath(pathData, &pathID);
+    if (use == ResourceBucket::PathUse::kDefine) {
+        AutoElement defs("defs", fWriter);
+        AutoElement pathElement("path", fWriter);
+        pathElement.addAttribute("id", pathID);
+        pathElement.addAttribute("d", pathData);
+    }
+
+    bool inlined = use == ResourceBucket::PathUse::kInline;
+    AutoElement elem(inlined ? "path" : "use", fWriter, fResourceBucket.get(), MxCp(this), paint);
+    if (inlined) {
+        elem.addAttribute("d", pathData);
+    } else {
+        elem.addAttribute("xlink:href", SkStringPrintf("#%s", pathID.c_str()));
+    }
 
     // TODO: inverse fill types?
     if (path.getFillType() == SkPath::kEvenOdd_FillType) {
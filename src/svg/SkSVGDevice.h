@@ -48,6 +48,7 @@ private:
 
     struct MxCp;
     void drawBitmapCommon(const MxCp&, const SkBitmap& bm, const SkPaint& paint);
+    void drawPathCommon(const SkPath& path, const SkPaint& paint);
 
     class AutoElement;
     class ResourceBucket;
@@ -9,12 +9,37 @@
 #include "SkCodec.h"
 #include "SkData.h"
 #include "SkImage.h"
+#include "SkTaskGroup.h"
 #include <algorithm>
 
 SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
+    this->init();
+}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(sk_sp<SkData> data, const Options& options)
+        : fCodec(SkCodec::MakeFromData(data))
+        , fData(std::move(data))
+        , fOptions(options) {
+    if (!fCodec) {
+        return;
+    }
+    this->init();
+
+    fOptions.fDecodeAhead = SkTMax(fOptions.fDecodeAhead, 0);
+    if (fOptions.fMaxCachedFrames > 0) {
+        fOptions.fMaxCachedFrames = SkTMax(fOptions.fMaxCachedFrames,
+                                           fOptions.fDecodeAhead + 1);
+    }
+    if (fOptions.fExecutor && fOptions.fDecodeAhead > 0) {
+        fTaskGroup.reset(new SkTaskGroup(*fOptions.fExecutor));
+    }
+}
+
+void SkAnimCodecPlayer::init() {
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
     fImages.resize(fFrameInfos.size());
+    fStates.resize(fFrameInfos.size(), FrameState::kNotDecoded);
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
@@ -31,13 +56,8 @@ SkISize SkAnimCodecPlayer::dimensions() {
     return { fImageInfo.width(), fImageInfo.height() };
 }
 
-sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
-    SkASSERT((unsigned)index < fFrameInfos.size());
-
-    if (fImages[index]) {
-        return fImages[index];
-    }
-
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(SkCodec* codec, int index, int priorIndex,
+                                              const sk_sp<SkImage>& prior) {
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
     auto data = SkData::MakeUninitialized(size);
@@ -47,24 +67,170 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
 
     const int requiredFrame = fFrameInfos[index].fRequiredFrame;
     if (requiredFrame != SkCodec::kNoFrame) {
-        auto requiredImage = fImages[requiredFrame];
+        sk_sp<SkImage> requiredImage;
+        if (requiredFrame == priorIndex) {
+            requiredImage = prior;
+        } else {
+            SkAutoMutexAcquire lock(fMutex);
+            requiredImage = fImages[requiredFrame];
+        }
         SkPixmap requiredPM;
         if (requiredImage && requiredImage->peekPixels(&requiredPM)) {
             sk_careful_memcpy(data->writable_data(), requiredPM.addr(), size);
             opts.fPriorFrame = requiredFrame;
         }
     }
-    if (SkCodec::kSuccess == fCodec->getPixels(fImageInfo, data->writable_data(), rb, &opts)) {
-        return fImages[index] = SkImage::MakeRasterData(fImageInfo, std::move(data), rb);
+    if (SkCodec::kSuccess == codec->getPixels(fImageInfo, data->writable_data(), rb, &opts)) {
+        return SkImage::MakeRasterData(fImageInfo, std::move(data), rb);
     }
     return nullptr;
 }
 
+void SkAnimCodecPlayer::didDecode(int index, sk_sp<SkImage> image) {
+    SkAutoMutexAcquire lock(fMutex);
+    SkASSERT(!fImages[index]);
+    if (image) {
+        fImages[index] = std::move(image);
+        fStates[index] = FrameState::kDecoded;
+        fCachedFrames++;
+        this->dropFramesIfNeeded();
+    } else {
+        fStates[index] = FrameState::kNotDecoded;
+    }
+}
+
+void SkAnimCodecPlayer::dropFramesIfNeeded() {
+    fMutex.assertHeld();
+    if (0 == fOptions.fMaxCachedFrames) {
+        return;
+    }
+    const int frameCount = SkToInt(fFrameInfos.size());
+    while (fCachedFrames > fOptions.fMaxCachedFrames) {
+        // Drop the frame that will be played last.
+        int drop = -1;
+        int dropDistance = -1;
+        for (int i = 0; i < frameCount; ++i) {
+            const int distance = (i - fCurrIndex + frameCount) % frameCount;
+            if (FrameState::kDecoded == fStates[i] && distance > dropDistance) {
+                drop = i;
+                dropDistance = distance;
+            }
+        }
+        SkASSERT(drop >= 0);
+        fImages[drop] = nullptr;
+        fStates[drop] = FrameState::kNotDecoded;
+        fCachedFrames--;
+    }
+}
+
+std::unique_ptr<SkCodec> SkAnimCodecPlayer::takeCodec() {
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (!fSpareCodecs.empty()) {
+            std::unique_ptr<SkCodec> codec = std::move(fSpareCodecs.back());
+            fSpareCodecs.pop_back();
+            return codec;
+        }
+    }
+    return SkCodec::MakeFromData(fData);
+}
+
+void SkAnimCodecPlayer::returnCodec(std::unique_ptr<SkCodec> codec) {
+    if (codec) {
+        SkAutoMutexAcquire lock(fMutex);
+        fSpareCodecs.push_back(std::move(codec));
+    }
+}
+
+void SkAnimCodecPlayer::decodeRun(int first, int count) {
+    std::unique_ptr<SkCodec> codec = this->takeCodec();
+    int priorIndex = -1;
+    sk_sp<SkImage> prior;
+    for (int index = first; index < first + count; ++index) {
+        sk_sp<SkImage> image = codec ? this->decodeFrame(codec.get(), index, priorIndex, prior)
+                                     : nullptr;
+        this->didDecode(index, image);
+        fDecoded.signal();
+        priorIndex = index;
+        prior = std::move(image);
+    }
+    this->returnCodec(std::move(codec));
+}
+
+void SkAnimCodecPlayer::decodeAhead() {
+    if (!fTaskGroup) {
+        return;
+    }
+
+    // Split the frames in the window that need decoding into runs. A frame that needs no prior
+    // frame starts a new run, so runs decode independently. Runs also end where the animation
+    // loops, and at frames that are already decoded or decoding.
+    const int frameCount = SkToInt(fFrameInfos.size());
+    const int window = SkTMin(fOptions.fDecodeAhead + 1, frameCount);
+    std::vector<std::pair<int, int>> runs;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        int first = 0, count = 0;
+        for (int i = 0; i < window; ++i) {
+            const int index = (fCurrIndex + i) % frameCount;
+            const bool startsRun = 0 == index ||
+                                   SkCodec::kNoFrame == fFrameInfos[index].fRequiredFrame;
+            if (count && (startsRun || FrameState::kNotDecoded != fStates[index])) {
+                runs.emplace_back(first, count);
+                count = 0;
+            }
+            if (FrameState::kNotDecoded == fStates[index]) {
+                fStates[index] = FrameState::kDecoding;
+                first = count ? first : index;
+                count++;
+            }
+        }
+        if (count) {
+            runs.emplace_back(first, count);
+        }
+    }
+
+    // Outside of fMutex, in case the executor runs them right away.
+    for (const auto& run : runs) {
+        const int first = run.first, count = run.second;
+        fTaskGroup->add([this, first, count] { this->decodeRun(first, count); });
+    }
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
+    SkASSERT((unsigned)index < fFrameInfos.size());
+
+    fMutex.acquire();
+    while (FrameState::kDecoding == fStates[index]) {
+        fMutex.release();
+        fDecoded.wait();
+        fMutex.acquire();
+    }
+    sk_sp<SkImage> image = fImages[index];
+    fMutex.release();
+    if (image) {
+        return image;
+    }
+
+    image = this->decodeFrame(fCodec.get(), index, -1, nullptr);
+    if (image) {
+        this->didDecode(index, image);
+    }
+    return image;
+}
+
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
+    if (fFrameInfos.empty()) {
+        return nullptr;
+    }
+    this->decodeAhead();
     return this->getFrameAt(fCurrIndex);
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
+    if (0 == fTotalDuration) {
+        return false;
+    }
     msec %= fTotalDuration;
 
     auto lower = std::lower_bound(fFrameInfos.begin(), fFrameInfos.end(), msec,
@@ -72,8 +238,10 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
                                       return (uint32_t)info.fDuration < msec;
                                   });
     int prevIndex = fCurrIndex;
-    fCurrIndex = lower - fFrameInfos.begin();
+    {
+        // Decodes on the executor read fCurrIndex to choose which frames to drop.
+        SkAutoMutexAcquire lock(fMutex);
+        fCurrIndex = lower - fFrameInfos.begin();
+    }
     return fCurrIndex != prevIndex;
 }
-
-
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBandRenderer.h"
+
+#include "SkBBHFactory.h"
+#include "SkBigPicture.h"
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPicturePriv.h"
+#include "SkPictureRecorder.h"
+#include "SkPixmap.h"
+#include "SkSurface.h"
+#include "SkTemplates.h"
+
+// Culling by bounds needs an SkBBoxHierarchy, which only SkBigPictures carry. Pictures small
+// enough to be stored some other way are cheap to play back whole.
+static sk_sp<const SkPicture> with_bbh(sk_sp<const SkPicture> picture) {
+    const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(picture);
+    if (!big || big->bbh()) {
+        return picture;
+    }
+
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    picture->playback(recorder.beginRecording(picture->cullRect(), &factory));
+    return recorder.finishRecordingAsPicture();
+}
+
+bool SkBandRenderer::RenderPicture(const SkPicture* picture, const SkImageInfo& info,
+                                   int bandHeight, const BandSink& sink,
+                                   const SkSurfaceProps* props) {
+    if (!picture || bandHeight <= 0 || info.isEmpty() || !sink) {
+        return false;
+    }
+    bandHeight = SkTMin(bandHeight, info.height());
+
+    // Every band shares the same pixels.
+    const SkImageInfo bandInfo = info.makeWH(info.width(), bandHeight);
+    const size_t rowBytes = bandInfo.minRowBytes();
+    SkAutoTMalloc<char> storage(bandInfo.computeByteSize(rowBytes));
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterDirect(bandInfo, storage.get(), rowBytes,
+                                                           props);
+    if (!surface) {
+        return false;
+    }
+
+    sk_sp<const SkPicture> culled = sk_ref_sp(picture);
+    if (bandHeight < info.height()) {
+        culled = with_bbh(std::move(culled));
+    }
+
+    SkCanvas* canvas = surface->getCanvas();
+    for (int top = 0; top < info.height(); top += bandHeight) {
+        int rows = SkTMin(bandHeight, info.height() - top);
+
+        canvas->clear(SK_ColorTRANSPARENT);
+        canvas->save();
+        canvas->clipRect(SkRect::MakeIWH(info.width(), rows));
+        canvas->translate(0, -SkIntToScalar(top));
+        culled->playback(canvas);
+        canvas->restore();
+
+        SkPixmap pixels, band;
+        SkAssertResult(surface->peekPixels(&pixels));
+        SkAssertResult(pixels.extractSubset(&band, SkIRect::MakeWH(info.width(), rows)));
+        if (!sink(band, top)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -7,6 +7,7 @@
 
 #include "SkDashPathPriv.h"
 #include "SkPathMeasure.h"
+#include "SkPathMeasurePriv.h"
 #include "SkPointPriv.h"
 #include "SkStrokeRec.h"
 
@@ -364,7 +365,9 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
     bool specialLine = (StrokeRecApplication::kAllow == strokeRecApplication) &&
                        lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
 
-    SkPathMeasure   meas(*srcPtr, false, rec->getResScale());
+    // Animated dashes filter the same path every frame, with only the phase changing.
+    SkPathMeasure   meas;
+    SkPathMeasurePriv::SetPathCached(&meas, *srcPtr, false, rec->getResScale());
 
     do {
         bool        skipFirstSegment = meas.isClosed();
@@ -0,0 +1,850 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFrameStream.h"
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkDeduper.h"
+#include "SkImage.h"
+#include "SkImageFilter.h"
+#include "SkOpts.h"
+#include "SkPaintPriv.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkReadBuffer.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkRecords.h"
+#include "SkRRect.h"
+#include "SkSerialProcs.h"
+#include "SkStream.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+#include "SkTextBlob.h"
+#include "SkTextBlobPriv.h"
+#include "SkTypeface.h"
+#include "SkWriteBuffer.h"
+
+/*  A frame is an SkBinaryWriteBuffer holding
+
+        magic, version, frame index, reset?, cull rect
+        verb, arguments
+        ...
+        kEnd
+
+    Definitions come before the first op that refers to them, so the reader can inflate each
+    object as it sees it.  Objects are referred to by 1-based IDs, assigned in order per kind of
+    object; 0 means none.  Flattened paints and blobs refer to typefaces, images and factories
+    by ID too (SkWriteBuffer's SkDeduper hook), so identical paints flatten to identical bytes
+    from frame to frame and we can intern them by content.
+ */
+
+namespace {
+
+constexpr uint32_t kMagic   = SkSetFourByteTag('s','k','f','s');
+constexpr uint32_t kVersion = 1;
+
+enum class Verb : uint32_t {
+    kEnd,
+
+    kDefineTypeface, kDefineImage, kDefineFactory,
+    kDefinePaint, kDefinePath, kDefineBlob,
+
+    kSave, kSaveLayer, kRestore,
+    kSetMatrix, kConcat, kTranslate,
+    kClipRect, kClipRRect, kClipPath, kClipRegion,
+
+    kDrawPaint, kDrawRect, kDrawRRect, kDrawDRRect, kDrawOval, kDrawArc, kDrawPath,
+    kDrawPoints, kDrawRegion, kDrawImage, kDrawImageRect, kDrawTextBlob,
+
+    // Everything else is sent as a serialized picture holding just that op.
+    kDrawPicture,
+
+    kLast = kDrawPicture,
+};
+
+sk_sp<SkData> snapshot(const SkBinaryWriteBuffer& buffer) {
+    sk_sp<SkData> data = SkData::MakeUninitialized(buffer.bytesWritten());
+    buffer.writeToMemory(data->writable_data());
+    return data;
+}
+
+void write_rrect(SkWriteBuffer* buffer, const SkRRect& rrect) {
+    char storage[SkRRect::kSizeInMemory];
+    rrect.writeToMemory(storage);
+    buffer->writePad32(storage, sizeof(storage));
+}
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SkFrameStreamWriter::State : public SkDeduper {
+    // Objects interned by the content of their serialized bytes.
+    struct Interned {
+        SkTHashMap<uint32_t, int>  fIDs;      // hash of bytes -> ID
+        SkTArray<sk_sp<SkData>>    fBytes;    // ID-1 -> bytes
+
+        void reset() { fIDs.reset(); fBytes.reset(); }
+    };
+
+    SkBinaryWriteBuffer* fOut = nullptr;
+    Stats                fStats;
+    uint32_t             fNextFrame = 0;
+    bool                 fResetPending = true;
+
+    SkTHashMap<uint32_t, int> fTypefaceIDs, fImageIDs;  // uniqueID -> ID
+    SkTHashMap<SkString, int> fFactoryIDs;              // name -> ID
+    Interned                  fPaints, fPaths, fBlobs;
+
+    void reset() {
+        fTypefaceIDs.reset();
+        fImageIDs.reset();
+        fFactoryIDs.reset();
+        fPaints.reset();
+        fPaths.reset();
+        fBlobs.reset();
+        fNextFrame = 0;
+        fResetPending = true;
+    }
+
+    void verb(Verb v) { fOut->writeUInt((uint32_t)v); }
+
+    void define(Verb v, int id, const SkData* bytes) {
+        this->verb(v);
+        fOut->writeInt(id);
+        if (bytes) {
+            fOut->writeByteArray(bytes->data(), bytes->size());
+        } else {
+            fOut->writeByteArray(nullptr, 0);
+        }
+        fStats.fDefinitions++;
+    }
+
+    int intern(Interned* table, Verb v, sk_sp<SkData> bytes) {
+        uint32_t hash = SkOpts::hash(bytes->data(), bytes->size());
+        if (const int* id = table->fIDs.find(hash)) {
+            if (table->fBytes[*id - 1]->equals(bytes.get())) {
+                fStats.fReferences++;
+                return *id;
+            }
+        }
+        int id = table->fBytes.count() + 1;
+        this->define(v, id, bytes.get());
+        table->fIDs.set(hash, id);
+        table->fBytes.push_back(std::move(bytes));
+        return id;
+    }
+
+    // SkDeduper
+    int findOrDefineTypeface(SkTypeface* typeface) override {
+        if (!typeface) {
+            return 0;   // The default typeface.
+        }
+        if (const int* id = fTypefaceIDs.find(typeface->uniqueID())) {
+            fStats.fReferences++;
+            return *id;
+        }
+        int id = fTypefaceIDs.count() + 1;
+        fTypefaceIDs.set(typeface->uniqueID(), id);
+        this->define(Verb::kDefineTypeface, id, typeface->serialize().get());
+        return id;
+    }
+
+    int findOrDefineImage(SkImage* image) override {
+        if (!image) {
+            return 0;
+        }
+        if (const int* id = fImageIDs.find(image->uniqueID())) {
+            fStats.fReferences++;
+            return *id;
+        }
+        sk_sp<SkData> encoded = image->refEncodedData();
+        if (!encoded) {
+            encoded = image->encodeToData();
+        }
+        if (!encoded) {
+            return 0;
+        }
+        int id = fImageIDs.count() + 1;
+        fImageIDs.set(image->uniqueID(), id);
+        this->define(Verb::kDefineImage, id, encoded.get());
+        return id;
+    }
+
+    int findOrDefineFactory(SkFlattenable* flattenable) override {
+        const char* name = flattenable->getTypeName();
+        if (!name) {
+            return 0;
+        }
+        SkString key(name);
+        if (const int* id = fFactoryIDs.find(key)) {
+            fStats.fReferences++;
+            return *id;
+        }
+        int id = fFactoryIDs.count() + 1;
+        fFactoryIDs.set(key, id);
+        this->verb(Verb::kDefineFactory);
+        fOut->writeInt(id);
+        fOut->writeString(name);
+        fStats.fDefinitions++;
+        return id;
+    }
+
+    // Pictures are always inlined (see writeFrame()), except inside shaders and such.
+    int findOrDefinePicture(SkPicture*) override { return 0; }
+
+    template <typename Fn>
+    sk_sp<SkData> flatten(Fn&& fn) {
+        SkBinaryWriteBuffer buffer;
+        buffer.setDeduper(this);
+        fn(buffer);
+        return snapshot(buffer);
+    }
+
+    int paint(const SkPaint& paint) {
+        return this->intern(&fPaints, Verb::kDefinePaint,
+                            this->flatten([&](SkWriteBuffer& b) { SkPaintPriv::Flatten(paint, b); }));
+    }
+    int paint(const SkPaint* paint) { return paint ? this->paint(*paint) : 0; }
+
+    int path(const SkPath& path) {
+        sk_sp<SkData> bytes = SkData::MakeUninitialized(path.writeToMemory(nullptr));
+        path.writeToMemory(bytes->writable_data());
+        return this->intern(&fPaths, Verb::kDefinePath, std::move(bytes));
+    }
+
+    int blob(const SkTextBlob& blob) {
+        return this->intern(&fBlobs, Verb::kDefineBlob,
+                            this->flatten([&](SkWriteBuffer& b) { SkTextBlobPriv::Flatten(blob, b); }));
+    }
+
+    // Writing ops.  Arguments that refer to objects are evaluated first, so their definitions
+    // precede the op.
+
+    void operator()(const SkRecords::NoOp&) {}
+    void operator()(const SkRecords::Save&)    { this->verb(Verb::kSave); }
+    void operator()(const SkRecords::Restore&) { this->verb(Verb::kRestore); }
+    void operator()(const SkRecords::SaveLayer& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kSaveLayer);
+        fOut->writeBool(op.bounds != nullptr);
+        if (op.bounds) {
+            fOut->writeRect(*op.bounds);
+        }
+        fOut->writeInt(paint);
+        fOut->writeFlattenable(op.backdrop.get());
+        fOut->writeBool(op.clipMask != nullptr);
+        if (op.clipMask) {
+            fOut->writeImage(op.clipMask.get());
+        }
+        fOut->writeBool(op.clipMatrix != nullptr);
+        if (op.clipMatrix) {
+            fOut->writeMatrix(*op.clipMatrix);
+        }
+        fOut->writeUInt(op.saveLayerFlags);
+    }
+
+    void operator()(const SkRecords::SetMatrix& op) {
+        this->verb(Verb::kSetMatrix);
+        fOut->writeMatrix(op.matrix);
+    }
+    void operator()(const SkRecords::Concat& op) {
+        this->verb(Verb::kConcat);
+        fOut->writeMatrix(op.matrix);
+    }
+    void operator()(const SkRecords::Translate& op) {
+        this->verb(Verb::kTranslate);
+        fOut->writeScalar(op.dx);
+        fOut->writeScalar(op.dy);
+    }
+
+    void clipOp(const SkRecords::ClipOpAndAA& opAA) {
+        fOut->writeUInt((uint32_t)opAA.op());
+        fOut->writeBool(opAA.aa());
+    }
+    void operator()(const SkRecords::ClipRect& op) {
+        this->verb(Verb::kClipRect);
+        fOut->writeRect(op.rect);
+        this->clipOp(op.opAA);
+    }
+    void operator()(const SkRecords::ClipRRect& op) {
+        this->verb(Verb::kClipRRect);
+        write_rrect(fOut, op.rrect);
+        this->clipOp(op.opAA);
+    }
+    void operator()(const SkRecords::ClipPath& op) {
+        int path = this->path(op.path);
+        this->verb(Verb::kClipPath);
+        fOut->writeInt(path);
+        this->clipOp(op.opAA);
+    }
+    void operator()(const SkRecords::ClipRegion& op) {
+        this->verb(Verb::kClipRegion);
+        fOut->writeRegion(op.region);
+        fOut->writeUInt((uint32_t)op.op);
+    }
+
+    void operator()(const SkRecords::DrawPaint& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawPaint);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawRect& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawRect);
+        fOut->writeRect(op.rect);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawRRect& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawRRect);
+        write_rrect(fOut, op.rrect);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawDRRect& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawDRRect);
+        write_rrect(fOut, op.outer);
+        write_rrect(fOut, op.inner);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawOval& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawOval);
+        fOut->writeRect(op.oval);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawArc& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawArc);
+        fOut->writeRect(op.oval);
+        fOut->writeScalar(op.startAngle);
+        fOut->writeScalar(op.sweepAngle);
+        fOut->writeBool(op.useCenter);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawPath& op) {
+        int path  = this->path(op.path),
+            paint = this->paint(op.paint);
+        this->verb(Verb::kDrawPath);
+        fOut->writeInt(path);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawPoints& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawPoints);
+        fOut->writeUInt(op.mode);
+        fOut->writePointArray(op.pts, op.count);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawRegion& op) {
+        int paint = this->paint(op.paint);
+        this->verb(Verb::kDrawRegion);
+        fOut->writeRegion(op.region);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawImage& op) {
+        int image = this->findOrDefineImage(const_cast<SkImage*>(op.image.get())),
+            paint = this->paint(op.paint);
+        this->verb(Verb::kDrawImage);
+        fOut->writeInt(image);
+        fOut->writeScalar(op.left);
+        fOut->writeScalar(op.top);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawImageRect& op) {
+        int image = this->findOrDefineImage(const_cast<SkImage*>(op.image.get())),
+            paint = this->paint(op.paint);
+        this->verb(Verb::kDrawImageRect);
+        fOut->writeInt(image);
+        fOut->writeBool(op.src != nullptr);
+        if (op.src) {
+            fOut->writeRect(*op.src);
+        }
+        fOut->writeRect(op.dst);
+        fOut->writeUInt(op.constraint);
+        fOut->writeInt(paint);
+    }
+    void operator()(const SkRecords::DrawTextBlob& op) {
+        int blob  = this->blob(*op.blob),
+            paint = this->paint(op.paint);
+        this->verb(Verb::kDrawTextBlob);
+        fOut->writeInt(blob);
+        fOut->writeScalar(op.x);
+        fOut->writeScalar(op.y);
+        fOut->writeInt(paint);
+    }
+
+    template <typename T>
+    void operator()(const T& op) {
+        // Record just this op, in the current local space, and send it as a picture.  Its
+        // images and typefaces still go through our tables.
+        SkPictureRecorder recorder;
+        SkRecords::Draw draw(recorder.beginRecording(fCull), nullptr, nullptr, 0);
+        draw(op);
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+        SkSerialProcs procs;
+        procs.fImageCtx = procs.fTypefaceCtx = this;
+        procs.fImageProc = [](SkImage* image, void* ctx) {
+            int id = ((State*)ctx)->findOrDefineImage(image);
+            return SkData::MakeWithCopy(&id, sizeof(id));
+        };
+        procs.fTypefaceProc = [](SkTypeface* typeface, void* ctx) {
+            int id = ((State*)ctx)->findOrDefineTypeface(typeface);
+            return SkData::MakeWithCopy(&id, sizeof(id));
+        };
+        sk_sp<SkData> bytes = picture->serialize(&procs);
+
+        this->verb(Verb::kDrawPicture);
+        fOut->writeDataAsByteArray(bytes.get());
+        fStats.fFallbackOps++;
+    }
+
+    SkRect fCull = SkRect::MakeEmpty();
+};
+
+SkFrameStreamWriter::SkFrameStreamWriter() : fState(new State) {}
+SkFrameStreamWriter::~SkFrameStreamWriter() {}
+
+void SkFrameStreamWriter::reset() { fState->reset(); }
+
+sk_sp<SkData> SkFrameStreamWriter::writeFrame(const SkPicture* picture, Stats* stats) {
+    State* state = fState.get();
+    const SkRect cull = picture->cullRect();
+
+    // Re-record the picture so we can walk its ops, inlining any nested pictures.
+    SkRecord record;
+    SkRecorder recorder(&record, cull);
+    recorder.reset(&record, cull, SkRecorder::Playback_DrawPictureMode);
+    picture->playback(&recorder);
+
+    SkBinaryWriteBuffer out;
+    out.setDeduper(state);
+    state->fOut   = &out;
+    state->fCull  = cull;
+    state->fStats = Stats();
+
+    out.writeUInt(kMagic);
+    out.writeUInt(kVersion);
+    out.writeUInt(state->fNextFrame++);
+    out.writeBool(state->fResetPending);
+    out.writeRect(cull);
+    state->fResetPending = false;
+
+    for (int i = 0; i < record.count(); i++) {
+        record.visit(i, *state);
+    }
+    state->verb(Verb::kEnd);
+
+    state->fOut = nullptr;
+    if (stats) {
+        *stats = state->fStats;
+    }
+    return snapshot(out);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SkFrameStreamReader::State : public SkInflator {
+    SkTArray<sk_sp<SkTypeface>>        fTypefaces;
+    SkTArray<sk_sp<SkImage>>           fImages;
+    SkTArray<SkFlattenable::Factory>   fFactories;
+    SkTArray<SkPaint>                  fPaints;
+    SkTArray<SkPath>                   fPaths;
+    SkTArray<sk_sp<SkTextBlob>>        fBlobs;
+    uint32_t                           fNextFrame = 0;
+    bool                               fFailed = true;   // Until we see a reset.
+
+    void reset() {
+        fTypefaces.reset();
+        fImages.reset();
+        fFactories.reset();
+        fPaints.reset();
+        fPaths.reset();
+        fBlobs.reset();
+    }
+
+    template <typename T>
+    static T* lookup(SkTArray<T>& table, int id) {
+        return 1 <= id && id <= table.count() ? &table[id - 1] : nullptr;
+    }
+
+    // SkInflator
+    SkImage* getImage(int id) override {
+        sk_sp<SkImage>* image = lookup(fImages, id);
+        return image ? image->get() : nullptr;
+    }
+    SkPicture* getPicture(int) override { return nullptr; }
+    SkTypeface* getTypeface(int id) override {
+        sk_sp<SkTypeface>* typeface = lookup(fTypefaces, id);
+        return typeface ? typeface->get() : nullptr;
+    }
+    SkFlattenable::Factory getFactory(int id) override {
+        SkFlattenable::Factory* factory = lookup(fFactories, id);
+        return factory ? *factory : nullptr;
+    }
+
+    // Reads a definition's ID, which must be the next one for its table, and its bytes.
+    template <typename T>
+    sk_sp<SkData> readDefinition(SkReadBuffer& buffer, const SkTArray<T>& table) {
+        int id = buffer.readInt();
+        sk_sp<SkData> bytes = buffer.readByteArrayAsData();
+        if (!buffer.validate(id == table.count() + 1 && bytes)) {
+            return nullptr;
+        }
+        return bytes;
+    }
+
+    // Flattened paints and blobs refer back to our tables.
+    std::unique_ptr<SkReadBuffer> inflate(const SkData& bytes) {
+        std::unique_ptr<SkReadBuffer> buffer(new SkReadBuffer(bytes.data(), bytes.size()));
+        buffer->setInflator(this);
+        return buffer;
+    }
+
+    bool define(Verb verb, SkReadBuffer& buffer) {
+        switch (verb) {
+            case Verb::kDefineTypeface: {
+                sk_sp<SkData> bytes = this->readDefinition(buffer, fTypefaces);
+                if (bytes) {
+                    SkMemoryStream stream(std::move(bytes));
+                    // A typeface we can't make falls back to the default one.
+                    fTypefaces.push_back(SkTypeface::MakeDeserialize(&stream));
+                }
+            } break;
+            case Verb::kDefineImage: {
+                sk_sp<SkData> bytes = this->readDefinition(buffer, fImages);
+                if (bytes) {
+                    fImages.push_back(SkImage::MakeFromEncoded(std::move(bytes)));
+                }
+            } break;
+            case Verb::kDefineFactory: {
+                int id = buffer.readInt();
+                SkString name;
+                buffer.readString(&name);
+                SkFlattenable::Factory factory = SkFlattenable::NameToFactory(name.c_str());
+                if (buffer.validate(id == fFactories.count() + 1 && factory)) {
+                    fFactories.push_back(factory);
+                }
+            } break;
+            case Verb::kDefinePaint: {
+                sk_sp<SkData> bytes = this->readDefinition(buffer, fPaints);
+                if (bytes) {
+                    SkPaint paint;
+                    auto inflater = this->inflate(*bytes);
+                    if (buffer.validate(SkPaintPriv::Unflatten(&paint, *inflater) &&
+                                        inflater->isValid())) {
+                        fPaints.push_back(paint);
+                    }
+                }
+            } break;
+            case Verb::kDefinePath: {
+                sk_sp<SkData> bytes = this->readDefinition(buffer, fPaths);
+                if (bytes) {
+                    SkPath path;
+                    if (buffer.validate(path.readFromMemory(bytes->data(), bytes->size()) != 0)) {
+                        fPaths.push_back(path);
+                    }
+                }
+            } break;
+            case Verb::kDefineBlob: {
+                sk_sp<SkData> bytes = this->readDefinition(buffer, fBlobs);
+                if (bytes) {
+                    sk_sp<SkTextBlob> blob = SkTextBlobPriv::MakeFromBuffer(*this->inflate(*bytes));
+                    if (buffer.validate(blob != nullptr)) {
+                        fBlobs.push_back(std::move(blob));
+                    }
+                }
+            } break;
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    // Invalid references fail the whole frame, so it doesn't matter what we draw with them.
+    const SkPaint& paint(SkReadBuffer& buffer) {
+        static const SkPaint kInvalid;
+        const SkPaint* paint = lookup(fPaints, buffer.readInt());
+        buffer.validate(paint != nullptr);
+        return paint ? *paint : kInvalid;
+    }
+    const SkPaint* optionalPaint(SkReadBuffer& buffer) {
+        int id = buffer.readInt();
+        const SkPaint* paint = lookup(fPaints, id);
+        buffer.validate(id == 0 || paint);
+        return paint;
+    }
+    const SkPath& path(SkReadBuffer& buffer) {
+        static const SkPath kInvalid;
+        const SkPath* path = lookup(fPaths, buffer.readInt());
+        buffer.validate(path != nullptr);
+        return path ? *path : kInvalid;
+    }
+    SkImage* image(SkReadBuffer& buffer) {
+        SkImage* image = this->getImage(buffer.readInt());
+        buffer.validate(image != nullptr);
+        return image;
+    }
+    void clipOp(SkReadBuffer& buffer, SkClipOp* op, bool* aa) {
+        *op = buffer.read32LE(SkClipOp::kMax_EnumValue);
+        *aa = buffer.readBool();
+    }
+
+    void drawPicture(SkReadBuffer& buffer, SkCanvas* canvas) {
+        sk_sp<SkData> bytes = buffer.readByteArrayAsData();
+        if (!buffer.validate(bytes != nullptr)) {
+            return;
+        }
+        SkDeserialProcs procs;
+        procs.fImageCtx = procs.fTypefaceCtx = this;
+        procs.fImageProc = [](const void* data, size_t length, void* ctx) -> sk_sp<SkImage> {
+            int id = 0;
+            if (length == sizeof(id)) {
+                memcpy(&id, data, sizeof(id));
+            }
+            return sk_ref_sp(((State*)ctx)->getImage(id));
+        };
+        procs.fTypefaceProc = [](const void* data, size_t length, void* ctx) {
+            int id = 0;
+            if (length == sizeof(id)) {
+                memcpy(&id, data, sizeof(id));
+            }
+            return sk_ref_sp(((State*)ctx)->getTypeface(id));
+        };
+        sk_sp<SkPicture> picture = SkPicture::MakeFromData(bytes.get(), &procs);
+        if (buffer.validate(picture != nullptr)) {
+            canvas->drawPicture(picture);
+        }
+    }
+
+    // Reads and replays one op, returning false at the end of the frame or on error.
+    bool op(SkReadBuffer& buffer, SkCanvas* canvas) {
+        Verb verb = buffer.read32LE(Verb::kLast);
+        if (!buffer.isValid() || verb == Verb::kEnd) {
+            return false;
+        }
+        if (this->define(verb, buffer)) {
+            return buffer.isValid();
+        }
+
+        SkRect   rect;
+        SkRRect  rrect, inner;
+        SkMatrix matrix;
+        SkRegion region;
+        SkClipOp clipOp;
+        bool     aa;
+        switch (verb) {
+            case Verb::kSave:    canvas->save();    break;
+            case Verb::kRestore: canvas->restore(); break;
+            case Verb::kSaveLayer: {
+                SkRect bounds;
+                bool hasBounds = buffer.readBool();
+                if (hasBounds) {
+                    buffer.readRect(&bounds);
+                }
+                const SkPaint* paint = this->optionalPaint(buffer);
+                sk_sp<SkImageFilter> backdrop = buffer.readImageFilter();
+                sk_sp<SkImage> clipMask;
+                if (buffer.readBool()) {
+                    clipMask = sk_ref_sp(this->image(buffer));
+                }
+                bool hasClipMatrix = buffer.readBool();
+                if (hasClipMatrix) {
+                    buffer.readMatrix(&matrix);
+                }
+                SkCanvas::SaveLayerFlags flags = buffer.readUInt();
+                if (buffer.isValid()) {
+                    canvas->saveLayer({ hasBounds ? &bounds : nullptr, paint, backdrop.get(),
+                                        clipMask.get(), hasClipMatrix ? &matrix : nullptr,
+                                        flags });
+                }
+            } break;
+
+            case Verb::kSetMatrix:
+                buffer.readMatrix(&matrix);
+                canvas->setMatrix(matrix);
+                break;
+            case Verb::kConcat:
+                buffer.readMatrix(&matrix);
+                canvas->concat(matrix);
+                break;
+            case Verb::kTranslate: {
+                SkScalar dx = buffer.readScalar();
+                canvas->translate(dx, buffer.readScalar());
+            } break;
+
+            case Verb::kClipRect:
+                buffer.readRect(&rect);
+                this->clipOp(buffer, &clipOp, &aa);
+                canvas->clipRect(rect, clipOp, aa);
+                break;
+            case Verb::kClipRRect:
+                buffer.readRRect(&rrect);
+                this->clipOp(buffer, &clipOp, &aa);
+                canvas->clipRRect(rrect, clipOp, aa);
+                break;
+            case Verb::kClipPath: {
+                const SkPath& path = this->path(buffer);
+                this->clipOp(buffer, &clipOp, &aa);
+                canvas->clipPath(path, clipOp, aa);
+            } break;
+            case Verb::kClipRegion:
+                buffer.readRegion(&region);
+                canvas->clipRegion(region, buffer.read32LE(SkClipOp::kMax_EnumValue));
+                break;
+
+            case Verb::kDrawPaint:
+                canvas->drawPaint(this->paint(buffer));
+                break;
+            case Verb::kDrawRect:
+                buffer.readRect(&rect);
+                canvas->drawRect(rect, this->paint(buffer));
+                break;
+            case Verb::kDrawRRect:
+                buffer.readRRect(&rrect);
+                canvas->drawRRect(rrect, this->paint(buffer));
+                break;
+            case Verb::kDrawDRRect:
+                buffer.readRRect(&rrect);
+                buffer.readRRect(&inner);
+                canvas->drawDRRect(rrect, inner, this->paint(buffer));
+                break;
+            case Verb::kDrawOval:
+                buffer.readRect(&rect);
+                canvas->drawOval(rect, this->paint(buffer));
+                break;
+            case Verb::kDrawArc: {
+                buffer.readRect(&rect);
+                SkScalar start = buffer.readScalar(),
+                         sweep = buffer.readScalar();
+                bool useCenter = buffer.readBool();
+                canvas->drawArc(rect, start, sweep, useCenter, this->paint(buffer));
+            } break;
+            case Verb::kDrawPath: {
+                const SkPath& path = this->path(buffer);
+                canvas->drawPath(path, this->paint(buffer));
+            } break;
+            case Verb::kDrawPoints: {
+                auto mode = buffer.read32LE(SkCanvas::kPolygon_PointMode);
+                uint32_t count = buffer.getArrayCount();
+                SkAutoTMalloc<SkPoint> pts;
+                if (buffer.validateCanReadN<SkPoint>(count)) {
+                    pts.reset(count);
+                    buffer.readPointArray(pts.get(), count);
+                }
+                const SkPaint& paint = this->paint(buffer);
+                if (buffer.isValid()) {
+                    canvas->drawPoints(mode, count, pts.get(), paint);
+                }
+            } break;
+            case Verb::kDrawRegion:
+                buffer.readRegion(&region);
+                canvas->drawRegion(region, this->paint(buffer));
+                break;
+            case Verb::kDrawImage: {
+                SkImage* image = this->image(buffer);
+                SkScalar x = buffer.readScalar(),
+                         y = buffer.readScalar();
+                const SkPaint* paint = this->optionalPaint(buffer);
+                if (buffer.isValid()) {
+                    canvas->drawImage(image, x, y, paint);
+                }
+            } break;
+            case Verb::kDrawImageRect: {
+                SkImage* image = this->image(buffer);
+                bool hasSrc = buffer.readBool();
+                SkRect src;
+                if (hasSrc) {
+                    buffer.readRect(&src);
+                }
+                buffer.readRect(&rect);
+                auto constraint = buffer.read32LE(SkCanvas::kFast_SrcRectConstraint);
+                const SkPaint* paint = this->optionalPaint(buffer);
+                if (!buffer.isValid()) {
+                    break;
+                }
+                if (hasSrc) {
+                    canvas->drawImageRect(image, src, rect, paint, constraint);
+                } else {
+                    canvas->drawImageRect(image, rect, paint);
+                }
+            } break;
+            case Verb::kDrawTextBlob: {
+                sk_sp<SkTextBlob>* blob = lookup(fBlobs, buffer.readInt());
+                SkScalar x = buffer.readScalar(),
+                         y = buffer.readScalar();
+                const SkPaint& paint = this->paint(buffer);
+                if (buffer.validate(blob != nullptr)) {
+                    canvas->drawTextBlob(blob->get(), x, y, paint);
+                }
+            } break;
+
+            case Verb::kDrawPicture:
+                this->drawPicture(buffer, canvas);
+                break;
+
+            default:
+                buffer.validate(false);
+                break;
+        }
+        return buffer.isValid();
+    }
+};
+
+SkFrameStreamReader::SkFrameStreamReader() : fState(new State) {}
+SkFrameStreamReader::~SkFrameStreamReader() {}
+
+sk_sp<SkPicture> SkFrameStreamReader::readFrame(const void* data, size_t length) {
+    State* state = fState.get();
+
+    // SkReadBuffer needs 4-byte aligned memory.
+    sk_sp<SkData> copy;
+    if (!SkIsAlign4((uintptr_t)data)) {
+        copy = SkData::MakeWithCopy(data, length);
+        data = copy->data();
+    }
+
+    SkReadBuffer buffer(data, length);
+    buffer.setInflator(state);
+
+    uint32_t magic   = buffer.readUInt(),
+             version = buffer.readUInt(),
+             frame   = buffer.readUInt();
+    bool reset = buffer.readBool();
+    SkRect cull;
+    buffer.readRect(&cull);
+    if (!buffer.validate(magic == kMagic && version == kVersion)) {
+        return nullptr;
+    }
+
+    if (reset) {
+        state->reset();
+        state->fFailed    = false;
+        state->fNextFrame = frame;
+    }
+    if (state->fFailed || frame != state->fNextFrame) {
+        state->fFailed = true;
+        return nullptr;
+    }
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(cull);
+    while (state->op(buffer, canvas)) {}
+
+    if (!buffer.isValid()) {
+        // Our tables may no longer match the writer's.
+        state->fFailed = true;
+        return nullptr;
+    }
+    state->fNextFrame++;
+    return recorder.finishRecordingAsPicture();
+}
@@ -8,6 +8,7 @@
 #include "SkJSON.h"
 
 #include "SkMalloc.h"
+#include "SkNx.h"
 #include "SkStream.h"
 #include "SkString.h"
 
@@ -254,6 +255,50 @@ static inline bool is_digit(char c)    { return g_token_flags[static_cast<uint8_
 static inline bool is_numeric(char c)  { return g_token_flags[static_cast<uint8_t>(c)] & 0x10; }
 static inline bool is_eoscope(char c)  { return g_token_flags[static_cast<uint8_t>(c)] & 0x20; }
 
+// Skips over chars up to (but not necessarily right up to) the first string terminator, a block
+// of chars at a time -- without reading past p_stop.  Long strings (e.g. embedded image data)
+// would dominate parsing otherwise.
+static inline const char* skip_string_chars(const char* p, const char* p_stop) {
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    const auto quote  = _mm_set1_epi8('"'),
+               brace  = _mm_set1_epi8('}'),
+               square = _mm_set1_epi8(']'),
+               // There are no unsigned byte compares: bias both sides to compare signed.
+               bias   = _mm_set1_epi8(-128),
+               space  = _mm_set1_epi8(0x20 - 128);
+
+    for (; p + 16 <= p_stop; p += 16) {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto terminators =
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, quote),
+                                          _mm_cmpeq_epi8(chars, brace)),
+                             _mm_or_si128(_mm_cmpeq_epi8(chars, square),
+                                          _mm_cmplt_epi8(_mm_xor_si128(chars, bias), space)));
+        if (_mm_movemask_epi8(terminators)) {
+            break;
+        }
+    }
+#else
+    // SWAR: (x - 0x01..) & ~x & 0x80.. is non-zero iff x has a zero byte.
+    static constexpr uint64_t k01 = 0x0101010101010101ULL,
+                              k80 = 0x8080808080808080ULL;
+    const auto has_zero = [](uint64_t x) { return (x - k01) & ~x & k80; };
+
+    for (; p + 8 <= p_stop; p += 8) {
+        uint64_t chars;
+        memcpy(&chars, p, sizeof(chars));
+        if (((chars - k01 * 0x20) & ~chars & k80) |  // control chars (< 0x20, including \0)
+            has_zero(chars ^ (k01 * '"'))          |
+            has_zero(chars ^ (k01 * '}'))          |
+            has_zero(chars ^ (k01 * ']'))) {
+            break;
+        }
+    }
+#endif
+
+    return p;
+}
+
 static inline const char* skip_ws(const char* p) {
     while (is_ws(*p)) ++p;
     return p;
@@ -635,7 +680,7 @@ private:
 
         do {
             // Consume string chars.
-            for (p = p + 1; !is_eostring(*p); ++p);
+            for (p = skip_string_chars(p + 1, p_stop); !is_eostring(*p); ++p);
 
             if (*p == '"') {
                 // Valid string found.
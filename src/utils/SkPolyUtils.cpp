@@ -1149,41 +1149,43 @@ bool SkOffsetSimplePolygon(const SkPoint* inputPolygonVerts, int inputPolygonSiz
 
     // build normals
     SkAutoSTMalloc<64, SkVector> normals(inputPolygonSize);
-    unsigned int numEdges = 0;
-    for (int currIndex = 0, prevIndex = inputPolygonSize - 1;
-         currIndex < inputPolygonSize;
-         prevIndex = currIndex, ++currIndex) {
+    for (int currIndex = 0; currIndex < inputPolygonSize; ++currIndex) {
         if (!inputPolygonVerts[currIndex].isFinite()) {
             return false;
         }
         int nextIndex = (currIndex + 1) % inputPolygonSize;
         compute_offset_vector(inputPolygonVerts[currIndex], inputPolygonVerts[nextIndex],
                               offset, winding, &normals[currIndex]);
-        if (currIndex > 0) {
-            // if reflex point, we need to add extra edges
-            if (is_reflex_vertex(inputPolygonVerts, winding, offset,
-                                 prevIndex, currIndex, nextIndex)) {
-                SkScalar rotSin, rotCos;
-                int numSteps;
-                if (!SkComputeRadialSteps(normals[prevIndex], normals[currIndex], offset,
-                                          &rotSin, &rotCos, &numSteps)) {
-                    return false;
-                }
-                numEdges += SkTMax(numSteps, 1);
+    }
+
+    // Count the edges, remembering the rotation steps at each reflex vertex so we don't have
+    // to recompute them when building the edges. A step count of 0 marks a non-reflex vertex.
+    struct RadialSteps {
+        SkScalar fSin;
+        SkScalar fCos;
+        int      fCount;
+    };
+    SkAutoSTMalloc<64, RadialSteps> radialSteps(inputPolygonSize);
+    unsigned int numEdges = 0;
+    for (int currIndex = 0, prevIndex = inputPolygonSize - 1;
+         currIndex < inputPolygonSize;
+         prevIndex = currIndex, ++currIndex) {
+        int nextIndex = (currIndex + 1) % inputPolygonSize;
+        RadialSteps& steps = radialSteps[currIndex];
+        steps.fCount = 0;
+        // if reflex point, we need to add extra edges
+        if (is_reflex_vertex(inputPolygonVerts, winding, offset,
+                             prevIndex, currIndex, nextIndex)) {
+            int numSteps;
+            if (!SkComputeRadialSteps(normals[prevIndex], normals[currIndex], offset,
+                                      &steps.fSin, &steps.fCos, &numSteps)) {
+                return false;
             }
+            steps.fCount = SkTMax(numSteps, 1);
+            numEdges += steps.fCount;
         }
         numEdges++;
     }
-    // finish up the edge counting
-    if (is_reflex_vertex(inputPolygonVerts, winding, offset, inputPolygonSize-1, 0, 1)) {
-        SkScalar rotSin, rotCos;
-        int numSteps;
-        if (!SkComputeRadialSteps(normals[inputPolygonSize-1], normals[0], offset,
-                                  &rotSin, &rotCos, &numSteps)) {
-            return false;
-        }
-        numEdges += SkTMax(numSteps, 1);
-    }
 
     // Make sure we don't overflow the max array count.
     // We shouldn't overflow numEdges, as SkComputeRadialSteps returns a max of 2^16-1,
@@ -1200,17 +1202,12 @@ bool SkOffsetSimplePolygon(const SkPoint* inputPolygonVerts, int inputPolygonSiz
          prevIndex = currIndex, ++currIndex) {
         int nextIndex = (currIndex + 1) % inputPolygonSize;
         // if reflex point, fill in curve
-        if (is_reflex_vertex(inputPolygonVerts, winding, offset,
-                             prevIndex, currIndex, nextIndex)) {
-            SkScalar rotSin, rotCos;
-            int numSteps;
+        const RadialSteps& steps = radialSteps[currIndex];
+        if (steps.fCount > 0) {
+            SkScalar rotSin = steps.fSin, rotCos = steps.fCos;
             SkVector prevNormal = normals[prevIndex];
-            if (!SkComputeRadialSteps(prevNormal, normals[currIndex], offset,
-                                      &rotSin, &rotCos, &numSteps)) {
-                return false;
-            }
-            auto currEdge = edgeData.push_back_n(SkTMax(numSteps, 1));
-            for (int i = 0; i < numSteps - 1; ++i) {
+            auto currEdge = edgeData.push_back_n(steps.fCount);
+            for (int i = 0; i < steps.fCount - 1; ++i) {
                 SkVector currNormal = SkVector::Make(prevNormal.fX*rotCos - prevNormal.fY*rotSin,
                                                      prevNormal.fY*rotCos + prevNormal.fX*rotSin);
                 setup_offset_edge(currEdge,
@@ -1551,6 +1548,7 @@ bool SkTriangulateSimplePolygon(const SkPoint* polygonVerts, uint16_t* indexMap,
 
     // Set up vertices
     SkAutoSTMalloc<64, TriangulationVertex> triangulationVertices(polygonSize);
+    int reflexCount = 0;
     int prevIndex = polygonSize - 1;
     SkVector v0 = polygonVerts[0] - polygonVerts[prevIndex];
     for (int currIndex = 0; currIndex < polygonSize; ++currIndex) {
@@ -1566,12 +1564,25 @@ bool SkTriangulateSimplePolygon(const SkPoint* polygonVerts, uint16_t* indexMap,
             triangulationVertices[currIndex].fVertexType = TriangulationVertex::VertexType::kConvex;
         } else {
             triangulationVertices[currIndex].fVertexType = TriangulationVertex::VertexType::kReflex;
+            ++reflexCount;
         }
 
         prevIndex = currIndex;
         v0 = v1;
     }
 
+    // A strictly convex polygon has an ear at every vertex, so we can just fan it out.
+    if (!reflexCount) {
+        triangleIndices->setReserve(triangleIndices->count() + 3 * (polygonSize - 2));
+        for (int currIndex = 1; currIndex < polygonSize - 1; ++currIndex) {
+            auto indices = triangleIndices->append(3);
+            indices[0] = indexMap[0];
+            indices[1] = indexMap[currIndex];
+            indices[2] = indexMap[currIndex + 1];
+        }
+        return true;
+    }
+
     // Classify initial vertices into a list of convex vertices and a hash of reflex vertices
     // TODO: possibly sort the convexList in some way to get better triangles
     SkTInternalLList<TriangulationVertex> convexList;
@@ -0,0 +1,353 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRingBufferTracer.h"
+
+#include "SkJSONWriter.h"
+#include "SkMathPriv.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+#include "SkThreadID.h"
+#include "SkTraceEvent.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stddef.h>
+#include <string.h>
+
+namespace {
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Marks an argument whose copied string we did not keep.
+static constexpr uint8_t kDroppedCopyString = 0xff;
+
+// Handles are the writing thread's index (plus one, so that a handle is never 0) over the
+// event's sequence number within that thread.
+static constexpr int      kHandleSeqBits = 48;
+static constexpr uint64_t kHandleSeqMask = (1ULL << kHandleSeqBits) - 1;
+
+// Everything about an event except its sequence number and end time.
+struct Payload {
+    uint64_t       fBegin;
+    const char*    fName;
+    const uint8_t* fCategory;
+    uint64_t       fID;
+    const char*    fArgNames[2];
+    uint64_t       fArgValues[2];
+    char           fPhase;
+    uint8_t        fNumArgs;
+    uint8_t        fArgTypes[2];
+};
+
+static constexpr int kPayloadWords = sizeof(Payload) / sizeof(uint64_t);
+static_assert(sizeof(Payload) == kPayloadWords * sizeof(uint64_t), "Payload must be whole words");
+
+}
+
+/**
+ * One ring buffer slot, written only by its thread and read by dumpJSON() as a seqlock: fSeq is 0
+ * while the slot is being written, and the event's sequence number once it is complete. Every
+ * field is atomic (though only ever accessed relaxed) so that a dump racing with a writer is well
+ * defined; a reader that sees fSeq change throws away what it copied.
+ */
+struct SkRingBufferTracer::Event {
+    std::atomic<uint64_t> fSeq;
+    std::atomic<uint64_t> fEnd;
+    std::atomic<uint64_t> fWords[kPayloadWords];
+
+    void write(uint64_t seq, const Payload& payload) {
+        uint64_t words[kPayloadWords];
+        memcpy(words, &payload, sizeof(Payload));
+
+        fSeq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < kPayloadWords; ++i) {
+            fWords[i].store(words[i], std::memory_order_relaxed);
+        }
+        fEnd.store(0, std::memory_order_relaxed);
+        fSeq.store(seq, std::memory_order_release);
+    }
+
+    bool read(Payload* payload, uint64_t* end) const {
+        uint64_t seq = fSeq.load(std::memory_order_acquire);
+        if (0 == seq) {
+            return false;
+        }
+        uint64_t words[kPayloadWords];
+        for (int i = 0; i < kPayloadWords; ++i) {
+            words[i] = fWords[i].load(std::memory_order_relaxed);
+        }
+        *end = fEnd.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq != fSeq.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        memcpy(payload, words, sizeof(Payload));
+        return true;
+    }
+};
+
+struct SkRingBufferTracer::ThreadBuffer {
+    ThreadBuffer(int index, int capacity)
+        : fIndex(index)
+        , fThreadID(SkGetThreadID())
+        , fMask(capacity - 1)
+        // Value-initialized, so every slot starts out empty (fSeq == 0).
+        , fEvents(new Event[capacity]()) {}
+
+    const int                fIndex;
+    const SkThreadID         fThreadID;
+    const uint64_t           fMask;
+    uint64_t                 fNextSeq = 1;  // only touched by the owning thread
+    std::unique_ptr<Event[]> fEvents;
+};
+
+static uint32_t next_tracer_id() {
+    static std::atomic<uint32_t> gNextID{1};
+    return gNextID++;
+}
+
+SkRingBufferTracer::SkRingBufferTracer(int eventsPerThread, double windowMs)
+    : fEventsPerThread(SkNextPow2(SkTMax(eventsPerThread, 2)))
+    , fWindowMs(windowMs)
+    , fUniqueID(next_tracer_id())
+    , fThreadCount(0)
+    , fNumCategories(0) {
+    for (auto& thread : fThreads) {
+        thread.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SkRingBufferTracer::~SkRingBufferTracer() {
+    for (auto& thread : fThreads) {
+        delete thread.load(std::memory_order_relaxed);
+    }
+}
+
+SkRingBufferTracer::ThreadBuffer* SkRingBufferTracer::threadBuffer() {
+    // Keyed on the tracer's unique ID rather than its address, in case a later tracer is
+    // allocated where an earlier one was.
+    struct Cached {
+        uint32_t      fTracerID;
+        ThreadBuffer* fBuffer;
+    };
+    static thread_local Cached cached = { 0, nullptr };
+
+    if (cached.fTracerID != fUniqueID) {
+        ThreadBuffer* buffer = nullptr;
+        int index = fThreadCount.fetch_add(1, std::memory_order_relaxed);
+        if (index < kMaxThreads) {
+            buffer = new ThreadBuffer(index, fEventsPerThread);
+            fThreads[index].store(buffer, std::memory_order_release);
+        }
+        cached = { fUniqueID, buffer };
+    }
+    return cached.fBuffer;
+}
+
+SkEventTracer::Handle SkRingBufferTracer::addTraceEvent(char phase,
+                                                        const uint8_t* categoryEnabledFlag,
+                                                        const char* name,
+                                                        uint64_t id,
+                                                        int numArgs,
+                                                        const char** argNames,
+                                                        const uint8_t* argTypes,
+                                                        const uint64_t* argValues,
+                                                        uint8_t flags) {
+    ThreadBuffer* buffer = this->threadBuffer();
+    if (!buffer) {
+        return 0;
+    }
+
+    Payload payload;
+    payload.fBegin = now_ns();
+    payload.fName = name;
+    payload.fCategory = categoryEnabledFlag;
+    payload.fID = id;
+    payload.fPhase = phase;
+    payload.fNumArgs = SkToU8(SkTMin(numArgs, 2));
+    for (int i = 0; i < 2; ++i) {
+        bool used = i < payload.fNumArgs;
+        bool copied = used && TRACE_VALUE_TYPE_COPY_STRING == argTypes[i];
+        payload.fArgNames[i] = used ? argNames[i] : nullptr;
+        payload.fArgTypes[i] = copied ? kDroppedCopyString : used ? argTypes[i] : 0;
+        payload.fArgValues[i] = used && !copied ? argValues[i] : 0;
+    }
+
+    uint64_t seq = buffer->fNextSeq++ & kHandleSeqMask;
+    buffer->fEvents[seq & buffer->fMask].write(seq, payload);
+    return (uint64_t)(buffer->fIndex + 1) << kHandleSeqBits | seq;
+}
+
+void SkRingBufferTracer::updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                                  const char* name,
+                                                  SkEventTracer::Handle handle) {
+    if (0 == handle) {
+        return;
+    }
+    int index = (int)(handle >> kHandleSeqBits) - 1;
+    uint64_t seq = handle & kHandleSeqMask;
+    ThreadBuffer* buffer = fThreads[index].load(std::memory_order_acquire);
+
+    // The event may already have been overwritten by a newer one.
+    Event& event = buffer->fEvents[seq & buffer->fMask];
+    if (seq == event.fSeq.load(std::memory_order_relaxed)) {
+        event.fEnd.store(now_ns(), std::memory_order_relaxed);
+    }
+}
+
+const uint8_t* SkRingBufferTracer::getCategoryGroupEnabled(const char* name) {
+    static_assert(0 == offsetof(CategoryState, fEnabled), "CategoryState");
+
+    if (SkStrStartsWith(name, TRACE_CATEGORY_PREFIX)) {
+        name += strlen(TRACE_CATEGORY_PREFIX);
+    }
+
+    // The tracing macros cache the result for each site, so this is rarely called.
+    SkAutoMutexAcquire lock(&fCategoryMutex);
+    for (int i = 0; i < fNumCategories; ++i) {
+        if (0 == strcmp(name, fCategories[i].fName)) {
+            return reinterpret_cast<uint8_t*>(&fCategories[i]);
+        }
+    }
+
+    if (fNumCategories >= kMaxCategories) {
+        SkDEBUGFAIL("Exhausted event tracing categories. Increase kMaxCategories.");
+        return reinterpret_cast<uint8_t*>(&fCategories[0]);
+    }
+
+    fCategories[fNumCategories].fEnabled =
+            SkEventTracer::kEnabledForRecording_CategoryGroupEnabledFlags;
+    fCategories[fNumCategories].fName = name;
+    return reinterpret_cast<uint8_t*>(&fCategories[fNumCategories++]);
+}
+
+const char* SkRingBufferTracer::getCategoryGroupName(const uint8_t* categoryEnabledFlag) {
+    return CategoryName(categoryEnabledFlag);
+}
+
+const char* SkRingBufferTracer::CategoryName(const uint8_t* categoryEnabledFlag) {
+    if (categoryEnabledFlag) {
+        return reinterpret_cast<const CategoryState*>(categoryEnabledFlag)->fName;
+    }
+    return nullptr;
+}
+
+static void trace_value_to_json(SkJSONWriter* writer, uint64_t argValue, uint8_t argType) {
+    skia::tracing_internals::TraceValueUnion value;
+    value.as_uint = argValue;
+
+    switch (argType) {
+        case TRACE_VALUE_TYPE_BOOL:
+            writer->appendBool(value.as_bool);
+            break;
+        case TRACE_VALUE_TYPE_UINT:
+            writer->appendU64(value.as_uint);
+            break;
+        case TRACE_VALUE_TYPE_INT:
+            writer->appendS64(value.as_int);
+            break;
+        case TRACE_VALUE_TYPE_DOUBLE:
+            writer->appendDouble(value.as_double);
+            break;
+        case TRACE_VALUE_TYPE_POINTER:
+            writer->appendPointer(value.as_pointer);
+            break;
+        case TRACE_VALUE_TYPE_STRING:
+            writer->appendString(value.as_string);
+            break;
+        case kDroppedCopyString:
+            writer->appendString("<copied string>");
+            break;
+        default:
+            writer->appendString("<unknown type>");
+            break;
+    }
+}
+
+void SkRingBufferTracer::dumpJSON(SkWStream* stream) const {
+    struct Snapshot {
+        Payload fPayload;
+        uint64_t fEnd;
+        SkThreadID fThreadID;
+    };
+
+    const uint64_t now = now_ns();
+    const uint64_t cutoff = now - SkTMin((uint64_t)(fWindowMs * 1e6), now);
+
+    SkTArray<Snapshot> events;
+    for (const auto& thread : fThreads) {
+        const ThreadBuffer* buffer = thread.load(std::memory_order_acquire);
+        if (!buffer) {
+            continue;
+        }
+        for (uint64_t i = 0; i <= buffer->fMask; ++i) {
+            Snapshot snapshot;
+            if (buffer->fEvents[i].read(&snapshot.fPayload, &snapshot.fEnd) &&
+                SkTMax(snapshot.fPayload.fBegin, snapshot.fEnd) >= cutoff) {
+                snapshot.fThreadID = buffer->fThreadID;
+                events.push_back(snapshot);
+            }
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const Snapshot& a, const Snapshot& b) {
+        return a.fPayload.fBegin < b.fPayload.fBegin;
+    });
+
+    SkJSONWriter writer(stream, SkJSONWriter::Mode::kFast);
+    writer.beginArray();
+
+    const uint64_t clockOffset = events.empty() ? 0 : events[0].fPayload.fBegin;
+    SkTHashMap<SkThreadID, int> shortThreadIDs;
+    for (const Snapshot& event : events) {
+        const Payload& payload = event.fPayload;
+        writer.beginObject();
+
+        char phaseString[2] = { payload.fPhase, 0 };
+        writer.appendString("ph", phaseString);
+        writer.appendString("name", payload.fName);
+        if (const char* category = CategoryName(payload.fCategory)) {
+            writer.appendString("cat", category);
+        }
+        if (0 != payload.fID) {
+            writer.appendPointer("id", reinterpret_cast<void*>(payload.fID));
+        }
+
+        // Timestamps are in microseconds. Complete events still in progress end at the dump.
+        writer.appendDoubleDigits("ts", (payload.fBegin - clockOffset) * 1E-3, 3);
+        if (TRACE_EVENT_PHASE_COMPLETE == payload.fPhase) {
+            uint64_t end = event.fEnd ? event.fEnd : now;
+            writer.appendDoubleDigits("dur", (end - payload.fBegin) * 1E-3, 3);
+        }
+
+        int* shortID = shortThreadIDs.find(event.fThreadID);
+        if (!shortID) {
+            shortID = shortThreadIDs.set(event.fThreadID, shortThreadIDs.count());
+        }
+        writer.appendS64("tid", *shortID);
+        writer.appendS32("pid", 0);
+
+        if (payload.fNumArgs) {
+            writer.beginObject("args");
+            for (int i = 0; i < payload.fNumArgs; ++i) {
+                writer.appendName(payload.fArgNames[i]);
+                trace_value_to_json(&writer, payload.fArgValues[i], payload.fArgTypes[i]);
+            }
+            writer.endObject();
+        }
+
+        writer.endObject();
+    }
+
+    writer.endArray();
+    writer.flush();
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRingBufferTracer_DEFINED
+#define SkRingBufferTracer_DEFINED
+
+#include "SkEventTracer.h"
+#include "SkMutex.h"
+
+#include <atomic>
+#include <memory>
+
+class SkWStream;
+
+/**
+ * A SkEventTracer that is cheap enough to leave installed. Each thread appends fixed size events
+ * to its own ring buffer without taking any lock, overwriting its oldest events once the buffer is
+ * full. dumpJSON() can be called at any time, from any thread, to write the events of the last
+ * windowMs milliseconds as JSON for viewing with chrome://tracing.
+ *
+ * Every category is recorded. The hottest trace sites can be compiled out entirely by listing
+ * their categories in SK_TRACE_COMPILED_OUT_CATEGORIES (see SkTraceEvent.h).
+ *
+ * Arguments copied with TRACE_STR_COPY are not kept, since that would need an allocation per
+ * event; they are dumped as "<copied string>". Buffers are kept for the first kMaxThreads threads
+ * that trace, and live as long as the tracer, so a dump still holds the events of threads that
+ * have since exited.
+ */
+class SK_API SkRingBufferTracer : public SkEventTracer {
+public:
+    static constexpr int kMaxThreads = 256;
+
+    /** eventsPerThread is rounded up to a power of two. */
+    explicit SkRingBufferTracer(int eventsPerThread = 16384, double windowMs = 1000);
+    ~SkRingBufferTracer() override;
+
+    SkEventTracer::Handle addTraceEvent(char phase,
+                                        const uint8_t* categoryEnabledFlag,
+                                        const char* name,
+                                        uint64_t id,
+                                        int numArgs,
+                                        const char** argNames,
+                                        const uint8_t* argTypes,
+                                        const uint64_t* argValues,
+                                        uint8_t flags) override;
+
+    void updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                  const char* name,
+                                  SkEventTracer::Handle handle) override;
+
+    const uint8_t* getCategoryGroupEnabled(const char* name) override;
+    const char* getCategoryGroupName(const uint8_t* categoryEnabledFlag) override;
+
+    /** Writes the events of the last windowMs milliseconds, oldest first. */
+    void dumpJSON(SkWStream*) const;
+
+private:
+    struct Event;
+    struct ThreadBuffer;
+
+    ThreadBuffer* threadBuffer();
+    static const char* CategoryName(const uint8_t* categoryEnabledFlag);
+
+    enum { kMaxCategories = 256 };
+
+    struct CategoryState {
+        uint8_t fEnabled;
+        const char* fName;
+    };
+
+    const int                  fEventsPerThread;
+    const double               fWindowMs;
+    const uint32_t             fUniqueID;
+    std::atomic<int>           fThreadCount;
+    std::atomic<ThreadBuffer*> fThreads[kMaxThreads];
+
+    SkMutex                    fCategoryMutex;
+    CategoryState              fCategories[kMaxCategories];
+    int                        fNumCategories;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSegmentedPictureRecorder.h"
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImage.h"
+#include "SkOpts.h"
+#include "SkPicture.h"
+#include "SkSerialProcs.h"
+#include "SkTypeface.h"
+
+// Serializing is the simplest complete walk of a picture's ops.  Images and typefaces are
+// written as just their uniqueIDs, which is all the hash needs and saves encoding them.
+static sk_sp<SkData> serialize_image_id(SkImage* image, void*) {
+    uint32_t id = image->uniqueID();
+    return SkData::MakeWithCopy(&id, sizeof(id));
+}
+
+static sk_sp<SkData> serialize_typeface_id(SkTypeface* typeface, void*) {
+    uint32_t id = typeface->uniqueID();
+    return SkData::MakeWithCopy(&id, sizeof(id));
+}
+
+static uint32_t content_hash(const SkPicture* picture) {
+    SkSerialProcs procs;
+    procs.fImageProc    = serialize_image_id;
+    procs.fTypefaceProc = serialize_typeface_id;
+    sk_sp<SkData> data = picture->serialize(&procs);
+    return data ? SkOpts::hash(data->data(), data->size()) : 0;
+}
+
+SkSegmentedPictureRecorder::SkSegmentedPictureRecorder() {}
+
+SkSegmentedPictureRecorder::~SkSegmentedPictureRecorder() {}
+
+int SkSegmentedPictureRecorder::indexOf(uint32_t id) const {
+    for (int i = 0; i < fSegments.count(); ++i) {
+        if (fSegments[i].fID == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+SkCanvas* SkSegmentedPictureRecorder::beginSegment(uint32_t id, const SkRect& bounds) {
+    SkASSERT(!fRecording);
+    fRecording = true;
+    fRecordingID = id;
+    return fRecorder.beginRecording(bounds, &fFactory);
+}
+
+bool SkSegmentedPictureRecorder::endSegment() {
+    SkASSERT(fRecording);
+    fRecording = false;
+
+    sk_sp<SkPicture> picture = fRecorder.finishRecordingAsPicture();
+    const uint32_t hash = content_hash(picture.get());
+
+    int index = this->indexOf(fRecordingID);
+    if (index < 0) {
+        index = fSegments.count();
+        fSegments.push_back(Segment{fRecordingID, nullptr, SkRect::MakeEmpty(), 0});
+    } else if (fSegments[index].fContentHash == hash) {
+        return false;
+    }
+
+    Segment& segment = fSegments[index];
+    segment.fBounds = picture->cullRect();
+    segment.fPicture = std::move(picture);
+    segment.fContentHash = hash;
+    return true;
+}
+
+bool SkSegmentedPictureRecorder::removeSegment(uint32_t id) {
+    SkASSERT(!fRecording || id != fRecordingID);
+    const int index = this->indexOf(id);
+    if (index < 0) {
+        return false;
+    }
+    for (int i = index; i < fSegments.count() - 1; ++i) {
+        fSegments[i] = std::move(fSegments[i + 1]);
+    }
+    fSegments.pop_back();
+    return true;
+}
+
+const SkSegmentedPictureRecorder::Segment*
+SkSegmentedPictureRecorder::findSegment(uint32_t id) const {
+    const int index = this->indexOf(id);
+    return index < 0 ? nullptr : &fSegments[index];
+}
+
+sk_sp<SkPicture> SkSegmentedPictureRecorder::makePicture() const {
+    SkRect bounds = SkRect::MakeEmpty();
+    for (const Segment& segment : fSegments) {
+        bounds.join(segment.fBounds);
+    }
+
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(bounds, &factory);
+    for (const Segment& segment : fSegments) {
+        canvas->drawPicture(segment.fPicture);
+    }
+    return recorder.finishRecordingAsPicture();
+}
@@ -364,8 +364,13 @@ public:
     }
     bool isRRect(SkRRect* rrect) { return fShapeForKey.asRRect(rrect, nullptr, nullptr, nullptr); }
 #else
-    int keyBytes() const { return -1; }
-    void writeKey(void* key) const { SK_ABORT("Should never be called"); }
+    /** Without GrShape we key non-volatile paths on their generation ID and fill type. */
+    int keyBytes() const { return fPath->isVolatile() ? -1 : 2 * sizeof(uint32_t); }
+    void writeKey(void* key) const {
+        uint32_t* key32 = reinterpret_cast<uint32_t*>(key);
+        key32[0] = fPath->getGenerationID();
+        key32[1] = fPath->getFillType();
+    }
     bool isRRect(SkRRect* rrect) { return false; }
 #endif
 
@@ -7,6 +7,7 @@
 
 #include "SkXMLWriter.h"
 
+#include "SkFloatToDecimal.h"
 #include "SkStream.h"
 #include "SkTo.h"
 
@@ -28,9 +29,8 @@ void SkXMLWriter::addAttribute(const char name[], const char value[]) {
 }
 
 void SkXMLWriter::addS32Attribute(const char name[], int32_t value) {
-    SkString    tmp;
-    tmp.appendS32(value);
-    this->addAttribute(name, tmp.c_str());
+    char tmp[SkStrAppendS32_MaxSize];
+    this->addAttributeLen(name, tmp, SkStrAppendS32(tmp, value) - tmp);
 }
 
 void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigits) {
@@ -40,9 +40,8 @@ void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigi
 }
 
 void SkXMLWriter::addScalarAttribute(const char name[], SkScalar value) {
-    SkString    tmp;
-    tmp.appendScalar(value);
-    this->addAttribute(name, tmp.c_str());
+    char tmp[kMaximumSkFloatToDecimalLength];
+    this->addAttributeLen(name, tmp, SkFloatToDecimal(SkScalarToFloat(value), tmp));
 }
 
 void SkXMLWriter::addText(const char text[], size_t length) {
@@ -191,9 +190,12 @@ void SkXMLWriter::writeHeader()
 // SkXMLStreamWriter
 
 static void tab(SkWStream& stream, int level) {
-    for (int i = 0; i < level; i++) {
-        stream.writeText("\t");
+    static const char kTabs[] = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+    static constexpr int kTabCount = SK_ARRAY_COUNT(kTabs) - 1;
+    for (; level > kTabCount; level -= kTabCount) {
+        stream.write(kTabs, kTabCount);
     }
+    stream.write(kTabs, level);
 }
 
 SkXMLStreamWriter::SkXMLStreamWriter(SkWStream* stream) : fStream(*stream)
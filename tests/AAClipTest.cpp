@@ -6,6 +6,7 @@
  */
 
 #include "SkAAClip.h"
+#include "SkAAClipCache.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
@@ -429,6 +430,34 @@ static void test_huge(skiatest::Reporter* reporter) {
     clip.setRect(r);
 }
 
+// Clipping to the same complex path, matrix and bounds again should reuse the cached clip.
+static void test_cached_path(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.moveTo(10, 10);
+    for (int i = 0; i < 20; ++i) {
+        path.lineTo(10 + 7.3f * i, (i & 1) ? 90.5f : 20.25f);
+    }
+    path.close();
+    SkMatrix matrix = SkMatrix::MakeScale(1.5f, 0.75f);
+    matrix.postTranslate(3.5f, 4);
+    const SkIRect bounds = SkIRect::MakeWH(200, 100);
+    REPORTER_ASSERT(reporter, SkAAClipCache::ShouldCache(path));
+
+    SkRasterClip first(bounds), second(bounds);
+    first .op(path, matrix, bounds, SkRegion::kIntersect_Op, true);
+    SkAAClip cached;
+    REPORTER_ASSERT(reporter, SkAAClipCache::Find(path, matrix, bounds, &cached));
+    second.op(path, matrix, bounds, SkRegion::kIntersect_Op, true);
+    REPORTER_ASSERT(reporter, first.isAA() && second.isAA());
+    REPORTER_ASSERT(reporter, first == second);
+    REPORTER_ASSERT(reporter, cached == second.aaRgn());
+
+    // A different matrix is a different clip.
+    SkMatrix other = matrix;
+    other.postTranslate(1, 0);
+    REPORTER_ASSERT(reporter, !SkAAClipCache::Find(path, other, bounds, &cached));
+}
+
 DEF_TEST(AAClip, reporter) {
     test_empty(reporter);
     test_path_bounds(reporter);
@@ -440,4 +469,5 @@ DEF_TEST(AAClip, reporter) {
     test_really_a_rect(reporter);
     test_crbug_422693(reporter);
     test_huge(reporter);
+    test_cached_path(reporter);
 }
@@ -6,6 +6,8 @@
  */
 
 #include "SkArenaAlloc.h"
+#include "SkArenaBlockPool.h"
+#include "SkDrawScratch.h"
 #include "SkRefCnt.h"
 #include "SkTypes.h"
 #include "Test.h"
@@ -173,3 +175,66 @@ DEF_TEST(ArenaAlloc, r) {
     REPORTER_ASSERT(r, destroyed == 128);
 
 }
+
+DEF_TEST(ArenaAlloc_HeapBytes, r) {
+    SkSTArenaAlloc<256> arena;
+    arena.makeArrayDefault<char>(128);
+    REPORTER_ASSERT(r, arena.heapBytes() == 0);
+    arena.makeArrayDefault<char>(1024);
+    REPORTER_ASSERT(r, arena.heapBytes() >= 1024);
+    arena.reset();
+    REPORTER_ASSERT(r, arena.heapBytes() == 0);
+}
+
+// A draw whose arena overflows grows the thread's scratch block, so the next one doesn't.
+DEF_TEST(ArenaAlloc_DrawScratch, r) {
+    const size_t kBig = 20000;
+    for (int i = 0; i < 2; i++) {
+        SkDrawScratch scratch;
+        SkArenaAlloc arena{scratch.block(), scratch.size(), 0};
+        arena.makeArrayDefault<char>(kBig);
+        // Earlier draws on this thread may have grown the block already.
+        REPORTER_ASSERT(r, i == 0 || arena.heapBytes() == 0);
+        scratch.noteHeapBytes(arena.heapBytes());
+    }
+
+    // Nested scratch can't share the thread's block.
+    SkDrawScratch outer;
+    SkDrawScratch inner;
+    REPORTER_ASSERT(r, outer.size() > kBig);
+    REPORTER_ASSERT(r, inner.block() != outer.block());
+}
+
+DEF_TEST(ArenaAlloc_BlockPool, r) {
+    size_t size = 1000;
+    void* block = SkArenaBlockPool::Alloc(&size);
+    REPORTER_ASSERT(r, size == 1024);
+    SkArenaBlockPool::Free(block, size);
+
+    // The next block of that size class on this thread is the same one. The stats are shared
+    // with tests running on other threads, so they can only be checked for growth.
+    const SkArenaBlockPool::Stats before = SkArenaBlockPool::GetStats();
+    size = 600;
+    REPORTER_ASSERT(r, SkArenaBlockPool::Alloc(&size) == block);
+    REPORTER_ASSERT(r, size == 1024);
+    REPORTER_ASSERT(r, SkArenaBlockPool::GetStats().fReuses > before.fReuses);
+    SkArenaBlockPool::Free(block, size);
+
+    // Large blocks aren't rounded up.
+    size = 100000;
+    block = SkArenaBlockPool::Alloc(&size);
+    REPORTER_ASSERT(r, size == 100000);
+    SkArenaBlockPool::Free(block, size);
+
+    // Arenas made one after another recycle each other's blocks.
+    for (int i = 0; i < 2; i++) {
+        const SkArenaBlockPool::Stats start = SkArenaBlockPool::GetStats();
+        SkArenaAlloc arena{0};
+        for (int j = 0; j < 8; j++) {
+            arena.makeArrayDefault<char>(1000);
+        }
+        const SkArenaBlockPool::Stats end = SkArenaBlockPool::GetStats();
+        REPORTER_ASSERT(r, end.fAllocs > start.fAllocs);
+        REPORTER_ASSERT(r, i == 0 || end.fReuses > start.fReuses);
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkBandRenderer.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkPixmap.h"
+#include "Test.h"
+
+// Aliased, axis-aligned rects draw the same however they are clipped, so bands must match the
+// whole image exactly. (Anti-aliased edges cut by a band can round differently.)
+static sk_sp<SkPicture> make_picture(SkBBHFactory* factory) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(200, 300, factory);
+    SkPaint paint;
+    for (int i = 0; i < 40; ++i) {
+        paint.setColor(SkColorSetARGB(0x80 + i, i * 6, 255 - i * 6, (i * 37) & 0xFF));
+        canvas->drawRect(SkRect::MakeXYWH(i * 4.25f, i * 7.5f, 60, 25), paint);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+DEF_TEST(BandRenderer, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(200, 300);
+
+    SkRTreeFactory factory;
+    for (SkBBHFactory* bbh : { (SkBBHFactory*)nullptr, (SkBBHFactory*)&factory }) {
+        sk_sp<SkPicture> picture = make_picture(bbh);
+
+        SkBitmap expected;
+        expected.allocPixels(info);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(expected).drawPicture(picture);
+
+        for (int bandHeight : { 1, 7, 64, 300, 1000 }) {
+            SkBitmap banded;
+            banded.allocPixels(info);
+            int nextTop = 0;
+            bool ok = SkBandRenderer::RenderPicture(picture.get(), info, bandHeight,
+                                                    [&](const SkPixmap& band, int top) {
+                REPORTER_ASSERT(reporter, top == nextTop);
+                REPORTER_ASSERT(reporter, band.width() == info.width());
+                REPORTER_ASSERT(reporter, band.height() == SkTMin(bandHeight, 300 - top));
+                SkAssertResult(banded.writePixels(band, 0, top));
+                nextTop = top + band.height();
+                return true;
+            });
+            REPORTER_ASSERT(reporter, ok);
+            REPORTER_ASSERT(reporter, nextTop == info.height());
+
+            bool same = true;
+            for (int y = 0; y < info.height(); ++y) {
+                same &= 0 == memcmp(expected.getAddr32(0, y), banded.getAddr32(0, y),
+                                    info.minRowBytes());
+            }
+            REPORTER_ASSERT(reporter, same, "bbh %d, band height %d", bbh != nullptr, bandHeight);
+        }
+    }
+
+    // A sink can stop early, and bad arguments fail without calling it.
+    sk_sp<SkPicture> picture = make_picture(nullptr);
+    int bands = 0;
+    auto stopAfterTwo = [&](const SkPixmap&, int) { return ++bands < 2; };
+    REPORTER_ASSERT(reporter, !SkBandRenderer::RenderPicture(picture.get(), info, 10,
+                                                             stopAfterTwo));
+    REPORTER_ASSERT(reporter, bands == 2);
+    REPORTER_ASSERT(reporter, !SkBandRenderer::RenderPicture(picture.get(), info, 0,
+                                                             stopAfterTwo));
+    REPORTER_ASSERT(reporter, !SkBandRenderer::RenderPicture(picture.get(),
+                                                             SkImageInfo::MakeUnknown(10, 10), 10,
+                                                             stopAfterTwo));
+    REPORTER_ASSERT(reporter, bands == 2);
+}
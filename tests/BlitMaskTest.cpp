@@ -5,9 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
 #include "SkBlitMask.h"
+#include "SkBlitter.h"
 #include "SkColorPriv.h"
+#include "SkCoreBlitters.h"
+#include "SkGradientShader.h"
 #include "SkMask.h"
+#include "SkPaint.h"
 #include "Test.h"
 
 static void test_opaque_dest(skiatest::Reporter* reporter, SkMask::Format format) {
@@ -42,3 +48,110 @@ static void test_opaque_dest(skiatest::Reporter* reporter, SkMask::Format format
 DEF_TEST(BlitMask_OpaqueD32, reporter) {
     test_opaque_dest(reporter, SkMask::Format::kA8_Format);
 }
+
+// Blitting a batch of masks must match blitting them one at a time.
+DEF_TEST(BlitMask_BatchMatchesSingle, reporter) {
+    uint8_t  a8[12 * 10];
+    uint16_t lcd[12 * 10];
+    uint8_t  bw[2 * 10];
+    for (int i = 0; i < 12 * 10; ++i) {
+        a8[i]  = (uint8_t)(i * 37);
+        lcd[i] = (uint16_t)(i * 4099);
+    }
+    for (int i = 0; i < 2 * 10; ++i) {
+        bw[i] = (uint8_t)(i * 73);
+    }
+
+    SkMask masks[3];
+    masks[0].fImage = a8;
+    masks[0].fBounds = SkIRect::MakeXYWH(3, 4, 12, 10);
+    masks[0].fRowBytes = 12;
+    masks[0].fFormat = SkMask::kA8_Format;
+    masks[1].fImage = (uint8_t*)lcd;
+    masks[1].fBounds = SkIRect::MakeXYWH(10, 8, 12, 10);
+    masks[1].fRowBytes = 12 * sizeof(uint16_t);
+    masks[1].fFormat = SkMask::kLCD16_Format;
+    masks[2].fImage = bw;
+    masks[2].fBounds = SkIRect::MakeXYWH(1, 15, 12, 10);
+    masks[2].fRowBytes = 2;
+    masks[2].fFormat = SkMask::kBW_Format;
+    // Clip the overlapping A8 and LCD masks, so both orders and partial clips are covered.
+    const SkIRect clips[3] = { SkIRect::MakeLTRB(3, 4, 14, 12), masks[1].fBounds,
+                               masks[2].fBounds };
+
+    for (SkColor color : { SK_ColorBLACK, SK_ColorBLUE, SkColorSetARGB(0x80, 0x20, 0x40, 0xF0) }) {
+        SkBitmap single, batched;
+        for (SkBitmap* bm : { &single, &batched }) {
+            bm->allocN32Pixels(32, 32);
+            bm->eraseColor(0xFF808080);
+        }
+        SkPaint paint;
+        paint.setColor(color);
+        SkSTArenaAlloc<1024> alloc;
+
+        SkBlitter* blitter = SkBlitter::Choose(single.pixmap(), SkMatrix::I(), paint, &alloc,
+                                               false);
+        for (int i = 0; i < 3; ++i) {
+            blitter->blitMask(masks[i], clips[i]);
+        }
+        blitter = SkBlitter::Choose(batched.pixmap(), SkMatrix::I(), paint, &alloc, false);
+        blitter->blitMasks(masks, clips, 3);
+
+        REPORTER_ASSERT(reporter, !memcmp(single.getPixels(), batched.getPixels(),
+                                          single.computeByteSize()), "color %08x", color);
+    }
+}
+
+// The raster pipeline blitter gathers the runs of blitAntiH() into spans; that must look just
+// like blitting each run on its own.
+DEF_TEST(BlitAntiH_SpansMatchRuns, reporter) {
+    // Short partial runs, short and long opaque runs, and gaps.
+    const int16_t runLengths[] = { 1, 2, 1, 3, 20, 1, 4, 2, 1, 1, 5, 1 };
+    const SkAlpha runAlphas[]  = { 0x10, 0x80, 0xff, 0xc0, 0xff, 0x00, 0x40, 0xff, 0x01, 0xfe,
+                                   0x00, 0x77 };
+    SkAlpha aa[64];
+    int16_t runs[64];
+    int n = 0;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(runLengths); ++i) {
+        aa[n]   = runAlphas[i];
+        runs[n] = runLengths[i];
+        n += runLengths[i];
+    }
+    runs[n] = 0;
+
+    SkPoint pts[] = {{0, 0}, {(SkScalar)n, 0}};
+    SkColor colors[] = {0xFF00FF00, 0x80FF0000};
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+
+    for (SkColorType ct : { kN32_SkColorType, kRGBA_F16_SkColorType }) {
+        SkBitmap single, spans;
+        for (SkBitmap* bm : { &single, &spans }) {
+            bm->allocPixels(SkImageInfo::Make(n + 4, 2, ct, kPremul_SkAlphaType));
+            bm->eraseColor(0xFF204060);
+        }
+        SkSTArenaAlloc<2048> alloc;
+
+        SkBlitter* blitter = SkCreateRasterPipelineBlitter(spans.pixmap(), paint, SkMatrix::I(),
+                                                           &alloc);
+        blitter->blitAntiH(2, 1, aa, runs);
+
+        blitter = SkCreateRasterPipelineBlitter(single.pixmap(), paint, SkMatrix::I(), &alloc);
+        for (int x = 0; x < n; x += runs[x]) {
+            SkAlpha oneAA[]   = { aa[x], 0 };
+            int16_t oneRuns[] = { runs[x], 0 };
+            blitter->blitAntiH(2 + x, 1, oneAA, oneRuns);
+        }
+
+        for (int x = 0; x < single.width(); ++x) {
+            SkColor s = single.getColor(x, 1),
+                    t = spans .getColor(x, 1);
+            int diff = SkTMax(SkTMax(SkTAbs((int)SkColorGetR(s) - (int)SkColorGetR(t)),
+                                     SkTAbs((int)SkColorGetG(s) - (int)SkColorGetG(t))),
+                              SkTMax(SkTAbs((int)SkColorGetB(s) - (int)SkColorGetB(t)),
+                                     SkTAbs((int)SkColorGetA(s) - (int)SkColorGetA(t))));
+            REPORTER_ASSERT(reporter, diff <= 1, "color type %d, x %d", ct, x);
+        }
+    }
+}
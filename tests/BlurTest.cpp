@@ -8,6 +8,7 @@
 #include "SkBitmap.h"
 #include "SkBlendMode.h"
 #include "SkBlurDrawLooper.h"
+#include "SkBlurImageFilter.h"
 #include "SkBlurMask.h"
 #include "SkBlurPriv.h"
 #include "SkBlurTypes.h"
@@ -21,6 +22,7 @@
 #include "SkLayerDrawLooper.h"
 #include "SkMask.h"
 #include "SkMaskFilter.h"
+#include "SkMaskBlurFilter.h"
 #include "SkMaskFilterBase.h"
 #include "SkMath.h"
 #include "SkMathPriv.h"
@@ -733,6 +735,45 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(BlurMaskBiggerThanDest, reporter, ctxInfo) {
     REPORTER_ASSERT(reporter, readback.getColor(31, 31) == SK_ColorBLACK);
 }
 
+// A sigma this large is downsampled by 16 before convolving, which takes the box filtered 4x
+// passes in SkGpuBlurUtils' decimate.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(BlurLargeSigmaImageFilter, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+
+    SkImageInfo ii = SkImageInfo::Make(256, 256, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+
+    sk_sp<SkSurface> dst(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, ii));
+    if (!dst) {
+        ERRORF(reporter, "Could not create surface for test.");
+        return;
+    }
+
+    SkPaint p;
+    p.setColor(SK_ColorRED);
+    p.setImageFilter(SkBlurImageFilter::Make(40, 40, nullptr));
+
+    SkCanvas* canvas = dst->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->drawRect(SkRect::MakeXYWH(96, 96, 64, 64), p);
+
+    SkBitmap readback;
+    SkAssertResult(readback.tryAllocPixels(ii));
+    canvas->readPixels(readback, 0, 0);
+
+    // The blur should be centered on the rect and spread well past it.
+    SkColor center = readback.getColor(128, 128);
+    REPORTER_ASSERT(reporter, SkColorGetA(center) > 64);
+    REPORTER_ASSERT(reporter, SkColorGetG(center) == 0 && SkColorGetB(center) == 0);
+    REPORTER_ASSERT(reporter, SkColorGetA(readback.getColor(40, 128)) > 0);
+    for (int x = 32; x < 128; x += 8) {
+        int left = SkColorGetA(readback.getColor(x, 128));
+        int right = SkColorGetA(readback.getColor(255 - x, 128));
+        int top = SkColorGetA(readback.getColor(128, x));
+        REPORTER_ASSERT(reporter, SkTAbs(left - right) <= 8 && SkTAbs(left - top) <= 8);
+        REPORTER_ASSERT(reporter, left <= (int)SkColorGetA(readback.getColor(x + 8, 128)));
+    }
+}
+
 DEF_TEST(zero_blur, reporter) {
     SkBitmap alpha, bitmap;
 
@@ -742,3 +783,65 @@ DEF_TEST(zero_blur, reporter) {
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
 
+
+// Makes a w x h mask of the given format whose alpha at (x, y) is alpha(x, y).
+static SkMask make_mask(SkMask::Format format, int w, int h, uint8_t (*alpha)(int, int)) {
+    SkMask mask;
+    mask.fBounds.setXYWH(0, 0, w, h);
+    mask.fFormat = format;
+    mask.fRowBytes = w * (format == SkMask::kARGB32_Format ? 4 : 1);
+    mask.fImage = SkMask::AllocImage(mask.computeImageSize());
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (format == SkMask::kARGB32_Format) {
+                *mask.getAddr32(x, y) = SkPackARGB32(alpha(x, y), 0, 0, 0);
+            } else {
+                *mask.getAddr8(x, y) = alpha(x, y);
+            }
+        }
+    }
+    return mask;
+}
+
+static bool masks_equal(const SkMask& a, const SkMask& b) {
+    if (a.fBounds != b.fBounds) {
+        return false;
+    }
+    for (int y = a.fBounds.fTop; y < a.fBounds.fBottom; ++y) {
+        if (memcmp(a.getAddr8(a.fBounds.fLeft, y), b.getAddr8(b.fBounds.fLeft, y),
+                   a.fBounds.width())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint8_t checker_alpha(int x, int y) {
+    return ((x / 3 + y / 5) & 1) ? (x * 7 + y * 13) & 0xFF : 0xFF;
+}
+
+// A8 masks blur several rows at once, and big blurs split their rows across the default executor
+// (a thread pool when the test runner has threads). Both must give exactly what blurring one row
+// at a time does, which is what the first pass of ARGB32 masks still does.
+DEF_TEST(BlurMaskFilterRows, reporter) {
+    auto blur = [](const SkMask& src, double sigma) {
+        SkMask dst;
+        SkMaskBlurFilter(sigma, sigma).blur(src, &dst);
+        return dst;
+    };
+
+    const struct { int w, h; double sigma; } kCases[] = {
+        { 1,  1,  2.0}, { 3,  2,  2.5}, {17, 5,  3.0}, {40, 23, 6.5},
+        {64, 61, 11.0}, {9, 150, 40.0}, {600, 501, 20.0},
+    };
+    for (const auto& c : kCases) {
+        SkMask a8   = make_mask(SkMask::kA8_Format,     c.w, c.h, checker_alpha),
+               argb = make_mask(SkMask::kARGB32_Format, c.w, c.h, checker_alpha);
+        SkAutoMaskFreeImage a8Image(a8.fImage), argbImage(argb.fImage);
+
+        SkMask fromA8 = blur(a8, c.sigma), fromARGB = blur(argb, c.sigma);
+        SkAutoMaskFreeImage fromA8Image(fromA8.fImage), fromARGBImage(fromARGB.fImage);
+        REPORTER_ASSERT(reporter, masks_equal(fromA8, fromARGB),
+                        "%dx%d sigma %g", c.w, c.h, c.sigma);
+    }
+}
@@ -678,6 +678,42 @@ DEF_TEST(Canvas_ClipEmptyPath, reporter) {
     canvas.restore();
 }
 
+// Saves that only change the matrix leave the device's clip alone; the device saves its clip
+// when something first clips at that level. Either way, restores must put the clip back.
+DEF_TEST(Canvas_DeferredDeviceSave, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(10, 10);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bm);
+
+    canvas.save();
+    canvas.translate(1, 1);         // resolves the save, but not the device's
+    canvas.save();
+    canvas.translate(1, 1);
+    canvas.clipRect(SkRect::MakeWH(2, 2));  // the device saves its clip here
+    REPORTER_ASSERT(reporter, canvas.getDeviceClipBounds() == SkIRect::MakeLTRB(2, 2, 4, 4));
+    canvas.drawColor(SK_ColorRED);
+    canvas.restore();
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix() == SkMatrix::MakeTrans(1, 1));
+    REPORTER_ASSERT(reporter, canvas.getDeviceClipBounds() == SkIRect::MakeWH(10, 10));
+
+    canvas.saveLayer(nullptr, nullptr);
+    canvas.clipRect(SkRect::MakeXYWH(5, 5, 1, 1));
+    canvas.drawColor(SK_ColorGREEN);
+    canvas.restore();
+    canvas.restore();
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix().isIdentity());
+
+    REPORTER_ASSERT(reporter, *bm.getAddr32(2, 2) == SkPreMultiplyColor(SK_ColorRED));
+    REPORTER_ASSERT(reporter, *bm.getAddr32(4, 4) == 0);
+    REPORTER_ASSERT(reporter, *bm.getAddr32(6, 6) == SkPreMultiplyColor(SK_ColorGREEN));
+
+    // Nothing should still be clipping the device.
+    canvas.drawColor(SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, *bm.getAddr32(0, 0) == SkPreMultiplyColor(SK_ColorBLUE));
+    REPORTER_ASSERT(reporter, *bm.getAddr32(9, 9) == SkPreMultiplyColor(SK_ColorBLUE));
+}
+
 namespace {
 
 class MockFilterCanvas : public SkPaintFilterCanvas {
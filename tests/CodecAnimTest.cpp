@@ -8,10 +8,13 @@
 #include "CodecPriv.h"
 #include "Resources.h"
 #include "SkAndroidCodec.h"
+#include "SkAnimCodecPlayer.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCodecAnimation.h"
 #include "SkData.h"
+#include "SkExecutor.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkRefCnt.h"
 #include "SkSize.h"
@@ -446,3 +449,53 @@ DEF_TEST(AndroidCodec_animated, r) {
         }
     }
 }
+
+// Frames decoded ahead on an executor, some of them dropped from the cache and decoded again,
+// must match the frames of a player that decodes each frame when it is asked for.
+DEF_TEST(AnimCodecPlayer_decodeAhead, r) {
+    if (GetResourcePath().isEmpty()) {
+        return;
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const char* file : { "images/required.gif", "images/required.webp",
+                              "images/alphabetAnim.gif", "images/webp-animated.webp" }) {
+        sk_sp<SkData> data(GetResourceAsData(file));
+        if (!data) {
+            ERRORF(r, "Missing %s", file);
+            continue;
+        }
+
+        SkAnimCodecPlayer expected(SkCodec::MakeFromData(data));
+        SkAnimCodecPlayer::Options options;
+        options.fExecutor = executor.get();
+        options.fDecodeAhead = 3;
+        options.fMaxCachedFrames = 4;
+        SkAnimCodecPlayer actual(data, options);
+        REPORTER_ASSERT(r, expected.duration() == actual.duration());
+        if (0 == expected.duration()) {
+            continue;
+        }
+
+        // Play through twice, so that frames dropped the first time are decoded again.
+        for (uint32_t msec = 0; msec < 2 * expected.duration(); msec += 10) {
+            expected.seek(msec);
+            actual.seek(msec);
+            sk_sp<SkImage> expectedFrame = expected.getFrame();
+            sk_sp<SkImage> actualFrame = actual.getFrame();
+            SkPixmap expectedPM, actualPM;
+            if (!expectedFrame || !actualFrame || !expectedFrame->peekPixels(&expectedPM)
+                    || !actualFrame->peekPixels(&actualPM)) {
+                ERRORF(r, "%s: failed to decode the frame at %u ms", file, msec);
+                break;
+            }
+            for (int y = 0; y < expectedPM.height(); ++y) {
+                if (memcmp(expectedPM.addr(0, y), actualPM.addr(0, y),
+                           expectedPM.info().minRowBytes())) {
+                    ERRORF(r, "%s: frames at %u ms differ", file, msec);
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -146,6 +146,72 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "images/color_wheel.gif");
 }
 
+// Progressive jpegs are shown a scan at a time as their data arrives. Each scan that is shown
+// rewrites the whole image.
+static void test_partial_progressive(skiatest::Reporter* r, const char* name) {
+    sk_sp<SkData> file = GetResourceAsData(name);
+    if (!file) {
+        SkDebugf("missing resource %s\n", name);
+        return;
+    }
+
+    SkBitmap truth;
+    if (!create_truth(file, &truth)) {
+        ERRORF(r, "Failed to decode %s\n", name);
+        return;
+    }
+
+    HaltingStream* stream = new HaltingStream(file, file->size() / 4);
+    std::unique_ptr<SkCodec> partialCodec(
+            SkCodec::MakeFromStream(std::unique_ptr<SkStream>(stream)));
+    if (!partialCodec) {
+        ERRORF(r, "Failed to create codec for %s", name);
+        return;
+    }
+
+    const SkImageInfo info = standardize_info(partialCodec.get());
+    SkBitmap incremental;
+    incremental.allocPixels(info);
+    if (SkCodec::kSuccess != partialCodec->startIncrementalDecode(info, incremental.getPixels(),
+                                                                  incremental.rowBytes())) {
+        ERRORF(r, "Failed to start incremental decode of %s", name);
+        return;
+    }
+
+    int scansShown = 0;
+    while (true) {
+        int rowsDecoded = 0;
+        const SkCodec::Result result = partialCodec->incrementalDecode(&rowsDecoded);
+        const SkIRect updated = partialCodec->getIncrementalUpdatedBounds();
+        if (!updated.isEmpty()) {
+            REPORTER_ASSERT(r, updated == SkIRect::MakeWH(info.width(), info.height()));
+            scansShown++;
+        }
+
+        if (result == SkCodec::kSuccess) {
+            break;
+        }
+
+        REPORTER_ASSERT(r, result == SkCodec::kIncompleteInput);
+        REPORTER_ASSERT(r, rowsDecoded == (scansShown ? info.height() : 0));
+
+        if (stream->isAllDataReceived()) {
+            ERRORF(r, "Failed to completely decode %s", name);
+            return;
+        }
+        stream->addNewData(1000);
+    }
+
+    // Coarser scans were shown before all of the data arrived.
+    REPORTER_ASSERT(r, scansShown > 1);
+    compare_bitmaps(r, truth, incremental);
+}
+
+DEF_TEST(Codec_partialProgressiveJpeg, r) {
+    test_partial_progressive(r, "images/brickwork-texture.jpg");
+    test_partial_progressive(r, "images/flutter_logo.jpg");
+}
+
 // Verify that when decoding an animated gif byte by byte we report the correct
 // fRequiredFrame as soon as getFrameInfo reports the frame.
 DEF_TEST(Codec_requiredFrame, r) {
@@ -18,6 +18,7 @@
 #include "SkColorSpacePriv.h"
 #include "SkData.h"
 #include "SkEncodedImageFormat.h"
+#include "SkExecutor.h"
 #include "SkFrontBufferedStream.h"
 #include "SkImage.h"
 #include "SkImageGenerator.h"
@@ -1659,3 +1660,174 @@ DEF_TEST(Codec_crbug807324, r) {
         }
     }
 }
+
+namespace {
+// Runs each task as soon as it is added, counting them.
+class CountingExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override {
+        fCount++;
+        work();
+    }
+
+    int fCount = 0;
+};
+}  // namespace
+
+// Decoding in bands between restart markers must match the serial decode exactly.
+DEF_TEST(Codec_jpegRestartBands, r) {
+    struct {
+        const char* fPath;
+        bool        fHasBands;
+    } recs[] = {
+        // 4:2:0, with a restart marker at the start of each MCU row.
+        { "images/icc-v2-gbr.jpg",      true  },
+        // No restart markers.
+        { "images/mandrill_h2v1.jpg",   false },
+    };
+    for (const auto& rec : recs) {
+        sk_sp<SkData> data = GetResourceAsData(rec.fPath);
+        if (!data) {
+            continue;
+        }
+        for (SkColorType colorType : { kN32_SkColorType, kRGB_565_SkColorType,
+                                       kRGBA_F16_SkColorType }) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            REPORTER_ASSERT(r, codec);
+            SkImageInfo info = codec->getInfo().makeColorType(colorType);
+            if (kRGBA_F16_SkColorType == colorType) {
+                info = info.makeColorSpace(SkColorSpace::MakeSRGBLinear());
+            }
+
+            SkBitmap serial, bands;
+            serial.allocPixels(info);
+            bands.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(serial.pixmap()));
+
+            CountingExecutor executor;
+            SkCodec::Options options;
+            options.fExecutor = &executor;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bands.pixmap(), &options));
+            REPORTER_ASSERT(r, rec.fHasBands == (executor.fCount > 1), "%s", rec.fPath);
+            REPORTER_ASSERT(r, !memcmp(serial.getPixels(), bands.getPixels(),
+                                       serial.computeByteSize()), "%s", rec.fPath);
+        }
+    }
+}
+
+// Swizzling and color transforming PNG rows on an executor must match the serial decode exactly.
+DEF_TEST(Codec_pngPipelined, r) {
+    std::unique_ptr<SkExecutor> threadPool = SkExecutor::MakeFIFOThreadPool(2);
+    for (const char* path : { "images/mandrill_512.png", "images/color_wheel_with_profile.png",
+                              "images/index8.png", "images/plane_interlaced.png" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        for (SkColorType colorType : { kN32_SkColorType, kRGBA_F16_SkColorType }) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            REPORTER_ASSERT(r, codec);
+            SkImageInfo info = codec->getInfo().makeColorType(colorType);
+            if (kRGBA_F16_SkColorType == colorType) {
+                info = info.makeColorSpace(SkColorSpace::MakeSRGBLinear());
+            }
+
+            SkBitmap serial;
+            serial.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(serial.pixmap()));
+
+            CountingExecutor inlineExecutor;
+            for (SkExecutor* executor : { (SkExecutor*) &inlineExecutor, threadPool.get() }) {
+                SkBitmap pipelined;
+                pipelined.allocPixels(info);
+                SkCodec::Options options;
+                options.fExecutor = executor;
+                REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(pipelined.pixmap(),
+                                                                         &options));
+                REPORTER_ASSERT(r, !memcmp(serial.getPixels(), pipelined.getPixels(),
+                                           serial.computeByteSize()), "%s", path);
+            }
+        }
+    }
+}
+
+// Subsets of jpegs are decoded incrementally, starting at the last restart marker above the subset
+// when the codec can find one. Decoding from the start of the image must give the same pixels.
+DEF_TEST(Codec_jpegSubsetFromRestart, r) {
+    for (const char* path : { "images/icc-v2-gbr.jpg", "images/mandrill_h2v1.jpg" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        for (int sampleSize : { 1, 2, 3, 4, 8 }) {
+            // Only codecs with the whole image in memory look for restart markers.
+            std::unique_ptr<SkAndroidCodec> seeking = SkAndroidCodec::MakeFromData(data);
+            std::unique_ptr<SkAndroidCodec> serial = SkAndroidCodec::MakeFromStream(
+                    skstd::make_unique<NotAssetMemStream>(data));
+            REPORTER_ASSERT(r, seeking && serial);
+            if (!seeking || !serial) {
+                return;
+            }
+
+            const SkISize dims = seeking->getInfo().dimensions();
+            SkIRect subset = SkIRect::MakeXYWH(dims.width() / 4, dims.height() * 2 / 3,
+                                               dims.width() / 3, dims.height() / 4);
+            REPORTER_ASSERT(r, seeking->getSupportedSubset(&subset));
+            const SkISize size = seeking->getSampledSubsetDimensions(sampleSize, subset);
+            const SkImageInfo info = seeking->getInfo().makeWH(size.width(), size.height())
+                                                       .makeColorType(kN32_SkColorType);
+
+            SkAndroidCodec::AndroidOptions options;
+            options.fSampleSize = sampleSize;
+            options.fSubset = &subset;
+            SkBitmap expected, actual;
+            expected.allocPixels(info);
+            actual.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == serial->getAndroidPixels(
+                    info, expected.getPixels(), expected.rowBytes(), &options));
+            REPORTER_ASSERT(r, SkCodec::kSuccess == seeking->getAndroidPixels(
+                    info, actual.getPixels(), actual.rowBytes(), &options));
+            REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.computeByteSize()),
+                            "%s, sample size %d", path, sampleSize);
+        }
+    }
+}
+
+// A stream that can seek but isn't in memory, so codecs have to copy out of it.
+class NotMemoryBackedStream : public SkMemoryStream {
+public:
+    NotMemoryBackedStream(sk_sp<SkData> data) : SkMemoryStream(std::move(data)) {}
+
+    const void* getMemoryBase() override { return nullptr; }
+};
+
+// Codecs decode memory-backed streams in place. That must give the same pixels as copying.
+DEF_TEST(Codec_memoryBacked, r) {
+    for (const char* path : { "images/box.gif", "images/randPixels.gif", "images/mandrill_128.png",
+                              "images/plane_interlaced.png", "images/color_wheel.webp" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> inPlace = SkCodec::MakeFromData(data);
+        std::unique_ptr<SkCodec> copying = SkCodec::MakeFromStream(
+                skstd::make_unique<NotMemoryBackedStream>(data));
+        REPORTER_ASSERT(r, inPlace && copying);
+        if (!inPlace || !copying) {
+            continue;
+        }
+
+        const SkImageInfo info = inPlace->getInfo().makeColorType(kN32_SkColorType)
+                                                   .makeAlphaType(kPremul_SkAlphaType);
+        SkBitmap expected, actual;
+        expected.allocPixels(info);
+        actual.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == copying->getPixels(info, expected.getPixels(),
+                                                                   expected.rowBytes()));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == inPlace->getPixels(info, actual.getPixels(),
+                                                                   actual.rowBytes()));
+        REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()), "%s", path);
+    }
+}
@@ -9,7 +9,9 @@
 #include "SkCodec.h"
 #include "SkColorSpace.h"
 #include "SkColorSpacePriv.h"
+#include "SkColorSpaceXformer.h"
 #include "SkData.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkMatrix44.h"
 #include "SkRefCnt.h"
@@ -430,3 +432,25 @@ DEF_TEST(ColorSpace_skcms_sRGB_exact, r) {
 
     REPORTER_ASSERT(r, 0 == memcmp(&profile, skcms_sRGB_profile(), sizeof(skcms_ICCProfile)));
 }
+
+DEF_TEST(ColorSpace_XformerImageCache, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(8, 8);
+    bm.eraseColor(SK_ColorRED);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bm);
+
+    sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                                                   SkColorSpace::kDCIP3_D65_Gamut);
+
+    // Separate xformers, like separate SkColorSpaceXformCanvas draws, share the converted image.
+    sk_sp<SkImage> xformed0 = SkColorSpaceXformer::Make(p3)->apply(image.get());
+    sk_sp<SkImage> xformed1 = SkColorSpaceXformer::Make(p3)->apply(image.get());
+    REPORTER_ASSERT(r, xformed0 && xformed0 != image);
+    REPORTER_ASSERT(r, xformed0 == xformed1);
+
+    // A different destination gets its own conversion.
+    sk_sp<SkColorSpace> srgbLinear = SkColorSpace::MakeSRGBLinear();
+    sk_sp<SkImage> linear = SkColorSpaceXformer::Make(srgbLinear)->apply(image.get());
+    REPORTER_ASSERT(r, linear && linear != xformed0);
+    REPORTER_ASSERT(r, SkColorSpace::Equals(linear->colorSpace(), srgbLinear.get()));
+}
@@ -7,6 +7,7 @@
 
 #include "SkData.h"
 #include "SkDataTable.h"
+#include "SkExecutor.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkRWBuffer.h"
@@ -313,6 +314,53 @@ DEF_TEST(RWBuffer_threaded, reporter) {
     tasks.wait();
 }
 
+DEF_TEST(RWBuffer_streaming, reporter) {
+    // Knowing that the default capacity is 4096, choose N large enough so we force it to use
+    // multiple buffers internally.
+    const int N = 1000;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkTaskGroup tasks(*executor);
+    SkRWBuffer buffer;
+
+    // One reader starts before anything is appended, the other partway through.
+    auto checkStream = [reporter](SkStreamSeekable* stream) {
+        // Reads that straddle the appends have to wait for the rest of their bytes.
+        SkAutoTMalloc<char> storage(N * 26);
+        for (size_t offset = 0; offset < N * 26; offset += 39) {
+            size_t request = SkTMin<size_t>(39, N * 26 - offset);
+            REPORTER_ASSERT(reporter, stream->read(storage.get() + offset, request) == request);
+        }
+        check_abcs(reporter, storage.get(), N * 26);
+        REPORTER_ASSERT(reporter, stream->read(storage.get(), 1) == 0);
+        REPORTER_ASSERT(reporter, stream->isAtEnd());
+
+        REPORTER_ASSERT(reporter, stream->seek(26 * 7));
+        REPORTER_ASSERT(reporter, stream->getPosition() == 26 * 7);
+        std::unique_ptr<SkStreamSeekable> fork = stream->fork();
+        REPORTER_ASSERT(reporter, fork->read(storage.get(), 26 * 2) == 26 * 2);
+        check_abcs(reporter, storage.get(), 26 * 2);
+        REPORTER_ASSERT(reporter, fork->getPosition() == 26 * 9);
+    };
+
+    SkStreamSeekable* early = buffer.makeStreamingReader().release();
+    tasks.add([checkStream, early] {
+        checkStream(early);
+        delete early;
+    });
+    for (int i = 0; i < N; ++i) {
+        buffer.append(gABC, 26);
+        if (N / 2 == i) {
+            SkStreamSeekable* late = buffer.makeStreamingReader().release();
+            tasks.add([checkStream, late] {
+                checkStream(late);
+                delete late;
+            });
+        }
+    }
+    buffer.finish();
+    tasks.wait();
+}
+
 // Tests that it is safe to call SkROBuffer::Iter::size() when exhausted.
 DEF_TEST(RWBuffer_size, r) {
     SkRWBuffer buffer;
@@ -24,11 +24,13 @@
 #include "SkColorSpace.h"
 #include "SkDeferredDisplayList.h"
 #include "SkDeferredDisplayListRecorder.h"
+#include "SkExecutor.h"
 #include "SkGpuDevice.h"
 #include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkImage_Gpu.h"
 #include "SkPaint.h"
+#include "SkPictureRecorder.h"
 #include "SkRect.h"
 #include "SkRefCnt.h"
 #include "SkSurface.h"
@@ -802,6 +804,53 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DDLFlushWhileRecording, reporter, ctxInfo) {
     canvas->getGrContext()->flush();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Recording a picture as tiled DDLs on worker threads should draw the same as drawing it directly
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DDLRecordTiles, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+
+    SkPictureRecorder pictureRecorder;
+    SkCanvas* recordingCanvas = pictureRecorder.beginRecording(64, 64);
+    SkPaint paint;
+    for (int i = 0; i < 8; i++) {
+        paint.setColor(SkColorSetARGB(0xFF, i * 32, 255 - i * 32, 0x80));
+        recordingCanvas->drawRect(SkRect::MakeXYWH(i * 8, i * 4, 20, 30), paint);
+    }
+    sk_sp<SkPicture> picture = pictureRecorder.finishRecordingAsPicture();
+
+    SkImageInfo ii = SkImageInfo::MakeN32Premul(64, 64);
+    sk_sp<SkSurface> expected = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, ii),
+                     actual   = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, ii);
+    expected->getCanvas()->clear(SK_ColorWHITE);
+    expected->getCanvas()->drawPicture(picture);
+    actual->getCanvas()->clear(SK_ColorWHITE);
+
+    SkSurfaceCharacterization characterization;
+    SkAssertResult(actual->characterize(&characterization));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkDeferredDisplayListRecorder::TileStats stats;
+    REPORTER_ASSERT(reporter, SkDeferredDisplayListRecorder::RecordTiles(
+            picture.get(), characterization, 3, 2, executor.get(), actual.get(), &stats));
+    REPORTER_ASSERT(reporter, 6 == stats.fTileCount);
+    REPORTER_ASSERT(reporter, 6 == stats.fTilesDrawn);
+
+    SkBitmap expectedBM, actualBM;
+    expectedBM.allocPixels(ii);
+    actualBM.allocPixels(ii);
+    SkAssertResult(expected->readPixels(expectedBM, 0, 0));
+    SkAssertResult(actual->readPixels(actualBM, 0, 0));
+    REPORTER_ASSERT(reporter, 0 == memcmp(expectedBM.getPixels(), actualBM.getPixels(),
+                                          expectedBM.computeByteSize()));
+
+    // An incompatible destination draws nothing.
+    sk_sp<SkSurface> other = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                                         SkImageInfo::MakeN32Premul(32, 32));
+    REPORTER_ASSERT(reporter, !SkDeferredDisplayListRecorder::RecordTiles(
+            picture.get(), characterization, 2, 2, nullptr, other.get(), &stats));
+    REPORTER_ASSERT(reporter, 0 == stats.fTilesDrawn);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Check that the texture-specific flags (i.e., for external & rectangle textures) work
 // for promise images. As such, this is a GL-only test.
@@ -36,3 +36,32 @@ DEF_TEST(DiscardableMemoryPool, reporter) {
     REPORTER_ASSERT(reporter, !dm2->lock());
     REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
 }
+
+DEF_TEST(DiscardableMemoryPool_Paged, reporter) {
+    const size_t kBytes = 100 * 1024;
+    sk_sp<SkDiscardableMemoryPool> pool(SkDiscardableMemoryPool::MakePaged(4 * kBytes, kBytes));
+
+    // Paged or not, memory that nothing purged comes back intact.
+    for (size_t bytes : { kBytes / 2, kBytes }) {
+        std::unique_ptr<SkDiscardableMemory> dm(pool->create(bytes));
+        REPORTER_ASSERT(reporter, dm);
+        REPORTER_ASSERT(reporter, bytes == pool->getRAMUsed());
+        uint8_t* data = static_cast<uint8_t*>(dm->data());
+        for (size_t i = 0; i < bytes; ++i) {
+            data[i] = (uint8_t)(i * 7);
+        }
+        dm->unlock();
+        REPORTER_ASSERT(reporter, bytes == pool->getRAMUsed());
+        REPORTER_ASSERT(reporter, dm->lock());
+        data = static_cast<uint8_t*>(dm->data());
+        bool intact = true;
+        for (size_t i = 0; i < bytes; ++i) {
+            intact &= data[i] == (uint8_t)(i * 7);
+        }
+        REPORTER_ASSERT(reporter, intact);
+        dm->unlock();
+        pool->dumpPool();
+        REPORTER_ASSERT(reporter, !dm->lock());
+        REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
+    }
+}
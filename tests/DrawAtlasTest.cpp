@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkRSXform.h"
+#include "SkShader.h"
+#include "Test.h"
+
+// Draws each sprite on its own, with the colors blended in by a compose shader.
+static void draw_sprites(SkCanvas* canvas, const sk_sp<SkImage>& atlas, const SkRSXform xform[],
+                         const SkRect tex[], const SkColor colors[], int count, SkBlendMode mode,
+                         const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        SkMatrix matrix;
+        matrix.setRSXform(xform[i]);
+        matrix.preTranslate(-tex[i].fLeft, -tex[i].fTop);
+
+        SkPaint p(paint);
+        p.setShader(atlas->makeShader());
+        if (colors) {
+            p.setShader(SkShader::MakeComposeShader(SkShader::MakeColorShader(colors[i]),
+                                                    p.refShader(), mode));
+        }
+        canvas->save();
+        canvas->concat(matrix);
+        canvas->drawRect(tex[i], p);
+        canvas->restore();
+    }
+}
+
+DEF_TEST(DrawAtlas_raster, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(32, 16);
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            *bm.getAddr32(x, y) = SkPreMultiplyARGB(x < 16 ? 0xFF : 0xC0, x * 8, y * 16,
+                                                    (x ^ y) * 8);
+        }
+    }
+    sk_sp<SkImage> atlas = SkImage::MakeFromBitmap(bm);
+
+    // Overlapping sprites, so that drawing them out of order would show.
+    const SkRect tex[] = {
+        SkRect::MakeXYWH(0, 0, 16, 16), SkRect::MakeXYWH(16, 0, 16, 16),
+        SkRect::MakeXYWH(4, 4, 8, 8),
+    };
+    const SkColor colors[] = { 0xFFFF8040, 0x80FFFFFF, 0xFF20C0FF };
+
+    for (bool rotate : { false, true }) {
+        SkRSXform xform[] = {
+            SkRSXform::Make(1, 0, 4, 4),
+            SkRSXform::Make(2, 0, 12, 10),
+            SkRSXform::Make(1, 0, 30, 30),
+        };
+        if (rotate) {
+            xform[0] = SkRSXform::MakeFromRadians(1, 0.5f, 20, 20, 8, 8);
+            xform[2] = SkRSXform::MakeFromRadians(1.5f, -1, 30, 30, 4, 4);
+        }
+        for (bool withColors : { false, true }) {
+            for (SkAlpha alpha : { 0xFF, 0x80 }) {
+                SkPaint paint;
+                paint.setAlpha(alpha);
+
+                SkBitmap expected, actual;
+                expected.allocN32Pixels(48, 48);
+                expected.eraseColor(SK_ColorTRANSPARENT);
+                SkCanvas expectedCanvas(expected);
+                draw_sprites(&expectedCanvas, atlas, xform, tex, withColors ? colors : nullptr,
+                             3, SkBlendMode::kModulate, paint);
+
+                actual.allocN32Pixels(48, 48);
+                actual.eraseColor(SK_ColorTRANSPARENT);
+                SkCanvas(actual).drawAtlas(atlas, xform, tex, withColors ? colors : nullptr, 3,
+                                           SkBlendMode::kModulate, nullptr, &paint);
+
+                int mismatches = 0;
+                for (int y = 0; y < 48; ++y) {
+                    for (int x = 0; x < 48; ++x) {
+                        const uint8_t* ep = (const uint8_t*)expected.getAddr32(x, y);
+                        const uint8_t* ap = (const uint8_t*)actual.getAddr32(x, y);
+                        for (int i = 0; i < 4; ++i) {
+                            mismatches += SkTAbs(ep[i] - ap[i]) > 1;
+                        }
+                    }
+                }
+                REPORTER_ASSERT(reporter, 0 == mismatches, "rotate %d, colors %d, alpha %d",
+                                rotate, withColors, alpha);
+            }
+        }
+    }
+}
@@ -172,6 +172,68 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(BasicDrawOpAtlas, reporter, ctxInfo) {
     check(reporter, atlas.get(), 1, 4, 1);
 }
 
+static void count_evictions(GrDrawOpAtlas::AtlasID, void* data) {
+    ++*static_cast<int*>(data);
+}
+
+// Verifies that uploads are batched per page, and that a full atlas evicts the least recently
+// used plot of any page.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DrawOpAtlasUploadsAndEviction, reporter, ctxInfo) {
+    auto context = ctxInfo.grContext();
+    auto proxyProvider = context->contextPriv().proxyProvider();
+    auto resourceProvider = context->contextPriv().resourceProvider();
+
+    TestingUploadTarget uploadTarget;
+
+    int evictions = 0;
+    std::unique_ptr<GrDrawOpAtlas> atlas = GrDrawOpAtlas::Make(
+                                                proxyProvider,
+                                                kAlpha_8_GrPixelConfig,
+                                                kAtlasSize, kAtlasSize,
+                                                kNumPlots, kNumPlots,
+                                                GrDrawOpAtlas::AllowMultitexturing::kYes,
+                                                count_evictions, &evictions);
+    atlas->setMaxPages(2);
+    check(reporter, atlas.get(), 0, 2, 0);
+
+    // Fill both pages. Each page's plots are written by a single ASAP upload.
+    static const int kPlotsPerPage = kNumPlots * kNumPlots;
+    GrDrawOpAtlas::AtlasID atlasIDs[2 * kPlotsPerPage];
+    for (int i = 0; i < 2 * kPlotsPerPage; ++i) {
+        bool result = fill_plot(atlas.get(), resourceProvider, &uploadTarget, &atlasIDs[i], i*16);
+        REPORTER_ASSERT(reporter, result);
+    }
+    check(reporter, atlas.get(), 2, 2, 2);
+    REPORTER_ASSERT(reporter, 2 == atlas->stats().fPageActivations);
+    REPORTER_ASSERT(reporter, 2 == atlas->stats().fASAPUploads);
+    REPORTER_ASSERT(reporter, 2 * kPlotsPerPage == atlas->stats().fASAPPlotUploads);
+
+    // Draw with the second page's plots, and then with the first page's.
+    for (int i = kPlotsPerPage; i < 2 * kPlotsPerPage; ++i) {
+        atlas->setLastUseToken(atlasIDs[i], uploadTarget.tokenTracker()->nextDrawToken());
+    }
+    uploadTarget.issueDrawToken();
+    for (int i = 0; i < kPlotsPerPage; ++i) {
+        atlas->setLastUseToken(atlasIDs[i], uploadTarget.tokenTracker()->nextDrawToken());
+    }
+    uploadTarget.issueDrawToken();
+    uploadTarget.flushToken();
+    uploadTarget.flushToken();
+
+    // The next upload evicts the plot used longest ago, which is on the second page.
+    GrDrawOpAtlas::AtlasID atlasID;
+    bool result = fill_plot(atlas.get(), resourceProvider, &uploadTarget, &atlasID, 255);
+    REPORTER_ASSERT(reporter, result);
+    REPORTER_ASSERT(reporter, 1 == evictions);
+    REPORTER_ASSERT(reporter, 1 == atlas->stats().fPlotEvictions);
+    REPORTER_ASSERT(reporter, 1 == GrDrawOpAtlas::GetPageIndexFromID(atlasID));
+    REPORTER_ASSERT(reporter, !atlas->hasID(atlasIDs[kPlotsPerPage]));
+    for (int i = 0; i < kPlotsPerPage; ++i) {
+        REPORTER_ASSERT(reporter, atlas->hasID(atlasIDs[i]));
+    }
+    REPORTER_ASSERT(reporter, 3 == atlas->stats().fASAPUploads);
+}
+
 // This test verifies that the GrAtlasTextOp::onPrepare method correctly handles a failure
 // when allocating an atlas page.
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(GrAtlasTextOpPreparation, reporter, ctxInfo) {
@@ -8,12 +8,14 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkColorPriv.h"
 #include "SkDashPathEffect.h"
 #include "SkImageInfo.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkPathEffect.h"
+#include "SkPathPriv.h"
 #include "SkPoint.h"
 #include "SkRRect.h"
 #include "SkRect.h"
@@ -371,3 +373,177 @@ DEF_TEST(DrawPath, reporter) {
     test_big_aa_rect(reporter);
     test_halfway();
 }
+
+static SkBitmap draw_roads(bool useDeltaAA, SkScalar strokeWidth) {
+    SkPath path;
+    path.moveTo(5, 5);
+    for (int i = 1; i <= 40; ++i) {
+        path.lineTo(5 + i * 6.3f, (i & 1) ? 90.5f : 10.25f);
+    }
+    path.moveTo(5, 50);
+    path.cubicTo(100, -20, 150, 120, 250, 50);
+    // Rather than toggling gSkUseDeltaAA, which other tests may be drawing with, keep this path
+    // (and the outline stroked from it) away from DAA.
+    SkPathPriv::SetIsBadForDAA(path, !useDeltaAA);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(strokeWidth);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(260, 100);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas(bitmap).drawPath(path, paint);
+    return bitmap;
+}
+
+// Stroke outlines and busy anti-aliased hairlines are scan converted with DAA. Check that they
+// cover the same pixels as the per-segment hairline code and AAA/SAA do, give or take the joins.
+DEF_TEST(DrawPath_DeltaAAStrokesAndHairlines, reporter) {
+    for (SkScalar strokeWidth : { 0.0f, 3.0f }) {
+        SkBitmap daa   = draw_roads(true,  strokeWidth),
+                 other = draw_roads(false, strokeWidth);
+        int covered = 0, mismatched = 0;
+        for (int y = 0; y < daa.height(); ++y) {
+            for (int x = 0; x < daa.width(); ++x) {
+                int a = SkGetPackedA32(*daa.getAddr32(x, y)),
+                    b = SkGetPackedA32(*other.getAddr32(x, y));
+                covered += (a || b);
+                mismatched += SkTAbs(a - b) > 64;
+            }
+        }
+        REPORTER_ASSERT(reporter, covered > 0);
+        REPORTER_ASSERT(reporter, mismatched * 20 < covered, "width %g", strokeWidth);
+    }
+}
+
+static void draw_markers(SkCanvas* canvas, bool aa) {
+    SkPaint paint;
+    paint.setAntiAlias(aa);
+    canvas->clear(SK_ColorWHITE);
+
+    // Disjoint markers sharing a paint, then overlapping translucent ones.  These are drawn as
+    // paths, since drawCircle() fills anti-aliased circles analytically instead of batching them.
+    auto circle = [](SkScalar x, SkScalar y, SkScalar radius) {
+        SkPath path;
+        path.addCircle(x, y, radius);
+        return path;
+    };
+    paint.setColor(SK_ColorBLUE);
+    for (int i = 0; i < 100; ++i) {
+        canvas->drawPath(circle(10.5f + (i % 10) * 19, 10.25f + (i / 10) * 19, 6), paint);
+    }
+    paint.setColor(0x80FF0000);
+    for (int i = 0; i < 20; ++i) {
+        canvas->drawPath(circle(30 + i * 4, 100, 12), paint);
+    }
+
+    // The same paint under different matrices and clips.
+    paint.setColor(SK_ColorBLACK);
+    SkPath triangle;
+    triangle.moveTo(0, 0);
+    triangle.lineTo(8, 3);
+    triangle.lineTo(2, 9);
+    triangle.close();
+    for (int i = 0; i < 10; ++i) {
+        canvas->save();
+        if (i & 4) {
+            canvas->clipRect(SkRect::MakeLTRB(0, 0, 100, 200));
+        }
+        canvas->translate(5 + i * 18.3f, 150);
+        canvas->rotate(i * 10.0f);
+        canvas->drawPath(triangle, paint);
+        canvas->restore();
+    }
+}
+
+DEF_TEST(DrawPath_BatchedFills, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(200, 200);
+    const SkSurfaceProps props(SkSurfaceProps::kBatchRasterPathFills_Flag,
+                               kUnknown_SkPixelGeometry);
+    for (bool aa : { false, true }) {
+        auto batched = SkSurface::MakeRaster(info, &props);
+        auto plain = SkSurface::MakeRaster(info);
+        draw_markers(batched->getCanvas(), aa);
+        draw_markers(plain->getCanvas(), aa);
+
+        // Peeking must see the pending fills.
+        SkPixmap batchedPixels, plainPixels;
+        REPORTER_ASSERT(reporter, batched->peekPixels(&batchedPixels));
+        REPORTER_ASSERT(reporter, plain->peekPixels(&plainPixels));
+
+        // Batched fills may go to a different anti-aliasing scan converter than lone ones.
+        const int tolerance = aa ? 64 : 0;
+        bool close = true;
+        for (int y = 0; y < info.height(); ++y) {
+            for (int x = 0; x < info.width(); ++x) {
+                uint32_t a = *batchedPixels.addr32(x, y),
+                         b = *plainPixels.addr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    close &= SkTAbs((int)((a >> shift) & 0xFF) -
+                                    (int)((b >> shift) & 0xFF)) <= tolerance;
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, close, "aa %d", aa);
+    }
+}
+
+#if !defined(SK_DISABLE_ANALYTIC_RRECTS) && !defined(SK_IGNORE_BLURRED_RRECT_OPT)
+// Anti-aliased rrects and ovals are filled with analytic coverage rather than as paths.  They
+// should match the coverage of the path sampled 16x16 times per pixel, and never touch pixels
+// outside the clip.  (Anti-aliased path filling itself can be much further off in the corners.)
+DEF_TEST(DrawPath_AnalyticRRects, reporter) {
+    const SkRect rect = SkRect::MakeLTRB(10.3f, 20.6f, 170.5f, 90.25f);
+    SkRRect rrects[4];
+    rrects[0].setRectXY(rect, 12, 12);
+    rrects[1].setRectXY(rect, 40, 9.5f);
+    rrects[2].setOval(rect);
+    const SkVector radii[4] = { {0, 0}, {30, 20}, {0.25f, 0.25f}, {60, 35} };
+    rrects[3].setRectRadii(rect, radii);
+
+    constexpr int kSamples = 16;
+    const SkIRect clips[] = { SkIRect::MakeWH(200, 120), SkIRect::MakeLTRB(40, 25, 120, 70) };
+    for (const SkIRect& clip : clips) {
+        for (const SkRRect& rrect : rrects) {
+            SkBitmap analytic, sampled;
+            analytic.allocPixels(SkImageInfo::MakeA8(200, 120));
+            analytic.eraseColor(SK_ColorTRANSPARENT);
+            sampled.allocPixels(SkImageInfo::MakeA8(200 * kSamples, 120 * kSamples));
+            sampled.eraseColor(SK_ColorTRANSPARENT);
+
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            SkCanvas analyticCanvas(analytic);
+            analyticCanvas.clipRect(SkRect::Make(clip));
+            analyticCanvas.drawRRect(rrect, paint);
+
+            SkCanvas sampledCanvas(sampled);
+            sampledCanvas.scale(kSamples, kSamples);
+            sampledCanvas.clipRect(SkRect::Make(clip));
+            sampledCanvas.drawPath(SkPath().addRRect(rrect), SkPaint());
+
+            int worst = 0;
+            bool outside = false;
+            for (int y = 0; y < 120; ++y) {
+                for (int x = 0; x < 200; ++x) {
+                    int covered = 0;
+                    for (int sy = 0; sy < kSamples; ++sy) {
+                        const uint8_t* row = sampled.getAddr8(x * kSamples, y * kSamples + sy);
+                        for (int sx = 0; sx < kSamples; ++sx) {
+                            covered += row[sx] != 0;
+                        }
+                    }
+                    int a = *analytic.getAddr8(x, y),
+                        b = (covered * 255 + kSamples * kSamples / 2) / (kSamples * kSamples);
+                    worst = SkTMax(worst, SkTAbs(a - b));
+                    outside |= a && !clip.contains(x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, !outside);
+            REPORTER_ASSERT(reporter, worst <= 24, "worst %d", worst);
+        }
+    }
+}
+#endif
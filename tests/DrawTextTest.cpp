@@ -11,6 +11,7 @@
 #include "SkDashPathEffect.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkPathEffect.h"
 #include "SkPoint.h"
 #include "SkRect.h"
@@ -213,3 +214,47 @@ DEF_TEST(DrawText_weirdMatricies, r) {
         canvas->drawString("Hamburgefons", 10, 10, paint);
     }
 }
+
+// Text drawn from distance fields should cover about what the glyphs' outlines cover.
+DEF_TEST(DrawText_distanceField, r) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkSurfaceProps sdfProps(SkSurfaceProps::kUseDeviceIndependentFonts_Flag,
+                            kUnknown_SkPixelGeometry);
+    SkImageInfo info = SkImageInfo::MakeN32Premul(400, 120);
+
+    for (SkScalar textSize : { 40.0f, 55.5f, 200.0f }) {
+        paint.setTextSize(textSize);
+        SkScalar y = textSize < 100 ? 80.0f : 110.0f;
+
+        auto outlineSurface = SkSurface::MakeRaster(info);
+        auto sdfSurface = SkSurface::MakeRaster(info, &sdfProps);
+        SkPath path;
+        paint.getTextPath("Hamburgefons", 12, 10, y, &path);
+        outlineSurface->getCanvas()->drawPath(path, paint);
+        sdfSurface->getCanvas()->drawString("Hamburgefons", 10, y, paint);
+
+        SkBitmap outline, sdf;
+        outline.allocPixels(info);
+        sdf.allocPixels(info);
+        outlineSurface->readPixels(outline, 0, 0);
+        sdfSurface->readPixels(sdf, 0, 0);
+
+        int64_t outlineInk = 0, sdfInk = 0;
+        int bigDifferences = 0;
+        for (int j = 0; j < info.height(); ++j) {
+            for (int i = 0; i < info.width(); ++i) {
+                int a = SkColorGetA(outline.getColor(i, j)),
+                    b = SkColorGetA(sdf.getColor(i, j));
+                outlineInk += a;
+                sdfInk += b;
+                bigDifferences += SkTAbs(a - b) > 64;
+            }
+        }
+        REPORTER_ASSERT(r, SkTAbs(outlineInk - sdfInk) <= outlineInk / 50,
+                        "size %g: ink %lld vs %lld", textSize, (long long)outlineInk,
+                        (long long)sdfInk);
+        REPORTER_ASSERT(r, bigDifferences <= 64,
+                        "size %g: %d pixels differ", textSize, bigDifferences);
+    }
+}
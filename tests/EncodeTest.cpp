@@ -11,6 +11,7 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkEncodedImageFormat.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkJpegEncoder.h"
 #include "SkPngEncoder.h"
@@ -286,6 +287,73 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+DEF_TEST(Encode_PngParallel, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+        return;
+    }
+
+    // F16 rows go through libpng's filler, which the parallel encode has to mimic.
+    SkBitmap f16;
+    f16.allocPixels(bitmap.info().makeColorType(kRGBA_F16_SkColorType));
+    REPORTER_ASSERT(r, bitmap.readPixels(f16.pixmap()));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (const SkBitmap* src : { &bitmap, &f16 }) {
+        for (SkPngEncoder::FilterFlag filters : { SkPngEncoder::FilterFlag::kAll,
+                                                  SkPngEncoder::FilterFlag::kSub }) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filters;
+            SkDynamicMemoryWStream serialStream, parallelStream;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&serialStream, src->pixmap(), options));
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallelStream, src->pixmap(), options));
+
+            sk_sp<SkData> serial = serialStream.detachAsData();
+            sk_sp<SkData> parallel = parallelStream.detachAsData();
+            REPORTER_ASSERT(r, parallel->size() < serial->size() * 21 / 20,
+                            "%zu vs %zu", parallel->size(), serial->size());
+
+            SkBitmap serialBitmap, parallelBitmap;
+            REPORTER_ASSERT(r, SkImage::MakeFromEncoded(serial)->asLegacyBitmap(&serialBitmap));
+            REPORTER_ASSERT(r,
+                    SkImage::MakeFromEncoded(parallel)->asLegacyBitmap(&parallelBitmap));
+            REPORTER_ASSERT(r, almost_equals(serialBitmap, parallelBitmap, 0));
+        }
+    }
+}
+
+DEF_TEST(Encode_JpegParallel, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+        return;
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (SkJpegEncoder::Downsample downsample : { SkJpegEncoder::Downsample::k420,
+                                                  SkJpegEncoder::Downsample::k422,
+                                                  SkJpegEncoder::Downsample::k444 }) {
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        options.fDownsample = downsample;
+        SkDynamicMemoryWStream serialStream, parallelStream;
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&serialStream, bitmap.pixmap(), options));
+        options.fExecutor = executor.get();
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&parallelStream, bitmap.pixmap(), options));
+
+        sk_sp<SkData> serial = serialStream.detachAsData();
+        sk_sp<SkData> parallel = parallelStream.detachAsData();
+        REPORTER_ASSERT(r, parallel->size() < serial->size() * 11 / 10,
+                        "%zu vs %zu", parallel->size(), serial->size());
+
+        // Only the entropy coding differs, so both decode to the same pixels.
+        SkBitmap serialBitmap, parallelBitmap;
+        REPORTER_ASSERT(r, SkImage::MakeFromEncoded(serial)->asLegacyBitmap(&serialBitmap));
+        REPORTER_ASSERT(r, SkImage::MakeFromEncoded(parallel)->asLegacyBitmap(&parallelBitmap));
+        REPORTER_ASSERT(r, almost_equals(serialBitmap, parallelBitmap, 0));
+    }
+}
+
 DEF_TEST(Encode_WebpOptions, r) {
     SkBitmap bitmap;
     bool success = GetResourceAsBitmap("images/google_chrome.ico", &bitmap);
@@ -94,3 +94,45 @@ DEF_TEST(UnflattenWithCustomFactory, r) {
     REPORTER_ASSERT(r, 6 == out3->c());
     REPORTER_ASSERT(r, 7 == out3->d());
 }
+
+class OtherIntFlattenable : public IntFlattenable {
+public:
+    OtherIntFlattenable(uint32_t a) : IntFlattenable(a, a, a, a) {}
+
+    const char* getTypeName() const override { return "OtherIntFlattenable"; }
+};
+
+static sk_sp<SkFlattenable> other_create_proc(SkReadBuffer& buffer) {
+    uint32_t a = buffer.readUInt();
+    buffer.readUInt();
+    buffer.readUInt();
+    buffer.readUInt();
+    return sk_sp<SkFlattenable>(new IntFlattenable(a, 0, 0, 0));
+}
+
+DEF_TEST(UnflattenInterleavedNames, r) {
+    SkBinaryWriteBuffer writeBuffer;
+    writeBuffer.writeFlattenable(sk_make_sp<IntFlattenable>(1, 0, 0, 0).get());
+    writeBuffer.writeFlattenable(sk_make_sp<OtherIntFlattenable>(2).get());
+    size_t namesWritten = writeBuffer.bytesWritten();
+    writeBuffer.writeFlattenable(sk_make_sp<OtherIntFlattenable>(3).get());
+    writeBuffer.writeFlattenable(sk_make_sp<IntFlattenable>(4, 0, 0, 0).get());
+    writeBuffer.writeFlattenable(sk_make_sp<OtherIntFlattenable>(5).get());
+
+    // Names already written are referred to by index: 4 bytes each, plus the size and the data.
+    REPORTER_ASSERT(r, namesWritten + 3 * (4 + 4 + 16) == writeBuffer.bytesWritten());
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(writeBuffer.bytesWritten());
+    writeBuffer.writeToMemory(data->writable_data());
+    SkReadBuffer readBuffer(data->data(), data->size());
+    readBuffer.setCustomFactory(SkString("IntFlattenable"), &custom_create_proc);
+    readBuffer.setCustomFactory(SkString("OtherIntFlattenable"), &other_create_proc);
+
+    // IntFlattenables come back incremented, OtherIntFlattenables as they were.
+    for (uint32_t expected : { 2, 2, 3, 5, 5 }) {
+        sk_sp<IntFlattenable> out((IntFlattenable*) readBuffer.readFlattenable(
+                SkFlattenable::kSkUnused_Type));
+        REPORTER_ASSERT(r, out && expected == out->a());
+    }
+    REPORTER_ASSERT(r, readBuffer.isValid());
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+#include "Test.h"
+
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "GrResourceProvider.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+
+#if GR_GPU_STATS
+
+static void draw_rect(SkSurface* surface, SkColor color) {
+    SkPaint paint;
+    paint.setColor(color);
+    surface->getCanvas()->drawRect(SkRect::MakeWH(8, 8), paint);
+}
+
+static int flush_and_count_draws(GrContext* context) {
+    context->contextPriv().resetGpuStats();
+    context->flush();
+    return context->contextPriv().getGpu()->stats()->numDraws();
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(FlushPriority, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    SkImageInfo info = SkImageInfo::MakeN32Premul(8, 8);
+    sk_sp<SkSurface> background = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    sk_sp<SkSurface> critical = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!background || !critical) {
+        return;
+    }
+    background->getCanvas()->clear(SK_ColorWHITE);
+    critical->getCanvas()->clear(SK_ColorWHITE);
+    context->flush();
+
+    // Any flush takes longer than a microsecond, so this budget runs out before the background
+    // work gets its turn.
+    bool mayDefer = !context->contextPriv().resourceProvider()->explicitlyAllocateGPUResources();
+    context->setFlushTimeBudget(1);
+
+    context->setWorkPriority(GrContext::WorkPriority::kBackground);
+    REPORTER_ASSERT(reporter, GrContext::WorkPriority::kBackground == context->workPriority());
+    draw_rect(background.get(), SK_ColorRED);
+    context->setWorkPriority(GrContext::WorkPriority::kCritical);
+    draw_rect(critical.get(), SK_ColorGREEN);
+
+    REPORTER_ASSERT(reporter, flush_and_count_draws(context) == (mayDefer ? 1 : 2));
+
+    // Deferred work is issued by the next flush that has the time for it.
+    context->setFlushTimeBudget(0);
+    REPORTER_ASSERT(reporter, flush_and_count_draws(context) == (mayDefer ? 1 : 0));
+    REPORTER_ASSERT(reporter, flush_and_count_draws(context) == 0);
+
+    // Reading a surface back issues its deferred work, whatever the budget.
+    context->setFlushTimeBudget(1);
+    context->setWorkPriority(GrContext::WorkPriority::kBackground);
+    draw_rect(background.get(), SK_ColorBLUE);
+    context->setWorkPriority(GrContext::WorkPriority::kCritical);
+    draw_rect(critical.get(), SK_ColorRED);
+    context->flush();
+
+    SkBitmap bitmap;
+    bitmap.allocPixels(info);
+    REPORTER_ASSERT(reporter, background->readPixels(bitmap, 0, 0));
+    REPORTER_ASSERT(reporter, bitmap.getColor(4, 4) == SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, critical->readPixels(bitmap, 0, 0));
+    REPORTER_ASSERT(reporter, bitmap.getColor(4, 4) == SK_ColorRED);
+
+    context->setFlushTimeBudget(0);
+}
+
+#endif
@@ -713,6 +713,26 @@ static void test_matchStyleCSS3(skiatest::Reporter* reporter) {
     }
 }
 
+static void test_match_characters(skiatest::Reporter* reporter) {
+    sk_sp<SkFontMgr> fm(SkFontMgr::RefDefault());
+    const SkUnichar characters[] = { 'H', 'e', 'l', 'l', 'o', 0x4E2D, 0x1F600, 'H' };
+    constexpr int count = SK_ARRAY_COUNT(characters);
+    sk_sp<SkTypeface> typefaces[count];
+    fm->matchFamilyStyleCharacters(nullptr, SkFontStyle(), nullptr, 0,
+                                   characters, count, typefaces);
+
+    for (int i = 0; i < count; ++i) {
+        if (typefaces[i]) {
+            SkGlyphID glyph = 0;
+            typefaces[i]->charsToGlyphs(&characters[i], SkTypeface::kUTF32_Encoding, &glyph, 1);
+            REPORTER_ASSERT(reporter, glyph != 0);
+        }
+    }
+    // A typeface found for one character is reused for the others it has.
+    REPORTER_ASSERT(reporter, typefaces[2] == typefaces[3]);
+    REPORTER_ASSERT(reporter, typefaces[0] == typefaces[count - 1]);
+}
+
 DEFINE_bool(verboseFontMgr, false, "run verbose fontmgr tests.");
 
 DEF_TEST(FontMgr, reporter) {
@@ -721,4 +741,5 @@ DEF_TEST(FontMgr, reporter) {
     test_fontiter(reporter, FLAGS_verboseFontMgr);
     test_alias_names(reporter);
     test_font(reporter);
+    test_match_characters(reporter);
 }
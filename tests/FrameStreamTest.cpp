@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkFrameStream.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRRect.h"
+#include "SkTextBlob.h"
+#include "SkVertices.h"
+#include "Test.h"
+
+static sk_sp<SkPicture> make_frame(SkScalar dx) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+
+    SkPaint red, stroke;
+    red.setColor(SK_ColorRED);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(3);
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.lineTo(60, 20);
+    path.quadTo(80, 80, 20, 70);
+
+    canvas->save();
+        canvas->translate(dx, 0);
+        canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeWH(90, 90)), true);
+        canvas->drawRect(SkRect::MakeXYWH(5, 5, 40, 40), red);
+        canvas->drawPath(path, stroke);
+        canvas->drawPath(path, red);
+    canvas->restore();
+
+    SkPaint text;
+    text.setTextSize(12);
+    SkTextBlobBuilder builder;
+    const auto& run = builder.allocRun(text, 2, 0, 0);
+    text.textToGlyphs("ok", 2, run.glyphs);
+    canvas->drawTextBlob(builder.make(), 20, 90, text);
+
+    // Not one of the ops with its own encoding.
+    SkPoint pts[] = {{0, 0}, {10, 20}, {40, 5}};
+    canvas->drawVertices(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, 3, pts,
+                                              nullptr, nullptr),
+                         SkBlendMode::kSrcOver, red);
+
+    return recorder.finishRecordingAsPicture();
+}
+
+static SkBitmap draw(const SkPicture* picture) {
+    SkBitmap bm;
+    bm.allocN32Pixels(100, 100);
+    bm.eraseColor(SK_ColorWHITE);
+    SkCanvas(bm).drawPicture(picture);
+    return bm;
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+}
+
+DEF_TEST(FrameStream, r) {
+    SkFrameStreamWriter writer;
+    SkFrameStreamReader reader;
+
+    sk_sp<SkPicture> src[] = { make_frame(0), make_frame(0), make_frame(5) };
+    sk_sp<SkData> frames[3];
+    SkFrameStreamWriter::Stats stats[3];
+    for (int i = 0; i < 3; i++) {
+        frames[i] = writer.writeFrame(src[i].get(), &stats[i]);
+    }
+
+    REPORTER_ASSERT(r, stats[0].fDefinitions > 0);
+    REPORTER_ASSERT(r, stats[0].fFallbackOps == 1);
+    // The paints and path are reused within the first frame...
+    REPORTER_ASSERT(r, stats[0].fReferences > 0);
+    // ...and the second and third frames are entirely made of what the first one defined.
+    REPORTER_ASSERT(r, stats[1].fDefinitions == 0);
+    REPORTER_ASSERT(r, stats[2].fDefinitions == 0);
+    REPORTER_ASSERT(r, frames[1]->size() < frames[0]->size());
+
+    for (int i = 0; i < 3; i++) {
+        sk_sp<SkPicture> dst = reader.readFrame(frames[i]->data(), frames[i]->size());
+        REPORTER_ASSERT(r, dst);
+        if (dst) {
+            REPORTER_ASSERT(r, same_pixels(draw(src[i].get()), draw(dst.get())));
+        }
+    }
+
+    // Replaying a frame is out of sequence, and fails the reader until the writer resets.
+    REPORTER_ASSERT(r, !reader.readFrame(frames[1]->data(), frames[1]->size()));
+    sk_sp<SkData> next = writer.writeFrame(src[0].get());
+    REPORTER_ASSERT(r, !reader.readFrame(next->data(), next->size()));
+
+    writer.reset();
+    next = writer.writeFrame(src[2].get(), &stats[0]);
+    REPORTER_ASSERT(r, stats[0].fDefinitions > 0);
+    sk_sp<SkPicture> dst = reader.readFrame(next->data(), next->size());
+    REPORTER_ASSERT(r, dst);
+    if (dst) {
+        REPORTER_ASSERT(r, same_pixels(draw(src[2].get()), draw(dst.get())));
+    }
+
+    // Truncated frames are rejected.
+    next = writer.writeFrame(src[0].get());
+    REPORTER_ASSERT(r, !reader.readFrame(next->data(), next->size() - 8));
+}
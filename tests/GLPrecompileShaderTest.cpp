@@ -0,0 +1,144 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#include "GrContextFactory.h"
+#include "GrContextOptions.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "GrShaderCapture.h"
+#include "MemoryCache.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkGradientShader.h"
+#include "SkSurface.h"
+#include "Test.h"
+#include "gl/GrGLCaps.h"
+
+using sk_gpu_test::GrContextFactory;
+
+static bool draw(GrContext* context, SkBitmap* result) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(32, 32);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return false;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    const SkPoint pts[] = { { 0, 0 }, { 32, 32 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    canvas->drawCircle(16, 16, 12, paint);
+    result->allocPixels(info);
+    return surface->readPixels(*result, 0, 0);
+}
+
+DEF_GPUTEST_FOR_GL_RENDERING_CONTEXTS(GLPrecompileShader, reporter, ctxInfo) {
+    auto glCaps = static_cast<const GrGLCaps*>(ctxInfo.grContext()->contextPriv().caps());
+    if (!glCaps->programBinarySupport()) {
+        return;
+    }
+
+    sk_gpu_test::MemoryCache cache;
+    GrContextOptions options(ctxInfo.options());
+    options.fPersistentCache = &cache;
+
+    SkBitmap cold;
+    {
+        GrContextFactory factory(options);
+        GrContext* context = factory.get(ctxInfo.type());
+        REPORTER_ASSERT(reporter, context && draw(context, &cold));
+    }
+
+    GrContextFactory factory(options);
+    GrContext* context = factory.get(ctxInfo.type());
+    REPORTER_ASSERT(reporter, context);
+    if (!context) {
+        return;
+    }
+    int precompiled = 0;
+    cache.foreach([&](sk_sp<const SkData> key, sk_sp<SkData> data) {
+        if (context->precompileShader(*key, *data)) {
+            ++precompiled;
+        }
+    });
+    REPORTER_ASSERT(reporter, precompiled > 0);
+
+    // Keys that aren't program descs are rejected.
+    const char garbage[] = "not a program";
+    sk_sp<SkData> garbageData = SkData::MakeWithoutCopy(garbage, sizeof(garbage));
+    REPORTER_ASSERT(reporter, !context->precompileShader(*garbageData, *garbageData));
+
+    // The precompiled programs are used as they are, without going back to the cache, and draw the
+    // same as the ones they were cached from.
+    SkBitmap warm;
+    REPORTER_ASSERT(reporter, draw(context, &warm));
+    REPORTER_ASSERT(reporter, cold.computeByteSize() == warm.computeByteSize() &&
+                              !memcmp(cold.getPixels(), warm.getPixels(), cold.computeByteSize()));
+#if GR_GPU_STATS
+    GrGpu::Stats* stats = context->contextPriv().getGpu()->stats();
+    REPORTER_ASSERT(reporter, 0 == stats->persistentCacheHits());
+    REPORTER_ASSERT(reporter, 0 == stats->persistentCacheMisses());
+#endif
+}
+
+DEF_GPUTEST_FOR_GL_RENDERING_CONTEXTS(GLPrecompileCapturedShaders, reporter, ctxInfo) {
+    GrShaderCapture capture;
+    SkBitmap cold;
+    {
+        GrContextFactory factory(ctxInfo.options());
+        GrContext* context = factory.get(ctxInfo.type());
+        REPORTER_ASSERT(reporter, context);
+        if (!context) {
+            return;
+        }
+        context->contextPriv().setShaderCapture(&capture);
+        REPORTER_ASSERT(reporter, draw(context, &cold));
+        context->contextPriv().setShaderCapture(nullptr);
+    }
+    REPORTER_ASSERT(reporter, capture.count() > 0);
+
+    // Round trips through its serialized form, and recording the same programs again is a no-op.
+    sk_sp<SkData> data = capture.serialize();
+    GrShaderCapture copy;
+    REPORTER_ASSERT(reporter, copy.deserialize(*data) && copy.deserialize(*data));
+    REPORTER_ASSERT(reporter, copy.count() == capture.count());
+    for (int i = 0; i < capture.count(); ++i) {
+        const GrShaderCapture::Program& program = capture.program(i);
+        REPORTER_ASSERT(reporter, program.fKey == copy.program(i).fKey);
+        REPORTER_ASSERT(reporter, !program.fSkSL[GrShaderCapture::kFragment_Stage].empty());
+        for (int stage = 0; stage < GrShaderCapture::kStageCount; ++stage) {
+            REPORTER_ASSERT(reporter, program.fSkSL[stage] == copy.program(i).fSkSL[stage]);
+        }
+    }
+    REPORTER_ASSERT(reporter, !copy.deserialize(*SkData::MakeSubset(data.get(), 0,
+                                                                     data->size() - 1)));
+
+    GrContextFactory factory(ctxInfo.options());
+    GrContext* context = factory.get(ctxInfo.type());
+    REPORTER_ASSERT(reporter, context);
+    if (!context) {
+        return;
+    }
+    const char garbage[] = "not a capture";
+    REPORTER_ASSERT(reporter,
+                    -1 == context->precompileShaders(*SkData::MakeWithoutCopy(garbage,
+                                                                            sizeof(garbage))));
+    // Without an executor the shaders are generated before this returns.
+    REPORTER_ASSERT(reporter, capture.count() == context->precompileShaders(*data));
+
+    SkBitmap warm;
+    REPORTER_ASSERT(reporter, draw(context, &warm));
+    REPORTER_ASSERT(reporter, cold.computeByteSize() == warm.computeByteSize() &&
+                              !memcmp(cold.getPixels(), warm.getPixels(), cold.computeByteSize()));
+}
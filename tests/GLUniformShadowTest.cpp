@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static constexpr int kSize = 64;
+static constexpr int kCell = 8;
+
+static void draw(SkCanvas* canvas) {
+    canvas->clear(SK_ColorWHITE);
+
+    // Both gradients use the same program. Runs of one between the other mean the program's
+    // uniforms are sometimes already what the next draw wants, and sometimes not.
+    const SkPoint pts[] = { { 0, 0 }, { kSize, 0 } };
+    const SkColor colorsA[] = { SK_ColorRED, SK_ColorBLUE };
+    const SkColor colorsB[] = { SK_ColorGREEN, SK_ColorYELLOW };
+    sk_sp<SkShader> shaders[] = {
+        SkGradientShader::MakeLinear(pts, colorsA, nullptr, 2, SkShader::kClamp_TileMode),
+        SkGradientShader::MakeLinear(pts, colorsB, nullptr, 2, SkShader::kClamp_TileMode),
+    };
+    const int pattern[] = { 0, 0, 1, 0, 1, 1, 1, 0 };
+    SkPaint paint;
+    int i = 0;
+    for (int y = 0; y < kSize; y += kCell) {
+        for (int x = 0; x < kSize; x += kCell, ++i) {
+            paint.setShader(shaders[pattern[i % SK_ARRAY_COUNT(pattern)]]);
+            canvas->drawRect(SkRect::MakeXYWH(x, y, kCell, kCell), paint);
+            canvas->flush();
+        }
+    }
+}
+
+static bool nearly_equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            SkColor ca = a.getColor(x, y), cb = b.getColor(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (SkTAbs((int)((ca >> shift) & 0xFF) - (int)((cb >> shift) & 0xFF)) > 2) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+DEF_GPUTEST_FOR_GL_RENDERING_CONTEXTS(GLUniformShadowing, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    {
+        SkCanvas canvas(expected);
+        draw(&canvas);
+    }
+
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    REPORTER_ASSERT(reporter, surface);
+    if (!surface) {
+        return;
+    }
+#if GR_GPU_STATS
+    GrGpu::Stats* stats = context->contextPriv().getGpu()->stats();
+    int uploads = stats->uniformUploads();
+    int elided = stats->uniformUploadsElided();
+#endif
+    draw(surface->getCanvas());
+    SkBitmap actual;
+    actual.allocPixels(info);
+    REPORTER_ASSERT(reporter, surface->readPixels(actual, 0, 0));
+    REPORTER_ASSERT(reporter, nearly_equal(expected, actual));
+#if GR_GPU_STATS
+    // The switches between gradients must be uploaded, and the rest of the uniforms needn't be.
+    REPORTER_ASSERT(reporter, stats->uniformUploads() > uploads);
+    REPORTER_ASSERT(reporter, stats->uniformUploadsElided() > elided);
+#endif
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#include "GrCaps.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+struct Timing {
+    const char* fName;
+    uint32_t    fOpListID;
+};
+}
+
+static void record_timing(void* context, const char* name, uint32_t opListID, uint64_t) {
+    static_cast<std::vector<Timing>*>(context)->push_back({name, opListID});
+}
+
+static bool is_op_list(const Timing& timing) {
+    return !strcmp(timing.fName, "RenderTargetOpList") || !strcmp(timing.fName, "TextureOpList");
+}
+
+// Draws, and checks for timings up to 'maxChecks' times until an opList has been reported.
+static bool draw_and_wait(GrContext* context, SkSurface* surface, std::vector<Timing>* timings,
+                          int maxChecks) {
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(4, 4, 16, 16), paint);
+    canvas->flush();
+
+    // Reading the pixels back waits on the GPU, so the timestamps are soon available after it.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    for (int i = 0; i < maxChecks; ++i) {
+        surface->readPixels(bitmap, 0, 0);
+        context->checkAsyncWorkCompletion();
+        for (const Timing& timing : *timings) {
+            if (is_op_list(timing)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(GpuTiming, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    std::vector<Timing> timings;
+    if (!context->setGpuTiming(GrContext::GpuTimingLevel::kOps, record_timing, &timings)) {
+        REPORTER_ASSERT(reporter, !context->contextPriv().caps()->gpuTimingSupport());
+        return;
+    }
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(32, 32);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    REPORTER_ASSERT(reporter, surface);
+    if (!surface) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, draw_and_wait(context, surface.get(), &timings, 1000));
+
+    // Brackets are reported in the order they began, so each opList comes just before the ops it
+    // ran, and they report its ID.
+    bool sawOp = false;
+    for (size_t i = 0; i < timings.size(); ++i) {
+        if (is_op_list(timings[i])) {
+            for (size_t j = i + 1; j < timings.size() && !is_op_list(timings[j]); ++j) {
+                REPORTER_ASSERT(reporter, timings[j].fOpListID == timings[i].fOpListID);
+                sawOp = true;
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, sawOp);
+
+    // Once timing is off nothing more is reported.
+    REPORTER_ASSERT(reporter,
+                    context->setGpuTiming(GrContext::GpuTimingLevel::kNone, nullptr, nullptr));
+    timings.clear();
+    REPORTER_ASSERT(reporter, !draw_and_wait(context, surface.get(), &timings, 10));
+    REPORTER_ASSERT(reporter, timings.empty());
+}
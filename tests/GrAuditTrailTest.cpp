@@ -0,0 +1,64 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrAuditTrail.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(GrAuditTrail_costs, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    GrAuditTrail* auditTrail = context->contextPriv().getAuditTrail();
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                                           SkImageInfo::MakeN32Premul(64, 64));
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    canvas->flush();
+
+    auditTrail->setCollectCosts(true);
+    {
+        GrAuditTrail::AutoCollectOps collect(auditTrail, 0);
+        SkPaint paint;
+        paint.setColor(0x80FF0000);  // Translucent, so it has to blend with the dst.
+        canvas->drawRect(SkRect::MakeXYWH(8, 8, 16, 16), paint);
+    }
+    canvas->flush();
+
+    SkTArray<GrAuditTrail::OpInfo> infos;
+    auditTrail->getBoundsByClientID(&infos, 0);
+    REPORTER_ASSERT(reporter, 1 == infos.count());
+    if (1 == infos.count()) {
+        const GrAuditTrail::OpCost& cost = infos[0].fCost;
+        REPORTER_ASSERT(reporter, cost.fDraws >= 1);
+        REPORTER_ASSERT(reporter, cost.fReadsDst);
+        REPORTER_ASSERT(reporter, 16 * 16 == cost.fPixels);
+        REPORTER_ASSERT(reporter, cost.fBytes >= 2 * 4 * cost.fPixels);
+
+        GrAuditTrail::Heatmap heatmap;
+        REPORTER_ASSERT(reporter, auditTrail->getHeatmap(infos[0].fProxyUniqueID, &heatmap));
+        const int cellsPerRow = 64 / GrAuditTrail::kHeatmapCellSize;
+        REPORTER_ASSERT(reporter, cellsPerRow == heatmap.fWidth);
+        REPORTER_ASSERT(reporter, cellsPerRow * cellsPerRow == heatmap.fCells.count());
+        // The rect covers cells (1,1) and (2,2) completely and misses (0,0).
+        REPORTER_ASSERT(reporter, heatmap.fCells[0] == 0);
+        REPORTER_ASSERT(reporter, heatmap.fCells[1 * cellsPerRow + 1] >= 2);
+        REPORTER_ASSERT(reporter,
+                        heatmap.fCells[1 * cellsPerRow + 1] == heatmap.fCells[2 * cellsPerRow + 2]);
+    }
+
+    GrAuditTrail::AutoEnable enable(auditTrail);
+    auditTrail->fullReset();
+    auditTrail->setCollectCosts(false);
+}
+
+#endif
@@ -14,14 +14,18 @@
 #include "GrDrawingManager.h"
 #include "GrPathRenderer.h"
 #include "GrPaint.h"
+#include "GrReducedClip.h"
 #include "GrRenderTargetContext.h"
 #include "GrRenderTargetContextPriv.h"
 #include "GrShape.h"
 #include "GrTexture.h"
+#include "SkClipOpPriv.h"
+#include "SkDashPathEffect.h"
 #include "SkMatrix.h"
 #include "SkPathPriv.h"
 #include "SkRect.h"
 #include "sk_tool_utils.h"
+#include "ccpr/GrCCPathCache.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
 #include "mock/GrMockTypes.h"
 
@@ -82,12 +86,6 @@ public:
     void drawPath(const SkPath& path, const SkMatrix& matrix = SkMatrix::I()) const {
         SkASSERT(this->valid());
 
-        GrPaint paint;
-        paint.setColor4f({ 0, 1, 0, 1 });
-
-        GrNoClip noClip;
-        SkIRect clipBounds = SkIRect::MakeWH(kCanvasSize, kCanvasSize);
-
         GrShape shape;
         if (!fDoStroke) {
             shape = GrShape(path);
@@ -99,6 +97,17 @@ public:
             stroke.setStrokeParams(SkPaint::kRound_Cap, SkPaint::kMiter_Join, 4);
             shape = GrShape(path, GrStyle(stroke, nullptr));
         }
+        this->drawShape(shape, matrix);
+    }
+
+    void drawShape(const GrShape& shape, const SkMatrix& matrix = SkMatrix::I()) const {
+        SkASSERT(this->valid());
+
+        GrPaint paint;
+        paint.setColor4f({ 0, 1, 0, 1 });
+
+        GrNoClip noClip;
+        SkIRect clipBounds = SkIRect::MakeWH(kCanvasSize, kCanvasSize);
 
         fCCPR->testingOnly_drawPathDirectly({
                 fCtx, std::move(paint), &GrUserStencilSettings::kUnused, fRTC.get(), &noClip,
@@ -394,6 +403,76 @@ class GrCCPRTest_cache : public CCPRTest {
 };
 DEF_CCPR_TEST(GrCCPRTest_cache)
 
+#if GR_CACHE_STATS
+// This test caches many paths in an atlas, then invalidates most of them so the atlas becomes
+// fragmented. With fCompactPathMaskAtlases, the surviving paths should be copied into a new atlas
+// the next time they are drawn, and drawn from that atlas from then on.
+class GrCCPRTest_compactCache : public CCPRTest {
+    void customizeOptions(GrMockOptions*, GrContextOptions* ctxOptions) override {
+        ctxOptions->fAllowPathMaskCaching = true;
+        ctxOptions->fCompactPathMaskAtlases = true;
+    }
+
+    void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
+        static constexpr int kPathSize = 20;
+        static constexpr int kNumPaths = 500;
+        SkRandom rand;
+
+        SkPath paths[kNumPaths];
+        int primes[11] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31};
+        for (int i = 0; i < kNumPaths; ++i) {
+            int numPts = rand.nextRangeU(GrShape::kMaxKeyFromDataVerbCnt + 1,
+                                         GrShape::kMaxKeyFromDataVerbCnt * 2);
+            paths[i] = sk_tool_utils::make_star(SkRect::MakeIWH(kPathSize, kPathSize), numPts,
+                                                primes[rand.nextU() % SK_ARRAY_COUNT(primes)]);
+        }
+
+        const GrCCPathCache* pathCache = ccpr.ccpr()->pathCache();
+        REPORTER_ASSERT(reporter, pathCache && pathCache->compactsAtlases());
+        if (!pathCache) {
+            return;
+        }
+        const GrCCPathCache::Stats& stats = pathCache->stats();
+
+        // Draw every path three times: it gets stashed after the second flush, and copied into a
+        // cached atlas during the third.
+        SkMatrix matrix = SkMatrix::MakeTrans(5, 5);
+        for (int j = 0; j < 3; ++j) {
+            for (int i = 0; i < kNumPaths; ++i) {
+                ccpr.drawPath(paths[i], matrix);
+            }
+            ccpr.flush();
+        }
+        REPORTER_ASSERT(reporter, 0 == stats.compactedPaths());
+
+        // A subpixel translate invalidates the masks of three quarters of the paths.
+        SkMatrix shiftedMatrix = matrix;
+        shiftedMatrix.preTranslate(.5f, .5f);
+        for (int i = 0; i < kNumPaths; ++i) {
+            if (i % 4) {
+                ccpr.drawPath(paths[i], shiftedMatrix);
+            }
+        }
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 0 == stats.compactedPaths());
+
+        // The surviving paths should move out of their fragmented atlas the next time they are
+        // drawn, and then stay where they are.
+        for (int j = 0; j < 2; ++j) {
+            int hits = stats.hits(), misses = stats.misses();
+            for (int i = 0; i < kNumPaths; i += 4) {
+                ccpr.drawPath(paths[i], matrix);
+            }
+            ccpr.flush();
+            REPORTER_ASSERT(reporter, hits + kNumPaths / 4 == stats.hits());
+            REPORTER_ASSERT(reporter, misses == stats.misses());
+            REPORTER_ASSERT(reporter, kNumPaths / 4 == stats.compactedPaths());
+        }
+    }
+};
+DEF_CCPR_TEST(GrCCPRTest_compactCache)
+#endif
+
 class GrCCPRTest_unrefPerOpListPathsBeforeOps : public CCPRTest {
     void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
         REPORTER_ASSERT(reporter, SkPathPriv::TestingOnly_unique(fPath));
@@ -414,6 +493,90 @@ class GrCCPRTest_unrefPerOpListPathsBeforeOps : public CCPRTest {
 };
 DEF_CCPR_TEST(GrCCPRTest_unrefPerOpListPathsBeforeOps)
 
+// CCPR should take dashed strokes and stroked conics itself, rather than leave them for the
+// stencil-then-cover or software path renderers.
+class GrCCPRTest_dashesAndConics : public CCPRTest {
+    void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
+        SkPath circle;
+        circle.addCircle(kCanvasSize / 2, kCanvasSize / 2, kCanvasSize / 3);
+        REPORTER_ASSERT(reporter, SkPathPriv::ConicWeightCnt(circle));
+
+        const SkScalar intervals[] = {5, 3};
+        sk_sp<SkPathEffect> dash = SkDashPathEffect::Make(intervals, 2, 1);
+
+        SkIRect clipBounds = SkIRect::MakeWH(kCanvasSize, kCanvasSize);
+        for (SkScalar width : {0.f, 4.f}) {
+            for (SkPaint::Join join : {SkPaint::kMiter_Join, SkPaint::kRound_Join,
+                                       SkPaint::kBevel_Join}) {
+                for (SkPaint::Cap cap : {SkPaint::kButt_Cap, SkPaint::kRound_Cap,
+                                         SkPaint::kSquare_Cap}) {
+                    SkStrokeRec stroke(SkStrokeRec::kHairline_InitStyle);
+                    stroke.setStrokeStyle(width);
+                    stroke.setStrokeParams(cap, join, 4);
+                    for (const SkPath& path : {circle, fPath}) {
+                        for (bool doDash : {false, true}) {
+                            GrShape shape(path, GrStyle(stroke, doDash ? dash : nullptr));
+
+                            GrPathRenderer::CanDrawPathArgs args;
+                            args.fCaps = ccpr.ctx()->contextPriv().caps();
+                            args.fClipConservativeBounds = &clipBounds;
+                            args.fViewMatrix = &SkMatrix::I();
+                            args.fShape = &shape;
+                            args.fAAType = GrAAType::kCoverage;
+                            args.fHasUserStencilSettings = false;
+                            REPORTER_ASSERT(reporter, GrPathRenderer::CanDrawPath::kYes ==
+                                                      ccpr.ccpr()->canDrawPath(args));
+
+                            ccpr.drawShape(shape);
+                        }
+                    }
+                }
+            }
+        }
+        ccpr.flush();
+    }
+};
+DEF_CCPR_TEST(GrCCPRTest_dashesAndConics)
+
+class GrCCPRTest_clipMaskPaths : public CCPRTest {
+    void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
+        // A union of AA paths can't be done with analytic FPs, so it would otherwise need a mask.
+        SkClipStack stack;
+        stack.clipPath(fPath, SkMatrix::I(), kIntersect_SkClipOp, true);
+        SkPath circle;
+        circle.addCircle(100, 100, 20);
+        stack.clipPath(circle, SkMatrix::I(), kUnion_SkClipOp, true);
+
+        const GrCaps* caps = fMockContext->contextPriv().caps();
+        SkRect queryBounds = SkRect::MakeIWH(kCanvasSize, kCanvasSize);
+        GrReducedClip reducedClip(stack, queryBounds, caps, 0, 4, 4);
+        REPORTER_ASSERT(reporter, !reducedClip.maskElements().isEmpty());
+        uint32_t maskGenID = reducedClip.maskGenID();
+        SkIRect scissor = reducedClip.scissor();
+        int numAnalyticFPs = reducedClip.numAnalyticFPs();
+
+        REPORTER_ASSERT(reporter, reducedClip.convertMaskElementsToCCPRClipPath(ccpr.ccpr()));
+        REPORTER_ASSERT(reporter, reducedClip.maskElements().isEmpty());
+        REPORTER_ASSERT(reporter, numAnalyticFPs + 1 == reducedClip.numAnalyticFPs());
+        const SkPath* maskPath = ccpr.ccpr()->findClipMaskPath(maskGenID, scissor, numAnalyticFPs);
+        REPORTER_ASSERT(reporter, maskPath);
+
+        // The same clip reuses the cached path.
+        GrReducedClip reducedClip2(stack, queryBounds, caps, 0, 4, 4);
+        REPORTER_ASSERT(reporter, reducedClip2.convertMaskElementsToCCPRClipPath(ccpr.ccpr()));
+        REPORTER_ASSERT(reporter, maskPath == ccpr.ccpr()->findClipMaskPath(maskGenID, scissor,
+                                                                              numAnalyticFPs));
+
+        // Non-AA elements are left for a mask.
+        stack.clipPath(circle, SkMatrix::I(), kXOR_SkClipOp, false);
+        GrReducedClip reducedClip3(stack, queryBounds, caps, 0, 4, 4);
+        REPORTER_ASSERT(reporter, !reducedClip3.maskElements().isEmpty());
+        REPORTER_ASSERT(reporter, !reducedClip3.convertMaskElementsToCCPRClipPath(ccpr.ccpr()));
+        REPORTER_ASSERT(reporter, !reducedClip3.maskElements().isEmpty());
+    }
+};
+DEF_CCPR_TEST(GrCCPRTest_clipMaskPaths)
+
 class CCPRRenderingTest {
 public:
     void run(skiatest::Reporter* reporter, GrContext* ctx, bool doStroke) const {
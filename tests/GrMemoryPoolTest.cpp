@@ -11,6 +11,11 @@
 #include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTemplates.h"
+#include "SkTaskGroup.h"
+
+#if SK_SUPPORT_GPU
+#include "GrProcessor.h"
+#endif
 
 // A is the top of an inheritance tree of classes that overload op new and
 // and delete to use a GrMemoryPool. The objects have values of different types
@@ -318,3 +323,46 @@ DEF_TEST(GrMemoryPoolAPI, reporter) {
         REPORTER_ASSERT(reporter, pool.size() == hugeBlockSize + kMinAllocSize);
     }
 }
+
+#if SK_SUPPORT_GPU
+
+namespace {
+class TestProcessor : public GrProcessor {
+public:
+    TestProcessor(int value) : INHERITED(kTestFP_ClassID), fValue(value) {}
+    const char* name() const override { return "TestProcessor"; }
+    int value() const { return fValue; }
+
+private:
+    int fValue;
+
+    typedef GrProcessor INHERITED;
+};
+}
+
+// Processors come from pools picked by the allocating thread, but may be freed on any thread.
+DEF_TEST(GrMemoryPoolProcessorsAcrossThreads, reporter) {
+    static constexpr int kThreads = 8;
+    static constexpr int kPerThread = 256;
+    TestProcessor* processors[kThreads * kPerThread];
+    SkTaskGroup().batch(kThreads, [&](int thread) {
+        for (int i = 0; i < kPerThread; ++i) {
+            int index = thread * kPerThread + i;
+            processors[index] = new TestProcessor(index);
+        }
+    });
+    bool allMatch = true;
+    for (int i = 0; i < kThreads * kPerThread; ++i) {
+        allMatch &= processors[i]->value() == i;
+    }
+    REPORTER_ASSERT(reporter, allMatch);
+    // Free each thread's processors on some other thread.
+    SkTaskGroup().batch(kThreads, [&](int thread) {
+        int other = (thread + 1) % kThreads;
+        for (int i = 0; i < kPerThread; ++i) {
+            delete processors[other * kPerThread + i];
+        }
+    });
+}
+
+#endif
@@ -2332,3 +2332,48 @@ DEF_TEST(GrShape_arcs, reporter) {
         ovalArcWithCenter.compare(reporter, oval, ovalExpectations);
     }
 }
+
+DEF_TEST(GrShape_styled_shape_cache, r) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.cubicTo(50, 100, 100, -50, 150, 50);
+    path.lineTo(20, 80);
+    static constexpr SkScalar kIntervals[] = { 4.f, 3.f };
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3.f);
+    paint.setPathEffect(SkDashPathEffect::Make(kIntervals, 2, 0.f));
+
+    auto styledPath = [&](const SkPath& src, SkScalar scale) {
+        GrShape styled = GrShape(src, paint).applyStyle(GrStyle::Apply::kPathEffectAndStrokeRec,
+                                                       scale);
+        REPORTER_ASSERT(r, styled.testingOnly_isPath());
+        if (!src.isVolatile()) {
+            REPORTER_ASSERT(r, src.getGenerationID() ==
+                               styled.testingOnly_getOriginalGenerationID());
+        }
+        SkPath out;
+        styled.asPath(&out);
+        return out;
+    };
+
+    // Styling the same keyed path twice reuses the first result, path data and all.
+    SkPath a = styledPath(path, 1.f);
+    SkPath b = styledPath(path, 1.f);
+    REPORTER_ASSERT(r, a == b);
+    REPORTER_ASSERT(r, a.getGenerationID() == b.getGenerationID());
+
+    // A different scale is a different key.
+    REPORTER_ASSERT(r, a.getGenerationID() != styledPath(path, 2.f).getGenerationID());
+
+    // So is an edited path, even though its previous results are still cached.
+    SkPath edited = path;
+    edited.lineTo(0, 100);
+    REPORTER_ASSERT(r, a.getGenerationID() != styledPath(edited, 1.f).getGenerationID());
+
+    // Volatile paths have no key, so they are styled every time.
+    SkPath volatilePath = path;
+    volatilePath.setIsVolatile(true);
+    REPORTER_ASSERT(r, styledPath(volatilePath, 1.f).getGenerationID() !=
+                       styledPath(volatilePath, 1.f).getGenerationID());
+}
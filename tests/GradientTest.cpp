@@ -5,10 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "../src/jumper/SkJumper.h"
+#include "SkArenaAlloc.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkColorShader.h"
 #include "SkGradientShader.h"
+#include "SkGradientShaderPriv.h"
+#include "SkRasterPipeline.h"
 #include "SkShader.h"
 #include "SkSurface.h"
 #include "SkTemplates.h"
@@ -538,6 +542,62 @@ static void test_sweep_fuzzer(skiatest::Reporter*) {
     }
 }
 
+// Gradients with many arbitrarily spaced stops are resampled into evenly spaced intervals on
+// raster; that should be indistinguishable from searching for each pixel's stops.
+static void test_many_stops(skiatest::Reporter* reporter) {
+    SkColor colors[20];
+    SkScalar pos[20];
+    for (int i = 0; i < 20; ++i) {
+        colors[i] = SkColorSetARGB(255 - i * 4, i * 13, 255 - i * 11, 64 + i * 9);
+        pos[i] = (i + (i % 2 ? 0.25f : 0)) / 19;
+    }
+    pos[19] = 1;
+
+    auto draw = [&](SkShader::TileMode mode, int maxSearchedStops, uint32_t* pixels) {
+        sk_sp<SkShader> shader = SkGradientShader::MakeRadial({3, 0}, 506, colors, pos, 20, mode);
+        SkSTArenaAlloc<1024> alloc;
+        SkRasterPipeline p(&alloc);
+        SkPaint paint;
+        SkShaderBase::StageRec rec = { &p, &alloc, nullptr, paint, nullptr, SkMatrix::I() };
+        REPORTER_ASSERT(reporter, static_cast<SkGradientShaderBase*>(shader.get())
+                                      ->appendStagesSearchingUpTo(rec, maxSearchedStops));
+        SkJumper_MemoryCtx store = { pixels, 0 };
+        p.append(SkRasterPipeline::store_8888, &store);
+        p.run(0, 0, 1024, 1);
+    };
+
+    auto max_diff = [&](SkShader::TileMode mode) {
+        uint32_t resampled[1024], searched[1024];
+        draw(mode, SkGradientShaderBase::kMaxSearchedStops, resampled);
+        draw(mode, SK_MaxS32, searched);
+        int maxDiff = 0;
+        for (int x = 0; x < 1024; ++x) {
+            uint32_t a = resampled[x],
+                     b = searched[x];
+            for (int shift = 0; shift < 32; shift += 8) {
+                maxDiff = SkTMax(maxDiff, SkAbs32((int)((a >> shift) & 0xFF) -
+                                                  (int)((b >> shift) & 0xFF)));
+            }
+        }
+        return maxDiff;
+    };
+
+    const SkShader::TileMode modes[] = {SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode,
+                                        SkShader::kMirror_TileMode, SkShader::kDecal_TileMode};
+    for (SkShader::TileMode mode : modes) {
+        int maxDiff = max_diff(mode);
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "tile mode %d: max diff %d", mode, maxDiff);
+    }
+
+    // A hard stop can't be resampled, so those gradients keep searching.
+    pos[10] = pos[9];
+    for (SkShader::TileMode mode : modes) {
+        int maxDiff = max_diff(mode);
+        REPORTER_ASSERT(reporter, maxDiff == 0, "hard stop, tile mode %d: max diff %d", mode,
+                        maxDiff);
+    }
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
@@ -551,4 +611,5 @@ DEF_TEST(Gradient, reporter) {
     test_degenerate_linear(reporter);
     test_linear_fuzzer(reporter);
     test_sweep_fuzzer(reporter);
+    test_many_stops(reporter);
 }
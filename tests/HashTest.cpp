@@ -6,8 +6,10 @@
  */
 
 #include "SkChecksum.h"
+#include "SkRandom.h"
 #include "SkRefCnt.h"
 #include "SkString.h"
+#include "SkTFlatHash.h"
 #include "SkTHash.h"
 #include "Test.h"
 
@@ -177,3 +179,81 @@ DEF_TEST(HashSetCopyCounter, r) {
     // We allow copies for same-value adds for now.
     REPORTER_ASSERT(r, globalCounter == 5);
 }
+
+namespace {
+
+template <uint32_t (*HashFn)(int)>
+struct FlatEntry {
+    int      key;
+    SkString val;
+
+    static int GetKey(const FlatEntry& e) { return e.key; }
+    static uint32_t Hash(int key) { return HashFn(key); }
+};
+
+uint32_t good_hash(int key) { return SkChecksum::Mix(key); }
+uint32_t bad_hash(int key) { return key % 7; }  // Lots of collisions in both H1 and H2.
+
+template <uint32_t (*HashFn)(int)>
+void test_flat_hash(skiatest::Reporter* r) {
+    using Entry = FlatEntry<HashFn>;
+    SkTFlatHashTable<Entry, int, Entry> table;
+    SkTHashMap<int, SkString> reference;
+
+    REPORTER_ASSERT(r, !table.find(0));
+
+    // Adds, overwrites and removes, checked against SkTHashMap.
+    SkRandom rand;
+    for (int i = 0; i < 5000; i++) {
+        const int key = rand.nextULessThan(500);
+        switch (rand.nextULessThan(3)) {
+            case 0:
+            case 1: {
+                SkString val = SkStringPrintf("%d-%d", key, i);
+                Entry* e = table.set({key, val});
+                REPORTER_ASSERT(r, e->key == key && e->val == val);
+                reference.set(key, val);
+                break;
+            }
+            case 2:
+                if (reference.find(key)) {
+                    table.remove(key);
+                    reference.remove(key);
+                }
+                break;
+        }
+        REPORTER_ASSERT(r, table.count() == reference.count());
+    }
+
+    for (int key = 0; key < 500; key++) {
+        const Entry* e = table.find(key);
+        const SkString* val = reference.find(key);
+        REPORTER_ASSERT(r, SkToBool(e) == SkToBool(val));
+        if (e && val) {
+            REPORTER_ASSERT(r, e->val == *val);
+        }
+    }
+
+    int n = 0;
+    const auto& constTable = table;
+    constTable.foreach([&](const Entry& e) {
+        REPORTER_ASSERT(r, reference.find(e.key));
+        n++;
+    });
+    REPORTER_ASSERT(r, n == reference.count());
+
+    SkTFlatHashTable<Entry, int, Entry> moved = std::move(table);
+    REPORTER_ASSERT(r, table.count() == 0 && !table.find(0));
+    REPORTER_ASSERT(r, moved.count() == reference.count());
+
+    moved.reset();
+    REPORTER_ASSERT(r, moved.count() == 0);
+    REPORTER_ASSERT(r, moved.approxBytesUsed() == 0);
+}
+
+}  // namespace
+
+DEF_TEST(FlatHashTable, r) {
+    test_flat_hash<good_hash>(r);
+    test_flat_hash<bad_hash>(r);
+}
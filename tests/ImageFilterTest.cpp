@@ -7,6 +7,7 @@
 
 #include "SkArithmeticImageFilter.h"
 #include "SkBitmap.h"
+#include "SkBitmapDevice.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
 #include "SkColorFilterImageFilter.h"
@@ -1615,6 +1616,109 @@ DEF_TEST(ImageFilterCanComputeFastBounds, reporter) {
     REPORTER_ASSERT(reporter, !forceOpaque->canComputeFastBounds());
 }
 
+static SkBitmap draw_filter_dag(int tileSize) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(700, 600);
+    sk_sp<SkBitmapDevice> device(SkBitmapDevice::Create(info));
+    device->setImageFilterTileSize(tileSize);
+    SkCanvas canvas(device);
+    canvas.clear(SK_ColorWHITE);
+
+    // The blur is shared by all three inputs of the merge.
+    sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(8, 8, nullptr));
+    sk_sp<SkImageFilter> inputs[] = {
+        blur,
+        SkOffsetImageFilter::Make(30, -20, blur),
+        make_grayscale(blur, nullptr),
+    };
+    SkPaint paint;
+    paint.setImageFilter(SkMergeImageFilter::Make(inputs, SK_ARRAY_COUNT(inputs)));
+    paint.setColor(SK_ColorBLUE);
+
+    canvas.drawRect(SkRect::MakeLTRB(50, 50, 650, 550), paint);
+    canvas.drawCircle(130, 130, 100, paint);
+
+    SkBitmap bitmap;
+    bitmap.allocPixels(info);
+    canvas.readPixels(bitmap, 0, 0);
+    return bitmap;
+}
+
+DEF_TEST(ImageFilterDrawInTiles, reporter) {
+    SkPoint3 location = SkPoint3::Make(0, 0, SK_Scalar1);
+    sk_sp<SkImageFilter> lighting(SkLightingImageFilter::MakePointLitDiffuse(location,
+                                                                             SK_ColorGREEN,
+                                                                             0, 0, nullptr));
+    REPORTER_ASSERT(reporter, !lighting->canFilterInTiles());
+    sk_sp<SkImageFilter> blurredLighting(SkBlurImageFilter::Make(1, 1, std::move(lighting)));
+    REPORTER_ASSERT(reporter, !blurredLighting->canFilterInTiles());
+
+    // Tiles that don't divide the clip evenly, and small enough that the blur reads far into
+    // the neighbouring tiles.
+    SkBitmap whole = draw_filter_dag(0);
+    SkBitmap tiled = draw_filter_dag(96);
+    for (int y = 0; y < whole.height(); ++y) {
+        if (memcmp(whole.getAddr32(0, y), tiled.getAddr32(0, y), whole.width() * 4)) {
+            ERRORF(reporter, "Tiled filtering differs in row %d", y);
+            break;
+        }
+    }
+}
+
+// A crop rect stops a color filter from being fused into the filter that uses it.
+static sk_sp<SkImageFilter> make_pointwise_dag(int which, bool fused) {
+    const SkImageFilter::CropRect everything(SkRect::MakeLTRB(-1000, -1000, 1000, 1000));
+    const SkImageFilter::CropRect* crop = fused ? nullptr : &everything;
+    sk_sp<SkImageFilter> gray(make_grayscale(nullptr, crop));
+    sk_sp<SkImageFilter> blue(make_blue(SkOffsetImageFilter::Make(10, 5, nullptr), crop));
+    switch (which) {
+        case 0:
+            return SkXfermodeImageFilter::Make(SkBlendMode::kMultiply, gray, blue, nullptr);
+        case 1:
+            return SkArithmeticImageFilter::Make(0.5f, 0.25f, 0.5f, 0, true, gray, blue, nullptr);
+        default: {
+            sk_sp<SkImageFilter> inputs[] = { gray, blue };
+            return SkMergeImageFilter::Make(inputs, SK_ARRAY_COUNT(inputs));
+        }
+    }
+}
+
+DEF_TEST(ImageFilterFusedColorFilters, reporter) {
+    SkPaint shapePaint;
+    const SkPoint pts[] = {{0, 0}, {100, 100}};
+    const SkColor colors[] = {SK_ColorRED, 0x8000FF00, SK_ColorYELLOW};
+    shapePaint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                      SkShader::kClamp_TileMode));
+
+    for (int which = 0; which < 3; ++which) {
+        SkBitmap results[2];
+        for (int fused = 0; fused < 2; ++fused) {
+            results[fused].allocN32Pixels(100, 100);
+            SkCanvas canvas(results[fused]);
+            canvas.clear(SK_ColorTRANSPARENT);
+            SkPaint paint;
+            paint.setImageFilter(make_pointwise_dag(which, fused));
+            canvas.saveLayer(nullptr, &paint);
+            canvas.drawCircle(50, 50, 40, shapePaint);
+            canvas.restore();
+        }
+        // Skipping the intermediate image only saves a rounding step.
+        for (int y = 0; y < 100; ++y) {
+            for (int x = 0; x < 100; ++x) {
+                SkPMColor a = *results[0].getAddr32(x, y),
+                          b = *results[1].getAddr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    int diff = SkTAbs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF));
+                    if (diff > 1) {
+                        ERRORF(reporter, "Fused filter %d differs at %d,%d: %08x vs %08x",
+                               which, x, y, a, b);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
 // Verify that SkImageSource survives serialization
 DEF_TEST(ImageFilterImageSourceSerialization, reporter) {
     auto surface(SkSurface::MakeRasterN32Premul(10, 10));
@@ -10,6 +10,7 @@
 #include "SkGraphics.h"
 #include "SkImageGenerator.h"
 #include "SkImageInfoPriv.h"
+#include "SkMakeUnique.h"
 #include "Test.h"
 
 #if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
@@ -127,3 +128,96 @@ DEF_TEST(PictureImageGenerator, reporter) {
     }
 }
 
+
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "SkSurface.h"
+
+struct ReleasedTexture {
+    GrGpu*           fGpu;
+    GrBackendTexture fTexture;
+    int*             fReleaseCount;
+};
+
+static void release_texture(SkImage::ReleaseContext context) {
+    ReleasedTexture* released = static_cast<ReleasedTexture*>(context);
+    released->fGpu->deleteTestingOnlyBackendTexture(released->fTexture);
+    (*released->fReleaseCount)++;
+    delete released;
+}
+
+// Stands in for a hardware decoder: the only way to get its pixels is as Y, U and V planes in
+// textures, which it makes itself.
+class YUVATextureGenerator : public SkImageGenerator {
+public:
+    static constexpr int kSize = 16;
+    static constexpr uint8_t kY = 0x80;
+
+    YUVATextureGenerator(int* releaseCount)
+        : SkImageGenerator(SkImageInfo::MakeN32(kSize, kSize, kOpaque_SkAlphaType))
+        , fReleaseCount(releaseCount) {}
+
+protected:
+    bool onGetYUVATextures(GrContext* ctx, YUVATextures* textures) override {
+        GrGpu* gpu = ctx->contextPriv().getGpu();
+        SkBitmap plane;
+        plane.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+        for (int i = 0; i < 3; ++i) {
+            // Neutral chroma, so the pixels are gray.
+            memset(plane.getPixels(), 0 == i ? kY : 0x80, plane.computeByteSize());
+            GrBackendTexture texture = gpu->createTestingOnlyBackendTexture(
+                    plane.getPixels(), kSize, kSize, kAlpha_8_SkColorType, false,
+                    GrMipMapped::kNo, plane.rowBytes());
+            textures->fTextures[i] = texture;
+            textures->fIndices[i] = { i, SkColorChannel::kA };
+            textures->fReleaseContexts[i] = new ReleasedTexture{ gpu, texture, fReleaseCount };
+        }
+        textures->fIndices[SkYUVAIndex::kA_Index] = { -1, SkColorChannel::kA };
+        textures->fYUVColorSpace = kJPEG_SkYUVColorSpace;
+        textures->fReleaseProc = release_texture;
+        return true;
+    }
+
+private:
+    int* fReleaseCount;
+};
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageGenerator_YUVATextures, reporter, ctxInfo) {
+    GrContext* ctx = ctxInfo.grContext();
+    const int kSize = YUVATextureGenerator::kSize;
+    int releaseCount = 0;
+    {
+        sk_sp<SkImage> image = SkImage::MakeFromGenerator(
+                skstd::make_unique<YUVATextureGenerator>(&releaseCount));
+        SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+        sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(ctx, SkBudgeted::kNo, info);
+        REPORTER_ASSERT(reporter, image && surface);
+        if (!image || !surface) {
+            return;
+        }
+        surface->getCanvas()->clear(SK_ColorBLUE);
+        surface->getCanvas()->drawImage(image, 0, 0);
+
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        REPORTER_ASSERT(reporter, surface->readPixels(bitmap, 0, 0));
+        bool gray = true;
+        for (int y = 0; y < kSize && gray; ++y) {
+            for (int x = 0; x < kSize && gray; ++x) {
+                SkColor color = bitmap.getColor(x, y);
+                for (int channel : { SkColorGetR(color), SkColorGetG(color), SkColorGetB(color) }) {
+                    gray = gray && SkTAbs(channel - YUVATextureGenerator::kY) <= 2;
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, gray);
+    }
+
+    // The planes were only needed to make the image's RGBA texture.
+    ctx->flush();
+    ctx->contextPriv().getGpu()->testingOnly_flushGpuAndSync();
+    REPORTER_ASSERT(reporter, 3 == releaseCount);
+}
+#endif
@@ -32,6 +32,7 @@
 #include "sk_pixel_iter.h"
 #include "sk_tool_utils.h"
 
+#include "GrCaps.h"
 #include "GrContextPriv.h"
 #include "GrGpu.h"
 #include "GrResourceCache.h"
@@ -513,6 +514,47 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(GrContext_colorTypeSupportedAsImage, reporter
     }
 }
 
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkImage_MakeFromCompressed, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    // 6x5 needs 2x2 blocks. Each one is in differential mode with a base of pure red and every
+    // pixel at the smallest positive modifier, so the whole image decodes to (255, 2, 2).
+    static constexpr int kW = 6, kH = 5;
+    static const uint8_t kBlock[8] = { 0xF8, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00 };
+    sk_sp<SkData> data = SkData::MakeUninitialized(4 * sizeof(kBlock));
+    for (int i = 0; i < 4; ++i) {
+        memcpy((uint8_t*)data->writable_data() + i * sizeof(kBlock), kBlock, sizeof(kBlock));
+    }
+
+    // Data that doesn't exactly cover the image is rejected.
+    REPORTER_ASSERT(reporter, !SkImage::MakeFromCompressed(context, data, kW + 4, kH,
+                                                           SkImage::CompressionType::kETC1));
+
+    sk_sp<SkImage> image = SkImage::MakeFromCompressed(context, data, kW, kH,
+                                                       SkImage::CompressionType::kETC1);
+    bool supported = context->contextPriv().caps()->isConfigTexturable(kRGB_ETC1_GrPixelConfig);
+    REPORTER_ASSERT(reporter, supported == SkToBool(image));
+    if (!image) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, image->isTextureBacked() && image->isOpaque());
+    REPORTER_ASSERT(reporter, kW == image->width() && kH == image->height());
+
+    auto surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                               SkImageInfo::MakeN32Premul(kW, kH));
+    surface->getCanvas()->clear(SK_ColorBLUE);
+    surface->getCanvas()->drawImage(image, 0, 0);
+    SkBitmap bm;
+    bm.allocN32Pixels(kW, kH);
+    SkAssertResult(surface->readPixels(bm, 0, 0));
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            SkColor c = bm.getColor(x, y);
+            REPORTER_ASSERT(reporter, 0xFF == SkColorGetR(c) && SkColorGetG(c) <= 4 &&
+                                      SkColorGetB(c) <= 4, "(%d, %d): 0x%08x", x, y, c);
+        }
+    }
+}
+
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(UnpremulTextureImage, reporter, ctxInfo) {
     SkBitmap bmp;
     bmp.allocPixels(
@@ -1339,6 +1381,51 @@ DEF_TEST(ImageScalePixels, reporter) {
     test_scale_pixels(reporter, codecImage.get(), pmRed);
 }
 
+// High quality downscales should average everything under each destination pixel, so a
+// one pixel checkerboard comes out flat gray instead of aliasing, and flat colors stay put.
+DEF_TEST(ImageScalePixels_HighQualityDownscale, reporter) {
+    SkBitmap checker;
+    checker.allocN32Pixels(400, 300);
+    for (int y = 0; y < checker.height(); ++y) {
+        for (int x = 0; x < checker.width(); ++x) {
+            *checker.getAddr32(x, y) = ((x ^ y) & 1) ? SkPackARGB32(0xFF, 0xFF, 0xFF, 0xFF)
+                                                     : SkPackARGB32(0xFF, 0, 0, 0);
+        }
+    }
+    for (int reduction : { 3, 10, 37 }) {
+        SkAutoPixmapStorage scaled;
+        scaled.alloc(SkImageInfo::MakeN32Premul(400 / reduction, 300 / reduction));
+        REPORTER_ASSERT(reporter, checker.pixmap().scalePixels(scaled, kHigh_SkFilterQuality));
+        for (int y = 0; y < scaled.height(); ++y) {
+            for (int x = 0; x < scaled.width(); ++x) {
+                SkPMColor c = *scaled.addr32(x, y);
+                int gray = SkGetPackedG32(c);
+                if (SkGetPackedA32(c) != 0xFF || SkTAbs(gray - 0x80) > 8 ||
+                    SkGetPackedR32(c) != gray || SkGetPackedB32(c) != gray) {
+                    ERRORF(reporter, "%dx reduction: 0x%08x at %d,%d", reduction, c, x, y);
+                    return;
+                }
+            }
+        }
+    }
+
+    // Unpremul pixels are filtered without premultiplying them.
+    for (SkAlphaType at : { kPremul_SkAlphaType, kUnpremul_SkAlphaType }) {
+        const uint32_t color = kPremul_SkAlphaType == at ? SkPackARGB32(0x80, 0x40, 0x20, 0x10)
+                                                         : SkPackARGB32(0x00, 0x40, 0x20, 0x10);
+        SkAutoPixmapStorage src, scaled;
+        src.alloc(SkImageInfo::MakeN32(123, 77, at));
+        scaled.alloc(SkImageInfo::MakeN32(17, 9, at));
+        for (int y = 0; y < src.height(); ++y) {
+            for (int x = 0; x < src.width(); ++x) {
+                *src.writable_addr32(x, y) = color;
+            }
+        }
+        REPORTER_ASSERT(reporter, src.scalePixels(scaled, kHigh_SkFilterQuality));
+        check_scaled_pixels(reporter, &scaled, color);
+    }
+}
+
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageScalePixels_Gpu, reporter, ctxInfo) {
     const SkPMColor pmRed = SkPackARGB32(0xFF, 0xFF, 0, 0);
     const SkColor red = SK_ColorRED;
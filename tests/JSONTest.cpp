@@ -76,6 +76,11 @@ DEF_TEST(JSON_Parse, reporter) {
         { "[ \"1234567\" ]"              , "[\"1234567\"]" },
         { "[ \"12345678\" ]"             , "[\"12345678\"]" },
         { "[ \"123456789\" ]"            , "[\"123456789\"]" },
+        { "[ \"123456789abcdefghijklmn\" ]", "[\"123456789abcdefghijklmn\"]" },
+        { "[ \"123456789abcdef}]{[ghijk\" ]", "[\"123456789abcdef}]{[ghijk\"]" },
+        { "[ \"1234567\u00ff89abcdefghijk\" ]", "[\"1234567\u00ff89abcdefghijk\"]" },
+        { "[ \"123456789abcdef\n\" ]"     , nullptr },
+        { "[ \"123456789abcdef\" , \"12345678}" , nullptr },
         { "[ null , true, false,0,12.8 ]", "[null,true,false,0,12.8]" },
 
         { "{}"                          , "{}" },
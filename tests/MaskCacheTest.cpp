@@ -6,7 +6,10 @@
  */
 
 #include "SkCachedData.h"
+#include "SkCanvas.h"
 #include "SkMaskCache.h"
+#include "SkMaskFilter.h"
+#include "SkPath.h"
 #include "SkResourceCache.h"
 #include "Test.h"
 
@@ -102,3 +105,113 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(100, 0);
+    path.lineTo(0, 100);
+    SkMatrix matrix = SkMatrix::MakeScale(2);
+    matrix.setTranslateX(0.25f);
+    SkScalar sigma = 0.8f;
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkMask mask;
+
+    // Only a key's second sighting reports it as seen before.
+    REPORTER_ASSERT(reporter, !SkMaskCache::SightPath(path, matrix, sigma, style, &cache));
+    REPORTER_ASSERT(reporter, SkMaskCache::SightPath(path, matrix, sigma, style, &cache));
+
+    SkCachedData* data = SkMaskCache::FindAndRef(path, matrix, sigma, style, &mask, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(0, 0, 100, 100);
+    mask.fRowBytes = 100;
+    mask.fFormat = SkMask::kBW_Format;
+    SkMaskCache::Add(path, matrix, sigma, style, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // Another matrix or blur is another mask.
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(path, SkMatrix::I(), sigma, style, &mask,
+                                                       &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(path, matrix, 0, style, &mask, &cache));
+
+    sk_bzero(&mask, sizeof(mask));
+    data = SkMaskCache::FindAndRef(path, matrix, sigma, style, &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    REPORTER_ASSERT(reporter, mask.fBounds.top() == 0 && mask.fBounds.bottom() == 100);
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    // Editing the path purges its masks and sightings.
+    path.lineTo(50, 50);
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(path, matrix, sigma, style, &mask,
+                                                       &cache));
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
+
+// Draws of a path from its cached mask should match drawing it without the cache, and each other
+// when moved by whole pixels.
+DEF_TEST(PathMaskCache_draw, reporter) {
+    SkPath path;
+    path.moveTo(2, 1);
+    path.cubicTo(20, -6, 30, 24, 8, 18);
+    path.lineTo(14, 6);
+    path.close();
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+
+    for (bool blur : { false, true }) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        if (blur) {
+            paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 1.5f));
+        }
+
+        SkBitmap cached, uncached;
+        cached.allocN32Pixels(80, 80);
+        cached.eraseColor(SK_ColorWHITE);
+        uncached.allocN32Pixels(80, 80);
+        uncached.eraseColor(SK_ColorWHITE);
+        SkCanvas cachedCanvas(cached), uncachedCanvas(uncached);
+
+        // The first draw at these subpixel offsets is direct, and only sights the path.
+        SkBitmap scratch;
+        scratch.allocN32Pixels(80, 80);
+        SkCanvas scratchCanvas(scratch);
+        scratchCanvas.translate(8.25f, 10.5f);
+        scratchCanvas.drawPath(path, paint);
+        for (SkPoint offset : { SkPoint{8.25f, 10.5f}, SkPoint{48.25f, 50.5f} }) {
+            cachedCanvas.save();
+            cachedCanvas.translate(offset.fX, offset.fY);
+            cachedCanvas.drawPath(path, paint);
+            cachedCanvas.restore();
+            uncachedCanvas.save();
+            uncachedCanvas.translate(offset.fX, offset.fY);
+            uncachedCanvas.drawPath(volatilePath, paint);
+            uncachedCanvas.restore();
+        }
+
+        int mismatches = 0;
+        for (int y = 0; y < 80; ++y) {
+            for (int x = 0; x < 80; ++x) {
+                int c = SkColorGetG(cached.getColor(x, y)),
+                    u = SkColorGetG(uncached.getColor(x, y));
+                mismatches += SkTAbs(c - u) > 1;
+                if (x < 40 && y < 40) {
+                    mismatches += c != (int)SkColorGetG(cached.getColor(x + 40, y + 40));
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, 0 == mismatches, "blur %d", blur);
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGraphics.h"
+#include "SkMemoryAccounting.h"
+#include "SkPath.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTraceMemoryDump.h"
+#include "Test.h"
+
+namespace {
+class SizeDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char* units,
+                          uint64_t value) override {
+        if (0 == strcmp(valueName, "size")) {
+            fNames.push_back(SkString(dumpName));
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override { return kLight_LevelOfDetail; }
+
+    SkTArray<SkString> fNames;
+};
+}  // namespace
+
+// Other tests may be allocating at the same time, so these only look for changes far larger
+// than anything they should be doing.
+static constexpr size_t kBig = 16 << 20;
+
+DEF_TEST(MemoryAccounting_tagged, reporter) {
+    const size_t before = SkMemoryAccounting::Bytes(SkMemoryTag::kCodec);
+    {
+        SkTaggedAutoTMalloc<uint8_t, SkMemoryTag::kCodec> buffer;
+        buffer.reset(2 * kBig);
+        REPORTER_ASSERT(reporter, SkMemoryAccounting::Bytes(SkMemoryTag::kCodec) > before + kBig);
+    }
+    REPORTER_ASSERT(reporter, SkMemoryAccounting::Bytes(SkMemoryTag::kCodec) < before + kBig);
+}
+
+DEF_TEST(MemoryAccounting_pathRef, reporter) {
+    const size_t before = SkMemoryAccounting::Bytes(SkMemoryTag::kPathRef);
+    {
+        SkPath path;
+        const int kPoints = 2 * kBig / sizeof(SkPoint);
+        for (int i = 0; i < kPoints; ++i) {
+            path.lineTo(i, i);
+        }
+        REPORTER_ASSERT(reporter, SkMemoryAccounting::Bytes(SkMemoryTag::kPathRef) > before + kBig);
+    }
+    REPORTER_ASSERT(reporter, SkMemoryAccounting::Bytes(SkMemoryTag::kPathRef) < before + kBig);
+}
+
+DEF_TEST(MemoryAccounting_dump, reporter) {
+    SizeDump dump;
+    SkGraphics::DumpMemoryStatistics(&dump);
+    for (int i = 0; i < SkMemoryAccounting::kTagCount; ++i) {
+        SkString name = SkStringPrintf("skia/sk_memory/%s",
+                                       SkMemoryAccounting::Name((SkMemoryTag)i));
+        bool found = false;
+        for (const SkString& dumped : dump.fNames) {
+            found |= dumped == name;
+        }
+        REPORTER_ASSERT(reporter, found, "%s", name.c_str());
+    }
+}
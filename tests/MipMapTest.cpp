@@ -202,3 +202,116 @@ DEF_TEST(MipMap_ComputeLevelSize, reporter) {
         REPORTER_ASSERT(reporter, currentTest.fExpectedMipMapLevelSize == levelSize);
     }
 }
+
+static void make_random_bitmap(SkBitmap* bm, const SkImageInfo& info, SkRandom* rand) {
+    bm->allocPixels(info);
+    for (int y = 0; y < info.height(); ++y) {
+        uint8_t* row = (uint8_t*)bm->getAddr(0, y);
+        for (size_t x = 0; x < info.minRowBytes(); ++x) {
+            row[x] = (uint8_t)rand->nextU();
+        }
+    }
+}
+
+// Averages each 2x2 block of bytes (so each channel of 8888) by summing and truncating.
+static bool check_box_level(const SkBitmap& src, const SkPixmap& dst) {
+    const int bpp = src.bytesPerPixel();
+    for (int y = 0; y < dst.height(); ++y) {
+        auto s0 = (const uint8_t*)src.getAddr(0, 2 * y),
+             s1 = (const uint8_t*)src.getAddr(0, 2 * y + 1);
+        auto d = (const uint8_t*)dst.addr(0, y);
+        for (int x = 0; x < dst.width() * bpp; ++x) {
+            int i = (x / bpp) * 2 * bpp + x % bpp;
+            if (d[x] != (s0[i] + s0[i + bpp] + s1[i] + s1[i + bpp]) >> 2) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+DEF_TEST(MipMap_BoxFilter, reporter) {
+    SkRandom rand;
+    // Widths that leave different tails after the filters working on several pixels at once.
+    for (int width : { 2, 8, 30, 74, 130 }) {
+        for (SkColorType ct : { kN32_SkColorType, kAlpha_8_SkColorType }) {
+            SkBitmap bm;
+            make_random_bitmap(&bm, SkImageInfo::Make(width, 40, ct, kPremul_SkAlphaType), &rand);
+            sk_sp<SkMipMap> mm(SkMipMap::Build(bm, nullptr));
+
+            SkMipMap::Level level;
+            REPORTER_ASSERT(reporter, mm && mm->getLevel(0, &level));
+            REPORTER_ASSERT(reporter, check_box_level(bm, level.fPixmap), "width %d", width);
+        }
+    }
+}
+
+static bool levels_equal(const SkMipMap* a, const SkMipMap* b) {
+    if (a->countLevels() != b->countLevels()) {
+        return false;
+    }
+    for (int i = 0; i < a->countLevels(); ++i) {
+        SkMipMap::Level la, lb;
+        a->getLevel(i, &la);
+        b->getLevel(i, &lb);
+        for (int y = 0; y < la.fPixmap.height(); ++y) {
+            if (memcmp(la.fPixmap.addr(0, y), lb.fPixmap.addr(0, y),
+                       la.fPixmap.info().minRowBytes())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+DEF_TEST(MipMap_Refresh, reporter) {
+    SkRandom rand;
+    const SkISize sizes[] = { {301, 200}, {256, 256}, {1, 77}, {640, 3} };
+    const SkColorType colorTypes[] = { kN32_SkColorType, kAlpha_8_SkColorType,
+                                       kRGB_565_SkColorType, kRGBA_F16_SkColorType };
+    for (SkISize size : sizes) {
+        for (SkColorType ct : colorTypes) {
+            SkImageInfo info = SkImageInfo::Make(size.width(), size.height(), ct,
+                                                 kPremul_SkAlphaType);
+            if (ct == kRGBA_F16_SkColorType) {
+                // Keep the halves finite.
+                info = info.makeColorType(kN32_SkColorType);
+            }
+            SkBitmap bm;
+            make_random_bitmap(&bm, info, &rand);
+            if (ct == kRGBA_F16_SkColorType) {
+                SkBitmap f16;
+                f16.allocPixels(info.makeColorType(ct));
+                REPORTER_ASSERT(reporter, bm.readPixels(f16.pixmap()));
+                bm = f16;
+            }
+            sk_sp<SkMipMap> mm(SkMipMap::Build(bm, nullptr));
+            REPORTER_ASSERT(reporter, mm);
+
+            for (int i = 0; i < 10; ++i) {
+                int l = rand.nextULessThan(size.width()),
+                    t = rand.nextULessThan(size.height());
+                SkIRect dirty = SkIRect::MakeLTRB(l, t,
+                                                  l + 1 + rand.nextULessThan(size.width() - l),
+                                                  t + 1 + rand.nextULessThan(size.height() - t));
+                bm.eraseArea(dirty, rand.nextU());
+                REPORTER_ASSERT(reporter, mm->refresh(bm.pixmap(), dirty));
+
+                sk_sp<SkMipMap> rebuilt(SkMipMap::Build(bm, nullptr));
+                REPORTER_ASSERT(reporter, levels_equal(mm.get(), rebuilt.get()),
+                                "%dx%d ct %d dirty %d,%d,%d,%d", size.width(), size.height(), ct,
+                                dirty.fLeft, dirty.fTop, dirty.fRight, dirty.fBottom);
+            }
+        }
+    }
+
+    // A source that doesn't match what the mipmap was built from is rejected.
+    SkBitmap bm, other;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorWHITE);
+    other.allocN32Pixels(64, 32);
+    other.eraseColor(SK_ColorWHITE);
+    sk_sp<SkMipMap> mm(SkMipMap::Build(bm, nullptr));
+    REPORTER_ASSERT(reporter, !mm->refresh(other.pixmap(), SkIRect::MakeWH(8, 8)));
+    REPORTER_ASSERT(reporter, mm->refresh(bm.pixmap(), SkIRect::MakeXYWH(100, 100, 8, 8)));
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkMultiPictureDocument.h"
+#include "SkStream.h"
+
+static constexpr int kPageCount = 8;
+
+static SkColor page_color(int page) {
+    return SkColorSetRGB(30 * page, 255 - 30 * page, 128);
+}
+
+static void draw_page(int page, SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setColor(page_color(page));
+    canvas->drawRect(SkRect::MakeWH(10 + page, 20), paint);
+}
+
+DEF_TEST(SkMultiPictureDocument_drawPages, r) {
+    SkSize sizes[kPageCount];
+    for (int i = 0; i < kPageCount; ++i) {
+        sizes[i] = SkSize::Make(10 + i, 20);
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* exec : { (SkExecutor*)nullptr, executor.get() }) {
+        SkDynamicMemoryWStream stream;
+        sk_sp<SkDocument> doc = SkMakeMultiPictureDocument(&stream);
+        doc->drawPages(kPageCount, sizes, draw_page, exec);
+        doc->close();
+
+        std::unique_ptr<SkStreamAsset> input = stream.detachAsStream();
+        REPORTER_ASSERT(r, SkMultiPictureDocumentReadPageCount(input.get()) == kPageCount);
+        SkDocumentPage pages[kPageCount];
+        REPORTER_ASSERT(r, SkMultiPictureDocumentRead(input.get(), pages, kPageCount));
+
+        // Pages come back in the order they were drawn in, whatever order they were recorded in.
+        for (int i = 0; i < kPageCount; ++i) {
+            REPORTER_ASSERT(r, pages[i].fSize == sizes[i]);
+            REPORTER_ASSERT(r, pages[i].fPicture);
+            if (!pages[i].fPicture) {
+                continue;
+            }
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(1, 1);
+            bitmap.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(bitmap);
+            canvas.drawPicture(pages[i].fPicture);
+            REPORTER_ASSERT(r, bitmap.getColor(0, 0) == page_color(i), "page %d", i);
+        }
+    }
+}
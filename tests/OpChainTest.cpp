@@ -10,6 +10,8 @@
 #include "GrMemoryPool.h"
 #include "GrOpFlushState.h"
 #include "GrRenderTargetOpList.h"
+#include "SkExecutor.h"
+#include "SkTaskGroup.h"
 #include "Test.h"
 #include "ops/GrOp.h"
 
@@ -138,8 +140,194 @@ DEF_GPUTEST(OpChainTest, reporter, /*ctxInfo*/) {
             opList.makeClosed(*context->contextPriv().caps());
             opList.prepare(&flushState);
             opList.execute(&flushState);
+            flushState.endRenderPass();
             opList.endFlush();
             REPORTER_ASSERT(reporter, std::equal(result, result + kNumOps + 1, validResult));
         }
     } while (std::next_permutation(permutation, permutation + kNumOps));
 }
+
+namespace {
+/**
+ * An op at an integer position which merges with any other mergeable one. When it executes it
+ * writes how many ops it merged at the positions of each of them.
+ */
+class MergeOp : public GrOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    static std::unique_ptr<MergeOp> Make(GrContext* context, int pos, bool mergeable,
+                                         int result[]) {
+        GrOpMemoryPool* pool = context->contextPriv().opMemoryPool();
+        return pool->allocate<MergeOp>(pos, mergeable, result);
+    }
+
+    const char* name() const override { return "MergeOp"; }
+
+private:
+    friend class ::GrOpMemoryPool;  // for ctor
+
+    MergeOp(int pos, bool mergeable, int result[])
+            : INHERITED(ClassID()), fMergeable(mergeable), fResult(result) {
+        fPositions.push_back(pos);
+        this->setBounds(SkRect::MakeXYWH(pos, 0, 1, 1), HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    void onPrepare(GrOpFlushState*) override {}
+
+    void onExecute(GrOpFlushState*) override {
+        for (int pos : fPositions) {
+            fResult[pos] = fPositions.count();
+        }
+    }
+
+    CombineResult onCombineIfPossible(GrOp* t, const GrCaps&) override {
+        MergeOp* that = t->cast<MergeOp>();
+        if (!fMergeable || !that->fMergeable) {
+            return CombineResult::kCannotCombine;
+        }
+        fPositions.push_back_n(that->fPositions.count(), that->fPositions.begin());
+        this->joinBounds(*that);
+        return CombineResult::kMerged;
+    }
+
+    bool fMergeable;
+    int* fResult;
+    SkTArray<int> fPositions;
+
+    typedef GrOp INHERITED;
+};
+}  // namespace
+
+/**
+ * With spatial op combining, an op merges with a compatible op recorded before the lookback
+ * window, but not past an op it overlaps.
+ */
+DEF_GPUTEST(OpListSpatialCombineTest, reporter, /*ctxInfo*/) {
+    static constexpr int kWidth = 64;
+    auto context = GrContext::MakeMock(nullptr);
+    SkASSERT(context);
+    GrSurfaceDesc desc;
+    desc.fConfig = kRGBA_8888_GrPixelConfig;
+    desc.fWidth = kWidth;
+    desc.fHeight = 1;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    auto proxy = context->contextPriv().proxyProvider()->createProxy(
+            desc, kTopLeft_GrSurfaceOrigin, GrMipMapped::kNo, SkBackingFit::kExact, SkBudgeted::kNo,
+            GrInternalSurfaceFlags::kNone);
+    SkASSERT(proxy);
+    proxy->instantiate(context->contextPriv().resourceProvider());
+    const GrCaps& caps = *context->contextPriv().caps();
+
+    for (bool spatial : {false, true}) {
+        GrTokenTracker tracker;
+        GrOpFlushState flushState(context->contextPriv().getGpu(),
+                                  context->contextPriv().resourceProvider(), &tracker);
+        GrRenderTargetOpList opList(context->contextPriv().resourceProvider(),
+                                    sk_ref_sp(context->contextPriv().opMemoryPool()),
+                                    proxy->asRenderTargetProxy(),
+                                    context->contextPriv().getAuditTrail(), spatial);
+        int result[kWidth];
+        std::fill(result, result + kWidth, 0);
+        auto add = [&](int pos, bool mergeable) {
+            return opList.addOp(MergeOp::Make(context.get(), pos, mergeable, result), caps);
+        };
+
+        add(0, true);
+        // Twenty ops which don't merge, at positions 1 to 20.
+        for (int i = 1; i <= 20; ++i) {
+            add(i, false);
+        }
+        // Nothing recorded since overlaps position 40, so it can draw with the first op...
+        bool merged = SK_InvalidUniqueID == add(40, true);
+        REPORTER_ASSERT(reporter, merged == spatial);
+        for (int i = 41; i <= 50; ++i) {
+            add(i, false);
+        }
+        // ...but position 10 has to draw after the op already there.
+        REPORTER_ASSERT(reporter, SK_InvalidUniqueID != add(10, true));
+
+        opList.makeClosed(caps);
+        opList.prepare(&flushState);
+        opList.execute(&flushState);
+        flushState.endRenderPass();
+        opList.endFlush();
+        REPORTER_ASSERT(reporter, result[0] == (spatial ? 2 : 1));
+        REPORTER_ASSERT(reporter, result[40] == (spatial ? 2 : 1));
+        REPORTER_ASSERT(reporter, result[10] == 1);
+    }
+}
+
+namespace {
+/** Records whether its prePrepare() ran before its prepare(). */
+class PrePrepareOp : public GrOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    static std::unique_ptr<PrePrepareOp> Make(GrContext* context, int pos, bool result[]) {
+        GrOpMemoryPool* pool = context->contextPriv().opMemoryPool();
+        return pool->allocate<PrePrepareOp>(pos, result);
+    }
+
+    const char* name() const override { return "PrePrepareOp"; }
+    bool canPrePrepare() const override { return true; }
+
+private:
+    friend class ::GrOpMemoryPool;  // for ctor
+
+    PrePrepareOp(int pos, bool result[]) : INHERITED(ClassID()), fPos(pos), fResult(result) {
+        this->setBounds(SkRect::MakeXYWH(pos, 0, 1, 1), HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    void onPrePrepare() override { fPrePrepared = true; }
+    void onPrepare(GrOpFlushState*) override { fResult[fPos] = fPrePrepared; }
+    void onExecute(GrOpFlushState*) override {}
+
+    int fPos;
+    bool* fResult;
+    bool fPrePrepared = false;
+
+    typedef GrOp INHERITED;
+};
+}  // namespace
+
+DEF_GPUTEST(OpListPrePrepareTest, reporter, /*ctxInfo*/) {
+    static constexpr int kNumPrePrepareOps = 8;
+    auto context = GrContext::MakeMock(nullptr);
+    SkASSERT(context);
+    GrSurfaceDesc desc;
+    desc.fConfig = kRGBA_8888_GrPixelConfig;
+    desc.fWidth = kNumPrePrepareOps;
+    desc.fHeight = 1;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    auto proxy = context->contextPriv().proxyProvider()->createProxy(
+            desc, kTopLeft_GrSurfaceOrigin, GrMipMapped::kNo, SkBackingFit::kExact, SkBudgeted::kNo,
+            GrInternalSurfaceFlags::kNone);
+    SkASSERT(proxy);
+    proxy->instantiate(context->contextPriv().resourceProvider());
+    const GrCaps& caps = *context->contextPriv().caps();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkTaskGroup taskGroup(*executor);
+    for (SkTaskGroup* group : {(SkTaskGroup*)nullptr, &taskGroup}) {
+        GrTokenTracker tracker;
+        GrOpFlushState flushState(context->contextPriv().getGpu(),
+                                  context->contextPriv().resourceProvider(), &tracker, group);
+        GrRenderTargetOpList opList(context->contextPriv().resourceProvider(),
+                                    sk_ref_sp(context->contextPriv().opMemoryPool()),
+                                    proxy->asRenderTargetProxy(),
+                                    context->contextPriv().getAuditTrail());
+        bool result[kNumPrePrepareOps] = {};
+        for (int i = 0; i < kNumPrePrepareOps; ++i) {
+            opList.addOp(PrePrepareOp::Make(context.get(), i, result), caps);
+        }
+        opList.makeClosed(caps);
+        opList.prepare(&flushState);
+        opList.execute(&flushState);
+        flushState.endRenderPass();
+        opList.endFlush();
+        for (int i = 0; i < kNumPrePrepareOps; ++i) {
+            REPORTER_ASSERT(reporter, result[i] == (group != nullptr));
+        }
+    }
+}
@@ -8,6 +8,7 @@
 
 #include "Resources.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPDFDocument.h"
@@ -15,6 +16,8 @@
 
 #include "sk_tool_utils.h"
 
+#include <string>
+
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
 
@@ -239,3 +242,179 @@ DEF_TEST(SkPDF_multiple_pages, r) {
                 SkColorSetARGB(0xFF, 0x00, (uint8_t)(255.0f * i / (n - 1)), 0x00));
     }
 }
+
+static sk_sp<SkData> make_document(const SkPDF::Metadata& metadata) {
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    sk_sp<SkImage> image = GetResourceAsImage("images/mandrill_128.png");
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(24);
+    for (int i = 0; i < 20; ++i) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        canvas->drawColor(SkColorSetARGB(0xFF, 0x00, (uint8_t)(12 * i), 0x00));
+        if (image) {
+            // A different subset on each page, so each is encoded separately.
+            canvas->drawImageRect(image, SkIRect::MakeXYWH(i, i, 64, 64),
+                                  SkRect::MakeXYWH(72, 72, 256, 256), nullptr);
+        }
+        SkString text = SkStringPrintf("Page %d of 20", i + 1);
+        canvas->drawString(text, 72, 400, paint);
+        // Text in a layer, whose form XObject refers to the font too.
+        canvas->saveLayerAlpha(nullptr, 0x80);
+        canvas->drawString(text, 72, 500, paint);
+        canvas->restore();
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+// Work done on the executor must not change the document.
+DEF_TEST(SkPDF_executor, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_executor, r);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (bool streaming : { false, true }) {
+        SkPDF::Metadata metadata;
+        metadata.fStreaming = streaming;
+        sk_sp<SkData> expected = make_document(metadata);
+        metadata.fExecutor = executor.get();
+        sk_sp<SkData> actual = make_document(metadata);
+        REPORTER_ASSERT(r, expected->equals(actual.get()), "streaming %d", streaming);
+    }
+}
+
+// Returns true if every object in the xref table is where the table says.
+static bool check_xref(const SkData* data) {
+    const char* pdf = static_cast<const char*>(data->data());
+    const std::string doc(pdf, data->size());
+    size_t startxref = doc.rfind("startxref\n");
+    if (std::string::npos == startxref) {
+        return false;
+    }
+    const size_t xref = atoi(pdf + startxref + strlen("startxref\n"));
+    if (0 != doc.compare(xref, strlen("xref\n0 "), "xref\n0 ")) {
+        return false;
+    }
+    const int count = atoi(pdf + xref + strlen("xref\n0 "));
+    // Each entry is 20 bytes, starting with the free object 0.
+    const size_t entries = doc.find('\n', xref + strlen("xref\n0 ")) + 1;
+    for (int i = 1; i < count; ++i) {
+        const size_t offset = atoi(pdf + entries + 20 * i);
+        const std::string header = SkStringPrintf("%d 0 obj\n", i).c_str();
+        if (offset >= doc.size() || 0 != doc.compare(offset, header.size(), header)) {
+            return false;
+        }
+    }
+    return count > 1;
+}
+
+// Streaming writes pages' resources early, and fonts late, but the document
+// has the same pages.
+DEF_TEST(SkPDF_streaming, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_streaming, r);
+    SkPDF::Metadata metadata;
+    sk_sp<SkData> whole = make_document(metadata);
+    metadata.fStreaming = true;
+    sk_sp<SkData> streamed = make_document(metadata);
+    REPORTER_ASSERT(r, check_xref(whole.get()));
+    REPORTER_ASSERT(r, check_xref(streamed.get()));
+    // Pages refer to their resources, rather than holding them.
+    static const char kDirectResources[] = "/Type /Page\n/Resources <<";
+    REPORTER_ASSERT(r, contains(whole->bytes(), whole->size(), kDirectResources));
+    REPORTER_ASSERT(r, !contains(streamed->bytes(), streamed->size(), kDirectResources));
+    REPORTER_ASSERT(r, contains(streamed->bytes(), streamed->size(), "/FontFile2") ==
+                       contains(whole->bytes(), whole->size(), "/FontFile2"));
+}
+
+static int count(const SkData* data, const char needle[]) {
+    const std::string doc(static_cast<const char*>(data->data()), data->size());
+    int n = 0;
+    for (size_t i = doc.find(needle); i != std::string::npos; i = doc.find(needle, i + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+// Distinct images with the same pixels are embedded once with fDeduplicateImages.
+DEF_TEST(SkPDF_deduplicateImages, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_deduplicateImages, r);
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/mandrill_128.png", &bitmap)) {
+        return;
+    }
+    for (bool deduplicate : { false, true }) {
+        SkPDF::Metadata metadata;
+        metadata.fDeduplicateImages = deduplicate;
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        for (int i = 0; i < 3; ++i) {
+            // A copy of the pixels each time, as if decoded again.
+            SkBitmap copy;
+            REPORTER_ASSERT(r, sk_tool_utils::copy_to(&copy, bitmap.colorType(), bitmap));
+            doc->beginPage(612, 792)->drawBitmap(copy, 72, 72);
+        }
+        // Different pixels are still embedded separately.
+        SkBitmap other;
+        other.allocN32Pixels(16, 16);
+        other.eraseColor(SK_ColorBLUE);
+        doc->beginPage(612, 792)->drawBitmap(other, 72, 72);
+        doc->close();
+        sk_sp<SkData> data = stream.detachAsData();
+        REPORTER_ASSERT(r, count(data.get(), "/Subtype /Image") == (deduplicate ? 2 : 4));
+    }
+}
+
+DEF_TEST(SkPDF_compressionLevel, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_compressionLevel, r);
+    using Level = SkPDF::Metadata::CompressionLevel;
+    size_t previousSize = 0;
+    for (Level level : { Level::kNone, Level::kLowButFast, Level::kHighButSlow }) {
+        SkPDF::Metadata metadata;
+        metadata.fCompressionLevel = level;
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        SkPaint paint;
+        for (int i = 0; i < 500; ++i) {
+            paint.setColor(SkColorSetRGB(i % 256, 0, 0));
+            canvas->drawRect(SkRect::MakeXYWH(i % 50, i / 50, 10, 10), paint);
+        }
+        doc->close();
+        sk_sp<SkData> data = stream.detachAsData();
+        const bool compressed = contains(data->bytes(), data->size(), "/Filter /FlateDecode");
+        REPORTER_ASSERT(r, compressed == (Level::kNone != level));
+        if (previousSize) {
+            REPORTER_ASSERT(r, data->size() <= previousSize);
+        }
+        previousSize = data->size();
+    }
+}
+
+// An image drawn with perspective is rasterized in tiles, each its own image.
+DEF_TEST(SkPDF_rasterTiles, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_rasterTiles, r);
+    sk_sp<SkImage> image = GetResourceAsImage("images/mandrill_128.png");
+    if (!image) {
+        return;
+    }
+    SkMatrix perspective;
+    perspective.setAll(1, 0, 0, 0, 1, 0, 0, 0.0001f, 1);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    sk_sp<SkData> serial;
+    for (SkExecutor* e : { (SkExecutor*)nullptr, executor.get() }) {
+        SkPDF::Metadata metadata;
+        metadata.fExecutor = e;
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        SkCanvas* canvas = doc->beginPage(2048, 2048);
+        canvas->concat(perspective);
+        canvas->drawImageRect(image, SkRect::MakeWH(2000, 2000), nullptr);
+        doc->close();
+        sk_sp<SkData> data = stream.detachAsData();
+        REPORTER_ASSERT(r, count(data.get(), "/Subtype /Image") > 1);
+        if (serial) {
+            REPORTER_ASSERT(r, serial->equals(data.get()));
+        }
+        serial = std::move(data);
+    }
+}
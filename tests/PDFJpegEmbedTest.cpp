@@ -7,6 +7,8 @@
 
 #include "SkCanvas.h"
 #include "SkData.h"
+#include "SkExecutor.h"
+#include "SkImage.h"
 #include "SkImageGenerator.h"
 #include "SkPDFDocument.h"
 #include "SkStream.h"
@@ -73,9 +75,55 @@ DEF_TEST(SkPDF_JpegEmbedTest, r) {
 
     REPORTER_ASSERT(r, is_subset_of(mandrillData.get(), pdfData.get()));
 
-    // This JPEG uses a nonstandard colorspace - it can not be
-    // embedded into the PDF directly.
-    REPORTER_ASSERT(r, !is_subset_of(cmykData.get(), pdfData.get()));
+    // CMYK JPEGs are embedded directly too, with their ink inverted.
+    REPORTER_ASSERT(r, is_subset_of(cmykData.get(), pdfData.get()));
+    static const char kDecode[] = "/Decode [1 0 1 0 1 0 1 0]";
+    sk_sp<SkData> decode = SkData::MakeWithoutCopy(kDecode, strlen(kDecode));
+    REPORTER_ASSERT(r, is_subset_of(decode.get(), pdfData.get()));
+}
+
+static bool is_dct_encoded(sk_sp<SkImage> image, SkExecutor* executor) {
+    SkPDF::Metadata metadata;
+    metadata.fEncodingQuality = 50;
+    metadata.fExecutor = executor;
+    SkDynamicMemoryWStream pdf;
+    sk_sp<SkDocument> document = SkPDF::MakeDocument(&pdf, metadata);
+    document->beginPage(SkIntToScalar(image->width()), SkIntToScalar(image->height()))
+            ->drawImage(image, 0, 0);
+    document->close();
+    sk_sp<SkData> pdfData = pdf.detachAsData();
+    static const char kDCT[] = "/DCTDecode";
+    sk_sp<SkData> dct = SkData::MakeWithoutCopy(kDCT, strlen(kDCT));
+    return is_subset_of(dct.get(), pdfData.get());
+}
+
+/**
+ *  Test that images without encoded data are only JPEG-encoded when they
+ *  look photographic.
+ */
+DEF_TEST(SkPDF_JpegEncodingHeuristic, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_JpegEncodingHeuristic, r);
+    sk_sp<SkImage> mandrill = GetResourceAsImage("images/mandrill_512_q075.jpg");
+    if (!mandrill) {
+        INFOF(r, "\nSkPDF_JpegEncodingHeuristic: resource can not be found.\n");
+        return;
+    }
+    // Drop the encoded data, so it can't be embedded as is.
+    sk_sp<SkImage> photo = mandrill->makeRasterImage();
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(512, 512, true);
+    bitmap.eraseColor(SK_ColorWHITE);
+    bitmap.erase(SK_ColorBLUE, SkIRect::MakeLTRB(64, 64, 256, 448));
+    bitmap.erase(SK_ColorRED, SkIRect::MakeLTRB(300, 100, 480, 200));
+    bitmap.setImmutable();
+    sk_sp<SkImage> lineArt = SkImage::MakeFromBitmap(bitmap);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (SkExecutor* e : {(SkExecutor*)nullptr, executor.get()}) {
+        REPORTER_ASSERT(r, is_dct_encoded(photo, e));
+        REPORTER_ASSERT(r, !is_dct_encoded(lineArt, e));
+    }
 }
 
 #ifdef SK_SUPPORT_PDF
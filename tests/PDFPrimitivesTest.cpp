@@ -24,9 +24,11 @@
 #include "SkPDFDevice.h"
 #include "SkPDFDocument.h"
 #include "SkPDFFont.h"
+#include "SkPDFSubsetFontCache.h"
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkScalar.h"
 #include "SkSpecialImage.h"
 #include "SkStream.h"
@@ -550,4 +552,29 @@ DEF_TEST(SkPDF_Clusterator, reporter) {
     }
 }
 
+DEF_TEST(SkPDF_SubsetFontCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    const std::vector<unsigned> glyphs = { 0, 3, 17, 42 };
+    const std::vector<unsigned> otherGlyphs = { 0, 3, 17, 43 };
+    sk_sp<SkData> subset = SkData::MakeWithCString("subset");
+    sk_sp<SkData> font = SkData::MakeWithCString("font");
+
+    REPORTER_ASSERT(reporter, !SkPDFSubsetFontCache::FindSubset(1, glyphs, &cache));
+    SkPDFSubsetFontCache::AddSubset(1, glyphs, subset, &cache);
+    REPORTER_ASSERT(reporter, SkPDFSubsetFontCache::FindSubset(1, glyphs, &cache) == subset);
+    // Both the typeface and the glyphs must match.
+    REPORTER_ASSERT(reporter, !SkPDFSubsetFontCache::FindSubset(2, glyphs, &cache));
+    REPORTER_ASSERT(reporter, !SkPDFSubsetFontCache::FindSubset(1, otherGlyphs, &cache));
+    // Subsets and font files don't share keys.
+    REPORTER_ASSERT(reporter, !SkPDFSubsetFontCache::FindFontData(1, &cache));
+
+    SkPDFSubsetFontCache::AddFontData(1, font, &cache);
+    REPORTER_ASSERT(reporter, SkPDFSubsetFontCache::FindFontData(1, &cache) == font);
+    REPORTER_ASSERT(reporter, SkPDFSubsetFontCache::FindSubset(1, glyphs, &cache) == subset);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, !SkPDFSubsetFontCache::FindSubset(1, glyphs, &cache));
+    REPORTER_ASSERT(reporter, !SkPDFSubsetFontCache::FindFontData(1, &cache));
+}
+
 #endif
@@ -10,19 +10,11 @@
 #include "SkPDFDocument.h"
 #include "SkStream.h"
 
-using PDFTag = SkPDF::StructureElementNode;
+#include <string>
 
-// Test building a tagged PDF.
-// Add this to args.gn to output the PDF to a file:
-//   extra_cflags = [ "-DSK_PDF_TEST_TAGS_OUTPUT_PATH=\"/tmp/foo.pdf\"" ]
-DEF_TEST(SkPDF_tagged, r) {
-    REQUIRE_PDF_DOCUMENT(SkPDF_tagged, r);
-#ifdef SK_PDF_TEST_TAGS_OUTPUT_PATH
-    SkFILEWStream outputStream(SK_PDF_TEST_TAGS_OUTPUT_PATH);
-#else
-    SkDynamicMemoryWStream outputStream;
-#endif
+using PDFTag = SkPDF::StructureElementNode;
 
+static void make_tagged_document(SkWStream* outputStream, bool streaming) {
     SkSize pageSize = SkSize::Make(612, 792);  // U.S. Letter
 
     SkPDF::Metadata metadata;
@@ -93,8 +85,9 @@ DEF_TEST(SkPDF_tagged, r) {
     p2.fChildCount = 0;
 
     metadata.fStructureElementTreeRoot = &root;
+    metadata.fStreaming = streaming;
     sk_sp<SkDocument> document = SkPDF::MakeDocument(
-        &outputStream, metadata);
+        outputStream, metadata);
 
     SkPaint paint;
     paint.setColor(SK_ColorBLACK);
@@ -163,6 +156,48 @@ DEF_TEST(SkPDF_tagged, r) {
     document->endPage();
 
     document->close();
+}
 
+// Test building a tagged PDF.
+// Add this to args.gn to output the PDF to a file:
+//   extra_cflags = [ "-DSK_PDF_TEST_TAGS_OUTPUT_PATH=\"/tmp/foo.pdf\"" ]
+DEF_TEST(SkPDF_tagged, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_tagged, r);
+#ifdef SK_PDF_TEST_TAGS_OUTPUT_PATH
+    SkFILEWStream outputStream(SK_PDF_TEST_TAGS_OUTPUT_PATH);
+#else
+    SkDynamicMemoryWStream outputStream;
+#endif
+    make_tagged_document(&outputStream, false);
     outputStream.flush();
 }
+
+static int count(const std::string& haystack, const char* needle) {
+    int n = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos;
+         pos = haystack.find(needle, pos + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+// In streaming mode each page's part of the parent tree is written when the page ends, but the
+// structure tree should come out the same.
+DEF_TEST(SkPDF_tagged_streaming, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_tagged_streaming, r);
+    std::string outputs[2];
+    for (bool streaming : { false, true }) {
+        SkDynamicMemoryWStream outputStream;
+        make_tagged_document(&outputStream, streaming);
+        sk_sp<SkData> data = outputStream.detachAsData();
+        outputs[streaming].assign(static_cast<const char*>(data->data()), data->size());
+    }
+    for (const std::string& output : outputs) {
+        REPORTER_ASSERT(r, count(output, "/Type /StructTreeRoot") == 1);
+        REPORTER_ASSERT(r, count(output, "/Type /ParentTree") == 1);
+        // Every tag but the hidden div.
+        REPORTER_ASSERT(r, count(output, "/Type /StructElem") == 9);
+        // The paragraph spanning both pages.
+        REPORTER_ASSERT(r, count(output, "/Type /MCR") == 2);
+    }
+}
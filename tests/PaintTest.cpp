@@ -367,3 +367,30 @@ DEF_TEST(Paint_nothingToDraw, r) {
     paint.setColorFilter(SkColorFilter::MakeMatrixFilterRowMajor255(cm.fMat));
     REPORTER_ASSERT(r, !paint.nothingToDraw());
 }
+
+DEF_TEST(Paint_effectsCopyOnWrite, r) {
+    SkPaint paint;
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 1));
+    paint.setLooper(SkLayerDrawLooper::Builder().detach());
+
+    // Changing an effect on a copy must not show through to the original.
+    SkPaint copy(paint);
+    REPORTER_ASSERT(r, copy == paint);
+    copy.setLooper(nullptr);
+    REPORTER_ASSERT(r, paint.getLooper());
+    REPORTER_ASSERT(r, !copy.getLooper());
+    REPORTER_ASSERT(r, copy.getMaskFilter() == paint.getMaskFilter());
+    REPORTER_ASSERT(r, copy != paint);
+
+    // Paints with the same effects are equal, and hash the same, whether or not they were copied
+    // from one another.
+    copy.setLooper(paint.refDrawLooper());
+    REPORTER_ASSERT(r, copy == paint);
+    REPORTER_ASSERT(r, copy.getHash() == paint.getHash());
+
+    SkPaint cleared(paint);
+    cleared.setMaskFilter(nullptr);
+    cleared.setLooper(nullptr);
+    REPORTER_ASSERT(r, cleared == SkPaint());
+    REPORTER_ASSERT(r, cleared.getHash() == SkPaint().getHash());
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkMatrix.h"
+#include "SkPathArena.h"
+#include "SkPathPriv.h"
+#include "Test.h"
+
+static SkPath make_path(int i) {
+    SkPath path;
+    switch (i % 4) {
+        case 0:
+            path.addRect(SkRect::MakeXYWH(i, i, 10, 20));
+            break;
+        case 1:
+            path.addCircle(i, 2 * i, 5);
+            break;
+        case 2:
+            path.moveTo(i, 0);
+            path.lineTo(i + 10, 5);
+            path.quadTo(i + 20, 20, i, 30);
+            path.conicTo(i - 10, 15, i, 0, 0.5f);
+            path.setFillType(SkPath::kEvenOdd_FillType);
+            break;
+        default:
+            path.moveTo(0, 0);
+            path.cubicTo(i, 40, -i, 40, 0, 0);
+            path.moveTo(5, 5);
+            path.lineTo(6, 5);
+            break;
+    }
+    return path;
+}
+
+DEF_TEST(PathArena, reporter) {
+    const int kCount = 200;
+    SkPath frozen[kCount];
+    size_t bytes;
+    {
+        SkPathArena arena(4096);
+        for (int i = 0; i < kCount; ++i) {
+            frozen[i] = arena.freeze(make_path(i));
+        }
+        bytes = arena.bytesAllocated();
+        REPORTER_ASSERT(reporter, bytes > 0 && bytes % 4096 == 0);
+        REPORTER_ASSERT(reporter, bytes < kCount * 256);
+        // The paths outlive the arena.
+    }
+
+    for (int i = 0; i < kCount; ++i) {
+        SkPath original = make_path(i);
+        REPORTER_ASSERT(reporter, frozen[i] == original);
+        REPORTER_ASSERT(reporter, frozen[i].getBounds() == original.getBounds());
+        REPORTER_ASSERT(reporter, frozen[i].getFillType() == original.getFillType());
+        REPORTER_ASSERT(reporter,
+                        frozen[i].getConvexityOrUnknown() == original.getConvexity());
+        REPORTER_ASSERT(reporter, frozen[i].isOval(nullptr) == original.isOval(nullptr));
+        REPORTER_ASSERT(reporter,
+                        SkPathPriv::ConicWeightCnt(frozen[i]) ==
+                        SkPathPriv::ConicWeightCnt(original));
+    }
+
+    // Editing a frozen path, or a copy of one, leaves the packed data alone.
+    SkPath copy = frozen[2];
+    copy.lineTo(100, 100);
+    REPORTER_ASSERT(reporter, copy != frozen[2]);
+    REPORTER_ASSERT(reporter, frozen[2] == make_path(2));
+
+    SkPath edited = frozen[2];
+    frozen[2].setLastPt(50, 50);
+    REPORTER_ASSERT(reporter, frozen[2] != edited);
+    REPORTER_ASSERT(reporter, edited == make_path(2));
+
+    SkPath transformed = frozen[1];
+    frozen[1].transform(SkMatrix::MakeTrans(10, 10));
+    make_path(1).transform(SkMatrix::MakeTrans(10, 10), &copy);
+    REPORTER_ASSERT(reporter, frozen[1] == copy);
+    REPORTER_ASSERT(reporter, transformed == make_path(1));
+
+    SkPath rewound = frozen[3];
+    frozen[3].rewind();
+    frozen[3].addRect(SkRect::MakeWH(1, 1));
+    REPORTER_ASSERT(reporter, rewound == make_path(3));
+
+    // Frozen paths serialize like any other.
+    sk_sp<SkData> data = frozen[6].serialize();
+    SkPath read;
+    REPORTER_ASSERT(reporter, read.readFromMemory(data->data(), data->size()) == data->size());
+    REPORTER_ASSERT(reporter, read == make_path(6));
+
+    // A path too big for a shared block gets one of its own.
+    SkPathArena arena(256);
+    SkPath big;
+    for (int i = 0; i < 100; ++i) {
+        big.lineTo(i, i * i);
+    }
+    REPORTER_ASSERT(reporter, arena.freeze(big) == big);
+    REPORTER_ASSERT(reporter, arena.bytesAllocated() == SkAlign4(101 * sizeof(SkPoint) + 101));
+
+    REPORTER_ASSERT(reporter, arena.freeze(SkPath()).isEmpty());
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkPathMeasure.h"
+#include "SkPathMeasurePriv.h"
 #include "Test.h"
 
 static void test_small_segment3() {
@@ -227,3 +228,73 @@ DEF_TEST(PathMeasure_nextctr, reporter) {
     // only expect 1 contour, even if we didn't explicitly call getLength() ourselves
     REPORTER_ASSERT(reporter, !meas.nextContour());
 }
+
+static void check_cached_measure(skiatest::Reporter* reporter, const SkPath& path,
+                                 bool forceClosed, SkScalar resScale) {
+    SkPathMeasure expected(path, forceClosed, resScale);
+    SkPathMeasure cached;
+    SkPathMeasurePriv::SetPathCached(&cached, path, forceClosed, resScale);
+
+    // Walk one more contour than nextContour() allows, to check what it skips past.
+    for (int contour = 0; contour < 8; ++contour) {
+        SkScalar length = expected.getLength();
+        REPORTER_ASSERT(reporter, length == cached.getLength());
+        REPORTER_ASSERT(reporter, expected.isClosed() == cached.isClosed());
+        for (int i = 0; i <= 16; ++i) {
+            SkPoint expectedPos, cachedPos;
+            SkVector expectedTan, cachedTan;
+            bool ok = expected.getPosTan(length * i / 16, &expectedPos, &expectedTan);
+            REPORTER_ASSERT(reporter, ok == cached.getPosTan(length * i / 16, &cachedPos,
+                                                             &cachedTan));
+            REPORTER_ASSERT(reporter, !ok || (expectedPos == cachedPos &&
+                                              expectedTan == cachedTan));
+        }
+        SkPath expectedSegment, cachedSegment;
+        REPORTER_ASSERT(reporter,
+                        expected.getSegment(length / 3, length * 3 / 4, &expectedSegment, true) ==
+                        cached.getSegment(length / 3, length * 3 / 4, &cachedSegment, true));
+        REPORTER_ASSERT(reporter, expectedSegment == cachedSegment);
+
+        REPORTER_ASSERT(reporter, expected.nextContour() == cached.nextContour());
+    }
+}
+
+DEF_TEST(PathMeasureCached, reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.cubicTo(10, 30, 40, -20, 50, 10);
+    path.lineTo(50, 50);
+    path.conicTo(0, 50, 0, 0, 0.7f);
+    path.close();
+    // A zero-length contour, which nextContour() stops at.
+    path.moveTo(60, 60);
+    path.lineTo(60, 60);
+    path.moveTo(70, 70);
+    path.quadTo(90, 100, 120, 70);
+    path.addCircle(30, 30, 20);
+    path.moveTo(0, 100);
+
+    for (bool forceClosed : {false, true}) {
+        for (SkScalar resScale : {1.0f, 4.0f}) {
+            check_cached_measure(reporter, path, forceClosed, resScale);
+            // The second time, the measurements come from the cache.
+            check_cached_measure(reporter, path, forceClosed, resScale);
+        }
+    }
+
+    // A short polyline isn't cached, but measures the same either way.
+    SkPath line;
+    line.moveTo(0, 0);
+    line.lineTo(10, 0);
+    line.lineTo(10, 10);
+    check_cached_measure(reporter, line, false, 1);
+
+    // Nor is a path that's not finite.
+    SkPath nan(path);
+    nan.lineTo(SK_ScalarNaN, 0);
+    check_cached_measure(reporter, nan, false, 1);
+
+    // Editing the path must not leave the old measurements in use.
+    path.lineTo(200, 200);
+    check_cached_measure(reporter, path, false, 1);
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "Test.h"
+
+static const SkScalar kTolerance = 0.25f;
+
+// Checks that the approximate result fills the same points as the exact one, except those within
+// twice the tolerance of the exact result's outline.
+static bool fill_matches(const SkPath& exact, const SkPath& approximate, SkScalar tolerance) {
+    SkRect bounds = exact.getBounds();
+    bounds.join(approximate.getBounds());
+    bounds.outset(3, 3);
+    const SkScalar offsets[][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+                                    { -0.7f, -0.7f }, { 0.7f, -0.7f }, { -0.7f, 0.7f },
+                                    { 0.7f, 0.7f } };
+    for (SkScalar y = bounds.fTop; y < bounds.fBottom; y += 2) {
+        for (SkScalar x = bounds.fLeft; x < bounds.fRight; x += 2) {
+            bool inside = exact.contains(x, y);
+            bool nearEdge = false;
+            for (const auto& offset : offsets) {
+                if (exact.contains(x + offset[0] * tolerance * 2,
+                                   y + offset[1] * tolerance * 2) != inside) {
+                    nearEdge = true;
+                    break;
+                }
+            }
+            if (!nearEdge && approximate.contains(x, y) != inside) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool only_lines(const SkPath& path) {
+    return 0 == (path.getSegmentMasks() & ~SkPath::kLine_SegmentMask);
+}
+
+DEF_TEST(PathOpsApproximateOp, reporter) {
+    SkPath shapes[4];
+    shapes[0].addRect(10, 10, 70, 70);
+    shapes[1].addCircle(60, 50, 30, SkPath::kCCW_Direction);
+    shapes[2].moveTo(40, 0);
+    shapes[2].cubicTo(120, 0, 0, 100, 100, 100);
+    shapes[2].cubicTo(50, 120, -20, 50, 40, 0);
+    shapes[3].addRRect(SkRRect::MakeRectXY({ 20, 5, 90, 60 }, 15, 15));
+    shapes[3].addRect(30, 20, 80, 40);
+    shapes[3].setFillType(SkPath::kEvenOdd_FillType);
+
+    for (const SkPath& one : shapes) {
+        for (const SkPath& two : shapes) {
+            for (int inverse = 0; inverse < 4; ++inverse) {
+                SkPath a(one), b(two);
+                if (inverse & 1) {
+                    a.toggleInverseFillType();
+                }
+                if (inverse & 2) {
+                    b.toggleInverseFillType();
+                }
+                for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+                    SkPath exact, approximate;
+                    if (!Op(a, b, (SkPathOp) op, &exact)) {
+                        continue;
+                    }
+                    REPORTER_ASSERT(reporter, ApproximateOp(a, b, (SkPathOp) op, kTolerance,
+                                                            &approximate));
+                    REPORTER_ASSERT(reporter, only_lines(approximate));
+                    REPORTER_ASSERT(reporter,
+                                    exact.isInverseFillType() == approximate.isInverseFillType());
+                    REPORTER_ASSERT(reporter, fill_matches(exact, approximate, kTolerance));
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(PathOpsApproximateSimplify, reporter) {
+    // Rects sharing edges, which the exact ops have to find coincidences for.
+    SkPath grid;
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            if ((x + y) % 3) {
+                grid.addRect(x * 10, y * 10, x * 10 + 10, y * 10 + 10);
+            }
+        }
+    }
+    SkPath exact, approximate;
+    REPORTER_ASSERT(reporter, Simplify(grid, &exact));
+    REPORTER_ASSERT(reporter, ApproximateSimplify(grid, kTolerance, &approximate));
+    REPORTER_ASSERT(reporter, fill_matches(exact, approximate, kTolerance));
+
+    // A curve that crosses itself many times.
+    SkPath scribble;
+    scribble.moveTo(0, 0);
+    for (int i = 0; i < 12; ++i) {
+        scribble.cubicTo((i * 37) % 100, (i * 53) % 100, (i * 71) % 100, (i * 29) % 100,
+                         (i * 17) % 100, (i * 83) % 100);
+    }
+    REPORTER_ASSERT(reporter, Simplify(scribble, &exact));
+    REPORTER_ASSERT(reporter, ApproximateSimplify(scribble, kTolerance, &approximate));
+    REPORTER_ASSERT(reporter, fill_matches(exact, approximate, kTolerance));
+
+    SkPath empty;
+    REPORTER_ASSERT(reporter, ApproximateSimplify(empty, kTolerance, &approximate));
+    REPORTER_ASSERT(reporter, approximate.isEmpty());
+
+    REPORTER_ASSERT(reporter, !ApproximateSimplify(grid, 0, &approximate));
+    REPORTER_ASSERT(reporter, !ApproximateSimplify(grid, SK_ScalarNaN, &approximate));
+}
@@ -8,6 +8,7 @@
 #include "PathOpsExtendedTest.h"
 #include "PathOpsTestCommon.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "Test.h"
 
 DEF_TEST(PathOpsBuilder, reporter) {
@@ -361,3 +362,36 @@ SkOpBuilder builder;
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     builder.resolve(&path);
 }
+
+// Overlapping non-convex paths are unioned in clusters, which must match unioning them in turn.
+DEF_TEST(SkOpBuilderClusters, reporter) {
+    SkTArray<SkPath> paths;
+    for (int cluster = 0; cluster < 4; ++cluster) {
+        for (int i = 0; i < 6; ++i) {
+            // An L shape, overlapping the next one in its cluster.
+            SkScalar x = 100 * cluster + 5 * i, y = 7 * i;
+            SkPath& path = paths.push_back();
+            path.moveTo(x, y);
+            path.lineTo(x + 20, y);
+            path.lineTo(x + 20, y + 8);
+            path.lineTo(x + 8, y + 8);
+            path.lineTo(x + 8, y + 30);
+            path.lineTo(x, y + 30);
+            path.close();
+        }
+    }
+    SkPath expected;
+    for (const SkPath& path : paths) {
+        REPORTER_ASSERT(reporter, Op(expected, path, kUnion_SkPathOp, &expected));
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (SkExecutor* e : { (SkExecutor*)nullptr, executor.get() }) {
+        SkOpBuilder builder;
+        for (const SkPath& path : paths) {
+            builder.add(path, kUnion_SkPathOp);
+        }
+        SkPath result;
+        REPORTER_ASSERT(reporter, builder.resolve(&result, e));
+        REPORTER_ASSERT(reporter, comparePaths(reporter, __FUNCTION__, expected, result) == 0);
+    }
+}
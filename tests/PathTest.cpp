@@ -4508,6 +4508,62 @@ DEF_TEST(PathContains, reporter) {
     test_contains(reporter);
 }
 
+// Big non-volatile paths answer contains() from an index in SkResourceCache. Volatile copies
+// walk every segment, so they should always agree.
+DEF_TEST(PathContainsIndexed, reporter) {
+    SkRandom rand;
+    for (int fill = 0; fill < 2; ++fill) {
+        SkPath path;
+        path.setFillType(fill ? SkPath::kEvenOdd_FillType : SkPath::kWinding_FillType);
+        SkTDArray<SkPoint> pts;
+        auto randPt = [&rand, &pts]() {
+            // Snap some points to a coarse grid so queries land on vertices and flat edges.
+            SkPoint pt = SkPoint::Make(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+            if (rand.nextBool()) {
+                pt.set(SkScalarRoundToScalar(pt.fX / 10) * 10,
+                       SkScalarRoundToScalar(pt.fY / 10) * 10);
+            }
+            *pts.push() = pt;
+            return pt;
+        };
+        for (int contour = 0; contour < 8; ++contour) {
+            path.moveTo(randPt());
+            for (int i = 0; i < 20; ++i) {
+                switch (rand.nextULessThan(4)) {
+                    case 0: path.lineTo(randPt()); break;
+                    case 1: path.quadTo(randPt(), randPt()); break;
+                    case 2: path.conicTo(randPt(), randPt(), rand.nextRangeF(0.25f, 2)); break;
+                    case 3: path.cubicTo(randPt(), randPt(), randPt()); break;
+                }
+            }
+            if (contour & 1) {
+                path.close();
+            }
+        }
+        SkPath volatilePath(path);
+        volatilePath.setIsVolatile(true);
+
+        for (int i = 0; i < 2000; ++i) {
+            SkPoint pt = SkPoint::Make(rand.nextRangeF(-5, 105), rand.nextRangeF(-5, 105));
+            REPORTER_ASSERT(reporter, path.contains(pt.fX, pt.fY) ==
+                                      volatilePath.contains(pt.fX, pt.fY));
+        }
+        for (const SkPoint& pt : pts) {
+            REPORTER_ASSERT(reporter, path.contains(pt.fX, pt.fY) ==
+                                      volatilePath.contains(pt.fX, pt.fY));
+        }
+
+        // Editing the path must not reuse the old index.
+        path.offset(50, 0);
+        volatilePath.offset(50, 0);
+        for (int i = 0; i < 500; ++i) {
+            SkPoint pt = SkPoint::Make(rand.nextRangeF(45, 155), rand.nextRangeF(-5, 105));
+            REPORTER_ASSERT(reporter, path.contains(pt.fX, pt.fY) ==
+                                      volatilePath.contains(pt.fX, pt.fY));
+        }
+    }
+}
+
 DEF_TEST(Paths, reporter) {
     test_fuzz_crbug_647922();
     test_fuzz_crbug_643933();
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkData.h"
+#include "SkGlyphCache.h"
+#include "SkGraphics.h"
+#include "SkStrikeCache.h"
+#include "SkTHash.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+namespace {
+
+class MemoryFontCache : public SkGraphics::PersistentFontCache {
+public:
+    sk_sp<SkData> load(const SkData& key) override {
+        fLoads++;
+        sk_sp<SkData>* data = fMap.find(SkString((const char*)key.data(), key.size()));
+        return data ? *data : nullptr;
+    }
+
+    void store(const SkData& key, const SkData& data) override {
+        fStores++;
+        fMap.set(SkString((const char*)key.data(), key.size()),
+                 SkData::MakeWithCopy(data.data(), data.size()));
+    }
+
+    SkTHashMap<SkString, sk_sp<SkData>> fMap;
+    int fLoads  = 0;
+    int fStores = 0;
+};
+
+}  // namespace
+
+static const char kText[] = "Hamburgefons";
+
+static SkExclusiveStrikePtr find_or_create(SkStrikeCache* strikeCache, const SkPaint& paint) {
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            paint, nullptr, SkScalerContextFlags::kNone, nullptr, &ad, &effects);
+    return strikeCache->findOrCreateStrikeExclusive(*desc, effects, *paint.getTypeface());
+}
+
+DEF_TEST(PersistentFontCache, r) {
+    SkPaint paint;
+    paint.setTypeface(MakeResourceAsTypeface("fonts/Roboto-Regular.ttf"));
+    if (!paint.getTypeface()) {
+        INFOF(r, "Could not load fonts/Roboto-Regular.ttf; skipping.");
+        return;
+    }
+    paint.setAntiAlias(true);
+    paint.setTextSize(20);
+
+    SkGlyphID glyphIDs[sizeof(kText)];
+    int glyphCount = paint.getTypeface()->charsToGlyphs(kText, SkTypeface::kUTF8_Encoding,
+                                                        glyphIDs, sizeof(kText) - 1);
+
+    MemoryFontCache store;
+    SkAutoTMalloc<uint8_t> images[sizeof(kText)];
+    bool hasPath[sizeof(kText)] = {};
+    {
+        SkStrikeCache strikeCache;
+        strikeCache.setPersistentCache(&store);
+        {
+            auto strike = find_or_create(&strikeCache, paint);
+            for (int i = 0; i < glyphCount; i++) {
+                const SkGlyph& glyph = strike->getGlyphIDMetrics(glyphIDs[i]);
+                hasPath[i] = strike->findPath(glyph) != nullptr;
+                if (const void* image = strike->findImage(glyph)) {
+                    images[i].reset(glyph.computeImageSize());
+                    memcpy(images[i].get(), image, glyph.computeImageSize());
+                }
+            }
+        }
+        strikeCache.storeAll();
+        REPORTER_ASSERT(r, store.fStores == 1);
+
+        // Nothing new to store.
+        strikeCache.storeAll();
+        REPORTER_ASSERT(r, store.fStores == 1);
+    }
+
+    SkStrikeCache strikeCache;
+    strikeCache.setPersistentCache(&store);
+    auto strike = find_or_create(&strikeCache, paint);
+    REPORTER_ASSERT(r, store.fLoads == 2);
+    REPORTER_ASSERT(r, strike->countCachedGlyphs() > 0);
+    for (int i = 0; i < glyphCount; i++) {
+        REPORTER_ASSERT(r, strike->isGlyphCached(glyphIDs[i], 0, 0));
+        const SkGlyph& glyph = strike->getGlyphIDMetrics(glyphIDs[i]);
+        if (images[i]) {
+            REPORTER_ASSERT(r, glyph.fImage);
+            REPORTER_ASSERT(r, glyph.fImage &&
+                               0 == memcmp(glyph.fImage, images[i].get(),
+                                           glyph.computeImageSize()));
+        }
+        if (hasPath[i]) {
+            REPORTER_ASSERT(r, glyph.fPathData && glyph.fPathData->fPath);
+        }
+    }
+
+    // A strike only loads what's stored for exactly its descriptor.
+    paint.setTextSize(21);
+    auto other = find_or_create(&strikeCache, paint);
+    REPORTER_ASSERT(r, other->countCachedGlyphs() == 0);
+
+    // Garbage is rejected without crashing.
+    SkGlyphCache* cache = strike.get();
+    const char garbage[] = "not a strike";
+    REPORTER_ASSERT(r, !cache->deserializeGlyphs(garbage, sizeof(garbage)));
+    sk_sp<SkData> glyphs = cache->serializeGlyphs();
+    REPORTER_ASSERT(r, !other->deserializeGlyphs(glyphs->data(), glyphs->size() / 2));
+}
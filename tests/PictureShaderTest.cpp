@@ -78,3 +78,37 @@ DEF_TEST(PictureShader_caching, reporter) {
     // All but the local ref should be gone now.
     REPORTER_ASSERT(reporter, picture->unique());
 }
+
+#ifdef SK_DEBUG
+// Test that nearby scales share a cached tile, and that mip-mapped draws reuse larger tiles.
+DEF_TEST(PictureShader_scaleBuckets, reporter) {
+    SkPictureRecorder recorder;
+    recorder.beginRecording(100, 100)->drawColor(SK_ColorGREEN);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+    SkPaint paint;
+    paint.setShader(SkPictureShader::Make(picture, SkShader::kRepeat_TileMode,
+                                          SkShader::kRepeat_TileMode, nullptr, nullptr));
+    // Every cached tile holds a ref on the picture.
+    const int32_t baseRefs = picture->getRefCnt();
+
+    auto draw = [&](SkScalar scale, SkFilterQuality quality) {
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->save();
+        canvas->scale(scale, scale);
+        paint.setFilterQuality(quality);
+        canvas->drawPaint(paint);
+        canvas->restore();
+        return picture->getRefCnt() - baseRefs;
+    };
+
+    REPORTER_ASSERT(reporter, 1 == draw(1.05f, kNone_SkFilterQuality));
+    REPORTER_ASSERT(reporter, 1 == draw(1.15f, kNone_SkFilterQuality));
+    REPORTER_ASSERT(reporter, 2 == draw(0.75f, kNone_SkFilterQuality));
+    // The 0.75 tile is one bucket larger than a 0.6 one, so mip-mapping can use it...
+    REPORTER_ASSERT(reporter, 2 == draw(0.6f, kMedium_SkFilterQuality));
+    // ... but sampling without mips needs its own.
+    REPORTER_ASSERT(reporter, 3 == draw(0.6f, kNone_SkFilterQuality));
+}
+#endif
@@ -14,10 +14,13 @@
 #include "SkClipOpPriv.h"
 #include "SkColor.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFontStyle.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkMatrix.h"
 #include "SkMiniRecorder.h"
+#include "SkMultiPictureDraw.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkPicturePriv.h"
@@ -28,6 +31,7 @@
 #include "SkRectPriv.h"
 #include "SkRefCnt.h"
 #include "SkScalar.h"
+#include "SkSerialProcs.h"
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkTypeface.h"
@@ -762,6 +766,42 @@ DEF_TEST(MiniRecorderLeftHanging, r) {
     // Don't call rec.detachPicture().  Test succeeds by not asserting or leaking the shader.
 }
 
+DEF_TEST(MiniRecorder_SeveralOps, r) {
+    SkPaint paint;
+    paint.setShader(SkShader::MakeColorShader(SK_ColorRED));
+
+    SkMiniRecorder rec;
+    for (int i = 0; i < SkMiniRecorder::kMaxOps; i++) {
+        REPORTER_ASSERT(r, rec.drawRect(SkRect::MakeXYWH(10*i, 0, 10, 10), paint));
+    }
+    REPORTER_ASSERT(r, !rec.drawRect(SkRect::MakeWH(10, 10), paint));
+    REPORTER_ASSERT(r, SkMiniRecorder::kMaxOps == rec.count());
+
+    sk_sp<SkPicture> pic = rec.detachAsPicture(nullptr);
+    REPORTER_ASSERT(r, 0 == rec.count());
+    REPORTER_ASSERT(r, !SkPicturePriv::AsSkBigPicture(pic));
+    REPORTER_ASSERT(r, SkMiniRecorder::kMaxOps == pic->approximateOpCount());
+    REPORTER_ASSERT(r, SkRect::MakeWH(10*SkMiniRecorder::kMaxOps, 10) == pic->cullRect());
+
+    // A few draws recorded normally play back the same as any other picture.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(20, 20));
+    canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+    paint.setColor(SK_ColorBLUE);
+    paint.setShader(nullptr);
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 10, 10), paint);
+    pic = recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, 2 == pic->approximateOpCount());
+
+    SkBitmap bm;
+    bm.allocN32Pixels(20, 20);
+    bm.eraseColor(SK_ColorWHITE);
+    SkCanvas(bm).drawPicture(pic);
+    REPORTER_ASSERT(r, SK_ColorRED  == bm.getColor(2, 2));
+    REPORTER_ASSERT(r, SK_ColorBLUE == bm.getColor(7, 7));
+    REPORTER_ASSERT(r, SK_ColorWHITE == bm.getColor(17, 2));
+}
+
 DEF_TEST(Picture_preserveCullRect, r) {
     SkPictureRecorder recorder;
 
@@ -802,7 +842,7 @@ DEF_TEST(Picture_UpdatedCull_1, r) {
     REPORTER_ASSERT(r, pic->cullRect() == SkRectPriv::MakeLargest());
 }
 DEF_TEST(Picture_UpdatedCull_2, r) {
-    // Testing >1 draw exercises SkBigPicture.
+    // Testing >1 draw exercises SkBigPicture with a BBH, and multi-op SkMiniPictures without.
     SkRTreeFactory factory;
     SkPictureRecorder recorder;
 
@@ -873,3 +913,162 @@ DEF_TEST(Picture_empty_serial, reporter) {
     REPORTER_ASSERT(reporter, pic2);
 }
 
+
+static sk_sp<SkPicture> make_busy_picture(int size, bool withLayer) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(size), SkIntToScalar(size),
+                                               &factory);
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkPath clip;
+    clip.addCircle(size * 0.5f, size * 0.5f, size * 0.45f);
+    canvas->clipPath(clip, true);
+    if (withLayer) {
+        canvas->saveLayerAlpha(nullptr, 0x80);
+    }
+    for (int i = 0; i < 200; ++i) {
+        SkPath path;
+        path.moveTo(rand.nextRangeF(0, size), rand.nextRangeF(0, size));
+        for (int j = 0; j < 3; ++j) {
+            path.quadTo(rand.nextRangeF(0, size), rand.nextRangeF(0, size),
+                        rand.nextRangeF(0, size), rand.nextRangeF(0, size));
+        }
+        paint.setColor(rand.nextU() | 0x40000000);
+        paint.setDither(i % 2 == 0);
+        paint.setStyle(i % 3 == 0 ? SkPaint::kStroke_Style : SkPaint::kFill_Style);
+        paint.setStrokeWidth(rand.nextRangeF(0, 5));
+        canvas->drawPath(path, paint);
+    }
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setTextSize(40);
+    for (int i = 0; i < 20; ++i) {
+        canvas->drawString("banded", rand.nextRangeF(0, size), rand.nextRangeF(0, size), paint);
+    }
+    if (withLayer) {
+        canvas->restore();
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+// Raster draws of large pictures are split into bands of rows, which must not change pixels.
+DEF_TEST(MultiPictureDraw_RasterBands, r) {
+    const int kSize = 1024;
+    for (bool withLayer : { false, true }) {
+        sk_sp<SkPicture> picture = make_busy_picture(kSize, withLayer);
+        SkMatrix matrix = SkMatrix::MakeScale(0.9f, 1.1f);
+        matrix.postTranslate(20.5f, -30.25f);
+
+        SkBitmap serial, banded;
+        serial.allocN32Pixels(kSize, kSize);
+        banded.allocN32Pixels(kSize, kSize);
+        serial.eraseColor(SK_ColorWHITE);
+        banded.eraseColor(SK_ColorWHITE);
+
+        SkCanvas serialCanvas(serial);
+        serialCanvas.clipRect(SkRect::MakeXYWH(7, 3, kSize - 20, kSize - 10));
+        serialCanvas.drawPicture(picture, &matrix, nullptr);
+
+        SkCanvas bandedCanvas(banded);
+        bandedCanvas.clipRect(SkRect::MakeXYWH(7, 3, kSize - 20, kSize - 10));
+        SkMultiPictureDraw mpd;
+        mpd.add(&bandedCanvas, picture.get(), &matrix);
+        SkTDArray<SkMultiPictureDraw::TileTiming> timings;
+        mpd.draw(false, &timings);
+
+        if (withLayer) {
+            REPORTER_ASSERT(r, timings.count() == 1);
+        } else {
+            REPORTER_ASSERT(r, timings.count() > 1);
+        }
+        int rows = 0;
+        for (const auto& timing : timings) {
+            REPORTER_ASSERT(r, 0 == timing.fDrawIndex);
+            REPORTER_ASSERT(r, timing.fMs >= 0);
+            rows += timing.fBounds.height();
+        }
+        REPORTER_ASSERT(r, kSize - 10 == rows);
+
+        for (int y = 0; y < kSize; ++y) {
+            REPORTER_ASSERT(r, !memcmp(serial.getAddr32(0, y), banded.getAddr32(0, y),
+                                       kSize * sizeof(uint32_t)));
+        }
+    }
+}
+
+// Pictures loaded from an SkData (say, a mapped file) share its bytes for encoded images.
+DEF_TEST(Picture_MakeFromDataSharesImages, r) {
+    SkBitmap bm;
+    make_bm(&bm, 40, 30, SK_ColorBLUE, true);
+    sk_sp<SkData> png = SkImage::MakeFromBitmap(bm)->encodeToData();
+    REPORTER_ASSERT(r, png);
+    sk_sp<SkImage> image = SkImage::MakeFromEncoded(png);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    canvas->drawColor(SK_ColorWHITE);
+    canvas->drawImage(image, 10, 20);
+    sk_sp<SkData> serialized = recorder.finishRecordingAsPicture()->serialize();
+
+    class ImageCatcher : public SkCanvas {
+    public:
+        ImageCatcher() : SkCanvas(100, 100) {}
+        void onDrawImage(const SkImage* image, SkScalar, SkScalar, const SkPaint*) override {
+            fEncoded = image->refEncodedData();
+        }
+        sk_sp<SkData> fEncoded;
+    };
+
+    sk_sp<SkPicture> loaded = SkPicture::MakeFromData(serialized.get());
+    REPORTER_ASSERT(r, loaded);
+    ImageCatcher catcher;
+    loaded->playback(&catcher);
+    REPORTER_ASSERT(r, catcher.fEncoded && catcher.fEncoded->equals(png.get()));
+
+    const char* begin = (const char*)serialized->data();
+    const char* encoded = catcher.fEncoded ? (const char*)catcher.fEncoded->data() : nullptr;
+    REPORTER_ASSERT(r, encoded >= begin && encoded < begin + serialized->size());
+
+    // Raw pointers can't be shared, so the image is copied out.
+    loaded = SkPicture::MakeFromData(serialized->data(), serialized->size());
+    REPORTER_ASSERT(r, loaded);
+    loaded->playback(&catcher);
+    encoded = catcher.fEncoded ? (const char*)catcher.fEncoded->data() : nullptr;
+    REPORTER_ASSERT(r, encoded && (encoded < begin || encoded >= begin + serialized->size()));
+}
+
+// Images may be made on an executor's threads while deserializing; the result is the same.
+DEF_TEST(Picture_DeserializeWithExecutor, r) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    for (int i = 0; i < 8; ++i) {
+        SkBitmap bm;
+        make_bm(&bm, 10 + i, 10, SkColorSetARGB(0xFF, 30 * i, 0x80, 0xFF - 30 * i), true);
+        sk_sp<SkImage> image = SkImage::MakeFromEncoded(
+                SkImage::MakeFromBitmap(bm)->encodeToData());
+        canvas->drawImage(image, 5.0f * i, 11.0f * i);
+    }
+    sk_sp<SkData> serialized = recorder.finishRecordingAsPicture()->serialize();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkDeserialProcs procs;
+    procs.fExecutor = executor.get();
+    sk_sp<SkPicture> serial   = SkPicture::MakeFromData(serialized.get()),
+                     parallel = SkPicture::MakeFromData(serialized.get(), &procs);
+    REPORTER_ASSERT(r, serial && parallel);
+    if (!serial || !parallel) {
+        return;
+    }
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(100, 100);
+    actual.allocN32Pixels(100, 100);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas(expected).drawPicture(serial);
+    SkCanvas(actual).drawPicture(parallel);
+    REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                               expected.computeByteSize()));
+}
@@ -109,6 +109,7 @@ DEF_TEST(PolyUtils, reporter) {
     triangleIndices.rewind();
     REPORTER_ASSERT(reporter, SkTriangulateSimplePolygon(poly.begin(), indexMap, poly.count(),
                                                          &triangleIndices));
+    REPORTER_ASSERT(reporter, triangleIndices.count() == 3 * (poly.count() - 2));
 
     // translate far enough to obliterate some low bits
     for (int i = 0; i < poly.count(); ++i) {
@@ -89,3 +89,31 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+// Trees this big are built in parallel; they must find the same ops, in the same order.
+DEF_TEST(RTree_Large, reporter) {
+    const int kNumRects = 100000;
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(kNumRects);
+    for (int i = 0; i < kNumRects; ++i) {
+        rects[i] = SkRect::MakeXYWH(rand.nextRangeF(0, 1000), rand.nextRangeF(0, 1000),
+                                    rand.nextRangeF(1, 20),   rand.nextRangeF(1, 20));
+    }
+
+    SkRTree rtree;
+    rtree.insert(rects.get(), kNumRects);
+    REPORTER_ASSERT(reporter, kNumRects == rtree.getCount());
+
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        SkRect query = SkRect::MakeXYWH(rand.nextRangeF(0, 1000), rand.nextRangeF(0, 1000),
+                                        rand.nextRangeF(0, 50),   rand.nextRangeF(0, 50));
+        SkTDArray<int> hits, expected;
+        rtree.search(query, &hits);
+        for (int j = 0; j < kNumRects; ++j) {
+            if (SkRect::Intersects(query, rects[j])) {
+                expected.push_back(j);
+            }
+        }
+        REPORTER_ASSERT(reporter, hits == expected);
+    }
+}
@@ -688,3 +688,45 @@ DEF_TEST(ReadPixels_ValidConversion, reporter) {
         }
     }
 }
+
+// Big conversions are split into bands of rows, which must convert exactly like small ones.
+DEF_TEST(ReadPixels_LargeMatchesRows, reporter) {
+    const int kW = 1024, kH = 601;
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::MakeN32(kW, kH, kPremul_SkAlphaType, SkColorSpace::MakeSRGB()));
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            uint8_t a = (x + y) & 0xFF;
+            *src.getAddr32(x, y) = SkPreMultiplyARGB(a, x & 0xFF, y & 0xFF, (x ^ y) & 0xFF);
+        }
+    }
+
+    const SkImageInfo kDstInfos[] = {
+        src.info().makeColorType(kBGRA_8888_SkColorType),
+        src.info().makeColorType(kRGBA_8888_SkColorType).makeAlphaType(kUnpremul_SkAlphaType),
+        src.info().makeColorType(kAlpha_8_SkColorType),
+        src.info().makeColorType(kRGBA_F16_SkColorType)
+                  .makeColorSpace(SkColorSpace::MakeSRGBLinear()),
+    };
+    for (const SkImageInfo& dstInfo : kDstInfos) {
+        SkBitmap whole, rows;
+        whole.allocPixels(dstInfo);
+        rows.allocPixels(dstInfo);
+        REPORTER_ASSERT(reporter, src.readPixels(whole.pixmap()));
+
+        // 7 rows at a time is far too little to split.
+        for (int y = 0; y < kH; y += 7) {
+            SkPixmap band;
+            SkAssertResult(rows.pixmap().extractSubset(&band,
+                                                       SkIRect::MakeXYWH(0, y, kW,
+                                                                         SkTMin(7, kH - y))));
+            REPORTER_ASSERT(reporter, src.readPixels(band, 0, y));
+        }
+
+        bool same = true;
+        for (int y = 0; y < kH; ++y) {
+            same &= 0 == memcmp(whole.getAddr(0, y), rows.getAddr(0, y), dstInfo.minRowBytes());
+        }
+        REPORTER_ASSERT(reporter, same, "color type %d", dstInfo.colorType());
+    }
+}
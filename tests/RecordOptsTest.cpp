@@ -427,3 +427,88 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent;
+    opaque.setColor(SK_ColorBLUE);
+    translucent.setColor(0x800000FF);
+
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());                 // 0
+    recorder.drawOval(SkRect::MakeXYWH(10, 10, 40, 40), SkPaint());         // 1
+    recorder.drawRect(SkRect::MakeXYWH(250, 0, 100, 100), SkPaint());       // 2: sticks out
+    recorder.saveLayer(nullptr, nullptr);                                   // 3
+        recorder.drawRect(SkRect::MakeWH(20, 20), SkPaint());               // 4
+    recorder.restore();                                                     // 5
+    recorder.drawRect(SkRect::MakeWH(200, 200), translucent);               // 6
+    recorder.save();                                                        // 7
+        recorder.clipRect(SkRect::MakeWH(50, 50));                          // 8
+        recorder.drawRect(SkRect::MakeWH(200, 200), opaque);                // 9: covers 50x50
+    recorder.restore();                                                     // 10
+    recorder.drawRect(SkRect::MakeWH(200, 200), translucent);               // 11: doesn't occlude
+
+    SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H));
+
+    // The clipped rect only covers the top left 50x50: the oval and the whole layer fit in there.
+    for (int i : {1, 3, 4, 5}) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    REPORTER_ASSERT(r, 5 == count_instances_of_type<SkRecords::DrawRect>(record));
+
+    recorder.drawRect(SkRect::MakeWH(300, 300), opaque);                    // 12
+    SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H));
+
+    for (int i : {0, 1, 3, 4, 5, 6, 9, 11}) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    assert_type<SkRecords::DrawRect>(r, record, 2);
+    assert_type<SkRecords::Save>    (r, record, 7);
+    assert_type<SkRecords::ClipRect>(r, record, 8);
+    assert_type<SkRecords::Restore> (r, record, 10);
+    assert_type<SkRecords::DrawRect>(r, record, 12);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws_DrawPaint, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque;
+    opaque.setColor(SK_ColorGREEN);
+
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());     // 0: occluded
+    recorder.clipRect(SkRect::MakeWH(50, 50), true);            // 1
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());       // 2: occluded
+    recorder.drawPaint(opaque);                                 // 3: only covers the clip
+
+    SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H));
+    assert_type<SkRecords::DrawRect>(r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 2);
+    assert_type<SkRecords::DrawPaint>(r, record, 3);
+}
+
+DEF_TEST(RecordOpts_NoopUnusedClips, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.save();                                            // 0
+        recorder.clipRect(SkRect::MakeWH(200, 200));            // 1: used
+        recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint()); // 2
+        recorder.clipRect(SkRect::MakeWH(50, 50));              // 3: unused
+        recorder.save();                                        // 4
+            recorder.clipRect(SkRect::MakeWH(20, 20));          // 5: unused
+        recorder.restore();                                     // 6
+    recorder.restore();                                         // 7
+    recorder.clipRect(SkRect::MakeWH(10, 10));                  // 8: used by the layer
+    recorder.saveLayer(nullptr, nullptr);                       // 9
+    recorder.restore();                                         // 10
+    recorder.clipRect(SkRect::MakeWH(5, 5));                    // 11: unused
+
+    SkRecordNoopUnusedClips(&record);
+    assert_type<SkRecords::ClipRect>(r, record, 1);
+    assert_type<SkRecords::NoOp>    (r, record, 3);
+    assert_type<SkRecords::NoOp>    (r, record, 5);
+    assert_type<SkRecords::ClipRect>(r, record, 8);
+    assert_type<SkRecords::NoOp>    (r, record, 11);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#include "GrContextFactory.h"
+#include "GrContextOptions.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+using sk_gpu_test::GrContextFactory;
+
+static constexpr int kWidth = 64;
+static constexpr int kHeight = 8;
+
+static sk_sp<SkShader> make_gradient(int index) {
+    const SkPoint pts[] = { { 0, 0 }, { kWidth, 0 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorYELLOW,
+                               SK_ColorCYAN };
+    const SkScalar hardStop[] = { 0, 0.5f, 0.5f, 1 };
+    switch (index) {
+        case 0:  // single interval
+            return SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkShader::kClamp_TileMode);
+        case 1:  // dual interval
+            return SkGradientShader::MakeLinear(pts, colors, nullptr, 3, SkShader::kClamp_TileMode);
+        case 2:  // dual interval with a hard stop
+            return SkGradientShader::MakeLinear(pts, colors, hardStop, 4,
+                                                SkShader::kClamp_TileMode);
+        case 3:  // unrolled
+            return SkGradientShader::MakeLinear(pts, colors, nullptr, 5, SkShader::kClamp_TileMode);
+    }
+    return nullptr;
+}
+static constexpr int kGradientCount = 4;
+
+static bool draw(GrContext* context, int index, SkBitmap* result) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kWidth, kHeight);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return false;
+    }
+    SkPaint paint;
+    paint.setShader(make_gradient(index));
+    surface->getCanvas()->drawPaint(paint);
+    result->allocPixels(info);
+    return surface->readPixels(*result, 0, 0);
+}
+
+static bool nearly_equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            SkColor ca = a.getColor(x, y), cb = b.getColor(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (SkTAbs((int)((ca >> shift) & 0xFF) - (int)((cb >> shift) & 0xFF)) > 2) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ReduceProgramVariants, reporter, ctxInfo) {
+    GrContextOptions options(ctxInfo.options());
+    options.fReduceProgramVariants = true;
+    GrContextFactory factory(options);
+    GrContext* context = factory.get(ctxInfo.type());
+    REPORTER_ASSERT(reporter, context);
+    if (!context) {
+        return;
+    }
+
+    // Gradients that would otherwise each get a colorizer of their own draw the same with the
+    // general one...
+    for (int i = 0; i < kGradientCount; ++i) {
+        SkBitmap expected, actual;
+        REPORTER_ASSERT(reporter, draw(ctxInfo.grContext(), i, &expected));
+        REPORTER_ASSERT(reporter, draw(context, i, &actual));
+        REPORTER_ASSERT(reporter, nearly_equal(expected, actual), "gradient %d", i);
+    }
+
+#if GR_GPU_STATS
+    // ...and so share one program.
+    GrContextFactory freshFactory(options);
+    context = freshFactory.get(ctxInfo.type());
+    GrGpu::Stats* stats = context->contextPriv().getGpu()->stats();
+    SkBitmap result;
+    REPORTER_ASSERT(reporter, draw(context, 0, &result));
+    int compilations = stats->shaderCompilations();
+    for (int i = 1; i < kGradientCount; ++i) {
+        REPORTER_ASSERT(reporter, draw(context, i, &result));
+    }
+    REPORTER_ASSERT(reporter, compilations == stats->shaderCompilations());
+#endif
+}
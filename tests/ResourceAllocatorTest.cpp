@@ -202,7 +202,14 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ResourceAllocatorTest, reporter, ctxInfo) {
         // Two non-overlapping intervals w/ different exact sizes should not share
         { { 56,    kRT, kRGBA, kE, 0, kTL }, { 54,    kRT, kRGBA, kE, 0, kTL }, kDontShare },
         // Two non-overlapping intervals w/ _very different_ approx sizes should not share
-        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 127,   kRT, kRGBA, kA, 0, kTL }, kDontShare },
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 63,    kRT, kRGBA, kA, 0, kTL }, kDontShare },
+        // An approx proxy that isn't functionally exact can reuse a surface up to twice its bin
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 127,   kRT, kRGBA, kA, 0, kTL }, kShare },
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 100,   kRT, kRGBA, kA, 0, kTL }, kShare },
+        // ... but not one that is smaller, or when it expects to fill its surface
+        { { 127,   kRT, kRGBA, kA, 0, kTL }, { 255,   kRT, kRGBA, kA, 0, kTL }, kDontShare },
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 128,   kRT, kRGBA, kA, 0, kTL }, kDontShare },
+        { { 255,   kRT, kRGBA, kE, 0, kTL }, { 127,   kRT, kRGBA, kE, 0, kTL }, kDontShare },
         // Two non-overlapping intervals w/ different MSAA sample counts should not share
         { { 64,    kRT, kRGBA, kA, k2, kTL },{ 64,    kRT, kRGBA, kA, k4, kTL}, k2 == k4 },
         // Two non-overlapping intervals w/ different configs should not share
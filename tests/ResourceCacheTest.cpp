@@ -82,6 +82,46 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ResourceCacheCache, reporter, ctxInfo) {
     context->setResourceCacheLimits(oldMaxNum, oldMaxBytes);
 }
 
+// Panning across a bitmap that is drawn in tiles should keep hitting the same cached tiles.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ResourceCacheTiledBitmapPan, reporter, ctxInfo) {
+#ifdef SK_DEBUG
+    GrContext* context = ctxInfo.grContext();
+    GrResourceCache* cache = context->contextPriv().getResourceCache();
+    context->purgeUnlockedResources(false);
+
+    SkBitmap src;
+    src.allocN32Pixels(2048, 2048);
+    src.eraseColor(SK_ColorBLUE);
+    size_t srcSize = src.computeByteSize();
+
+    size_t initialCacheSize;
+    context->getResourceCacheUsage(nullptr, &initialCacheSize);
+    if (initialCacheSize > srcSize) {
+        return;
+    }
+
+    int oldMaxNum;
+    size_t oldMaxBytes;
+    context->getResourceCacheLimits(&oldMaxNum, &oldMaxBytes);
+    // Small enough that the bitmap is drawn in tiles, big enough that the tile stays cached.
+    context->setResourceCacheLimits(oldMaxNum, 2 * srcSize - 1);
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(256, 256);
+    auto surface(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info));
+    SkPaint paint;
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    for (int i = 0; i < 8; ++i) {
+        SkRect srcRect = SkRect::MakeXYWH(100 + 16 * i, 100 + 8 * i, 256, 256);
+        surface->getCanvas()->drawBitmapRect(src, srcRect, SkRect::MakeWH(256, 256), &paint,
+                                             SkCanvas::kStrict_SrcRectConstraint);
+        context->flush();
+        REPORTER_ASSERT(reporter, 1 == cache->countUniqueKeysWithTag("Image"));
+    }
+
+    context->setResourceCacheLimits(oldMaxNum, oldMaxBytes);
+#endif
+}
+
 static bool is_rendering_and_not_angle_es3(sk_gpu_test::GrContextFactory::ContextType type) {
     if (type == sk_gpu_test::GrContextFactory::kANGLE_D3D11_ES3_ContextType ||
         type == sk_gpu_test::GrContextFactory::kANGLE_GL_ES3_ContextType) {
@@ -1503,6 +1543,59 @@ static void test_tags(skiatest::Reporter* reporter) {
 #endif
 }
 
+static void test_partitions(skiatest::Reporter* reporter) {
+    Mock mock(10, 300);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+    GrGpu* gpu = context->contextPriv().getGpu();
+    typedef GrResourceCache::Partition Partition;
+
+    // Images outlive scratch resources when the cache is over budget.
+    cache->setPartitionLimits(Partition::kImages, SIZE_MAX, 1);
+
+    GrUniqueKey imageKey;
+    make_unique_key<0>(&imageKey, 0, "Image");
+    TestResource* image = new TestResource(gpu, SkBudgeted::kYes, 100);
+    REPORTER_ASSERT(reporter, 100 == cache->getPartitionBudgetedBytes(Partition::kScratch));
+    image->resourcePriv().setUniqueKey(imageKey);
+    REPORTER_ASSERT(reporter, 0 == cache->getPartitionBudgetedBytes(Partition::kScratch));
+    REPORTER_ASSERT(reporter, 100 == cache->getPartitionBudgetedBytes(Partition::kImages));
+    image->unref();
+    REPORTER_ASSERT(reporter, 100 == cache->getPartitionPurgeableBytes(Partition::kImages));
+
+    // A burst of scratch resources, all more recently used than the image.
+    for (int i = 0; i < 3; ++i) {
+        TestResource::CreateScratch(gpu, SkBudgeted::kYes, TestResource::kA_SimulatedProperty,
+                                    100)->unref();
+    }
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(imageKey));
+    REPORTER_ASSERT(reporter, 200 == cache->getPartitionBudgetedBytes(Partition::kScratch));
+    REPORTER_ASSERT(reporter, 300 == cache->getBudgetedResourceBytes());
+
+    // A partition's own limit is enforced even when the cache is within budget.
+    cache->setPartitionLimits(Partition::kScratch, 100, 0);
+    REPORTER_ASSERT(reporter, 100 == cache->getPartitionBudgetedBytes(Partition::kScratch));
+    REPORTER_ASSERT(reporter, 200 == cache->getBudgetedResourceBytes());
+
+    // A new keyless resource is scratch until it gets a unique key, and pushes the remaining
+    // scratch resource out meanwhile.
+    GrUniqueKey pathKey;
+    make_unique_key<0>(&pathKey, 1, "Path");
+    TestResource* path = new TestResource(gpu, SkBudgeted::kYes, 50);
+    REPORTER_ASSERT(reporter, 50 == cache->getPartitionBudgetedBytes(Partition::kScratch));
+    path->resourcePriv().setUniqueKey(pathKey);
+    REPORTER_ASSERT(reporter, 0 == cache->getPartitionBudgetedBytes(Partition::kScratch));
+    REPORTER_ASSERT(reporter, 50 == cache->getPartitionBudgetedBytes(Partition::kPaths));
+    path->unref();
+
+    // Purging one partition leaves the others alone.
+    cache->purgeUnlockedResources(Partition::kPaths);
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(pathKey));
+    REPORTER_ASSERT(reporter, 0 == cache->getPartitionBudgetedBytes(Partition::kPaths));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(imageKey));
+    REPORTER_ASSERT(reporter, 100 == cache->getBudgetedResourceBytes());
+}
+
 static void test_free_resource_messages(skiatest::Reporter* reporter) {
     Mock mock(10, 30000);
     GrContext* context = mock.context();
@@ -1561,6 +1654,7 @@ DEF_GPUTEST(ResourceCacheMisc, reporter, /* options */) {
     test_custom_data(reporter);
     test_abandoned(reporter);
     test_tags(reporter);
+    test_partitions(reporter);
     test_free_resource_messages(reporter);
 }
 
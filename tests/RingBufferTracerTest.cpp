@@ -0,0 +1,98 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkJSON.h"
+#include "SkRingBufferTracer.h"
+#include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkTraceEvent.h"
+#include "Test.h"
+
+using namespace skjson;
+
+static void add_complete_event(SkRingBufferTracer* tracer, const uint8_t* category, uint64_t n) {
+    const char* argName = "n";
+    uint8_t argType = TRACE_VALUE_TYPE_UINT;
+    SkEventTracer::Handle handle = tracer->addTraceEvent(TRACE_EVENT_PHASE_COMPLETE, category,
+                                                         "event", 0, 1, &argName, &argType, &n,
+                                                         TRACE_EVENT_FLAG_NONE);
+    tracer->updateTraceEventDuration(category, "event", handle);
+}
+
+static sk_sp<SkData> dump(const SkRingBufferTracer& tracer) {
+    SkDynamicMemoryWStream stream;
+    tracer.dumpJSON(&stream);
+    return stream.detachAsData();
+}
+
+DEF_TEST(RingBufferTracer_overwritesOldest, reporter) {
+    SkRingBufferTracer tracer(16);
+    const uint8_t* category = tracer.getCategoryGroupEnabled(TRACE_CATEGORY_PREFIX "skia");
+    REPORTER_ASSERT(reporter, *category);
+    REPORTER_ASSERT(reporter, !strcmp("skia", tracer.getCategoryGroupName(category)));
+
+    for (uint64_t i = 0; i < 40; ++i) {
+        add_complete_event(&tracer, category, i);
+    }
+
+    sk_sp<SkData> json = dump(tracer);
+    DOM dom(static_cast<const char*>(json->data()), json->size());
+    const ArrayValue* events = dom.root();
+    REPORTER_ASSERT(reporter, events && 16 == events->size());
+    if (!events) {
+        return;
+    }
+
+    // Only the newest 16 events are left, oldest first.
+    for (size_t i = 0; i < events->size(); ++i) {
+        const ObjectValue* event = (*events)[i];
+        REPORTER_ASSERT(reporter, event);
+        if (!event) {
+            return;
+        }
+        const StringValue* cat = (*event)["cat"];
+        const NumberValue* dur = (*event)["dur"];
+        const ObjectValue* args = (*event)["args"];
+        REPORTER_ASSERT(reporter, cat && !strcmp("skia", cat->begin()));
+        REPORTER_ASSERT(reporter, dur && **dur >= 0);
+        REPORTER_ASSERT(reporter, args);
+        if (args) {
+            const NumberValue* n = (*args)["n"];
+            REPORTER_ASSERT(reporter, n && 24 + i == **n);
+        }
+    }
+}
+
+DEF_TEST(RingBufferTracer_dumpWhileTracing, reporter) {
+    static constexpr int kThreads = 4;
+    static constexpr int kEventsPerThread = 64;
+
+    SkRingBufferTracer tracer(kEventsPerThread);
+    const uint8_t* category = tracer.getCategoryGroupEnabled("skia");
+
+    // Every dump taken while other threads trace must still be well formed.
+    SkTaskGroup().batch(kThreads + 1, [&](int i) {
+        if (i < kThreads) {
+            for (uint64_t n = 0; n < 10000; ++n) {
+                add_complete_event(&tracer, category, n);
+            }
+            return;
+        }
+        for (int j = 0; j < 20; ++j) {
+            sk_sp<SkData> json = dump(tracer);
+            DOM dom(static_cast<const char*>(json->data()), json->size());
+            const ArrayValue* events = dom.root();
+            REPORTER_ASSERT(reporter, events &&
+                                      events->size() <= (kThreads + 1) * kEventsPerThread);
+        }
+    });
+
+    sk_sp<SkData> json = dump(tracer);
+    DOM dom(static_cast<const char*>(json->data()), json->size());
+    const ArrayValue* events = dom.root();
+    REPORTER_ASSERT(reporter, events && events->size() > 0);
+}
@@ -17,6 +17,7 @@
 #include "SkCanvas.h"
 #include "SkColorFilter.h"
 #include "SkData.h"
+#include "SkGradientShader.h"
 #include "SkImage.h"
 #include "SkImageShader.h"
 #include "SkParse.h"
@@ -382,4 +383,52 @@ DEF_TEST(SVGDevice_ColorFilters, reporter) {
     REPORTER_ASSERT(reporter, strcmp(dom.findAttr(compositeElement, "operator"), "in") == 0);
 }
 
+static int count_elements(const SkDOM& dom, const SkDOM::Node* node, const char name[]) {
+    int count = 0;
+    for (const SkDOM::Node* child = dom.getFirstChild(node); child;
+         child = dom.getNextSibling(child)) {
+        if (dom.getType(child) == SkDOM::kElement_Type) {
+            count += !strcmp(dom.getName(child), name);
+            count += count_elements(dom, child, name);
+        }
+    }
+    return count;
+}
+
+DEF_TEST(SVGDevice_SharedResources, reporter) {
+    SkPath path;
+    path.moveTo(10.5f, 10.5f);
+    for (int i = 0; i < 10; ++i) {
+        path.lineTo(20.25f + i, 30.75f + 2 * i);
+    }
+    path.close();
+
+    const SkPoint pts[] = { { 0, 0 }, { 100, 100 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkPaint gradientPaint;
+    gradientPaint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                         SkShader::kClamp_TileMode));
+
+    SkDOM dom;
+    {
+        SkXMLParserWriter writer(dom.beginParsing());
+        std::unique_ptr<SkCanvas> svgCanvas = SkSVGCanvas::Make(SkRect::MakeWH(100, 100), &writer);
+        svgCanvas->clipRect(SkRect::MakeWH(50, 50));
+        for (int i = 0; i < 3; ++i) {
+            svgCanvas->translate(5, 5);
+            svgCanvas->drawPath(path, SkPaint());
+            svgCanvas->drawRect(SkRect::MakeWH(10, 10), gradientPaint);
+        }
+    }
+    const SkDOM::Node* root = dom.finishParsing();
+    ABORT_TEST(reporter, !root, "root element not found");
+
+    // The path is inlined the first time, and defined the second.
+    REPORTER_ASSERT(reporter, count_elements(dom, root, "path") == 2);
+    REPORTER_ASSERT(reporter, count_elements(dom, root, "use") == 2);
+    REPORTER_ASSERT(reporter, count_elements(dom, root, "linearGradient") == 1);
+    REPORTER_ASSERT(reporter, count_elements(dom, root, "clipPath") == 1);
+    REPORTER_ASSERT(reporter, count_elements(dom, root, "rect") == 3 + 1);
+}
+
 #endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkSegmentedPictureRecorder.h"
+#include "Test.h"
+
+static void record_rects(SkSegmentedPictureRecorder* recorder, uint32_t id, SkColor color,
+                         SkScalar x) {
+    SkCanvas* canvas = recorder->beginSegment(id, SkRect::MakeWH(100, 100));
+    SkPaint paint;
+    paint.setColor(color);
+    canvas->drawRect(SkRect::MakeXYWH(x, 10, 20, 20), paint);
+    canvas->drawRect(SkRect::MakeXYWH(x, 40, 20, 30), paint);
+}
+
+static SkBitmap draw(const SkPicture* picture) {
+    SkBitmap bm;
+    bm.allocN32Pixels(100, 100);
+    bm.eraseColor(SK_ColorWHITE);
+    SkCanvas(bm).drawPicture(picture);
+    return bm;
+}
+
+DEF_TEST(SegmentedPictureRecorder, r) {
+    SkSegmentedPictureRecorder recorder;
+    record_rects(&recorder, 7, SK_ColorRED, 10);
+    REPORTER_ASSERT(r, recorder.endSegment());
+    record_rects(&recorder, 3, SK_ColorBLUE, 20);
+    REPORTER_ASSERT(r, recorder.endSegment());
+    record_rects(&recorder, 5, SK_ColorGREEN, 60);
+    REPORTER_ASSERT(r, recorder.endSegment());
+
+    REPORTER_ASSERT(r, 3 == recorder.segmentCount());
+    REPORTER_ASSERT(r, 7 == recorder.segment(0).fID);
+    REPORTER_ASSERT(r, 3 == recorder.segment(1).fID);
+    REPORTER_ASSERT(r, SkRect::MakeLTRB(20, 10, 40, 70) == recorder.findSegment(3)->fBounds);
+    REPORTER_ASSERT(r, !recorder.findSegment(4));
+
+    // Re-recording the same content keeps the old picture.
+    const SkPicture* blue = recorder.findSegment(3)->fPicture.get();
+    const uint32_t blueHash = recorder.findSegment(3)->fContentHash;
+    record_rects(&recorder, 3, SK_ColorBLUE, 20);
+    REPORTER_ASSERT(r, !recorder.endSegment());
+    REPORTER_ASSERT(r, blue == recorder.findSegment(3)->fPicture.get());
+
+    // New content replaces the segment in place, leaving the others alone.
+    const SkPicture* red = recorder.findSegment(7)->fPicture.get();
+    record_rects(&recorder, 3, SK_ColorBLUE, 30);
+    REPORTER_ASSERT(r, recorder.endSegment());
+    REPORTER_ASSERT(r, 3 == recorder.segment(1).fID);
+    REPORTER_ASSERT(r, blueHash != recorder.findSegment(3)->fContentHash);
+    REPORTER_ASSERT(r, red == recorder.findSegment(7)->fPicture.get());
+
+    // The combined picture draws the same as recording everything at once.
+    SkPictureRecorder whole;
+    SkCanvas* canvas = whole.beginRecording(100, 100);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);
+    canvas->drawRect(SkRect::MakeXYWH(10, 40, 20, 30), paint);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(30, 10, 20, 20), paint);
+    canvas->drawRect(SkRect::MakeXYWH(30, 40, 20, 30), paint);
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(60, 10, 20, 20), paint);
+    canvas->drawRect(SkRect::MakeXYWH(60, 40, 20, 30), paint);
+
+    SkBitmap expected = draw(whole.finishRecordingAsPicture().get()),
+             actual   = draw(recorder.makePicture().get());
+    REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                               expected.computeByteSize()));
+
+    REPORTER_ASSERT(r, recorder.removeSegment(7));
+    REPORTER_ASSERT(r, !recorder.removeSegment(7));
+    REPORTER_ASSERT(r, 2 == recorder.segmentCount());
+    REPORTER_ASSERT(r, 3 == recorder.segment(0).fID);
+    REPORTER_ASSERT(r, 5 == recorder.segment(1).fID);
+}
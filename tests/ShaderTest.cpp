@@ -8,6 +8,7 @@
 #include "Test.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkImage.h"
 #include "SkPerlinNoiseShader.h"
 #include "SkRRect.h"
@@ -69,3 +70,50 @@ DEF_TEST(ComposeShaderSingle, reporter) {
     rr.setRectRadii({0, 0, 0, 0}, rd);
     canvas.drawRRect(rr, p);
 }
+
+// Fractal noise and turbulence are drawn by a SkRasterPipeline stage. These pixels come from the
+// scalar implementation it replaced, which rounded down to 8 bits before premultiplying.
+DEF_TEST(PerlinNoise_raster, reporter) {
+    const SkISize tile = {40, 30};
+    struct {
+        sk_sp<SkShader> fShader;
+        U8CPU           fAlpha;
+        SkColor         fExpected[4];  // Premultiplied, in ARGB order.
+    } tests[] = {
+        { SkPerlinNoiseShader::MakeFractalNoise(0.05f, 0.07f, 3, 2), 0xFF,
+          { 0x835a4b2f, 0x792d423a, 0x90404b42, 0x7c445734 } },
+        { SkPerlinNoiseShader::MakeTurbulence(0.1f, 0.03f, 4, 7), 0x80,
+          { 0x4a0c1c06, 0x26070e09, 0x1f050f14, 0x1a03050e } },
+        { SkPerlinNoiseShader::MakeFractalNoise(0.05f, 0.07f, 3, 2, &tile), 0xFF,
+          { 0x8051374c, 0xaf594f5f, 0xae625248, 0x963f6c4c } },
+        { SkPerlinNoiseShader::MakeTurbulence(0.1f, 0.03f, 5, 7, &tile), 0xFF,
+          { 0x45151107, 0x2806141b, 0x52121b31, 0x11010101 } },
+    };
+    const SkIPoint points[] = { {10, 10}, {100, 75}, {199, 149}, {57, 3} };
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(200, 150);
+    for (const auto& test : tests) {
+        bitmap.eraseColor(0);
+        SkCanvas canvas(bitmap);
+        canvas.translate(13.3f, -7);
+        canvas.scale(1.5f, 0.75f);
+        SkPaint paint;
+        paint.setShader(test.fShader);
+        paint.setAlpha(test.fAlpha);
+        canvas.drawPaint(paint);
+
+        for (int i = 0; i < 4; ++i) {
+            SkColor expected = test.fExpected[i];
+            SkPMColor actual = *bitmap.getAddr32(points[i].x(), points[i].y());
+            REPORTER_ASSERT(reporter,
+                            SkTAbs((int)SkGetPackedA32(actual) - (int)SkColorGetA(expected)) <= 2 &&
+                            SkTAbs((int)SkGetPackedR32(actual) - (int)SkColorGetR(expected)) <= 2 &&
+                            SkTAbs((int)SkGetPackedG32(actual) - (int)SkColorGetG(expected)) <= 2 &&
+                            SkTAbs((int)SkGetPackedB32(actual) - (int)SkColorGetB(expected)) <= 2,
+                            "%d: expected %08x, got %08x", i, expected,
+                            SkColorSetARGB(SkGetPackedA32(actual), SkGetPackedR32(actual),
+                                           SkGetPackedG32(actual), SkGetPackedB32(actual)));
+        }
+    }
+}
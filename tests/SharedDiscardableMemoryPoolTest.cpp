@@ -0,0 +1,158 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImage.h"
+#include "SkImageGenerator.h"
+#include "SkMakeUnique.h"
+#include "SkResourceCache.h"
+#include "SkSharedDiscardableMemoryPool.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+static constexpr size_t kPageSize = SkSharedDiscardableMemoryPool::kPageSize;
+
+// Two pools over one block of memory stand in for two processes sharing it.
+DEF_TEST(SharedDiscardableMemoryPool, reporter) {
+    const size_t kBytes = 5 * kPageSize;
+    SkAutoTMalloc<uint8_t> block(kBytes);
+    memset(block.get(), 0, kBytes);
+
+    sk_sp<SkSharedDiscardableMemoryPool> a = SkSharedDiscardableMemoryPool::Make(block, kBytes);
+    sk_sp<SkSharedDiscardableMemoryPool> b = SkSharedDiscardableMemoryPool::Make(block, kBytes);
+    REPORTER_ASSERT(reporter, a && b);
+    if (!a || !b) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, 4 * kPageSize == a->getByteLimit());
+    REPORTER_ASSERT(reporter, 0 == b->getBytesUsed());
+
+    // Every pool over the block must agree on its size.
+    REPORTER_ASSERT(reporter, !SkSharedDiscardableMemoryPool::Make(block, kBytes - kPageSize));
+
+    const char kKey[] = "image";
+    const size_t kImageBytes = kPageSize + 100;
+    std::unique_ptr<SkDiscardableMemory> written = a->createForKey(kKey, sizeof(kKey),
+                                                                   kImageBytes);
+    REPORTER_ASSERT(reporter, written);
+    REPORTER_ASSERT(reporter, 2 * kPageSize == b->getBytesUsed());
+    memset(written->data(), 0x5A, kImageBytes);
+
+    // Until it's published, nobody can find it, nor make it again.
+    size_t bytes = 0;
+    REPORTER_ASSERT(reporter, !b->find(kKey, sizeof(kKey), &bytes));
+    REPORTER_ASSERT(reporter, !b->createForKey(kKey, sizeof(kKey), kImageBytes));
+
+    a->publish(written.get());
+    written->unlock();
+    written.reset();
+
+    std::unique_ptr<SkDiscardableMemory> found = b->find(kKey, sizeof(kKey), &bytes);
+    REPORTER_ASSERT(reporter, found);
+    REPORTER_ASSERT(reporter, kImageBytes == bytes);
+    const uint8_t* pixels = static_cast<const uint8_t*>(found->data());
+    REPORTER_ASSERT(reporter, 0x5A == pixels[0] && 0x5A == pixels[kImageBytes - 1]);
+
+    // Locked memory can't be discarded to make room...
+    REPORTER_ASSERT(reporter, !a->create(3 * kPageSize));
+    found->unlock();
+
+    // ... but unlocked memory can.
+    std::unique_ptr<SkDiscardableMemory> anonymous(a->create(3 * kPageSize));
+    REPORTER_ASSERT(reporter, anonymous);
+    REPORTER_ASSERT(reporter, !found->lock());
+    REPORTER_ASSERT(reporter, !b->find(kKey, sizeof(kKey), &bytes));
+    REPORTER_ASSERT(reporter, 3 * kPageSize == b->getBytesUsed());
+
+    anonymous->unlock();
+    REPORTER_ASSERT(reporter, anonymous->lock());
+    anonymous->unlock();
+    b->purgeUnlocked();
+    REPORTER_ASSERT(reporter, !anonymous->lock());
+    REPORTER_ASSERT(reporter, 0 == a->getBytesUsed());
+
+    // Anonymous memory is freed when it's deleted.
+    anonymous.reset(b->create(100));
+    REPORTER_ASSERT(reporter, kPageSize == a->getBytesUsed());
+    anonymous->unlock();
+    anonymous.reset();
+    REPORTER_ASSERT(reporter, 0 == a->getBytesUsed());
+}
+
+namespace {
+
+// Claims to be encoded, but makes its pixels itself, counting how many times it does.
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(sk_sp<SkData> encoded, int* count)
+            : INHERITED(SkImageInfo::MakeN32Premul(32, 32))
+            , fEncoded(std::move(encoded))
+            , fCount(count) {}
+
+protected:
+    sk_sp<SkData> onRefEncodedData() override { return fEncoded; }
+
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        *fCount += 1;
+        SkBitmap bitmap;
+        bitmap.installPixels(info, pixels, rowBytes);
+        bitmap.eraseColor(SK_ColorBLUE);
+        bitmap.erase(SK_ColorRED, SkIRect::MakeWH(16, 16));
+        return true;
+    }
+
+private:
+    sk_sp<SkData> fEncoded;
+    int*          fCount;
+
+    typedef SkImageGenerator INHERITED;
+};
+
+}  // namespace
+
+DEF_TEST(SharedDiscardableMemoryPool_LazyImage, reporter) {
+    const size_t kBytes = 4 * kPageSize;
+    SkAutoTMalloc<uint8_t> block(kBytes);
+    memset(block.get(), 0, kBytes);
+    SkSharedDiscardableMemoryPool::SetGlobal(SkSharedDiscardableMemoryPool::Make(block, kBytes));
+
+    // Two images of the same encoded data have different IDs, just like images in two processes.
+    const char kEncoded[] = "not really an image";
+    sk_sp<SkData> encoded = SkData::MakeWithCopy(kEncoded, sizeof(kEncoded));
+    int count = 0;
+    sk_sp<SkImage> first = SkImage::MakeFromGenerator(
+            skstd::make_unique<CountingGenerator>(encoded, &count));
+    sk_sp<SkImage> second = SkImage::MakeFromGenerator(
+            skstd::make_unique<CountingGenerator>(encoded, &count));
+    REPORTER_ASSERT(reporter, first->uniqueID() != second->uniqueID());
+
+    SkBitmap firstPixels, secondPixels;
+    firstPixels.allocN32Pixels(32, 32);
+    secondPixels.allocN32Pixels(32, 32);
+    REPORTER_ASSERT(reporter, first->readPixels(firstPixels.pixmap(), 0, 0));
+    REPORTER_ASSERT(reporter, 1 == count);
+    REPORTER_ASSERT(reporter, second->readPixels(secondPixels.pixmap(), 0, 0));
+    REPORTER_ASSERT(reporter, 1 == count);
+    REPORTER_ASSERT(reporter, SK_ColorRED == secondPixels.getColor(0, 0));
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == secondPixels.getColor(31, 31));
+
+    // Subsets are keyed separately.
+    sk_sp<SkImage> subset = second->makeSubset(SkIRect::MakeXYWH(16, 16, 16, 16));
+    SkBitmap subsetPixels;
+    subsetPixels.allocN32Pixels(16, 16);
+    REPORTER_ASSERT(reporter, subset->readPixels(subsetPixels.pixmap(), 0, 0));
+    REPORTER_ASSERT(reporter, 2 == count);
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == subsetPixels.getColor(0, 0));
+
+    SkSharedDiscardableMemoryPool::SetGlobal(nullptr);
+    first.reset();
+    second.reset();
+    subset.reset();
+    SkResourceCache::PurgeAll();
+}
@@ -5,9 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "RecordTestUtils.h"
+#include "SkImage.h"
 #include "SkLiteDL.h"
 #include "SkLiteRecorder.h"
+#include "SkRecord.h"
+#include "SkRecorder.h"
 #include "SkRSXform.h"
+#include "SkSurface.h"
 #include "Test.h"
 
 DEF_TEST(SkLiteDL_basics, r) {
@@ -88,3 +93,51 @@ DEF_TEST(SkLiteRecorder_RSXformAlignment, r) {
     // We're just checking that this recorded our draw without SkASSERTing in Debug builds.
     REPORTER_ASSERT(r, !dl.empty());
 }
+
+DEF_TEST(SkLiteDL_drawInBatchOrder, r) {
+    auto surface = SkSurface::MakeRasterN32Premul(10, 10);
+    surface->getCanvas()->clear(SK_ColorGREEN);
+    sk_sp<SkImage> image = surface->makeImageSnapshot();
+
+    SkPaint blue, red;
+    blue.setColor(SK_ColorBLUE);
+    red.setColor(0x80FF0000);
+
+    // Images and rects in two columns, interleaved, then a rect over both columns.
+    SkLiteDL dl;
+    for (int i = 0; i < 5; i++) {
+        dl.drawImage(image, 0, i*20.0f, nullptr);
+        dl.drawRect(SkRect::MakeXYWH(20, i*20.0f, 10, 10), blue);
+    }
+    dl.drawRect(SkRect::MakeXYWH(5, 5, 20, 20), red);
+    dl.drawImage(image, 15, 15, nullptr);
+
+    SkRecord record;
+    SkRecorder recorder(&record, 100, 100);
+    dl.drawInBatchOrder(&recorder);
+
+    // The images all move ahead of the rects, and the red rect batches with the blue ones after
+    // everything it overlaps.  The last image can't move ahead of the red rect it overlaps.
+    REPORTER_ASSERT(r, 12 == record.count());
+    for (int i = 0; i < 5; i++) {
+        assert_type<SkRecords::DrawImage>(r, record, i);
+    }
+    for (int i = 5; i < 11; i++) {
+        assert_type<SkRecords::DrawRect>(r, record, i);
+    }
+    assert_type<SkRecords::DrawImage>(r, record, 11);
+
+    SkBitmap expected, actual;
+    for (SkBitmap* bm : {&expected, &actual}) {
+        bm->allocN32Pixels(100, 100);
+        bm->eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(*bm);
+        if (bm == &expected) {
+            dl.draw(&canvas);
+        } else {
+            dl.drawInBatchOrder(&canvas);
+        }
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+}
@@ -432,6 +432,24 @@ DEF_TEST(Sk4f_Load2, r) {
     REPORTER_ASSERT(r, y[3] == 7);
 }
 
+DEF_TEST(Sk4u_Load2, r) {
+    // Use values that aren't valid floats, to make sure nothing gets canonicalized.
+    uint32_t xy[8] = { 0xffc00000, 1, 0x7f800001, 3, 4, 0xffffffff, 6, 7 };
+
+    Sk4u x,y;
+    Sk4u::Load2(xy, &x,&y);
+
+    REPORTER_ASSERT(r, x[0] == 0xffc00000);
+    REPORTER_ASSERT(r, x[1] == 0x7f800001);
+    REPORTER_ASSERT(r, x[2] == 4);
+    REPORTER_ASSERT(r, x[3] == 6);
+
+    REPORTER_ASSERT(r, y[0] == 1);
+    REPORTER_ASSERT(r, y[1] == 3);
+    REPORTER_ASSERT(r, y[2] == 0xffffffff);
+    REPORTER_ASSERT(r, y[3] == 7);
+}
+
 DEF_TEST(Sk2f_Load2, r) {
     float xy[4] = { 0,1,2,3 };
 
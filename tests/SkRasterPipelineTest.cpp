@@ -8,6 +8,7 @@
 #include "../src/jumper/SkJumper.h"
 #include "SkHalf.h"
 #include "SkRasterPipeline.h"
+#include "SkRasterPipelineProgramCache.h"
 #include "SkTo.h"
 #include "Test.h"
 
@@ -201,3 +202,251 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_bilerp_clamp_8888, r) {
+    // Magnify a 2x2 image 4x with the fused bilinear sampler.  This runs in lowp when it's
+    // available, which weights samples in 1/256ths, so we allow each channel to be off by one.
+    const uint32_t src[4] = { 0xff0000ff, 0x80008000, 0x00ff0000, 0xffffffff };
+    uint32_t dst[64];
+
+    SkJumper_GatherCtx gather;
+    gather.pixels = src;
+    gather.stride = 2;
+    gather.width  = 2;
+    gather.height = 2;
+    SkJumper_MemoryCtx store = { dst, 8 };
+    const float scale_translate[] = { 0.25f, 0.25f, 0, 0 };
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::seed_shader);
+    p.append(SkRasterPipeline::matrix_scale_translate, scale_translate);
+    p.append(SkRasterPipeline::bilerp_clamp_8888, &gather);
+    p.append(SkRasterPipeline::store_8888, &store);
+    p.run(0,0,8,8);
+
+    auto channel = [&](int x, int y, int c) {
+        x = SkTPin(x, 0, 1);
+        y = SkTPin(y, 0, 1);
+        return (float)((src[y*2+x] >> (8*c)) & 0xff);
+    };
+    for (int y = 0; y < 8; y++)
+    for (int x = 0; x < 8; x++) {
+        float cx = (x + 0.5f) * 0.25f - 0.5f,
+              cy = (y + 0.5f) * 0.25f - 0.5f;
+        int   ix = (int)floorf(cx),
+              iy = (int)floorf(cy);
+        float fx = cx - ix,
+              fy = cy - iy;
+        for (int c = 0; c < 4; c++) {
+            float want = channel(ix  ,iy  ,c) * (1-fx) * (1-fy)
+                       + channel(ix+1,iy  ,c) *    fx  * (1-fy)
+                       + channel(ix  ,iy+1,c) * (1-fx) *    fy
+                       + channel(ix+1,iy+1,c) *    fx  *    fy;
+            int got = (dst[y*8+x] >> (8*c)) & 0xff;
+            if (SkTAbs(got - (int)(want + 0.5f)) > 1) {
+                ERRORF(r, "(%d,%d) channel %d: got %d, want %g\n", x,y,c, got, want);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_lowp_dodge_burn_matrix, r) {
+    // colorburn, colordodge and matrix_4x5 have lowp versions, which divide and multiply in
+    // float but round to 8-bit between stages, so we allow each channel to be off by two.
+    uint32_t src[108], dst[108];
+    int n = 0;
+    for (int sa : { 0, 64, 128, 255 })
+    for (int s  : { 0, sa/3, sa })
+    for (int da : { 0, 100, 255 })
+    for (int d  : { 0, da/2, da }) {
+        src[n] = (uint32_t)sa << 24 | (uint32_t)s << 16 | (uint32_t)s << 8 | (uint32_t)s;
+        dst[n] = (uint32_t)da << 24 | (uint32_t)d << 16 | (uint32_t)d << 8 | (uint32_t)d;
+        n++;
+    }
+    auto channel = [](uint32_t px, int c) { return ((px >> (8*c)) & 0xff) * (1/255.0f); };
+
+    auto burn = [](float s, float d, float sa, float da) {
+        if (d == da) { return d + s*(1-da); }
+        if (s == 0)  { return d*(1-sa); }
+        return sa*(da - SkTMin(da, (da-d)*sa/s)) + s*(1-da) + d*(1-sa);
+    };
+    auto dodge = [](float s, float d, float sa, float da) {
+        if (d == 0)  { return s*(1-da); }
+        if (s == sa) { return s + d*(1-sa); }
+        return sa*SkTMin(da, d*sa/(sa-s)) + s*(1-da) + d*(1-sa);
+    };
+
+    for (int mode = 0; mode < 2; mode++) {
+        uint32_t out[108];
+        memcpy(out, dst, sizeof(dst));
+        SkJumper_MemoryCtx srcPtr = { src, 0 },
+                           dstPtr = { out, 0 };
+
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::load_8888,     &srcPtr);
+        p.append(SkRasterPipeline::load_8888_dst, &dstPtr);
+        p.append(mode == 0 ? SkRasterPipeline::colorburn : SkRasterPipeline::colordodge);
+        p.append(SkRasterPipeline::store_8888,    &dstPtr);
+        p.run(0,0,n,1);
+
+        for (int i = 0; i < n; i++)
+        for (int c = 0; c < 4; c++) {
+            float s  = channel(src[i], c), d  = channel(dst[i], c),
+                  sa = channel(src[i], 3), da = channel(dst[i], 3);
+            float want = c == 3      ? sa + da*(1-sa)
+                       : mode == 0   ? burn (s,d,sa,da)
+                                     : dodge(s,d,sa,da);
+            int got = (out[i] >> (8*c)) & 0xff;
+            if (SkTAbs(got - (int)(want*255 + 0.5f)) > 2) {
+                ERRORF(r, "mode %d, %08x over %08x, channel %d: got %d, want %g\n",
+                       mode, src[i], dst[i], c, got, want*255);
+            }
+        }
+    }
+
+    // Swap red and blue, halve green, and add a quarter to blue, in unpremul.
+    const float matrix[20] = { 0,0,1,0,  0,0.5f,0,0,  1,0,0,0,  0,0,0,1,  0,0,0.25f,0 };
+    uint32_t out[108];
+    SkJumper_MemoryCtx srcPtr = { src, 0 },
+                       outPtr = { out, 0 };
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::load_8888,  &srcPtr);
+    p.append(SkRasterPipeline::unpremul);
+    p.append(SkRasterPipeline::matrix_4x5, matrix);
+    p.append(SkRasterPipeline::clamp_1);
+    p.append(SkRasterPipeline::premul);
+    p.append(SkRasterPipeline::store_8888, &outPtr);
+    p.run(0,0,n,1);
+
+    for (int i = 0; i < n; i++) {
+        float a = channel(src[i], 3),
+              u = a > 0 ? channel(src[i], 0) / a : 0;
+        float want[4] = { u*a, 0.5f*u*a, SkTMin(u + 0.25f, 1.0f)*a, a };
+        for (int c = 0; c < 4; c++) {
+            int got = (out[i] >> (8*c)) & 0xff;
+            if (SkTAbs(got - (int)(want[c]*255 + 0.5f)) > 2) {
+                ERRORF(r, "matrix_4x5 of %08x, channel %d: got %d, want %g\n",
+                       src[i], c, got, want[c]*255);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_f16_unorm, r) {
+    // Normalized F16 colors must survive a load and store exactly to 8 bits.
+    // 67 pixels covers a tail too.
+    uint64_t halfs[67];
+    for (int i = 0; i < 67; i++) {
+        halfs[i] = (uint64_t)SkFloatToHalf(((i*4+0) & 255) / 255.0f) <<  0
+                 | (uint64_t)SkFloatToHalf(((i*4+1) & 255) / 255.0f) << 16
+                 | (uint64_t)SkFloatToHalf(((i*4+2) & 255) / 255.0f) << 32
+                 | (uint64_t)SkFloatToHalf(((i*4+3) & 255) / 255.0f) << 48;
+    }
+
+    SkJumper_MemoryCtx ptr = { halfs, 0 };
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::load_f16,  &ptr);
+    p.append(SkRasterPipeline::srcover);
+    p.append(SkRasterPipeline::store_f16, &ptr);
+    p.run(0,0,67,1);
+
+    for (int i = 0; i < 67; i++) {
+        for (int c = 0; c < 4; c++) {
+            float got = SkHalfToFloat((SkHalf)(halfs[i] >> (16*c)));
+            int want = (i*4+c) & 255;
+            if (SkScalarRoundToInt(got * 255) != want) {
+                ERRORF(r, "pixel %d channel %d: got %g, want %d/255\n", i, c, got, want);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_programCache, r) {
+    // Two pipelines with the same stages but different contexts share a cached program,
+    // and each must still run with its own contexts.
+    uint32_t src[2][4] = {{ 0xff0000ff, 0xff00ff00, 0xffff0000, 0x80402010 },
+                          { 0x11223344, 0x55667788, 0x99aabbcc, 0xddeeff00 }},
+             dst[2][4];
+
+    SkRasterPipelineProgramCache cache;
+    for (int i = 0; i < 2; i++) {
+        SkJumper_MemoryCtx load_ctx  = { src[i], 0 },
+                           store_ctx = { dst[i], 0 };
+
+        SkRasterPipeline_<256> p;
+        p.setProgramCache(&cache);
+        p.append(SkRasterPipeline::load_bgra,  &load_ctx);
+        p.append(SkRasterPipeline::swap_rb);
+        p.append(SkRasterPipeline::store_8888, &store_ctx);
+        p.run(0,0,4,1);
+
+        for (int j = 0; j < 4; j++) {
+            REPORTER_ASSERT(r, dst[i][j] == src[i][j]);
+        }
+    }
+    REPORTER_ASSERT(r, cache.misses() == 1);
+    REPORTER_ASSERT(r, cache.hits() == 1);
+}
+
+DEF_TEST(SkRasterPipeline_fusion, r) {
+    // Fused stages should draw exactly what their unfused halves do.
+    uint32_t src[16*2];
+    for (int i = 0; i < 16*2; i++) {
+        src[i] = 0x01020304 * (i+1);
+    }
+    SkJumper_GatherCtx gather = { src, 16, 16.0f, 2.0f };
+    const float matrix[] = { 0.75f, 0.25f, 0.5f, 1.0f, 1.5f, -0.5f };  // column-major 2x3
+
+    for (bool seed_matrix_gather : { true, false }) {
+        uint32_t dst[2][16*2];
+        for (bool fuse : { true, false }) {
+            SkJumper_MemoryCtx src_ctx = { src, 16 },
+                               dst_ctx = { dst[fuse], 16 };
+
+            SkRasterPipeline_<256> p;
+            p.setFuseStages(fuse);
+            if (seed_matrix_gather) {
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_2x3, matrix);
+                p.append(SkRasterPipeline::gather_8888, &gather);
+                p.append(SkRasterPipeline::swap_rb);
+            } else {
+                p.append(SkRasterPipeline::load_8888, &src_ctx);
+                p.append(SkRasterPipeline::swap_rb);
+                p.append(SkRasterPipeline::swap_rb);
+            }
+            p.append(SkRasterPipeline::swap_rb);
+            p.append(SkRasterPipeline::store_8888, &dst_ctx);
+            p.run(0,0,13,2);
+        }
+        for (int i = 0; i < 16*2; i++) {
+            if (i % 16 < 13 && dst[0][i] != dst[1][i]) {
+                ERRORF(r, "pixel %d: unfused %08x, fused %08x\n", i, dst[0][i], dst[1][i]);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_fusion_store_then_more, r) {
+    // A swap_rb fused into a store must not leave r and b unswapped for stages after the store.
+    const uint32_t src[4] = { 0xff0000ff, 0xff00ff00, 0xffff0000, 0x80402010 };
+    uint32_t first[4], second[4];
+    SkJumper_MemoryCtx src_ctx    = { (void*)src, 0 },
+                       first_ctx  = { first,      0 },
+                       second_ctx = { second,     0 };
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::load_8888,  &src_ctx);
+    p.append(SkRasterPipeline::clamp_0);  // Keeps swap_rb from fusing into the load instead.
+    p.append(SkRasterPipeline::swap_rb);
+    p.append(SkRasterPipeline::store_8888, &first_ctx);
+    p.append(SkRasterPipeline::store_8888, &second_ctx);
+    p.run(0,0,4,1);
+
+    for (int i = 0; i < 4; i++) {
+        uint32_t swapped = (src[i] & 0xff00ff00) | (src[i] & 0xff) << 16 | (src[i] >> 16 & 0xff);
+        REPORTER_ASSERT(r, first[i] == swapped);
+        REPORTER_ASSERT(r, second[i] == swapped);
+    }
+}
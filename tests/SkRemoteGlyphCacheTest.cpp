@@ -184,6 +184,90 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkRemoteGlyphCache_StrikeSerialization, repor
     discardableManager->unlockAndDeleteAll();
 }
 
+DEF_TEST(SkRemoteGlyphCache_RingBuffer, reporter) {
+    SkAutoTMalloc<uint64_t> memory(SkStrikeRingBuffer::MemoryNeeded(64) / sizeof(uint64_t));
+    const size_t memorySize = SkStrikeRingBuffer::MemoryNeeded(64);
+
+    // Unformatted memory is rejected.
+    sk_bzero(memory.get(), memorySize);
+    REPORTER_ASSERT(reporter, !SkStrikeRingBuffer(memory.get(), memorySize).isValid());
+
+    SkStrikeRingBuffer::Init(memory.get(), memorySize);
+    SkStrikeRingBuffer server(memory.get(), memorySize),
+                       client(memory.get(), memorySize);
+    REPORTER_ASSERT(reporter, server.isValid() && client.isValid());
+
+    size_t size;
+    REPORTER_ASSERT(reporter, !client.peek(&size));
+
+    // Messages take 8 bytes for their length, plus their size rounded up to 8.
+    const char message[] = "0123456789abcdefghijklmnopqrstu";  // 32 bytes
+    REPORTER_ASSERT(reporter, server.write(message, 20));
+    REPORTER_ASSERT(reporter, server.write(message, 8));
+    REPORTER_ASSERT(reporter, !server.write(message, 24));  // Only 16 bytes left.
+    REPORTER_ASSERT(reporter, !server.write(message, 64));  // Never fits.
+
+    const volatile void* data = client.peek(&size);
+    REPORTER_ASSERT(reporter, data && size == 20);
+    REPORTER_ASSERT(reporter, data && 0 == memcmp(const_cast<const void*>(data), message, 20));
+    client.pop();
+
+    // There are 48 bytes free now, but only 16 at the end, so this wraps around.
+    REPORTER_ASSERT(reporter, server.write(message + 1, 24));
+    data = client.peek(&size);
+    REPORTER_ASSERT(reporter, data && size == 8);
+    client.pop();
+    data = client.peek(&size);
+    REPORTER_ASSERT(reporter, data && size == 24);
+    REPORTER_ASSERT(reporter, data && 0 == memcmp(const_cast<const void*>(data), message + 1, 24));
+    client.pop();
+    REPORTER_ASSERT(reporter, !client.peek(&size));
+
+    // A length that runs past what's been written is malformed, so there's nothing to read.
+    REPORTER_ASSERT(reporter, server.write(message, 8));
+    auto* bytes = reinterpret_cast<uint8_t*>(memory.get()) + memorySize - 64;
+    uint32_t badLength = 48;
+    memcpy(bytes + 32, &badLength, sizeof(badLength));
+    REPORTER_ASSERT(reporter, !client.peek(&size));
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkRemoteGlyphCache_RingBufferPrefetch, reporter, ctxInfo) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    SkStrikeClient client(discardableManager, false);
+    server.setGlyphPrefetchRange(16);
+    const SkPaint paint;
+
+    const size_t memorySize = SkStrikeRingBuffer::MemoryNeeded(64 * 1024);
+    SkAutoTMalloc<uint64_t> memory(memorySize / sizeof(uint64_t));
+    SkStrikeRingBuffer::Init(memory.get(), memorySize);
+    SkStrikeRingBuffer serverRing(memory.get(), memorySize),
+                       clientRing(memory.get(), memorySize);
+
+    // The server only draws the first two glyphs...
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto serverTfData = server.serializeTypeface(serverTf.get());
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+    SkTextBlobCacheDiffCanvas cache_diff_canvas(10, 10, SkMatrix::I(), props, &server,
+                                                MakeSettings(ctxInfo.grContext()));
+    cache_diff_canvas.drawTextBlob(buildTextBlob(serverTf, 2).get(), 0, 0, paint);
+    REPORTER_ASSERT(reporter, server.writeStrikeData(&serverRing));
+
+    // ...but the client can draw the first ten without a miss.
+    auto clientTf = client.deserializeTypeface(serverTfData->data(), serverTfData->size());
+    REPORTER_ASSERT(reporter, client.readStrikeData(&clientRing));
+    int glyphCount = 10;
+    SkBitmap expected = RasterBlob(buildTextBlob(serverTf, glyphCount), 10, 10, paint,
+                                   ctxInfo.grContext());
+    SkBitmap actual = RasterBlob(buildTextBlob(clientTf, glyphCount), 10, 10, paint,
+                                 ctxInfo.grContext());
+    compare_blobs(expected, actual, reporter);
+    REPORTER_ASSERT(reporter, !discardableManager->hasCacheMiss());
+
+    // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
+    discardableManager->unlockAndDeleteAll();
+}
+
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkRemoteGlyphCache_ReleaseTypeFace, reporter, ctxInfo) {
     sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
     SkStrikeServer server(discardableManager.get());
@@ -17,6 +17,11 @@
 #include "SkPictureRecorder.h"
 #include "SkResourceCache.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
+#include "SkTraceMemoryDump.h"
+
+#include <algorithm>
+#include <atomic>
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -291,3 +296,108 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+DEF_TEST(ResourceCache_purgeUntilUnder, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    int flags[10];
+    for (int i = 0; i < 10; ++i) {
+        auto rec = skstd::make_unique<TestRec>(1, i, &flags[i]);
+        rec->fCanBePurged = true;
+        cache.add(rec.release(), nullptr);
+    }
+    REPORTER_ASSERT(reporter, cache.getCount() == 10);
+
+    auto has = [&](int data) {
+        return cache.find(TestKey(1, data), [](const SkResourceCache::Rec&, void*) {
+            return true;
+        }, nullptr);
+    };
+
+    // Touch the oldest, so that it's now the most recently used.
+    REPORTER_ASSERT(reporter, has(0));
+
+    cache.purgeUntilUnder(5 * 1024, SK_MaxS32);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 4 * 1024);
+    REPORTER_ASSERT(reporter, has(0));
+    REPORTER_ASSERT(reporter, !has(1));
+
+    cache.purgeUntilUnder(SIZE_MAX, 2);
+    REPORTER_ASSERT(reporter, cache.getCount() == 1);
+    REPORTER_ASSERT(reporter, has(0));
+}
+
+/*
+ *  Hammer the global cache from many threads: whatever is found must be what was added.
+ */
+DEF_TEST(ResourceCache_global_concurrent, reporter) {
+    static constexpr int kSharedID = 0x7e57;
+    static constexpr int kRecs = 512;
+
+    std::atomic<int> mismatches{0};
+    SkTaskGroup().batch(4 * kRecs, [&](int i) {
+        const int32_t data = i % kRecs;
+        bool found = SkResourceCache::Find(TestKey(kSharedID, data),
+                                           [](const SkResourceCache::Rec& rec, void* ctx) {
+            auto expected = static_cast<int32_t*>(ctx);
+            return static_cast<const TestRec&>(rec).fKey.fData == *expected;
+        }, const_cast<int32_t*>(&data));
+        if (!found) {
+            int flags = 0;
+            auto rec = skstd::make_unique<TestRec>(kSharedID, data, &flags);
+            rec->fCanBePurged = true;
+            SkResourceCache::Add(rec.release());
+            if (!(flags & TestRec::kDidInstall)) {
+                mismatches++;
+            }
+        }
+    });
+    REPORTER_ASSERT(reporter, 0 == mismatches.load());
+
+    SkResourceCache::PostPurgeSharedID(kSharedID);
+}
+
+namespace {
+class FreedBytesDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char* units,
+                          uint64_t value) override {
+        if (0 == strcmp(valueName, "freed_size")) {
+            fCaches.push_back(SkString(dumpName));
+            fTotal += value;
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override { return kLight_LevelOfDetail; }
+
+    SkTArray<SkString> fCaches;
+    uint64_t           fTotal = 0;
+};
+}  // namespace
+
+DEF_TEST(ResourceCache_memoryPressure, reporter) {
+    static constexpr int kSharedID = 0x9e55;
+    static constexpr int kRecs = 16;
+    for (int i = 0; i < kRecs; ++i) {
+        int flags = 0;
+        auto rec = skstd::make_unique<TestRec>(kSharedID, i, &flags);
+        rec->fCanBePurged = true;
+        SkResourceCache::Add(rec.release());
+    }
+
+    FreedBytesDump dump;
+    size_t freed = SkGraphics::OnMemoryPressure(SkGraphics::MemoryPressure::kCritical, &dump);
+    REPORTER_ASSERT(reporter, freed == dump.fTotal);
+    for (const char* cache : { "glyph_cache", "resource_cache", "image_filter_cache" }) {
+        SkString name = SkStringPrintf("skia/memory_pressure/%s", cache);
+        REPORTER_ASSERT(reporter, std::find(dump.fCaches.begin(), dump.fCaches.end(), name) !=
+                                  dump.fCaches.end());
+    }
+
+    for (int i = 0; i < kRecs; ++i) {
+        REPORTER_ASSERT(reporter, !SkResourceCache::Find(TestKey(kSharedID, i),
+                                                         [](const SkResourceCache::Rec&, void*) {
+            return true;
+        }, nullptr));
+    }
+}
@@ -1673,6 +1673,67 @@ DEF_TEST(SkSLDeadLoopVar, r) {
          );
 }
 
+DEF_TEST(SkSLCommonSubexpressions, r) {
+    test(r,
+         "uniform sampler2D s;"
+         "uniform float2 coords;"
+         "uniform float scale;"
+         "in float2 v;"
+         "void main() {"
+         "float4 color = texture(s, coords);"
+         "{"
+         "sk_FragColor = texture(s, coords) * scale;"
+         "}"
+         "float2 c = coords * 2;"
+         "if (scale > 0) {"
+         "float4 d = texture(s, c);"
+         "sk_FragColor += d;"
+         "}"
+         "sk_FragColor += texture(s, c) + texture(s, coords * 2);"
+         "c = v;"
+         "sk_FragColor += texture(s, c) + texture(s, coords * 2) + color;"
+         "}",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "uniform sampler2D s;\n"
+         "uniform vec2 coords;\n"
+         "uniform float scale;\n"
+         "in vec2 v;\n"
+         "void main() {\n"
+         "    vec4 color = texture(s, coords);\n"
+         "    {\n"
+         "        sk_FragColor = color * scale;\n"
+         "    }\n"
+         "    vec2 c = coords * 2.0;\n"
+         "    if (scale > 0.0) {\n"
+         "        vec4 d = texture(s, c);\n"
+         "        sk_FragColor += d;\n"
+         "    }\n"
+         "    sk_FragColor += texture(s, c) + texture(s, c);\n"
+         "    c = v;\n"
+         "    sk_FragColor += (texture(s, c) + texture(s, coords * 2.0)) + color;\n"
+         "}\n");
+}
+
+DEF_TEST(SkSLDeadUniforms, r) {
+    test(r,
+         "uniform float unused;"
+         "uniform float2 used, alsoUnused;"
+         "uniform float deadCode;"
+         "void main() {"
+         "if (false) sk_FragColor = float4(deadCode);"
+         "sk_FragColor = float4(used, 0, 1);"
+         "}",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "uniform vec2 used;\n"
+         "void main() {\n"
+         "    sk_FragColor = vec4(used, 0.0, 1.0);\n"
+         "}\n");
+}
+
 DEF_TEST(SkSLGeometryShaders, r) {
     test(r,
          "layout(points) in;"
@@ -2080,7 +2141,7 @@ DEF_TEST(SkSLWorkaroundUnfoldShortCircuitAsTernary, r) {
          "void main() {"
          "    bool andXY = x && y;"
          "    bool orXY = x || y;"
-         "    bool combo = (x && y) || (x || y);"
+         "    bool combo = (y && x) || (y || x);"
          "    bool prec = (i + j == 3) && y;"
          "    while (andXY && orXY && combo && prec) {"
          "        sk_FragColor = float4(0);"
@@ -2097,7 +2158,7 @@ DEF_TEST(SkSLWorkaroundUnfoldShortCircuitAsTernary, r) {
          "void main() {\n"
          "    bool andXY = x ? y : false;\n"
          "    bool orXY = x ? true : y;\n"
-         "    bool combo = (x ? y : false) ? true : (x ? true : y);\n"
+         "    bool combo = (y ? x : false) ? true : (y ? true : x);\n"
          "    bool prec = i + j == 3 ? y : false;\n"
          "    while (((andXY ? orXY : false) ? combo : false) ? prec : false) {\n"
          "        sk_FragColor = vec4(0.0);\n"
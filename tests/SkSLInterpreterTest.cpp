@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "../src/jumper/SkJumper.h"
+#include "SkArenaAlloc.h"
+#include "SkRasterPipeline.h"
+#include "SkSLCompiler.h"
+#include "SkSLInterpreter.h"
+
+#include "Test.h"
+
+// Runs 'body' as a callback stage over more pixels than one batch holds, so both full and partial
+// batches go through it, and compares against 'expected' evaluated per pixel.
+static void test(skiatest::Reporter* r, const char* body,
+                 void (*expected)(float* red, float* green, float* blue)) {
+    SkSL::String src = SkSL::String("void f(inout float r, inout float g, inout float b) {") +
+                       body + "} void appendStages(SkRasterPipeline p) { append(p, f); }";
+    SkSL::Compiler compiler;
+    SkSL::Program::Settings settings;
+    std::unique_ptr<SkSL::Program> program =
+            compiler.convertProgram(SkSL::Program::kPipelineStage_Kind, src, settings);
+    if (!program) {
+        ERRORF(r, "%s", compiler.errorText().c_str());
+        return;
+    }
+
+    const int kCount = SkJumper_kMaxStride + 7;
+    float in[kCount][4], out[kCount][4];
+    for (int i = 0; i < kCount; ++i) {
+        in[i][0] = i / (float) kCount;
+        in[i][1] = 1 - i / (2.0f * kCount);
+        in[i][2] = i * 0.5f - 3;
+        in[i][3] = 1;
+    }
+    SkJumper_MemoryCtx srcCtx = { &in[0][0], 0 },
+                       dstCtx = { &out[0][0], 0 };
+
+    SkRasterPipeline_<256> p;
+    std::vector<SkSL::Interpreter::Value> stack;
+    p.append(SkRasterPipeline::load_f32, &srcCtx);
+    SkSL::Interpreter interpreter(std::move(program), &p, &stack);
+    interpreter.run();
+    p.append(SkRasterPipeline::store_f32, &dstCtx);
+    p.run(0,0, kCount,1);
+
+    for (int i = 0; i < kCount; ++i) {
+        float want[4] = { in[i][0], in[i][1], in[i][2], in[i][3] };
+        expected(&want[0], &want[1], &want[2]);
+        for (int c = 0; c < 4; ++c) {
+            if (out[i][c] != want[c]) {
+                ERRORF(r, "%s\npixel %d channel %d: expected %g, got %g", body, i, c, want[c],
+                       out[i][c]);
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(SkSLInterpreterArithmetic, r) {
+    test(r, "float t = r; r = g; g = t; b = b * 2 - 1;",
+         [](float* r, float* g, float* b) { std::swap(*r, *g); *b = *b * 2 - 1; });
+    test(r, "int i = 7; i /= 2; g = float(i) * r; b = -b;",
+         [](float* r, float* g, float* b) { *g = 3 * *r; *b = -*b; });
+}
+
+DEF_TEST(SkSLInterpreterIf, r) {
+    test(r, "if (r > 0.5) { g = 1; } else { g = -1; b += r; }",
+         [](float* r, float* g, float* b) {
+             if (*r > 0.5f) { *g = 1; } else { *g = -1; *b += *r; }
+         });
+    test(r, "bool t = r > 0.5; if (t) { t = false; g = 2; } else { g = 3; }",
+         [](float* r, float* g, float* b) { *g = *r > 0.5f ? 2 : 3; });
+    test(r, "r = b > 0 ? g : -g; g = (r < 0.3 && b < 1) || b > 4 ? 1 : 0;",
+         [](float* r, float* g, float* b) {
+             *r = *b > 0 ? *g : -*g;
+             *g = (*r < 0.3f && *b < 1) || *b > 4 ? 1 : 0;
+         });
+}
+
+DEF_TEST(SkSLInterpreterLoops, r) {
+    test(r, "float x = 0; while (x < r) { x += 0.25; b += 1; } g = x;",
+         [](float* r, float* g, float* b) {
+             float x = 0;
+             while (x < *r) { x += 0.25f; *b += 1; }
+             *g = x;
+         });
+    test(r, "for (int i = 0; i < 5; i++) { if (b > float(i)) { r += 1; } }",
+         [](float* r, float* g, float* b) {
+             for (int i = 0; i < 5; i++) { if (*b > i) { *r += 1; } }
+         });
+}
+
+DEF_TEST(SkSLInterpreterRuntimeStage, r) {
+    const char* src = "void swap(int x, int y, inout float4 color) {"
+                      "    float t = color.r; color.r = color.b; color.b = t;"
+                      "    if (color.g > 0.5) { color.a *= 0.5; }"
+                      "}";
+    float data[4][4] = {
+        { 0.1f, 0.2f, 0.3f, 1 },
+        { 0.4f, 0.6f, 0.8f, 1 },
+        { 0.0f, 0.9f, 0.5f, 0.5f },
+        { 0.7f, 0.1f, 0.2f, 0.25f },
+    };
+    SkJumper_MemoryCtx ctx = { &data[0][0], 0 };
+    // The second append reuses the stage compiled by the first.
+    for (int i = 0; i < 2; ++i) {
+        SkSTArenaAlloc<256> alloc;
+        SkRasterPipeline p(&alloc);
+        p.append(SkRasterPipeline::load_f32, &ctx);
+        REPORTER_ASSERT(r, SkSL::Interpreter::AppendRuntimeStage(&p, &alloc, SkSL::String(src),
+                                                                 "swap"));
+        p.append(SkRasterPipeline::store_f32, &ctx);
+        p.run(0,0, 4,1);
+    }
+    // Swapping twice restores r and b; alpha is halved twice where green is over 0.5.
+    const float expected[4][4] = {
+        { 0.1f, 0.2f, 0.3f, 1 },
+        { 0.4f, 0.6f, 0.8f, 0.25f },
+        { 0.0f, 0.9f, 0.5f, 0.125f },
+        { 0.7f, 0.1f, 0.2f, 0.25f },
+    };
+    for (int i = 0; i < 4; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            REPORTER_ASSERT(r, data[i][c] == expected[i][c]);
+        }
+    }
+
+    SkSTArenaAlloc<256> alloc;
+    SkRasterPipeline p(&alloc);
+    REPORTER_ASSERT(r, !SkSL::Interpreter::AppendRuntimeStage(&p, &alloc, SkSL::String(src),
+                                                              "missing"));
+}
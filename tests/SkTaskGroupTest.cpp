@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+#include <atomic>
+#include <memory>
+
+static std::unique_ptr<SkExecutor> make_pool(int type) {
+    switch (type) {
+        case 0:  return SkExecutor::MakeFIFOThreadPool(4);
+        case 1:  return SkExecutor::MakeLIFOThreadPool(4);
+        default: return SkExecutor::MakeWorkStealingThreadPool(4);
+    }
+}
+
+DEF_TEST(SkTaskGroup_Batch, r) {
+    static constexpr int N = 1000;
+
+    // Executors which run work right away call the batch in order.
+    {
+        int next = 0;
+        SkTaskGroup().batch(N, [&](int i) {
+            REPORTER_ASSERT(r, i == next);
+            next++;
+        });
+        REPORTER_ASSERT(r, next == N);
+    }
+
+    for (int type = 0; type < 3; type++) {
+        auto pool = make_pool(type);
+
+        std::atomic<int> calls[N];
+        for (auto& c : calls) {
+            c.store(0);
+        }
+
+        SkTaskGroup(*pool).batch(N, [&](int i) { calls[i]++; });
+
+        for (const auto& c : calls) {
+            REPORTER_ASSERT(r, c.load() == 1);
+        }
+    }
+}
+
+DEF_TEST(SkTaskGroup_NestedBatch, r) {
+    static constexpr int kOuter = 32,
+                         kInner = 64;
+
+    for (int type = 0; type < 3; type++) {
+        auto pool = make_pool(type);
+
+        std::atomic<int> sum{0};
+        SkTaskGroup(*pool).batch(kOuter, [&](int i) {
+            // Nested groups wait by running work, so this doesn't deadlock however few threads
+            // the pool has.
+            SkTaskGroup(*pool).batch(kInner, [&](int j) { sum += i * kInner + j; });
+        });
+
+        static constexpr int kCount = kOuter * kInner;
+        REPORTER_ASSERT(r, sum.load() == kCount * (kCount - 1) / 2);
+    }
+}
+
+DEF_TEST(SkParallelFor, r) {
+    static constexpr int N = 1000;
+
+    for (int type = 0; type < 3; type++) {
+        auto pool = make_pool(type);
+
+        for (int grain : { 1, 7, 250, N, 2 * N }) {
+            std::atomic<int> calls[N];
+            for (auto& c : calls) {
+                c.store(0);
+            }
+
+            SkParallelFor(N, grain, [&](int start, int end) {
+                REPORTER_ASSERT(r, 0 <= start && start < end && end <= N);
+                REPORTER_ASSERT(r, end - start <= grain);
+                for (int i = start; i < end; i++) {
+                    calls[i]++;
+                }
+            }, *pool);
+
+            for (const auto& c : calls) {
+                REPORTER_ASSERT(r, c.load() == 1);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkPipelineStages, r) {
+    static constexpr int N           = 200,
+                         kMaxInFlight = 3;
+
+    for (int type = 0; type < 4; type++) {
+        std::unique_ptr<SkExecutor> pool;
+        if (type < 3) {
+            pool = make_pool(type);
+        }
+        SkExecutor& executor = pool ? *pool : SkExecutor::GetDefault();
+
+        // Each stage hands its item on through a buffer slot, checking they arrive in order.
+        int slots[kMaxInFlight];
+        int produced = 0, doubled = 0, consumed = 0;
+        std::atomic<int> inFlight{0};
+        int sum = 0;
+
+        SkPipelineStages pipeline(kMaxInFlight, executor);
+        pipeline.addStage([&](int item) {
+            REPORTER_ASSERT(r, item == produced++);
+            REPORTER_ASSERT(r, ++inFlight <= kMaxInFlight);
+            slots[item % kMaxInFlight] = item;
+        });
+        pipeline.addStage([&](int item) {
+            REPORTER_ASSERT(r, item == doubled++);
+            slots[item % kMaxInFlight] *= 2;
+        });
+        pipeline.addStage([&](int item) {
+            REPORTER_ASSERT(r, item == consumed++);
+            REPORTER_ASSERT(r, slots[item % kMaxInFlight] == 2 * item);
+            sum += slots[item % kMaxInFlight];
+            inFlight--;
+        });
+        pipeline.run(N);
+
+        REPORTER_ASSERT(r, consumed == N);
+        REPORTER_ASSERT(r, sum == N * (N - 1));
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+#include "GrContextFactory.h"
+#include "GrContextOptions.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+using sk_gpu_test::GrContextFactory;
+
+static constexpr int kSize = 512;
+
+static bool draw(GrContext* context, SkBitmap* result) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return false;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+
+    // Paths scaled past kMaxMIP use distance fields. Each star is a different shape, and each is
+    // drawn twice so the second draw finds the first one's distance field cached.
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 8; ++i) {
+        SkPath path;
+        path.moveTo(30, 0);
+        for (int j = 1; j < 5 + i; ++j) {
+            SkScalar angle = j * SK_ScalarPI * (4 + 2 * i) / (5 + i);
+            path.lineTo(30 + 30 * SkScalarSin(angle), 30 - 30 * SkScalarCos(angle));
+        }
+        path.close();
+        for (int k = 0; k < 2; ++k) {
+            canvas->save();
+            canvas->translate((i % 4) * 120 + k * 7, (i / 4) * 240 + k * 5);
+            canvas->scale(3, 3);
+            canvas->drawPath(path, paint);
+            canvas->restore();
+        }
+    }
+    result->allocPixels(info);
+    return surface->readPixels(*result, 0, 0);
+}
+
+// With an executor, distance fields are generated on its threads as the draws are recorded. The
+// results must match generating them at flush time.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SmallPathRendererThreaded, reporter, ctxInfo) {
+    GrContextOptions options(ctxInfo.options());
+    options.fGpuPathRenderers = GpuPathRenderers::kSmall;
+    SkBitmap expected;
+    {
+        GrContextFactory factory(options);
+        GrContext* context = factory.get(ctxInfo.type());
+        REPORTER_ASSERT(reporter, context && draw(context, &expected));
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    options.fExecutor = executor.get();
+    GrContextFactory factory(options);
+    GrContext* context = factory.get(ctxInfo.type());
+    SkBitmap actual;
+    REPORTER_ASSERT(reporter, context && draw(context, &actual));
+    REPORTER_ASSERT(reporter,
+                    expected.computeByteSize() == actual.computeByteSize() &&
+                    !memcmp(expected.getPixels(), actual.getPixels(), expected.computeByteSize()));
+}
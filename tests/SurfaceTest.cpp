@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "GrAsyncReadQueue.h"
 #include "GrBackendSurface.h"
 #include "GrContext.h"
 #include "GrContextPriv.h"
@@ -24,8 +25,10 @@
 #include "SkRRect.h"
 #include "SkSurface.h"
 #include "SkSurface_Gpu.h"
+#include "SkTime.h"
 #include "SkUtils.h"
 #include "Test.h"
+#include "mock/GrMockTypes.h"
 
 #include <functional>
 #include <initializer_list>
@@ -518,6 +521,45 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceCRBug263329_Gpu, reporter, ctxInfo) {
     }
 }
 
+static const void* snapshot_pixels(const sk_sp<SkImage>& image) {
+    SkPixmap pm;
+    return image->peekPixels(&pm) ? pm.addr() : nullptr;
+}
+
+// Copy-on-write reuses the pixels of a snapshot once it has been released, but never the pixels
+// of one that is still alive, and never gives a recycled snapshot its old generation ID.
+DEF_TEST(SurfaceCopyOnWriteRecyclesPixels, reporter) {
+    auto surface(create_surface());
+    SkCanvas* canvas = surface->getCanvas();
+
+    canvas->clear(SK_ColorRED);
+    sk_sp<SkImage> image1(surface->makeImageSnapshot());
+    const void* pixels1 = snapshot_pixels(image1);
+    canvas->clear(SK_ColorGREEN);  // Forks away from image1.
+    sk_sp<SkImage> image2(surface->makeImageSnapshot());
+    const void* pixels2 = snapshot_pixels(image2);
+    uint32_t id2 = image2->uniqueID();
+    canvas->clear(SK_ColorBLUE);   // image1 is still alive, so this needs fresh pixels.
+    sk_sp<SkImage> image3(surface->makeImageSnapshot());
+    REPORTER_ASSERT(reporter, pixels2 != pixels1);
+    REPORTER_ASSERT(reporter, snapshot_pixels(image3) != pixels1);
+    REPORTER_ASSERT(reporter, snapshot_pixels(image3) != pixels2);
+
+    image1.reset();
+    image2.reset();
+    canvas->drawPoint(0, 0, SkPaint());  // Forks away from image3, into image2's pixels.
+    sk_sp<SkImage> image4(surface->makeImageSnapshot());
+    REPORTER_ASSERT(reporter, snapshot_pixels(image4) == pixels2);
+    REPORTER_ASSERT(reporter, image4->uniqueID() != id2);
+
+    SkBitmap bm;
+    bm.allocN32Pixels(1, 1);
+    REPORTER_ASSERT(reporter, image3->readPixels(bm.pixmap(), 0, 0));
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == bm.getColor(0, 0));
+    REPORTER_ASSERT(reporter, image4->readPixels(bm.pixmap(), 1, 1));
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == bm.getColor(0, 0));
+}
+
 DEF_TEST(SurfaceGetTexture, reporter) {
     auto surface(create_surface());
     sk_sp<SkImage> image(surface->makeImageSnapshot());
@@ -981,3 +1023,134 @@ DEF_TEST(surface_image_unity, reporter) {
         }
     }
 }
+
+struct AsyncReadResult {
+    bool                 fCalled = false;
+    std::vector<uint8_t> fPlanes[3];
+    size_t               fRowBytes[3] = {};
+};
+
+static void async_read_done(void* context, const void* pixels, size_t rowBytes) {
+    auto* result = static_cast<AsyncReadResult*>(context);
+    result->fCalled = true;
+    if (pixels) {
+        // Keep just the first row; the tests fill the surfaces with one color.
+        const uint8_t* bytes = static_cast<const uint8_t*>(pixels);
+        result->fPlanes[0].assign(bytes, bytes + rowBytes);
+        result->fRowBytes[0] = rowBytes;
+    }
+}
+
+static void async_read_yuv_done(void* context, const void* planes[3], const size_t rowBytes[3]) {
+    auto* result = static_cast<AsyncReadResult*>(context);
+    result->fCalled = true;
+    for (int i = 0; i < 3; ++i) {
+        if (planes[i]) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(planes[i]);
+            result->fPlanes[i].assign(bytes, bytes + rowBytes[i]);
+            result->fRowBytes[i] = rowBytes[i];
+        }
+    }
+}
+
+// Mid gray is 128 in each of Y, U, and V in JPEG's full range YUV.
+static void check_async_reads(skiatest::Reporter* reporter, SkSurface* surface,
+                              const std::function<void(AsyncReadResult*)>& wait) {
+    surface->getCanvas()->clear(SkColorSetRGB(128, 128, 128));
+
+    AsyncReadResult rgba;
+    auto info = SkImageInfo::Make(8, 4, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+    surface->asyncReadPixels(info, 2, 2, async_read_done, &rgba);
+    wait(&rgba);
+    REPORTER_ASSERT(reporter, rgba.fCalled);
+    REPORTER_ASSERT(reporter, rgba.fRowBytes[0] >= 8 * 4);
+    if (rgba.fRowBytes[0] >= 8 * 4) {
+        for (int x = 0; x < 8; ++x) {
+            REPORTER_ASSERT(reporter, 128 == rgba.fPlanes[0][4 * x + 0]);
+            REPORTER_ASSERT(reporter, 128 == rgba.fPlanes[0][4 * x + 1]);
+            REPORTER_ASSERT(reporter, 128 == rgba.fPlanes[0][4 * x + 2]);
+            REPORTER_ASSERT(reporter, 255 == rgba.fPlanes[0][4 * x + 3]);
+        }
+    }
+
+    AsyncReadResult yuv;
+    surface->asyncReadPixelsYUV420(kJPEG_SkYUVColorSpace, SkIRect::MakeXYWH(1, 1, 7, 5),
+                                   async_read_yuv_done, &yuv);
+    wait(&yuv);
+    REPORTER_ASSERT(reporter, yuv.fCalled);
+    for (int i = 0; i < 3; ++i) {
+        size_t width = i ? 4 : 7;
+        REPORTER_ASSERT(reporter, yuv.fRowBytes[i] >= width);
+        for (size_t x = 0; x < width && yuv.fRowBytes[i] >= width; ++x) {
+            // Allow for rounding in the GPU's conversion.
+            REPORTER_ASSERT(reporter, SkTAbs(yuv.fPlanes[i][x] - 128) <= 1);
+        }
+    }
+
+    // Reads outside the surface fail.
+    AsyncReadResult outside;
+    surface->asyncReadPixels(info, surface->width() - 4, 0, async_read_done, &outside);
+    REPORTER_ASSERT(reporter, outside.fCalled && outside.fPlanes[0].empty());
+}
+
+DEF_TEST(SurfaceAsyncReadPixels_Raster, reporter) {
+    auto surface = SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(16, 16));
+    // Raster surfaces call back before returning.
+    check_async_reads(reporter, surface.get(), [](AsyncReadResult*) {});
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceAsyncReadPixels_Gpu, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    for (auto origin : {kTopLeft_GrSurfaceOrigin, kBottomLeft_GrSurfaceOrigin}) {
+        auto surface = SkSurface::MakeRenderTarget(
+                context, SkBudgeted::kNo,
+                SkImageInfo::Make(16, 16, kRGBA_8888_SkColorType, kPremul_SkAlphaType), 1,
+                origin, nullptr);
+        if (!surface) {
+            continue;
+        }
+        check_async_reads(reporter, surface.get(), [context](AsyncReadResult* result) {
+            double start = SkTime::GetMSecs();
+            while (!result->fCalled && SkTime::GetMSecs() - start < 10000) {
+                context->checkAsyncWorkCompletion();
+            }
+        });
+    }
+}
+
+DEF_GPUTEST(SurfaceAsyncReadPixels_Mock, reporter, options) {
+    GrMockOptions mockOptions;
+    mockOptions.fMapBufferFlags = GrCaps::kCanMap_MapFlag;
+    mockOptions.fFenceSyncSupport = true;
+    mockOptions.fTransferBufferSupport = true;
+    auto info = SkImageInfo::Make(8, 8, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+
+    sk_sp<GrContext> context = GrContext::MakeMock(&mockOptions, options);
+    auto surface = SkSurface::MakeRenderTarget(context.get(), SkBudgeted::kNo, info);
+    REPORTER_ASSERT(reporter, surface && context->contextPriv().getGpu()->asyncReadQueue());
+    if (!surface) {
+        return;
+    }
+
+    // The read is submitted before asyncReadPixels() returns, but only called back when checked.
+    AsyncReadResult result;
+    surface->asyncReadPixels(info, 0, 0, async_read_done, &result);
+    REPORTER_ASSERT(reporter, !result.fCalled);
+    context->checkAsyncWorkCompletion();
+    REPORTER_ASSERT(reporter, result.fCalled && !result.fPlanes[0].empty());
+
+    // Destroying the context delivers what the GPU finishes...
+    result = AsyncReadResult();
+    surface->asyncReadPixels(info, 0, 0, async_read_done, &result);
+    surface.reset();
+    context.reset();
+    REPORTER_ASSERT(reporter, result.fCalled && !result.fPlanes[0].empty());
+
+    // ...but abandoning it fails the pending reads.
+    context = GrContext::MakeMock(&mockOptions, options);
+    surface = SkSurface::MakeRenderTarget(context.get(), SkBudgeted::kNo, info);
+    result = AsyncReadResult();
+    surface->asyncReadPixels(info, 0, 0, async_read_done, &result);
+    context->abandonContext();
+    REPORTER_ASSERT(reporter, result.fCalled && result.fPlanes[0].empty());
+}
@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkCodecPriv.h"
 #include "SkImageInfoPriv.h"
+#include "SkRandom.h"
 #include "SkSwizzle.h"
 #include "SkSwizzler.h"
 #include "Test.h"
@@ -144,6 +146,101 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+DEF_TEST(SwizzleOpts16, r) {
+    // Not a multiple of any vector width, so the tails get tested too.
+    const int kCount = 37;
+    uint8_t src[kCount * 8];
+    SkRandom random;
+    for (uint8_t& byte : src) {
+        byte = random.nextU() & 0xFF;
+    }
+
+    // Components are big-endian, so the first byte of each is the one that survives.
+    uint32_t dst[kCount];
+    SkOpts::RGB16_to_RGB1(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 6*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_RGBA(0xFF, p[0], p[2], p[4]));
+    }
+    SkOpts::RGB16_to_BGR1(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 6*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_BGRA(0xFF, p[0], p[2], p[4]));
+    }
+    SkOpts::RGBA16_to_RGBA(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 8*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_RGBA(p[6], p[0], p[2], p[4]));
+    }
+    SkOpts::RGBA16_to_BGRA(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 8*i;
+        REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_BGRA(p[6], p[0], p[2], p[4]));
+    }
+}
+
+// Sampled swizzles gather the sampled pixels and then use the optimized swizzles.  They should
+// match swizzling a row that holds just the sampled pixels.
+DEF_TEST(SwizzlerSampleX, r) {
+    const int kWidth = 37;
+    const struct {
+        SkEncodedInfo::Color fColor;
+        SkEncodedInfo::Alpha fAlpha;
+        int                  fBitsPerComponent;
+    } kFormats[] = {
+        { SkEncodedInfo::kGray_Color,      SkEncodedInfo::kOpaque_Alpha,    8  },
+        { SkEncodedInfo::kGrayAlpha_Color, SkEncodedInfo::kUnpremul_Alpha,  8  },
+        { SkEncodedInfo::kRGB_Color,       SkEncodedInfo::kOpaque_Alpha,    8  },
+        { SkEncodedInfo::kRGBA_Color,      SkEncodedInfo::kUnpremul_Alpha,  8  },
+        { SkEncodedInfo::kRGB_Color,       SkEncodedInfo::kOpaque_Alpha,    16 },
+        { SkEncodedInfo::kRGBA_Color,      SkEncodedInfo::kUnpremul_Alpha,  16 },
+        { SkEncodedInfo::kInvertedCMYK_Color, SkEncodedInfo::kOpaque_Alpha, 8  },
+    };
+    const SkColorType kColorTypes[] = { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType };
+    const SkAlphaType kAlphaTypes[] = { kPremul_SkAlphaType, kUnpremul_SkAlphaType };
+
+    SkRandom random;
+    uint8_t src[kWidth * 8];
+    for (uint8_t& byte : src) {
+        byte = random.nextU() & 0xFF;
+    }
+
+    for (const auto& format : kFormats) {
+        const SkEncodedInfo encodedInfo = SkEncodedInfo::Make(kWidth, 1, format.fColor,
+                format.fAlpha, format.fBitsPerComponent);
+        const int bpp = encodedInfo.bitsPerPixel() / 8;
+        for (SkColorType colorType : kColorTypes) {
+            for (SkAlphaType alphaType : kAlphaTypes) {
+                for (int sampleX : { 2, 3, 5 }) {
+                    const SkImageInfo info = SkImageInfo::Make(kWidth, 1, colorType, alphaType);
+                    std::unique_ptr<SkSwizzler> sampled(SkSwizzler::CreateSwizzler(
+                            encodedInfo, nullptr, info, SkCodec::Options()));
+                    REPORTER_ASSERT(r, sampled);
+                    if (!sampled) {
+                        continue;
+                    }
+                    const int width = sampled->setSampleX(sampleX);
+
+                    uint8_t packed[kWidth * 8];
+                    for (int x = 0; x < width; x++) {
+                        memcpy(packed + x * bpp,
+                               src + (get_start_coord(sampleX) + x * sampleX) * bpp, bpp);
+                    }
+                    std::unique_ptr<SkSwizzler> unsampled(SkSwizzler::CreateSwizzler(
+                            encodedInfo, nullptr, info.makeWH(width, 1), SkCodec::Options()));
+
+                    uint32_t expected[kWidth], actual[kWidth];
+                    unsampled->swizzle(expected, packed);
+                    sampled->swizzle(actual, src);
+                    REPORTER_ASSERT(r, !memcmp(expected, actual, width * sizeof(uint32_t)),
+                                    "color %d bits %d sampleX %d", format.fColor,
+                                    format.fBitsPerComponent, sampleX);
+                }
+            }
+        }
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
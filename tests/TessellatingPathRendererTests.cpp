@@ -9,9 +9,12 @@
 
 #include "GrClip.h"
 #include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextOptions.h"
 #include "GrContextPriv.h"
 #include "GrShape.h"
 #include "GrStyle.h"
+#include "SkExecutor.h"
 #include "SkGradientShader.h"
 #include "SkPath.h"
 #include "SkShaderBase.h"
@@ -734,3 +737,39 @@ DEF_GPUTEST_FOR_ALL_CONTEXTS(TessellatingPathRendererTests, reporter, ctxInfo) {
     test_path(ctx, rtc.get(), create_path_42());
     test_path(ctx, rtc.get(), create_path_43(), SkMatrix(), GrAAType::kCoverage);
 }
+
+// Non-AA paths are tessellated on the executor's threads as they're recorded. Draw them under
+// several similarity transforms, twice over, so that later draws find tessellations cached by
+// earlier ones at a similar scale.
+DEF_GPUTEST_FOR_ALL_CONTEXTS(TessellatingPathRendererThreadedTests, reporter, ctxInfo) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    GrContextOptions options(ctxInfo.options());
+    options.fExecutor = executor.get();
+    sk_gpu_test::GrContextFactory factory(options);
+    GrContext* ctx = factory.get(ctxInfo.type());
+    if (!ctx) {
+        return;
+    }
+    sk_sp<GrRenderTargetContext> rtc(ctx->contextPriv().makeDeferredRenderTargetContext(
+            SkBackingFit::kApprox, 800, 800, kRGBA_8888_GrPixelConfig, nullptr, 1, GrMipMapped::kNo,
+            kTopLeft_GrSurfaceOrigin));
+    if (!rtc) {
+        return;
+    }
+    rtc->discard();
+
+    SkPath paths[] = { create_path_0(), create_path_2(), create_path_12(), create_path_13() };
+    SkMatrix matrices[4] = { SkMatrix::I(), SkMatrix::I(), SkMatrix::I(), SkMatrix::I() };
+    matrices[1].setScale(1.5f, 1.5f);
+    matrices[2].setRotate(30);
+    matrices[2].postTranslate(100, 50);
+    matrices[3].setScale(8, 8);
+    for (int i = 0; i < 2; ++i) {
+        for (const SkPath& path : paths) {
+            for (const SkMatrix& matrix : matrices) {
+                test_path(ctx, rtc.get(), path, matrix);
+            }
+        }
+        ctx->flush();
+    }
+}
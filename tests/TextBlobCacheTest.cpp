@@ -26,6 +26,7 @@
 
 #include "GrContext.h"
 #include "GrContextPriv.h"
+#include "text/GrTextBlob.h"
 
 static void draw(SkCanvas* canvas, int redraw, const SkTArray<sk_sp<SkTextBlob>>& blobs) {
     int yOffset = 0;
@@ -166,3 +167,56 @@ DEF_GPUTEST_FOR_NULLGL_CONTEXT(TextBlobAbnormal, reporter, ctxInfo) {
 DEF_GPUTEST_FOR_NULLGL_CONTEXT(TextBlobStressAbnormal, reporter, ctxInfo) {
     text_blob_cache_inner(reporter, ctxInfo.grContext(), 256, 256, 10, false, true);
 }
+
+static bool must_regenerate(GrTextBlob* blob, const SkMatrix& viewMatrix) {
+    SkPaint paint;
+    SkMaskFilterBase::BlurRec blurRec;
+    return blob->mustRegenerate(paint, true, blurRec, viewMatrix, 0, 0);
+}
+
+DEF_TEST(TextBlobCache_ScaleReuse, reporter) {
+    GrTextBlob::Key key;
+    key.fCanonicalColor = SK_ColorBLACK;
+    SkMaskFilterBase::BlurRec blurRec;
+    SkPaint paint;
+
+    // Path runs are reusable when zooming in, and down to their minimum scale.
+    sk_sp<GrTextBlob> paths = GrTextBlob::Make(1, 1);
+    paths->setupKey(key, blurRec, paint);
+    paths->initReusableBlob(SK_ColorBLACK, SkMatrix::MakeScale(2), 0, 0);
+    paths->setHasPaths(0.5f);
+    REPORTER_ASSERT(reporter, !must_regenerate(paths.get(), SkMatrix::MakeScale(8)));
+    REPORTER_ASSERT(reporter, !must_regenerate(paths.get(), SkMatrix::MakeScale(1.25f)));
+    REPORTER_ASSERT(reporter, must_regenerate(paths.get(), SkMatrix::MakeScale(0.5f)));
+
+    // Distance fields are reusable within their size bucket, even alongside paths.
+    paths->setHasDistanceField();
+    paths->setMinAndMaxScale(0.75f, 1.5f);
+    REPORTER_ASSERT(reporter, !must_regenerate(paths.get(), SkMatrix::MakeScale(2.5f)));
+    REPORTER_ASSERT(reporter, must_regenerate(paths.get(), SkMatrix::MakeScale(4)));
+    REPORTER_ASSERT(reporter, must_regenerate(paths.get(), SkMatrix::MakeScale(1.25f)));
+
+    // Any scale change regenerates bitmap glyphs.
+    sk_sp<GrTextBlob> bitmap = GrTextBlob::Make(1, 1);
+    bitmap->setupKey(key, blurRec, paint);
+    bitmap->initReusableBlob(SK_ColorBLACK, SkMatrix::I(), 0, 0);
+    bitmap->setHasBitmap();
+    REPORTER_ASSERT(reporter, !must_regenerate(bitmap.get(), SkMatrix::MakeTrans(3, 4)));
+    REPORTER_ASSERT(reporter, must_regenerate(bitmap.get(), SkMatrix::MakeScale(1.01f)));
+
+    // Under perspective only bitmap glyphs pin the blob to its matrix.
+    SkMatrix persp = SkMatrix::I();
+    persp.setPerspY(0.001f);
+    SkMatrix otherPersp = persp;
+    otherPersp.preScale(2, 2);
+    sk_sp<GrTextBlob> df = GrTextBlob::Make(1, 1);
+    df->setupKey(key, blurRec, paint);
+    df->initReusableBlob(SK_ColorBLACK, persp, 0, 0);
+    df->setHasDistanceField();
+    df->setMinAndMaxScale(32.f / 72, 1);
+    REPORTER_ASSERT(reporter, !must_regenerate(df.get(), otherPersp));
+    REPORTER_ASSERT(reporter, must_regenerate(df.get(), SkMatrix::I()));
+    df->setHasBitmap();
+    REPORTER_ASSERT(reporter, !must_regenerate(df.get(), persp));
+    REPORTER_ASSERT(reporter, must_regenerate(df.get(), otherPersp));
+}
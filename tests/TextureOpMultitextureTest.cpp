@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static constexpr int kCell = 8;
+static constexpr int kGrid = 12;
+
+static SkColor cell_color(int i) {
+    return SkColorSetRGB(20 * (i % kGrid), 255 - 20 * (i / kGrid), (37 * i) & 0xFF);
+}
+
+// Every cell of the grid is a different texture, so the draws are chained across more textures
+// than a single multitextured draw can sample from.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(TextureOpMultitexture, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    sk_sp<SkImage> images[kGrid * kGrid];
+    for (int i = 0; i < kGrid * kGrid; ++i) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kCell, kCell);
+        bitmap.eraseColor(cell_color(i));
+        bitmap.setImmutable();
+        images[i] = SkImage::MakeFromBitmap(bitmap)->makeTextureImage(context, nullptr);
+        REPORTER_ASSERT(reporter, images[i]);
+        if (!images[i]) {
+            return;
+        }
+    }
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kGrid * kCell, kGrid * kCell);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    REPORTER_ASSERT(reporter, surface);
+    if (!surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    // Draw the images twice, in opposite orders, so groups repeat textures.
+    for (int i = 0; i < kGrid * kGrid; ++i) {
+        canvas->drawImage(images[kGrid * kGrid - 1 - i], 0, 0);
+    }
+    for (int i = 0; i < kGrid * kGrid; ++i) {
+        canvas->drawImage(images[i], (i % kGrid) * kCell, (i / kGrid) * kCell);
+    }
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    REPORTER_ASSERT(reporter, surface->readPixels(actual, 0, 0));
+    for (int i = 0; i < kGrid * kGrid; ++i) {
+        int x = (i % kGrid) * kCell, y = (i / kGrid) * kCell;
+        bool allMatch = true;
+        for (int dy = 0; dy < kCell && allMatch; ++dy) {
+            for (int dx = 0; dx < kCell && allMatch; ++dx) {
+                allMatch = actual.getColor(x + dx, y + dy) == cell_color(i);
+            }
+        }
+        REPORTER_ASSERT(reporter, allMatch, "cell %d", i);
+    }
+}
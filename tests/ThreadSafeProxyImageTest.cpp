@@ -0,0 +1,100 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#include "GrContext.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImage.h"
+#include "SkImageEncoder.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+#include <thread>
+
+static constexpr int kSize = 16;
+
+static SkBitmap make_bitmap() {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kSize, kSize, true);
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorBLACK };
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(colors[(y >= kSize / 2) * 2 +
+                                                                (x >= kSize / 2)]);
+        }
+    }
+    bitmap.setImmutable();
+    return bitmap;
+}
+
+static bool draws_as(GrContext* context, SkImage* image, const SkBitmap& expected) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return false;
+    }
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    surface->getCanvas()->drawImage(image, 0, 0);
+    SkBitmap actual;
+    actual.allocPixels(info);
+    if (!surface->readPixels(actual, 0, 0)) {
+        return false;
+    }
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            if (actual.getColor(x, y) != expected.getColor(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ThreadSafeProxyMakeTextureImage, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    SkBitmap bitmap = make_bitmap();
+    sk_sp<SkImage> sources[] = {
+        SkImage::MakeFromBitmap(bitmap),
+        SkImage::MakeFromEncoded(SkEncodeBitmap(bitmap, SkEncodedImageFormat::kPNG, 100)),
+    };
+    const GrMipMapped mipMaps[] = { GrMipMapped::kNo, GrMipMapped::kYes };
+
+    // Both the decode and the proxy creation happen on another thread.
+    sk_sp<GrContextThreadSafeProxy> proxy = context->threadSafeProxy();
+    sk_sp<SkImage> images[SK_ARRAY_COUNT(sources)][SK_ARRAY_COUNT(mipMaps)];
+    std::thread worker([&] {
+        for (size_t i = 0; i < SK_ARRAY_COUNT(sources); ++i) {
+            for (size_t j = 0; j < SK_ARRAY_COUNT(mipMaps); ++j) {
+                images[i][j] = proxy->makeTextureImage(sources[i], mipMaps[j]);
+            }
+        }
+    });
+    worker.join();
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(sources); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(mipMaps); ++j) {
+            SkImage* image = images[i][j].get();
+            REPORTER_ASSERT(reporter, image);
+            if (!image) {
+                continue;
+            }
+            REPORTER_ASSERT(reporter, image->isTextureBacked());
+            REPORTER_ASSERT(reporter, image->isValid(context));
+            REPORTER_ASSERT(reporter, draws_as(context, image, bitmap), "source %d mips %d",
+                            (int)i, (int)j);
+            // Making it a texture image for the context it was made for is a no-op.
+            REPORTER_ASSERT(reporter, image->makeTextureImage(context, nullptr).get() == image);
+        }
+    }
+
+    // Images that are already textures aren't copied.
+    REPORTER_ASSERT(reporter, !proxy->makeTextureImage(images[0][0]));
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkGradientShader.h"
+#include "SkImage.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkSurface.h"
+#include "SkThreadedBMPDevice.h"
+#include "Test.h"
+
+static void draw_scene(SkCanvas* canvas, bool aa) {
+    SkPaint paint;
+    paint.setAntiAlias(aa);
+
+    canvas->clear(SK_ColorWHITE);
+
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeLTRB(10.5f, 20.25f, 180.75f, 300.5f), paint);
+
+    SkPath star;
+    star.moveTo(150, 10);
+    for (int i = 1; i < 7; ++i) {
+        SkScalar angle = SK_ScalarPI * 2 * i * 3 / 7;
+        star.lineTo(150 + 130 * SkScalarSin(angle), 200 - 180 * SkScalarCos(angle));
+    }
+    star.close();
+    paint.setColor(0x8000FF00);
+    canvas->drawPath(star, paint);
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(7);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(30, 250, 270, 390), 20, 30), paint);
+    canvas->drawPath(star, paint);
+    paint.setStyle(SkPaint::kFill_Style);
+
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(40, 100, 260, 340));
+    canvas->rotate(15);
+    const SkPoint pts[] = { {0, 0}, {300, 400} };
+    const SkColor colors[] = { SK_ColorYELLOW, SK_ColorMAGENTA };
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    canvas->drawOval(SkRect::MakeLTRB(60, 80, 240, 360), paint);
+    paint.setShader(nullptr);
+    canvas->restore();
+
+    const SkPoint points[] = { {5, 5}, {295, 395}, {295, 5}, {5, 395} };
+    paint.setColor(SK_ColorBLACK);
+    paint.setStrokeWidth(3);
+    canvas->drawPoints(SkCanvas::kLines_PointMode, SK_ARRAY_COUNT(points), points, paint);
+}
+
+static bool pixels_equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(uint32_t))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool pixels_close(const SkBitmap& a, const SkBitmap& b, int tolerance) {
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            uint32_t pa = *a.getAddr32(x, y),
+                     pb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (SkTAbs((int)((pa >> shift) & 0xFF) - (int)((pb >> shift) & 0xFF)) > tolerance) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static SkBitmap draw_threaded(int tiles, SkExecutor* executor, bool aa) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(300, 400);
+    {
+        SkCanvas canvas(sk_make_sp<SkThreadedBMPDevice>(bitmap, tiles, executor));
+        draw_scene(&canvas, aa);
+    }
+    return bitmap;
+}
+
+// Draws the scene once per tile into a plain bitmap device, clipped the way SkThreadedBMPDevice
+// clips its tiles. Scan converting against a smaller clip can move edge pixels, so this is what
+// the tiled device has to match.
+static SkBitmap draw_clipped_to_tiles(int tiles, bool aa) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(300, 400);
+    SkCanvas canvas(bitmap);
+    for (int tile = 0; tile < tiles; ++tile) {
+        canvas.save();
+        canvas.clipRect(SkRect::MakeLTRB(0, 400 * tile / tiles, 300, 400 * (tile + 1) / tiles));
+        draw_scene(&canvas, aa);
+        canvas.restore();
+    }
+    return bitmap;
+}
+
+DEF_TEST(ThreadedBMPDevice_TilesMatch, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int tiles : { 1, 2, 7, 32 }) {
+        SkBitmap tiled = draw_threaded(tiles, executor.get(), false);
+        REPORTER_ASSERT(reporter, pixels_equal(draw_clipped_to_tiles(tiles, false), tiled),
+                        "tiles %d", tiles);
+    }
+
+    // Anti-aliased fills share coverage computed once against the whole clip, which need not
+    // come from the same scan converter a plain device would pick, so only expect them close.
+    SkBitmap reference = draw_clipped_to_tiles(1, true);
+    for (int tiles : { 1, 2, 7, 32 }) {
+        SkBitmap tiled = draw_threaded(tiles, executor.get(), true);
+        REPORTER_ASSERT(reporter, pixels_close(reference, tiled, 64), "aa tiles %d", tiles);
+    }
+}
+
+DEF_TEST(ThreadedBMPDevice_Surface, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 400);
+    const SkSurfaceProps props(SkSurfaceProps::kThreadedRaster_Flag, kUnknown_SkPixelGeometry);
+    auto threaded = SkSurface::MakeRaster(info, &props);
+    auto plain = SkSurface::MakeRaster(info);
+
+    // Axis-aligned rects scan convert the same way whatever the tiling.
+    for (SkCanvas* canvas : { threaded->getCanvas(), plain->getCanvas() }) {
+        SkPaint paint;
+        canvas->clear(SK_ColorWHITE);
+        paint.setColor(SK_ColorRED);
+        canvas->drawRect(SkRect::MakeLTRB(10, 20, 180, 300), paint);
+        paint.setColor(0x8000FF00);
+        canvas->drawRect(SkRect::MakeLTRB(100, 50, 290, 390), paint);
+    }
+
+    // readPixels() must see the pending draws.
+    SkBitmap threadedPixels, plainPixels;
+    threadedPixels.allocPixels(info);
+    plainPixels.allocPixels(info);
+    REPORTER_ASSERT(reporter, threaded->readPixels(threadedPixels, 0, 0));
+    REPORTER_ASSERT(reporter, plain->readPixels(plainPixels, 0, 0));
+    REPORTER_ASSERT(reporter, pixels_equal(threadedPixels, plainPixels));
+
+    // So must snapshots, and drawing after a snapshot must not change it.
+    threaded->getCanvas()->drawColor(SK_ColorGREEN);
+    sk_sp<SkImage> snapshot = threaded->makeImageSnapshot();
+    threaded->getCanvas()->drawColor(SK_ColorBLUE);
+    SkPixmap pm;
+    REPORTER_ASSERT(reporter, snapshot->peekPixels(&pm));
+    REPORTER_ASSERT(reporter, *pm.addr32(150, 200) == SkPreMultiplyColor(SK_ColorGREEN));
+    REPORTER_ASSERT(reporter, threaded->readPixels(threadedPixels, 0, 0));
+    REPORTER_ASSERT(reporter, *threadedPixels.getAddr32(150, 200) ==
+                              SkPreMultiplyColor(SK_ColorBLUE));
+}
@@ -12,12 +12,15 @@
 #include "GrContextFactory.h"
 #include "GrContextPriv.h"
 #include "GrGpu.h"
+#include "GrProxyProvider.h"
 #include "GrResourceProvider.h"
 #include "GrSurfaceProxy.h"
 #include "GrTexture.h"
 #include "SkGr.h"
+#include "SkImage.h"
 #include "SkSurface.h"
 #include "Test.h"
+#include "mock/GrMockTypes.h"
 
 using sk_gpu_test::GrContextFactory;
 
@@ -177,3 +180,79 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(TransferPixelsTest, reporter, ctxInfo) {
     basic_transfer_test(reporter, ctxInfo.grContext(), GrColorType::kBGRA_8888, false);
     basic_transfer_test(reporter, ctxInfo.grContext(), GrColorType::kBGRA_8888, true);
 }
+
+static sk_sp<SkImage> make_upload_image(int size, SkColor color) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::Make(size, size, kRGBA_8888_SkColorType,
+                                         kPremul_SkAlphaType));
+    bitmap.eraseColor(color);
+    bitmap.setImmutable();
+    return SkImage::MakeFromBitmap(bitmap);
+}
+
+DEF_GPUTEST(StagedTextureUploads, reporter, options) {
+    GrContextOptions stagedOptions = options;
+    stagedOptions.fStagedTextureUploads = GrContextOptions::Enable::kYes;
+
+    // On the mock backend fences signal right away, so each flush frees the staging buffers.
+    {
+        GrMockOptions mockOptions;
+        mockOptions.fMapBufferFlags = GrCaps::kCanMap_MapFlag;
+        mockOptions.fFenceSyncSupport = true;
+        mockOptions.fTransferBufferSupport = true;
+        sk_sp<GrContext> context = GrContext::MakeMock(&mockOptions, stagedOptions);
+        GrStagingBufferRing* ring = context->contextPriv().resourceProvider()->stagingBufferRing();
+        REPORTER_ASSERT(reporter, ring);
+        if (!ring) {
+            return;
+        }
+
+        GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
+        sk_sp<SkImage> image = make_upload_image(64, SK_ColorRED);
+        for (int frame = 0; frame < 2; ++frame) {
+            for (int i = 0; i < 3; ++i) {
+                sk_sp<GrTextureProxy> proxy = proxyProvider->createTextureProxy(
+                        image, kNone_GrSurfaceFlags, 1, SkBudgeted::kYes, SkBackingFit::kExact);
+                REPORTER_ASSERT(reporter, proxy && proxy->isInstantiated());
+            }
+            // Three uploads in flight at once need three buffers, which the next frame reuses.
+            REPORTER_ASSERT(reporter, 3 == ring->bufferCount());
+            context->flush();
+        }
+#if GR_GPU_STATS
+        GrGpu::Stats* stats = context->contextPriv().getGpu()->stats();
+        REPORTER_ASSERT(reporter, 6 == stats->transfersToTexture());
+        REPORTER_ASSERT(reporter, 0 == stats->textureUploads());
+#endif
+    }
+
+    // The staged uploads land on real backends too.
+    for (int typeInt = 0; typeInt < sk_gpu_test::GrContextFactory::kContextTypeCnt; ++typeInt) {
+        auto contextType = static_cast<sk_gpu_test::GrContextFactory::ContextType>(typeInt);
+        if (!sk_gpu_test::GrContextFactory::IsRenderingContext(contextType)) {
+            continue;
+        }
+        sk_gpu_test::GrContextFactory factory(stagedOptions);
+        GrContext* context = factory.get(contextType);
+        if (!context || !context->contextPriv().resourceProvider()->stagingBufferRing()) {
+            continue;
+        }
+        skiatest::ReporterContext ctx(
+                reporter, SkString(sk_gpu_test::GrContextFactory::ContextTypeName(contextType)));
+
+        for (SkColor color : { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE }) {
+            sk_sp<SkImage> texture = make_upload_image(32, color)->makeTextureImage(context,
+                                                                                    nullptr);
+            REPORTER_ASSERT(reporter, texture);
+            if (!texture) {
+                continue;
+            }
+            SkBitmap result;
+            result.allocPixels(SkImageInfo::Make(32, 32, kRGBA_8888_SkColorType,
+                                                 kPremul_SkAlphaType));
+            REPORTER_ASSERT(reporter, texture->readPixels(result.pixmap(), 0, 0));
+            REPORTER_ASSERT(reporter, color == result.getColor(0, 0));
+            REPORTER_ASSERT(reporter, color == result.getColor(31, 31));
+        }
+    }
+}
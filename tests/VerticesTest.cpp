@@ -6,6 +6,8 @@
  */
 
 #include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkShader.h"
 #include "SkSurface.h"
 #include "SkVertices.h"
 #include "sk_pixel_iter.h"
@@ -147,3 +149,56 @@ DEF_TEST(Vertices_clipping, reporter) {
         }
     }
 }
+
+DEF_TEST(Vertices_texture, reporter) {
+    // Two triangles that map a texture exactly onto a rect draw just like the image does,
+    // including when they are modulated by opaque white colors or drawn with a translucent paint.
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            *bm.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, x * 16, y * 16, (x ^ y) * 16);
+        }
+    }
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bm);
+
+    const SkPoint pos[] = { { 4, 4 }, { 36, 4 }, { 36, 36 }, { 4, 36 } };
+    const SkPoint tex[] = { { 0, 0 }, { 16, 0 }, { 16, 16 }, { 0, 16 } };
+    const SkColor colors[] = { SK_ColorWHITE, SK_ColorWHITE, SK_ColorWHITE, SK_ColorWHITE };
+    const uint16_t indices[] = { 0, 1, 2, 0, 2, 3 };
+
+    for (bool withColors : { false, true }) {
+        for (SkAlpha alpha : { 0xFF, 0x80 }) {
+            for (SkFilterQuality quality : { kNone_SkFilterQuality, kLow_SkFilterQuality }) {
+                SkPaint paint;
+                paint.setAlpha(alpha);
+                paint.setFilterQuality(quality);
+
+                SkBitmap expected, actual;
+                expected.allocN32Pixels(40, 40);
+                expected.eraseColor(SK_ColorTRANSPARENT);
+                SkCanvas(expected).drawImageRect(image, SkRect::MakeLTRB(4, 4, 36, 36), &paint);
+
+                actual.allocN32Pixels(40, 40);
+                actual.eraseColor(SK_ColorTRANSPARENT);
+                paint.setShader(image->makeShader());
+                auto verts = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, 4, pos, tex,
+                                                  withColors ? colors : nullptr, 6, indices);
+                SkCanvas(actual).drawVertices(verts, SkBlendMode::kModulate, paint);
+
+                int mismatches = 0;
+                for (int y = 0; y < 40; ++y) {
+                    for (int x = 0; x < 40; ++x) {
+                        const uint8_t* ep = (const uint8_t*)expected.getAddr32(x, y);
+                        const uint8_t* ap = (const uint8_t*)actual.getAddr32(x, y);
+                        for (int i = 0; i < 4; ++i) {
+                            mismatches += SkTAbs(ep[i] - ap[i]) > 1;
+                        }
+                    }
+                }
+                REPORTER_ASSERT(reporter, 0 == mismatches, "colors %d, alpha %d, quality %d",
+                                withColors, alpha, quality);
+            }
+        }
+    }
+}
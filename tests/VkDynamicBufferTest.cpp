@@ -0,0 +1,67 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#if defined(SK_VULKAN)
+
+#include "SkCanvas.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static constexpr int kSize = 64;
+static constexpr int kFrames = 8;
+
+static SkColor frame_color(int frame) {
+    return SkColorSetRGB(32 * frame, 255 - 32 * frame, 128);
+}
+
+// Each frame's rects carry their color in their vertices, so a vertex buffer that was reused while
+// an earlier frame still read from it would show up as the wrong color.
+static void draw_frame(SkCanvas* canvas, int frame) {
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setColor(frame_color(frame));
+    for (int y = 0; y < kSize; y += 2) {
+        for (int x = 0; x < kSize; x += 2) {
+            canvas->drawRect(SkRect::MakeXYWH(x, y, 2, 2), paint);
+        }
+    }
+}
+
+DEF_GPUTEST_FOR_VULKAN_CONTEXT(VkDynamicBufferReuse, reporter, ctxInfo) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+
+    // Flush every frame without waiting on it, so later frames recycle the earlier ones' buffers.
+    sk_sp<SkSurface> surfaces[kFrames];
+    for (int i = 0; i < kFrames; ++i) {
+        surfaces[i] = SkSurface::MakeRenderTarget(ctxInfo.grContext(), SkBudgeted::kNo, info);
+        REPORTER_ASSERT(reporter, surfaces[i]);
+        if (!surfaces[i]) {
+            return;
+        }
+        draw_frame(surfaces[i]->getCanvas(), i);
+        surfaces[i]->getCanvas()->flush();
+    }
+
+    for (int i = 0; i < kFrames; ++i) {
+        SkBitmap actual;
+        actual.allocPixels(info);
+        REPORTER_ASSERT(reporter, surfaces[i]->readPixels(actual, 0, 0));
+        bool allMatch = true;
+        for (int y = 0; y < kSize && allMatch; ++y) {
+            for (int x = 0; x < kSize && allMatch; ++x) {
+                allMatch = actual.getColor(x, y) == frame_color(i);
+            }
+        }
+        REPORTER_ASSERT(reporter, allMatch, "frame %d", i);
+    }
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#if defined(SK_VULKAN)
+
+#include "GrContextFactory.h"
+#include "GrContextOptions.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkGradientShader.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+using sk_gpu_test::GrContextFactory;
+
+static bool draw(GrContext* context, SkBitmap* result) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return false;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+
+    // Overlapping draws that alternate between two kinds of shader can't be batched, so each is a
+    // draw of its own, and there are enough of them to fill several recorded command buffers.
+    const SkPoint pts[] = { { 0, 0 }, { 64, 64 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE, SK_ColorGREEN };
+    sk_sp<SkShader> linear = SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                          SkShader::kClamp_TileMode);
+    sk_sp<SkShader> radial = SkGradientShader::MakeRadial({ 32, 32 }, 32, colors, nullptr, 3,
+                                                          SkShader::kMirror_TileMode);
+    SkPaint paint;
+    for (int i = 0; i < 1000; ++i) {
+        paint.setShader(i % 2 ? linear : radial);
+        canvas->drawRect(SkRect::MakeXYWH(i % 61, (i / 61) * 4, 3, 3), paint);
+    }
+    result->allocPixels(info);
+    return surface->readPixels(*result, 0, 0);
+}
+
+DEF_GPUTEST_FOR_VULKAN_CONTEXT(VkParallelRecording, reporter, ctxInfo) {
+    SkBitmap expected;
+    REPORTER_ASSERT(reporter, draw(ctxInfo.grContext(), &expected));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    GrContextOptions options(ctxInfo.options());
+    options.fExecutor = executor.get();
+
+    // Twice, so the second draw reuses the recycled command buffers of the first.
+    GrContextFactory factory(options);
+    GrContext* context = factory.get(ctxInfo.type());
+    for (int i = 0; i < 2; ++i) {
+        SkBitmap actual;
+        REPORTER_ASSERT(reporter, context && draw(context, &actual));
+        REPORTER_ASSERT(reporter,
+                        expected.computeByteSize() == actual.computeByteSize() &&
+                        !memcmp(expected.getPixels(), actual.getPixels(),
+                                expected.computeByteSize()));
+    }
+}
+
+#endif
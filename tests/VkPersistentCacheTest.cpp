@@ -0,0 +1,85 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#if defined(SK_VULKAN)
+
+#include "GrContextFactory.h"
+#include "GrContextOptions.h"
+#include "MemoryCache.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkGradientShader.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+using sk_gpu_test::GrContextFactory;
+
+static bool draw(GrContext* context, SkBitmap* result) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(32, 32);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return false;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    const SkPoint pts[] = { { 0, 0 }, { 32, 32 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    canvas->drawCircle(16, 16, 12, paint);
+    result->allocPixels(info);
+    return surface->readPixels(*result, 0, 0);
+}
+
+DEF_GPUTEST_FOR_VULKAN_CONTEXT(VkPersistentCache, reporter, ctxInfo) {
+    sk_gpu_test::MemoryCache cache;
+    GrContextOptions options(ctxInfo.options());
+    options.fPersistentCache = &cache;
+
+    // A cold cache compiles everything, and is filled with the SPIR-V as it goes and with the
+    // VkPipelineCache's data when the context goes away.
+    SkBitmap cold;
+    {
+        GrContextFactory factory(options);
+        GrContext* context = factory.get(ctxInfo.type());
+        REPORTER_ASSERT(reporter, context && draw(context, &cold));
+    }
+    REPORTER_ASSERT(reporter, cache.numCacheMisses() > 0);
+
+    // A warm cache has everything a second context asks for, and draws the same.
+    cache.resetNumCacheMisses();
+    SkBitmap warm;
+    {
+        GrContextFactory factory(options);
+        GrContext* context = factory.get(ctxInfo.type());
+        REPORTER_ASSERT(reporter, context && draw(context, &warm));
+    }
+    REPORTER_ASSERT(reporter, 0 == cache.numCacheMisses());
+    REPORTER_ASSERT(reporter, cold.computeByteSize() == warm.computeByteSize() &&
+                              !memcmp(cold.getPixels(), warm.getPixels(), cold.computeByteSize()));
+
+    // Data made by another device is ignored rather than handed to the driver.
+    static const char kKey[] = "VkPipelineCache";
+    sk_sp<SkData> key = SkData::MakeWithoutCopy(kKey, sizeof(kKey) - 1);
+    REPORTER_ASSERT(reporter, cache.load(*key));
+    char garbage[64] = {};
+    cache.store(*key, *SkData::MakeWithoutCopy(garbage, sizeof(garbage)));
+    {
+        GrContextFactory factory(options);
+        GrContext* context = factory.get(ctxInfo.type());
+        SkBitmap result;
+        REPORTER_ASSERT(reporter, context && draw(context, &result));
+    }
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#if defined(SK_VULKAN)
+
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkImage.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static constexpr int kSize = 256;
+static constexpr int kCell = 4;
+
+static sk_sp<SkImage> make_image(SkColor color) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kCell, kCell);
+    bitmap.eraseColor(color);
+    bitmap.setImmutable();
+    return SkImage::MakeFromBitmap(bitmap);
+}
+
+static void draw(SkCanvas* canvas) {
+    canvas->clear(SK_ColorWHITE);
+
+    // Every cell gets a gradient of its own, so each is a draw with its own uniforms, and there
+    // are enough of them to go through several of the ring's chunks.
+    SkPaint paint;
+    for (int y = 0; y < kSize; y += kCell) {
+        for (int x = 0; x < kSize; x += kCell) {
+            const SkPoint pts[] = { { SkIntToScalar(x), 0 }, { SkIntToScalar(x + kCell), 0 } };
+            const SkColor colors[] = { SkColorSetRGB(x, y, 0), SkColorSetRGB(0, x, y) };
+            paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                         SkShader::kClamp_TileMode));
+            canvas->drawRect(SkRect::MakeXYWH(x, y, kCell, kCell), paint);
+        }
+    }
+
+    // Runs of the same texture reuse a sampler descriptor set; changes must write a new one.
+    sk_sp<SkImage> images[] = { make_image(SK_ColorRED), make_image(SK_ColorBLUE) };
+    const int pattern[] = { 0, 0, 1, 0, 1, 1, 1, 0 };
+    for (int i = 0; i < 64; ++i) {
+        canvas->drawImage(images[pattern[i % SK_ARRAY_COUNT(pattern)]], i * kCell, 0);
+    }
+}
+
+static bool nearly_equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            SkColor ca = a.getColor(x, y), cb = b.getColor(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (SkTAbs((int)((ca >> shift) & 0xFF) - (int)((cb >> shift) & 0xFF)) > 2) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+DEF_GPUTEST_FOR_VULKAN_CONTEXT(VkUniformRingBuffer, reporter, ctxInfo) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    {
+        SkCanvas canvas(expected);
+        draw(&canvas);
+    }
+
+    // Twice, so the second draw goes through chunks recycled from the first.
+    for (int i = 0; i < 2; ++i) {
+        sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(ctxInfo.grContext(),
+                                                               SkBudgeted::kNo, info);
+        REPORTER_ASSERT(reporter, surface);
+        if (!surface) {
+            return;
+        }
+        draw(surface->getCanvas());
+        SkBitmap actual;
+        actual.allocPixels(info);
+        REPORTER_ASSERT(reporter, surface->readPixels(actual, 0, 0));
+        REPORTER_ASSERT(reporter, nearly_equal(expected, actual));
+    }
+}
+
+#endif
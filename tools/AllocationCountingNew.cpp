@@ -0,0 +1,46 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Replaces the global operator new so that SkMemoryAccounting's allocation counts include it.
+// Linked into nanobench when skia_count_new_allocations is set.
+
+#include "SkMalloc.h"
+#include "SkMemoryAccounting.h"
+
+#include <cstdlib>
+#include <new>
+
+static void* counted_new(size_t size) {
+    SkMemoryAccounting::CountAllocation(size);
+    // operator new must return a unique pointer even when asked for nothing.
+    return malloc(size ? size : 1);
+}
+
+// Skia builds without exceptions, so running out of memory aborts instead of throwing.
+void* operator new(size_t size) {
+    void* p = counted_new(size);
+    if (!p) {
+        sk_out_of_memory();
+    }
+    return p;
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return counted_new(size);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return counted_new(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PerfCounters.h"
+#include "SkTypes.h"
+
+#include <cstring>
+
+using namespace sk_tools;
+
+const char* PerfCounters::Name(Counter counter) {
+    switch (counter) {
+        case kCycles:       return "cycles";
+        case kInstructions: return "instructions";
+        case kCacheMisses:  return "cache_misses";
+        case kBranchMisses: return "branch_misses";
+    }
+    SkASSERT(false);
+    return "";
+}
+
+bool PerfCounters::read(Counter counter, double* count) const {
+    if (fIndex[counter] < 0) {
+        return false;
+    }
+    uint64_t values[kCounterCount], enabled, running;
+    this->readRaw(values, &enabled, &running);
+
+    const int i = fIndex[counter];
+    *count = (double)(values[i] - fBase[i]);
+    enabled -= fBaseEnabled;
+    running -= fBaseRunning;
+    if (running > 0 && running < enabled) {
+        *count *= (double)enabled / running;
+    }
+    return true;
+}
+
+void PerfCounters::reset() {
+    this->readRaw(fBase, &fBaseEnabled, &fBaseRunning);
+}
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int open_counter(uint32_t type, uint64_t config, int leader) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    // The leader starts and stops the whole group.
+    attr.disabled = leader < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread, on whichever CPU it runs.
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+std::unique_ptr<PerfCounters> PerfCounters::Make() {
+    static const struct {
+        uint32_t fType;
+        uint64_t fConfig;
+    } kEvents[kCounterCount] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    std::unique_ptr<PerfCounters> counters(new PerfCounters);
+    for (int i = 0; i < kCounterCount; ++i) {
+        counters->fFds[i] = open_counter(kEvents[i].fType, kEvents[i].fConfig, counters->fLeader);
+        counters->fIndex[i] = -1;
+        if (counters->fFds[i] >= 0) {
+            counters->fIndex[i] = counters->fOpened++;
+            if (counters->fLeader < 0) {
+                counters->fLeader = counters->fFds[i];
+            }
+        }
+    }
+    if (counters->fLeader < 0) {
+        return nullptr;
+    }
+    counters->reset();
+    return counters;
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fFds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void PerfCounters::start() {
+    ioctl(fLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters::stop() {
+    ioctl(fLeader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters::readRaw(uint64_t values[kCounterCount],
+                           uint64_t* enabled, uint64_t* running) const {
+    struct {
+        uint64_t fCount;
+        uint64_t fEnabled;
+        uint64_t fRunning;
+        uint64_t fValues[kCounterCount];
+    } group;
+    memset(&group, 0, sizeof(group));
+    if (::read(fLeader, &group, sizeof(group)) <= 0) {
+        memset(&group, 0, sizeof(group));
+    }
+    memcpy(values, group.fValues, sizeof(group.fValues));
+    *enabled = group.fEnabled;
+    *running = group.fRunning;
+}
+
+#else
+
+// macOS has counters too, but only through the private kperf framework, and only for root.
+
+std::unique_ptr<PerfCounters> PerfCounters::Make() { return nullptr; }
+PerfCounters::~PerfCounters() {}
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+void PerfCounters::readRaw(uint64_t values[kCounterCount],
+                           uint64_t* enabled, uint64_t* running) const {
+    memset(values, 0, kCounterCount * sizeof(uint64_t));
+    *enabled = *running = 0;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef PerfCounters_DEFINED
+#define PerfCounters_DEFINED
+
+#include <cstdint>
+#include <memory>
+
+namespace sk_tools {
+
+/**
+ *  Hardware performance counters for the thread that created them, read with perf_event_open()
+ *  on Linux. Only user space is counted. The counts accumulate while the counters are started,
+ *  until reset() is called.
+ */
+class PerfCounters {
+public:
+    enum Counter {
+        kCycles,
+        kInstructions,
+        kCacheMisses,
+        kBranchMisses,
+
+        kLast = kBranchMisses
+    };
+    static constexpr int kCounterCount = kLast + 1;
+
+    static const char* Name(Counter);
+
+    /**
+     *  Returns null if no counter can be opened: on other platforms, when there is no PMU (as in
+     *  many VMs), or when /proc/sys/kernel/perf_event_paranoid doesn't allow it.
+     */
+    static std::unique_ptr<PerfCounters> Make();
+
+    ~PerfCounters();
+
+    void start();
+    void stop();
+    void reset();
+
+    /**
+     *  Returns false if the counter isn't available on this machine. Counts are scaled up if the
+     *  kernel had to multiplex the counters with other users.
+     */
+    bool read(Counter, double* count) const;
+
+private:
+    PerfCounters() = default;
+
+    void readRaw(uint64_t values[kCounterCount], uint64_t* enabled, uint64_t* running) const;
+
+    int      fLeader = -1;
+    int      fFds[kCounterCount];
+    int      fIndex[kCounterCount];  // Order of each counter in a group read, or -1.
+    int      fOpened = 0;
+    uint64_t fBase[kCounterCount];
+    uint64_t fBaseEnabled = 0;
+    uint64_t fBaseRunning = 0;
+};
+
+}  // namespace sk_tools
+
+#endif  // PerfCounters_DEFINED
@@ -0,0 +1,335 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "RecordProfile.h"
+
+#include "FenceSync.h"
+#include "GpuTimer.h"
+#include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkImageFilter.h"
+#include "SkJSONWriter.h"
+#include "SkMaskFilter.h"
+#include "SkPathEffect.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkShader.h"
+#include "SkTHash.h"
+#include "SkTime.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+SkString describe(const SkPaint* paint) {
+    if (!paint) {
+        return SkString("none");
+    }
+    SkString desc(paint->getStyle() == SkPaint::kFill_Style ? "fill" : "stroke");
+    if (paint->isAntiAlias()) {
+        desc.append(" aa");
+    }
+    if (paint->getAlpha() != 0xFF) {
+        desc.append(" alpha");
+    }
+    desc.appendf(" %s", SkBlendMode_Name(paint->getBlendMode()));
+
+    auto effect = [&](const char* what, const SkFlattenable* flattenable) {
+        if (flattenable) {
+            const char* name = flattenable->getTypeName();
+            desc.appendf(" %s:%s", what, name ? name : "?");
+        }
+    };
+    effect("shader",      paint->getShader());
+    effect("colorfilter", paint->getColorFilter());
+    effect("maskfilter",  paint->getMaskFilter());
+    effect("pathfx",      paint->getPathEffect());
+    effect("imagefilter", paint->getImageFilter());
+    return desc;
+}
+
+class Profiler {
+public:
+    Profiler(SkCanvas* canvas, const RecordProfileOptions& options, RecordProfile* profile)
+        : fCanvas(canvas)
+        , fOptions(options)
+        , fProfile(profile)
+        , fDraw(canvas, nullptr, nullptr, 0) {}
+
+    void setQueries(std::vector<sk_gpu_test::PlatformTimerQuery>* queries) { fQueries = queries; }
+
+    template <typename T>
+    void operator()(const T& op) {
+        RecordProfile::Op& stats = fProfile->fOps[fIndex];
+        if (stats.fType == nullptr) {
+            stats.fIndex = fIndex;
+            stats.fType  = NameOf(op);
+            stats.fPaint = this->paint(op);
+        }
+
+        sk_gpu_test::GpuTimer* timer = fQueries ? fOptions.fGpuTimer : nullptr;
+        auto start = SkTime::GetNSecs();
+        if (timer) {
+            timer->queueStart();
+        }
+        fDraw(op);
+        if (fOptions.fFlushEachOp || timer) {
+            fCanvas->flush();
+        }
+        if (timer) {
+            (*fQueries)[fIndex] = timer->queueStop();
+        }
+        stats.fCpuNs += SkTime::GetNSecs() - start;
+        fIndex++;
+    }
+
+    void operator()(const SkRecords::NoOp&) {
+        fProfile->fOps[fIndex].fIndex = fIndex;
+        fProfile->fOps[fIndex].fType  = "NoOp";
+        fIndex++;
+    }
+
+    void rewind() { fIndex = 0; }
+
+private:
+    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+    static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
+
+    template <typename T>
+    SK_WHEN(T::kTags & SkRecords::kHasPaint_Tag, SkString) paint(const T& op) {
+        return describe(AsPtr(op.paint));
+    }
+    template <typename T>
+    SK_WHEN(!(T::kTags & SkRecords::kHasPaint_Tag), SkString) paint(const T&) {
+        return SkString();
+    }
+
+    template <typename T>
+    static const char* NameOf(const T&) {
+    #define CASE(U) case SkRecords::U##_Type: return #U;
+        switch(T::kType) { SK_RECORD_TYPES(CASE); }
+    #undef CASE
+        SkDEBUGFAIL("Unknown T");
+        return "Unknown T";
+    }
+
+    SkCanvas*                                      fCanvas;
+    const RecordProfileOptions&                    fOptions;
+    RecordProfile*                                 fProfile;
+    SkRecords::Draw                                fDraw;
+    std::vector<sk_gpu_test::PlatformTimerQuery>*  fQueries = nullptr;
+    int                                            fIndex = 0;
+};
+
+// Which ops touch pixels: draws, and layers (which are allocated and composited).
+struct TouchesPixels {
+    bool operator()(const SkRecords::SaveLayer&) { return true; }
+
+    template <typename T>
+    bool operator()(const T&) { return SkToBool(T::kTags & SkRecords::kDraw_Tag); }
+};
+
+}  // namespace
+
+void ProfileRecord(const SkRecord& record, SkCanvas* canvas, const RecordProfileOptions& options,
+                   RecordProfile* profile) {
+    profile->fOps.reset(record.count());
+    profile->fLoops = SkTMax(options.fLoops, 1);
+    profile->fHasGpuTimes = false;
+
+    // Pixel cost: each op's bounds in device space, clipped to the canvas.
+    {
+        SkAutoTMalloc<SkRect> bounds(record.count());
+        SkRecordFillBounds(canvas->getLocalClipBounds(), record, bounds.get());
+        const SkMatrix& ctm = canvas->getTotalMatrix();
+        const SkIRect clip = canvas->getDeviceClipBounds();
+        TouchesPixels touches;
+        for (int i = 0; i < record.count(); i++) {
+            SkIRect device = ctm.mapRect(bounds[i]).roundOut();
+            if (record.visit(i, touches) && device.intersect(clip)) {
+                profile->fOps[i].fPixels = (int64_t)device.width() * device.height();
+            }
+        }
+    }
+
+    const bool timeGpu = options.fGpuTimer && options.fFenceSync;
+    std::vector<sk_gpu_test::PlatformTimerQuery> queries;
+
+    Profiler profiler(canvas, options, profile);
+    for (int loop = 0; loop < profile->fLoops; loop++) {
+        if (timeGpu) {
+            queries.assign(record.count(), sk_gpu_test::kInvalidTimerQuery);
+            profiler.setQueries(&queries);
+        }
+
+        SkAutoCanvasRestore acr(canvas, true);
+        profiler.rewind();
+        for (int i = 0; i < record.count(); i++) {
+            record.visit(i, profiler);
+        }
+        canvas->flush();
+
+        if (!timeGpu) {
+            continue;
+        }
+        sk_gpu_test::PlatformFence fence = options.fFenceSync->insertFence();
+        const bool synced = fence != sk_gpu_test::kInvalidFence &&
+                            options.fFenceSync->waitFence(fence);
+        if (!synced) {
+            SkDebugf("ProfileRecord: fence wait failed; dropping this loop's GPU times.\n");
+        }
+        options.fFenceSync->deleteFence(fence);
+
+        for (int i = 0; i < record.count(); i++) {
+            if (queries[i] == sk_gpu_test::kInvalidTimerQuery) {
+                continue;
+            }
+            using QueryStatus = sk_gpu_test::GpuTimer::QueryStatus;
+            if (synced &&
+                options.fGpuTimer->checkQueryStatus(queries[i]) == QueryStatus::kAccurate) {
+                profile->fOps[i].fGpuNs +=
+                        options.fGpuTimer->getTimeElapsed(queries[i]).count();
+                profile->fOps[i].fGpuSamples++;
+                profile->fHasGpuTimes = true;
+            }
+            options.fGpuTimer->deleteQuery(queries[i]);
+        }
+    }
+
+    for (RecordProfile::Op& op : profile->fOps) {
+        op.fCpuNs /= profile->fLoops;
+        if (op.fGpuSamples > 0) {
+            op.fGpuNs /= op.fGpuSamples;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Totals {
+    const char* fType = nullptr;
+    SkString    fPaint;
+    int         fCount = 0;
+    double      fCpuNs = 0,
+                fGpuNs = 0;
+    int64_t     fPixels = 0;
+
+    void add(const RecordProfile::Op& op) {
+        fType = op.fType;
+        fCount++;
+        fCpuNs  += op.fCpuNs;
+        fGpuNs  += op.fGpuNs;
+        fPixels += op.fPixels;
+    }
+};
+
+void write_costs(SkJSONWriter& writer, double cpuNs, double gpuNs, bool hasGpu, int64_t pixels) {
+    writer.appendDoubleDigits("cpu_us", cpuNs * 1e-3, 3);
+    if (hasGpu) {
+        writer.appendDoubleDigits("gpu_us", gpuNs * 1e-3, 3);
+    }
+    writer.appendS64("pixels", pixels);
+    if (pixels > 0) {
+        // Cost per megapixel, to tell expensive pixels from merely many of them.
+        writer.appendDoubleDigits("us_per_mpix", (hasGpu ? gpuNs : cpuNs) * 1e3 / pixels, 3);
+    }
+}
+
+void write_totals(SkJSONWriter& writer, const char* name, SkTHashMap<SkString, Totals>& map,
+                  bool hasGpu, int topN, bool withPaint) {
+    std::vector<const Totals*> sorted;
+    map.foreach([&](const SkString&, Totals* t) { sorted.push_back(t); });
+    std::sort(sorted.begin(), sorted.end(), [&](const Totals* a, const Totals* b) {
+        return hasGpu ? a->fGpuNs > b->fGpuNs : a->fCpuNs > b->fCpuNs;
+    });
+    if ((int)sorted.size() > topN) {
+        sorted.resize(topN);
+    }
+
+    writer.beginArray(name);
+    for (const Totals* t : sorted) {
+        writer.beginObject(nullptr, false);
+        writer.appendString("type", t->fType);
+        if (withPaint) {
+            writer.appendString("paint", t->fPaint.c_str());
+        }
+        writer.appendS32("count", t->fCount);
+        write_costs(writer, t->fCpuNs, t->fGpuNs, hasGpu, t->fPixels);
+        writer.endObject();
+    }
+    writer.endArray();
+}
+
+}  // namespace
+
+void RecordProfile::writeJSON(SkWStream* stream, int topN) const {
+    const bool hasGpu = fHasGpuTimes;
+    auto cost = [&](const Op& op) { return hasGpu ? op.fGpuNs : op.fCpuNs; };
+
+    double cpuNs = 0, gpuNs = 0;
+    SkTHashMap<SkString, Totals> byType, byPaint;
+    std::vector<const Op*> ops;
+    for (const Op& op : fOps) {
+        if (!op.fType || 0 == strcmp(op.fType, "NoOp")) {
+            continue;
+        }
+        cpuNs += op.fCpuNs;
+        gpuNs += op.fGpuNs;
+        ops.push_back(&op);
+
+        SkString type(op.fType);
+        Totals* t = byType.find(type);
+        if (!t) {
+            t = byType.set(type, Totals());
+        }
+        t->add(op);
+
+        SkString key = SkStringPrintf("%s|%s", op.fType, op.fPaint.c_str());
+        t = byPaint.find(key);
+        if (!t) {
+            t = byPaint.set(key, Totals());
+            t->fPaint = op.fPaint;
+        }
+        t->add(op);
+    }
+    std::sort(ops.begin(), ops.end(), [&](const Op* a, const Op* b) { return cost(*a) > cost(*b); });
+    if ((int)ops.size() > topN) {
+        ops.resize(topN);
+    }
+
+    SkJSONWriter writer(stream, SkJSONWriter::Mode::kPretty);
+    writer.beginObject();
+    writer.appendString("ranked_by", hasGpu ? "gpu" : "cpu");
+    writer.appendS32("loops", fLoops);
+    writer.appendS32("ops", fOps.count());
+    writer.appendDoubleDigits("total_cpu_us", cpuNs * 1e-3, 3);
+    if (hasGpu) {
+        writer.appendDoubleDigits("total_gpu_us", gpuNs * 1e-3, 3);
+    }
+
+    writer.beginArray("top_ops");
+    for (const Op* op : ops) {
+        writer.beginObject(nullptr, false);
+        writer.appendS32("index", op->fIndex);
+        writer.appendString("type", op->fType);
+        if (!op->fPaint.isEmpty()) {
+            writer.appendString("paint", op->fPaint.c_str());
+        }
+        write_costs(writer, op->fCpuNs, op->fGpuNs, hasGpu, op->fPixels);
+        writer.endObject();
+    }
+    writer.endArray();
+
+    write_totals(writer, "by_type",  byType,  hasGpu, topN, false);
+    write_totals(writer, "by_paint", byPaint, hasGpu, topN, true);
+
+    writer.endObject();
+    writer.flush();
+}
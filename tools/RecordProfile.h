@@ -0,0 +1,66 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef RecordProfile_DEFINED
+#define RecordProfile_DEFINED
+
+#include "SkString.h"
+#include "SkTArray.h"
+
+class SkCanvas;
+class SkRecord;
+class SkWStream;
+
+namespace sk_gpu_test {
+class FenceSync;
+class GpuTimer;
+}
+
+/**
+ * What each command in an SkRecord cost to draw, averaged over several playbacks.
+ */
+struct RecordProfile {
+    struct Op {
+        int         fIndex  = 0;
+        const char* fType   = nullptr;
+        SkString    fPaint;           // A short summary of the op's paint, if it has one.
+        double      fCpuNs  = 0;
+        double      fGpuNs  = 0;      // Only meaningful if fGpuSamples > 0.
+        int         fGpuSamples = 0;
+        int64_t     fPixels = 0;      // Device pixels under the op's bounds, for draws and layers.
+    };
+
+    SkTArray<Op> fOps;
+    int          fLoops = 0;
+    bool         fHasGpuTimes = false;
+
+    /**
+     * Writes a JSON report ranking the topN costliest ops, and the totals by op type and by
+     * op type and paint.  Ops are ranked by GPU time when we have it, otherwise by CPU time.
+     */
+    void writeJSON(SkWStream*, int topN) const;
+};
+
+struct RecordProfileOptions {
+    int  fLoops = 10;
+
+    // Flush after each op, so its CPU time includes executing it on the GPU backend rather than
+    // just recording it.  GPU timing always flushes after each op.
+    bool fFlushEachOp = true;
+
+    // If both are set, each op is also timed on the GPU.
+    sk_gpu_test::GpuTimer*        fGpuTimer  = nullptr;
+    const sk_gpu_test::FenceSync* fFenceSync = nullptr;
+};
+
+/**
+ * Draws the record to the canvas fLoops times via SkRecords::Draw, timing each command.
+ * Nested pictures are timed as a single op; inline them first (e.g. with
+ * SkRecorder::Playback_DrawPictureMode) to see inside them.
+ */
+void ProfileRecord(const SkRecord&, SkCanvas*, const RecordProfileOptions&, RecordProfile*);
+
+#endif  // RecordProfile_DEFINED
@@ -59,7 +59,8 @@ SkDebugCanvas::SkDebugCanvas(int width, int height)
         : INHERITED(width, height)
         , fOverdrawViz(false)
         , fClipVizColor(SK_ColorTRANSPARENT)
-        , fDrawGpuOpBounds(false) {
+        , fDrawGpuOpBounds(false)
+        , fDrawGpuCostHeatmap(false) {
     // SkPicturePlayback uses the base-class' quickReject calls to cull clipped
     // operations. This can lead to problems in the debugger which expects all
     // the operations in the captured skp to appear in the debug canvas. To
@@ -112,10 +113,13 @@ void SkDebugCanvas::drawTo(SkCanvas* originalCanvas, int index, int m) {
 
     // If we have a GPU backend we can also visualize the op information
     GrAuditTrail* at = nullptr;
-    if (fDrawGpuOpBounds || m != -1) {
+    if (fDrawGpuOpBounds || fDrawGpuCostHeatmap || m != -1) {
         // The audit trail must be obtained from the original canvas.
         at = this->getAuditTrail(originalCanvas);
     }
+    if (at && fDrawGpuCostHeatmap) {
+        at->setCollectCosts(true);
+    }
 
     for (int i = 0; i <= index; i++) {
         // We need to flush any pending operations, or they might combine with commands below.
@@ -170,13 +174,34 @@ void SkDebugCanvas::drawTo(SkCanvas* originalCanvas, int index, int m) {
                 originalCanvas->internal_private_accessTopLayerRenderTargetContext();
         GrSurfaceProxy::UniqueID proxyID = rtc->asSurfaceProxy()->uniqueID();
 
+        GrAuditTrail::Heatmap heatmap;
+        if (fDrawGpuCostHeatmap && at->getHeatmap(proxyID, &heatmap)) {
+            float maxCost = 0;
+            for (float cost : heatmap.fCells) {
+                maxCost = SkTMax(maxCost, cost);
+            }
+            SkPaint paint;
+            const SkScalar cellSize = GrAuditTrail::kHeatmapCellSize;
+            for (int y = 0; y < heatmap.fHeight; ++y) {
+                for (int x = 0; x < heatmap.fWidth; ++x) {
+                    float t = heatmap.fCells[y * heatmap.fWidth + x] / maxCost;
+                    if (t > 0) {
+                        paint.setColor(SkColorSetARGB(SkScalarRoundToInt(0x40 + 0x80 * t), 0xFF,
+                                                      SkScalarRoundToInt(0xFF * (1 - t)), 0));
+                        filterCanvas.drawRect(SkRect::MakeXYWH(x * cellSize, y * cellSize,
+                                                               cellSize, cellSize), paint);
+                    }
+                }
+            }
+        }
+
         // get the bounding boxes to draw
         SkTArray<GrAuditTrail::OpInfo> childrenBounds;
-        if (m == -1) {
-            at->getBoundsByClientID(&childrenBounds, index);
-        } else {
+        if (m != -1) {
             // the client wants us to draw the mth op
             at->getBoundsByOpListID(&childrenBounds.push_back(), m);
+        } else if (fDrawGpuOpBounds) {
+            at->getBoundsByClientID(&childrenBounds, index);
         }
         SkPaint paint;
         paint.setStyle(SkPaint::kStroke_Style);
@@ -225,6 +250,8 @@ GrAuditTrail* SkDebugCanvas::getAuditTrail(SkCanvas* canvas) {
 void SkDebugCanvas::drawAndCollectOps(int n, SkCanvas* canvas) {
     GrAuditTrail* at = this->getAuditTrail(canvas);
     if (at) {
+        at->setCollectCosts(true);
+
         // loop over all of the commands and draw them, this is to collect reordering
         // information
         for (int i = 0; i < this->getSize() && i <= n; i++) {
@@ -245,6 +272,7 @@ void SkDebugCanvas::cleanupAuditTrail(SkCanvas* canvas) {
     if (at) {
         GrAuditTrail::AutoEnable ae(at);
         at->fullReset();
+        at->setCollectCosts(false);
     }
 }
 
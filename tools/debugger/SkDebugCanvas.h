@@ -45,6 +45,16 @@ public:
 
     bool getDrawGpuOpBounds() const { return fDrawGpuOpBounds; }
 
+    /**
+     * Overlay the estimated per-pixel fragment cost of the GPU draws (see GrAuditTrail::Heatmap),
+     * from yellow for the cheapest cells to red for the most expensive.
+     */
+    void setDrawGpuCostHeatmap(bool drawGpuCostHeatmap) {
+        fDrawGpuCostHeatmap = drawGpuCostHeatmap;
+    }
+
+    bool getDrawGpuCostHeatmap() const { return fDrawGpuCostHeatmap; }
+
     /**
         Executes all draw calls to the canvas.
         @param canvas  The canvas being drawn to
@@ -183,6 +193,7 @@ private:
     bool fOverdrawViz;
     SkColor fClipVizColor;
     bool fDrawGpuOpBounds;
+    bool fDrawGpuCostHeatmap;
 
     /**
         Adds the command to the class' vector of commands.
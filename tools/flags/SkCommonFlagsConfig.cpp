@@ -97,6 +97,7 @@ static const struct {
     ,{ "vkmsaa8",              "gpu", "api=vulkan,samples=8" }
     ,{ "vkbetex",              "gpu", "api=vulkan,surf=betex" }
     ,{ "vkbert",               "gpu", "api=vulkan,surf=bert" }
+    ,{ "vktestpersistentcache", "gpu", "api=vulkan,testPersistentCache=true" }
 #endif
 #ifdef SK_METAL
     ,{ "mtl",                   "gpu", "api=metal" }
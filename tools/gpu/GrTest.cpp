@@ -26,6 +26,7 @@
 #include "SkMathPriv.h"
 #include "SkString.h"
 #include "SkTo.h"
+#include "ccpr/GrCCPathCache.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
 #include "ops/GrMeshDrawOp.h"
 #include "text/GrGlyphCache.h"
@@ -60,6 +61,11 @@ void GrContextPriv::resetGpuStats() const {
 void GrContextPriv::dumpCacheStats(SkString* out) const {
 #if GR_CACHE_STATS
     fContext->fResourceCache->dumpStats(out);
+    if (auto ccpr = fContext->fDrawingManager->getCoverageCountingPathRenderer()) {
+        if (auto pathCache = ccpr->pathCache()) {
+            pathCache->stats().dump(out);
+        }
+    }
 #endif
 }
 
@@ -67,6 +73,11 @@ void GrContextPriv::dumpCacheStatsKeyValuePairs(SkTArray<SkString>* keys,
                                                 SkTArray<double>* values) const {
 #if GR_CACHE_STATS
     fContext->fResourceCache->dumpStatsKeyValuePairs(keys, values);
+    if (auto ccpr = fContext->fDrawingManager->getCoverageCountingPathRenderer()) {
+        if (auto pathCache = ccpr->pathCache()) {
+            pathCache->stats().dumpKeyValuePairs(keys, values);
+        }
+    }
 #endif
 }
 
@@ -123,6 +134,17 @@ void GrGpu::Stats::dump(SkString* out) {
     out->appendf("Transfers to Texture: %d\n", fTransfersToTexture);
     out->appendf("Stencil Buffer Creates: %d\n", fStencilAttachmentCreates);
     out->appendf("Number of draws: %d\n", fNumDraws);
+    out->appendf("Persistent Cache Hits: %d\n", fPersistentCacheHits);
+    out->appendf("Persistent Cache Misses: %d\n", fPersistentCacheMisses);
+    out->appendf("Program Cache Hits: %d\n", fProgramCacheHits);
+    out->appendf("Program Cache Misses: %d\n", fProgramCacheMisses);
+    out->appendf("Shader Compile Time (ms): %.2f\n", fShaderCompileNs * 1e-6);
+    out->appendf("Pipelines Created: %d\n", fPipelineCreates);
+    out->appendf("Pipeline Create Time (ms): %.2f\n", fPipelineCreateNs * 1e-6);
+    out->appendf("Uniform Uploads: %d (%d elided)\n", fUniformUploads, fUniformUploadsElided);
+    out->appendf("Vertex Attrib Setups: %d (%d elided)\n", fVertexAttribSetups,
+                 fVertexAttribSetupsElided);
+    out->appendf("Buffer Binds: %d (%d elided)\n", fBufferBinds, fBufferBindsElided);
 }
 
 void GrGpu::Stats::dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values) {
@@ -131,6 +153,20 @@ void GrGpu::Stats::dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>*
     keys->push_back(SkString("texture_uploads")); values->push_back(fTextureUploads);
     keys->push_back(SkString("number_of_draws")); values->push_back(fNumDraws);
     keys->push_back(SkString("number_of_failed_draws")); values->push_back(fNumFailedDraws);
+    keys->push_back(SkString("persistent_cache_hits")); values->push_back(fPersistentCacheHits);
+    keys->push_back(SkString("persistent_cache_misses")); values->push_back(fPersistentCacheMisses);
+    keys->push_back(SkString("program_cache_hits")); values->push_back(fProgramCacheHits);
+    keys->push_back(SkString("program_cache_misses")); values->push_back(fProgramCacheMisses);
+    keys->push_back(SkString("shader_compile_ms")); values->push_back(fShaderCompileNs * 1e-6);
+    keys->push_back(SkString("pipeline_creates")); values->push_back(fPipelineCreates);
+    keys->push_back(SkString("pipeline_create_ms")); values->push_back(fPipelineCreateNs * 1e-6);
+    keys->push_back(SkString("uniform_uploads")); values->push_back(fUniformUploads);
+    keys->push_back(SkString("uniform_uploads_elided")); values->push_back(fUniformUploadsElided);
+    keys->push_back(SkString("vertex_attrib_setups")); values->push_back(fVertexAttribSetups);
+    keys->push_back(SkString("vertex_attrib_setups_elided"));
+    values->push_back(fVertexAttribSetupsElided);
+    keys->push_back(SkString("buffer_binds")); values->push_back(fBufferBinds);
+    keys->push_back(SkString("buffer_binds_elided")); values->push_back(fBufferBindsElided);
 }
 
 #endif
@@ -169,6 +205,17 @@ void GrResourceCache::dumpStats(SkString* out) const {
     out->appendf("\t\tEntry Bytes: current %d (budgeted %d, %.2g%% full, %d unbudgeted) high %d\n",
                  SkToInt(fBytes), SkToInt(fBudgetedBytes), byteUtilization,
                  SkToInt(stats.fUnbudgetedSize), SkToInt(fHighWaterBytes));
+    for (int i = 0; i < kPartitionCount; ++i) {
+        const PartitionBudget& budget = fPartitions[i];
+        out->appendf("\t\tPartition %s: %d budgeted items %d bytes (%d purgeable), priority %d",
+                     PartitionName(static_cast<Partition>(i)), budget.fBudgetedCount,
+                     SkToInt(budget.fBudgetedBytes), SkToInt(budget.fPurgeableBytes),
+                     budget.fPriority);
+        if (budget.fMaxBytes != SIZE_MAX) {
+            out->appendf(", limit %d bytes", SkToInt(budget.fMaxBytes));
+        }
+        out->append("\n");
+    }
 }
 
 void GrResourceCache::dumpStatsKeyValuePairs(SkTArray<SkString>* keys,
@@ -181,6 +228,21 @@ void GrResourceCache::dumpStatsKeyValuePairs(SkTArray<SkString>* keys,
     keys->push_back(SkString("gpu_cache_purgable_entries")); values->push_back(stats.fNumPurgeable);
 }
 
+void GrCCPathCache::Stats::dump(SkString* out) const {
+    int lookups = fHits + fMisses;
+    out->appendf("CCPR Path Cache: %d hits, %d misses (%.2g%% hit rate)\n", fHits, fMisses,
+                 lookups ? (100.f * fHits) / lookups : 0.f);
+    out->appendf("\t\tCompacted Paths: %d, Evictions: %d\n", fCompactedPaths, fEvictions);
+}
+
+void GrCCPathCache::Stats::dumpKeyValuePairs(SkTArray<SkString>* keys,
+                                             SkTArray<double>* values) const {
+    keys->push_back(SkString("ccpr_path_cache_hits")); values->push_back(fHits);
+    keys->push_back(SkString("ccpr_path_cache_misses")); values->push_back(fMisses);
+    keys->push_back(SkString("ccpr_path_cache_compactions")); values->push_back(fCompactedPaths);
+    keys->push_back(SkString("ccpr_path_cache_evictions")); values->push_back(fEvictions);
+}
+
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -190,13 +252,11 @@ void GrResourceCache::changeTimestamp(uint32_t newTimestamp) { fTimestamp = newT
 #ifdef SK_DEBUG
 int GrResourceCache::countUniqueKeysWithTag(const char* tag) const {
     int count = 0;
-    UniqueHash::ConstIter iter(&fUniqueHash);
-    while (!iter.done()) {
-        if (0 == strcmp(tag, (*iter).getUniqueKey().tag())) {
+    fUniqueHash.foreach([&](const GrGpuResource& resource) {
+        if (0 == strcmp(tag, resource.getUniqueKey().tag())) {
             ++count;
         }
-        ++iter;
-    }
+    });
     return count;
 }
 #endif
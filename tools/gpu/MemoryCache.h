@@ -33,6 +33,13 @@ public:
     int numCacheMisses() const { return fCacheMissCnt; }
     void resetNumCacheMisses() { fCacheMissCnt = 0; }
 
+    template <typename Fn>
+    void foreach(Fn&& fn) {
+        for (const auto& it : fMap) {
+            fn(it.first.fKey, it.second);
+        }
+    }
+
 private:
     struct Key {
         Key() = default;
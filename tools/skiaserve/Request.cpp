@@ -217,6 +217,7 @@ sk_sp<SkData> Request::getJsonOps(int n) {
     Json::Value root = fDebugCanvas->toJSON(fUrlDataManager, n, canvas);
     root["mode"] = Json::Value(fGPUEnabled ? "gpu" : "cpu");
     root["drawGpuOpBounds"] = Json::Value(fDebugCanvas->getDrawGpuOpBounds());
+    root["drawGpuCostHeatmap"] = Json::Value(fDebugCanvas->getDrawGpuCostHeatmap());
     root["colorMode"] = Json::Value(fColorMode);
     SkDynamicMemoryWStream stream;
     stream.writeText(Json::FastWriter().write(root).c_str());
@@ -44,6 +44,7 @@ public:
         fHandlers.push_back(new BreakHandler);
         fHandlers.push_back(new OpsHandler);
         fHandlers.push_back(new OpBoundsHandler);
+        fHandlers.push_back(new CostHeatmapHandler);
         fHandlers.push_back(new ColorModeHandler);
         fHandlers.push_back(new QuitHandler);
     }
@@ -135,6 +135,18 @@ public:
                const char* upload_data, size_t* upload_data_size) override;
 };
 
+/*
+ * Enables drawing of the estimated gpu fragment cost heatmap. Posting to /gpuCostHeatmap/1 turns
+ * it on, /gpuCostHeatmap/0 turns it off. The op list from /ops also carries each op's cost.
+ */
+class CostHeatmapHandler : public UrlHandler {
+public:
+    bool canHandle(const char* method, const char* url) override;
+    int handle(Request* request, MHD_Connection* connection,
+               const char* url, const char* method,
+               const char* upload_data, size_t* upload_data_size) override;
+};
+
 class RootHandler : public UrlHandler {
 public:
     bool canHandle(const char* method, const char* url) override;
@@ -27,7 +27,7 @@ def find_skps(skps):
   return __ADB.check('''\
     for PATHNAME in %s; do
       if [ -d "$PATHNAME" ]; then
-        find "$PATHNAME" -maxdepth 1 -name *.skp
+        find "$PATHNAME" -maxdepth 1 -name *.skp -o -maxdepth 1 -name *.mskp
       else
         echo "$PATHNAME"
       fi
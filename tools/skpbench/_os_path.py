@@ -17,6 +17,7 @@ def find_skps(skps):
   for skp in skps:
     if (path.isdir(skp)):
       pathnames.extend(glob.iglob(path.join(skp, '*.skp')))
+      pathnames.extend(glob.iglob(path.join(skp, '*.mskp')))
     else:
       pathnames.append(skp)
   return pathnames
@@ -11,17 +11,21 @@
 #include "GrCaps.h"
 #include "GrContextFactory.h"
 #include "GrContextPriv.h"
+#include "RecordProfile.h"
 #include "SkCanvas.h"
 #include "SkCommonFlags.h"
 #include "SkCommonFlagsGpu.h"
 #include "SkDeferredDisplayList.h"
 #include "SkGraphics.h"
 #include "SkGr.h"
+#include "SkMultiPictureDocument.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPerlinNoiseShader.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
+#include "SkRecord.h"
+#include "SkRecorder.h"
 #include "SkStream.h"
 #include "SkSurface.h"
 #include "SkSurfaceProps.h"
@@ -35,11 +39,16 @@
 #include "../experimental/svg/model/SkSVGDOM.h"
 #endif
 
+#ifdef SK_ENABLE_SKOTTIE
+#include "Skottie.h"
+#endif
+
 #include <stdlib.h>
 #include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <memory>
 #include <vector>
 
 /**
@@ -51,6 +60,11 @@
  * No tiling, looping, or other fanciness is used; it just draws the skp whole into a size-matched
  * render target and syncs the GPU after each draw.
  *
+ * An .mskp (SkMultiPictureDocument) or Lottie .json file is instead replayed as a frame timeline:
+ * one page, or one animation frame, per frame. The context and surface persist across frames, so
+ * caches (text blobs, atlases, paths) behave as they would during real playback. Besides the usual
+ * result line, a timeline run prints per-frame percentiles and a jank count.
+ *
  * Currently, only GPU configs are supported.
  */
 
@@ -63,10 +77,16 @@ DEFINE_int32(duration, 5000, "number of milliseconds to run the benchmark");
 DEFINE_int32(sampleMs, 50, "minimum duration of a sample");
 DEFINE_bool(gpuClock, false, "time on the gpu clock (gpu work only)");
 DEFINE_bool(fps, false, "use fps instead of ms");
-DEFINE_string(src, "", "path to a single .skp or .svg file, or 'warmup' for a builtin warmup run");
+DEFINE_string(src, "", "path to a single .skp, .svg, .mskp or Lottie .json file, or 'warmup' for "
+                       "a builtin warmup run");
 DEFINE_string(png, "", "if set, save a .png proof to disk at this file location");
 DEFINE_int32(verbosity, 4, "level of verbosity (0=none to 5=debug)");
 DEFINE_bool(suppressHeader, false, "don't print a header row before the results");
+DEFINE_string(profile, "", "if set, write a JSON report of the costliest draw commands to this file");
+DEFINE_int32(profileTopN, 20, "number of commands (and command/paint groups) in the --profile report");
+DEFINE_int32(profileLoops, 10, "number of times to draw the skp when profiling it");
+DEFINE_double(jankMs, 1000.0 / 60, "timeline frames slower than this many milliseconds are jank");
+DEFINE_int32(lottieFps, 60, "frame rate at which to step through a Lottie animation");
 
 static const char* header =
 "   accum    median       max       min   stddev  samples  sample_ms  clock  metric  config    bench";
@@ -112,9 +132,25 @@ enum class ExitErr {
     kSoftware     = 70
 };
 
+/**
+ * A sequence of frames to replay in order, e.g. the pages of an .mskp or the frames of a Lottie
+ * animation.
+ */
+class Timeline {
+public:
+    virtual ~Timeline() {}
+    virtual int frameCount() const = 0;
+    virtual SkRect bounds() const = 0;
+    virtual void drawFrame(SkCanvas*, int frame) = 0;
+};
+
 static void draw_skp_and_flush(SkCanvas*, const SkPicture*);
+static void draw_frame_and_flush(SkCanvas*, Timeline*, int frame);
+static void profile_skp(SkCanvas*, const SkPicture*, sk_gpu_test::TestContext*);
 static sk_sp<SkPicture> create_warmup_skp();
 static sk_sp<SkPicture> create_skp_from_svg(SkStream*, const char* filename);
+static std::unique_ptr<Timeline> create_timeline_from_mskp(SkStreamSeekable*, const char* filename);
+static std::unique_ptr<Timeline> create_timeline_from_lottie(SkStream*, const char* filename);
 static bool mkdir_p(const SkString& name);
 static SkString join(const SkCommandLineFlags::StringArray&);
 static void exitf(ExitErr, const char* format, ...);
@@ -290,6 +326,62 @@ static void run_gpu_time_benchmark(sk_gpu_test::GpuTimer* gpuTimer,
     gpuTimer->deleteQuery(previousTime);
 }
 
+// Each sample is one pass through the timeline, and every frame's time is also kept in frameMs.
+static void run_timeline_benchmark(const sk_gpu_test::FenceSync* fenceSync, SkCanvas* canvas,
+                                   Timeline* timeline, std::vector<Sample>* samples,
+                                   std::vector<double>* frameMs) {
+    using clock = std::chrono::high_resolution_clock;
+    const clock::duration benchDuration = std::chrono::milliseconds(FLAGS_duration);
+    const int frameCount = timeline->frameCount();
+
+    // Only prime with the first frame; later frames should meet the caches as playback left them.
+    draw_frame_and_flush(canvas, timeline, 0);
+    GpuSync gpuSync(fenceSync);
+    for (int i = 1; i < kNumFlushesToPrimeCache; ++i) {
+        draw_frame_and_flush(canvas, timeline, 0);
+        gpuSync.syncToPreviousFrame();
+    }
+
+    clock::time_point now = clock::now();
+    const clock::time_point endTime = now + benchDuration;
+
+    do {
+        samples->emplace_back();
+        Sample& sample = samples->back();
+
+        for (int i = 0; i < frameCount; ++i) {
+            clock::time_point frameStart = now;
+            draw_frame_and_flush(canvas, timeline, i);
+            gpuSync.syncToPreviousFrame();
+
+            now = clock::now();
+            sample.fDuration += now - frameStart;
+            ++sample.fFrames;
+            frameMs->push_back(std::chrono::duration<double, std::milli>(now - frameStart).count());
+        }
+    } while (now < endTime || 0 == samples->size() % 2);
+}
+
+void print_timeline_result(const std::vector<double>& frameMs, int frameCount) {
+    std::vector<double> sorted(frameMs);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](int p) {
+        return sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)];
+    };
+    auto jank = [](std::vector<double>::const_iterator begin,
+                   std::vector<double>::const_iterator end) {
+        return std::count_if(begin, end, [](double ms) { return ms > FLAGS_jankMs; });
+    };
+
+    // The first pass is reported separately since it is the one that fills the caches.
+    printf("timeline: %i frames x %li passes  p50 %.4gms  p90 %.4gms  p99 %.4gms  max %.4gms  "
+           "jank(>%.4gms) %li, %li in first pass\n",
+           frameCount, (long)(frameMs.size() / frameCount), percentile(50), percentile(90),
+           percentile(99), sorted.back(), FLAGS_jankMs, (long)jank(frameMs.begin(), frameMs.end()),
+           (long)jank(frameMs.begin(), frameMs.begin() + frameCount));
+    fflush(stdout);
+}
+
 void print_result(const std::vector<Sample>& samples, const char* config, const char* bench)  {
     if (0 == (samples.size() % 2)) {
         exitf(ExitErr::kSoftware, "attempted to gather stats on even number of samples");
@@ -346,40 +438,52 @@ int main(int argc, char** argv) {
     // Parse the skp.
     if (FLAGS_src.count() != 1) {
         exitf(ExitErr::kUsage,
-              "invalid input '%s': must specify a single .skp or .svg file, or 'warmup'",
+              "invalid input '%s': must specify a single .skp, .svg, .mskp or .json file, "
+              "or 'warmup'",
               join(FLAGS_src).c_str());
     }
 
     SkGraphics::Init();
 
     sk_sp<SkPicture> skp;
+    std::unique_ptr<Timeline> timeline;
     SkString srcname;
     if (0 == strcmp(FLAGS_src[0], "warmup")) {
         skp = create_warmup_skp();
         srcname = "warmup";
     } else {
         SkString srcfile(FLAGS_src[0]);
-        std::unique_ptr<SkStream> srcstream(SkStream::MakeFromFile(srcfile.c_str()));
+        std::unique_ptr<SkStreamAsset> srcstream(SkStream::MakeFromFile(srcfile.c_str()));
         if (!srcstream) {
             exitf(ExitErr::kIO, "failed to open file %s", srcfile.c_str());
         }
-        if (srcfile.endsWith(".svg")) {
+        if (srcfile.endsWith(".mskp")) {
+            timeline = create_timeline_from_mskp(srcstream.get(), srcfile.c_str());
+        } else if (srcfile.endsWith(".json")) {
+            timeline = create_timeline_from_lottie(srcstream.get(), srcfile.c_str());
+        } else if (srcfile.endsWith(".svg")) {
             skp = create_skp_from_svg(srcstream.get(), srcfile.c_str());
         } else {
             skp = SkPicture::MakeFromStream(srcstream.get());
         }
-        if (!skp) {
+        if (!skp && !timeline) {
             exitf(ExitErr::kData, "failed to parse file %s", srcfile.c_str());
         }
         srcname = SkOSPath::Basename(srcfile.c_str());
     }
-    int width = SkTMin(SkScalarCeilToInt(skp->cullRect().width()), 2048),
-        height = SkTMin(SkScalarCeilToInt(skp->cullRect().height()), 2048);
-    if (FLAGS_verbosity >= 3 &&
-        (width != skp->cullRect().width() || height != skp->cullRect().height())) {
+    if (timeline) {
+        if (FLAGS_ddl || FLAGS_gpuClock || !FLAGS_profile.isEmpty()) {
+            exitf(ExitErr::kUnavailable, "--ddl, --gpuClock and --profile are not supported for "
+                                         "timelines (%s)", srcname.c_str());
+        }
+    }
+    const SkRect bounds = timeline ? timeline->bounds() : skp->cullRect();
+    int width = SkTMin(SkScalarCeilToInt(bounds.width()), 2048),
+        height = SkTMin(SkScalarCeilToInt(bounds.height()), 2048);
+    if (FLAGS_verbosity >= 3 && (width != bounds.width() || height != bounds.height())) {
         fprintf(stderr, "%s is too large (%ix%i), cropping to %ix%i.\n",
-                        srcname.c_str(), SkScalarCeilToInt(skp->cullRect().width()),
-                        SkScalarCeilToInt(skp->cullRect().height()), width, height);
+                        srcname.c_str(), SkScalarCeilToInt(bounds.width()),
+                        SkScalarCeilToInt(bounds.height()), width, height);
     }
 
     if (config->getSurfType() != SkCommandLineConfigGpu::SurfType::kDefault) {
@@ -443,8 +547,13 @@ int main(int argc, char** argv) {
         samples.reserve(2 * FLAGS_duration);
     }
     SkCanvas* canvas = surface->getCanvas();
-    canvas->translate(-skp->cullRect().x(), -skp->cullRect().y());
-    if (!FLAGS_gpuClock) {
+    canvas->translate(-bounds.x(), -bounds.y());
+    if (timeline) {
+        std::vector<double> frameMs;
+        run_timeline_benchmark(testCtx->fenceSync(), canvas, timeline.get(), &samples, &frameMs);
+        print_result(samples, config->getTag().c_str(), srcname.c_str());
+        print_timeline_result(frameMs, timeline->frameCount());
+    } else if (!FLAGS_gpuClock) {
         if (FLAGS_ddl) {
             run_ddl_benchmark(testCtx->fenceSync(), ctx, canvas, skp.get(), &samples);
         } else {
@@ -460,7 +569,9 @@ int main(int argc, char** argv) {
         run_gpu_time_benchmark(testCtx->gpuTimer(), testCtx->fenceSync(), canvas, skp.get(),
                                &samples);
     }
-    print_result(samples, config->getTag().c_str(), srcname.c_str());
+    if (!timeline) {
+        print_result(samples, config->getTag().c_str(), srcname.c_str());
+    }
 
     // Save a proof (if one was requested).
     if (!FLAGS_png.isEmpty()) {
@@ -477,14 +588,53 @@ int main(int argc, char** argv) {
         }
     }
 
+    // Attribute the frame's cost to individual commands (if requested).
+    if (!FLAGS_profile.isEmpty()) {
+        profile_skp(canvas, skp.get(), testCtx);
+    }
+
     exit(0);
 }
 
+static void profile_skp(SkCanvas* canvas, const SkPicture* skp, sk_gpu_test::TestContext* testCtx) {
+    // Inline nested pictures so their commands are profiled individually.
+    SkRecord record;
+    SkRecorder recorder(&record, skp->cullRect());
+    recorder.reset(&record, skp->cullRect(), SkRecorder::Playback_DrawPictureMode);
+    skp->playback(&recorder);
+
+    RecordProfileOptions options;
+    options.fLoops = FLAGS_profileLoops;
+    if (testCtx->gpuTimingSupport()) {
+        options.fGpuTimer  = testCtx->gpuTimer();
+        options.fFenceSync = testCtx->fenceSync();
+    } else if (FLAGS_verbosity >= 3) {
+        fprintf(stderr, "GPU does not support timing; profiling on the cpu clock only.\n");
+    }
+
+    RecordProfile profile;
+    ProfileRecord(record, canvas, options, &profile);
+
+    if (!mkdir_p(SkOSPath::Dirname(FLAGS_profile[0]))) {
+        exitf(ExitErr::kIO, "failed to create directory for profile \"%s\"", FLAGS_profile[0]);
+    }
+    SkFILEWStream out(FLAGS_profile[0]);
+    if (!out.isValid()) {
+        exitf(ExitErr::kIO, "failed to open profile \"%s\" for writing", FLAGS_profile[0]);
+    }
+    profile.writeJSON(&out, FLAGS_profileTopN);
+}
+
 static void draw_skp_and_flush(SkCanvas* canvas, const SkPicture* skp) {
     canvas->drawPicture(skp);
     canvas->flush();
 }
 
+static void draw_frame_and_flush(SkCanvas* canvas, Timeline* timeline, int frame) {
+    timeline->drawFrame(canvas, frame);
+    canvas->flush();
+}
+
 static sk_sp<SkPicture> create_warmup_skp() {
     static constexpr SkRect bounds{0, 0, 500, 500};
     SkPictureRecorder recorder;
@@ -533,6 +683,75 @@ static sk_sp<SkPicture> create_skp_from_svg(SkStream* stream, const char* filena
     return nullptr;
 }
 
+class MSKPTimeline : public Timeline {
+public:
+    MSKPTimeline(std::vector<SkDocumentPage> pages) : fPages(std::move(pages)) {
+        for (const SkDocumentPage& page : fPages) {
+            fBounds.join(SkRect::MakeSize(page.fSize));
+        }
+    }
+
+    int frameCount() const override { return SkToInt(fPages.size()); }
+    SkRect bounds() const override { return fBounds; }
+
+    void drawFrame(SkCanvas* canvas, int frame) override {
+        canvas->drawPicture(fPages[frame].fPicture);
+    }
+
+private:
+    std::vector<SkDocumentPage> fPages;
+    SkRect                      fBounds = SkRect::MakeEmpty();
+};
+
+static std::unique_ptr<Timeline> create_timeline_from_mskp(SkStreamSeekable* stream,
+                                                           const char* filename) {
+    int pageCount = SkMultiPictureDocumentReadPageCount(stream);
+    if (pageCount <= 0) {
+        exitf(ExitErr::kData, "failed to read pages from mskp file %s", filename);
+    }
+    std::vector<SkDocumentPage> pages(pageCount);
+    if (!SkMultiPictureDocumentRead(stream, pages.data(), pageCount)) {
+        exitf(ExitErr::kData, "failed to parse mskp file %s", filename);
+    }
+    return std::unique_ptr<Timeline>(new MSKPTimeline(std::move(pages)));
+}
+
+#ifdef SK_ENABLE_SKOTTIE
+class LottieTimeline : public Timeline {
+public:
+    LottieTimeline(sk_sp<skottie::Animation> animation)
+        : fAnimation(std::move(animation))
+        , fFrameCount(SkTMax(1, SkScalarCeilToInt(fAnimation->duration() * FLAGS_lottieFps))) {}
+
+    int frameCount() const override { return fFrameCount; }
+    SkRect bounds() const override { return SkRect::MakeSize(fAnimation->size()); }
+
+    // Seeking is part of the frame, as it would be during playback.
+    void drawFrame(SkCanvas* canvas, int frame) override {
+        fAnimation->seek(fFrameCount > 1 ? (float)frame / (fFrameCount - 1) : 0);
+        canvas->clear(SK_ColorTRANSPARENT);
+        fAnimation->render(canvas);
+    }
+
+private:
+    const sk_sp<skottie::Animation> fAnimation;
+    const int                       fFrameCount;
+};
+#endif
+
+static std::unique_ptr<Timeline> create_timeline_from_lottie(SkStream* stream,
+                                                             const char* filename) {
+#ifdef SK_ENABLE_SKOTTIE
+    sk_sp<skottie::Animation> animation = skottie::Animation::Make(stream);
+    if (!animation) {
+        exitf(ExitErr::kData, "failed to parse lottie file %s", filename);
+    }
+    return std::unique_ptr<Timeline>(new LottieTimeline(std::move(animation)));
+#endif
+    exitf(ExitErr::kData, "SK_ENABLE_SKOTTIE is disabled; cannot open lottie file %s", filename);
+    return nullptr;
+}
+
 bool mkdir_p(const SkString& dirname) {
     if (dirname.isEmpty()) {
         return true;
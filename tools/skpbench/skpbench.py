@@ -81,7 +81,8 @@ __argparse.add_argument('--gpuThreads',
        " software path rendering. Defaults to two.")
 __argparse.add_argument('srcs',
   nargs='+',
-  help=".skp files or directories to expand for .skp files, and/or .svg files")
+  help=".skp files or directories to expand for .skp (and .mskp) files, and/or "
+       ".svg, .mskp or Lottie .json files")
 
 FLAGS = __argparse.parse_args()
 if FLAGS.adb:
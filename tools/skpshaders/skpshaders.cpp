@@ -0,0 +1,138 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrCaps.h"
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "GrShaderCapture.h"
+#include "SkCanvas.h"
+#include "SkCommonFlags.h"
+#include "SkCommonFlagsGpu.h"
+#include "SkGraphics.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "flags/SkCommandLineFlags.h"
+#include "flags/SkCommonFlagsConfig.h"
+
+#include <stdlib.h>
+
+/**
+ * Replays .skp files on a single GPU config and writes out the SkSL of every program Ganesh built
+ * along the way, keyed by GrProgramDesc. Apps pass the file to GrContext::precompileShaders() at
+ * startup, so the programs' shaders are generated on worker threads before the first frame needs
+ * them.
+ *
+ * The SkSL that processors emit depends on the shader caps, so captures are most useful when made
+ * on the device (or at least the driver) they'll be used with. On a machine without a suitable GPU,
+ * --config nullgl still builds every program, with the caps of a generic desktop GL.
+ */
+
+DEFINE_string(out, "", "file to write the captured shaders to");
+DEFINE_int32(verbosity, 1, "level of verbosity (0=errors only, 1=one line per skp)");
+
+static void exitf(const char* format, ...) {
+    fprintf(stderr, "ERROR: ");
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fprintf(stderr, ".\n");
+    exit(1);
+}
+
+static void draw_skp(GrContext* ctx, const SkCommandLineConfigGpu* config, const SkString& path) {
+    std::unique_ptr<SkStream> stream(SkStream::MakeFromFile(path.c_str()));
+    sk_sp<SkPicture> skp = stream ? SkPicture::MakeFromStream(stream.get()) : nullptr;
+    if (!skp) {
+        fprintf(stderr, "skipping %s: failed to parse it\n", path.c_str());
+        return;
+    }
+
+    int maxSize = SkTMin(ctx->maxRenderTargetSize(), 2048);
+    int width = SkTMin(SkScalarCeilToInt(skp->cullRect().width()), maxSize),
+        height = SkTMin(SkScalarCeilToInt(skp->cullRect().height()), maxSize);
+    SkImageInfo info =
+            SkImageInfo::Make(SkTMax(width, 1), SkTMax(height, 1), config->getColorType(),
+                              config->getAlphaType(), sk_ref_sp(config->getColorSpace()));
+    uint32_t flags = config->getUseDIText() ? SkSurfaceProps::kUseDeviceIndependentFonts_Flag : 0;
+    SkSurfaceProps props(flags, SkSurfaceProps::kLegacyFontHost_InitType);
+    sk_sp<SkSurface> surface =
+            SkSurface::MakeRenderTarget(ctx, SkBudgeted::kNo, info, config->getSamples(), &props);
+    if (!surface) {
+        fprintf(stderr, "skipping %s: failed to create a %ix%i render target\n", path.c_str(),
+                info.width(), info.height());
+        return;
+    }
+
+    GrShaderCapture* capture = ctx->contextPriv().getShaderCapture();
+    int before = capture->count();
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->translate(-skp->cullRect().x(), -skp->cullRect().y());
+    canvas->drawPicture(skp);
+    canvas->flush();
+    if (FLAGS_verbosity >= 1) {
+        printf("%s: %i new programs\n", SkOSPath::Basename(path.c_str()).c_str(),
+               capture->count() - before);
+    }
+}
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Captures the shaders of the programs needed to draw --skps (.skp "
+                                 "files or directories of them) on a single GPU --config, into "
+                                 "--out.");
+    SkCommandLineFlags::Parse(argc, argv);
+
+    const SkCommandLineConfigGpu* config = nullptr;
+    SkCommandLineConfigArray configs;
+    ParseConfigs(FLAGS_config, &configs);
+    if (configs.count() != 1 || !(config = configs[0]->asConfigGpu())) {
+        exitf("must specify one (and only one) GPU config");
+    }
+    if (FLAGS_out.count() != 1) {
+        exitf("must specify one output file with --out");
+    }
+
+    SkGraphics::Init();
+
+    GrContextOptions ctxOptions;
+    SetCtxOptionsFromCommonFlags(&ctxOptions);
+    sk_gpu_test::GrContextFactory factory(ctxOptions);
+    sk_gpu_test::ContextInfo ctxInfo =
+            factory.getContextInfo(config->getContextType(), config->getContextOverrides());
+    GrContext* ctx = ctxInfo.grContext();
+    if (!ctx) {
+        exitf("failed to create context for config %s", config->getTag().c_str());
+    }
+
+    GrShaderCapture capture;
+    ctx->contextPriv().setShaderCapture(&capture);
+    for (int i = 0; i < FLAGS_skps.count(); ++i) {
+        const char* src = FLAGS_skps[i];
+        if (sk_isdir(src)) {
+            SkOSFile::Iter iter(src, "skp");
+            for (SkString file; iter.next(&file); ) {
+                draw_skp(ctx, config, SkOSPath::Join(src, file.c_str()));
+            }
+        } else {
+            draw_skp(ctx, config, SkString(src));
+        }
+    }
+    ctx->contextPriv().setShaderCapture(nullptr);
+
+    sk_sp<SkData> data = capture.serialize();
+    SkFILEWStream out(FLAGS_out[0]);
+    if (!out.isValid() || !out.write(data->data(), data->size())) {
+        exitf("failed to write %s", FLAGS_out[0]);
+    }
+    if (FLAGS_verbosity >= 1) {
+        printf("captured %i programs into %s\n", capture.count(), FLAGS_out[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkCommonFlagsConfig.h"
+#include "SkCommonFlagsGpu.h"
+#include "SkFlattenable.h"
+#include "SkFontMgr.h"
+#include "SkGradientShader.h"
+#include "SkGraphics.h"
+#include "SkImage.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTime.h"
+#include "SkTypeface.h"
+
+#if SK_SUPPORT_GPU
+#include "GrContextFactory.h"
+#endif
+
+#if !defined(SK_BUILD_FOR_WIN)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <functional>
+
+/**
+ * A benchmark for the time it takes a process to get its first frame out of Skia.
+ *
+ * Each cold sample runs in a freshly forked child that has not touched Skia yet, and times the
+ * phases a real client goes through: SkGraphics::Init() (CPU dispatch), default font manager and
+ * typeface creation, context creation (GPU configs only; includes caps probing), surface creation,
+ * recording a first frame, and flushing it (GPU configs pay for the SkSL compiler and their first
+ * programs here). The warm numbers then repeat surface creation, draw and flush in the same
+ * process, so the difference between the two is the one-time cost.
+ *
+ * Flattenable registration is reported on the side: it is only paid by processes that deserialize
+ * pictures or effects, so it is not part of the time to first draw.
+ */
+
+DEFINE_int32(samples, 5, "Number of cold processes to measure for each config.");
+DEFINE_int32(warm, 10, "Number of warm frames to measure after each cold start.");
+DEFINE_int32(size, 256, "Width and height of the surface to draw into.");
+
+enum Phase {
+    kInit_Phase,
+    kFontMgr_Phase,
+    kContext_Phase,
+    kSurface_Phase,
+    kDraw_Phase,
+    kFlush_Phase,
+    kFlattenables_Phase,
+
+    kLast_Phase = kFlattenables_Phase
+};
+static constexpr int kPhaseCount = kLast_Phase + 1;
+
+static const char* phase_name(int phase) {
+    static const char* kNames[kPhaseCount] = {
+        "init", "fontmgr", "context", "surface", "draw", "flush", "flattenables",
+    };
+    return kNames[phase];
+}
+
+// Cold and warm time of each phase in ms, or -1 for phases that don't apply.
+struct Sample {
+    double fCold[kPhaseCount];
+    double fWarm[kPhaseCount];
+};
+
+static void draw_first_frame(SkCanvas* canvas, SkTypeface* typeface) {
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 100, 60), paint);
+
+    SkPath path;
+    path.addCircle(150, 60, 40);
+    path.addRoundRect(SkRect::MakeXYWH(40, 120, 180, 60), 12, 12);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    canvas->drawPath(path, paint);
+
+    const SkPoint pts[] = {{0, 0}, {0, 256}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN};
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    canvas->drawCircle(200, 200, 30, paint);
+
+    paint.setShader(nullptr);
+    paint.setColor(SK_ColorBLACK);
+    paint.setTypeface(sk_ref_sp(typeface));
+    paint.setTextSize(24);
+    static const char kText[] = "Hello, first frame";
+    canvas->drawText(kText, sizeof(kText) - 1, 10, 230, paint);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    bitmap.eraseColor(SK_ColorMAGENTA);
+    canvas->drawImage(SkImage::MakeFromBitmap(bitmap), 200, 10);
+}
+
+// Times one phase, in ms.
+template <typename Fn>
+static double time_phase(Fn&& fn) {
+    double start = SkTime::GetMSecs();
+    fn();
+    return SkTime::GetMSecs() - start;
+}
+
+static bool run_config(const SkCommandLineConfig* config, Sample* sample) {
+    for (int i = 0; i < kPhaseCount; ++i) {
+        sample->fCold[i] = sample->fWarm[i] = -1;
+    }
+
+    sample->fCold[kInit_Phase] = time_phase([] { SkGraphics::Init(); });
+
+    sk_sp<SkTypeface> typeface;
+    sample->fCold[kFontMgr_Phase] = time_phase([&] {
+        typeface = SkFontMgr::RefDefault()->legacyMakeTypeface(nullptr, SkFontStyle());
+    });
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(FLAGS_size, FLAGS_size);
+    std::function<sk_sp<SkSurface>()> makeSurface;
+#if SK_SUPPORT_GPU
+    std::unique_ptr<sk_gpu_test::GrContextFactory> factory;
+    GrContext* context = nullptr;
+    if (const SkCommandLineConfigGpu* gpuConfig = config->asConfigGpu()) {
+        sample->fCold[kContext_Phase] = time_phase([&] {
+            GrContextOptions options;
+            SetCtxOptionsFromCommonFlags(&options);
+            factory.reset(new sk_gpu_test::GrContextFactory(options));
+            context = factory->get(gpuConfig->getContextType(),
+                                   gpuConfig->getContextOverrides());
+        });
+        if (!context) {
+            SkDebugf("%s: could not create a context.\n", config->getTag().c_str());
+            return false;
+        }
+        info = SkImageInfo::Make(FLAGS_size, FLAGS_size, gpuConfig->getColorType(),
+                                 gpuConfig->getAlphaType(), sk_ref_sp(gpuConfig->getColorSpace()));
+        int samples = gpuConfig->getSamples();
+        makeSurface = [=] {
+            return SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info, samples, nullptr);
+        };
+    }
+#endif
+    if (!makeSurface) {
+        if (!config->getBackend().equals("8888")) {
+            SkDebugf("%s: only 8888 and GPU configs are supported.\n", config->getTag().c_str());
+            return false;
+        }
+        makeSurface = [=] { return SkSurface::MakeRaster(info); };
+    }
+
+    // Reading back a pixel waits for the GPU to finish the frame.
+    auto flush = [](SkSurface* surface) {
+        uint32_t pixel;
+        surface->getCanvas()->flush();
+        surface->readPixels(SkImageInfo::MakeN32Premul(1, 1), &pixel, sizeof(pixel), 0, 0);
+    };
+
+    for (int i = 0; i <= FLAGS_warm; ++i) {
+        double* times = i == 0 ? sample->fCold : sample->fWarm;
+        sk_sp<SkSurface> surface;
+        double surfaceMs = time_phase([&] { surface = makeSurface(); });
+        if (!surface) {
+            SkDebugf("%s: could not create a surface.\n", config->getTag().c_str());
+            return false;
+        }
+        double drawMs  = time_phase([&] {
+            draw_first_frame(surface->getCanvas(), typeface.get());
+        });
+        double flushMs = time_phase([&] { flush(surface.get()); });
+
+        // Keep the fastest warm frame.
+        if (i == 0 || times[kSurface_Phase] < 0 ||
+                surfaceMs + drawMs + flushMs <
+                times[kSurface_Phase] + times[kDraw_Phase] + times[kFlush_Phase]) {
+            times[kSurface_Phase] = surfaceMs;
+            times[kDraw_Phase]    = drawMs;
+            times[kFlush_Phase]   = flushMs;
+        }
+    }
+
+    // Looking up any factory by name registers them all.
+    sample->fCold[kFlattenables_Phase] = time_phase([] {
+        SkFlattenable::NameToFactory("SkRecordedDrawable");
+    });
+    return true;
+}
+
+static double median(SkTDArray<double>* values) {
+    SkTQSort(values->begin(), values->end() - 1);
+    return (*values)[values->count() / 2];
+}
+
+static void report(const char* tag, const SkTArray<Sample>& samples) {
+    if (samples.empty()) {
+        return;
+    }
+    SkDebugf("%s (median of %d cold starts, best of %d warm frames)\n",
+             tag, samples.count(), FLAGS_warm);
+    SkDebugf("  %-14s %10s %10s\n", "phase", "cold_ms", "warm_ms");
+    double coldTotal = 0, warmTotal = 0;
+    for (int phase = 0; phase < kPhaseCount; ++phase) {
+        SkTDArray<double> cold, warm;
+        for (const Sample& sample : samples) {
+            *cold.append() = sample.fCold[phase];
+            *warm.append() = sample.fWarm[phase];
+        }
+        double coldMs = median(&cold),
+               warmMs = median(&warm);
+        if (coldMs < 0) {
+            continue;
+        }
+        if (phase == kFlattenables_Phase) {
+            SkDebugf("  %-14s %10.3f %10s  (not part of the total)\n", phase_name(phase), coldMs,
+                     "");
+            continue;
+        }
+        coldTotal += coldMs;
+        warmTotal += SkTMax(warmMs, 0.0);
+        if (warmMs < 0) {
+            SkDebugf("  %-14s %10.3f %10s\n", phase_name(phase), coldMs, "");
+        } else {
+            SkDebugf("  %-14s %10.3f %10.3f\n", phase_name(phase), coldMs, warmMs);
+        }
+    }
+    SkDebugf("  %-14s %10.3f %10.3f\n", "first_draw", coldTotal, warmTotal);
+}
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Measures cold and warm time to first draw, by phase.\n"
+                                 "    startup_bench --config 8888 gl vk");
+    SkCommandLineFlags::Parse(argc, argv);
+
+    SkCommandLineConfigArray configs;
+    ParseConfigs(FLAGS_config, &configs);
+
+    for (int i = 0; i < configs.count(); ++i) {
+        const SkCommandLineConfig* config = configs[i].get();
+        SkTArray<Sample> samples;
+#if defined(SK_BUILD_FOR_WIN)
+        // Without fork() only the first config in the process actually starts cold.
+        Sample sample;
+        if (run_config(config, &sample)) {
+            samples.push_back(sample);
+        }
+#else
+        for (int s = 0; s < FLAGS_samples; ++s) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                SkDebugf("pipe() failed.\n");
+                return 1;
+            }
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(fds[0]);
+                Sample sample;
+                bool ok = run_config(config, &sample) &&
+                          write(fds[1], &sample, sizeof(sample)) == sizeof(sample);
+                _exit(ok ? 0 : 1);
+            }
+            close(fds[1]);
+            Sample sample;
+            bool ok = pid > 0 && read(fds[0], &sample, sizeof(sample)) == sizeof(sample);
+            close(fds[0]);
+            if (pid > 0) {
+                waitpid(pid, nullptr, 0);
+            }
+            if (!ok) {
+                SkDebugf("%s: cold start %d failed.\n", config->getTag().c_str(), s);
+                break;
+            }
+            samples.push_back(sample);
+        }
+#endif
+        report(config->getTag().c_str(), samples);
+    }
+    return 0;
+}
@@ -12,12 +12,16 @@
 #include "SkCommandLineFlags.h"
 #include "SkDebugfTracer.h"
 #include "SkEventTracer.h"
+#include "SkRingBufferTracer.h"
+#include "SkStream.h"
 #include "SkTraceEvent.h"
 
 DEFINE_string(trace, "",
               "Log trace events in one of several modes:\n"
               "  debugf     : Show events using SkDebugf\n"
               "  atrace     : Send events to Android ATrace\n"
+              "  ring:<file>: Keep recent events in per-thread ring buffers, and write\n"
+              "               the last second of them to <file> as JSON at exit\n"
               "  <filename> : Any other string is interpreted as a filename. Writes\n"
               "               trace events to specified file as JSON, for viewing\n"
               "               with chrome://tracing");
@@ -26,6 +30,27 @@ DEFINE_string(traceMatch, "",
               "Filter which categories are traced.\n"
               "Uses same format as --match\n");
 
+namespace {
+
+class RingBufferFileTracer : public SkRingBufferTracer {
+public:
+    RingBufferFileTracer(const char* filename) : fFilename(filename) {}
+
+    ~RingBufferFileTracer() override {
+        SkFILEWStream stream(fFilename.c_str());
+        if (stream.isValid()) {
+            this->dumpJSON(&stream);
+        } else {
+            SkDebugf("Failed to open %s for writing trace events.\n", fFilename.c_str());
+        }
+    }
+
+private:
+    SkString fFilename;
+};
+
+}
+
 void initializeEventTracingForTools(const char* traceFlag) {
     if (!traceFlag) {
         if (FLAGS_trace.isEmpty()) {
@@ -39,6 +64,8 @@ void initializeEventTracingForTools(const char* traceFlag) {
         eventTracer = new SkATrace();
     } else if (0 == strcmp(traceFlag, "debugf")) {
         eventTracer = new SkDebugfTracer();
+    } else if (SkStrStartsWith(traceFlag, "ring:")) {
+        eventTracer = new RingBufferFileTracer(traceFlag + strlen("ring:"));
     } else {
         eventTracer = new SkChromeTracingTracer(traceFlag);
     }